@@ -207,6 +207,12 @@ The full list of options mlpack allows:
        of CXXFLAGS (default OFF)
  - USE_OPENMP=(ON/OFF): if ON, then use OpenMP if the compiler supports it; if
        OFF, OpenMP support is manually disabled (default ON)
+ - USE_MPI=(ON/OFF): if ON, then use MPI if it is available, so that
+       DistributedKMeans and DistributedNeighborSearch can work on datasets
+       sharded over several machines (default OFF)
+ - USE_BANDICOOT=(ON/OFF): if ON, then use the Bandicoot GPU linear algebra
+       library if it is available, so that the large matrix products of the
+       Linear and Convolution layers run on the GPU (default OFF)
 
 Each option can be specified to CMake with the '-D' flag.  Other tools can also
 be used to configure CMake, but those are not documented here.
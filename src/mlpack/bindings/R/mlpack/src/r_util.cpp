@@ -13,21 +13,103 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/io.hpp>
 
+#include <R_ext/Altrep.h>
+
 using namespace mlpack;
 using namespace Rcpp;
 
-template<typename eT>
-bool inline inplace_transpose(arma::Mat<eT>& X)
+// The ALTREP class of R numeric vectors whose memory is owned by an arma::mat.
+// The data1 slot of each vector holds an external pointer to the arma::mat,
+// which is deleted when R collects the vector.
+static R_altrep_class_t armaRealClass;
+
+static arma::mat* ArmaMemory(SEXP x)
 {
-  try
-  {
-    X = arma::trans(X);
-    return false;
-  }
-  catch (std::bad_alloc&)
-  {
-    return true;
-  }
+  return (arma::mat*) R_ExternalPtrAddr(R_altrep_data1(x));
+}
+
+static void FinalizeArmaMemory(SEXP ptr)
+{
+  delete (arma::mat*) R_ExternalPtrAddr(ptr);
+  R_ClearExternalPtr(ptr);
+}
+
+static R_xlen_t ArmaLength(SEXP x)
+{
+  return (R_xlen_t) ArmaMemory(x)->n_elem;
+}
+
+static Rboolean ArmaInspect(SEXP x,
+                            int /* pre */,
+                            int /* deep */,
+                            int /* pvec */,
+                            void (*/* inspectSubtree */)(SEXP, int, int, int))
+{
+  Rprintf(" mlpack matrix memory (%lld elements)\n",
+      (long long) ArmaMemory(x)->n_elem);
+  return TRUE;
+}
+
+static void* ArmaDataptr(SEXP x, Rboolean /* writeable */)
+{
+  return ArmaMemory(x)->memptr();
+}
+
+static const void* ArmaDataptrOrNull(SEXP x)
+{
+  return ArmaMemory(x)->memptr();
+}
+
+static double ArmaRealElt(SEXP x, R_xlen_t i)
+{
+  return ArmaMemory(x)->mem[i];
+}
+
+static R_xlen_t ArmaRealGetRegion(SEXP x,
+                                  R_xlen_t i,
+                                  R_xlen_t n,
+                                  double* buf)
+{
+  const arma::mat& m = *ArmaMemory(x);
+  const R_xlen_t size = std::min(n, (R_xlen_t) m.n_elem - i);
+  std::copy(m.mem + i, m.mem + i + size, buf);
+  return size;
+}
+
+// Register the ALTREP class when the package is loaded.
+// [[Rcpp::init]]
+void InitArmaMemory(DllInfo* dll)
+{
+  armaRealClass = R_make_altreal_class("arma_memory", "mlpack", dll);
+  R_set_altrep_Length_method(armaRealClass, ArmaLength);
+  R_set_altrep_Inspect_method(armaRealClass, ArmaInspect);
+  R_set_altvec_Dataptr_method(armaRealClass, ArmaDataptr);
+  R_set_altvec_Dataptr_or_null_method(armaRealClass, ArmaDataptrOrNull);
+  R_set_altreal_Elt_method(armaRealClass, ArmaRealElt);
+  R_set_altreal_Get_region_method(armaRealClass, ArmaRealGetRegion);
+}
+
+// Give the memory of the given matrix to a new R numeric matrix with the given
+// dimensions, without copying it.  The memory is freed when R collects the
+// matrix.  (R saves, serializes and duplicates the matrix like any other.)
+static SEXP WrapArmaMemory(arma::mat&& m,
+                           const size_t nRows,
+                           const size_t nCols)
+{
+  // A matrix that does not own its memory (for instance, an input that was
+  // borrowed from R and returned as-is) must be copied.
+  arma::mat* owned = (m.mem_state == 0) ? new arma::mat(std::move(m)) :
+      new arma::mat(m);
+
+  SEXP ptr = PROTECT(R_MakeExternalPtr(owned, R_NilValue, R_NilValue));
+  R_RegisterCFinalizerEx(ptr, FinalizeArmaMemory, TRUE);
+  SEXP x = PROTECT(R_new_altrep(armaRealClass, ptr, R_NilValue));
+  SEXP dim = PROTECT(Rf_allocVector(INTSXP, 2));
+  INTEGER(dim)[0] = (int) nRows;
+  INTEGER(dim)[1] = (int) nCols;
+  Rf_setAttrib(x, R_DimSymbol, dim);
+  UNPROTECT(3);
+  return x;
 }
 
 // Create a new util::Params object.
@@ -110,7 +192,9 @@ void SetParamVecInt(SEXP params,
   p.SetPassed(paramName);
 }
 
-// Call params.Get<arma::mat>() to set the value of a parameter.
+// Call params.Get<arma::mat>() to set the value of a parameter.  R's matrix is
+// borrowed, so the only copy made is the transpose into mlpack's layout (points
+// as columns).
 // [[Rcpp::export]]
 void SetParamMat(SEXP params,
                     const std::string& paramName,
@@ -132,14 +216,27 @@ void SetParamUMat(SEXP params,
   p.SetPassed(paramName);
 }
 
-// Call params.Get<arma::rowvec>() to set the value of a parameter.
+// Call params.Get<arma::rowvec>() to set the value of a parameter.  If `copy`
+// is false, R's memory is used directly.
 // [[Rcpp::export]]
 void SetParamRow(SEXP params,
-                    const std::string& paramName,
-                    const arma::rowvec& paramValue)
+                 const std::string& paramName,
+                 SEXP paramValue,
+                 bool copy)
 {
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
-  p.Get<arma::rowvec>(paramName) = std::move(paramValue);
+  // A numeric vector is borrowed (unless a copy was asked for); the R code
+  // keeps it alive until the binding has run.
+  if (TYPEOF(paramValue) == REALSXP && !copy)
+  {
+    p.Get<arma::rowvec>(paramName) = arma::rowvec(REAL(paramValue),
+        Rf_xlength(paramValue), false, true);
+  }
+  else
+  {
+    NumericVector v(paramValue);
+    p.Get<arma::rowvec>(paramName) = arma::rowvec(v.begin(), v.size());
+  }
   p.SetPassed(paramName);
 }
 
@@ -154,14 +251,27 @@ void SetParamURow(SEXP params,
   p.SetPassed(paramName);
 }
 
-// Call params.Get<arma::vec>() to set the value of a parameter.
+// Call params.Get<arma::vec>() to set the value of a parameter.  If `copy` is
+// false, R's memory is used directly.
 // [[Rcpp::export]]
 void SetParamCol(SEXP params,
-                    const std::string& paramName,
-                    const arma::vec& paramValue)
+                 const std::string& paramName,
+                 SEXP paramValue,
+                 bool copy)
 {
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
-  p.Get<arma::vec>(paramName) = std::move(paramValue);
+  // A numeric vector is borrowed (unless a copy was asked for); the R code
+  // keeps it alive until the binding has run.
+  if (TYPEOF(paramValue) == REALSXP && !copy)
+  {
+    p.Get<arma::vec>(paramName) = arma::vec(REAL(paramValue),
+        Rf_xlength(paramValue), false, true);
+  }
+  else
+  {
+    NumericVector v(paramValue);
+    p.Get<arma::vec>(paramName) = arma::vec(v.begin(), v.size());
+  }
   p.SetPassed(paramName);
 }
 
@@ -249,57 +359,71 @@ const std::vector<int>& GetParamVecInt(SEXP params,
   return std::move(p.Get<std::vector<int>>(paramName));
 }
 
-// Call p.Get<arma::mat>().
+// Call p.Get<arma::mat>().  The transposed matrix is given to R without
+// another copy.
 // [[Rcpp::export]]
-const arma::mat& GetParamMat(SEXP params, const std::string& paramName)
+SEXP GetParamMat(SEXP params, const std::string& paramName)
 {
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
-  inplace_transpose(p.Get<arma::mat>(paramName));
-  return std::move(p.Get<arma::mat>(paramName));
+  arma::mat m = p.Get<arma::mat>(paramName).t();
+  p.Get<arma::mat>(paramName).clear();
+  const size_t nRows = m.n_rows, nCols = m.n_cols;
+  return WrapArmaMemory(std::move(m), nRows, nCols);
 }
 
-// Call p.Get<arma::Mat<size_t>>().
+// Call p.Get<arma::Mat<size_t>>().  The matrix is converted to double and
+// transposed in one pass, and given to R without another copy.
 // [[Rcpp::export]]
-const arma::Mat<size_t>& GetParamUMat(SEXP params,
-                                      const std::string& paramName)
+SEXP GetParamUMat(SEXP params, const std::string& paramName)
 {
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
-  inplace_transpose(p.Get<arma::Mat<size_t>>(paramName));
-  return std::move(p.Get<arma::Mat<size_t>>(paramName));
+  arma::mat m = arma::conv_to<arma::mat>::from(
+      p.Get<arma::Mat<size_t>>(paramName).t());
+  p.Get<arma::Mat<size_t>>(paramName).clear();
+  const size_t nRows = m.n_rows, nCols = m.n_cols;
+  return WrapArmaMemory(std::move(m), nRows, nCols);
 }
 
-// Call p.Get<arma::rowvec>().
+// Call p.Get<arma::rowvec>().  The memory of the vector is given to R as an
+// n x 1 matrix, without a copy.
 // [[Rcpp::export]]
-const arma::vec GetParamRow(SEXP params, const std::string& paramName)
+SEXP GetParamRow(SEXP params, const std::string& paramName)
 {
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
-  return p.Get<arma::rowvec>(paramName).t();
+  const size_t n = p.Get<arma::rowvec>(paramName).n_elem;
+  return WrapArmaMemory(std::move(p.Get<arma::rowvec>(paramName)), n, 1);
 }
 
 // Call p.Get<arma::Row<size_t>>().
 // [[Rcpp::export]]
-const arma::Col<size_t> GetParamURow(SEXP params,
-                                     const std::string& paramName)
+SEXP GetParamURow(SEXP params, const std::string& paramName)
 {
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
-  return p.Get<arma::Row<size_t>>(paramName).t() + 1;
+  arma::mat m = arma::conv_to<arma::mat>::from(
+      p.Get<arma::Row<size_t>>(paramName)) + 1;
+  const size_t n = m.n_elem;
+  return WrapArmaMemory(std::move(m), n, 1);
 }
 
-// Call p.Get<arma::vec>().
+// Call p.Get<arma::vec>().  The memory of the vector is given to R as a 1 x n
+// matrix, without a copy.
 // [[Rcpp::export]]
-const arma::rowvec GetParamCol(SEXP params, const std::string& paramName)
+SEXP GetParamCol(SEXP params, const std::string& paramName)
 {
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
-  return p.Get<arma::vec>(paramName).t();
+  const size_t n = p.Get<arma::vec>(paramName).n_elem;
+  return WrapArmaMemory(std::move(p.Get<arma::vec>(paramName)), 1, n);
 }
 
 // Call p.Get<arma::Col<size_t>>().
 // [[Rcpp::export]]
-const arma::Row<size_t> GetParamUCol(SEXP params,
-                                     const std::string& paramName)
+SEXP GetParamUCol(SEXP params, const std::string& paramName)
 {
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
-  return p.Get<arma::Col<size_t>>(paramName).t() + 1;
+  arma::mat m = arma::conv_to<arma::mat>::from(
+      p.Get<arma::Col<size_t>>(paramName)) + 1;
+  const size_t n = m.n_elem;
+  return WrapArmaMemory(std::move(m), 1, n);
 }
 
 // Call p.Get<std::tuple<data::DatasetInfo, arma::mat>>().
@@ -309,15 +433,16 @@ List IO_GetParamMatWithInfo(SEXP params, const std::string& paramName)
   util::Params& p = *Rcpp::as<Rcpp::XPtr<util::Params>>(params);
   const data::DatasetInfo& d = std::get<0>(
       p.Get<std::tuple<data::DatasetInfo, arma::mat>>(paramName));
-  const arma::mat& m = std::get<1>(
+  arma::mat m = std::get<1>(
       p.Get<std::tuple<data::DatasetInfo, arma::mat>>(paramName)).t();
+  const size_t nRows = m.n_rows, nCols = m.n_cols;
 
   LogicalVector dims(d.Dimensionality());
   for (size_t i = 0; i < d.Dimensionality(); ++i)
     dims[i] = (d.Type(i) == data::Datatype::numeric) ? false : true;
 
   return List::create(Rcpp::Named("Info") = std::move(dims),
-                      Rcpp::Named("Data") = std::move(m));
+      Rcpp::Named("Data") = WrapArmaMemory(std::move(m), nRows, nCols));
 }
 
 // Enable verbose output.
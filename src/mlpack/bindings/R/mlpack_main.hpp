@@ -81,5 +81,9 @@ using Option = mlpack::bindings::r::ROption<T>;
 // Add default parameters that are included in every program.
 PARAM_FLAG("verbose", "Display informational messages and the full list of "
     "parameters and timers at the end of execution.", "v");
+PARAM_FLAG("copy_all_inputs", "If specified, all input parameters will be deep "
+    "copied before the method is run.  This is useful for debugging problems "
+    "where the input parameters are being modified by the algorithm, but can "
+    "slow down the code.", "");
 
 #endif
@@ -74,6 +74,13 @@ void PrintInputProcessing(
     util::ParamData& d,
     const typename std::enable_if<arma::is_arma_type<T>::value>::type* = 0)
 {
+  // Numeric vectors are borrowed from R, so they must be kept alive (by
+  // assigning them to a variable) until the binding has run, and they are only
+  // copied if copy_all_inputs is given.
+  const bool borrowed = (T::is_row || T::is_col) &&
+      std::is_same<typename T::elem_type, double>::value;
+  const std::string prefix = d.required ? "  " : "    ";
+
   if (!d.required)
   {
     /**
@@ -82,23 +89,33 @@ void PrintInputProcessing(
      *     if (!identical(<param_name>, NA)) {
      *        SetParam<type>(p, "<param_name>", to_matrix(<param_name>))
      *     }
+     *
+     * or, for a numeric vector:
+     *
+     *     if (!identical(<param_name>, NA)) {
+     *        <param_name> <- to_matrix(<param_name>)
+     *        SetParam<type>(p, "<param_name>", <param_name>, copy_all_inputs)
+     *     }
      */
     MLPACK_COUT_STREAM << "  if (!identical(" << d.name << ", NA)) {"
         << std::endl;
-    MLPACK_COUT_STREAM << "    SetParam" << GetType<T>(d) << "(p, \""
-        << d.name << "\", to_matrix(" << d.name << "))" << std::endl;
-    MLPACK_COUT_STREAM << "  }" << std::endl; // Closing brace.
+  }
+
+  if (borrowed)
+  {
+    MLPACK_COUT_STREAM << prefix << d.name << " <- to_matrix(" << d.name << ")"
+        << std::endl;
+    MLPACK_COUT_STREAM << prefix << "SetParam" << GetType<T>(d) << "(p, \""
+        << d.name << "\", " << d.name << ", copy_all_inputs)" << std::endl;
   }
   else
   {
-    /**
-     * This gives us code like:
-     *
-     *     SetParam<type>(p, "<param_name>", to_matrix(<param_name>))
-     */
-    MLPACK_COUT_STREAM << "  SetParam" << GetType<T>(d) << "(p, \""
+    MLPACK_COUT_STREAM << prefix << "SetParam" << GetType<T>(d) << "(p, \""
         << d.name << "\", to_matrix(" << d.name << "))" << std::endl;
   }
+
+  if (!d.required)
+    MLPACK_COUT_STREAM << "  }" << std::endl; // Closing brace.
   MLPACK_COUT_STREAM << std::endl; // Extra line is to clear up the code a bit.
 }
 
@@ -14,6 +14,7 @@
 #define MLPACK_BINDINGS_CLI_END_PROGRAM_HPP
 
 #include <mlpack/core/util/io.hpp>
+#include "perf_report.hpp"
 
 namespace mlpack {
 namespace bindings {
@@ -28,6 +29,13 @@ inline void EndProgram(util::Params& params, util::Timers& timers)
   // Stop the timers.
   timers.StopAllTimers();
 
+  // Write the trace, if one was recorded.
+  if (params.Has("trace_file"))
+  {
+    util::Tracer::Disable();
+    util::Tracer::Write(params.Get<std::string>("trace_file"));
+  }
+
   // Print any output.
   std::map<std::string, util::ParamData>& parameters = params.Parameters();
   for (auto& it : parameters)
@@ -37,6 +45,27 @@ inline void EndProgram(util::Params& params, util::Timers& timers)
       params.functionMap[d.tname]["OutputParam"](d, NULL, NULL);
   }
 
+  // Write the performance report, if one was requested.  This must happen
+  // before the parameters are cleaned up.
+  if (params.Has("perf_report"))
+  {
+    if (params.Has("perf_report_file"))
+    {
+      const std::string& filename = params.Get<std::string>("perf_report_file");
+      std::ofstream ofs(filename);
+      if (!ofs.is_open())
+      {
+        Log::Fatal << "Cannot open performance report file '" << filename
+            << "' for writing!" << std::endl;
+      }
+      WritePerfReport(params, timers, ofs);
+    }
+    else
+    {
+      WritePerfReport(params, timers, std::cout);
+    }
+  }
+
   if (params.Has("verbose"))
   {
     Log::Info << std::endl << "Execution parameters:" << std::endl;
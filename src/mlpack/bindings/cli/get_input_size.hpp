@@ -0,0 +1,76 @@
+/**
+ * @file bindings/cli/get_input_size.hpp
+ *
+ * Get the size of an input matrix that was loaded from file, for the
+ * performance report.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_GET_INPUT_SIZE_HPP
+#define MLPACK_BINDINGS_CLI_GET_INPUT_SIZE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "parameter_type.hpp"
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * Parameters that are not matrices have no size, so nothing is done.
+ */
+template<typename T>
+void GetInputSize(
+    util::ParamData& /* d */,
+    std::pair<size_t, size_t>& /* size */,
+    const typename std::enable_if<!arma::is_arma_type<T>::value>::type* = 0,
+    const typename std::enable_if<!std::is_same<T,
+        std::tuple<data::DatasetInfo, arma::mat>>::value>::type* = 0)
+{
+  // Nothing to do.
+}
+
+/**
+ * Get the number of rows and columns of a matrix (or matrix with dataset
+ * info) parameter, if it is an input that was loaded.
+ */
+template<typename T>
+void GetInputSize(
+    util::ParamData& d,
+    std::pair<size_t, size_t>& size,
+    const typename std::enable_if<arma::is_arma_type<T>::value ||
+                                  std::is_same<T,
+        std::tuple<data::DatasetInfo, arma::mat>>::value>::type* = 0)
+{
+  typedef std::tuple<T, typename ParameterType<T>::type> TupleType;
+  const TupleType* tuple = boost::any_cast<TupleType>(&d.value);
+  if (d.input && d.loaded)
+  {
+    size.first = std::get<1>(std::get<1>(*tuple));
+    size.second = std::get<2>(std::get<1>(*tuple));
+  }
+}
+
+/**
+ * Get the number of rows and columns of an input matrix that was loaded.  The
+ * output is not modified for other parameters.
+ *
+ * @param d Parameter information.
+ * @param * (input) Unused parameter.
+ * @param output Pointer to a std::pair<size_t, size_t> to store the size in.
+ */
+template<typename T>
+void GetInputSize(util::ParamData& d, const void* /* input */, void* output)
+{
+  GetInputSize<typename std::remove_pointer<T>::type>(d,
+      *((std::pair<size_t, size_t>*) output));
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
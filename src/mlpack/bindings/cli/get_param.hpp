@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include "parameter_type.hpp"
+#include "model_cache.hpp"
 
 namespace mlpack {
 namespace bindings {
@@ -120,10 +121,8 @@ T*& GetParam(
   const std::string& value = std::get<1>(*tuple);
   if (d.input && !d.loaded)
   {
-    T* model = new T();
-    data::Load(value, "model", *model, true);
+    std::get<0>(*tuple) = ModelCache::Load<T>(value);
     d.loaded = true;
-    std::get<0>(*tuple) = model;
   }
   return std::get<0>(*tuple);
 }
@@ -76,21 +76,39 @@ using Option = mlpack::bindings::cli::CLIOption<T>;
 #include <mlpack/core/util/timers.hpp>
 #include <mlpack/bindings/cli/parse_command_line.hpp>
 #include <mlpack/bindings/cli/end_program.hpp>
+#include <mlpack/bindings/cli/serve.hpp>
 
 // Forward definition of the binding function.
 void BINDING_FUNCTION(mlpack::util::Params&, mlpack::util::Timers&);
 
-// Define the main function that will be used by this binding.
-int main(int argc, char** argv)
+// Run one call of the binding with the given parameters.
+static void RunBinding(mlpack::util::Params& params)
 {
-  // Parse the command-line options; put them into CLI.
-  mlpack::util::Params params =
-      mlpack::bindings::cli::ParseCommandLine(argc, argv);
   // Create a new timer object for this call.
   mlpack::util::Timers timers;
   timers.Enabled() = true;
   mlpack::Timer::EnableTiming();
 
+  // JSON is the only format of performance report for now.
+  if (params.Has("perf_report") &&
+      params.Get<std::string>("perf_report") != "json")
+  {
+    mlpack::Log::Fatal << "Unknown performance report format '"
+        << params.Get<std::string>("perf_report") << "'; must be 'json'!"
+        << std::endl;
+  }
+
+  // Record the timed scopes of the program, if a trace was requested.
+  if (params.Has("trace_file"))
+    mlpack::util::Tracer::Enable();
+
+  // Every parallel part of the call (and the performance report) uses the
+  // number of threads given by the user.
+  if (params.Get<int>("threads") < 0)
+    mlpack::Log::Fatal << "--threads must be nonnegative!" << std::endl;
+  mlpack::ParallelScope parallelScope(mlpack::ParallelPolicy(
+      (size_t) params.Get<int>("threads")));
+
   // A "total_time" timer is run by default for each mlpack program.
   timers.Start("total_time");
   BINDING_FUNCTION(params, timers);
@@ -101,15 +119,49 @@ int main(int argc, char** argv)
   mlpack::bindings::cli::EndProgram(params, timers);
 }
 
+// Define the main function that will be used by this binding.
+int main(int argc, char** argv)
+{
+  // In server mode, each line of standard input is the command line of a call.
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::string(argv[i]) == "--serve")
+      return mlpack::bindings::cli::Serve(argc, argv, &RunBinding);
+  }
+
+  // Parse the command-line options; put them into CLI.
+  mlpack::util::Params params =
+      mlpack::bindings::cli::ParseCommandLine(argc, argv);
+  RunBinding(params);
+}
+
 // Add default parameters that are included in every program.
 PARAM_GLOBAL(bool, "help", "Default help info.", "h", "bool", false, true,
     false, false);
 PARAM_GLOBAL(std::string, "info", "Print help on a specific option.", "",
     "std::string", false, true, false, "");
+PARAM_GLOBAL(std::string, "perf_report", "If specified, a performance report "
+    "of the program (timers, counters, peak memory usage, number of threads "
+    "and sizes of the input matrices) is written in the given format; only "
+    "'json' is supported.", "", "std::string", false, true, false, "");
+PARAM_GLOBAL(std::string, "perf_report_file", "File to write the performance "
+    "report to.  If not specified, it is written to standard output.", "",
+    "std::string", false, true, false, "");
+PARAM_GLOBAL(int, "threads", "Number of threads to use; 0 uses the OpenMP "
+    "default (set by the OMP_NUM_THREADS environment variable).", "", "int",
+    false, true, false, 0);
 PARAM_GLOBAL(bool, "verbose", "Display informational messages and the full "
     "list of parameters and timers at the end of execution.", "v", "bool",
     false, true, false, false);
 PARAM_GLOBAL(bool, "version", "Display the version of mlpack.", "V", "bool",
     false, true, false, false);
+PARAM_GLOBAL(bool, "serve", "Run in server mode: read the options of one "
+    "call per line of standard input, and answer each with a line 'ok' or "
+    "'error: <message>'.  Input models are only loaded again when their file "
+    "changes.", "", "bool", false, true, false, false);
+PARAM_GLOBAL(std::string, "trace_file", "If specified, a trace of the timers "
+    "and traced scopes of the program is written to this file, in the Chrome "
+    "trace event format (viewable in chrome://tracing or Perfetto).", "",
+    "std::string", false, true, false, "");
 
 #endif
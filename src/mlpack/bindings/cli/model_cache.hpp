@@ -0,0 +1,118 @@
+/**
+ * @file bindings/cli/model_cache.hpp
+ *
+ * A cache of the models loaded by a command-line program in server mode, so
+ * that a model file is only deserialized again when it changes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_MODEL_CACHE_HPP
+#define MLPACK_BINDINGS_CLI_MODEL_CACHE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <sys/stat.h>
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * The ModelCache loads input models for the command-line programs.  By
+ * default each model is simply loaded from its file.  When the cache is
+ * enabled (in server mode, where one program answers many calls), each model
+ * loaded from a file is kept, keyed by the path of the file and the type of
+ * the model; later calls with the same file get a copy of the kept model
+ * instead of deserializing the file again, as long as the modification time
+ * and size of the file have not changed.
+ *
+ * Each call gets its own copy, since bindings own (and may modify or delete)
+ * their input models.  Models that cannot be copied are always loaded from
+ * their file.
+ */
+class ModelCache
+{
+ public:
+  //! Modify whether models are cached.
+  static bool& Enabled()
+  {
+    static bool enabled = false;
+    return enabled;
+  }
+
+  /**
+   * Load a model from the given file, or copy it from the cache.  The caller
+   * owns the returned model.
+   *
+   * @param filename File to load the model from.
+   */
+  template<typename T>
+  static T* Load(const std::string& filename)
+  {
+    return Load<T>(filename, std::is_copy_constructible<T>());
+  }
+
+  //! Discard all cached models.
+  static void Clear() { Entries().clear(); }
+
+ private:
+  //! A cached model, with the state of its file when it was loaded.
+  struct Entry
+  {
+    time_t modificationTime;
+    long long size;
+    std::shared_ptr<void> model;
+  };
+
+  //! Get the cached models, keyed by filename and model type.
+  static std::map<std::string, Entry>& Entries()
+  {
+    static std::map<std::string, Entry> entries;
+    return entries;
+  }
+
+  //! Load a model that cannot be copied: it is always loaded from file.
+  template<typename T>
+  static T* Load(const std::string& filename, const std::false_type)
+  {
+    T* model = new T();
+    data::Load(filename, "model", *model, true);
+    return model;
+  }
+
+  //! Load a model that can be copied, using the cache if it is enabled.
+  template<typename T>
+  static T* Load(const std::string& filename, const std::true_type)
+  {
+    struct stat fileStat;
+    if (!Enabled() || stat(filename.c_str(), &fileStat) != 0)
+      return Load<T>(filename, std::false_type());
+
+    const std::string key = filename + '\n' + typeid(T).name();
+    Entry& entry = Entries()[key];
+    if (!entry.model ||
+        entry.modificationTime != fileStat.st_mtime ||
+        entry.size != (long long) fileStat.st_size)
+    {
+      entry.model = std::shared_ptr<void>(Load<T>(filename, std::false_type()),
+          [](void* model) { delete (T*) model; });
+      entry.modificationTime = fileStat.st_mtime;
+      entry.size = (long long) fileStat.st_size;
+    }
+    else
+    {
+      Log::Info << "Using cached model from '" << filename << "'." << std::endl;
+    }
+
+    return new T(*((const T*) entry.model.get()));
+  }
+};
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
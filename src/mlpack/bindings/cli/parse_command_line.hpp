@@ -30,7 +30,7 @@ namespace cli {
  * instead of whatever the setting of the macro `BINDING_NAME` is.  That is
  * generally only used for testing, in `io_test.cpp`.
  */
-mlpack::util::Params ParseCommandLine(
+inline mlpack::util::Params ParseCommandLine(
     int argc,
     char** argv,
     const char* bindingName = "")
@@ -0,0 +1,173 @@
+/**
+ * @file bindings/cli/perf_report.hpp
+ *
+ * Write a machine-readable report of the performance of a command-line
+ * program: its timers and counters, peak memory usage, number of threads, and
+ * the sizes of its input matrices.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_PERF_REPORT_HPP
+#define MLPACK_BINDINGS_CLI_PERF_REPORT_HPP
+
+#include <mlpack/core/util/io.hpp>
+
+#ifndef _WIN32
+  #include <sys/resource.h>
+#endif
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * Get the peak resident set size of the process, in bytes, or 0 if it is not
+ * available on this platform.
+ */
+inline size_t PeakMemoryUsage()
+{
+#ifndef _WIN32
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+
+  #ifdef __APPLE__
+    // macOS gives bytes; everyone else gives kilobytes.
+    return (size_t) usage.ru_maxrss;
+  #else
+    return (size_t) usage.ru_maxrss * 1024;
+  #endif
+#else
+  return 0;
+#endif
+}
+
+//! Write the given string as a JSON string.
+inline void WriteJSONString(std::ostream& stream, const std::string& str)
+{
+  stream << '"';
+  for (const char c : str)
+  {
+    if (c == '"' || c == '\\')
+      stream << '\\' << c;
+    else if ((unsigned char) c < 0x20)
+      stream << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+          << (int) c << std::dec << std::setfill(' ');
+    else
+      stream << c;
+  }
+  stream << '"';
+}
+
+/**
+ * Write the performance report of a finished program as a JSON object:
+ *
+ * @code
+ * {
+ *   "binding": "knn",
+ *   "timers": { "total_time": 1.234567, ... },
+ *   "counters": { "base_cases": 123456, ... },
+ *   "peak_rss": 104857600,
+ *   "threads": 8,
+ *   "inputs": { "reference": { "rows": 3, "cols": 1000 }, ... }
+ * }
+ * @endcode
+ *
+ * Timers are given in seconds and the peak resident set size in bytes (null
+ * if the platform does not provide it).  The global timers (from Timer) are
+ * merged into the program's timers.
+ *
+ * @param params Parameters of the program.
+ * @param timers Timers and counters of the program.
+ * @param stream Stream to write the report to.
+ */
+inline void WritePerfReport(util::Params& params,
+                            util::Timers& timers,
+                            std::ostream& stream)
+{
+  // Merge the global timers with the binding-specific ones.
+  std::map<std::string, std::chrono::microseconds> timerMap =
+      timers.GetAllTimers();
+  std::map<std::string, std::chrono::microseconds> globalTimerMap =
+      Timer::GetAllTimers();
+  for (auto& it : globalTimerMap)
+    timerMap[it.first] += it.second;
+
+  const std::ios::fmtflags flags = stream.flags();
+  const std::streamsize precision = stream.precision();
+  stream << std::fixed << std::setprecision(6);
+
+  stream << "{" << std::endl << "  \"binding\": ";
+  WriteJSONString(stream, params.BindingName());
+  stream << "," << std::endl;
+
+  stream << "  \"timers\": {";
+  bool first = true;
+  for (auto& it : timerMap)
+  {
+    stream << (first ? " " : ", ");
+    WriteJSONString(stream, it.first);
+    stream << ": " << it.second.count() / 1e6;
+    first = false;
+  }
+  stream << (first ? "}," : " },") << std::endl;
+
+  stream << "  \"counters\": {";
+  first = true;
+  for (auto& it : timers.GetAllCounters())
+  {
+    stream << (first ? " " : ", ");
+    WriteJSONString(stream, it.first);
+    stream << ": " << it.second;
+    first = false;
+  }
+  stream << (first ? "}," : " },") << std::endl;
+
+  const size_t peakMemory = PeakMemoryUsage();
+  stream << "  \"peak_rss\": ";
+  if (peakMemory == 0)
+    stream << "null";
+  else
+    stream << peakMemory;
+  stream << "," << std::endl;
+
+  #ifdef HAS_OPENMP
+  stream << "  \"threads\": " << omp_get_max_threads() << "," << std::endl;
+  #else
+  stream << "  \"threads\": 1," << std::endl;
+  #endif
+
+  // Only input matrices that were loaded have a size.
+  stream << "  \"inputs\": {";
+  first = true;
+  for (auto& it : params.Parameters())
+  {
+    util::ParamData& d = it.second;
+    if (!d.input)
+      continue;
+
+    std::pair<size_t, size_t> size(0, 0);
+    params.functionMap[d.tname]["GetInputSize"](d, NULL, (void*) &size);
+    if (size.first == 0 && size.second == 0)
+      continue;
+
+    stream << (first ? " " : ", ");
+    WriteJSONString(stream, d.name);
+    stream << ": { \"rows\": " << size.first << ", \"cols\": " << size.second
+        << " }";
+    first = false;
+  }
+  stream << (first ? "}" : " }") << std::endl << "}" << std::endl;
+
+  stream.flags(flags);
+  stream.precision(precision);
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
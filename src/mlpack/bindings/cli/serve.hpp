@@ -0,0 +1,153 @@
+/**
+ * @file bindings/cli/serve.hpp
+ *
+ * Server mode for command-line programs: answer a stream of calls read from
+ * standard input, caching the models they load.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_SERVE_HPP
+#define MLPACK_BINDINGS_CLI_SERVE_HPP
+
+#include <mlpack/core.hpp>
+#include "model_cache.hpp"
+#include "parse_command_line.hpp"
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * Split a line into arguments the way a shell would, for simple cases:
+ * arguments are separated by whitespace, and may be quoted with single or
+ * double quotes; a backslash escapes the next character outside of single
+ * quotes.
+ *
+ * @param line Line to split.
+ */
+inline std::vector<std::string> SplitArguments(const std::string& line)
+{
+  std::vector<std::string> arguments;
+  std::string current;
+  bool inArgument = false;
+  char quote = '\0';
+  for (size_t i = 0; i < line.size(); ++i)
+  {
+    const char c = line[i];
+    if (quote == '\'')
+    {
+      if (c == '\'')
+        quote = '\0';
+      else
+        current += c;
+    }
+    else if (c == '\\' && i + 1 < line.size())
+    {
+      current += line[++i];
+      inArgument = true;
+    }
+    else if (quote == '"')
+    {
+      if (c == '"')
+        quote = '\0';
+      else
+        current += c;
+    }
+    else if (c == '\'' || c == '"')
+    {
+      quote = c;
+      inArgument = true;
+    }
+    else if (std::isspace((unsigned char) c))
+    {
+      if (inArgument)
+        arguments.push_back(current);
+      current.clear();
+      inArgument = false;
+    }
+    else
+    {
+      current += c;
+      inArgument = true;
+    }
+  }
+
+  if (quote != '\0')
+    throw std::invalid_argument("unterminated quote in '" + line + "'");
+  if (inArgument)
+    arguments.push_back(current);
+
+  return arguments;
+}
+
+/**
+ * Run a command-line program in server mode.  Each line of standard input
+ * holds the options of one call of the program, as they would be given on the
+ * command line (for instance, `--input_model_file model.bin --test_file
+ * test.csv --predictions_file predictions.csv`); the options given on the
+ * command line itself, besides --serve, are added to every call.  After each
+ * call, a line with `ok` or `error: <message>` is written to standard output.
+ * The program stops at the end of standard input.
+ *
+ * Input models are cached by the path and modification time of their file
+ * (see ModelCache), so each model file is only deserialized once.
+ *
+ * @param argc Number of command-line arguments.
+ * @param argv Command-line arguments, including --serve.
+ * @param run Function that runs one call of the program with the given
+ *     parameters, and cleans up after it.
+ */
+inline int Serve(int argc, char** argv, void (*run)(util::Params&))
+{
+  std::vector<std::string> commonArguments;
+  for (int i = 0; i < argc; ++i)
+    if (std::string(argv[i]) != "--serve")
+      commonArguments.push_back(argv[i]);
+
+  ModelCache::Enabled() = true;
+  const bool ignoreInfo = Log::Info.ignoreInput;
+
+  std::string line;
+  while (std::getline(std::cin, line))
+  {
+    try
+    {
+      std::vector<std::string> arguments = SplitArguments(line);
+      if (arguments.empty())
+        continue;
+      arguments.insert(arguments.begin(), commonArguments.begin(),
+          commonArguments.end());
+
+      std::vector<char*> callArgv;
+      for (size_t i = 0; i < arguments.size(); ++i)
+        callArgv.push_back(&arguments[i][0]);
+
+      // Each call starts from the same state (--verbose only applies to the
+      // call it is given with).
+      Log::Info.ignoreInput = ignoreInfo;
+      Timer::ResetAll();
+
+      util::Params params = ParseCommandLine((int) callArgv.size(),
+          callArgv.data());
+      run(params);
+      std::cout << "ok" << std::endl;
+    }
+    catch (std::exception& e)
+    {
+      std::string message(e.what());
+      std::replace(message.begin(), message.end(), '\n', ' ');
+      std::cout << "error: " << message << std::endl;
+    }
+  }
+
+  return 0;
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
@@ -90,12 +90,30 @@ func (m *mlpackArma) allocArmaPtrMatWithInfo(p *params,
   runtime.KeepAlive(m)
 }
 
-// Passes a Gonum matrix to C by using the underlying data from the Gonum matrix.
-func gonumToArmaMat(p *params, identifier string, m *mat.Dense) {
-  // Get the number of elements in the Armadillo column.
+// Returns the elements of a Gonum matrix in row-major order.  If the matrix is
+// contiguous in memory (that is, it is not a view of a larger matrix), this is
+// its own memory; otherwise a contiguous copy is made.  The returned memory is
+// kept alive by the params until they are cleaned, since mlpack uses it in
+// place.
+func gonumData(p *params, m *mat.Dense) []float64 {
   r, c := m.Dims()
   blas64General := m.RawMatrix()
   data := blas64General.Data
+  if blas64General.Stride != c && r != 1 {
+    data = mat.DenseCopyOf(m).RawMatrix().Data
+  }
+
+  p.inputs = append(p.inputs, data)
+  return data[:r * c]
+}
+
+// Passes a Gonum matrix to C without a copy: the row-major points of the Gonum
+// matrix are the column-major points of the Armadillo matrix.  mlpack only
+// reads the matrix.
+func gonumToArmaMat(p *params, identifier string, m *mat.Dense) {
+  // Get the number of elements in the Armadillo column.
+  r, c := m.Dims()
+  data := gonumData(p, m)
 
   // Pass pointer of the underlying matrix to mlpack.
   ptr := unsafe.Pointer(&data[0])
@@ -107,8 +125,7 @@ func gonumToArmaMat(p *params, identifier string, m *mat.Dense) {
 func gonumToArmaUmat(p *params, identifier string, m *mat.Dense) {
   // Get the number of elements in the Armadillo column.
   r, c := m.Dims()
-  blas64General := m.RawMatrix()
-  data := blas64General.Data
+  data := gonumData(p, m)
 
   // Pass pointer of the underlying matrix to mlpack.
   ptr := unsafe.Pointer(&data[0])
@@ -116,107 +133,82 @@ func gonumToArmaUmat(p *params, identifier string, m *mat.Dense) {
       C.size_t(c), C.size_t(r))
 }
 
-// Passes a Gonum matrix to C by using the underlying data from the Gonum matrix.
+// Passes a Gonum vector (with a single row or a single column) to C without a
+// copy.  mlpack only reads the vector.
 func gonumToArmaRow(p *params, identifier string, m *mat.Dense) {
-  // Get the number of elements in the Armadillo column.
-  e, err := m.Dims()
-  if (err != 1 && e != 1){
-    panic("Given matrix must have a single column")
-  }
-
-  // Transpose if Column vector is given
-  if e == 1 {
-    m = mat.DenseCopyOf(m.T())
-    e = err
+  r, c := m.Dims()
+  if (r != 1 && c != 1) {
+    panic("Given matrix must have a single row or a single column")
   }
 
-  blas64General := m.RawMatrix()
-  data := blas64General.Data
+  // Either way, the elements are in order.
+  data := gonumData(p, m)
 
   // Pass pointer of the underlying matrix to mlpack.
   ptr := unsafe.Pointer(&data[0])
   C.mlpackToArmaRow(p.mem, C.CString(identifier), (*C.double)(ptr),
-      C.size_t(e))
+      C.size_t(r * c))
 }
 
-// Passes a Gonum matrix to C by using the underlying data from the Gonum matrix.
+// Passes a Gonum vector (with a single row or a single column) to C by using
+// the underlying data from the Gonum matrix.
 func gonumToArmaUrow(p *params, identifier string, m *mat.Dense) {
-  // Get the number of elements in the Armadillo column.
-  e, err := m.Dims()
-  if (err != 1 && e != 1){
-    panic("Given matrix must have a single column")
-  }
-
-  // Transpose if Column vector is given
-  if e == 1 {
-    m = mat.DenseCopyOf(m.T())
-    e = err
+  r, c := m.Dims()
+  if (r != 1 && c != 1) {
+    panic("Given matrix must have a single row or a single column")
   }
 
-  blas64General := m.RawMatrix()
-  data := blas64General.Data
+  // Either way, the elements are in order.
+  data := gonumData(p, m)
 
   // Pass pointer of the underlying matrix to mlpack.
   ptr := unsafe.Pointer(&data[0])
   C.mlpackToArmaUrow(p.mem, C.CString(identifier), (*C.double)(ptr),
-      C.size_t(e))
+      C.size_t(r * c))
 }
 
-// Passes a Gonum matrix to C by using the underlying data from the Gonum matrix.
+// Passes a Gonum vector (with a single row or a single column) to C without a
+// copy.  mlpack only reads the vector.
 func gonumToArmaCol(p *params, identifier string, m *mat.Dense) {
-  // Get the number of elements in the Armadillo column.
-  err, e := m.Dims()
-  if (err != 1 && e != 1){
-    panic("Given matrix must have a single row")
-  }
-
-  // Transpose if Row vector is given
-  if e == 1 {
-    m = mat.DenseCopyOf(m.T())
-    e = err
+  r, c := m.Dims()
+  if (r != 1 && c != 1) {
+    panic("Given matrix must have a single row or a single column")
   }
 
-  blas64General := m.RawMatrix()
-  data := blas64General.Data
+  // Either way, the elements are in order.
+  data := gonumData(p, m)
 
   // Pass pointer of the underlying matrix to mlpack.
   ptr := unsafe.Pointer(&data[0])
   C.mlpackToArmaCol(p.mem, C.CString(identifier), (*C.double)(ptr),
-      C.size_t(e))
+      C.size_t(r * c))
 }
 
-// Passes a Gonum matrix to C by using the underlying data from the Gonum matrix.
+// Passes a Gonum vector (with a single row or a single column) to C by using
+// the underlying data from the Gonum matrix.
 func gonumToArmaUcol(p *params, identifier string, m *mat.Dense) {
-  // Get the number of elements in the Armadillo column.
-  err, e := m.Dims()
-  if (err != 1 && e != 1){
-    panic("Given matrix must have a single row")
+  r, c := m.Dims()
+  if (r != 1 && c != 1) {
+    panic("Given matrix must have a single row or a single column")
   }
 
-  // Transpose if Row vector is given
-  if e == 1 {
-    m = mat.DenseCopyOf(m.T())
-    e = err
-  }
-
-  blas64General := m.RawMatrix()
-  data := blas64General.Data
+  // Either way, the elements are in order.
+  data := gonumData(p, m)
 
   // Pass pointer of the underlying matrix to mlpack.
   ptr := unsafe.Pointer(&data[0])
   C.mlpackToArmaUcol(p.mem, C.CString(identifier), (*C.double)(ptr),
-      C.size_t(e))
+      C.size_t(r * c))
 }
 
-// GonumToArmaMatWithInfo passes a gonum matrix with info to C by 
-// using it's gonums underlying blas64.
+// GonumToArmaMatWithInfo passes a gonum matrix with info to C without a copy
+// of the matrix.
 func gonumToArmaMatWithInfo(p *params,
                             identifier string,
                             m *matrixWithInfo) {
   // Get the number of elements in the Armadillo column.
   r, c := m.Data.Dims()
-  blas64General := m.Data.RawMatrix()
-  dataAndInfo := blas64General.Data
+  dataAndInfo := gonumData(p, m.Data)
   boolarray := m.Categoricals
   // Pass pointer of the underlying matrix to mlpack.
   boolptr := unsafe.Pointer(&boolarray[0])
@@ -225,6 +217,19 @@ func gonumToArmaMatWithInfo(p *params,
       (*C.bool)(boolptr), (*C.double)(matptr), C.size_t(c), C.size_t(r))
 }
 
+// Wraps memory handed over by mlpack (see GetMemory() in capi/arma_util.hpp)
+// in a Gonum matrix without a copy.  The matrix owns the memory: it is freed
+// when the returned *mat.Dense is garbage collected, so slices of its raw data
+// or views of it must not outlive it.
+func wrapArmaMemory(mem unsafe.Pointer, r, c, e int) *mat.Dense {
+  data := (*[1<<30 - 1]float64)(mem)[:e:e]
+  output := mat.NewDense(r, c, data)
+  runtime.SetFinalizer(output, func(*mat.Dense) {
+    C.free(mem)
+  })
+  return output
+}
+
 // ArmaToGonum returns a gonum matrix based on the memory pointer
 // of an armadillo matrix.
 func (m *mlpackArma) armaToGonumMat(p *params,
@@ -237,16 +242,9 @@ func (m *mlpackArma) armaToGonumMat(p *params,
   // Allocate Go memory pointer to the armadillo matrix.
   m.allocArmaPtrMat(p, identifier)
 
-  // Convert pointer to slice of data, to then pass it to a gonum matrix.
-  array := (*[1<<30 - 1]float64)(m.mem)
-  if array != nil {
-    data := array[:e]
-
-    // Initialize result matrix.
-    output := mat.NewDense(r, c, data)
-
-    // Return gonum vector.
-    return output
+  // Wrap the memory, which the matrix takes ownership of.
+  if m.mem != nil {
+    return wrapArmaMemory(m.mem, r, c, e)
   }
   return mat.NewDense(1, 1, nil)
 }
@@ -282,16 +280,9 @@ func (m *mlpackArma) armaToGonumUmat(p *params,
   // Allocate Go memory pointer to the armadillo matrix.
   m.allocArmaPtrUmat(p, identifier)
 
-  // Convert pointer to slice of data, to then pass it to a gonum matrix.
-  array := (*[1<<30 - 1]float64)(m.mem)
-  if array != nil {
-    data := array[:e]
-
-    // Initialize result matrix.
-    output := mat.NewDense(r, c, data)
-
-    // Return gonum vector.
-    return output
+  // Wrap the memory, which the matrix takes ownership of.
+  if m.mem != nil {
+    return wrapArmaMemory(m.mem, r, c, e)
   }
   return mat.NewDense(1, 1, nil)
 }
@@ -306,16 +297,9 @@ func (m *mlpackArma) armaToGonumRow(p *params,
   // Allocate Go memory pointer to the armadillo matrix.
   m.allocArmaPtrRow(p, identifier)
 
-  // Convert pointer to slice of data, to then pass it to a gonum matrix.
-  array := (*[1<<30 - 1]float64)(m.mem)
-  if array != nil {
-    data := array[:e]
-
-    // Initialize result matrix.
-    output := mat.NewDense(e, 1, data)
-
-    // Return gonum vector.
-    return output
+  // Wrap the memory, which the matrix takes ownership of.
+  if m.mem != nil {
+    return wrapArmaMemory(m.mem, e, 1, e)
   }
   return mat.NewDense(1, 1, nil)
 }
@@ -330,15 +314,9 @@ func (m *mlpackArma) armaToGonumUrow(p *params,
   // Allocate Go memory pointer to the armadillo matrix.
   m.allocArmaPtrUrow(p, identifier)
 
-  // Convert pointer to slice of data, to then pass it to a gonum matrix.
-  array := (*[1<<30 - 1]float64)(m.mem)
-  if array != nil {
-    data := array[:e]
-
-    // Initialize result matrix.
-    output := mat.NewDense(e, 1, data)
-    // Return gonum vector.
-    return output
+  // Wrap the memory, which the matrix takes ownership of.
+  if m.mem != nil {
+    return wrapArmaMemory(m.mem, e, 1, e)
   }
   return mat.NewDense(1, 1, nil)
 }
@@ -353,16 +331,9 @@ func (m *mlpackArma) armaToGonumCol(p *params,
   // Allocate Go memory pointer to the armadillo matrix.
   m.allocArmaPtrCol(p, identifier)
 
-  // Convert pointer to slice of data, to then pass it to a gonum matrix.
-  array := (*[1<<30 - 1]float64)(m.mem)
-  if array != nil {
-    data := array[:e]
-
-    // Initialize result matrix.
-    output := mat.NewDense(1, e, data)
-
-    // Return gonum vector.
-    return output
+  // Wrap the memory, which the matrix takes ownership of.
+  if m.mem != nil {
+    return wrapArmaMemory(m.mem, 1, e, e)
   }
   return mat.NewDense(1, 1, nil)
 }
@@ -377,16 +348,9 @@ func (m *mlpackArma) armaToGonumUcol(p *params,
   // Allocate Go memory pointer to the armadillo matrix.
   m.allocArmaPtrUcol(p, identifier)
 
-  // Convert pointer to slice of data, to then pass it to a gonum matrix.
-  array := (*[1<<30 - 1]float64)(m.mem)
-  if array != nil {
-    data := array[:e]
-
-    // Initialize result matrix.
-    output := mat.NewDense(1, e, data)
-
-    // Return gonum vector.
-    return output
+  // Wrap the memory, which the matrix takes ownership of.
+  if m.mem != nil {
+    return wrapArmaMemory(m.mem, 1, e, e)
   }
   return mat.NewDense(1, 1, nil)
 }
@@ -402,16 +366,10 @@ func (m *mlpackArma) armaToGonumMatWithInfo(p *params,
 
   // Allocate Go memory pointer to the armadillo matrix.
   m.allocArmaPtrMatWithInfo(p, identifier)
-  matarray := (*[1<<30 - 1]float64)(m.mem)
-
-  if matarray != nil {
-    data := matarray[:e]
-
-    // Initialize result matrix.
-    output := mat.NewDense(r, c, data)
 
-    // Return gonum vector.
-    return output
+  // Wrap the memory, which the matrix takes ownership of.
+  if m.mem != nil {
+    return wrapArmaMemory(m.mem, r, c, e)
   }
   return mat.NewDense(1, 1, nil)
 }
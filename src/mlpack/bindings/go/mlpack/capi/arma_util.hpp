@@ -16,6 +16,8 @@
 #include <mlpack/core/util/io.hpp>
 #include <mlpack/core.hpp>
 
+#include <cstdlib>
+
 namespace mlpack {
 
 /**
@@ -23,14 +25,33 @@ namespace mlpack {
  * internal preallocated memory, in which case we copy that and return a
  * pointer to the memory we just made.
  */
+/**
+ * Give the memory of the given Armadillo object to Go, which will free it with
+ * free() once the matrix that wraps it is garbage collected.  The memory is
+ * handed over without a copy when the object allocated it itself with an
+ * allocator compatible with free(); otherwise (if the elements are stored
+ * inside the object, the object aliases memory it does not own, such as an
+ * input matrix from Go, or Armadillo uses another allocator) the elements are
+ * copied into memory from malloc().
+ */
 template<typename T>
 inline typename T::elem_type* GetMemory(T& m)
 {
-  if (m.mem && m.n_elem <= arma::arma_config::mat_prealloc)
+  typedef typename T::elem_type eT;
+
+  #if defined(ARMA_USE_TBB_ALLOC) || defined(ARMA_USE_MKL_ALLOC) || \
+      defined(_MSC_VER)
+  const bool compatibleAllocator = false;
+  #else
+  const bool compatibleAllocator = true;
+  #endif
+
+  if (!compatibleAllocator || m.mem_state != 0 ||
+      m.n_elem <= arma::arma_config::mat_prealloc)
   {
     // We need to allocate new memory.
-    typename T::elem_type* mem =
-        arma::memory::acquire<typename T::elem_type>(m.n_elem);
+    eT* mem = (eT*) std::malloc(sizeof(eT) *
+        std::max(m.n_elem, (arma::uword) 1));
     arma::arrayops::copy(mem, m.memptr(), m.n_elem);
     return mem;
   }
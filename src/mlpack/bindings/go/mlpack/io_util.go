@@ -14,6 +14,9 @@ import (
 
 type params struct {
   mem unsafe.Pointer
+  // Go memory that mlpack uses in place (such as the data of input matrices),
+  // which must be kept alive until the params are cleaned.
+  inputs []interface{}
 }
 
 type timers struct {
@@ -36,6 +39,7 @@ func getTimers() *timers {
 
 func cleanParams(p *params) {
   C.mlpackCleanParams(p.mem)
+  p.inputs = nil
 }
 
 func cleanTimers(t *timers) {
@@ -158,6 +158,47 @@ func TestGonumMatrix(t *testing.T) {
   }
 }
 
+func TestGonumMatrixView(t *testing.T) {
+  t.Log("Test that a view of a larger matrix, which is not contiguous in",
+        "memory, is passed correctly.")
+  x := mat.NewDense(4, 6, []float64{
+    1, 2, 3, 4, 5, 0,
+    6, 7, 8, 9, 10, 0,
+    11, 12, 13, 14, 15, 0,
+    0, 0, 0, 0, 0, 0,
+  })
+  view := x.Slice(0, 3, 0, 5).(*mat.Dense)
+
+  y := mat.NewDense(3, 4, []float64{
+    1, 2, 6, 4,
+    6, 7, 16, 9,
+    11, 12, 26, 14,
+  })
+
+  param := mlpack.TestGoBindingOptions()
+  param.MatrixIn = view
+  d := 4.0
+  i := 12
+  s := "hello"
+  _, _, _, _, MatrixOut, _, _, _, _, _, _, _, _, _ :=
+      mlpack.TestGoBinding(d, i, s, param)
+
+  rows, cols := MatrixOut.Dims()
+  if rows != 3 || cols != 4 {
+    panic("error shape")
+  }
+
+  var z mat.Dense
+  z.Sub(MatrixOut, y)
+  for i := 0; i < rows; i++ {
+    for j := 0; j < cols; j++ {
+      if val := z.At(i, j); val != 0 {
+        t.Errorf("Error. Value at [i,j] : %v", val)
+      }
+    }
+  }
+}
+
 func TestGonumUMatrix(t *testing.T) {
   t.Log("Test that the umatrix we get back should be the umatrix we pass",
         "in with the third dimension doubled and the fifth forgotten.")
@@ -16,6 +16,47 @@
 
 using namespace mlpack;
 
+/**
+ * Give the memory of the given Armadillo object to Julia, which takes
+ * ownership of it and frees it with free() (Base.unsafe_wrap() with own=true).
+ * The memory is handed over without a copy when the object allocated it
+ * itself with an allocator compatible with free(); otherwise (if the elements
+ * are stored inside the object, the object aliases memory it does not own,
+ * such as an input array from Julia, or Armadillo uses another allocator) the
+ * elements are copied into memory from malloc().
+ */
+template<typename MatType>
+typename MatType::elem_type* GiveMemory(MatType& m)
+{
+  typedef typename MatType::elem_type eT;
+
+  #if defined(ARMA_USE_TBB_ALLOC) || defined(ARMA_USE_MKL_ALLOC) || \
+      defined(_MSC_VER)
+  const bool compatibleAllocator = false;
+  #else
+  const bool compatibleAllocator = true;
+  #endif
+
+  if (!compatibleAllocator || m.mem_state != 0 ||
+      m.n_elem <= arma::arma_config::mat_prealloc)
+  {
+    eT* newMem = (eT*) malloc(sizeof(eT) *
+        std::max(m.n_elem, (arma::uword) 1));
+    arma::arrayops::copy(newMem, m.memptr(), m.n_elem);
+    return newMem;
+  }
+  else
+  {
+    arma::access::rw(m.mem_state) = 1;
+    #if ARMA_VERSION_MAJOR >= 10
+      arma::access::rw(m.n_alloc) = 0;
+    #endif
+    return m.memptr();
+  }
+}
+
+using namespace mlpack;
+
 extern "C" {
 
 /**
@@ -375,24 +416,8 @@ double* GetParamMat(void* params, const char* paramName)
 {
   util::Params* p = (util::Params*) params;
 
-  // Are we using preallocated memory?  If so we have to handle this more
-  // carefully.
   arma::mat& mat = p->Get<arma::mat>(paramName);
-  if (mat.n_elem <= arma::arma_config::mat_prealloc)
-  {
-    // Copy the memory to something that we can give back to Julia.
-    double* newMem = new double[mat.n_elem];
-    arma::arrayops::copy(newMem, mat.mem, mat.n_elem);
-    return newMem; // We believe Julia will free it.  Hopefully we are right.
-  }
-  else
-  {
-    arma::access::rw(mat.mem_state) = 1;
-    #if ARMA_VERSION_MAJOR >= 10
-      arma::access::rw(mat.n_alloc) = 0;
-    #endif
-    return mat.memptr();
-  }
+  return GiveMemory(mat);
 }
 
 /**
@@ -421,25 +446,9 @@ size_t GetParamUMatCols(void* params, const char* paramName)
 size_t* GetParamUMat(void* params, const char* paramName)
 {
   util::Params* p = (util::Params*) params;
-  arma::Mat<size_t>& mat = p->Get<arma::Mat<size_t>>(paramName);
 
-  // Are we using preallocated memory?  If so we have to handle this more
-  // carefully.
-  if (mat.n_elem <= arma::arma_config::mat_prealloc)
-  {
-    // Copy the memory to something that we can give back to Julia.
-    size_t* newMem = new size_t[mat.n_elem];
-    arma::arrayops::copy(newMem, mat.mem, mat.n_elem);
-    return newMem; // We believe Julia will free it.  Hopefully we are right.
-  }
-  else
-  {
-    arma::access::rw(mat.mem_state) = 1;
-    #if ARMA_VERSION_MAJOR >= 10
-      arma::access::rw(mat.n_alloc) = 0;
-    #endif
-    return mat.memptr();
-  }
+  arma::Mat<size_t>& mat = p->Get<arma::Mat<size_t>>(paramName);
+  return GiveMemory(mat);
 }
 
 /**
@@ -460,24 +469,8 @@ double* GetParamCol(void* params, const char* paramName)
 {
   util::Params* p = (util::Params*) params;
 
-  // Are we using preallocated memory?  If so we have to handle this more
-  // carefully.
   arma::vec& vec = p->Get<arma::vec>(paramName);
-  if (vec.n_elem <= arma::arma_config::mat_prealloc)
-  {
-    // Copy the memory to something we can give back to Julia.
-    double* newMem = new double[vec.n_elem];
-    arma::arrayops::copy(newMem, vec.mem, vec.n_elem);
-    return newMem; // We believe Julia will free it.  Hopefully we are right.
-  }
-  else
-  {
-    arma::access::rw(vec.mem_state) = 1;
-    #if ARMA_VERSION_MAJOR >= 10
-      arma::access::rw(vec.n_alloc) = 0;
-    #endif
-    return vec.memptr();
-  }
+  return GiveMemory(vec);
 }
 
 /**
@@ -499,24 +492,7 @@ size_t* GetParamUCol(void* params, const char* paramName)
   util::Params* p = (util::Params*) params;
 
   arma::Col<size_t>& vec = p->Get<arma::Col<size_t>>(paramName);
-
-  // Are we using preallocated memory?  If so we have to handle this more
-  // carefully.
-  if (vec.n_elem <= arma::arma_config::mat_prealloc)
-  {
-    // Copy the memory to something we can give back to Julia.
-    size_t* newMem = new size_t[vec.n_elem];
-    arma::arrayops::copy(newMem, vec.mem, vec.n_elem);
-    return newMem; // We believe Julia will free it.  Hopefully we are right.
-  }
-  else
-  {
-    arma::access::rw(vec.mem_state) = 1;
-    #if ARMA_VERSION_MAJOR >= 10
-      arma::access::rw(vec.n_alloc) = 0;
-    #endif
-    return vec.memptr();
-  }
+  return GiveMemory(vec);
 }
 
 /**
@@ -537,24 +513,8 @@ double* GetParamRow(void* params, const char* paramName)
 {
   util::Params* p = (util::Params*) params;
 
-  // Are we using preallocated memory?  If so we have to handle this more
-  // carefully.
   arma::rowvec& vec = p->Get<arma::rowvec>(paramName);
-  if (vec.n_elem <= arma::arma_config::mat_prealloc)
-  {
-    // Copy the memory to something we can give back to Julia.
-    double* newMem = new double[vec.n_elem];
-    arma::arrayops::copy(newMem, vec.mem, vec.n_elem);
-    return newMem;
-  }
-  else
-  {
-    arma::access::rw(vec.mem_state) = 1;
-    #if ARMA_VERSION_MAJOR >= 10
-      arma::access::rw(vec.n_alloc) = 0;
-    #endif
-    return vec.memptr();
-  }
+  return GiveMemory(vec);
 }
 
 /**
@@ -576,24 +536,7 @@ size_t* GetParamURow(void* params, const char* paramName)
   util::Params* p = (util::Params*) params;
 
   arma::Row<size_t>& vec = p->Get<arma::Row<size_t>>(paramName);
-
-  // Are we using preallocated memory?  If so we have to handle this more
-  // carefully.
-  if (vec.n_elem <= arma::arma_config::mat_prealloc)
-  {
-    // Copy the memory to something we can give back to Julia.
-    size_t* newMem = new size_t[vec.n_elem];
-    arma::arrayops::copy(newMem, vec.mem, vec.n_elem);
-    return newMem;
-  }
-  else
-  {
-    arma::access::rw(vec.mem_state) = 1;
-    #if ARMA_VERSION_MAJOR >= 10
-      arma::access::rw(vec.n_alloc) = 0;
-    #endif
-    return vec.memptr();
-  }
+  return GiveMemory(vec);
 }
 
 /**
@@ -628,7 +571,9 @@ bool* GetParamMatWithInfoBoolPtr(void* params, const char* paramName)
   const data::DatasetInfo& d = std::get<0>(
       p->Get<std::tuple<data::DatasetInfo, arma::mat>>(paramName));
 
-  bool* dims = new bool[d.Dimensionality()];
+  // Julia takes ownership of the memory, and frees it with free().
+  bool* dims = (bool*) malloc(sizeof(bool) *
+      std::max(d.Dimensionality(), (size_t) 1));
   for (size_t i = 0; i < d.Dimensionality(); ++i)
     dims[i] = (d.Type(i) == data::Datatype::numeric) ? false : true;
 
@@ -643,24 +588,9 @@ double* GetParamMatWithInfoPtr(void* params, const char* paramName)
 {
   util::Params* p = (util::Params*) params;
 
-  // Are we using preallocated memory?  If so we have to handle this more
-  // carefully.
   arma::mat& m = std::get<1>(
       p->Get<std::tuple<data::DatasetInfo, arma::mat>>(paramName));
-  if (m.n_elem <= arma::arma_config::mat_prealloc)
-  {
-    double* newMem = new double[m.n_elem];
-    arma::arrayops::copy(newMem, m.mem, m.n_elem);
-    return newMem;
-  }
-  else
-  {
-    arma::access::rw(m.mem_state) = 1;
-    #if ARMA_VERSION_MAJOR >= 10
-      arma::access::rw(m.n_alloc) = 0;
-    #endif
-    return m.memptr();
-  }
+  return GiveMemory(m);
 }
 
 /**
@@ -126,6 +126,31 @@ end
   end
 end
 
+# A transposed column-major matrix passed with points as rows is used in place;
+# the results should be the same as with the column-major matrix.
+@testset "TestMatrixTransposed" begin
+  x = rand(5, 100)
+  xCopy = copy(x)
+
+  _, _, _, _, matOut, _, _, _, _, _, _, _, _, _ =
+      test_julia_binding(4.0, 12, "hello",
+                         matrix_in=x',
+                         points_are_rows=true)
+
+  @test x == xCopy
+  @test size(matOut, 1) == 100
+  @test size(matOut, 2) == 4
+  for i in 1:100
+    for j in [0, 1, 3]
+      @test matOut[i, j + 1] == x[j + 1, i]
+    end
+  end
+
+  for i in 1:100
+    @test matOut[i, 3] == 2 * x[3, i]
+  end
+end
+
 # Same as TestMatrix but with an unsigned matrix.
 @testset "TestUMatrix" begin
   # Generate a random matrix of integers.
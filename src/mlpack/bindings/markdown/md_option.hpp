@@ -81,7 +81,10 @@ class MDOption
 
     // Add the option.
     if (identifier != "verbose" && identifier != "copy_all_inputs" &&
-        identifier != "help" && identifier != "info" && identifier != "version")
+        identifier != "help" && identifier != "info" &&
+        identifier != "version" && identifier != "trace_file" &&
+        identifier != "perf_report" && identifier != "perf_report_file" &&
+        identifier != "serve" && identifier != "threads")
     {
       IO::AddParameter(bindingName, std::move(data));
     }
@@ -89,8 +89,28 @@ PARAM_GLOBAL(std::string, "info", "Print help on a specific option.", "",
     "std::string", false, true, false, "");
 PARAM_GLOBAL(bool, "version", "Display the version of mlpack.", "V", "bool",
     false, true, false, false);
+PARAM_GLOBAL(bool, "serve", "Run in server mode: read the options of one "
+    "call per line of standard input, and answer each with a line 'ok' or "
+    "'error: <message>'.  Input models are only loaded again when their file "
+    "changes.", "", "bool", false, true, false, false);
+PARAM_GLOBAL(std::string, "trace_file", "If specified, a trace of the timers "
+    "and traced scopes of the program is written to this file, in the Chrome "
+    "trace event format (viewable in chrome://tracing or Perfetto).", "",
+    "std::string", false, true, false, "");
+PARAM_GLOBAL(std::string, "perf_report", "If specified, a performance report "
+    "of the program (timers, counters, peak memory usage, number of threads "
+    "and sizes of the input matrices) is written in the given format; only "
+    "'json' is supported.", "", "std::string", false, true, false, "");
+PARAM_GLOBAL(std::string, "perf_report_file", "File to write the performance "
+    "report to.  If not specified, it is written to standard output.", "",
+    "std::string", false, true, false, "");
+
+// CLI- and Python-specific parameters.
+PARAM_GLOBAL(int, "threads", "Number of threads to use; 0 uses the OpenMP "
+    "default (set by the OMP_NUM_THREADS environment variable).", "", "int",
+    false, true, false, 0);
 
-// Python-specific parameters.
+// Python- and R-specific parameters.
 PARAM_GLOBAL(bool, "copy_all_inputs", "If specified, all input parameters will "
     "be deep copied before the method is run.  This is useful for debugging "
     "problems where the input parameters are being modified by the algorithm, "
@@ -601,6 +601,7 @@ inline std::string ProgramCall(const std::string& programName)
     // Strip non-CLI options.
     p.Parameters().erase("copy_all_inputs");
     p.Parameters().erase("check_input_matrices");
+    p.Parameters().erase("threads");
 
     s += "bash\n";
     std::string import = PrintImport(GetBindingName(programName));
@@ -614,6 +615,10 @@ inline std::string ProgramCall(const std::string& programName)
     p.Parameters().erase("help");
     p.Parameters().erase("info");
     p.Parameters().erase("version");
+    p.Parameters().erase("trace_file");
+    p.Parameters().erase("perf_report");
+    p.Parameters().erase("perf_report_file");
+    p.Parameters().erase("serve");
 
     s += "python\n";
     std::string import = PrintImport(programName);
@@ -627,8 +632,13 @@ inline std::string ProgramCall(const std::string& programName)
     p.Parameters().erase("help");
     p.Parameters().erase("info");
     p.Parameters().erase("version");
+    p.Parameters().erase("trace_file");
+    p.Parameters().erase("perf_report");
+    p.Parameters().erase("perf_report_file");
+    p.Parameters().erase("serve");
     p.Parameters().erase("copy_all_inputs");
     p.Parameters().erase("check_input_matrices");
+    p.Parameters().erase("threads");
 
     s += "julia\n";
     std::string import = PrintImport(programName);
@@ -642,8 +652,13 @@ inline std::string ProgramCall(const std::string& programName)
     p.Parameters().erase("help");
     p.Parameters().erase("info");
     p.Parameters().erase("version");
+    p.Parameters().erase("trace_file");
+    p.Parameters().erase("perf_report");
+    p.Parameters().erase("perf_report_file");
+    p.Parameters().erase("serve");
     p.Parameters().erase("copy_all_inputs");
     p.Parameters().erase("check_input_matrices");
+    p.Parameters().erase("threads");
 
     s += "go\n";
     std::string import = PrintImport(programName);
@@ -657,6 +672,10 @@ inline std::string ProgramCall(const std::string& programName)
     p.Parameters().erase("help");
     p.Parameters().erase("info");
     p.Parameters().erase("version");
+    p.Parameters().erase("trace_file");
+    p.Parameters().erase("perf_report");
+    p.Parameters().erase("perf_report_file");
+    p.Parameters().erase("serve");
     p.Parameters().erase("copy_all_inputs");
     p.Parameters().erase("check_input_matrices");
 
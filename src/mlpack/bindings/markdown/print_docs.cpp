@@ -129,11 +129,18 @@ void PrintDocs(const std::string& bindingName,
         continue;
 
       // There are some special options that don't exist in some languages.
-      if (languages[i] != "python" && it->second.name == "copy_all_inputs")
+      if (languages[i] != "python" && languages[i] != "r" &&
+          it->second.name == "copy_all_inputs")
+        continue;
+      if (languages[i] != "cli" && languages[i] != "python" &&
+          it->second.name == "threads")
         continue;
       if (languages[i] != "cli" &&
           (it->second.name == "help" || it->second.name == "info" ||
-           it->second.name == "version"))
+           it->second.name == "version" || it->second.name == "trace_file" ||
+           it->second.name == "perf_report" ||
+           it->second.name == "perf_report_file" ||
+           it->second.name == "serve"))
         continue;
 
       // Print name, type, description, default.
@@ -162,7 +169,10 @@ void PrintDocs(const std::string& bindingName,
       cout << desc; // just a string
       // Print whether or not it's a "special" language-only parameter.
       if (it->second.name == "copy_all_inputs" || it->second.name == "help" ||
-          it->second.name == "info" || it->second.name == "version")
+          it->second.name == "info" || it->second.name == "version" ||
+          it->second.name == "trace_file" || it->second.name == "perf_report" ||
+          it->second.name == "perf_report_file" ||
+          it->second.name == "serve")
       {
         cout << "  <span class=\"special\">Only exists in "
             << PrintLanguage(languages[i]) << " binding.</span>";
@@ -226,7 +236,10 @@ void PrintDocs(const std::string& bindingName,
       cout << it->second.desc;
       // Print whether or not it's a "special" language-only parameter.
       if (it->second.name == "copy_all_inputs" || it->second.name == "help" ||
-          it->second.name == "info" || it->second.name == "version")
+          it->second.name == "info" || it->second.name == "version" ||
+          it->second.name == "trace_file" || it->second.name == "perf_report" ||
+          it->second.name == "perf_report_file" ||
+          it->second.name == "serve")
       {
         cout << "  <span class=\"special\">Only exists in "
             << PrintLanguage(languages[i]) << " binding.</span>";
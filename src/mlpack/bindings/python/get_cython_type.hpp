@@ -50,6 +50,16 @@ inline std::string GetCythonType<double>(
   return "double";
 }
 
+template<>
+inline std::string GetCythonType<float>(
+    util::ParamData& /* d */,
+    const typename std::enable_if<!util::IsStdVector<float>::value>::type*,
+    const typename std::enable_if<!data::HasSerialize<float>::value>::type*,
+    const typename std::enable_if<!arma::is_arma_type<float>::value>::type*)
+{
+  return "float";
+}
+
 template<>
 inline std::string GetCythonType<std::string>(
     util::ParamData& /* d */,
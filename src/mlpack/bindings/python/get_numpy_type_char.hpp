@@ -63,6 +63,25 @@ inline std::string GetNumpyTypeChar<arma::rowvec>()
   return "d";
 }
 
+// float = f.
+template<>
+inline std::string GetNumpyTypeChar<arma::fmat>()
+{
+  return "f";
+}
+
+template<>
+inline std::string GetNumpyTypeChar<arma::fvec>()
+{
+  return "f";
+}
+
+template<>
+inline std::string GetNumpyTypeChar<arma::frowvec>()
+{
+  return "f";
+}
+
 } // namespace python
 } // namespace bindings
 } // namespace mlpack
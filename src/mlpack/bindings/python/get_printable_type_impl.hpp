@@ -117,6 +117,12 @@ inline std::string GetPrintableType(
     if (T::is_row || T::is_col)
       type = "vector";
   }
+  else if (std::is_same<typename T::elem_type, float>::value)
+  {
+    type = "float32 matrix";
+    if (T::is_row || T::is_col)
+      type = "float32 vector";
+  }
   else if (std::is_same<typename T::elem_type, size_t>::value)
   {
     type = "int matrix";
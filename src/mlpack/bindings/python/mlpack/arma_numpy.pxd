@@ -28,6 +28,8 @@ cdef arma.Mat[double]* numpy_to_mat_d(numpy.ndarray[numpy.double_t, ndim=2] X, \
                                       bool takeOwnership) except +
 cdef arma.Mat[size_t]* numpy_to_mat_s(numpy.ndarray[numpy.npy_intp, ndim=2] X, \
                                       bool takeOwnership) except +
+cdef arma.Mat[float]* numpy_to_mat_f(numpy.ndarray[numpy.float32_t, ndim=2] X, \
+                                     bool takeOwnership) except +
 
 """
 Convert an Armadillo object to a numpy ndarray of the given type.
@@ -36,6 +38,8 @@ cdef numpy.ndarray[numpy.double_t, ndim=2] mat_to_numpy_d(arma.Mat[double]& X) \
     except +
 cdef numpy.ndarray[numpy.npy_intp, ndim=2] mat_to_numpy_s(arma.Mat[size_t]& X) \
     except +
+cdef numpy.ndarray[numpy.float32_t, ndim=2] mat_to_numpy_f(arma.Mat[float]& X) \
+    except +
 
 """
 Convert a numpy one-dimensional ndarray to a row of the given type.
@@ -44,6 +48,8 @@ cdef arma.Row[double]* numpy_to_row_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
                                       bool takeOwnership) except +
 cdef arma.Row[size_t]* numpy_to_row_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
                                       bool takeOwnership) except +
+cdef arma.Row[float]* numpy_to_row_f(numpy.ndarray[numpy.float32_t, ndim=1] X, \
+                                     bool takeOwnership) except +
 
 """
 Convert an Armadillo row vector to a one-dimensional numpy ndarray of the
@@ -53,6 +59,8 @@ cdef numpy.ndarray[numpy.double_t, ndim=1] row_to_numpy_d(arma.Row[double]& X) \
     except +
 cdef numpy.ndarray[numpy.npy_intp, ndim=1] row_to_numpy_s(arma.Row[size_t]& X) \
     except +
+cdef numpy.ndarray[numpy.float32_t, ndim=1] row_to_numpy_f(arma.Row[float]& X) \
+    except +
 
 """
 Convert a numpy one-dimensional ndarray to a column vector of the given type.
@@ -61,6 +69,8 @@ cdef arma.Col[double]* numpy_to_col_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
                                       bool takeOwnership) except +
 cdef arma.Col[size_t]* numpy_to_col_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
                                       bool takeOwnership) except +
+cdef arma.Col[float]* numpy_to_col_f(numpy.ndarray[numpy.float32_t, ndim=1] X, \
+                                     bool takeOwnership) except +
 
 """
 Convert an Armadillo column vector to a one-dimensional numpy ndarray of the
@@ -70,3 +80,5 @@ cdef numpy.ndarray[numpy.double_t, ndim=1] col_to_numpy_d(arma.Col[double]& X) \
     except +
 cdef numpy.ndarray[numpy.npy_intp, ndim=1] col_to_numpy_s(arma.Col[size_t]& X) \
     except +
+cdef numpy.ndarray[numpy.float32_t, ndim=1] col_to_numpy_f(arma.Col[float]& X) \
+    except +
@@ -12,6 +12,10 @@ object, then the numpy object will "own" the matrix.
 Thus, know that if you convert a matrix type, remember that the resulting type
 is what "owns" the allocated memory.
 
+Arrays whose memory numpy does not own, such as slices and memory-mapped
+arrays, are borrowed without a copy when they are C-contiguous and writeable;
+the Armadillo object then neither owns nor frees the memory.
+
 mlpack is free software; you may redistribute it and/or modify it under the
 terms of the 3-clause BSD license.  You should have received a copy of the
 3-clause BSD license along with mlpack.  If not, see
@@ -42,13 +46,31 @@ cdef extern from "<mlpack/bindings/python/mlpack/arma_util.hpp>":
   size_t* GetMemory(arma.Mat[size_t]& m)
   size_t* GetMemory(arma.Col[size_t]& m)
   size_t* GetMemory(arma.Row[size_t]& m)
+  float* GetMemory(arma.Mat[float]& m)
+  float* GetMemory(arma.Col[float]& m)
+  float* GetMemory(arma.Row[float]& m)
+
+cdef inline bool must_copy(numpy.ndarray X, bool takeOwnership):
+  """
+  Return whether X has to be copied before an Armadillo object can use its
+  memory.  Arrays that numpy does not own (slices, views, memory-mapped arrays)
+  are borrowed as long as they are C-contiguous, since they stay alive for the
+  duration of the call.  But mlpack may modify its input matrices, so read-only
+  arrays are copied, and so are arrays whose memory must be taken over.  On
+  Windows, Armadillo copies the memory itself.
+  """
+  if not X.flags.c_contiguous:
+    return True
+  if isWin:
+    return False
+  return (not X.flags.writeable) or (takeOwnership and not X.flags.owndata)
 
 cdef arma.Mat[double]* numpy_to_mat_d(numpy.ndarray[numpy.double_t, ndim=2] X, \
                                       bool takeOwnership) except +:
   """
   Convert a numpy ndarray to a matrix.  The memory will still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
+  if must_copy(X, takeOwnership):
     # If needed, make a copy where we own the memory.
     X = X.copy(order="C")
     takeOwnership = True
@@ -68,7 +90,7 @@ cdef arma.Mat[size_t]* numpy_to_mat_s(numpy.ndarray[numpy.npy_intp, ndim=2] X, \
   """
   Convert a numpy ndarray to a matrix.  The memory will still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
+  if must_copy(X, takeOwnership):
     # If needed, make a copy where we own the memory, except on Windows where
     # we never copy.
     X = X.copy(order="C")
@@ -132,7 +154,7 @@ cdef arma.Row[double]* numpy_to_row_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a row.  The memory will still be
   owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
+  if must_copy(X, takeOwnership):
     # If needed, make a copy where we own the memory, except on Windows where
     # we never copy.
     X = X.copy(order="C")
@@ -154,7 +176,7 @@ cdef arma.Row[size_t]* numpy_to_row_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a row.  The memory will still be
   owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
+  if must_copy(X, takeOwnership):
     # If needed, make a copy where we own the memory, except on Windows where
     # we never copy.
     X = X.copy(order="C")
@@ -215,7 +237,7 @@ cdef arma.Col[double]* numpy_to_col_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a column vector.  The memory will
   still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
+  if must_copy(X, takeOwnership):
     # If needed, make a copy where we own the memory, except on Windows where
     # we never copy.
     X = X.copy(order="C")
@@ -237,7 +259,7 @@ cdef arma.Col[size_t]* numpy_to_col_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a column vector.  The memory will
   still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
+  if must_copy(X, takeOwnership):
     # If needed, make a copy where we own the memory, except on Windows where
     # we never copy.
     X = X.copy(order="C")
@@ -290,3 +312,127 @@ cdef numpy.ndarray[numpy.npy_intp, ndim=1] col_to_numpy_s(arma.Col[size_t]& X) \
     PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
 
   return output
+
+cdef arma.Mat[float]* numpy_to_mat_f(numpy.ndarray[numpy.float32_t, ndim=2] X, \
+                                     bool takeOwnership) except +:
+  """
+  Convert a numpy ndarray to a matrix.  The memory will still be owned by numpy.
+  """
+  if must_copy(X, takeOwnership):
+    # If needed, make a copy where we own the memory.
+    X = X.copy(order="C")
+    takeOwnership = True
+
+  cdef arma.Mat[float]* m = new arma.Mat[float](<float*> X.data, X.shape[1],\
+      X.shape[0], isWin, False)
+
+  # Take ownership of the memory, if we need to and we are not on Windows.
+  if takeOwnership and not isWin:
+    PyArray_CLEARFLAGS(X, numpy.NPY_OWNDATA)
+    SetMemState[arma.Mat[float]](m[0], 0)
+
+  return m
+
+cdef numpy.ndarray[numpy.float32_t, ndim=2] mat_to_numpy_f(arma.Mat[float]& X) \
+    except +:
+  """
+  Convert an Armadillo object to a numpy ndarray.
+  """
+  # Extract dimensions.
+  cdef numpy.npy_intp dims[2]
+  dims[0] = <numpy.npy_intp> X.n_cols
+  dims[1] = <numpy.npy_intp> X.n_rows
+  cdef numpy.ndarray[numpy.float32_t, ndim=2] output = \
+      numpy.PyArray_SimpleNewFromData(2, &dims[0], numpy.NPY_FLOAT32,
+                                      GetMemory(X))
+  if isWin:
+    output = output.copy(order="C")
+
+  # Transfer memory ownership, if needed.
+  if GetMemState[arma.Mat[float]](X) == 0 and not isWin:
+    SetMemState[arma.Mat[float]](X, 1)
+    PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
+
+  return output
+
+cdef arma.Row[float]* numpy_to_row_f(numpy.ndarray[numpy.float32_t, ndim=1] X, \
+                                     bool takeOwnership) except +:
+  """
+  Convert a numpy one-dimensional ndarray to a row.  The memory will still be
+  owned by numpy.
+  """
+  if must_copy(X, takeOwnership):
+    # If needed, make a copy where we own the memory, except on Windows where
+    # we never copy.
+    X = X.copy(order="C")
+    takeOwnership = True
+
+  cdef arma.Row[float]* m = new arma.Row[float](<float*> X.data, X.shape[0],
+      isWin, False)
+
+  # Transfer memory ownership, if needed.
+  if takeOwnership and not isWin:
+    PyArray_CLEARFLAGS(X, numpy.NPY_OWNDATA)
+    SetMemState[arma.Row[float]](m[0], 0)
+
+  return m
+
+cdef numpy.ndarray[numpy.float32_t, ndim=1] row_to_numpy_f(arma.Row[float]& X) \
+    except +:
+  """
+  Convert an Armadillo row vector to a one-dimensional numpy ndarray.
+  """
+  # Extract dimensions.
+  cdef numpy.npy_intp dim = <numpy.npy_intp> X.n_elem
+  cdef numpy.ndarray[numpy.float32_t, ndim=1] output = \
+      numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_FLOAT32, GetMemory(X))
+  if isWin:
+    output = output.copy(order="C")
+
+  # Transfer memory ownership, if needed.
+  if GetMemState[arma.Row[float]](X) == 0 and not isWin:
+    SetMemState[arma.Row[float]](X, 1)
+    PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
+
+  return output
+
+cdef arma.Col[float]* numpy_to_col_f(numpy.ndarray[numpy.float32_t, ndim=1] X, \
+                                     bool takeOwnership) except +:
+  """
+  Convert a numpy one-dimensional ndarray to a column vector.  The memory will
+  still be owned by numpy.
+  """
+  if must_copy(X, takeOwnership):
+    # If needed, make a copy where we own the memory, except on Windows where
+    # we never copy.
+    X = X.copy(order="C")
+    takeOwnership = True
+
+  cdef arma.Col[float]* m = new arma.Col[float](<float*> X.data, X.shape[0],
+      isWin, False)
+
+  # Transfer memory ownership, if needed.
+  if takeOwnership and not isWin:
+    PyArray_CLEARFLAGS(X, numpy.NPY_OWNDATA)
+    SetMemState[arma.Col[float]](m[0], 0)
+
+  return m
+
+cdef numpy.ndarray[numpy.float32_t, ndim=1] col_to_numpy_f(arma.Col[float]& X) \
+    except +:
+  """
+  Convert an Armadillo column vector to a one-dimensional numpy ndarray.
+  """
+  # Extract dimension.
+  cdef numpy.npy_intp dim = <numpy.npy_intp> X.n_elem
+  cdef numpy.ndarray[numpy.float32_t, ndim=1] output = \
+      numpy.PyArray_SimpleNewFromData(1, &dim, numpy.NPY_FLOAT32, GetMemory(X))
+  if isWin:
+    output = output.copy(order="C")
+
+  # Transfer memory ownership, if needed.
+  if GetMemState[arma.Col[float]](X) == 0 and not isWin:
+    SetMemState[arma.Col[float]](X, 1)
+    PyArray_ENABLEFLAGS(output, numpy.NPY_OWNDATA)
+
+  return output
@@ -30,9 +30,45 @@ std::string SerializeOut(T* t, const std::string& name)
   return oss.str();
 }
 
+/**
+ * Serialize the model into the mapped model format (see
+ * data::SaveMappedModel()), so that the result can also be written to a
+ * .mlmodel file and mapped without a copy with data::MappedModel.
+ */
+template<typename T>
+std::string SerializeOutMapped(T* t, const std::string& name)
+{
+  std::ostringstream oss(std::ios::binary);
+  data::SaveMappedModel(oss, name, *t);
+  return oss.str();
+}
+
+/**
+ * Load the model from a string produced by SerializeOutMapped().  The string
+ * does not outlive the call, so the matrices are copied out of it.
+ */
+template<typename T>
+void SerializeInMapped(T* t, const std::string& str, const std::string& name)
+{
+  data::LoadMappedModel(str.data(), str.size(), name, *t, false);
+}
+
+/**
+ * Load the model from a string produced by SerializeOut() or by
+ * SerializeOutMapped(); the mapped model format is recognized by its header.
+ */
 template<typename T>
 void SerializeIn(T* t, const std::string& str, const std::string& name)
 {
+  uint64_t magic = 0;
+  if (str.size() >= sizeof(cereal::MappedArchiveHeader))
+    std::memcpy(&magic, str.data(), sizeof(magic));
+  if (magic == cereal::MappedArchiveHeader::magicValue)
+  {
+    SerializeInMapped(t, str, name);
+    return;
+  }
+
   std::istringstream iss(str);
   cereal::BinaryInputArchive b(iss);
   b(cereal::make_nvp(name.c_str(), *t));
@@ -72,12 +72,31 @@ using Option = mlpack::bindings::python::PyOption<T>;
 }
 
 #include <mlpack/core/util/param.hpp>
+#include <mlpack/core/util/parallel_policy.hpp>
+#include <mlpack/core/util/timers.hpp>
 
-// In Python, we want to call the binding function mlpack_<BINDING_NAME>()
-// instead of just <BINDING_NAME>(), so we change the definition of
-// BINDING_FUNCTION().
+// In Python, we want to call the binding function mlpack_<BINDING_NAME>(),
+// which runs the body of the binding (renamed mlpack_<BINDING_NAME>_impl())
+// with the number of threads given by the "threads" parameter, so we change
+// the definition of BINDING_FUNCTION().
 #undef BINDING_FUNCTION
-#define BINDING_FUNCTION(...) JOIN(mlpack_, BINDING_NAME)(__VA_ARGS__)
+#define BINDING_FUNCTION(...) \
+    JOIN(JOIN(mlpack_, BINDING_NAME), _impl)(__VA_ARGS__)
+
+// Forward definition of the body of the binding.
+void BINDING_FUNCTION(mlpack::util::Params&, mlpack::util::Timers&);
+
+// Run the binding with the number of threads given by the user.
+inline void JOIN(mlpack_, BINDING_NAME)(mlpack::util::Params& params,
+                                        mlpack::util::Timers& timers)
+{
+  if (params.Get<int>("threads") < 0)
+    throw std::invalid_argument("threads must be nonnegative!");
+
+  mlpack::ParallelScope parallelScope(mlpack::ParallelPolicy(
+      (size_t) params.Get<int>("threads")));
+  BINDING_FUNCTION(params, timers);
+}
 
 // Define parameters available in every Python binding.
 PARAM_GLOBAL(bool, "verbose", "Display informational messages and the full "
@@ -91,5 +110,8 @@ PARAM_GLOBAL(bool, "copy_all_inputs", "If specified, all input parameters "
 PARAM_GLOBAL(bool, "check_input_matrices", "If specified, the input matrix "
     "is checked for NaN and inf values; an exception is thrown if any are "
     "found.", "", "bool", false, true, false, false);
+PARAM_GLOBAL(int, "threads", "Number of threads to use; 0 uses the OpenMP "
+    "default (set by the OMP_NUM_THREADS environment variable).", "", "int",
+    false, true, false, 0);
 
 #endif
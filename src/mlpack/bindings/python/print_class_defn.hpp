@@ -51,6 +51,15 @@ void PrintClassDefn(
     const typename std::enable_if<!arma::is_arma_type<T>::value>::type* = 0,
     const typename std::enable_if<data::HasSerialize<T>::value>::type* = 0)
 {
+  // The object is a handle to the model: it is passed to each call by pointer,
+  // so a trained model is used in place, and it is freed when the last Python
+  // reference to it goes away.  Handles for the outputs of a binding are
+  // created with _allocate=False, so that no default model is built only to be
+  // replaced.  Pickling writes the mapped model format, which can also be
+  // saved as a .mlmodel file and mapped with data::MappedModel; both that
+  // format and the older binary format can be unpickled.  _borrowed holds the
+  // input arrays whose memory the model may point to, so that they outlive it.
+  //
   // First, we have to parse the type.  If we have something like, e.g.,
   // 'LogisticRegression<>', we must convert this to 'LogisticRegression[].'
   std::string strippedType, printedType, defaultsType;
@@ -63,16 +72,19 @@ void PrintClassDefn(
    * cdef class <ModelType>Type:
    *   cdef <ModelType>* modelptr
    *   cdef public dict scrubbed_params
+   *   cdef public list _borrowed
    *
-   *   def __cinit__(self):
-   *     self.modelptr = new <ModelType>()
+   *   def __cinit__(self, bint _allocate=True):
+   *     if _allocate:
+   *       self.modelptr = new <ModelType>()
    *     self.scrubbed_params = dict()
+   *     self._borrowed = []
    *
    *   def __dealloc__(self):
    *     del self.modelptr
    *
    *   def __getstate__(self):
-   *     return SerializeOut(self.modelptr, "<ModelType>")
+   *     return SerializeOutMapped(self.modelptr, "<ModelType>")
    *
    *   def __setstate__(self, state):
    *     SerializeIn(self.modelptr, state, "<ModelType>")
@@ -99,16 +111,19 @@ void PrintClassDefn(
   std::cout << "cdef class " << strippedType << "Type:" << std::endl;
   std::cout << "  cdef " << printedType << "* modelptr" << std::endl;
   std::cout << "  cdef public dict scrubbed_params" << std::endl;
+  std::cout << "  cdef public list _borrowed" << std::endl;
   std::cout << std::endl;
-  std::cout << "  def __cinit__(self):" << std::endl;
-  std::cout << "    self.modelptr = new " << printedType << "()" << std::endl;
+  std::cout << "  def __cinit__(self, bint _allocate=True):" << std::endl;
+  std::cout << "    if _allocate:" << std::endl;
+  std::cout << "      self.modelptr = new " << printedType << "()" << std::endl;
   std::cout << "    self.scrubbed_params = dict()" << std::endl;
+  std::cout << "    self._borrowed = []" << std::endl;
   std::cout << std::endl;
   std::cout << "  def __dealloc__(self):" << std::endl;
   std::cout << "    del self.modelptr" << std::endl;
   std::cout << std::endl;
   std::cout << "  def __getstate__(self):" << std::endl;
-  std::cout << "    return SerializeOut(self.modelptr, \"" << printedType
+  std::cout << "    return SerializeOutMapped(self.modelptr, \"" << printedType
       << "\")" << std::endl;
   std::cout << std::endl;
   std::cout << "  def __setstate__(self, state):" << std::endl;
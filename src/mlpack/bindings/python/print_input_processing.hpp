@@ -267,6 +267,8 @@ void PrintInputProcessing(
    *     param_name_tuple[0].shape = (param_name_tuple[0].size,)
    *   param_name_mat = arma_numpy.numpy_to_mat_s(param_name_tuple[0],
    *       param_name_tuple[1])
+   *   if not param_name_tuple[1]:
+   *     _borrowed_inputs.append(param_name_tuple[0])
    *   SetParam[mat](p, \<const string\> 'param_name', dereference(param_name_mat))
    *   p.SetPassed(\<const string\> 'param_name')
    *
@@ -291,6 +293,9 @@ void PrintInputProcessing(
       std::cout << prefix << "  " << d.name << "_mat = arma_numpy.numpy_to_"
           << GetArmaType<T>() << "_" << GetNumpyTypeChar<T>() << "(" << d.name
           << "_tuple[0], " << d.name << "_tuple[1])" << std::endl;
+      std::cout << prefix << "  if not " << d.name << "_tuple[1]:" << std::endl;
+      std::cout << prefix << "    _borrowed_inputs.append(" << d.name
+          << "_tuple[0])" << std::endl;
       std::cout << prefix << "  SetParam[" << GetCythonType<T>(d)
           << "](p, <const string> '" << d.name << "', dereference("
           << d.name << "_mat))"<< std::endl;
@@ -311,6 +316,9 @@ void PrintInputProcessing(
       std::cout << prefix << "  " << d.name << "_mat = arma_numpy.numpy_to_"
           << GetArmaType<T>() << "_" << GetNumpyTypeChar<T>() << "(" << d.name
           << "_tuple[0], " << d.name << "_tuple[1])" << std::endl;
+      std::cout << prefix << "  if not " << d.name << "_tuple[1]:" << std::endl;
+      std::cout << prefix << "    _borrowed_inputs.append(" << d.name
+          << "_tuple[0])" << std::endl;
       std::cout << prefix << "  SetParam[" << GetCythonType<T>(d)
           << "](p, <const string> '" << d.name << "', dereference("
           << d.name << "_mat))"<< std::endl;
@@ -335,6 +343,9 @@ void PrintInputProcessing(
       std::cout << prefix << d.name << "_mat = arma_numpy.numpy_to_"
           << GetArmaType<T>() << "_" << GetNumpyTypeChar<T>() << "(" << d.name
           << "_tuple[0], " << d.name << "_tuple[1])" << std::endl;
+      std::cout << prefix << "if not " << d.name << "_tuple[1]:" << std::endl;
+      std::cout << prefix << "  _borrowed_inputs.append(" << d.name
+          << "_tuple[0])" << std::endl;
       std::cout << prefix << "SetParam[" << GetCythonType<T>(d)
           << "](p, <const string> '" << d.name << "', dereference("
           << d.name << "_mat))"<< std::endl;
@@ -354,6 +365,9 @@ void PrintInputProcessing(
       std::cout << prefix << d.name << "_mat = arma_numpy.numpy_to_"
           << GetArmaType<T>() << "_" << GetNumpyTypeChar<T>() << "(" << d.name
           << "_tuple[0], " << d.name << "_tuple[1])" << std::endl;
+      std::cout << prefix << "if not " << d.name << "_tuple[1]:" << std::endl;
+      std::cout << prefix << "  _borrowed_inputs.append(" << d.name
+          << "_tuple[0])" << std::endl;
       std::cout << prefix << "SetParam[" << GetCythonType<T>(d)
           << "](p, <const string> '" << d.name << "', dereference(" << d.name
           << "_mat))" << std::endl;
@@ -478,6 +492,9 @@ void PrintInputProcessing(
         << "_tuple[0].shape[0], 1)" << std::endl;
     std::cout << prefix << "  " << d.name << "_mat = arma_numpy.numpy_to_mat_d("
         << d.name << "_tuple[0], " << d.name << "_tuple[1])" << std::endl;
+    std::cout << prefix << "  if not " << d.name << "_tuple[1]:" << std::endl;
+    std::cout << prefix << "    _borrowed_inputs.append(" << d.name
+        << "_tuple[0])" << std::endl;
     std::cout << prefix << "  " << d.name << "_dims = " << d.name
         << "_tuple[2]" << std::endl;
     std::cout << prefix << "  SetParamWithInfo[arma.Mat[double]](p, <const "
@@ -498,6 +515,9 @@ void PrintInputProcessing(
         << "_tuple[0].shape[0], 1)" << std::endl;
     std::cout << prefix << d.name << "_mat = arma_numpy.numpy_to_mat_d("
         << d.name << "_tuple[0], " << d.name << "_tuple[1])" << std::endl;
+    std::cout << prefix << "if not " << d.name << "_tuple[1]:" << std::endl;
+    std::cout << prefix << "  _borrowed_inputs.append(" << d.name
+        << "_tuple[0])" << std::endl;
     std::cout << prefix << d.name << "_dims = " << d.name << "_tuple[2]"
         << std::endl;
     std::cout << prefix << "SetParamWithInfo[arma.Mat[double]](p, <const "
@@ -188,13 +188,17 @@ void PrintOutputProcessing(
     /**
      * This gives us code like:
      *
-     * result = ModelType()
+     * result = ModelType(_allocate=False)
      * (<ModelType?> result).modelptr = GetParamPtr[Model](p, 'name')
+     * (<ModelType?> result)._borrowed = _borrowed_inputs
      */
-    std::cout << prefix << "result = " << strippedType << "Type()" << std::endl;
+    std::cout << prefix << "result = " << strippedType
+        << "Type(_allocate=False)" << std::endl;
     std::cout << prefix << "(<" << strippedType << "Type?> result).modelptr = "
         << "GetParamPtr[" << strippedType << "](p, '" << d.name << "')"
         << std::endl;
+    std::cout << prefix << "(<" << strippedType << "Type?> result)._borrowed = "
+        << "_borrowed_inputs" << std::endl;
 
     /**
      * But we also have to check to ensure there aren't any input model
@@ -210,7 +214,7 @@ void PrintOutputProcessing(
       if (data.input && data.cppType == d.cppType && data.required)
       {
         std::cout << prefix << "if (<" << strippedType
-            << "Type> result).modelptr" << d.name << " == (<" << strippedType
+            << "Type> result).modelptr == (<" << strippedType
             << "Type> " << data.name << ").modelptr:" << std::endl;
         std::cout << prefix << "  (<" << strippedType
             << "Type> result).modelptr = <" << strippedType << "*> 0"
@@ -222,7 +226,7 @@ void PrintOutputProcessing(
         std::cout << prefix << "if " << data.name << " is not None:"
             << std::endl;
         std::cout << prefix << "  if (<" << strippedType
-            << "Type> result).modelptr" << d.name << " == (<" << strippedType
+            << "Type> result).modelptr == (<" << strippedType
             << "Type> " << data.name << ").modelptr:" << std::endl;
         std::cout << prefix << "    (<" << strippedType
             << "Type> result).modelptr = <" << strippedType << "*> 0"
@@ -236,14 +240,17 @@ void PrintOutputProcessing(
     /**
      * This gives us code like:
      *
-     * result['name'] = ModelType()
+     * result['name'] = ModelType(_allocate=False)
      * (<ModelType?> result['name']).modelptr = GetParamPtr[Model](p, 'name'))
+     * (<ModelType?> result['name'])._borrowed = _borrowed_inputs
      */
     std::cout << prefix << "result['" << d.name << "'] = " << strippedType
-        << "Type()" << std::endl;
+        << "Type(_allocate=False)" << std::endl;
     std::cout << prefix << "(<" << strippedType << "Type?> result['" << d.name
         << "']).modelptr = GetParamPtr[" << strippedType << "](p, '" << d.name
         << "')" << std::endl;
+    std::cout << prefix << "(<" << strippedType << "Type?> result['" << d.name
+        << "'])._borrowed = _borrowed_inputs" << std::endl;
 
     /**
      * But we also have to check to ensure there aren't any input model
@@ -80,13 +80,13 @@ void PrintPYX(const util::BindingDetails& doc,
   cout << "from timers cimport Timers" << endl;
   cout << "from io cimport SetParam, SetParamPtr, SetParamWithInfo, "
       << "GetParamPtr" << endl;
-  cout << "from io cimport EnableVerbose, DisableVerbose, DisableBacktrace, "
-      << "ResetTimers, EnableTimers" << endl;
+  cout << "from io cimport EnableVerbose, DisableVerbose, DisableBacktrace"
+      << endl;
   cout << "from matrix_utils import to_matrix, to_matrix_with_info" << endl;
   cout << "from preprocess_json_params import process_params_out, "
       << "process_params_in" << endl;
   cout << "from serialization cimport SerializeIn, SerializeOut, "
-      << "SerializeOutJSON, SerializeInJSON" << endl;
+      << "SerializeOutMapped, SerializeOutJSON, SerializeInJSON" << endl;
   cout << endl;
   cout << "import numpy as np" << endl;
   cout << "cimport numpy as np" << endl;
@@ -191,9 +191,9 @@ void PrintPYX(const util::BindingDetails& doc,
       << "returned." << endl;
   cout << "  \"\"\"" << endl;
 
-  // Reset any timers and disable backtraces.
-  cout << "  ResetTimers()" << endl;
-  cout << "  EnableTimers()" << endl;
+  // Disable backtraces.  The binding records its timings in its own Timers
+  // object, so the global timers are left alone; that way concurrent calls do
+  // not reset each other's timers.
   cout << "  DisableBacktrace()" << endl;
   cout << "  DisableVerbose()" << endl;
 
@@ -213,6 +213,11 @@ void PrintPYX(const util::BindingDetails& doc,
       << "\'bool'!\")" << endl;
   cout << endl;
 
+  // Input matrices whose memory is borrowed rather than copied are collected,
+  // so that any model built from them can keep them alive.
+  cout << "  _borrowed_inputs = []" << endl;
+  cout << endl;
+
   // Do any input processing.
   for (size_t i = 0; i < inputOptions.size(); ++i)
   {
@@ -240,11 +245,15 @@ void PrintPYX(const util::BindingDetails& doc,
   // Before calling mlpackMain(), we check input matrices for NaN values if
   // needed.
   cout << "  if check_input_matrices:" << endl;
-  cout << "    p.CheckInputMatrices()" << endl;
+  cout << "    with nogil:" << endl;
+  cout << "      p.CheckInputMatrices()" << endl;
 
-  // Call the method.
+  // Call the method.  The GIL is released for the call, so that other Python
+  // threads (including other mlpack calls) can run in the meantime; all the
+  // Python objects were converted before, and the outputs are converted after.
   cout << "  # Call the mlpack program." << endl;
-  cout << "  mlpack_" << bindingName << "(p, t)" << endl;
+  cout << "  with nogil:" << endl;
+  cout << "    mlpack_" << bindingName << "(p, t)" << endl;
 
   // Do any output processing and return.
   cout << "  # Initialize result dictionary." << endl;
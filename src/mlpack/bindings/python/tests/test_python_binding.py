@@ -13,6 +13,8 @@ import unittest
 import pandas as pd
 import numpy as np
 import copy
+import pickle
+import threading
 
 from mlpack.test_python_binding import test_python_binding
 
@@ -131,6 +133,38 @@ class TestPythonBinding(unittest.TestCase):
     for j in range(100):
       self.assertEqual(2 * x[j, 2], output['matrix_out'][j, 2])
 
+  def testNumpyMatrixBorrowed(self):
+    """
+    Matrices that numpy does not own (a slice) or that are read-only should
+    give the same result as a matrix that numpy owns.
+    """
+    x = np.random.rand(200, 5)
+    z = copy.deepcopy(x)
+    r = copy.deepcopy(x[100:, :])
+    r.flags.writeable = False
+
+    for matrix in [z[100:, :], r]:
+      output = test_python_binding(string_in='hello',
+                                   int_in=12,
+                                   double_in=4.0,
+                                   mat_req_in=[[1.0]],
+                                   col_req_in=[1.0],
+                                   matrix_in=matrix)
+
+      self.assertEqual(output['matrix_out'].shape[0], 100)
+      self.assertEqual(output['matrix_out'].shape[1], 4)
+      for i in [0, 1, 3]:
+        for j in range(100):
+          self.assertEqual(x[100 + j, i], output['matrix_out'][j, i])
+
+      for j in range(100):
+        self.assertEqual(2 * x[100 + j, 2], output['matrix_out'][j, 2])
+
+    # The read-only matrix must not have been modified.
+    for i in range(5):
+      for j in range(100):
+        self.assertEqual(x[100 + j, i], r[j, i])
+
   def testNumpyMatrixForceCopy(self):
     """
     The matrix we pass in, we should get back with the third dimension doubled
@@ -1336,6 +1370,53 @@ class TestPythonBinding(unittest.TestCase):
     self.assertEqual(output2['model_bw_out'], 20.0)
     self.assertEqual(output3['model_bw_out'], 20.0)
 
+  def testModelPickle(self):
+    """
+    Pickle a model, make sure the unpickled model gives the same result, and
+    make sure that a model passed as input to several calls is left intact.
+    """
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 mat_req_in=[[1.0]],
+                                 col_req_in=[1.0],
+                                 build_model=True)
+
+    model = pickle.loads(pickle.dumps(output['model_out']))
+    for i in range(3):
+      output2 = test_python_binding(string_in='hello',
+                                    int_in=12,
+                                    double_in=4.0,
+                                    mat_req_in=[[1.0]],
+                                    col_req_in=[1.0],
+                                    model_in=model)
+      self.assertEqual(output2['model_bw_out'], 20.0)
+
+  def testConcurrentCalls(self):
+    """
+    Run the binding from several threads at once (the GIL is released during
+    the call), and make sure each thread gets its own result.
+    """
+    results = [None] * 4
+    def run(i):
+      results[i] = test_python_binding(string_in='hello',
+                                       int_in=12,
+                                       double_in=4.0,
+                                       mat_req_in=[[1.0]],
+                                       col_req_in=[1.0],
+                                       matrix_in=np.full((1000, 5), float(i)))
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(4)]
+    for t in threads:
+      t.start()
+    for t in threads:
+      t.join()
+
+    for i in range(4):
+      self.assertEqual(results[i]['matrix_out'].shape, (1000, 4))
+      self.assertTrue(np.all(results[i]['matrix_out'][:, 0] == i))
+      self.assertTrue(np.all(results[i]['matrix_out'][:, 2] == 2 * i))
+
   def testCheckInputMatricesNaN(self):
     """
     Checks that an exception is thrown if the input matrix contains
@@ -17,6 +17,7 @@
 #include <cereal/archives/json.hpp>
 
 #include <mlpack/core/cereal/array_wrapper.hpp>
+#include <mlpack/core/cereal/mapped_binary_archive.hpp>
 
 #include <armadillo>
 
@@ -83,6 +84,62 @@ void serialize(Archive& ar, arma::Mat<eT>& mat)
     ar(cereal::make_nvp("elem", arma::access::rw(mat.mem[i])));
 }
 
+// With the mapped binary archive, the memory of a Mat is written as a separate
+// aligned blob, and only its offset in the file goes through the archive.
+template<typename eT>
+void serialize(MappedBinaryOutputArchive& ar, arma::Mat<eT>& mat)
+{
+  arma::uword n_rows = mat.n_rows;
+  arma::uword n_cols = mat.n_cols;
+  arma::uword vec_state = mat.vec_state;
+  uint64_t offset = (mat.n_elem == 0) ? 0 :
+      ar.saveBlob(mat.memptr(), sizeof(eT) * mat.n_elem);
+
+  ar(CEREAL_NVP(n_rows));
+  ar(CEREAL_NVP(n_cols));
+  ar(CEREAL_NVP(vec_state));
+  ar(CEREAL_NVP(offset));
+}
+
+// When loading with the mapped binary archive, the memory of the Mat is either
+// copied out of the file, or the Mat is made a strict alias of the file, which
+// then has to outlive it.
+template<typename eT>
+void serialize(MappedBinaryInputArchive& ar, arma::Mat<eT>& mat)
+{
+  arma::uword n_rows, n_cols, vec_state;
+  uint64_t offset;
+
+  ar(CEREAL_NVP(n_rows));
+  ar(CEREAL_NVP(n_cols));
+  ar(CEREAL_NVP(vec_state));
+  ar(CEREAL_NVP(offset));
+
+  if (n_rows == 0 || n_cols == 0)
+  {
+    mat.set_size(n_rows, n_cols);
+    arma::access::rw(mat.vec_state) = vec_state;
+    return;
+  }
+
+  if (n_cols > (std::numeric_limits<size_t>::max() / sizeof(eT)) / n_rows)
+    throw Exception("Invalid matrix size in mapped binary archive!");
+  const char* blob = ar.loadBlob(offset, sizeof(eT) * n_rows * n_cols);
+
+  if (ar.aliasBlobs())
+  {
+    mat.~Mat();
+    new (&mat) arma::Mat<eT>((eT*) blob, n_rows, n_cols, false, true);
+  }
+  else
+  {
+    mat.set_size(n_rows, n_cols);
+    std::memcpy(mat.memptr(), blob, sizeof(eT) * mat.n_elem);
+  }
+
+  arma::access::rw(mat.vec_state) = vec_state;
+}
+
 // Add a serialization function for armadillo Cube
 template<typename Archive, typename eT>
 void serialize(Archive& ar, arma::Cube<eT>& cube)
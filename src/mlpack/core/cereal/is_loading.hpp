@@ -21,6 +21,8 @@
 #include <cereal/archives/xml.hpp>
 #include <cereal/archives/json.hpp>
 
+#include "mapped_binary_archive.hpp"
+
 namespace cereal {
 
 template<typename Archive>
@@ -33,7 +35,8 @@ struct is_cereal_archive
 // #if (BINDING_TYPE != BINDING_TYPE_R)
       std::is_same<Archive, cereal::JSONInputArchive>::value ||
 // #endif
-      std::is_same<Archive, cereal::XMLInputArchive>::value;
+      std::is_same<Archive, cereal::XMLInputArchive>::value ||
+      std::is_same<Archive, cereal::MappedBinaryInputArchive>::value;
 };
 
 template<typename Archive>
@@ -22,6 +22,8 @@
 #include <cereal/archives/xml.hpp>
 #include <cereal/archives/json.hpp>
 
+#include "mapped_binary_archive.hpp"
+
 namespace cereal {
 
 template<typename Archive>
@@ -34,7 +36,8 @@ struct is_cereal_archive_saving
 // #if (BINDING_TYPE != BINDING_TYPE_R)
       std::is_same<Archive, cereal::JSONOutputArchive>::value ||
 // #endif
-      std::is_same<Archive, cereal::XMLOutputArchive>::value;
+      std::is_same<Archive, cereal::XMLOutputArchive>::value ||
+      std::is_same<Archive, cereal::MappedBinaryOutputArchive>::value;
 };
 
 template<typename Archive>
@@ -0,0 +1,247 @@
+/**
+ * @file core/cereal/mapped_binary_archive.hpp
+ *
+ * Definition of the mapped binary cereal archives, which store the memory of
+ * large Armadillo objects as aligned blobs that can be memory-mapped.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_CEREAL_MAPPED_BINARY_ARCHIVE_HPP
+#define MLPACK_CORE_CEREAL_MAPPED_BINARY_ARCHIVE_HPP
+
+#include <cereal/cereal.hpp>
+
+namespace cereal {
+
+/**
+ * The header of an mlpack mapped model file (extension .mlmodel), as written
+ * by data::Save() with format::mapped.  The file is laid out as follows:
+ *
+ *  - this 64-byte header, in the byte order of the machine that wrote it;
+ *  - the memory of each Armadillo matrix of the model, each starting at a
+ *    multiple of 64 bytes (the blobs);
+ *  - the rest of the model (scalars, small containers, and the sizes and
+ *    blob offsets of the matrices), as written by MappedBinaryOutputArchive,
+ *    which writes like cereal::BinaryOutputArchive.
+ */
+struct MappedArchiveHeader
+{
+  //! Identifier at the start of each file ("MLPKMDL1").
+  static constexpr uint64_t magicValue = 0x314C444D4B504C4DULL;
+  //! The current version of the format.
+  static constexpr uint32_t currentVersion = 1;
+  //! The alignment of the blobs, in bytes.
+  static constexpr uint64_t alignment = 64;
+
+  uint64_t magic;
+  uint32_t version;
+  uint32_t reserved32;
+  //! The offset of the archive stream in the file.
+  uint64_t streamOffset;
+  //! The size of the archive stream in bytes.
+  uint64_t streamSize;
+  uint64_t reserved[4];
+};
+
+/**
+ * An output archive that writes like cereal::BinaryOutputArchive, except that
+ * Armadillo matrices write their memory as a separate blob with saveBlob(),
+ * and only their sizes and the offset of the blob go through the archive
+ * stream.  The blobs are written to their own stream, aligned to
+ * MappedArchiveHeader::alignment bytes relative to the start of the file.
+ */
+class MappedBinaryOutputArchive :
+    public OutputArchive<MappedBinaryOutputArchive, AllowEmptyClassElision>
+{
+ public:
+  /**
+   * Construct the archive.
+   *
+   * @param stream Stream to write the archive stream to.
+   * @param blobs Stream to write the blobs to.
+   * @param blobOffset Offset in the file of the next byte written to blobs.
+   */
+  MappedBinaryOutputArchive(std::ostream& stream,
+                            std::ostream& blobs,
+                            const uint64_t blobOffset) :
+      OutputArchive<MappedBinaryOutputArchive, AllowEmptyClassElision>(this),
+      stream(stream),
+      blobs(blobs),
+      blobOffset(blobOffset)
+  { }
+
+  //! Write the given bytes to the archive stream.
+  void saveBinary(const void* data, std::streamsize size)
+  {
+    const std::streamsize written = stream.rdbuf()->sputn(
+        reinterpret_cast<const char*>(data), size);
+    if (written != size)
+    {
+      throw Exception("Failed to write " + std::to_string(size) + " bytes to "
+          "output stream! Wrote " + std::to_string(written));
+    }
+  }
+
+  /**
+   * Write the given bytes as an aligned blob, and return the offset of the
+   * blob in the file.
+   */
+  uint64_t saveBlob(const void* data, const size_t size)
+  {
+    const char padding[MappedArchiveHeader::alignment] = { 0 };
+    const uint64_t aligned = (blobOffset + MappedArchiveHeader::alignment - 1) &
+        ~(MappedArchiveHeader::alignment - 1);
+    blobs.write(padding, aligned - blobOffset);
+    blobs.write(reinterpret_cast<const char*>(data), size);
+    if (!blobs.good())
+    {
+      throw Exception("Failed to write blob of " + std::to_string(size) +
+          " bytes to output stream!");
+    }
+
+    blobOffset = aligned + size;
+    return aligned;
+  }
+
+  //! Get the offset in the file after the last blob.
+  uint64_t BlobEnd() const { return blobOffset; }
+
+ private:
+  //! The archive stream.
+  std::ostream& stream;
+  //! The stream the blobs are written to.
+  std::ostream& blobs;
+  //! The offset in the file of the next byte written to the blob stream.
+  uint64_t blobOffset;
+};
+
+/**
+ * An input archive that reads what MappedBinaryOutputArchive writes.  The
+ * whole file must be in memory (usually, memory-mapped).  Armadillo matrices
+ * either copy their memory out of the file, or, if aliasBlobs() is true, use
+ * the memory of the file directly; the file then has to stay mapped for as
+ * long as the matrices are used.
+ */
+class MappedBinaryInputArchive :
+    public InputArchive<MappedBinaryInputArchive, AllowEmptyClassElision>
+{
+ public:
+  /**
+   * Construct the archive.
+   *
+   * @param stream Stream to read the archive stream from.
+   * @param file Start of the file in memory.
+   * @param fileSize Size of the file in bytes.
+   * @param alias Whether matrices should use the memory of the file.
+   */
+  MappedBinaryInputArchive(std::istream& stream,
+                           const char* file,
+                           const size_t fileSize,
+                           const bool alias) :
+      InputArchive<MappedBinaryInputArchive, AllowEmptyClassElision>(this),
+      stream(stream),
+      file(file),
+      fileSize(fileSize),
+      alias(alias)
+  { }
+
+  //! Read the given number of bytes from the archive stream.
+  void loadBinary(void* const data, std::streamsize size)
+  {
+    const std::streamsize read = stream.rdbuf()->sgetn(
+        reinterpret_cast<char*>(data), size);
+    if (read != size)
+    {
+      throw Exception("Failed to read " + std::to_string(size) + " bytes from "
+          "input stream! Read " + std::to_string(read));
+    }
+  }
+
+  //! Get the blob of the given size at the given offset in the file.
+  const char* loadBlob(const uint64_t offset, const size_t size) const
+  {
+    if (offset % MappedArchiveHeader::alignment != 0 || offset > fileSize ||
+        size > fileSize - offset)
+    {
+      throw Exception("Invalid blob of " + std::to_string(size) + " bytes at "
+          "offset " + std::to_string(offset) + "!");
+    }
+
+    return file + offset;
+  }
+
+  //! Get whether matrices should use the memory of the file.
+  bool aliasBlobs() const { return alias; }
+
+ private:
+  //! The archive stream.
+  std::istream& stream;
+  //! The start of the file in memory.
+  const char* file;
+  //! The size of the file.
+  size_t fileSize;
+  //! Whether matrices should use the memory of the file.
+  bool alias;
+};
+
+//! Saving for arithmetic types.
+template<class T>
+inline typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+CEREAL_SAVE_FUNCTION_NAME(MappedBinaryOutputArchive& ar, const T& t)
+{
+  ar.saveBinary(std::addressof(t), sizeof(t));
+}
+
+//! Loading for arithmetic types.
+template<class T>
+inline typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+CEREAL_LOAD_FUNCTION_NAME(MappedBinaryInputArchive& ar, T& t)
+{
+  ar.loadBinary(std::addressof(t), sizeof(t));
+}
+
+//! Names are not stored.
+template<class Archive, class T>
+inline CEREAL_ARCHIVE_RESTRICT(MappedBinaryInputArchive,
+                               MappedBinaryOutputArchive)
+CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar, NameValuePair<T>& t)
+{
+  ar(t.value);
+}
+
+//! Sizes of containers are stored as they are.
+template<class Archive, class T>
+inline CEREAL_ARCHIVE_RESTRICT(MappedBinaryInputArchive,
+                               MappedBinaryOutputArchive)
+CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar, SizeTag<T>& t)
+{
+  ar(t.size);
+}
+
+//! Saving binary data.
+template<class T>
+inline void CEREAL_SAVE_FUNCTION_NAME(MappedBinaryOutputArchive& ar,
+                                      const BinaryData<T>& bd)
+{
+  ar.saveBinary(bd.data, static_cast<std::streamsize>(bd.size));
+}
+
+//! Loading binary data.
+template<class T>
+inline void CEREAL_LOAD_FUNCTION_NAME(MappedBinaryInputArchive& ar,
+                                      BinaryData<T>& bd)
+{
+  ar.loadBinary(bd.data, static_cast<std::streamsize>(bd.size));
+}
+
+} // namespace cereal
+
+CEREAL_REGISTER_ARCHIVE(cereal::MappedBinaryOutputArchive)
+CEREAL_REGISTER_ARCHIVE(cereal::MappedBinaryInputArchive)
+CEREAL_SETUP_ARCHIVE_TRAITS(cereal::MappedBinaryInputArchive,
+                            cereal::MappedBinaryOutputArchive)
+
+#endif
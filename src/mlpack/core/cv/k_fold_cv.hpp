@@ -44,6 +44,14 @@ namespace cv {
  * the @c Shuffle() function.  Shuffling is performed at construction time if
  * the parameter @c shuffle is set to @c true in the constructor.
  *
+ * The folds are trained and evaluated concurrently.  The training subsets are
+ * not copied: the data is extended once at construction time (by repeating
+ * its first k - 2 bins), so that each training subset is a contiguous block of
+ * columns that can be aliased.  The number of threads can be set with
+ * @c NumThreads(); they are split between the folds and the threads each model
+ * uses for its own training.  With @c NumThreads() equal to 1, the folds are
+ * trained one after another.
+ *
  * @tparam MLAlgorithm A machine learning algorithm.
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam MatType The type of data.
@@ -180,6 +188,23 @@ class KFoldCV
   //! Access and modify a model from the last run of k-fold cross-validation.
   MLAlgorithm& Model();
 
+  //! Get the number of threads used to run k-fold cross-validation (0 means
+  //! all the threads OpenMP provides).
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used to run k-fold cross-validation (0
+  //! means all the threads OpenMP provides).
+  size_t& NumThreads() { return numThreads; }
+
+  /**
+   * Get the fraction of each training subset that models are trained on.  Only
+   * the first points of each subset are used, so the data should be shuffled.
+   * This is used by SuccessiveHalving to assess hyper-parameters cheaply; the
+   * default is 1.0.
+   */
+  double TrainingFraction() const { return trainingFraction; }
+  //! Modify the fraction of each training subset that models are trained on.
+  double& TrainingFraction() { return trainingFraction; }
+
  private:
   //! A short alias for CVBase.
   using Base = CVBase<MLAlgorithm, MatType, PredictionsType, WeightsType>;
@@ -225,6 +250,12 @@ class KFoldCV
   //! A pointer to a model from the last run of k-fold cross-validation.
   std::unique_ptr<MLAlgorithm> modelPtr;
 
+  //! The number of threads to use (0 means all available threads).
+  size_t numThreads;
+
+  //! The fraction of each training subset that models are trained on.
+  double trainingFraction;
+
   /**
    * Assert the k parameter and data consistency and initialize fields required
    * for running k-fold cross-validation.
@@ -270,6 +301,19 @@ class KFoldCV
            typename = void>
   double TrainAndEvaluate(const MLAlgorithmArgs& ...mlAlgorithmArgs);
 
+  /**
+   * Train a model on each fold with the given function, and store the
+   * evaluation of each model on its validation subset.  The folds are
+   * processed in parallel, and the threads left over are given to each model
+   * for its own training.
+   *
+   * @param evaluations Vector to store the evaluation of each fold in.
+   * @param trainFold Function that trains and returns a model on the ith
+   *     training subset.
+   */
+  template<typename TrainFoldType>
+  void TrainFolds(arma::vec& evaluations, const TrainFoldType& trainFold);
+
   /**
    * Calculate the index of the first column of the ith validation subset.
    *
@@ -135,7 +135,9 @@ KFoldCV<MLAlgorithm,
                               const PredictionsType& ys,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    numThreads(0),
+    trainingFraction(1.0)
 {
   if (k < 2)
     throw std::invalid_argument("KFoldCV: k should not be less than 2");
@@ -166,7 +168,9 @@ KFoldCV<MLAlgorithm,
                               const WeightsType& weights,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    numThreads(0),
+    trainingFraction(1.0)
 {
   Base::AssertWeightsConsistency(xs, weights);
 
@@ -245,14 +249,15 @@ double KFoldCV<MLAlgorithm,
                 WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
 {
   arma::vec evaluations(k);
+  TrainFolds(evaluations, [&](const size_t i)
+  {
+    return base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
+        args...);
+  });
 
   size_t numInvalidScores = 0;
   for (size_t i = 0; i < k; ++i)
   {
-    MLAlgorithm&& model  = base.Train(GetTrainingSubset(xs, i),
-        GetTrainingSubset(ys, i), args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
     if (std::isnan(evaluations(i)) || std::isinf(evaluations(i)))
     {
       ++numInvalidScores;
@@ -260,8 +265,6 @@ double KFoldCV<MLAlgorithm,
           << "a score of " << evaluations(i) << "; ignoring when computing "
           << "the average score." << std::endl;
     }
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
   }
 
   if (numInvalidScores == k)
@@ -287,23 +290,83 @@ double KFoldCV<MLAlgorithm,
                 WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
 {
   arma::vec evaluations(k);
-
-  for (size_t i = 0; i < k; ++i)
+  TrainFolds(evaluations, [&](const size_t i)
   {
-    MLAlgorithm&& model = (weights.n_elem > 0) ?
+    return (weights.n_elem > 0) ?
         base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
             GetTrainingSubset(weights, i), args...) :
         base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
             args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
-  }
+  });
 
   return arma::mean(evaluations);
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename TrainFoldType>
+void KFoldCV<MLAlgorithm,
+             Metric,
+             MatType,
+             PredictionsType,
+             WeightsType>::TrainFolds(arma::vec& evaluations,
+                                      const TrainFoldType& trainFold)
+{
+  // Split the threads between the folds and the models.
+  #ifdef HAS_OPENMP
+    const size_t threads = (numThreads == 0) ?
+        (size_t) omp_get_max_threads() : numThreads;
+  #else
+    const size_t threads = 1;
+  #endif
+  const size_t foldThreads = std::min(threads, k);
+  const size_t modelThreads = std::max(threads / foldThreads, (size_t) 1);
+
+  #ifdef HAS_OPENMP
+    // The models can only use their threads if nested parallelism is enabled.
+    const int maxActiveLevels = omp_get_max_active_levels();
+    if (foldThreads > 1 && modelThreads > 1)
+      omp_set_max_active_levels(std::max(maxActiveLevels, 2));
+  #endif
+
+  // Exceptions cannot leave the parallel region, so they are rethrown after.
+  std::vector<std::exception_ptr> exceptions(k);
+
+  #pragma omp parallel for num_threads(foldThreads) schedule(dynamic, 1)
+  for (omp_size_t i = 0; i < (omp_size_t) k; ++i)
+  {
+    #ifdef HAS_OPENMP
+      omp_set_num_threads((int) modelThreads);
+    #endif
+
+    try
+    {
+      MLAlgorithm&& model = trainFold(i);
+      evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
+          GetValidationSubset(ys, i));
+      if ((size_t) i == k - 1)
+        modelPtr.reset(new MLAlgorithm(std::move(model)));
+    }
+    catch (...)
+    {
+      exceptions[i] = std::current_exception();
+    }
+  }
+
+  #ifdef HAS_OPENMP
+    omp_set_max_active_levels(maxActiveLevels);
+  #endif
+
+  for (size_t i = 0; i < k; ++i)
+  {
+    if (exceptions[i])
+      std::rethrow_exception(exceptions[i]);
+  }
+}
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -388,8 +451,10 @@ arma::Mat<ElementType> KFoldCV<MLAlgorithm,
   // If this is not the first fold, we have to handle it a little bit
   // differently, since the last fold may contain slightly more than 'binSize'
   // points.
-  const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
+  const size_t fullSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
       (k - 1) * binSize;
+  const size_t subsetSize = std::min(fullSize, std::max((size_t) 1,
+      (size_t) std::ceil(trainingFraction * fullSize)));
 
   return arma::Mat<ElementType>(m.colptr(binSize * i), m.n_rows, subsetSize,
       false, true);
@@ -412,8 +477,10 @@ arma::Row<ElementType> KFoldCV<MLAlgorithm,
   // If this is not the first fold, we have to handle it a little bit
   // differently, since the last fold may contain slightly more than 'binSize'
   // points.
-  const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
+  const size_t fullSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
       (k - 1) * binSize;
+  const size_t subsetSize = std::min(fullSize, std::max((size_t) 1,
+      (size_t) std::ceil(trainingFraction * fullSize)));
 
   return arma::Row<ElementType>(r.colptr(binSize * i), subsetSize, false, true);
 }
@@ -12,6 +12,8 @@
 #ifndef MLPACK_CORE_CV_METRICS_ACCURACY_IMPL_HPP
 #define MLPACK_CORE_CV_METRICS_ACCURACY_IMPL_HPP
 
+#include <mlpack/core/cv/metrics/facilities.hpp>
+
 namespace mlpack {
 namespace cv {
 
@@ -22,9 +24,10 @@ double Accuracy::Evaluate(MLAlgorithm& model,
 {
   util::CheckSameSizes(data, labels, "Accuracy::Evaluate()");
 
-  arma::Row<size_t> predictedLabels;
-  model.Classify(data, predictedLabels);
-  size_t amountOfCorrectPredictions = arma::sum(predictedLabels == labels);
+  // The correct predictions are on the diagonal of the confusion matrix.
+  const arma::Mat<size_t> confusion = ChunkedConfusionMatrix(model, data,
+      labels);
+  size_t amountOfCorrectPredictions = arma::trace(confusion);
 
   return (double) amountOfCorrectPredictions / labels.n_elem;
 }
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_CV_METRICS_F1_IMPL_HPP
 
 #include <mlpack/core/cv/metrics/accuracy.hpp>
+#include <mlpack/core/cv/metrics/facilities.hpp>
 
 namespace mlpack {
 namespace cv {
@@ -34,12 +35,13 @@ double F1<AS, PC>::Evaluate(MLAlgorithm& model,
 {
   util::CheckSameSizes(data, labels, "F1<Binary>::Evaluate()");
 
-  arma::Row<size_t> predictedLabels;
-  model.Classify(data, predictedLabels);
+  // Rows of the confusion matrix are predictions, columns are labels.
+  const arma::Mat<size_t> confusion = ChunkedConfusionMatrix(model, data,
+      labels, PC + 1);
 
-  size_t tp = arma::sum((labels == PC) % (predictedLabels == PC));
-  size_t numberOfPositivePredictions = arma::sum(predictedLabels == PC);
-  size_t numberOfPositiveClassInstances = arma::sum(labels == PC);
+  size_t tp = confusion(PC, PC);
+  size_t numberOfPositivePredictions = arma::accu(confusion.row(PC));
+  size_t numberOfPositiveClassInstances = arma::accu(confusion.col(PC));
 
   double precision = double(tp) / numberOfPositivePredictions;
   double recall = double(tp) / numberOfPositiveClassInstances;
@@ -71,17 +73,19 @@ double F1<AS, PC>::Evaluate(MLAlgorithm& model,
 {
   util::CheckSameSizes(data, labels, "F1<Macro>::Evaluate()");
 
-  arma::Row<size_t> predictedLabels;
-  model.Classify(data, predictedLabels);
-
   size_t numClasses = arma::max(labels) + 1;
 
+  const arma::Mat<size_t> confusion = ChunkedConfusionMatrix(model, data,
+      labels, numClasses);
+  const arma::Col<size_t> predictionCounts = arma::sum(confusion, 1);
+  const arma::Row<size_t> labelCounts = arma::sum(confusion, 0);
+
   arma::vec f1s = arma::vec(numClasses);
   for (size_t c = 0; c < numClasses; ++c)
   {
-    size_t tp = arma::sum((labels == c) % (predictedLabels == c));
-    size_t positivePredictions = arma::sum(predictedLabels == c);
-    size_t positiveLabels = arma::sum(labels == c);
+    size_t tp = confusion(c, c);
+    size_t positivePredictions = predictionCounts[c];
+    size_t positiveLabels = labelCounts[c];
 
     double precision = double(tp) / positivePredictions;
     double recall = double(tp) / positiveLabels;
@@ -15,6 +15,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/data/confusion_matrix.hpp>
 
 namespace mlpack {
 namespace cv {
@@ -42,6 +43,131 @@ DataType PairwiseDistances(const DataType& data,
   return distances;
 }
 
+/**
+ * The number of points the metrics predict at once.  Only the predictions of
+ * one chunk of points are held in memory at any time.
+ */
+constexpr size_t metricsChunkSize = 16384;
+
+/**
+ * Call function(chunk, begin) for consecutive chunks of at most chunkSize
+ * columns of the given data, where chunk holds the columns starting at begin.
+ * If the data fits in one chunk, it is passed directly, without a copy.
+ *
+ * @param data Column-major data to split.
+ * @param function Function to call on each chunk.
+ * @param chunkSize Maximum number of columns of a chunk.
+ */
+template<typename DataType, typename FunctionType>
+void ForEachChunk(const DataType& data,
+                  FunctionType&& function,
+                  const size_t chunkSize = metricsChunkSize)
+{
+  if (data.n_cols <= chunkSize)
+  {
+    function(data, 0);
+    return;
+  }
+
+  for (size_t begin = 0; begin < data.n_cols; begin += chunkSize)
+  {
+    const size_t end = std::min(begin + chunkSize, (size_t) data.n_cols) - 1;
+    const DataType chunk = data.cols(begin, end);
+    function(chunk, begin);
+  }
+}
+
+/**
+ * Classify the given data one chunk at a time, and accumulate the confusion
+ * matrix of the predictions (see data::ConfusionMatrix()): element (i, j) is
+ * the number of points of class j predicted as class i.  The matrix is large
+ * enough to hold both the largest label and the largest prediction.
+ *
+ * @param model A classification model.
+ * @param data Column-major data containing test items.
+ * @param labels Ground truth (correct) labels for the test items.
+ * @param minClasses Minimum number of rows and columns of the result.
+ */
+template<typename MLAlgorithm, typename DataType>
+arma::Mat<size_t> ChunkedConfusionMatrix(MLAlgorithm& model,
+                                         const DataType& data,
+                                         const arma::Row<size_t>& labels,
+                                         const size_t minClasses = 0)
+{
+  arma::Mat<size_t> confusion(minClasses, minClasses, arma::fill::zeros);
+  arma::Mat<size_t> chunkConfusion;
+  ForEachChunk(data, [&](const DataType& chunk, const size_t begin)
+  {
+    arma::Row<size_t> predictions;
+    model.Classify(chunk, predictions);
+    if (predictions.n_elem != chunk.n_cols)
+    {
+      throw std::invalid_argument("the model predicted the wrong number of "
+          "labels");
+    }
+
+    // This is an alias, not a copy.
+    const arma::Row<size_t> chunkLabels(
+        const_cast<size_t*>(labels.colptr(begin)), chunk.n_cols, false, true);
+    const size_t numClasses = std::max((size_t) confusion.n_rows,
+        chunk.n_cols == 0 ? 0 :
+        std::max(predictions.max(), chunkLabels.max()) + 1);
+    if (numClasses > confusion.n_rows)
+      confusion.resize(numClasses, numClasses);
+
+    data::ConfusionMatrix(predictions, chunkLabels, chunkConfusion,
+        numClasses);
+    confusion += chunkConfusion;
+  });
+
+  return confusion;
+}
+
+/**
+ * Predict the responses of the given data one chunk at a time, and return the
+ * sum of the squared differences between the predictions and the given
+ * responses.  The sum of each chunk is computed in parallel.
+ *
+ * @param model A regression model.
+ * @param data Column-major data containing test items.
+ * @param responses Ground truth (correct) responses for the test items.
+ */
+template<typename MLAlgorithm, typename DataType, typename ResponsesType>
+double ChunkedSquaredError(MLAlgorithm& model,
+                           const DataType& data,
+                           const ResponsesType& responses)
+{
+  double sum = 0.0;
+  ForEachChunk(data, [&](const DataType& chunk, const size_t begin)
+  {
+    ResponsesType predictions;
+    model.Predict(chunk, predictions);
+    if (predictions.n_rows != responses.n_rows ||
+        predictions.n_cols != chunk.n_cols)
+    {
+      throw std::invalid_argument("the model predicted responses of the wrong "
+          "size");
+    }
+
+    const size_t rows = responses.n_rows;
+    double chunkSum = 0.0;
+    #pragma omp parallel for reduction(+:chunkSum) schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) chunk.n_cols; ++i)
+    {
+      for (size_t r = 0; r < rows; ++r)
+      {
+        const double diff = double(responses(r, begin + i)) -
+            double(predictions(r, i));
+        chunkSum += diff * diff;
+      }
+    }
+
+    sum += chunkSum;
+  });
+
+  return sum;
+}
+
 } // namespace cv
 } // namespace mlpack
 
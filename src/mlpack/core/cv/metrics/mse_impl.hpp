@@ -12,6 +12,8 @@
 #ifndef MLPACK_CORE_CV_METRICS_MSE_IMPL_HPP
 #define MLPACK_CORE_CV_METRICS_MSE_IMPL_HPP
 
+#include <mlpack/core/cv/metrics/facilities.hpp>
+
 namespace mlpack {
 namespace cv {
 
@@ -23,9 +25,8 @@ double MSE::Evaluate(MLAlgorithm& model,
   util::CheckSameSizes(data, (size_t) responses.n_cols, "MSE::Evaluate()",
       "responses");
 
-  ResponsesType predictedResponses;
-  model.Predict(data, predictedResponses);
-  double sum = arma::accu(arma::square(responses - predictedResponses));
+  // The responses are predicted and compared one chunk at a time.
+  double sum = ChunkedSquaredError(model, data, responses);
 
   return sum / responses.n_elem;
 }
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_CV_METRICS_PRECISION_IMPL_HPP
 
 #include <mlpack/core/cv/metrics/accuracy.hpp>
+#include <mlpack/core/cv/metrics/facilities.hpp>
 
 namespace mlpack {
 namespace cv {
@@ -34,11 +35,12 @@ double Precision<AS, PC>::Evaluate(MLAlgorithm& model,
 {
   util::CheckSameSizes(data, labels, "Precision<Binary>::Evaluate()");
 
-  arma::Row<size_t> predictedLabels;
-  model.Classify(data, predictedLabels);
+  // Rows of the confusion matrix are predictions, columns are labels.
+  const arma::Mat<size_t> confusion = ChunkedConfusionMatrix(model, data,
+      labels, PC + 1);
 
-  size_t tp = arma::sum((labels == PC) % (predictedLabels == PC));
-  size_t numberOfPositivePredictions = arma::sum(predictedLabels == PC);
+  size_t tp = confusion(PC, PC);
+  size_t numberOfPositivePredictions = arma::accu(confusion.row(PC));
 
   return double(tp) / numberOfPositivePredictions;
 }
@@ -65,16 +67,17 @@ double Precision<AS, PC>::Evaluate(MLAlgorithm& model,
 {
   util::CheckSameSizes(data, labels, "Precision<Macro>::Evaluate()");
 
-  arma::Row<size_t> predictedLabels;
-  model.Classify(data, predictedLabels);
-
   size_t numClasses = arma::max(labels) + 1;
 
+  const arma::Mat<size_t> confusion = ChunkedConfusionMatrix(model, data,
+      labels, numClasses);
+  const arma::Col<size_t> predictionCounts = arma::sum(confusion, 1);
+
   arma::vec precisions = arma::vec(numClasses);
   for (size_t c = 0; c < numClasses; ++c)
   {
-    size_t tp = arma::sum((labels == c) % (predictedLabels == c));
-    size_t numberOfPositivePredictions = arma::sum(predictedLabels == c);
+    size_t tp = confusion(c, c);
+    size_t numberOfPositivePredictions = predictionCounts[c];
     precisions(c) = double(tp) / numberOfPositivePredictions;
   }
 
@@ -12,6 +12,8 @@
 #ifndef MLPACK_CORE_CV_METRICS_R2SCORE_IMPL_HPP
 #define MLPACK_CORE_CV_METRICS_R2SCORE_IMPL_HPP
 
+#include <mlpack/core/cv/metrics/facilities.hpp>
+
 namespace mlpack {
 namespace cv {
 
@@ -24,15 +26,12 @@ double R2Score<AdjustedR2>::Evaluate(MLAlgorithm& model,
   util::CheckSameSizes(data, (size_t) responses.n_cols, "R2Score::Evaluate()",
       "responses");
 
-  ResponsesType predictedResponses;
-  // Taking Predicted Output from the model.
-  model.Predict(data, predictedResponses);
   // Mean value of response.
   double meanResponses = arma::mean(responses);
 
-  // Calculate the numerator i.e. residual sum of squares.
-  double residualSumSquared = arma::accu(arma::square(responses -
-      predictedResponses));
+  // Calculate the numerator i.e. residual sum of squares, predicting the
+  // responses one chunk at a time.
+  double residualSumSquared = ChunkedSquaredError(model, data, responses);
 
   // Calculate the denominator i.e.total sum of squares.
   double totalSumSquared = arma::accu(arma::square(responses - meanResponses));
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_CV_METRICS_RECALL_IMPL_HPP
 
 #include <mlpack/core/cv/metrics/accuracy.hpp>
+#include <mlpack/core/cv/metrics/facilities.hpp>
 
 namespace mlpack {
 namespace cv {
@@ -34,11 +35,12 @@ double Recall<AS, PC>::Evaluate(MLAlgorithm& model,
 {
   util::CheckSameSizes(data, labels, "Recall<Binary>::Evaluate()");
 
-  arma::Row<size_t> predictedLabels;
-  model.Classify(data, predictedLabels);
+  // Rows of the confusion matrix are predictions, columns are labels.
+  const arma::Mat<size_t> confusion = ChunkedConfusionMatrix(model, data,
+      labels, PC + 1);
 
-  size_t tp = arma::sum((labels == PC) % (predictedLabels == PC));
-  size_t numberOfPositiveClassInstances = arma::sum(labels == PC);
+  size_t tp = confusion(PC, PC);
+  size_t numberOfPositiveClassInstances = arma::accu(confusion.col(PC));
 
   return double(tp) / numberOfPositiveClassInstances;
 }
@@ -65,16 +67,17 @@ double Recall<AS, PC>::Evaluate(MLAlgorithm& model,
 {
   util::CheckSameSizes(data, labels, "Recall<Macro>::Evaluate()");
 
-  arma::Row<size_t> predictedLabels;
-  model.Classify(data, predictedLabels);
-
   size_t numClasses = arma::max(labels) + 1;
 
+  const arma::Mat<size_t> confusion = ChunkedConfusionMatrix(model, data,
+      labels, numClasses);
+  const arma::Row<size_t> labelCounts = arma::sum(confusion, 0);
+
   arma::vec recalls = arma::vec(numClasses);
   for (size_t c = 0; c < numClasses; ++c)
   {
-    size_t tp = arma::sum((labels == c) % (predictedLabels == c));
-    size_t positiveLabels = arma::sum(labels == c);
+    size_t tp = confusion(c, c);
+    size_t positiveLabels = labelCounts[c];
     recalls(c) = double(tp) / positiveLabels;
   }
 
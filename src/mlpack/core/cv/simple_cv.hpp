@@ -14,6 +14,7 @@
 
 #include <mlpack/core/cv/meta_info_extractor.hpp>
 #include <mlpack/core/cv/cv_base.hpp>
+#include <mlpack/core/data/split_data.hpp>
 
 namespace mlpack {
 namespace cv {
@@ -211,6 +212,27 @@ class SimpleCV
   //! Access and modify the last trained model.
   MLAlgorithm& Model();
 
+  /**
+   * Validate on the given points, and train on the other ones, instead of on
+   * the last points of the data; for instance, to validate on a stratified
+   * split computed with data::StratifiedSplitIndices().  The points are
+   * reordered in place, so no data is copied.
+   *
+   * @param validationIndices Indices of the validation points in the data
+   *     passed to the constructor.
+   */
+  void ValidationPoints(const arma::uvec& validationIndices);
+
+  /**
+   * Get the fraction of the training points that models are trained on.  Only
+   * the first points of the training set are used, so the data should be
+   * shuffled.  This is used by SuccessiveHalving to assess hyper-parameters
+   * cheaply; the default is 1.0.
+   */
+  double TrainingFraction() const { return trainingFraction; }
+  //! Modify the fraction of the training points that models are trained on.
+  double& TrainingFraction() { return trainingFraction; }
+
  private:
   //! A short alias for CVBase.
   using Base = CVBase<MLAlgorithm, MatType, PredictionsType, WeightsType>;
@@ -240,6 +262,22 @@ class SimpleCV
   //! The pointer to the last trained model.
   std::unique_ptr<MLAlgorithm> modelPtr;
 
+  //! The fraction of the training points that models are trained on.
+  double trainingFraction;
+
+  //! The index in the data passed to the constructor of each point of xs (if
+  //! empty, the points have not been reordered).
+  arma::uvec pointOrder;
+
+  /**
+   * Get the number of training points that models are trained on.
+   */
+  size_t NumTrainingPoints() const
+  {
+    const size_t n = (size_t) std::ceil(trainingFraction * trainingXs.n_cols);
+    return std::min(std::max(n, (size_t) 1), (size_t) trainingXs.n_cols);
+  }
+
   /**
    * Assert data consistency and initialize fields required for running
    * cross-validation.
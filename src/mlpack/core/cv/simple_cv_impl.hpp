@@ -143,7 +143,8 @@ SimpleCV<MLAlgorithm,
                                 PIT&& ys) :
     base(std::move(base)),
     xs(std::forward<MIT>(xs)),
-    ys(std::forward<PIT>(ys))
+    ys(std::forward<PIT>(ys)),
+    trainingFraction(1.0)
 {
   Base::AssertDataConsistency(this->xs, this->ys);
 
@@ -215,6 +216,71 @@ MLAlgorithm& SimpleCV<MLAlgorithm,
   return *modelPtr;
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+void SimpleCV<MLAlgorithm,
+              Metric,
+              MatType,
+              PredictionsType,
+              WeightsType>::ValidationPoints(
+    const arma::uvec& validationIndices)
+{
+  const size_t numPoints = xs.n_cols;
+  std::vector<bool> validation(numPoints, false);
+  for (size_t i = 0; i < validationIndices.n_elem; ++i)
+  {
+    if (validationIndices[i] >= numPoints || validation[validationIndices[i]])
+    {
+      throw std::invalid_argument("SimpleCV::ValidationPoints(): the indices "
+          "should be distinct and less than the number of points");
+    }
+    validation[validationIndices[i]] = true;
+  }
+
+  if (validationIndices.n_elem == 0 || validationIndices.n_elem == numPoints)
+  {
+    throw std::invalid_argument("SimpleCV::ValidationPoints(): both the "
+        "training set and the validation set should be non-empty");
+  }
+
+  // Find where each point of the original data is now.
+  if (pointOrder.is_empty())
+    pointOrder = arma::linspace<arma::uvec>(0, numPoints - 1, numPoints);
+  arma::uvec position(numPoints);
+  position.elem(pointOrder) = arma::linspace<arma::uvec>(0, numPoints - 1,
+      numPoints);
+
+  // Put the training points first (in their original order), then the
+  // validation points.
+  const size_t numTrainingPoints = numPoints - validationIndices.n_elem;
+  arma::uvec newPointOrder(numPoints);
+  size_t trainingIndex = 0;
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    if (!validation[i])
+      newPointOrder[trainingIndex++] = i;
+  }
+  newPointOrder.tail(validationIndices.n_elem) = validationIndices;
+
+  const arma::uvec permutation = position.elem(newPointOrder);
+  data::PermuteColumns(xs, permutation);
+  data::PermuteColumns(ys, permutation);
+  if (!weights.is_empty())
+    data::PermuteColumns(weights, permutation);
+  pointOrder = newPointOrder;
+
+  trainingXs = GetSubset(xs, 0, numTrainingPoints - 1);
+  trainingYs = GetSubset(ys, 0, numTrainingPoints - 1);
+  if (!weights.is_empty())
+    trainingWeights = GetSubset(weights, 0, numTrainingPoints - 1);
+
+  validationXs = GetSubset(xs, numTrainingPoints, numPoints - 1);
+  validationYs = GetSubset(ys, numTrainingPoints, numPoints - 1);
+}
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -258,8 +324,9 @@ arma::Mat<ElementType> SimpleCV<MLAlgorithm,
     const size_t firstCol,
     const size_t lastCol)
 {
+  // The alias is not strict, so that it can be replaced by another alias.
   return arma::Mat<ElementType>(m.colptr(firstCol), m.n_rows,
-      lastCol - firstCol + 1, false, true);
+      lastCol - firstCol + 1, false, false);
 }
 
 template<typename MLAlgorithm,
@@ -278,7 +345,7 @@ arma::Row<ElementType> SimpleCV<MLAlgorithm,
     const size_t lastCol)
 {
   return arma::Row<ElementType>(r.colptr(firstCol), lastCol - firstCol + 1,
-      false, true);
+      false, false);
 }
 
 template<typename MLAlgorithm,
@@ -293,7 +360,9 @@ double SimpleCV<MLAlgorithm,
                 PredictionsType,
                 WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
 {
-  modelPtr.reset(new MLAlgorithm(base.Train(trainingXs, trainingYs, args...)));
+  const size_t n = NumTrainingPoints();
+  modelPtr.reset(new MLAlgorithm(base.Train(GetSubset(trainingXs, 0, n - 1),
+      GetSubset(trainingYs, 0, n - 1), args...)));
 
   return Metric::Evaluate(*modelPtr, validationXs, validationYs);
 }
@@ -310,12 +379,16 @@ double SimpleCV<MLAlgorithm,
                 PredictionsType,
                 WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
 {
+  const size_t n = NumTrainingPoints();
   if (trainingWeights.n_elem > 0)
     modelPtr.reset(new MLAlgorithm(
-        base.Train(trainingXs, trainingYs, trainingWeights, args...)));
+        base.Train(GetSubset(trainingXs, 0, n - 1),
+        GetSubset(trainingYs, 0, n - 1), GetSubset(trainingWeights, 0, n - 1),
+        args...)));
   else
     modelPtr.reset(new MLAlgorithm(
-        base.Train(trainingXs, trainingYs, args...)));
+        base.Train(GetSubset(trainingXs, 0, n - 1),
+        GetSubset(trainingYs, 0, n - 1), args...)));
 
   return Metric::Evaluate(*modelPtr, validationXs, validationYs);
 }
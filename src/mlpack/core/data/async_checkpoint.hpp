@@ -0,0 +1,138 @@
+/**
+ * @file core/data/async_checkpoint.hpp
+ *
+ * Definition of AsyncCheckpoint, an ensmallen callback that saves the model
+ * being trained at the end of epochs, without stopping the training while the
+ * file is written.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_ASYNC_CHECKPOINT_HPP
+#define MLPACK_CORE_DATA_ASYNC_CHECKPOINT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "async_saver.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * AsyncCheckpoint is an ensmallen callback that saves the model being trained
+ * every given number of epochs with an AsyncSaver: at the end of the epoch,
+ * only the parameters being optimized are copied into a snapshot of the model,
+ * and the snapshot is written on a background thread while the training goes
+ * on.  The rest of the model (for a network, its layers) is copied once, with
+ * the first snapshot of each of the two buffers of the saver.
+ *
+ * The model must have a Parameters() function that returns the matrix being
+ * optimized, as FFN, RNN and BRNN have:
+ *
+ * @code
+ * FFN<NegativeLogLikelihood<>> model;
+ * // ... add the layers ...
+ * data::AsyncCheckpoint<FFN<NegativeLogLikelihood<>>> checkpoint(model,
+ *     "model.bin", "model");
+ * model.Train(predictors, responses, optimizer, checkpoint);
+ * @endcode
+ *
+ * The last snapshot is written when the callback is destroyed, or after
+ * Wait().
+ *
+ * @tparam ModelType Type of the model being trained.
+ */
+template<typename ModelType>
+class AsyncCheckpoint
+{
+ public:
+  /**
+   * Create the callback.
+   *
+   * @param model The model being trained.
+   * @param filename Name of the file to save to; it is overwritten by each
+   *     checkpoint.
+   * @param name Name of the model in the file.
+   * @param period Number of epochs between two checkpoints.
+   * @param f Format of the file (detected from the extension by default).
+   */
+  AsyncCheckpoint(const ModelType& model,
+                  const std::string& filename,
+                  const std::string& name = "model",
+                  const size_t period = 1,
+                  const format f = format::autodetect) :
+      model(model),
+      filename(filename),
+      name(name),
+      period(period),
+      f(f),
+      epochs(0)
+  {
+    if (period == 0)
+    {
+      throw std::invalid_argument("AsyncCheckpoint::AsyncCheckpoint(): the "
+          "period must be at least 1");
+    }
+  }
+
+  /**
+   * Callback function called at the end of a pass over the data; a snapshot of
+   * the model with the given parameters is saved every `period` epochs.
+   *
+   * @param optimizer The optimizer used to update the function.
+   * @param function Function to optimize.
+   * @param coordinates Starting point.
+   * @param epoch The index of the current epoch.
+   * @param objective Objective value of the current point.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool EndEpoch(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& coordinates,
+                const size_t /* epoch */,
+                const double /* objective */)
+  {
+    if (++epochs % period != 0)
+      return false;
+
+    const ModelType& trained = model;
+    saver.SaveSnapshot(filename, name,
+        [&trained, &coordinates](std::unique_ptr<ModelType>& buffer)
+    {
+      if (!buffer)
+        buffer.reset(new ModelType(trained));
+      buffer->Parameters() = coordinates;
+    }, f);
+
+    return false;
+  }
+
+  //! Wait until the checkpoints taken so far are written.
+  void Wait() { saver.Wait(); }
+
+  //! Get the saver used to write the checkpoints.
+  const AsyncSaver<ModelType>& Saver() const { return saver; }
+
+ private:
+  //! The model being trained.
+  const ModelType& model;
+  //! The file to save to.
+  std::string filename;
+  //! The name of the model in the file.
+  std::string name;
+  //! The number of epochs between two checkpoints.
+  size_t period;
+  //! The format of the file.
+  format f;
+  //! The number of epochs seen so far.
+  size_t epochs;
+  //! The saver that writes the checkpoints.
+  AsyncSaver<ModelType> saver;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
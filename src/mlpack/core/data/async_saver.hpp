@@ -0,0 +1,159 @@
+/**
+ * @file core/data/async_saver.hpp
+ *
+ * Definition of AsyncSaver, which saves snapshots of a model to file on a
+ * background thread, so that the caller (typically a training loop) does not
+ * wait for the file to be written.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_ASYNC_SAVER_HPP
+#define MLPACK_CORE_DATA_ASYNC_SAVER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "format.hpp"
+#include "save.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * An AsyncSaver saves snapshots of a model to file with data::Save() on a
+ * background thread.  Save() only copies the model into one of two buffers and
+ * returns; the buffer is then serialized while the caller goes on.  While one
+ * buffer is being written, the next snapshot is copied into the other one, so
+ * the caller never waits for a file to be written; if a new snapshot is taken
+ * before the previous one was started, the previous one is dropped, so that
+ * the latest snapshot is always the next one written.
+ *
+ * Each snapshot is written to a temporary file in the same directory, that is
+ * then renamed, so that the file is never left half-written if the program
+ * stops during the write.
+ *
+ * @code
+ * RandomForest<> rf;
+ * data::AsyncSaver<RandomForest<>> saver;
+ * for (size_t i = 0; i < rounds; ++i)
+ * {
+ *   rf.Train(data, labels, numClasses, 10 * (i + 1));
+ *   saver.Save("forest.bin", "forest", rf);
+ * }
+ * saver.Wait();
+ * @endcode
+ *
+ * Snapshots must be taken from a single thread.  The destructor waits for the
+ * last snapshot to be written.
+ *
+ * @tparam T Type of the model to save; it must be copy-constructible and
+ *     serializable.
+ */
+template<typename T>
+class AsyncSaver
+{
+ public:
+  //! Create the saver and start its background thread.
+  AsyncSaver();
+
+  //! Write the pending snapshot, if any, and stop the background thread.
+  ~AsyncSaver();
+
+  //! The background thread cannot be copied.
+  AsyncSaver(const AsyncSaver& other) = delete;
+  //! The background thread cannot be copied.
+  AsyncSaver& operator=(const AsyncSaver& other) = delete;
+
+  /**
+   * Copy the given model and save it on the background thread, with the same
+   * arguments as data::Save().
+   *
+   * @param filename Name of the file to save to.
+   * @param name Name of the model in the file.
+   * @param t Model to save.
+   * @param f Format of the file (detected from the extension by default).
+   */
+  void Save(const std::string& filename,
+            const std::string& name,
+            const T& t,
+            const format f = format::autodetect);
+
+  /**
+   * Take a snapshot with the given function and save it on the background
+   * thread.  The function is given the buffer to fill, a std::unique_ptr<T>
+   * that is empty for the first snapshot in the buffer and otherwise holds a
+   * previous snapshot; it can thus copy only what changed since (for instance,
+   * only the parameters of a network).
+   *
+   * @param filename Name of the file to save to.
+   * @param name Name of the model in the file.
+   * @param snapshot Function that fills the buffer.
+   * @param f Format of the file (detected from the extension by default).
+   */
+  template<typename SnapshotType>
+  void SaveSnapshot(const std::string& filename,
+                    const std::string& name,
+                    SnapshotType snapshot,
+                    const format f = format::autodetect);
+
+  //! Wait until all the snapshots taken so far are written.
+  void Wait();
+
+  //! Get the number of snapshots written.
+  size_t Written() const;
+  //! Get the number of snapshots that could not be written.
+  size_t Failed() const;
+  //! Get the number of snapshots replaced by a newer one before being written.
+  size_t Dropped() const;
+
+ private:
+  //! The loop of the background thread.
+  void Run();
+
+  //! Write the snapshot of the given buffer; return whether it succeeded.
+  bool Write(const size_t slot);
+
+  //! The two snapshot buffers.
+  std::unique_ptr<T> buffers[2];
+  //! The file of each buffer.
+  std::string filenames[2];
+  //! The name of the model of each buffer.
+  std::string names[2];
+  //! The format of each buffer.
+  format formats[2];
+
+  //! The buffer being written, or -1.
+  int writing;
+  //! The buffer waiting to be written, or -1.
+  int pending;
+  //! Whether the background thread must stop.
+  bool stop;
+
+  //! The number of snapshots written.
+  size_t written;
+  //! The number of snapshots that could not be written.
+  size_t failed;
+  //! The number of snapshots dropped.
+  size_t dropped;
+
+  //! The lock that protects the state of the buffers.
+  mutable std::mutex mutex;
+  //! Signaled when a snapshot is pending or written.
+  std::condition_variable condition;
+  //! The background thread.
+  std::thread writer;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "async_saver_impl.hpp"
+
+#endif
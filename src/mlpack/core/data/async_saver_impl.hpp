@@ -0,0 +1,203 @@
+/**
+ * @file core/data/async_saver_impl.hpp
+ *
+ * Implementation of AsyncSaver.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_ASYNC_SAVER_IMPL_HPP
+#define MLPACK_CORE_DATA_ASYNC_SAVER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "async_saver.hpp"
+
+#include <cstdio>
+
+namespace mlpack {
+namespace data {
+
+template<typename T>
+AsyncSaver<T>::AsyncSaver() :
+    writing(-1),
+    pending(-1),
+    stop(false),
+    written(0),
+    failed(0),
+    dropped(0)
+{
+  formats[0] = formats[1] = format::autodetect;
+  writer = std::thread(&AsyncSaver::Run, this);
+}
+
+template<typename T>
+AsyncSaver<T>::~AsyncSaver()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  condition.notify_all();
+  writer.join();
+}
+
+template<typename T>
+void AsyncSaver<T>::Save(const std::string& filename,
+                         const std::string& name,
+                         const T& t,
+                         const format f)
+{
+  SaveSnapshot(filename, name, [&t](std::unique_ptr<T>& buffer)
+  {
+    if (buffer)
+      *buffer = t;
+    else
+      buffer.reset(new T(t));
+  }, f);
+}
+
+template<typename T>
+template<typename SnapshotType>
+void AsyncSaver<T>::SaveSnapshot(const std::string& filename,
+                                 const std::string& name,
+                                 SnapshotType snapshot,
+                                 const format f)
+{
+  // Take the buffer that is not being written; if it holds a snapshot that was
+  // not started yet, that snapshot is replaced.
+  int slot;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    slot = (writing == 0) ? 1 : 0;
+    if (pending == slot)
+    {
+      pending = -1;
+      ++dropped;
+    }
+  }
+
+  // The background thread never touches a buffer that is not pending, so the
+  // copy is done without the lock.
+  snapshot(buffers[slot]);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    filenames[slot] = filename;
+    names[slot] = name;
+    formats[slot] = f;
+    if (pending != -1)
+      ++dropped;
+    pending = slot;
+  }
+  condition.notify_all();
+}
+
+template<typename T>
+void AsyncSaver<T>::Wait()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  condition.wait(lock, [this]() { return pending == -1 && writing == -1; });
+}
+
+template<typename T>
+size_t AsyncSaver<T>::Written() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return written;
+}
+
+template<typename T>
+size_t AsyncSaver<T>::Failed() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return failed;
+}
+
+template<typename T>
+size_t AsyncSaver<T>::Dropped() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return dropped;
+}
+
+template<typename T>
+void AsyncSaver<T>::Run()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true)
+  {
+    condition.wait(lock, [this]() { return stop || pending != -1; });
+
+    // The pending snapshot is still written when the saver is destroyed.
+    if (pending == -1)
+      return;
+
+    writing = pending;
+    pending = -1;
+    const size_t slot = writing;
+
+    lock.unlock();
+    const bool success = Write(slot);
+    lock.lock();
+
+    writing = -1;
+    if (success)
+      ++written;
+    else
+      ++failed;
+    condition.notify_all();
+  }
+}
+
+template<typename T>
+bool AsyncSaver<T>::Write(const size_t slot)
+{
+  // Write to a temporary file with the same extension, so that the format is
+  // detected in the same way, and rename it once it is complete.
+  const std::string& filename = filenames[slot];
+  const size_t dot = filename.rfind('.');
+  const std::string tmpFilename = (dot == std::string::npos) ?
+      filename + ".tmp" :
+      filename.substr(0, dot) + ".tmp" + filename.substr(dot);
+
+  bool success;
+  try
+  {
+    success = data::Save(tmpFilename, names[slot], *buffers[slot], false,
+        formats[slot]);
+  }
+  catch (std::exception& e)
+  {
+    Log::Warn << "AsyncSaver: saving '" << filename << "' failed: " << e.what()
+        << std::endl;
+    success = false;
+  }
+
+  if (!success)
+  {
+    std::remove(tmpFilename.c_str());
+    return false;
+  }
+
+  // Renaming over an existing file fails on some platforms.
+  if (std::rename(tmpFilename.c_str(), filename.c_str()) != 0)
+  {
+    std::remove(filename.c_str());
+    if (std::rename(tmpFilename.c_str(), filename.c_str()) != 0)
+    {
+      Log::Warn << "AsyncSaver: cannot rename '" << tmpFilename << "' to '"
+          << filename << "'." << std::endl;
+      std::remove(tmpFilename.c_str());
+      return false;
+    }
+  }
+
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
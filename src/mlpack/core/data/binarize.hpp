@@ -79,6 +79,7 @@ void Binarize(const arma::Mat<T>& input,
               const double threshold,
               const size_t dimension)
 {
+  // This does nothing if output is input.
   output = input;
 
   #pragma omp parallel for
@@ -86,6 +87,56 @@ void Binarize(const arma::Mat<T>& input,
     output(dimension, i) = input(dimension, i) > threshold;
 }
 
+/**
+ * Binarize the given dataset in place: set values greater than threshold to 1
+ * and values less than or equal to the threshold to 0, in all dimensions.  No
+ * memory is allocated.
+ *
+ * @code
+ * arma::Mat<double> data = loadData();
+ * Binarize(data, 0.5);
+ * @endcode
+ *
+ * @param data Matrix to binarize.
+ * @param threshold Threshold can by any number.
+ */
+template<typename T>
+void Binarize(arma::Mat<T>& data, const double threshold)
+{
+  T* ptr = data.memptr();
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_elem; ++i)
+    ptr[i] = ptr[i] > threshold;
+}
+
+/**
+ * Binarize the given dimension of the given dataset in place: set values of
+ * that dimension greater than threshold to 1 and values less than or equal to
+ * the threshold to 0.  The other dimensions are not touched.
+ *
+ * @param data Matrix to binarize.
+ * @param threshold Threshold can by any number.
+ * @param dimension Feature to apply the Binarize function.
+ */
+template<typename T>
+void Binarize(arma::Mat<T>& data,
+              const double threshold,
+              const size_t dimension)
+{
+  if (dimension >= data.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "Binarize(): dimension " << dimension << " is out of range (the "
+        << "dataset has " << data.n_rows << " dimensions)";
+    throw std::invalid_argument(oss.str());
+  }
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    data(dimension, i) = data(dimension, i) > threshold;
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -0,0 +1,175 @@
+/**
+ * @file core/data/chunked_reader.hpp
+ *
+ * Definition of ChunkedReader, which reads a dataset from a file one block of
+ * points at a time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_CHUNKED_READER_HPP
+#define MLPACK_CORE_DATA_CHUNKED_READER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <future>
+
+#include "load.hpp"
+#include "load_csv.hpp"
+#include "mapped_matrix.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A ChunkedReader reads a dataset from a file one chunk of points at a time,
+ * for algorithms that process the data in a single pass or in several passes
+ * (such as streaming k-means, HoeffdingTree, or SGD-based models) without
+ * holding the whole dataset in memory.  Each chunk is a matrix with one point
+ * per column, as data::Load() would return it.  By default, the next chunk is
+ * read in a background thread while the current one is being used.
+ *
+ * The source is chosen from the extension of the file:
+ *
+ *  - CSV, TSV and text files (.csv, .tsv, .txt) are memory-mapped and parsed
+ *    one line (one point) at a time, with the tokenizer of data::Load(), so the
+ *    files are read the same way.  Categorical features are mapped with the
+ *    given DatasetMapper.  If the policy needs a first pass (as IncrementPolicy
+ *    does) and the DatasetMapper has not been used yet, the constructor scans
+ *    the whole file once to determine the type of each dimension.
+ *  - mlpack binary matrix files (.mlmat) are memory-mapped, and each chunk is a
+ *    copy of a range of columns.
+ *  - Other formats supported by data::Load() (such as Armadillo binary and
+ *    HDF5) cannot be read partially, so they are loaded completely when the
+ *    reader is created, and chunks are copied out of the loaded matrix.
+ *
+ * @code
+ * data::DatasetInfo info;
+ * data::ChunkedReader<> reader("dataset.csv", info, 10000);
+ * arma::mat chunk;
+ * while (reader.Next(chunk))
+ *   model.Update(chunk);
+ *
+ * // Start another pass over the data.
+ * reader.Reset();
+ * @endcode
+ *
+ * The DatasetMapper is modified by the background thread while it reads, so
+ * it must not be used until Next() returns false, and it must outlive the
+ * reader.
+ *
+ * @tparam eT Element type of the chunks.
+ * @tparam PolicyType Mapping policy of the DatasetMapper.
+ */
+template<typename eT = double, typename PolicyType = IncrementPolicy>
+class ChunkedReader
+{
+ public:
+  /**
+   * Open the given file for reading in chunks.  A std::runtime_error is thrown
+   * if the file cannot be opened or parsed.
+   *
+   * @param filename Name of the file to read.
+   * @param info DatasetMapper to map categorical features with.
+   * @param chunkSize Number of points in each chunk (the last chunk may be
+   *     smaller).
+   * @param prefetch Whether to read the next chunk in a background thread.
+   */
+  ChunkedReader(const std::string& filename,
+                DatasetMapper<PolicyType>& info,
+                const size_t chunkSize = 4096,
+                const bool prefetch = true);
+
+  //! Wait for the background thread, if it is reading.
+  ~ChunkedReader();
+
+  //! The background thread uses the reader, so it cannot be copied.
+  ChunkedReader(const ChunkedReader& other) = delete;
+  //! The background thread uses the reader, so it cannot be copied.
+  ChunkedReader& operator=(const ChunkedReader& other) = delete;
+
+  /**
+   * Get the next chunk of points.  An exception thrown while reading the
+   * chunk (for instance, for a line with the wrong number of fields) is
+   * thrown here.
+   *
+   * @param chunk Matrix to store the chunk in, one point per column.
+   * @return false if all points have been read (chunk is then empty).
+   */
+  bool Next(arma::Mat<eT>& chunk);
+
+  //! Start reading from the first point again.
+  void Reset();
+
+  //! Get the dimensionality of the points.
+  size_t Dimensionality() const { return dimensionality; }
+  //! Get the number of points in each chunk.
+  size_t ChunkSize() const { return chunkSize; }
+  //! Get the number of points returned by Next() since the start (or the last
+  //! Reset()).
+  size_t Position() const { return position; }
+
+  //! Get the DatasetMapper.
+  const DatasetMapper<PolicyType>& Info() const { return info; }
+
+ private:
+  //! Read the next chunk from the source into the given matrix.
+  bool Read(arma::Mat<eT>& chunk);
+
+  //! Read the next chunk of a text file.
+  bool ReadText(arma::Mat<eT>& chunk);
+
+  //! Take the first pass of the DatasetMapper over a text file.
+  void FirstPass();
+
+  //! Wait for the background thread, ignoring its result.
+  void Wait();
+
+  //! The name of the file.
+  std::string filename;
+  //! The DatasetMapper.
+  DatasetMapper<PolicyType>& info;
+  //! The number of points in each chunk.
+  size_t chunkSize;
+  //! Whether to read the next chunk in a background thread.
+  bool prefetch;
+  //! The dimensionality of the points.
+  size_t dimensionality;
+  //! The number of points returned so far.
+  size_t position;
+
+  //! The text file and its tokenizer, for text sources.
+  std::unique_ptr<LoadCSV> text;
+  //! The start of the next line to read, for text sources.
+  const char* textPosition;
+  //! The index of the next line to read, for text sources.
+  size_t line;
+  //! Whether numbers in non-categorical dimensions are stored directly.
+  bool storeNumbers;
+  //! Whether each dimension is categorical.
+  std::vector<char> categorical;
+
+  //! The mapped matrix, for .mlmat sources.
+  MappedMatrix<eT> mapped;
+  //! The loaded matrix, for other sources.
+  arma::Mat<eT> loaded;
+  //! The matrix that chunks are copied from, for matrix sources.
+  const arma::Mat<eT>* source;
+  //! The next column to read, for matrix sources.
+  size_t column;
+
+  //! The chunk being read in the background.
+  std::future<bool> pending;
+  //! The matrix the background thread reads into.
+  arma::Mat<eT> next;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "chunked_reader_impl.hpp"
+
+#endif
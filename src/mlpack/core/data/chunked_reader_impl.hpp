@@ -0,0 +1,260 @@
+/**
+ * @file core/data/chunked_reader_impl.hpp
+ *
+ * Implementation of ChunkedReader.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_CHUNKED_READER_IMPL_HPP
+#define MLPACK_CORE_DATA_CHUNKED_READER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "chunked_reader.hpp"
+
+namespace mlpack {
+namespace data {
+
+template<typename eT, typename PolicyType>
+ChunkedReader<eT, PolicyType>::ChunkedReader(
+    const std::string& filename,
+    DatasetMapper<PolicyType>& info,
+    const size_t chunkSize,
+    const bool prefetch) :
+    filename(filename),
+    info(info),
+    chunkSize(std::max(chunkSize, (size_t) 1)),
+    prefetch(prefetch),
+    dimensionality(0),
+    position(0),
+    textPosition(NULL),
+    line(0),
+    storeNumbers(false),
+    source(NULL),
+    column(0)
+{
+  const std::string extension = Extension(filename);
+  if (extension == "csv" || extension == "tsv" || extension == "txt")
+  {
+    text.reset(new LoadCSV(filename));
+    textPosition = text->file->Data();
+
+    // The number of fields of the first line is the dimensionality.
+    const char* end = textPosition + text->file->Size();
+    if (textPosition != end)
+    {
+      const char* firstEnd = (const char*) std::memchr(textPosition, '\n',
+          end - textPosition);
+      const char* firstBegin = textPosition;
+      if (!firstEnd)
+        firstEnd = end;
+      LoadCSV::Trim(firstBegin, firstEnd);
+      dimensionality = text->TokenizeLine(firstBegin, firstEnd,
+          [](size_t, const char*, const char*) { });
+    }
+
+    storeNumbers = std::is_same<eT, double>::value &&
+        LoadCSV::NumbersPassThrough(info.Policy());
+
+    if (info.Dimensionality() == 0)
+    {
+      info.SetDimensionality(dimensionality);
+      if (PolicyType::NeedsFirstPass)
+        FirstPass();
+    }
+  }
+  else
+  {
+    if (extension == "mlmat")
+    {
+      mapped = MappedMatrix<eT>(filename);
+      source = &mapped.Matrix();
+    }
+    else
+    {
+      data::Load(filename, loaded, true);
+      source = &loaded;
+    }
+
+    dimensionality = source->n_rows;
+    if (info.Dimensionality() == 0)
+      info.SetDimensionality(dimensionality);
+  }
+
+  if (info.Dimensionality() != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "ChunkedReader: given DatasetInfo has dimensionality "
+        << info.Dimensionality() << ", but data has dimensionality "
+        << dimensionality;
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Numbers in categorical dimensions still have to be mapped.
+  categorical.resize(dimensionality, 0);
+  for (size_t d = 0; d < dimensionality; ++d)
+    categorical[d] = (info.Type(d) == Datatype::categorical);
+}
+
+template<typename eT, typename PolicyType>
+ChunkedReader<eT, PolicyType>::~ChunkedReader()
+{
+  Wait();
+}
+
+template<typename eT, typename PolicyType>
+bool ChunkedReader<eT, PolicyType>::Next(arma::Mat<eT>& chunk)
+{
+  bool found;
+  if (pending.valid())
+  {
+    found = pending.get();
+    chunk.swap(next);
+  }
+  else
+  {
+    found = Read(chunk);
+  }
+
+  if (!found)
+    return false;
+
+  position += chunk.n_cols;
+  if (prefetch)
+    pending = std::async(std::launch::async, [this]() { return Read(next); });
+
+  return true;
+}
+
+template<typename eT, typename PolicyType>
+void ChunkedReader<eT, PolicyType>::Reset()
+{
+  Wait();
+
+  position = 0;
+  if (text)
+  {
+    textPosition = text->file->Data();
+    line = 0;
+  }
+  else
+  {
+    column = 0;
+  }
+}
+
+template<typename eT, typename PolicyType>
+bool ChunkedReader<eT, PolicyType>::Read(arma::Mat<eT>& chunk)
+{
+  if (text)
+    return ReadText(chunk);
+
+  if (column >= source->n_cols)
+  {
+    chunk.set_size(dimensionality, 0);
+    return false;
+  }
+
+  const size_t last = std::min(column + chunkSize, (size_t) source->n_cols);
+  chunk = source->cols(column, last - 1);
+  column = last;
+  return true;
+}
+
+template<typename eT, typename PolicyType>
+bool ChunkedReader<eT, PolicyType>::ReadText(arma::Mat<eT>& chunk)
+{
+  const char* end = text->file->Data() + text->file->Size();
+  chunk.set_size(dimensionality, chunkSize);
+
+  size_t count = 0;
+  while (count < chunkSize && textPosition < end)
+  {
+    const char* newline = (const char*) std::memchr(textPosition, '\n',
+        end - textPosition);
+    const char* lineBegin = textPosition;
+    const char* lineEnd = newline ? newline : end;
+    textPosition = newline ? newline + 1 : end;
+    LoadCSV::Trim(lineBegin, lineEnd);
+
+    const size_t fields = text->TokenizeLine(lineBegin, lineEnd,
+        [&](const size_t d, const char* begin, const char* tokenEnd)
+    {
+      if (d >= dimensionality)
+        return;
+
+      double value;
+      if (storeNumbers && !categorical[d] &&
+          LoadCSV::ParseDouble(begin, tokenEnd, value))
+        chunk(d, count) = (eT) value;
+      else
+        chunk(d, count) = info.template MapString<eT>(std::string(begin,
+            tokenEnd), d);
+    });
+
+    if (fields != dimensionality)
+    {
+      std::ostringstream oss;
+      oss << "ChunkedReader::Next(): wrong number of dimensions (" << fields
+          << ") on line " << line << " of '" << filename << "'; should be "
+          << dimensionality << " dimensions.";
+      throw std::runtime_error(oss.str());
+    }
+
+    ++count;
+    ++line;
+  }
+
+  chunk.resize(dimensionality, count);
+  return (count > 0);
+}
+
+template<typename eT, typename PolicyType>
+void ChunkedReader<eT, PolicyType>::FirstPass()
+{
+  const char* pos = text->file->Data();
+  const char* end = pos + text->file->Size();
+  while (pos < end)
+  {
+    const char* newline = (const char*) std::memchr(pos, '\n', end - pos);
+    const char* lineBegin = pos;
+    const char* lineEnd = newline ? newline : end;
+    pos = newline ? newline + 1 : end;
+    LoadCSV::Trim(lineBegin, lineEnd);
+
+    // Numbers that are stored directly do not change the type of a dimension.
+    text->TokenizeLine(lineBegin, lineEnd,
+        [&](const size_t d, const char* begin, const char* tokenEnd)
+    {
+      double value;
+      if (d < dimensionality && !(storeNumbers &&
+          LoadCSV::ParseDouble(begin, tokenEnd, value)))
+      {
+        info.template MapFirstPass<eT>(std::string(begin, tokenEnd), d);
+      }
+    });
+  }
+}
+
+template<typename eT, typename PolicyType>
+void ChunkedReader<eT, PolicyType>::Wait()
+{
+  if (!pending.valid())
+    return;
+
+  try
+  {
+    pending.get();
+  }
+  catch (const std::exception& /* e */)
+  {
+    // The chunk is discarded anyway.
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,163 @@
+/**
+ * @file core/data/compressed_dataset.hpp
+ *
+ * Definition of CompressedDataset, a compact columnar container for datasets
+ * with categorical and numeric dimensions.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_COMPRESSED_DATASET_HPP
+#define MLPACK_CORE_DATA_COMPRESSED_DATASET_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "dataset_mapper.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * CompressedDataset stores a dataset with categorical and numeric dimensions
+ * (as described by a DatasetInfo) in a much smaller space than an arma::mat.
+ * Each dimension is stored on its own, so that the values of one dimension
+ * (which is what split searches look at) are contiguous:
+ *
+ *  - the values of a categorical dimension are the indices of its categories,
+ *    so they are bit-packed with the smallest of 1, 2, 4, 8, 16 or 32 bits
+ *    that holds all of its categories; a feature with three categories takes
+ *    two bits per point instead of 64;
+ *  - the values of a numeric dimension are stored as floats.  Note that this
+ *    rounds values that are not exactly representable as floats.
+ *
+ * A CompressedDataset can be used in place of an arma::mat to train
+ * DecisionTree, RandomForest, HoeffdingTree and NaiveBayesClassifier models
+ * (and to classify with the trees), since it provides the subset of the
+ * Armadillo interface that they use: n_rows, n_cols, operator()(), col() and
+ * cols().  Each value is unpacked when it is accessed.
+ *
+ * @code
+ * arma::mat data;
+ * data::DatasetInfo info;
+ * data::Load("data.arff", data, info, true);
+ * data::CompressedDataset compressed(data, info);
+ * data.reset(); // The original matrix is not needed anymore.
+ *
+ * RandomForest<> rf(compressed, info, labels, numClasses);
+ * @endcode
+ */
+class CompressedDataset
+{
+ public:
+  //! The type of the values returned by the accessors.
+  typedef double elem_type;
+
+  /**
+   * Create an empty dataset.
+   */
+  CompressedDataset();
+
+  /**
+   * Compress the given dataset.  The values of the categorical dimensions
+   * must be category indices in [0, info.NumMappings(d)), as data::Load()
+   * produces; otherwise a std::invalid_argument is thrown.
+   *
+   * @param data Dataset to compress, one point per column.
+   * @param info The types and categories of the dimensions of the dataset.
+   */
+  CompressedDataset(const arma::mat& data, const DatasetInfo& info);
+
+  /**
+   * Get the value of the given dimension of the given point.
+   *
+   * @param dimension Dimension to get.
+   * @param point Index of the point.
+   */
+  double operator()(const size_t dimension, const size_t point) const
+  {
+    const size_t logBits = logBitWidths[dimension];
+    if (logBits == numericDimension)
+      return numericValues[offsets[dimension]][point];
+
+    // Values never straddle two words, since the width divides 64.
+    const size_t bits = size_t(1) << logBits;
+    const size_t perWordShift = 6 - logBits;
+    const uint64_t word =
+        packedValues[offsets[dimension]][point >> perWordShift];
+    const size_t shift = (point & ((size_t(1) << perWordShift) - 1)) << logBits;
+    return (double) ((word >> shift) & ((uint64_t(1) << bits) - 1));
+  }
+
+  /**
+   * Get the given point as a column vector.
+   *
+   * @param point Index of the point.
+   */
+  arma::vec col(const size_t point) const;
+
+  /**
+   * Get a dataset with the given points (in the given order).
+   *
+   * @param points Indices of the points.
+   */
+  CompressedDataset cols(const arma::uvec& points) const;
+
+  /**
+   * Decompress the dataset into the given matrix.
+   *
+   * @param data Matrix to store the dataset in, one point per column.
+   */
+  void Decompress(arma::mat& data) const;
+
+  //! Get the number of bits used for each value of the given dimension.
+  size_t BitWidth(const size_t dimension) const
+  {
+    return (logBitWidths[dimension] == numericDimension) ?
+        8 * sizeof(float) : (size_t(1) << logBitWidths[dimension]);
+  }
+
+  //! Get the number of bytes used to store the values of the dataset.
+  size_t MemoryUsage() const;
+
+  /**
+   * Serialize the dataset.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+  //! The number of dimensions (named like the Armadillo member).
+  size_t n_rows;
+  //! The number of points (named like the Armadillo member).
+  size_t n_cols;
+
+ private:
+  //! Set the storage of each dimension for the given widths.
+  void Allocate();
+
+  //! Store the given value of the given dimension of the given point.
+  void Set(const size_t dimension, const size_t point, const double value);
+
+  //! The value of logBitWidths for a numeric dimension.
+  static const size_t numericDimension = 255;
+
+  //! For each dimension, the base 2 logarithm of the number of bits of each
+  //! value, or numericDimension.
+  std::vector<size_t> logBitWidths;
+  //! For each dimension, the index of its values in packedValues or
+  //! numericValues.
+  std::vector<size_t> offsets;
+  //! The bit-packed values of the categorical dimensions.
+  std::vector<std::vector<uint64_t>> packedValues;
+  //! The values of the numeric dimensions.
+  std::vector<std::vector<float>> numericValues;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "compressed_dataset_impl.hpp"
+
+#endif
@@ -0,0 +1,202 @@
+/**
+ * @file core/data/compressed_dataset_impl.hpp
+ *
+ * Implementation of CompressedDataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_COMPRESSED_DATASET_IMPL_HPP
+#define MLPACK_CORE_DATA_COMPRESSED_DATASET_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "compressed_dataset.hpp"
+
+namespace mlpack {
+namespace data {
+
+inline CompressedDataset::CompressedDataset() :
+    n_rows(0),
+    n_cols(0)
+{
+  // Nothing to do.
+}
+
+inline CompressedDataset::CompressedDataset(const arma::mat& data,
+                                            const DatasetInfo& info) :
+    n_rows(data.n_rows),
+    n_cols(data.n_cols)
+{
+  if (info.Dimensionality() != data.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "CompressedDataset: the dataset has " << data.n_rows
+        << " dimensions, but the DatasetInfo has " << info.Dimensionality();
+    throw std::invalid_argument(oss.str());
+  }
+
+  logBitWidths.resize(n_rows);
+  for (size_t d = 0; d < n_rows; ++d)
+  {
+    if (info.Type(d) == Datatype::numeric)
+    {
+      logBitWidths[d] = numericDimension;
+      continue;
+    }
+
+    // Find the smallest width (that divides 64) for the largest category.
+    const uint64_t numMappings = info.NumMappings(d);
+    logBitWidths[d] = 0;
+    while (logBitWidths[d] < 5 &&
+        (uint64_t(1) << (size_t(1) << logBitWidths[d])) < numMappings)
+      ++logBitWidths[d];
+
+    if (logBitWidths[d] == 5 && numMappings > (uint64_t(1) << 32))
+    {
+      std::ostringstream oss;
+      oss << "CompressedDataset: dimension " << d << " has too many categories"
+          << " (" << numMappings << ")";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  Allocate();
+
+  // Each dimension is written by one thread, so no word is shared.
+  std::vector<std::string> errors(n_rows);
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (omp_size_t d = 0; d < (omp_size_t) n_rows; ++d)
+  {
+    const double numMappings = (logBitWidths[d] == numericDimension) ? 0.0 :
+        (double) info.NumMappings(d);
+    for (size_t i = 0; i < n_cols; ++i)
+    {
+      const double value = data(d, i);
+      if (logBitWidths[d] != numericDimension && !(value >= 0.0 &&
+          value < numMappings && value == std::floor(value)))
+      {
+        std::ostringstream oss;
+        oss << "CompressedDataset: value " << value << " of categorical "
+            << "dimension " << d << " of point " << i << " is not a category "
+            << "index";
+        errors[d] = oss.str();
+        break;
+      }
+
+      Set(d, i, value);
+    }
+  }
+
+  for (size_t d = 0; d < n_rows; ++d)
+  {
+    if (!errors[d].empty())
+      throw std::invalid_argument(errors[d]);
+  }
+}
+
+inline arma::vec CompressedDataset::col(const size_t point) const
+{
+  arma::vec result(n_rows);
+  for (size_t d = 0; d < n_rows; ++d)
+    result[d] = (*this)(d, point);
+
+  return result;
+}
+
+inline CompressedDataset CompressedDataset::cols(const arma::uvec& points)
+    const
+{
+  CompressedDataset result;
+  result.n_rows = n_rows;
+  result.n_cols = points.n_elem;
+  result.logBitWidths = logBitWidths;
+  result.Allocate();
+
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (omp_size_t d = 0; d < (omp_size_t) n_rows; ++d)
+  {
+    for (size_t i = 0; i < points.n_elem; ++i)
+      result.Set(d, i, (*this)(d, points[i]));
+  }
+
+  return result;
+}
+
+inline void CompressedDataset::Decompress(arma::mat& data) const
+{
+  data.set_size(n_rows, n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) n_cols; ++i)
+  {
+    for (size_t d = 0; d < n_rows; ++d)
+      data(d, i) = (*this)(d, i);
+  }
+}
+
+inline size_t CompressedDataset::MemoryUsage() const
+{
+  size_t bytes = 0;
+  for (size_t i = 0; i < packedValues.size(); ++i)
+    bytes += sizeof(uint64_t) * packedValues[i].size();
+  for (size_t i = 0; i < numericValues.size(); ++i)
+    bytes += sizeof(float) * numericValues[i].size();
+
+  return bytes;
+}
+
+template<typename Archive>
+void CompressedDataset::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(n_rows));
+  ar(CEREAL_NVP(n_cols));
+  ar(CEREAL_NVP(logBitWidths));
+  ar(CEREAL_NVP(offsets));
+  ar(CEREAL_NVP(packedValues));
+  ar(CEREAL_NVP(numericValues));
+}
+
+inline void CompressedDataset::Allocate()
+{
+  offsets.resize(n_rows);
+  packedValues.clear();
+  numericValues.clear();
+  for (size_t d = 0; d < n_rows; ++d)
+  {
+    if (logBitWidths[d] == numericDimension)
+    {
+      offsets[d] = numericValues.size();
+      numericValues.emplace_back(n_cols);
+    }
+    else
+    {
+      const size_t perWord = size_t(64) >> logBitWidths[d];
+      offsets[d] = packedValues.size();
+      packedValues.emplace_back((n_cols + perWord - 1) / perWord, 0);
+    }
+  }
+}
+
+inline void CompressedDataset::Set(const size_t dimension,
+                                   const size_t point,
+                                   const double value)
+{
+  const size_t logBits = logBitWidths[dimension];
+  if (logBits == numericDimension)
+  {
+    numericValues[offsets[dimension]][point] = (float) value;
+    return;
+  }
+
+  const size_t perWordShift = 6 - logBits;
+  const size_t shift = (point & ((size_t(1) << perWordShift) - 1)) << logBits;
+  uint64_t& word = packedValues[offsets[dimension]][point >> perWordShift];
+  const uint64_t mask = ((uint64_t(1) << (size_t(1) << logBits)) - 1) << shift;
+  word = (word & ~mask) | (((uint64_t) value << shift) & mask);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -45,14 +45,18 @@ namespace data {
  * represents the predicted classes and column index represents the actual
  * class.
  *
+ * The counts are accumulated in parallel, and confusion matrices of disjoint
+ * sets of predictions can simply be added together; so a large set of
+ * predictions can be processed in chunks.
+ *
  * @param predictors Vector of data points.
  * @param responses The measured data for each point.
  * @param output Matrix which is represented as confusion matrix.
  * @param numClasses Number of classes.
  */
 template<typename eT>
-void ConfusionMatrix(const arma::Row<size_t> predictors,
-                     const arma::Row<size_t> responses,
+void ConfusionMatrix(const arma::Row<size_t>& predictors,
+                     const arma::Row<size_t>& responses,
                      arma::Mat<eT>& output,
                      const size_t numClasses);
 
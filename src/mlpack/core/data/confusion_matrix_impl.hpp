@@ -47,16 +47,33 @@ namespace data {
  * class.
  */
 template<typename eT>
-void ConfusionMatrix(const arma::Row<size_t> predictors,
-                     const arma::Row<size_t> responses,
+void ConfusionMatrix(const arma::Row<size_t>& predictors,
+                     const arma::Row<size_t>& responses,
                      arma::Mat<eT>& output,
                      const size_t numClasses)
 {
-  // Loop over the actual labels and predicted labels and add the count.
+  if (predictors.n_elem != responses.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "ConfusionMatrix(): number of predictions (" << predictors.n_elem
+        << ") does not match number of responses (" << responses.n_elem
+        << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Loop over the actual labels and predicted labels and add the count.  Each
+  // thread counts its part of the predictions, and the counts are then added.
   output = arma::zeros<arma::Mat<eT> >(numClasses, numClasses);
-  for (size_t i = 0; i < predictors.n_elem; ++i)
+  #pragma omp parallel
   {
-    output.at(predictors[i], responses[i])++;
+    arma::Mat<size_t> counts(numClasses, numClasses, arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) predictors.n_elem; ++i)
+      counts.at(predictors[i], responses[i])++;
+
+    #pragma omp critical
+    output += arma::conv_to<arma::Mat<eT>>::from(counts);
   }
 }
 
@@ -0,0 +1,168 @@
+/**
+ * @file core/data/feature_statistics.hpp
+ *
+ * Definition of FeatureStatistics, which computes the statistics of each
+ * dimension of a dataset in a single pass.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_FEATURE_STATISTICS_HPP
+#define MLPACK_CORE_DATA_FEATURE_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "quantile_sketch.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * FeatureStatistics accumulates the mean, variance, skewness, kurtosis,
+ * minimum and maximum of each dimension of a dataset, and optionally a
+ * QuantileSketch for its quantiles, in a single pass over the points.  The
+ * points can be given in chunks, so the dataset does not have to fit in
+ * memory, and the statistics of two parts of a dataset can be merged.  The
+ * moments are updated with Welford's method and merged with the formulas of
+ * Pebay ("Formulas for robust, one-pass parallel computation of covariances
+ * and arbitrary-order statistical moments", 2008), which are numerically
+ * stable.
+ *
+ * The scalers in data/scaler_methods/ can be fit from a FeatureStatistics
+ * object; for instance, to fit a StandardScaler on a file that is too big to
+ * load:
+ *
+ * @code
+ * data::DatasetInfo info;
+ * data::ChunkedReader<> reader("big.csv", info, 100000);
+ * data::FeatureStatistics statistics;
+ * arma::mat chunk;
+ * while (reader.Next(chunk))
+ *   statistics.Update(chunk);
+ *
+ * data::StandardScaler scaler;
+ * scaler.Fit(statistics);
+ * @endcode
+ */
+class FeatureStatistics
+{
+ public:
+  /**
+   * Create an empty set of statistics.  The dimensionality is set by the first
+   * call to Update().
+   *
+   * @param sketchSize Size parameter of the QuantileSketch kept for each
+   *     dimension, or 0 to not estimate quantiles.
+   */
+  FeatureStatistics(const size_t sketchSize = 0);
+
+  /**
+   * Add the given points to the statistics.  Large chunks are processed in
+   * parallel.
+   *
+   * @param points Points to add, one per column.
+   */
+  template<typename MatType>
+  void Update(const MatType& points);
+
+  /**
+   * Merge the given statistics into these ones, so that they describe the
+   * points of both.
+   *
+   * @param other Statistics to merge.
+   */
+  void Merge(const FeatureStatistics& other);
+
+  //! Get the number of dimensions.
+  size_t Dimensionality() const { return mean.n_elem; }
+  //! Get the number of points.
+  size_t Count() const { return count; }
+
+  //! Get the mean of each dimension.
+  const arma::vec& Mean() const { return mean; }
+  //! Get the minimum of each dimension.
+  const arma::vec& Min() const { return minimum; }
+  //! Get the maximum of each dimension.
+  const arma::vec& Max() const { return maximum; }
+
+  /**
+   * Get the variance of each dimension.
+   *
+   * @param population If true, the points are the whole population (divide
+   *     by n); otherwise they are a sample (divide by n - 1).
+   */
+  arma::vec Variance(const bool population = false) const;
+
+  /**
+   * Get the standard deviation of each dimension.
+   *
+   * @param population If true, the points are the whole population.
+   */
+  arma::vec StdDev(const bool population = false) const;
+
+  /**
+   * Get the skewness of each dimension.
+   *
+   * @param population If true, the points are the whole population.
+   */
+  arma::vec Skewness(const bool population = false) const;
+
+  /**
+   * Get the excess kurtosis of each dimension.
+   *
+   * @param population If true, the points are the whole population.
+   */
+  arma::vec Kurtosis(const bool population = false) const;
+
+  /**
+   * Estimate the given quantile of the given dimension.  A std::logic_error is
+   * thrown if quantiles are not estimated (sketchSize is 0).
+   *
+   * @param dimension Dimension to get the quantile of.
+   * @param q Quantile, in [0, 1].
+   */
+  double Quantile(const size_t dimension, const double q) const;
+
+  /**
+   * Serialize the statistics.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Set the dimensionality of empty statistics.
+  void Initialize(const size_t dimensionality);
+
+  //! Add the given columns of the given points, one at a time.
+  template<typename MatType>
+  void UpdateRange(const MatType& points, const size_t begin, const size_t end);
+
+  //! The size parameter of the sketches (0 if there are none).
+  size_t sketchSize;
+  //! The number of points.
+  size_t count;
+  //! The mean of each dimension.
+  arma::vec mean;
+  //! The sum of the squared deviations from the mean of each dimension.
+  arma::vec m2;
+  //! The sum of the cubed deviations from the mean of each dimension.
+  arma::vec m3;
+  //! The sum of the fourth powers of the deviations of each dimension.
+  arma::vec m4;
+  //! The minimum of each dimension.
+  arma::vec minimum;
+  //! The maximum of each dimension.
+  arma::vec maximum;
+  //! The quantile sketch of each dimension.
+  std::vector<QuantileSketch> sketches;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "feature_statistics_impl.hpp"
+
+#endif
@@ -0,0 +1,234 @@
+/**
+ * @file core/data/feature_statistics_impl.hpp
+ *
+ * Implementation of FeatureStatistics.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_FEATURE_STATISTICS_IMPL_HPP
+#define MLPACK_CORE_DATA_FEATURE_STATISTICS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "feature_statistics.hpp"
+
+namespace mlpack {
+namespace data {
+
+inline FeatureStatistics::FeatureStatistics(const size_t sketchSize) :
+    sketchSize(sketchSize),
+    count(0)
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+void FeatureStatistics::Update(const MatType& points)
+{
+  if (count == 0)
+  {
+    Initialize(points.n_rows);
+  }
+  else if (points.n_rows != mean.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "FeatureStatistics::Update(): the points have " << points.n_rows
+        << " dimensions, but the statistics have " << mean.n_elem;
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Only split chunks that are big enough to be worth it.
+  const size_t numBlocks = ParallelPolicy::Current().NumBlocks(points.n_cols,
+      4096);
+
+  if (numBlocks <= 1)
+  {
+    UpdateRange(points, 0, points.n_cols);
+    return;
+  }
+
+  // Each block gets its own statistics, which are merged in order.
+  std::vector<FeatureStatistics> blocks(numBlocks,
+      FeatureStatistics(sketchSize));
+  const size_t blockSize = (points.n_cols + numBlocks - 1) / numBlocks;
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = (size_t) b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) points.n_cols);
+    blocks[b].Initialize(points.n_rows);
+    blocks[b].UpdateRange(points, begin, end);
+  }
+
+  for (size_t b = 0; b < numBlocks; ++b)
+    Merge(blocks[b]);
+}
+
+inline void FeatureStatistics::Merge(const FeatureStatistics& other)
+{
+  if (other.count == 0)
+    return;
+
+  if (count == 0)
+  {
+    *this = other;
+    return;
+  }
+
+  if (other.mean.n_elem != mean.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "FeatureStatistics::Merge(): the statistics have "
+        << other.mean.n_elem << " dimensions, but these have " << mean.n_elem;
+    throw std::invalid_argument(oss.str());
+  }
+
+  const double na = count;
+  const double nb = other.count;
+  const double n = na + nb;
+  const arma::vec delta = other.mean - mean;
+  const arma::vec delta2 = delta % delta;
+
+  // The higher moments depend on the lower ones, so they are merged first.
+  m4 += other.m4 + (na * nb * (na * na - na * nb + nb * nb) / (n * n * n)) *
+      (delta2 % delta2) + (6.0 / (n * n)) * delta2 %
+      (na * na * other.m2 + nb * nb * m2) + (4.0 / n) * delta %
+      (na * other.m3 - nb * m3);
+  m3 += other.m3 + (na * nb * (na - nb) / (n * n)) * (delta2 % delta) +
+      (3.0 / n) * delta % (na * other.m2 - nb * m2);
+  m2 += other.m2 + (na * nb / n) * delta2;
+  mean += (nb / n) * delta;
+
+  minimum = arma::min(minimum, other.minimum);
+  maximum = arma::max(maximum, other.maximum);
+  if (!sketches.empty() && !other.sketches.empty())
+  {
+    for (size_t d = 0; d < sketches.size(); ++d)
+      sketches[d].Merge(other.sketches[d]);
+  }
+
+  count += other.count;
+}
+
+inline arma::vec FeatureStatistics::Variance(const bool population) const
+{
+  if (count == 0 || (!population && count < 2))
+    return arma::vec(mean.n_elem, arma::fill::zeros);
+
+  return m2 / (population ? (double) count : (double) (count - 1));
+}
+
+inline arma::vec FeatureStatistics::StdDev(const bool population) const
+{
+  return arma::sqrt(Variance(population));
+}
+
+inline arma::vec FeatureStatistics::Skewness(const bool population) const
+{
+  const double n = count;
+  const arma::vec s3 = arma::pow(StdDev(population), 3);
+  if (population)
+    return m3 / (n * s3);
+  else
+    return n * m3 / ((n - 1) * (n - 2) * s3);
+}
+
+inline arma::vec FeatureStatistics::Kurtosis(const bool population) const
+{
+  const double n = count;
+  if (population)
+    return n * (m4 / (m2 % m2)) - 3;
+
+  const arma::vec s4 = arma::pow(StdDev(population), 4);
+  const double norm3 = (3 * (n - 1) * (n - 1)) / ((n - 2) * (n - 3));
+  const double normC = (n * (n + 1)) / ((n - 1) * (n - 2) * (n - 3));
+  return normC * (m4 / s4) - norm3;
+}
+
+inline double FeatureStatistics::Quantile(const size_t dimension,
+                                          const double q) const
+{
+  if (sketchSize == 0)
+  {
+    throw std::logic_error("FeatureStatistics::Quantile(): quantiles are not "
+        "estimated (the sketch size is 0)");
+  }
+  if (dimension >= sketches.size())
+  {
+    std::ostringstream oss;
+    oss << "FeatureStatistics::Quantile(): dimension " << dimension
+        << " is out of range (the statistics have " << sketches.size()
+        << " dimensions)";
+    throw std::invalid_argument(oss.str());
+  }
+
+  return sketches[dimension].Quantile(q);
+}
+
+template<typename Archive>
+void FeatureStatistics::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(sketchSize));
+  ar(CEREAL_NVP(count));
+  ar(CEREAL_NVP(mean));
+  ar(CEREAL_NVP(m2));
+  ar(CEREAL_NVP(m3));
+  ar(CEREAL_NVP(m4));
+  ar(CEREAL_NVP(minimum));
+  ar(CEREAL_NVP(maximum));
+  ar(CEREAL_NVP(sketches));
+}
+
+inline void FeatureStatistics::Initialize(const size_t dimensionality)
+{
+  mean.zeros(dimensionality);
+  m2.zeros(dimensionality);
+  m3.zeros(dimensionality);
+  m4.zeros(dimensionality);
+  minimum.set_size(dimensionality);
+  minimum.fill(std::numeric_limits<double>::infinity());
+  maximum.set_size(dimensionality);
+  maximum.fill(-std::numeric_limits<double>::infinity());
+
+  sketches.clear();
+  if (sketchSize > 0)
+    sketches.resize(dimensionality, QuantileSketch(sketchSize));
+}
+
+template<typename MatType>
+void FeatureStatistics::UpdateRange(const MatType& points,
+                                    const size_t begin,
+                                    const size_t end)
+{
+  for (size_t i = begin; i < end; ++i)
+  {
+    ++count;
+    const double n = count;
+    for (size_t d = 0; d < mean.n_elem; ++d)
+    {
+      // Welford's update, extended to the third and fourth moments.
+      const double x = points(d, i);
+      const double delta = x - mean[d];
+      const double deltaN = delta / n;
+      const double deltaN2 = deltaN * deltaN;
+      const double term = delta * deltaN * (n - 1);
+      mean[d] += deltaN;
+      m4[d] += term * deltaN2 * (n * n - 3 * n + 3) + 6 * deltaN2 * m2[d] -
+          4 * deltaN * m3[d];
+      m3[d] += term * deltaN * (n - 2) - 3 * deltaN * m2[d];
+      m2[d] += term;
+
+      minimum[d] = std::min(minimum[d], x);
+      maximum[d] = std::max(maximum[d], x);
+      if (sketchSize > 0)
+        sketches[d].Insert(x);
+    }
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * @file core/data/first_touch.hpp
+ *
+ * A function that moves the memory of a matrix to the NUMA nodes of the
+ * threads that process its columns.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_FIRST_TOUCH_HPP
+#define MLPACK_CORE_DATA_FIRST_TOUCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Copy the given matrix into new memory that is first written by the OpenMP
+ * threads, each thread writing one contiguous range of columns with a static
+ * schedule.  Operating systems place a page of memory on the NUMA node of the
+ * thread that touches it first, so that afterwards a parallel loop over the
+ * columns with a static schedule (and the same number of threads) finds its
+ * columns on the socket of each thread, instead of having the whole matrix on
+ * the socket of the thread that loaded it.
+ *
+ * The threads must be pinned to cores for the placement to last (for instance
+ * with OMP_PROC_BIND=spread and OMP_PLACES=cores).  The values of the matrix
+ * are unchanged; without OpenMP, or for matrices too small to have their own
+ * memory pages, this only costs one copy.
+ *
+ * data::Load() calls this function when the current ParallelPolicy is
+ * NUMA-aware.
+ *
+ * @param matrix Matrix to move.
+ */
+template<typename eT>
+void FirstTouch(arma::Mat<eT>& matrix)
+{
+  if (matrix.n_elem == 0)
+    return;
+
+  // Memory that has just been allocated is not yet mapped to any page, so it
+  // must not be filled here.
+  arma::Mat<eT> placed(matrix.n_rows, matrix.n_cols, arma::fill::none);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) matrix.n_cols; ++i)
+  {
+    std::copy(matrix.colptr(i), matrix.colptr(i) + matrix.n_rows,
+        placed.colptr(i));
+  }
+
+  matrix.steal_mem(placed);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
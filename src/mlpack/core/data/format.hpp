@@ -22,7 +22,8 @@ enum format
   autodetect,
   json,
   xml,
-  binary
+  binary,
+  mapped
 };
 
 } // namespace data
@@ -0,0 +1,118 @@
+/**
+ * @file core/data/image_options.hpp
+ *
+ * Options for loading a batch of images into a matrix.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_IMAGE_OPTIONS_HPP
+#define MLPACK_CORE_DATA_IMAGE_OPTIONS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * ImageOptions controls how data::Load() writes a batch of images into the
+ * columns of a matrix.  The transformations are applied while each decoded
+ * image is copied into its column, so they cost no extra pass over the data:
+ *
+ *  - if a width and height are given, each image is resized to that size with
+ *    bilinear interpolation; otherwise all images must have the same size;
+ *  - each value is computed as (pixel * scale - mean[c]) / stddev[c], where c
+ *    is the channel of the pixel, so that images can be scaled to [0, 1] and
+ *    standardized per channel;
+ *  - the pixels are stored either interleaved (the default, as stb_image
+ *    decodes them: all channels of a pixel, pixel by pixel in row-major
+ *    order), or planar (one complete image per channel), which is the layout
+ *    that the Convolution layer expects for an input of the given width,
+ *    height and channels.
+ *
+ * @code
+ * // Load a batch for a network whose first layer is Convolution<>(3, ...,
+ * // 224, 224): resize to 224x224, scale to [0, 1], planar layout.
+ * data::ImageOptions options(224, 224, true, 1.0 / 255.0);
+ * data::ImageInfo info(0, 0, 3);
+ * arma::mat batch;
+ * data::Load(files, batch, info, options, true);
+ * @endcode
+ */
+class ImageOptions
+{
+ public:
+  /**
+   * Create the options.
+   *
+   * @param width Width to resize each image to (0 to keep the original size).
+   * @param height Height to resize each image to (0 to keep the original
+   *     size).
+   * @param planar Whether to store the channels of each image one after the
+   *     other (as Convolution expects), instead of interleaved.
+   * @param scale Factor to multiply each pixel value with.
+   */
+  ImageOptions(const size_t width = 0,
+               const size_t height = 0,
+               const bool planar = false,
+               const double scale = 1.0) :
+      width(width),
+      height(height),
+      planar(planar),
+      scale(scale)
+  {
+    // Nothing to do.
+  }
+
+  //! Get the width to resize to (0 if images are not resized).
+  size_t Width() const { return width; }
+  //! Modify the width to resize to (0 if images are not resized).
+  size_t& Width() { return width; }
+
+  //! Get the height to resize to (0 if images are not resized).
+  size_t Height() const { return height; }
+  //! Modify the height to resize to (0 if images are not resized).
+  size_t& Height() { return height; }
+
+  //! Get whether the channels are stored planar.
+  bool Planar() const { return planar; }
+  //! Modify whether the channels are stored planar.
+  bool& Planar() { return planar; }
+
+  //! Get the factor each pixel value is multiplied with.
+  double Scale() const { return scale; }
+  //! Modify the factor each pixel value is multiplied with.
+  double& Scale() { return scale; }
+
+  //! Get the mean subtracted from each channel (empty for none).
+  const arma::vec& Mean() const { return mean; }
+  //! Modify the mean subtracted from each channel (empty for none).
+  arma::vec& Mean() { return mean; }
+
+  //! Get the standard deviation each channel is divided by (empty for none).
+  const arma::vec& Stddev() const { return stddev; }
+  //! Modify the standard deviation each channel is divided by (empty for
+  //! none).
+  arma::vec& Stddev() { return stddev; }
+
+ private:
+  //! The width to resize to.
+  size_t width;
+  //! The height to resize to.
+  size_t height;
+  //! Whether the channels are stored planar.
+  bool planar;
+  //! The factor each pixel value is multiplied with.
+  double scale;
+  //! The mean subtracted from each channel.
+  arma::vec mean;
+  //! The standard deviation each channel is divided by.
+  arma::vec stddev;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
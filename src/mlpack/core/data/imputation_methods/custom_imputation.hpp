@@ -46,27 +46,38 @@ class CustomImputation
               const size_t dimension,
               const bool columnMajor = true)
   {
+    Impute(input, std::vector<T>(1, mappedValue),
+        std::vector<size_t>(1, dimension), columnMajor);
+  }
+
+  /**
+   * Replace the missing values of the given dimensions with the custom value,
+   * in one parallel pass over the points.  The result is overwritten to the
+   * input.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value that the user wants to get rid of, for each of
+   *     the given dimensions.
+   * @param dimensions Indices of the dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    const size_t numPoints = columnMajor ? input.n_cols : input.n_rows;
+
     // replace the target value to custom value
-    if (columnMajor)
-    {
-      for (size_t i = 0; i < input.n_cols; ++i)
-      {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
-        {
-          input(dimension, i) = customValue;
-        }
-      }
-    }
-    else
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) numPoints; ++i)
     {
-      for (size_t i = 0; i < input.n_rows; ++i)
+      for (size_t j = 0; j < dimensions.size(); ++j)
       {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
-        {
-          input(i, dimension) = customValue;
-        }
+        T& value = columnMajor ? input(dimensions[j], i) :
+            input(i, dimensions[j]);
+        if (value == mappedValues[j] || std::isnan(value))
+          value = customValue;
       }
     }
   }
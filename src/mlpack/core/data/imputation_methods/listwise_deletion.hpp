@@ -39,31 +39,89 @@ class ListwiseDeletion
               const size_t dimension,
               const bool columnMajor = true)
   {
-    std::vector<arma::uword> colsToKeep;
+    Impute(input, std::vector<T>(1, mappedValue),
+        std::vector<size_t>(1, dimension), columnMajor);
+  }
+
+  /**
+   * Remove every point that has a missing value in any of the given
+   * dimensions.  The points to keep are found in one parallel pass, and are
+   * then moved to the front of the matrix in place, so that the result is only
+   * copied once, when the matrix is shrunk.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value that the user wants to get rid of, for each of
+   *     the given dimensions.
+   * @param dimensions Indices of the dimensions to check.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    const size_t numPoints = columnMajor ? input.n_cols : input.n_rows;
+
+    // std::vector<bool> can't be written concurrently.
+    std::vector<char> keep(numPoints);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) numPoints; ++i)
+    {
+      keep[i] = 1;
+      for (size_t j = 0; j < dimensions.size(); ++j)
+      {
+        const T value = columnMajor ? input(dimensions[j], i) :
+            input(i, dimensions[j]);
+        if (value == mappedValues[j] || std::isnan(value))
+        {
+          keep[i] = 0;
+          break;
+        }
+      }
+    }
+
+    const size_t numKept = std::count(keep.begin(), keep.end(), 1);
+    if (numKept == numPoints)
+      return;
 
     if (columnMajor)
     {
-      for (size_t i = 0; i < input.n_cols; ++i)
+      // Columns are contiguous, so each kept column is moved as a block.
+      size_t kept = 0;
+      for (size_t i = 0; i < numPoints; ++i)
       {
-         if (!(input(dimension, i) == mappedValue ||
-             std::isnan(input(dimension, i))))
-         {
-           colsToKeep.push_back(i);
-         }
+        if (!keep[i])
+          continue;
+        if (kept != i)
+          std::copy(input.colptr(i), input.colptr(i) + input.n_rows,
+              input.colptr(kept));
+        ++kept;
       }
-      input = input.cols(arma::uvec(colsToKeep));
+
+      if (numKept == 0)
+        input.set_size(input.n_rows, 0);
+      else
+        input.shed_cols(numKept, numPoints - 1);
     }
     else
     {
-      for (size_t i = 0; i < input.n_rows; ++i)
+      // Each column is compacted on its own.
+      #pragma omp parallel for schedule(static)
+      for (omp_size_t c = 0; c < (omp_size_t) input.n_cols; ++c)
       {
-        if (!(input(i, dimension) == mappedValue ||
-             std::isnan(input(i, dimension))))
+        T* column = input.colptr(c);
+        size_t kept = 0;
+        for (size_t i = 0; i < numPoints; ++i)
         {
-           colsToKeep.push_back(i);
+          if (keep[i])
+            column[kept++] = column[i];
         }
       }
-      input = input.rows(arma::uvec(colsToKeep));
+
+      if (numKept == 0)
+        input.set_size(0, input.n_cols);
+      else
+        input.shed_rows(numKept, numPoints - 1);
     }
   }
 }; // class ListwiseDeletion
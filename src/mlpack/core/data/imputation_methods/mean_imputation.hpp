@@ -39,61 +39,78 @@ class MeanImputation
               const size_t dimension,
               const bool columnMajor = true)
   {
-    double sum = 0;
-    size_t elems = 0; // excluding nan or missing target
-
-    using PairType = std::pair<size_t, size_t>;
-    // dimensions and indexes are saved as pairs inside this vector.
-    std::vector<PairType> targets;
+    Impute(input, std::vector<T>(1, mappedValue),
+        std::vector<size_t>(1, dimension), columnMajor);
+  }
 
+  /**
+   * Impute the given dimensions at once: the means of all of them are computed
+   * in one parallel pass over the points, and the missing values are replaced
+   * in a second parallel pass.  The result is overwritten to the input matrix.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value that the user wants to get rid of, for each of
+   *     the given dimensions.
+   * @param dimensions Indices of the dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    const size_t numDimensions = dimensions.size();
+    const size_t numPoints = columnMajor ? input.n_cols : input.n_rows;
 
-    // calculate number of elements and sum of them excluding mapped value or
-    // nan. while doing that, remember where mappedValue or NaN exists.
-    if (columnMajor)
+    // Calculate the number of elements and their sum in each dimension,
+    // excluding the mapped value or nan.
+    arma::vec sums(numDimensions, arma::fill::zeros);
+    arma::Col<size_t> elems(numDimensions, arma::fill::zeros);
+    #pragma omp parallel
     {
-      for (size_t i = 0; i < input.n_cols; ++i)
+      arma::vec localSums(numDimensions, arma::fill::zeros);
+      arma::Col<size_t> localElems(numDimensions, arma::fill::zeros);
+
+      #pragma omp for schedule(static)
+      for (omp_size_t i = 0; i < (omp_size_t) numPoints; ++i)
       {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
+        for (size_t j = 0; j < numDimensions; ++j)
         {
-          targets.emplace_back(dimension, i);
-        }
-        else
-        {
-          elems++;
-          sum += input(dimension, i);
+          const T value = columnMajor ? input(dimensions[j], i) :
+              input(i, dimensions[j]);
+          if (!(value == mappedValues[j] || std::isnan(value)))
+          {
+            localSums[j] += value;
+            localElems[j]++;
+          }
         }
       }
-    }
-    else
-    {
-      for (size_t i = 0; i < input.n_rows; ++i)
+
+      #pragma omp critical
       {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
-        {
-          targets.emplace_back(i, dimension);
-        }
-        else
-        {
-          elems++;
-          sum += input(i, dimension);
-        }
+        sums += localSums;
+        elems += localElems;
       }
     }
 
-    if (elems == 0)
+    if (arma::any(elems == 0))
       Log::Fatal << "it is impossible to calculate mean; no valid elements in "
           << "the dimension" << std::endl;
 
-    // calculate mean;
-    const double mean = sum / elems;
+    // calculate means;
+    const arma::vec means = sums / arma::conv_to<arma::vec>::from(elems);
 
-    // Now replace the calculated mean to the missing variables
-    // It only needs to loop through targets vector, not the whole matrix.
-    for (const PairType& target : targets)
+    // Now replace the calculated means to the missing variables.
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) numPoints; ++i)
     {
-      input(target.first, target.second) = mean;
+      for (size_t j = 0; j < numDimensions; ++j)
+      {
+        T& value = columnMajor ? input(dimensions[j], i) :
+            input(i, dimensions[j]);
+        if (value == mappedValues[j] || std::isnan(value))
+          value = means[j];
+      }
     }
   }
 }; // class MeanImputation
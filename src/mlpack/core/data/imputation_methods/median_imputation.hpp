@@ -40,50 +40,85 @@ class MedianImputation
               const size_t dimension,
               const bool columnMajor = true)
   {
-    using PairType = std::pair<size_t, size_t>;
-    // dimensions and indexes are saved as pairs inside this vector.
-    std::vector<PairType> targets;
-    // good elements are kept inside this vector.
-    std::vector<double> elemsToKeep;
+    Impute(input, std::vector<T>(1, mappedValue),
+        std::vector<size_t>(1, dimension), columnMajor);
+  }
+
+  /**
+   * Impute the given dimensions at once: the medians of the dimensions are
+   * computed in parallel with a selection algorithm (not a full sort), and the
+   * missing values are replaced in one parallel pass over the points.  The
+   * result is overwritten to the input matrix.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value that the user wants to get rid of, for each of
+   *     the given dimensions.
+   * @param dimensions Indices of the dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    const size_t numDimensions = dimensions.size();
+    const size_t numPoints = columnMajor ? input.n_cols : input.n_rows;
 
-    if (columnMajor)
+    arma::vec medians(numDimensions);
+    arma::Col<size_t> elems(numDimensions);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (omp_size_t j = 0; j < (omp_size_t) numDimensions; ++j)
     {
-      for (size_t i = 0; i < input.n_cols; ++i)
+      // good elements are kept inside this vector.
+      std::vector<double> elemsToKeep;
+      elemsToKeep.reserve(numPoints);
+      for (size_t i = 0; i < numPoints; ++i)
       {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
-        {
-          targets.emplace_back(dimension, i);
-        }
-        else
-        {
-          elemsToKeep.push_back(input(dimension, i));
-        }
+        const T value = columnMajor ? input(dimensions[j], i) :
+            input(i, dimensions[j]);
+        if (!(value == mappedValues[j] || std::isnan(value)))
+          elemsToKeep.push_back(value);
       }
+
+      elems[j] = elemsToKeep.size();
+      if (!elemsToKeep.empty())
+        medians[j] = Median(elemsToKeep);
     }
-    else
+
+    if (arma::any(elems == 0))
+      Log::Fatal << "it is impossible to calculate median; no valid elements "
+          << "in the dimension" << std::endl;
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) numPoints; ++i)
     {
-      for (size_t i = 0; i < input.n_rows; ++i)
+      for (size_t j = 0; j < numDimensions; ++j)
       {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
-        {
-          targets.emplace_back(i, dimension);
-        }
-        else
-        {
-           elemsToKeep.push_back(input(i, dimension));
-        }
+        T& value = columnMajor ? input(dimensions[j], i) :
+            input(i, dimensions[j]);
+        if (value == mappedValues[j] || std::isnan(value))
+          value = medians[j];
       }
     }
+  }
 
-    // calculate median
-    const double median = arma::median(arma::vec(elemsToKeep));
+ private:
+  /**
+   * Compute the median of the given (non-empty) values, like arma::median():
+   * the middle value, or the average of the two middle values.  The values are
+   * reordered.
+   */
+  static double Median(std::vector<double>& values)
+  {
+    const size_t middle = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + middle, values.end());
+    if (values.size() % 2 == 1)
+      return values[middle];
 
-    for (const PairType& target : targets)
-    {
-       input(target.first, target.second) = median;
-    }
+    // The other middle value is the largest of the lower half.
+    const double lower = *std::max_element(values.begin(),
+        values.begin() + middle);
+    return (lower + values[middle]) / 2.0;
   }
 }; // class MedianImputation
 
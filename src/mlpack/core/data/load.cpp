@@ -81,6 +81,16 @@ template bool Load<float>(const std::string&,
                           const bool,
                           const bool);
 
+template bool LoadLibSVM<float>(const std::string&,
+                                arma::SpMat<float>&,
+                                arma::rowvec&,
+                                const bool);
+
+template bool LoadLibSVM<double>(const std::string&,
+                                 arma::SpMat<double>&,
+                                 arma::rowvec&,
+                                 const bool);
+
 template bool Load<int, IncrementPolicy>(const std::string&,
                                          arma::Mat<int>&,
                                          DatasetMapper<IncrementPolicy>&,
@@ -21,6 +21,9 @@
 #include "format.hpp"
 #include "dataset_mapper.hpp"
 #include "image_info.hpp"
+#include "image_options.hpp"
+#include "mapped_matrix.hpp"
+#include "mapped_model.hpp"
 
 namespace mlpack {
 namespace data /** Functions to load and save matrices and models. */ {
@@ -42,6 +45,11 @@ namespace data /** Functions to load and save matrices and models. */ {
  *  - Armadillo binary (arma::arma_binary), denoted by .bin
  *  - HDF5 (arma::hdf5_binary), denoted by .hdf, .hdf5, .h5, or .he5
  *
+ * mlpack binary matrix files (see MatrixFileHeader), denoted by .mlmat, can
+ * also be loaded; they are never transposed, and must hold elements of type
+ * eT.  To use such a file without copying it, load it into a MappedMatrix
+ * instead.
+ *
  * By default, this function will try to automatically determine the type of
  * file to load based on its extension and by inspecting the file.  If you know
  * the file type and want to specify it manually, override the default
@@ -84,6 +92,12 @@ bool Load(const std::string& filename,
  *  - TXT (coord_ascii), denoted by .txt
  *  - Raw binary (raw_binary), denoted by .bin
  *  - Armadillo binary (arma_binary), denoted by .bin
+ *  - mlpack binary sparse matrix (see SparseMatrixFileHeader), denoted by
+ *    .mlsp
+ *
+ * Coordinate files are memory-mapped and parsed in parallel.  Matrices in the
+ * mlpack binary sparse format are stored in compressed sparse column form, so
+ * they are loaded without parsing or sorting, and are never transposed.
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
@@ -340,6 +354,75 @@ extern template bool Load<double, IncrementPolicy>(
  * @endcond
  */
 
+/**
+ * Map an mlpack binary matrix file (denoted by .mlmat; see MatrixFileHeader)
+ * without reading or copying it.  The matrix aliases the mapped file; see
+ * MappedMatrix for details.  Files in this format are written by data::Save()
+ * when given a filename with the .mlmat extension, or a block of columns at a
+ * time by MatrixFileWriter.
+ *
+ * If the parameter 'fatal' is set to true, a std::runtime_error exception will
+ * be thrown if the matrix does not load successfully.
+ *
+ * @param filename Name of file to map.
+ * @param matrix MappedMatrix to hold the mapped file.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool Load(const std::string& filename,
+          MappedMatrix<eT>& matrix,
+          const bool fatal = false);
+
+/**
+ * Load a sparse dataset and its labels from a file in the libsvm (svmlight)
+ * format, where each line holds one point as "label index:value ...", with
+ * 1-based feature indices.  Each point becomes a column of the matrix (so the
+ * matrix is not transposed), and the number of rows is the largest feature
+ * index in the file.  The file is memory-mapped and parsed in parallel; see
+ * SparseLoader for details.
+ *
+ * The resulting matrix can be given directly to the methods that accept
+ * sparse data, such as LogisticRegression, SoftmaxRegression, LinearSVM, CF
+ * and AMF.  Labels are given as they are in the file; use
+ * data::NormalizeLabels() to map them to 0, 1, 2, ... for classifiers.
+ *
+ * If the parameter 'fatal' is set to true, a std::runtime_error exception will
+ * be thrown if the file does not load successfully.
+ *
+ * @param filename Name of file to load.
+ * @param matrix Sparse matrix to load the points into.
+ * @param labels Row vector to load the labels into.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool LoadLibSVM(const std::string& filename,
+                arma::SpMat<eT>& matrix,
+                arma::rowvec& labels,
+                const bool fatal = false);
+
+/**
+ * Don't document these with doxygen; these declarations aren't helpful to
+ * users.
+ *
+ * @cond
+ */
+
+extern template bool LoadLibSVM<float>(const std::string&,
+                                       arma::SpMat<float>&,
+                                       arma::rowvec&,
+                                       const bool);
+
+extern template bool LoadLibSVM<double>(const std::string&,
+                                        arma::SpMat<double>&,
+                                        arma::rowvec&,
+                                        const bool);
+
+/**
+ * @endcond
+ */
+
 /**
  * Load a model from a file, guessing the filetype from the extension, or,
  * optionally, loading the specified format.  If automatic extension detection
@@ -351,9 +434,12 @@ extern template bool Load<double, IncrementPolicy>(
  *  - json, denoted by .json
  *  - xml, denoted by .xml
  *  - binary, denoted by .bin
+ *  - mapped binary, denoted by .mlmodel, where the matrices of the model are
+ *    stored as aligned blocks that can be memory-mapped (see MappedModel)
  *
  * The format parameter can take any of the values in the 'format' enum:
- * 'format::autodetect', 'format::json', 'format::xml', and 'format::binary'.
+ * 'format::autodetect', 'format::json', 'format::xml', 'format::binary', and
+ * 'format::mapped'.
  * The autodetect functionality operates on the file extension (so, "file.txt"
  * would be autodetected as text).
  *
@@ -392,7 +478,8 @@ bool Load(const std::string& filename,
           const bool fatal = false);
 
 /**
- * Load the image file into the given matrix.
+ * Load the image files into the given matrix, one image per column.  The
+ * images are decoded in parallel, and must all have the same size.
  *
  * @param files A vector consisting of filenames.
  * @param matrix Matrix to save the image from.
@@ -406,12 +493,55 @@ bool Load(const std::vector<std::string>& files,
           ImageInfo& info,
           const bool fatal = false);
 
+/**
+ * Load the image files into the given matrix, one image per column, resizing,
+ * normalizing and laying out each image as specified by the given
+ * ImageOptions.  The images are decoded in parallel, each directly into its
+ * column of the matrix, which is allocated once.  The number of channels to
+ * load is taken from info (1 for grayscale, otherwise 3 for RGB); on return,
+ * info holds the size of the images in the matrix.
+ *
+ * @param files A vector consisting of filenames.
+ * @param matrix Matrix to load the images into.
+ * @param info An object of ImageInfo class.
+ * @param options How to resize, normalize and lay out the images.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool Load(const std::vector<std::string>& files,
+          arma::Mat<eT>& matrix,
+          ImageInfo& info,
+          const ImageOptions& options,
+          const bool fatal = false);
+
 // Implementation found in load_image.cpp.
 bool LoadImage(const std::string& filename,
                arma::Mat<unsigned char>& matrix,
                ImageInfo& info,
                const bool fatal = false);
 
+/**
+ * Decode the given image file into interleaved 8-bit pixels, with the given
+ * number of channels (1 for grayscale, otherwise 3 for RGB).  This does not
+ * log anything, and can be called from several threads at once.
+ * Implementation found in load_image.cpp.
+ *
+ * @param filename Name of the image file.
+ * @param channels Number of channels to decode.
+ * @param pixels Vector to store the pixels in.
+ * @param width Set to the width of the image.
+ * @param height Set to the height of the image.
+ * @param error Set to a description of the error, if decoding fails.
+ * @return Whether the image was decoded.
+ */
+bool DecodeImage(const std::string& filename,
+                 const size_t channels,
+                 std::vector<unsigned char>& pixels,
+                 size_t& width,
+                 size_t& height,
+                 std::string& error);
+
 } // namespace data
 } // namespace mlpack
 
@@ -421,5 +551,7 @@ bool LoadImage(const std::string& filename,
 #include "load_vec_impl.hpp"
 // Include implementation of Load() for images.
 #include "load_image_impl.hpp"
+// Include implementation of Load() for mapped matrices.
+#include "load_mapped_impl.hpp"
 
 #endif
@@ -17,6 +17,9 @@
 
 #include <boost/algorithm/string/trim.hpp>
 #include "is_naninf.hpp"
+#include "load_csv.hpp"
+#include "mapped_file.hpp"
+#include "string_map.hpp"
 
 namespace mlpack {
 namespace data {
@@ -176,121 +179,258 @@ void LoadARFF(const std::string& filename,
     }
   }
 
-  // We need to find out how many lines of data are in the file.
-  std::streampos pos = ifs.tellg();
-  size_t row = 0;
-  while (ifs.good())
-  {
-    std::getline(ifs, line, '\n');
-    ++row;
-  }
-  // Uncount the EOF row.
-  --row;
+  // The data section is parsed in parallel from the mapped file, in chunks of
+  // whole lines, as LoadCSV does.
+  const size_t dataOffset = (size_t) ifs.tellg();
+  ifs.close();
 
-  // Since we've hit the EOF, we have to call clear() so we can seek again.
-  ifs.clear();
-  ifs.seekg(pos);
+  MappedFile file(filename);
+  const char* fileEnd = file.Data() + file.Size();
+  std::vector<LoadCSV::Chunk> chunks;
+  LoadCSV::SplitChunks(file.Data() + std::min(dataOffset, file.Size()),
+      fileEnd, chunks);
 
-  // Now, set the size of the matrix.
-  matrix.set_size(dimensionality, row);
+  // Blank lines and comment lines hold no point.
+  auto isPoint = [](const char* begin, const char* end)
+  {
+    return (begin != end && *begin != '%');
+  };
 
-  // Now we are looking at the @data section.
-  row = 0;
-  while (ifs.good())
+  // Count the points of each chunk, to find the column of its first point.
+  std::vector<size_t> firstPoint(chunks.size() + 1, 0);
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t c = 0; c < (omp_size_t) chunks.size(); ++c)
   {
-    std::getline(ifs, line, '\n');
-    boost::trim(line);
-    // Each line of the @data section must be a CSV (except sparse data, which
-    // we will handle later).  So now we can tokenize the
-    // CSV and parse it.  The '?' representing a missing value is not allowed,
-    // so if that occurs we throw an exception.  We also throw an exception if
-    // any piece of data does not match its type (categorical or numeric).
-
-    // If the first character is {, it is sparse data, and we can just say this
-    // is not handled for now...
-    if (line[0] == '{')
-      throw std::runtime_error("cannot yet parse sparse ARFF data");
-
-    // Tokenize the line.
-    typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
-    boost::escaped_list_separator<char> sep("\\", ",", "\"");
-    Tokenizer tok(line, sep);
-
-    size_t col = 0;
-    std::stringstream token;
-    for (Tokenizer::iterator it = tok.begin(); it != tok.end(); ++it)
+    size_t points = 0;
+    LoadCSV::ForEachLine(chunks[c], [&](const size_t /* line */,
+        const char* begin, const char* end)
     {
-      // Check that we are not too many columns in.
-      if (col >= matrix.n_rows)
-      {
-        std::stringstream error;
-        error << "Too many columns in line " << (headerLines + row) << ".";
-        throw std::runtime_error(error.str());
-      }
+      if (isPoint(begin, end))
+        ++points;
+    });
+    firstPoint[c + 1] = points;
+  }
+  for (size_t c = 0; c < chunks.size(); ++c)
+    firstPoint[c + 1] += firstPoint[c];
+
+  matrix.set_size(dimensionality, firstPoint.back());
+
+  // Numeric values are stored directly.  Categorical values are interned into
+  // a StringMap per chunk (tagged with their dimension), and mapped with the
+  // DatasetMapper after the parallel pass, in file order, so that the mappings
+  // are the same as if the file were read serially.
+  std::vector<StringMap> strings(chunks.size());
+  std::vector<std::vector<size_t>> stringLines(chunks.size());
+  std::vector<std::vector<std::pair<size_t, size_t>>> uses(chunks.size());
+  std::vector<std::string> errors(chunks.size());
+
+  std::vector<char> categorical(dimensionality);
+  for (size_t i = 0; i < dimensionality; ++i)
+    categorical[i] = (info.Type(i) == Datatype::categorical);
+
+  // Return the end of the field that starts at the given position: the next
+  // ',' or '%' (or '}', for sparse data) that is not inside a quoted string.
+  auto fieldEnd = [](const char* pos, const char* end, const bool sparse)
+  {
+    while (pos != end && (*pos == ' ' || *pos == '\t'))
+      ++pos;
+    if (pos != end && (*pos == '"' || *pos == '\''))
+    {
+      const char quote = *pos++;
+      while (pos != end && *pos != quote)
+        pos += (*pos == '\\' && pos + 1 != end) ? 2 : 1;
+      if (pos != end)
+        ++pos;
+    }
+    while (pos != end && *pos != ',' && *pos != '%' && !(sparse && *pos == '}'))
+      ++pos;
+    return pos;
+  };
+
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (omp_size_t c = 0; c < (omp_size_t) chunks.size(); ++c)
+  {
+    size_t point = firstPoint[c];
+    std::string unquoted;
+    LoadCSV::ForEachLine(chunks[c], [&](const size_t line, const char* begin,
+        const char* end)
+    {
+      if (!errors[c].empty() || !isPoint(begin, end))
+        return;
 
-      // What should this token be?
-      if (info.Type(col) == Datatype::categorical)
+      const size_t lineNumber = headerLines + line + 1;
+      const size_t col = point++;
+
+      // Store the value of the given token in dimension d; return false (and
+      // set the error) if it is invalid.
+      auto store = [&](const size_t d, const char* tokenBegin,
+          const char* tokenEnd)
       {
-        // Strip spaces before mapping.
-        std::string token = *it;
-        boost::trim(token);
-        const size_t currentNumMappings = info.NumMappings(col);
-        const eT result = info.template MapString<eT>(token, col);
-
-        // If the set of categories was pre-specified, then we must crash if
-        // this was not one of those categories.
-        if (categoryStrings.count(col) > 0 &&
-            currentNumMappings < info.NumMappings(col))
+        LoadCSV::Trim(tokenBegin, tokenEnd);
+
+        // Remove quotes, and resolve escaped characters.
+        if (tokenEnd - tokenBegin >= 2 && (*tokenBegin == '"' ||
+            *tokenBegin == '\'') && *(tokenEnd - 1) == *tokenBegin)
         {
-          std::stringstream error;
-          error << "Parse error at line " << (headerLines + row) << " token "
-              << col << ": category \"" << token << "\" not in the set of known"
-              << " categories for this dimension (";
-          for (size_t i = 0; i < categoryStrings.at(col).size() - 1; ++i)
-            error << "\"" << categoryStrings.at(col)[i] << "\", ";
-          error << "\"" << categoryStrings.at(col).back() << "\").";
-          throw std::runtime_error(error.str());
+          unquoted.clear();
+          for (const char* p = tokenBegin + 1; p < tokenEnd - 1; ++p)
+          {
+            if (*p == '\\' && p + 1 < tokenEnd - 1)
+              ++p;
+            unquoted.push_back(*p);
+          }
+          tokenBegin = unquoted.data();
+          tokenEnd = tokenBegin + unquoted.size();
         }
 
-        // We load transposed.
-        matrix(col, row) = result;
-      }
-      else if (info.Type(col) == Datatype::numeric)
-      {
-        // Attempt to read as numeric.
-        token.clear();
-        token.str(*it);
+        if (categorical[d])
+        {
+          const size_t numStrings = strings[c].Size();
+          const size_t id = strings[c].Insert(tokenBegin,
+              tokenEnd - tokenBegin, d);
+          if (id == numStrings)
+            stringLines[c].push_back(lineNumber);
+          uses[c].push_back(std::make_pair(col * dimensionality + d, id));
+          return true;
+        }
+
+        double value;
+        if (LoadCSV::ParseDouble(tokenBegin, tokenEnd, value))
+        {
+          matrix(d, col) = (eT) value;
+          return true;
+        }
 
+        // Anything else is read as a stream would read it, which also
+        // accepts NaN and inf.
+        std::stringstream token(std::string(tokenBegin, tokenEnd));
         eT val = eT(0);
         token >> val;
+        if (token.fail() && !IsNaNInf(val, token.str()))
+        {
+          // Okay, it's not NaN or inf.  If it's '?', we issue a specific
+          // error, otherwise we issue a general error.
+          std::stringstream error;
+          if (token.str() == "?")
+            error << "Missing values ('?') not supported, ";
+          else
+            error << "Parse error ";
+          error << "at line " << lineNumber << " token " << d << ": \""
+              << token.str() << "\".";
+          errors[c] = error.str();
+          return false;
+        }
+
+        matrix(d, col) = val;
+        return true;
+      };
 
-        if (token.fail())
+      if (*begin == '{')
+      {
+        // Sparse data: "{index value, index value, ...}", with 0-based
+        // indices; all other values are zero.
+        matrix.col(col).zeros();
+        const char* pos = begin + 1;
+        while (pos != end && *pos != '}' && *pos != '%')
         {
-          // Check for NaN or inf.
-          if (!IsNaNInf(val, token.str()))
+          const char* entryEnd = fieldEnd(pos, end, true);
+          const char* entryBegin = pos;
+          const char* lastEnd = entryEnd;
+          LoadCSV::Trim(entryBegin, lastEnd);
+          if (entryBegin != lastEnd)
           {
-            // Okay, it's not NaN or inf.  If it's '?', we issue a specific
-            // error, otherwise we issue a general error.
-            std::stringstream error;
-            std::string tokenStr = token.str();
-            boost::trim(tokenStr);
-            if (tokenStr == "?")
-              error << "Missing values ('?') not supported, ";
-            else
-              error << "Parse error ";
-            error << "at line " << (headerLines + row) << " token " << col
-                << ": \"" << tokenStr << "\".";
-            throw std::runtime_error(error.str());
+            size_t index = 0;
+            const char* indexEnd = entryBegin;
+            for (; indexEnd != lastEnd && *indexEnd >= '0' && *indexEnd <= '9';
+                ++indexEnd)
+              index = 10 * index + (*indexEnd - '0');
+
+            if (indexEnd == entryBegin || indexEnd == lastEnd ||
+                !std::isspace((unsigned char) *indexEnd) ||
+                index >= dimensionality)
+            {
+              std::stringstream error;
+              error << "Parse error at line " << lineNumber << ": invalid "
+                  << "sparse entry \"" << std::string(entryBegin, lastEnd)
+                  << "\".";
+              errors[c] = error.str();
+              return;
+            }
+
+            if (!store(index, indexEnd, lastEnd))
+              return;
           }
+
+          pos = (entryEnd != end && *entryEnd == ',') ? entryEnd + 1 :
+              entryEnd;
         }
 
-        // If we made it to here, we have a value.
-        matrix(col, row) = val; // We load transposed.
+        return;
       }
 
-      ++col;
+      // Each line of the @data section must otherwise be a CSV line.
+      size_t d = 0;
+      const char* pos = begin;
+      while (true)
+      {
+        const char* tokenEnd = fieldEnd(pos, end, false);
+        if (d >= dimensionality)
+        {
+          std::stringstream error;
+          error << "Too many columns in line " << lineNumber << ".";
+          errors[c] = error.str();
+          return;
+        }
+
+        if (!store(d++, pos, tokenEnd))
+          return;
+
+        if (tokenEnd == end || *tokenEnd == '%')
+          break;
+        pos = tokenEnd + 1;
+      }
+
+      if (d < dimensionality)
+      {
+        std::stringstream error;
+        error << "Too few columns in line " << lineNumber << ".";
+        errors[c] = error.str();
+      }
+    });
+  }
+
+  for (size_t c = 0; c < chunks.size(); ++c)
+    if (!errors[c].empty())
+      throw std::runtime_error(errors[c]);
+
+  for (size_t c = 0; c < chunks.size(); ++c)
+  {
+    std::vector<eT> values(strings[c].Size());
+    for (size_t id = 0; id < strings[c].Size(); ++id)
+    {
+      const size_t col = strings[c].Tag(id);
+      const size_t currentNumMappings = info.NumMappings(col);
+      values[id] = info.template MapString<eT>(strings[c].String(id), col);
+
+      // If the set of categories was pre-specified, then we must crash if
+      // this was not one of those categories.
+      if (categoryStrings.count(col) > 0 &&
+          currentNumMappings < info.NumMappings(col))
+      {
+        std::stringstream error;
+        error << "Parse error at line " << stringLines[c][id] << " token "
+            << col << ": category \"" << strings[c].String(id) << "\" not in "
+            << "the set of known categories for this dimension (";
+        for (size_t i = 0; i < categoryStrings.at(col).size() - 1; ++i)
+          error << "\"" << categoryStrings.at(col)[i] << "\", ";
+        error << "\"" << categoryStrings.at(col).back() << "\").";
+        throw std::runtime_error(error.str());
+      }
     }
-    ++row;
+
+    #pragma omp parallel for
+    for (omp_size_t u = 0; u < (omp_size_t) uses[c].size(); ++u)
+      matrix[uses[c][u].first] = values[uses[c][u].second];
   }
 }
 
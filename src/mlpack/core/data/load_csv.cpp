@@ -3,7 +3,7 @@
  * @author Tham Ngap Wei
  * @author Mehul Kumar Nirala
  *
- * A CSV reader that uses boost::spirit.
+ * A parallel CSV reader over a memory-mapped file.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -12,75 +12,272 @@
  */
 #include "load_csv.hpp"
 
-using namespace boost::spirit;
+#include <cerrno>
+#include <cstdlib>
 
 namespace mlpack {
 namespace data {
 
 LoadCSV::LoadCSV(const std::string& file) :
   extension(Extension(file)),
-  filename(file),
-  inFile(file)
+  filename(file)
 {
-  // Attempt to open stream.
+  if (extension == "csv")
+    delimiter = ',';
+  else if (extension == "txt")
+    delimiter = ' ';
+  else // TSV.
+    delimiter = '\t';
+
+  // Attempt to map the file.
+  try
+  {
+    this->file.reset(new MappedFile(file));
+  }
+  catch (const std::exception& /* e */)
+  {
+    // CheckOpen() will report the error.
+  }
+
   CheckOpen();
+}
 
-  //! Spirit rule for parsing quoted string.
-  boost::spirit::qi::rule<std::string::iterator, iter_type()> quotedRule;
-  // Match quoted strings as: "string" or 'string'
-  quotedRule = qi::raw[(qi::char_("'") >> *((qi::char_ - "'") |
-                               "'" >> qi::char_("'")) >> "'") |
-                       (qi::char_('"') >> *((qi::char_ - '"') |
-                               '"' >> qi::char_('"')) >> '"') ];
+void LoadCSV::CheckOpen()
+{
+  if (!file)
+  {
+    std::ostringstream oss;
+    oss << "Cannot open file '" << filename << "'. " << std::endl;
+    throw std::runtime_error(oss.str());
+  }
+}
 
-  // Set rules.
-  if (extension == "csv")
+size_t LoadCSV::SplitChunks(const MappedFile& file,
+                            std::vector<Chunk>& chunks)
+{
+  return SplitChunks(file.Data(), file.Data() + file.Size(), chunks);
+}
+
+size_t LoadCSV::SplitChunks(const char* begin,
+                            const char* end,
+                            std::vector<Chunk>& chunks)
+{
+  chunks.clear();
+  if (begin == end)
+    return 0;
+
+  // A few chunks per thread balance the load, but each one should be large
+  // enough that the splitting does not cost more than it saves.
+  size_t numChunks = 1;
+  #ifdef HAS_OPENMP
+    numChunks = 4 * omp_get_max_threads();
+  #endif
+  const size_t minChunkSize = 1 << 20;
+  const size_t size = end - begin;
+  numChunks = std::max((size_t) 1, std::min(numChunks, size / minChunkSize));
+  const size_t chunkSize = size / numChunks;
+
+  // Each chunk ends just after a newline.
+  const char* pos = begin;
+  for (size_t c = 0; c < numChunks && pos < end; ++c)
   {
-    // Match all characters that are not ',', '\r', or '\n'.
-    stringRule = quotedRule.copy() | qi::raw[*~qi::char_(",\r\n")];
+    const char* chunkEnd = end;
+    if (c + 1 < numChunks && pos + chunkSize < end)
+    {
+      const char* newline = (const char*) std::memchr(pos + chunkSize, '\n',
+          end - (pos + chunkSize));
+      chunkEnd = newline ? newline + 1 : end;
+    }
+
+    chunks.push_back(Chunk{ pos, chunkEnd, 0 });
+    pos = chunkEnd;
   }
-  else if (extension == "txt")
+
+  // Count the lines of each chunk in parallel; the last line need not end
+  // with a newline.
+  std::vector<size_t> lines(chunks.size(), 0);
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t c = 0; c < (omp_size_t) chunks.size(); ++c)
   {
-    // Match all characters that are not ' ', ',', '\r', or '\n'.
-    stringRule = quotedRule.copy() | qi::raw[*~qi::char_(" ,\r\n")];
+    size_t count = 0;
+    const char* p = chunks[c].begin;
+    while (p < chunks[c].end)
+    {
+      const char* newline = (const char*) std::memchr(p, '\n',
+          chunks[c].end - p);
+      ++count;
+      p = newline ? newline + 1 : chunks[c].end;
+    }
+    lines[c] = count;
   }
-  else // TSV.
+
+  size_t numLines = 0;
+  for (size_t c = 0; c < chunks.size(); ++c)
   {
-    // Match all characters that are not '\t', '\r', or '\n'.
-    stringRule = quotedRule.copy() | qi::raw[*~qi::char_("\t\r\n")];
+    chunks[c].firstLine = numLines;
+    numLines += lines[c];
   }
 
-  if (extension == "csv")
+  return numLines;
+}
+
+const char* LoadCSV::SkipQuoted(const char* begin, const char* end)
+{
+  const char quote = *begin;
+  const char* pos = begin + 1;
+  while (pos != end)
   {
-    // Extract a single comma as the delimiter, catching whitespace on either
-    // side.
-    delimiterRule = qi::raw[(*qi::char_(" ") >> qi::char_(",") >>
-        *qi::char_(" "))];
+    if (*pos == quote)
+    {
+      // A doubled quote is an escaped quote.
+      if (pos + 1 != end && *(pos + 1) == quote)
+        pos += 2;
+      else
+        return pos + 1;
+    }
+    else
+    {
+      ++pos;
+    }
   }
-  else if (extension == "txt")
+
+  // The quote is not terminated.
+  return end;
+}
+
+bool LoadCSV::ParseDouble(const char* begin, const char* end, double& value)
+{
+  // Exactly representable powers of ten.
+  static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+      1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+      1e20, 1e21, 1e22 };
+
+  const char* pos = begin;
+  bool negative = false;
+  if (pos != end && (*pos == '+' || *pos == '-'))
   {
-    // This one is a little more difficult, we need to catch any number of
-    // spaces more than one.
-    delimiterRule = qi::raw[+qi::char_(" ")];
+    negative = (*pos == '-');
+    ++pos;
   }
-  else // TSV.
+
+  // Collect up to 19 significant digits in an integer; the number is exact
+  // only if no nonzero digit is dropped.
+  uint64_t mantissa = 0;
+  size_t significant = 0;
+  bool truncated = false;
+  long exponent = 0;
+  size_t digits = 0;
+  for (; pos != end && *pos >= '0' && *pos <= '9'; ++pos, ++digits)
+  {
+    if (significant < 19)
+    {
+      mantissa = 10 * mantissa + (*pos - '0');
+      if (mantissa != 0)
+        ++significant;
+    }
+    else
+    {
+      ++exponent;
+      truncated |= (*pos != '0');
+    }
+  }
+
+  if (pos != end && *pos == '.')
+  {
+    ++pos;
+    for (; pos != end && *pos >= '0' && *pos <= '9'; ++pos, ++digits)
+    {
+      if (significant < 19)
+      {
+        mantissa = 10 * mantissa + (*pos - '0');
+        if (mantissa != 0)
+          ++significant;
+        --exponent;
+      }
+      else
+      {
+        truncated |= (*pos != '0');
+      }
+    }
+  }
+
+  if (digits == 0)
+    return false;
+
+  if (pos != end && (*pos == 'e' || *pos == 'E'))
   {
-    // Catch a tab character, possibly with whitespace on either side.
-    delimiterRule = qi::raw[(*qi::char_(" ") >> qi::char_("\t") >>
-        *qi::char_(" "))];
+    ++pos;
+    bool negativeExponent = false;
+    if (pos != end && (*pos == '+' || *pos == '-'))
+    {
+      negativeExponent = (*pos == '-');
+      ++pos;
+    }
+
+    if (pos == end || *pos < '0' || *pos > '9')
+      return false;
+
+    long e = 0;
+    for (; pos != end && *pos >= '0' && *pos <= '9'; ++pos)
+    {
+      if (e < 100000)
+        e = 10 * e + (*pos - '0');
+    }
+    exponent += negativeExponent ? -e : e;
+  }
+
+  if (pos != end)
+    return false;
+
+  // Fast path: both the mantissa and the power of ten are exact doubles, so a
+  // single multiplication or division rounds correctly.
+  if (!truncated && mantissa <= (uint64_t(1) << 53) && exponent >= -22 &&
+      exponent <= 22)
+  {
+    value = (double) mantissa;
+    if (exponent < 0)
+      value /= powers[-exponent];
+    else
+      value *= powers[exponent];
+    if (negative)
+      value = -value;
+    return true;
+  }
+
+  // Otherwise let strtod() round it; it needs a terminated string.
+  const size_t length = end - begin;
+  char buffer[64];
+  std::string copy;
+  const char* str;
+  if (length < sizeof(buffer))
+  {
+    std::memcpy(buffer, begin, length);
+    buffer[length] = '\0';
+    str = buffer;
+  }
+  else
+  {
+    copy.assign(begin, end);
+    str = copy.c_str();
   }
+
+  char* parsedEnd;
+  errno = 0;
+  value = std::strtod(str, &parsedEnd);
+  return (errno != ERANGE && parsedEnd == str + length);
 }
 
-void LoadCSV::CheckOpen()
+bool LoadCSV::NumbersPassThrough(const MissingPolicy& policy)
 {
-  if (!inFile.is_open())
+  // A missing value that reads as a number has to be mapped to NaN.
+  double value;
+  for (const std::string& missing : policy.MissingSet())
   {
-    std::ostringstream oss;
-    oss << "Cannot open file '" << filename << "'. " << std::endl;
-    throw std::runtime_error(oss.str());
+    if (ParseDouble(missing.data(), missing.data() + missing.size(), value))
+      return false;
   }
 
-  inFile.unsetf(std::ios::skipws);
+  return true;
 }
 
 } // namespace data
@@ -12,33 +12,60 @@
 #ifndef MLPACK_CORE_DATA_LOAD_CSV_HPP
 #define MLPACK_CORE_DATA_LOAD_CSV_HPP
 
-#include <boost/spirit/include/qi.hpp>
-#include <boost/algorithm/string/trim.hpp>
-
 #include <mlpack/core.hpp>
 #include <mlpack/core/util/log.hpp>
 
+#include <cctype>
+#include <cstring>
 #include <set>
 #include <string>
 
 #include "extension.hpp"
 #include "format.hpp"
 #include "dataset_mapper.hpp"
+#include "mapped_file.hpp"
+#include "string_map.hpp"
+#include "map_policies/missing_policy.hpp"
 
 namespace mlpack {
 namespace data {
 
+// Forward declarations, for the friend declarations below.
+template<typename eT, typename PolicyType>
+class ChunkedReader;
+class SparseLoader;
+template<typename eT, typename PolicyType>
+void LoadARFF(const std::string& filename,
+              arma::Mat<eT>& matrix,
+              DatasetMapper<PolicyType>& info);
+
 /**
- *Load the csv file.This class use boost::spirit
- *to implement the parser, please refer to following link
- *http://theboostcpplibraries.com/boost.spirit for quick review.
+ * Load a CSV, TSV or space-separated text file.  The file is memory-mapped and
+ * split into chunks of whole lines, which are tokenized and parsed in parallel
+ * with OpenMP.  Tokens that are plain decimal numbers are converted directly
+ * when the DatasetMapper policy would return them unmapped anyway
+ * (IncrementPolicy without forced mappings, and MissingPolicy unless a missing
+ * value reads as a number); all other tokens are handed to the DatasetMapper
+ * afterwards, in file order, so the mappings are the same as if the file were
+ * read serially.  With any other policy, or for non-double matrices, every
+ * token goes through the DatasetMapper.
+ *
+ * With IncrementPolicy and MissingPolicy, the tokens of each chunk are also
+ * interned into a StringMap per chunk in parallel, and only the distinct
+ * strings of each chunk are handed to the DatasetMapper; the values of the
+ * tokens are then filled in from the mappings in parallel.  For columns with
+ * many repeated categories, this removes almost all of the serial work.
+ *
+ * Fields may be quoted with " or '; a quoted field may contain the delimiter,
+ * and the quotes are kept as part of the field.  Whitespace around fields is
+ * ignored.
  */
 class LoadCSV
 {
  public:
   /**
-   * Construct the LoadCSV object on the given file.  This will construct the
-   * rules necessary for loading and attempt to open the file.
+   * Construct the LoadCSV object on the given file.  This will attempt to map
+   * the file.
    */
   LoadCSV(const std::string& file);
 
@@ -54,15 +81,7 @@ class LoadCSV
   template<typename T, typename PolicyType>
   void Load(arma::Mat<T> &inout,
             DatasetMapper<PolicyType> &infoSet,
-            const bool transpose = true)
-  {
-    CheckOpen();
-
-    if (transpose)
-      TransposeParse(inout, infoSet);
-    else
-      NonTransposeParse(inout, infoSet);
-  }
+            const bool transpose = true);
 
   /**
    * Peek at the file to determine the number of rows and columns in the matrix,
@@ -77,77 +96,7 @@ class LoadCSV
   template<typename T, typename MapPolicy>
   void GetMatrixSize(size_t& rows, size_t& cols, DatasetMapper<MapPolicy>& info)
   {
-    using namespace boost::spirit;
-
-    // Take a pass through the file.  If the DatasetMapper policy requires it,
-    // we will pass everything string through MapString().  This might be useful
-    // if, e.g., the MapPolicy needs to find which dimensions are numeric or
-    // categorical.
-
-    // Reset to the start of the file.
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-    rows = 0;
-    cols = 0;
-
-    // First, count the number of rows in the file (this is the dimensionality).
-    std::string line;
-    while (std::getline(inFile, line))
-    {
-      ++rows;
-    }
-
-    // Reset the DatasetInfo object, if needed.
-    if (info.Dimensionality() == 0)
-    {
-      info.SetDimensionality(rows);
-    }
-    else if (info.Dimensionality() != rows)
-    {
-      std::ostringstream oss;
-      oss << "data::LoadCSV(): given DatasetInfo has dimensionality "
-          << info.Dimensionality() << ", but data has dimensionality "
-          << rows;
-      throw std::invalid_argument(oss.str());
-    }
-
-    // Now, jump back to the beginning of the file.
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-    rows = 0;
-
-    while (std::getline(inFile, line))
-    {
-      ++rows;
-      // Remove whitespace from either side.
-      boost::trim(line);
-
-      if (rows == 1)
-      {
-        // Extract the number of columns.
-        auto findColSize = [&cols](iter_type) { ++cols; };
-        qi::parse(line.begin(), line.end(),
-            stringRule[findColSize] % delimiterRule);
-      }
-
-      // I guess this is technically a second pass, but that's ok... still the
-      // same idea...
-      if (MapPolicy::NeedsFirstPass)
-      {
-        // In this case we must pass everything we parse to the MapPolicy.
-        auto firstPassMap = [&](const iter_type& iter)
-        {
-          std::string str(iter.begin(), iter.end());
-          boost::trim(str);
-
-          info.template MapFirstPass<T>(std::move(str), rows - 1);
-        };
-
-        // Now parse the line.
-        qi::parse(line.begin(), line.end(),
-            stringRule[firstPassMap] % delimiterRule);
-      }
-    }
+    GetSize<T>(rows, cols, info, false);
   }
 
   /**
@@ -165,71 +114,61 @@ class LoadCSV
                               size_t& cols,
                               DatasetMapper<MapPolicy>& info)
   {
-    using namespace boost::spirit;
-
-    // Take a pass through the file.  If the DatasetMapper policy requires it,
-    // we will pass everything string through MapString().  This might be useful
-    // if, e.g., the MapPolicy needs to find which dimensions are numeric or
-    // categorical.
-
-    // Reset to the start of the file.
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-    rows = 0;
-    cols = 0;
-
-    std::string line;
-    while (std::getline(inFile, line))
-    {
-      ++cols;
-      // Remove whitespace from either side.
-      boost::trim(line);
-
-      if (cols == 1)
-      {
-        // Extract the number of dimensions.
-        auto findRowSize = [&rows](iter_type) { ++rows; };
-        qi::parse(line.begin(), line.end(),
-            stringRule[findRowSize] % delimiterRule);
-
-        // Reset the DatasetInfo object, if needed.
-        if (info.Dimensionality() == 0)
-        {
-          info.SetDimensionality(rows);
-        }
-        else if (info.Dimensionality() != rows)
-        {
-          std::ostringstream oss;
-          oss << "data::LoadCSV(): given DatasetInfo has dimensionality "
-              << info.Dimensionality() << ", but data has dimensionality "
-              << rows;
-          throw std::invalid_argument(oss.str());
-        }
-      }
-
-      // If we need to do a first pass for the DatasetMapper, do it.
-      if (MapPolicy::NeedsFirstPass)
-      {
-        size_t dim = 0;
-
-        // In this case we must pass everything we parse to the MapPolicy.
-        auto firstPassMap = [&](const iter_type& iter)
-        {
-          std::string str(iter.begin(), iter.end());
-          boost::trim(str);
-
-          info.template MapFirstPass<T>(std::move(str), dim++);
-        };
-
-        // Now parse the line.
-        qi::parse(line.begin(), line.end(),
-            stringRule[firstPassMap] % delimiterRule);
-      }
-    }
+    GetSize<T>(rows, cols, info, true);
   }
 
+  /**
+   * Parse the given token as a double, if it is a plain decimal number
+   * ([+-]digits[.digits][(e|E)[+-]digits], with digits on at least one side of
+   * the point).  Numbers whose digits fit in 53 bits and whose exponents are
+   * small are converted exactly without strtod(); others fall back to it.
+   * Numbers that overflow or underflow are not accepted.
+   *
+   * @param begin Start of the token.
+   * @param end End of the token.
+   * @param value Variable to store the number in.
+   * @return Whether the token is a plain decimal number.
+   */
+  static bool ParseDouble(const char* begin, const char* end, double& value);
+
  private:
-  using iter_type = boost::iterator_range<std::string::iterator>;
+  //! ChunkedReader reads text files with the tokenizer of this class.
+  template<typename eT, typename PolicyType>
+  friend class ChunkedReader;
+  //! SparseLoader splits sparse text files into chunks like this class.
+  friend class SparseLoader;
+  //! LoadARFF() parses the data section of ARFF files in chunks too.
+  template<typename eT, typename PolicyType>
+  friend void LoadARFF(const std::string& filename,
+                       arma::Mat<eT>& matrix,
+                       DatasetMapper<PolicyType>& info);
+
+  //! A range of whole lines of the file.
+  struct Chunk
+  {
+    //! Start of the first line.
+    const char* begin;
+    //! End of the last line (after its newline, if any).
+    const char* end;
+    //! Index of the first line in the file.
+    size_t firstLine;
+  };
+
+  //! A token that has to be passed to the DatasetMapper.
+  struct Token
+  {
+    //! Start of the token.
+    const char* begin;
+    //! Length of the token.
+    size_t length;
+    //! Dimension (row of the matrix) of the token.
+    size_t dimension;
+    //! Point (column of the matrix) of the token.
+    size_t point;
+    //! Id of the token in the StringMap of its chunk, if strings are
+    //! interned.
+    size_t id;
+  };
 
   /**
    * Check whether or not the file has successfully opened; throw an exception
@@ -238,163 +177,170 @@ class LoadCSV
   void CheckOpen();
 
   /**
-   * Parse a non-transposed matrix.
+   * Split the given file into chunks of whole lines, one or more per thread,
+   * and count the lines of each chunk in parallel.
    *
-   * @param inout Matrix to load into.
-   * @param infoSet DatasetMapper object to load with.
+   * @param file File to split.
+   * @param chunks Vector to store the chunks in.
+   * @return The number of lines in the file.
    */
-  template<typename T, typename PolicyType>
-  void NonTransposeParse(arma::Mat<T>& inout,
-                         DatasetMapper<PolicyType>& infoSet)
-  {
-    using namespace boost::spirit;
-
-    // Get the size of the matrix.
-    size_t rows, cols;
-    GetMatrixSize<T>(rows, cols, infoSet);
+  static size_t SplitChunks(const MappedFile& file,
+                            std::vector<Chunk>& chunks);
 
-    // Set up output matrix.
-    inout.set_size(rows, cols);
-    size_t row = 0;
-    size_t col = 0;
+  /**
+   * Split the given range of a file into chunks of whole lines, as above.
+   *
+   * @param begin Start of the range (the start of a line).
+   * @param end End of the range.
+   * @param chunks Vector to store the chunks in.
+   * @return The number of lines in the range.
+   */
+  static size_t SplitChunks(const char* begin,
+                            const char* end,
+                            std::vector<Chunk>& chunks);
 
-    // Reset file position.
-    std::string line;
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
+  /**
+   * Determine the size of the matrix and prepare the DatasetMapper, as
+   * GetMatrixSize() and GetTransposeMatrixSize() do.
+   */
+  template<typename T, typename MapPolicy>
+  void GetSize(size_t& rows,
+               size_t& cols,
+               DatasetMapper<MapPolicy>& info,
+               const bool transpose);
 
-    auto setCharClass = [&](iter_type const &iter)
+  /**
+   * Call f(line, begin, end) for each line of the given chunk, with the
+   * whitespace on either side of the line removed.
+   */
+  template<typename FunctionType>
+  static void ForEachLine(const Chunk& chunk, FunctionType&& f)
+  {
+    size_t line = chunk.firstLine;
+    const char* pos = chunk.begin;
+    while (pos < chunk.end)
     {
-      std::string str(iter.begin(), iter.end());
-      if (str == "\t")
-      {
-        str.clear();
-      }
-      boost::trim(str);
-
-      inout(row, col++) = infoSet.template MapString<T>(std::move(str), row);
-    };
+      const char* newline = (const char*) std::memchr(pos, '\n',
+          chunk.end - pos);
+      const char* lineEnd = newline ? newline : chunk.end;
+      const char* lineBegin = pos;
+      Trim(lineBegin, lineEnd);
+      f(line++, lineBegin, lineEnd);
+      pos = newline ? newline + 1 : chunk.end;
+    }
+  }
 
-    while (std::getline(inFile, line))
+  /**
+   * Call f(index, begin, end) for each field of the given line, with the
+   * whitespace on either side of the field removed, and return the number of
+   * fields.  An empty line holds one empty field.
+   */
+  template<typename FunctionType>
+  size_t TokenizeLine(const char* begin,
+                      const char* end,
+                      FunctionType&& f) const
+  {
+    size_t count = 0;
+    const char* pos = begin;
+    while (true)
     {
-      // Remove whitespace from either side.
-      boost::trim(line);
-
-      // Parse the numbers from a line (ex: 1,2,3,4); if the parser finds a
-      // number it will execute the setNum function.
-      const bool canParse = qi::parse(line.begin(), line.end(),
-          stringRule[setCharClass] % delimiterRule);
-
-      // Make sure we got the right number of rows.
-      if (col != cols)
+      const char* tokenBegin = pos;
+      // A quoted field may contain the delimiter.
+      if (pos != end && (*pos == '"' || *pos == '\''))
+        pos = SkipQuoted(pos, end);
+      while (pos != end && *pos != delimiter)
+        ++pos;
+
+      const char* tokenEnd = pos;
+      Trim(tokenBegin, tokenEnd);
+      f(count++, tokenBegin, tokenEnd);
+
+      if (pos == end)
+        break;
+
+      // Skip the delimiter; spaces delimit in runs.
+      ++pos;
+      if (delimiter == ' ')
       {
-        std::ostringstream oss;
-        oss << "LoadCSV::NonTransposeParse(): wrong number of dimensions ("
-            << col << ") on line " << row << "; should be " << cols
-            << " dimensions.";
-        throw std::runtime_error(oss.str());
+        while (pos != end && *pos == ' ')
+          ++pos;
       }
+    }
 
-      if (!canParse)
-      {
-        std::ostringstream oss;
-        oss << "LoadCSV::NonTransposeParse(): parsing error on line " << col
-            << "!";
-        throw std::runtime_error(oss.str());
-      }
+    return count;
+  }
 
-      ++row; col = 0;
-    }
+  //! Remove whitespace from either side of the given range.
+  static void Trim(const char*& begin, const char*& end)
+  {
+    while (begin != end && std::isspace((unsigned char) *begin))
+      ++begin;
+    while (end != begin && std::isspace((unsigned char) *(end - 1)))
+      --end;
   }
 
+  //! Return the position after the quoted string that starts at begin (a
+  //! doubled quote character inside it is an escaped quote).
+  static const char* SkipQuoted(const char* begin, const char* end);
+
   /**
-   * Parse a transposed matrix.
-   *
-   * @param inout Matrix to load into.
-   * @param infoSet DatasetMapper to load with.
+   * Return whether tokens that ParseDouble() accepts can be stored directly,
+   * in dimensions that are not categorical, without calling MapString() of
+   * the given policy.  This is unknown for arbitrary policies.
    */
-  template<typename T, typename PolicyType>
-  void TransposeParse(arma::Mat<T>& inout, DatasetMapper<PolicyType>& infoSet)
+  template<typename PolicyType>
+  static bool NumbersPassThrough(const PolicyType& /* policy */)
   {
-    using namespace boost::spirit;
-
-    // Get matrix size.  This also initializes infoSet correctly.
-    size_t rows, cols;
-    GetTransposeMatrixSize<T>(rows, cols, infoSet);
-
-    // Set the matrix size.
-    inout.set_size(rows, cols);
-
-    // Initialize auxiliary variables.
-    size_t row = 0;
-    size_t col = 0;
-    std::string line;
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-
-    /**
-     * This is the parse rule for strings.  When we get a string we have to pass
-     * it to the DatasetMapper.
-     */
-    auto parseString = [&](iter_type const &iter)
-    {
-      // All parsed values must be mapped.
-      std::string str(iter.begin(), iter.end());
-      boost::trim(str);
-
-      inout(row, col) = infoSet.template MapString<T>(std::move(str), row);
-      ++row;
-    };
-
-    while (std::getline(inFile, line))
-    {
-      // Remove whitespace from either side.
-      boost::trim(line);
-
-      // Reset the row we are looking at.  (Remember this is transposed.)
-      row = 0;
+    return false;
+  }
 
-      // Now use boost::spirit to parse the characters of the line;
-      // parseString() will be called when a token is detected.
-      const bool canParse = qi::parse(line.begin(), line.end(),
-          stringRule[parseString] % delimiterRule);
+  //! IncrementPolicy returns numbers unmapped, unless it maps everything.
+  static bool NumbersPassThrough(const IncrementPolicy& policy)
+  {
+    return !policy.ForceAllMappings();
+  }
 
-      // Make sure we got the right number of rows.
-      if (row != rows)
-      {
-        std::ostringstream oss;
-        oss << "LoadCSV::TransposeParse(): wrong number of dimensions (" << row
-            << ") on line " << col << "; should be " << rows << " dimensions.";
-        throw std::runtime_error(oss.str());
-      }
+  //! MissingPolicy returns numbers unmapped, unless they are missing values.
+  static bool NumbersPassThrough(const MissingPolicy& policy);
 
-      if (!canParse)
-      {
-        std::ostringstream oss;
-        oss << "LoadCSV::TransposeParse(): parsing error on line " << col
-            << "!";
-        throw std::runtime_error(oss.str());
-      }
+  /**
+   * Return whether mapping a string a second time in the same dimension has
+   * no effect with the given policy, so that only the distinct strings of
+   * each chunk have to be passed to the DatasetMapper, in order of first
+   * appearance.  This is unknown for arbitrary policies (which may, for
+   * instance, count the strings).
+   */
+  template<typename PolicyType>
+  static bool MapsDistinctStrings(const PolicyType& /* policy */)
+  {
+    return false;
+  }
 
-      // Increment the column index.
-      ++col;
-    }
+  //! IncrementPolicy maps each distinct string once.
+  static bool MapsDistinctStrings(const IncrementPolicy& /* policy */)
+  {
+    return true;
   }
 
-  //! Spirit rule for parsing.
-  boost::spirit::qi::rule<std::string::iterator, iter_type()> stringRule;
-  //! Spirit rule for delimiters (i.e. ',' for CSVs).
-  boost::spirit::qi::rule<std::string::iterator, iter_type()> delimiterRule;
+  //! MissingPolicy maps each distinct string once.
+  static bool MapsDistinctStrings(const MissingPolicy& /* policy */)
+  {
+    return true;
+  }
 
   //! Extension (type) of file.
   std::string extension;
   //! Name of file.
   std::string filename;
-  //! Opened stream for reading.
-  std::ifstream inFile;
+  //! Field delimiter: ',' for CSV, '\t' for TSV, and runs of ' ' for text.
+  char delimiter;
+  //! The mapped file.
+  std::unique_ptr<MappedFile> file;
 };
 
 } // namespace data
 } // namespace mlpack
 
+#include "load_csv_impl.hpp"
+
 #endif
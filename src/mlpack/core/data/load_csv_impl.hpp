@@ -0,0 +1,329 @@
+/**
+ * @file core/data/load_csv_impl.hpp
+ *
+ * Implementation of the templated parts of the CSV loader.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_CSV_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_CSV_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load_csv.hpp"
+
+namespace mlpack {
+namespace data {
+
+template<typename T, typename PolicyType>
+void LoadCSV::Load(arma::Mat<T>& inout,
+                   DatasetMapper<PolicyType>& infoSet,
+                   const bool transpose)
+{
+  CheckOpen();
+
+  std::vector<Chunk> chunks;
+  const size_t numLines = SplitChunks(*file, chunks);
+
+  // The number of fields of the first line is the number of fields of every
+  // line.
+  size_t numFields = 0;
+  if (numLines > 0)
+  {
+    const char* firstEnd = (const char*) std::memchr(chunks[0].begin, '\n',
+        chunks[0].end - chunks[0].begin);
+    const char* firstBegin = chunks[0].begin;
+    if (!firstEnd)
+      firstEnd = chunks[0].end;
+    Trim(firstBegin, firstEnd);
+    numFields = TokenizeLine(firstBegin, firstEnd,
+        [](size_t, const char*, const char*) { });
+  }
+
+  const size_t rows = transpose ? numFields : numLines;
+  const size_t cols = transpose ? numLines : numFields;
+
+  // Reset the DatasetInfo object, if needed.
+  if (infoSet.Dimensionality() == 0)
+  {
+    infoSet.SetDimensionality(rows);
+  }
+  else if (infoSet.Dimensionality() != rows)
+  {
+    std::ostringstream oss;
+    oss << "data::LoadCSV(): given DatasetInfo has dimensionality "
+        << infoSet.Dimensionality() << ", but data has dimensionality "
+        << rows;
+    throw std::invalid_argument(oss.str());
+  }
+
+  inout.set_size(rows, cols);
+
+  // Parse the chunks in parallel.  Fields that can be stored directly are
+  // stored; the others are kept, in file order, for the DatasetMapper.  If the
+  // policy allows it, they are also interned, so that only the distinct
+  // strings of each chunk go through the DatasetMapper.
+  const bool storeNumbers = std::is_same<T, double>::value &&
+      NumbersPassThrough(infoSet.Policy());
+  const bool intern = MapsDistinctStrings(infoSet.Policy());
+  std::vector<std::vector<Token>> tokens(chunks.size());
+  std::vector<StringMap> strings(intern ? chunks.size() : 0);
+  std::vector<size_t> badLine(chunks.size(), numLines);
+  std::vector<size_t> badCount(chunks.size(), 0);
+
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (omp_size_t c = 0; c < (omp_size_t) chunks.size(); ++c)
+  {
+    ForEachLine(chunks[c], [&](const size_t line, const char* lineBegin,
+        const char* lineEnd)
+    {
+      if (badLine[c] != numLines)
+        return;
+
+      const size_t count = TokenizeLine(lineBegin, lineEnd,
+          [&](const size_t field, const char* begin, const char* end)
+      {
+        if (field >= numFields)
+          return;
+
+        const size_t dimension = transpose ? field : line;
+        const size_t point = transpose ? line : field;
+        double value;
+        if (storeNumbers && ParseDouble(begin, end, value))
+        {
+          inout(dimension, point) = (T) value;
+        }
+        else
+        {
+          const size_t id = intern ?
+              strings[c].Insert(begin, end - begin, dimension) : 0;
+          tokens[c].push_back(Token{ begin, size_t(end - begin), dimension,
+              point, id });
+        }
+      });
+
+      if (count != numFields)
+      {
+        badLine[c] = line;
+        badCount[c] = count;
+      }
+    });
+  }
+
+  for (size_t c = 0; c < chunks.size(); ++c)
+  {
+    if (badLine[c] != numLines)
+    {
+      std::ostringstream oss;
+      oss << "LoadCSV::Load(): wrong number of dimensions (" << badCount[c]
+          << ") on line " << badLine[c] << "; should be " << numFields
+          << " dimensions.";
+      throw std::runtime_error(oss.str());
+    }
+  }
+
+  // Merge step: the remaining fields go through the DatasetMapper in file
+  // order, first for its first pass, if it needs one.
+  if (PolicyType::NeedsFirstPass)
+  {
+    for (size_t c = 0; c < chunks.size(); ++c)
+    {
+      if (intern)
+      {
+        for (size_t id = 0; id < strings[c].Size(); ++id)
+        {
+          infoSet.template MapFirstPass<T>(strings[c].String(id),
+              strings[c].Tag(id));
+        }
+      }
+      else
+      {
+        for (const Token& token : tokens[c])
+        {
+          infoSet.template MapFirstPass<T>(std::string(token.begin,
+              token.length), token.dimension);
+        }
+      }
+    }
+  }
+
+  // Every field of a categorical dimension has to be mapped, including the
+  // numbers that were stored, so those dimensions are collected again.
+  std::vector<char> categorical(rows, 0);
+  bool anyCategorical = false;
+  if (storeNumbers)
+  {
+    for (size_t d = 0; d < rows; ++d)
+    {
+      categorical[d] = (infoSet.Type(d) == Datatype::categorical);
+      anyCategorical |= (categorical[d] != 0);
+    }
+  }
+
+  if (anyCategorical)
+  {
+    std::vector<std::vector<Token>> categoricalTokens(chunks.size());
+    std::vector<StringMap> categoricalStrings(intern ? chunks.size() : 0);
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (omp_size_t c = 0; c < (omp_size_t) chunks.size(); ++c)
+    {
+      ForEachLine(chunks[c], [&](const size_t line, const char* lineBegin,
+          const char* lineEnd)
+      {
+        TokenizeLine(lineBegin, lineEnd, [&](const size_t field,
+            const char* begin, const char* end)
+        {
+          const size_t dimension = transpose ? field : line;
+          if (categorical[dimension])
+          {
+            const size_t id = intern ? categoricalStrings[c].Insert(begin,
+                end - begin, dimension) : 0;
+            categoricalTokens[c].push_back(Token{ begin, size_t(end - begin),
+                dimension, transpose ? line : field, id });
+          }
+        });
+      });
+    }
+
+    if (intern)
+    {
+      std::vector<std::vector<T>> values(chunks.size());
+      for (size_t c = 0; c < chunks.size(); ++c)
+      {
+        values[c].resize(categoricalStrings[c].Size());
+        for (size_t id = 0; id < categoricalStrings[c].Size(); ++id)
+        {
+          values[c][id] = infoSet.template MapString<T>(
+              categoricalStrings[c].String(id), categoricalStrings[c].Tag(id));
+        }
+      }
+
+      #pragma omp parallel for schedule(dynamic, 1)
+      for (omp_size_t c = 0; c < (omp_size_t) chunks.size(); ++c)
+      {
+        for (const Token& token : categoricalTokens[c])
+          inout(token.dimension, token.point) = values[c][token.id];
+      }
+    }
+    else
+    {
+      for (size_t c = 0; c < chunks.size(); ++c)
+      {
+        for (const Token& token : categoricalTokens[c])
+        {
+          inout(token.dimension, token.point) = infoSet.template MapString<T>(
+              std::string(token.begin, token.length), token.dimension);
+        }
+      }
+    }
+  }
+
+  if (intern)
+  {
+    std::vector<std::vector<T>> values(chunks.size());
+    for (size_t c = 0; c < chunks.size(); ++c)
+    {
+      values[c].resize(strings[c].Size());
+      for (size_t id = 0; id < strings[c].Size(); ++id)
+      {
+        if (!categorical[strings[c].Tag(id)])
+        {
+          values[c][id] = infoSet.template MapString<T>(strings[c].String(id),
+              strings[c].Tag(id));
+        }
+      }
+    }
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (omp_size_t c = 0; c < (omp_size_t) chunks.size(); ++c)
+    {
+      for (const Token& token : tokens[c])
+      {
+        if (!categorical[token.dimension])
+          inout(token.dimension, token.point) = values[c][token.id];
+      }
+    }
+  }
+  else
+  {
+    for (size_t c = 0; c < chunks.size(); ++c)
+    {
+      for (const Token& token : tokens[c])
+      {
+        if (categorical[token.dimension])
+          continue;
+
+        inout(token.dimension, token.point) = infoSet.template MapString<T>(
+            std::string(token.begin, token.length), token.dimension);
+      }
+    }
+  }
+}
+
+template<typename T, typename MapPolicy>
+void LoadCSV::GetSize(size_t& rows,
+                      size_t& cols,
+                      DatasetMapper<MapPolicy>& info,
+                      const bool transpose)
+{
+  CheckOpen();
+
+  std::vector<Chunk> chunks;
+  const size_t numLines = SplitChunks(*file, chunks);
+
+  size_t numFields = 0;
+  std::vector<Token> tokens;
+  for (size_t c = 0; c < chunks.size(); ++c)
+  {
+    ForEachLine(chunks[c], [&](const size_t line, const char* lineBegin,
+        const char* lineEnd)
+    {
+      const size_t count = TokenizeLine(lineBegin, lineEnd,
+          [&](const size_t field, const char* begin, const char* end)
+      {
+        tokens.push_back(Token{ begin, size_t(end - begin),
+            transpose ? field : line, transpose ? line : field, 0 });
+      });
+
+      if (line == 0)
+        numFields = count;
+    });
+  }
+
+  rows = transpose ? numFields : numLines;
+  cols = transpose ? numLines : numFields;
+
+  // Reset the DatasetInfo object, if needed.
+  if (info.Dimensionality() == 0)
+  {
+    info.SetDimensionality(rows);
+  }
+  else if (info.Dimensionality() != rows)
+  {
+    std::ostringstream oss;
+    oss << "data::LoadCSV(): given DatasetInfo has dimensionality "
+        << info.Dimensionality() << ", but data has dimensionality "
+        << rows;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (MapPolicy::NeedsFirstPass)
+  {
+    for (const Token& token : tokens)
+    {
+      if (token.dimension < rows)
+      {
+        info.template MapFirstPass<T>(std::string(token.begin, token.length),
+            token.dimension);
+      }
+    }
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
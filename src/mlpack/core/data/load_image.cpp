@@ -96,6 +96,36 @@ bool LoadImage(const std::string& filename,
   return true;
 }
 
+bool DecodeImage(const std::string& filename,
+                 const size_t channels,
+                 std::vector<unsigned char>& pixels,
+                 size_t& width,
+                 size_t& height,
+                 std::string& error)
+{
+  if (!ImageFormatSupported(filename))
+  {
+    error = "file type " + Extension(filename) + " not supported";
+    return false;
+  }
+
+  int tempWidth, tempHeight, tempChannels;
+  unsigned char* image = stbi_load(filename.c_str(), &tempWidth, &tempHeight,
+      &tempChannels, (channels == 1) ? STBI_grey : STBI_rgb);
+  if (!image)
+  {
+    // stbi_failure_reason() is not thread-safe, so it is not used here.
+    error = "cannot decode image";
+    return false;
+  }
+
+  width = tempWidth;
+  height = tempHeight;
+  pixels.assign(image, image + width * height * ((channels == 1) ? 1 : 3));
+  free(image);
+  return true;
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -123,6 +153,18 @@ bool LoadImage(const std::string& /* filename */,
   return false;
 }
 
+bool DecodeImage(const std::string& /* filename */,
+                 const size_t /* channels */,
+                 std::vector<unsigned char>& /* pixels */,
+                 size_t& /* width */,
+                 size_t& /* height */,
+                 std::string& error)
+{
+  error = "mlpack was not compiled with STB support, so images cannot be "
+      "loaded";
+  return false;
+}
+
 } // namespace data
 } // namespace mlpack
 
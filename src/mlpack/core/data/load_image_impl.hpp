@@ -52,11 +52,128 @@ bool Load(const std::vector<std::string>& files,
           ImageInfo& info,
           const bool fatal)
 {
+  return Load(files, matrix, info, ImageOptions(), fatal);
+}
+
+/**
+ * Resize, normalize and lay out one decoded image (interleaved 8-bit pixels)
+ * into the given column, as specified by the given ImageOptions.
+ */
+template<typename eT>
+void TransformImage(const unsigned char* pixels,
+                    const size_t width,
+                    const size_t height,
+                    const size_t channels,
+                    const size_t outWidth,
+                    const size_t outHeight,
+                    const ImageOptions& options,
+                    eT* column)
+{
+  // Each value is pixel * multiplier[c] + offset[c].
+  double multiplier[3], offset[3];
+  for (size_t c = 0; c < channels; ++c)
+  {
+    const double stddev = options.Stddev().is_empty() ? 1.0 :
+        options.Stddev()[c];
+    const double mean = options.Mean().is_empty() ? 0.0 : options.Mean()[c];
+    multiplier[c] = options.Scale() / stddev;
+    offset[c] = -mean / stddev;
+  }
+
+  auto store = [&](const size_t x, const size_t y, const size_t c,
+      const double pixel)
+  {
+    const size_t index = options.Planar() ?
+        (c * outHeight + y) * outWidth + x : (y * outWidth + x) * channels + c;
+    const double value = pixel * multiplier[c] + offset[c];
+    if (std::is_integral<eT>::value)
+    {
+      column[index] = (eT) std::round(std::min(std::max(value,
+          (double) std::numeric_limits<eT>::lowest()),
+          (double) std::numeric_limits<eT>::max()));
+    }
+    else
+    {
+      column[index] = (eT) value;
+    }
+  };
+
+  if (width == outWidth && height == outHeight)
+  {
+    for (size_t y = 0; y < height; ++y)
+      for (size_t x = 0; x < width; ++x)
+        for (size_t c = 0; c < channels; ++c)
+          store(x, y, c, pixels[(y * width + x) * channels + c]);
+
+    return;
+  }
+
+  // Bilinear interpolation between the centers of the pixels; the horizontal
+  // neighbours and weights are the same for every row.
+  std::vector<size_t> left(outWidth), right(outWidth);
+  std::vector<double> rightWeight(outWidth);
+  for (size_t x = 0; x < outWidth; ++x)
+  {
+    const double sx = std::min(std::max((x + 0.5) * width / outWidth - 0.5,
+        0.0), (double) (width - 1));
+    left[x] = (size_t) sx;
+    right[x] = std::min(left[x] + 1, width - 1);
+    rightWeight[x] = sx - left[x];
+  }
+
+  for (size_t y = 0; y < outHeight; ++y)
+  {
+    const double sy = std::min(std::max((y + 0.5) * height / outHeight - 0.5,
+        0.0), (double) (height - 1));
+    const size_t top = (size_t) sy;
+    const size_t bottom = std::min(top + 1, height - 1);
+    const double bottomWeight = sy - top;
+    const unsigned char* topRow = pixels + top * width * channels;
+    const unsigned char* bottomRow = pixels + bottom * width * channels;
+    for (size_t x = 0; x < outWidth; ++x)
+    {
+      const size_t l = left[x] * channels;
+      const size_t r = right[x] * channels;
+      for (size_t c = 0; c < channels; ++c)
+      {
+        const double upper = topRow[l + c] +
+            (topRow[r + c] - topRow[l + c]) * rightWeight[x];
+        const double lower = bottomRow[l + c] +
+            (bottomRow[r + c] - bottomRow[l + c]) * rightWeight[x];
+        store(x, y, c, upper + (lower - upper) * bottomWeight);
+      }
+    }
+  }
+}
+
+// Image loading API for multiple files, with resizing and normalization.
+template<typename eT>
+bool Load(const std::vector<std::string>& files,
+          arma::Mat<eT>& matrix,
+          ImageInfo& info,
+          const ImageOptions& options,
+          const bool fatal)
+{
+  const size_t channels = (info.Channels() == 1) ? 1 : 3;
+  std::ostringstream oss;
   if (files.size() == 0)
   {
-    std::ostringstream oss;
     oss << "Load(): vector of image files is empty." << std::endl;
+  }
+  else if ((options.Width() == 0) != (options.Height() == 0))
+  {
+    oss << "Load(): ImageOptions must give both a width and a height to "
+        << "resize to, or neither." << std::endl;
+  }
+  else if ((!options.Mean().is_empty() && options.Mean().n_elem != channels) ||
+      (!options.Stddev().is_empty() && options.Stddev().n_elem != channels))
+  {
+    oss << "Load(): ImageOptions must give the mean and standard deviation of "
+        << "each of the " << channels << " channels." << std::endl;
+  }
 
+  if (!oss.str().empty())
+  {
     if (fatal)
       Log::Fatal << oss.str();
     else
@@ -65,28 +182,70 @@ bool Load(const std::vector<std::string>& files,
     return false;
   }
 
-  arma::Mat<unsigned char> img;
-  bool status = LoadImage(files[0], img, info, fatal);
+  Timer::Start("loading_image");
 
-  if (!status)
-    return false;
+  // Without resizing, all images must have the size of the first one.
+  size_t width = options.Width();
+  size_t height = options.Height();
+  std::vector<std::string> errors(files.size());
+  std::vector<unsigned char> first;
+  if (width == 0)
+    DecodeImage(files[0], channels, first, width, height, errors[0]);
 
-  // Decide matrix dimension using the image height and width.
-  arma::Mat<unsigned char> tmpMatrix(
-      info.Width() * info.Height() * info.Channels(), files.size());
-  tmpMatrix.col(0) = img;
+  if (errors[0].empty())
+  {
+    matrix.set_size(width * height * channels, files.size());
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) files.size(); ++i)
+    {
+      std::vector<unsigned char> pixels;
+      size_t imageWidth = width;
+      size_t imageHeight = height;
+      if (i == 0 && options.Width() == 0)
+        pixels.swap(first);
+      else if (!DecodeImage(files[i], channels, pixels, imageWidth,
+          imageHeight, errors[i]))
+        continue;
+
+      if (options.Width() == 0 && (imageWidth != width ||
+          imageHeight != height))
+      {
+        std::ostringstream error;
+        error << "image is " << imageWidth << "x" << imageHeight << ", but "
+            << "the first image is " << width << "x" << height;
+        errors[i] = error.str();
+        continue;
+      }
+
+      TransformImage(pixels.data(), imageWidth, imageHeight, channels, width,
+          height, options, matrix.colptr(i));
+    }
+  }
 
-  for (size_t i = 1; i < files.size() ; ++i)
+  Timer::Stop("loading_image");
+  for (size_t i = 0; i < files.size(); ++i)
   {
-    arma::Mat<unsigned char> colImg(tmpMatrix.colptr(i), tmpMatrix.n_rows, 1,
-        false, true);
-    status = LoadImage(files[i], colImg, info, fatal);
+    if (!errors[i].empty())
+    {
+      if (fatal)
+      {
+        Log::Fatal << "Load(): failed to load image '" << files[i] << "': "
+            << errors[i] << "." << std::endl;
+      }
+      else
+      {
+        Log::Warn << "Load(): failed to load image '" << files[i] << "': "
+            << errors[i] << "." << std::endl;
+      }
 
-    if (!status)
       return false;
+    }
   }
 
-  matrix = arma::conv_to<arma::Mat<eT>>::from(tmpMatrix);
+  info.Width() = width;
+  info.Height() = height;
+  info.Channels() = channels;
   return true;
 }
 
@@ -19,9 +19,11 @@
 #include <mlpack/core/util/timers.hpp>
 
 #include "load_csv.hpp"
+#include "sparse_loader.hpp"
 #include "load.hpp"
 #include "extension.hpp"
 #include "detect_file_type.hpp"
+#include "first_touch.hpp"
 
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/tokenizer.hpp>
@@ -92,6 +94,22 @@ bool Load(const std::string& filename,
           const bool transpose,
           const arma::file_type inputLoadType)
 {
+  // mlpack binary matrix files are copied out of the mapped file, and are not
+  // transposed.
+  if (inputLoadType == arma::auto_detect && Extension(filename) == "mlmat")
+  {
+    MappedMatrix<eT> mapped;
+    const bool success = Load(filename, mapped, fatal);
+    if (success)
+    {
+      matrix = mapped.Matrix();
+      if (ParallelPolicy::Current().NumaAware())
+        FirstTouch(matrix);
+    }
+
+    return success;
+  }
+
   Timer::Start("loading_data");
 
   // Catch nonexistent files by opening the stream ourselves.
@@ -190,6 +208,10 @@ bool Load(const std::string& filename,
     success = inplace_transpose(matrix, fatal);
   }
 
+  // Spread the matrix over the NUMA nodes, if requested.
+  if (success && ParallelPolicy::Current().NumaAware())
+    FirstTouch(matrix);
+
   Timer::Stop("loading_data");
 
   // Finally, return the success indicator.
@@ -287,6 +309,10 @@ bool Load(const std::string& filename,
   Log::Info << "Size is " << (transpose ? matrix.n_cols : matrix.n_rows)
       << " x " << (transpose ? matrix.n_rows : matrix.n_cols) << ".\n";
 
+  // Spread the matrix over the NUMA nodes, if requested.
+  if (ParallelPolicy::Current().NumaAware())
+    FirstTouch(matrix);
+
   Timer::Stop("loading_data");
 
   return true;
@@ -323,16 +349,49 @@ bool Load(const std::string& filename,
     return false;
   }
 
+  // Coordinate files and mlpack binary sparse files are mapped and read by
+  // SparseLoader and SparseMatrixFileHeader; coordinate files are parsed in
+  // parallel, and binary files are never transposed.
+  if (extension == "tsv" || extension == "txt" || extension == "mlsp")
+  {
+    stream.close();
+    const bool binary = (extension == "mlsp");
+    Log::Info << "Loading '" << filename << "' as " << (binary ?
+        "mlpack binary sparse matrix" :
+        "Coordinate Formatted Data for Sparse Matrix") << ".  " << std::flush;
+
+    try
+    {
+      MappedFile file(filename);
+      if (binary)
+        SparseMatrixFileHeader::Load(file, matrix);
+      else
+        SparseLoader::Coordinates(file, matrix, transpose);
+    }
+    catch (std::exception& e)
+    {
+      Log::Info << std::endl;
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    Log::Info << "Size is " << matrix.n_rows << " x " << matrix.n_cols
+        << ".\n";
+    Timer::Stop("loading_data");
+
+    return true;
+  }
+
   bool unknownType = false;
   arma::file_type loadType;
   std::string stringType;
 
-  if (extension == "tsv" || extension == "txt")
-  {
-    loadType = arma::coord_ascii;
-    stringType = "Coordinate Formatted Data for Sparse Matrix";
-  }
-  else if (extension == "bin")
+  if (extension == "bin")
   {
     // This could be raw binary or Armadillo binary (binary with header).  We
     // will check to see if it is Armadillo binary.
@@ -416,6 +475,39 @@ bool Load(const std::string& filename,
   return success;
 }
 
+template<typename eT>
+bool LoadLibSVM(const std::string& filename,
+                arma::SpMat<eT>& matrix,
+                arma::rowvec& labels,
+                const bool fatal)
+{
+  Timer::Start("loading_data");
+  Log::Info << "Loading '" << filename << "' as libsvm formatted data.  "
+      << std::flush;
+
+  try
+  {
+    MappedFile file(filename);
+    SparseLoader::LibSVM(file, matrix, labels);
+  }
+  catch (std::exception& e)
+  {
+    Log::Info << std::endl;
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << e.what() << std::endl;
+    else
+      Log::Warn << e.what() << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Size is " << matrix.n_rows << " x " << matrix.n_cols << ".\n";
+  Timer::Stop("loading_data");
+
+  return true;
+}
+
 } // namespace data
 } // namespace mlpack
 
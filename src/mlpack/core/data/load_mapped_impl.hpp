@@ -0,0 +1,57 @@
+/**
+ * @file core/data/load_mapped_impl.hpp
+ *
+ * Implementation of the Load() overload for mlpack binary matrix files mapped
+ * into a MappedMatrix.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_MAPPED_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_MAPPED_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "load.hpp"
+
+#include <mlpack/core/util/timers.hpp>
+
+namespace mlpack {
+namespace data {
+
+template<typename eT>
+bool Load(const std::string& filename,
+          MappedMatrix<eT>& matrix,
+          const bool fatal)
+{
+  Timer::Start("loading_data");
+  Log::Info << "Mapping '" << filename << "' as mlpack binary matrix.  "
+      << std::flush;
+
+  try
+  {
+    matrix = MappedMatrix<eT>(filename);
+  }
+  catch (std::exception& e)
+  {
+    Log::Info << std::endl;
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << e.what() << std::endl;
+    else
+      Log::Warn << e.what() << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Size is " << matrix.Rows() << " x " << matrix.Cols() << ".\n";
+  Timer::Stop("loading_data");
+
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
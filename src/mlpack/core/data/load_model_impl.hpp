@@ -42,6 +42,8 @@ bool Load(const std::string& filename,
       f = format::binary;
     else if (extension == "json")
       f = format::json;
+    else if (extension == "mlmodel")
+      f = format::mapped;
     else
     {
       if (fatal)
@@ -55,6 +57,26 @@ bool Load(const std::string& filename,
     }
   }
 
+  // The mapped format is read from a mapping of the whole file.
+  if (f == format::mapped)
+  {
+    try
+    {
+      MappedFile file(filename);
+      LoadMappedModel(file, name, t, false);
+      return true;
+    }
+    catch (std::exception& e)
+    {
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+  }
+
   // Now load the given format.
   std::ifstream ifs;
 #ifdef _WIN32 // Open non-text in binary mode on Windows.
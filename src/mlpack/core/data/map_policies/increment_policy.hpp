@@ -36,6 +36,9 @@ class IncrementPolicy
   IncrementPolicy(const bool forceAllMappings = false) :
       forceAllMappings(forceAllMappings) { }
 
+  //! Get whether all strings are mapped, including numbers.
+  bool ForceAllMappings() const { return forceAllMappings; }
+
   // typedef of MappedType
   using MappedType = size_t;
 
@@ -52,6 +52,9 @@ class MissingPolicy
     // Nothing to initialize here.
   }
 
+  //! Get the set of strings that are mapped to NaN.
+  const std::set<std::string>& MissingSet() const { return missingSet; }
+
   //! This doesn't need a first pass over the data to set up.
   static const bool NeedsFirstPass = false;
 
@@ -0,0 +1,101 @@
+/**
+ * @file core/data/mapped_file.cpp
+ *
+ * Implementation of MappedFile, a read-only memory mapping of a file.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "mapped_file.hpp"
+
+#include <fstream>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+MappedFile::MappedFile(const std::string& filename, const bool copyOnWrite) :
+    filename(filename),
+    data(NULL),
+    size(0)
+{
+#ifndef _WIN32
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1)
+  {
+    throw std::runtime_error("MappedFile: cannot open file '" + filename +
+        "'");
+  }
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) == -1)
+  {
+    close(fd);
+    throw std::runtime_error("MappedFile: cannot determine size of file '" +
+        filename + "'");
+  }
+
+  size = (size_t) fileStat.st_size;
+  if (size > 0)
+  {
+    // Private mappings still share the pages that are never written.
+    void* mapping = copyOnWrite ?
+        mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0) :
+        mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+      close(fd);
+      throw std::runtime_error("MappedFile: cannot map file '" + filename +
+          "'");
+    }
+
+    data = (char*) mapping;
+  }
+
+  // The mapping stays valid after the file descriptor is closed.
+  close(fd);
+#else
+  // The memory is always a private copy of the file here.
+  (void) copyOnWrite;
+  std::ifstream stream(filename, std::ios::binary | std::ios::ate);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("MappedFile: cannot open file '" + filename +
+        "'");
+  }
+
+  size = (size_t) stream.tellg();
+  stream.seekg(0, std::ios::beg);
+  if (size > 0)
+  {
+    data = new char[size];
+    if (!stream.read(data, size))
+    {
+      delete[] data;
+      throw std::runtime_error("MappedFile: cannot read file '" + filename +
+          "'");
+    }
+  }
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+  if (data)
+    munmap(data, size);
+#else
+  delete[] data;
+#endif
+}
+
+} // namespace data
+} // namespace mlpack
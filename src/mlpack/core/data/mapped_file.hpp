@@ -0,0 +1,71 @@
+/**
+ * @file core/data/mapped_file.hpp
+ *
+ * Definition of MappedFile, a read-only memory mapping of a file.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_FILE_HPP
+#define MLPACK_CORE_DATA_MAPPED_FILE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A read-only memory mapping of an entire file.  On POSIX systems, the file is
+ * mapped with mmap(), so that several processes mapping the same file share
+ * its pages in the page cache, and pages are only read from disk when they are
+ * touched.  On other systems, the file is read into memory instead.
+ *
+ * A file can also be mapped copy-on-write: its memory can then be written,
+ * but the writes are private to the mapping and never reach the file.
+ *
+ * The mapping is released when the object is destroyed, so any matrix that
+ * aliases the mapped memory must not be used after that.  MappedFile objects
+ * cannot be copied; use a std::shared_ptr to share one.
+ */
+class MappedFile
+{
+ public:
+  /**
+   * Map the given file.  A std::runtime_error is thrown if the file cannot be
+   * opened or mapped.
+   *
+   * @param filename Name of the file to map.
+   * @param copyOnWrite Whether the mapped memory may be written (privately).
+   */
+  MappedFile(const std::string& filename, const bool copyOnWrite = false);
+
+  //! Release the mapping.
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  //! Get a pointer to the start of the mapped file.
+  const char* Data() const { return data; }
+
+  //! Get the size of the mapped file in bytes.
+  size_t Size() const { return size; }
+
+  //! Get the name of the mapped file.
+  const std::string& Filename() const { return filename; }
+
+ private:
+  //! The name of the mapped file.
+  std::string filename;
+  //! The start of the mapped memory.
+  char* data;
+  //! The size of the mapped memory in bytes.
+  size_t size;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
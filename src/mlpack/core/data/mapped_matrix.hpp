@@ -0,0 +1,255 @@
+/**
+ * @file core/data/mapped_matrix.hpp
+ *
+ * The mlpack binary matrix format: a matrix file that can be memory-mapped and
+ * used without being read or copied, and a writer that produces it a block of
+ * columns at a time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <fstream>
+
+#include "mapped_file.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The header of an mlpack binary matrix file (extension .mlmat).  The file is
+ * laid out as follows:
+ *
+ *  - the 64-byte header below, in the byte order of the machine that wrote it;
+ *  - padding up to the data offset, which is a multiple of the alignment
+ *    (4096 bytes, so that the data is page-aligned when the file is mapped);
+ *  - the elements of the matrix, in column-major order, so that each column
+ *    (each point, for mlpack datasets) is contiguous.
+ *
+ * The matrix is stored exactly as it is held in memory; it is not transposed
+ * on saving or loading.  The element type is recorded as a kind (unsigned
+ * integer, signed integer, or floating point) and a size in bytes, and a file
+ * can only be loaded into a matrix of the same element type.
+ */
+struct MatrixFileHeader
+{
+  //! The kinds of element types.
+  enum ElemKind : uint32_t
+  {
+    unsignedInteger = 0,
+    signedInteger = 1,
+    floatingPoint = 2
+  };
+
+  //! Identifier at the start of each file ("MLPKMAT1").
+  static constexpr uint64_t magicValue = 0x3154414D4B504C4DULL;
+  //! The current version of the format.
+  static constexpr uint32_t currentVersion = 1;
+  //! The alignment of the data.
+  static constexpr uint64_t defaultAlignment = 4096;
+
+  uint64_t magic;
+  uint32_t version;
+  //! An ElemKind.
+  uint32_t elemKind;
+  uint64_t elemSize;
+  uint64_t rows;
+  uint64_t cols;
+  uint64_t alignment;
+  uint64_t dataOffset;
+  uint64_t reserved;
+
+  //! Create a header for a matrix of the given element type and size.
+  template<typename eT>
+  static MatrixFileHeader Create(const size_t rows, const size_t cols);
+
+  /**
+   * Read the header at the start of the given file and check it against the
+   * element type and the size of the file.  A std::runtime_error is thrown if
+   * the file is not a matrix file or if it is truncated, and a
+   * std::invalid_argument if it holds a different element type.
+   */
+  template<typename eT>
+  static MatrixFileHeader Read(const MappedFile& file);
+
+  //! Get the name of the element type recorded in the header.
+  std::string ElemTypeName() const;
+};
+
+/**
+ * The header of an mlpack binary sparse matrix file (extension .mlsp), which
+ * holds an arma::SpMat in compressed sparse column (CSC) form.  The file is
+ * laid out as follows, with each block starting at a multiple of 64 bytes:
+ *
+ *  - the 64-byte header below, in the byte order of the machine that wrote it;
+ *  - the column pointers, as cols + 1 unsigned 64-bit integers;
+ *  - the row indices of the nonzero elements, as unsigned 64-bit integers;
+ *  - the values of the nonzero elements.
+ *
+ * As for dense matrix files, the matrix is not transposed, and the element
+ * type is recorded and must match on loading.  Since Armadillo sparse
+ * matrices own their memory, loading copies the three arrays out of the
+ * mapped file, but does not parse or sort anything.
+ */
+struct SparseMatrixFileHeader
+{
+  //! Identifier at the start of each file ("MLPKSPM1").
+  static constexpr uint64_t magicValue = 0x314D50534B504C4DULL;
+  //! The current version of the format.
+  static constexpr uint32_t currentVersion = 1;
+
+  uint64_t magic;
+  uint32_t version;
+  //! A MatrixFileHeader::ElemKind.
+  uint32_t elemKind;
+  uint64_t elemSize;
+  uint64_t rows;
+  uint64_t cols;
+  uint64_t nonZeros;
+  uint64_t reserved[2];
+
+  /**
+   * Save the given sparse matrix to the given file.  A std::runtime_error is
+   * thrown on errors.
+   *
+   * @param filename Name of the file to write.
+   * @param matrix Matrix to save.
+   */
+  template<typename eT>
+  static void Save(const std::string& filename, const arma::SpMat<eT>& matrix);
+
+  /**
+   * Load a sparse matrix from the given mapped file.  A std::runtime_error is
+   * thrown if the file is not a valid sparse matrix file, and a
+   * std::invalid_argument if it holds a different element type.
+   *
+   * @param file Mapped file to load from.
+   * @param matrix Matrix to load into.
+   */
+  template<typename eT>
+  static void Load(const MappedFile& file, arma::SpMat<eT>& matrix);
+
+  //! Round the offset up to a multiple of 64 bytes.
+  static size_t Align(const size_t offset) { return (offset + 63) & ~63; }
+};
+
+/**
+ * A read-only matrix backed by a memory-mapped mlpack binary matrix file.  The
+ * matrix aliases the mapped memory (it is built with copy_aux_mem = false and
+ * strict = true), so opening it costs nothing regardless of the size of the
+ * file; pages are read from disk when they are first touched, and processes
+ * that map the same file share them through the page cache.
+ *
+ * MappedMatrix objects can be copied cheaply: copies share the mapping, which
+ * is released when the last of them is destroyed.  References to Matrix() must
+ * not outlive every copy.  The memory is mapped read-only, so the matrix must
+ * not be modified; only const access is given.
+ *
+ * @tparam eT Element type of the matrix.
+ */
+template<typename eT>
+class MappedMatrix
+{
+ public:
+  //! Create an empty matrix that is not backed by a file.
+  MappedMatrix();
+
+  /**
+   * Map the given matrix file.  A std::runtime_error is thrown if the file
+   * cannot be mapped or is not a valid matrix file, and a
+   * std::invalid_argument if it holds a different element type.
+   *
+   * @param filename Name of the matrix file.
+   */
+  MappedMatrix(const std::string& filename);
+
+  //! Get the matrix.
+  const arma::Mat<eT>& Matrix() const { return *matrix; }
+
+  //! Get the number of rows of the matrix.
+  size_t Rows() const { return matrix->n_rows; }
+  //! Get the number of columns of the matrix.
+  size_t Cols() const { return matrix->n_cols; }
+
+ private:
+  //! The mapped file (declared first so that it is released last).
+  std::shared_ptr<MappedFile> file;
+  //! The matrix aliasing the mapped memory.
+  std::shared_ptr<const arma::Mat<eT>> matrix;
+};
+
+/**
+ * Write an mlpack binary matrix file a block of columns at a time, so that a
+ * matrix larger than memory can be converted or generated without being held
+ * in memory at once.  The number of rows is fixed on construction; the number
+ * of columns is written into the header by Close(), which the destructor calls
+ * if needed.  Errors writing the file are reported with std::runtime_error,
+ * and blocks with the wrong number of rows with std::invalid_argument.
+ *
+ * @code
+ * data::MatrixFileWriter<double> writer("data.mlmat", 10);
+ * for (size_t i = 0; i < numBlocks; ++i)
+ *   writer.Write(GenerateBlock(i)); // Each block is 10 x something.
+ * writer.Close();
+ *
+ * data::MappedMatrix<double> dataset("data.mlmat");
+ * @endcode
+ *
+ * @tparam eT Element type of the matrix.
+ */
+template<typename eT>
+class MatrixFileWriter
+{
+ public:
+  /**
+   * Create the given file, with no columns yet.
+   *
+   * @param filename Name of the file to write.
+   * @param rows Number of rows of the matrix.
+   */
+  MatrixFileWriter(const std::string& filename, const size_t rows);
+
+  //! Close the file, if it is still open.  Errors are ignored; call Close()
+  //! to see them.
+  ~MatrixFileWriter();
+
+  MatrixFileWriter(const MatrixFileWriter&) = delete;
+  MatrixFileWriter& operator=(const MatrixFileWriter&) = delete;
+
+  /**
+   * Append the columns of the given block to the matrix.
+   *
+   * @param block Columns to append; must have the number of rows given on
+   *     construction.
+   */
+  void Write(const arma::Mat<eT>& block);
+
+  //! Write the final number of columns into the header and close the file.
+  void Close();
+
+  //! Get the number of columns written so far.
+  size_t Cols() const { return cols; }
+
+ private:
+  //! The name of the file.
+  std::string filename;
+  //! The stream to the file.
+  std::ofstream stream;
+  //! The number of rows of the matrix.
+  size_t rows;
+  //! The number of columns written so far.
+  size_t cols;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "mapped_matrix_impl.hpp"
+
+#endif
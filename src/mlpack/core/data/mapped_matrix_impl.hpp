@@ -0,0 +1,320 @@
+/**
+ * @file core/data/mapped_matrix_impl.hpp
+ *
+ * Implementation of the mlpack binary matrix format.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mapped_matrix.hpp"
+
+namespace mlpack {
+namespace data {
+
+template<typename eT>
+MatrixFileHeader MatrixFileHeader::Create(const size_t rows, const size_t cols)
+{
+  static_assert(std::is_arithmetic<eT>::value, "MatrixFileHeader: the element "
+      "type must be an arithmetic type");
+
+  MatrixFileHeader header;
+  header.magic = magicValue;
+  header.version = currentVersion;
+  header.elemKind = std::is_floating_point<eT>::value ? floatingPoint :
+      (std::is_signed<eT>::value ? signedInteger : unsignedInteger);
+  header.elemSize = sizeof(eT);
+  header.rows = rows;
+  header.cols = cols;
+  header.alignment = defaultAlignment;
+  header.dataOffset = defaultAlignment;
+  header.reserved = 0;
+  return header;
+}
+
+template<typename eT>
+MatrixFileHeader MatrixFileHeader::Read(const MappedFile& file)
+{
+  MatrixFileHeader header;
+  if (file.Size() < sizeof(MatrixFileHeader))
+  {
+    throw std::runtime_error("MatrixFileHeader::Read(): file '" +
+        file.Filename() + "' is not an mlpack matrix file");
+  }
+
+  std::memcpy(&header, file.Data(), sizeof(MatrixFileHeader));
+  if (header.magic != magicValue)
+  {
+    throw std::runtime_error("MatrixFileHeader::Read(): file '" +
+        file.Filename() + "' is not an mlpack matrix file");
+  }
+  if (header.version > currentVersion)
+  {
+    throw std::runtime_error("MatrixFileHeader::Read(): file '" +
+        file.Filename() + "' has an unsupported format version");
+  }
+
+  const MatrixFileHeader expected = Create<eT>(0, 0);
+  if (header.elemKind != expected.elemKind ||
+      header.elemSize != expected.elemSize)
+  {
+    throw std::invalid_argument("MatrixFileHeader::Read(): file '" +
+        file.Filename() + "' holds elements of type " + header.ElemTypeName() +
+        ", not " + expected.ElemTypeName());
+  }
+
+  if (header.dataOffset % sizeof(eT) != 0 || header.dataOffset > file.Size() ||
+      (header.rows != 0 && header.cols > ((file.Size() - header.dataOffset) /
+      sizeof(eT)) / header.rows))
+  {
+    throw std::runtime_error("MatrixFileHeader::Read(): file '" +
+        file.Filename() + "' is truncated");
+  }
+
+  return header;
+}
+
+inline std::string MatrixFileHeader::ElemTypeName() const
+{
+  std::ostringstream oss;
+  oss << ((elemKind == floatingPoint) ? "float" :
+      (elemKind == signedInteger) ? "int" : "uint") << (8 * elemSize);
+  return oss.str();
+}
+
+template<typename eT>
+void SparseMatrixFileHeader::Save(const std::string& filename,
+                                  const arma::SpMat<eT>& matrix)
+{
+  std::ofstream stream(filename, std::ios::binary | std::ios::out |
+      std::ios::trunc);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("SparseMatrixFileHeader::Save(): cannot open file "
+        "'" + filename + "' for writing");
+  }
+
+  matrix.sync();
+  const MatrixFileHeader dense = MatrixFileHeader::Create<eT>(0, 0);
+  SparseMatrixFileHeader header;
+  header.magic = magicValue;
+  header.version = currentVersion;
+  header.elemKind = dense.elemKind;
+  header.elemSize = dense.elemSize;
+  header.rows = matrix.n_rows;
+  header.cols = matrix.n_cols;
+  header.nonZeros = matrix.n_nonzero;
+  header.reserved[0] = 0;
+  header.reserved[1] = 0;
+
+  const char padding[64] = { 0 };
+  size_t offset = 0;
+  auto writeBlock = [&](const char* data, const size_t bytes)
+  {
+    stream.write(padding, Align(offset) - offset);
+    offset = Align(offset);
+    stream.write(data, bytes);
+    offset += bytes;
+  };
+
+  writeBlock((const char*) &header, sizeof(SparseMatrixFileHeader));
+  const std::vector<uint64_t> colPtrs(matrix.col_ptrs,
+      matrix.col_ptrs + matrix.n_cols + 1);
+  writeBlock((const char*) colPtrs.data(), sizeof(uint64_t) * colPtrs.size());
+  const std::vector<uint64_t> rowIndices(matrix.row_indices,
+      matrix.row_indices + matrix.n_nonzero);
+  writeBlock((const char*) rowIndices.data(),
+      sizeof(uint64_t) * rowIndices.size());
+  writeBlock((const char*) matrix.values, sizeof(eT) * matrix.n_nonzero);
+
+  if (!stream.good())
+  {
+    throw std::runtime_error("SparseMatrixFileHeader::Save(): error writing to "
+        "file '" + filename + "'");
+  }
+}
+
+template<typename eT>
+void SparseMatrixFileHeader::Load(const MappedFile& file,
+                                  arma::SpMat<eT>& matrix)
+{
+  SparseMatrixFileHeader header;
+  if (file.Size() < sizeof(SparseMatrixFileHeader))
+  {
+    throw std::runtime_error("SparseMatrixFileHeader::Load(): file '" +
+        file.Filename() + "' is not an mlpack sparse matrix file");
+  }
+
+  std::memcpy(&header, file.Data(), sizeof(SparseMatrixFileHeader));
+  if (header.magic != magicValue || header.version > currentVersion)
+  {
+    throw std::runtime_error("SparseMatrixFileHeader::Load(): file '" +
+        file.Filename() + "' is not an mlpack sparse matrix file");
+  }
+
+  MatrixFileHeader dense = MatrixFileHeader::Create<eT>(0, 0);
+  if (header.elemKind != dense.elemKind || header.elemSize != dense.elemSize)
+  {
+    MatrixFileHeader stored = dense;
+    stored.elemKind = header.elemKind;
+    stored.elemSize = header.elemSize;
+    throw std::invalid_argument("SparseMatrixFileHeader::Load(): file '" +
+        file.Filename() + "' holds elements of type " + stored.ElemTypeName() +
+        ", not " + dense.ElemTypeName());
+  }
+
+  const size_t colPtrsOffset = Align(sizeof(SparseMatrixFileHeader));
+  const size_t rowIndicesOffset = Align(colPtrsOffset +
+      sizeof(uint64_t) * (header.cols + 1));
+  const size_t valuesOffset = Align(rowIndicesOffset +
+      sizeof(uint64_t) * header.nonZeros);
+  if (valuesOffset + sizeof(eT) * header.nonZeros > file.Size())
+  {
+    throw std::runtime_error("SparseMatrixFileHeader::Load(): file '" +
+        file.Filename() + "' is truncated");
+  }
+
+  const uint64_t* colPtrs = (const uint64_t*) (file.Data() + colPtrsOffset);
+  const uint64_t* rowIndices = (const uint64_t*) (file.Data() +
+      rowIndicesOffset);
+  if (colPtrs[header.cols] != header.nonZeros)
+  {
+    throw std::runtime_error("SparseMatrixFileHeader::Load(): file '" +
+        file.Filename() + "' is corrupt");
+  }
+
+  arma::uvec colPtrsVec(header.cols + 1);
+  std::copy(colPtrs, colPtrs + header.cols + 1, colPtrsVec.begin());
+  arma::uvec rowIndicesVec(header.nonZeros);
+  std::copy(rowIndices, rowIndices + header.nonZeros, rowIndicesVec.begin());
+  arma::Col<eT> values(header.nonZeros);
+  if (header.nonZeros > 0)
+  {
+    std::memcpy(values.memptr(), file.Data() + valuesOffset,
+        sizeof(eT) * header.nonZeros);
+  }
+
+  matrix = arma::SpMat<eT>(rowIndicesVec, colPtrsVec, values, header.rows,
+      header.cols);
+}
+
+template<typename eT>
+MappedMatrix<eT>::MappedMatrix() :
+    matrix(new arma::Mat<eT>())
+{
+  // Nothing to do.
+}
+
+template<typename eT>
+MappedMatrix<eT>::MappedMatrix(const std::string& filename) :
+    file(new MappedFile(filename))
+{
+  const MatrixFileHeader header = MatrixFileHeader::Read<eT>(*file);
+  if (header.rows * header.cols == 0)
+  {
+    matrix.reset(new arma::Mat<eT>(header.rows, header.cols));
+  }
+  else
+  {
+    // The memory is never written through the matrix: it is only handed out
+    // as const, and strict = true keeps its size fixed.
+    eT* data = (eT*) (file->Data() + header.dataOffset);
+    matrix.reset(new arma::Mat<eT>(data, header.rows, header.cols, false,
+        true));
+  }
+}
+
+template<typename eT>
+MatrixFileWriter<eT>::MatrixFileWriter(const std::string& filename,
+                                       const size_t rows) :
+    filename(filename),
+    stream(filename, std::ios::binary | std::ios::out | std::ios::trunc),
+    rows(rows),
+    cols(0)
+{
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("MatrixFileWriter: cannot open file '" +
+        filename + "' for writing");
+  }
+
+  // The header is rewritten with the number of columns by Close().
+  const MatrixFileHeader header = MatrixFileHeader::Create<eT>(rows, 0);
+  std::vector<char> start(header.dataOffset, 0);
+  std::memcpy(start.data(), &header, sizeof(MatrixFileHeader));
+  stream.write(start.data(), start.size());
+  if (!stream.good())
+  {
+    throw std::runtime_error("MatrixFileWriter: error writing to file '" +
+        filename + "'");
+  }
+}
+
+template<typename eT>
+MatrixFileWriter<eT>::~MatrixFileWriter()
+{
+  try
+  {
+    if (stream.is_open())
+      Close();
+  }
+  catch (const std::exception& /* e */)
+  {
+    // Destructors must not throw.
+  }
+}
+
+template<typename eT>
+void MatrixFileWriter<eT>::Write(const arma::Mat<eT>& block)
+{
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("MatrixFileWriter::Write(): file '" + filename +
+        "' has been closed");
+  }
+
+  if (block.n_rows != rows)
+  {
+    std::ostringstream oss;
+    oss << "MatrixFileWriter::Write(): block has " << block.n_rows << " rows, "
+        << "but the matrix has " << rows << " rows";
+    throw std::invalid_argument(oss.str());
+  }
+
+  stream.write((const char*) block.memptr(), sizeof(eT) * block.n_elem);
+  if (!stream.good())
+  {
+    throw std::runtime_error("MatrixFileWriter::Write(): error writing to file "
+        "'" + filename + "'");
+  }
+
+  cols += block.n_cols;
+}
+
+template<typename eT>
+void MatrixFileWriter<eT>::Close()
+{
+  if (!stream.is_open())
+    return;
+
+  const MatrixFileHeader header = MatrixFileHeader::Create<eT>(rows, cols);
+  stream.seekp(0, std::ios::beg);
+  stream.write((const char*) &header, sizeof(MatrixFileHeader));
+  const bool good = stream.good();
+  stream.close();
+  if (!good || stream.fail())
+  {
+    throw std::runtime_error("MatrixFileWriter::Close(): error writing to file "
+        "'" + filename + "'");
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,145 @@
+/**
+ * @file core/data/mapped_model.hpp
+ *
+ * Definition of the mapped model format, which stores the matrices of a model
+ * so that they can be used directly from a memory-mapped file, and of
+ * MappedModel, which loads a model that way.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MODEL_HPP
+#define MLPACK_CORE_DATA_MAPPED_MODEL_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/cereal/mapped_binary_archive.hpp>
+
+#include "mapped_file.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Save the given model to the given file in the mapped model format (see
+ * cereal::MappedArchiveHeader for the layout).  This is what data::Save()
+ * does for format::mapped; errors are reported by throwing a
+ * std::runtime_error.
+ *
+ * @param filename Name of the file to save to.
+ * @param name Name of the model in the archive.
+ * @param model Model to save.
+ */
+template<typename T>
+void SaveMappedModel(const std::string& filename,
+                     const std::string& name,
+                     T& model);
+
+/**
+ * Write the given model to the given stream in the mapped model format.  The
+ * file starts at the current position of the stream, which must support
+ * seeking (like a std::ofstream or a std::ostringstream); errors are reported
+ * by throwing a std::runtime_error.
+ *
+ * @param out Stream to write to.
+ * @param name Name of the model in the archive.
+ * @param model Model to save.
+ */
+template<typename T>
+void SaveMappedModel(std::ostream& out,
+                     const std::string& name,
+                     T& model);
+
+/**
+ * Load the given model from a mapped model file.  This is what data::Load()
+ * does for format::mapped (with alias = false); errors are reported by
+ * throwing a std::runtime_error.
+ *
+ * @param file Mapped file to load from.
+ * @param name Name of the model in the archive.
+ * @param model Model to load into.
+ * @param alias If true, the matrices of the model use the memory of the file
+ *     instead of a copy of it, so the file has to stay mapped for as long as
+ *     the model is used.
+ */
+template<typename T>
+void LoadMappedModel(const MappedFile& file,
+                     const std::string& name,
+                     T& model,
+                     const bool alias);
+
+/**
+ * Load the given model from a mapped model file that is held in memory.
+ * Errors are reported by throwing a std::runtime_error.
+ *
+ * @param data Start of the file in memory; it must be aligned to
+ *     cereal::MappedArchiveHeader::alignment bytes if alias is true.
+ * @param size Size of the file in bytes.
+ * @param name Name of the model in the archive.
+ * @param model Model to load into.
+ * @param alias If true, the matrices of the model use the given memory
+ *     instead of a copy of it, so the memory has to stay valid for as long as
+ *     the model is used.
+ */
+template<typename T>
+void LoadMappedModel(const char* data,
+                     const size_t size,
+                     const std::string& name,
+                     T& model,
+                     const bool alias);
+
+/**
+ * A model loaded from a mapped model file (extension .mlmodel), whose
+ * matrices are not copied but point directly into the mapped file.  Loading
+ * therefore only reads the small parts of the model, and the pages of the
+ * matrices are read from disk when they are first used; several processes
+ * that load the same file share those pages.  The file is mapped copy-on-write,
+ * so the model may modify the elements of its matrices without changing the
+ * file.  However, the matrices cannot be resized, so the model can be used
+ * for prediction, but not retrained.
+ *
+ * @code
+ * data::Save("model.mlmodel", "model", model, true);
+ * ...
+ * data::MappedModel<LinearRegression> mapped("model.mlmodel", "model");
+ * mapped.Model().Predict(points, predictions);
+ * @endcode
+ *
+ * @tparam T Type of the model.
+ */
+template<typename T>
+class MappedModel
+{
+ public:
+  /**
+   * Map the given file and load the model from it.  A std::runtime_error is
+   * thrown if the file cannot be loaded.
+   *
+   * @param filename Name of the file to load.
+   * @param name Name of the model in the archive.
+   */
+  MappedModel(const std::string& filename, const std::string& name);
+
+  MappedModel(const MappedModel&) = delete;
+  MappedModel& operator=(const MappedModel&) = delete;
+
+  //! Get the model.
+  const T& Model() const { return model; }
+  //! Modify the model (its matrices cannot be resized).
+  T& Model() { return model; }
+
+ private:
+  //! The mapped file; declared first so that it outlives the model.
+  std::shared_ptr<MappedFile> file;
+  //! The model.
+  T model;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "mapped_model_impl.hpp"
+
+#endif
@@ -0,0 +1,143 @@
+/**
+ * @file core/data/mapped_model_impl.hpp
+ *
+ * Implementation of the mapped model format and MappedModel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MODEL_IMPL_HPP
+#define MLPACK_CORE_DATA_MAPPED_MODEL_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mapped_model.hpp"
+
+namespace mlpack {
+namespace data {
+
+template<typename T>
+void SaveMappedModel(const std::string& filename,
+                     const std::string& name,
+                     T& model)
+{
+  std::ofstream ofs(filename, std::ios::binary | std::ios::out |
+      std::ios::trunc);
+  if (!ofs.is_open())
+  {
+    throw std::runtime_error("SaveMappedModel(): cannot open file '" +
+        filename + "' for writing");
+  }
+
+  SaveMappedModel(ofs, name, model);
+  ofs.close();
+  if (ofs.fail())
+  {
+    throw std::runtime_error("SaveMappedModel(): error writing to file '" +
+        filename + "'");
+  }
+}
+
+template<typename T>
+void SaveMappedModel(std::ostream& out,
+                     const std::string& name,
+                     T& model)
+{
+  // The header is rewritten once the position of the archive stream is known.
+  const std::streampos start = out.tellp();
+  cereal::MappedArchiveHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.magic = cereal::MappedArchiveHeader::magicValue;
+  header.version = cereal::MappedArchiveHeader::currentVersion;
+  out.write((const char*) &header, sizeof(header));
+
+  // The blobs go straight to the output; the rest of the archive is small, so
+  // it is collected in memory and appended after the last blob.
+  std::ostringstream stream(std::ios::binary);
+  uint64_t blobEnd;
+  {
+    cereal::MappedBinaryOutputArchive ar(stream, out, sizeof(header));
+    ar(cereal::make_nvp(name.c_str(), model));
+    blobEnd = ar.BlobEnd();
+  }
+
+  const std::string archive = stream.str();
+  const char padding[cereal::MappedArchiveHeader::alignment] = { 0 };
+  header.streamOffset = (blobEnd + cereal::MappedArchiveHeader::alignment - 1) &
+      ~(cereal::MappedArchiveHeader::alignment - 1);
+  header.streamSize = archive.size();
+  out.write(padding, header.streamOffset - blobEnd);
+  out.write(archive.data(), archive.size());
+  const std::streampos end = out.tellp();
+  out.seekp(start);
+  out.write((const char*) &header, sizeof(header));
+  out.seekp(end);
+  if (!out.good())
+    throw std::runtime_error("SaveMappedModel(): error writing to stream");
+}
+
+template<typename T>
+void LoadMappedModel(const MappedFile& file,
+                     const std::string& name,
+                     T& model,
+                     const bool alias)
+{
+  try
+  {
+    LoadMappedModel(file.Data(), file.Size(), name, model, alias);
+  }
+  catch (const std::runtime_error& e)
+  {
+    throw std::runtime_error(std::string(e.what()) + " (file '" +
+        file.Filename() + "')");
+  }
+}
+
+template<typename T>
+void LoadMappedModel(const char* data,
+                     const size_t size,
+                     const std::string& name,
+                     T& model,
+                     const bool alias)
+{
+  cereal::MappedArchiveHeader header;
+  if (size < sizeof(header))
+  {
+    throw std::runtime_error("LoadMappedModel(): data is not an mlpack mapped "
+        "model");
+  }
+
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != cereal::MappedArchiveHeader::magicValue ||
+      header.version > cereal::MappedArchiveHeader::currentVersion)
+  {
+    throw std::runtime_error("LoadMappedModel(): data is not an mlpack mapped "
+        "model");
+  }
+  if (header.streamOffset > size ||
+      header.streamSize > size - header.streamOffset)
+  {
+    throw std::runtime_error("LoadMappedModel(): mapped model is truncated");
+  }
+
+  // Only the small archive stream is copied; the matrices are read from the
+  // given memory directly.
+  std::istringstream stream(std::string(data + header.streamOffset,
+      header.streamSize), std::ios::binary);
+  cereal::MappedBinaryInputArchive ar(stream, data, size, alias);
+  ar(cereal::make_nvp(name.c_str(), model));
+}
+
+template<typename T>
+MappedModel<T>::MappedModel(const std::string& filename,
+                            const std::string& name) :
+    file(new MappedFile(filename, true))
+{
+  LoadMappedModel(*file, name, model, true);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
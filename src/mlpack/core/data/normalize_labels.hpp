@@ -34,6 +34,19 @@ void NormalizeLabels(const RowType& labelsIn,
                      arma::Row<size_t>& labels,
                      arma::Col<eT>& mapping);
 
+/**
+ * Normalize the given labels in place: each label is replaced by its index in
+ * the range [0, n), where n is the number of different labels, and the
+ * original value of each index is stored in the 'mapping' vector.  The labels
+ * are numbered in the order of their first appearance, as in the overload
+ * above.
+ *
+ * @param labels Labels to normalize.
+ * @param mapping Reverse mapping to convert new labels back to old labels.
+ */
+template<typename eT>
+void NormalizeLabels(arma::Row<eT>& labels, arma::Col<eT>& mapping);
+
 /**
  * Given a set of labels that have been mapped to the range [0, n), map them
  * back to the original labels given by the 'mapping' vector.
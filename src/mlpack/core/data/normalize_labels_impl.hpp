@@ -19,6 +19,85 @@
 namespace mlpack {
 namespace data {
 
+namespace details {
+
+/**
+ * Map each of the given labels to the index of its first appearance among the
+ * distinct labels, and store the distinct labels in that order.  Each thread
+ * maps a contiguous block of labels with its own hash table; the distinct
+ * labels of the blocks are then merged in order, which numbers them in the
+ * order of their first appearance, and each label is translated from the
+ * index in its block to the global index.  labels may point to the memory of
+ * labelsIn.
+ *
+ * @param labelsIn Input labels.
+ * @param labels Array to store the index of each label in.
+ * @param mapping Vector to store the distinct labels in.
+ */
+template<typename eT, typename RowType, typename OutputType>
+void NormalizeLabels(const RowType& labelsIn,
+                     OutputType* labels,
+                     arma::Col<eT>& mapping)
+{
+  const size_t n = labelsIn.n_elem;
+
+  // Only split the labels if there are enough of them to be worth it.
+  const size_t numBlocks = ParallelPolicy::Current().NumBlocks(n, 4096);
+  const size_t blockSize = (n + numBlocks - 1) / numBlocks;
+
+  std::vector<std::vector<eT>> blockLabels(numBlocks);
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    std::unordered_map<eT, size_t> labelMap;
+    const size_t begin = (size_t) b * blockSize;
+    const size_t end = std::min(begin + blockSize, n);
+    for (size_t i = begin; i < end; ++i)
+    {
+      // Insert the label if it is new, with a single lookup.
+      const eT label = labelsIn[i];
+      const auto result = labelMap.emplace(label, blockLabels[b].size());
+      if (result.second)
+        blockLabels[b].push_back(label);
+
+      labels[i] = (OutputType) result.first->second;
+    }
+  }
+
+  // Merge the distinct labels of each block, in order.
+  std::unordered_map<eT, size_t> labelMap;
+  std::vector<std::vector<size_t>> translations(numBlocks);
+  std::vector<eT> distinctLabels;
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    translations[b].resize(blockLabels[b].size());
+    for (size_t j = 0; j < blockLabels[b].size(); ++j)
+    {
+      const auto result = labelMap.emplace(blockLabels[b][j],
+          distinctLabels.size());
+      if (result.second)
+        distinctLabels.push_back(blockLabels[b][j]);
+
+      translations[b][j] = result.first->second;
+    }
+  }
+
+  // The first block is numbered like the distinct labels, so it is already
+  // done.
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t b = 1; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = (size_t) b * blockSize;
+    const size_t end = std::min(begin + blockSize, n);
+    for (size_t i = begin; i < end; ++i)
+      labels[i] = (OutputType) translations[b][(size_t) labels[i]];
+  }
+
+  mapping = arma::Col<eT>(distinctLabels);
+}
+
+} // namespace details
+
 /**
  * Given a set of labels of a particular datatype, convert them to unsigned
  * labels in the range [0, n) where n is the number of different labels.  Also,
@@ -34,36 +113,22 @@ void NormalizeLabels(const RowType& labelsIn,
                      arma::Row<size_t>& labels,
                      arma::Col<eT>& mapping)
 {
-  // Loop over the input labels, and develop the mapping.  We'll first naively
-  // resize the mapping to the maximum possible size, and then when we fill it,
-  // we'll resize it back down to its actual size.
-  mapping.set_size(labelsIn.n_elem);
   labels.set_size(labelsIn.n_elem);
-  // Map for mapping labelIn to their label.
-  std::unordered_map<eT, size_t> labelMap;
-  size_t curLabel = 0;
-  for (size_t i = 0; i < labelsIn.n_elem; ++i)
-  {
-    // If labelsIn[i] is already in the map, use the existing label.
-    if (labelMap.count(labelsIn[i]) > 0)
-    {
-      labels[i] = labelMap[labelsIn[i]];
-    }
-    else
-    {
-      // If labelsIn[i] not there then add it to map.
-      labelMap[labelsIn[i]] = curLabel;
-      labels[i] = curLabel;
-      ++curLabel;
-    }
-  }
-  // Resize mapping back down to necessary size.
-  mapping.resize(curLabel);
-  // Mapping array created with encoded labels.
-  for (auto it = labelMap.begin(); it != labelMap.end(); ++it)
-  {
-    mapping[it->second] = it->first;
-  }
+  details::NormalizeLabels(labelsIn, labels.memptr(), mapping);
+}
+
+/**
+ * Normalize the given labels in place: each label is replaced by its index in
+ * the range [0, n), where n is the number of different labels, and the
+ * original value of each index is stored in the 'mapping' vector.
+ *
+ * @param labels Labels to normalize.
+ * @param mapping Reverse mapping to convert new labels back to old labels.
+ */
+template<typename eT>
+void NormalizeLabels(arma::Row<eT>& labels, arma::Col<eT>& mapping)
+{
+  details::NormalizeLabels(labels, labels.memptr(), mapping);
 }
 
 /**
@@ -82,7 +147,8 @@ void RevertLabels(const arma::Row<size_t>& labels,
   // We already have the mapping, so we just need to loop over each element.
   labelsOut.set_size(labels.n_elem);
 
-  for (size_t i = 0; i < labels.n_elem; ++i)
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) labels.n_elem; ++i)
     labelsOut[i] = mapping[labels[i]];
 }
 
@@ -3,7 +3,8 @@
  * @author Jeffin Sam
  *
  * One hot encoding functions. The purpose of this function is to convert
- * categorical variables to binary vectors.
+ * categorical variables to binary vectors.  Categorical variables can also be
+ * hashed into a fixed number of dimensions.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -33,6 +34,18 @@ template<typename RowType, typename MatType>
 void OneHotEncoding(const RowType& labelsIn,
                     MatType& output);
 
+/**
+ * Overload of the function above with a sparse output matrix, which is built
+ * directly from the positions of the ones (without inserting them one at a
+ * time).
+ *
+ * @param labelsIn Input labels of arbitrary datatype.
+ * @param output Sparse binary matrix.
+ */
+template<typename RowType, typename eT>
+void OneHotEncoding(const RowType& labelsIn,
+                    arma::SpMat<eT>& output);
+
 /**
  * Overloaded function for the above function, which takes a matrix as input
  * and also a vector of indices to encode and outputs a matrix.
@@ -62,6 +75,76 @@ void OneHotEncoding(const arma::Mat<eT>& input,
                     arma::Mat<eT>& output,
                     const data::DatasetInfo& datasetInfo);
 
+/**
+ * Overload of the function above that takes a vector of indices to encode and
+ * outputs a sparse matrix.  The encoded dimensions only contribute one nonzero
+ * value per point, however many categories they have, and the dimensions that
+ * are not encoded only contribute their nonzero values; so, for dimensions
+ * with many categories, the encoded matrix takes much less memory than a dense
+ * one, and it can be used directly by the methods that accept sparse data.
+ *
+ * @param input Input dataset to be encoded.
+ * @param indices Index of rows to be encoded.
+ * @param output Sparse encoded matrix.
+ */
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    const arma::Col<size_t>& indices,
+                    arma::SpMat<eT>& output);
+
+/**
+ * Overload of the function above that encodes all the dimensions marked
+ * `Datatype::categorical` in the data::DatasetInfo, and outputs a sparse
+ * matrix.
+ *
+ * @param input Input dataset to be encoded.
+ * @param output Sparse encoded matrix.
+ * @param datasetInfo DatasetInfo object that has information about data.
+ */
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    arma::SpMat<eT>& output,
+                    const data::DatasetInfo& datasetInfo);
+
+/**
+ * Encode the given dimensions with the hashing trick (Weinberger et al.,
+ * "Feature Hashing for Large Scale Multitask Learning", 2009): each
+ * (dimension, value) pair is hashed to one of numBuckets dimensions, which is
+ * set to 1 (values that hash to the same dimension add up).  Unlike one-hot
+ * encoding, the width of the output does not depend on the number of
+ * categories, and no mapping is learned: the same value is always encoded in
+ * the same way, so different chunks of a dataset (or a training set and a test
+ * set) can be encoded separately.
+ *
+ * The dimensions that are not encoded are kept, in order, as the first rows
+ * of the output, and the numBuckets hashed dimensions follow them.
+ *
+ * @param input Input dataset to be encoded.
+ * @param indices Index of rows to be encoded.
+ * @param numBuckets Number of dimensions the encoded rows are hashed into.
+ * @param output Sparse encoded matrix.
+ */
+template<typename eT>
+void HashEncoding(const arma::Mat<eT>& input,
+                  const arma::Col<size_t>& indices,
+                  const size_t numBuckets,
+                  arma::SpMat<eT>& output);
+
+/**
+ * Overload of the function above that hashes all the dimensions marked
+ * `Datatype::categorical` in the data::DatasetInfo.
+ *
+ * @param input Input dataset to be encoded.
+ * @param numBuckets Number of dimensions the encoded rows are hashed into.
+ * @param output Sparse encoded matrix.
+ * @param datasetInfo DatasetInfo object that has information about data.
+ */
+template<typename eT>
+void HashEncoding(const arma::Mat<eT>& input,
+                  const size_t numBuckets,
+                  arma::SpMat<eT>& output,
+                  const data::DatasetInfo& datasetInfo);
+
 } // namespace data
 } // namespace mlpack
 
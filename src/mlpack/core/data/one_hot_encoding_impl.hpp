@@ -19,26 +19,24 @@
 namespace mlpack {
 namespace data {
 
+namespace details {
+
 /**
- * Given a set of labels of a particular datatype, convert them to binary
- * vector. The categorical values be mapped to integer values.
- * Then, each integer value is represented as a binary vector that is
- * all zero values except the index of the integer, which is marked
- * with a 1.
+ * Map each of the given labels to the index of its first appearance among the
+ * distinct labels.
  *
  * @param labelsIn Input labels of arbitrary datatype.
- * @param output Binary matrix.
+ * @param labels Index of each label.
+ * @return The number of distinct labels.
  */
-template<typename RowType, typename MatType>
-void OneHotEncoding(const RowType& labelsIn,
-                    MatType& output)
+template<typename KeyType, typename RowType>
+size_t MapLabels(const RowType& labelsIn, arma::Row<size_t>& labels)
 {
-  arma::Row<size_t> labels;
   labels.set_size(labelsIn.n_elem);
 
   // Loop over the input labels, and develop the mapping.
   // Map for labelsIn to labels.
-  std::unordered_map<typename MatType::elem_type, size_t> labelMap;
+  std::unordered_map<KeyType, size_t> labelMap;
   size_t curLabel = 0;
   for (size_t i = 0; i < labelsIn.n_elem; ++i)
   {
@@ -55,14 +53,131 @@ void OneHotEncoding(const RowType& labelsIn,
       ++curLabel;
     }
   }
+
+  return curLabel;
+}
+
+/**
+ * Find, for each dimension to be one-hot encoded, the index of each of its
+ * values among its distinct values (in order of first appearance), and the
+ * row of the encoded matrix where each dimension starts.
+ *
+ * @param input Input dataset to be encoded.
+ * @param indices Index of rows to be encoded.
+ * @param mappings Will hold the mapping of each dimension (empty for the
+ *     dimensions that are not encoded).
+ * @param encoded Will hold whether each dimension is encoded.
+ * @param dimensionOffsets Will hold the first row of each dimension in the
+ *     encoded matrix; the last element is the number of rows.
+ */
+template<typename eT>
+void OneHotEncodingMappings(
+    const arma::Mat<eT>& input,
+    const arma::Col<size_t>& indices,
+    std::vector<std::unordered_map<eT, size_t>>& mappings,
+    std::vector<bool>& encoded,
+    arma::Col<size_t>& dimensionOffsets)
+{
+  mappings.clear();
+  mappings.resize(input.n_rows);
+  encoded.assign(input.n_rows, false);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    if (indices[i] >= input.n_rows)
+    {
+      std::ostringstream oss;
+      oss << "OneHotEncoding(): cannot encode dimension " << indices[i]
+          << "; the data has only " << input.n_rows << " dimensions";
+      throw std::invalid_argument(oss.str());
+    }
+    encoded[indices[i]] = true;
+  }
+
+  // The dimensions that are not encoded take one row each.
+  arma::Col<size_t> counts(input.n_rows);
+  for (size_t row = 0; row < input.n_rows; ++row)
+    counts[row] = encoded[row] ? 0 : 1;
+
+  for (size_t col = 0; col < input.n_cols; ++col)
+  {
+    for (size_t row = 0; row < input.n_rows; ++row)
+    {
+      // We have to one-hot encode this point.
+      if (encoded[row] && mappings[row].count(input(row, col)) == 0)
+        mappings[row][input(row, col)] = counts[row]++;
+    }
+  }
+
+  // Turn the counts into offsets.
+  dimensionOffsets.set_size(input.n_rows + 1);
+  dimensionOffsets[0] = 0;
+  for (size_t row = 0; row < input.n_rows; ++row)
+    dimensionOffsets[row + 1] = dimensionOffsets[row] + counts[row];
+}
+
+/**
+ * Hash the given value of the given dimension, in the same way on every
+ * platform.
+ */
+inline uint64_t HashCategory(const size_t dimension, const double value)
+{
+  // Make sure that 0 and -0 have the same hash.
+  const double normalized = (value == 0.0) ? 0.0 : value;
+  uint64_t bits;
+  std::memcpy(&bits, &normalized, sizeof(double));
+
+  // Mix the dimension in, and finish with the splitmix64 finalizer.
+  uint64_t hash = bits ^ (uint64_t(dimension) * 0x9E3779B97F4A7C15ULL);
+  hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+  return hash ^ (hash >> 31);
+}
+
+} // namespace details
+
+/**
+ * Given a set of labels of a particular datatype, convert them to binary
+ * vector. The categorical values be mapped to integer values.
+ * Then, each integer value is represented as a binary vector that is
+ * all zero values except the index of the integer, which is marked
+ * with a 1.
+ *
+ * @param labelsIn Input labels of arbitrary datatype.
+ * @param output Binary matrix.
+ */
+template<typename RowType, typename MatType>
+void OneHotEncoding(const RowType& labelsIn,
+                    MatType& output)
+{
+  arma::Row<size_t> labels;
+  const size_t numLabels =
+      details::MapLabels<typename MatType::elem_type>(labelsIn, labels);
+
   // Resize output matrix to necessary size, and fill it with zeros.
-  output.zeros(curLabel, labelsIn.n_elem);
+  output.zeros(numLabels, labelsIn.n_elem);
   // Fill ones in at the required places.
   for (size_t i = 0; i < labelsIn.n_elem; ++i)
   {
     output(labels[i], i) = 1;
   }
-  labelMap.clear();
+}
+
+template<typename RowType, typename eT>
+void OneHotEncoding(const RowType& labelsIn,
+                    arma::SpMat<eT>& output)
+{
+  arma::Row<size_t> labels;
+  const size_t numLabels = details::MapLabels<eT>(labelsIn, labels);
+
+  // The locations are already sorted by column.
+  arma::umat locations(2, labelsIn.n_elem);
+  for (size_t i = 0; i < labelsIn.n_elem; ++i)
+  {
+    locations(0, i) = labels[i];
+    locations(1, i) = i;
+  }
+  output = arma::SpMat<eT>(locations, arma::Col<eT>(labelsIn.n_elem,
+      arma::fill::ones), numLabels, labelsIn.n_elem, false, false);
 }
 
 /**
@@ -86,61 +201,93 @@ void OneHotEncoding(const arma::Mat<eT>& input,
     return;
   }
 
-  // First, we need to compute the size of the output matrix.
+  std::vector<std::unordered_map<eT, size_t>> mappings;
+  std::vector<bool> encoded;
+  arma::Col<size_t> dimensionOffsets;
+  details::OneHotEncodingMappings(input, indices, mappings, encoded,
+      dimensionOffsets);
 
-  // This vector will eventually hold the offsets for each dimension in the
-  // one-hot encoded matrix, but first it will just hold the counts of
-  // dimensions for each dimension.
-  arma::Col<size_t> dimensionOffsets(input.n_rows, arma::fill::ones);
-  // This will hold the mappings from a value that should be one-hot encoded to
-  // the index of the dimension it should take.
-  std::unordered_map<size_t, std::unordered_map<eT, size_t>> mappings;
-  for (size_t i = 0; i < indices.n_elem; ++i)
-  {
-    dimensionOffsets[indices[i]] = 0;
-    mappings.insert(
-        std::make_pair(indices[i], std::unordered_map<eT, size_t>()));
-  }
+  // Now, initialize the output matrix to the right size.
+  output.zeros(dimensionOffsets[input.n_rows], input.n_cols);
 
-  for (size_t col = 0; col < input.n_cols; ++col)
+  // Finally, one-hot encode the matrix.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t col = 0; col < (omp_size_t) input.n_cols; ++col)
   {
     for (size_t row = 0; row < input.n_rows; ++row)
     {
-      if (mappings.count(row) != 0)
+      const size_t dimOffset = dimensionOffsets[row];
+      if (encoded[row])
       {
-        // We have to one-hot encode this point.
-        if (mappings[row].count(input(row, col)) == 0)
-          mappings[row][input(row, col)] = dimensionOffsets[row]++;
+        output(dimOffset + mappings[row].at(input(row, col)), col) = eT(1);
+      }
+      else
+      {
+        // No need for one-hot encoding.
+        output(dimOffset, col) = input(row, col);
       }
     }
   }
+}
 
-  // Turn the dimension counts into offsets.  Note that the last element is the
-  // total number of dimensions, and the first element is the offset for
-  // dimension *2* (not 1).
-  for (size_t i = 1; i < dimensionOffsets.n_elem; ++i)
-    dimensionOffsets[i] += dimensionOffsets[i - 1];
-
-  // Now, initialize the output matrix to the right size.
-  output.zeros(dimensionOffsets[dimensionOffsets.n_elem - 1], input.n_cols);
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    const arma::Col<size_t>& indices,
+                    arma::SpMat<eT>& output)
+{
+  std::vector<std::unordered_map<eT, size_t>> mappings;
+  std::vector<bool> encoded;
+  arma::Col<size_t> dimensionOffsets;
+  details::OneHotEncodingMappings(input, indices, mappings, encoded,
+      dimensionOffsets);
 
-  // Finally, one-hot encode the matrix.
+  // Count the nonzero values of each point, to know where each point starts
+  // in the list of nonzero values.
+  arma::Col<size_t> columnOffsets(input.n_cols + 1);
+  columnOffsets[0] = 0;
   for (size_t col = 0; col < input.n_cols; ++col)
   {
+    size_t nonzeros = 0;
     for (size_t row = 0; row < input.n_rows; ++row)
     {
-      const size_t dimOffset = (row == 0) ? 0 : dimensionOffsets[row - 1];
-      if (mappings.count(row) != 0)
+      if (encoded[row] || input(row, col) != eT(0))
+        ++nonzeros;
+    }
+    columnOffsets[col + 1] = columnOffsets[col] + nonzeros;
+  }
+
+  // The rows of each point are increasing, so the locations come out sorted.
+  arma::umat locations(2, columnOffsets[input.n_cols]);
+  arma::Col<eT> values(columnOffsets[input.n_cols]);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t col = 0; col < (omp_size_t) input.n_cols; ++col)
+  {
+    size_t index = columnOffsets[col];
+    for (size_t row = 0; row < input.n_rows; ++row)
+    {
+      if (encoded[row])
+      {
+        locations(0, index) = dimensionOffsets[row] +
+            mappings[row].at(input(row, col));
+        values[index] = eT(1);
+      }
+      else if (input(row, col) != eT(0))
       {
-        output(dimOffset + mappings[row][input(row, col)], col) = eT(1);
+        locations(0, index) = dimensionOffsets[row];
+        values[index] = input(row, col);
       }
       else
       {
-        // No need for one-hot encoding.
-        output(dimOffset, col) = input(row, col);
+        continue;
       }
+
+      locations(1, index) = col;
+      ++index;
     }
   }
+
+  output = arma::SpMat<eT>(locations, values, dimensionOffsets[input.n_rows],
+      input.n_cols, false, false);
 }
 
 /**
@@ -169,6 +316,142 @@ void OneHotEncoding(const arma::Mat<eT>& input,
   OneHotEncoding(input, arma::Col<size_t>(indices), output);
 }
 
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    arma::SpMat<eT>& output,
+                    const data::DatasetInfo& datasetInfo)
+{
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
+  {
+    if (datasetInfo.Type(i) == data::Datatype::categorical)
+    {
+      indices.push_back(i);
+    }
+  }
+  OneHotEncoding(input, arma::Col<size_t>(indices), output);
+}
+
+template<typename eT>
+void HashEncoding(const arma::Mat<eT>& input,
+                  const arma::Col<size_t>& indices,
+                  const size_t numBuckets,
+                  arma::SpMat<eT>& output)
+{
+  if (numBuckets == 0)
+  {
+    throw std::invalid_argument("HashEncoding(): the number of buckets must be "
+        "positive");
+  }
+
+  std::vector<bool> encoded(input.n_rows, false);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    if (indices[i] >= input.n_rows)
+    {
+      std::ostringstream oss;
+      oss << "HashEncoding(): cannot encode dimension " << indices[i]
+          << "; the data has only " << input.n_rows << " dimensions";
+      throw std::invalid_argument(oss.str());
+    }
+    encoded[indices[i]] = true;
+  }
+
+  // Each dimension that is not encoded keeps a row, before the buckets.
+  std::vector<size_t> keptRows(input.n_rows);
+  size_t numKept = 0;
+  for (size_t row = 0; row < input.n_rows; ++row)
+  {
+    if (!encoded[row])
+      keptRows[row] = numKept++;
+  }
+
+  // Get the sorted rows of the nonzero values of the given point, and their
+  // values (values hashed to the same bucket add up).
+  auto encodePoint = [&](const size_t col,
+                         std::vector<std::pair<size_t, eT>>& entries)
+  {
+    entries.clear();
+    std::vector<size_t> buckets;
+    for (size_t row = 0; row < input.n_rows; ++row)
+    {
+      if (encoded[row])
+      {
+        buckets.push_back(numKept + (size_t) (details::HashCategory(row,
+            (double) input(row, col)) % numBuckets));
+      }
+      else if (input(row, col) != eT(0))
+      {
+        entries.emplace_back(keptRows[row], input(row, col));
+      }
+    }
+
+    std::sort(buckets.begin(), buckets.end());
+    for (size_t i = 0; i < buckets.size(); ++i)
+    {
+      if (i > 0 && buckets[i] == buckets[i - 1])
+        entries.back().second += eT(1);
+      else
+        entries.emplace_back(buckets[i], eT(1));
+    }
+  };
+
+  // Count the nonzero values of each point first, so that the points can be
+  // encoded in parallel.
+  arma::Col<size_t> columnOffsets(input.n_cols + 1);
+  columnOffsets[0] = 0;
+  #pragma omp parallel
+  {
+    std::vector<std::pair<size_t, eT>> entries;
+    #pragma omp for schedule(static)
+    for (omp_size_t col = 0; col < (omp_size_t) input.n_cols; ++col)
+    {
+      encodePoint(col, entries);
+      columnOffsets[col + 1] = entries.size();
+    }
+  }
+  for (size_t col = 0; col < input.n_cols; ++col)
+    columnOffsets[col + 1] += columnOffsets[col];
+
+  arma::umat locations(2, columnOffsets[input.n_cols]);
+  arma::Col<eT> values(columnOffsets[input.n_cols]);
+  #pragma omp parallel
+  {
+    std::vector<std::pair<size_t, eT>> entries;
+    #pragma omp for schedule(static)
+    for (omp_size_t col = 0; col < (omp_size_t) input.n_cols; ++col)
+    {
+      encodePoint(col, entries);
+      for (size_t i = 0; i < entries.size(); ++i)
+      {
+        locations(0, columnOffsets[col] + i) = entries[i].first;
+        locations(1, columnOffsets[col] + i) = col;
+        values[columnOffsets[col] + i] = entries[i].second;
+      }
+    }
+  }
+
+  output = arma::SpMat<eT>(locations, values, numKept + numBuckets,
+      input.n_cols, false, false);
+}
+
+template<typename eT>
+void HashEncoding(const arma::Mat<eT>& input,
+                  const size_t numBuckets,
+                  arma::SpMat<eT>& output,
+                  const data::DatasetInfo& datasetInfo)
+{
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
+  {
+    if (datasetInfo.Type(i) == data::Datatype::categorical)
+    {
+      indices.push_back(i);
+    }
+  }
+  HashEncoding(input, arma::Col<size_t>(indices), numBuckets, output);
+}
+
 } // namespace data
 } // namespace mlpack
 
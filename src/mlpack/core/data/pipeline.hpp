@@ -0,0 +1,186 @@
+/**
+ * @file core/data/pipeline.hpp
+ *
+ * Definition of Pipeline, which imputes, scales and one-hot encodes a dataset
+ * in a single pass.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_PIPELINE_HPP
+#define MLPACK_CORE_DATA_PIPELINE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/dataset_mapper.hpp>
+#include <mlpack/core/data/feature_statistics.hpp>
+#include <mlpack/core/data/scaler_methods/standard_scaler.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Pipeline chains the usual preprocessing steps of a dataset: the missing
+ * values of the numeric dimensions are imputed (with the mean or the median
+ * of the dimension), the numeric dimensions are then scaled with ScalerType,
+ * and the categorical dimensions are one-hot encoded.  Each step is fit on the
+ * result of the previous ones, as if they were applied one after the other
+ * with Imputer, a scaler and OneHotEncoding().
+ *
+ * Instead of making a full pass over the dataset, with its own output matrix,
+ * for each step, Transform() takes the dataset one block of columns at a time,
+ * in parallel, and runs each block through all the steps while it is still in
+ * cache; the only allocation the size of the dataset is the output.  Fit()
+ * needs two passes: one to find the imputed values and the categories, and
+ * one to accumulate the statistics of the imputed dataset for the scaler.
+ *
+ * The categorical dimensions are replaced by one row for each of their
+ * categories seen by Fit(), in increasing order of value; a category that was
+ * not seen by Fit() (or a missing value) is encoded as all zeros.  The model
+ * can be serialized, so that new data can be preprocessed the same way later.
+ *
+ * @code
+ * data::DatasetInfo info;
+ * arma::mat train, test;
+ * data::Load("train.csv", train, info);
+ *
+ * data::Pipeline<data::MinMaxScaler> pipeline(info);
+ * arma::mat trainOutput, testOutput;
+ * pipeline.Fit(train);
+ * pipeline.Transform(train, trainOutput);
+ * pipeline.Transform(test, testOutput);
+ * @endcode
+ *
+ * @tparam ScalerType Scaler for the numeric dimensions; it must be fit from a
+ *     FeatureStatistics object (StandardScaler, MinMaxScaler, MaxAbsScaler or
+ *     MeanNormalization).
+ */
+template<typename ScalerType = StandardScaler>
+class Pipeline
+{
+ public:
+  /**
+   * Create the pipeline.
+   *
+   * @param categoricalDimensions Dimensions to one-hot encode; the others are
+   *     imputed and scaled.
+   * @param missingValue Value that marks a missing value (NaN by default).
+   * @param medianImputation If true, impute the median of each dimension
+   *     instead of its mean.
+   * @param scaler Scaler to use for the numeric dimensions.
+   */
+  Pipeline(const std::vector<size_t>& categoricalDimensions =
+               std::vector<size_t>(),
+           const double missingValue =
+               std::numeric_limits<double>::quiet_NaN(),
+           const bool medianImputation = false,
+           const ScalerType& scaler = ScalerType());
+
+  /**
+   * Create the pipeline, one-hot encoding the dimensions that are categorical
+   * according to the given DatasetInfo.
+   *
+   * @param info Type of each dimension.
+   * @param missingValue Value that marks a missing value (NaN by default).
+   * @param medianImputation If true, impute the median of each dimension
+   *     instead of its mean.
+   * @param scaler Scaler to use for the numeric dimensions.
+   */
+  Pipeline(const DatasetInfo& info,
+           const double missingValue =
+               std::numeric_limits<double>::quiet_NaN(),
+           const bool medianImputation = false,
+           const ScalerType& scaler = ScalerType());
+
+  /**
+   * Fit all the steps of the pipeline on the given dataset.  A
+   * std::invalid_argument is thrown if a categorical dimension does not exist,
+   * or if a numeric dimension has no value that is not missing.
+   *
+   * @param input Dataset to fit, one point per column.
+   */
+  template<typename MatType>
+  void Fit(const MatType& input);
+
+  /**
+   * Run the given dataset through all the steps of the pipeline.  Fit() must
+   * have been called before.
+   *
+   * @param input Dataset to transform, one point per column.
+   * @param output Matrix to store the transformed dataset in.
+   * @param blockSize Number of points that go through the steps together.
+   */
+  template<typename MatType>
+  void Transform(const MatType& input,
+                 MatType& output,
+                 const size_t blockSize = 256);
+
+  //! Get the dimensionality of the datasets the pipeline transforms.
+  size_t InputDimensionality() const { return dimensionOffsets.size(); }
+  //! Get the dimensionality of the transformed datasets.
+  size_t OutputDimensionality() const { return outputDimensionality; }
+
+  //! Get the value imputed for each numeric dimension.
+  const arma::vec& ImputedValues() const { return imputedValues; }
+  //! Get the categories of each dimension (empty for numeric ones).
+  const std::vector<std::vector<double>>& Categories() const
+  { return categories; }
+
+  //! Get the scaler.
+  const ScalerType& Scaler() const { return scaler; }
+
+  /**
+   * Serialize the pipeline.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Whether the given value is missing.
+  bool IsMissing(const double value) const
+  {
+    return std::isnan(missingValue) ? std::isnan(value) :
+        (value == missingValue);
+  }
+
+  //! Compute the value imputed for each numeric dimension.
+  template<typename MatType>
+  void FitImputation(const MatType& input);
+
+  //! Copy the numeric dimensions of the given points into the given buffer,
+  //! imputing the missing values.
+  template<typename MatType>
+  void ImputeBlock(const MatType& input,
+                   const size_t begin,
+                   const size_t end,
+                   arma::Mat<typename MatType::elem_type>& buffer) const;
+
+  //! The dimensions to one-hot encode.
+  std::vector<size_t> categoricalDimensions;
+  //! The value that marks a missing value.
+  double missingValue;
+  //! Whether to impute the median instead of the mean.
+  bool medianImputation;
+  //! The scaler of the numeric dimensions.
+  ScalerType scaler;
+
+  //! The numeric dimensions, in order.
+  std::vector<size_t> numericDimensions;
+  //! The value imputed for each numeric dimension.
+  arma::vec imputedValues;
+  //! The sorted categories of each dimension (empty for numeric ones).
+  std::vector<std::vector<double>> categories;
+  //! The first output row of each input dimension.
+  std::vector<size_t> dimensionOffsets;
+  //! The number of output rows.
+  size_t outputDimensionality;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "pipeline_impl.hpp"
+
+#endif
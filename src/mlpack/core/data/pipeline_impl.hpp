@@ -0,0 +1,335 @@
+/**
+ * @file core/data/pipeline_impl.hpp
+ *
+ * Implementation of Pipeline.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_PIPELINE_IMPL_HPP
+#define MLPACK_CORE_DATA_PIPELINE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "pipeline.hpp"
+
+namespace mlpack {
+namespace data {
+
+template<typename ScalerType>
+Pipeline<ScalerType>::Pipeline(const std::vector<size_t>& categoricalDimensions,
+                               const double missingValue,
+                               const bool medianImputation,
+                               const ScalerType& scaler) :
+    categoricalDimensions(categoricalDimensions),
+    missingValue(missingValue),
+    medianImputation(medianImputation),
+    scaler(scaler),
+    outputDimensionality(0)
+{
+  // Nothing to do.
+}
+
+template<typename ScalerType>
+Pipeline<ScalerType>::Pipeline(const DatasetInfo& info,
+                               const double missingValue,
+                               const bool medianImputation,
+                               const ScalerType& scaler) :
+    missingValue(missingValue),
+    medianImputation(medianImputation),
+    scaler(scaler),
+    outputDimensionality(0)
+{
+  for (size_t d = 0; d < info.Dimensionality(); ++d)
+  {
+    if (info.Type(d) == Datatype::categorical)
+      categoricalDimensions.push_back(d);
+  }
+}
+
+template<typename ScalerType>
+template<typename MatType>
+void Pipeline<ScalerType>::Fit(const MatType& input)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  std::vector<bool> isCategorical(input.n_rows, false);
+  for (size_t i = 0; i < categoricalDimensions.size(); ++i)
+  {
+    if (categoricalDimensions[i] >= input.n_rows)
+    {
+      std::ostringstream oss;
+      oss << "Pipeline::Fit(): categorical dimension "
+          << categoricalDimensions[i] << " does not exist (the dataset has "
+          << input.n_rows << " dimensions)";
+      throw std::invalid_argument(oss.str());
+    }
+    isCategorical[categoricalDimensions[i]] = true;
+  }
+
+  numericDimensions.clear();
+  for (size_t d = 0; d < input.n_rows; ++d)
+  {
+    if (!isCategorical[d])
+      numericDimensions.push_back(d);
+  }
+
+  // First pass: find the imputed values and the categories.
+  FitImputation(input);
+
+  categories.assign(input.n_rows, std::vector<double>());
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (omp_size_t i = 0; i < (omp_size_t) categoricalDimensions.size(); ++i)
+  {
+    const size_t d = categoricalDimensions[i];
+    std::vector<double>& dimensionCategories = categories[d];
+    for (size_t j = 0; j < input.n_cols; ++j)
+    {
+      if (!IsMissing(input(d, j)))
+        dimensionCategories.push_back(input(d, j));
+    }
+
+    std::sort(dimensionCategories.begin(), dimensionCategories.end());
+    dimensionCategories.erase(std::unique(dimensionCategories.begin(),
+        dimensionCategories.end()), dimensionCategories.end());
+  }
+
+  dimensionOffsets.resize(input.n_rows);
+  outputDimensionality = 0;
+  for (size_t d = 0; d < input.n_rows; ++d)
+  {
+    dimensionOffsets[d] = outputDimensionality;
+    outputDimensionality += isCategorical[d] ? categories[d].size() : 1;
+  }
+
+  // Second pass: accumulate the statistics of the imputed numeric dimensions
+  // one chunk at a time, and fit the scaler on them.
+  if (numericDimensions.empty())
+    return;
+
+  const size_t chunkSize = 16384;
+  FeatureStatistics statistics;
+  arma::Mat<ElemType> buffer;
+  for (size_t begin = 0; begin < input.n_cols; begin += chunkSize)
+  {
+    const size_t end = std::min(begin + chunkSize, (size_t) input.n_cols);
+    ImputeBlock(input, begin, end, buffer);
+    statistics.Update(buffer);
+  }
+
+  scaler.Fit(statistics);
+}
+
+template<typename ScalerType>
+template<typename MatType>
+void Pipeline<ScalerType>::Transform(const MatType& input,
+                                     MatType& output,
+                                     const size_t blockSize)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  if (dimensionOffsets.empty())
+  {
+    throw std::runtime_error("Call Fit() before Transform(), please"
+        " refer to the documentation.");
+  }
+
+  if (input.n_rows != dimensionOffsets.size())
+  {
+    std::ostringstream oss;
+    oss << "Pipeline::Transform(): the dataset has " << input.n_rows
+        << " dimensions, but the pipeline was fit on "
+        << dimensionOffsets.size() << " dimensions";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (blockSize == 0)
+  {
+    throw std::invalid_argument("Pipeline::Transform(): blockSize must be "
+        "positive");
+  }
+
+  // The output has another size, so it cannot overwrite the input.
+  if (&input == &output)
+  {
+    MatType result;
+    Transform(input, result, blockSize);
+    output = std::move(result);
+    return;
+  }
+
+  output.set_size(outputDimensionality, input.n_cols);
+  const size_t numBlocks = (input.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel
+  {
+    // Each thread reuses its buffer for all its blocks.
+    arma::Mat<ElemType> buffer;
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = (size_t) b * blockSize;
+      const size_t end = std::min(begin + blockSize, (size_t) input.n_cols);
+
+      // Impute and scale the numeric dimensions of the block.
+      ImputeBlock(input, begin, end, buffer);
+      if (!numericDimensions.empty())
+        scaler.Transform(buffer);
+
+      for (size_t i = begin; i < end; ++i)
+      {
+        ElemType* out = output.colptr(i);
+        for (size_t j = 0; j < numericDimensions.size(); ++j)
+          out[dimensionOffsets[numericDimensions[j]]] = buffer(j, i - begin);
+
+        // One-hot encode the categorical dimensions.
+        for (size_t k = 0; k < categoricalDimensions.size(); ++k)
+        {
+          const size_t d = categoricalDimensions[k];
+          const std::vector<double>& dimensionCategories = categories[d];
+          ElemType* encoded = out + dimensionOffsets[d];
+          std::fill(encoded, encoded + dimensionCategories.size(),
+              ElemType(0));
+
+          const double value = input(d, i);
+          if (IsMissing(value))
+            continue;
+
+          const auto it = std::lower_bound(dimensionCategories.begin(),
+              dimensionCategories.end(), value);
+          if (it != dimensionCategories.end() && *it == value)
+            encoded[it - dimensionCategories.begin()] = ElemType(1);
+        }
+      }
+    }
+  }
+}
+
+template<typename ScalerType>
+template<typename Archive>
+void Pipeline<ScalerType>::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(categoricalDimensions));
+  ar(CEREAL_NVP(missingValue));
+  ar(CEREAL_NVP(medianImputation));
+  ar(CEREAL_NVP(scaler));
+  ar(CEREAL_NVP(numericDimensions));
+  ar(CEREAL_NVP(imputedValues));
+  ar(CEREAL_NVP(categories));
+  ar(CEREAL_NVP(dimensionOffsets));
+  ar(CEREAL_NVP(outputDimensionality));
+}
+
+template<typename ScalerType>
+template<typename MatType>
+void Pipeline<ScalerType>::FitImputation(const MatType& input)
+{
+  const size_t numNumeric = numericDimensions.size();
+  imputedValues.set_size(numNumeric);
+  arma::Col<size_t> counts(numNumeric, arma::fill::zeros);
+
+  if (medianImputation)
+  {
+    // Each dimension is handled by one thread.
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (omp_size_t j = 0; j < (omp_size_t) numNumeric; ++j)
+    {
+      const size_t d = numericDimensions[j];
+      std::vector<double> values;
+      values.reserve(input.n_cols);
+      for (size_t i = 0; i < input.n_cols; ++i)
+      {
+        if (!IsMissing(input(d, i)))
+          values.push_back(input(d, i));
+      }
+
+      counts[j] = values.size();
+      if (values.empty())
+        continue;
+
+      // Select the upper median; for an even number of values, average it
+      // with the largest value of the lower half, like arma::median() does.
+      const size_t half = values.size() / 2;
+      std::nth_element(values.begin(), values.begin() + half, values.end());
+      double median = values[half];
+      if (values.size() % 2 == 0)
+      {
+        median = (median + *std::max_element(values.begin(),
+            values.begin() + half)) / 2.0;
+      }
+      imputedValues[j] = median;
+    }
+  }
+  else
+  {
+    // Each thread sums its part of the points, and the sums are then added.
+    arma::vec sums(numNumeric, arma::fill::zeros);
+    #pragma omp parallel
+    {
+      arma::vec threadSums(numNumeric, arma::fill::zeros);
+      arma::Col<size_t> threadCounts(numNumeric, arma::fill::zeros);
+
+      #pragma omp for schedule(static)
+      for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+      {
+        for (size_t j = 0; j < numNumeric; ++j)
+        {
+          const double value = input(numericDimensions[j], i);
+          if (!IsMissing(value))
+          {
+            threadSums[j] += value;
+            ++threadCounts[j];
+          }
+        }
+      }
+
+      #pragma omp critical
+      {
+        sums += threadSums;
+        counts += threadCounts;
+      }
+    }
+
+    imputedValues = sums / arma::conv_to<arma::vec>::from(counts);
+  }
+
+  for (size_t j = 0; j < numNumeric; ++j)
+  {
+    if (counts[j] == 0)
+    {
+      std::ostringstream oss;
+      oss << "Pipeline::Fit(): dimension " << numericDimensions[j] << " has "
+          << "no value to impute missing values with";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+}
+
+template<typename ScalerType>
+template<typename MatType>
+void Pipeline<ScalerType>::ImputeBlock(
+    const MatType& input,
+    const size_t begin,
+    const size_t end,
+    arma::Mat<typename MatType::elem_type>& buffer) const
+{
+  typedef typename MatType::elem_type ElemType;
+
+  buffer.set_size(numericDimensions.size(), end - begin);
+  for (size_t i = begin; i < end; ++i)
+  {
+    ElemType* out = buffer.colptr(i - begin);
+    for (size_t j = 0; j < numericDimensions.size(); ++j)
+    {
+      const ElemType value = input(numericDimensions[j], i);
+      out[j] = IsMissing(value) ? ElemType(imputedValues[j]) : value;
+    }
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
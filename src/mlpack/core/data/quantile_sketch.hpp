@@ -0,0 +1,107 @@
+/**
+ * @file core/data/quantile_sketch.hpp
+ *
+ * Definition of QuantileSketch, a mergeable summary of a stream of values that
+ * estimates its quantiles in small space.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_QUANTILE_SKETCH_HPP
+#define MLPACK_CORE_DATA_QUANTILE_SKETCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * QuantileSketch is a KLL sketch (Karnin, Lang and Liberty, "Optimal Quantile
+ * Approximation in Streams", 2016): it keeps a hierarchy of buffers ("levels")
+ * where each value of level h stands for 2^h values of the stream.  When the
+ * sketch is full, the lowest full level is sorted and every other value of it
+ * is moved one level up.  The number of values kept is about 3k, and the rank
+ * error of the quantiles is of the order of 1 / k of the number of values; as
+ * long as fewer than k values were inserted, the quantiles are exact.
+ *
+ * Sketches of parts of a stream can be merged into a sketch of the whole
+ * stream, so a stream can be summarized in parallel.  Unlike the original
+ * algorithm, the values kept by a compaction alternate deterministically
+ * between the odd and even positions, so the result does not depend on a
+ * random number generator.
+ */
+class QuantileSketch
+{
+ public:
+  /**
+   * Create an empty sketch.
+   *
+   * @param k Size parameter; larger values give more accurate quantiles, and
+   *     use more memory (at least 2).
+   */
+  QuantileSketch(const size_t k = 200);
+
+  /**
+   * Insert the given value.
+   *
+   * @param value Value to insert.
+   */
+  void Insert(const double value);
+
+  /**
+   * Merge the given sketch into this one, so that this sketch summarizes the
+   * values of both.  The two sketches should have the same k.
+   *
+   * @param other Sketch to merge.
+   */
+  void Merge(const QuantileSketch& other);
+
+  /**
+   * Estimate the given quantile, interpolating linearly between the values
+   * around it like arma::median() does (so the exact quantile is returned if
+   * fewer than k values were inserted).  A std::logic_error is thrown if the
+   * sketch is empty.
+   *
+   * @param q Quantile to estimate, in [0, 1].
+   */
+  double Quantile(const double q) const;
+
+  //! Get the number of values inserted.
+  size_t Count() const { return count; }
+  //! Get the size parameter.
+  size_t K() const { return k; }
+
+  /**
+   * Serialize the sketch.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Get the number of values the given level can hold.
+  size_t Capacity(const size_t level) const;
+
+  //! Compact the lowest full level.
+  void Compress();
+
+  //! The size parameter.
+  size_t k;
+  //! The number of values inserted.
+  size_t count;
+  //! The number of values kept in all the levels.
+  size_t numRetained;
+  //! The values of each level; those of level h have weight 2^h.
+  std::vector<std::vector<double>> levels;
+  //! Whether the next compaction keeps the values at odd positions.
+  bool oddOffset;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "quantile_sketch_impl.hpp"
+
+#endif
@@ -0,0 +1,173 @@
+/**
+ * @file core/data/quantile_sketch_impl.hpp
+ *
+ * Implementation of QuantileSketch.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_QUANTILE_SKETCH_IMPL_HPP
+#define MLPACK_CORE_DATA_QUANTILE_SKETCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "quantile_sketch.hpp"
+
+namespace mlpack {
+namespace data {
+
+inline QuantileSketch::QuantileSketch(const size_t k) :
+    k(k),
+    count(0),
+    numRetained(0),
+    oddOffset(false)
+{
+  if (k < 2)
+    throw std::invalid_argument("QuantileSketch: k should be at least 2");
+}
+
+inline void QuantileSketch::Insert(const double value)
+{
+  if (levels.empty())
+    levels.emplace_back();
+
+  levels[0].push_back(value);
+  ++count;
+  ++numRetained;
+
+  size_t capacity = 0;
+  for (size_t h = 0; h < levels.size(); ++h)
+    capacity += Capacity(h);
+  if (numRetained >= capacity)
+    Compress();
+}
+
+inline void QuantileSketch::Merge(const QuantileSketch& other)
+{
+  if (other.count == 0)
+    return;
+
+  if (levels.size() < other.levels.size())
+    levels.resize(other.levels.size());
+  for (size_t h = 0; h < other.levels.size(); ++h)
+  {
+    levels[h].insert(levels[h].end(), other.levels[h].begin(),
+        other.levels[h].end());
+  }
+  count += other.count;
+  numRetained += other.numRetained;
+
+  // Each compaction removes at least one value, and while the sketch holds
+  // more than its capacity, some level is full.
+  while (true)
+  {
+    size_t capacity = 0;
+    for (size_t h = 0; h < levels.size(); ++h)
+      capacity += Capacity(h);
+    if (numRetained < capacity)
+      break;
+
+    Compress();
+  }
+}
+
+inline double QuantileSketch::Quantile(const double q) const
+{
+  if (count == 0)
+    throw std::logic_error("QuantileSketch::Quantile(): the sketch is empty");
+  if (!(q >= 0.0 && q <= 1.0))
+  {
+    throw std::invalid_argument("QuantileSketch::Quantile(): the quantile "
+        "should be in [0, 1]");
+  }
+
+  // Sort the values with their weights.
+  std::vector<std::pair<double, size_t>> values;
+  values.reserve(numRetained);
+  for (size_t h = 0; h < levels.size(); ++h)
+  {
+    for (size_t i = 0; i < levels[h].size(); ++i)
+      values.emplace_back(levels[h][i], size_t(1) << h);
+  }
+  std::sort(values.begin(), values.end());
+
+  // Find the values at the two ranks around the position of the quantile.
+  size_t totalWeight = 0;
+  for (size_t i = 0; i < values.size(); ++i)
+    totalWeight += values[i].second;
+
+  const double position = q * (totalWeight - 1);
+  const size_t lowRank = (size_t) std::floor(position);
+  const size_t highRank = std::min(lowRank + 1, totalWeight - 1);
+  const double fraction = position - lowRank;
+
+  double low = values.back().first, high = values.back().first;
+  size_t cumulativeWeight = 0;
+  bool foundLow = false;
+  for (size_t i = 0; i < values.size(); ++i)
+  {
+    cumulativeWeight += values[i].second;
+    if (!foundLow && lowRank < cumulativeWeight)
+    {
+      low = values[i].first;
+      foundLow = true;
+    }
+    if (highRank < cumulativeWeight)
+    {
+      high = values[i].first;
+      break;
+    }
+  }
+
+  return (fraction == 0.0) ? low : (1.0 - fraction) * low + fraction * high;
+}
+
+template<typename Archive>
+void QuantileSketch::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(k));
+  ar(CEREAL_NVP(count));
+  ar(CEREAL_NVP(numRetained));
+  ar(CEREAL_NVP(levels));
+  ar(CEREAL_NVP(oddOffset));
+}
+
+inline size_t QuantileSketch::Capacity(const size_t level) const
+{
+  // Lower levels hold geometrically fewer values than the top one.
+  const double capacity = std::ceil(k * std::pow(2.0 / 3.0,
+      (double) (levels.size() - 1 - level)));
+  return std::max((size_t) 2, (size_t) capacity);
+}
+
+inline void QuantileSketch::Compress()
+{
+  for (size_t h = 0; h < levels.size(); ++h)
+  {
+    if (levels[h].size() < Capacity(h))
+      continue;
+
+    if (h + 1 == levels.size())
+      levels.emplace_back();
+
+    // Keep the smallest value if the number of values is odd, and move every
+    // other one of the rest up, with twice the weight.
+    std::vector<double>& level = levels[h];
+    std::sort(level.begin(), level.end());
+    const size_t start = level.size() % 2;
+    const size_t offset = oddOffset ? 1 : 0;
+    oddOffset = !oddOffset;
+    for (size_t i = start; i < level.size(); i += 2)
+      levels[h + 1].push_back(level[i + offset]);
+
+    numRetained -= (level.size() - start) / 2;
+    level.resize(start);
+    return;
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -20,6 +20,8 @@
 
 #include "format.hpp"
 #include "image_info.hpp"
+#include "mapped_matrix.hpp"
+#include "mapped_model.hpp"
 
 namespace mlpack {
 namespace data /** Functions to load and save matrices. */ {
@@ -40,6 +42,10 @@ namespace data /** Functions to load and save matrices. */ {
  *  - Armadillo binary (arma::arma_binary), denoted by .bin
  *  - HDF5 (arma::hdf5_binary), denoted by .hdf5, .hdf, .h5, or .he5
  *
+ * Filenames with the .mlmat extension are saved in the mlpack binary matrix
+ * format (see MatrixFileHeader), which data::Load() can map without copying
+ * into a MappedMatrix.  Matrices in this format are never transposed.
+ *
  * By default, this function will try to automatically determine the format to
  * save with based only on the filename's extension.  If you would prefer to
  * specify a file type manually, override the default
@@ -77,6 +83,8 @@ bool Save(const std::string& filename,
  *  - TXT (coord_ascii), denoted by .txt
  *  - Raw binary (raw_binary), denoted by .bin
  *  - Armadillo binary (arma_binary), denoted by .bin
+ *  - mlpack binary sparse matrix (see SparseMatrixFileHeader), denoted by
+ *    .mlsp; these are never transposed
  *
  * If the file extension is not one of those types, an error will be given.  If
  * the 'fatal' parameter is set to true, a std::runtime_error exception will be
@@ -97,6 +105,27 @@ bool Save(const std::string& filename,
           const bool fatal = false,
           bool transpose = true);
 
+/**
+ * Save a sparse dataset and its labels to a file in the libsvm (svmlight)
+ * format, with one point (one column of the matrix) per line, written as
+ * "label index:value ..." with 1-based feature indices.  The file can be
+ * loaded with data::LoadLibSVM().
+ *
+ * If the 'fatal' parameter is set to true, a std::runtime_error exception will
+ * be thrown upon failure.
+ *
+ * @param filename Name of file to save to.
+ * @param matrix Sparse matrix of points to save, one point per column.
+ * @param labels Labels of the points.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of save.
+ */
+template<typename eT>
+bool SaveLibSVM(const std::string& filename,
+                const arma::SpMat<eT>& matrix,
+                const arma::rowvec& labels,
+                const bool fatal = false);
+
 /**
  * Saves a model to file, guessing the filetype from the extension, or,
  * optionally, saving the specified format.  If automatic extension detection is
@@ -108,9 +137,12 @@ bool Save(const std::string& filename,
  *  - json, denoted by .json
  *  - xml, denoted by .xml
  *  - binary, denoted by .bin
+ *  - mapped binary, denoted by .mlmodel, where the matrices of the model are
+ *    stored as aligned blocks that can be memory-mapped (see MappedModel)
  *
  * The format parameter can take any of the values in the 'format' enum:
- * 'format::autodetect', 'format::json', 'format::xml', and 'format::binary'.
+ * 'format::autodetect', 'format::json', 'format::xml', 'format::binary', and
+ * 'format::mapped'.
  * The autodetect functionality operates on the file extension (so, "file.txt"
  * would be autodetected as text).
  *
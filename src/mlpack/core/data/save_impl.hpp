@@ -52,6 +52,32 @@ bool Save(const std::string& filename,
 {
   Timer::Start("saving_data");
 
+  // mlpack binary matrix files are not transposed.
+  if (inputSaveType == arma::auto_detect && Extension(filename) == "mlmat")
+  {
+    Log::Info << "Saving mlpack binary matrix to '" << filename << "'."
+        << std::endl;
+    try
+    {
+      MatrixFileWriter<eT> writer(filename, matrix.n_rows);
+      writer.Write(matrix);
+      writer.Close();
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("saving_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    Timer::Stop("saving_data");
+    return true;
+  }
+
   arma::file_type saveType = inputSaveType;
   std::string stringType = "";
 
@@ -174,6 +200,31 @@ bool Save(const std::string& filename,
     return false;
   }
 
+  // mlpack binary sparse files are written in compressed sparse column form,
+  // and are not transposed.
+  if (extension == "mlsp")
+  {
+    Log::Info << "Saving mlpack binary sparse matrix to '" << filename << "'."
+        << std::endl;
+    try
+    {
+      SparseMatrixFileHeader::Save(filename, matrix);
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("saving_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    Timer::Stop("saving_data");
+    return true;
+  }
+
   // Catch errors opening the file.
   std::fstream stream;
 #ifdef  _WIN32 // Always open in binary mode on Windows.
@@ -259,6 +310,71 @@ bool Save(const std::string& filename,
   return true;
 }
 
+template<typename eT>
+bool SaveLibSVM(const std::string& filename,
+                const arma::SpMat<eT>& matrix,
+                const arma::rowvec& labels,
+                const bool fatal)
+{
+  Timer::Start("saving_data");
+
+  if (labels.n_elem != matrix.n_cols)
+  {
+    Timer::Stop("saving_data");
+    std::ostringstream oss;
+    oss << "SaveLibSVM(): number of labels (" << labels.n_elem << ") does not "
+        << "match number of points (" << matrix.n_cols << "); save failed.";
+    if (fatal)
+      Log::Fatal << oss.str() << std::endl;
+    else
+      Log::Warn << oss.str() << std::endl;
+
+    return false;
+  }
+
+  std::ofstream stream(filename);
+  if (!stream.is_open())
+  {
+    Timer::Stop("saving_data");
+    if (fatal)
+      Log::Fatal << "Cannot open file '" << filename << "' for writing. "
+          << "Save failed." << std::endl;
+    else
+      Log::Warn << "Cannot open file '" << filename << "' for writing; save "
+          << "failed." << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Saving libsvm formatted data to '" << filename << "'."
+      << std::endl;
+
+  // Write enough digits that the values are read back exactly.
+  matrix.sync();
+  stream.precision(std::numeric_limits<double>::max_digits10);
+  for (size_t i = 0; i < matrix.n_cols; ++i)
+  {
+    stream << labels[i];
+    for (size_t j = matrix.col_ptrs[i]; j < matrix.col_ptrs[i + 1]; ++j)
+      stream << ' ' << (matrix.row_indices[j] + 1) << ':' << matrix.values[j];
+    stream << '\n';
+  }
+
+  if (!stream.good())
+  {
+    Timer::Stop("saving_data");
+    if (fatal)
+      Log::Fatal << "Save to '" << filename << "' failed." << std::endl;
+    else
+      Log::Warn << "Save to '" << filename << "' failed." << std::endl;
+
+    return false;
+  }
+
+  Timer::Stop("saving_data");
+  return true;
+}
+
 //! Save a model to file.
 template<typename T>
 bool Save(const std::string& filename,
@@ -277,20 +393,42 @@ bool Save(const std::string& filename,
       f = format::binary;
     else if (extension == "json")
       f = format::json;
+    else if (extension == "mlmodel")
+      f = format::mapped;
     else
     {
       if (fatal)
         Log::Fatal << "Unable to detect type of '" << filename << "'; incorrect"
-            << " extension? (allowed: xml/bin/json)" << std::endl;
+            << " extension? (allowed: xml/bin/json/mlmodel)" << std::endl;
       else
         Log::Warn << "Unable to detect type of '" << filename << "'; save "
-            << "failed.  Incorrect extension? (allowed: xml/bin/json)"
+            << "failed.  Incorrect extension? (allowed: xml/bin/json/mlmodel)"
             << std::endl;
 
       return false;
     }
   }
 
+  // The mapped format writes the matrices and the rest of the model to
+  // different parts of the file.
+  if (f == format::mapped)
+  {
+    try
+    {
+      SaveMappedModel(filename, name, t);
+      return true;
+    }
+    catch (std::exception& e)
+    {
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+  }
+
   // Open the file to save to.
   std::ofstream ofs;
 #ifdef _WIN32
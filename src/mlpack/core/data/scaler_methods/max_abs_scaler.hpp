@@ -13,6 +13,9 @@
 #define MLPACK_CORE_DATA_MAX_ABS_SCALE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/feature_statistics.hpp>
+
+#include "scale_columns.hpp"
 
 namespace mlpack {
 namespace data {
@@ -54,8 +57,21 @@ class MaxAbsScaler
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMin = arma::min(input, 1);
-    itemMax = arma::max(input, 1);
+    FeatureStatistics statistics;
+    statistics.Update(input);
+    Fit(statistics);
+  }
+
+  /**
+   * Function to fit features from statistics of the dataset, which can be
+   * accumulated one chunk at a time (see FeatureStatistics).
+   *
+   * @param statistics Statistics of the dataset to fit.
+   */
+  void Fit(const FeatureStatistics& statistics)
+  {
+    itemMin = statistics.Min();
+    itemMax = statistics.Max();
     scale = arma::max(arma::abs(itemMin), arma::abs(itemMax));
     // Handling zeros in scale vector.
     scale.for_each([](arma::vec::elem_type& val) { val =
@@ -76,8 +92,19 @@ class MaxAbsScaler
       throw std::runtime_error("Call Fit() before Transform(), please"
         " refer to the documentation.");
     }
-    output.copy_size(input);
-    output = input.each_col() / scale;
+    const arma::vec zeros(scale.n_elem, arma::fill::zeros);
+    ScaleColumns(input, output, zeros, 1.0 / scale, zeros);
+  }
+
+  /**
+   * Function to scale features in place, without allocating another matrix.
+   *
+   * @param data Dataset to scale; it is overwritten.
+   */
+  template<typename MatType>
+  void Transform(MatType& data)
+  {
+    Transform(data, data);
   }
 
   /**
@@ -89,8 +116,19 @@ class MaxAbsScaler
   template<typename MatType>
   void InverseTransform(const MatType& input, MatType& output)
   {
-    output.copy_size(input);
-    output = input.each_col() % scale;
+    const arma::vec zeros(scale.n_elem, arma::fill::zeros);
+    ScaleColumns(input, output, zeros, scale, zeros);
+  }
+
+  /**
+   * Function to retrieve the original dataset in place.
+   *
+   * @param data Scaled dataset; it is overwritten.
+   */
+  template<typename MatType>
+  void InverseTransform(MatType& data)
+  {
+    InverseTransform(data, data);
   }
 
   //! Get the Min row vector.
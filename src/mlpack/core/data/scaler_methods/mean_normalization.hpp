@@ -13,6 +13,9 @@
 #define MLPACK_CORE_DATA_MEAN_NORMALIZATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/feature_statistics.hpp>
+
+#include "scale_columns.hpp"
 
 namespace mlpack {
 namespace data {
@@ -54,9 +57,22 @@ class MeanNormalization
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMean = arma::mean(input, 1);
-    itemMin = arma::min(input, 1);
-    itemMax = arma::max(input, 1);
+    FeatureStatistics statistics;
+    statistics.Update(input);
+    Fit(statistics);
+  }
+
+  /**
+   * Function to fit features from statistics of the dataset, which can be
+   * accumulated one chunk at a time (see FeatureStatistics).
+   *
+   * @param statistics Statistics of the dataset to fit.
+   */
+  void Fit(const FeatureStatistics& statistics)
+  {
+    itemMean = statistics.Mean();
+    itemMin = statistics.Min();
+    itemMax = statistics.Max();
     scale = itemMax - itemMin;
     // Handling zeros in scale vector.
     scale.for_each([](arma::vec::elem_type& val) { val =
@@ -77,8 +93,19 @@ class MeanNormalization
       throw std::runtime_error("Call Fit() before Transform(), please"
         " refer to the documentation.");
     }
-    output.copy_size(input);
-    output = (input.each_col() - itemMean).each_col() / scale;
+    ScaleColumns(input, output, itemMean, 1.0 / scale,
+        arma::zeros<arma::vec>(scale.n_elem));
+  }
+
+  /**
+   * Function to scale features in place, without allocating another matrix.
+   *
+   * @param data Dataset to scale; it is overwritten.
+   */
+  template<typename MatType>
+  void Transform(MatType& data)
+  {
+    Transform(data, data);
   }
 
   /**
@@ -90,8 +117,19 @@ class MeanNormalization
   template<typename MatType>
   void InverseTransform(const MatType& input, MatType& output)
   {
-    output.copy_size(input);
-    output = (input.each_col() % scale).each_col() + itemMean;
+    ScaleColumns(input, output, arma::zeros<arma::vec>(scale.n_elem), scale,
+        itemMean);
+  }
+
+  /**
+   * Function to retrieve the original dataset in place.
+   *
+   * @param data Scaled dataset; it is overwritten.
+   */
+  template<typename MatType>
+  void InverseTransform(MatType& data)
+  {
+    InverseTransform(data, data);
   }
 
   //! Get the Mean row vector.
@@ -13,6 +13,9 @@
 #define MLPACK_CORE_DATA_SCALE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/feature_statistics.hpp>
+
+#include "scale_columns.hpp"
 
 namespace mlpack {
 namespace data {
@@ -73,8 +76,21 @@ class MinMaxScaler
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMin = arma::min(input, 1);
-    itemMax = arma::max(input, 1);
+    FeatureStatistics statistics;
+    statistics.Update(input);
+    Fit(statistics);
+  }
+
+  /**
+   * Function to fit features from statistics of the dataset, which can be
+   * accumulated one chunk at a time (see FeatureStatistics).
+   *
+   * @param statistics Statistics of the dataset to fit.
+   */
+  void Fit(const FeatureStatistics& statistics)
+  {
+    itemMin = statistics.Min();
+    itemMax = statistics.Max();
     scale = itemMax - itemMin;
     // Handle zeros in scale vector.
     scale.for_each([](arma::vec::elem_type& val) { val =
@@ -99,8 +115,19 @@ class MinMaxScaler
       throw std::runtime_error("Call Fit() before Transform(), please"
           " refer to the documentation.");
     }
-    output.copy_size(input);
-    output = (input.each_col() % scale).each_col() + scalerowmin;
+    ScaleColumns(input, output, arma::zeros<arma::vec>(scale.n_elem), scale,
+        scalerowmin);
+  }
+
+  /**
+   * Function to scale features in place, without allocating another matrix.
+   *
+   * @param data Dataset to scale; it is overwritten.
+   */
+  template<typename MatType>
+  void Transform(MatType& data)
+  {
+    Transform(data, data);
   }
 
   /**
@@ -112,8 +139,19 @@ class MinMaxScaler
   template<typename MatType>
   void InverseTransform(const MatType& input, MatType& output)
   {
-    output.copy_size(input);
-    output = (input.each_col() - scalerowmin).each_col() / scale;
+    ScaleColumns(input, output, scalerowmin, 1.0 / scale,
+        arma::zeros<arma::vec>(scale.n_elem));
+  }
+
+  /**
+   * Function to retrieve the original dataset in place.
+   *
+   * @param data Scaled dataset; it is overwritten.
+   */
+  template<typename MatType>
+  void InverseTransform(MatType& data)
+  {
+    InverseTransform(data, data);
   }
 
   //! Get the Min row vector.
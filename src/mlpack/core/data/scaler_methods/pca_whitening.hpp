@@ -16,6 +16,8 @@
 #include <mlpack/core/math/lin_alg.hpp>
 #include <mlpack/core/math/ccov.hpp>
 
+#include "scale_columns.hpp"
+
 namespace mlpack {
 namespace data {
 
@@ -91,10 +93,23 @@ class PCAWhitening
       throw std::runtime_error("Call Fit() before Transform(), please"
           " refer to the documentation.");
     }
-    output.copy_size(input);
-    output = (input.each_col() - itemMean);
-    output = arma::diagmat(1.0 / (arma::sqrt(eigenValues))) * eigenVectors.t()
-        * output;
+    // Centering is folded into the offset, so each block of points is
+    // whitened with one matrix product.
+    const arma::mat whitening = arma::diagmat(1.0 / arma::sqrt(eigenValues)) *
+        eigenVectors.t();
+    TransformColumns(input, output, whitening, -whitening * itemMean);
+  }
+
+  /**
+   * Function for PCA whitening in place.  The points are whitened one block at
+   * a time, so the only extra memory is a buffer of one block.
+   *
+   * @param data Dataset to whiten; it is overwritten.
+   */
+  template<typename MatType>
+  void Transform(MatType& data)
+  {
+    Transform(data, data);
   }
 
   /**
@@ -106,9 +121,19 @@ class PCAWhitening
   template<typename MatType>
   void InverseTransform(const MatType& input, MatType& output)
   {
-    output = arma::diagmat(arma::sqrt(eigenValues)) * inv(eigenVectors.t())
-        * input;
-    output = (output.each_col() + itemMean);
+    TransformColumns(input, output, inv(eigenVectors.t()) *
+        arma::diagmat(arma::sqrt(eigenValues)), itemMean);
+  }
+
+  /**
+   * Function to retrieve the original dataset in place.
+   *
+   * @param data Whitened dataset; it is overwritten.
+   */
+  template<typename MatType>
+  void InverseTransform(MatType& data)
+  {
+    InverseTransform(data, data);
   }
 
   //! Get the mean row vector.
@@ -0,0 +1,130 @@
+/**
+ * @file core/data/scaler_methods/scale_columns.hpp
+ *
+ * Fused kernels used by the scalers to transform a dataset in a single pass,
+ * possibly in place.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SCALER_METHODS_SCALE_COLUMNS_HPP
+#define MLPACK_CORE_DATA_SCALER_METHODS_SCALE_COLUMNS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Compute output(d, i) = (input(d, i) - shift[d]) * scale[d] + offset[d] for
+ * every point, in one parallel pass over the points.  input and output may be
+ * the same matrix, in which case no memory is allocated.
+ *
+ * @param input Dataset to transform, one point per column.
+ * @param output Matrix to store the transformed dataset in.
+ * @param shift Value subtracted from each dimension.
+ * @param scale Factor each (shifted) dimension is multiplied by.
+ * @param offset Value added to each (scaled) dimension.
+ */
+template<typename MatType>
+void ScaleColumns(const MatType& input,
+                  MatType& output,
+                  const arma::vec& shift,
+                  const arma::vec& scale,
+                  const arma::vec& offset)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  // This does nothing if output is input.
+  output.set_size(input.n_rows, input.n_cols);
+
+  const size_t dimensionality = input.n_rows;
+  const double* shiftPtr = shift.memptr();
+  const double* scalePtr = scale.memptr();
+  const double* offsetPtr = offset.memptr();
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+  {
+    const ElemType* in = input.colptr(i);
+    ElemType* out = output.colptr(i);
+    for (size_t d = 0; d < dimensionality; ++d)
+    {
+      out[d] = ElemType((in[d] - shiftPtr[d]) * scalePtr[d] + offsetPtr[d]);
+    }
+  }
+}
+
+/**
+ * Compute output = transformation * input + offset (offset being added to
+ * each column), one block of blockSize points at a time.  Each block is
+ * multiplied with a single matrix product, written directly into output; if
+ * input and output are the same matrix, the product goes to a preallocated
+ * buffer of one block and is then copied back, so the extra memory is that
+ * of one block instead of that of the whole dataset.  In that case the
+ * transformation has to be square.
+ *
+ * @param input Dataset to transform, one point per column.
+ * @param output Matrix to store the transformed dataset in.
+ * @param transformation Matrix to multiply each point by.
+ * @param offset Vector to add to each transformed point.
+ * @param blockSize Number of points to transform at once.
+ */
+template<typename MatType>
+void TransformColumns(const MatType& input,
+                      MatType& output,
+                      const arma::mat& transformation,
+                      const arma::vec& offset,
+                      const size_t blockSize = 4096)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  if (transformation.n_cols != input.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "TransformColumns(): the transformation has "
+        << transformation.n_cols << " columns, but the dataset has "
+        << input.n_rows << " dimensions";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const bool inPlace = (&input == &output);
+  if (inPlace && transformation.n_rows != input.n_rows)
+  {
+    throw std::invalid_argument("TransformColumns(): an in-place "
+        "transformation must be square");
+  }
+
+  const size_t numPoints = input.n_cols;
+  if (!inPlace)
+    output.set_size(transformation.n_rows, numPoints);
+
+  arma::Mat<ElemType> buffer;
+  if (inPlace)
+    buffer.set_size(transformation.n_rows, std::min(blockSize, numPoints));
+
+  for (size_t begin = 0; begin < numPoints; begin += blockSize)
+  {
+    const size_t blockPoints = std::min(blockSize, numPoints - begin);
+
+    // Alias the block of points and its destination, so that the product is
+    // computed without temporaries.
+    const arma::Mat<ElemType> block(const_cast<ElemType*>(input.colptr(begin)),
+        input.n_rows, blockPoints, false, true);
+    arma::Mat<ElemType> result(inPlace ? buffer.memptr() :
+        output.colptr(begin), transformation.n_rows, blockPoints, false, true);
+
+    result = transformation * block;
+    result.each_col() += offset;
+
+    if (inPlace)
+      std::copy(result.begin(), result.end(), output.colptr(begin));
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -13,6 +13,9 @@
 #define MLPACK_CORE_DATA_STANDARD_SCALE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/feature_statistics.hpp>
+
+#include "scale_columns.hpp"
 
 namespace mlpack {
 namespace data {
@@ -55,8 +58,21 @@ class StandardScaler
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMean = arma::mean(input, 1);
-    itemStdDev = arma::stddev(input, 1, 1);
+    FeatureStatistics statistics;
+    statistics.Update(input);
+    Fit(statistics);
+  }
+
+  /**
+   * Function to fit features from statistics of the dataset, which can be
+   * accumulated one chunk at a time (see FeatureStatistics).
+   *
+   * @param statistics Statistics of the dataset to fit.
+   */
+  void Fit(const FeatureStatistics& statistics)
+  {
+    itemMean = statistics.Mean();
+    itemStdDev = statistics.StdDev(true);
     // Handle zeros in scale vector.
     itemStdDev.for_each([](arma::vec::elem_type& val) { val =
         (val == 0) ? 1 : val; });
@@ -76,8 +92,19 @@ class StandardScaler
       throw std::runtime_error("Call Fit() before Transform(), please"
         " refer to the documentation.");
     }
-    output.copy_size(input);
-    output = (input.each_col() - itemMean).each_col() / itemStdDev;
+    ScaleColumns(input, output, itemMean, 1.0 / itemStdDev,
+        arma::zeros<arma::vec>(itemMean.n_elem));
+  }
+
+  /**
+   * Function to scale features in place, without allocating another matrix.
+   *
+   * @param data Dataset to scale; it is overwritten.
+   */
+  template<typename MatType>
+  void Transform(MatType& data)
+  {
+    Transform(data, data);
   }
 
   /**
@@ -89,8 +116,19 @@ class StandardScaler
   template<typename MatType>
   void InverseTransform(const MatType& input, MatType& output)
   {
-    output.copy_size(input);
-    output = (input.each_col() % itemStdDev).each_col() + itemMean;
+    ScaleColumns(input, output, arma::zeros<arma::vec>(itemMean.n_elem),
+        itemStdDev, itemMean);
+  }
+
+  /**
+   * Function to retrieve the original dataset in place.
+   *
+   * @param data Scaled dataset; it is overwritten.
+   */
+  template<typename MatType>
+  void InverseTransform(MatType& data)
+  {
+    InverseTransform(data, data);
   }
 
   //! Get the mean row vector.
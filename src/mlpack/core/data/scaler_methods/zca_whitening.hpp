@@ -74,8 +74,30 @@ class ZCAWhitening
   template<typename MatType>
   void Transform(const MatType& input, MatType& output)
   {
-    pca.Transform(input, output);
-    output = pca.EigenVectors() * output;
+    if (pca.EigenValues().is_empty() || pca.EigenVectors().is_empty())
+    {
+      throw std::runtime_error("Call Fit() before Transform(), please"
+          " refer to the documentation.");
+    }
+
+    // Rotating back is folded into the PCA whitening matrix, so each block of
+    // points is whitened with one matrix product.
+    const arma::mat whitening = pca.EigenVectors() *
+        arma::diagmat(1.0 / arma::sqrt(pca.EigenValues())) *
+        pca.EigenVectors().t();
+    TransformColumns(input, output, whitening, -whitening * pca.ItemMean());
+  }
+
+  /**
+   * Function for ZCA whitening in place.  The points are whitened one block at
+   * a time, so the only extra memory is a buffer of one block.
+   *
+   * @param data Dataset to whiten; it is overwritten.
+   */
+  template<typename MatType>
+  void Transform(MatType& data)
+  {
+    Transform(data, data);
   }
 
   /**
@@ -87,9 +109,20 @@ class ZCAWhitening
   template<typename MatType>
   void InverseTransform(const MatType& input, MatType& output)
   {
-    output = inv(pca.EigenVectors()) * arma::diagmat(arma::sqrt(
-        pca.EigenValues())) * inv(pca.EigenVectors().t()) * input;
-    output = (output.each_col() + pca.ItemMean());
+    TransformColumns(input, output, inv(pca.EigenVectors().t()) *
+        arma::diagmat(arma::sqrt(pca.EigenValues())) *
+        inv(pca.EigenVectors()), pca.ItemMean());
+  }
+
+  /**
+   * Function to retrieve the original dataset in place.
+   *
+   * @param data Whitened dataset; it is overwritten.
+   */
+  template<typename MatType>
+  void InverseTransform(MatType& data)
+  {
+    InverseTransform(data, data);
   }
 
   //! Get the mean row vector.
@@ -0,0 +1,124 @@
+/**
+ * @file core/data/sparse_loader.hpp
+ *
+ * Definition of SparseLoader, a parallel reader for sparse text formats.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SPARSE_LOADER_HPP
+#define MLPACK_CORE_DATA_SPARSE_LOADER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "load_csv.hpp"
+#include "mapped_file.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * SparseLoader parses sparse matrices from memory-mapped text files.  Like
+ * LoadCSV, the file is split into chunks of whole lines that are parsed in
+ * parallel, and the nonzero elements of each chunk are then copied into the
+ * sparse matrix at their final positions, so that no text is parsed twice and
+ * no temporary copy of the file is made.  Two formats are supported:
+ *
+ *  - the libsvm (or svmlight) format, where each line is one point of the form
+ *    "label index:value index:value ...", with 1-based feature indices.  A
+ *    "qid:" field after the label is ignored, as is anything after a '#'.
+ *    Points become the columns of the matrix, so no transposition is needed,
+ *    and the matrix is assembled directly in compressed sparse column form.
+ *  - the coordinate format written and read by Armadillo (arma::coord_ascii),
+ *    where each line is "row column value", with 0-based indices.
+ *
+ * Errors are reported by throwing a std::runtime_error.
+ */
+class SparseLoader
+{
+ public:
+  /**
+   * Load a sparse matrix and its labels from the given file in libsvm format.
+   * The number of rows of the matrix is the largest feature index in the file.
+   *
+   * @param file Mapped file to parse.
+   * @param matrix Matrix to store the points in, one point per column.
+   * @param labels Row vector to store the label of each point in.
+   */
+  template<typename eT>
+  static void LibSVM(const MappedFile& file,
+                     arma::SpMat<eT>& matrix,
+                     arma::rowvec& labels);
+
+  /**
+   * Load a sparse matrix from the given file in coordinate format.  The size
+   * of the matrix is given by the largest row and column indices in the file.
+   * Elements that appear more than once are summed.
+   *
+   * @param file Mapped file to parse.
+   * @param matrix Matrix to store the elements in.
+   * @param transpose Whether to transpose the matrix (that is, to read each
+   *     line as "column row value").
+   */
+  template<typename eT>
+  static void Coordinates(const MappedFile& file,
+                          arma::SpMat<eT>& matrix,
+                          const bool transpose);
+
+ private:
+  /**
+   * Call f(begin, end) for each field of the given line, where fields are
+   * separated by runs of spaces or tabs.
+   */
+  template<typename FunctionType>
+  static void ForEachField(const char* begin,
+                           const char* end,
+                           FunctionType&& f)
+  {
+    while (begin != end)
+    {
+      while (begin != end && (*begin == ' ' || *begin == '\t'))
+        ++begin;
+
+      const char* fieldEnd = begin;
+      while (fieldEnd != end && *fieldEnd != ' ' && *fieldEnd != '\t')
+        ++fieldEnd;
+
+      if (begin != fieldEnd)
+        f(begin, fieldEnd);
+      begin = fieldEnd;
+    }
+  }
+
+  //! Parse an unsigned decimal integer; return false if it is not one.
+  static bool ParseIndex(const char* begin, const char* end, size_t& index)
+  {
+    if (begin == end || end - begin > 18)
+      return false;
+
+    index = 0;
+    for (; begin != end; ++begin)
+    {
+      if (*begin < '0' || *begin > '9')
+        return false;
+      index = 10 * index + (*begin - '0');
+    }
+
+    return true;
+  }
+
+  //! Throw the first of the errors of the chunks, if there is one.
+  static void CheckErrors(const MappedFile& file,
+                          const std::vector<std::string>& errors,
+                          const std::vector<size_t>& errorLines);
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "sparse_loader_impl.hpp"
+
+#endif
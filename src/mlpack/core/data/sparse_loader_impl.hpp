@@ -0,0 +1,288 @@
+/**
+ * @file core/data/sparse_loader_impl.hpp
+ *
+ * Implementation of SparseLoader.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SPARSE_LOADER_IMPL_HPP
+#define MLPACK_CORE_DATA_SPARSE_LOADER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sparse_loader.hpp"
+
+namespace mlpack {
+namespace data {
+
+template<typename eT>
+void SparseLoader::LibSVM(const MappedFile& file,
+                          arma::SpMat<eT>& matrix,
+                          arma::rowvec& labels)
+{
+  std::vector<LoadCSV::Chunk> chunks;
+  const size_t numLines = LoadCSV::SplitChunks(file, chunks);
+
+  // Each chunk collects the row indices and values of its points, in order;
+  // the number of nonzero elements of each point gives the column pointers.
+  std::vector<std::vector<arma::uword>> rowIndices(chunks.size());
+  std::vector<std::vector<eT>> values(chunks.size());
+  std::vector<size_t> maxIndex(chunks.size(), 0);
+  std::vector<std::string> errors(chunks.size());
+  std::vector<size_t> errorLines(chunks.size(), 0);
+  arma::uvec colPtrs(numLines + 1);
+  colPtrs[0] = 0;
+  labels.set_size(numLines);
+
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (omp_size_t c = 0; c < (omp_size_t) chunks.size(); ++c)
+  {
+    std::vector<std::pair<arma::uword, eT>> unsorted;
+    LoadCSV::ForEachLine(chunks[c], [&](const size_t line, const char* begin,
+        const char* end)
+    {
+      if (!errors[c].empty())
+        return;
+
+      const char* comment = (const char*) std::memchr(begin, '#', end - begin);
+      if (comment)
+      {
+        end = comment;
+        LoadCSV::Trim(begin, end);
+      }
+
+      const size_t start = rowIndices[c].size();
+      bool first = true;
+      bool sorted = true;
+      ForEachField(begin, end, [&](const char* fieldBegin,
+          const char* fieldEnd)
+      {
+        if (!errors[c].empty())
+          return;
+
+        double value;
+        if (first)
+        {
+          first = false;
+          if (!LoadCSV::ParseDouble(fieldBegin, fieldEnd, value))
+          {
+            errors[c] = "cannot parse label '" + std::string(fieldBegin,
+                fieldEnd) + "'";
+            return;
+          }
+
+          labels[line] = value;
+          return;
+        }
+
+        const char* colon = (const char*) std::memchr(fieldBegin, ':',
+            fieldEnd - fieldBegin);
+        if (colon && colon - fieldBegin == 3 &&
+            std::memcmp(fieldBegin, "qid", 3) == 0)
+          return;
+
+        size_t index;
+        if (!colon || !ParseIndex(fieldBegin, colon, index) || index == 0 ||
+            !LoadCSV::ParseDouble(colon + 1, fieldEnd, value))
+        {
+          errors[c] = "cannot parse feature '" + std::string(fieldBegin,
+              fieldEnd) + "'";
+          return;
+        }
+
+        // Zeros are not stored in a sparse matrix.
+        if (value == 0.0)
+          return;
+
+        if (rowIndices[c].size() > start && index - 1 <= rowIndices[c].back())
+          sorted = false;
+        rowIndices[c].push_back(index - 1);
+        values[c].push_back((eT) value);
+        maxIndex[c] = std::max(maxIndex[c], index);
+      });
+
+      if (errors[c].empty() && first)
+        errors[c] = "missing label";
+
+      if (!errors[c].empty())
+      {
+        errorLines[c] = line;
+        return;
+      }
+
+      // Features are almost always given in increasing order, but the format
+      // does not require it.
+      if (!sorted)
+      {
+        unsorted.clear();
+        for (size_t i = start; i < rowIndices[c].size(); ++i)
+          unsorted.push_back(std::make_pair(rowIndices[c][i], values[c][i]));
+        std::sort(unsorted.begin(), unsorted.end(),
+            [](const std::pair<arma::uword, eT>& a,
+               const std::pair<arma::uword, eT>& b)
+            { return a.first < b.first; });
+
+        for (size_t i = 0; i < unsorted.size(); ++i)
+        {
+          if (i > 0 && unsorted[i].first == unsorted[i - 1].first)
+          {
+            std::ostringstream oss;
+            oss << "feature " << (unsorted[i].first + 1) << " is given more "
+                << "than once";
+            errors[c] = oss.str();
+            errorLines[c] = line;
+            return;
+          }
+
+          rowIndices[c][start + i] = unsorted[i].first;
+          values[c][start + i] = unsorted[i].second;
+        }
+      }
+
+      colPtrs[line + 1] = rowIndices[c].size() - start;
+    });
+  }
+
+  CheckErrors(file, errors, errorLines);
+
+  // Turn the counts into column pointers; each chunk starts at the column
+  // pointer of its first line.
+  for (size_t i = 1; i <= numLines; ++i)
+    colPtrs[i] += colPtrs[i - 1];
+
+  arma::uvec rowIndicesVec(colPtrs[numLines]);
+  arma::Col<eT> valuesVec(colPtrs[numLines]);
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t c = 0; c < (omp_size_t) chunks.size(); ++c)
+  {
+    const size_t offset = colPtrs[chunks[c].firstLine];
+    std::copy(rowIndices[c].begin(), rowIndices[c].end(),
+        rowIndicesVec.begin() + offset);
+    std::copy(values[c].begin(), values[c].end(),
+        valuesVec.begin() + offset);
+  }
+
+  size_t rows = 0;
+  for (size_t c = 0; c < chunks.size(); ++c)
+    rows = std::max(rows, maxIndex[c]);
+  matrix = arma::SpMat<eT>(rowIndicesVec, colPtrs, valuesVec, rows, numLines);
+}
+
+template<typename eT>
+void SparseLoader::Coordinates(const MappedFile& file,
+                               arma::SpMat<eT>& matrix,
+                               const bool transpose)
+{
+  std::vector<LoadCSV::Chunk> chunks;
+  LoadCSV::SplitChunks(file, chunks);
+
+  std::vector<std::vector<arma::uword>> locations(chunks.size());
+  std::vector<std::vector<eT>> values(chunks.size());
+  std::vector<arma::uword> maxRow(chunks.size(), 0);
+  std::vector<arma::uword> maxCol(chunks.size(), 0);
+  std::vector<char> empty(chunks.size(), 1);
+  std::vector<std::string> errors(chunks.size());
+  std::vector<size_t> errorLines(chunks.size(), 0);
+
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (omp_size_t c = 0; c < (omp_size_t) chunks.size(); ++c)
+  {
+    LoadCSV::ForEachLine(chunks[c], [&](const size_t line, const char* begin,
+        const char* end)
+    {
+      if (!errors[c].empty() || begin == end)
+        return;
+
+      const char* fields[6];
+      size_t numFields = 0;
+      ForEachField(begin, end, [&](const char* fieldBegin,
+          const char* fieldEnd)
+      {
+        if (numFields < 3)
+        {
+          fields[2 * numFields] = fieldBegin;
+          fields[2 * numFields + 1] = fieldEnd;
+        }
+        ++numFields;
+      });
+
+      size_t row, col;
+      double value;
+      if (numFields != 3 || !ParseIndex(fields[0], fields[1], row) ||
+          !ParseIndex(fields[2], fields[3], col) ||
+          !LoadCSV::ParseDouble(fields[4], fields[5], value))
+      {
+        errors[c] = "expected 'row column value', got '" +
+            std::string(begin, end) + "'";
+        errorLines[c] = line;
+        return;
+      }
+
+      if (transpose)
+        std::swap(row, col);
+
+      // An explicit zero still determines the size of the matrix.
+      empty[c] = 0;
+      maxRow[c] = std::max(maxRow[c], (arma::uword) row);
+      maxCol[c] = std::max(maxCol[c], (arma::uword) col);
+      if (value != 0.0)
+      {
+        locations[c].push_back(row);
+        locations[c].push_back(col);
+        values[c].push_back((eT) value);
+      }
+    });
+  }
+
+  CheckErrors(file, errors, errorLines);
+
+  size_t rows = 0, cols = 0, nonZeros = 0;
+  std::vector<size_t> offsets(chunks.size(), 0);
+  for (size_t c = 0; c < chunks.size(); ++c)
+  {
+    offsets[c] = nonZeros;
+    nonZeros += values[c].size();
+    if (!empty[c])
+    {
+      rows = std::max(rows, (size_t) maxRow[c] + 1);
+      cols = std::max(cols, (size_t) maxCol[c] + 1);
+    }
+  }
+
+  arma::umat locationsMat(2, nonZeros);
+  arma::Col<eT> valuesVec(nonZeros);
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t c = 0; c < (omp_size_t) chunks.size(); ++c)
+  {
+    std::copy(locations[c].begin(), locations[c].end(),
+        locationsMat.begin() + 2 * offsets[c]);
+    std::copy(values[c].begin(), values[c].end(),
+        valuesVec.begin() + offsets[c]);
+  }
+
+  // The batch constructor sorts the elements by column and sums duplicates.
+  matrix = arma::SpMat<eT>(true, locationsMat, valuesVec, rows, cols);
+}
+
+inline void SparseLoader::CheckErrors(const MappedFile& file,
+                                      const std::vector<std::string>& errors,
+                                      const std::vector<size_t>& errorLines)
+{
+  for (size_t c = 0; c < errors.size(); ++c)
+  {
+    if (!errors[c].empty())
+    {
+      std::ostringstream oss;
+      oss << "SparseLoader: " << errors[c] << " on line " << errorLines[c]
+          << " of '" << file.Filename() << "'";
+      throw std::runtime_error(oss.str());
+    }
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -63,51 +63,111 @@ void SplitHelper(const InputType& input,
 }
 
 /**
- * Given an input dataset and labels, stratify into a training set and test set.
- * It is recommended to have the input labels between the range [0, n) where n
- * is the number of different labels. The NormalizeLabels() function in
- * mlpack::data can be used for this.
- * Expects labels to be of type arma::Row<> or arma::Col<>.
- * Throws a runtime error if this is not the case.
- * Example usage below. This overload places the stratified dataset into the
- * four output parameters given (trainData, testData, trainLabel,
- * and testLabel).
+ * Permute the columns of the given matrix (or row) in place, so that column i
+ * of the result is column order[i] of the original matrix.  Only one column
+ * is copied to temporary memory at a time.
  *
- * @code
- * arma::mat input = loadData();
- * arma::Row<size_t> label = loadLabel();
- * arma::mat trainData;
- * arma::mat testData;
- * arma::Row<size_t> trainLabel;
- * arma::Row<size_t> testLabel;
- * math::RandomSeed(100); // Set the seed if you like.
+ * @param m Matrix to permute.
+ * @param order Permutation of the indices of the columns of m.
+ */
+template<typename T>
+void PermuteColumns(arma::Mat<T>& m, const arma::uvec& order)
+{
+  if (order.n_elem != m.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "data::PermuteColumns(): the permutation has " << order.n_elem
+        << " elements, but the matrix has " << m.n_cols << " columns";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Follow each cycle of the permutation, holding the first column of the
+  // cycle aside.
+  std::vector<bool> placed(m.n_cols, false);
+  arma::Col<T> first(m.n_rows);
+  for (size_t start = 0; start < m.n_cols; ++start)
+  {
+    if (placed[start] || order[start] == start)
+      continue;
+
+    std::copy(m.colptr(start), m.colptr(start) + m.n_rows, first.memptr());
+    size_t i = start;
+    while (order[i] != start)
+    {
+      std::copy(m.colptr(order[i]), m.colptr(order[i]) + m.n_rows,
+          m.colptr(i));
+      placed[i] = true;
+      i = order[i];
+    }
+    std::copy(first.memptr(), first.memptr() + m.n_rows, m.colptr(i));
+    placed[i] = true;
+  }
+}
+
+/**
+ * Split the indices of a dataset with the given number of points into a
+ * training set and a test set, in the same way as Split() splits the points
+ * (for the same random seed).  No data is copied, so this can be used to
+ * split datasets that cannot be copied; for instance, the indices can be
+ * given to PermuteColumns(), or to arma::Mat::cols() to extract a subset.
  *
- * // Stratify the dataset into a training and test set, with 30% of the data
- * // being held out for the test set.
- * StratifiedSplit(input, label, trainData,
- *                 testData, trainLabel, testLabel, 0.3);
+ * @code
+ * arma::uvec trainIndices, testIndices;
+ * SplitIndices(input.n_cols, trainIndices, testIndices, 0.3);
  * @endcode
  *
- * @param input Input dataset to stratify.
- * @param inputLabel Input labels to stratify.
- * @param trainData Matrix to store training data into.
- * @param testData Matrix to store test data into.
- * @param trainLabel Vector to store training labels into.
- * @param testLabel Vector to store test labels into.
+ * @param numPoints Number of points in the dataset.
+ * @param trainIndices Vector to store the indices of the training points into.
+ * @param testIndices Vector to store the indices of the test points into.
  * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
  * @param shuffleData If true, the sample order is shuffled; otherwise, each
  *     sample is visited in linear order. (Default true.)
  */
-template<typename T, typename LabelsType,
+inline void SplitIndices(const size_t numPoints,
+                         arma::uvec& trainIndices,
+                         arma::uvec& testIndices,
+                         const double testRatio,
+                         const bool shuffleData = true)
+{
+  if (numPoints == 0)
+  {
+    trainIndices.reset();
+    testIndices.reset();
+    return;
+  }
+
+  const size_t testSize = static_cast<size_t>(numPoints * testRatio);
+  const size_t trainSize = numPoints - testSize;
+
+  arma::uvec order = arma::linspace<arma::uvec>(0, numPoints - 1, numPoints);
+  if (shuffleData)
+    order = arma::shuffle(order);
+
+  trainIndices = order.head(trainSize);
+  testIndices = order.tail(testSize);
+}
+
+/**
+ * Split the indices of a dataset into a training set and a test set,
+ * stratified by the given labels, in the same way as StratifiedSplit() splits
+ * the points (for the same random seed).  No data is copied.  Expects labels
+ * to be of type arma::Row<> or arma::Col<>; throws a runtime error if this is
+ * not the case.
+ *
+ * @param inputLabel Labels of the points to stratify by.
+ * @param trainIndices Vector to store the indices of the training points into.
+ * @param testIndices Vector to store the indices of the test points into.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *     sample is visited in linear order. (Default true.)
+ */
+template<typename LabelsType,
          typename = std::enable_if_t<arma::is_arma_type<LabelsType>::value> >
-void StratifiedSplit(const arma::Mat<T>& input,
-                     const LabelsType& inputLabel,
-                     arma::Mat<T>& trainData,
-                     arma::Mat<T>& testData,
-                     LabelsType& trainLabel,
-                     LabelsType& testLabel,
-                     const double testRatio,
-                     const bool shuffleData = true)
+void StratifiedSplitIndices(const LabelsType& inputLabel,
+                            arma::uvec& trainIndices,
+                            arma::uvec& testIndices,
+                            const double testRatio,
+                            const bool shuffleData = true)
 {
   /**
    * Basic idea:
@@ -147,7 +207,6 @@ void StratifiedSplit(const arma::Mat<T>& input,
   if (!typeCheck)
     throw std::runtime_error("data::Split(): when stratified sampling is done, "
         "labels must have type `arma::Row<>`!");
-  util::CheckSameSizes(input, inputLabel, "data::Split()");
   size_t trainIdx = 0;
   size_t testIdx = 0;
   size_t trainSize = 0;
@@ -168,56 +227,92 @@ void StratifiedSplit(const arma::Mat<T>& input,
     trainSize += labelCount - floor(labelCount * testRatio);
   }
 
-  trainData.set_size(input.n_rows, trainSize);
-  testData.set_size(input.n_rows, testSize);
-  trainLabel.set_size(inputLabel.n_rows, trainSize);
-  testLabel.set_size(inputLabel.n_rows, testSize);
+  trainIndices.set_size(trainSize);
+  testIndices.set_size(testSize);
 
+  arma::uvec order = arma::linspace<arma::uvec>(0, inputLabel.n_elem - 1,
+      inputLabel.n_elem);
   if (shuffleData)
-  {
-    arma::uvec order = arma::shuffle(
-        arma::linspace<arma::uvec>(0, input.n_cols - 1, input.n_cols));
+    order = arma::shuffle(order);
 
-    for (arma::uword i : order)
+  for (arma::uword i : order)
+  {
+    typename LabelsType::elem_type label = inputLabel[i];
+    if (testLabelCounts[label] < floor(labelCounts[label] * testRatio))
     {
-      typename LabelsType::elem_type label = inputLabel[i];
-      if (testLabelCounts[label] < floor(labelCounts[label] * testRatio))
-      {
-        testLabelCounts[label] += 1;
-        testData.col(testIdx) = input.col(i);
-        testLabel[testIdx] = inputLabel[i];
-        testIdx += 1;
-      }
-      else
-      {
-        trainData.col(trainIdx) = input.col(i);
-        trainLabel[trainIdx] = inputLabel[i];
-        trainIdx += 1;
-      }
+      testLabelCounts[label] += 1;
+      testIndices[testIdx++] = i;
     }
-  }
-  else
-  {
-    for (arma::uword i = 0; i < input.n_cols; i++)
+    else
     {
-      typename LabelsType::elem_type label = inputLabel[i];
-      if (testLabelCounts[label] < floor(labelCounts[label] * testRatio))
-      {
-        testLabelCounts[label] += 1;
-        testData.col(testIdx) = input.col(i);
-        testLabel[testIdx] = inputLabel[i];
-        testIdx += 1;
-      }
-      else
-      {
-        trainData.col(trainIdx) = input.col(i);
-        trainLabel[trainIdx] = inputLabel[i];
-        trainIdx += 1;
-      }
+      trainIndices[trainIdx++] = i;
     }
   }
 }
 
+/**
+ * Given an input dataset and labels, stratify into a training set and test set.
+ * It is recommended to have the input labels between the range [0, n) where n
+ * is the number of different labels. The NormalizeLabels() function in
+ * mlpack::data can be used for this.
+ * Expects labels to be of type arma::Row<> or arma::Col<>.
+ * Throws a runtime error if this is not the case.
+ * Example usage below. This overload places the stratified dataset into the
+ * four output parameters given (trainData, testData, trainLabel,
+ * and testLabel).
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::Row<size_t> label = loadLabel();
+ * arma::mat trainData;
+ * arma::mat testData;
+ * arma::Row<size_t> trainLabel;
+ * arma::Row<size_t> testLabel;
+ * math::RandomSeed(100); // Set the seed if you like.
+ *
+ * // Stratify the dataset into a training and test set, with 30% of the data
+ * // being held out for the test set.
+ * StratifiedSplit(input, label, trainData,
+ *                 testData, trainLabel, testLabel, 0.3);
+ * @endcode
+ *
+ * @param input Input dataset to stratify.
+ * @param inputLabel Input labels to stratify.
+ * @param trainData Matrix to store training data into.
+ * @param testData Matrix to store test data into.
+ * @param trainLabel Vector to store training labels into.
+ * @param testLabel Vector to store test labels into.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *     sample is visited in linear order. (Default true.)
+ */
+template<typename T, typename LabelsType,
+         typename = std::enable_if_t<arma::is_arma_type<LabelsType>::value> >
+void StratifiedSplit(const arma::Mat<T>& input,
+                     const LabelsType& inputLabel,
+                     arma::Mat<T>& trainData,
+                     arma::Mat<T>& testData,
+                     LabelsType& trainLabel,
+                     LabelsType& testLabel,
+                     const double testRatio,
+                     const bool shuffleData = true)
+{
+  util::CheckSameSizes(input, inputLabel, "data::Split()");
+
+  arma::uvec trainIndices, testIndices;
+  StratifiedSplitIndices(inputLabel, trainIndices, testIndices, testRatio,
+      shuffleData);
+
+  trainData = input.cols(trainIndices);
+  testData = input.cols(testIndices);
+  trainLabel.set_size(inputLabel.n_rows, trainIndices.n_elem);
+  testLabel.set_size(inputLabel.n_rows, testIndices.n_elem);
+  for (size_t i = 0; i < trainIndices.n_elem; ++i)
+    trainLabel[i] = inputLabel[trainIndices[i]];
+  for (size_t i = 0; i < testIndices.n_elem; ++i)
+    testLabel[i] = inputLabel[testIndices[i]];
+}
+
 /**
  * Given an input dataset and labels, split into a training set and test set.
  * Example usage below.  This overload places the split dataset into the four
@@ -613,6 +708,109 @@ Split(const FieldType& input,
                          std::move(testData));
 }
 
+/**
+ * Split the given dataset into a training set and a test set without copying
+ * it: the points are reordered in place so that the training points come
+ * first, and trainData and testData are made aliases of the two parts of
+ * input.  So, splitting a dataset only takes the memory of one point, but
+ * input must not be modified or destroyed while trainData and testData are in
+ * use (math::ClearAlias() can be used to release them).  The split is the same as the one of Split() (for the same random
+ * seed).
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::mat trainData, testData;
+ * SplitInPlace(input, trainData, testData, 0.3);
+ * @endcode
+ *
+ * @param input Input dataset to split; its points are reordered.
+ * @param trainData Matrix to make an alias of the training data.
+ * @param testData Matrix to make an alias of the test data.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *     sample is visited in linear order. (Default true.)
+ */
+template<typename T>
+void SplitInPlace(arma::Mat<T>& input,
+                  arma::Mat<T>& trainData,
+                  arma::Mat<T>& testData,
+                  const double testRatio,
+                  const bool shuffleData = true)
+{
+  arma::uvec trainIndices, testIndices;
+  SplitIndices(input.n_cols, trainIndices, testIndices, testRatio,
+      shuffleData);
+  if (shuffleData)
+    PermuteColumns(input, arma::join_cols(trainIndices, testIndices));
+
+  const size_t trainSize = trainIndices.n_elem;
+  trainData = arma::Mat<T>(input.memptr(), input.n_rows, trainSize, false,
+      false);
+  testData = arma::Mat<T>(input.memptr() + trainSize * input.n_rows,
+      input.n_rows, input.n_cols - trainSize, false, false);
+}
+
+/**
+ * Split the given dataset and labels into a training set and a test set
+ * without copying them, like the overload above: the points and labels are
+ * reordered in place, and the outputs are made aliases of them.  If stratify
+ * is true, the split is stratified by the labels like StratifiedSplit() does.
+ *
+ * @param input Input dataset to split; its points are reordered.
+ * @param inputLabel Input labels to split; they are reordered.
+ * @param trainData Matrix to make an alias of the training data.
+ * @param testData Matrix to make an alias of the test data.
+ * @param trainLabel Vector to make an alias of the training labels.
+ * @param testLabel Vector to make an alias of the test labels.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *     sample is visited in linear order. (Default true.)
+ * @param stratify If true, the split is stratified by the labels.
+ *     (Default false.)
+ */
+template<typename T, typename U>
+void SplitInPlace(arma::Mat<T>& input,
+                  arma::Row<U>& inputLabel,
+                  arma::Mat<T>& trainData,
+                  arma::Mat<T>& testData,
+                  arma::Row<U>& trainLabel,
+                  arma::Row<U>& testLabel,
+                  const double testRatio,
+                  const bool shuffleData = true,
+                  const bool stratify = false)
+{
+  util::CheckSameSizes(input, inputLabel, "data::SplitInPlace()");
+
+  arma::uvec trainIndices, testIndices;
+  if (stratify)
+  {
+    StratifiedSplitIndices(inputLabel, trainIndices, testIndices, testRatio,
+        shuffleData);
+  }
+  else
+  {
+    SplitIndices(input.n_cols, trainIndices, testIndices, testRatio,
+        shuffleData);
+  }
+
+  if (shuffleData || stratify)
+  {
+    const arma::uvec order = arma::join_cols(trainIndices, testIndices);
+    PermuteColumns(input, order);
+    PermuteColumns(inputLabel, order);
+  }
+
+  const size_t trainSize = trainIndices.n_elem;
+  const size_t testSize = input.n_cols - trainSize;
+  trainData = arma::Mat<T>(input.memptr(), input.n_rows, trainSize, false,
+      false);
+  testData = arma::Mat<T>(input.memptr() + trainSize * input.n_rows,
+      input.n_rows, testSize, false, false);
+  trainLabel = arma::Row<U>(inputLabel.memptr(), trainSize, false, false);
+  testLabel = arma::Row<U>(inputLabel.memptr() + trainSize, testSize, false,
+      false);
+}
+
 } // namespace data
 } // namespace mlpack
 
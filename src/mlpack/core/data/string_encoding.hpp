@@ -86,10 +86,77 @@ class StringEncoding
                  const TokenizerType& tokenizer);
 
   /**
-   * Clear the dictionary.
+   * Clear the dictionary and the document frequencies.
    */
   void Clear();
 
+  /**
+   * The first pass of the streaming encoder: add the tokens of the given shard
+   * of the corpus to the dictionary, and count the number of documents that
+   * contain each token.  The shard is tokenized in parallel; calling this for
+   * each shard of the corpus in order gives the same labels as Encode() would
+   * give for the whole corpus.
+   *
+   * The streaming encoder only holds one shard in memory at a time: once each
+   * shard has been counted, PruneMap() can remove rare tokens, and then
+   * EncodeShard() encodes each shard as a sparse matrix.  It supports the
+   * policies that encode a document as a vector of the size of the dictionary,
+   * i.e. BagOfWordsEncodingPolicy and TfIdfEncodingPolicy.
+   *
+   * @code
+   * TfIdfEncoding<SplitByAnyOf::TokenType> encoder;
+   * SplitByAnyOf tokenizer(" ,.");
+   * for (size_t i = 0; i < numShards; ++i)
+   *   encoder.CountTokens(ReadShard(i), tokenizer);
+   * encoder.PruneMap(5);
+   * for (size_t i = 0; i < numShards; ++i)
+   * {
+   *   arma::sp_mat output;
+   *   encoder.EncodeShard(ReadShard(i), output, tokenizer);
+   *   ...
+   * }
+   * @endcode
+   *
+   * @tparam TokenizerType Type of the tokenizer (see CreateMap()); its
+   *     operator() has to be safe to call from several threads.
+   *
+   * @param shard Documents of the corpus to count.
+   * @param tokenizer The tokenizer object.
+   */
+  template<typename TokenizerType>
+  void CountTokens(const std::vector<std::string>& shard,
+                   const TokenizerType& tokenizer);
+
+  /**
+   * Remove the tokens that occur in fewer than the given number of the
+   * documents counted by CountTokens() from the dictionary.  The remaining
+   * tokens are relabeled in the same order.
+   *
+   * @param minDocumentFrequency The minimum number of documents that a token
+   *     has to occur in.
+   */
+  void PruneMap(const size_t minDocumentFrequency);
+
+  /**
+   * The second pass of the streaming encoder: encode the given shard of the
+   * corpus as a sparse matrix with one column per document and one row per
+   * token of the dictionary.  Tokens that are not in the dictionary are
+   * ignored (but still count towards the length of their document).  The tf-idf
+   * statistics use the document frequencies and the number of documents
+   * counted by CountTokens().  The documents are encoded in parallel.
+   *
+   * @tparam ElemType Type of the output values.
+   * @tparam TokenizerType Type of the tokenizer.
+   *
+   * @param shard Documents of the corpus to encode.
+   * @param output Sparse matrix to store the result in.
+   * @param tokenizer The tokenizer object.
+   */
+  template<typename ElemType, typename TokenizerType>
+  void EncodeShard(const std::vector<std::string>& shard,
+                   arma::SpMat<ElemType>& output,
+                   const TokenizerType& tokenizer) const;
+
   /**
    * Encode the given text and write the result to the given output. The encoder
    * writes data in the column-major order or in the row-major order depending
@@ -125,6 +192,15 @@ class StringEncoding
   //! Modify the dictionary.
   DictionaryType& Dictionary() { return dictionary; }
 
+  //! Return the number of documents that contain each token (by label - 1).
+  const std::vector<size_t>& DocumentFrequencies() const
+  {
+    return documentFrequencies;
+  }
+
+  //! Return the number of documents counted by CountTokens().
+  size_t NumDocuments() const { return numDocuments; }
+
   //! Return the encoding policy object.
   const EncodingPolicyType& EncodingPolicy() const { return encodingPolicy; }
   //! Modify the encoding policy object.
@@ -202,11 +278,25 @@ class StringEncoding
                     typename std::enable_if<StringEncodingPolicyTraits<
                         PolicyType>::onePassEncoding>::type* = 0);
 
+  //! Get the tokens of the given dictionary, ordered by their labels.
+  template<typename Token>
+  static void TokensByLabel(const StringEncodingDictionary<Token>& dict,
+                            std::vector<Token>& tokens);
+
+  //! Get the tokens of the given dictionary of characters, ordered by their
+  //! labels.
+  static void TokensByLabel(const StringEncodingDictionary<int>& dict,
+                            std::vector<int>& tokens);
+
  private:
   //! The encoding policy object.
   EncodingPolicyType encodingPolicy;
   //! The dictionary that contains the tokens and their labels.
   DictionaryType dictionary;
+  //! The number of counted documents that contain each token (by label - 1).
+  std::vector<size_t> documentFrequencies;
+  //! The number of documents counted by CountTokens().
+  size_t numDocuments;
 };
 
 } // namespace data
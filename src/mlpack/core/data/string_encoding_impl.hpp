@@ -24,40 +24,50 @@ template<typename EncodingPolicyType, typename DictionaryType>
 template<typename ... ArgTypes>
 StringEncoding<EncodingPolicyType, DictionaryType>::StringEncoding(
     ArgTypes&& ... args) :
-    encodingPolicy(std::forward<ArgTypes>(args)...)
+    encodingPolicy(std::forward<ArgTypes>(args)...),
+    numDocuments(0)
 { }
 
 template<typename EncodingPolicyType, typename DictionaryType>
 StringEncoding<EncodingPolicyType, DictionaryType>::StringEncoding(
     EncodingPolicyType encodingPolicy) :
-    encodingPolicy(std::move(encodingPolicy))
+    encodingPolicy(std::move(encodingPolicy)),
+    numDocuments(0)
 { }
 
 template<typename EncodingPolicyType, typename DictionaryType>
 StringEncoding<EncodingPolicyType, DictionaryType>::StringEncoding(
     StringEncoding& other) :
     encodingPolicy(other.encodingPolicy),
-    dictionary(other.dictionary)
+    dictionary(other.dictionary),
+    documentFrequencies(other.documentFrequencies),
+    numDocuments(other.numDocuments)
 { }
 
 template<typename EncodingPolicyType, typename DictionaryType>
 StringEncoding<EncodingPolicyType, DictionaryType>::StringEncoding(
     const StringEncoding& other) :
     encodingPolicy(other.encodingPolicy),
-    dictionary(other.dictionary)
+    dictionary(other.dictionary),
+    documentFrequencies(other.documentFrequencies),
+    numDocuments(other.numDocuments)
 { }
 
 template<typename EncodingPolicyType, typename DictionaryType>
 StringEncoding<EncodingPolicyType, DictionaryType>::StringEncoding(
     StringEncoding&& other) :
     encodingPolicy(std::move(other.encodingPolicy)),
-    dictionary(std::move(other.dictionary))
+    dictionary(std::move(other.dictionary)),
+    documentFrequencies(std::move(other.documentFrequencies)),
+    numDocuments(other.numDocuments)
 { }
 
 template<typename EncodingPolicyType, typename DictionaryType>
 void StringEncoding<EncodingPolicyType, DictionaryType>::Clear()
 {
   dictionary.Clear();
+  documentFrequencies.clear();
+  numDocuments = 0;
 }
 
 template<typename EncodingPolicyType, typename DictionaryType>
@@ -196,6 +206,210 @@ EncodeHelper(const std::vector<std::string>& input,
   }
 }
 
+template<typename EncodingPolicyType, typename DictionaryType>
+template<typename TokenizerType>
+void StringEncoding<EncodingPolicyType, DictionaryType>::CountTokens(
+    const std::vector<std::string>& shard,
+    const TokenizerType& tokenizer)
+{
+  using TokenType = typename DictionaryType::TokenType;
+
+  // Each thread counts a contiguous block of documents with its own
+  // dictionary, whose tokens still point into the shard.  Merging the blocks
+  // in order labels the tokens in the order of their first occurrence.
+  size_t numBlocks = 1;
+  #ifdef HAS_OPENMP
+  numBlocks = std::min(shard.size(), (size_t) omp_get_max_threads());
+  #endif
+  numBlocks = std::max(numBlocks, (size_t) 1);
+  const size_t blockSize = (shard.size() + numBlocks - 1) / numBlocks;
+
+  std::vector<std::vector<TokenType>> blockTokens(numBlocks);
+  std::vector<std::vector<size_t>> blockFrequencies(numBlocks);
+
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    DictionaryType blockDictionary;
+    std::vector<size_t> lastDocument;
+    const size_t begin = (size_t) b * blockSize;
+    const size_t end = std::min(shard.size(), begin + blockSize);
+    for (size_t i = begin; i < end; ++i)
+    {
+      boost::string_view strView(shard[i]);
+      auto token = tokenizer(strView);
+
+      static_assert(
+          std::is_same<typename std::remove_reference<decltype(token)>::type,
+                       typename std::remove_reference<TokenType>::type>::value,
+          "The dictionary token type doesn't match the return value type "
+          "of the tokenizer.");
+
+      while (!tokenizer.IsTokenEmpty(token))
+      {
+        size_t label;
+        if (blockDictionary.HasToken(token))
+        {
+          label = blockDictionary.Value(token);
+        }
+        else
+        {
+          blockTokens[b].push_back(token);
+          blockFrequencies[b].push_back(0);
+          lastDocument.push_back(0);
+          label = blockDictionary.AddToken(token);
+        }
+
+        // Count each document once per token.
+        if (lastDocument[label - 1] != i + 1)
+        {
+          lastDocument[label - 1] = i + 1;
+          ++blockFrequencies[b][label - 1];
+        }
+
+        token = tokenizer(strView);
+      }
+    }
+  }
+
+  documentFrequencies.resize(dictionary.Size(), 0);
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    for (size_t t = 0; t < blockTokens[b].size(); ++t)
+    {
+      const TokenType& token = blockTokens[b][t];
+      if (!dictionary.HasToken(token))
+      {
+        dictionary.AddToken(token);
+        documentFrequencies.push_back(0);
+      }
+
+      documentFrequencies[dictionary.Value(token) - 1] +=
+          blockFrequencies[b][t];
+    }
+  }
+
+  numDocuments += shard.size();
+}
+
+template<typename EncodingPolicyType, typename DictionaryType>
+void StringEncoding<EncodingPolicyType, DictionaryType>::PruneMap(
+    const size_t minDocumentFrequency)
+{
+  using TokenType = typename DictionaryType::TokenType;
+
+  // The tokens may point into the old dictionary, which is only replaced once
+  // the new one holds its own copies.
+  std::vector<TokenType> tokens;
+  TokensByLabel(dictionary, tokens);
+  documentFrequencies.resize(dictionary.Size(), 0);
+
+  DictionaryType pruned;
+  std::vector<size_t> prunedFrequencies;
+  for (size_t t = 0; t < tokens.size(); ++t)
+  {
+    if (documentFrequencies[t] >= minDocumentFrequency)
+    {
+      pruned.AddToken(tokens[t]);
+      prunedFrequencies.push_back(documentFrequencies[t]);
+    }
+  }
+
+  dictionary = std::move(pruned);
+  documentFrequencies = std::move(prunedFrequencies);
+}
+
+template<typename EncodingPolicyType, typename DictionaryType>
+template<typename ElemType, typename TokenizerType>
+void StringEncoding<EncodingPolicyType, DictionaryType>::EncodeShard(
+    const std::vector<std::string>& shard,
+    arma::SpMat<ElemType>& output,
+    const TokenizerType& tokenizer) const
+{
+  // Each document collects the (row, count) pairs of its tokens; the number
+  // of pairs of each document gives the column pointers.
+  std::vector<std::vector<std::pair<arma::uword, size_t>>> counts(
+      shard.size());
+  std::vector<size_t> numTokens(shard.size(), 0);
+  arma::uvec colPtrs(shard.size() + 1);
+  colPtrs[0] = 0;
+
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) shard.size(); ++i)
+  {
+    std::vector<std::pair<arma::uword, size_t>>& documentCounts = counts[i];
+    boost::string_view strView(shard[i]);
+    auto token = tokenizer(strView);
+
+    while (!tokenizer.IsTokenEmpty(token))
+    {
+      if (dictionary.HasToken(token))
+        documentCounts.emplace_back(dictionary.Value(token) - 1, 1);
+
+      token = tokenizer(strView);
+      ++numTokens[i];
+    }
+
+    std::sort(documentCounts.begin(), documentCounts.end());
+    size_t numRows = 0;
+    for (size_t j = 0; j < documentCounts.size(); ++j)
+    {
+      if (numRows > 0 &&
+          documentCounts[numRows - 1].first == documentCounts[j].first)
+        ++documentCounts[numRows - 1].second;
+      else
+        documentCounts[numRows++] = documentCounts[j];
+    }
+    documentCounts.resize(numRows);
+    colPtrs[i + 1] = numRows;
+  }
+
+  for (size_t i = 1; i <= shard.size(); ++i)
+    colPtrs[i] += colPtrs[i - 1];
+
+  arma::uvec rowIndices(colPtrs[shard.size()]);
+  arma::Col<ElemType> values(colPtrs[shard.size()]);
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) shard.size(); ++i)
+  {
+    for (size_t j = 0; j < counts[i].size(); ++j)
+    {
+      const arma::uword row = counts[i][j].first;
+      rowIndices[colPtrs[i] + j] = row;
+      values[colPtrs[i] + j] = encodingPolicy.template TokenValue<ElemType>(
+          counts[i][j].second, numTokens[i], documentFrequencies[row],
+          numDocuments);
+    }
+  }
+
+  output = arma::SpMat<ElemType>(rowIndices, colPtrs, values,
+      dictionary.Size(), shard.size());
+}
+
+template<typename EncodingPolicyType, typename DictionaryType>
+template<typename Token>
+void StringEncoding<EncodingPolicyType, DictionaryType>::TokensByLabel(
+    const StringEncodingDictionary<Token>& dict,
+    std::vector<Token>& tokens)
+{
+  tokens.resize(dict.Size());
+  for (const auto& keyValue : dict.Mapping())
+    tokens[keyValue.second - 1] = keyValue.first;
+}
+
+template<typename EncodingPolicyType, typename DictionaryType>
+void StringEncoding<EncodingPolicyType, DictionaryType>::TokensByLabel(
+    const StringEncodingDictionary<int>& dict,
+    std::vector<int>& tokens)
+{
+  tokens.resize(dict.Size());
+  for (size_t token = 0; token < dict.Mapping().size(); ++token)
+  {
+    if (dict.Mapping()[token] > 0)
+      tokens[dict.Mapping()[token] - 1] = (int) token;
+  }
+}
+
 template<typename EncodingPolicyType, typename DictionaryType>
 template<typename Archive>
 void StringEncoding<EncodingPolicyType, DictionaryType>::serialize(
@@ -134,6 +134,27 @@ class BagOfWordsEncodingPolicy
     output[line][value - 1] += 1;
   }
 
+  /**
+   * The function returns the encoded value of a token for the streaming
+   * encoder (StringEncoding::EncodeShard()), i.e. the number of times the
+   * token occurs in the line.
+   *
+   * @tparam ElemType Type of the output values.
+   *
+   * @param count The number of times the token occurs in the line.
+   * @param * (numTokens) The total number of tokens in the line.
+   * @param * (documentFrequency) The number of lines that contain the token.
+   * @param * (numDocuments) The total number of lines.
+   */
+  template<typename ElemType>
+  static ElemType TokenValue(const size_t count,
+                             const size_t /* numTokens */,
+                             const size_t /* documentFrequency */,
+                             const size_t /* numDocuments */)
+  {
+    return count;
+  }
+
   /**
    * The function is not used by the bag of words encoding policy.
    *
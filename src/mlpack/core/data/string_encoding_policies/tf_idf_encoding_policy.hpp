@@ -191,6 +191,27 @@ class TfIdfEncodingPolicy
     output[line][value - 1] =  tf * idf;
   }
 
+  /**
+   * The function returns the encoded value of a token for the streaming
+   * encoder (StringEncoding::EncodeShard()), i.e. its tf-idf value.
+   *
+   * @tparam ElemType Type of the output values.
+   *
+   * @param count The number of times the token occurs in the line.
+   * @param numTokens The total number of tokens in the line.
+   * @param documentFrequency The number of lines that contain the token.
+   * @param numDocuments The total number of lines.
+   */
+  template<typename ElemType>
+  ElemType TokenValue(const size_t count,
+                      const size_t numTokens,
+                      const size_t documentFrequency,
+                      const size_t numDocuments) const
+  {
+    return TermFrequency<ElemType>(count, numTokens) *
+        InverseDocumentFrequency<ElemType>(numDocuments, documentFrequency);
+  }
+
   /*
    * The function calculates the necessary statistics for the purpose
    * of the tf-idf algorithm during the first pass through the dataset.
@@ -275,7 +296,7 @@ class TfIdfEncodingPolicy
    */
   template<typename ValueType>
   ValueType TermFrequency(const size_t numOccurrences,
-                          const size_t numTokens)
+                          const size_t numTokens) const
   {
     switch (tfType)
     {
@@ -304,7 +325,7 @@ class TfIdfEncodingPolicy
    */
   template<typename ValueType>
   ValueType InverseDocumentFrequency(const size_t totalNumLines,
-                                     const size_t numOccurrences)
+                                     const size_t numOccurrences) const
   {
     if (smoothIdf)
     {
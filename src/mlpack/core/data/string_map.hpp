@@ -0,0 +1,199 @@
+/**
+ * @file core/data/string_map.hpp
+ *
+ * Definition of StringMap, a compact map from strings to consecutive ids.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_STRING_MAP_HPP
+#define MLPACK_CORE_DATA_STRING_MAP_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A StringMap assigns consecutive ids (0, 1, 2, ...) to distinct strings, in
+ * the order in which they are first inserted.  Each string may carry a tag
+ * (such as the dimension it belongs to); the same string with different tags
+ * is a different key.
+ *
+ * The strings are interned into a single arena, and looked up with an
+ * open-addressing hash table (linear probing) of ids, so that a map of
+ * millions of strings costs little more than the characters of the strings,
+ * and inserting a string that is already present allocates nothing.  Keys are
+ * given as character ranges, so they do not have to be copied into a
+ * std::string first.
+ *
+ * The serialized form holds only the arena, the offsets and the tags; the
+ * hash table is rebuilt on loading.
+ */
+class StringMap
+{
+ public:
+  //! The id returned by Find() for strings that are not present.
+  static constexpr size_t notFound = SIZE_MAX;
+
+  //! Create an empty map.
+  StringMap() : offsets(1, 0), table(16, 0) { }
+
+  /**
+   * Insert the given string, if it is not present, and return its id.
+   *
+   * @param begin Start of the string.
+   * @param length Length of the string.
+   * @param tag Tag of the string.
+   */
+  size_t Insert(const char* begin, const size_t length, const size_t tag = 0)
+  {
+    const uint64_t hash = Hash(begin, length, tag);
+    size_t slot = Lookup(begin, length, tag, hash);
+    if (table[slot] != 0)
+      return table[slot] - 1;
+
+    const size_t id = Size();
+    arena.append(begin, length);
+    offsets.push_back(arena.size());
+    tags.push_back(tag);
+    hashes.push_back(hash);
+    table[slot] = id + 1;
+
+    // Keep the load factor at most 1/2.
+    if (2 * Size() > table.size())
+      Rehash(2 * table.size());
+
+    return id;
+  }
+
+  /**
+   * Get the id of the given string, or notFound if it is not present.
+   *
+   * @param begin Start of the string.
+   * @param length Length of the string.
+   * @param tag Tag of the string.
+   */
+  size_t Find(const char* begin, const size_t length, const size_t tag = 0)
+      const
+  {
+    const size_t slot = Lookup(begin, length, tag, Hash(begin, length, tag));
+    if (table[slot] == 0)
+      return notFound;
+
+    return table[slot] - 1;
+  }
+
+  //! Get the number of distinct strings.
+  size_t Size() const { return tags.size(); }
+
+  //! Get a pointer to the characters of the string with the given id.
+  const char* Data(const size_t id) const
+  { return arena.data() + offsets[id]; }
+  //! Get the length of the string with the given id.
+  size_t Length(const size_t id) const
+  { return offsets[id + 1] - offsets[id]; }
+  //! Get the string with the given id.
+  std::string String(const size_t id) const
+  { return std::string(Data(id), Length(id)); }
+  //! Get the tag of the string with the given id.
+  size_t Tag(const size_t id) const { return tags[id]; }
+
+  //! Remove all strings.
+  void Clear()
+  {
+    arena.clear();
+    offsets.assign(1, 0);
+    tags.clear();
+    hashes.clear();
+    table.assign(16, 0);
+  }
+
+  //! Serialize the map.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(arena));
+    ar(CEREAL_NVP(offsets));
+    ar(CEREAL_NVP(tags));
+
+    if (cereal::is_loading<Archive>())
+    {
+      hashes.resize(tags.size());
+      for (size_t id = 0; id < tags.size(); ++id)
+        hashes[id] = Hash(Data(id), Length(id), tags[id]);
+
+      size_t capacity = 16;
+      while (2 * Size() > capacity)
+        capacity *= 2;
+      Rehash(capacity);
+    }
+  }
+
+ private:
+  //! FNV-1a over the characters, then over the tag.
+  static uint64_t Hash(const char* begin, const size_t length, size_t tag)
+  {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i)
+      hash = (hash ^ (unsigned char) begin[i]) * 1099511628211ULL;
+    for (size_t i = 0; i < sizeof(size_t); ++i, tag >>= 8)
+      hash = (hash ^ (tag & 0xFF)) * 1099511628211ULL;
+
+    return hash;
+  }
+
+  //! Return the slot that holds the given string, or the empty slot where it
+  //! would be inserted.
+  size_t Lookup(const char* begin,
+                const size_t length,
+                const size_t tag,
+                const uint64_t hash) const
+  {
+    const size_t mask = table.size() - 1;
+    size_t slot = (size_t) (hash ^ (hash >> 32)) & mask;
+    while (table[slot] != 0)
+    {
+      const size_t id = table[slot] - 1;
+      if (hashes[id] == hash && tags[id] == tag && Length(id) == length &&
+          std::memcmp(Data(id), begin, length) == 0)
+        return slot;
+
+      slot = (slot + 1) & mask;
+    }
+
+    return slot;
+  }
+
+  //! Rebuild the hash table with the given capacity (a power of two).
+  void Rehash(const size_t capacity)
+  {
+    table.assign(capacity, 0);
+    const size_t mask = capacity - 1;
+    for (size_t id = 0; id < Size(); ++id)
+    {
+      size_t slot = (size_t) (hashes[id] ^ (hashes[id] >> 32)) & mask;
+      while (table[slot] != 0)
+        slot = (slot + 1) & mask;
+      table[slot] = id + 1;
+    }
+  }
+
+  //! The characters of all strings, one after the other.
+  std::string arena;
+  //! String i is arena[offsets[i]] to arena[offsets[i + 1] - 1].
+  std::vector<size_t> offsets;
+  //! The tag of each string.
+  std::vector<size_t> tags;
+  //! The hash of each string, so that rehashing does not read the arena.
+  std::vector<uint64_t> hashes;
+  //! The hash table: each slot holds an id plus one, or 0 if it is empty.
+  std::vector<size_t> table;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
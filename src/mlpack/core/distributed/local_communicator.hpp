@@ -0,0 +1,78 @@
+/**
+ * @file core/distributed/local_communicator.hpp
+ *
+ * A communicator for a single process, used by the distributed methods when
+ * the whole dataset is on one machine.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DISTRIBUTED_LOCAL_COMMUNICATOR_HPP
+#define MLPACK_CORE_DISTRIBUTED_LOCAL_COMMUNICATOR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace distributed {
+
+/**
+ * The LocalCommunicator is the communicator of a group of processes that holds
+ * only the current process: the distributed methods then behave like their
+ * single-machine counterparts.  It is also the reference for the interface of
+ * communicators, which is:
+ *
+ * @code
+ * // The index of this process in the group, and the number of processes.
+ * size_t Rank() const;
+ * size_t Size() const;
+ *
+ * // Replace the matrix by the element-wise sum of the matrices of all the
+ * // processes; all the matrices must have the same size.
+ * template<typename eT>
+ * void AllReduceSum(arma::Mat<eT>& matrix);
+ *
+ * // Replace the object by the one of the given process, which is sent with
+ * // its serialize() function.
+ * template<typename T>
+ * void Broadcast(T& object, const size_t root);
+ *
+ * // Collect the object of every process (serialized likewise), in the order
+ * // of their ranks.
+ * template<typename T>
+ * void AllGather(const T& object, std::vector<T>& objects);
+ * @endcode
+ *
+ * Every process of the group must make the same calls in the same order.
+ *
+ * @see MPICommunicator
+ */
+class LocalCommunicator
+{
+ public:
+  //! Get the index of this process in the group.
+  size_t Rank() const { return 0; }
+  //! Get the number of processes in the group.
+  size_t Size() const { return 1; }
+
+  //! The sum over a single process is the matrix itself.
+  template<typename eT>
+  void AllReduceSum(arma::Mat<eT>& /* matrix */) { }
+
+  //! The only process is the root, so the object is unchanged.
+  template<typename T>
+  void Broadcast(T& /* object */, const size_t /* root */) { }
+
+  //! Collect the object of the only process.
+  template<typename T>
+  void AllGather(const T& object, std::vector<T>& objects)
+  {
+    objects.assign(1, object);
+  }
+};
+
+} // namespace distributed
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,212 @@
+/**
+ * @file core/distributed/mpi_communicator.hpp
+ *
+ * A communicator for the processes of an MPI communicator, used by the
+ * distributed methods to work on datasets sharded over several machines.  It
+ * is only available if mlpack is built with USE_MPI.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DISTRIBUTED_MPI_COMMUNICATOR_HPP
+#define MLPACK_CORE_DISTRIBUTED_MPI_COMMUNICATOR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef HAS_MPI
+
+#include <mpi.h>
+#include <climits>
+
+namespace mlpack {
+namespace distributed {
+
+/**
+ * The MPI datatype of the elements of a matrix.
+ */
+template<typename eT>
+struct MPIType;
+
+template<>
+struct MPIType<double> { static MPI_Datatype Get() { return MPI_DOUBLE; } };
+
+template<>
+struct MPIType<float> { static MPI_Datatype Get() { return MPI_FLOAT; } };
+
+template<>
+struct MPIType<size_t>
+{
+  static MPI_Datatype Get()
+  {
+    return (sizeof(size_t) == sizeof(unsigned long long)) ?
+        MPI_UNSIGNED_LONG_LONG : MPI_UNSIGNED;
+  }
+};
+
+/**
+ * The MPICommunicator connects the processes of an MPI communicator, so that
+ * the distributed methods (such as kmeans::DistributedKMeans and
+ * neighbor::DistributedNeighborSearch) can work on a dataset of which each
+ * process holds one shard.  Objects are exchanged with the cereal
+ * serialization that mlpack uses to save models, so any model or matrix that
+ * can be saved with data::Save() can be sent.
+ *
+ * MPI must be initialized (with MPI_Init()) before the communicator is used,
+ * and finalized by the program afterwards.
+ *
+ * @code
+ * MPI_Init(&argc, &argv);
+ * {
+ *   distributed::MPICommunicator comm;
+ *   arma::mat shard;
+ *   data::Load("shard-" + std::to_string(comm.Rank()) + ".csv", shard, true);
+ *
+ *   arma::mat centroids;
+ *   kmeans::DistributedKMeans<distributed::MPICommunicator> k(comm);
+ *   k.Cluster(shard, 1000, centroids);
+ * }
+ * MPI_Finalize();
+ * @endcode
+ *
+ * @see LocalCommunicator for the interface of communicators.
+ */
+class MPICommunicator
+{
+ public:
+  /**
+   * Create the communicator for the processes of the given MPI communicator.
+   *
+   * @param comm MPI communicator to use.
+   */
+  MPICommunicator(MPI_Comm comm = MPI_COMM_WORLD) : comm(comm)
+  {
+    int value;
+    MPI_Comm_rank(comm, &value);
+    rank = (size_t) value;
+    MPI_Comm_size(comm, &value);
+    size = (size_t) value;
+  }
+
+  //! Get the index of this process in the group.
+  size_t Rank() const { return rank; }
+  //! Get the number of processes in the group.
+  size_t Size() const { return size; }
+
+  /**
+   * Replace the matrix by the element-wise sum of the matrices of all the
+   * processes.
+   */
+  template<typename eT>
+  void AllReduceSum(arma::Mat<eT>& matrix)
+  {
+    // MPI counts are ints, so large matrices are summed in several parts.
+    for (size_t start = 0; start < matrix.n_elem; start += INT_MAX)
+    {
+      const int count = (int) std::min((size_t) (matrix.n_elem - start),
+          (size_t) INT_MAX);
+      MPI_Allreduce(MPI_IN_PLACE, matrix.memptr() + start, count,
+          MPIType<eT>::Get(), MPI_SUM, comm);
+    }
+  }
+
+  /**
+   * Replace the object by the one of the given process.
+   */
+  template<typename T>
+  void Broadcast(T& object, const size_t root)
+  {
+    std::string buffer;
+    if (rank == root)
+      Serialize(object, buffer);
+
+    unsigned long long bytes = buffer.size();
+    MPI_Bcast(&bytes, 1, MPI_UNSIGNED_LONG_LONG, (int) root, comm);
+    CheckBytes(bytes);
+
+    buffer.resize(bytes);
+    MPI_Bcast(&buffer[0], (int) bytes, MPI_CHAR, (int) root, comm);
+    if (rank != root)
+      Deserialize(buffer, object);
+  }
+
+  /**
+   * Collect the object of every process, in the order of their ranks.
+   */
+  template<typename T>
+  void AllGather(const T& object, std::vector<T>& objects)
+  {
+    std::string buffer;
+    Serialize(object, buffer);
+
+    unsigned long long bytes = buffer.size();
+    std::vector<unsigned long long> allBytes(size);
+    MPI_Allgather(&bytes, 1, MPI_UNSIGNED_LONG_LONG, allBytes.data(), 1,
+        MPI_UNSIGNED_LONG_LONG, comm);
+
+    std::vector<int> counts(size), offsets(size);
+    unsigned long long total = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+      offsets[i] = (int) total;
+      counts[i] = (int) allBytes[i];
+      total += allBytes[i];
+      CheckBytes(total);
+    }
+
+    std::string allBuffers(total, '\0');
+    MPI_Allgatherv(buffer.data(), (int) bytes, MPI_CHAR, &allBuffers[0],
+        counts.data(), offsets.data(), MPI_CHAR, comm);
+
+    objects.resize(size);
+    for (size_t i = 0; i < size; ++i)
+      Deserialize(allBuffers.substr(offsets[i], counts[i]), objects[i]);
+  }
+
+ private:
+  //! Serialize the object into the buffer.
+  template<typename T>
+  static void Serialize(const T& object, std::string& buffer)
+  {
+    std::ostringstream oss;
+    {
+      cereal::BinaryOutputArchive ar(oss);
+      ar(cereal::make_nvp("object", object));
+    }
+    buffer = oss.str();
+  }
+
+  //! Load the object from the buffer.
+  template<typename T>
+  static void Deserialize(const std::string& buffer, T& object)
+  {
+    std::istringstream iss(buffer);
+    cereal::BinaryInputArchive ar(iss);
+    ar(cereal::make_nvp("object", object));
+  }
+
+  //! Make sure that a message can be sent with an MPI count.
+  static void CheckBytes(const unsigned long long bytes)
+  {
+    if (bytes > (unsigned long long) INT_MAX)
+    {
+      Log::Fatal << "MPICommunicator: cannot send " << bytes << " bytes in one "
+          << "message; split the object." << std::endl;
+    }
+  }
+
+  //! The MPI communicator.
+  MPI_Comm comm;
+  //! The index of this process.
+  size_t rank;
+  //! The number of processes.
+  size_t size;
+};
+
+} // namespace distributed
+} // namespace mlpack
+
+#endif // HAS_MPI
+
+#endif
@@ -51,16 +51,27 @@ void DiagonalGaussianDistribution::LogProbability(
     arma::vec& logProbabilities) const
 {
   const size_t k = observations.n_rows;
-
-  // Column i of 'diffs' is the difference between observations.col(i) and
-  // the mean.
-  arma::mat diffs = observations.each_col() - mean;
-
-  // Calculates log of exponent equation in multivariate Gaussian
-  // distribution. We use only diagonal part for faster computation.
-  arma::vec logExponents = -0.5 * arma::trans(diffs % diffs) * invCov;
-
-  logProbabilities = -0.5 * k * log2pi - 0.5 * logDetCov + logExponents;
+  const double constant = -0.5 * k * log2pi - 0.5 * logDetCov;
+  logProbabilities.set_size(observations.n_cols);
+
+  // Calculate the exponent of each observation directly, without the
+  // temporary matrix of differences.  The inner loop is vectorized and the
+  // observations are processed in parallel.
+  const double* meanMem = mean.memptr();
+  const double* invCovMem = invCov.memptr();
+  #pragma omp parallel for schedule(static) if (observations.n_cols > 1024)
+  for (omp_size_t i = 0; i < (omp_size_t) observations.n_cols; ++i)
+  {
+    const double* observation = observations.colptr(i);
+    double exponent = 0.0;
+    for (size_t d = 0; d < k; ++d)
+    {
+      const double diff = observation[d] - meanMem[d];
+      exponent += diff * diff * invCovMem[d];
+    }
+
+    logProbabilities[i] = constant - 0.5 * exponent;
+  }
 }
 
 arma::vec DiagonalGaussianDistribution::Random() const
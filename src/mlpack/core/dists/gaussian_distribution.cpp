@@ -76,6 +76,33 @@ double GaussianDistribution::LogProbability(const arma::vec& observation) const
   return -0.5 * k * log2pi - 0.5 * logDetCov - 0.5 * v(0);
 }
 
+void GaussianDistribution::LogProbability(const arma::mat& x,
+                                          arma::vec& logProbabilities) const
+{
+  // With cov = L L^T, the Mahalanobis term of each observation is the squared
+  // norm of L^-1 (x - mean).  For a block of observations this is one
+  // triangular solve, which costs half as much as multiplying by invCov, and
+  // the blocks are independent.
+  const double constant = -0.5 * x.n_rows * log2pi - 0.5 * logDetCov;
+  const size_t blockSize = 256;
+  const size_t numBlocks = (x.n_cols + blockSize - 1) / blockSize;
+  logProbabilities.set_size(x.n_cols);
+
+  #pragma omp parallel for schedule(static) if (numBlocks > 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) x.n_cols);
+
+    arma::mat diffs = x.cols(begin, end - 1);
+    diffs.each_col() -= mean;
+    const arma::mat whitened = arma::solve(arma::trimatl(covLower), diffs);
+
+    logProbabilities.subvec(begin, end - 1) = constant - 0.5 *
+        arma::sum(arma::square(whitened), 0).t();
+  }
+}
+
 arma::vec GaussianDistribution::Random() const
 {
   return covLower * arma::randn<arma::vec>(mean.n_elem) + mean;
@@ -99,23 +99,14 @@ class GaussianDistribution
 
   /**
    * Returns the Log probability of the given matrix. These values are stored
-   * in logProbabilities.
+   * in logProbabilities.  The observations are processed in blocks, in
+   * parallel.
    *
    * @param x List of observations.
    * @param logProbabilities Output log probabilities for each input
    *     observation.
    */
-  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const
-  {
-    // Column i of 'diffs' is the difference between x.col(i) and the mean.
-    arma::mat diffs = x;
-    diffs.each_col() -= mean;
-
-    // Now, we only want to calculate the diagonal elements of (diffs' * cov^-1
-    // * diffs).  We just don't need any of the other elements.
-    logProbabilities = -0.5 * x.n_rows * log2pi - 0.5 * logDetCov +
-        sum(diffs % (-0.5 * invCov * diffs), 0).t();
-  }
+  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const;
 
   /**
    * Return a randomly generated observation according to the probability
@@ -66,13 +66,29 @@ class CVFunction
              const BoundArgs&... args);
 
   /**
-   * Run cross-validation with the bound and passed parameters.
+   * Run cross-validation with the bound and passed parameters.  The result for
+   * each set of parameters is memoized, so cross-validation is run only once
+   * for each of them.
    *
    * @param parameters Arguments (rather than the bound arguments) that should
    *     be passed into the Evaluate method of the CVType object.
    */
   double Evaluate(const arma::mat& parameters);
 
+  /**
+   * Run cross-validation with the bound and passed parameters, training the
+   * models on the given fraction of the training data only (see
+   * TrainingFraction() of the cross-validation classes).  This is cheaper, but
+   * less accurate, and is used by SuccessiveHalving to discard bad parameters
+   * early.  The models trained on a part of the data are not considered for
+   * BestModel().  The results are memoized too.
+   *
+   * @param parameters Arguments (rather than the bound arguments) that should
+   *     be passed into the Evaluate method of the CVType object.
+   * @param budget Fraction of the training data to use, in (0, 1].
+   */
+  double Evaluate(const arma::mat& parameters, const double budget);
+
   /**
    * Evaluate numerically the gradient of the CVFunction with the given
    * parameters.
@@ -86,6 +102,10 @@ class CVFunction
   //! Access and modify the best model so far.
   MLAlgorithm& BestModel() { return bestModel; }
 
+  //! Get the number of times cross-validation has been run (memoized results
+  //! are not counted).
+  size_t NumEvaluations() const { return evaluations.size(); }
+
  private:
   //! The type of tuples of BoundArgs.
   using BoundArgsTupleType = std::tuple<BoundArgs...>;
@@ -125,6 +145,19 @@ class CVFunction
   //! Minimum absolute increase of arguments for calculation of gradient.
   double minDelta;
 
+  //! The results of cross-validation for each set of parameters and budget
+  //! run so far.
+  std::map<std::vector<double>, double> evaluations;
+
+  //! Whether models are being trained on a part of the data.
+  bool partialEvaluation;
+
+  /**
+   * Look up the memoized result for the given parameters and budget, or run
+   * cross-validation if there is none.
+   */
+  double MemoizedEvaluate(const arma::mat& parameters, const double budget);
+
   /**
    * Collect all arguments and run cross-validation.
    */
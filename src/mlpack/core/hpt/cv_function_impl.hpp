@@ -55,7 +55,8 @@ CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::CVFunction(
     boundArgs(args...),
     bestObjective(std::numeric_limits<double>::max()),
     relativeDelta(relativeDelta),
-    minDelta(minDelta)
+    minDelta(minDelta),
+    partialEvaluation(false)
 { /* Nothing left to do. */ }
 
 template<typename CVType,
@@ -65,7 +66,65 @@ template<typename CVType,
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
     const arma::mat& parameters)
 {
-  return Evaluate<0, 0>(parameters);
+  return MemoizedEvaluate(parameters, 1.0);
+}
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
+    const arma::mat& parameters,
+    const double budget)
+{
+  if (budget <= 0.0 || budget > 1.0)
+  {
+    std::ostringstream oss;
+    oss << "CVFunction::Evaluate(): the budget should be in (0, 1], but it is "
+        << budget;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (budget == 1.0)
+    return MemoizedEvaluate(parameters, 1.0);
+
+  // Restore the full training data even if training throws.
+  cv.TrainingFraction() = budget;
+  partialEvaluation = true;
+  double objective;
+  try
+  {
+    objective = MemoizedEvaluate(parameters, budget);
+  }
+  catch (...)
+  {
+    cv.TrainingFraction() = 1.0;
+    partialEvaluation = false;
+    throw;
+  }
+  cv.TrainingFraction() = 1.0;
+  partialEvaluation = false;
+
+  return objective;
+}
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::
+MemoizedEvaluate(const arma::mat& parameters, const double budget)
+{
+  std::vector<double> key(parameters.begin(), parameters.end());
+  key.push_back(budget);
+
+  const auto it = evaluations.find(key);
+  if (it != evaluations.end())
+    return it->second;
+
+  const double objective = Evaluate<0, 0>(parameters);
+  evaluations[key] = objective;
+  return objective;
 }
 
 template<typename CVType,
@@ -120,9 +179,10 @@ double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
   double objective = cv.Evaluate(args...);
 
   // Change the best model if we have got a better score, or if we probably
-  // have not assigned any valid (trained) model yet.
-  if (bestObjective > objective ||
-      bestObjective == std::numeric_limits<double>::max())
+  // have not assigned any valid (trained) model yet.  Models trained on a part
+  // of the data are not comparable with the others.
+  if (!partialEvaluation && (bestObjective > objective ||
+      bestObjective == std::numeric_limits<double>::max()))
   {
     bestObjective = objective;
     bestModel = std::move(cv.Model());
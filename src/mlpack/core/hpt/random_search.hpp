@@ -0,0 +1,103 @@
+/**
+ * @file core/hpt/random_search.hpp
+ *
+ * Random search over sets of hyper-parameter values with a budget.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_HPT_RANDOM_SEARCH_HPP
+#define MLPACK_CORE_HPT_RANDOM_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <set>
+
+namespace mlpack {
+namespace hpt {
+
+/**
+ * Get distinct configurations of categorical parameters: all of them if there
+ * are at most maxConfigurations (or if maxConfigurations is 0), and
+ * maxConfigurations configurations chosen uniformly at random otherwise.
+ * Each configuration is a column with the index of the category of each
+ * parameter.
+ *
+ * @param categoricalDimensions Whether each parameter is categorical; all of
+ *     them have to be, otherwise a std::invalid_argument is thrown.
+ * @param numCategories The number of categories of each parameter.
+ * @param maxConfigurations The maximum number of configurations (0 means no
+ *     limit).
+ * @param configurations Matrix to store the configurations in.
+ */
+inline void SampleConfigurations(const std::vector<bool>& categoricalDimensions,
+                                 const arma::Row<size_t>& numCategories,
+                                 const size_t maxConfigurations,
+                                 arma::mat& configurations);
+
+/**
+ * RandomSearch is an optimizer for HyperParameterTuner that evaluates a given
+ * number of configurations of the hyper-parameters, chosen at random from the
+ * sets of values passed to HyperParameterTuner::Optimize() (as for GridSearch).
+ * Each configuration is evaluated once.  If the budget covers all the
+ * configurations, they are all evaluated, like GridSearch does.
+ *
+ * @code
+ * HyperParameterTuner<LARS, MSE, SimpleCV, RandomSearch> hpt(0.2, data,
+ *     responses);
+ * hpt.Optimizer().MaxEvaluations() = 50;
+ * double lambda1, lambda2;
+ * std::tie(lambda1, lambda2) = hpt.Optimize(lambda1Set, lambda2Set);
+ * @endcode
+ */
+class RandomSearch
+{
+ public:
+  /**
+   * Create the optimizer.
+   *
+   * @param maxEvaluations The number of configurations to evaluate (0 means
+   *     all of them).
+   */
+  RandomSearch(const size_t maxEvaluations = 100) :
+      maxEvaluations(maxEvaluations)
+  { /* Nothing to do. */ }
+
+  /**
+   * Find the configuration with the smallest objective among maxEvaluations
+   * random configurations.
+   *
+   * @param function Function to optimize, with an
+   *     Evaluate(const arma::mat& parameters) method.
+   * @param bestParameters Matrix to store the best configuration in (the index
+   *     of the category of each parameter).
+   * @param categoricalDimensions Whether each parameter is categorical (they
+   *     all have to be).
+   * @param numCategories The number of categories of each parameter.
+   * @return The objective of the best configuration.
+   */
+  template<typename FunctionType>
+  double Optimize(FunctionType& function,
+                  arma::mat& bestParameters,
+                  const std::vector<bool>& categoricalDimensions,
+                  const arma::Row<size_t>& numCategories);
+
+  //! Get the number of configurations to evaluate.
+  size_t MaxEvaluations() const { return maxEvaluations; }
+  //! Modify the number of configurations to evaluate.
+  size_t& MaxEvaluations() { return maxEvaluations; }
+
+ private:
+  //! The number of configurations to evaluate.
+  size_t maxEvaluations;
+};
+
+} // namespace hpt
+} // namespace mlpack
+
+// Include implementation.
+#include "random_search_impl.hpp"
+
+#endif
@@ -0,0 +1,108 @@
+/**
+ * @file core/hpt/random_search_impl.hpp
+ *
+ * Implementation of RandomSearch.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_HPT_RANDOM_SEARCH_IMPL_HPP
+#define MLPACK_CORE_HPT_RANDOM_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "random_search.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace hpt {
+
+inline void SampleConfigurations(const std::vector<bool>& categoricalDimensions,
+                                 const arma::Row<size_t>& numCategories,
+                                 const size_t maxConfigurations,
+                                 arma::mat& configurations)
+{
+  const size_t dimensionality = numCategories.n_elem;
+  double totalConfigurations = 1.0;
+  for (size_t d = 0; d < dimensionality; ++d)
+  {
+    if (!categoricalDimensions[d] || numCategories[d] == 0)
+    {
+      std::ostringstream oss;
+      oss << "SampleConfigurations(): hyper-parameter " << d << " is not "
+          << "given as a set of values";
+      throw std::invalid_argument(oss.str());
+    }
+
+    totalConfigurations *= numCategories[d];
+  }
+
+  if (maxConfigurations == 0 || totalConfigurations <= maxConfigurations)
+  {
+    // Enumerate all the configurations, like GridSearch.
+    configurations.set_size(dimensionality, (size_t) totalConfigurations);
+    arma::vec configuration(dimensionality, arma::fill::zeros);
+    for (size_t c = 0; c < configurations.n_cols; ++c)
+    {
+      configurations.col(c) = configuration;
+      for (size_t d = 0; d < dimensionality; ++d)
+      {
+        if (++configuration[d] < numCategories[d])
+          break;
+        configuration[d] = 0;
+      }
+    }
+
+    return;
+  }
+
+  // Draw distinct configurations; there are more than we need, so this ends.
+  configurations.set_size(dimensionality, maxConfigurations);
+  std::set<std::vector<size_t>> drawn;
+  std::vector<size_t> configuration(dimensionality);
+  size_t c = 0;
+  while (c < maxConfigurations)
+  {
+    for (size_t d = 0; d < dimensionality; ++d)
+      configuration[d] = math::RandInt(numCategories[d]);
+
+    if (!drawn.insert(configuration).second)
+      continue;
+
+    for (size_t d = 0; d < dimensionality; ++d)
+      configurations(d, c) = configuration[d];
+    ++c;
+  }
+}
+
+template<typename FunctionType>
+double RandomSearch::Optimize(FunctionType& function,
+                              arma::mat& bestParameters,
+                              const std::vector<bool>& categoricalDimensions,
+                              const arma::Row<size_t>& numCategories)
+{
+  arma::mat configurations;
+  SampleConfigurations(categoricalDimensions, numCategories, maxEvaluations,
+      configurations);
+
+  double bestObjective = std::numeric_limits<double>::max();
+  for (size_t c = 0; c < configurations.n_cols; ++c)
+  {
+    const arma::mat configuration = configurations.col(c);
+    const double objective = function.Evaluate(configuration);
+    if (c == 0 || objective < bestObjective)
+    {
+      bestObjective = objective;
+      bestParameters = configuration;
+    }
+  }
+
+  return bestObjective;
+}
+
+} // namespace hpt
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,116 @@
+/**
+ * @file core/hpt/successive_halving.hpp
+ *
+ * Successive halving over sets of hyper-parameter values.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_HPT_SUCCESSIVE_HALVING_HPP
+#define MLPACK_CORE_HPT_SUCCESSIVE_HALVING_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "random_search.hpp"
+
+namespace mlpack {
+namespace hpt {
+
+/**
+ * SuccessiveHalving is an optimizer for HyperParameterTuner that evaluates many
+ * configurations of the hyper-parameters cheaply, and only the best of them
+ * on all the data.  The configurations (all of those that can be made from
+ * the sets of values passed to HyperParameterTuner::Optimize(), or a random
+ * sample of them) are first evaluated with models trained on a small fraction
+ * of the training data.  Then, in each round, only the best 1 / eta of them
+ * are kept, and the fraction of the data is multiplied by eta, until the
+ * remaining configurations are evaluated on all the training data.
+ *
+ * The fraction of the training data is set through the TrainingFraction()
+ * method of the cross-validation class (see SimpleCV and KFoldCV), so the data
+ * should be shuffled.  Hyperband is successive halving run several times with
+ * different numbers of configurations and smallest budgets; this can be done
+ * with several HyperParameterTuner::Optimize() calls.
+ *
+ * @code
+ * HyperParameterTuner<DecisionTree<>, Accuracy, KFoldCV, SuccessiveHalving>
+ *     hpt(5, data, labels, numClasses);
+ * hpt.Optimizer().NumConfigurations() = 81;
+ * size_t minimumLeafSize;
+ * double minimumGainSplit;
+ * std::tie(minimumLeafSize, minimumGainSplit) = hpt.Optimize(
+ *     leafSizes, gainSplits);
+ * @endcode
+ */
+class SuccessiveHalving
+{
+ public:
+  /**
+   * Create the optimizer.
+   *
+   * @param numConfigurations The number of configurations to start with (0
+   *     means all of them).
+   * @param eta The factor by which the number of configurations is divided, and
+   *     the budget is multiplied, in each round (greater than 1).
+   * @param minBudget The smallest fraction of the training data to train
+   *     models on, in (0, 1].
+   */
+  SuccessiveHalving(const size_t numConfigurations = 0,
+                    const double eta = 3.0,
+                    const double minBudget = 0.05) :
+      numConfigurations(numConfigurations),
+      eta(eta),
+      minBudget(minBudget)
+  { /* Nothing to do. */ }
+
+  /**
+   * Find a good configuration with successive halving.
+   *
+   * @param function Function to optimize, with an
+   *     Evaluate(const arma::mat& parameters, const double budget) method.
+   * @param bestParameters Matrix to store the best configuration in (the index
+   *     of the category of each parameter).
+   * @param categoricalDimensions Whether each parameter is categorical (they
+   *     all have to be).
+   * @param numCategories The number of categories of each parameter.
+   * @return The objective of the best configuration on all the data.
+   */
+  template<typename FunctionType>
+  double Optimize(FunctionType& function,
+                  arma::mat& bestParameters,
+                  const std::vector<bool>& categoricalDimensions,
+                  const arma::Row<size_t>& numCategories);
+
+  //! Get the number of configurations to start with (0 means all).
+  size_t NumConfigurations() const { return numConfigurations; }
+  //! Modify the number of configurations to start with (0 means all).
+  size_t& NumConfigurations() { return numConfigurations; }
+
+  //! Get the reduction factor of each round.
+  double Eta() const { return eta; }
+  //! Modify the reduction factor of each round.
+  double& Eta() { return eta; }
+
+  //! Get the smallest fraction of the training data to train models on.
+  double MinBudget() const { return minBudget; }
+  //! Modify the smallest fraction of the training data to train models on.
+  double& MinBudget() { return minBudget; }
+
+ private:
+  //! The number of configurations to start with.
+  size_t numConfigurations;
+  //! The reduction factor of each round.
+  double eta;
+  //! The smallest fraction of the training data to train models on.
+  double minBudget;
+};
+
+} // namespace hpt
+} // namespace mlpack
+
+// Include implementation.
+#include "successive_halving_impl.hpp"
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ * @file core/hpt/successive_halving_impl.hpp
+ *
+ * Implementation of SuccessiveHalving.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_HPT_SUCCESSIVE_HALVING_IMPL_HPP
+#define MLPACK_CORE_HPT_SUCCESSIVE_HALVING_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "successive_halving.hpp"
+
+namespace mlpack {
+namespace hpt {
+
+template<typename FunctionType>
+double SuccessiveHalving::Optimize(
+    FunctionType& function,
+    arma::mat& bestParameters,
+    const std::vector<bool>& categoricalDimensions,
+    const arma::Row<size_t>& numCategories)
+{
+  if (eta <= 1.0)
+  {
+    throw std::invalid_argument("SuccessiveHalving::Optimize(): eta should be "
+        "greater than 1");
+  }
+  if (minBudget <= 0.0 || minBudget > 1.0)
+  {
+    throw std::invalid_argument("SuccessiveHalving::Optimize(): minBudget "
+        "should be in (0, 1]");
+  }
+
+  arma::mat configurations;
+  SampleConfigurations(categoricalDimensions, numCategories, numConfigurations,
+      configurations);
+
+  std::vector<size_t> survivors(configurations.n_cols);
+  for (size_t c = 0; c < survivors.size(); ++c)
+    survivors[c] = c;
+
+  // Start with the budget that reaches all the data when about one
+  // configuration is left.
+  const double rounds = std::ceil(std::log((double) survivors.size()) /
+      std::log(eta));
+  double budget = std::min(1.0, std::max(minBudget, std::pow(eta, -rounds)));
+
+  arma::vec objectives(configurations.n_cols);
+  while (true)
+  {
+    for (size_t s = 0; s < survivors.size(); ++s)
+    {
+      const arma::mat configuration = configurations.col(survivors[s]);
+      objectives[survivors[s]] = function.Evaluate(configuration, budget);
+
+      // Invalid scores are never the best.
+      if (std::isnan(objectives[survivors[s]]))
+        objectives[survivors[s]] = std::numeric_limits<double>::infinity();
+    }
+
+    if (budget == 1.0)
+      break;
+
+    // Keep the best 1 / eta of the configurations for the next round.
+    const size_t kept = std::max((size_t) 1,
+        (size_t) std::ceil(survivors.size() / eta));
+    std::stable_sort(survivors.begin(), survivors.end(),
+        [&objectives](const size_t a, const size_t b)
+        {
+          return objectives[a] < objectives[b];
+        });
+    survivors.resize(kept);
+
+    budget = (kept == 1 || budget * eta >= 1.0) ? 1.0 : budget * eta;
+  }
+
+  size_t best = survivors[0];
+  for (size_t s = 1; s < survivors.size(); ++s)
+  {
+    if (objectives[survivors[s]] < objectives[best])
+      best = survivors[s];
+  }
+
+  bestParameters = configurations.col(best);
+  return objectives[best];
+}
+
+} // namespace hpt
+} // namespace mlpack
+
+#endif
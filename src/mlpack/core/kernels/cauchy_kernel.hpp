@@ -68,6 +68,11 @@ class CauchyKernel
         std::pow(metric::EuclideanDistance::Evaluate(a, b) / bandwidth, 2)));
   }
 
+  //! Get the bandwidth.
+  double Bandwidth() const { return bandwidth; }
+  //! Modify the bandwidth.
+  double& Bandwidth() { return bandwidth; }
+
   /**
    * Serialize the kernel.
    */
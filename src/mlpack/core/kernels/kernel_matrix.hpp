@@ -0,0 +1,270 @@
+/**
+ * @file core/kernels/kernel_matrix.hpp
+ *
+ * Computation of the kernel matrix between two sets of points, or of a set of
+ * points with itself.  Kernels that are a function of the inner products and
+ * the norms of the points (including all the kernels of the distance between
+ * the points) are computed from a single matrix product; any other kernel is
+ * evaluated point by point, in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+#define MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/laplacian_kernel.hpp>
+#include <mlpack/core/kernels/polynomial_kernel.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
+#include <mlpack/core/kernels/cosine_distance.hpp>
+#include <mlpack/core/kernels/hyperbolic_tangent_kernel.hpp>
+#include <mlpack/core/kernels/epanechnikov_kernel.hpp>
+#include <mlpack/core/kernels/cauchy_kernel.hpp>
+#include <mlpack/core/kernels/triangular_kernel.hpp>
+#include <mlpack/core/kernels/spherical_kernel.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * KernelMatrixTraits describes how a kernel can be computed from the inner
+ * product of two points and from their squared norms, so that the kernel
+ * matrix of two sets of points can be computed from the product of the sets.
+ * By default a kernel is not assumed to have such a form, and it is evaluated
+ * on each pair of points.
+ *
+ * A specialization for a kernel sets UsesInnerProducts to true, sets UsesNorms
+ * to whether the squared norms are needed, and provides
+ *
+ * @code
+ * static double Apply(const KernelType& kernel,
+ *                     const double product,
+ *                     const double normA,
+ *                     const double normB);
+ * @endcode
+ *
+ * which returns K(a, b) given the inner product of a and b and their squared
+ * norms.
+ */
+template<typename KernelType>
+struct KernelMatrixTraits
+{
+  //! Whether the kernel is a function of the inner products of the points.
+  static const bool UsesInnerProducts = false;
+};
+
+//! The linear kernel is the inner product.
+template<>
+struct KernelMatrixTraits<LinearKernel>
+{
+  static const bool UsesInnerProducts = true;
+  static const bool UsesNorms = false;
+
+  static double Apply(const LinearKernel& /* kernel */,
+                      const double product,
+                      const double /* normA */,
+                      const double /* normB */)
+  {
+    return product;
+  }
+};
+
+//! The polynomial kernel is a power of the inner product.
+template<>
+struct KernelMatrixTraits<PolynomialKernel>
+{
+  static const bool UsesInnerProducts = true;
+  static const bool UsesNorms = false;
+
+  static double Apply(const PolynomialKernel& kernel,
+                      const double product,
+                      const double /* normA */,
+                      const double /* normB */)
+  {
+    return pow(product + kernel.Offset(), kernel.Degree());
+  }
+};
+
+//! The squared distance is ||a||^2 + ||b||^2 - 2 a^T b.
+template<>
+struct KernelMatrixTraits<GaussianKernel>
+{
+  static const bool UsesInnerProducts = true;
+  static const bool UsesNorms = true;
+
+  static double Apply(const GaussianKernel& kernel,
+                      const double product,
+                      const double normA,
+                      const double normB)
+  {
+    // Rounding can make the squared distance of close points negative.
+    return exp(kernel.Gamma() * std::max(normA + normB - 2.0 * product, 0.0));
+  }
+};
+
+//! The distance is the square root of ||a||^2 + ||b||^2 - 2 a^T b.
+template<>
+struct KernelMatrixTraits<LaplacianKernel>
+{
+  static const bool UsesInnerProducts = true;
+  static const bool UsesNorms = true;
+
+  static double Apply(const LaplacianKernel& kernel,
+                      const double product,
+                      const double normA,
+                      const double normB)
+  {
+    return exp(-std::sqrt(std::max(normA + normB - 2.0 * product, 0.0)) /
+        kernel.Bandwidth());
+  }
+};
+
+//! The cosine similarity is the inner product divided by the norms.
+template<>
+struct KernelMatrixTraits<CosineDistance>
+{
+  static const bool UsesInnerProducts = true;
+  static const bool UsesNorms = true;
+
+  static double Apply(const CosineDistance& /* kernel */,
+                      const double product,
+                      const double normA,
+                      const double normB)
+  {
+    // Like CosineDistance::Evaluate(), zero points have similarity 0.
+    const double denominator = std::sqrt(normA * normB);
+    return (denominator == 0.0) ? 0.0 : product / denominator;
+  }
+};
+
+//! The hyperbolic tangent kernel is a function of the inner product.
+template<>
+struct KernelMatrixTraits<HyperbolicTangentKernel>
+{
+  static const bool UsesInnerProducts = true;
+  static const bool UsesNorms = false;
+
+  static double Apply(const HyperbolicTangentKernel& kernel,
+                      const double product,
+                      const double /* normA */,
+                      const double /* normB */)
+  {
+    return tanh(kernel.Scale() * product + kernel.Offset());
+  }
+};
+
+//! The Epanechnikov kernel is a function of the squared distance.
+template<>
+struct KernelMatrixTraits<EpanechnikovKernel>
+{
+  static const bool UsesInnerProducts = true;
+  static const bool UsesNorms = true;
+
+  static double Apply(const EpanechnikovKernel& kernel,
+                      const double product,
+                      const double normA,
+                      const double normB)
+  {
+    return std::max(0.0, 1.0 - std::max(normA + normB - 2.0 * product, 0.0) /
+        (kernel.Bandwidth() * kernel.Bandwidth()));
+  }
+};
+
+//! The Cauchy kernel is a function of the squared distance.
+template<>
+struct KernelMatrixTraits<CauchyKernel>
+{
+  static const bool UsesInnerProducts = true;
+  static const bool UsesNorms = true;
+
+  static double Apply(const CauchyKernel& kernel,
+                      const double product,
+                      const double normA,
+                      const double normB)
+  {
+    return 1.0 / (1.0 + std::max(normA + normB - 2.0 * product, 0.0) /
+        (kernel.Bandwidth() * kernel.Bandwidth()));
+  }
+};
+
+//! The triangular kernel is a function of the distance.
+template<>
+struct KernelMatrixTraits<TriangularKernel>
+{
+  static const bool UsesInnerProducts = true;
+  static const bool UsesNorms = true;
+
+  static double Apply(const TriangularKernel& kernel,
+                      const double product,
+                      const double normA,
+                      const double normB)
+  {
+    return std::max(0.0, 1.0 - std::sqrt(std::max(normA + normB -
+        2.0 * product, 0.0)) / kernel.Bandwidth());
+  }
+};
+
+//! The spherical kernel is 1 within the bandwidth, and 0 outside.
+template<>
+struct KernelMatrixTraits<SphericalKernel>
+{
+  static const bool UsesInnerProducts = true;
+  static const bool UsesNorms = true;
+
+  static double Apply(const SphericalKernel& kernel,
+                      const double product,
+                      const double normA,
+                      const double normB)
+  {
+    return (normA + normB - 2.0 * product <=
+        kernel.Bandwidth() * kernel.Bandwidth()) ? 1.0 : 0.0;
+  }
+};
+
+/**
+ * Compute the kernel matrix between two sets of points, so that output(i, j)
+ * is K(a.col(i), b.col(j)).  If KernelMatrixTraits of the kernel says that it
+ * is a function of the inner products, the matrix is computed with one matrix
+ * product of the sets, and the kernel is then applied to the columns of the
+ * result in parallel.  Otherwise, the columns of the result are evaluated in
+ * parallel, one pair of points at a time.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param a First set of points, one point per column.
+ * @param b Second set of points, one point per column.
+ * @param output Will hold the kernel matrix, with a.n_cols rows and b.n_cols
+ *     columns.
+ */
+template<typename KernelType, typename MatTypeA, typename MatTypeB>
+void KernelMatrix(KernelType& kernel,
+                  const MatTypeA& a,
+                  const MatTypeB& b,
+                  arma::mat& output);
+
+/**
+ * Compute the kernel matrix of a set of points with itself, so that
+ * output(i, j) is K(data.col(i), data.col(j)).  The kernel is assumed to be
+ * symmetric, so when it is evaluated point by point only the upper triangular
+ * part of the matrix is evaluated.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param data Set of points, one point per column.
+ * @param output Will hold the symmetric kernel matrix, with data.n_cols rows
+ *     and columns.
+ */
+template<typename KernelType, typename MatType>
+void KernelMatrix(KernelType& kernel,
+                  const MatType& data,
+                  arma::mat& output);
+
+} // namespace kernel
+} // namespace mlpack
+
+// Include implementation.
+#include "kernel_matrix_impl.hpp"
+
+#endif
@@ -0,0 +1,151 @@
+/**
+ * @file core/kernels/kernel_matrix_impl.hpp
+ *
+ * Implementation of the computation of kernel matrices.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_KERNEL_MATRIX_IMPL_HPP
+#define MLPACK_CORE_KERNELS_KERNEL_MATRIX_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kernel_matrix.hpp"
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * Apply the kernel to a matrix of inner products, in place, in parallel over
+ * its columns.
+ */
+template<typename KernelType>
+void ApplyKernelToProducts(const KernelType& kernel,
+                           const arma::rowvec& normsA,
+                           const arma::rowvec& normsB,
+                           arma::mat& products)
+{
+  typedef KernelMatrixTraits<KernelType> Traits;
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t j = 0; j < (omp_size_t) products.n_cols; ++j)
+  {
+    double* column = products.colptr(j);
+    const double normB = Traits::UsesNorms ? normsB[j] : 0.0;
+    for (size_t i = 0; i < products.n_rows; ++i)
+    {
+      column[i] = Traits::Apply(kernel, column[i],
+          Traits::UsesNorms ? normsA[i] : 0.0, normB);
+    }
+  }
+}
+
+//! Compute the kernel matrix of two sets from the product of the sets.
+template<typename KernelType, typename MatTypeA, typename MatTypeB>
+void KernelMatrix(const KernelType& kernel,
+                  const MatTypeA& a,
+                  const MatTypeB& b,
+                  arma::mat& output,
+                  const std::true_type /* usesInnerProducts */)
+{
+  output = a.t() * b;
+
+  arma::rowvec normsA, normsB;
+  if (KernelMatrixTraits<KernelType>::UsesNorms)
+  {
+    normsA = arma::sum(arma::square(a), 0);
+    normsB = arma::sum(arma::square(b), 0);
+  }
+
+  ApplyKernelToProducts(kernel, normsA, normsB, output);
+}
+
+//! Compute the kernel matrix of two sets one pair of points at a time.
+template<typename KernelType, typename MatTypeA, typename MatTypeB>
+void KernelMatrix(KernelType& kernel,
+                  const MatTypeA& a,
+                  const MatTypeB& b,
+                  arma::mat& output,
+                  const std::false_type /* usesInnerProducts */)
+{
+  output.set_size(a.n_cols, b.n_cols);
+
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t j = 0; j < (omp_size_t) b.n_cols; ++j)
+    for (size_t i = 0; i < a.n_cols; ++i)
+      output(i, j) = kernel.Evaluate(a.col(i), b.col(j));
+}
+
+//! Compute the kernel matrix of a set from the product of the set with itself.
+template<typename KernelType, typename MatType>
+void KernelMatrix(const KernelType& kernel,
+                  const MatType& data,
+                  arma::mat& output,
+                  const std::true_type /* usesInnerProducts */)
+{
+  output = data.t() * data;
+
+  // The squared distance of each point to itself must be exactly zero, or
+  // else kernels like the Laplacian kernel amplify its rounding error.
+  arma::rowvec norms;
+  if (KernelMatrixTraits<KernelType>::UsesNorms)
+  {
+    norms = arma::sum(arma::square(data), 0);
+    output.diag() = norms.t();
+  }
+
+  ApplyKernelToProducts(kernel, norms, norms, output);
+}
+
+//! Compute the kernel matrix of a set one pair of points at a time.
+template<typename KernelType, typename MatType>
+void KernelMatrix(KernelType& kernel,
+                  const MatType& data,
+                  arma::mat& output,
+                  const std::false_type /* usesInnerProducts */)
+{
+  output.set_size(data.n_cols, data.n_cols);
+
+  // Only the upper triangular part is evaluated, since the matrix is
+  // symmetric.  The columns get longer, so they are scheduled dynamically.
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+    for (size_t i = 0; i <= (size_t) j; ++i)
+      output(i, j) = kernel.Evaluate(data.col(i), data.col(j));
+
+  output = arma::symmatu(output);
+}
+
+template<typename KernelType, typename MatTypeA, typename MatTypeB>
+void KernelMatrix(KernelType& kernel,
+                  const MatTypeA& a,
+                  const MatTypeB& b,
+                  arma::mat& output)
+{
+  if (a.n_rows != b.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "KernelMatrix(): the two sets of points have different "
+        << "dimensionalities (" << a.n_rows << " and " << b.n_rows << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  KernelMatrix(kernel, a, b, output, std::integral_constant<bool,
+      KernelMatrixTraits<KernelType>::UsesInnerProducts>());
+}
+
+template<typename KernelType, typename MatType>
+void KernelMatrix(KernelType& kernel,
+                  const MatType& data,
+                  arma::mat& output)
+{
+  KernelMatrix(kernel, data, output, std::integral_constant<bool,
+      KernelMatrixTraits<KernelType>::UsesInnerProducts>());
+}
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
@@ -22,6 +22,9 @@ namespace kernel {
  * kernels, and each kernel should override values as necessary.  If a kernel
  * doesn't need to override a value, then there's no need to write a
  * KernelTraits specialization for that class.
+ *
+ * How a kernel matrix of two sets of points can be computed in one batch is
+ * described separately, by KernelMatrixTraits (see kernel_matrix.hpp).
  */
 template<typename KernelType>
 class KernelTraits
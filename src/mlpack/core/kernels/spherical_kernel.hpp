@@ -102,6 +102,9 @@ class SphericalKernel
     return t == bandwidth ? arma::datum::nan : 0.0;
   }
 
+  //! Get the bandwidth.
+  double Bandwidth() const { return bandwidth; }
+
   //! Serialize the object.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -19,6 +19,72 @@
 namespace mlpack {
 namespace math /** Miscellaneous math routines. */ {
 
+/**
+ * CovarianceAccumulator computes the mean and the covariance of a stream of
+ * points, given in blocks of columns.  Each block is centered on its own mean
+ * and merged into the running statistics with the pairwise update of Chan et
+ * al. (1979), which is numerically stable; two accumulators of disjoint sets
+ * of points can be merged too, so that parts of a dataset can be handled
+ * separately (for instance by different threads) and then combined.
+ *
+ * @code
+ * CovarianceAccumulator<double> accumulator;
+ * while (...)
+ *   accumulator.Update(block);
+ * arma::mat covariance = accumulator.Covariance();
+ * @endcode
+ */
+template<typename eT>
+class CovarianceAccumulator
+{
+ public:
+  //! Create an accumulator with no points.
+  CovarianceAccumulator() : count(0) { }
+
+  /**
+   * Add the given points (one per column) to the statistics.  Large chunks
+   * are processed in parallel.
+   *
+   * @param points Points to add.
+   */
+  void Update(const arma::Mat<eT>& points);
+
+  /**
+   * Merge the statistics of another set of points into these.
+   *
+   * @param other Accumulator of the other points.
+   */
+  void Merge(const CovarianceAccumulator& other);
+
+  /**
+   * Return the covariance of the points.
+   *
+   * @param normType If 0, normalize by n - 1 (or by 1 for a single point); if
+   *     1, normalize by n.
+   */
+  arma::Mat<eT> Covariance(const size_t normType = 0) const;
+
+  //! Get the number of points.
+  size_t Count() const { return count; }
+  //! Get the mean of the points.
+  const arma::Col<eT>& Mean() const { return mean; }
+  //! Get the sum of the outer products of the deviations from the mean.
+  const arma::Mat<eT>& Scatter() const { return scatter; }
+
+ private:
+  //! Add the points in the given range of columns, serially.
+  void UpdateRange(const arma::Mat<eT>& points,
+                   const size_t begin,
+                   const size_t end);
+
+  //! The number of points.
+  size_t count;
+  //! The mean of the points.
+  arma::Col<eT> mean;
+  //! The sum of the outer products of the deviations from the mean.
+  arma::Mat<eT> scatter;
+};
+
 template<typename eT>
 inline
 arma::Mat<eT>
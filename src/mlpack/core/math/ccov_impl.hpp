@@ -3,7 +3,8 @@
  * @author Ryan Curtin
  * @author Conrad Sanderson
  *
- * ColumnCovariance(X) is same as cov(trans(X)) but without the cost of computing trans(X)
+ * ColumnCovariance(X) is same as cov(trans(X)) but without the cost of
+ * computing trans(X)
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -37,16 +38,108 @@ inline arma::Mat<eT> ColumnCovariance(const arma::Mat<eT>& x,
         arma::Mat<eT>(const_cast<eT*>(x.memptr()), x.n_rows, x.n_cols, false,
             false);
 
-    const size_t n = xAlias.n_cols;
-    const eT normVal = (normType == 0) ? ((n > 1) ? eT(n - 1) : eT(1)) : eT(n);
+    // The accumulator centers the points in blocks, so the whole centered
+    // matrix is never stored.
+    CovarianceAccumulator<eT> accumulator;
+    accumulator.Update(xAlias);
+    out = accumulator.Covariance(normType);
+  }
 
-    const arma::Mat<eT> tmp = xAlias.each_col() - arma::mean(xAlias, 1);
+  return out;
+}
 
-    out = tmp * tmp.t();
-    out /= normVal;
+template<typename eT>
+void CovarianceAccumulator<eT>::Update(const arma::Mat<eT>& points)
+{
+  // Only split chunks that are big enough to be worth it; each chunk has its
+  // own scatter matrix, so very high-dimensional points are not split.
+  size_t numBlocks = 1;
+  if (points.n_rows <= 1024)
+    numBlocks = ParallelPolicy::Current().NumBlocks(points.n_cols, 4096);
+
+  if (numBlocks <= 1)
+  {
+    UpdateRange(points, 0, points.n_cols);
+    return;
   }
 
-  return out;
+  // Each block gets its own accumulator, and they are merged in order.
+  std::vector<CovarianceAccumulator> blocks(numBlocks);
+  const size_t blockSize = (points.n_cols + numBlocks - 1) / numBlocks;
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = (size_t) b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) points.n_cols);
+    blocks[b].UpdateRange(points, begin, end);
+  }
+
+  for (size_t b = 0; b < numBlocks; ++b)
+    Merge(blocks[b]);
+}
+
+template<typename eT>
+void CovarianceAccumulator<eT>::UpdateRange(const arma::Mat<eT>& points,
+                                            const size_t begin,
+                                            const size_t end)
+{
+  // The points are centered in pieces, so that the centered copy stays small.
+  const size_t pieceSize = 4096;
+  for (size_t first = begin; first < end; first += pieceSize)
+  {
+    const size_t last = std::min(first + pieceSize, end);
+    CovarianceAccumulator piece;
+    piece.count = last - first;
+    piece.mean = arma::mean(points.cols(first, last - 1), 1);
+    const arma::Mat<eT> centered = points.cols(first, last - 1).each_col() -
+        piece.mean;
+    piece.scatter = centered * centered.t();
+    Merge(piece);
+  }
+}
+
+template<typename eT>
+void CovarianceAccumulator<eT>::Merge(const CovarianceAccumulator& other)
+{
+  if (other.count == 0)
+    return;
+
+  if (count == 0)
+  {
+    *this = other;
+    return;
+  }
+
+  if (other.mean.n_elem != mean.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "CovarianceAccumulator::Merge(): the points have different "
+        << "dimensionalities (" << mean.n_elem << " and " << other.mean.n_elem
+        << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const eT n = eT(count + other.count);
+  const arma::Col<eT> delta = other.mean - mean;
+  scatter += other.scatter + (delta * delta.t()) * (eT(count) *
+      eT(other.count) / n);
+  mean += delta * (eT(other.count) / n);
+  count += other.count;
+}
+
+template<typename eT>
+arma::Mat<eT> CovarianceAccumulator<eT>::Covariance(const size_t normType)
+    const
+{
+  if (normType > 1)
+  {
+    Log::Fatal << "CovarianceAccumulator::Covariance(): normType must be 0 or "
+        << "1!" << std::endl;
+  }
+
+  const eT normVal = (normType == 0) ? ((count > 1) ? eT(count - 1) : eT(1)) :
+      eT(count);
+  return scatter / normVal;
 }
 
 template<typename T>
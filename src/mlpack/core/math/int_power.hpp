@@ -0,0 +1,70 @@
+/**
+ * @file core/math/int_power.hpp
+ *
+ * Computation of a compile-time integer power of a number with
+ * multiplications.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_INT_POWER_HPP
+#define MLPACK_CORE_MATH_INT_POWER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * IntPowerImpl<Power>::Apply(x) computes x^Power by squaring, so that the
+ * compiler unrolls it into a few multiplications.  Use IntPower() instead.
+ */
+template<int Power>
+struct IntPowerImpl
+{
+  static_assert(Power >= 0, "IntPower(): the power must be nonnegative");
+
+  template<typename T>
+  static T Apply(const T x)
+  {
+    const T half = IntPowerImpl<Power / 2>::Apply(x);
+    return (Power % 2 == 0) ? half * half : half * half * x;
+  }
+};
+
+//! x^1 is x.
+template<>
+struct IntPowerImpl<1>
+{
+  template<typename T>
+  static T Apply(const T x) { return x; }
+};
+
+//! x^0 is 1.
+template<>
+struct IntPowerImpl<0>
+{
+  template<typename T>
+  static T Apply(const T /* x */) { return T(1); }
+};
+
+/**
+ * Compute x^Power for a nonnegative integer Power known at compile time.  This
+ * is much faster than std::pow(), and it can be vectorized in loops; the
+ * bounds of the trees use it for the powers of the LMetric.
+ *
+ * @param x Number to raise to the power.
+ * @return x^Power.
+ */
+template<int Power, typename T>
+inline T IntPower(const T x)
+{
+  return IntPowerImpl<Power>::Apply(x);
+}
+
+} // namespace math
+} // namespace mlpack
+
+#endif
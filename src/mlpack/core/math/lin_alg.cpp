@@ -42,10 +42,44 @@ void mlpack::math::VectorPower(arma::vec& vec, const double power)
  */
 void mlpack::math::Center(const arma::mat& x, arma::mat& xCentered)
 {
+  if (&x == &xCentered)
+  {
+    Center(xCentered);
+    return;
+  }
+
   // Get the mean of the elements in each row.
-  arma::vec rowMean = arma::sum(x, 1) / x.n_cols;
+  const arma::vec rowMean = arma::sum(x, 1) / x.n_cols;
+
+  // Write the centered columns directly, without a repeated copy of the mean.
+  xCentered.set_size(x.n_rows, x.n_cols);
+  #pragma omp parallel for schedule(static) if (x.n_elem > 65536)
+  for (omp_size_t j = 0; j < (omp_size_t) x.n_cols; ++j)
+  {
+    const double* in = x.colptr(j);
+    double* out = xCentered.colptr(j);
+    for (size_t i = 0; i < x.n_rows; ++i)
+      out[i] = in[i] - rowMean[i];
+  }
+}
 
-  xCentered = x - arma::repmat(rowMean, 1, x.n_cols);
+/**
+ * Centers a matrix in place, by subtracting the mean of the columns from each
+ * column.
+ *
+ * @param x Matrix to center
+ */
+void mlpack::math::Center(arma::mat& x)
+{
+  const arma::vec rowMean = arma::sum(x, 1) / x.n_cols;
+
+  #pragma omp parallel for schedule(static) if (x.n_elem > 65536)
+  for (omp_size_t j = 0; j < (omp_size_t) x.n_cols; ++j)
+  {
+    double* column = x.colptr(j);
+    for (size_t i = 0; i < x.n_rows; ++i)
+      column[i] -= rowMean[i];
+  }
 }
 
 /**
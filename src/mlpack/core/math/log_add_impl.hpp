@@ -50,7 +50,7 @@ T LogAdd(T x, T y)
   if (std::isinf(d) || std::isinf(r))
     return r;
 
-  return r + log(1 + exp(d));
+  return r + std::log1p(std::exp(d));
 }
 
 /**
@@ -63,42 +63,81 @@ template<typename T>
 typename T::elem_type AccuLog(const T& x)
 {
   typename T::elem_type maxVal = max(x);
-  if (maxVal == -std::numeric_limits<typename T::elem_type>::infinity())
+  if (std::isinf(maxVal))
     return maxVal;
 
-  return maxVal + log(sum(exp(x - maxVal)));;
+  // accu() evaluates the exponentials without a temporary vector.
+  return maxVal + std::log(arma::accu(arma::exp(x - maxVal)));
 }
 
 /**
- * Compute the sum of exponentials of each element in each column, then compute
- * the log of that.  If InPlace is true, then the values of `y` will also be
- * added to the sum.
+ * Compute log(sum(exp(x.row(i)))) for each row i in [begin, end) of the given
+ * matrix, with two passes over the rows (the first finds the maximum of each
+ * row, so that the exponentials cannot overflow).  If InPlace is true, y[i] is
+ * added to the sum.  The inner loops run over contiguous elements of each
+ * column, so they can be vectorized.
  */
-template<typename T, bool InPlace>
-void LogSumExp(const T& x, arma::Col<typename T::elem_type>& y)
+template<typename eT, bool InPlace>
+void LogSumExpRows(const arma::Mat<eT>& x,
+                   arma::Col<eT>& y,
+                   const size_t begin,
+                   const size_t end)
 {
-  arma::Col<typename T::elem_type> maxs;
-
+  const size_t n = end - begin;
+  arma::Col<eT> maxs(n), sums(n, arma::fill::zeros);
   if (InPlace)
-  {
-    // Compute the maximum in each column (treating y as a column too).
-    maxs = max(max(x, 1), y);
+    maxs = y.subvec(begin, end - 1);
+  else
+    maxs.fill(-std::numeric_limits<eT>::infinity());
 
-    y = maxs + log(sum(exp(x - repmat(maxs, 1, x.n_cols)), 1) +
-        exp(y - maxs));
+  for (size_t j = 0; j < x.n_cols; ++j)
+  {
+    const eT* column = x.colptr(j) + begin;
+    for (size_t i = 0; i < n; ++i)
+      maxs[i] = std::max(maxs[i], column[i]);
   }
-  else
+
+  for (size_t j = 0; j < x.n_cols; ++j)
   {
-    // Compute the maximum element in each column.
-    maxs = max(x, 1);
+    const eT* column = x.colptr(j) + begin;
+    for (size_t i = 0; i < n; ++i)
+      sums[i] += std::exp(column[i] - maxs[i]);
+  }
 
-    y = maxs + log(sum(exp(x - repmat(maxs, 1, x.n_cols)), 1));
+  // If the maximum is infinite, so is the result (and the sum is NaN).
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (InPlace)
+      sums[i] += std::exp(y[begin + i] - maxs[i]);
+    y[begin + i] = std::isinf(maxs[i]) ? maxs[i] :
+        maxs[i] + std::log(sums[i]);
   }
+}
 
-  if (maxs.has_inf())
+/**
+ * Compute the sum of exponentials of each element in each column, then compute
+ * the log of that.  If InPlace is true, then the values of `y` will also be
+ * added to the sum.
+ */
+template<typename T, bool InPlace>
+void LogSumExp(const T& x, arma::Col<typename T::elem_type>& y)
+{
+  typedef typename T::elem_type ElemType;
+  const arma::Mat<ElemType>& data = x;
+  if (!InPlace)
+    y.set_size(data.n_rows);
+
+  // Large matrices are split into blocks of rows, which are handled in
+  // parallel.
+  const size_t blockSize = 256;
+  const size_t numBlocks = (data.n_rows + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for schedule(static) \
+      if (numBlocks > 1 && data.n_elem > 65536)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    y.replace(-std::numeric_limits<typename T::elem_type>::quiet_NaN(),
-              -std::numeric_limits<typename T::elem_type>::infinity());
+    LogSumExpRows<ElemType, InPlace>(data, y, b * blockSize,
+        std::min((size_t) (b + 1) * blockSize, (size_t) data.n_rows));
   }
 }
 
@@ -110,28 +149,33 @@ void LogSumExp(const T& x, arma::Col<typename T::elem_type>& y)
 template<typename T, bool InPlace>
 void LogSumExpT(const T& x, arma::Col<typename T::elem_type>& y)
 {
-  arma::Row<typename T::elem_type> maxs;
-
-  if (InPlace)
-  {
-    // Compute the maximum element in each column.
-    maxs = max(max(x, 0), y.t());
-
-    y = maxs.t() + log(sum(exp(x - repmat(maxs, x.n_rows, 1)), 0) +
-        exp(y.t() - maxs)).t();
-  }
-  else
-  {
-    // Compute the maximum element in each column.
-    arma::Row<typename T::elem_type> maxs = max(x, 0);
-
-    y = (maxs + log(sum(exp(x - repmat(maxs, x.n_rows, 1)), 0))).t();
-  }
-
-  if (maxs.has_inf())
+  typedef typename T::elem_type ElemType;
+  const arma::Mat<ElemType>& data = x;
+  if (!InPlace)
+    y.set_size(data.n_cols);
+
+  // Each column is contiguous, so it is still in cache for the second pass.
+  #pragma omp parallel for schedule(static) if (data.n_elem > 65536)
+  for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
   {
-    y.replace(-std::numeric_limits<typename T::elem_type>::quiet_NaN(),
-              -std::numeric_limits<typename T::elem_type>::infinity());
+    const ElemType* column = data.colptr(j);
+    ElemType maxVal = InPlace ? y[j] :
+        -std::numeric_limits<ElemType>::infinity();
+    for (size_t i = 0; i < data.n_rows; ++i)
+      maxVal = std::max(maxVal, column[i]);
+
+    // If the maximum is infinite, so is the result.
+    if (std::isinf(maxVal))
+    {
+      y[j] = maxVal;
+      continue;
+    }
+
+    ElemType sum = InPlace ? std::exp(y[j] - maxVal) : 0;
+    for (size_t i = 0; i < data.n_rows; ++i)
+      sum += std::exp(column[i] - maxVal);
+
+    y[j] = maxVal + std::log(sum);
   }
 }
 
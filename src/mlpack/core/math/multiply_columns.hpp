@@ -0,0 +1,171 @@
+/**
+ * @file core/math/multiply_columns.hpp
+ *
+ * Products of a dense matrix with a range of columns of a dense or sparse
+ * dataset, as needed by the batch objectives of linear models.  The range may
+ * be taken through an ordering of the points, so that the objectives can be
+ * shuffled without copying the dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_MULTIPLY_COLUMNS_HPP
+#define MLPACK_CORE_MATH_MULTIPLY_COLUMNS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace math /** Miscellaneous math routines. */ {
+
+/**
+ * Compute output = weights * data.cols(begin, begin + count - 1) for a dense
+ * dataset.
+ *
+ * @param weights Dense matrix with one column per dimension of the data.
+ * @param data Dataset, one point per column.
+ * @param begin Index of the first point.
+ * @param count Number of points.
+ * @param output Will hold the product, one column per point.
+ * @param ordering If not empty, the points of the range are the columns
+ *     ordering[begin] to ordering[begin + count - 1] of the data.
+ */
+template<typename MatType>
+void MultiplyColumns(const arma::mat& weights,
+                     const MatType& data,
+                     const size_t begin,
+                     const size_t count,
+                     arma::mat& output,
+                     const arma::uvec& ordering = arma::uvec(),
+                     const std::enable_if_t<
+                         !arma::is_SpMat<MatType>::value>* = 0)
+{
+  if (ordering.is_empty())
+    output = weights * data.cols(begin, begin + count - 1);
+  else
+    output = weights * data.cols(ordering.subvec(begin, begin + count - 1));
+}
+
+/**
+ * Compute output = weights * data.cols(begin, begin + count - 1) for a sparse
+ * dataset, directly from its compressed columns: each nonzero adds a column of
+ * weights to the column of its point, so the data is neither copied nor
+ * densified.  The points are processed in parallel.
+ *
+ * @param weights Dense matrix with one column per dimension of the data.
+ * @param data Dataset, one point per column.
+ * @param begin Index of the first point.
+ * @param count Number of points.
+ * @param output Will hold the product, one column per point.
+ * @param ordering If not empty, the points of the range are the columns
+ *     ordering[begin] to ordering[begin + count - 1] of the data.
+ */
+template<typename MatType>
+void MultiplyColumns(const arma::mat& weights,
+                     const MatType& data,
+                     const size_t begin,
+                     const size_t count,
+                     arma::mat& output,
+                     const arma::uvec& ordering = arma::uvec(),
+                     const std::enable_if_t<
+                         arma::is_SpMat<MatType>::value>* = 0)
+{
+  data.sync();
+  output.zeros(weights.n_rows, count);
+
+  // Estimate the number of nonzeros of an ordered range from the density.
+  const size_t nonzeros = ordering.is_empty() ?
+      data.col_ptrs[begin + count] - data.col_ptrs[begin] :
+      (size_t) (count * ((double) data.n_nonzero / data.n_cols));
+
+  #pragma omp parallel for schedule(static) if (nonzeros >= 16384)
+  for (omp_size_t c = 0; c < (omp_size_t) count; ++c)
+  {
+    double* out = output.colptr(c);
+    const size_t col = ordering.is_empty() ? begin + (size_t) c :
+        (size_t) ordering[begin + (size_t) c];
+    for (size_t k = data.col_ptrs[col]; k < data.col_ptrs[col + 1]; ++k)
+    {
+      const double value = data.values[k];
+      const double* w = weights.colptr(data.row_indices[k]);
+      for (size_t r = 0; r < weights.n_rows; ++r)
+        out[r] += value * w[r];
+    }
+  }
+}
+
+/**
+ * Compute output = factors * data.cols(begin, begin + count - 1).t() for a
+ * dense dataset.
+ *
+ * @param factors Dense matrix with one column per point.
+ * @param data Dataset, one point per column.
+ * @param begin Index of the first point.
+ * @param count Number of points.
+ * @param output Will hold the product, one column per dimension of the data.
+ * @param ordering If not empty, the points of the range are the columns
+ *     ordering[begin] to ordering[begin + count - 1] of the data.
+ */
+template<typename MatType>
+void MultiplyColumnsTrans(const arma::mat& factors,
+                          const MatType& data,
+                          const size_t begin,
+                          const size_t count,
+                          arma::mat& output,
+                          const arma::uvec& ordering = arma::uvec(),
+                          const std::enable_if_t<
+                              !arma::is_SpMat<MatType>::value>* = 0)
+{
+  if (ordering.is_empty())
+    output = factors * data.cols(begin, begin + count - 1).t();
+  else
+    output = factors * data.cols(ordering.subvec(begin, begin + count - 1)).t();
+}
+
+/**
+ * Compute output = factors * data.cols(begin, begin + count - 1).t() for a
+ * sparse dataset, directly from its compressed columns: each nonzero adds the
+ * column of factors of its point to the column of its dimension, so no
+ * transpose of the data is built.
+ *
+ * @param factors Dense matrix with one column per point.
+ * @param data Dataset, one point per column.
+ * @param begin Index of the first point.
+ * @param count Number of points.
+ * @param output Will hold the product, one column per dimension of the data.
+ * @param ordering If not empty, the points of the range are the columns
+ *     ordering[begin] to ordering[begin + count - 1] of the data.
+ */
+template<typename MatType>
+void MultiplyColumnsTrans(const arma::mat& factors,
+                          const MatType& data,
+                          const size_t begin,
+                          const size_t count,
+                          arma::mat& output,
+                          const arma::uvec& ordering = arma::uvec(),
+                          const std::enable_if_t<
+                              arma::is_SpMat<MatType>::value>* = 0)
+{
+  data.sync();
+  output.zeros(factors.n_rows, data.n_rows);
+
+  for (size_t c = 0; c < count; ++c)
+  {
+    const double* f = factors.colptr(c);
+    const size_t col = ordering.is_empty() ? begin + c :
+        (size_t) ordering[begin + c];
+    for (size_t k = data.col_ptrs[col]; k < data.col_ptrs[col + 1]; ++k)
+    {
+      const double value = data.values[k];
+      double* out = output.colptr(data.row_indices[k]);
+      for (size_t r = 0; r < factors.n_rows; ++r)
+        out[r] += value * f[r];
+    }
+  }
+}
+
+} // namespace math
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,97 @@
+/**
+ * @file core/math/pairwise_distances.hpp
+ *
+ * Computation of the squared Euclidean distances between each point of a set
+ * and each point of another set, with one matrix product.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_PAIRWISE_DISTANCES_HPP
+#define MLPACK_CORE_MATH_PAIRWISE_DISTANCES_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * Compute the squared Euclidean distance between each point of a and each
+ * point of b, so that distances(i, j) = ||a.col(i) - b.col(j)||^2, given the
+ * squared norms of the points.  The distances are computed as
+ * ||a||^2 + ||b||^2 - 2 a^T b, so all the inner products are given by one
+ * matrix product (which the BLAS computes in blocks, with SIMD instructions),
+ * and the norms are then added to the columns of the result in parallel.
+ * This form loses some precision for close points, whose distances can be off
+ * by a few machine epsilons of the squared norms; negative results are set to
+ * 0.
+ *
+ * Pass the norms when they are reused across calls, for instance when a set of
+ * points is compared with different blocks of another set.
+ *
+ * @param a First set of points, one point per column.
+ * @param b Second set of points, one point per column.
+ * @param normsA Squared norms of the points of a.
+ * @param normsB Squared norms of the points of b.
+ * @param distances Will hold the squared distances, with a.n_cols rows and
+ *     b.n_cols columns.
+ */
+template<typename MatTypeA, typename MatTypeB>
+void PairwiseSquaredDistances(const MatTypeA& a,
+                              const MatTypeB& b,
+                              const arma::vec& normsA,
+                              const arma::vec& normsB,
+                              arma::mat& distances)
+{
+  if (a.n_rows != b.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "PairwiseSquaredDistances(): the two sets of points have different "
+        << "dimensionalities (" << a.n_rows << " and " << b.n_rows << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (normsA.n_elem != a.n_cols || normsB.n_elem != b.n_cols)
+  {
+    throw std::invalid_argument("PairwiseSquaredDistances(): the number of "
+        "norms does not match the number of points");
+  }
+
+  distances = a.t() * b;
+
+  #pragma omp parallel for schedule(static) if (distances.n_elem > 65536)
+  for (omp_size_t j = 0; j < (omp_size_t) distances.n_cols; ++j)
+  {
+    double* column = distances.colptr(j);
+    const double normB = normsB[j];
+    for (size_t i = 0; i < distances.n_rows; ++i)
+      column[i] = std::max(normsA[i] + normB - 2.0 * column[i], 0.0);
+  }
+}
+
+/**
+ * Compute the squared Euclidean distance between each point of a and each
+ * point of b, so that distances(i, j) = ||a.col(i) - b.col(j)||^2.  See the
+ * other overload for details.
+ *
+ * @param a First set of points, one point per column.
+ * @param b Second set of points, one point per column.
+ * @param distances Will hold the squared distances, with a.n_cols rows and
+ *     b.n_cols columns.
+ */
+template<typename MatTypeA, typename MatTypeB>
+void PairwiseSquaredDistances(const MatTypeA& a,
+                              const MatTypeB& b,
+                              arma::mat& distances)
+{
+  const arma::vec normsA = arma::sum(arma::square(a), 0).t();
+  const arma::vec normsB = arma::sum(arma::square(b), 0).t();
+  PairwiseSquaredDistances(a, b, normsA, normsB, distances);
+}
+
+} // namespace math
+} // namespace mlpack
+
+#endif
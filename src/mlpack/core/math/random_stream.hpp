@@ -0,0 +1,353 @@
+/**
+ * @file core/math/random_stream.hpp
+ *
+ * Definition of the RandomStream class, a counter-based random number
+ * generator that can be split into independent streams for parallel tasks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_RANDOM_STREAM_HPP
+#define MLPACK_CORE_MATH_RANDOM_STREAM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "random.hpp"
+
+namespace mlpack {
+namespace math {
+
+/**
+ * RandomStream is a counter-based random number generator: the n'th block of
+ * random bits of a stream is the Philox4x32-10 function (Salmon et al., 2011)
+ * of the seed, the stream identifier and n.  So any position of a stream can
+ * be computed directly, and a stream can be split into any number of
+ * independent streams with Split().
+ *
+ * The global generator used by Random(), RandInt() and RandNormal() must not
+ * be used from several threads at once, and the numbers a thread gets from it
+ * depend on the number of threads.  Instead, parallel code should draw a
+ * stream with NewRandomStream() before the parallel region (which uses the
+ * global generator, so the stream follows RandomSeed()), and give each task
+ * its own stream with Split(task).  Then the results only depend on the seed
+ * and not on the number of threads or the schedule.
+ *
+ * @code
+ * math::RandomStream stream = math::NewRandomStream();
+ * #pragma omp parallel for
+ * for (omp_size_t i = 0; i < n; ++i)
+ * {
+ *   math::RandomStream taskStream = stream.Split(i);
+ *   const double u = taskStream.Random();
+ *   ...
+ * }
+ * @endcode
+ *
+ * Randu() and Randn() fill whole matrices; large matrices are filled in
+ * parallel, with the same result as a serial fill.  Randu() gives the same
+ * numbers as repeated calls to Random().
+ *
+ * RandomStream also satisfies the UniformRandomBitGenerator requirements, so
+ * it can be used with the distributions of the standard library.
+ */
+class RandomStream
+{
+ public:
+  //! The type of the random words.
+  typedef uint32_t result_type;
+
+  //! The smallest random word.
+  static constexpr result_type min() { return 0; }
+  //! The largest random word.
+  static constexpr result_type max() { return 0xFFFFFFFF; }
+
+  /**
+   * Create the stream with the given seed and stream identifier, at its first
+   * position.
+   *
+   * @param seed Seed of the stream.
+   * @param stream Identifier of the stream.
+   */
+  RandomStream(const uint64_t seed = 0, const uint64_t stream = 0) :
+      seed(seed),
+      stream(stream),
+      position(0),
+      bufferBlock(UINT64_MAX)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Return a new stream, independent of this one and of the streams split
+   * with other task indices, at its first position.  The new stream does not
+   * depend on the position of this stream.
+   *
+   * @param task Index of the task the stream is for.
+   */
+  RandomStream Split(const uint64_t task) const
+  {
+    // The SplitMix64 finalizer spreads the task index over the identifier.
+    uint64_t z = stream * 0x9E3779B97F4A7C15ULL + task + 1;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return RandomStream(seed, z ^ (z >> 31));
+  }
+
+  //! Return the next random word.
+  result_type operator()()
+  {
+    const uint64_t block = position / 4;
+    if (block != bufferBlock)
+    {
+      Block(block, buffer);
+      bufferBlock = block;
+    }
+
+    return buffer[position++ % 4];
+  }
+
+  //! Skip the given number of random words.
+  void Discard(const uint64_t words) { position += words; }
+
+  //! Generate a uniform random number in [0, 1).
+  double Random()
+  {
+    const uint32_t high = (*this)();
+    return ToDouble(high, (*this)());
+  }
+
+  //! Generate a uniform random number in [lo, hi).
+  double Random(const double lo, const double hi)
+  {
+    return lo + (hi - lo) * Random();
+  }
+
+  //! Generate 1 with the given probability, and 0 otherwise.
+  double RandBernoulli(const double input)
+  {
+    return (Random() < input) ? 1 : 0;
+  }
+
+  //! Generate a uniform random integer in [0, hiExclusive).
+  int RandInt(const int hiExclusive)
+  {
+    return (int) std::floor((double) hiExclusive * Random());
+  }
+
+  //! Generate a uniform random integer in [lo, hiExclusive).
+  int RandInt(const int lo, const int hiExclusive)
+  {
+    return lo + (int) std::floor((double) (hiExclusive - lo) * Random());
+  }
+
+  //! Generate a normally distributed random number with mean 0 and variance
+  //! 1.  This takes as many random words as two numbers of Randn().
+  double RandNormal()
+  {
+    uint32_t words[4];
+    for (size_t i = 0; i < 4; ++i)
+      words[i] = (*this)();
+
+    double first, second;
+    BoxMuller(words, first, second);
+    return first;
+  }
+
+  //! Generate a normally distributed random number, scaled as by
+  //! math::RandNormal(mean, variance).
+  double RandNormal(const double mean, const double variance)
+  {
+    return variance * RandNormal() + mean;
+  }
+
+  /**
+   * Fill the given matrix with uniform random numbers in [0, 1), in the order
+   * of its elements.  This is the same as setting each element with Random().
+   *
+   * @param x Matrix to fill.
+   */
+  template<typename eT>
+  void Randu(arma::Mat<eT>& x);
+
+  /**
+   * Fill the given matrix with normally distributed random numbers with mean 0
+   * and variance 1, in the order of its elements.
+   *
+   * @param x Matrix to fill.
+   */
+  template<typename eT>
+  void Randn(arma::Mat<eT>& x);
+
+  //! Get the seed of the stream.
+  uint64_t Seed() const { return seed; }
+  //! Get the identifier of the stream.
+  uint64_t Stream() const { return stream; }
+  //! Get the index of the next random word.
+  uint64_t Position() const { return position; }
+
+  /**
+   * Compute the Philox4x32-10 function of the given counter and key.
+   *
+   * @param counter Counter (four words).
+   * @param key Key (two words).
+   * @param out Output (four words).
+   */
+  static void Philox(const uint32_t counter[4],
+                     const uint32_t key[2],
+                     uint32_t out[4])
+  {
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2],
+        c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+    for (size_t r = 0; r < 10; ++r)
+    {
+      const uint64_t p0 = (uint64_t) 0xD2511F53 * c0;
+      const uint64_t p1 = (uint64_t) 0xCD9E8D57 * c2;
+      c0 = (uint32_t) (p1 >> 32) ^ c1 ^ k0;
+      c1 = (uint32_t) p1;
+      c2 = (uint32_t) (p0 >> 32) ^ c3 ^ k1;
+      c3 = (uint32_t) p0;
+      k0 += 0x9E3779B9;
+      k1 += 0xBB67AE85;
+    }
+
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+  }
+
+ private:
+  //! The number of elements filled by each task of Randu() and Randn().
+  static constexpr size_t chunkSize = 1024;
+
+  //! Compute the given block of four random words of the stream.
+  void Block(const uint64_t block, uint32_t out[4]) const
+  {
+    const uint32_t counter[4] = { (uint32_t) block, (uint32_t) (block >> 32),
+        (uint32_t) stream, (uint32_t) (stream >> 32) };
+    const uint32_t key[2] = { (uint32_t) seed, (uint32_t) (seed >> 32) };
+    Philox(counter, key, out);
+  }
+
+  /**
+   * Compute the given number of random words from the given position on into
+   * the given buffer, which must hold count + 6 words, and return the offset
+   * of the first word in the buffer.
+   */
+  size_t Words(const uint64_t first, const size_t count, uint32_t* out) const
+  {
+    const uint64_t firstBlock = first / 4;
+    const uint64_t lastBlock = (first + count - 1) / 4;
+    for (uint64_t b = firstBlock; b <= lastBlock; ++b)
+      Block(b, out + 4 * (b - firstBlock));
+
+    return first % 4;
+  }
+
+  //! Convert two random words to a uniform random number in [0, 1) with 53
+  //! random bits.
+  static double ToDouble(const uint32_t high, const uint32_t low)
+  {
+    return (double) ((((uint64_t) high << 32) | low) >> 11) *
+        (1.0 / 9007199254740992.0);
+  }
+
+  //! Convert four random words to two independent normally distributed random
+  //! numbers with the Box-Muller transform.
+  static void BoxMuller(const uint32_t words[4], double& first, double& second)
+  {
+    // 1 - u is in (0, 1], so its logarithm is finite.
+    const double radius = std::sqrt(-2.0 * std::log(1.0 -
+        ToDouble(words[0], words[1])));
+    const double angle = 2.0 * M_PI * ToDouble(words[2], words[3]);
+    first = radius * std::cos(angle);
+    second = radius * std::sin(angle);
+  }
+
+  //! The seed (the Philox key).
+  uint64_t seed;
+  //! The identifier of the stream (the high half of the Philox counter).
+  uint64_t stream;
+  //! The index of the next random word.
+  uint64_t position;
+  //! The block of random words that holds the next word, if it is
+  //! bufferBlock.
+  uint32_t buffer[4];
+  //! The index of the block held in buffer.
+  uint64_t bufferBlock;
+};
+
+template<typename eT>
+void RandomStream::Randu(arma::Mat<eT>& x)
+{
+  // Element i takes the two words after position + 2 i, so the chunks can be
+  // filled independently.
+  const uint64_t start = position;
+  const size_t numChunks = (x.n_elem + chunkSize - 1) / chunkSize;
+  eT* memory = x.memptr();
+
+  #pragma omp parallel for schedule(static) if (numChunks > 8)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    const size_t begin = c * chunkSize;
+    const size_t end = std::min(begin + chunkSize, (size_t) x.n_elem);
+    uint32_t words[2 * chunkSize + 6];
+    const size_t offset = Words(start + 2 * begin, 2 * (end - begin), words);
+    for (size_t i = begin; i < end; ++i)
+    {
+      const uint32_t* w = words + offset + 2 * (i - begin);
+      memory[i] = (eT) ToDouble(w[0], w[1]);
+    }
+  }
+
+  position = start + 2 * (uint64_t) x.n_elem;
+}
+
+template<typename eT>
+void RandomStream::Randn(arma::Mat<eT>& x)
+{
+  // Elements 2 j and 2 j + 1 take the four words after position + 4 j.
+  // chunkSize is even, so each pair of elements is in one chunk.
+  const uint64_t start = position;
+  const size_t numPairs = (x.n_elem + 1) / 2;
+  const size_t numChunks = (x.n_elem + chunkSize - 1) / chunkSize;
+  eT* memory = x.memptr();
+
+  #pragma omp parallel for schedule(static) if (numChunks > 8)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    const size_t beginPair = c * (chunkSize / 2);
+    const size_t endPair = std::min(beginPair + chunkSize / 2, numPairs);
+    uint32_t words[2 * chunkSize + 6];
+    const size_t offset = Words(start + 4 * beginPair,
+        4 * (endPair - beginPair), words);
+    for (size_t j = beginPair; j < endPair; ++j)
+    {
+      double first, second;
+      BoxMuller(words + offset + 4 * (j - beginPair), first, second);
+      memory[2 * j] = (eT) first;
+      if (2 * j + 1 < x.n_elem)
+        memory[2 * j + 1] = (eT) second;
+    }
+  }
+
+  position = start + 4 * (uint64_t) numPairs;
+}
+
+/**
+ * Create a new RandomStream, seeded from the global random number generator,
+ * so that it follows RandomSeed().  Call this outside of parallel regions.
+ */
+inline RandomStream NewRandomStream()
+{
+  const uint64_t high = randGen();
+  const uint64_t low = randGen();
+  return RandomStream((high << 32) | low);
+}
+
+} // namespace math
+} // namespace mlpack
+
+#endif
@@ -41,6 +41,14 @@ namespace metric {
  *
  * The value of BLEU Score lies in between 0 and 1.
  *
+ * The score only depends on a few sums over the sentences of the corpus (the
+ * n-gram matches and possible matches of each order and the lengths), so a
+ * corpus can be given in parts: call Update() for each part (for instance,
+ * for each batch of predictions) and then Score().  Two BLEU objects that
+ * have seen different parts can be combined with Merge().  The n-grams of the
+ * sentences are counted in parallel; their tokens can have any type with
+ * std::hash and operator==, like std::string.
+ *
  * @tparam ElemType Type of the quantities in BLEU, e.g. (long double,
  *         double, float).
  * @tparam PrecisionType Container type for precision for corresponding order.
@@ -93,13 +101,47 @@ class BLEU
    * @return The Evaluate method returns the BLEU Score. This method also
    * calculates other BLEU metrics (brevity penalty, translation length, reference
    * length, ratio and precisions) which can be accessed by their corresponding
-   * accessor methods.
+   * accessor methods.  The statistics seen before by Update() are forgotten.
    */
   template <typename ReferenceCorpusType, typename TranslationCorpusType>
   ElemType Evaluate(const ReferenceCorpusType& referenceCorpus,
                     const TranslationCorpusType& translationCorpus,
                     const bool smooth = false);
 
+  /**
+   * Add the statistics of the given part of a corpus to the statistics seen
+   * so far.  The corpora have the same form as for Evaluate().  Use Score() to
+   * get the BLEU score of all the parts.
+   *
+   * @tparam ReferenceCorpusType Type of reference corpus.
+   * @tparam TranslationCorpusType Type of translation corpus.
+   * @param referenceCorpus References of each sentence of the part.
+   * @param translationCorpus Translation of each sentence of the part.
+   */
+  template <typename ReferenceCorpusType, typename TranslationCorpusType>
+  void Update(const ReferenceCorpusType& referenceCorpus,
+              const TranslationCorpusType& translationCorpus);
+
+  /**
+   * Add the statistics seen by another BLEU object, with the same maximum
+   * order, to the statistics of this object.
+   *
+   * @param other BLEU object to merge.
+   */
+  void Merge(const BLEU& other);
+
+  /**
+   * Compute the BLEU score of the statistics seen so far by Update() and
+   * Merge(), and set the other BLEU metrics, as Evaluate() does.
+   *
+   * @param smooth Whether or not to apply Lin et al. 2004 smoothing.
+   * @return The BLEU score.
+   */
+  ElemType Score(const bool smooth = false);
+
+  //! Forget the statistics seen by Update() and Merge().
+  void Reset();
+
   //! Serialize the metric.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t version);
@@ -127,19 +169,77 @@ class BLEU
   //! Get the precisions for corresponding order.
   PrecisionType const& Precisions() const { return precisions; }
 
+  //! Get the number of n-gram matches of each order seen so far.
+  const std::vector<size_t>& MatchesByOrder() const { return matchesByOrder; }
+  //! Get the number of possible n-gram matches of each order seen so far.
+  const std::vector<size_t>& PossibleMatchesByOrder() const
+  {
+    return possibleMatchesByOrder;
+  }
+
  private:
   /**
-   * Extracts all the n-grams.
-   *
-   * @tparam WordVector Type of the tokenized vector.
-   * @param segment Tokenized sequence represented in form of vector.
+   * The n-grams of the references and the translation of a sentence, each
+   * with an identifier.  A token is identified by its index in the order the
+   * tokens are seen, and an n-gram by the identifiers of its first n - 1 tokens
+   * and its last token, so n-grams are never copied or compared.  The buffers
+   * are reused for the sentences of a block of a corpus.
+   */
+  template<typename TokenType>
+  struct NGramBuffers
+  {
+    //! The identifier of each token.
+    std::unordered_map<TokenType, uint32_t> tokenIds;
+    //! The identifier of each n-gram of order at least 2, given by the
+    //! identifier of its prefix (high half) and of its last token (low half).
+    std::unordered_map<uint64_t, uint32_t> ngramIds;
+    //! The order of each identifier.
+    std::vector<size_t> orders;
+    //! The largest count of each identifier in any reference.
+    std::vector<size_t> referenceCounts;
+    //! The count of each identifier in the current segment.
+    std::vector<size_t> counts;
+    //! The identifiers counted in the current segment.
+    std::vector<uint32_t> touched;
+    //! The identifiers of the tokens of the current segment.
+    std::vector<uint32_t> segmentTokens;
+    //! The identifiers of the n-grams starting at each token of the current
+    //! segment, for the current order.
+    std::vector<uint32_t> segmentNGrams;
+  };
+
+  //! Reset the statistics if the maximum order was modified while there were
+  //! none, and throw an exception if there were some.
+  void CheckMaxOrder(const std::string& caller);
+
+  /**
+   * Count the n-grams of the given segment in buffers.counts, and list them in
+   * buffers.touched.  If addNew is false, n-grams that have no identifier yet
+   * are skipped.
    */
-  template <typename WordVector>
-  std::map<WordVector, size_t> GetNGrams(const WordVector& segment);
+  template<typename SegmentType, typename TokenType>
+  void CountNGrams(const SegmentType& segment,
+                   NGramBuffers<TokenType>& buffers,
+                   const bool addNew) const;
+
+  /**
+   * Add the statistics of the given number of sentences, starting at the given
+   * references and translation.
+   */
+  template<typename ReferenceIterator, typename TranslationIterator>
+  void UpdateRange(ReferenceIterator refIt,
+                   TranslationIterator trIt,
+                   const size_t count);
 
   //! Locally-stored value of maximum length of tokens in n-grams.
   size_t maxOrder;
 
+  //! The number of n-gram matches of each order seen so far.
+  std::vector<size_t> matchesByOrder;
+
+  //! The number of possible n-gram matches of each order seen so far.
+  std::vector<size_t> possibleMatchesByOrder;
+
   //! Locally-stored BLEU score.
   ElemType bleuScore;
 
@@ -24,63 +24,142 @@ BLEU<ElemType, PrecisionType>::BLEU(const size_t maxOrder) :
     translationLength(0),
     referenceLength(0)
 {
-  // Nothing to do here.
+  Reset();
 }
 
 template <typename ElemType, typename PrecisionType>
-template <typename WordVector>
-std::map<WordVector, size_t> BLEU<ElemType, PrecisionType>::GetNGrams(
-    const WordVector& segment)
+void BLEU<ElemType, PrecisionType>::Reset()
 {
-  std::map<WordVector, size_t> ngramsCount;
-  for (size_t order = 1; order < maxOrder + 1; ++order)
+  matchesByOrder.assign(maxOrder, 0);
+  possibleMatchesByOrder.assign(maxOrder, 0);
+  referenceLength = 0;
+  translationLength = 0;
+}
+
+template <typename ElemType, typename PrecisionType>
+void BLEU<ElemType, PrecisionType>::CheckMaxOrder(const std::string& caller)
+{
+  // The maximum order may have been modified since the last Reset().
+  if (matchesByOrder.size() == maxOrder)
+    return;
+
+  if (translationLength > 0 || referenceLength > 0)
   {
-    for (size_t i = 0; i + order < segment.size() + 1; ++i)
+    throw std::invalid_argument("BLEU::" + caller + "(): the maximum order "
+        "was modified after statistics were added; call Reset() first");
+  }
+  Reset();
+}
+
+template <typename ElemType, typename PrecisionType>
+template <typename SegmentType, typename TokenType>
+void BLEU<ElemType, PrecisionType>::CountNGrams(
+    const SegmentType& segment,
+    NGramBuffers<TokenType>& buffers,
+    const bool addNew) const
+{
+  const uint32_t none = std::numeric_limits<uint32_t>::max();
+  const size_t n = segment.size();
+  buffers.segmentTokens.resize(n);
+  buffers.segmentNGrams.resize(n);
+
+  // Count an identifier, and list it the first time it is counted.
+  auto count = [&buffers](const uint32_t id)
+  {
+    if (buffers.counts[id]++ == 0)
+      buffers.touched.push_back(id);
+  };
+
+  // Give an identifier to a new n-gram of the given order.
+  auto newId = [&buffers](const size_t order) -> uint32_t
+  {
+    buffers.orders.push_back(order);
+    buffers.referenceCounts.push_back(0);
+    buffers.counts.push_back(0);
+    return (uint32_t) (buffers.orders.size() - 1);
+  };
+
+  // The unigrams are the tokens.
+  size_t i = 0;
+  for (auto it = segment.cbegin(); it != segment.cend() && maxOrder > 0;
+      ++it, ++i)
+  {
+    uint32_t id = none;
+    auto found = buffers.tokenIds.find(*it);
+    if (found != buffers.tokenIds.end())
+      id = found->second;
+    else if (addNew)
+      id = buffers.tokenIds.emplace(*it, newId(1)).first->second;
+
+    buffers.segmentTokens[i] = id;
+    buffers.segmentNGrams[i] = id;
+    if (id != none)
+      count(id);
+  }
+
+  // The n-gram of order n starting at token i is the (n - 1)-gram starting at
+  // token i followed by token i + n - 1.
+  for (size_t order = 2; order <= maxOrder && order <= n; ++order)
+  {
+    for (i = 0; i + order <= n; ++i)
     {
-      WordVector seq = WordVector(segment.cbegin() + i,
-                                  segment.cbegin() + i + order);
-      ngramsCount[seq]++;
+      const uint32_t prefix = buffers.segmentNGrams[i];
+      const uint32_t last = buffers.segmentTokens[i + order - 1];
+      uint32_t id = none;
+      if (prefix != none && last != none)
+      {
+        const uint64_t key = ((uint64_t) prefix << 32) | last;
+        auto found = buffers.ngramIds.find(key);
+        if (found != buffers.ngramIds.end())
+          id = found->second;
+        else if (addNew)
+          id = buffers.ngramIds.emplace(key, newId(order)).first->second;
+      }
+
+      buffers.segmentNGrams[i] = id;
+      if (id != none)
+        count(id);
     }
   }
-  return ngramsCount;
 }
 
 template <typename ElemType, typename PrecisionType>
-template <typename ReferenceCorpusType, typename TranslationCorpusType>
-ElemType BLEU<ElemType, PrecisionType>::Evaluate(
-    const ReferenceCorpusType& referenceCorpus,
-    const TranslationCorpusType& translationCorpus,
-    const bool smooth)
+template <typename ReferenceIterator, typename TranslationIterator>
+void BLEU<ElemType, PrecisionType>::UpdateRange(
+    ReferenceIterator refIt,
+    TranslationIterator trIt,
+    const size_t count)
 {
-  // WordVector is a string container type.
-  // Also, TranslationCorpusType is an array of such containers.
-  typedef typename TranslationCorpusType::value_type WordVector;
-
-  // matchesByOrder: It catches how many times sequence of a particular order
-  // is encountered in both reference corpus and translation corpus.
-  std::vector<size_t> matchesByOrder(maxOrder, 0);
-
-  // possibleMatchesByOrder: It tracks how many possible matches can be in the
-  // translation corpus.
-  std::vector<size_t> possibleMatchesByOrder(maxOrder, 0);
-
-  // referenceLength: It is the sum of minimum length of the paragraph from
-  // various documents.
-  // translationLength: It is the sum of length of each paragraphs.
-  referenceLength = 0, translationLength = 0;
-
-  auto refIt = referenceCorpus.cbegin();
-  auto trIt = translationCorpus.cbegin();
-  for (; refIt != referenceCorpus.cend() && trIt != translationCorpus.cend();
-      ++refIt, ++trIt)
+  typedef typename std::iterator_traits<TranslationIterator>::value_type
+      WordVector;
+  typedef typename WordVector::value_type TokenType;
+
+  NGramBuffers<TokenType> buffers;
+  for (size_t s = 0; s < count; ++s, ++refIt, ++trIt)
   {
+    buffers.tokenIds.clear();
+    buffers.ngramIds.clear();
+    buffers.orders.clear();
+    buffers.referenceCounts.clear();
+    buffers.counts.clear();
+
+    // The reference length of a sentence is the length of its shortest
+    // reference.
     size_t min = std::numeric_limits<size_t>::max();
     for (const auto& t : *refIt)
     {
       if (min > t.size())
-      {
         min = t.size();
+
+      // Keep the largest count of each n-gram over the references.
+      CountNGrams(t, buffers, true);
+      for (const uint32_t id : buffers.touched)
+      {
+        buffers.referenceCounts[id] = std::max(buffers.referenceCounts[id],
+            buffers.counts[id]);
+        buffers.counts[id] = 0;
       }
+      buffers.touched.clear();
     }
 
     if (min == std::numeric_limits<size_t>::max())
@@ -89,46 +168,17 @@ ElemType BLEU<ElemType, PrecisionType>::Evaluate(
     referenceLength += min;
     translationLength += trIt->size();
 
-    // mergedRefNGramCounts: It accumulates all the similar n-grams from
-    // various references or documents, so that there is no repetition of
-    // any key (sequence of order n).
-    std::map<WordVector, size_t> mergedRefNGramCounts;
-    for (const auto& t : *refIt)
-    {
-      // ngram: It holds the n-grams of each document/reference.
-      const std::map<WordVector, size_t> ngrams = GetNGrams(t);
-      for (auto it = ngrams.cbegin(); it != ngrams.cend(); ++it)
-      {
-        mergedRefNGramCounts[it->first] = std::max(it->second,
-            mergedRefNGramCounts[it->first]);
-      }
-    }
-    // translationNGramCounts: It extracts the n-grams of the generated text
-    // sequence.
-    const std::map<WordVector, size_t> translationNGramCounts
-        = GetNGrams(*trIt);
-
-    // overlap: It holds those keys (sequence of order n) which are common to
-    // reference corpus and translation corpus.
-    std::map<WordVector, size_t> overlap;
-    for (auto it = translationNGramCounts.cbegin();
-         it != translationNGramCounts.cend();
-         ++it)
-    {
-      auto mergedIt = mergedRefNGramCounts.find(it->first);
-      if (mergedIt != mergedRefNGramCounts.end())
-      {
-        // If the key (sequence of order n) is present in both translation
-        // corpus as well as reference corpus, then the minimum number of
-        // counts it has occurred in any is considered.
-        overlap[it->first] = std::min(mergedIt->second, it->second);
-      }
-    }
-
-    for (auto it = overlap.cbegin(); it != overlap.cend(); ++it)
+    // An n-gram of the translation matches as many times as it appears in
+    // both the translation and a reference; n-grams that are in no reference
+    // have no identifier.
+    CountNGrams(*trIt, buffers, false);
+    for (const uint32_t id : buffers.touched)
     {
-      matchesByOrder[it->first.size() - 1] += it->second;
+      matchesByOrder[buffers.orders[id] - 1] += std::min(buffers.counts[id],
+          buffers.referenceCounts[id]);
+      buffers.counts[id] = 0;
     }
+    buffers.touched.clear();
 
     for (size_t order = 1; order < maxOrder + 1; ++order)
     {
@@ -136,6 +186,82 @@ ElemType BLEU<ElemType, PrecisionType>::Evaluate(
         possibleMatchesByOrder[order - 1] += trIt->size() - order + 1;
     }
   }
+}
+
+template <typename ElemType, typename PrecisionType>
+template <typename ReferenceCorpusType, typename TranslationCorpusType>
+void BLEU<ElemType, PrecisionType>::Update(
+    const ReferenceCorpusType& referenceCorpus,
+    const TranslationCorpusType& translationCorpus)
+{
+  CheckMaxOrder("Update");
+
+  const size_t n = std::min((size_t) referenceCorpus.size(),
+      (size_t) translationCorpus.size());
+
+  // Large corpora are split into blocks whose statistics are computed in
+  // parallel and then added.
+  const size_t numBlocks = ParallelPolicy::Current().NumBlocks(n, 256);
+
+  if (numBlocks <= 1)
+  {
+    UpdateRange(referenceCorpus.cbegin(), translationCorpus.cbegin(), n);
+    return;
+  }
+
+  std::vector<BLEU> blocks(numBlocks, BLEU(maxOrder));
+  const size_t blockSize = (n + numBlocks - 1) / numBlocks;
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = std::min((size_t) b * blockSize, n);
+    const size_t end = std::min(begin + blockSize, n);
+    auto refIt = referenceCorpus.cbegin();
+    auto trIt = translationCorpus.cbegin();
+    std::advance(refIt, begin);
+    std::advance(trIt, begin);
+    blocks[b].UpdateRange(refIt, trIt, end - begin);
+  }
+
+  for (size_t b = 0; b < numBlocks; ++b)
+    Merge(blocks[b]);
+}
+
+template <typename ElemType, typename PrecisionType>
+void BLEU<ElemType, PrecisionType>::Merge(const BLEU& other)
+{
+  if (other.matchesByOrder.size() != matchesByOrder.size())
+  {
+    throw std::invalid_argument("BLEU::Merge(): the two objects have "
+        "different maximum orders");
+  }
+
+  for (size_t i = 0; i < matchesByOrder.size(); ++i)
+  {
+    matchesByOrder[i] += other.matchesByOrder[i];
+    possibleMatchesByOrder[i] += other.possibleMatchesByOrder[i];
+  }
+
+  referenceLength += other.referenceLength;
+  translationLength += other.translationLength;
+}
+
+template <typename ElemType, typename PrecisionType>
+template <typename ReferenceCorpusType, typename TranslationCorpusType>
+ElemType BLEU<ElemType, PrecisionType>::Evaluate(
+    const ReferenceCorpusType& referenceCorpus,
+    const TranslationCorpusType& translationCorpus,
+    const bool smooth)
+{
+  Reset();
+  Update(referenceCorpus, translationCorpus);
+  return Score(smooth);
+}
+
+template <typename ElemType, typename PrecisionType>
+ElemType BLEU<ElemType, PrecisionType>::Score(const bool smooth)
+{
+  CheckMaxOrder("Score");
 
   precisions = PrecisionType(maxOrder, 0.0);
 
@@ -194,6 +320,10 @@ void BLEU<ElemType, PrecisionType>::serialize(Archive& ar,
     const uint32_t version)
 {
   ar(CEREAL_NVP(maxOrder));
+
+  // The statistics are not saved.
+  if (cereal::is_loading<Archive>())
+    Reset();
 }
 
 } // namespace metric
@@ -59,6 +59,25 @@ class IoU
   static typename VecTypeA::elem_type Evaluate(const VecTypeA& a,
                                                const VecTypeB& b);
 
+  /**
+   * Computes the Intersection over Union metric between each bounding box in
+   * a and each bounding box in b, so that ious(i, j) is the IoU of a.col(i)
+   * and b.col(j), as given by the other overload of Evaluate().  The
+   * coordinates of the boxes are first copied into separate arrays, so that
+   * each column of the output is computed by a simple loop that the compiler
+   * can vectorize; the columns are computed in parallel.
+   *
+   * @tparam MatTypeA Type of first matrix.
+   * @tparam MatTypeB Type of second matrix.
+   * @param a First set of bounding boxes (one per column).
+   * @param b Second set of bounding boxes (one per column).
+   * @param ious Matrix to store the IoU of each pair of bounding boxes in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  static void Evaluate(const MatTypeA& a,
+                       const MatTypeB& b,
+                       arma::Mat<typename MatTypeA::elem_type>& ious);
+
   static const bool useCoordinates = UseCoordinates;
 
   //! Serialize the metric.
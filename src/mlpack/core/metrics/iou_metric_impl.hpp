@@ -64,6 +64,73 @@ typename VecTypeA::elem_type IoU<UseCoordinates>::Evaluate(
   return interSectionArea / (1.0 * ((a(2) + 1) * (a(3) + 1) + (b(2) + 1) *
       (b(3) + 1) - interSectionArea));
 }
+
+template<bool UseCoordinates>
+template<typename MatTypeA, typename MatTypeB>
+void IoU<UseCoordinates>::Evaluate(
+    const MatTypeA& a,
+    const MatTypeB& b,
+    arma::Mat<typename MatTypeA::elem_type>& ious)
+{
+  typedef typename MatTypeA::elem_type ElemType;
+
+  Log::Assert(a.n_rows == 4 && b.n_rows == 4, "Incorrect shape for bounding "
+      "boxes. They must contain 4 elements either be {x0, y0, x1, y1} or "
+      "{x0, y0, h, w}. Refer to the documentation for more information.");
+
+  // Copy the corners of the boxes of a into separate arrays, with the extents
+  // of each box (plus one, as in the other overload of Evaluate()).
+  const size_t n = a.n_cols;
+  std::vector<ElemType> ax0(n), ay0(n), ax1(n), ay1(n), aArea(n);
+  bool valid = true;
+  for (size_t i = 0; i < n; ++i)
+  {
+    ax0[i] = a(0, i);
+    ay0[i] = a(1, i);
+    ax1[i] = UseCoordinates ? a(2, i) : a(0, i) + a(2, i);
+    ay1[i] = UseCoordinates ? a(3, i) : a(1, i) + a(3, i);
+    aArea[i] = (ax1[i] - ax0[i] + 1) * (ay1[i] - ay0[i] + 1);
+    valid &= (ax0[i] < ax1[i] && ay0[i] < ay1[i]);
+  }
+
+  for (size_t j = 0; j < b.n_cols; ++j)
+  {
+    valid &= UseCoordinates ? (b(0, j) < b(2, j) && b(1, j) < b(3, j)) :
+        (b(2, j) > 0 && b(3, j) > 0);
+  }
+
+  if (!valid)
+  {
+    Log::Fatal << "Check the correctness of bounding boxes i.e. " <<
+        "{x0, y0} must represent lower left coordinates and " <<
+        "{x1, y1} must represent upper right coordinates of bounding " <<
+        "box, or height and width must be greater than zero." << std::endl;
+  }
+
+  ious.set_size(n, b.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t j = 0; j < (omp_size_t) b.n_cols; ++j)
+  {
+    const ElemType bx0 = b(0, j);
+    const ElemType by0 = b(1, j);
+    const ElemType bx1 = UseCoordinates ? b(2, j) : b(0, j) + b(2, j);
+    const ElemType by1 = UseCoordinates ? b(3, j) : b(1, j) + b(3, j);
+    const ElemType bArea = (bx1 - bx0 + 1) * (by1 - by0 + 1);
+
+    ElemType* out = ious.colptr(j);
+    for (size_t i = 0; i < n; ++i)
+    {
+      const ElemType width = std::max(ElemType(0),
+          std::min(ax1[i], bx1) - std::max(ax0[i], bx0) + 1);
+      const ElemType height = std::max(ElemType(0),
+          std::min(ay1[i], by1) - std::max(ay0[i], by0) + 1);
+      const ElemType intersection = width * height;
+      out[i] = intersection / (aArea[i] + bArea - intersection);
+    }
+  }
+}
+
 template<bool UseCoordinates>
 template<typename Archive>
 void IoU<UseCoordinates>::serialize(
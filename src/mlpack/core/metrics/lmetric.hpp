@@ -16,6 +16,7 @@
 #define MLPACK_CORE_METRICS_LMETRIC_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/int_power.hpp>
 
 namespace mlpack {
 namespace metric {
@@ -83,6 +84,34 @@ class LMetric
   static typename VecTypeA::elem_type Evaluate(const VecTypeA& a,
                                                const VecTypeB& b);
 
+  /**
+   * Computes the distances between one point and a contiguous block of
+   * columns of a matrix, such as the points held in a leaf of a tree.  For
+   * dense data and the (squared) Euclidean distance, this uses a tight kernel
+   * over the raw memory that the compiler can vectorize, instead of building
+   * an Armadillo expression for every pair of points.
+   *
+   * @param a Point to compute distances from.
+   * @param b Matrix holding the other points.
+   * @param begin Index of the first column of b to use.
+   * @param count Number of columns of b to use.
+   * @param distances Output array; must have room for count elements.
+   */
+  template<typename VecType, typename MatType>
+  static void EvaluateBlock(const VecType& a,
+                            const MatType& b,
+                            const size_t begin,
+                            const size_t count,
+                            typename MatType::elem_type* distances);
+
+  //! Overload of EvaluateBlock() for columns of dense matrices.
+  template<typename eT>
+  static void EvaluateBlock(const arma::subview_col<eT>& a,
+                            const arma::Mat<eT>& b,
+                            const size_t begin,
+                            const size_t count,
+                            eT* distances);
+
   //! Serialize the metric (nothing to do).
   template<typename Archive>
   void serialize(Archive& /* ar */, const uint32_t /* version */) { }
@@ -93,6 +122,14 @@ class LMetric
   static const bool TakeRoot = TTakeRoot;
 };
 
+//! Whether or not a metric has an EvaluateBlock() method.  This is true for
+//! all LMetrics.
+template<typename MetricType>
+struct HasEvaluateBlock : std::false_type { };
+
+template<int Power, bool TakeRoot>
+struct HasEvaluateBlock<LMetric<Power, TakeRoot>> : std::true_type { };
+
 // Convenience typedefs.
 
 /**
@@ -27,7 +27,7 @@ typename VecTypeA::elem_type LMetric<Power, TakeRoot>::Evaluate(
 {
   typename VecTypeA::elem_type sum = 0;
   for (size_t i = 0; i < a.n_elem; ++i)
-    sum += std::pow(fabs(a[i] - b[i]), Power);
+    sum += math::IntPower<Power>(std::fabs(a[i] - b[i]));
 
   if (!TakeRoot) // The compiler should optimize this correctly at compile-time.
     return sum;
@@ -80,11 +80,7 @@ typename VecTypeA::elem_type LMetric<3, true>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  typename VecTypeA::elem_type sum = 0;
-  for (size_t i = 0; i < a.n_elem; ++i)
-    sum += std::pow(fabs(a[i] - b[i]), 3.0);
-
-  return std::pow(arma::accu(arma::pow(arma::abs(a - b), 3.0)), 1.0 / 3.0);
+  return std::cbrt(arma::accu(arma::pow(arma::abs(a - b), 3.0)));
 }
 
 template<>
@@ -106,6 +102,56 @@ typename VecTypeA::elem_type LMetric<INT_MAX, false>::Evaluate(
   return arma::as_scalar(arma::max(arma::abs(a - b)));
 }
 
+// Block evaluation for general types: evaluate each pair separately.
+template<int Power, bool TakeRoot>
+template<typename VecType, typename MatType>
+void LMetric<Power, TakeRoot>::EvaluateBlock(
+    const VecType& a,
+    const MatType& b,
+    const size_t begin,
+    const size_t count,
+    typename MatType::elem_type* distances)
+{
+  for (size_t i = 0; i < count; ++i)
+    distances[i] = Evaluate(a, b.col(begin + i));
+}
+
+// Block evaluation for dense columns.
+template<int Power, bool TakeRoot>
+template<typename eT>
+void LMetric<Power, TakeRoot>::EvaluateBlock(
+    const arma::subview_col<eT>& a,
+    const arma::Mat<eT>& b,
+    const size_t begin,
+    const size_t count,
+    eT* distances)
+{
+  // Only the L2 distance gets the special kernel; the compiler removes this
+  // branch at compile-time.
+  if (Power != 2)
+  {
+    for (size_t i = 0; i < count; ++i)
+      distances[i] = Evaluate(a, b.col(begin + i));
+    return;
+  }
+
+  const eT* point = a.colmem;
+  const omp_size_t dim = (omp_size_t) b.n_rows;
+  for (size_t i = 0; i < count; ++i)
+  {
+    const eT* other = b.colptr(begin + i);
+    eT sum = 0;
+    #pragma omp simd reduction(+:sum)
+    for (omp_size_t d = 0; d < dim; ++d)
+    {
+      const eT diff = point[d] - other[d];
+      sum += diff * diff;
+    }
+
+    distances[i] = TakeRoot ? std::sqrt(sum) : sum;
+  }
+}
+
 } // namespace metric
 } // namespace mlpack
 
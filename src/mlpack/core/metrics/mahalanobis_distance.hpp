@@ -13,6 +13,7 @@
 #define MLPACK_CORE_METRICS_MAHALANOBIS_DISTANCE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "lmetric.hpp"
 
 namespace mlpack {
 namespace metric {
@@ -37,10 +38,24 @@ namespace metric {
  *
  * If you wish to use the KNN class or other tree-based algorithms with this
  * distance, it is recommended to instead stretch the dataset first, by
- * decomposing Q = L^T L (perhaps via a Cholesky decomposition), and then
- * multiply the data by L.  If you still wish to use the KNN class with a custom
- * distance anyway, you will need to use a different tree type than the default
- * KDTree, which only works with the LMetric class.
+ * decomposing Q = L^T L, and then multiply the data by L.  Transform() does
+ * this with a cached factor L of the covariance matrix, and the distance
+ * between the transformed points is given by TransformedMetric, an LMetric, so
+ * the KDTree and its bounds can be used in the transformed space:
+ *
+ * @code
+ * extern arma::mat dataset;
+ * MahalanobisDistance<> md(covariance);
+ * arma::mat transformed = md.Transform(dataset);
+ *
+ * // The distances are the Mahalanobis distances of the original points.
+ * neighbor::NeighborSearch<neighbor::NearestNeighborSort,
+ *     MahalanobisDistance<>::TransformedMetric> knn(transformed);
+ * @endcode
+ *
+ * If you still wish to use the KNN class with a custom distance anyway, you
+ * will need to use a different tree type than the default KDTree, which only
+ * works with the LMetric class.
  *
  * Similar to the LMetric class, this offers a template parameter TakeRoot
  * which, when set to false, will instead evaluate the distance
@@ -84,6 +99,10 @@ class MahalanobisDistance
   MahalanobisDistance(arma::mat covariance) :
       covariance(std::move(covariance)) { }
 
+  //! The metric between points transformed with Transform() that gives this
+  //! distance between the original points.
+  typedef LMetric<2, TakeRoot> TransformedMetric;
+
   /**
    * Evaluate the distance between the two given points using this Mahalanobis
    * distance.  If the covariance matrix has not been set (i.e. if you used the
@@ -96,6 +115,31 @@ class MahalanobisDistance
   template<typename VecTypeA, typename VecTypeB>
   double Evaluate(const VecTypeA& a, const VecTypeB& b);
 
+  /**
+   * Get the transformation L, with Q = L^T L, that maps the points into a
+   * space where this distance is the distance of TransformedMetric.  L is the
+   * Cholesky factor of the symmetric part of Q (which gives the same distance);
+   * if Q is only positive semidefinite, L is computed from its eigenvalue
+   * decomposition instead.  L is cached, and computed again after the
+   * covariance matrix is modified with Covariance().
+   *
+   * @throw std::invalid_argument if Q has a negative eigenvalue.
+   */
+  const arma::mat& Transformation();
+
+  /**
+   * Transform the given points with Transformation(), so that this distance
+   * between two points is the distance of TransformedMetric between the
+   * transformed points.  Transforming a dataset once and then using
+   * TransformedMetric avoids the product with Q in each evaluation.  If the
+   * covariance matrix has not been set, the identity matrix is used.
+   *
+   * @param points Points to transform (one per column).
+   * @return The transformed points.
+   */
+  template<typename MatType>
+  MatType Transform(const MatType& points);
+
   /**
    * Access the covariance matrix.
    *
@@ -104,11 +148,15 @@ class MahalanobisDistance
   const arma::mat& Covariance() const { return covariance; }
 
   /**
-   * Modify the covariance matrix.
+   * Modify the covariance matrix.  This discards the cached transformation.
    *
    * @return Reference to the covariance matrix.
    */
-  arma::mat& Covariance() { return covariance; }
+  arma::mat& Covariance()
+  {
+    transformation.reset();
+    return covariance;
+  }
 
   //! Serialize the Mahalanobis distance.
   template<typename Archive>
@@ -117,6 +165,9 @@ class MahalanobisDistance
  private:
   //! The covariance matrix associated with this distance.
   arma::mat covariance;
+  //! The cached transformation, or the empty matrix if it has not been
+  //! computed.
+  arma::mat transformation;
 };
 
 } // namespace metric
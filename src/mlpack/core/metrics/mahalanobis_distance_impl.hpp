@@ -25,10 +25,10 @@ template<typename VecTypeA, typename VecTypeB>
 double MahalanobisDistance<false>::Evaluate(const VecTypeA& a,
                                             const VecTypeB& b)
 {
-  arma::vec m = (a - b);
-  arma::mat out = trans(m) * covariance * m; // 1x1
-  return out[0];
+  const arma::vec m = (a - b);
+  return arma::dot(m, covariance * m);
 }
+
 /**
  * Specialization for rooted case.  This requires one extra evaluation of
  * sqrt().
@@ -42,9 +42,61 @@ double MahalanobisDistance<true>::Evaluate(const VecTypeA& a,
   if (covariance.n_rows == 0)
     covariance = arma::eye<arma::mat>(a.n_elem, a.n_elem);
 
-  arma::vec m = (a - b);
-  arma::mat out = trans(m) * covariance * m; // 1x1;
-  return sqrt(out[0]);
+  const arma::vec m = (a - b);
+  return sqrt(arma::dot(m, covariance * m));
+}
+
+template<bool TakeRoot>
+const arma::mat& MahalanobisDistance<TakeRoot>::Transformation()
+{
+  if (transformation.n_rows == covariance.n_rows &&
+      transformation.n_cols == covariance.n_cols)
+    return transformation;
+
+  // Only the symmetric part of Q contributes to the distance.
+  const arma::mat symmetric = 0.5 * (covariance + covariance.t());
+  if (arma::chol(transformation, symmetric))
+    return transformation;
+
+  // Q is singular (or not positive semidefinite); use Q = V diag(l) V^T, so
+  // L = diag(sqrt(l)) V^T.
+  arma::vec eigenvalues;
+  arma::mat eigenvectors;
+  if (!arma::eig_sym(eigenvalues, eigenvectors, symmetric))
+  {
+    transformation.reset();
+    throw std::invalid_argument("MahalanobisDistance::Transformation(): "
+        "eigendecomposition of the covariance matrix failed");
+  }
+
+  const double tolerance = 1e-10 * std::max(1.0,
+      arma::max(arma::abs(eigenvalues)));
+  if (eigenvalues.min() < -tolerance)
+  {
+    transformation.reset();
+    throw std::invalid_argument("MahalanobisDistance::Transformation(): "
+        "covariance matrix is not positive semidefinite");
+  }
+
+  eigenvalues = arma::sqrt(arma::clamp(eigenvalues, 0.0, arma::datum::inf));
+  transformation = arma::diagmat(eigenvalues) * eigenvectors.t();
+  return transformation;
+}
+
+template<bool TakeRoot>
+template<typename MatType>
+MatType MahalanobisDistance<TakeRoot>::Transform(const MatType& points)
+{
+  // Check if covariance matrix has been initialized.
+  if (covariance.n_rows == 0)
+    Covariance() = arma::eye<arma::mat>(points.n_rows, points.n_rows);
+
+  util::CheckSameDimensionality(points, covariance.n_rows,
+      "MahalanobisDistance::Transform()", "points");
+
+  // One product for the whole dataset is much faster than a product with Q for
+  // each pair of points.
+  return arma::conv_to<MatType>::from(Transformation() * points);
 }
 
 // Serialize the Mahalanobis distance.
@@ -54,6 +106,10 @@ void MahalanobisDistance<TakeRoot>::serialize(Archive& ar,
                                               const uint32_t /* version */)
 {
   ar(CEREAL_NVP(covariance));
+
+  // The transformation is computed again when it is needed.
+  if (cereal::is_loading<Archive>())
+    transformation.reset();
 }
 
 } // namespace metric
@@ -12,6 +12,8 @@
 #ifndef MLPACK_CORE_METRICS_NMS_HPP
 #define MLPACK_CORE_METRICS_NMS_HPP
 
+#include <mlpack/prereqs.hpp>
+
 namespace mlpack {
 namespace metric {
 
@@ -22,6 +24,12 @@ namespace metric {
  * Intersection-over-Union (IoU). NMS iteratively removes lower scoring boxes
  * which have an IoU greater than threshold with another high scoring box.
  *
+ * The boxes are sorted by score and split into blocks of 64, and the boxes
+ * each block suppresses are marked in one bit mask per block.  Once the boxes
+ * kept in a block are known, the later blocks are compared with them in
+ * parallel, so suppression takes no allocations per box and scales to many
+ * thousands of boxes.  BatchedEvaluate() runs NMS separately for each class.
+ *
  * For bounding box representation there are two common representation
  * either as coordinates i.e. each value in vector represents a
  * coordinate in the format x0, y0, x1, y1 where x0, y0 represent the
@@ -70,11 +78,63 @@ class NMS
                        OutputType& selectedIndices,
                        const double threshold = 0.5);
 
+  /**
+   * Performs non-maximal suppression separately for the bounding boxes of each
+   * class, so that boxes of different classes never suppress each other.
+   *
+   * @param boundingBoxes Column major representation of bounding boxes
+   *                      i.e. Each column corresponds to a different bounding
+   *                      box. Each bounding box should contain 4 points only
+   *                      either {x1, y1, x2, y2} or {x1, y1, h, w} depending
+   *                      on UseCoordinates parameter.
+   * @param confidenceScores Vector containing confidence score corresponding
+   *                         to each bounding box.
+   * @param labels Vector containing the class of each bounding box.
+   * @param selectedIndices Output of Non Maximal Suppression (NMS) is stored
+   *                        here. It contains the indices of the selected
+   *                        bounding boxes of all classes, sorted in
+   *                        descending order of the confidence scores.
+   * @param threshold Threshold used to discard all overlapping bounding boxes
+   *                  of the same class that have IoU greater than the
+   *                  threshold.
+   */
+  template<
+      typename BoundingBoxesType,
+      typename ConfidenceScoreType,
+      typename LabelsType,
+      typename OutputType
+  >
+  static void BatchedEvaluate(const BoundingBoxesType& boundingBoxes,
+                              const ConfidenceScoreType& confidenceScores,
+                              const LabelsType& labels,
+                              OutputType& selectedIndices,
+                              const double threshold = 0.5);
+
   static const bool useCoordinates = UseCoordinates;
 
   //! Serialize the metric.
   template <typename Archive>
   void serialize(Archive &ar, const uint32_t /* version */);
+
+ private:
+  /**
+   * Sort the given indices of bounding boxes by descending confidence score
+   * (and by index for equal scores).
+   */
+  template<typename ConfidenceScoreType>
+  static void SortByScore(const ConfidenceScoreType& confidenceScores,
+                          std::vector<size_t>& indices);
+
+  /**
+   * Perform non-maximal suppression on the bounding boxes with the given
+   * indices, which are sorted by descending confidence score, and append the
+   * indices of the selected bounding boxes to selected, in the same order.
+   */
+  template<typename BoundingBoxesType>
+  static void Suppress(const BoundingBoxesType& boundingBoxes,
+                       const std::vector<size_t>& indices,
+                       const double threshold,
+                       std::vector<size_t>& selected);
 }; // Class NMS.
 
 } // namespace metric
@@ -1,5 +1,5 @@
 /**
- * @file core/metrics/nms_metric_impl.hpp
+ * @file core/metrics/non_maximal_supression_impl.hpp
  * @author Kartik Dutt
  *
  * Implementation of Non Maximal Supression metric.
@@ -35,93 +35,196 @@ void NMS<UseCoordinates>::Evaluate(
       box either in {x1, y1, x2, y2} or {x1, y1, h, w} format.\
       Refer to the documentation for more information.");
 
-  Log::Assert(confidenceScores.n_cols != boundingBoxes.n_cols, "Each \
+  Log::Assert(confidenceScores.n_elem == boundingBoxes.n_cols, "Each \
       bounding box must correspond to atleast and only 1 bounding box. \
-      Found " + std::to_string(confidenceScores.n_cols) + " confidence \
+      Found " + std::to_string(confidenceScores.n_elem) + " confidence \
       scores for " + std::to_string(boundingBoxes.n_cols) + " bounding boxes.");
 
-  // Clear selected bounding boxes.
-  selectedIndices.clear();
+  // Obtain sorted indices for bounding boxes according to their confidence
+  // scores.
+  std::vector<size_t> indices(boundingBoxes.n_cols);
+  for (size_t i = 0; i < indices.size(); ++i)
+    indices[i] = i;
+  SortByScore(confidenceScores, indices);
 
-  // Obtain Sorted indices for bounding boxes according to
-  // their confidence scores.
-  arma::ucolvec sortedIndices = arma::sort_index(confidenceScores);
+  std::vector<size_t> selected;
+  Suppress(boundingBoxes, indices, threshold, selected);
 
-  // Pre-Compute area of each bounding box.
-  arma::mat area;
-  if (UseCoordinates)
-  {
-    area = (boundingBoxes.row(2) - boundingBoxes.row(0)) %
-        (boundingBoxes.row(3) - boundingBoxes.row(1));
-  }
-  else
+  selectedIndices.set_size(selected.size());
+  for (size_t i = 0; i < selected.size(); ++i)
+    selectedIndices[i] = selected[i];
+}
+
+template<bool UseCoordinates>
+template<
+    typename BoundingBoxesType,
+    typename ConfidenceScoreType,
+    typename LabelsType,
+    typename OutputType
+>
+void NMS<UseCoordinates>::BatchedEvaluate(
+    const BoundingBoxesType& boundingBoxes,
+    const ConfidenceScoreType& confidenceScores,
+    const LabelsType& labels,
+    OutputType& selectedIndices,
+    const double threshold)
+{
+  Log::Assert(boundingBoxes.n_rows == 4, "Bounding boxes must "
+      "contain only 4 rows determining coordinates of bounding "
+      "box either in {x1, y1, x2, y2} or {x1, y1, h, w} format. "
+      "Refer to the documentation for more information.");
+
+  Log::Assert(confidenceScores.n_elem == boundingBoxes.n_cols &&
+      labels.n_elem == boundingBoxes.n_cols, "Each bounding box must "
+      "correspond to exactly one confidence score and one label. Found " +
+      std::to_string(confidenceScores.n_elem) + " confidence scores and " +
+      std::to_string(labels.n_elem) + " labels for " +
+      std::to_string(boundingBoxes.n_cols) + " bounding boxes.");
+
+  // Group the bounding boxes by class.
+  std::vector<size_t> indices(boundingBoxes.n_cols);
+  for (size_t i = 0; i < indices.size(); ++i)
+    indices[i] = i;
+  std::stable_sort(indices.begin(), indices.end(),
+      [&labels](const size_t a, const size_t b)
+      {
+        return labels[a] < labels[b];
+      });
+
+  // Suppress the bounding boxes of each class separately; the classes are
+  // handled one after another, since Suppress() is parallel itself.
+  std::vector<size_t> selected, classIndices;
+  size_t begin = 0;
+  while (begin < indices.size())
   {
-    area = boundingBoxes.row(2) % boundingBoxes.row(3);
+    size_t end = begin + 1;
+    while (end < indices.size() &&
+        labels[indices[end]] == labels[indices[begin]])
+      ++end;
+
+    classIndices.assign(indices.begin() + begin, indices.begin() + end);
+    SortByScore(confidenceScores, classIndices);
+    Suppress(boundingBoxes, classIndices, threshold, selected);
+    begin = end;
   }
 
-  while (sortedIndices.n_elem > 0)
-  {
-    size_t selectedIndex = sortedIndices(sortedIndices.n_elem - 1);
+  SortByScore(confidenceScores, selected);
+  selectedIndices.set_size(selected.size());
+  for (size_t i = 0; i < selected.size(); ++i)
+    selectedIndices[i] = selected[i];
+}
 
-    // Choose the box with the largest probability.
-    selectedIndices.insert_rows(0, arma::uvec(1).fill(selectedIndex));
+template<bool UseCoordinates>
+template<typename ConfidenceScoreType>
+void NMS<UseCoordinates>::SortByScore(
+    const ConfidenceScoreType& confidenceScores,
+    std::vector<size_t>& indices)
+{
+  std::sort(indices.begin(), indices.end(),
+      [&confidenceScores](const size_t a, const size_t b)
+      {
+        if (confidenceScores[a] != confidenceScores[b])
+          return confidenceScores[a] > confidenceScores[b];
+        return a < b;
+      });
+}
 
-    // Check if there are other bounding boxes to compare with.
-    if (sortedIndices.n_elem == 1)
+template<bool UseCoordinates>
+template<typename BoundingBoxesType>
+void NMS<UseCoordinates>::Suppress(
+    const BoundingBoxesType& boundingBoxes,
+    const std::vector<size_t>& indices,
+    const double threshold,
+    std::vector<size_t>& selected)
+{
+  typedef typename BoundingBoxesType::elem_type ElemType;
+
+  // Copy the corners and the area of the bounding boxes, in order of score,
+  // into separate arrays, so that the comparisons of a box with a block of
+  // boxes can be vectorized.
+  const size_t n = indices.size();
+  std::vector<ElemType> x1(n), y1(n), x2(n), y2(n), area(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    const size_t index = indices[i];
+    x1[i] = boundingBoxes(0, index);
+    y1[i] = boundingBoxes(1, index);
+    if (UseCoordinates)
     {
-      break;
+      x2[i] = boundingBoxes(2, index);
+      y2[i] = boundingBoxes(3, index);
     }
-
-    // Remove the last index.
-    sortedIndices = sortedIndices(arma::span(0, sortedIndices.n_rows - 2),
-        arma::span());
-
-    // Get x and y coordinates for remaining bounding boxes.
-    BoundingBoxesType x2 = boundingBoxes.submat(arma::uvec(1).fill(2),
-        sortedIndices);
-
-    BoundingBoxesType x1 = boundingBoxes.submat(arma::uvec(1).fill(0),
-        sortedIndices);;
-
-    BoundingBoxesType y2 = boundingBoxes.submat(arma::uvec(1).fill(3),
-        sortedIndices);
-
-    BoundingBoxesType y1 = boundingBoxes.submat(arma::uvec(1).fill(1),
-        sortedIndices);
-
-    size_t selectedX2 = boundingBoxes(2, selectedIndex);
-    size_t selectedY2 = boundingBoxes(3, selectedIndex);
-    size_t selectedX1 = boundingBoxes(0, selectedIndex);
-    size_t selectedY1 = boundingBoxes(1, selectedIndex);
-
-    if (!UseCoordinates)
+    else
     {
       // Change height - width representation to coordinate represention.
-      x2 = x2 + x1;
-      y2 = y2 + y1;
-      selectedX2 = selectedX2 + selectedX1;
-      selectedY2 = selectedY2 + selectedY1;
+      x2[i] = x1[i] + boundingBoxes(2, index);
+      y2[i] = y1[i] + boundingBoxes(3, index);
     }
+    area[i] = (x2[i] - x1[i]) * (y2[i] - y1[i]);
+  }
 
-    // Calculate points of intersection between the bounding box with
-    // highest confidence score and remaining bounding boxes.
-    x2 = arma::clamp(x2, DBL_MIN, selectedX2);
-    y2 = arma::clamp(y2, DBL_MIN, selectedY2);
-    x1 = arma::clamp(x1, selectedX1, DBL_MAX);
-    y1 = arma::clamp(y1, selectedY1, DBL_MAX);
+  // Return a mask of the boxes in [begin, end) that have an IoU greater than
+  // the threshold with box i.  The IoU is compared without a division.
+  auto overlaps = [&](const size_t i, const size_t begin, const size_t end)
+  {
+    uint64_t mask = 0;
+    for (size_t j = begin; j < end; ++j)
+    {
+      const ElemType width = std::max(ElemType(0),
+          std::min(x2[i], x2[j]) - std::max(x1[i], x1[j]));
+      const ElemType height = std::max(ElemType(0),
+          std::min(y2[i], y2[j]) - std::max(y1[i], y1[j]));
+      const ElemType intersection = width * height;
+      const bool suppressed = !(intersection <=
+          threshold * (area[i] + area[j] - intersection));
+      mask |= ((uint64_t) suppressed) << (j - begin);
+    }
+    return mask;
+  };
+
+  // One bit for each box, set when the box is suppressed.
+  const size_t numBlocks = (n + 63) / 64;
+  std::vector<uint64_t> removed(numBlocks, 0);
+  std::vector<size_t> blockSelected;
+  for (size_t block = 0; block < numBlocks; ++block)
+  {
+    // Select the boxes of this block in order; they can only be suppressed by
+    // earlier boxes of the block now.
+    const size_t begin = 64 * block;
+    const size_t end = std::min(begin + 64, n);
+    blockSelected.clear();
+    for (size_t i = begin; i < end; ++i)
+    {
+      if ((removed[block] >> (i - begin)) & 1)
+        continue;
 
-    BoundingBoxesType intersectionArea = arma::clamp(x2 - x1, 0.0, DBL_MAX) %
-          arma::clamp(y2 - y1, 0.0, DBL_MAX);
+      blockSelected.push_back(i);
+      selected.push_back(indices[i]);
+      if (i + 1 < end)
+        removed[block] |= (overlaps(i, i + 1, end) << (i + 1 - begin));
+    }
 
-    // Calculate IoU of remaining boxes with the last bounding box with
-    // the highest confidence score.
-    BoundingBoxesType calculateIoU = intersectionArea /
-        (area(sortedIndices).t() - intersectionArea + area(selectedIndex));
+    if (blockSelected.empty())
+      continue;
 
-    sortedIndices = sortedIndices(arma::find(calculateIoU <= threshold));
+    // Suppress the boxes of the later blocks that overlap with the selected
+    // boxes of this block.  Each block has its own mask, so the blocks can be
+    // handled in parallel.
+    #pragma omp parallel for schedule(dynamic, 16) \
+        if (numBlocks - block > 64)
+    for (omp_size_t b = block + 1; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t laterBegin = 64 * b;
+      const size_t laterEnd = std::min(laterBegin + 64, n);
+      const uint64_t full = (laterEnd - laterBegin == 64) ? ~((uint64_t) 0) :
+          ((((uint64_t) 1) << (laterEnd - laterBegin)) - 1);
+
+      uint64_t mask = removed[b];
+      for (size_t s = 0; s < blockSelected.size() && mask != full; ++s)
+        mask |= overlaps(blockSelected[s], laterBegin, laterEnd);
+      removed[b] = mask;
+    }
   }
-
-  selectedIndices = arma::flipud(selectedIndices);
 }
 
 template<bool UseCoordinates>
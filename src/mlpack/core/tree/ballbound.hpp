@@ -24,8 +24,20 @@ namespace bound {
  * specific point (center). MetricType is the custom metric type that defaults
  * to the Euclidean (L2) distance.
  *
+ * The center can be a fixed-size vector, so that low-dimensional bounds do not
+ * allocate memory; for instance, this is a ball tree for 3-dimensional data:
+ *
+ * @code
+ * template<typename MetricType>
+ * using Ball3Bound = BallBound<MetricType, arma::vec::fixed<3>>;
+ *
+ * typedef BinarySpaceTree<EuclideanDistance, EmptyStatistic, arma::mat,
+ *     Ball3Bound> Ball3Tree;
+ * @endcode
+ *
  * @tparam MetricType metric type used in the distance measure.
- * @tparam VecType Type of vector (arma::vec or arma::sp_vec or similar).
+ * @tparam VecType Type of vector (arma::vec, arma::vec::fixed<3>, arma::sp_vec
+ *     or similar).
  */
 template<typename MetricType = metric::LMetric<2, true>,
          typename VecType = arma::vec>
@@ -121,7 +133,8 @@ class BallBound
    *
    * @param center Vector which the centroid will be written to.
    */
-  void Center(VecType& center) const { center = this->center; }
+  template<typename OutVecType>
+  void Center(OutVecType& center) const { center = this->center; }
 
   /**
    * Calculates minimum bound-to-point squared distance.
@@ -37,10 +37,12 @@ BallBound<MetricType, VecType>::BallBound() :
 template<typename MetricType, typename VecType>
 BallBound<MetricType, VecType>::BallBound(const size_t dimension) :
     radius(std::numeric_limits<ElemType>::lowest()),
-    center(dimension),
     metric(new MetricType()),
     ownsMetric(true)
-{ /* Nothing to do. */ }
+{
+  // This also works for fixed-size vectors, which have no size constructor.
+  center.zeros(dimension, 1);
+}
 
 /**
  * Create the ball bound with the specified radius and center.
@@ -85,7 +87,7 @@ BallBound<MetricType, VecType>& BallBound<MetricType, VecType>::operator=(
 template<typename MetricType, typename VecType>
 BallBound<MetricType, VecType>::BallBound(BallBound&& other) :
     radius(other.radius),
-    center(other.center),
+    center(std::move(other.center)),
     metric(other.metric),
     ownsMetric(other.ownsMetric)
 {
@@ -288,15 +290,16 @@ BallBound<MetricType, VecType>::operator|=(const MatType& data)
   // Now iteratively add points.
   for (size_t i = 0; i < data.n_cols; ++i)
   {
-    const ElemType dist = metric->Evaluate(center, (VecType) data.col(i));
+    // The column is not copied, so no memory is allocated for each point.
+    const ElemType dist = metric->Evaluate(center, data.col(i));
 
     // See if the new point lies outside the bound.
     if (dist > radius)
     {
       // Move towards the new point and increase the radius just enough to
-      // accommodate the new point.
-      const VecType diff = data.col(i) - center;
-      center += ((dist - radius) / (2 * dist)) * diff;
+      // accommodate the new point.  This is element-wise, so center can appear
+      // on both sides.
+      center += ((dist - radius) / (2 * dist)) * (data.col(i) - center);
       radius = 0.5 * (dist + radius);
     }
   }
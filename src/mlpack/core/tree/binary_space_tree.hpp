@@ -14,12 +14,14 @@
 
 #include <mlpack/prereqs.hpp>
 #include "bounds.hpp"
+#include "leaf_base_cases.hpp"
 #include "binary_space_tree/midpoint_split.hpp"
 #include "binary_space_tree/mean_split.hpp"
 #include "binary_space_tree/vantage_point_split.hpp"
 #include "binary_space_tree/rp_tree_max_split.hpp"
 #include "binary_space_tree/rp_tree_mean_split.hpp"
 #include "binary_space_tree/ub_tree_split.hpp"
+#include "binary_space_tree/morton_split.hpp"
 #include "binary_space_tree/binary_space_tree.hpp"
 #include "binary_space_tree/single_tree_traverser.hpp"
 #include "binary_space_tree/single_tree_traverser_impl.hpp"
@@ -27,6 +29,9 @@
 #include "binary_space_tree/dual_tree_traverser_impl.hpp"
 #include "binary_space_tree/breadth_first_dual_tree_traverser.hpp"
 #include "binary_space_tree/breadth_first_dual_tree_traverser_impl.hpp"
+#include "binary_space_tree/parallel_dual_tree_traverser.hpp"
+#include "binary_space_tree/parallel_dual_tree_traverser_impl.hpp"
+#include "binary_space_tree/flat_tree.hpp"
 #include "binary_space_tree/traits.hpp"
 #include "binary_space_tree/typedef.hpp"
 
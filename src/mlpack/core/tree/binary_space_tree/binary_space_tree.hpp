@@ -13,8 +13,10 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "../node_arena.hpp"
 #include "../statistic.hpp"
 #include "midpoint_split.hpp"
+#include "split_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -32,6 +34,10 @@ namespace tree /** Trees and tree-building procedures. */ {
  * This tree does take one runtime parameter in the constructor, which is the
  * max leaf size to be used.
  *
+ * The nodes of a tree built from a dataset are allocated from a NodeArena held
+ * by the root, so building and destroying a large tree does not allocate and
+ * free each node separately.
+ *
  * @tparam MetricType The metric used for tree-building.  The BoundType may
  *     place restrictions on the metrics that can be used.
  * @tparam StatisticType Extra data contained in the node.  See statistic.hpp
@@ -88,6 +94,13 @@ class BinarySpaceTree
   //! The dataset.  If we are the root of the tree, we own the dataset and must
   //! delete it.
   MatType* dataset;
+  //! The arena that holds the memory of the children of this node, or NULL if
+  //! the children are allocated separately (as in copied and loaded trees).  It
+  //! is shared by all the nodes of a tree, and owned by the root.
+  NodeArena<BinarySpaceTree>* arena;
+  //! Whether the nodes are stored in the layout given by Compact().  Only
+  //! meaningful for the root.
+  bool compact;
 
  public:
   //! A single-tree traverser for binary space trees; see
@@ -102,6 +115,11 @@ class BinarySpaceTree
   template<typename RuleType>
   class BreadthFirstDualTreeTraverser;
 
+  //! A task-parallel dual-tree traverser for binary space trees; see
+  //! parallel_dual_tree_traverser.hpp.
+  template<typename RuleType>
+  class ParallelDualTreeTraverser;
+
   /**
    * Construct this as the root node of a binary space tree using the given
    * dataset.  This will copy the input matrix; if you don't want this, consider
@@ -464,7 +482,9 @@ class BinarySpaceTree
   //! Return the minimum and maximum distance to another node.
   math::RangeType<ElemType> RangeDistance(const BinarySpaceTree& other) const
   {
-    return bound.RangeDistance(other.Bound());
+    // The bound may hold a different element type than the dataset.
+    const auto distances = bound.RangeDistance(other.Bound());
+    return math::RangeType<ElemType>(distances.Lo(), distances.Hi());
   }
 
   //! Return the minimum distance to another point.
@@ -491,7 +511,8 @@ class BinarySpaceTree
   RangeDistance(const VecType& point,
                 typename std::enable_if_t<IsVector<VecType>::value>* = 0) const
   {
-    return bound.RangeDistance(point);
+    const auto distances = bound.RangeDistance(point);
+    return math::RangeType<ElemType>(distances.Lo(), distances.Hi());
   }
 
   //! Return the index of the beginning point of this subset.
@@ -505,9 +526,70 @@ class BinarySpaceTree
   size_t& Count() { return count; }
 
   //! Store the center of the bounding region in the given vector.
-  void Center(arma::vec& center) const { bound.Center(center); }
+  void Center(arma::Col<ElemType>& center) const { bound.Center(center); }
+
+  /**
+   * Move every node of the tree (other than this node, which must be the root)
+   * into a single contiguous block of memory, in either van Emde Boas
+   * (cache-oblivious) or breadth-first order, and reallocate the bounds in the
+   * same order.  Points are already stored in the order of a depth-first
+   * traversal, so the points of every node remain contiguous.  This should be
+   * done once the tree is built; the tree can be traversed as before, but any
+   * pointers to the previous non-root nodes are invalidated.
+   *
+   * @param vanEmdeBoas If true, use the van Emde Boas layout; otherwise, use
+   *      breadth-first order.
+   */
+  void Compact(const bool vanEmdeBoas = true);
+
+  //! Return whether or not the nodes of the tree are stored contiguously (see
+  //! Compact()).  Only meaningful for the root.
+  bool IsCompact() const { return compact; }
+
+  /**
+   * Recompute the bounds of this node and of all its descendants, and the
+   * distances between them, after the points in the dataset have been moved
+   * (for instance, with Dataset()).  Each node keeps the same points, so the
+   * bounds may be looser than those of a new tree built on the moved points,
+   * but they are valid.  The statistics of the nodes are not updated.
+   */
+  void RefitBounds();
 
  private:
+  /**
+   * Delete the children of this node, whether they are individually allocated
+   * or held in the arena of the tree.  The children are set to NULL; if this
+   * node is the root, the arena is freed too.
+   */
+  void DeleteChildren();
+
+  /**
+   * Append the nodes within the given number of levels below the given node
+   * to the given vector, in van Emde Boas order.
+   *
+   * @param node Node to start from.
+   * @param levels Number of levels to lay out (at least 1).
+   * @param order Vector to append nodes to.
+   */
+  static void VanEmdeBoasOrder(BinarySpaceTree* node,
+                               const size_t levels,
+                               std::vector<BinarySpaceTree*>& order);
+
+  /**
+   * Append the descendants of the given node that are exactly the given number
+   * of levels below it to the given vector.
+   *
+   * @param node Node to start from.
+   * @param depth Depth of the descendants to collect.
+   * @param descendants Vector to append descendants to.
+   */
+  static void Descendants(BinarySpaceTree* node,
+                          const size_t depth,
+                          std::vector<BinarySpaceTree*>& descendants);
+
+  //! Return the number of levels in the subtree rooted at the given node.
+  static size_t Levels(const BinarySpaceTree* node);
+
   /**
    * Splits the current node, assigning its left and right children recursively.
    *
@@ -529,6 +611,31 @@ class BinarySpaceTree
                  const size_t maxLeafSize,
                  SplitType<BoundType<MetricType>, MatType>& splitter);
 
+  /**
+   * Build the children of the current node, which is split at the given
+   * column.  If the splitter allows it, the children of large nodes are built
+   * in parallel with OpenMP tasks.
+   *
+   * @param splitCol First column of the right child.
+   * @param oldFromNew Vector holding permuted indices, or NULL if the
+   *      permutation is not needed.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   */
+  void BuildChildren(const size_t splitCol,
+                     std::vector<size_t>* oldFromNew,
+                     const size_t maxLeafSize,
+                     SplitType<BoundType<MetricType>, MatType>& splitter);
+
+  //! Create a child of the current node holding the given points, in the arena
+  //! of the tree if there is one; it is split recursively.
+  BinarySpaceTree* NewChild(
+      const size_t childBegin,
+      const size_t childCount,
+      std::vector<size_t>* oldFromNew,
+      const size_t maxLeafSize,
+      SplitType<BoundType<MetricType>, MatType>& splitter);
+
   /**
    * Update the bound of the current node. This method does not take into
    * account bound-specific properties.
@@ -558,6 +665,9 @@ class BinarySpaceTree
   //! Friend access is given for the default constructor.
   friend class cereal::access;
 
+  //! FlatTree needs access to the node internals to rebuild a tree.
+  friend class FlatTree;
+
  public:
   /**
    * Serialize the tree.
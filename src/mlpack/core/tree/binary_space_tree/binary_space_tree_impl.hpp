@@ -16,6 +16,7 @@
 
 #include <mlpack/core/util/log.hpp>
 #include <queue>
+#include <unordered_map>
 
 namespace mlpack {
 namespace tree {
@@ -39,7 +40,9 @@ BinarySpaceTree(
     count(data.n_cols), /* and spans all of the dataset. */
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    arena(new NodeArena<BinarySpaceTree>()),
+    compact(false)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
@@ -67,7 +70,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    arena(new NodeArena<BinarySpaceTree>()),
+    compact(false)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(data.n_cols);
@@ -101,7 +106,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    arena(new NodeArena<BinarySpaceTree>()),
+    compact(false)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(data.n_cols);
@@ -136,7 +143,9 @@ BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    arena(new NodeArena<BinarySpaceTree>()),
+    compact(false)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
@@ -164,7 +173,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    arena(new NodeArena<BinarySpaceTree>()),
+    compact(false)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -198,7 +209,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    arena(new NodeArena<BinarySpaceTree>()),
+    compact(false)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -237,7 +250,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset()) // Point to the parent's dataset.
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    arena(parent->arena),
+    compact(false)
 {
   // Perform the actual splitting.
   SplitNode(maxLeafSize, splitter);
@@ -266,7 +281,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    arena(parent->arena),
+    compact(false)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -300,7 +317,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset()->n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    arena(parent->arena),
+    compact(false)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -342,7 +361,9 @@ BinarySpaceTree(
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
     // Copy matrix, but only if we are the root.
-    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL)
+    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL),
+    arena(NULL),
+    compact(false)
 {
   // Create left and right children (if any).
   if (other.Left())
@@ -398,11 +419,13 @@ operator=(const BinarySpaceTree& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  delete left;
-  delete right;
+  DeleteChildren();
 
+  // The copied children are allocated separately.
   left = NULL;
   right = NULL;
+  arena = NULL;
+  compact = false;
   parent = other.Parent();
   begin = other.Begin();
   count = other.Count();
@@ -470,8 +493,7 @@ operator=(BinarySpaceTree&& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  delete left;
-  delete right;
+  DeleteChildren();
 
   parent = other.Parent();
   left = other.Left();
@@ -484,6 +506,8 @@ operator=(BinarySpaceTree&& other)
   furthestDescendantDistance = other.FurthestDescendantDistance();
   minimumBoundDistance = other.MinimumBoundDistance();
   dataset = other.dataset;
+  arena = other.arena;
+  compact = other.compact;
 
   other.left = NULL;
   other.right = NULL;
@@ -494,6 +518,14 @@ operator=(BinarySpaceTree&& other)
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.arena = NULL;
+  other.compact = false;
+
+  // Set new parent.
+  if (left)
+    left->parent = this;
+  if (right)
+    right->parent = this;
 
   return *this;
 }
@@ -520,7 +552,9 @@ BinarySpaceTree(BinarySpaceTree&& other) :
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
-    dataset(other.dataset)
+    dataset(other.dataset),
+    arena(other.arena),
+    compact(other.compact)
 {
   // Now we are a clone of the other tree.  But we must also clear the other
   // tree's contents, so it doesn't delete anything when it is destructed.
@@ -533,6 +567,8 @@ BinarySpaceTree(BinarySpaceTree&& other) :
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.arena = NULL;
+  other.compact = false;
 
   // Set new parent.
   if (left)
@@ -576,14 +612,197 @@ template<typename MetricType,
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     ~BinarySpaceTree()
 {
-  delete left;
-  delete right;
+  DeleteChildren();
 
   // If we're the root, delete the matrix.
   if (!parent)
     delete dataset;
 }
 
+/**
+ * Move all of the non-root nodes into one contiguous block, in van Emde Boas or
+ * breadth-first order.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Compact(const bool vanEmdeBoas)
+{
+  if (parent != NULL)
+  {
+    throw std::invalid_argument("BinarySpaceTree::Compact(): only the root of "
+        "a tree can be compacted");
+  }
+
+  if (IsLeaf())
+    return;
+
+  // Determine the new order of the nodes; this node is always first.
+  std::vector<BinarySpaceTree*> order;
+  if (vanEmdeBoas)
+  {
+    VanEmdeBoasOrder(this, Levels(this), order);
+  }
+  else
+  {
+    order.push_back(this);
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+      if (order[i]->left)
+        order.push_back(order[i]->left);
+      if (order[i]->right)
+        order.push_back(order[i]->right);
+    }
+  }
+
+  // Allocate a new arena with a single block for all the nodes, and create
+  // empty nodes in it.
+  NodeArena<BinarySpaceTree>* newArena = new NodeArena<BinarySpaceTree>();
+  newArena->Reserve(order.size() - 1);
+  std::unordered_map<const BinarySpaceTree*, BinarySpaceTree*> newNodes;
+  newNodes[this] = this;
+  for (size_t i = 1; i < order.size(); ++i)
+    newNodes[order[i]] = new (newArena->Allocate()) BinarySpaceTree();
+
+  // Now fill the new nodes in layout order, so that the memory the bounds
+  // allocate is requested in that order too.
+  for (size_t i = 1; i < order.size(); ++i)
+  {
+    BinarySpaceTree* oldNode = order[i];
+    BinarySpaceTree* node = newNodes[oldNode];
+
+    node->left = (oldNode->left) ? newNodes[oldNode->left] : NULL;
+    node->right = (oldNode->right) ? newNodes[oldNode->right] : NULL;
+    node->parent = newNodes[oldNode->parent];
+    node->begin = oldNode->begin;
+    node->count = oldNode->count;
+    node->bound = oldNode->bound;
+    node->stat = std::move(oldNode->stat);
+    node->parentDistance = oldNode->parentDistance;
+    node->furthestDescendantDistance = oldNode->furthestDescendantDistance;
+    node->minimumBoundDistance = oldNode->minimumBoundDistance;
+    node->dataset = dataset;
+    node->arena = newArena;
+  }
+
+  // Free the old nodes and their arena.
+  BinarySpaceTree* newLeft = newNodes[left];
+  BinarySpaceTree* newRight = right ? newNodes[right] : NULL;
+  DeleteChildren();
+
+  left = newLeft;
+  right = newRight;
+  arena = newArena;
+  compact = true;
+}
+
+/**
+ * Delete the children of this node.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    DeleteChildren()
+{
+  if (arena)
+  {
+    // The memory of the children belongs to the arena, so they are only
+    // destroyed; the root frees the memory of all the nodes at once.
+    if (left)
+      left->~BinarySpaceTree();
+    if (right)
+      right->~BinarySpaceTree();
+
+    if (!parent)
+    {
+      delete arena;
+      arena = NULL;
+      compact = false;
+    }
+  }
+  else
+  {
+    delete left;
+    delete right;
+  }
+
+  left = NULL;
+  right = NULL;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    VanEmdeBoasOrder(BinarySpaceTree* node,
+                     const size_t levels,
+                     std::vector<BinarySpaceTree*>& order)
+{
+  if (levels == 1)
+  {
+    order.push_back(node);
+    return;
+  }
+
+  // Lay out the top half of the levels, then each subtree hanging below it.
+  const size_t topLevels = levels / 2;
+  VanEmdeBoasOrder(node, topLevels, order);
+
+  std::vector<BinarySpaceTree*> bottomRoots;
+  Descendants(node, topLevels, bottomRoots);
+  for (size_t i = 0; i < bottomRoots.size(); ++i)
+    VanEmdeBoasOrder(bottomRoots[i], levels - topLevels, order);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Descendants(BinarySpaceTree* node,
+                const size_t depth,
+                std::vector<BinarySpaceTree*>& descendants)
+{
+  if (depth == 0)
+  {
+    descendants.push_back(node);
+    return;
+  }
+
+  if (node->left)
+    Descendants(node->left, depth - 1, descendants);
+  if (node->right)
+    Descendants(node->right, depth - 1, descendants);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Levels(const BinarySpaceTree* node)
+{
+  if (node == NULL)
+    return 0;
+
+  return 1 + std::max(Levels(node->left), Levels(node->right));
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -858,6 +1077,38 @@ inline size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   return (begin + index);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    RefitBounds()
+{
+  // Rebuild the bound from the points, as SplitNode() does.  The left child is
+  // refit before the right child, because some bounds (HollowBallBound) depend
+  // on the bound of the left sibling.
+  bound = BoundType<MetricType>(dataset->n_rows);
+  UpdateBound(bound);
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  if (left == NULL || right == NULL)
+    return;
+
+  left->RefitBounds();
+  right->RefitBounds();
+
+  // Recalculate the parent distances of the children.
+  arma::Col<ElemType> center, leftCenter, rightCenter;
+  Center(center);
+  left->Center(leftCenter);
+  right->Center(rightCenter);
+
+  left->ParentDistance() = bound.Metric().Evaluate(center, leftCenter);
+  right->ParentDistance() = bound.Metric().Evaluate(center, rightCenter);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -903,14 +1154,12 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   assert(splitCol < begin + count);
 
   // Now that we know the split column, we will recursively split the children
-  // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, splitter,
-      maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      splitter, maxLeafSize);
+  // by calling their constructors (which perform this splitting process).  If
+  // the splitter allows it, large subtrees are built in parallel.
+  BuildChildren(splitCol, NULL, maxLeafSize, splitter);
 
   // Calculate parent distances for those two nodes.
-  arma::vec center, leftCenter, rightCenter;
+  arma::Col<ElemType> center, leftCenter, rightCenter;
   Center(center);
   left->Center(leftCenter);
   right->Center(rightCenter);
@@ -924,6 +1173,104 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   right->ParentDistance() = rightParentDistance;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BuildChildren(const size_t splitCol,
+              std::vector<size_t>* oldFromNew,
+              const size_t maxLeafSize,
+              SplitType<BoundType<MetricType>, MatType>& splitter)
+{
+  // Nodes with fewer points than this are not worth a separate task.
+  const size_t minParallelSplitSize = 5000;
+
+  // Each child only touches its own columns of the dataset (and its own
+  // entries of oldFromNew), so the children can be built at the same time as
+  // long as the splitter itself holds no state.  The resulting tree is the
+  // same as the one built serially.
+  const bool parallel = SplitTraits<Split>::ParallelSplit &&
+      (count >= 2 * minParallelSplitSize);
+
+  if (!parallel)
+  {
+    left = NewChild(begin, splitCol - begin, oldFromNew, maxLeafSize,
+        splitter);
+    right = NewChild(splitCol, begin + count - splitCol, oldFromNew,
+        maxLeafSize, splitter);
+    return;
+  }
+
+  // If we are not inside a parallel region yet (i.e., this is the first large
+  // node), start one; the tasks of all the descendants will then run in it.
+  bool inParallel = false;
+  #ifdef HAS_OPENMP
+    inParallel = omp_in_parallel();
+  #endif
+
+  BinarySpaceTree* leftChild = NULL;
+  BinarySpaceTree* rightChild = NULL;
+  #pragma omp parallel if (!inParallel)
+  {
+    #pragma omp single
+    {
+      #pragma omp task shared(leftChild)
+      leftChild = NewChild(begin, splitCol - begin, oldFromNew, maxLeafSize,
+          splitter);
+
+      #pragma omp task shared(rightChild)
+      rightChild = NewChild(splitCol, begin + count - splitCol, oldFromNew,
+          maxLeafSize, splitter);
+
+      #pragma omp taskwait
+    }
+  }
+
+  left = leftChild;
+  right = rightChild;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>*
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+NewChild(const size_t childBegin,
+         const size_t childCount,
+         std::vector<size_t>* oldFromNew,
+         const size_t maxLeafSize,
+         SplitType<BoundType<MetricType>, MatType>& splitter)
+{
+  // The children of a node are allocated in the same way as the node itself.
+  if (arena)
+  {
+    void* memory = arena->Allocate();
+    if (oldFromNew)
+    {
+      return new (memory) BinarySpaceTree(this, childBegin, childCount,
+          *oldFromNew, splitter, maxLeafSize);
+    }
+
+    return new (memory) BinarySpaceTree(this, childBegin, childCount,
+        splitter, maxLeafSize);
+  }
+
+  if (oldFromNew)
+  {
+    return new BinarySpaceTree(this, childBegin, childCount, *oldFromNew,
+        splitter, maxLeafSize);
+  }
+
+  return new BinarySpaceTree(this, childBegin, childCount, splitter,
+      maxLeafSize);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -971,14 +1318,12 @@ SplitNode(std::vector<size_t>& oldFromNew,
   assert(splitCol < begin + count);
 
   // Now that we know the split column, we will recursively split the children
-  // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, oldFromNew,
-      splitter, maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      oldFromNew, splitter, maxLeafSize);
+  // by calling their constructors (which perform this splitting process).  If
+  // the splitter allows it, large subtrees are built in parallel.
+  BuildChildren(splitCol, &oldFromNew, maxLeafSize, splitter);
 
   // Calculate parent distances for those two nodes.
-  arma::vec center, leftCenter, rightCenter;
+  arma::Col<ElemType> center, leftCenter, rightCenter;
   Center(center);
   left->Center(leftCenter);
   right->Center(rightCenter);
@@ -1049,7 +1394,9 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     stat(*this),
     parentDistance(0),
     furthestDescendantDistance(0),
-    dataset(NULL)
+    dataset(NULL),
+    arena(NULL),
+    compact(false)
 {
   // Nothing to do.
 }
@@ -1070,16 +1417,16 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   // If we're loading, and we have children, they need to be deleted.
   if (cereal::is_loading<Archive>())
   {
-    if (left)
-      delete left;
-    if (right)
-      delete right;
+    DeleteChildren();
     if (!parent)
       delete dataset;
 
+    // The loaded children are allocated separately.
     parent = NULL;
     left = NULL;
     right = NULL;
+    arena = NULL;
+    compact = false;
   }
 
   ar(CEREAL_NVP(begin));
@@ -131,7 +131,6 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
     {
       // Loop through each of the points in each node.
       const size_t queryEnd = queryNode.Begin() + queryNode.Count();
-      const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
       for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
       {
         // See if we need to investigate this point (this function should be
@@ -142,8 +141,8 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
 //        if (childScore == DBL_MAX)
 //          continue; // We can't improve this particular point.
 
-        for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
-          rule.BaseCase(query, ref);
+        LeafBaseCases(rule, query, referenceNode.Begin(),
+            referenceNode.Count());
 
         numBaseCases += referenceNode.Count();
       }
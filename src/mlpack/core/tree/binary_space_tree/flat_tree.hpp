@@ -0,0 +1,133 @@
+/**
+ * @file core/tree/binary_space_tree/flat_tree.hpp
+ *
+ * Definition of FlatTree, which stores a BinarySpaceTree with hyperrectangle
+ * bounds in a flat binary layout that can be used directly from a memory
+ * mapping.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_FLAT_TREE_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_FLAT_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/mapped_file.hpp>
+
+namespace mlpack {
+namespace tree {
+
+//! Whether or not a bound type is an HRectBound.
+template<typename BoundType>
+struct IsHRectBound : std::false_type { };
+
+template<typename MetricType, typename ElemType>
+struct IsHRectBound<bound::HRectBound<MetricType, ElemType>> :
+    std::true_type { };
+
+/**
+ * FlatTree writes a BinarySpaceTree to a stream in a flat layout: a small
+ * header, then the dataset as one contiguous column-major block, then an array
+ * of node records (in breadth-first order, with children referred to by their
+ * index), then the bounds of every node as one contiguous block.  The blocks
+ * are aligned to 64 bytes relative to the start of the file.
+ *
+ * When a tree is loaded from a MappedFile, the dataset of the tree is an alias
+ * of the mapped memory, so it is neither read nor copied until it is used, and
+ * processes that map the same file share it through the page cache.  Only the
+ * (much smaller) node objects are rebuilt.  The MappedFile must therefore
+ * outlive the loaded tree; the tree must also not be modified.
+ *
+ * Only trees with HRectBound bounds (such as the kd-tree) are supported; other
+ * bound types cause a std::invalid_argument to be thrown.  The layout uses the
+ * byte order and type sizes of the machine, so files are not portable between
+ * architectures.
+ */
+class FlatTree
+{
+ public:
+  /**
+   * Write the given tree to the given stream, at the current position.  The
+   * tree must be the root of the tree.
+   *
+   * @param tree Tree to save.
+   * @param stream Binary stream to write to.
+   */
+  template<typename TreeType>
+  static void Save(const TreeType& tree, std::ostream& stream);
+
+  /**
+   * Load a tree from the given mapped file, starting at the given offset.  The
+   * offset is updated to point just past the tree.  The returned tree must be
+   * deleted by the caller, before the mapped file is released.
+   *
+   * @param file Mapped file to load from.
+   * @param offset Offset (in bytes) of the tree in the file.
+   */
+  template<typename TreeType>
+  static TreeType* Load(const data::MappedFile& file, size_t& offset);
+
+ private:
+  //! Identifier written at the start of each tree.
+  static constexpr uint64_t magic = 0x31454552544C4654ULL;
+
+  //! The header of a flat tree.
+  struct Header
+  {
+    uint64_t magic;
+    uint64_t elemSize;
+    uint64_t dimensionality;
+    uint64_t numPoints;
+    uint64_t numNodes;
+  };
+
+  //! The record of a single node.  Children and parents are given by index;
+  //! an index of SIZE_MAX means there is none.
+  struct Node
+  {
+    uint64_t begin;
+    uint64_t count;
+    uint64_t parent;
+    uint64_t left;
+    uint64_t right;
+    double parentDistance;
+    double furthestDescendantDistance;
+  };
+
+  //! Write padding so that the stream position is a multiple of 64 bytes.
+  static void Align(std::ostream& stream);
+
+  //! Round the offset up to a multiple of 64 bytes.
+  static size_t Align(const size_t offset);
+
+  //! Write a hyperrectangle bound.
+  template<typename MetricType, typename ElemType>
+  static void SaveBound(const bound::HRectBound<MetricType, ElemType>& bound,
+                        std::ostream& stream);
+
+  //! Other bound types are not supported.
+  template<typename BoundType>
+  static void SaveBound(const BoundType& bound, std::ostream& stream);
+
+  //! Read a hyperrectangle bound with the given dimensionality.
+  template<typename MetricType, typename ElemType>
+  static void LoadBound(bound::HRectBound<MetricType, ElemType>& bound,
+                        const size_t dimensionality,
+                        const char* data);
+
+  //! Other bound types are not supported.
+  template<typename BoundType>
+  static void LoadBound(BoundType& bound,
+                        const size_t dimensionality,
+                        const char* data);
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_tree_impl.hpp"
+
+#endif
@@ -0,0 +1,244 @@
+/**
+ * @file core/tree/binary_space_tree/flat_tree_impl.hpp
+ *
+ * Implementation of FlatTree, which stores a BinarySpaceTree with
+ * hyperrectangle bounds in a flat binary layout.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_FLAT_TREE_IMPL_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_FLAT_TREE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType>
+void FlatTree::Save(const TreeType& tree, std::ostream& stream)
+{
+  typedef typename TreeType::ElemType ElemType;
+
+  if (tree.Parent() != NULL)
+  {
+    throw std::invalid_argument("FlatTree::Save(): the given node is not the "
+        "root of the tree");
+  }
+
+  // Check this before anything is written.
+  typedef typename std::remove_const<typename std::remove_reference<decltype(
+      tree.Bound())>::type>::type BoundType;
+  if (!IsHRectBound<BoundType>::value)
+  {
+    throw std::invalid_argument("FlatTree::Save(): only trees with HRectBound "
+        "bounds are supported");
+  }
+
+  // Collect the nodes in breadth-first order, so that the index of every child
+  // is known when its parent's record is created.
+  std::vector<const TreeType*> nodes(1, &tree);
+  std::vector<uint64_t> parents(1, SIZE_MAX);
+  std::vector<Node> records;
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    const TreeType* node = nodes[i];
+
+    Node record;
+    record.begin = node->Begin();
+    record.count = node->Count();
+    record.parent = parents[i];
+    record.left = SIZE_MAX;
+    record.right = SIZE_MAX;
+    record.parentDistance = node->ParentDistance();
+    record.furthestDescendantDistance = node->FurthestDescendantDistance();
+
+    if (node->Left())
+    {
+      record.left = nodes.size();
+      nodes.push_back(node->Left());
+      parents.push_back(i);
+    }
+    if (node->Right())
+    {
+      record.right = nodes.size();
+      nodes.push_back(node->Right());
+      parents.push_back(i);
+    }
+
+    records.push_back(record);
+  }
+
+  Header header;
+  header.magic = magic;
+  header.elemSize = sizeof(ElemType);
+  header.dimensionality = tree.Dataset().n_rows;
+  header.numPoints = tree.Dataset().n_cols;
+  header.numNodes = nodes.size();
+
+  Align(stream);
+  stream.write((const char*) &header, sizeof(Header));
+  Align(stream);
+  stream.write((const char*) tree.Dataset().memptr(),
+      sizeof(ElemType) * tree.Dataset().n_elem);
+  Align(stream);
+  stream.write((const char*) records.data(), sizeof(Node) * records.size());
+  Align(stream);
+  for (size_t i = 0; i < nodes.size(); ++i)
+    SaveBound(nodes[i]->Bound(), stream);
+
+  if (!stream.good())
+    throw std::runtime_error("FlatTree::Save(): error writing tree");
+}
+
+template<typename TreeType>
+TreeType* FlatTree::Load(const data::MappedFile& file, size_t& offset)
+{
+  typedef typename TreeType::ElemType ElemType;
+  typedef typename TreeType::Mat MatType;
+  typedef typename std::remove_reference<decltype(
+      std::declval<TreeType&>().Stat())>::type StatisticType;
+
+  offset = Align(offset);
+  if (offset + sizeof(Header) > file.Size())
+  {
+    throw std::runtime_error("FlatTree::Load(): file '" + file.Filename() +
+        "' is truncated");
+  }
+
+  Header header;
+  std::memcpy(&header, file.Data() + offset, sizeof(Header));
+  if (header.magic != magic)
+  {
+    throw std::runtime_error("FlatTree::Load(): file '" + file.Filename() +
+        "' does not contain a flat tree at the given offset");
+  }
+  if (header.elemSize != sizeof(ElemType))
+  {
+    throw std::runtime_error("FlatTree::Load(): the element type of the tree "
+        "in file '" + file.Filename() + "' does not match");
+  }
+  if (header.numNodes == 0)
+  {
+    throw std::runtime_error("FlatTree::Load(): the tree in file '" +
+        file.Filename() + "' has no nodes");
+  }
+
+  const size_t dimensionality = header.dimensionality;
+  const size_t datasetOffset = Align(offset + sizeof(Header));
+  const size_t nodeOffset = Align(datasetOffset +
+      sizeof(ElemType) * dimensionality * header.numPoints);
+  const size_t boundOffset = Align(nodeOffset +
+      sizeof(Node) * header.numNodes);
+  const size_t boundSize = sizeof(ElemType) * (2 * dimensionality + 1);
+  offset = boundOffset + boundSize * header.numNodes;
+  if (offset > file.Size())
+  {
+    throw std::runtime_error("FlatTree::Load(): file '" + file.Filename() +
+        "' is truncated");
+  }
+
+  // The dataset is a read-only alias of the mapped memory.
+  MatType* dataset = new MatType((ElemType*) (file.Data() + datasetOffset),
+      dimensionality, header.numPoints, false, true);
+
+  std::vector<TreeType*> nodes(header.numNodes);
+  for (size_t i = 0; i < nodes.size(); ++i)
+    nodes[i] = new TreeType();
+
+  const Node* records = (const Node*) (file.Data() + nodeOffset);
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    TreeType& node = *nodes[i];
+    const Node& record = records[i];
+
+    node.begin = record.begin;
+    node.count = record.count;
+    node.parent = (record.parent == SIZE_MAX) ? NULL : nodes[record.parent];
+    node.left = (record.left == SIZE_MAX) ? NULL : nodes[record.left];
+    node.right = (record.right == SIZE_MAX) ? NULL : nodes[record.right];
+    node.parentDistance = (ElemType) record.parentDistance;
+    node.furthestDescendantDistance =
+        (ElemType) record.furthestDescendantDistance;
+    node.dataset = dataset;
+
+    LoadBound(node.bound, dimensionality,
+        file.Data() + boundOffset + i * boundSize);
+    node.minimumBoundDistance = node.bound.MinWidth() / 2.0;
+  }
+
+  // Statistics may depend on the statistics of the children, so initialize
+  // them bottom-up.
+  for (size_t i = nodes.size(); i > 0; --i)
+    nodes[i - 1]->stat = StatisticType(*nodes[i - 1]);
+
+  return nodes[0];
+}
+
+inline void FlatTree::Align(std::ostream& stream)
+{
+  const size_t position = (size_t) stream.tellp();
+  const size_t padding = Align(position) - position;
+  const char zeros[64] = { 0 };
+  stream.write(zeros, padding);
+}
+
+inline size_t FlatTree::Align(const size_t offset)
+{
+  return (offset + 63) / 64 * 64;
+}
+
+template<typename MetricType, typename ElemType>
+void FlatTree::SaveBound(const bound::HRectBound<MetricType, ElemType>& bound,
+                         std::ostream& stream)
+{
+  for (size_t d = 0; d < bound.Dim(); ++d)
+  {
+    const ElemType lo = bound[d].Lo();
+    const ElemType hi = bound[d].Hi();
+    stream.write((const char*) &lo, sizeof(ElemType));
+    stream.write((const char*) &hi, sizeof(ElemType));
+  }
+
+  const ElemType minWidth = bound.MinWidth();
+  stream.write((const char*) &minWidth, sizeof(ElemType));
+}
+
+template<typename BoundType>
+void FlatTree::SaveBound(const BoundType& /* bound */,
+                         std::ostream& /* stream */)
+{
+  throw std::invalid_argument("FlatTree::Save(): only trees with HRectBound "
+      "bounds are supported");
+}
+
+template<typename MetricType, typename ElemType>
+void FlatTree::LoadBound(bound::HRectBound<MetricType, ElemType>& bound,
+                         const size_t dimensionality,
+                         const char* data)
+{
+  bound = bound::HRectBound<MetricType, ElemType>(dimensionality);
+
+  const ElemType* values = (const ElemType*) data;
+  for (size_t d = 0; d < dimensionality; ++d)
+    bound[d] = math::RangeType<ElemType>(values[2 * d], values[2 * d + 1]);
+
+  bound.MinWidth() = values[2 * dimensionality];
+}
+
+template<typename BoundType>
+void FlatTree::LoadBound(BoundType& /* bound */,
+                         const size_t /* dimensionality */,
+                         const char* /* data */)
+{
+  throw std::invalid_argument("FlatTree::Load(): only trees with HRectBound "
+      "bounds are supported");
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * @file core/tree/binary_space_tree/morton_split.hpp
+ *
+ * Definition of MortonSplit, a class that sorts the dataset along the Morton
+ * (Z-order) curve and splits binary space partitioning tree nodes at the
+ * boundaries of Z-order cells.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_MORTON_SPLIT_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_MORTON_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+/**
+ * Split a node at the boundary of the largest Z-order cell that contains its
+ * points.  When the root is split, each point is quantized to a grid over the
+ * bounding box of the dataset and given a 64-bit Morton code (the bits of its
+ * grid coordinates, interleaved), and the dataset is sorted by Morton code
+ * once.  Every node then holds a contiguous range of the Z-order curve, and is
+ * split where the highest bit in which the codes of its points differ changes;
+ * in two dimensions this gives the cells of a quadtree, and in three
+ * dimensions the cells of an octree, but with the points of each node stored
+ * contiguously and in locality order.
+ *
+ * Since nearby points are next to each other in memory, both the points of a
+ * leaf and the leaves visited by a query are close together, which helps
+ * low-dimensional (e.g. geospatial) searches that are dominated by memory
+ * accesses.  Each dimension gets 64 / d bits of the code, so this split is
+ * meant for data with few dimensions; with more than 64 dimensions, only the
+ * first 64 are used for the codes (the bounds of the nodes are still exact).
+ */
+template<typename BoundType, typename MatType = arma::mat>
+class MortonSplit
+{
+ public:
+  //! An information about the partition.
+  struct SplitInfo
+  {
+    //! The column to split at.
+    size_t splitCol;
+    //! The order of the points along the curve, if the dataset must be
+    //! rearranged (only when the root is split); NULL otherwise.
+    const std::vector<size_t>* order;
+  };
+
+  /**
+   * Find the column to split the node at.  If this is the root, the Morton
+   * codes of all points are computed and sorted first.
+   *
+   * @param bound The bound used for this node.
+   * @param data The dataset used by the binary space tree.
+   * @param begin Index of the starting point in the dataset that belongs to
+   *    this node.
+   * @param count Number of points in this node.
+   * @param splitInfo An information about the split.
+   */
+  bool SplitNode(const BoundType& bound,
+                 MatType& data,
+                 const size_t begin,
+                 const size_t count,
+                 SplitInfo& splitInfo);
+
+  /**
+   * Rearrange the dataset along the curve (if this is the root) and return the
+   * split column.
+   *
+   * @param data The dataset used by the binary space tree.
+   * @param begin Index of the starting point in the dataset that belongs to
+   *    this node.
+   * @param count Number of points in this node.
+   * @param splitInfo The information about the split.
+   */
+  static size_t PerformSplit(MatType& data,
+                             const size_t begin,
+                             const size_t count,
+                             const SplitInfo& splitInfo);
+
+  /**
+   * Rearrange the dataset along the curve (if this is the root) and return the
+   * split column, and update the list of changed indices.
+   *
+   * @param data The dataset used by the binary space tree.
+   * @param begin Index of the starting point in the dataset that belongs to
+   *    this node.
+   * @param count Number of points in this node.
+   * @param splitInfo The information about the split.
+   * @param oldFromNew Vector which will be filled with the old positions for
+   *    each new point.
+   */
+  static size_t PerformSplit(MatType& data,
+                             const size_t begin,
+                             const size_t count,
+                             const SplitInfo& splitInfo,
+                             std::vector<size_t>& oldFromNew);
+
+  /**
+   * Compute the Morton code of each point of the given dataset, quantized to a
+   * grid over the given bounding box.
+   *
+   * @param data The dataset.
+   * @param minimums The minimum value of each dimension.
+   * @param maximums The maximum value of each dimension.
+   * @param codes Vector to store the code of each point in.
+   */
+  static void ComputeCodes(const MatType& data,
+                           const arma::Col<typename MatType::elem_type>&
+                               minimums,
+                           const arma::Col<typename MatType::elem_type>&
+                               maximums,
+                           std::vector<uint64_t>& codes);
+
+ private:
+  //! The Morton codes of the points, in the order of the rearranged dataset.
+  std::vector<uint64_t> codes;
+  //! The order of the points along the curve.
+  std::vector<size_t> order;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "morton_split_impl.hpp"
+
+#endif
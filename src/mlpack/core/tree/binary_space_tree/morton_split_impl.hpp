@@ -0,0 +1,156 @@
+/**
+ * @file core/tree/binary_space_tree/morton_split_impl.hpp
+ *
+ * Implementation of MortonSplit, a class that splits binary space partitioning
+ * tree nodes at the boundaries of Z-order cells.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_MORTON_SPLIT_IMPL_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_MORTON_SPLIT_IMPL_HPP
+
+#include "morton_split.hpp"
+
+#include <algorithm>
+
+namespace mlpack {
+namespace tree {
+
+template<typename BoundType, typename MatType>
+bool MortonSplit<BoundType, MatType>::SplitNode(const BoundType& /* bound */,
+                                                MatType& data,
+                                                const size_t begin,
+                                                const size_t count,
+                                                SplitInfo& splitInfo)
+{
+  splitInfo.order = NULL;
+  if (begin == 0 && count == data.n_cols)
+  {
+    // Compute the codes of all points and sort the points by code.  The
+    // dataset is rearranged by PerformSplit().
+    std::vector<uint64_t> unsorted;
+    ComputeCodes(data, arma::min(data, 1), arma::max(data, 1), unsorted);
+
+    order.resize(data.n_cols);
+    for (size_t i = 0; i < order.size(); ++i)
+      order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+        [&unsorted](const size_t a, const size_t b)
+        {
+          return unsorted[a] < unsorted[b];
+        });
+
+    codes.resize(data.n_cols);
+    for (size_t i = 0; i < order.size(); ++i)
+      codes[i] = unsorted[order[i]];
+
+    splitInfo.order = &order;
+  }
+
+  const uint64_t lo = codes[begin];
+  const uint64_t hi = codes[begin + count - 1];
+  if (lo == hi)
+  {
+    // All points are in the same (finest) cell; split at the median so that
+    // the leaves still get small.
+    splitInfo.splitCol = begin + count / 2;
+    return true;
+  }
+
+  // All codes of the node share the bits above the highest differing bit of
+  // the first and the last code.  The right child gets the codes that have
+  // this bit set.
+  size_t bit = 63;
+  while (((lo ^ hi) >> bit) == 0)
+    --bit;
+  const uint64_t firstRight = (hi >> bit) << bit;
+
+  splitInfo.splitCol = std::lower_bound(codes.begin() + begin,
+      codes.begin() + begin + count, firstRight) - codes.begin();
+  return true;
+}
+
+template<typename BoundType, typename MatType>
+size_t MortonSplit<BoundType, MatType>::PerformSplit(
+    MatType& data,
+    const size_t /* begin */,
+    const size_t /* count */,
+    const SplitInfo& splitInfo)
+{
+  // For the first time we have to rearrange the dataset.
+  if (splitInfo.order)
+  {
+    const arma::uvec indices = arma::conv_to<arma::uvec>::from(
+        *splitInfo.order);
+    data = MatType(data.cols(indices));
+  }
+
+  return splitInfo.splitCol;
+}
+
+template<typename BoundType, typename MatType>
+size_t MortonSplit<BoundType, MatType>::PerformSplit(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    const SplitInfo& splitInfo,
+    std::vector<size_t>& oldFromNew)
+{
+  if (splitInfo.order)
+  {
+    const std::vector<size_t> oldOldFromNew(oldFromNew);
+    for (size_t i = 0; i < splitInfo.order->size(); ++i)
+      oldFromNew[i] = oldOldFromNew[(*splitInfo.order)[i]];
+  }
+
+  return PerformSplit(data, begin, count, splitInfo);
+}
+
+template<typename BoundType, typename MatType>
+void MortonSplit<BoundType, MatType>::ComputeCodes(
+    const MatType& data,
+    const arma::Col<typename MatType::elem_type>& minimums,
+    const arma::Col<typename MatType::elem_type>& maximums,
+    std::vector<uint64_t>& codes)
+{
+  const size_t dims = std::min((size_t) data.n_rows, (size_t) 64);
+  const size_t bits = (dims == 0) ? 0 : std::min((size_t) 32, 64 / dims);
+  const double cells = std::ldexp(1.0, (int) bits);
+
+  // The scale of each dimension maps the bounding box to [0, cells).
+  arma::vec scales(dims);
+  for (size_t d = 0; d < dims; ++d)
+  {
+    const double range = (double) (maximums[d] - minimums[d]);
+    scales[d] = (range > 0) ? (cells / range) : 0.0;
+  }
+
+  codes.resize(data.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    uint64_t cell[64];
+    for (size_t d = 0; d < dims; ++d)
+    {
+      const double scaled = ((double) (data(d, i) - minimums[d])) * scales[d];
+      cell[d] = (uint64_t) std::min(std::max(scaled, 0.0), cells - 1.0);
+    }
+
+    // Interleave the bits, from the most significant one.
+    uint64_t code = 0;
+    for (size_t b = bits; b > 0; --b)
+      for (size_t d = 0; d < dims; ++d)
+        code = (code << 1) | ((cell[d] >> (b - 1)) & 1);
+
+    codes[i] = code;
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,150 @@
+/**
+ * @file core/tree/binary_space_tree/parallel_dual_tree_traverser.hpp
+ *
+ * Defines the ParallelDualTreeTraverser for the BinarySpaceTree tree type.
+ * This is a nested class of BinarySpaceTree which traverses two trees with a
+ * given set of rules, splitting the query tree into OpenMP tasks until the
+ * query nodes become smaller than a given grain size.  Each task then performs
+ * a regular depth-first dual-tree traversal.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "binary_space_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A task-parallel dual-tree traverser.  While the query node has at least
+ * GrainSize() descendants, each of its children is scored against the
+ * reference node and handed to its own OpenMP task; below that size, the
+ * regular DualTreeTraverser is used.  Since every task owns a disjoint query
+ * subtree, the rules only need to be safe for concurrent use on disjoint query
+ * subtrees that share the reference tree.
+ *
+ * Every task uses its own copy of the given rules.  Therefore RuleType must
+ * be copy-constructible, and a copy must share the result storage of the
+ * original (so that results found by a copy are visible in the original),
+ * while keeping its own traversal information and base case cache.  This is
+ * the case for NeighborSearchRules and RangeSearchRules.  Rules that modify
+ * reference node statistics during scoring (such as KDERules) or that share
+ * results between query points (such as DTBRules) cannot be used with this
+ * traverser.  After Traverse() returns, the number of base cases and scores of
+ * all copies has been added to the given rules.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+                      SplitType>::ParallelDualTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the parallel dual-tree traverser with the given rule set.
+   *
+   * @param rule Rules to use for the traversal.
+   * @param grainSize Query nodes with fewer descendants than this are traversed
+   *     serially by a single task.
+   */
+  ParallelDualTreeTraverser(RuleType& rule, const size_t grainSize = 1000);
+
+  /**
+   * Traverse the two trees.  This does not reset the number of prunes.
+   *
+   * @param queryNode The query node to be traversed.
+   * @param referenceNode The reference node to be traversed.
+   */
+  void Traverse(BinarySpaceTree& queryNode, BinarySpaceTree& referenceNode);
+
+  //! Get the grain size.
+  size_t GrainSize() const { return grainSize; }
+  //! Modify the grain size.
+  size_t& GrainSize() { return grainSize; }
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+  //! Get the number of visited combinations.
+  size_t NumVisited() const { return numVisited; }
+  //! Modify the number of visited combinations.
+  size_t& NumVisited() { return numVisited; }
+
+  //! Get the number of times a node combination was scored.
+  size_t NumScores() const { return numScores; }
+  //! Modify the number of times a node combination was scored.
+  size_t& NumScores() { return numScores; }
+
+  //! Get the number of times a base case was calculated.
+  size_t NumBaseCases() const { return numBaseCases; }
+  //! Modify the number of times a base case was calculated.
+  size_t& NumBaseCases() { return numBaseCases; }
+
+ private:
+  /**
+   * Traverse the given query node (which has already been scored against the
+   * reference node) with the given copy of the rules, spawning a task for each
+   * query child if the query node is large enough.
+   */
+  void TraverseTask(RuleType& taskRule,
+                    BinarySpaceTree& queryNode,
+                    BinarySpaceTree& referenceNode);
+
+  /**
+   * Add the base cases and scores performed by the given copy of the rules
+   * since the given initial counts, as well as the given traversal statistics,
+   * to the totals.  This is safe to call from several tasks at once.
+   */
+  void AddCounts(const RuleType& taskRule,
+                 const size_t initialBaseCases,
+                 const size_t initialScores,
+                 const size_t prunes,
+                 const size_t visited,
+                 const size_t scores,
+                 const size_t baseCases);
+
+  //! Reference to the rules with which the trees will be traversed.
+  RuleType& rule;
+
+  //! Query nodes with fewer descendants than this are traversed serially.
+  size_t grainSize;
+
+  //! The number of prunes.
+  size_t numPrunes;
+
+  //! The number of node combinations that have been visited during traversal.
+  size_t numVisited;
+
+  //! The number of times a node combination was scored.
+  size_t numScores;
+
+  //! The number of times a base case was calculated.
+  size_t numBaseCases;
+
+  //! The number of base cases performed by all copies of the rules.
+  size_t ruleBaseCases;
+
+  //! The number of scores performed by all copies of the rules.
+  size_t ruleScores;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "parallel_dual_tree_traverser_impl.hpp"
+
+#endif // MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
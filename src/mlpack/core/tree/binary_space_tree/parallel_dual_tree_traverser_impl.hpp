@@ -0,0 +1,206 @@
+/**
+ * @file core/tree/binary_space_tree/parallel_dual_tree_traverser_impl.hpp
+ *
+ * Implementation of the ParallelDualTreeTraverser for BinarySpaceTree.  The
+ * query tree is split into OpenMP tasks down to the grain size, and the
+ * regular DualTreeTraverser is used below that.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_dual_tree_traverser.hpp"
+#include "dual_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelDualTreeTraverser<RuleType>::ParallelDualTreeTraverser(
+    RuleType& rule,
+    const size_t grainSize) :
+    rule(rule),
+    grainSize(grainSize),
+    numPrunes(0),
+    numVisited(0),
+    numScores(0),
+    numBaseCases(0),
+    ruleBaseCases(0),
+    ruleScores(0)
+{ /* Nothing to do. */ }
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelDualTreeTraverser<RuleType>::Traverse(
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        queryNode,
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        referenceNode)
+{
+  // If the query node is too small to be split, there is nothing to gain from
+  // tasks.
+  if (queryNode.IsLeaf() || queryNode.NumDescendants() < grainSize)
+  {
+    DualTreeTraverser<RuleType> traverser(rule);
+    traverser.Traverse(queryNode, referenceNode);
+
+    numPrunes += traverser.NumPrunes();
+    numVisited += traverser.NumVisited();
+    numScores += traverser.NumScores();
+    numBaseCases += traverser.NumBaseCases();
+    return;
+  }
+
+  // If both nodes are root nodes, just score them.
+  if (queryNode.Parent() == NULL && referenceNode.Parent() == NULL)
+  {
+    const double rootScore = rule.Score(queryNode, referenceNode);
+    // If root score is DBL_MAX, don't recurse.
+    if (rootScore == DBL_MAX)
+    {
+      ++numPrunes;
+      return;
+    }
+  }
+
+  // The given rules are not used during the traversal itself; each task works
+  // on its own copy, and the copies share the results.
+  RuleType rootRule(rule);
+  ruleBaseCases = 0;
+  ruleScores = 0;
+
+  #pragma omp parallel
+  {
+    #pragma omp single
+    TraverseTask(rootRule, queryNode, referenceNode);
+  }
+
+  rule.BaseCases() += ruleBaseCases;
+  rule.Scores() += ruleScores;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelDualTreeTraverser<RuleType>::TraverseTask(
+    RuleType& taskRule,
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        queryNode,
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        referenceNode)
+{
+  const size_t initialBaseCases = taskRule.BaseCases();
+  const size_t initialScores = taskRule.Scores();
+
+  if (queryNode.IsLeaf() || queryNode.NumDescendants() < grainSize)
+  {
+    // Small enough: this task performs the rest of the traversal serially.
+    DualTreeTraverser<RuleType> traverser(taskRule);
+    traverser.Traverse(queryNode, referenceNode);
+    AddCounts(taskRule, initialBaseCases, initialScores,
+        traverser.NumPrunes(), traverser.NumVisited(), traverser.NumScores(),
+        traverser.NumBaseCases());
+    return;
+  }
+
+  // Score each query child against the reference node, and keep a copy of the
+  // rules (which holds the traversal information of that combination) for
+  // each child that can't be pruned.
+  const typename RuleType::TraversalInfoType traversalInfo =
+      taskRule.TraversalInfo();
+  std::vector<RuleType> childRules;
+  std::vector<BinarySpaceTree*> childNodes;
+  childRules.reserve(queryNode.NumChildren());
+  childNodes.reserve(queryNode.NumChildren());
+
+  size_t prunes = 0;
+  for (size_t i = 0; i < queryNode.NumChildren(); ++i)
+  {
+    taskRule.TraversalInfo() = traversalInfo;
+    const double score = taskRule.Score(queryNode.Child(i), referenceNode);
+    if (score == DBL_MAX)
+    {
+      ++prunes;
+      continue;
+    }
+
+    childRules.push_back(taskRule);
+    childNodes.push_back(&queryNode.Child(i));
+  }
+
+  AddCounts(taskRule, initialBaseCases, initialScores, prunes, 1,
+      queryNode.NumChildren(), 0);
+
+  BinarySpaceTree* referencePtr = &referenceNode;
+  for (size_t i = 0; i < childRules.size(); ++i)
+  {
+    #pragma omp task firstprivate(i, referencePtr) \
+        shared(childRules, childNodes)
+    TraverseTask(childRules[i], *childNodes[i], *referencePtr);
+  }
+
+  // The copies of the rules must stay alive until all children are done.
+  #pragma omp taskwait
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelDualTreeTraverser<RuleType>::AddCounts(
+    const RuleType& taskRule,
+    const size_t initialBaseCases,
+    const size_t initialScores,
+    const size_t prunes,
+    const size_t visited,
+    const size_t scores,
+    const size_t baseCases)
+{
+  const size_t newRuleBaseCases = taskRule.BaseCases() - initialBaseCases;
+  const size_t newRuleScores = taskRule.Scores() - initialScores;
+
+  #pragma omp atomic
+  ruleBaseCases += newRuleBaseCases;
+  #pragma omp atomic
+  ruleScores += newRuleScores;
+  #pragma omp atomic
+  numPrunes += prunes;
+  #pragma omp atomic
+  numVisited += visited;
+  #pragma omp atomic
+  numScores += scores;
+  #pragma omp atomic
+  numBaseCases += baseCases;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif // MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
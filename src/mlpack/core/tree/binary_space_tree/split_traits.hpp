@@ -0,0 +1,61 @@
+/**
+ * @file core/tree/binary_space_tree/split_traits.hpp
+ *
+ * A class for template metaprogramming traits for the SplitType classes of
+ * BinarySpaceTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+
+#include "midpoint_split.hpp"
+#include "mean_split.hpp"
+#include "morton_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A class to obtain compile-time traits about SplitType classes.  If you are
+ * writing your own SplitType class, you should make a template specialization
+ * in order to set the values correctly.
+ */
+template<typename SplitType>
+struct SplitTraits
+{
+  //! If true, the splitter holds no state and uses no random numbers, so
+  //! different nodes can be split at the same time and the result does not
+  //! depend on the order in which nodes are split.  This defaults to false.
+  static const bool ParallelSplit = false;
+};
+
+//! MidpointSplit only uses static methods and no randomness.
+template<typename BoundType, typename MatType>
+struct SplitTraits<MidpointSplit<BoundType, MatType>>
+{
+  static const bool ParallelSplit = true;
+};
+
+//! MeanSplit only uses static methods and no randomness.
+template<typename BoundType, typename MatType>
+struct SplitTraits<MeanSplit<BoundType, MatType>>
+{
+  static const bool ParallelSplit = true;
+};
+
+//! MortonSplit only writes its state when the root is split; the other nodes
+//! only read it.
+template<typename BoundType, typename MatType>
+struct SplitTraits<MortonSplit<BoundType, MatType>>
+{
+  static const bool ParallelSplit = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
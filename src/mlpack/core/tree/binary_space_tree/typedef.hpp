@@ -300,6 +300,28 @@ using UBTree = BinarySpaceTree<MetricType,
                                bound::CellBound,
                                UBTreeSplit>;
 
+/**
+ * A binary space tree over the Morton (Z-order) curve.  The dataset is sorted
+ * by Morton code when the tree is built, and each node is split at the
+ * boundary of the largest Z-order cell that contains its points, so the nodes
+ * are the nonempty cells of a quadtree (in two dimensions) or an octree (in
+ * three dimensions), with their points stored contiguously and in locality
+ * order.  Unlike the UBTree, each node has a tight hyperrectangle bound, so
+ * node-to-node distances are cheap.  This tree is meant for low-dimensional
+ * data, such as geospatial coordinates; dual-tree searches with a query
+ * MortonTree then process the query points in batches of nearby points.
+ *
+ * This template typedef satisfies the TreeType policy API.
+ *
+ * @see @ref trees, BinarySpaceTree, UBTree, Octree
+ */
+template<typename MetricType, typename StatisticType, typename MatType>
+using MortonTree = BinarySpaceTree<MetricType,
+                                   StatisticType,
+                                   MatType,
+                                   bound::HRectBound,
+                                   MortonSplit>;
+
 } // namespace tree
 } // namespace mlpack
 
@@ -496,18 +496,8 @@ inline ElemType CellBound<MetricType, ElemType>::MinDistance(
       // each's absolute value to itself and then sum those two, our
       // result is the non negative half of the equation times two;
       // then we raise to power Power.
-      if (MetricType::Power == 1)
-        sum += lower + std::fabs(lower) + higher + std::fabs(higher);
-      else if (MetricType::Power == 2)
-      {
-        ElemType dist = lower + std::fabs(lower) + higher + std::fabs(higher);
-        sum += dist * dist;
-      }
-      else
-      {
-        sum += pow((lower + fabs(lower)) + (higher + fabs(higher)),
-            (ElemType) MetricType::Power);
-      }
+      sum += math::IntPower<MetricType::Power>(
+          (lower + std::fabs(lower)) + (higher + std::fabs(higher)));
 
       if (sum >= minSum)
         break;
@@ -536,7 +526,7 @@ inline ElemType CellBound<MetricType, ElemType>::MinDistance(
       return (ElemType) pow((double) minSum,
           1.0 / (double) MetricType::Power) / 2.0;
     else
-      return minSum / pow(2.0, MetricType::Power);
+      return minSum / math::IntPower<MetricType::Power>((ElemType) 2);
   }
 }
 
@@ -565,19 +555,8 @@ ElemType CellBound<MetricType, ElemType>::MinDistance(const CellBound& other)
         //   x + fabs(x) = max(x * 2, 0)
         //   (x * 2)^2 / 4 = x^2
 
-        // The compiler should optimize out this if statement entirely.
-        if (MetricType::Power == 1)
-          sum += (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-        else if (MetricType::Power == 2)
-        {
-          ElemType dist = lower + std::fabs(lower) + higher + std::fabs(higher);
-          sum += dist * dist;
-        }
-        else
-        {
-          sum += pow((lower + fabs(lower)) + (higher + fabs(higher)),
-              (ElemType) MetricType::Power);
-        }
+        sum += math::IntPower<MetricType::Power>(
+            (lower + std::fabs(lower)) + (higher + std::fabs(higher)));
 
         if (sum >= minSum)
           break;
@@ -603,7 +582,7 @@ ElemType CellBound<MetricType, ElemType>::MinDistance(const CellBound& other)
       return (ElemType) pow((double) minSum,
           1.0 / (double) MetricType::Power) / 2.0;
     else
-      return minSum / pow(2.0, MetricType::Power);
+      return minSum / math::IntPower<MetricType::Power>((ElemType) 2);
   }
 }
 
@@ -628,12 +607,7 @@ inline ElemType CellBound<MetricType, ElemType>::MaxDistance(
       ElemType v = std::max(fabs(point[d] - loBound(d, i)),
           fabs(hiBound(d, i) - point[d]));
 
-      if (MetricType::Power == 1)
-        sum += v; // v is non-negative.
-      else if (MetricType::Power == 2)
-        sum += v * v;
-      else
-        sum += std::pow(v, (ElemType) MetricType::Power);
+      sum += math::IntPower<MetricType::Power>(v);
     }
 
     if (sum > maxSum)
@@ -676,13 +650,7 @@ inline ElemType CellBound<MetricType, ElemType>::MaxDistance(
         v = std::max(fabs(other.hiBound(d, j) - loBound(d, i)),
             fabs(hiBound(d, i) - other.loBound(d, j)));
 
-        // The compiler should optimize out this if statement entirely.
-        if (MetricType::Power == 1)
-          sum += v; // v is non-negative.
-        else if (MetricType::Power == 2)
-          sum += v * v;
-        else
-          sum += std::pow(v, (ElemType) MetricType::Power);
+        sum += math::IntPower<MetricType::Power>(v);
       }
 
       if (sum > maxSum)
@@ -727,34 +695,13 @@ CellBound<MetricType, ElemType>::RangeDistance(
       {
         v1 = other.loBound(d, j) - hiBound(d, i);
         v2 = loBound(d, i) - other.hiBound(d, j);
-        // One of v1 or v2 is negative.
-        if (v1 >= v2)
-        {
-          vHi = -v2; // Make it nonnegative.
-          vLo = (v1 > 0) ? v1 : 0; // Force to be 0 if negative.
-        }
-        else
-        {
-          vHi = -v1; // Make it nonnegative.
-          vLo = (v2 > 0) ? v2 : 0; // Force to be 0 if negative.
-        }
-
-        // The compiler should optimize out this if statement entirely.
-        if (MetricType::Power == 1)
-        {
-          loSum += vLo; // vLo is non-negative.
-          hiSum += vHi; // vHi is non-negative.
-        }
-        else if (MetricType::Power == 2)
-        {
-          loSum += vLo * vLo;
-          hiSum += vHi * vHi;
-        }
-        else
-        {
-          loSum += std::pow(vLo, (ElemType) MetricType::Power);
-          hiSum += std::pow(vHi, (ElemType) MetricType::Power);
-        }
+        // One of v1 or v2 is negative; the other one (if it is positive) is
+        // the gap between the bounds.  This is branch-free.
+        vLo = std::max(std::max(v1, v2), (ElemType) 0);
+        vHi = -std::min(v1, v2); // Make it nonnegative.
+
+        loSum += math::IntPower<MetricType::Power>(vLo);
+        hiSum += math::IntPower<MetricType::Power>(vHi);
       }
 
       if (loSum < minLoSum)
@@ -806,42 +753,13 @@ CellBound<MetricType, ElemType>::RangeDistance(
       v1 = loBound(d, i) - point[d]; // Negative if point[d] > lo.
       v2 = point[d] - hiBound(d, i); // Negative if point[d] < hi.
 
-      // One of v1 or v2 (or both) is negative.
-      if (v1 >= 0) // point[d] <= bounds_[d].Lo().
-      {
-        vHi = -v2; // v2 will be larger but must be negated.
-        vLo = v1;
-      }
-      else // point[d] is between lo and hi, or greater than hi.
-      {
-        if (v2 >= 0)
-        {
-          vHi = -v1; // v1 will be larger, but must be negated.
-          vLo = v2;
-        }
-        else
-        {
-          vHi = -std::min(v1, v2); // Both are negative, but we need the larger.
-          vLo = 0;
-        }
-      }
+      // One of v1 or v2 (or both) is negative; the other one (if it is
+      // positive) is the distance to the bound.  This is branch-free.
+      vLo = std::max(std::max(v1, v2), (ElemType) 0);
+      vHi = -std::min(v1, v2); // Make it nonnegative.
 
-      // The compiler should optimize out this if statement entirely.
-      if (MetricType::Power == 1)
-      {
-        loSum += vLo; // vLo is non-negative.
-        hiSum += vHi; // vHi is non-negative.
-      }
-      else if (MetricType::Power == 2)
-      {
-        loSum += vLo * vLo;
-        hiSum += vHi * vHi;
-      }
-      else
-      {
-        loSum += std::pow(vLo, (ElemType) MetricType::Power);
-        hiSum += std::pow(vHi, (ElemType) MetricType::Power);
-      }
+      loSum += math::IntPower<MetricType::Power>(vLo);
+      hiSum += math::IntPower<MetricType::Power>(vHi);
     }
     if (loSum < minLoSum)
       minLoSum = loSum;
@@ -968,8 +886,7 @@ inline ElemType CellBound<MetricType, ElemType>::Diameter() const
 {
   ElemType d = 0;
   for (size_t i = 0; i < dim; ++i)
-    d += std::pow(bounds[i].Hi() - bounds[i].Lo(),
-        (ElemType) MetricType::Power);
+    d += math::IntPower<MetricType::Power>(bounds[i].Hi() - bounds[i].Lo());
 
   if (MetricType::TakeRoot)
     return (ElemType) std::pow((double) d, 1.0 / (double) MetricType::Power);
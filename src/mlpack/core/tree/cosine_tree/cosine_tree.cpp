@@ -30,7 +30,8 @@ CosineTree::CosineTree(const arma::mat& dataset) :
   l2NormsSquared.zeros(numColumns);
 
   // Set indices and calculate squared norms of the columns.
-  for (size_t i = 0; i < numColumns; ++i)
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) numColumns; ++i)
   {
     indices[i] = i;
     double l2Norm = arma::norm(dataset.col(i), 2);
@@ -87,11 +88,20 @@ CosineTree::CosineTree(const arma::mat& dataset,
   // Declare the cosine tree priority queue.
   CosineNodeQueue treeQueue;
 
+  // The basis vectors of the nodes in the queue are also kept as the columns
+  // of a single matrix, so that orthonormalizing the children and estimating
+  // the errors are blocked matrix products instead of one dot product per
+  // basis vector; queueNodes[i] is the node whose basis vector is column i.
+  // The matrix only grows, and is reused by all the splits.
+  arma::mat queueBasis(dataset.n_rows, 16);
+  std::vector<CosineTree*> queueNodes;
+
   // Define root node of the tree and add it to the queue.
   CosineTree root(dataset);
-  arma::vec tempVector = arma::zeros(dataset.n_rows);
   root.L2Error(-1.0); // We don't know what the error is.
-  root.BasisVector(tempVector);
+  root.basisVector.zeros(dataset.n_rows);
+  queueBasis.col(0) = root.basisVector;
+  queueNodes.push_back(&root);
   treeQueue.push(&root);
 
   // Initialize Monte Carlo error estimate for comparison.
@@ -116,6 +126,18 @@ CosineTree::CosineTree(const arma::mat& dataset,
       break;
     }
 
+    // Remove the basis vector of the popped node from the basis matrix, by
+    // moving the last column into its place.
+    const size_t column = std::find(queueNodes.begin(), queueNodes.end(),
+        currentNode) - queueNodes.begin();
+    const size_t last = queueNodes.size() - 1;
+    if (column != last)
+    {
+      queueBasis.col(column) = queueBasis.col(last);
+      queueNodes[column] = queueNodes[last];
+    }
+    queueNodes.pop_back();
+
     // Split the node into left and right children.  We assume that this cannot
     // fail; it might fail if L2Error() is 0, but we have already avoided that
     // case.
@@ -126,27 +148,34 @@ CosineTree::CosineTree(const arma::mat& dataset,
     currentLeft = currentNode->Left();
     currentRight = currentNode->Right();
 
-    // Calculate basis vectors of left and right children.
-    arma::vec lBasisVector, rBasisVector;
-
-    ModifiedGramSchmidt(treeQueue, currentLeft->Centroid(), lBasisVector);
-    ModifiedGramSchmidt(treeQueue, currentRight->Centroid(), rBasisVector,
-                        &lBasisVector);
+    // Calculate basis vectors of left and right children, by orthonormalizing
+    // their centroids against the current basis in one block.
+    const size_t numBasis = queueNodes.size();
+    if (queueBasis.n_cols < numBasis + 2)
+      queueBasis.resize(dataset.n_rows, 2 * (numBasis + 2));
+    queueBasis.col(numBasis) = currentLeft->Centroid();
+    queueBasis.col(numBasis + 1) = currentRight->Centroid();
+    BlockGramSchmidt(queueBasis, numBasis, 2);
 
     // Add basis vectors to their respective nodes.
-    currentLeft->BasisVector(lBasisVector);
-    currentRight->BasisVector(rBasisVector);
-
-    // Calculate Monte Carlo error estimates for child nodes.
-    MonteCarloError(currentLeft, treeQueue, &lBasisVector, &rBasisVector);
-    MonteCarloError(currentRight, treeQueue, &lBasisVector, &rBasisVector);
+    currentLeft->basisVector = queueBasis.col(numBasis);
+    currentRight->basisVector = queueBasis.col(numBasis + 1);
+    queueNodes.push_back(currentLeft);
+    queueNodes.push_back(currentRight);
+
+    // Calculate Monte Carlo error estimates for child nodes, and then for the
+    // root node, with respect to the basis including both children.
+    const arma::mat basisAlias(queueBasis.memptr(), dataset.n_rows,
+        queueNodes.size(), false, true);
+    MonteCarloError(currentLeft, basisAlias);
+    MonteCarloError(currentRight, basisAlias);
 
     // Push child nodes into the priority queue.
     treeQueue.push(currentLeft);
     treeQueue.push(currentRight);
 
     // Calculate Monte Carlo error estimate for the root node.
-    monteCarloError = MonteCarloError(&root, treeQueue);
+    monteCarloError = MonteCarloError(&root, basisAlias);
   }
 
   // Construct the subspace basis from the current priority queue.
@@ -163,6 +192,7 @@ CosineTree::CosineTree(const CosineTree& other) :
     right(NULL),
     indices(other.indices),
     l2NormsSquared(other.l2NormsSquared),
+    cDistribution(other.cDistribution),
     centroid(other.centroid),
     basisVector(other.basisVector),
     splitPointIndex(other.SplitPointIndex()),
@@ -229,6 +259,7 @@ CosineTree& CosineTree::operator=(const CosineTree& other)
   right = other.Right();
   indices = other.indices;
   l2NormsSquared = other.l2NormsSquared;
+  cDistribution = other.cDistribution;
   centroid = other.centroid;
   basisVector = other.basisVector;
   splitPointIndex = other.SplitPointIndex();
@@ -283,6 +314,7 @@ CosineTree::CosineTree(CosineTree&& other) :
     right(other.right),
     indices(std::move(other.indices)),
     l2NormsSquared(std::move(other.l2NormsSquared)),
+    cDistribution(std::move(other.cDistribution)),
     centroid(std::move(other.centroid)),
     basisVector(std::move(other.basisVector)),
     splitPointIndex(other.splitPointIndex),
@@ -329,6 +361,7 @@ CosineTree& CosineTree::operator=(CosineTree&& other)
   right = other.Right();
   indices = std::move(other.indices);
   l2NormsSquared = std::move(other.l2NormsSquared);
+  cDistribution = std::move(other.cDistribution);
   centroid = std::move(other.centroid);
   basisVector = std::move(other.basisVector);
   splitPointIndex = other.SplitPointIndex();
@@ -401,10 +434,60 @@ void CosineTree::ModifiedGramSchmidt(CosineNodeQueue& treeQueue,
     newBasisVector /= arma::norm(newBasisVector, 2);
 }
 
+void CosineTree::BlockGramSchmidt(arma::mat& basis,
+                                  const size_t numBasis,
+                                  const size_t numNew)
+{
+  // Aliases of the current basis and of the new vectors; no data is copied.
+  arma::mat added(basis.colptr(numBasis), basis.n_rows, numNew, false, true);
+
+  // Remove the projections on the current basis from all the new vectors at
+  // once.
+  if (numBasis > 0)
+  {
+    const arma::mat current(basis.memptr(), basis.n_rows, numBasis, false,
+        true);
+    added -= current * (current.t() * added);
+  }
+
+  // Orthonormalize the new vectors among themselves.
+  for (size_t j = 0; j < numNew; ++j)
+  {
+    for (size_t k = 0; k < j; ++k)
+      added.col(j) -= arma::dot(added.col(k), added.col(j)) * added.col(k);
+
+    const double norm = arma::norm(added.col(j), 2);
+    if (norm)
+      added.col(j) /= norm;
+  }
+}
+
 double CosineTree::MonteCarloError(CosineTree* node,
                                    CosineNodeQueue& treeQueue,
                                    arma::vec* addBasisVector1,
                                    arma::vec* addBasisVector2)
+{
+  // Collect the basis vectors into a matrix, depending on whether additional
+  // basis vectors are passed.
+  const bool addVectors = (addBasisVector1 && addBasisVector2);
+  arma::mat basis(node->GetDataset().n_rows,
+      treeQueue.size() + (addVectors ? 2 : 0));
+
+  CosineNodeQueue::const_iterator j = treeQueue.begin();
+  size_t k = 0;
+  for ( ; j != treeQueue.end(); ++j, ++k)
+    basis.col(k) = (*j)->BasisVector();
+
+  if (addVectors)
+  {
+    basis.col(k++) = *addBasisVector1;
+    basis.col(k) = *addBasisVector2;
+  }
+
+  return MonteCarloError(node, basis);
+}
+
+double CosineTree::MonteCarloError(CosineTree* node, const arma::mat& basis)
 {
   std::vector<size_t> sampledIndices;
   arma::vec probabilities;
@@ -417,53 +500,15 @@ double CosineTree::MonteCarloError(CosineTree* node,
   // Get pointer to the original dataset.
   const arma::mat& dataset = node->GetDataset();
 
-  // Initialize weighted projection magnitudes as zeros.
-  arma::vec weightedMagnitudes;
-  weightedMagnitudes.zeros(numSamples);
-
-  // Set size of projection vector, depending on whether additional basis
-  // vectors are passed.
-  size_t projectionSize;
-  if (addBasisVector1 && addBasisVector2)
-    projectionSize = treeQueue.size() + 2;
-  else
-    projectionSize = treeQueue.size();
-
-  // For each sample, calculate the weighted projection onto the current basis.
+  // Project all the samples onto the current basis with a single product; the
+  // squared norm of each projection, weighted by its probability, is its
+  // weighted projection magnitude.
+  arma::mat samples(dataset.n_rows, numSamples);
   for (size_t i = 0; i < numSamples; ++i)
-  {
-    // Initialize projection as a vector of zeros.
-    arma::vec projection;
-    projection.zeros(projectionSize);
-
-    CosineTree *currentNode;
-    CosineNodeQueue::const_iterator j = treeQueue.begin();
-
-    size_t k = 0;
-    // Compute the projection of the sampled vector onto the existing subspace.
-    for ( ; j != treeQueue.end(); ++j, ++k)
-    {
-      currentNode = *j;
-
-      projection(k) = arma::dot(dataset.col(sampledIndices[i]),
-                                currentNode->BasisVector());
-    }
-    // If two additional vectors are passed, take their projections.
-    if (addBasisVector1 && addBasisVector2)
-    {
-      projection(k++) = arma::dot(dataset.col(sampledIndices[i]),
-                                  *addBasisVector1);
-      projection(k) = arma::dot(dataset.col(sampledIndices[i]),
-                                *addBasisVector2);
-    }
-
-    // Calculate the Frobenius norm squared of the projected vector.
-    double frobProjection = arma::norm(projection, "frob");
-    double frobProjectionSquared = frobProjection * frobProjection;
+    samples.col(i) = dataset.col(sampledIndices[i]);
 
-    // Calculate the weighted projection magnitude.
-    weightedMagnitudes(i) = frobProjectionSquared / probabilities(i);
-  }
+  const arma::vec weightedMagnitudes =
+      arma::sum(arma::square(basis.t() * samples), 0).t() / probabilities;
 
   // Compute mean and standard deviation of the weighted samples.
   double mu = arma::mean(weightedMagnitudes);
@@ -545,16 +590,9 @@ void CosineTree::ColumnSamplesLS(std::vector<size_t>& sampledIndices,
                                  arma::vec& probabilities,
                                  size_t numSamples)
 {
-  // Initialize the cumulative distribution vector size.
-  arma::vec cDistribution;
-  cDistribution.zeros(numColumns + 1);
-
-  // Calculate cumulative length-squared distribution for the node.
-  for (size_t i = 0; i < numColumns; ++i)
-  {
-    cDistribution(i + 1) = cDistribution(i) +
-        (l2NormsSquared(i) / frobNormSquared);
-  }
+  // Calculate cumulative length-squared distribution for the node, if it
+  // has not been calculated yet.
+  CalculateCDistribution();
 
   // Initialize sizes of the 'sampledIndices' and 'probabilities' vectors.
   sampledIndices.resize(numSamples);
@@ -581,16 +619,9 @@ size_t CosineTree::ColumnSampleLS()
     return 0;
   }
 
-  // Initialize the cumulative distribution vector size.
-  arma::vec cDistribution;
-  cDistribution.zeros(numColumns + 1);
-
-  // Calculate cumulative length-squared distribution for the node.
-  for (size_t i = 0; i < numColumns; ++i)
-  {
-    cDistribution(i + 1) = cDistribution(i) +
-        (l2NormsSquared(i) / frobNormSquared);
-  }
+  // Calculate cumulative length-squared distribution for the node, if it
+  // has not been calculated yet.
+  CalculateCDistribution();
 
   // Generate a random value for sampling.
   double randValue = arma::randu();
@@ -600,6 +631,21 @@ size_t CosineTree::ColumnSampleLS()
   return BinarySearch(cDistribution, randValue, start, end);
 }
 
+void CosineTree::CalculateCDistribution()
+{
+  // The columns of the node never change, so the distribution only has to be
+  // calculated once, even though the root node is sampled at every split.
+  if (cDistribution.n_elem == numColumns + 1)
+    return;
+
+  cDistribution.zeros(numColumns + 1);
+  for (size_t i = 0; i < numColumns; ++i)
+  {
+    cDistribution(i + 1) = cDistribution(i) +
+        (l2NormsSquared(i) / frobNormSquared);
+  }
+}
+
 size_t CosineTree::BinarySearch(arma::vec& cDistribution,
                                 double value,
                                 size_t start,
@@ -633,7 +679,8 @@ void CosineTree::CalculateCosines(arma::vec& cosines)
   // Initialize cosine vector as a vector of zeros.
   cosines.zeros(numColumns);
 
-  for (size_t i = 0; i < numColumns; ++i)
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) numColumns; ++i)
   {
     // If norm is zero, store cosine value as zero. Else, calculate cosine value
     // between two vectors.
@@ -655,10 +702,18 @@ void CosineTree::CalculateCentroid()
   // Initialize centroid as vector of zeros.
   centroid.zeros(dataset->n_rows);
 
-  // Calculate centroid of columns in the node.
-  for (size_t i = 0; i < numColumns; ++i)
+  // Calculate centroid of columns in the node; each thread sums a part of the
+  // columns.
+  #pragma omp parallel
   {
-    centroid += dataset->col(indices[i]);
+    arma::vec threadCentroid(dataset->n_rows, arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) numColumns; ++i)
+      threadCentroid += dataset->col(indices[i]);
+
+    #pragma omp critical
+    centroid += threadCentroid;
   }
   centroid /= numColumns;
 }
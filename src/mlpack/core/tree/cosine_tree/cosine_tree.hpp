@@ -133,6 +133,32 @@ class CosineTree
                          arma::vec* addBasisVector1 = NULL,
                          arma::vec* addBasisVector2 = NULL);
 
+  /**
+   * Estimates the squared error of the projection of the input node's matrix
+   * onto the subspace spanned by the columns of the given matrix, which must
+   * be orthonormal (or zero).  All the samples are projected with a single
+   * matrix product.
+   *
+   * @param node Node for which Monte Carlo estimate is calculated.
+   * @param basis Matrix whose columns span the current vector subspace.
+   */
+  double MonteCarloError(CosineTree* node, const arma::mat& basis);
+
+  /**
+   * Orthonormalizes the numNew columns of the given matrix that follow its
+   * first numBasis columns, which must already be orthonormal (or zero).  The
+   * projections on the first numBasis columns are removed from all the new
+   * columns at once, and then the new columns are orthonormalized among
+   * themselves.
+   *
+   * @param basis Matrix holding the current basis and the new vectors.
+   * @param numBasis Number of columns of the current basis.
+   * @param numNew Number of new vectors following the current basis.
+   */
+  void BlockGramSchmidt(arma::mat& basis,
+                        const size_t numBasis,
+                        const size_t numNew);
+
   /**
    * Constructs the final basis matrix, after the cosine tree construction.
    *
@@ -194,6 +220,12 @@ class CosineTree
    */
   void CalculateCentroid();
 
+  /**
+   * Calculate the cumulative Length-Squared distribution of the columns present
+   * in the node, unless it has already been calculated.
+   */
+  void CalculateCDistribution();
+
   //! Returns the basis of the constructed subspace.
   void GetFinalBasis(arma::mat& finalBasis) { finalBasis = basis; }
 
@@ -258,6 +290,8 @@ class CosineTree
   std::vector<size_t> indices;
   //! L2-norm squared of columns in the node.
   arma::vec l2NormsSquared;
+  //! Cumulative Length-Squared distribution of columns in the node.
+  arma::vec cDistribution;
   //! Centroid of columns of input matrix in the node.
   arma::vec centroid;
   //! Orthonormalized basis vector of the node.
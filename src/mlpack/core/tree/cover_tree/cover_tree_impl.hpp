@@ -15,6 +15,7 @@
 // In case it hasn't already been included.
 #include "cover_tree.hpp"
 
+#include <algorithm>
 #include <queue>
 #include <string>
 
@@ -1228,6 +1229,18 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CreateChildren(
   // computation later, we'll create an array holding the points in the near
   // set, and then after each run we'll check which of those (if any) were used
   // and we will remove them.  ...if that's faster.  I think it is.
+  //
+  // The near and far sets only shrink as children are built, so the point set
+  // of every child fits in the space needed by the first one, and the same
+  // buffers are reused for all the children of this node.
+  arma::Col<size_t> childIndices;
+  arma::vec childDistances;
+  if (nearSetSize + farSetSize > 1)
+  {
+    childIndices.set_size(nearSetSize + farSetSize);
+    childDistances.set_size(nearSetSize + farSetSize);
+  }
+
   while (nearSetSize > 0)
   {
     size_t newPointIndex = nearSetSize - 1;
@@ -1268,12 +1281,10 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CreateChildren(
       break;
     }
 
-    // Create the near and far set indices and distance vectors.  We don't fill
-    // in the self-point, yet.
-    arma::Col<size_t> childIndices(nearSetSize + farSetSize);
+    // Fill the near and far set indices for the child.  We don't fill in the
+    // self-point, yet.
     childIndices.rows(0, (nearSetSize + farSetSize - 2)) = indices.rows(1,
         nearSetSize + farSetSize - 1);
-    arma::vec childDistances(nearSetSize + farSetSize);
 
     // Build distances for the child.
     ComputeDistances(indices[0], childIndices, childDistances, nearSetSize
@@ -1392,9 +1403,15 @@ void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
                      const size_t pointSetSize)
 {
   // For each point, rebuild the distances.  The indices do not need to be
-  // modified.
+  // modified.  Large point sets (near the top of the tree) are handled in
+  // parallel; the distances do not depend on the order they are computed in,
+  // so the tree is the same as when built serially.  In high dimensions each
+  // distance is expensive, so smaller point sets are worth splitting too.
   distanceComps += pointSetSize;
-  for (size_t i = 0; i < pointSetSize; ++i)
+  const bool parallel = (pointSetSize >= 10000) ||
+      (pointSetSize * dataset->n_rows >= 200000);
+  #pragma omp parallel for schedule(static) if (parallel)
+  for (omp_size_t i = 0; i < (omp_size_t) pointSetSize; ++i)
   {
     distances[i] = metric->Evaluate(dataset->col(pointIndex),
         dataset->col(indices[i]));
@@ -1484,126 +1501,111 @@ void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
 {
   const size_t originalSum = nearSetSize + farSetSize + usedSetSize;
 
+  // Sort the child's used set, so that we can check whether a point is in it
+  // with a binary search instead of a scan over the whole set.  The child's
+  // used set does not need to be preserved, and the order of the points in our
+  // own sets does not depend on how the points in it are found, so the tree is
+  // the same.
+  size_t* childUsedBegin = childIndices.memptr() + childFarSetSize;
+  size_t* childUsedEnd = childUsedBegin + childUsedSetSize;
+  std::sort(childUsedBegin, childUsedEnd);
+  size_t numFound = 0;
+
   // Loop across the set.  We will swap points as we need.  It should be noted
   // that farSetSize and nearSetSize may change with each iteration of this loop
   // (depending on if we make a swap or not).
-  size_t startChildUsedSet = 0; // Where to start in the child set.
-  for (size_t i = 0; i < nearSetSize; ++i)
+  for (size_t i = 0; (i < nearSetSize) && (numFound < childUsedSetSize); ++i)
   {
     // Discover if this point was in the child's used set.
-    for (size_t j = startChildUsedSet; j < childUsedSetSize; ++j)
+    if (!std::binary_search(childUsedBegin, childUsedEnd, indices[i]))
+      continue;
+
+    // We have found a point; a swap is necessary.
+
+    // Since this point is from the near set, to preserve the near set, we must
+    // do a swap.
+    if (farSetSize > 0)
     {
-      if (childIndices[childFarSetSize + j] == indices[i])
+      if ((nearSetSize - 1) != i)
+      {
+        // In this case it must be a three-way swap.
+        size_t tempIndex = indices[nearSetSize + farSetSize - 1];
+        ElemType tempDist = distances[nearSetSize + farSetSize - 1];
+
+        size_t tempNearIndex = indices[nearSetSize - 1];
+        ElemType tempNearDist = distances[nearSetSize - 1];
+
+        indices[nearSetSize + farSetSize - 1] = indices[i];
+        distances[nearSetSize + farSetSize - 1] = distances[i];
+
+        indices[nearSetSize - 1] = tempIndex;
+        distances[nearSetSize - 1] = tempDist;
+
+        indices[i] = tempNearIndex;
+        distances[i] = tempNearDist;
+      }
+      else
       {
-        // We have found a point; a swap is necessary.
-
-        // Since this point is from the near set, to preserve the near set, we
-        // must do a swap.
-        if (farSetSize > 0)
-        {
-          if ((nearSetSize - 1) != i)
-          {
-            // In this case it must be a three-way swap.
-            size_t tempIndex = indices[nearSetSize + farSetSize - 1];
-            ElemType tempDist = distances[nearSetSize + farSetSize - 1];
-
-            size_t tempNearIndex = indices[nearSetSize - 1];
-            ElemType tempNearDist = distances[nearSetSize - 1];
-
-            indices[nearSetSize + farSetSize - 1] = indices[i];
-            distances[nearSetSize + farSetSize - 1] = distances[i];
-
-            indices[nearSetSize - 1] = tempIndex;
-            distances[nearSetSize - 1] = tempDist;
-
-            indices[i] = tempNearIndex;
-            distances[i] = tempNearDist;
-          }
-          else
-          {
-            // We can do a two-way swap.
-            size_t tempIndex = indices[nearSetSize + farSetSize - 1];
-            ElemType tempDist = distances[nearSetSize + farSetSize - 1];
-
-            indices[nearSetSize + farSetSize - 1] = indices[i];
-            distances[nearSetSize + farSetSize - 1] = distances[i];
-
-            indices[i] = tempIndex;
-            distances[i] = tempDist;
-          }
-        }
-        else if ((nearSetSize - 1) != i)
-        {
-          // A two-way swap is possible.
-          size_t tempIndex = indices[nearSetSize + farSetSize - 1];
-          ElemType tempDist = distances[nearSetSize + farSetSize - 1];
-
-          indices[nearSetSize + farSetSize - 1] = indices[i];
-          distances[nearSetSize + farSetSize - 1] = distances[i];
-
-          indices[i] = tempIndex;
-          distances[i] = tempDist;
-        }
-        else
-        {
-          // No swap is necessary.
-        }
-
-        // We don't need to do a complete preservation of the child index set,
-        // but we want to make sure we only loop over points we haven't seen.
-        // So increment the child counter by 1 and move a point if we need.
-        if (j != startChildUsedSet)
-        {
-          childIndices[childFarSetSize + j] = childIndices[childFarSetSize +
-              startChildUsedSet];
-        }
-
-        // Update all counters from the swaps we have done.
-        ++startChildUsedSet;
-        --nearSetSize;
-        --i; // Since we moved a point out of the near set we must step back.
-
-        break; // Break out of this for loop; back to the first one.
+        // We can do a two-way swap.
+        size_t tempIndex = indices[nearSetSize + farSetSize - 1];
+        ElemType tempDist = distances[nearSetSize + farSetSize - 1];
+
+        indices[nearSetSize + farSetSize - 1] = indices[i];
+        distances[nearSetSize + farSetSize - 1] = distances[i];
+
+        indices[i] = tempIndex;
+        distances[i] = tempDist;
       }
     }
+    else if ((nearSetSize - 1) != i)
+    {
+      // A two-way swap is possible.
+      size_t tempIndex = indices[nearSetSize + farSetSize - 1];
+      ElemType tempDist = distances[nearSetSize + farSetSize - 1];
+
+      indices[nearSetSize + farSetSize - 1] = indices[i];
+      distances[nearSetSize + farSetSize - 1] = distances[i];
+
+      indices[i] = tempIndex;
+      distances[i] = tempDist;
+    }
+    else
+    {
+      // No swap is necessary.
+    }
+
+    // Update all counters from the swaps we have done.
+    ++numFound;
+    --nearSetSize;
+    --i; // Since we moved a point out of the near set we must step back.
   }
 
   // Now loop over the far set.  This loop is different because we only require
   // a normal two-way swap instead of the three-way swap to preserve the near
   // set / far set ordering.
-  for (size_t i = 0; i < farSetSize; ++i)
+  for (size_t i = 0; (i < farSetSize) && (numFound < childUsedSetSize); ++i)
   {
     // Discover if this point was in the child's used set.
-    for (size_t j = startChildUsedSet; j < childUsedSetSize; ++j)
-    {
-      if (childIndices[childFarSetSize + j] == indices[i + nearSetSize])
-      {
-        // We have found a point to swap.
-
-        // Perform the swap.
-        size_t tempIndex = indices[nearSetSize + farSetSize - 1];
-        ElemType tempDist = distances[nearSetSize + farSetSize - 1];
+    if (!std::binary_search(childUsedBegin, childUsedEnd,
+        indices[i + nearSetSize]))
+      continue;
 
-        indices[nearSetSize + farSetSize - 1] = indices[nearSetSize + i];
-        distances[nearSetSize + farSetSize - 1] = distances[nearSetSize + i];
+    // We have found a point to swap.
 
-        indices[nearSetSize + i] = tempIndex;
-        distances[nearSetSize + i] = tempDist;
+    // Perform the swap.
+    size_t tempIndex = indices[nearSetSize + farSetSize - 1];
+    ElemType tempDist = distances[nearSetSize + farSetSize - 1];
 
-        if (j != startChildUsedSet)
-        {
-          childIndices[childFarSetSize + j] = childIndices[childFarSetSize +
-              startChildUsedSet];
-        }
+    indices[nearSetSize + farSetSize - 1] = indices[nearSetSize + i];
+    distances[nearSetSize + farSetSize - 1] = distances[nearSetSize + i];
 
-        // Update all counters from the swaps we have done.
-        ++startChildUsedSet;
-        --farSetSize;
-        --i;
+    indices[nearSetSize + i] = tempIndex;
+    distances[nearSetSize + i] = tempDist;
 
-        break; // Break out of this for loop; back to the first one.
-      }
-    }
+    // Update all counters from the swaps we have done.
+    ++numFound;
+    --farSetSize;
+    --i;
   }
 
   // Update used set size.
@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/math/range.hpp>
+#include <mlpack/core/math/int_power.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include "bound_traits.hpp"
 
@@ -46,6 +47,10 @@ struct IsLMetric<metric::LMetric<Power, TakeRoot>>
  * with the LMetric class.  Be sure to use the same template parameters for
  * LMetric as you do for HRectBound -- otherwise odd results may occur.
  *
+ * The ranges of bounds with at most three dimensions are stored in the bound
+ * itself, so trees on 2-D and 3-D data (octrees, geographic data) do not
+ * allocate memory for their bounds.
+ *
  * @tparam MetricType Type of metric to use; must be of type LMetric.
  * @tparam ElemType Element type (double/float/int/etc.).
  */
@@ -236,10 +241,22 @@ class HRectBound
   void serialize(Archive& ar, const uint32_t version);
 
  private:
+  //! The largest dimensionality whose ranges are stored in the bound itself.
+  static constexpr size_t inlineDims = 3;
+
+  //! Set the dimensionality, and point bounds to storage for the ranges.  The
+  //! bound must not hold ranges.
+  void Allocate(const size_t dimension);
+  //! Release the storage of the ranges.
+  void Release();
+
   //! The dimensionality of the bound.
   size_t dim;
-  //! The bounds for each dimension.
+  //! The bounds for each dimension; this points to inlineBounds if dim is at
+  //! most inlineDims, and to an allocated array otherwise.
   math::RangeType<ElemType>* bounds;
+  //! The ranges of low-dimensional bounds.
+  math::RangeType<ElemType> inlineBounds[inlineDims];
   //! Cached minimum width of bound.
   ElemType minWidth;
   //! Instantiated metric (likely has size 0).
@@ -36,10 +36,12 @@ inline HRectBound<MetricType, ElemType>::HRectBound() :
  */
 template<typename MetricType, typename ElemType>
 inline HRectBound<MetricType, ElemType>::HRectBound(const size_t dimension) :
-    dim(dimension),
-    bounds(new math::RangeType<ElemType>[dim]),
+    dim(0),
+    bounds(NULL),
     minWidth(0)
-{ /* Nothing to do. */ }
+{
+  Allocate(dimension);
+}
 
 /**
  * Copy constructor necessary to prevent memory leaks.
@@ -47,10 +49,12 @@ inline HRectBound<MetricType, ElemType>::HRectBound(const size_t dimension) :
 template<typename MetricType, typename ElemType>
 inline HRectBound<MetricType, ElemType>::HRectBound(
     const HRectBound<MetricType, ElemType>& other) :
-    dim(other.Dim()),
-    bounds(new math::RangeType<ElemType>[dim]),
+    dim(0),
+    bounds(NULL),
     minWidth(other.MinWidth())
 {
+  Allocate(other.Dim());
+
   // Copy other bounds over.
   for (size_t i = 0; i < dim; ++i)
     bounds[i] = other[i];
@@ -71,11 +75,8 @@ inline HRectBound<
   if (dim != other.Dim())
   {
     // Reallocation is necessary.
-    if (bounds)
-      delete[] bounds;
-
-    dim = other.Dim();
-    bounds = new math::RangeType<ElemType>[dim];
+    Release();
+    Allocate(other.Dim());
   }
 
   // Now copy each of the bound values.
@@ -93,14 +94,11 @@ inline HRectBound<
 template<typename MetricType, typename ElemType>
 inline HRectBound<MetricType, ElemType>::HRectBound(
     HRectBound<MetricType, ElemType>&& other) :
-    dim(other.dim),
-    bounds(other.bounds),
+    dim(0),
+    bounds(NULL),
     minWidth(other.minWidth)
 {
-  // Fix the other bound.
-  other.dim = 0;
-  other.bounds = NULL;
-  other.minWidth = 0.0;
+  *this = std::move(other);
 }
 
 /**
@@ -113,11 +111,24 @@ HRectBound<MetricType, ElemType>::operator=(
 {
   if (this != &other)
   {
-    bounds = other.bounds;
+    Release();
+
+    // Ranges stored in the other bound itself have to be copied.
+    if (other.bounds == other.inlineBounds)
+    {
+      Allocate(other.dim);
+      for (size_t i = 0; i < dim; ++i)
+        bounds[i] = other.bounds[i];
+    }
+    else
+    {
+      bounds = other.bounds;
+      dim = other.dim;
+    }
+
     minWidth = other.minWidth;
-    dim = other.dim;
     other.dim = 0;
-    other.bounds = nullptr;
+    other.bounds = NULL;
     other.minWidth = 0.0;
   }
   return *this;
@@ -129,8 +140,33 @@ HRectBound<MetricType, ElemType>::operator=(
 template<typename MetricType, typename ElemType>
 inline HRectBound<MetricType, ElemType>::~HRectBound()
 {
-  if (bounds)
+  Release();
+}
+
+template<typename MetricType, typename ElemType>
+inline void HRectBound<MetricType, ElemType>::Allocate(const size_t dimension)
+{
+  dim = dimension;
+  if (dim <= inlineDims)
+  {
+    bounds = inlineBounds;
+    for (size_t i = 0; i < dim; ++i)
+      bounds[i] = math::RangeType<ElemType>();
+  }
+  else
+  {
+    bounds = new math::RangeType<ElemType>[dim];
+  }
+}
+
+template<typename MetricType, typename ElemType>
+inline void HRectBound<MetricType, ElemType>::Release()
+{
+  if (bounds != inlineBounds)
     delete[] bounds;
+
+  bounds = NULL;
+  dim = 0;
 }
 
 /**
@@ -203,18 +239,8 @@ inline ElemType HRectBound<MetricType, ElemType>::MinDistance(
     // Since only one of 'lower' or 'higher' is negative, if we add each's
     // absolute value to itself and then sum those two, our result is the
     // nonnegative half of the equation times two; then we raise to power Power.
-    if (MetricType::Power == 1)
-      sum += (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-    else if (MetricType::Power == 2)
-    {
-      ElemType dist = (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-      sum += dist * dist;
-    }
-    else
-    {
-      sum += pow((lower + fabs(lower)) + (higher + fabs(higher)),
-          (ElemType) MetricType::Power);
-    }
+    sum += math::IntPower<MetricType::Power>(
+        (lower + std::fabs(lower)) + (higher + std::fabs(higher)));
   }
 
   // Now take the Power'th root (but make sure our result is squared if it needs
@@ -236,7 +262,7 @@ inline ElemType HRectBound<MetricType, ElemType>::MinDistance(
       return (ElemType) pow((double) sum,
           1.0 / (double) MetricType::Power) / 2.0;
     else
-      return sum / pow(2.0, MetricType::Power);
+      return sum / math::IntPower<MetricType::Power>((ElemType) 2);
   }
 }
 
@@ -262,19 +288,8 @@ ElemType HRectBound<MetricType, ElemType>::MinDistance(const HRectBound& other)
     //   x + fabs(x) = max(x * 2, 0)
     //   (x * 2)^2 / 4 = x^2
 
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-      sum += (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-    else if (MetricType::Power == 2)
-    {
-      ElemType dist = (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-      sum += dist * dist;
-    }
-    else
-    {
-      sum += pow((lower + fabs(lower)) + (higher + fabs(higher)),
-          (ElemType) MetricType::Power);
-    }
+    sum += math::IntPower<MetricType::Power>(
+        (lower + std::fabs(lower)) + (higher + std::fabs(higher)));
 
     // Move bound pointers.
     mbound++;
@@ -297,7 +312,7 @@ ElemType HRectBound<MetricType, ElemType>::MinDistance(const HRectBound& other)
       return (ElemType) pow((double) sum,
           1.0 / (double) MetricType::Power) / 2.0;
     else
-      return sum / pow(2.0, MetricType::Power);
+      return sum / math::IntPower<MetricType::Power>((ElemType) 2);
   }
 }
 
@@ -319,13 +334,7 @@ inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
     ElemType v = std::max(fabs(point[d] - bounds[d].Lo()),
         fabs(bounds[d].Hi() - point[d]));
 
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-      sum += v; // v is non-negative.
-    else if (MetricType::Power == 2)
-      sum += v * v;
-    else
-      sum += std::pow(v, (ElemType) MetricType::Power);
+    sum += math::IntPower<MetricType::Power>(v);
   }
 
   // The compiler should optimize out this if statement entirely.
@@ -360,13 +369,7 @@ inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
     v = std::max(fabs(other.bounds[d].Hi() - bounds[d].Lo()),
         fabs(bounds[d].Hi() - other.bounds[d].Lo()));
 
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-      sum += v; // v is non-negative.
-    else if (MetricType::Power == 2)
-      sum += v * v;
-    else
-      sum += std::pow(v, (ElemType) MetricType::Power);
+    sum += math::IntPower<MetricType::Power>(v);
   }
 
   // The compiler should optimize out this if statement entirely.
@@ -401,34 +404,13 @@ HRectBound<MetricType, ElemType>::RangeDistance(
   {
     v1 = other.bounds[d].Lo() - bounds[d].Hi();
     v2 = bounds[d].Lo() - other.bounds[d].Hi();
-    // One of v1 or v2 is negative.
-    if (v1 >= v2)
-    {
-      vHi = -v2; // Make it nonnegative.
-      vLo = (v1 > 0) ? v1 : 0; // Force to be 0 if negative.
-    }
-    else
-    {
-      vHi = -v1; // Make it nonnegative.
-      vLo = (v2 > 0) ? v2 : 0; // Force to be 0 if negative.
-    }
+    // One of v1 or v2 is negative; the other one (if it is positive) is
+    // the gap between the bounds.  This is branch-free.
+    vLo = std::max(std::max(v1, v2), (ElemType) 0);
+    vHi = -std::min(v1, v2); // Make it nonnegative.
 
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-    {
-      loSum += vLo; // vLo is non-negative.
-      hiSum += vHi; // vHi is non-negative.
-    }
-    else if (MetricType::Power == 2)
-    {
-      loSum += vLo * vLo;
-      hiSum += vHi * vHi;
-    }
-    else
-    {
-      loSum += std::pow(vLo, (ElemType) MetricType::Power);
-      hiSum += std::pow(vHi, (ElemType) MetricType::Power);
-    }
+    loSum += math::IntPower<MetricType::Power>(vLo);
+    hiSum += math::IntPower<MetricType::Power>(vHi);
   }
 
   if (MetricType::TakeRoot)
@@ -469,42 +451,13 @@ HRectBound<MetricType, ElemType>::RangeDistance(
   {
     v1 = bounds[d].Lo() - point[d]; // Negative if point[d] > lo.
     v2 = point[d] - bounds[d].Hi(); // Negative if point[d] < hi.
-    // One of v1 or v2 (or both) is negative.
-    if (v1 >= 0) // point[d] <= bounds_[d].Lo().
-    {
-      vHi = -v2; // v2 will be larger but must be negated.
-      vLo = v1;
-    }
-    else // point[d] is between lo and hi, or greater than hi.
-    {
-      if (v2 >= 0)
-      {
-        vHi = -v1; // v1 will be larger, but must be negated.
-        vLo = v2;
-      }
-      else
-      {
-        vHi = -std::min(v1, v2); // Both are negative, but we need the larger.
-        vLo = 0;
-      }
-    }
+    // One of v1 or v2 (or both) is negative; the other one (if it is
+    // positive) is the distance to the bound.  This is branch-free.
+    vLo = std::max(std::max(v1, v2), (ElemType) 0);
+    vHi = -std::min(v1, v2); // Make it nonnegative.
 
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-    {
-      loSum += vLo; // vLo is non-negative.
-      hiSum += vHi; // vHi is non-negative.
-    }
-    else if (MetricType::Power == 2)
-    {
-      loSum += vLo * vLo;
-      hiSum += vHi * vHi;
-    }
-    else
-    {
-      loSum += std::pow(vLo, (ElemType) MetricType::Power);
-      hiSum += std::pow(vHi, (ElemType) MetricType::Power);
-    }
+    loSum += math::IntPower<MetricType::Power>(vLo);
+    hiSum += math::IntPower<MetricType::Power>(vHi);
   }
 
   if (MetricType::TakeRoot)
@@ -670,8 +623,7 @@ inline ElemType HRectBound<MetricType, ElemType>::Diameter() const
 {
   ElemType d = 0;
   for (size_t i = 0; i < dim; ++i)
-    d += std::pow(bounds[i].Hi() - bounds[i].Lo(),
-        (ElemType) MetricType::Power);
+    d += math::IntPower<MetricType::Power>(bounds[i].Hi() - bounds[i].Lo());
 
   if (MetricType::TakeRoot)
     return (ElemType) std::pow((double) d, 1.0 / (double) MetricType::Power);
@@ -686,8 +638,27 @@ void HRectBound<MetricType, ElemType>::serialize(
     Archive& ar,
     const uint32_t /* version */)
 {
-  // We can't serialize a raw array directly, so wrap it.
-  ar(CEREAL_POINTER_ARRAY(bounds, dim));
+  // We can't serialize a raw array directly, so wrap it.  When loading, the
+  // wrapper allocates the array, and low-dimensional ranges are then moved
+  // into the bound itself.
+  if (cereal::is_loading<Archive>())
+  {
+    Release();
+    ar(CEREAL_POINTER_ARRAY(bounds, dim));
+    if (dim <= inlineDims && bounds != NULL)
+    {
+      math::RangeType<ElemType>* loaded = bounds;
+      const size_t loadedDim = dim;
+      Allocate(loadedDim);
+      for (size_t i = 0; i < dim; ++i)
+        bounds[i] = loaded[i];
+      delete[] loaded;
+    }
+  }
+  else
+  {
+    ar(CEREAL_POINTER_ARRAY(bounds, dim));
+  }
   ar(CEREAL_NVP(minWidth));
   ar(CEREAL_NVP(metric));
 }
@@ -0,0 +1,80 @@
+/**
+ * @file core/tree/leaf_base_cases.hpp
+ *
+ * A utility function for traversers that runs the base cases between a query
+ * point and a contiguous range of reference points, letting the RuleType
+ * handle the whole range at once if it can.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_LEAF_BASE_CASES_HPP
+#define MLPACK_CORE_TREE_LEAF_BASE_CASES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+namespace tree {
+
+HAS_MEM_FUNC(BaseCaseBlock, HasBaseCaseBlockCheck);
+
+//! Whether or not the given RuleType has a BaseCaseBlock() method.
+template<typename RuleType>
+struct HasBaseCaseBlock
+{
+  static const bool value = HasBaseCaseBlockCheck<RuleType,
+      void(RuleType::*)(const size_t, const size_t, const size_t)>::value;
+};
+
+/**
+ * Run the base cases between the given query point and the reference points
+ * [referenceBegin, referenceBegin + count).  If the RuleType has a method
+ * BaseCaseBlock(queryIndex, referenceBegin, count), it is used, so that the
+ * distances to all of the points in a leaf can be computed in one go.
+ *
+ * @param rule Rules to run the base cases with.
+ * @param queryIndex Index of the query point.
+ * @param referenceBegin Index of the first reference point.
+ * @param count Number of reference points.
+ */
+template<typename RuleType>
+inline void LeafBaseCases(
+    RuleType& rule,
+    const size_t queryIndex,
+    const size_t referenceBegin,
+    const size_t count,
+    const typename std::enable_if_t<HasBaseCaseBlock<RuleType>::value>* = 0)
+{
+  rule.BaseCaseBlock(queryIndex, referenceBegin, count);
+}
+
+/**
+ * Run the base cases between the given query point and the reference points
+ * [referenceBegin, referenceBegin + count) one at a time, for RuleTypes that
+ * do not have a BaseCaseBlock() method.
+ *
+ * @param rule Rules to run the base cases with.
+ * @param queryIndex Index of the query point.
+ * @param referenceBegin Index of the first reference point.
+ * @param count Number of reference points.
+ */
+template<typename RuleType>
+inline void LeafBaseCases(
+    RuleType& rule,
+    const size_t queryIndex,
+    const size_t referenceBegin,
+    const size_t count,
+    const typename std::enable_if_t<!HasBaseCaseBlock<RuleType>::value>* = 0)
+{
+  const size_t referenceEnd = referenceBegin + count;
+  for (size_t i = referenceBegin; i < referenceEnd; ++i)
+    rule.BaseCase(queryIndex, i);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,135 @@
+/**
+ * @file core/tree/node_arena.hpp
+ *
+ * An arena that holds the memory of the nodes of a tree in a few large slabs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_NODE_ARENA_HPP
+#define MLPACK_CORE_TREE_NODE_ARENA_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mutex>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A NodeArena provides the memory for the nodes of a tree from a few large
+ * slabs, so that building a tree does not allocate every node separately, the
+ * nodes built one after another are next to each other in memory, and all the
+ * memory is freed at once with the arena.
+ *
+ * The arena only provides memory: nodes are constructed in it with placement
+ * new, and the tree must still call their destructors (so that the memory held
+ * by their bounds and statistics is freed), but not delete them.  The slabs
+ * grow geometrically up to a maximum number of nodes, so that small trees do not
+ * waste memory.  Allocate() may be called from several threads at once, as when
+ * the subtrees of a tree are built in parallel.
+ *
+ * @tparam NodeType Type of the nodes held in the arena.
+ */
+template<typename NodeType>
+class NodeArena
+{
+ public:
+  /**
+   * Create an empty arena; no memory is allocated until the first node.
+   *
+   * @param minSlabSize Number of nodes in the first slab.
+   * @param maxSlabSize Maximum number of nodes in each slab.
+   */
+  NodeArena(const size_t minSlabSize = 16, const size_t maxSlabSize = 4096) :
+      slabUsed(0),
+      slabCapacity(0),
+      nextSlabSize(minSlabSize),
+      maxSlabSize(maxSlabSize),
+      size(0)
+  {
+    // Nothing to do.
+  }
+
+  //! The nodes of an arena cannot be copied without their tree.
+  NodeArena(const NodeArena& other) = delete;
+  //! The nodes of an arena cannot be copied without their tree.
+  NodeArena& operator=(const NodeArena& other) = delete;
+
+  /**
+   * Free all the memory of the arena.  The destructors of the nodes must have
+   * been called already.
+   */
+  ~NodeArena()
+  {
+    for (size_t i = 0; i < slabs.size(); ++i)
+      ::operator delete(slabs[i]);
+  }
+
+  /**
+   * Return uninitialized memory for one node, to be constructed with placement
+   * new.
+   */
+  void* Allocate()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (slabUsed == slabCapacity)
+    {
+      NewSlab(nextSlabSize);
+      nextSlabSize = std::min(2 * nextSlabSize, maxSlabSize);
+    }
+
+    ++size;
+    return slabs.back() + slabUsed++;
+  }
+
+  /**
+   * Make sure that the next n nodes are allocated contiguously, in a single
+   * slab.
+   *
+   * @param n Number of nodes to reserve.
+   */
+  void Reserve(const size_t n)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (slabCapacity - slabUsed < n)
+      NewSlab(std::max(n, nextSlabSize));
+  }
+
+  //! Get the number of nodes allocated from the arena.
+  size_t Size() const { return size; }
+  //! Get the number of slabs allocated by the arena.
+  size_t NumSlabs() const { return slabs.size(); }
+
+ private:
+  //! Allocate a new slab with room for the given number of nodes, and use it
+  //! for the next nodes.
+  void NewSlab(const size_t nodes)
+  {
+    slabs.push_back(static_cast<NodeType*>(
+        ::operator new(sizeof(NodeType) * nodes)));
+    slabUsed = 0;
+    slabCapacity = nodes;
+  }
+
+  //! The slabs of memory; nodes are allocated from the last one.
+  std::vector<NodeType*> slabs;
+  //! The number of nodes allocated from the last slab.
+  size_t slabUsed;
+  //! The number of nodes the last slab can hold.
+  size_t slabCapacity;
+  //! The number of nodes of the next slab.
+  size_t nextSlabSize;
+  //! The maximum number of nodes of a slab.
+  size_t maxSlabSize;
+  //! The number of nodes allocated from the arena.
+  size_t size;
+  //! The lock that protects the slabs when nodes are allocated in parallel.
+  std::mutex mutex;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
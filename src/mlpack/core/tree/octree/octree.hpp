@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include "../hrectbound.hpp"
+#include "../node_arena.hpp"
 #include "../statistic.hpp"
 
 namespace mlpack {
@@ -63,6 +64,10 @@ class Octree
   ElemType furthestDescendantDistance;
   //! An instantiated metric.
   MetricType metric;
+  //! The arena that holds the memory of the children of this node, or NULL if
+  //! the children are allocated separately (as in copied and loaded trees).  It
+  //! is shared by all the nodes of a tree, and owned by the root.
+  NodeArena<Octree>* arena;
 
  public:
   /**
@@ -173,7 +178,7 @@ class Octree
   Octree(Octree* parent,
          const size_t begin,
          const size_t count,
-         const arma::vec& center,
+         const arma::Col<ElemType>& center,
          const double width,
          const size_t maxLeafSize = 20);
 
@@ -201,7 +206,7 @@ class Octree
          const size_t begin,
          const size_t count,
          std::vector<size_t>& oldFromNew,
-         const arma::vec& center,
+         const arma::Col<ElemType>& center,
          const double width,
          const size_t maxLeafSize = 20);
 
@@ -394,7 +399,7 @@ class Octree
       typename std::enable_if_t<IsVector<VecType>::value>* = 0) const;
 
   //! Store the center of the bounding region in the given vector.
-  void Center(arma::vec& center) const { bound.Center(center); }
+  void Center(arma::Col<ElemType>& center) const { bound.Center(center); }
 
   //! Serialize the tree.
   template<typename Archive>
@@ -421,7 +426,7 @@ class Octree
    * @param width Width of the current node.
    * @param maxLeafSize Maximum number of points allowed in a leaf.
    */
-  void SplitNode(const arma::vec& center,
+  void SplitNode(const arma::Col<ElemType>& center,
                  const double width,
                  const size_t maxLeafSize);
 
@@ -434,11 +439,25 @@ class Octree
    * @param oldFromNew Mappings from old to new.
    * @param maxLeafSize Maximum number of points allowed in a leaf.
    */
-  void SplitNode(const arma::vec& center,
+  void SplitNode(const arma::Col<ElemType>& center,
                  const double width,
                  std::vector<size_t>& oldFromNew,
                  const size_t maxLeafSize);
 
+  /**
+   * Create a child of this node with the given arguments of the child
+   * constructor (after the parent), in the arena of the tree if there is one.
+   */
+  template<typename... Args>
+  Octree* NewChild(Args&&... args);
+
+  /**
+   * Delete the children of this node, whether they are individually allocated
+   * or held in the arena of the tree.  If this node is the root, the arena is
+   * freed too.
+   */
+  void DeleteChildren();
+
   /**
    * This is used for sorting points while splitting.
    */
@@ -452,7 +471,7 @@ class Octree
       //! The dimension we are splitting on.
       size_t d;
       //! The center of the node.
-      const arma::vec& center;
+      const arma::Col<ElemType>& center;
     };
 
     template<typename VecType>
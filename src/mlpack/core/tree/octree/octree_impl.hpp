@@ -28,13 +28,14 @@ Octree<MetricType, StatisticType, MatType>::Octree(const MatType& dataset,
     bound(dataset.n_rows),
     dataset(new MatType(dataset)),
     parent(NULL),
-    parentDistance(0.0)
+    parentDistance(0.0),
+    arena(new NodeArena<Octree>())
 {
   if (count > 0)
   {
     // Calculate empirical center of data.
     bound |= *this->dataset;
-    arma::vec center;
+    arma::Col<ElemType> center;
     bound.Center(center);
 
     double maxWidth = 0.0;
@@ -66,7 +67,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(
     bound(dataset.n_rows),
     dataset(new MatType(dataset)),
     parent(NULL),
-    parentDistance(0.0)
+    parentDistance(0.0),
+    arena(new NodeArena<Octree>())
 {
   oldFromNew.resize(this->dataset->n_cols);
   for (size_t i = 0; i < this->dataset->n_cols; ++i)
@@ -76,7 +78,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
   {
     // Calculate empirical center of data.
     bound |= *this->dataset;
-    arma::vec center;
+    arma::Col<ElemType> center;
     bound.Center(center);
 
     double maxWidth = 0.0;
@@ -109,7 +111,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(
     bound(dataset.n_rows),
     dataset(new MatType(dataset)),
     parent(NULL),
-    parentDistance(0.0)
+    parentDistance(0.0),
+    arena(new NodeArena<Octree>())
 {
   oldFromNew.resize(this->dataset->n_cols);
   for (size_t i = 0; i < this->dataset->n_cols; ++i)
@@ -119,7 +122,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
   {
     // Calculate empirical center of data.
     bound |= *this->dataset;
-    arma::vec center;
+    arma::Col<ElemType> center;
     bound.Center(center);
 
     double maxWidth = 0.0;
@@ -154,13 +157,14 @@ Octree<MetricType, StatisticType, MatType>::Octree(MatType&& dataset,
     bound(dataset.n_rows),
     dataset(new MatType(std::move(dataset))),
     parent(NULL),
-    parentDistance(0.0)
+    parentDistance(0.0),
+    arena(new NodeArena<Octree>())
 {
   if (count > 0)
   {
     // Calculate empirical center of data.
     bound |= *this->dataset;
-    arma::vec center;
+    arma::Col<ElemType> center;
     bound.Center(center);
 
     double maxWidth = 0.0;
@@ -192,7 +196,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(
     bound(dataset.n_rows),
     dataset(new MatType(std::move(dataset))),
     parent(NULL),
-    parentDistance(0.0)
+    parentDistance(0.0),
+    arena(new NodeArena<Octree>())
 {
   oldFromNew.resize(this->dataset->n_cols);
   for (size_t i = 0; i < this->dataset->n_cols; ++i)
@@ -202,7 +207,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
   {
     // Calculate empirical center of data.
     bound |= *this->dataset;
-    arma::vec center;
+    arma::Col<ElemType> center;
     bound.Center(center);
 
     double maxWidth = 0.0;
@@ -235,7 +240,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(
     bound(dataset.n_rows),
     dataset(new MatType(std::move(dataset))),
     parent(NULL),
-    parentDistance(0.0)
+    parentDistance(0.0),
+    arena(new NodeArena<Octree>())
 {
   oldFromNew.resize(this->dataset->n_cols);
   for (size_t i = 0; i < this->dataset->n_cols; ++i)
@@ -245,7 +251,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
   {
     // Calculate empirical center of data.
     bound |= *this->dataset;
-    arma::vec center;
+    arma::Col<ElemType> center;
     bound.Center(center);
 
     double maxWidth = 0.0;
@@ -277,14 +283,15 @@ Octree<MetricType, StatisticType, MatType>::Octree(
     Octree* parent,
     const size_t begin,
     const size_t count,
-    const arma::vec& center,
+    const arma::Col<ElemType>& center,
     const double width,
     const size_t maxLeafSize) :
     begin(begin),
     count(count),
     bound(parent->dataset->n_rows),
     dataset(parent->dataset),
-    parent(parent)
+    parent(parent),
+    arena(parent->arena)
 {
   // Calculate empirical center of data.
   bound |= dataset->cols(begin, begin + count - 1);
@@ -294,7 +301,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
 
   // Calculate the distance from the empirical center of this node to the
   // empirical center of the parent.
-  arma::vec trueCenter, parentCenter;
+  arma::Col<ElemType> trueCenter, parentCenter;
   bound.Center(trueCenter);
   parent->Bound().Center(parentCenter);
   parentDistance = metric.Evaluate(trueCenter, parentCenter);
@@ -312,14 +319,15 @@ Octree<MetricType, StatisticType, MatType>::Octree(
     const size_t begin,
     const size_t count,
     std::vector<size_t>& oldFromNew,
-    const arma::vec& center,
+    const arma::Col<ElemType>& center,
     const double width,
     const size_t maxLeafSize) :
     begin(begin),
     count(count),
     bound(parent->dataset->n_rows),
     dataset(parent->dataset),
-    parent(parent)
+    parent(parent),
+    arena(parent->arena)
 {
   // Calculate empirical center of data.
   bound |= dataset->cols(begin, begin + count - 1);
@@ -329,7 +337,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
 
   // Calculate the distance from the empirical center of this node to the
   // empirical center of the parent.
-  arma::vec trueCenter, parentCenter;
+  arma::Col<ElemType> trueCenter, parentCenter;
   bound.Center(trueCenter);
   parent->Bound().Center(parentCenter);
   parentDistance = metric.Evaluate(trueCenter, parentCenter);
@@ -351,7 +359,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(const Octree& other) :
     stat(other.stat),
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
-    metric(other.metric)
+    metric(other.metric),
+    arena(NULL)
 {
   // If we have any children, we need to create them, and then ensure that their
   // parent links are set right.
@@ -375,10 +384,10 @@ operator=(const Octree& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  for (size_t i = 0; i < children.size(); ++i)
-    delete children[i];
-  children.clear();
+  DeleteChildren();
 
+  // The copied children are allocated separately.
+  arena = NULL;
   begin = other.Begin();
   count = other.Count();
   bound = other.bound;
@@ -412,7 +421,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(Octree&& other) :
     stat(std::move(other.stat)),
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
-    metric(std::move(other.metric))
+    metric(std::move(other.metric)),
+    arena(other.arena)
 {
   // Update the parent pointers of the direct children.
   for (size_t i = 0; i < children.size(); ++i)
@@ -424,6 +434,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(Octree&& other) :
   other.parentDistance = 0.0;
   other.furthestDescendantDistance = 0.0;
   other.parent = NULL;
+  other.arena = NULL;
 }
 
 //! Move assignment operator: take ownership of the given tree.
@@ -438,9 +449,7 @@ operator=(Octree&& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  for (size_t i = 0; i < children.size(); ++i)
-    delete children[i];
-  children.clear();
+  DeleteChildren();
 
   children = std::move(other.children);
   begin = other.Begin();
@@ -450,8 +459,9 @@ operator=(Octree&& other)
   parent = other.Parent();
   stat = std::move(other.stat);
   parentDistance = other.ParentDistance();
-  furthestDescendantDistance = other.furthestDescendantDistance();
+  furthestDescendantDistance = other.FurthestDescendantDistance();
   metric = std::move(other.metric);
+  arena = other.arena;
 
   // Update the parent pointers of the direct children.
   for (size_t i = 0; i < children.size(); ++i)
@@ -461,9 +471,9 @@ operator=(Octree&& other)
   other.count = 0;
   other.dataset = new MatType();
   other.parentDistance = 0.0;
-  other.numDescendants = 0;
   other.furthestDescendantDistance = 0.0;
   other.parent = NULL;
+  other.arena = NULL;
 
   return *this;
 }
@@ -476,7 +486,8 @@ Octree<MetricType, StatisticType, MatType>::Octree() :
     dataset(new MatType()),
     parent(NULL),
     parentDistance(0.0),
-    furthestDescendantDistance(0.0)
+    furthestDescendantDistance(0.0),
+    arena(NULL)
 {
   // Nothing to do.
 }
@@ -500,9 +511,7 @@ Octree<MetricType, StatisticType, MatType>::~Octree()
     delete dataset;
 
   // Now delete each of the children.
-  for (size_t i = 0; i < children.size(); ++i)
-    delete children[i];
-  children.clear();
+  DeleteChildren();
 }
 
 template<typename MetricType, typename StatisticType, typename MatType>
@@ -715,14 +724,14 @@ void Octree<MetricType, StatisticType, MatType>::serialize(
   // If we're loading and we have children, they need to be deleted.
   if (cereal::is_loading<Archive>())
   {
-    for (size_t i = 0; i < children.size(); ++i)
-      delete children[i];
-    children.clear();
+    DeleteChildren();
 
     if (!parent)
       delete dataset;
 
+    // The loaded children are allocated separately.
     parent = NULL;
+    arena = NULL;
   }
 
   bool hasParent = (parent != NULL);
@@ -773,7 +782,7 @@ void Octree<MetricType, StatisticType, MatType>::serialize(
 //! Split the node.
 template<typename MetricType, typename StatisticType, typename MatType>
 void Octree<MetricType, StatisticType, MatType>::SplitNode(
-    const arma::vec& center,
+    const arma::Col<ElemType>& center,
     const double width,
     const size_t maxLeafSize)
 {
@@ -847,7 +856,7 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
   }
 
   // Now that the dataset is reordered, we can create the children.
-  arma::vec childCenter(center.n_elem);
+  arma::Col<ElemType> childCenter(center.n_elem);
   const double childWidth = width / 2.0;
   for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
   {
@@ -865,7 +874,7 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
         childCenter[d] = center[d] + childWidth;
     }
 
-    children.push_back(new Octree(this, childBegins[i],
+    children.push_back(NewChild(childBegins[i],
         childBegins[i + 1] - childBegins[i], childCenter, childWidth,
         maxLeafSize));
   }
@@ -874,7 +883,7 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
 //! Split the node, and store mappings.
 template<typename MetricType, typename StatisticType, typename MatType>
 void Octree<MetricType, StatisticType, MatType>::SplitNode(
-    const arma::vec& center,
+    const arma::Col<ElemType>& center,
     const double width,
     std::vector<size_t>& oldFromNew,
     const size_t maxLeafSize)
@@ -949,7 +958,7 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
   }
 
   // Now that the dataset is reordered, we can create the children.
-  arma::vec childCenter(center.n_elem);
+  arma::Col<ElemType> childCenter(center.n_elem);
   const double childWidth = width / 2.0;
   for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
   {
@@ -967,12 +976,47 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
         childCenter[d] = center[d] + childWidth;
     }
 
-    children.push_back(new Octree(this, childBegins[i],
+    children.push_back(NewChild(childBegins[i],
         childBegins[i + 1] - childBegins[i], oldFromNew, childCenter,
         childWidth, maxLeafSize));
   }
 }
 
+//! Create a child of this node.
+template<typename MetricType, typename StatisticType, typename MatType>
+template<typename... Args>
+Octree<MetricType, StatisticType, MatType>*
+Octree<MetricType, StatisticType, MatType>::NewChild(Args&&... args)
+{
+  // The children of a node are allocated in the same way as the node itself.
+  if (arena)
+    return new (arena->Allocate()) Octree(this, std::forward<Args>(args)...);
+
+  return new Octree(this, std::forward<Args>(args)...);
+}
+
+//! Delete the children of this node.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::DeleteChildren()
+{
+  // The memory of children in an arena is only freed with the arena, by the
+  // root.
+  for (size_t i = 0; i < children.size(); ++i)
+  {
+    if (arena)
+      children[i]->~Octree();
+    else
+      delete children[i];
+  }
+  children.clear();
+
+  if (!parent)
+  {
+    delete arena;
+    arena = NULL;
+  }
+}
+
 } // namespace tree
 } // namespace mlpack
 
@@ -0,0 +1,109 @@
+/**
+ * @file core/tree/parallel_subtrees.hpp
+ *
+ * Utility functions that split a query tree into disjoint subtrees, so that
+ * several threads can each run a dual-tree traversal of some of the subtrees
+ * against the same reference tree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PARALLEL_SUBTREES_HPP
+#define MLPACK_CORE_TREE_PARALLEL_SUBTREES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "tree_traits.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Split the given tree into disjoint subtrees with at most grainSize
+ * descendants each (unless they are leaves, or hold points of their own), and
+ * return them in a fixed order.  Every point of the tree is a descendant of
+ * exactly one of the returned nodes.  Only the root is returned if the tree type
+ * has self-children or overlapping children (in which case subtrees share
+ * points).
+ *
+ * Unlike ParallelSubtrees(), the split does not depend on the number of
+ * threads, so it can be used when the results of a traversal must not depend on
+ * it either.
+ *
+ * @param root Root of the tree to split.
+ * @param grainSize Maximum number of descendants of a subtree that is split no
+ *     further.
+ * @return Roots of the subtrees.
+ */
+template<typename TreeType>
+std::vector<TreeType*> SplitSubtrees(TreeType& root, const size_t grainSize)
+{
+  std::vector<TreeType*> subtrees;
+  if (TreeTraits<TreeType>::HasSelfChildren ||
+      TreeTraits<TreeType>::HasOverlappingChildren)
+  {
+    subtrees.push_back(&root);
+    return subtrees;
+  }
+
+  std::vector<TreeType*> stack(1, &root);
+  while (!stack.empty())
+  {
+    TreeType* node = stack.back();
+    stack.pop_back();
+
+    // Nodes that hold points of their own are not split, so that those points
+    // are not lost.
+    if (node->IsLeaf() || node->NumPoints() > 0 ||
+        node->NumDescendants() <= grainSize)
+    {
+      subtrees.push_back(node);
+    }
+    else
+    {
+      for (size_t i = 0; i < node->NumChildren(); ++i)
+        stack.push_back(&node->Child(i));
+    }
+  }
+
+  return subtrees;
+}
+
+/**
+ * Split the given tree into disjoint subtrees for a parallel dual-tree
+ * traversal, and return them.  Every point of the tree is a descendant of
+ * exactly one of the returned nodes, so the subtrees can be traversed as query
+ * trees independently of each other.  Since small query nodes prune less, the
+ * subtrees are only as small as needed to give each thread several of them
+ * (and never smaller than minSize descendants, unless they are leaves).
+ *
+ * Only the root is returned if OpenMP is not available, if only one thread may
+ * be used, or if the tree type has self-children or overlapping children (in
+ * which case subtrees share points).
+ *
+ * @param root Root of the tree to split.
+ * @param minSize Minimum number of descendants of a subtree that is not a
+ *     leaf.
+ * @return Roots of the subtrees.
+ */
+template<typename TreeType>
+std::vector<TreeType*> ParallelSubtrees(TreeType& root,
+                                        const size_t minSize = 1000)
+{
+  size_t grainSize = root.NumDescendants();
+  #ifdef HAS_OPENMP
+  if (omp_get_max_threads() > 1)
+  {
+    grainSize = std::max(minSize, root.NumDescendants() /
+        (16 * omp_get_max_threads()));
+  }
+  #endif
+
+  return SplitSubtrees(root, grainSize);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -435,7 +435,7 @@ class SpillTree
   static bool HasSelfChildren() { return false; }
 
   //! Store the center of the bounding region in the given vector.
-  void Center(arma::vec& center) { bound.Center(center); }
+  void Center(arma::Col<ElemType>& center) { bound.Center(center); }
 
  private:
   /**
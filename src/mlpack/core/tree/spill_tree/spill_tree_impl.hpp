@@ -771,7 +771,7 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   right = new SpillTree(this, rightPoints, tau, maxLeafSize, rho);
 
   // Calculate parent distances for those two nodes.
-  arma::vec center, leftCenter, rightCenter;
+  arma::Col<ElemType> center, leftCenter, rightCenter;
   Center(center);
   left->Center(leftCenter);
   right->Center(rightCenter);
@@ -0,0 +1,240 @@
+/**
+ * @file core/tree/traversal_statistics.hpp
+ *
+ * This class holds counters that describe how a tree traversal went: how many
+ * nodes were scored and pruned for each query point and at each level of the
+ * reference tree, how many base cases were computed, and how much time was
+ * spent in Score() and BaseCase().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+#define MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The TraversalStatistics class collects counters during a traversal, to help
+ * understand how well the pruning rules work for a given dataset, tree type,
+ * and set of parameters.  A RuleType class that supports it holds a pointer to
+ * a TraversalStatistics object; when that pointer is NULL (the default),
+ * nothing is collected and the only cost is one branch per call.
+ *
+ * Counters are kept for each query point and for each level of the reference
+ * tree (the root is at level 0).  In dual-tree traversals, Score() is called
+ * with a query node, so those calls are only counted for the reference level;
+ * base cases are always counted for the query point.  The time spent in
+ * Score() includes the time of any base cases that Score() computes itself.
+ *
+ * The counters are not thread-safe; each thread must use its own object, and
+ * the objects can then be combined with Merge().
+ */
+class TraversalStatistics
+{
+ public:
+  //! Create an empty TraversalStatistics object.
+  TraversalStatistics() : baseCaseTime(0.0), scoreTime(0.0) { }
+
+  /**
+   * Reset all counters, and prepare to collect counters for the given number
+   * of query points.
+   *
+   * @param numQueries Number of query points.
+   */
+  void Reset(const size_t numQueries)
+  {
+    queryBaseCases.zeros(numQueries);
+    queryScores.zeros(numQueries);
+    queryPrunes.zeros(numQueries);
+    levelScores.reset();
+    levelPrunes.reset();
+    baseCaseTime = 0.0;
+    scoreTime = 0.0;
+  }
+
+  /**
+   * Record base cases for the given query point.
+   *
+   * @param queryIndex Index of the query point.
+   * @param count Number of base cases.
+   * @param seconds Time spent computing the base cases.
+   */
+  void AddBaseCases(const size_t queryIndex,
+                    const size_t count,
+                    const double seconds)
+  {
+    if (queryIndex < queryBaseCases.n_elem)
+      queryBaseCases[queryIndex] += count;
+    baseCaseTime += seconds;
+  }
+
+  /**
+   * Record a call to Score().
+   *
+   * @param queryIndex Index of the query point, or SIZE_MAX for a query node.
+   * @param level Level of the reference node.
+   * @param pruned Whether or not the reference node was pruned.
+   * @param seconds Time spent computing the score.
+   */
+  void AddScore(const size_t queryIndex,
+                const size_t level,
+                const bool pruned,
+                const double seconds)
+  {
+    if (queryIndex < queryScores.n_elem)
+    {
+      ++queryScores[queryIndex];
+      if (pruned)
+        ++queryPrunes[queryIndex];
+    }
+
+    GrowLevels(level);
+    ++levelScores[level];
+    if (pruned)
+      ++levelPrunes[level];
+    scoreTime += seconds;
+  }
+
+  /**
+   * Record a prune by Rescore() (which is not counted as a score).
+   *
+   * @param queryIndex Index of the query point, or SIZE_MAX for a query node.
+   * @param level Level of the reference node.
+   */
+  void AddPrune(const size_t queryIndex, const size_t level)
+  {
+    if (queryIndex < queryPrunes.n_elem)
+      ++queryPrunes[queryIndex];
+
+    GrowLevels(level);
+    ++levelPrunes[level];
+  }
+
+  /**
+   * Add the counters of the given object to this one.  The query points of the
+   * other object are taken to be the query points [queryOffset, queryOffset +
+   * n) of this object.
+   *
+   * @param other Object to add.
+   * @param queryOffset Index of the first query point of the other object.
+   */
+  void Merge(const TraversalStatistics& other, const size_t queryOffset = 0)
+  {
+    const size_t numQueries = other.queryBaseCases.n_elem;
+    if (numQueries > 0)
+    {
+      queryBaseCases.subvec(queryOffset, queryOffset + numQueries - 1) +=
+          other.queryBaseCases;
+      queryScores.subvec(queryOffset, queryOffset + numQueries - 1) +=
+          other.queryScores;
+      queryPrunes.subvec(queryOffset, queryOffset + numQueries - 1) +=
+          other.queryPrunes;
+    }
+
+    if (other.levelScores.n_elem > 0)
+    {
+      GrowLevels(other.levelScores.n_elem - 1);
+      levelScores.subvec(0, other.levelScores.n_elem - 1) +=
+          other.levelScores;
+      levelPrunes.subvec(0, other.levelPrunes.n_elem - 1) +=
+          other.levelPrunes;
+    }
+
+    baseCaseTime += other.baseCaseTime;
+    scoreTime += other.scoreTime;
+  }
+
+  /**
+   * Reorder the per-query counters, given the mapping from the new indices of
+   * the query points (i.e. in a query tree) to their original indices.
+   *
+   * @param oldFromNew Original index of each query point.
+   */
+  void MapQueries(const std::vector<size_t>& oldFromNew)
+  {
+    arma::Col<size_t> baseCases(queryBaseCases.n_elem);
+    arma::Col<size_t> scores(queryScores.n_elem);
+    arma::Col<size_t> prunes(queryPrunes.n_elem);
+    for (size_t i = 0; i < oldFromNew.size(); ++i)
+    {
+      baseCases[oldFromNew[i]] = queryBaseCases[i];
+      scores[oldFromNew[i]] = queryScores[i];
+      prunes[oldFromNew[i]] = queryPrunes[i];
+    }
+
+    queryBaseCases = std::move(baseCases);
+    queryScores = std::move(scores);
+    queryPrunes = std::move(prunes);
+  }
+
+  /**
+   * Return the level of the given node in its tree (the root is at level 0).
+   *
+   * @param node Node to compute the level of.
+   */
+  template<typename TreeType>
+  static size_t Level(const TreeType& node)
+  {
+    size_t level = 0;
+    for (const TreeType* n = node.Parent(); n != NULL; n = n->Parent())
+      ++level;
+    return level;
+  }
+
+  //! Get the number of base cases of each query point.
+  const arma::Col<size_t>& QueryBaseCases() const { return queryBaseCases; }
+  //! Get the number of scored reference nodes for each query point.
+  const arma::Col<size_t>& QueryScores() const { return queryScores; }
+  //! Get the number of pruned reference nodes for each query point.
+  const arma::Col<size_t>& QueryPrunes() const { return queryPrunes; }
+
+  //! Get the number of scored nodes at each level of the reference tree.
+  const arma::Col<size_t>& LevelScores() const { return levelScores; }
+  //! Get the number of pruned nodes at each level of the reference tree.
+  const arma::Col<size_t>& LevelPrunes() const { return levelPrunes; }
+
+  //! Get the total time (in seconds) spent computing base cases.
+  double BaseCaseTime() const { return baseCaseTime; }
+  //! Get the total time (in seconds) spent computing scores.
+  double ScoreTime() const { return scoreTime; }
+
+ private:
+  //! Make sure that the per-level counters hold the given level.
+  void GrowLevels(const size_t level)
+  {
+    if (level >= levelScores.n_elem)
+    {
+      // New elements are set to zero.
+      levelScores.resize(level + 1);
+      levelPrunes.resize(level + 1);
+    }
+  }
+
+  //! The number of base cases of each query point.
+  arma::Col<size_t> queryBaseCases;
+  //! The number of scored reference nodes for each query point.
+  arma::Col<size_t> queryScores;
+  //! The number of pruned reference nodes for each query point.
+  arma::Col<size_t> queryPrunes;
+
+  //! The number of scored nodes at each reference level.
+  arma::Col<size_t> levelScores;
+  //! The number of pruned nodes at each reference level.
+  arma::Col<size_t> levelPrunes;
+
+  //! The total time spent computing base cases.
+  double baseCaseTime;
+  //! The total time spent computing scores.
+  double scoreTime;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,201 @@
+/**
+ * @file core/tree/tree_tuner.hpp
+ *
+ * The TreeTuner class chooses the tree type and leaf size of a tree-based
+ * method by building candidate trees on a sample of the data and timing a
+ * sample of queries.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_TREE_TUNER_HPP
+#define MLPACK_CORE_TREE_TREE_TUNER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A configuration tried by TreeTuner: a tree type and a leaf size, with what
+ * was measured when the configuration was tried.
+ */
+struct TreeCandidate
+{
+  /**
+   * Create a candidate.
+   *
+   * @param treeType Type of tree, as a value of the TreeTypes enum of the
+   *     model.
+   * @param name Name of the tree type, for the report.
+   * @param leafSize Leaf size of the tree (0 if the tree type has none).
+   */
+  TreeCandidate(const size_t treeType = 0,
+                const std::string& name = "",
+                const size_t leafSize = 0) :
+      treeType(treeType),
+      name(name),
+      leafSize(leafSize),
+      buildTime(0.0),
+      searchTime(0.0),
+      baseCases(0),
+      scores(0),
+      cost(0.0)
+  {
+    // Nothing to do.
+  }
+
+  //! The type of tree, as a value of the TreeTypes enum of the model.
+  size_t treeType;
+  //! The name of the tree type.
+  std::string name;
+  //! The leaf size of the tree (0 if the tree type has none).
+  size_t leafSize;
+  //! The time taken to build the tree on the reference sample, in seconds.
+  double buildTime;
+  //! The time taken to answer the query sample, in seconds.
+  double searchTime;
+  //! The number of base cases computed for the query sample.
+  size_t baseCases;
+  //! The number of node combinations scored for the query sample.
+  size_t scores;
+  //! The estimated time to build the tree and answer all the queries on the
+  //! full dataset, in seconds.
+  double cost;
+};
+
+/**
+ * The TreeTuner class chooses between candidate configurations (tree type and
+ * leaf size) of a tree-based method such as neighbor search, range search, or
+ * kernel density estimation.  Each candidate is tried on a sample of the
+ * data: its tree is built on a sample of the reference set, and then a sample
+ * of the queries is answered, while the wall time of both steps and the number
+ * of base cases and scores are measured.  The measurements are extrapolated to
+ * the full dataset with a simple cost model:
+ *
+ *  - building a tree on N points is assumed to cost O(N log N);
+ *  - if a fraction f of the reference sample was compared to each query (as
+ *    given by the base cases), the pruned part of the search of each query is
+ *    assumed to grow as O(log N), and the unpruned part as O(N).
+ *
+ * The candidate with the lowest estimated total cost (build and search) is
+ * chosen, and all measurements are reported with Log::Info.  The models that
+ * support tuning (NSModel, RSModel, KDEModel) provide a Tune() method, which
+ * the bindings call when `tree_type` is `auto`.
+ *
+ * For instance, to tune a range search model before building it:
+ *
+ * @code
+ * RSModel model;
+ * model.Tune(timers, referenceSet, querySet, range, false, false);
+ * model.BuildModel(timers, std::move(referenceSet), model.LeafSize(), false,
+ *     false);
+ * @endcode
+ */
+class TreeTuner
+{
+ public:
+  /**
+   * Create the tuner.
+   *
+   * @param referenceSamples Number of reference points the candidate trees are
+   *     built on.
+   * @param querySamples Number of queries answered with each candidate.
+   * @param leafSizes Leaf sizes tried for the tree types that take one.
+   */
+  TreeTuner(const size_t referenceSamples = 2000,
+            const size_t querySamples = 200,
+            const std::vector<size_t>& leafSizes = { 10, 20, 40 });
+
+  //! Get the number of reference points the candidate trees are built on.
+  size_t ReferenceSamples() const { return referenceSamples; }
+  //! Modify the number of reference points the candidate trees are built on.
+  size_t& ReferenceSamples() { return referenceSamples; }
+
+  //! Get the number of queries answered with each candidate.
+  size_t QuerySamples() const { return querySamples; }
+  //! Modify the number of queries answered with each candidate.
+  size_t& QuerySamples() { return querySamples; }
+
+  //! Get the leaf sizes tried for the tree types that take one.
+  const std::vector<size_t>& LeafSizes() const { return leafSizes; }
+  //! Modify the leaf sizes tried for the tree types that take one.
+  std::vector<size_t>& LeafSizes() { return leafSizes; }
+
+  /**
+   * Add the candidates of the given tree type: one for each leaf size of the
+   * tuner if the tree type takes a leaf size, or a single one otherwise.
+   *
+   * @param candidates Candidates to add to.
+   * @param treeType Type of tree, as a value of the TreeTypes enum of the
+   *     model.
+   * @param name Name of the tree type.
+   * @param hasLeafSize Whether the tree type takes a leaf size.
+   */
+  void AddCandidates(std::vector<TreeCandidate>& candidates,
+                     const size_t treeType,
+                     const std::string& name,
+                     const bool hasLeafSize) const;
+
+  /**
+   * Try each candidate, and return the index of the one with the lowest
+   * estimated cost.  The measurements and the estimated cost are stored in
+   * each candidate.
+   *
+   * The build function is called as build(candidate, referenceSample), and
+   * must build the tree of the candidate on the given sample, which it may
+   * take possession of.  The search function is then called as
+   * search(querySample, timers), and must answer the given queries with that
+   * tree; it should count the base cases and scores of the search in the
+   * given timers, as "base_cases" and "scores".
+   *
+   * @param referenceSet Reference set the model will be built on.
+   * @param querySet Queries the model will answer; if empty, the queries are
+   *     the points of the reference set.
+   * @param candidates Candidates to try; must not be empty.
+   * @param build Function that builds the tree of a candidate.
+   * @param search Function that answers queries with the last built tree.
+   */
+  template<typename MatType, typename BuildFunctionType,
+           typename SearchFunctionType>
+  size_t Tune(const MatType& referenceSet,
+              const MatType& querySet,
+              std::vector<TreeCandidate>& candidates,
+              BuildFunctionType build,
+              SearchFunctionType search) const;
+
+  /**
+   * Estimate the time taken by a candidate to build its tree on the full
+   * reference set and answer all the queries, from the measurements made on
+   * the samples.
+   *
+   * @param candidate Candidate that was tried.
+   * @param referenceSamples Number of points of the reference sample.
+   * @param querySamples Number of points of the query sample.
+   * @param referencePoints Number of points of the full reference set.
+   * @param queryPoints Number of queries to answer.
+   */
+  static double EstimateCost(const TreeCandidate& candidate,
+                             const size_t referenceSamples,
+                             const size_t querySamples,
+                             const size_t referencePoints,
+                             const size_t queryPoints);
+
+ private:
+  //! The number of reference points the candidate trees are built on.
+  size_t referenceSamples;
+  //! The number of queries answered with each candidate.
+  size_t querySamples;
+  //! The leaf sizes tried for the tree types that take one.
+  std::vector<size_t> leafSizes;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "tree_tuner_impl.hpp"
+
+#endif
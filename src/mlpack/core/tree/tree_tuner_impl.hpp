@@ -0,0 +1,188 @@
+/**
+ * @file core/tree/tree_tuner_impl.hpp
+ *
+ * Implementation of the TreeTuner class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_TREE_TUNER_IMPL_HPP
+#define MLPACK_CORE_TREE_TREE_TUNER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "tree_tuner.hpp"
+
+namespace mlpack {
+namespace tree {
+
+inline TreeTuner::TreeTuner(const size_t referenceSamples,
+                            const size_t querySamples,
+                            const std::vector<size_t>& leafSizes) :
+    referenceSamples(referenceSamples),
+    querySamples(querySamples),
+    leafSizes(leafSizes)
+{
+  if (referenceSamples < 2)
+  {
+    throw std::invalid_argument("TreeTuner::TreeTuner(): at least 2 reference "
+        "points must be sampled!");
+  }
+
+  if (querySamples == 0)
+  {
+    throw std::invalid_argument("TreeTuner::TreeTuner(): at least 1 query must "
+        "be sampled!");
+  }
+}
+
+inline void TreeTuner::AddCandidates(std::vector<TreeCandidate>& candidates,
+                                     const size_t treeType,
+                                     const std::string& name,
+                                     const bool hasLeafSize) const
+{
+  if (!hasLeafSize || leafSizes.empty())
+  {
+    candidates.push_back(TreeCandidate(treeType, name));
+    return;
+  }
+
+  for (size_t i = 0; i < leafSizes.size(); ++i)
+    candidates.push_back(TreeCandidate(treeType, name, leafSizes[i]));
+}
+
+template<typename MatType, typename BuildFunctionType,
+         typename SearchFunctionType>
+size_t TreeTuner::Tune(const MatType& referenceSet,
+                       const MatType& querySet,
+                       std::vector<TreeCandidate>& candidates,
+                       BuildFunctionType build,
+                       SearchFunctionType search) const
+{
+  if (candidates.empty())
+    throw std::invalid_argument("TreeTuner::Tune(): no candidates to try!");
+
+  if (referenceSet.n_cols == 0)
+    throw std::invalid_argument("TreeTuner::Tune(): empty reference set!");
+
+  const bool monochromatic = (querySet.n_cols == 0);
+  const size_t referencePoints = referenceSet.n_cols;
+  const size_t queryPoints = monochromatic ? referencePoints : querySet.n_cols;
+
+  // Sample the reference set and the queries.  The sampled points keep their
+  // order, so that the samples have the same layout as the full sets.
+  MatType referenceSample;
+  if (referencePoints <= referenceSamples)
+  {
+    referenceSample = referenceSet;
+  }
+  else
+  {
+    referenceSample = referenceSet.cols(arma::sort(arma::randperm(
+        referencePoints, referenceSamples)));
+  }
+
+  const MatType& queryPool = monochromatic ? referenceSample : querySet;
+  MatType querySample;
+  if (queryPool.n_cols <= querySamples)
+  {
+    querySample = queryPool;
+  }
+  else
+  {
+    querySample = queryPool.cols(arma::sort(arma::randperm(queryPool.n_cols,
+        querySamples)));
+  }
+
+  Log::Info << "Trying " << candidates.size() << " tree configurations on "
+      << referenceSample.n_cols << " reference points and "
+      << querySample.n_cols << " queries..." << std::endl;
+
+  size_t best = 0;
+  for (size_t i = 0; i < candidates.size(); ++i)
+  {
+    TreeCandidate& candidate = candidates[i];
+
+    // Each candidate takes possession of its own copy of the samples.
+    MatType references(referenceSample);
+    MatType queries(querySample);
+
+    const std::chrono::high_resolution_clock::time_point buildStart =
+        std::chrono::high_resolution_clock::now();
+    build(candidate, std::move(references));
+    const std::chrono::high_resolution_clock::time_point searchStart =
+        std::chrono::high_resolution_clock::now();
+
+    // The counters of the search are only kept by enabled timers.
+    util::Timers timers;
+    timers.Enabled() = true;
+    search(std::move(queries), timers);
+    const std::chrono::high_resolution_clock::time_point searchEnd =
+        std::chrono::high_resolution_clock::now();
+
+    candidate.buildTime =
+        std::chrono::duration<double>(searchStart - buildStart).count();
+    candidate.searchTime =
+        std::chrono::duration<double>(searchEnd - searchStart).count();
+
+    std::map<std::string, size_t> counters = timers.GetAllCounters();
+    candidate.baseCases = counters["base_cases"];
+    candidate.scores = counters["scores"];
+    candidate.cost = EstimateCost(candidate, referenceSample.n_cols,
+        querySample.n_cols, referencePoints, queryPoints);
+
+    Log::Info << "  " << candidate.name;
+    if (candidate.leafSize > 0)
+      Log::Info << " (leaf size " << candidate.leafSize << ")";
+    Log::Info << ": built in " << candidate.buildTime << "s, searched in "
+        << candidate.searchTime << "s with " << candidate.baseCases
+        << " base cases and " << candidate.scores << " scores; estimated "
+        << "cost " << candidate.cost << "s." << std::endl;
+
+    if (candidate.cost < candidates[best].cost)
+      best = i;
+  }
+
+  Log::Info << "Chose the " << candidates[best].name;
+  if (candidates[best].leafSize > 0)
+    Log::Info << " with leaf size " << candidates[best].leafSize;
+  Log::Info << " (estimated cost " << candidates[best].cost << "s)."
+      << std::endl;
+
+  return best;
+}
+
+inline double TreeTuner::EstimateCost(const TreeCandidate& candidate,
+                                      const size_t referenceSamples,
+                                      const size_t querySamples,
+                                      const size_t referencePoints,
+                                      const size_t queryPoints)
+{
+  double buildScale = 1.0;
+  double searchScale = 1.0;
+  if (referencePoints > referenceSamples && referenceSamples > 1)
+  {
+    const double n = (double) referenceSamples;
+    const double bigN = (double) referencePoints;
+    buildScale = (bigN * std::log(bigN)) / (n * std::log(n));
+
+    // The fraction of the reference sample compared to each query did not
+    // benefit from pruning, and grows linearly with the reference set.
+    const double unpruned = std::min(1.0,
+        (double) candidate.baseCases / ((double) querySamples * n));
+    searchScale = (1.0 - unpruned) * std::log(bigN) / std::log(n) +
+        unpruned * bigN / n;
+  }
+
+  const double queryScale = (querySamples == 0) ? 0.0 :
+      (double) queryPoints / (double) querySamples;
+
+  return candidate.buildTime * buildScale +
+      candidate.searchTime * queryScale * searchScale;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
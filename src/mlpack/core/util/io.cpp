@@ -52,6 +52,7 @@ void IO::AddParameter(const std::string& bindingName, ParamData&& data)
   #undef BASH_CLEAR
 
   // Define identifier and alias maps.
+  std::lock_guard<std::mutex> lock(GetSingleton().mapMutex);
   std::map<std::string, util::ParamData>& bindingParams =
       GetSingleton().parameters[bindingName];
   std::map<char, std::string>& bindingAliases =
@@ -79,7 +80,6 @@ void IO::AddParameter(const std::string& bindingName, ParamData&& data)
   }
 
   // Add the alias, if necessary.
-  std::lock_guard<std::mutex> lock(GetSingleton().mapMutex);
   if (data.alias != '\0')
     bindingAliases[data.alias] = data.name;
 
@@ -109,7 +109,7 @@ void IO::AddFunction(const std::string& type,
  */
 void IO::AddBindingName(const std::string& bindingName, const std::string& name)
 {
-  std::lock_guard<std::mutex> lock(GetSingleton().mapMutex);
+  std::lock_guard<std::mutex> lock(GetSingleton().docMutex);
   GetSingleton().docs[bindingName].name = name;
 }
 
@@ -189,22 +189,43 @@ util::Timers& IO::GetTimers()
  */
 util::Params IO::Parameters(const std::string& bindingName)
 {
-  // We don't need a mutex here, because we are only randomly accessing elements
-  // of the maps.
+  // Bindings may be run concurrently, so the maps are only read here (never
+  // with operator[], which would insert an empty entry), and under the locks
+  // that the Add*() functions take.  The returned object holds copies, so the
+  // binding itself touches no shared state through it.
+  IO& io = GetSingleton();
+  util::BindingDetails details;
+  {
+    std::lock_guard<std::mutex> lock(io.docMutex);
+    auto it = io.docs.find(bindingName);
+    if (it != io.docs.end())
+      details = it->second;
+  }
 
-  std::map<char, std::string> resultAliases =
-      GetSingleton().aliases[bindingName];
+  std::lock_guard<std::mutex> lock(io.mapMutex);
+  std::map<char, std::string> resultAliases;
+  auto aliases = io.aliases.find(bindingName);
+  if (aliases != io.aliases.end())
+    resultAliases = aliases->second;
   // Merge in any persistent parameters (e.g. parameters in the "" binding map).
-  std::map<char, std::string> persistentAliases = GetSingleton().aliases[""];
-  resultAliases.insert(persistentAliases.begin(), persistentAliases.end());
+  auto persistentAliases = io.aliases.find("");
+  if (persistentAliases != io.aliases.end())
+  {
+    resultAliases.insert(persistentAliases->second.begin(),
+        persistentAliases->second.end());
+  }
 
-  std::map<std::string, util::ParamData> resultParams =
-      GetSingleton().parameters[bindingName];
-  // Merge in any persistent parameters (e.g. parameters in the "" binding map).
-  std::map<std::string, util::ParamData> persistentParams =
-      GetSingleton().parameters[""];
-  resultParams.insert(persistentParams.begin(), persistentParams.end());
+  std::map<std::string, util::ParamData> resultParams;
+  auto params = io.parameters.find(bindingName);
+  if (params != io.parameters.end())
+    resultParams = params->second;
+  auto persistentParams = io.parameters.find("");
+  if (persistentParams != io.parameters.end())
+  {
+    resultParams.insert(persistentParams->second.begin(),
+        persistentParams->second.end());
+  }
 
-  return Params(resultAliases, resultParams, GetSingleton().functionMap,
-      bindingName, GetSingleton().docs[bindingName]);
+  return Params(resultAliases, resultParams, io.functionMap, bindingName,
+      details);
 }
@@ -165,6 +165,19 @@ namespace mlpack {
  * binding has options which you did not define, it is probably because the
  * option is defined somewhere else and included in your binding.
  *
+ * @section threads Running bindings concurrently
+ *
+ * Each run of a binding works on its own util::Params object, returned by
+ * IO::Parameters(), and its own util::Timers object; the Python, Julia and Go
+ * bindings create both for each call.  IO::Parameters() only copies the
+ * registered parameters under a lock, so several bindings (or the same
+ * binding several times) may run at once in different threads, as long as
+ * they do not share an input model that one of them modifies.  Two things
+ * remain process-wide: the verbosity of Log::Info (the `verbose` option of
+ * one call also shows the informational messages of concurrent calls), and
+ * the random number generator of mlpack::math, so concurrent runs of
+ * randomized methods are not reproducible even with a fixed seed.
+ *
  * @bug
  * The __COUNTER__ variable is used in most cases to guarantee a unique global
  * identifier for options declared using the PARAM_*() macros.  However, not all
@@ -51,7 +51,16 @@ namespace mlpack {
  * mode.  Messages to Log::Info will only be shown when the --verbose flag is
  * given to the program (or rather, the IO class).
  *
- * @see PrefixedOutStream, NullOutStream, IO
+ * Writing to a stream that is muted (Log::Info without --verbose, or Log::Debug
+ * in non-debug mode) does nothing, but the arguments are still evaluated.  In
+ * hot code, MLPACK_LOG() skips evaluating them too:
+ *
+ * @code
+ * MLPACK_LOG(Log::Info) << "Iteration " << i << ": objective "
+ *     << ComputeObjective() << "." << std::endl;
+ * @endcode
+ *
+ * @see PrefixedOutStream, NullOutStream, IO, MLPACK_LOG()
  */
 class Log
 {
@@ -93,6 +102,27 @@ class Log
   static std::ostream& cout;
 };
 
+namespace util {
+
+//! Turns a logging expression into a void expression, for MLPACK_LOG().  The
+//! operator has lower precedence than <<, so it applies to the whole chain.
+struct LogVoidify
+{
+  template<typename StreamType>
+  void operator&(StreamType& /* stream */) { }
+};
+
+} // namespace util
+
 }; // namespace mlpack
 
+/**
+ * Write to the given log stream (e.g. Log::Info) only if it is not muted; when
+ * it is, the rest of the expression (including calls that compute the values to
+ * print) is not evaluated at all.  Use it like the stream itself:
+ * `MLPACK_LOG(Log::Info) << "residue " << residue << "." << std::endl;`.
+ */
+#define MLPACK_LOG(STREAM) \
+    (STREAM).Muted() ? (void) 0 : mlpack::util::LogVoidify() & (STREAM)
+
 #endif
@@ -37,6 +37,9 @@ class NullOutStream
    */
   NullOutStream(const NullOutStream& /* other */) { }
 
+  //! Anything written to the stream is discarded.
+  bool Muted() const { return true; }
+
   //! Does nothing.
   NullOutStream& operator<<(bool) { return *this; }
   //! Does nothing.
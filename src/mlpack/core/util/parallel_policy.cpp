@@ -0,0 +1,94 @@
+/**
+ * @file core/util/parallel_policy.cpp
+ *
+ * Implementation of ParallelPolicy and ParallelScope.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "parallel_policy.hpp"
+#include "log.hpp"
+
+#include <algorithm>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+using namespace mlpack;
+
+namespace {
+
+//! The policy of the innermost ParallelScope of this thread, or NULL.
+thread_local const ParallelPolicy* currentPolicy = NULL;
+
+//! The policy of the threads without a ParallelScope.
+const ParallelPolicy defaultPolicy;
+
+//! The number of blocks of the reductions of deterministic policies, so that
+//! they can still use up to this many threads.
+const size_t deterministicBlocks = 64;
+
+} // anonymous namespace
+
+size_t ParallelPolicy::NumThreads() const
+{
+  #ifdef HAS_OPENMP
+    return (threads == 0) ? (size_t) omp_get_max_threads() : threads;
+  #else
+    return 1;
+  #endif
+}
+
+size_t ParallelPolicy::NumBlocks(const size_t n,
+                                 const size_t defaultGrainSize) const
+{
+  const size_t grain = std::max((grainSize == 0) ? defaultGrainSize :
+      grainSize, (size_t) 1);
+  const size_t maxBlocks = deterministic ? deterministicBlocks : NumThreads();
+
+  return std::max(std::min(n / grain, maxBlocks), (size_t) 1);
+}
+
+const ParallelPolicy& ParallelPolicy::Current()
+{
+  return (currentPolicy == NULL) ? defaultPolicy : *currentPolicy;
+}
+
+ParallelScope::ParallelScope(const ParallelPolicy& policy) :
+    policy(policy),
+    previous(currentPolicy),
+    previousThreads(0)
+{
+  #ifdef HAS_OPENMP
+    previousThreads = omp_get_max_threads();
+    if (policy.Threads() > 0)
+      omp_set_num_threads((int) policy.Threads());
+  #endif
+
+  // Pages are only placed near the threads that touch them first if the
+  // threads do not move between sockets afterwards; OpenMP has no call to pin
+  // them once the program runs, so it can only be done with the environment.
+  #if defined(HAS_OPENMP) && defined(_OPENMP) && (_OPENMP >= 201307)
+    if (policy.NumaAware() && omp_get_proc_bind() == omp_proc_bind_false)
+    {
+      Log::Warn << "ParallelScope: NUMA-aware policy, but the OpenMP threads "
+          << "are not pinned to cores; set OMP_PROC_BIND=spread and "
+          << "OMP_PLACES=cores to keep each thread next to its data."
+          << std::endl;
+    }
+  #endif
+
+  currentPolicy = &this->policy;
+}
+
+ParallelScope::~ParallelScope()
+{
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(previousThreads);
+  #endif
+
+  currentPolicy = previous;
+}
@@ -0,0 +1,183 @@
+/**
+ * @file core/util/parallel_policy.hpp
+ *
+ * Definition of ParallelPolicy, which sets how many threads the methods of
+ * mlpack use and how they split their work, and of ParallelScope, which
+ * applies a policy to the calls made by the current thread.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_PARALLEL_POLICY_HPP
+#define MLPACK_CORE_UTIL_PARALLEL_POLICY_HPP
+
+#include <cstddef>
+
+namespace mlpack {
+
+/**
+ * A ParallelPolicy holds the parallelism allowed to the methods of mlpack:
+ *
+ *  - the number of threads (0 means the OpenMP default, which can be set with
+ *    the OMP_NUM_THREADS environment variable);
+ *  - the grain size, that is the minimum number of points given to each block
+ *    of work (0 means the default of each method);
+ *  - whether results must be deterministic, that is, independent of the number
+ *    of threads.  Reductions of floating-point values (sums, covariances,
+ *    gradients) are then always split into the same blocks, which are merged
+ *    in the same order, whatever the number of threads;
+ *  - whether the memory of large matrices must be spread over the NUMA nodes
+ *    of the machine.  data::Load() then places the loaded matrix with
+ *    data::FirstTouch(), so that each thread finds the columns it processes in
+ *    the memory of its own socket.  This only helps if the OpenMP threads are
+ *    pinned to cores, for instance with OMP_PROC_BIND=spread and
+ *    OMP_PLACES=cores; a warning is given otherwise.
+ *
+ * A policy is applied to all the calls made by a thread with a ParallelScope;
+ * the methods that split their work into blocks ask the current policy with
+ * ParallelPolicy::Current().  Since the policy of each thread is separate, two
+ * models trained at the same time in two threads of one process can use
+ * different numbers of threads:
+ *
+ * @code
+ * // In the first thread:
+ * {
+ *   ParallelScope scope(ParallelPolicy(8));
+ *   forest.Train(data, labels, numClasses);
+ * }
+ *
+ * // In the second thread:
+ * {
+ *   ParallelScope scope(ParallelPolicy(4));
+ *   knn.Search(queries, k, neighbors, distances);
+ * }
+ * @endcode
+ *
+ * The command-line and Python bindings apply the policy given by their
+ * `threads` option.
+ */
+class ParallelPolicy
+{
+ public:
+  /**
+   * Create the policy.
+   *
+   * @param threads Number of threads to use (0 for the OpenMP default).
+   * @param grainSize Minimum number of points of each block of work (0 for the
+   *     default of each method).
+   * @param deterministic Whether results must be independent of the number of
+   *     threads.
+   * @param numaAware Whether loaded matrices must be spread over the NUMA nodes
+   *     of the machine.
+   */
+  ParallelPolicy(const size_t threads = 0,
+                 const size_t grainSize = 0,
+                 const bool deterministic = false,
+                 const bool numaAware = false) :
+      threads(threads),
+      grainSize(grainSize),
+      deterministic(deterministic),
+      numaAware(numaAware)
+  {
+    // Nothing to do.
+  }
+
+  //! Get the number of threads to use (0 for the OpenMP default).
+  size_t Threads() const { return threads; }
+  //! Modify the number of threads to use (0 for the OpenMP default).
+  size_t& Threads() { return threads; }
+
+  //! Get the minimum number of points of each block (0 for the default).
+  size_t GrainSize() const { return grainSize; }
+  //! Modify the minimum number of points of each block (0 for the default).
+  size_t& GrainSize() { return grainSize; }
+
+  //! Get whether results must be independent of the number of threads.
+  bool Deterministic() const { return deterministic; }
+  //! Modify whether results must be independent of the number of threads.
+  bool& Deterministic() { return deterministic; }
+
+  //! Get whether loaded matrices are spread over the NUMA nodes.
+  bool NumaAware() const { return numaAware; }
+  //! Modify whether loaded matrices are spread over the NUMA nodes.
+  bool& NumaAware() { return numaAware; }
+
+  /**
+   * Get the number of threads used by this policy: Threads(), or the OpenMP
+   * default if it is 0.  Without OpenMP, this is always 1.
+   */
+  size_t NumThreads() const;
+
+  /**
+   * Get the number of blocks to split n points into, for a computation whose
+   * blocks are processed in parallel and then merged in order.  Each block has
+   * at least GrainSize() points (or defaultGrainSize, if GrainSize() is 0), and
+   * there are no more blocks than threads; if the policy is deterministic, the
+   * number of blocks does not depend on the number of threads instead.  The
+   * result is at least 1.
+   *
+   * @param n Number of points to split.
+   * @param defaultGrainSize Minimum number of points of each block used by the
+   *     method if the policy has no grain size.
+   */
+  size_t NumBlocks(const size_t n, const size_t defaultGrainSize) const;
+
+  /**
+   * Get the policy of the current thread: the one of the innermost
+   * ParallelScope, or the default policy (with the default values of the
+   * constructor) if there is none.
+   */
+  static const ParallelPolicy& Current();
+
+ private:
+  //! The number of threads to use.
+  size_t threads;
+  //! The minimum number of points of each block.
+  size_t grainSize;
+  //! Whether results must be independent of the number of threads.
+  bool deterministic;
+  //! Whether loaded matrices are spread over the NUMA nodes.
+  bool numaAware;
+};
+
+/**
+ * A ParallelScope applies a ParallelPolicy to the current thread until it is
+ * destroyed: ParallelPolicy::Current() returns the policy, and if the policy
+ * sets a number of threads, OpenMP parallel regions started by the thread
+ * (including those of a BLAS library built with OpenMP) use that number of
+ * threads.  If the policy is NUMA-aware but the OpenMP threads are not pinned
+ * to cores, a warning is given.  Scopes may be nested; the previous policy is
+ * restored when the scope is destroyed.
+ */
+class ParallelScope
+{
+ public:
+  /**
+   * Apply the given policy to the current thread.
+   *
+   * @param policy Policy to apply; it is copied.
+   */
+  explicit ParallelScope(const ParallelPolicy& policy);
+
+  //! Restore the previous policy of the current thread.
+  ~ParallelScope();
+
+  //! A scope cannot be copied.
+  ParallelScope(const ParallelScope& other) = delete;
+  //! A scope cannot be copied.
+  ParallelScope& operator=(const ParallelScope& other) = delete;
+
+ private:
+  //! The applied policy.
+  ParallelPolicy policy;
+  //! The previous policy of the thread.
+  const ParallelPolicy* previous;
+  //! The previous OpenMP number of threads of the thread.
+  int previousThreads;
+};
+
+} // namespace mlpack
+
+#endif
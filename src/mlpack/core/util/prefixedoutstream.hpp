@@ -111,6 +111,14 @@ class PrefixedOutStream
   template<typename T>
   PrefixedOutStream& operator<<(const T& s);
 
+  /**
+   * Get whether anything written to the stream is discarded: the input is
+   * ignored and the stream is not fatal.  Writing to a muted stream does not
+   * format its arguments, but they are still evaluated; use MLPACK_LOG() to
+   * skip that too.
+   */
+  bool Muted() const { return ignoreInput && !fatal; }
+
   //! The output stream that all data is to be sent to; example:
   //! MLPACK_COUT_STREAM.
   std::ostream& destination;
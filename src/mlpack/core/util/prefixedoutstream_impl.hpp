@@ -38,6 +38,11 @@ template<typename T>
 typename std::enable_if<!arma::is_arma_type<T>::value>::type
 PrefixedOutStream::BaseLogic(const T& val)
 {
+  // A muted stream has nothing to print and nothing to throw, so don't bother
+  // formatting the value.
+  if (Muted())
+    return;
+
   // We will use this to track whether or not we need to terminate at the end of
   // this call (only for streams which terminate after a newline).
   bool newlined = false;
@@ -146,6 +151,11 @@ template<typename T>
 typename std::enable_if<arma::is_arma_type<T>::value>::type
 PrefixedOutStream::BaseLogic(const T& val)
 {
+  // A muted stream has nothing to print and nothing to throw, so don't bother
+  // formatting the value.
+  if (Muted())
+    return;
+
   // Extract printable object from the input.
   const arma::Mat<typename T::elem_type>& printVal(val);
 
@@ -75,6 +75,7 @@ void Timers::Reset()
 {
   lock_guard<mutex> lock(timersMutex);
   timers.clear();
+  counters.clear();
   timerStartTime.clear();
 }
 
@@ -85,6 +86,22 @@ map<string, microseconds> Timers::GetAllTimers()
   return timers;
 }
 
+map<string, size_t> Timers::GetAllCounters()
+{
+  lock_guard<mutex> lock(timersMutex);
+  return counters;
+}
+
+void Timers::Count(const string& counterName, const size_t count)
+{
+  // Don't do anything if we aren't timing.
+  if (!enabled)
+    return;
+
+  lock_guard<mutex> lock(timersMutex);
+  counters[counterName] += count;
+}
+
 microseconds Timers::Get(const string& timerName)
 {
   if (!enabled)
@@ -221,8 +238,16 @@ void Timers::Stop(const string& timerName,
   high_resolution_clock::time_point currTime = high_resolution_clock::now();
 
   // Calculate the delta time.
-  timers[timerName] += duration_cast<microseconds>(currTime -
+  const nanoseconds delta = duration_cast<nanoseconds>(currTime -
       timerStartTime[threadId][timerName]);
+  timers[timerName] += duration_cast<microseconds>(delta);
+
+  // Timers also appear in the trace, if it is being recorded.
+  if (Tracer::Enabled())
+  {
+    const int64_t end = Tracer::Now();
+    Tracer::Record(Tracer::NameId(timerName), end - delta.count(), end);
+  }
 
   // Remove the entries.
   timerStartTime[threadId].erase(timerName);
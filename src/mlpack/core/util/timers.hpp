@@ -23,6 +23,8 @@
 #include <string>
 #include <thread> // std::thread is used for thread safety.
 
+#include "tracer.hpp"
+
 #if defined(_WIN32)
   // uint64_t isn't defined on every windows.
   #if !defined(HAVE_UINT64_T)
@@ -114,8 +116,8 @@ class Timers
   std::map<std::string, std::chrono::microseconds> GetAllTimers();
 
   /**
-   * Reset the timers.  This stops all running timers and removes them.  Whether
-   * or not timing is enabled will not be changed.
+   * Reset the timers.  This stops all running timers and removes them, along
+   * with all counters.  Whether or not timing is enabled will not be changed.
    */
   void Reset();
 
@@ -161,6 +163,22 @@ class Timers
    */
   void StopAllTimers();
 
+  /**
+   * Add to the given counter, such as the number of base cases of a search or
+   * the number of iterations of an optimization, so that it can be reported
+   * alongside the timers.  Counters start at zero, are additive like timers,
+   * and are only kept when timing is enabled.
+   *
+   * @param counterName The name of the counter in question.
+   * @param count Amount to add to the counter.
+   */
+  void Count(const std::string& counterName, const size_t count = 1);
+
+  /**
+   * Returns a copy of all the counters used via this interface.
+   */
+  std::map<std::string, size_t> GetAllCounters();
+
   //! Modify whether or not timing is enabled.
   std::atomic<bool>& Enabled() { return enabled; }
   //! Get whether or not timing is enabled.
@@ -169,7 +187,9 @@ class Timers
  private:
   //! A map of all the timers that are being tracked.
   std::map<std::string, std::chrono::microseconds> timers;
-  //! A mutex for modifying the timers.
+  //! A map of all the counters that are being tracked.
+  std::map<std::string, size_t> counters;
+  //! A mutex for modifying the timers and counters.
   std::mutex timersMutex;
   //! A map for the starting values of the timers.
   std::map<std::thread::id, std::map<std::string,
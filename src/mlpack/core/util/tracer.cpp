@@ -0,0 +1,227 @@
+/**
+ * @file core/util/tracer.cpp
+ *
+ * Implementation of the Tracer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "tracer.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+using namespace mlpack;
+using namespace mlpack::util;
+using namespace std;
+using namespace chrono;
+
+std::atomic<bool> Tracer::enabled(false);
+
+namespace {
+
+//! A recorded scope.
+struct TraceEvent
+{
+  uint32_t nameId;
+  int64_t start;
+  int64_t end;
+};
+
+//! The ring buffer of the events of one thread; only that thread writes it.
+struct TraceBuffer
+{
+  explicit TraceBuffer(const size_t capacity) : events(capacity), count(0) { }
+
+  std::vector<TraceEvent> events;
+  //! Number of events recorded, including those that were overwritten.
+  uint64_t count;
+};
+
+//! The state shared by all threads.
+struct TraceRegistry
+{
+  TraceRegistry() :
+      capacity(65536),
+      generation(1),
+      epoch(steady_clock::now())
+  { }
+
+  //! Protects everything but the contents of the buffers.
+  std::mutex mutex;
+  //! The interned scope names, indexed by id.
+  std::vector<std::string> names;
+  //! The id of each interned name.
+  std::unordered_map<std::string, uint32_t> ids;
+  //! The buffer of each thread that recorded an event, in order of first use.
+  std::vector<std::unique_ptr<TraceBuffer>> buffers;
+  //! Number of events kept for each thread (a power of two).
+  size_t capacity;
+  //! Incremented whenever the buffers are discarded, so that each thread
+  //! knows to register a new one.
+  std::atomic<uint64_t> generation;
+  //! The time that Now() is relative to.
+  steady_clock::time_point epoch;
+};
+
+TraceRegistry& Registry()
+{
+  static TraceRegistry registry;
+  return registry;
+}
+
+//! The buffer of the calling thread, valid if localGeneration is current.
+thread_local TraceBuffer* localBuffer = nullptr;
+thread_local uint64_t localGeneration = 0;
+
+//! Write the given string as a JSON string.
+void WriteJSONString(std::ostream& stream, const std::string& str)
+{
+  stream << '"';
+  for (const char c : str)
+  {
+    if (c == '"' || c == '\\')
+      stream << '\\' << c;
+    else if ((unsigned char) c < 0x20)
+      stream << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+          << (int) c << std::dec << std::setfill(' ');
+    else
+      stream << c;
+  }
+  stream << '"';
+}
+
+} // anonymous namespace
+
+void Tracer::Enable(const size_t capacity)
+{
+  TraceRegistry& registry = Registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  size_t roundedCapacity = 1;
+  while (roundedCapacity < capacity)
+    roundedCapacity <<= 1;
+  registry.capacity = roundedCapacity;
+  registry.buffers.clear();
+  ++registry.generation;
+  enabled = true;
+}
+
+void Tracer::Disable()
+{
+  enabled = false;
+}
+
+void Tracer::Clear()
+{
+  TraceRegistry& registry = Registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.buffers.clear();
+  ++registry.generation;
+}
+
+uint32_t Tracer::NameId(const std::string& name)
+{
+  TraceRegistry& registry = Registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  auto it = registry.ids.find(name);
+  if (it != registry.ids.end())
+    return it->second;
+
+  const uint32_t id = (uint32_t) registry.names.size();
+  registry.names.push_back(name);
+  registry.ids[name] = id;
+  return id;
+}
+
+int64_t Tracer::Now()
+{
+  return duration_cast<nanoseconds>(steady_clock::now() -
+      Registry().epoch).count();
+}
+
+void Tracer::Record(const uint32_t nameId,
+                    const int64_t start,
+                    const int64_t end)
+{
+  TraceRegistry& registry = Registry();
+
+  // The first event of a thread (after the buffers were last discarded)
+  // registers its buffer; every other event only writes to that buffer.
+  const uint64_t generation = registry.generation.load(
+      std::memory_order_acquire);
+  if (localGeneration != generation)
+  {
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.buffers.emplace_back(new TraceBuffer(registry.capacity));
+    localBuffer = registry.buffers.back().get();
+    localGeneration = generation;
+  }
+
+  TraceBuffer& buffer = *localBuffer;
+  TraceEvent& event = buffer.events[buffer.count &
+      (buffer.events.size() - 1)];
+  event.nameId = nameId;
+  event.start = start;
+  event.end = end;
+  ++buffer.count;
+}
+
+void Tracer::Write(std::ostream& stream)
+{
+  TraceRegistry& registry = Registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  // Complete ("X") events, with times in microseconds; each thread is its own
+  // track.
+  const std::ios::fmtflags flags = stream.flags();
+  const std::streamsize precision = stream.precision();
+  stream << "{\"traceEvents\":[";
+  bool first = true;
+  stream << std::fixed << std::setprecision(3);
+  for (size_t t = 0; t < registry.buffers.size(); ++t)
+  {
+    const TraceBuffer& buffer = *registry.buffers[t];
+    const uint64_t size = buffer.events.size();
+    const uint64_t begin = (buffer.count > size) ? buffer.count - size : 0;
+    for (uint64_t i = begin; i < buffer.count; ++i)
+    {
+      const TraceEvent& event = buffer.events[i & (size - 1)];
+      stream << (first ? "\n" : ",\n") << "{\"name\":";
+      WriteJSONString(stream, registry.names[event.nameId]);
+      stream << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << t << ",\"ts\":"
+          << event.start / 1000.0 << ",\"dur\":"
+          << (event.end - event.start) / 1000.0 << "}";
+      first = false;
+    }
+  }
+  stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  stream.flags(flags);
+  stream.precision(precision);
+}
+
+void Tracer::Write(const std::string& filename)
+{
+  std::ofstream ofs(filename);
+  if (!ofs.is_open())
+  {
+    throw std::runtime_error("Tracer::Write(): cannot open file '" + filename +
+        "' for writing");
+  }
+
+  Write(ofs);
+  if (!ofs.good())
+  {
+    throw std::runtime_error("Tracer::Write(): error writing to file '" +
+        filename + "'");
+  }
+}
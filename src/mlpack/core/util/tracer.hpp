@@ -0,0 +1,158 @@
+/**
+ * @file core/util/tracer.hpp
+ *
+ * Definition of the Tracer, which records timed scopes into per-thread ring
+ * buffers, and of the TraceScope guard and MLPACK_TRACE_SCOPE() macro used to
+ * instrument code with it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_TRACER_HPP
+#define MLPACK_CORE_UTIL_TRACER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include <mlpack/mlpack_export.hpp>
+
+namespace mlpack {
+namespace util {
+
+/**
+ * The Tracer records the start and end of timed scopes, so that the nesting of
+ * the scopes of each thread over time can be inspected afterwards.  Unlike
+ * Timers, which sums the time of each named timer behind a mutex, recording a
+ * scope takes no lock and does no string lookup: the name of each scope is
+ * interned once into an id, and each thread writes its events into its own
+ * ring buffer, which keeps the most recent events.  When tracing is disabled,
+ * a scope costs a single atomic load.
+ *
+ * The events are written in the Chrome trace event format, which can be
+ * viewed with chrome://tracing or https://ui.perfetto.dev.  The command-line
+ * programs write it when the --trace_file option is given.
+ *
+ * @code
+ * void Iterate()
+ * {
+ *   MLPACK_TRACE_SCOPE("iteration");
+ *   ...
+ * }
+ *
+ * util::Tracer::Enable();
+ * for (size_t i = 0; i < 10; ++i)
+ *   Iterate();
+ * util::Tracer::Write("trace.json");
+ * @endcode
+ *
+ * Scopes may be recorded from any number of threads at once.  Enable(),
+ * Clear() and Write() must only be called while no scope is being recorded.
+ */
+class Tracer
+{
+ public:
+  /**
+   * Start recording scopes.  Each thread keeps the last `capacity` events it
+   * records; the capacity is rounded up to a power of two.  Events recorded
+   * before are discarded.
+   *
+   * @param capacity Number of events to keep for each thread.
+   */
+  static void Enable(const size_t capacity = 65536);
+
+  //! Stop recording scopes; the events recorded so far are kept.
+  static void Disable();
+
+  //! Get whether scopes are being recorded.
+  static bool Enabled() { return enabled.load(std::memory_order_relaxed); }
+
+  //! Discard all the events recorded so far.
+  static void Clear();
+
+  /**
+   * Get the id of the given scope name, adding it to the table of names if
+   * needed.  This takes a lock, so it should be called once for each scope
+   * (MLPACK_TRACE_SCOPE() keeps the id in a static variable).
+   */
+  static uint32_t NameId(const std::string& name);
+
+  //! Get the current time, in nanoseconds since the tracer was created.
+  static int64_t Now();
+
+  /**
+   * Record a scope of the calling thread.
+   *
+   * @param nameId Id of the name of the scope, from NameId().
+   * @param start Start of the scope, from Now().
+   * @param end End of the scope, from Now().
+   */
+  static void Record(const uint32_t nameId,
+                     const int64_t start,
+                     const int64_t end);
+
+  //! Write the recorded events to the given stream, in the Chrome trace event
+  //! format.
+  static void Write(std::ostream& stream);
+
+  //! Write the recorded events to the given file, in the Chrome trace event
+  //! format.  A std::runtime_error is thrown if the file cannot be written.
+  static void Write(const std::string& filename);
+
+ private:
+  //! Whether scopes are being recorded.
+  static MLPACK_EXPORT std::atomic<bool> enabled;
+};
+
+/**
+ * TraceScope records the scope it lives in with the Tracer: the scope starts
+ * when the object is constructed and ends when it is destroyed.  Nested scopes
+ * appear nested in the trace.  Usually this is created through the
+ * MLPACK_TRACE_SCOPE() macro.
+ */
+class TraceScope
+{
+ public:
+  //! Start the scope with the given name id.
+  explicit TraceScope(const uint32_t nameId) :
+      nameId(nameId),
+      start(Tracer::Enabled() ? Tracer::Now() : -1)
+  { }
+
+  //! End the scope.
+  ~TraceScope()
+  {
+    if (start >= 0)
+      Tracer::Record(nameId, start, Tracer::Now());
+  }
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+ private:
+  //! Id of the name of the scope.
+  uint32_t nameId;
+  //! Start of the scope, or -1 if tracing was disabled.
+  int64_t start;
+};
+
+} // namespace util
+} // namespace mlpack
+
+#define MLPACK_TRACE_JOIN_IMPL(X, Y) X ## Y
+#define MLPACK_TRACE_JOIN(X, Y) MLPACK_TRACE_JOIN_IMPL(X, Y)
+
+/**
+ * Record the rest of the enclosing block as a scope with the given name (a
+ * string literal) when tracing is enabled.
+ */
+#define MLPACK_TRACE_SCOPE(NAME) \
+    static const uint32_t MLPACK_TRACE_JOIN(mlpackTraceId, __LINE__) = \
+        mlpack::util::Tracer::NameId(NAME); \
+    mlpack::util::TraceScope MLPACK_TRACE_JOIN(mlpackTraceScope, __LINE__)( \
+        MLPACK_TRACE_JOIN(mlpackTraceId, __LINE__))
+
+#endif
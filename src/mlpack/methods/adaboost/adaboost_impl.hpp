@@ -87,13 +87,6 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
   // To be used for prediction by the weak learner.
   arma::Row<size_t> predictedLabels(labels.n_cols);
 
-  // Use tempData to modify input data for incorporating weights.
-  MatType tempData(data);
-
-  // This matrix is a helper matrix used to calculate the final hypothesis.
-  arma::mat sumFinalH = arma::zeros<arma::mat>(numClasses,
-      predictedLabels.n_cols);
-
   // Load the initial weights into a 2-D matrix.
   const double initWeight = 1.0 / double(data.n_cols * numClasses);
   arma::mat D(numClasses, data.n_cols);
@@ -102,20 +95,13 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
   // Weights are stored in this row vector.
   arma::rowvec weights(predictedLabels.n_cols);
 
-  // This is the final hypothesis.
-  arma::Row<size_t> finalH(predictedLabels.n_cols);
+  // This holds 1 for each point the weak learner classifies correctly, and -1
+  // for each point it misclassifies.
+  arma::rowvec signs(predictedLabels.n_cols);
 
   // Now, start the boosting rounds.
   for (size_t i = 0; i < iterations; ++i)
   {
-    // Initialized to zero in every round.  rt is used for calculation of
-    // alphat; it is the weighted error.
-    // rt = (sum) D(i) y(i) ht(xi)
-    rt = 0.0;
-
-    // zt is used for weight normalization.
-    zt = 0.0;
-
     // Build the weight vectors.
     weights = arma::sum(D);
 
@@ -131,7 +117,7 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
     // This trains the new WeakLearnerType using the hyperparameters from the
     // given WeakLearnerType.
 
-    WeakLearnerType w(other, tempData, labels, numClasses, weights);
+    WeakLearnerType w(other, data, labels, numClasses, weights);
     // There is a bug with Adaboost!  It will not use the specified
     // hyperparameters for the decision tree because they are not properly
     // passed to the new weak learners!  (And: it's a hard bug, because the
@@ -139,19 +125,14 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
     // trained with!)
 
     // DecisionTree(DecisionTree&, MatType&, LabelsType&, size_t, WeightsType&, double = 0.0, double = 0.0, ...);
-    w.Classify(tempData, predictedLabels);
+    w.Classify(data, predictedLabels);
 
-    // Now from predictedLabels, build ht, the weak hypothesis
-    // buildClassificationMatrix(ht, predictedLabels);
-
-    // Now, calculate alpha(t) using ht.
-    for (size_t j = 0; j < D.n_cols; ++j) // instead of D, ht
-    {
-      if (predictedLabels(j) == labels(j))
-        rt += arma::accu(D.col(j));
-      else
-        rt -= arma::accu(D.col(j));
-    }
+    // Now, calculate alpha(t) using ht.  rt is used for calculation of alphat;
+    // it is the weighted error, rt = (sum) D(i) y(i) ht(xi).  The weight of
+    // each point is the sum of its column of D.
+    signs = 2.0 * arma::conv_to<arma::rowvec>::from(
+        predictedLabels == labels) - 1.0;
+    rt = arma::dot(weights, signs);
 
     if ((i > 0) && (std::abs(rt - crt) < tolerance))
       break;
@@ -174,44 +155,21 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
     alpha.push_back(alphat);
     wl.push_back(w);
 
-    // Now start modifying the weights.
-    for (size_t j = 0; j < D.n_cols; ++j)
+    // Now start modifying the weights: the weights of the correctly classified
+    // points are divided by exp(alphat), and the others are multiplied by it.
+    // Each point is independent of the others.
+    const double expo = exp(alphat);
+    #pragma omp parallel for
+    for (omp_size_t j = 0; j < (omp_size_t) D.n_cols; ++j)
     {
-      const double expo = exp(alphat);
-      if (predictedLabels(j) == labels(j))
-      {
-        for (size_t k = 0; k < D.n_rows; ++k)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) /= expo;
-          zt += D(k, j); // * exp(-1 * alphat * yt(j,k) * ht(j,k));
-
-          // Add to the final hypothesis matrix.
-          // sumFinalH(k, j) += (alphat * ht(k, j));
-          if (k == labels(j))
-            sumFinalH(k, j) += (alphat); // * ht(k, j));
-          else
-            sumFinalH(k, j) -= (alphat);
-        }
-      }
+      if (signs[j] > 0.0)
+        D.col(j) /= expo;
       else
-      {
-        for (size_t k = 0; k < D.n_rows; ++k)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) *= expo;
-          zt += D(k, j);
-
-          // Add to the final hypothesis matrix.
-          if (k == labels(j))
-            sumFinalH(k, j) += alphat; // * ht(k, j));
-          else
-            sumFinalH(k, j) -= alphat;
-        }
-      }
+        D.col(j) *= expo;
     }
 
-    // Normalize D.
+    // We calculate zt, the normalization constant, and normalize D.
+    zt = arma::accu(D);
     D /= zt;
 
     // Accumulate the value of zt for the Hamming loss bound.
@@ -252,19 +210,16 @@ void AdaBoost<WeakLearnerType, MatType>::Classify(
   {
     wl[i].Classify(test, tempPredictedLabels);
 
-    for (size_t j = 0; j < tempPredictedLabels.n_cols; ++j)
+    #pragma omp parallel for
+    for (omp_size_t j = 0; j < (omp_size_t) tempPredictedLabels.n_cols; ++j)
       probabilities(tempPredictedLabels(j), j) += alpha[i];
   }
 
-  arma::colvec pRow;
-  arma::uword maxIndex = 0;
-
-  for (size_t i = 0; i < predictedLabels.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) predictedLabels.n_cols; ++i)
   {
     probabilities.col(i) /= arma::accu(probabilities.col(i));
-    pRow = probabilities.unsafe_col(i);
-    pRow.max(maxIndex);
-    predictedLabels(i) = maxIndex;
+    predictedLabels(i) = probabilities.col(i).index_max();
   }
 }
 
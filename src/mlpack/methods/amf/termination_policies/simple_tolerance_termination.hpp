@@ -107,7 +107,7 @@ class SimpleToleranceTermination
 
     // Increment iteration count.
     iteration++;
-    Log::Info << "Iteration " << iteration << "; residue "
+    MLPACK_LOG(Log::Info) << "Iteration " << iteration << "; residue "
         << ((residueOld - residue) / residueOld) << ".\n";
 
     // If residue tolerance is not satisfied.
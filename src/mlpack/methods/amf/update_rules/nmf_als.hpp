@@ -37,6 +37,10 @@ namespace amf {
  * It uses the least squares projection formula to reduce the error value of
  * \f$ \sqrt{\sum_i \sum_j(V-WH)^2} \f$ by alternately calculating W and H
  * respectively while holding the other matrix constant.
+ *
+ * The least squares problems are solved with a Cholesky factorization of the
+ * r x r Gram matrix of the fixed factor; with a sparse input matrix, only
+ * sparse-dense products with V are needed.
  */
 class NMFALSUpdate
 {
@@ -73,9 +77,8 @@ class NMFALSUpdate
                              arma::mat& W,
                              const arma::mat& H)
   {
-    // The call to inv() sometimes fails; so we are using the psuedoinverse.
-    // W = (inv(H * H.t()) * H * V.t()).t();
-    W = V * H.t() * pinv(H * H.t());
+    // W^T = (H H^T)^{-1} H V^T.
+    W = SolveGram(H * H.t(), (V * H.t()).t()).t();
 
     // Set all negative numbers to machine epsilon.
     for (size_t i = 0; i < W.n_elem; ++i)
@@ -106,7 +109,7 @@ class NMFALSUpdate
                              const arma::mat& W,
                              arma::mat& H)
   {
-    H = pinv(W.t() * W) * W.t() * V;
+    H = SolveGram(W.t() * W, W.t() * V);
 
     // Set all negative numbers to 0.
     for (size_t i = 0; i < H.n_elem; ++i)
@@ -121,6 +124,28 @@ class NMFALSUpdate
   //! Serialize the object (in this case, there is nothing to serialize).
   template<typename Archive>
   void serialize(Archive& /* ar */, const uint32_t /* version */) { }
+
+ private:
+  /**
+   * Solve G X = B for the r x r Gram matrix G of the fixed factor.  G is
+   * symmetric positive semidefinite, so it is solved with a Cholesky
+   * factorization G = R^T R and two triangular solves; the pseudoinverse is
+   * only used if G is singular.
+   *
+   * @param gram Gram matrix G.
+   * @param rhs Right-hand side B.
+   */
+  static arma::mat SolveGram(const arma::mat& gram, const arma::mat& rhs)
+  {
+    arma::mat r;
+    if (arma::chol(r, gram))
+    {
+      const arma::mat y = arma::solve(arma::trimatl(r.t()), rhs);
+      return arma::solve(arma::trimatu(r), y);
+    }
+
+    return arma::pinv(gram) * rhs;
+  }
 }; // class NMFALSUpdate
 
 } // namespace amf
@@ -35,6 +35,10 @@ namespace amf {
  * This is a multiplicative rule that ensures that the Frobenius norm
  * \f$ \sqrt{\sum_i \sum_j(V-WH)^2} \f$ is non-increasing between subsequent
  * iterations. Both of the update rules for W and H are defined in this file.
+ *
+ * The denominators are computed with the r x r Gram matrices H H^T and W^T W,
+ * so the dense product W H is never formed, and sparse matrices V are only
+ * used in sparse-dense products.
  */
 class NMFMultiplicativeDistanceUpdate
 {
@@ -71,7 +75,9 @@ class NMFMultiplicativeDistanceUpdate
                              arma::mat& W,
                              const arma::mat& H)
   {
-    W = (W % (V * H.t())) / (W * H * H.t());
+    // Multiply by the r x r matrix H H^T first, so that the m x n product W H
+    // is never formed.
+    W = (W % (V * H.t())) / (W * (H * H.t()));
   }
 
   /**
@@ -93,7 +99,8 @@ class NMFMultiplicativeDistanceUpdate
                              const arma::mat& W,
                              arma::mat& H)
   {
-    H = (H % (W.t() * V)) / (W.t() * W * H);
+    // As above, W^T W is r x r.
+    H = (H % (W.t() * V)) / ((W.t() * W) * H);
   }
 
   //! Serialize the object (in this case, there is nothing to serialize).
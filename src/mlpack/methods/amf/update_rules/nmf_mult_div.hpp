@@ -41,9 +41,10 @@ namespace amf {
  * is non-increasing between subsequent iterations. Both of the update rules
  * for W and H are defined in this file.
  *
- * This set of update rules is not meant to work with sparse matrices.  Using
- * sparse matrices often causes NaNs in the output, so other choices of update
- * rules are better in that situation.
+ * Both rules only need the quotient V / (W H) elementwise, which is zero
+ * wherever V is zero.  For sparse matrices, W H is therefore only evaluated at
+ * the nonzero elements of V (in parallel over the columns), and never formed
+ * as a dense matrix.
  */
 class NMFMultiplicativeDivergenceUpdate
 {
@@ -81,28 +82,10 @@ class NMFMultiplicativeDivergenceUpdate
                              arma::mat& W,
                              const arma::mat& H)
   {
-    // Simple implementation left in the header file.
-    arma::mat t1;
-    arma::rowvec t2;
-
-    t1 = W * H;
-    for (size_t i = 0; i < W.n_rows; ++i)
-    {
-      for (size_t j = 0; j < W.n_cols; ++j)
-      {
-        // Writing this as a single expression does not work as of Armadillo
-        // 3.920.  This should be fixed in a future release, and then the code
-        // below can be fixed.
-        // t2 = H.row(j) % V.row(i) / t1.row(i);
-        t2.set_size(H.n_cols);
-        for (size_t k = 0; k < t2.n_elem; ++k)
-        {
-          t2(k) = H(j, k) * V(i, k) / t1(i, k);
-        }
-
-        W(i, j) = W(i, j) * sum(t2) / sum(H.row(j));
-      }
-    }
+    // The numerator is Q H^T, with Q = V / (W H) elementwise.
+    const arma::rowvec hSums = arma::sum(H, 1).t();
+    W %= Quotient(V, W, H) * H.t();
+    W.each_row() /= hSums;
   }
 
   /**
@@ -122,36 +105,56 @@ class NMFMultiplicativeDivergenceUpdate
    */
   template<typename MatType>
   inline static void HUpdate(const MatType& V,
+                             const arma::mat& W,
+                             arma::mat& H)
+  {
+    // The numerator is W^T Q, with Q = V / (W H) elementwise.
+    const arma::vec wSums = arma::sum(W, 0).t();
+    H %= W.t() * Quotient(V, W, H);
+    H.each_col() /= wSums;
+  }
+
+  //! Serialize the object (in this case, there is nothing to serialize).
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const uint32_t /* version */) { }
+
+ private:
+  /**
+   * Compute V / (W H) elementwise, for a dense V.
+   */
+  static arma::mat Quotient(const arma::mat& V,
                             const arma::mat& W,
-                            arma::mat& H)
+                            const arma::mat& H)
+  {
+    return V / (W * H);
+  }
+
+  /**
+   * Compute V / (W H) elementwise, for a sparse V.  The quotient is zero
+   * wherever V is zero, so W H is only evaluated at the nonzero elements of V,
+   * and the columns are handled in parallel.
+   */
+  static arma::sp_mat Quotient(const arma::sp_mat& V,
+                               const arma::mat& W,
+                               const arma::mat& H)
   {
-    // Simple implementation left in the header file.
-    arma::mat t1;
-    arma::colvec t2;
+    V.sync();
+    const arma::mat wt = W.t();
+    arma::sp_mat q(V);
+    q.sync();
 
-    t1 = W * H;
-    for (size_t i = 0; i < H.n_rows; ++i)
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (omp_size_t j = 0; j < (omp_size_t) V.n_cols; ++j)
     {
-      for (size_t j = 0; j < H.n_cols; ++j)
+      for (size_t k = V.col_ptrs[j]; k < V.col_ptrs[j + 1]; ++k)
       {
-        // Writing this as a single expression does not work as of Armadillo
-        // 3.920.  This should be fixed in a future release, and then the code
-        // below can be fixed.
-        // t2 = W.col(i) % V.col(j) / t1.col(j);
-        t2.set_size(W.n_rows);
-        for (size_t k = 0; k < t2.n_elem; ++k)
-        {
-          t2(k) = W(k, i) * V(k, j) / t1(k, j);
-        }
-
-        H(i, j) = H(i, j) * sum(t2) / sum(W.col(i));
+        arma::access::rw(q.values[k]) = V.values[k] /
+            arma::dot(wt.col(V.row_indices[k]), H.col(j));
       }
     }
-  }
 
-  //! Serialize the object (in this case, there is nothing to serialize).
-  template<typename Archive>
-  void serialize(Archive& /* ar */, const uint32_t /* version */) { }
+    return q;
+  }
 };
 
 } // namespace amf
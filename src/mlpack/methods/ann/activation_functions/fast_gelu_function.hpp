@@ -0,0 +1,97 @@
+/**
+ * @file methods/ann/activation_functions/fast_gelu_function.hpp
+ *
+ * Definition and implementation of the Gaussian Error Linear Unit (GELU)
+ * function computed with a vectorizable approximation of tanh().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_FAST_GELU_FUNCTION_HPP
+#define MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_FAST_GELU_FUNCTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "fast_math.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The GELU function (see GELUFunction), computed with FastTanh() instead of
+ * std::tanh() and std::cosh().  The results match GELUFunction up to a
+ * relative error of about 1e-13.
+ *
+ * @f{eqnarray*}{
+ * f(x) = 0.5 * x * {1 + tanh[(2/pi)^(1/2) * (x + 0.044715 * x^3)]} \\
+ * f'(x) = 0.5 * tanh(0.0356774 * x^3) + 0.797885 * x) +
+ *         (0.0535161x^3 + 0.398942 * x) *
+ *         sech^2(0.0356774 * x^3+0.797885 * x) + 0.5\\
+ * @f}
+ *
+ * The derivative uses sech^2(z) = 1 - tanh^2(z), so it needs a single tanh
+ * per element.
+ */
+class FastGELUFunction
+{
+ public:
+  /**
+   * Computes the GELU function.
+   *
+   * @param x Input data.
+   * @return f(x).
+   */
+  static double Fn(const double x)
+  {
+    return 0.5 * x * (1 + FastTanh(std::sqrt(2 / M_PI) *
+        (x + 0.044715 * x * x * x)));
+  }
+
+  /**
+   * Computes the GELU function.
+   *
+   * @param x Input data (a dense matrix or vector).
+   * @param y The resulting output activation.
+   */
+  template<typename InputVecType, typename OutputVecType>
+  static void Fn(const InputVecType& x, OutputVecType& y)
+  {
+    OutputVecType t = std::sqrt(2 / M_PI) * (x + 0.044715 * arma::pow(x, 3));
+    FastTanh(t.memptr(), t.memptr(), t.n_elem);
+    y = 0.5 * x % (1 + t);
+  }
+
+  /**
+   * Computes the first derivative of the GELU function.
+   *
+   * @param y Input data.
+   * @return f'(x)
+   */
+  static double Deriv(const double y)
+  {
+    const double t = FastTanh(0.0356774 * y * y * y + 0.797885 * y);
+    return 0.5 * t + (0.0535161 * y * y * y + 0.398942 * y) * (1 - t * t) +
+        0.5;
+  }
+
+  /**
+   * Computes the first derivatives of the GELU function.
+   *
+   * @param y Input data (a dense matrix or vector).
+   * @param x The resulting derivatives.
+   */
+  template<typename InputVecType, typename OutputVecType>
+  static void Deriv(const InputVecType& y, OutputVecType& x)
+  {
+    OutputVecType t = 0.0356774 * arma::pow(y, 3) + 0.797885 * y;
+    FastTanh(t.memptr(), t.memptr(), t.n_elem);
+    x = 0.5 * t + (0.0535161 * arma::pow(y, 3) + 0.398942 * y) %
+        (1 - arma::square(t)) + 0.5;
+  }
+}; // class FastGELUFunction
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,112 @@
+/**
+ * @file methods/ann/activation_functions/fast_logistic_function.hpp
+ *
+ * Definition and implementation of the logistic function computed with a
+ * vectorizable approximation of exp().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_FAST_LOGISTIC_FUNCTION_HPP
+#define MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_FAST_LOGISTIC_FUNCTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "fast_math.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The logistic function, computed with FastExp() instead of std::exp().  The
+ * results match LogisticFunction up to a relative error of about 1e-15, and
+ * the function over a matrix is a single loop that the compiler vectorizes.
+ *
+ * @f{eqnarray*}{
+ * f(x) &=& \frac{1}{1 + e^{-x}} \\
+ * f'(x) &=& f(x) * (1 - f(x)) \\
+ * f^{-1}(y) &=& ln(\frac{y}{1-y})
+ * @f}
+ *
+ * As for LogisticFunction, the derivative is computed from the output f(x),
+ * so the forward pass already holds everything the backward pass needs.
+ */
+class FastLogisticFunction
+{
+ public:
+  /**
+   * Computes the logistic function.
+   *
+   * @param x Input data.
+   * @return f(x).
+   */
+  static double Fn(const double x)
+  {
+    return 1.0 / (1.0 + FastExp(-x));
+  }
+
+  /**
+   * Computes the logistic function.
+   *
+   * @param x Input data (a dense matrix or vector).
+   * @param y The resulting output activation.
+   */
+  template<typename InputVecType, typename OutputVecType>
+  static void Fn(const InputVecType& x, OutputVecType& y)
+  {
+    y.set_size(arma::size(x));
+    FastLogistic(x.memptr(), y.memptr(), x.n_elem);
+  }
+
+  /**
+   * Computes the first derivative of the logistic function.
+   *
+   * @param y Input activation.
+   * @return f'(x)
+   */
+  static double Deriv(const double y)
+  {
+    return y * (1.0 - y);
+  }
+
+  /**
+   * Computes the first derivatives of the logistic function.
+   *
+   * @param y Input activations.
+   * @param x The resulting derivatives.
+   */
+  template<typename InputVecType, typename OutputVecType>
+  static void Deriv(const InputVecType& y, OutputVecType& x)
+  {
+    x = y % (1.0 - y);
+  }
+
+  /**
+   * Computes the inverse of the logistic function.
+   *
+   * @param y Input data.
+   * @return f^{-1}(y)
+   */
+  static double Inv(const double y)
+  {
+    return arma::trunc_log(y / (1 - y));
+  }
+
+  /**
+   * Computes the inverse of the logistic function.
+   *
+   * @param y Input data.
+   * @param x The resulting inverse of the input data.
+   */
+  template<typename InputVecType, typename OutputVecType>
+  static void Inv(const InputVecType& y, OutputVecType& x)
+  {
+    x = arma::trunc_log(y / (1 - y));
+  }
+}; // class FastLogisticFunction
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
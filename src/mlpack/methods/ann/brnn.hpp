@@ -187,6 +187,35 @@ class BRNN
                arma::cube& results,
                const size_t batchSize = 256);
 
+  /**
+   * Predict the responses to sequences of different lengths.  The sequences
+   * are held in the predictors as for Predict(), each followed by padding up
+   * to the number of slices of the predictors; the padding is never given to
+   * the network.  The backward network reads each sequence from its own last
+   * step, so that its state is not affected by the padding either.  The
+   * sequences are sorted by length and predicted in batches of sequences of
+   * similar lengths, each for the number of steps of its longest sequence
+   * only.
+   *
+   * The responses have the same format as the predictors, and are zero after
+   * the end of each sequence.  If the network predicts only the last element
+   * of the sequence (see the constructor), the responses have one slice, that
+   * holds the response to the last step of each sequence.
+   *
+   * The recurrent layers of the networks must reset their state with
+   * ResetCell() (as LSTM, FastLSTM, FusedLSTM and GRU do), and hold at least
+   * as many steps as the longest sequence.
+   *
+   * @param predictors Input predictors, padded after the end of each sequence.
+   * @param results Matrix to put output predictions of responses into.
+   * @param lengths The number of steps of each sequence.
+   * @param batchSize Number of sequences to predict at once.
+   */
+  void Predict(arma::cube predictors,
+               arma::cube& results,
+               const arma::Row<size_t>& lengths,
+               const size_t batchSize = 256);
+
   /**
    * Evaluate the bidirectional recurrent neural network with the given
    * parameters. This function is usually called by the optimizer to train
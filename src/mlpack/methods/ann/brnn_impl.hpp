@@ -25,6 +25,7 @@
 #include "visitor/gradient_visitor.hpp"
 #include "visitor/weight_set_visitor.hpp"
 #include "visitor/run_set_visitor.hpp"
+#include "util/sequence_batches.hpp"
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -257,6 +258,114 @@ void BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
   }
 }
 
+template<typename OutputLayerType, typename MergeLayerType,
+         typename MergeOutputType, typename InitializationRuleType,
+         typename... CustomLayers>
+void BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
+    InitializationRuleType, CustomLayers...>::Predict(
+    arma::cube predictors,
+    arma::cube& results,
+    const arma::Row<size_t>& lengths,
+    const size_t batchSize)
+{
+  const arma::uvec order = SortSequenceLengths(predictors, lengths,
+      "BRNN::Predict()");
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+  if (parameter.is_empty())
+  {
+    ResetParameters();
+  }
+
+  results.reset();
+  std::vector<arma::mat> forwardOutputs, backwardOutputs;
+  arma::mat input, forwardInput, backwardInput;
+  for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols - begin));
+
+    // The first sequence of the batch is the longest one; the batch is done
+    // once it ends.
+    const size_t steps = lengths[order[begin]];
+    forwardRNN.ResetCells(steps);
+    backwardRNN.ResetCells(steps);
+
+    // Forward both RNN's; the backward RNN reads each sequence backwards from
+    // its own last step.
+    forwardInput.set_size(predictors.n_rows, effectiveBatchSize);
+    backwardInput.set_size(predictors.n_rows, effectiveBatchSize);
+    forwardOutputs.resize(steps);
+    backwardOutputs.resize(steps);
+    for (size_t seqNum = 0; seqNum < steps; ++seqNum)
+    {
+      GatherSequenceStep(predictors, lengths, order, begin, seqNum, false,
+          forwardInput);
+      GatherSequenceStep(predictors, lengths, order, begin, seqNum, true,
+          backwardInput);
+      forwardRNN.Forward(forwardInput);
+      backwardRNN.Forward(backwardInput);
+
+      forwardOutputs[seqNum] = boost::apply_visitor(outputParameterVisitor,
+          forwardRNN.network.back());
+      backwardOutputs[seqNum] = boost::apply_visitor(outputParameterVisitor,
+          backwardRNN.network.back());
+    }
+
+    // Merge the outputs of both RNN's for each step; the output of the
+    // backward RNN for step seqNum of a sequence of length l was computed at
+    // its step l - seqNum - 1.
+    for (size_t seqNum = 0; seqNum < steps; ++seqNum)
+    {
+      arma::mat& backwardOutput = boost::apply_visitor(outputParameterVisitor,
+          backwardRNN.network.back());
+      backwardOutput.zeros(backwardOutputs[0].n_rows, effectiveBatchSize);
+      for (size_t i = 0; i < effectiveBatchSize; ++i)
+      {
+        const size_t length = lengths[order[begin + i]];
+        if (seqNum < length)
+        {
+          backwardOutput.col(i) =
+              backwardOutputs[length - seqNum - 1].col(i);
+        }
+      }
+      boost::apply_visitor(outputParameterVisitor,
+          forwardRNN.network.back()) = forwardOutputs[seqNum];
+
+      boost::apply_visitor(ForwardVisitor(input,
+          boost::apply_visitor(outputParameterVisitor, mergeLayer)),
+          mergeLayer);
+      boost::apply_visitor(ForwardVisitor(
+          boost::apply_visitor(outputParameterVisitor, mergeLayer),
+          boost::apply_visitor(outputParameterVisitor, mergeOutput)),
+          mergeOutput);
+
+      const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+          mergeOutput);
+      if (results.is_empty())
+      {
+        results.zeros(output.n_rows, predictors.n_cols,
+            single ? 1 : predictors.n_slices);
+      }
+
+      // Only keep the responses to the steps of the sequences that have not
+      // ended.
+      for (size_t i = 0; i < effectiveBatchSize; ++i)
+      {
+        const size_t sequence = order[begin + i];
+        if (!single && seqNum < lengths[sequence])
+          results.slice(seqNum).col(sequence) = output.col(i);
+        else if (single && seqNum + 1 == lengths[sequence])
+          results.slice(0).col(sequence) = output.col(i);
+      }
+    }
+  }
+}
+
 template<typename OutputLayerType, typename MergeLayerType,
          typename MergeOutputType, typename InitializationRuleType,
          typename... CustomLayers>
@@ -0,0 +1,427 @@
+/**
+ * @file methods/ann/convolution_rules/im2col_convolution.hpp
+ *
+ * Implementation of the convolution through im2col and matrix multiplication.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution by lowering it to a matrix
+ * multiplication: each patch of the input that the filter is applied to is
+ * copied into one column of a matrix (im2col), and the convolution is the
+ * product of that matrix with the filter.  For a single input and filter, as
+ * used through Convolution(), this is a matrix-vector product; the benefit
+ * comes from the batched functions Im2Col() and Col2Im(), which the
+ * Convolution layer uses when it is given this rule: then the convolutions of
+ * all input maps, output maps and points of a batch are computed with one
+ * large matrix multiplication (BLAS GEMM) in the forward pass, in the
+ * backward pass and for the gradient of the weights, instead of a scalar loop
+ * for each pair of input and output maps.
+ *
+ * The single-input Convolution() functions give the same results as
+ * NaiveConvolution with the same arguments.  With stride 1, the layer gives
+ * the same results with this rule as with NaiveConvolution; since the batched
+ * gradient computes its own patches, the rule should be used for all three
+ * passes of the layer (or at least for the forward and the gradient pass).
+ *
+ * @code
+ * Convolution<Im2ColConvolution<ValidConvolution>,
+ *             Im2ColConvolution<FullConvolution>,
+ *             Im2ColConvolution<ValidConvolution>> layer(1, 8, 3, 3, 1, 1, 1,
+ *     1, 28, 28);
+ * @endcode
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution
+{
+ public:
+  /*
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    const size_t outputRows = (input.n_rows - (filter.n_rows - 1) *
+        dilationW - 1) / dW + 1;
+    const size_t outputCols = (input.n_cols - (filter.n_cols - 1) *
+        dilationH - 1) / dH + 1;
+
+    // Each column holds the input elements that are multiplied with the
+    // elements of the filter (in the order of the filter) for one output
+    // element.  The indexing is the same as in NaiveConvolution.
+    arma::Mat<eT> columns(filter.n_elem, outputRows * outputCols);
+    eT* columnPtr = columns.memptr();
+    for (size_t j = 0; j < outputCols; ++j)
+    {
+      for (size_t i = 0; i < outputRows; ++i)
+      {
+        for (size_t kj = 0; kj < filter.n_cols; ++kj)
+        {
+          const eT* inputPtr = input.colptr(kj * dilationW + j * dW) + i * dH;
+          for (size_t ki = 0; ki < filter.n_rows; ++ki, ++columnPtr,
+              inputPtr += dilationH)
+            *columnPtr = *inputPtr;
+        }
+      }
+    }
+
+    output.set_size(outputRows, outputCols);
+    arma::Col<eT> outputVec(output.memptr(), output.n_elem, false, true);
+    outputVec = columns.t() * arma::vectorise(filter);
+  }
+
+  /*
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    // The input is padded in the same way as by NaiveConvolution.
+    size_t outputRows = (input.n_rows - 1) * dW + 2 * (filter.n_rows - 1)
+        * dilationW + 1;
+    size_t outputCols = (input.n_cols - 1) * dH + 2 * (filter.n_cols - 1)
+        * dilationH + 1;
+
+    for (size_t i = 0; i < dW; ++i)
+    {
+      if (((((i + outputRows - 2 * (filter.n_rows - 1) * dilationW - 1) % dW)
+          + dW) % dW) == i)
+      {
+        outputRows += i;
+        break;
+      }
+    }
+    for (size_t i = 0; i < dH; ++i)
+    {
+      if (((((i + outputCols - 2 * (filter.n_cols - 1) * dilationH - 1) % dH)
+          + dH) % dH) == i)
+      {
+        outputCols += i;
+        break;
+      }
+    }
+
+    arma::Mat<eT> inputPadded = arma::zeros<arma::Mat<eT> >(outputRows,
+        outputCols);
+    inputPadded.submat((filter.n_rows - 1) * dilationW, (filter.n_cols - 1)
+        * dilationH, (filter.n_rows - 1) * dilationW + input.n_rows - 1,
+        (filter.n_cols - 1) * dilationH + input.n_cols - 1) = input;
+
+    Im2ColConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output, 1, 1, dilationW, dilationH);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0),
+        filter.slice(0), convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        filter.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /**
+   * Copy the patches of a batch of inputs with several maps into the columns
+   * of a matrix.  Each column of the input holds the inSize maps of one point
+   * (each map is inputWidth x inputHeight, column-major), padded implicitly
+   * with zeros.  Row m * kernelWidth * kernelHeight + kj * kernelWidth + ki of
+   * the result holds element (ki, kj) of the patches of map m, and column
+   * b * outputWidth * outputHeight + j * outputWidth + i holds the patch of
+   * point b for output element (i, j), so that the kernels of the
+   * Convolution layer (viewed as a matrix with one column for each output
+   * map) can be applied to all patches with one matrix multiplication.
+   *
+   * @param input The batch of inputs.
+   * @param inputWidth The width of each input map.
+   * @param inputHeight The height of each input map.
+   * @param inSize The number of input maps.
+   * @param kernelWidth The width of the kernels.
+   * @param kernelHeight The height of the kernels.
+   * @param strideWidth The stride in the x direction.
+   * @param strideHeight The stride in the y direction.
+   * @param padWLeft The padding on the left side.
+   * @param padHTop The padding at the top.
+   * @param outputWidth The width of each output map.
+   * @param outputHeight The height of each output map.
+   * @param columns The matrix of patches (reused if it has the right size).
+   */
+  template<typename eT>
+  static void Im2Col(const arma::Mat<eT>& input,
+                     const size_t inputWidth,
+                     const size_t inputHeight,
+                     const size_t inSize,
+                     const size_t kernelWidth,
+                     const size_t kernelHeight,
+                     const size_t strideWidth,
+                     const size_t strideHeight,
+                     const size_t padWLeft,
+                     const size_t padHTop,
+                     const size_t outputWidth,
+                     const size_t outputHeight,
+                     arma::Mat<eT>& columns)
+  {
+    const size_t mapSize = inputWidth * inputHeight;
+    columns.set_size(kernelWidth * kernelHeight * inSize,
+        outputWidth * outputHeight * input.n_cols);
+
+    eT* columnPtr = columns.memptr();
+    for (size_t b = 0; b < input.n_cols; ++b)
+    {
+      for (size_t j = 0; j < outputHeight; ++j)
+      {
+        for (size_t i = 0; i < outputWidth; ++i)
+        {
+          for (size_t m = 0; m < inSize; ++m)
+          {
+            const eT* map = input.colptr(b) + m * mapSize;
+            for (size_t kj = 0; kj < kernelHeight; ++kj)
+            {
+              const size_t c = j * strideHeight + kj;
+              const bool colInside = (c >= padHTop) &&
+                  (c - padHTop < inputHeight);
+              for (size_t ki = 0; ki < kernelWidth; ++ki, ++columnPtr)
+              {
+                const size_t r = i * strideWidth + ki;
+                *columnPtr = (colInside && r >= padWLeft &&
+                    r - padWLeft < inputWidth) ?
+                    map[(c - padHTop) * inputWidth + r - padWLeft] : 0;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * The transpose of Im2Col(): add each element of the columns to the input
+   * element it was copied from, dropping the elements of the padding.
+   *
+   * @param columns The matrix of patches, as given by Im2Col().
+   * @param inputWidth The width of each input map.
+   * @param inputHeight The height of each input map.
+   * @param inSize The number of input maps.
+   * @param kernelWidth The width of the kernels.
+   * @param kernelHeight The height of the kernels.
+   * @param strideWidth The stride in the x direction.
+   * @param strideHeight The stride in the y direction.
+   * @param padWLeft The padding on the left side.
+   * @param padHTop The padding at the top.
+   * @param outputWidth The width of each output map.
+   * @param outputHeight The height of each output map.
+   * @param output The batch of inputs the columns are accumulated into (set
+   *     to zero first).
+   */
+  template<typename eT>
+  static void Col2Im(const arma::Mat<eT>& columns,
+                     const size_t inputWidth,
+                     const size_t inputHeight,
+                     const size_t inSize,
+                     const size_t kernelWidth,
+                     const size_t kernelHeight,
+                     const size_t strideWidth,
+                     const size_t strideHeight,
+                     const size_t padWLeft,
+                     const size_t padHTop,
+                     const size_t outputWidth,
+                     const size_t outputHeight,
+                     arma::Mat<eT>& output)
+  {
+    const size_t mapSize = inputWidth * inputHeight;
+    const size_t batchSize = columns.n_cols / (outputWidth * outputHeight);
+    output.zeros(mapSize * inSize, batchSize);
+
+    const eT* columnPtr = columns.memptr();
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      for (size_t j = 0; j < outputHeight; ++j)
+      {
+        for (size_t i = 0; i < outputWidth; ++i)
+        {
+          for (size_t m = 0; m < inSize; ++m)
+          {
+            eT* map = output.colptr(b) + m * mapSize;
+            for (size_t kj = 0; kj < kernelHeight; ++kj)
+            {
+              const size_t c = j * strideHeight + kj;
+              const bool colInside = (c >= padHTop) &&
+                  (c - padHTop < inputHeight);
+              for (size_t ki = 0; ki < kernelWidth; ++ki, ++columnPtr)
+              {
+                const size_t r = i * strideWidth + ki;
+                if (colInside && r >= padWLeft && r - padWLeft < inputWidth)
+                  map[(c - padHTop) * inputWidth + r - padWLeft] += *columnPtr;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+};  // class Im2ColConvolution
+
+/**
+ * Whether the given convolution rule is an Im2ColConvolution, so that the
+ * Convolution layer can use the batched functions of the rule.
+ */
+template<typename ConvolutionRule>
+struct IsIm2ColConvolution
+{
+  static const bool value = false;
+};
+
+template<typename BorderMode>
+struct IsIm2ColConvolution<Im2ColConvolution<BorderMode> >
+{
+  static const bool value = true;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,468 @@
+/**
+ * @file methods/ann/convolution_rules/winograd_convolution.hpp
+ *
+ * Implementation of the 3x3 convolution through the Winograd F(2x2, 3x3)
+ * minimal filtering algorithm.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_WINOGRAD_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_WINOGRAD_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+#include "naive_convolution.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution of an input with a 3x3 filter with
+ * the Winograd F(2x2, 3x3) algorithm.  The output is computed in tiles of 2x2
+ * elements; each tile needs a 4x4 tile of the input, which is transformed
+ * (with additions only) together with the filter, multiplied elementwise and
+ * transformed back.  This needs 16 multiplications for each tile instead of
+ * the 36 of the direct convolution.  The transformed filters only depend on
+ * the weights, so they can be computed once with TransformFilters() and
+ * reused, as done by BatchConvolution() and by the Convolution layer.
+ *
+ * Only 3x3 filters with stride 1 and no dilation are supported by the
+ * transform; for every other shape the NaiveConvolution with the same border
+ * mode is used.  The results are the same as those of NaiveConvolution, up to
+ * rounding.
+ *
+ * The Convolution and AtrousConvolution layers use this algorithm for the
+ * forward pass automatically if the forward rule is the default
+ * NaiveConvolution<ValidConvolution> (or a WinogradConvolution) and the
+ * kernel is 3x3 with stride 1 (and no dilation).
+ *
+ * For more information, see the following paper.
+ *
+ * @code
+ * @inproceedings{Lavin2016,
+ *   title     = {Fast Algorithms for Convolutional Neural Networks},
+ *   author    = {Andrew Lavin and Scott Gray},
+ *   booktitle = {IEEE Conference on Computer Vision and Pattern Recognition
+ *                (CVPR)},
+ *   pages     = {4013--4021},
+ *   year      = {2016}
+ * }
+ * @endcode
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class WinogradConvolution
+{
+ public:
+  /*
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    if (!Supported(filter.n_rows, filter.n_cols, dW, dH, dilationW,
+        dilationH) || input.n_rows < 3 || input.n_cols < 3)
+    {
+      NaiveConvolution<ValidConvolution>::Convolution(input, filter, output,
+          dW, dH, dilationW, dilationH);
+      return;
+    }
+
+    const arma::Cube<eT> filterCube(const_cast<eT*>(filter.memptr()), 3, 3,
+        1, false, true);
+    arma::Mat<eT> transformedFilter;
+    TransformFilters(filterCube, transformedFilter);
+
+    const arma::Cube<eT> inputCube(const_cast<eT*>(input.memptr()),
+        input.n_rows, input.n_cols, 1, false, true);
+    arma::Cube<eT> outputCube;
+    BatchConvolution(inputCube, transformedFilter, 1, outputCube);
+    output = outputCube.slice(0);
+  }
+
+  /*
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    if (!Supported(filter.n_rows, filter.n_cols, dW, dH, dilationW,
+        dilationH))
+    {
+      NaiveConvolution<FullConvolution>::Convolution(input, filter, output,
+          dW, dH, dilationW, dilationH);
+      return;
+    }
+
+    // With stride 1, the full convolution is the valid convolution of the
+    // input padded with two zeros on each side.
+    arma::Mat<eT> inputPadded = arma::zeros<arma::Mat<eT> >(input.n_rows + 4,
+        input.n_cols + 4);
+    inputPadded.submat(2, 2, input.n_rows + 1, input.n_cols + 1) = input;
+
+    WinogradConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    WinogradConvolution<BorderMode>::Convolution(input.slice(0),
+        filter.slice(0), convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      WinogradConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    WinogradConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        filter.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; ++i)
+    {
+      WinogradConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    WinogradConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      WinogradConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /**
+   * Return whether the Winograd transform can be used for a filter of the
+   * given size with the given stride and dilation.
+   */
+  static bool Supported(const size_t filterRows,
+                        const size_t filterCols,
+                        const size_t dW = 1,
+                        const size_t dH = 1,
+                        const size_t dilationW = 1,
+                        const size_t dilationH = 1)
+  {
+    return filterRows == 3 && filterCols == 3 && dW == 1 && dH == 1 &&
+        dilationW == 1 && dilationH == 1;
+  }
+
+  /**
+   * Transform each 3x3 slice of the given filters into the 4x4 Winograd
+   * domain (G g G^T).  Column i of the result holds the transform of slice i,
+   * in column-major order.
+   *
+   * @param filters The 3x3 filters.
+   * @param transformed The transformed filters (16 x filters.n_slices).
+   */
+  template<typename eT>
+  static void TransformFilters(const arma::Cube<eT>& filters,
+                               arma::Mat<eT>& transformed)
+  {
+    if (filters.n_rows != 3 || filters.n_cols != 3)
+    {
+      throw std::invalid_argument("WinogradConvolution::TransformFilters(): "
+          "only 3x3 filters are supported");
+    }
+
+    transformed.set_size(16, filters.n_slices);
+    for (size_t s = 0; s < filters.n_slices; ++s)
+    {
+      const eT* g = filters.slice_memptr(s);
+      eT* u = transformed.colptr(s);
+
+      // t = G g (4x3), along the rows of each column.
+      eT t[12];
+      for (size_t c = 0; c < 3; ++c)
+      {
+        const eT* gc = g + 3 * c;
+        t[4 * c] = gc[0];
+        t[4 * c + 1] = (gc[0] + gc[1] + gc[2]) / 2;
+        t[4 * c + 2] = (gc[0] - gc[1] + gc[2]) / 2;
+        t[4 * c + 3] = gc[2];
+      }
+
+      // u = t G^T (4x4), along the columns of each row.
+      for (size_t r = 0; r < 4; ++r)
+      {
+        u[r] = t[r];
+        u[r + 4] = (t[r] + t[r + 4] + t[r + 8]) / 2;
+        u[r + 8] = (t[r] - t[r + 4] + t[r + 8]) / 2;
+        u[r + 12] = t[r + 8];
+      }
+    }
+  }
+
+  /**
+   * Compute the valid convolution (stride 1) of a batch of inputs with
+   * several maps with the transformed 3x3 filters of several output maps.
+   * Slice b * inSize + m of the input is map m of point b; column
+   * o * inSize + m of the transformed filters is the filter from input map m
+   * to output map o (this is the layout of the Convolution layer), and slice
+   * b * outSize + o of the output is output map o of point b.  The output is
+   * overwritten (not accumulated); it is only reallocated if it does not have
+   * the right size already.
+   *
+   * @param input The input maps.
+   * @param transformedFilters The filters, as given by TransformFilters().
+   * @param inSize The number of input maps.
+   * @param output The output maps.
+   */
+  template<typename eT>
+  static void BatchConvolution(const arma::Cube<eT>& input,
+                               const arma::Mat<eT>& transformedFilters,
+                               const size_t inSize,
+                               arma::Cube<eT>& output)
+  {
+    const size_t outSize = transformedFilters.n_cols / inSize;
+    const size_t batchSize = input.n_slices / inSize;
+    const size_t outputRows = input.n_rows - 2;
+    const size_t outputCols = input.n_cols - 2;
+    if (output.n_rows != outputRows || output.n_cols != outputCols ||
+        output.n_slices != outSize * batchSize)
+      output.set_size(outputRows, outputCols, outSize * batchSize);
+
+    // The transformed input tiles of all input maps.
+    arma::Mat<eT> transformedInput(16, inSize);
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      for (size_t j = 0; j < outputCols; j += 2)
+      {
+        for (size_t i = 0; i < outputRows; i += 2)
+        {
+          for (size_t m = 0; m < inSize; ++m)
+          {
+            TransformInputTile(input.slice_memptr(b * inSize + m),
+                input.n_rows, input.n_cols, i, j, transformedInput.colptr(m));
+          }
+
+          for (size_t o = 0; o < outSize; ++o)
+          {
+            eT product[16] = { 0 };
+            const eT* u = transformedFilters.colptr(o * inSize);
+            const eT* v = transformedInput.memptr();
+            for (size_t m = 0; m < inSize; ++m, u += 16, v += 16)
+            {
+              for (size_t k = 0; k < 16; ++k)
+                product[k] += u[k] * v[k];
+            }
+
+            eT* outputMap = output.slice_memptr(b * outSize + o);
+            InverseTransformTile(product, outputMap, outputRows, outputCols,
+                i, j);
+          }
+        }
+      }
+    }
+  }
+
+ private:
+  /**
+   * Transform the 4x4 input tile whose upper left element is (i, j) into the
+   * Winograd domain (B^T d B); elements outside of the map are zero.
+   */
+  template<typename eT>
+  static void TransformInputTile(const eT* map,
+                                 const size_t rows,
+                                 const size_t cols,
+                                 const size_t i,
+                                 const size_t j,
+                                 eT* v)
+  {
+    eT d[16];
+    for (size_t c = 0; c < 4; ++c)
+    {
+      for (size_t r = 0; r < 4; ++r)
+      {
+        d[r + 4 * c] = (i + r < rows && j + c < cols) ?
+            map[(j + c) * rows + i + r] : 0;
+      }
+    }
+
+    // t = B^T d, along the rows of each column.
+    eT t[16];
+    for (size_t c = 0; c < 4; ++c)
+    {
+      const eT* dc = d + 4 * c;
+      t[4 * c] = dc[0] - dc[2];
+      t[4 * c + 1] = dc[1] + dc[2];
+      t[4 * c + 2] = dc[2] - dc[1];
+      t[4 * c + 3] = dc[1] - dc[3];
+    }
+
+    // v = t B, along the columns of each row.
+    for (size_t r = 0; r < 4; ++r)
+    {
+      v[r] = t[r] - t[r + 8];
+      v[r + 4] = t[r + 4] + t[r + 8];
+      v[r + 8] = t[r + 8] - t[r + 4];
+      v[r + 12] = t[r + 4] - t[r + 12];
+    }
+  }
+
+  /**
+   * Transform the 4x4 product back (A^T m A) and store the 2x2 output tile
+   * whose upper left element is (i, j), dropping elements outside of the map.
+   */
+  template<typename eT>
+  static void InverseTransformTile(const eT* m,
+                                   eT* map,
+                                   const size_t rows,
+                                   const size_t cols,
+                                   const size_t i,
+                                   const size_t j)
+  {
+    // t = A^T m (2x4), along the rows of each column.
+    eT t[8];
+    for (size_t c = 0; c < 4; ++c)
+    {
+      const eT* mc = m + 4 * c;
+      t[2 * c] = mc[0] + mc[1] + mc[2];
+      t[2 * c + 1] = mc[1] - mc[2] - mc[3];
+    }
+
+    // y = t A (2x2), along the columns of each row.
+    for (size_t r = 0; r < 2 && i + r < rows; ++r)
+    {
+      map[j * rows + i + r] = t[r] + t[r + 2] + t[r + 4];
+      if (j + 1 < cols)
+        map[(j + 1) * rows + i + r] = t[r + 2] - t[r + 4] - t[r + 6];
+    }
+  }
+};  // class WinogradConvolution
+
+/**
+ * Whether the given convolution rule is a WinogradConvolution.
+ */
+template<typename ConvolutionRule>
+struct IsWinogradConvolution
+{
+  static const bool value = false;
+};
+
+template<typename BorderMode>
+struct IsWinogradConvolution<WinogradConvolution<BorderMode> >
+{
+  static const bool value = true;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,172 @@
+/**
+ * @file methods/ann/data_parallel_ffn.hpp
+ *
+ * Definition of the DataParallelFFN class, which trains an FFN by splitting
+ * each minibatch over thread-local replicas of the network.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_DATA_PARALLEL_FFN_HPP
+#define MLPACK_METHODS_ANN_DATA_PARALLEL_FFN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "ffn.hpp"
+#include "visitor/deterministic_set_visitor.hpp"
+#include "visitor/reset_visitor.hpp"
+#include "visitor/weight_set_visitor.hpp"
+#include "util/check_input_shape.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * DataParallelFFN trains an FFN with data parallelism.  When FFN::Train() is
+ * used, the gradient of each minibatch is computed by one chain of calls, and
+ * the only parallelism is that of the BLAS library inside the layers, which is
+ * small for narrow networks.  DataParallelFFN instead holds one replica of the
+ * network for each thread.  The layers of all replicas use the parameters of
+ * the trained network itself (there is only one parameter matrix), but each
+ * replica has its own activations, deltas, and gradient.  Each minibatch is
+ * split over the replicas, the replicas compute the gradients of their parts
+ * in parallel (with OpenMP), and the gradients are reduced into the gradient
+ * that is given to the optimizer.
+ *
+ * DataParallelFFN implements the same separable function interface as FFN, so
+ * any ensmallen optimizer can be used unchanged; the trained network gives the
+ * same results (up to floating-point rounding) as if it had been trained with
+ * FFN::Train() with the same optimizer, since the reduction accounts for
+ * output layers that average their loss over the batch (like
+ * MeanSquaredError) as well as for those that sum it (like
+ * NegativeLogLikelihood).  Layers that add a loss of their own (through
+ * Loss()) contribute that loss once for each replica.
+ *
+ * @code
+ * FFN<NegativeLogLikelihood<>> model;
+ * // ... add layers to the model ...
+ *
+ * DataParallelFFN<FFN<NegativeLogLikelihood<>>> parallel(model);
+ * ens::Adam optimizer(0.001, 256);
+ * parallel.Train(trainData, trainLabels, optimizer);
+ * model.Predict(testData, predictions);
+ * @endcode
+ *
+ * @tparam NetworkType The type of the network (an FFN).
+ */
+template<typename NetworkType>
+class DataParallelFFN
+{
+ public:
+  /**
+   * Create the DataParallelFFN object for the given network, which must outlive
+   * it.
+   *
+   * @param network The network to train.
+   * @param numReplicas The number of replicas of the network; 0 uses one
+   *     replica for each OpenMP thread.
+   */
+  DataParallelFFN(NetworkType& network, const size_t numReplicas = 0);
+
+  /**
+   * Train the network on the given data, splitting each minibatch over the
+   * replicas.  If the network has no parameters yet, they are initialized.
+   *
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  double Train(arma::mat predictors,
+               arma::mat responses,
+               OptimizerType& optimizer,
+               CallbackTypes&&... callbacks);
+
+  /**
+   * Evaluate the network on the given batch of the training data, in
+   * deterministic mode.  This is called by the optimizer.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize);
+
+  /**
+   * Evaluate the network and the gradient of the given batch of the training
+   * data, splitting the batch over the replicas.  This is called by the
+   * optimizer.
+   *
+   * @param parameters The parameters of the network.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function gradient evaluation.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              arma::mat& gradient,
+                              const size_t batchSize);
+
+  /**
+   * Evaluate the gradient of the given batch of the training data.  This is
+   * called by the optimizer.
+   *
+   * @param parameters The parameters of the network.
+   * @param begin Index of the starting point to use for objective function
+   *        gradient evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function gradient evaluation.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize);
+
+  //! Shuffle the order of the training data.  This may be called by the
+  //! optimizer.
+  void Shuffle();
+
+  //! Return the number of separable functions (the number of training points).
+  size_t NumFunctions() const { return network.Responses().n_cols; }
+
+  //! Get the number of replicas of the network.
+  size_t NumReplicas() const { return numReplicas; }
+
+ private:
+  //! Create the replicas of the network, and point the layers of each replica
+  //! at the parameters of the network.
+  void CreateReplicas();
+
+  //! The trained network.
+  NetworkType& network;
+  //! The number of replicas of the network.
+  size_t numReplicas;
+  //! The replicas of the network.
+  std::vector<NetworkType> replicas;
+  //! The gradient computed by each replica.
+  std::vector<arma::mat> gradients;
+  //! The output of each replica.
+  std::vector<arma::mat> outputs;
+  //! Whether the output layer averages its loss over the points of a batch.
+  bool meanReduction;
+}; // class DataParallelFFN
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "data_parallel_ffn_impl.hpp"
+
+#endif
@@ -0,0 +1,202 @@
+/**
+ * @file methods/ann/data_parallel_ffn_impl.hpp
+ *
+ * Implementation of the DataParallelFFN class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_DATA_PARALLEL_FFN_IMPL_HPP
+#define MLPACK_METHODS_ANN_DATA_PARALLEL_FFN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "data_parallel_ffn.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename NetworkType>
+DataParallelFFN<NetworkType>::DataParallelFFN(NetworkType& network,
+                                              const size_t numReplicas) :
+    network(network),
+    numReplicas(numReplicas),
+    meanReduction(false)
+{
+  if (this->numReplicas == 0)
+  {
+    #ifdef HAS_OPENMP
+      this->numReplicas = omp_get_max_threads();
+    #else
+      this->numReplicas = 1;
+    #endif
+  }
+}
+
+template<typename NetworkType>
+template<typename OptimizerType, typename... CallbackTypes>
+double DataParallelFFN<NetworkType>::Train(arma::mat predictors,
+                                           arma::mat responses,
+                                           OptimizerType& optimizer,
+                                           CallbackTypes&&... callbacks)
+{
+  CheckInputShape(network.Model(), predictors.n_rows,
+      "DataParallelFFN::Train()");
+
+  if (predictors.n_cols == 0 || predictors.n_cols != responses.n_cols)
+  {
+    throw std::invalid_argument("DataParallelFFN::Train(): the predictors and "
+        "the responses must have the same (positive) number of points");
+  }
+
+  if (network.Parameters().is_empty())
+    network.ResetParameters();
+
+  // The replicas are created before the data is given to the network, so that
+  // they do not copy it.
+  network.Predictors().reset();
+  network.Responses().reset();
+  CreateReplicas();
+
+  network.Predictors() = std::move(predictors);
+  network.Responses() = std::move(responses);
+
+  // Find out whether the loss of the output layer is summed or averaged over
+  // the points of a batch, by evaluating it on one point and on two copies of
+  // the same point.  This determines how the losses and the gradients of the
+  // parts of a batch are combined.
+  const arma::mat x = network.Predictors().col(0);
+  const arma::mat y = network.Responses().col(0);
+  const double single = network.Evaluate(x, y);
+  const double twice = network.Evaluate(arma::join_rows(x, x),
+      arma::join_rows(y, y));
+  meanReduction = std::abs(twice - single) < std::abs(twice - 2 * single);
+
+  const double out = optimizer.Optimize(*this, network.Parameters(),
+      callbacks...);
+
+  Log::Info << "DataParallelFFN::Train(): final objective of trained model is "
+      << out << "." << std::endl;
+  return out;
+}
+
+template<typename NetworkType>
+double DataParallelFFN<NetworkType>::Evaluate(const arma::mat& parameters,
+                                              const size_t begin,
+                                              const size_t batchSize)
+{
+  return network.Evaluate(parameters, begin, batchSize);
+}
+
+template<typename NetworkType>
+double DataParallelFFN<NetworkType>::EvaluateWithGradient(
+    const arma::mat& /* parameters */,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize)
+{
+  const arma::mat& predictors = network.Predictors();
+  const arma::mat& responses = network.Responses();
+
+  // Split the batch into (almost) equal parts, one for each replica.
+  const size_t numParts = std::min(numReplicas, batchSize);
+  std::vector<double> losses(numParts);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t r = 0; r < (omp_size_t) numParts; ++r)
+  {
+    const size_t partBegin = begin + r * batchSize / numParts;
+    const size_t partEnd = begin + (r + 1) * batchSize / numParts;
+
+    // Alias the part of the batch instead of copying it.
+    const arma::mat input(const_cast<double*>(predictors.colptr(partBegin)),
+        predictors.n_rows, partEnd - partBegin, false, true);
+    const arma::mat target(const_cast<double*>(responses.colptr(partBegin)),
+        responses.n_rows, partEnd - partBegin, false, true);
+
+    replicas[r].Forward(input, outputs[r]);
+    losses[r] = replicas[r].Backward(input, target, gradients[r]);
+  }
+
+  // If the output layer averages its loss, the loss and the gradient of each
+  // part are weighted by the size of the part.
+  std::vector<double> weights(numParts, 1.0);
+  double res = 0.0;
+  for (size_t r = 0; r < numParts; ++r)
+  {
+    if (meanReduction)
+    {
+      weights[r] = (double) ((r + 1) * batchSize / numParts -
+          r * batchSize / numParts) / batchSize;
+    }
+
+    res += weights[r] * losses[r];
+  }
+
+  // Reduce the gradients of the replicas in blocks, so that the reduction is
+  // parallel too.
+  gradient.set_size(network.Parameters().n_rows, network.Parameters().n_cols);
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (gradient.n_elem + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t first = b * blockSize;
+    const size_t last = std::min(first + blockSize, (size_t) gradient.n_elem)
+        - 1;
+
+    gradient.rows(first, last) = weights[0] * gradients[0].rows(first, last);
+    for (size_t r = 1; r < numParts; ++r)
+      gradient.rows(first, last) += weights[r] * gradients[r].rows(first, last);
+  }
+
+  return res;
+}
+
+template<typename NetworkType>
+void DataParallelFFN<NetworkType>::Gradient(const arma::mat& parameters,
+                                            const size_t begin,
+                                            arma::mat& gradient,
+                                            const size_t batchSize)
+{
+  EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
+template<typename NetworkType>
+void DataParallelFFN<NetworkType>::Shuffle()
+{
+  network.Shuffle();
+}
+
+template<typename NetworkType>
+void DataParallelFFN<NetworkType>::CreateReplicas()
+{
+  replicas.clear();
+  replicas.reserve(numReplicas);
+  for (size_t r = 0; r < numReplicas; ++r)
+  {
+    replicas.push_back(network);
+
+    // The copied layers use their own copy of the parameters; point them at
+    // the parameters of the network instead, which are updated by the
+    // optimizer.
+    auto& layers = replicas[r].Model();
+    for (size_t i = 0, offset = 0; i < layers.size(); ++i)
+    {
+      offset += boost::apply_visitor(WeightSetVisitor(network.Parameters(),
+          offset), layers[i]);
+      boost::apply_visitor(ResetVisitor(), layers[i]);
+      boost::apply_visitor(DeterministicSetVisitor(false), layers[i]);
+    }
+  }
+
+  gradients.assign(numReplicas, arma::mat());
+  outputs.assign(numReplicas, arma::mat());
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
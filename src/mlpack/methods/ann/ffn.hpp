@@ -22,10 +22,12 @@
 #include "visitor/output_width_visitor.hpp"
 #include "visitor/reset_visitor.hpp"
 #include "visitor/weight_size_visitor.hpp"
+#include "visitor/gradient_ranges_visitor.hpp"
 #include "visitor/copy_visitor.hpp"
 #include "visitor/loss_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "layer_profiler.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
@@ -163,6 +165,34 @@ class FFN
                arma::mat responses,
                CallbackTypes&&... callbacks);
 
+  /**
+   * Train the feedforward network on the given input data using the given
+   * optimizer, with sparse gradients: the gradient given to the optimizer for
+   * each batch is an arma::sp_mat that holds only the columns of the
+   * embedding tables (see Lookup) used by the batch, and the whole gradient of
+   * the other layers.  With a large vocabulary, this avoids clearing and
+   * updating the full embedding tables for each batch, provided the update
+   * policy of the optimizer only touches the nonzero elements of the gradient,
+   * as ens::SGD with ens::VanillaUpdate and ens::SGD with LazyAdamUpdate do.
+   *
+   * This will use the existing model parameters as a starting point for the
+   * optimization.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  double TrainSparse(arma::mat predictors,
+                     arma::mat responses,
+                     OptimizerType& optimizer,
+                     CallbackTypes&&... callbacks);
+
   /**
    * Predict the responses to a given set of predictors. The responses will
    * reflect the output of the given output layer as returned by the
@@ -258,6 +288,26 @@ class FFN
                               GradType& gradient,
                               const size_t batchSize);
 
+  /**
+   * Evaluate the feedforward network with the given parameters, but using only
+   * a number of data points, and store the gradient as a sparse matrix.  Only
+   * the columns of the embedding tables (see Lookup) used by the batch and the
+   * gradient of the other layers are stored, so the cost of the call does not
+   * depend on the size of the embedding tables.  This is used by
+   * TrainSparse().
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param gradient Sparse matrix to output gradient into.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              arma::sp_mat& gradient,
+                              const size_t batchSize);
+
   /**
    * Evaluate the gradient of the feedforward network with the given parameters,
    * and with respect to only a number of points in the dataset. This is useful
@@ -324,6 +374,12 @@ class FFN
   //! Modify the matrix of data points (predictors).
   arma::mat& Predictors() { return predictors; }
 
+  //! Get the profiler of the layers of the network.
+  const LayerProfiler& Profiler() const { return profiler; }
+  //! Modify the profiler of the layers of the network.  Set
+  //! Profiler().Enabled() to record the time spent in each layer.
+  LayerProfiler& Profiler() { return profiler; }
+
   /**
    * Reset the module infomration (weights/parameters).
    */
@@ -415,6 +471,14 @@ class FFN
   template<typename InputType>
   void Gradient(const InputType& input);
 
+  /**
+   * Evaluate the network on the given batch and add its gradient to the given
+   * gradient, which must have the size of the parameters.
+   */
+  double ForwardBackward(const size_t begin,
+                         arma::mat& gradient,
+                         const size_t batchSize);
+
   /**
    * Reset the module status by setting the current deterministic parameter
    * for all modules that implement the Deterministic function.
@@ -506,9 +570,19 @@ class FFN
   //! Locally-stored gradient parameter.
   arma::mat gradient;
 
+  //! The dense gradient used to compute sparse gradients; it is zero between
+  //! the calls.
+  arma::mat denseGradient;
+
+  //! The ranges of denseGradient that may be nonzero after the last batch.
+  std::vector<std::pair<size_t, size_t> > gradientRanges;
+
   //! Locally-stored copy visitor
   CopyVisitor<CustomLayers...> copyVisitor;
 
+  //! The profiler of the layers.
+  LayerProfiler profiler;
+
   // The GAN class should have access to internal members.
   template<
     typename Model,
@@ -127,6 +127,31 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
   return out;
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename OptimizerType, typename... CallbackTypes>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+TrainSparse(arma::mat predictors,
+            arma::mat responses,
+            OptimizerType& optimizer,
+            CallbackTypes&&... callbacks)
+{
+  CheckInputShape<std::vector<LayerTypes<CustomLayers...> > >(network,
+      predictors.n_rows, "FFN<>::TrainSparse()");
+
+  ResetData(std::move(predictors), std::move(responses));
+
+  WarnMessageMaxIterations<OptimizerType>(optimizer, this->predictors.n_cols);
+
+  // Train the model, with sparse gradients.
+  const double out = optimizer.template Optimize<FFN, arma::mat,
+      arma::sp_mat>(*this, parameter, callbacks...);
+
+  Log::Info << "FFN::TrainSparse(): final objective of trained model is "
+      << out << "." << std::endl;
+  return out;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename OptimizerType, typename... CallbackTypes>
@@ -159,6 +184,8 @@ template<typename PredictorsType, typename ResponsesType>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Forward(
     const PredictorsType& inputs, ResponsesType& results)
 {
+  MLPACK_TRACE_SCOPE("ffn_forward");
+
   if (parameter.is_empty())
     ResetParameters();
 
@@ -175,16 +202,22 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Forward(
     const size_t begin,
     const size_t end)
 {
+  MLPACK_TRACE_SCOPE("ffn_forward");
+
+  profiler.Start();
   boost::apply_visitor(ForwardVisitor(inputs,
       boost::apply_visitor(outputParameterVisitor, network[begin])),
       network[begin]);
+  profiler.Stop(begin, LayerProfiler::FORWARD, network[begin]);
 
   for (size_t i = 1; i < end - begin + 1; ++i)
   {
+    profiler.Start();
     boost::apply_visitor(ForwardVisitor(boost::apply_visitor(
         outputParameterVisitor, network[begin + i - 1]),
         boost::apply_visitor(outputParameterVisitor, network[begin + i])),
         network[begin + i]);
+    profiler.Stop(begin + i, LayerProfiler::FORWARD, network[begin + i]);
   }
 
   results = boost::apply_visitor(outputParameterVisitor, network[end]);
@@ -368,6 +401,69 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     gradient.zeros();
   }
 
+  return ForwardBackward(begin, gradient, batchSize);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+EvaluateWithGradient(const arma::mat& /* parameters */,
+                     const size_t begin,
+                     arma::sp_mat& gradient,
+                     const size_t batchSize)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  // The dense gradient is only cleared in the ranges used by the last batch, so
+  // it is allocated once.
+  if (denseGradient.n_rows != parameter.n_rows ||
+      denseGradient.n_cols != parameter.n_cols)
+  {
+    denseGradient = arma::zeros<arma::mat>(parameter.n_rows, parameter.n_cols);
+  }
+
+  const double res = ForwardBackward(begin, denseGradient, batchSize);
+
+  gradientRanges.clear();
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    offset += boost::apply_visitor(GradientRangesVisitor(gradientRanges,
+        offset), network[i]);
+  }
+
+  size_t nnz = 0;
+  for (size_t i = 0; i < gradientRanges.size(); ++i)
+    nnz += gradientRanges[i].second;
+
+  arma::umat locations(2, nnz, arma::fill::zeros);
+  arma::vec values(nnz);
+  size_t k = 0;
+  for (size_t i = 0; i < gradientRanges.size(); ++i)
+  {
+    const size_t first = gradientRanges[i].first;
+    for (size_t j = first; j < first + gradientRanges[i].second; ++j, ++k)
+    {
+      locations(0, k) = j;
+      values[k] = denseGradient[j];
+      denseGradient[j] = 0.0;
+    }
+  }
+
+  gradient = arma::sp_mat(locations, values, parameter.n_rows,
+      parameter.n_cols);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+ForwardBackward(const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize)
+{
   if (this->deterministic)
   {
     this->deterministic = false;
@@ -456,9 +552,11 @@ template<typename InputType>
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Forward(const InputType& input)
 {
+  profiler.Start();
   boost::apply_visitor(ForwardVisitor(input,
       boost::apply_visitor(outputParameterVisitor, network.front())),
       network.front());
+  profiler.Stop(0, LayerProfiler::FORWARD, network.front());
 
   if (!reset)
   {
@@ -484,9 +582,11 @@ void FFN<OutputLayerType, InitializationRuleType,
       boost::apply_visitor(SetInputHeightVisitor(height), network[i]);
     }
 
+    profiler.Start();
     boost::apply_visitor(ForwardVisitor(boost::apply_visitor(
         outputParameterVisitor, network[i - 1]),
         boost::apply_visitor(outputParameterVisitor, network[i])), network[i]);
+    profiler.Stop(i, LayerProfiler::FORWARD, network[i]);
 
     if (!reset)
     {
@@ -512,17 +612,22 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward()
 {
+  profiler.Start();
   boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
       outputParameterVisitor, network.back()), error,
       boost::apply_visitor(deltaVisitor, network.back())), network.back());
+  profiler.Stop(network.size() - 1, LayerProfiler::BACKWARD, network.back());
 
   for (size_t i = 2; i < network.size(); ++i)
   {
+    profiler.Start();
     boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
         outputParameterVisitor, network[network.size() - i]),
         boost::apply_visitor(deltaVisitor, network[network.size() - i + 1]),
         boost::apply_visitor(deltaVisitor, network[network.size() - i])),
         network[network.size() - i]);
+    profiler.Stop(network.size() - i, LayerProfiler::BACKWARD,
+        network[network.size() - i]);
   }
 }
 
@@ -532,19 +637,25 @@ template<typename InputType>
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Gradient(const InputType& input)
 {
+  profiler.Start();
   boost::apply_visitor(GradientVisitor(input,
       boost::apply_visitor(deltaVisitor, network[1])), network.front());
+  profiler.Stop(0, LayerProfiler::GRADIENT, network.front());
 
   for (size_t i = 1; i < network.size() - 1; ++i)
   {
+    profiler.Start();
     boost::apply_visitor(GradientVisitor(boost::apply_visitor(
         outputParameterVisitor, network[i - 1]),
         boost::apply_visitor(deltaVisitor, network[i + 1])), network[i]);
+    profiler.Stop(i, LayerProfiler::GRADIENT, network[i]);
   }
 
+  profiler.Start();
   boost::apply_visitor(GradientVisitor(boost::apply_visitor(
       outputParameterVisitor, network[network.size() - 2]), error),
       network[network.size() - 1]);
+  profiler.Stop(network.size() - 1, LayerProfiler::GRADIENT, network.back());
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -607,6 +718,8 @@ void FFN<OutputLayerType, InitializationRuleType,
   std::swap(inputParameter, network.inputParameter);
   std::swap(outputParameter, network.outputParameter);
   std::swap(gradient, network.gradient);
+  std::swap(denseGradient, network.denseGradient);
+  std::swap(profiler, network.profiler);
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -627,7 +740,8 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     delta(network.delta),
     inputParameter(network.inputParameter),
     outputParameter(network.outputParameter),
-    gradient(network.gradient)
+    gradient(network.gradient),
+    profiler(network.profiler)
 {
   // Build new layers according to source network
   for (size_t i = 0; i < network.network.size(); ++i)
@@ -656,7 +770,8 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     delta(std::move(network.delta)),
     inputParameter(std::move(network.inputParameter)),
     outputParameter(std::move(network.outputParameter)),
-    gradient(std::move(network.gradient))
+    gradient(std::move(network.gradient)),
+    profiler(std::move(network.profiler))
 {
   this->network = std::move(network.network);
 };
@@ -0,0 +1,69 @@
+/**
+ * @file methods/ann/fuse_network.hpp
+ *
+ * Definition of FuseNetwork(), which folds the layers of a trained FFN into
+ * fewer layers for inference.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_FUSE_NETWORK_HPP
+#define MLPACK_METHODS_ANN_FUSE_NETWORK_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "ffn.hpp"
+#include "visitor/copy_visitor.hpp"
+#include "visitor/weight_size_visitor.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Build an equivalent network for inference from a trained network, with
+ * fewer layers and fewer passes over memory.  The network is scanned for the
+ * following patterns:
+ *
+ *  - A Linear or Convolution layer followed by a BatchNorm layer: in
+ *    deterministic mode, BatchNorm is an affine map of each channel with the
+ *    running mean and variance, so it is folded into the weights and the bias
+ *    of the preceding layer, and removed.
+ *  - A Linear layer (after the folding above) followed by an identity, ReLU,
+ *    sigmoid or tanh BaseLayer: the two layers are replaced by a FusedLinear
+ *    layer, which applies the bias and the activation in the same pass over
+ *    the output of the matrix multiplication.
+ *
+ * All other layers are copied.  The fused network gives the same predictions
+ * as the trained network in deterministic mode (up to floating-point
+ * rounding), and can be serialized like any other network.  Since the
+ * BatchNorm layers are gone, the fused network should not be trained further.
+ *
+ * @code
+ * extern FFN<NegativeLogLikelihood<>> model; // A trained network.
+ *
+ * FFN<NegativeLogLikelihood<>> fused;
+ * FuseNetwork(model, fused);
+ * fused.Predict(testData, predictions);
+ * @endcode
+ *
+ * @param network The trained network.
+ * @param fused The network to build; it must not have any layers.
+ * @return The number of layers that were folded into other layers.
+ */
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename... CustomLayers>
+size_t FuseNetwork(
+    const FFN<OutputLayerType, InitializationRuleType, CustomLayers...>&
+        network,
+    FFN<OutputLayerType, InitializationRuleType, CustomLayers...>& fused);
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "fuse_network_impl.hpp"
+
+#endif
@@ -0,0 +1,230 @@
+/**
+ * @file methods/ann/fuse_network_impl.hpp
+ *
+ * Implementation of FuseNetwork().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_FUSE_NETWORK_IMPL_HPP
+#define MLPACK_METHODS_ANN_FUSE_NETWORK_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "fuse_network.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Compute the scale and the shift of each channel of a BatchNorm layer in
+ * deterministic mode, so that the output of channel c is
+ * scale(c) * input + shift(c).
+ *
+ * @param layer The BatchNorm layer.
+ * @param weights The parameters of the layer (gamma, followed by beta).
+ * @param scale The scale of each channel.
+ * @param shift The shift of each channel.
+ */
+inline void BatchNormScaleShift(const BatchNorm<>& layer,
+                                const double* weights,
+                                arma::vec& scale,
+                                arma::vec& shift)
+{
+  const size_t size = layer.InputSize();
+  const arma::vec gamma(weights, size);
+  const arma::vec beta(weights + size, size);
+
+  scale = gamma / arma::sqrt(arma::vectorise(layer.TrainingVariance()) +
+      layer.Epsilon());
+  shift = beta - scale % arma::vectorise(layer.TrainingMean());
+}
+
+/**
+ * If the given layer is a BaseLayer with the given activation function, add a
+ * FusedLinear layer with that activation function to the network.
+ *
+ * @return Whether the layer was added.
+ */
+template<typename ActivationFunction, typename LayerType, typename NetworkType>
+bool AddFusedLinear(const LayerType& layer,
+                    const size_t inSize,
+                    const size_t outSize,
+                    NetworkType& network)
+{
+  if (boost::get<BaseLayer<ActivationFunction>*>(&layer) == NULL)
+    return false;
+
+  network.template Add<FusedLinear<ActivationFunction> >(inSize, outSize);
+  return true;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename... CustomLayers>
+size_t FuseNetwork(
+    const FFN<OutputLayerType, InitializationRuleType, CustomLayers...>&
+        network,
+    FFN<OutputLayerType, InitializationRuleType, CustomLayers...>& fused)
+{
+  if (network.Parameters().is_empty())
+  {
+    throw std::invalid_argument("FuseNetwork(): the network has no "
+        "parameters; train it first");
+  }
+
+  if (!fused.Model().empty())
+  {
+    throw std::invalid_argument("FuseNetwork(): the fused network must not "
+        "have any layers");
+  }
+
+  const std::vector<LayerTypes<CustomLayers...> >& layers = network.Model();
+  const arma::mat& parameters = network.Parameters();
+  CopyVisitor<CustomLayers...> copyVisitor;
+
+  // The parameters of each layer of the fused network.  They can only be set
+  // once all layers have been added.
+  std::vector<arma::vec> fusedWeights;
+
+  size_t numFused = 0;
+  size_t offset = 0;
+  size_t i = 0;
+  while (i < layers.size())
+  {
+    const size_t weightSize = boost::apply_visitor(WeightSizeVisitor(),
+        layers[i]);
+    arma::vec weights(parameters.memptr() + offset, weightSize);
+    offset += weightSize;
+
+    Linear<>* const* linear = boost::get<Linear<>*>(&layers[i]);
+    Convolution<>* const* convolution =
+        boost::get<Convolution<>*>(&layers[i]);
+    BatchNorm<>* const* batchNorm = (i + 1 < layers.size()) ?
+        boost::get<BatchNorm<>*>(&layers[i + 1]) : NULL;
+
+    size_t next = i + 1;
+    if (linear != NULL)
+    {
+      const size_t inSize = (*linear)->InputSize();
+      const size_t outSize = (*linear)->OutputSize();
+
+      // Weight and bias of the layer, as aliases of the copied parameters.
+      arma::mat weight(weights.memptr(), outSize, inSize, false, true);
+      arma::vec bias(weights.memptr() + weight.n_elem, outSize, false, true);
+
+      bool folded = false;
+      if (batchNorm != NULL && outSize % (*batchNorm)->InputSize() == 0)
+      {
+        arma::vec scale, shift;
+        BatchNormScaleShift(**batchNorm, parameters.memptr() + offset, scale,
+            shift);
+
+        // Each channel of the BatchNorm layer covers a block of rows.
+        const size_t channelRows = outSize / (*batchNorm)->InputSize();
+        for (size_t r = 0; r < outSize; ++r)
+        {
+          weight.row(r) *= scale[r / channelRows];
+          bias[r] = scale[r / channelRows] * bias[r] + shift[r / channelRows];
+        }
+
+        offset += (*batchNorm)->WeightSize();
+        ++next;
+        ++numFused;
+        folded = true;
+      }
+
+      bool activation = false;
+      if (next < layers.size())
+      {
+        activation =
+            AddFusedLinear<IdentityFunction>(layers[next], inSize, outSize,
+                fused) ||
+            AddFusedLinear<RectifierFunction>(layers[next], inSize, outSize,
+                fused) ||
+            AddFusedLinear<LogisticFunction>(layers[next], inSize, outSize,
+                fused) ||
+            AddFusedLinear<TanhFunction>(layers[next], inSize, outSize,
+                fused);
+      }
+
+      if (activation)
+      {
+        ++next;
+        ++numFused;
+      }
+      else if (folded)
+      {
+        fused.template Add<Linear<> >(inSize, outSize);
+      }
+      else
+      {
+        fused.Add(boost::apply_visitor(copyVisitor, layers[i]));
+      }
+    }
+    else if (convolution != NULL && batchNorm != NULL &&
+        (*batchNorm)->InputSize() == (*convolution)->OutputSize())
+    {
+      const size_t inSize = (*convolution)->InputSize();
+      const size_t outSize = (*convolution)->OutputSize();
+      const size_t kernelSize = (*convolution)->KernelWidth() *
+          (*convolution)->KernelHeight();
+
+      arma::vec scale, shift;
+      BatchNormScaleShift(**batchNorm, parameters.memptr() + offset, scale,
+          shift);
+
+      // The kernels of output map o are the slices o * inSize, ...,
+      // (o + 1) * inSize - 1 of the weights, followed by the biases.
+      double* bias = weights.memptr() + kernelSize * inSize * outSize;
+      for (size_t o = 0; o < outSize; ++o)
+      {
+        arma::vec kernels(weights.memptr() + o * inSize * kernelSize,
+            inSize * kernelSize, false, true);
+        kernels *= scale[o];
+        bias[o] = scale[o] * bias[o] + shift[o];
+      }
+
+      fused.Add(boost::apply_visitor(copyVisitor, layers[i]));
+      offset += (*batchNorm)->WeightSize();
+      ++next;
+      ++numFused;
+    }
+    else
+    {
+      fused.Add(boost::apply_visitor(copyVisitor, layers[i]));
+    }
+
+    fusedWeights.push_back(std::move(weights));
+    i = next;
+  }
+
+  // Let the fused network allocate its parameters and set up the aliases of
+  // its layers, then overwrite the initial parameters.
+  fused.ResetParameters();
+
+  size_t fusedOffset = 0;
+  for (size_t l = 0; l < fusedWeights.size(); ++l)
+  {
+    if (fusedWeights[l].n_elem == 0)
+      continue;
+
+    if (fusedOffset + fusedWeights[l].n_elem > fused.Parameters().n_elem)
+    {
+      throw std::logic_error("FuseNetwork(): the fused network has fewer "
+          "parameters than expected");
+    }
+
+    fused.Parameters().rows(fusedOffset, fusedOffset +
+        fusedWeights[l].n_elem - 1) = fusedWeights[l];
+    fusedOffset += fusedWeights[l].n_elem;
+  }
+
+  return numFused;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
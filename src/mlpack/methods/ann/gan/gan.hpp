@@ -13,6 +13,8 @@
 
 #include <mlpack/core.hpp>
 
+#include <future>
+
 #include <mlpack/methods/ann/ffn.hpp>
 #include <mlpack/methods/ann/gan/gan_policies.hpp>
 #include <mlpack/methods/ann/visitor/output_parameter_visitor.hpp>
@@ -316,6 +318,21 @@ class GAN
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return numFunctions; }
 
+  //! Get whether the fake points are generated while the Discriminator is
+  //! trained on the real points.
+  bool OverlapGenerator() const { return overlapGenerator; }
+  /**
+   * Modify whether the fake points are generated while the Discriminator is
+   * trained on the real points.  If set, in each training step the noise is
+   * sampled and passed through the Generator in a separate thread, while the
+   * Discriminator is evaluated (forward and backward) on the real points of
+   * the batch in the calling thread.  The result is the same, but the noise
+   * function is called from the other thread, so it must not share its random
+   * number generator with the layers of the Discriminator (e.g. it should use
+   * its own std::mt19937 instead of math::RandNormal()).
+   */
+  bool& OverlapGenerator() { return overlapGenerator; }
+
   //! Get the matrix of responses to the input data points.
   const arma::mat& Responses() const { return responses; }
   //! Modify the matrix of responses to the input data points.
@@ -337,6 +354,23 @@ class GAN
   */
   void ResetDeterministic();
 
+  /**
+   * Sample the noise, pass it through the Generator, and store the generated
+   * points in the predictors, after the training data.
+   */
+  void GenerateSamples();
+
+  /**
+   * Evaluate the Discriminator and its gradient on the real points of the
+   * batch starting at the given index, and generate the fake points of the
+   * batch with GenerateSamples(), at the same time if OverlapGenerator() is
+   * set.
+   *
+   * @param i The index of the first point of the batch.
+   * @return The objective of the Discriminator on the real points.
+   */
+  double EvaluateRealAndGenerate(const size_t i);
+
   //! Locally stored parameter for training data + noise data.
   arma::mat predictors;
   //! Locally stored parameters of the network.
@@ -401,6 +435,9 @@ class GAN
   size_t genWeights;
   //! To keep track of number of discriminator weights in total weights.
   size_t discWeights;
+  //! Whether the fake points are generated while the Discriminator is
+  //! trained on the real points.
+  bool overlapGenerator;
 };
 
 } // namespace ann
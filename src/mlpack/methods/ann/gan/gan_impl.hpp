@@ -56,7 +56,8 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
     reset(false),
     deterministic(false),
     genWeights(0),
-    discWeights(0)
+    discWeights(0),
+    overlapGenerator(false)
 {
   // Insert IdentityLayer for joining the Generator and Discriminator.
   this->discriminator.network.insert(
@@ -92,7 +93,8 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
     noise(network.noise),
     deterministic(network.deterministic),
     genWeights(network.genWeights),
-    discWeights(network.discWeights)
+    discWeights(network.discWeights),
+    overlapGenerator(network.overlapGenerator)
 {
   /* Nothing to do here */
 }
@@ -125,7 +127,8 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
     noise(std::move(network.noise)),
     deterministic(network.deterministic),
     genWeights(network.genWeights),
-    discWeights(network.discWeights)
+    discWeights(network.discWeights),
+    overlapGenerator(network.overlapGenerator)
 {
   /* Nothing to do here */
 }
@@ -263,15 +266,10 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
       outputParameterVisitor,
       discriminator.network.back()), currentTarget);
 
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(noise);
-
-  predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      boost::apply_visitor(outputParameterVisitor, generator.network.back());
+  GenerateSamples();
   discriminator.Forward(predictors.cols(numFunctions,
       numFunctions + batchSize - 1));
-  responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      arma::zeros(1, batchSize);
+  responses.cols(numFunctions, numFunctions + batchSize - 1).zeros();
 
   currentTarget = arma::mat(responses.memptr() + numFunctions,
       1, batchSize, false, false);
@@ -334,16 +332,9 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       gradientGenerator.n_elem,
       discriminator.Parameters().n_elem, 1, false, false);
 
-  // Get the gradients of the Discriminator.
-  double res = discriminator.EvaluateWithGradient(discriminator.parameter,
-      i, gradientDiscriminator, batchSize);
-
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(noise);
-  predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      boost::apply_visitor(outputParameterVisitor, generator.network.back());
-  responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      arma::zeros(1, batchSize);
+  // Get the gradients of the Discriminator, and generate the fake points.
+  double res = EvaluateRealAndGenerate(i);
+  responses.cols(numFunctions, numFunctions + batchSize - 1).zeros();
 
   // Get the gradients of the Generator.
   res += discriminator.EvaluateWithGradient(discriminator.parameter,
@@ -354,8 +345,7 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   {
     // Minimize -log(D(G(noise))).
     // Pass the error from Discriminator to Generator.
-    responses.cols(numFunctions, numFunctions + batchSize - 1) =
-        arma::ones(1, batchSize);
+    responses.cols(numFunctions, numFunctions + batchSize - 1).ones();
 
     discriminator.outputLayer.Backward(
         boost::apply_visitor(outputParameterVisitor,
@@ -403,6 +393,48 @@ Gradient(const arma::mat& parameters,
   this->EvaluateWithGradient(parameters, i, gradient, batchSize);
 }
 
+template<
+  typename Model,
+  typename InitializationRuleType,
+  typename Noise,
+  typename PolicyType
+>
+void GAN<Model, InitializationRuleType, Noise, PolicyType>::GenerateSamples()
+{
+  noise.imbue( [&]() { return noiseFunction();} );
+  generator.Forward(noise);
+  predictors.cols(numFunctions, numFunctions + batchSize - 1) =
+      boost::apply_visitor(outputParameterVisitor, generator.network.back());
+}
+
+template<
+  typename Model,
+  typename InitializationRuleType,
+  typename Noise,
+  typename PolicyType
+>
+double GAN<Model, InitializationRuleType, Noise, PolicyType>::
+EvaluateRealAndGenerate(const size_t i)
+{
+  if (!overlapGenerator)
+  {
+    const double res = discriminator.EvaluateWithGradient(
+        discriminator.parameter, i, gradientDiscriminator, batchSize);
+    GenerateSamples();
+    return res;
+  }
+
+  // The Generator and the Discriminator do not share any state, and the
+  // generated points are stored in the columns of the predictors after the
+  // training data, which the Discriminator does not read for the real points.
+  std::future<void> samples = std::async(std::launch::async,
+      [this]() { GenerateSamples(); });
+  const double res = discriminator.EvaluateWithGradient(
+      discriminator.parameter, i, gradientDiscriminator, batchSize);
+  samples.get();
+  return res;
+}
+
 template<
   typename Model,
   typename InitializationRuleType,
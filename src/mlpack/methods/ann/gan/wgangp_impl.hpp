@@ -57,17 +57,14 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
       outputParameterVisitor,
       discriminator.network.back())), std::move(currentTarget));
 
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(std::move(noise));
-
-  arma::mat generatedData = boost::apply_visitor(outputParameterVisitor,
+  // The output of the Generator is not changed by the Discriminator, so it
+  // does not have to be copied.
+  GenerateSamples();
+  const arma::mat& generatedData = boost::apply_visitor(outputParameterVisitor,
       generator.network.back());
-  predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      generatedData;
   discriminator.Forward(std::move(predictors.cols(numFunctions,
       numFunctions + batchSize - 1)));
-  responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
+  responses.cols(numFunctions, numFunctions + batchSize - 1).fill(-1.0);
 
   currentTarget = arma::mat(responses.memptr() + numFunctions,
       1, batchSize, false, false);
@@ -80,8 +77,7 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
   double epsilon = math::Random();
   predictors.cols(numFunctions, numFunctions + batchSize - 1) =
       (epsilon * currentInput) + ((1.0 - epsilon) * generatedData);
-  responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
+  responses.cols(numFunctions, numFunctions + batchSize - 1).fill(-1.0);
   discriminator.Gradient(discriminator.parameter, numFunctions,
       normGradientDiscriminator, batchSize);
   res += lambda * std::pow(arma::norm(normGradientDiscriminator, 2) - 1, 2);
@@ -144,21 +140,16 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   currentInput = arma::mat(predictors.memptr() + (i * predictors.n_rows),
       predictors.n_rows, batchSize, false, false);
 
-  // Get the gradients of the Discriminator.
-  double res = discriminator.EvaluateWithGradient(discriminator.parameter,
-      i, gradientDiscriminator, batchSize);
-
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(std::move(noise));
-  arma::mat generatedData = boost::apply_visitor(outputParameterVisitor,
+  // Get the gradients of the Discriminator, and generate the fake points.
+  double res = EvaluateRealAndGenerate(i);
+  const arma::mat& generatedData = boost::apply_visitor(outputParameterVisitor,
       generator.network.back());
 
   // Gradient Penalty is calculated here.
   double epsilon = math::Random();
   predictors.cols(numFunctions, numFunctions + batchSize - 1) =
       (epsilon * currentInput) + ((1.0 - epsilon) * generatedData);
-  responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
+  responses.cols(numFunctions, numFunctions + batchSize - 1).fill(-1.0);
   discriminator.Gradient(discriminator.parameter, numFunctions,
       normGradientDiscriminator, batchSize);
   res += lambda * std::pow(arma::norm(normGradientDiscriminator, 2) - 1, 2);
@@ -173,8 +164,7 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   {
     // Minimize -D(G(noise)).
     // Pass the error from Discriminator to Generator.
-    responses.cols(numFunctions, numFunctions + batchSize - 1) =
-        arma::ones(1, batchSize);
+    responses.cols(numFunctions, numFunctions + batchSize - 1).ones();
 
     discriminator.outputLayer.Backward(
         boost::apply_visitor(outputParameterVisitor,
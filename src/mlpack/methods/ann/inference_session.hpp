@@ -0,0 +1,130 @@
+/**
+ * @file methods/ann/inference_session.hpp
+ *
+ * Definition of the InferenceSession class, which runs the forward pass of a
+ * trained FFN with preallocated activation buffers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_INFERENCE_SESSION_HPP
+#define MLPACK_METHODS_ANN_INFERENCE_SESSION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "ffn.hpp"
+#include "visitor/deterministic_set_visitor.hpp"
+#include "visitor/forward_visitor.hpp"
+#include "visitor/set_input_height_visitor.hpp"
+#include "visitor/set_input_width_visitor.hpp"
+#include "util/check_input_shape.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * An InferenceSession is a frozen execution plan for the forward pass of a
+ * trained FFN.  FFN::Predict() passes each point through the network one at a
+ * time, and each layer writes its output into its own OutputParameter(), so
+ * the network holds the outputs (and the deltas) of every layer at once.
+ *
+ * When the session is created, a single batch is passed through the network
+ * to find the output size of each layer, and one arena is allocated that holds
+ * two buffers of the largest output size.  The output of each layer only has
+ * to live until the next layer has read it, so the layers write their outputs
+ * into the two buffers in turn.  The outputs and deltas stored in the layers
+ * themselves are released, since they are recomputed by the next call to
+ * FFN::Forward() or FFN::Train() anyway.  After that, Predict() does not
+ * allocate any activation memory (layers that use temporaries internally may
+ * still allocate those), and the memory used for activations is that of two
+ * layer outputs for one batch, no matter how deep the network is.
+ *
+ * The session keeps a reference to the network, which must outlive it, and
+ * sets the layers of the network to deterministic (testing) mode.  The
+ * network must not be changed (or trained) while the session is used; create
+ * a new session after the network has been changed.
+ *
+ * @code
+ * extern FFN<NegativeLogLikelihood<>> model; // A trained network.
+ * extern arma::mat testData;
+ *
+ * InferenceSession<FFN<NegativeLogLikelihood<>>> session(model,
+ *     testData.n_rows, 256);
+ * arma::mat predictions;
+ * session.Predict(testData, predictions);
+ * @endcode
+ *
+ * @tparam NetworkType The type of the network (an FFN).
+ */
+template<typename NetworkType>
+class InferenceSession
+{
+ public:
+  /**
+   * Create the session for the given trained network.
+   *
+   * @param network The trained network.
+   * @param inputSize The number of dimensions of each input point.
+   * @param batchSize The maximum number of points passed through the network
+   *     at once.
+   */
+  InferenceSession(NetworkType& network,
+                   const size_t inputSize,
+                   const size_t batchSize = 128);
+
+  //! Sessions hold aliases into their own arena, so they cannot be copied.
+  InferenceSession(const InferenceSession& other) = delete;
+  //! Sessions hold aliases into their own arena, so they cannot be copied.
+  InferenceSession& operator=(const InferenceSession& other) = delete;
+
+  /**
+   * Predict the responses to the given set of predictors, in batches of at
+   * most BatchSize() points.  This gives the same results as
+   * FFN::Predict().
+   *
+   * @param predictors Input predictors, with InputSize() rows.
+   * @param results Matrix to put output predictions of responses into.
+   */
+  void Predict(const arma::mat& predictors, arma::mat& results);
+
+  //! Get the number of dimensions of each input point.
+  size_t InputSize() const { return inputSize; }
+  //! Get the number of dimensions of each output point.
+  size_t OutputSize() const { return layerSizes.back(); }
+  //! Get the maximum number of points passed through the network at once.
+  size_t BatchSize() const { return batchSize; }
+  //! Get the output size of each layer (for one point).
+  const std::vector<size_t>& LayerSizes() const { return layerSizes; }
+  //! Get the number of elements of the activation arena.
+  size_t ArenaSize() const { return arena.n_elem; }
+
+ private:
+  //! Point the output buffer of each layer at the arena, for a batch of the
+  //! given number of points.
+  void AliasBuffers(const size_t batchCols);
+
+  //! The network.
+  NetworkType& network;
+  //! The number of dimensions of each input point.
+  size_t inputSize;
+  //! The maximum number of points passed through the network at once.
+  size_t batchSize;
+  //! The output size of each layer.
+  std::vector<size_t> layerSizes;
+  //! The memory for the outputs of all layers.
+  arma::mat arena;
+  //! The output buffer of each layer, an alias into the arena.
+  std::vector<arma::mat> outputs;
+  //! The number of points the output buffers are currently set up for.
+  size_t bufferCols;
+}; // class InferenceSession
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "inference_session_impl.hpp"
+
+#endif
@@ -0,0 +1,160 @@
+/**
+ * @file methods/ann/inference_session_impl.hpp
+ *
+ * Implementation of the InferenceSession class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_INFERENCE_SESSION_IMPL_HPP
+#define MLPACK_METHODS_ANN_INFERENCE_SESSION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "inference_session.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename NetworkType>
+InferenceSession<NetworkType>::InferenceSession(NetworkType& network,
+                                                const size_t inputSize,
+                                                const size_t batchSize) :
+    network(network),
+    inputSize(inputSize),
+    batchSize(batchSize),
+    bufferCols(0)
+{
+  if (inputSize == 0 || batchSize == 0)
+  {
+    throw std::invalid_argument("InferenceSession::InferenceSession(): the "
+        "input size and the batch size must be positive");
+  }
+
+  if (network.Model().empty())
+  {
+    throw std::invalid_argument("InferenceSession::InferenceSession(): the "
+        "network has no layers");
+  }
+
+  if (network.Parameters().is_empty())
+  {
+    throw std::invalid_argument("InferenceSession::InferenceSession(): the "
+        "network has no parameters; train it or call ResetParameters() first");
+  }
+
+  CheckInputShape(network.Model(), inputSize,
+      "InferenceSession::InferenceSession()");
+
+  auto& layers = network.Model();
+  for (size_t i = 0; i < layers.size(); ++i)
+    boost::apply_visitor(DeterministicSetVisitor(true), layers[i]);
+
+  // Pass one batch through the network to find the output size of each layer.
+  // The input width and height of the layers are set in the same way as in
+  // FFN::Forward().
+  arma::mat input(inputSize, batchSize, arma::fill::zeros);
+  arma::mat output;
+  size_t width = 0, height = 0;
+  layerSizes.resize(layers.size());
+  for (size_t i = 0; i < layers.size(); ++i)
+  {
+    if (i > 0)
+    {
+      boost::apply_visitor(SetInputWidthVisitor(width), layers[i]);
+      boost::apply_visitor(SetInputHeightVisitor(height), layers[i]);
+    }
+
+    boost::apply_visitor(ForwardVisitor(input, output), layers[i]);
+
+    if (boost::apply_visitor(OutputWidthVisitor(), layers[i]) != 0)
+      width = boost::apply_visitor(OutputWidthVisitor(), layers[i]);
+    if (boost::apply_visitor(OutputHeightVisitor(), layers[i]) != 0)
+      height = boost::apply_visitor(OutputHeightVisitor(), layers[i]);
+
+    if (output.n_cols != batchSize)
+    {
+      std::ostringstream oss;
+      oss << "InferenceSession::InferenceSession(): layer " << i << " does "
+          << "not output one column for each input point";
+      throw std::logic_error(oss.str());
+    }
+
+    layerSizes[i] = output.n_rows;
+    input = std::move(output);
+  }
+
+  // The outputs and deltas held by the layers are not used for inference.
+  // They are recomputed by the next forward or backward pass of the network.
+  for (size_t i = 0; i < layers.size(); ++i)
+  {
+    boost::apply_visitor(OutputParameterVisitor(), layers[i]).reset();
+    boost::apply_visitor(DeltaVisitor(), layers[i]).reset();
+  }
+
+  // Two buffers are enough, since each output only has to live until the next
+  // layer has read it.
+  const size_t maxSize = *std::max_element(layerSizes.begin(),
+      layerSizes.end());
+  arena.set_size(2 * maxSize * batchSize, 1);
+  outputs.resize(layers.size());
+  AliasBuffers(batchSize);
+}
+
+template<typename NetworkType>
+void InferenceSession<NetworkType>::Predict(const arma::mat& predictors,
+                                            arma::mat& results)
+{
+  if (predictors.n_rows != inputSize)
+  {
+    std::ostringstream oss;
+    oss << "InferenceSession::Predict(): the predictors have "
+        << predictors.n_rows << " dimensions, but the session was created for "
+        << inputSize << " dimensions";
+    throw std::invalid_argument(oss.str());
+  }
+
+  auto& layers = network.Model();
+  results.set_size(OutputSize(), predictors.n_cols);
+  for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
+  {
+    const size_t cols = std::min(batchSize,
+        (size_t) predictors.n_cols - begin);
+    if (cols != bufferCols)
+      AliasBuffers(cols);
+
+    // Alias the batch instead of copying it.
+    const arma::mat input(const_cast<double*>(predictors.colptr(begin)),
+        inputSize, cols, false, true);
+
+    boost::apply_visitor(ForwardVisitor(input, outputs[0]), layers[0]);
+    for (size_t i = 1; i < layers.size(); ++i)
+    {
+      boost::apply_visitor(ForwardVisitor(outputs[i - 1], outputs[i]),
+          layers[i]);
+    }
+
+    results.cols(begin, begin + cols - 1) = outputs.back();
+  }
+}
+
+template<typename NetworkType>
+void InferenceSession<NetworkType>::AliasBuffers(const size_t batchCols)
+{
+  // The buffers are not strict aliases: if a layer resizes its output anyway,
+  // it gets its own memory, and the results are still correct.
+  const size_t bufferSize = arena.n_elem / 2;
+  for (size_t i = 0; i < outputs.size(); ++i)
+  {
+    outputs[i] = arma::mat(arena.memptr() + (i % 2) * bufferSize,
+        layerSizes[i], batchCols, false, false);
+  }
+
+  bufferCols = batchCols;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
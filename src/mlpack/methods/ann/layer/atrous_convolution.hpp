@@ -19,6 +19,7 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/winograd_convolution.hpp>
 #include <mlpack/core/util/to_lower.hpp>
 
 #include "layer_types.hpp"
@@ -34,6 +35,9 @@ namespace ann /** Artificial Neural Network. */ {
  * spaces included between the kernel cells, in order to capture a larger
  * field of reception, without having to increase dicrete kernel sizes.
  *
+ * Without dilation, a 3x3 kernel with stride 1 uses the Winograd F(2x2, 3x3)
+ * algorithm for the forward pass, as the Convolution layer does.
+ *
  * @tparam ForwardConvolutionRule Atrous Convolution to perform forward process.
  * @tparam BackwardConvolutionRule Atrous Convolution to perform backward process.
  * @tparam GradientConvolutionRule Atrous Convolution to calculate gradient.
@@ -259,6 +263,11 @@ class AtrousConvolution
   //! Modify the internal Padding layer.
   ann::Padding<>& Padding() { return padding; }
 
+  //! Get the value of the deterministic parameter.
+  bool Deterministic() const { return deterministic; }
+  //! Modify the value of the deterministic parameter.
+  bool& Deterministic() { return deterministic; }
+
   //! Get size of the weight matrix.
   size_t WeightSize() const
   {
@@ -307,6 +316,16 @@ class AtrousConvolution
                              size_t& padHBottom,
                              size_t& padHTop) const;
 
+  //! Return whether the forward pass uses the Winograd algorithm.
+  bool UseWinograd() const
+  {
+    return (std::is_same<ForwardConvolutionRule,
+        NaiveConvolution<ValidConvolution> >::value ||
+        IsWinogradConvolution<ForwardConvolutionRule>::value) &&
+        WinogradConvolution<>::Supported(kernelWidth, kernelHeight,
+        strideWidth, strideHeight, dilationWidth, dilationHeight);
+  }
+
   /*
    * Rotates a 3rd-order tensor counterclockwise by 180 degrees.
    *
@@ -407,6 +426,15 @@ class AtrousConvolution
 
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
+
+  //! If true, the layer is used for inference and the weights do not change.
+  bool deterministic;
+
+  //! Locally-stored Winograd transform of the filters.
+  arma::mat winogradFilters;
+
+  //! Whether the stored transform of the filters can be reused.
+  bool winogradFiltersValid;
 }; // class AtrousConvolution
 
 } // namespace ann
@@ -32,7 +32,9 @@ AtrousConvolution<
     GradientConvolutionRule,
     InputDataType,
     OutputDataType
->::AtrousConvolution()
+>::AtrousConvolution() :
+    deterministic(false),
+    winogradFiltersValid(false)
 {
   // Nothing to do here.
 }
@@ -120,7 +122,9 @@ AtrousConvolution<
     outputWidth(0),
     outputHeight(0),
     dilationWidth(dilationWidth),
-    dilationHeight(dilationHeight)
+    dilationHeight(dilationHeight),
+    deterministic(false),
+    winogradFiltersValid(false)
 {
   weights.set_size(WeightSize(), 1);
 
@@ -165,6 +169,7 @@ void AtrousConvolution<
         outSize * inSize, false, false);
     bias = arma::mat(weights.memptr() + weight.n_elem,
         outSize, 1, false, false);
+    winogradFiltersValid = false;
 }
 
 template<
@@ -209,8 +214,38 @@ void AtrousConvolution<
   output.set_size(wConv * hConv * outSize, batchSize);
   outputTemp = arma::Cube<eT>(output.memptr(), wConv, hConv,
       outSize * batchSize, false, false);
-  outputTemp.zeros();
 
+  if (UseWinograd())
+  {
+    // The transformed filters only have to be computed again if the weights
+    // may have changed, that is, unless the layer is used for inference.
+    if (!deterministic || !winogradFiltersValid)
+    {
+      WinogradConvolution<>::TransformFilters(weight, winogradFilters);
+      winogradFiltersValid = deterministic;
+    }
+
+    if (padding.PadWLeft() != 0 || padding.PadWRight() != 0 ||
+        padding.PadHTop() != 0 || padding.PadHBottom() != 0)
+    {
+      WinogradConvolution<>::BatchConvolution(inputPaddedTemp,
+          winogradFilters, inSize, outputTemp);
+    }
+    else
+    {
+      WinogradConvolution<>::BatchConvolution(inputTemp, winogradFilters,
+          inSize, outputTemp);
+    }
+
+    for (size_t outMap = 0; outMap < outputTemp.n_slices; ++outMap)
+      outputTemp.slice(outMap) += bias(outMap % outSize);
+
+    outputWidth = outputTemp.n_rows;
+    outputHeight = outputTemp.n_cols;
+    return;
+  }
+
+  outputTemp.zeros();
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
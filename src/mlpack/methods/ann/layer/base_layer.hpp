@@ -30,6 +30,9 @@
 #include <mlpack/methods/ann/activation_functions/hard_swish_function.hpp>
 #include <mlpack/methods/ann/activation_functions/tanh_exponential_function.hpp>
 #include <mlpack/methods/ann/activation_functions/silu_function.hpp>
+#include <mlpack/methods/ann/activation_functions/fast_logistic_function.hpp>
+#include <mlpack/methods/ann/activation_functions/fast_tanh_function.hpp>
+#include <mlpack/methods/ann/activation_functions/fast_gelu_function.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -56,6 +59,9 @@ namespace ann /** Artificial Neural Network. */ {
  *  - HardSwishLayer
  *  - TanhExpLayer
  *  - SILULayer
+ *  - FastSigmoidLayer
+ *  - FastTanHLayer
+ *  - FastGELUFunctionLayer
  *
  * @tparam ActivationFunction Activation function used for the embedding layer.
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
@@ -317,6 +323,42 @@ using SILUFunctionLayer = BaseLayer<
     ActivationFunction, InputDataType, OutputDataType
 >;
 
+/**
+ * Sigmoid-Layer using the vectorizable approximation of the logistic function
+ * (FastLogisticFunction).
+ */
+template <
+    class ActivationFunction = FastLogisticFunction,
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+using FastSigmoidLayer = BaseLayer<
+    ActivationFunction, InputDataType, OutputDataType>;
+
+/**
+ * TanH-Layer using the vectorizable approximation of the tanh function
+ * (FastTanhFunction).
+ */
+template <
+    class ActivationFunction = FastTanhFunction,
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+using FastTanHLayer = BaseLayer<
+    ActivationFunction, InputDataType, OutputDataType>;
+
+/**
+ * GELU-Layer using the vectorizable approximation of the tanh function
+ * (FastGELUFunction).
+ */
+template <
+    class ActivationFunction = FastGELUFunction,
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+using FastGELUFunctionLayer = BaseLayer<
+    ActivationFunction, InputDataType, OutputDataType>;
+
 } // namespace ann
 } // namespace mlpack
 
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_LAYER_BATCHNORM_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/util/normalization.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -231,9 +232,6 @@ class BatchNorm
 
   //! Locally-stored normalized input.
   arma::cube normalized;
-
-  //! Locally-stored zero mean input.
-  arma::cube inputMean;
 }; // class BatchNorm
 
 } // namespace ann
@@ -99,40 +99,42 @@ void BatchNorm<InputDataType, OutputDataType>::Forward(
           " greater than 1 to fix the warning." << std::endl;
     }
 
-    // Input corresponds to output from convolution layer.
-    // Use a cube for simplicity.
-    arma::cube inputTemp(const_cast<arma::Mat<eT>&>(input).memptr(),
-        inputSize, size, batchSize, false, false);
-
-    // Initialize output to same size and values for convenience.
-    arma::cube outputTemp(const_cast<arma::Mat<eT>&>(output).memptr(),
-        inputSize, size, batchSize, false, false);
-    outputTemp = inputTemp;
-
-    // Calculate mean and variance over all channels.
-    mean = arma::mean(arma::mean(inputTemp, 2), 0);
-    variance = arma::mean(arma::mean(arma::pow(
-        inputTemp.each_slice() - arma::repmat(mean,
-        inputSize, 1), 2), 2), 0);
-
-    outputTemp.each_slice() -= arma::repmat(mean, inputSize, 1);
-
-    // Used in backward propagation.
-    inputMean.set_size(arma::size(inputTemp));
-    inputMean = outputTemp;
-
-    // Normalize output.
-    outputTemp.each_slice() /= arma::sqrt(arma::repmat(variance,
-        inputSize, 1) + eps);
-
-    // Re-used in backward propagation.
-    normalized.set_size(arma::size(inputTemp));
-    normalized = outputTemp;
+    // Input corresponds to output from convolution layer: each column holds
+    // the inputSize values of each of the feature maps, one after the other.
+    // Compute the mean and the variance of each feature map in one pass.
+    std::vector<WelfordStatistics> statistics(size);
+    for (size_t j = 0; j < batchSize; ++j)
+      for (size_t k = 0; k < size; ++k)
+        statistics[k].Update(input.colptr(j) + k * inputSize, inputSize);
+
+    mean.set_size(1, size);
+    variance.set_size(1, size);
+    arma::vec stdInv(size);
+    for (size_t k = 0; k < size; ++k)
+    {
+      mean(k) = statistics[k].Mean();
+      variance(k) = statistics[k].Variance();
+      stdInv(k) = 1.0 / std::sqrt(variance(k) + eps);
+    }
 
-    outputTemp.each_slice() %= arma::repmat(gamma.t(),
-        inputSize, 1);
-    outputTemp.each_slice() += arma::repmat(beta.t(),
-        inputSize, 1);
+    // Normalize, scale and shift the input in a second pass.  The normalized
+    // input is re-used in backward propagation.
+    normalized.set_size(inputSize, size, batchSize);
+    for (size_t j = 0; j < batchSize; ++j)
+    {
+      for (size_t k = 0; k < size; ++k)
+      {
+        const size_t offset = j * input.n_rows + k * inputSize;
+        const eT* x = input.memptr() + offset;
+        double* xhat = normalized.memptr() + offset;
+        eT* y = output.memptr() + offset;
+        for (size_t i = 0; i < inputSize; ++i)
+        {
+          xhat[i] = (x[i] - mean(k)) * stdInv(k);
+          y[i] = xhat[i] * gamma(k) + beta(k);
+        }
+      }
+    }
 
     count += 1;
     averageFactor = average ? 1.0 / count : momentum;
@@ -150,19 +152,20 @@ void BatchNorm<InputDataType, OutputDataType>::Forward(
   }
   else
   {
-    // Normalize the input and scale and shift the output.
-    output = input;
-    arma::cube outputTemp(const_cast<arma::Mat<eT>&>(output).memptr(),
-        input.n_rows / size, size, batchSize, false, false);
-
-    outputTemp.each_slice() -= arma::repmat(runningMean.t(),
-        input.n_rows / size, 1);
-    outputTemp.each_slice() /= arma::sqrt(arma::repmat(runningVariance.t(),
-        input.n_rows / size, 1) + eps);
-    outputTemp.each_slice() %= arma::repmat(gamma.t(),
-        input.n_rows / size, 1);
-    outputTemp.each_slice() += arma::repmat(beta.t(),
-        input.n_rows / size, 1);
+    // Normalize the input and scale and shift the output, with a single
+    // scale and shift for each feature map.
+    for (size_t k = 0; k < size; ++k)
+    {
+      const double scale = gamma(k) / std::sqrt(runningVariance(k) + eps);
+      const double shift = beta(k) - runningMean(k) * scale;
+      for (size_t j = 0; j < batchSize; ++j)
+      {
+        const eT* x = input.colptr(j) + k * inputSize;
+        eT* y = output.colptr(j) + k * inputSize;
+        for (size_t i = 0; i < inputSize; ++i)
+          y[i] = x[i] * scale + shift;
+      }
+    }
   }
 }
 
@@ -173,35 +176,52 @@ void BatchNorm<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>& gy,
     arma::Mat<eT>& g)
 {
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
-
+  const size_t inputSize = input.n_rows / size;
+  const size_t batchSize = input.n_cols;
   g.set_size(arma::size(input));
-  arma::cube gyTemp(const_cast<arma::Mat<eT>&>(gy).memptr(),
-      input.n_rows / size, size, input.n_cols, false, false);
-  arma::cube gTemp(const_cast<arma::Mat<eT>&>(g).memptr(),
-      input.n_rows / size, size, input.n_cols, false, false);
-
-  // Step 1: dl / dxhat.
-  arma::cube norm = gyTemp.each_slice() % arma::repmat(gamma.t(),
-      input.n_rows / size, 1);
-
-  // Step 2: sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  arma::mat temp = arma::sum(norm % inputMean, 2);
-  arma::mat vars = temp % arma::repmat(arma::pow(stdInv, 3),
-      input.n_rows / size, 1) * -0.5;
-
-  // Step 3: dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
-  // dl / dmu * 1 / m.
-  gTemp = (norm.each_slice() % arma::repmat(stdInv,
-      input.n_rows / size, 1) +
-      (inputMean.each_slice() % vars * 2)) / input.n_cols;
-
-  // Step 4: sum (dl / dxhat * -1 / stdInv) + variance *
-  // (sum -2 * (x - mu)) / m.
-  arma::mat normTemp = arma::sum(norm.each_slice() %
-      arma::repmat(-stdInv, input.n_rows / size, 1) , 2) /
-      input.n_cols;
-  gTemp.each_slice() += normTemp;
+
+  // Step 1: with dxhat = dl / dy * gamma, sum dxhat and dxhat * xhat over
+  // the batch, for each position of each feature map.
+  arma::mat normSum(inputSize, size, arma::fill::zeros);
+  arma::mat normDot(inputSize, size, arma::fill::zeros);
+  for (size_t j = 0; j < batchSize; ++j)
+  {
+    for (size_t k = 0; k < size; ++k)
+    {
+      const size_t offset = j * input.n_rows + k * inputSize;
+      const eT* error = gy.memptr() + offset;
+      const double* xhat = normalized.memptr() + offset;
+      double* sum = normSum.colptr(k);
+      double* dot = normDot.colptr(k);
+      for (size_t i = 0; i < inputSize; ++i)
+      {
+        const double dxhat = error[i] * gamma(k);
+        sum[i] += dxhat;
+        dot[i] += dxhat * xhat[i];
+      }
+    }
+  }
+
+  // Step 2: the gradient with respect to the input is
+  // stdInv / m * (dxhat - sum dxhat - xhat * sum dxhat * xhat).
+  for (size_t k = 0; k < size; ++k)
+  {
+    const double stdInv = 1.0 / std::sqrt(variance(k) + eps) / batchSize;
+    const double* sum = normSum.colptr(k);
+    const double* dot = normDot.colptr(k);
+    for (size_t j = 0; j < batchSize; ++j)
+    {
+      const size_t offset = j * input.n_rows + k * inputSize;
+      const eT* error = gy.memptr() + offset;
+      const double* xhat = normalized.memptr() + offset;
+      eT* delta = g.memptr() + offset;
+      for (size_t i = 0; i < inputSize; ++i)
+      {
+        delta[i] = stdInv * (error[i] * gamma(k) - sum[i] -
+            xhat[i] * dot[i]);
+      }
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -211,17 +231,28 @@ void BatchNorm<InputDataType, OutputDataType>::Gradient(
     const arma::Mat<eT>& error,
     arma::Mat<eT>& gradient)
 {
-  gradient.set_size(size + size, 1);
-  arma::cube errorTemp(const_cast<arma::Mat<eT>&>(error).memptr(),
-      error.n_rows / size, size, error.n_cols, false, false);
+  const size_t inputSize = error.n_rows / size;
+  gradient.zeros(size + size, 1);
 
-  // Step 5: dl / dy * xhat.
-  arma::mat temp = arma::sum(arma::sum(normalized % errorTemp, 0), 2);
-  gradient.submat(0, 0, gamma.n_elem - 1, 0) = temp.t();
-
-  // Step 6: dl / dy.
-  temp = arma::sum(arma::sum(errorTemp, 0), 2);
-  gradient.submat(gamma.n_elem, 0, gradient.n_elem - 1, 0) = temp.t();
+  // Step 5: dl / dy * xhat, and step 6: dl / dy, in the same pass.
+  for (size_t j = 0; j < error.n_cols; ++j)
+  {
+    for (size_t k = 0; k < size; ++k)
+    {
+      const size_t offset = j * error.n_rows + k * inputSize;
+      const eT* e = error.memptr() + offset;
+      const double* xhat = normalized.memptr() + offset;
+      double gammaGradient = 0.0, betaGradient = 0.0;
+      for (size_t i = 0; i < inputSize; ++i)
+      {
+        gammaGradient += xhat[i] * e[i];
+        betaGradient += e[i];
+      }
+
+      gradient[k] += gammaGradient;
+      gradient[size + k] += betaGradient;
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -114,23 +114,32 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Forward(
     }
   }
 
-  output = boost::apply_visitor(outputParameterVisitor, network.front());
+  // Allocate the output once, and copy the output of each layer directly into
+  // its block of rows, instead of concatenating the outputs one by one.
+  size_t rows = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+    rows += boost::apply_visitor(outputParameterVisitor, network[i]).n_rows;
 
-  // Reshape output to incorporate the channels.
-  output.reshape(output.n_rows / channels, output.n_cols * channels);
+  const size_t cols = boost::apply_visitor(outputParameterVisitor,
+      network.front()).n_cols;
+  output.set_size(rows, cols);
 
-  for (size_t i = 1; i < network.size(); ++i)
+  // View the output with the channels incorporated.  The outputs of the layers
+  // are concatenated vertically in that shape.
+  arma::Mat<eT> outputTmp(output.memptr(), rows / channels, cols * channels,
+      false, true);
+
+  size_t rowCount = 0;
+  for (size_t i = 0; i < network.size(); ++i)
   {
-    arma::Mat<eT> out = boost::apply_visitor(outputParameterVisitor,
+    arma::Mat<eT>& out = boost::apply_visitor(outputParameterVisitor,
         network[i]);
+    const arma::Mat<eT> outTmp(out.memptr(), out.n_rows / channels,
+        out.n_cols * channels, false, true);
 
-    out.reshape(out.n_rows / channels, out.n_cols * channels);
-
-    // Vertically concatentate output from each layer.
-    output = arma::join_cols(output, out);
+    outputTmp.rows(rowCount, rowCount + outTmp.n_rows - 1) = outTmp;
+    rowCount += outTmp.n_rows;
   }
-  // Reshape output to its original shape.
-  output.reshape(output.n_rows * channels, output.n_cols / channels);
 }
 
 template<typename InputDataType, typename OutputDataType,
@@ -18,7 +18,10 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/winograd_convolution.hpp>
 #include <mlpack/core/util/to_lower.hpp>
+#include <mlpack/methods/ann/util/device_gemm.hpp>
 
 #include "layer_types.hpp"
 #include "padding.hpp"
@@ -59,6 +62,13 @@ namespace ann /** Artificial Neural Network. */ {
  * a 2-D image (or object) of the original 196x14 size, using this as the input
  * for the 14 filters of this example.
  *
+ * If the forward rule is the default NaiveConvolution<ValidConvolution> (or a
+ * WinogradConvolution) and the kernel is 3x3 with stride 1, the forward pass
+ * uses the Winograd F(2x2, 3x3) algorithm (see WinogradConvolution).  In
+ * deterministic mode (inference, as set by FFN::Predict()), the transformed
+ * filters are computed once and kept, so Reset() must be called if the
+ * weights are changed while the layer is deterministic.
+ *
  * @tparam ForwardConvolutionRule Convolution to perform forward process.
  * @tparam BackwardConvolutionRule Convolution to perform backward process.
  * @tparam GradientConvolutionRule Convolution to calculate gradient.
@@ -294,6 +304,11 @@ class Convolution
   //! Modify the right padding width.
   size_t& PadWRight() { return padWRight; }
 
+  //! Get the value of the deterministic parameter.
+  bool Deterministic() const { return deterministic; }
+  //! Modify the value of the deterministic parameter.
+  bool& Deterministic() { return deterministic; }
+
   //! Get size of weights for the layer.
   size_t WeightSize() const
   {
@@ -337,6 +352,60 @@ class Convolution
    */
   void InitializeSamePadding();
 
+  //! Return whether the forward pass uses the Winograd algorithm.
+  bool UseWinograd() const
+  {
+    return (std::is_same<ForwardConvolutionRule,
+        NaiveConvolution<ValidConvolution> >::value ||
+        IsWinogradConvolution<ForwardConvolutionRule>::value) &&
+        WinogradConvolution<>::Supported(kernelWidth, kernelHeight,
+        strideWidth, strideHeight);
+  }
+
+  /*
+   * Run the forward pass for the whole batch with one matrix multiplication;
+   * used if the forward rule is an Im2ColConvolution.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void ForwardIm2Col(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+
+  /*
+   * Run the backward pass for the whole batch with one matrix multiplication;
+   * used if the backward rule is an Im2ColConvolution.
+   *
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void BackwardIm2Col(const arma::Mat<eT>& gy, arma::Mat<eT>& g);
+
+  /*
+   * Compute the gradient for the whole batch with one matrix multiplication;
+   * used if the gradient rule is an Im2ColConvolution.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  template<typename eT>
+  void GradientIm2Col(const arma::Mat<eT>& input,
+                      const arma::Mat<eT>& error,
+                      arma::Mat<eT>& gradient);
+
+  /*
+   * Copy the error into a matrix with one column for each output map, as
+   * used by the Im2ColConvolution passes.
+   *
+   * @param error The error of the output of the layer.
+   * @param errorColumns The rearranged error.
+   */
+  template<typename eT>
+  void ErrorToColumns(const arma::Mat<eT>& error,
+                      arma::Mat<eT>& errorColumns);
+
   /*
    * Rotates a 3rd-order tensor counterclockwise by 180 degrees.
    *
@@ -432,6 +501,13 @@ class Convolution
   //! Locally-stored transformed gradient parameter.
   arma::cube gradientTemp;
 
+  //! Locally-stored input patches (only used with Im2ColConvolution).
+  arma::mat im2colColumns;
+
+  //! Locally-stored product of the patches and the kernels, or the
+  //! rearranged error (only used with Im2ColConvolution).
+  arma::mat im2colProduct;
+
   //! Locally-stored padding layer.
   ann::Padding<> padding;
 
@@ -446,6 +522,20 @@ class Convolution
 
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
+
+  //! If true, the layer is used for inference and the weights do not change.
+  bool deterministic;
+
+  //! Locally-stored Winograd transform of the filters.
+  arma::mat winogradFilters;
+
+  //! Whether the stored transform of the filters can be reused.
+  bool winogradFiltersValid;
+
+  //! Copy of the kernels on the GPU (only used with Im2ColConvolution and
+  //! Bandicoot); like the Winograd transform, it is kept between batches if
+  //! the layer is deterministic.
+  DeviceMatrix<double> deviceKernels;
 }; // class Convolution
 
 } // namespace ann
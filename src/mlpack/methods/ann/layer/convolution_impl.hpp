@@ -31,7 +31,9 @@ Convolution<
     GradientConvolutionRule,
     InputDataType,
     OutputDataType
->::Convolution()
+>::Convolution() :
+    deterministic(false),
+    winogradFiltersValid(false)
 {
   // Nothing to do here.
 }
@@ -115,7 +117,9 @@ Convolution<
     inputWidth(inputWidth),
     inputHeight(inputHeight),
     outputWidth(0),
-    outputHeight(0)
+    outputHeight(0),
+    deterministic(false),
+    winogradFiltersValid(false)
 {
   weights.set_size(WeightSize(), 1);
 
@@ -167,7 +171,9 @@ Convolution<
     outputWidth(layer.outputWidth),
     outputHeight(layer.outputHeight),
     padding(layer.padding),
-    weights(layer.weights)
+    weights(layer.weights),
+    deterministic(layer.deterministic),
+    winogradFiltersValid(false)
 {
   // Nothing to do here.
 }
@@ -202,7 +208,9 @@ Convolution<
     outputWidth(layer.outputWidth),
     outputHeight(layer.outputHeight),
     padding(std::move(layer.padding)),
-    weights(std::move(layer.weights))
+    weights(std::move(layer.weights)),
+    deterministic(layer.deterministic),
+    winogradFiltersValid(false)
 {
   // Nothing to do here.
 }
@@ -248,6 +256,8 @@ operator=(const Convolution& layer)
     outputHeight = layer.outputHeight;
     padding = layer.padding;
     weights = layer.weights;
+    deterministic = layer.deterministic;
+    winogradFiltersValid = false;
   }
 
   return *this;
@@ -293,6 +303,8 @@ operator=(Convolution&& layer)
     outputHeight = layer.outputHeight;
     padding = std::move(layer.padding);
     weights = std::move(layer.weights);
+    deterministic = layer.deterministic;
+    winogradFiltersValid = false;
   }
 
   return *this;
@@ -317,6 +329,8 @@ void Convolution<
         outSize * inSize, false, false);
     bias = arma::mat(weights.memptr() + weight.n_elem,
         outSize, 1, false, false);
+    winogradFiltersValid = false;
+    deviceKernels.Invalidate();
 }
 
 template<
@@ -335,6 +349,12 @@ void Convolution<
     OutputDataType
 >::Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
 {
+  if (IsIm2ColConvolution<ForwardConvolutionRule>::value)
+  {
+    ForwardIm2Col(input, output);
+    return;
+  }
+
   batchSize = input.n_cols;
   arma::cube inputTemp(const_cast<arma::Mat<eT>&>(input).memptr(),
       inputWidth, inputHeight, inSize * batchSize, false, false);
@@ -358,8 +378,37 @@ void Convolution<
   output.set_size(wConv * hConv * outSize, batchSize);
   outputTemp = arma::Cube<eT>(output.memptr(), wConv, hConv,
       outSize * batchSize, false, false);
-  outputTemp.zeros();
 
+  if (UseWinograd())
+  {
+    // The transformed filters only have to be computed again if the weights
+    // may have changed, that is, unless the layer is used for inference.
+    if (!deterministic || !winogradFiltersValid)
+    {
+      WinogradConvolution<>::TransformFilters(weight, winogradFilters);
+      winogradFiltersValid = deterministic;
+    }
+
+    if (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0)
+    {
+      WinogradConvolution<>::BatchConvolution(inputPaddedTemp,
+          winogradFilters, inSize, outputTemp);
+    }
+    else
+    {
+      WinogradConvolution<>::BatchConvolution(inputTemp, winogradFilters,
+          inSize, outputTemp);
+    }
+
+    for (size_t outMap = 0; outMap < outputTemp.n_slices; ++outMap)
+      outputTemp.slice(outMap) += bias(outMap % outSize);
+
+    outputWidth = outputTemp.n_rows;
+    outputHeight = outputTemp.n_cols;
+    return;
+  }
+
+  outputTemp.zeros();
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
@@ -413,6 +462,12 @@ void Convolution<
 >::Backward(
     const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
 {
+  if (IsIm2ColConvolution<BackwardConvolutionRule>::value)
+  {
+    BackwardIm2Col(gy, g);
+    return;
+  }
+
   arma::cube mappedError(((arma::Mat<eT>&) gy).memptr(), outputWidth,
       outputHeight, outSize * batchSize, false, false);
 
@@ -470,6 +525,12 @@ void Convolution<
     const arma::Mat<eT>& error,
     arma::Mat<eT>& gradient)
 {
+  if (IsIm2ColConvolution<GradientConvolutionRule>::value)
+  {
+    GradientIm2Col(input, error, gradient);
+    return;
+  }
+
   arma::cube mappedError(((arma::Mat<eT>&) error).memptr(), outputWidth,
       outputHeight, outSize * batchSize, false, false);
   arma::cube inputTemp(((arma::Mat<eT>&) input).memptr(), inputWidth,
@@ -530,6 +591,156 @@ void Convolution<
   }
 }
 
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::ForwardIm2Col(const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  batchSize = input.n_cols;
+  outputWidth = ConvOutSize(inputWidth, kernelWidth, strideWidth, padWLeft,
+      padWRight);
+  outputHeight = ConvOutSize(inputHeight, kernelHeight, strideHeight, padHTop,
+      padHBottom);
+  const size_t outputMapSize = outputWidth * outputHeight;
+
+  // The padding is applied while the patches are copied.
+  Im2ColConvolution<>::Im2Col(input, inputWidth, inputHeight, inSize,
+      kernelWidth, kernelHeight, strideWidth, strideHeight, padWLeft, padHTop,
+      outputWidth, outputHeight, im2colColumns);
+
+  // The kernels of each output map, stored one after another, are the
+  // columns of a matrix whose rows are in the same order as the patches.
+  const arma::Mat<eT> kernels(weight.memptr(), im2colColumns.n_rows, outSize,
+      false, true);
+  if (!deterministic)
+    deviceKernels.Invalidate();
+  DeviceGemm<eT>(im2colColumns, true, kernels, false, im2colProduct, NULL,
+      &deviceKernels);
+
+  // The product has one column for each output map; move those into the
+  // layout of the output and add the bias.
+  output.set_size(outputMapSize * outSize, batchSize);
+  for (size_t b = 0; b < batchSize; ++b)
+  {
+    for (size_t o = 0; o < outSize; ++o)
+    {
+      const eT* productPtr = im2colProduct.colptr(o) + b * outputMapSize;
+      eT* outputPtr = output.colptr(b) + o * outputMapSize;
+      for (size_t i = 0; i < outputMapSize; ++i)
+        outputPtr[i] = productPtr[i] + bias(o);
+    }
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::BackwardIm2Col(const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+{
+  ErrorToColumns(gy, im2colProduct);
+
+  // The error of each patch, which is accumulated back into the inputs it was
+  // copied from; the error of the padding is dropped.
+  const arma::Mat<eT> kernels(weight.memptr(), kernelWidth * kernelHeight *
+      inSize, outSize, false, true);
+  DeviceGemm(kernels, false, im2colProduct, true, im2colColumns,
+      &deviceKernels);
+  // The optimizer changes the weights after the backward pass.
+  deviceKernels.Invalidate();
+
+  Im2ColConvolution<>::Col2Im(im2colColumns, inputWidth, inputHeight, inSize,
+      kernelWidth, kernelHeight, strideWidth, strideHeight, padWLeft, padHTop,
+      outputWidth, outputHeight, g);
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::GradientIm2Col(
+    const arma::Mat<eT>& input,
+    const arma::Mat<eT>& error,
+    arma::Mat<eT>& gradient)
+{
+  // The patches are computed again, since the backward pass reuses the
+  // buffer.
+  Im2ColConvolution<>::Im2Col(input, inputWidth, inputHeight, inSize,
+      kernelWidth, kernelHeight, strideWidth, strideHeight, padWLeft, padHTop,
+      outputWidth, outputHeight, im2colColumns);
+  ErrorToColumns(error, im2colProduct);
+
+  gradient.set_size(weights.n_elem, 1);
+  arma::Mat<eT> kernelGradient(gradient.memptr(), im2colColumns.n_rows,
+      outSize, false, true);
+  DeviceGemm(im2colColumns, false, im2colProduct, false, kernelGradient);
+
+  gradient.rows(weight.n_elem, weights.n_elem - 1) =
+      arma::sum(im2colProduct, 0).t();
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::ErrorToColumns(
+    const arma::Mat<eT>& error,
+    arma::Mat<eT>& errorColumns)
+{
+  const size_t outputMapSize = outputWidth * outputHeight;
+  errorColumns.set_size(outputMapSize * batchSize, outSize);
+  for (size_t b = 0; b < batchSize; ++b)
+  {
+    for (size_t o = 0; o < outSize; ++o)
+    {
+      std::copy(error.colptr(b) + o * outputMapSize,
+          error.colptr(b) + (o + 1) * outputMapSize,
+          errorColumns.colptr(o) + b * outputMapSize);
+    }
+  }
+}
+
 template<
     typename ForwardConvolutionRule,
     typename BackwardConvolutionRule,
@@ -0,0 +1,164 @@
+/**
+ * @file methods/ann/layer/fused_linear_impl.hpp
+ *
+ * Implementation of the FusedLinear layer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FUSED_LINEAR_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_FUSED_LINEAR_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "fused_linear.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename ActivationFunction, typename InputDataType,
+    typename OutputDataType>
+FusedLinear<ActivationFunction, InputDataType, OutputDataType>::FusedLinear() :
+    inSize(0),
+    outSize(0)
+{
+  // Nothing to do here.
+}
+
+template<typename ActivationFunction, typename InputDataType,
+    typename OutputDataType>
+FusedLinear<ActivationFunction, InputDataType, OutputDataType>::FusedLinear(
+    const size_t inSize,
+    const size_t outSize) :
+    inSize(inSize),
+    outSize(outSize)
+{
+  weights.set_size(WeightSize(), 1);
+}
+
+template<typename ActivationFunction, typename InputDataType,
+    typename OutputDataType>
+FusedLinear<ActivationFunction, InputDataType, OutputDataType>::FusedLinear(
+    const FusedLinear& layer) :
+    inSize(layer.inSize),
+    outSize(layer.outSize),
+    weights(layer.weights)
+{
+  // Nothing to do here.
+}
+
+template<typename ActivationFunction, typename InputDataType,
+    typename OutputDataType>
+FusedLinear<ActivationFunction, InputDataType, OutputDataType>::FusedLinear(
+    FusedLinear&& layer) :
+    inSize(layer.inSize),
+    outSize(layer.outSize),
+    weights(std::move(layer.weights))
+{
+  // Nothing to do here.
+}
+
+template<typename ActivationFunction, typename InputDataType,
+    typename OutputDataType>
+FusedLinear<ActivationFunction, InputDataType, OutputDataType>&
+FusedLinear<ActivationFunction, InputDataType, OutputDataType>::
+operator=(const FusedLinear& layer)
+{
+  if (this != &layer)
+  {
+    inSize = layer.inSize;
+    outSize = layer.outSize;
+    weights = layer.weights;
+  }
+  return *this;
+}
+
+template<typename ActivationFunction, typename InputDataType,
+    typename OutputDataType>
+FusedLinear<ActivationFunction, InputDataType, OutputDataType>&
+FusedLinear<ActivationFunction, InputDataType, OutputDataType>::
+operator=(FusedLinear&& layer)
+{
+  if (this != &layer)
+  {
+    inSize = layer.inSize;
+    outSize = layer.outSize;
+    weights = std::move(layer.weights);
+  }
+  return *this;
+}
+
+template<typename ActivationFunction, typename InputDataType,
+    typename OutputDataType>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::Reset()
+{
+  weight = OutputDataType(weights.memptr(), outSize, inSize, false, false);
+  bias = OutputDataType(weights.memptr() + weight.n_elem,
+      outSize, 1, false, false);
+}
+
+template<typename ActivationFunction, typename InputDataType,
+    typename OutputDataType>
+template<typename eT>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  output = weight * input;
+
+  // Add the bias and apply the activation function while the output is in the
+  // cache, instead of making a separate pass for each.
+  const eT* b = bias.memptr();
+  for (size_t j = 0; j < output.n_cols; ++j)
+  {
+    eT* out = output.colptr(j);
+    for (size_t i = 0; i < output.n_rows; ++i)
+      out[i] = ActivationFunction::Fn(out[i] + b[i]);
+  }
+}
+
+template<typename ActivationFunction, typename InputDataType,
+    typename OutputDataType>
+template<typename eT>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>& input, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+{
+  // As for BaseLayer, the derivative is computed from the output activation.
+  arma::Mat<eT> derivative;
+  ActivationFunction::Deriv(input, derivative);
+  g = weight.t() * (gy % derivative);
+}
+
+template<typename ActivationFunction, typename InputDataType,
+    typename OutputDataType>
+template<typename eT>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::Gradient(
+    const arma::Mat<eT>& input,
+    const arma::Mat<eT>& error,
+    arma::Mat<eT>& gradient)
+{
+  arma::Mat<eT> derivative;
+  ActivationFunction::Deriv(outputParameter, derivative);
+  const arma::Mat<eT> preError = error % derivative;
+
+  gradient.submat(0, 0, weight.n_elem - 1, 0) = arma::vectorise(
+      preError * input.t());
+  gradient.submat(weight.n_elem, 0, gradient.n_elem - 1, 0) =
+      arma::sum(preError, 1);
+}
+
+template<typename ActivationFunction, typename InputDataType,
+    typename OutputDataType>
+template<typename Archive>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(inSize));
+  ar(CEREAL_NVP(outSize));
+  ar(CEREAL_NVP(weights));
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
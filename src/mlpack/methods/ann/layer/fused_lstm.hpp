@@ -0,0 +1,352 @@
+/**
+ * @file methods/ann/layer/fused_lstm.hpp
+ *
+ * Definition of the FusedLSTM class, an LSTM layer whose gates are computed
+ * with one matrix multiplication per step and fused elementwise passes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FUSED_LSTM_HPP
+#define MLPACK_METHODS_ANN_LAYER_FUSED_LSTM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <limits>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * An LSTM layer with the same equations and the same parameter layout as
+ * FastLSTM (but with the exact sigmoid function):
+ *
+ * @f{eqnarray}{
+ * i &=& sigmoid(W \cdot x + W \cdot h + b) \\
+ * f &=& sigmoid(W  \cdot x + W \cdot h + b) \\
+ * z &=& tanh(W \cdot x + W \cdot h + b) \\
+ * c &=& f \odot c + i \odot z \\
+ * o &=& sigmoid(W \cdot x + W \cdot h + b) \\
+ * h &=& o \odot tanh(c)
+ * @f}
+ *
+ * The pre-activations of all four gates are computed into one preallocated
+ * matrix, and the activations, the cell and the output are then computed in
+ * a single fused pass over that matrix (which also adds the bias), instead of
+ * one pass (and one temporary) for each operation.  All state is kept in
+ * buffers that are allocated once for rho steps by ResetCell(), so the steps
+ * themselves do not allocate memory.
+ *
+ * When the layer is used inside an RNN, it is given one step at a time.  If
+ * the whole sequence is available, ForwardSequence() and BackwardSequence()
+ * can be used instead: they compute the input projection of all steps with
+ * one large matrix multiplication, so that only the recurrent projection is
+ * left for each step, and they compute the error of the inputs and the
+ * gradient of the input and recurrent weights for the whole sequence with one
+ * matrix multiplication each.
+ *
+ * @code
+ * FusedLSTM<> lstm(inputSize, hiddenSize);
+ * lstm.Parameters().randn();
+ * lstm.Reset();
+ *
+ * // input is inputSize x batchSize x sequenceLength.
+ * arma::cube output, inputError;
+ * lstm.ForwardSequence(input, output);
+ * arma::mat gradient;
+ * lstm.BackwardSequence(input, outputError, inputError, gradient);
+ * @endcode
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class FusedLSTM
+{
+ public:
+  // Convenience typedefs.
+  typedef typename OutputDataType::elem_type ElemType;
+
+  //! Create the FusedLSTM object.
+  FusedLSTM();
+
+  /**
+   * Create the FusedLSTM layer object using the specified parameters.
+   *
+   * @param inSize The number of input units.
+   * @param outSize The number of output units.
+   * @param rho Maximum number of steps to backpropagate through time (BPTT).
+   */
+  FusedLSTM(const size_t inSize,
+            const size_t outSize,
+            const size_t rho = std::numeric_limits<size_t>::max());
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.  This is one step of
+   * the sequence.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename InputType, typename OutputType>
+  void Forward(const InputType& input, OutputType& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f. Using the results from the feed
+   * forward pass.  The steps are given in reverse order.
+   *
+   * @param input The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename InputType, typename ErrorType, typename GradientType>
+  void Backward(const InputType& input,
+                const ErrorType& gy,
+                GradientType& g);
+
+  /*
+   * Calculate the gradient using the output delta and the input activation,
+   * for the step of the last call to Backward().
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  template<typename InputType, typename ErrorType, typename GradientType>
+  void Gradient(const InputType& input,
+                const ErrorType& error,
+                GradientType& gradient);
+
+  /**
+   * Run the forward pass over a whole sequence.  The state of the layer is
+   * reset first, and the state of the sequence is kept for
+   * BackwardSequence().
+   *
+   * @param input The input sequence (inSize x batch size x sequence length).
+   * @param output The output sequence (outSize x batch size x sequence
+   *     length).
+   */
+  void ForwardSequence(const arma::Cube<ElemType>& input,
+                       arma::Cube<ElemType>& output);
+
+  /**
+   * Backpropagate through the sequence of the last call to ForwardSequence().
+   *
+   * @param input The input sequence given to ForwardSequence().
+   * @param gy The error of each output (outSize x batch size x sequence
+   *     length).
+   * @param g The error of each input (inSize x batch size x sequence length).
+   * @param gradient The gradient of the parameters, summed over the sequence.
+   */
+  void BackwardSequence(const arma::Cube<ElemType>& input,
+                        const arma::Cube<ElemType>& gy,
+                        arma::Cube<ElemType>& g,
+                        arma::Mat<ElemType>& gradient);
+
+  /*
+   * Reset the layer parameter.
+   */
+  void Reset();
+
+  /*
+   * Resets the cell to accept a new input. This breaks the BPTT chain starts a
+   * new one.
+   *
+   * @param size The current maximum number of steps through time.
+   */
+  void ResetCell(const size_t size);
+
+  /**
+   * Reset the cell like ResetCell(), but start the next sequence from the
+   * output and the cell state after the last step of the previous forward
+   * pass, instead of from zero.  This is used to feed a long sequence to the
+   * layer in consecutive parts: the state is carried over from one part to the
+   * next, and BPTT is truncated at the beginning of each part.  If the batch
+   * size of the next forward pass is not the same, the state is reset to zero.
+   *
+   * @param size The current maximum number of steps through time.
+   */
+  void CarryCell(const size_t size);
+
+  //! Get the maximum number of steps to backpropagate through time (BPTT).
+  size_t Rho() const { return rho; }
+  //! Modify the maximum number of steps to backpropagate through time (BPTT).
+  size_t& Rho() { return rho; }
+
+  //! Get the parameters.
+  OutputDataType const& Parameters() const { return weights; }
+  //! Modify the parameters.
+  OutputDataType& Parameters() { return weights; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the gradient.
+  OutputDataType const& Gradient() const { return grad; }
+  //! Modify the gradient.
+  OutputDataType& Gradient() { return grad; }
+
+  //! Get the number of input units.
+  size_t InSize() const { return inSize; }
+
+  //! Get the number of output units.
+  size_t OutSize() const { return outSize; }
+
+  //! Get the size of the weight matrix.
+  size_t WeightSize() const
+  {
+    return 4 * outSize * inSize + 4 * outSize + 4 * outSize * outSize;
+  }
+
+  //! Get the shape of the input.
+  size_t InputShape() const
+  {
+    return inSize;
+  }
+
+  /**
+   * Serialize the layer
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Make sure the state buffers can hold the given number of steps.
+  void AllocateState(const size_t steps);
+
+  /**
+   * Turn the pre-activations of the given step (without the bias) into the
+   * gate activations, and compute the cell and the output of the step.
+   */
+  void ForwardStep(const size_t step);
+
+  /**
+   * Compute the error of the gate pre-activations of the given step from the
+   * error of the output (hiddenError) and the error carried over from the
+   * next step through the cell (cellError, which is updated).
+   *
+   * @param step The step.
+   * @param first Whether this is the first step of the backward pass (the
+   *     last step of the sequence), which has no error carried over.
+   * @param gateError The error of the gate pre-activations (4 * outSize x
+   *     batch size).
+   */
+  void BackwardStep(const size_t step,
+                    const bool first,
+                    arma::Mat<ElemType>& gateError);
+
+  //! Logistic sigmoid of the given value.
+  static ElemType Sigmoid(const ElemType x)
+  {
+    return 1.0 / (1.0 + std::exp(-x));
+  }
+
+  //! Weights between the input and gate.
+  OutputDataType input2GateWeight;
+
+  //! Bias between the input and gate.
+  OutputDataType input2GateBias;
+
+  //! Weights between the output and gate.
+  OutputDataType output2GateWeight;
+
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of output units.
+  size_t outSize;
+
+  //! Number of steps to backpropagate through time (BPTT).
+  size_t rho;
+
+  //! Locally-stored current rho size.
+  size_t rhoSize;
+
+  //! Current backpropagate through time steps.
+  size_t bpttSteps;
+
+  //! Locally-stored batch size.
+  size_t batchSize;
+
+  //! The step of the next call to Forward().
+  size_t forwardStep;
+
+  //! The step of the next call to Backward().
+  size_t backwardStep;
+
+  //! The step of the next call to Gradient().
+  size_t gradientStep;
+
+  //! The number of steps Backward() has been called for.
+  size_t backwardCount;
+
+  //! Whether a step has been computed since the last reset of the state.
+  bool hasState;
+
+  //! Locally-stored weight object.
+  OutputDataType weights;
+
+  //! The activations of the four gates in the order input, output, forget,
+  //! state (4 * outSize x batch size for each step).
+  OutputDataType gates;
+
+  //! Locally-stored cell of each step.
+  OutputDataType cell;
+
+  //! The cell before the first step, if the state was carried over by
+  //! CarryCell() (and empty otherwise).
+  OutputDataType initialCell;
+
+  //! Locally-stored tanh of the cell of each step.
+  OutputDataType cellActivation;
+
+  //! The output of each step, after the output before the first step (zero,
+  //! unless the state was carried over by CarryCell()).
+  OutputDataType outParameter;
+
+  //! The error of the gate pre-activations of the last step given to
+  //! Backward().
+  OutputDataType prevError;
+
+  //! The error of the gate pre-activations of each step of the sequence
+  //! (only used by BackwardSequence()).
+  OutputDataType sequenceError;
+
+  //! The error of the output of the current step.
+  OutputDataType hiddenError;
+
+  //! The error carried over to the previous step through the cell.
+  OutputDataType cellError;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored gradient object.
+  OutputDataType grad;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class FusedLSTM
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "fused_lstm_impl.hpp"
+
+#endif
@@ -0,0 +1,458 @@
+/**
+ * @file methods/ann/layer/fused_lstm_impl.hpp
+ *
+ * Implementation of the FusedLSTM class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FUSED_LSTM_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_FUSED_LSTM_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "fused_lstm.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+FusedLSTM<InputDataType, OutputDataType>::FusedLSTM() :
+    inSize(0),
+    outSize(0),
+    rho(std::numeric_limits<size_t>::max()),
+    rhoSize(rho),
+    bpttSteps(0),
+    batchSize(0),
+    forwardStep(0),
+    backwardStep(0),
+    gradientStep(0),
+    backwardCount(0),
+    hasState(false)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+FusedLSTM<InputDataType, OutputDataType>::FusedLSTM(const size_t inSize,
+                                                    const size_t outSize,
+                                                    const size_t rho) :
+    inSize(inSize),
+    outSize(outSize),
+    rho(rho),
+    rhoSize(rho),
+    bpttSteps(0),
+    batchSize(0),
+    forwardStep(0),
+    backwardStep(0),
+    gradientStep(0),
+    backwardCount(0),
+    hasState(false)
+{
+  // Weights for: input to gate layer (4 * outsize * inSize + 4 * outsize)
+  // and output to gate (4 * outSize).
+  weights.set_size(WeightSize(), 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void FusedLSTM<InputDataType, OutputDataType>::Reset()
+{
+  // The parameter layout is the same as the one of FastLSTM.
+  input2GateWeight = OutputDataType(weights.memptr(),
+      4 * outSize, inSize, false, false);
+  input2GateBias = OutputDataType(weights.memptr() + input2GateWeight.n_elem,
+      4 * outSize, 1, false, false);
+  output2GateWeight = OutputDataType(weights.memptr() + input2GateWeight.n_elem
+      + input2GateBias.n_elem, 4 * outSize, outSize, false, false);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void FusedLSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
+{
+  if (size == std::numeric_limits<size_t>::max())
+    return;
+
+  rhoSize = size;
+  hasState = false;
+  initialCell.reset();
+
+  if (batchSize == 0)
+    return;
+
+  bpttSteps = std::min(rho, rhoSize);
+  forwardStep = 0;
+  backwardStep = bpttSteps - 1;
+  gradientStep = bpttSteps - 1;
+  backwardCount = 0;
+
+  AllocateState(bpttSteps);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void FusedLSTM<InputDataType, OutputDataType>::CarryCell(const size_t size)
+{
+  if (size == std::numeric_limits<size_t>::max())
+    return;
+
+  // Take the state after the last step that was computed; if no step was
+  // computed since the last reset, keep the state that was carried over then.
+  OutputDataType lastOutput, lastCell;
+  if (batchSize > 0 && hasState)
+  {
+    const size_t last = ((forwardStep == 0) ? bpttSteps : forwardStep) - 1;
+    lastOutput = outParameter.cols((last + 1) * batchSize,
+        (last + 2) * batchSize - 1);
+    lastCell = cell.cols(last * batchSize, (last + 1) * batchSize - 1);
+  }
+  else if (batchSize > 0 && !initialCell.is_empty())
+  {
+    lastOutput = outParameter.cols(0, batchSize - 1);
+    lastCell = std::move(initialCell);
+  }
+
+  ResetCell(size);
+
+  if (!lastCell.is_empty())
+  {
+    outParameter.cols(0, batchSize - 1) = lastOutput;
+    initialCell = std::move(lastCell);
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+void FusedLSTM<InputDataType, OutputDataType>::AllocateState(
+    const size_t steps)
+{
+  // set_size() does not reallocate if the size is unchanged.
+  gates.set_size(4 * outSize, steps * batchSize);
+  cell.set_size(outSize, steps * batchSize);
+  cellActivation.set_size(outSize, steps * batchSize);
+  outParameter.set_size(outSize, (steps + 1) * batchSize);
+  outParameter.cols(0, batchSize - 1).zeros();
+  prevError.set_size(4 * outSize, batchSize);
+  hiddenError.set_size(outSize, batchSize);
+  cellError.set_size(outSize, batchSize);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename OutputType>
+void FusedLSTM<InputDataType, OutputDataType>::Forward(
+    const InputType& input, OutputType& output)
+{
+  // Check if the batch size changed, the number of cols is defines the input
+  // batch size.
+  if (input.n_cols != batchSize)
+  {
+    batchSize = input.n_cols;
+    ResetCell(rhoSize);
+  }
+
+  const size_t begin = forwardStep * batchSize;
+  arma::Mat<ElemType> gateStep(gates.colptr(begin), 4 * outSize, batchSize,
+      false, true);
+  gateStep = input2GateWeight * input;
+  if (forwardStep > 0 || !initialCell.is_empty())
+  {
+    const arma::Mat<ElemType> prevOutput(outParameter.colptr(begin), outSize,
+        batchSize, false, true);
+    gateStep += output2GateWeight * prevOutput;
+  }
+
+  ForwardStep(forwardStep);
+  hasState = true;
+
+  output = OutputType(outParameter.colptr(begin + batchSize), outSize,
+      batchSize, false, false);
+
+  ++forwardStep;
+  if (forwardStep == bpttSteps)
+    forwardStep = 0;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename ErrorType, typename GradientType>
+void FusedLSTM<InputDataType, OutputDataType>::Backward(
+    const InputType& /* input */, const ErrorType& gy, GradientType& g)
+{
+  hiddenError = gy;
+  if (backwardCount > 0)
+    hiddenError += output2GateWeight.t() * prevError;
+
+  BackwardStep(backwardStep, backwardCount == 0, prevError);
+  g = input2GateWeight.t() * prevError;
+
+  // Gradient() is called for the same step.
+  gradientStep = backwardStep;
+  ++backwardCount;
+  if (backwardStep == 0 || backwardCount == bpttSteps)
+  {
+    backwardStep = bpttSteps - 1;
+    backwardCount = 0;
+  }
+  else
+  {
+    --backwardStep;
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename InputType, typename ErrorType, typename GradientType>
+void FusedLSTM<InputDataType, OutputDataType>::Gradient(
+    const InputType& input,
+    const ErrorType& /* error */,
+    GradientType& gradient)
+{
+  ElemType* gradientPtr = gradient.memptr();
+
+  // Gradient of the input to gate layer.
+  arma::Mat<ElemType> inputWeightGradient(gradientPtr, 4 * outSize, inSize,
+      false, true);
+  inputWeightGradient = prevError * input.t();
+  gradientPtr += inputWeightGradient.n_elem;
+
+  arma::Mat<ElemType> biasGradient(gradientPtr, 4 * outSize, 1, false, true);
+  biasGradient = arma::sum(prevError, 1);
+  gradientPtr += biasGradient.n_elem;
+
+  // Gradient of the output to gate layer; the output before the first step is
+  // zero, unless the state was carried over.
+  arma::Mat<ElemType> outputWeightGradient(gradientPtr, 4 * outSize, outSize,
+      false, true);
+  if (gradientStep > 0 || !initialCell.is_empty())
+  {
+    const arma::Mat<ElemType> prevOutput(outParameter.colptr(gradientStep *
+        batchSize), outSize, batchSize, false, true);
+    outputWeightGradient = prevError * prevOutput.t();
+  }
+  else
+  {
+    outputWeightGradient.zeros();
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+void FusedLSTM<InputDataType, OutputDataType>::ForwardSequence(
+    const arma::Cube<ElemType>& input,
+    arma::Cube<ElemType>& output)
+{
+  if (input.n_rows != inSize)
+  {
+    std::ostringstream oss;
+    oss << "FusedLSTM::ForwardSequence(): the input has " << input.n_rows
+        << " dimensions, but the layer has " << inSize << " input units";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t steps = input.n_slices;
+  if (steps == 0 || input.n_cols == 0)
+  {
+    throw std::invalid_argument("FusedLSTM::ForwardSequence(): the input "
+        "sequence is empty");
+  }
+
+  batchSize = input.n_cols;
+  rhoSize = steps;
+  bpttSteps = steps;
+  forwardStep = 0;
+  backwardStep = steps - 1;
+  gradientStep = steps - 1;
+  backwardCount = 0;
+  initialCell.reset();
+  AllocateState(steps);
+
+  // The input projection of all steps, with one matrix multiplication.
+  const arma::Mat<ElemType> inputs(const_cast<ElemType*>(input.memptr()),
+      inSize, batchSize * steps, false, true);
+  gates = input2GateWeight * inputs;
+
+  for (size_t t = 0; t < steps; ++t)
+  {
+    if (t > 0)
+    {
+      arma::Mat<ElemType> gateStep(gates.colptr(t * batchSize), 4 * outSize,
+          batchSize, false, true);
+      const arma::Mat<ElemType> prevOutput(outParameter.colptr(t * batchSize),
+          outSize, batchSize, false, true);
+      gateStep += output2GateWeight * prevOutput;
+    }
+
+    ForwardStep(t);
+  }
+  hasState = true;
+
+  output.set_size(outSize, batchSize, steps);
+  std::copy(outParameter.colptr(batchSize), outParameter.memptr() +
+      outParameter.n_elem, output.memptr());
+}
+
+template<typename InputDataType, typename OutputDataType>
+void FusedLSTM<InputDataType, OutputDataType>::BackwardSequence(
+    const arma::Cube<ElemType>& input,
+    const arma::Cube<ElemType>& gy,
+    arma::Cube<ElemType>& g,
+    arma::Mat<ElemType>& gradient)
+{
+  const size_t steps = input.n_slices;
+  if (steps != bpttSteps || input.n_cols != batchSize ||
+      input.n_rows != inSize || gy.n_rows != outSize ||
+      gy.n_cols != batchSize || gy.n_slices != steps)
+  {
+    throw std::invalid_argument("FusedLSTM::BackwardSequence(): the sizes of "
+        "the input and the error do not match the last call to "
+        "ForwardSequence()");
+  }
+
+  sequenceError.set_size(4 * outSize, steps * batchSize);
+  for (size_t t = steps; t-- > 0; )
+  {
+    std::copy(gy.slice_memptr(t), gy.slice_memptr(t) + outSize * batchSize,
+        hiddenError.memptr());
+    if (t + 1 < steps)
+    {
+      const arma::Mat<ElemType> nextError(sequenceError.colptr((t + 1) *
+          batchSize), 4 * outSize, batchSize, false, true);
+      hiddenError += output2GateWeight.t() * nextError;
+    }
+
+    arma::Mat<ElemType> gateError(sequenceError.colptr(t * batchSize),
+        4 * outSize, batchSize, false, true);
+    BackwardStep(t, t + 1 == steps, gateError);
+  }
+
+  // The error of all inputs and the gradient of all weights, each with one
+  // matrix multiplication over the whole sequence.
+  g.set_size(inSize, batchSize, steps);
+  arma::Mat<ElemType> inputError(g.memptr(), inSize, batchSize * steps, false,
+      true);
+  inputError = input2GateWeight.t() * sequenceError;
+
+  gradient.set_size(WeightSize(), 1);
+  ElemType* gradientPtr = gradient.memptr();
+
+  const arma::Mat<ElemType> inputs(const_cast<ElemType*>(input.memptr()),
+      inSize, batchSize * steps, false, true);
+  arma::Mat<ElemType> inputWeightGradient(gradientPtr, 4 * outSize, inSize,
+      false, true);
+  inputWeightGradient = sequenceError * inputs.t();
+  gradientPtr += inputWeightGradient.n_elem;
+
+  arma::Mat<ElemType> biasGradient(gradientPtr, 4 * outSize, 1, false, true);
+  biasGradient = arma::sum(sequenceError, 1);
+  gradientPtr += biasGradient.n_elem;
+
+  // The output before each step; the first block is the zero output before
+  // the first step.
+  const arma::Mat<ElemType> prevOutputs(outParameter.memptr(), outSize,
+      batchSize * steps, false, true);
+  arma::Mat<ElemType> outputWeightGradient(gradientPtr, 4 * outSize, outSize,
+      false, true);
+  outputWeightGradient = sequenceError * prevOutputs.t();
+}
+
+template<typename InputDataType, typename OutputDataType>
+void FusedLSTM<InputDataType, OutputDataType>::ForwardStep(const size_t step)
+{
+  const size_t begin = step * batchSize;
+  const ElemType* bias = input2GateBias.memptr();
+  for (size_t b = 0; b < batchSize; ++b)
+  {
+    ElemType* gate = gates.colptr(begin + b);
+    ElemType* c = cell.colptr(begin + b);
+    ElemType* cAct = cellActivation.colptr(begin + b);
+    ElemType* h = outParameter.colptr(begin + batchSize + b);
+    const ElemType* prevCell = (step > 0) ?
+        cell.colptr(begin - batchSize + b) : (initialCell.is_empty() ? NULL :
+        initialCell.colptr(b));
+
+    for (size_t j = 0; j < outSize; ++j)
+    {
+      const ElemType i = Sigmoid(gate[j] + bias[j]);
+      const ElemType o = Sigmoid(gate[outSize + j] + bias[outSize + j]);
+      const ElemType f = Sigmoid(gate[2 * outSize + j] +
+          bias[2 * outSize + j]);
+      const ElemType z = std::tanh(gate[3 * outSize + j] +
+          bias[3 * outSize + j]);
+
+      gate[j] = i;
+      gate[outSize + j] = o;
+      gate[2 * outSize + j] = f;
+      gate[3 * outSize + j] = z;
+
+      c[j] = (prevCell != NULL) ? i * z + f * prevCell[j] : i * z;
+      cAct[j] = std::tanh(c[j]);
+      h[j] = o * cAct[j];
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+void FusedLSTM<InputDataType, OutputDataType>::BackwardStep(
+    const size_t step,
+    const bool first,
+    arma::Mat<ElemType>& gateError)
+{
+  const size_t begin = step * batchSize;
+  for (size_t b = 0; b < batchSize; ++b)
+  {
+    const ElemType* gate = gates.colptr(begin + b);
+    const ElemType* cAct = cellActivation.colptr(begin + b);
+    const ElemType* prevCell = (step > 0) ?
+        cell.colptr(begin - batchSize + b) : (initialCell.is_empty() ? NULL :
+        initialCell.colptr(b));
+    const ElemType* dh = hiddenError.colptr(b);
+    ElemType* carry = cellError.colptr(b);
+    ElemType* e = gateError.colptr(b);
+
+    for (size_t j = 0; j < outSize; ++j)
+    {
+      const ElemType i = gate[j];
+      const ElemType o = gate[outSize + j];
+      const ElemType f = gate[2 * outSize + j];
+      const ElemType z = gate[3 * outSize + j];
+
+      ElemType dc = dh[j] * o * (1 - cAct[j] * cAct[j]);
+      if (!first)
+        dc += carry[j];
+
+      e[j] = dc * z * i * (1 - i);
+      e[outSize + j] = dh[j] * cAct[j] * o * (1 - o);
+      e[2 * outSize + j] = (prevCell != NULL) ?
+          dc * prevCell[j] * f * (1 - f) : 0;
+      e[3 * outSize + j] = dc * i * (1 - z * z);
+
+      carry[j] = dc * f;
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void FusedLSTM<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(weights));
+  ar(CEREAL_NVP(inSize));
+  ar(CEREAL_NVP(outSize));
+  ar(CEREAL_NVP(rho));
+
+  // The state of a sequence is not saved; it is allocated again by the next
+  // forward pass.
+  if (cereal::is_loading<Archive>())
+  {
+    rhoSize = rho;
+    bpttSteps = 0;
+    batchSize = 0;
+    forwardStep = 0;
+    backwardStep = 0;
+    gradientStep = 0;
+    backwardCount = 0;
+    hasState = false;
+    initialCell.reset();
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -66,26 +66,17 @@ template<typename eT>
 void GroupNorm<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>& input, arma::Mat<eT>& output)
 {
-  if (output.is_empty())
-    output.set_size(input.n_rows / groupCount, input.n_cols * groupCount);
-
   assert(size % groupCount == 0);
   assert(input.n_rows % size == 0);
 
-  arma::mat reshapedInput(const_cast<arma::Mat<eT>&>(input).memptr(),
-      input.n_rows / groupCount, input.n_cols * groupCount, false, false);
-
-  mean = arma::mean(reshapedInput, 0);
-  variance = arma::var(reshapedInput, 1, 0);
+  // Each group of each point is a contiguous block of the input.
+  const size_t groupSize = input.n_rows / groupCount;
+  const size_t groups = input.n_cols * groupCount;
 
-  // Normalize the input.
-  output = reshapedInput.each_row() - mean;
-  inputMean = output;
-  output.each_row() /= arma::sqrt(variance + eps);
-
-  output.reshape(input.n_rows, input.n_cols);
-  // Reused in the backward and gradient step.
-  normalized = output;
+  output.set_size(arma::size(input));
+  normalized.set_size(arma::size(input));
+  mean.set_size(1, groups);
+  variance.set_size(1, groups);
 
   arma::mat expandedGamma, expandedBeta;
   expandedGamma.set_size(input.n_rows, 1);
@@ -97,9 +88,26 @@ void GroupNorm<InputDataType, OutputDataType>::Forward(
     expandedBeta(r) = beta(r * size / input.n_rows);
   }
 
-  // Scale and shift the output.
-  output.each_col() %= expandedGamma;
-  output.each_col() += expandedBeta;
+  for (size_t i = 0; i < groups; ++i)
+  {
+    const eT* x = input.memptr() + i * groupSize;
+    WelfordStatistics statistics;
+    statistics.Update(x, groupSize);
+    mean(i) = statistics.Mean();
+    variance(i) = statistics.Variance();
+
+    // Normalize, scale and shift the group while it is still in the cache.
+    // The normalized input is reused in the backward and gradient step.
+    const size_t row = (i % groupCount) * groupSize;
+    const double invStd = 1.0 / std::sqrt(variance(i) + eps);
+    double* xhat = normalized.memptr() + i * groupSize;
+    eT* y = output.memptr() + i * groupSize;
+    for (size_t r = 0; r < groupSize; ++r)
+    {
+      xhat[r] = (x[r] - mean(i)) * invStd;
+      y[r] = xhat[r] * expandedGamma[row + r] + expandedBeta[row + r];
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -107,11 +115,10 @@ template<typename eT>
 void GroupNorm<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>& input, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
 {
-  if (g.is_empty())
-    g.set_size(input.n_rows / groupCount, input.n_cols * groupCount);
+  const size_t groupSize = input.n_rows / groupCount;
+  const size_t groups = input.n_cols * groupCount;
 
-  arma::mat inputReshaped(const_cast<arma::Mat<eT>&>(input).memptr(),
-      input.n_rows / groupCount, input.n_cols * groupCount, false, false);
+  g.set_size(arma::size(input));
 
   arma::mat expandedGamma;
   expandedGamma.set_size(input.n_rows, 1);
@@ -120,28 +127,32 @@ void GroupNorm<InputDataType, OutputDataType>::Backward(
     expandedGamma(r) = gamma(r * size / input.n_rows);
   }
 
-  // dl / dxhat.
-  const arma::mat norm = gy.each_col() % expandedGamma;
-
-  arma::mat normReshaped(const_cast<arma::Mat<eT>&>(norm).memptr(),
-      gy.n_rows / groupCount, gy.n_cols * groupCount, false, false);
-
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
-
-  // sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  const arma::mat var = arma::sum(normReshaped % inputMean, 0) %
-      arma::pow(stdInv, 3.0) * -0.5;
-
-  // dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
-  // dl / dmu * 1 / m.
-  g = (normReshaped.each_row() % stdInv) + (inputMean.each_row() %
-      var * 2 / inputReshaped.n_rows);
-
-  // sum (dl / dxhat * -1 / stdInv) + variance *
-  // (sum -2 * (x - mu)) / m.
-  g.each_row() += arma::sum(normReshaped.each_row() % -stdInv, 0) /
-      inputReshaped.n_rows;
-  g.reshape(input.n_rows, input.n_cols);
+  // With dxhat = dl / dy * gamma, the gradient with respect to the input is
+  // stdInv * (dxhat - mean(dxhat) - xhat * mean(dxhat * xhat)) for each group.
+  for (size_t i = 0; i < groups; ++i)
+  {
+    const size_t row = (i % groupCount) * groupSize;
+    const eT* error = gy.memptr() + i * groupSize;
+    const double* xhat = normalized.memptr() + i * groupSize;
+
+    double normSum = 0.0, normDot = 0.0;
+    for (size_t r = 0; r < groupSize; ++r)
+    {
+      const double dxhat = error[r] * expandedGamma[row + r];
+      normSum += dxhat;
+      normDot += dxhat * xhat[r];
+    }
+    normSum /= groupSize;
+    normDot /= groupSize;
+
+    const double stdInv = 1.0 / std::sqrt(variance(i) + eps);
+    eT* delta = g.memptr() + i * groupSize;
+    for (size_t r = 0; r < groupSize; ++r)
+    {
+      delta[r] = stdInv * (error[r] * expandedGamma[row + r] - normSum -
+          xhat[r] * normDot);
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -153,22 +164,20 @@ void GroupNorm<InputDataType, OutputDataType>::Gradient(
 {
   assert(error.n_rows % size == 0);
   const size_t channelSize = error.n_rows / size;
-  temp = arma::sum(normalized % error, 1);
-  arma::mat tempReshaped((temp).memptr(),
-      channelSize, temp.n_elem / channelSize, false, false);
 
-  gradient.set_size(size + size, 1);
+  gradient.zeros(size + size, 1);
 
-  // Step 5: dl / dy * xhat.
-  gradient.submat(0, 0, gamma.n_elem - 1, 0) = arma::sum(tempReshaped, 0).t();
-
-  temp = arma::sum(error, 1);
-  arma::mat tempErrorReshaped((temp).memptr(),
-      channelSize, temp.n_elem / channelSize, false, false);
-
-  // Step 6: dl / dy.
-  gradient.submat(gamma.n_elem, 0, gradient.n_elem - 1, 0) =
-      arma::sum(tempErrorReshaped, 0).t();
+  // Step 5: dl / dy * xhat, and step 6: dl / dy, in the same pass.
+  for (size_t c = 0; c < error.n_cols; ++c)
+  {
+    const eT* e = error.colptr(c);
+    const double* xhat = normalized.colptr(c);
+    for (size_t r = 0; r < error.n_rows; ++r)
+    {
+      gradient[r / channelSize] += xhat[r] * e[r];
+      gradient[size + r / channelSize] += e[r];
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -45,6 +45,8 @@
 #include "layer_types.hpp"
 #include "leaky_relu.hpp"
 #include "linear.hpp"
+#include "fused_linear.hpp"
+#include "fused_lstm.hpp"
 #include "linear_no_bias.hpp"
 #include "linear3d.hpp"
 #include "log_softmax.hpp"
@@ -63,6 +65,8 @@
 #include "parametric_relu.hpp"
 #include "pixel_shuffle.hpp"
 #include "positional_encoding.hpp"
+#include "quantized_convolution.hpp"
+#include "quantized_linear.hpp"
 #include "recurrent_attention.hpp"
 #include "recurrent.hpp"
 #include "reinforce_normal.hpp"
@@ -59,44 +59,61 @@ template<typename eT>
 void LayerNorm<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>& input, arma::Mat<eT>& output)
 {
-  mean = arma::mean(input, 0);
-  variance = arma::var(input, 1, 0);
+  output.set_size(arma::size(input));
+  normalized.set_size(arma::size(input));
+  mean.set_size(1, input.n_cols);
+  variance.set_size(1, input.n_cols);
 
-  // Normalize the input.
-  output = input.each_row() - mean;
-  inputMean = output;
-  output.each_row() /= arma::sqrt(variance + eps);
-
-  // Reused in the backward and gradient step.
-  normalized = output;
-
-  // Scale and shift the output.
-  output.each_col() %= gamma;
-  output.each_col() += beta;
+  for (size_t c = 0; c < input.n_cols; ++c)
+  {
+    const eT* x = input.colptr(c);
+    WelfordStatistics statistics;
+    statistics.Update(x, input.n_rows);
+    mean(c) = statistics.Mean();
+    variance(c) = statistics.Variance();
+
+    // Normalize, scale and shift the column while it is still in the cache.
+    // The normalized input is reused in the backward and gradient step.
+    const double invStd = 1.0 / std::sqrt(variance(c) + eps);
+    double* xhat = normalized.colptr(c);
+    eT* y = output.colptr(c);
+    for (size_t r = 0; r < input.n_rows; ++r)
+    {
+      xhat[r] = (x[r] - mean(c)) * invStd;
+      y[r] = xhat[r] * gamma[r] + beta[r];
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
 template<typename eT>
 void LayerNorm<InputDataType, OutputDataType>::Backward(
-    const arma::Mat<eT>& input, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+    const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
 {
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
-
-  // dl / dxhat.
-  const arma::mat norm = gy.each_col() % gamma;
-
-  // sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  const arma::mat var = arma::sum(norm % inputMean, 0) %
-      arma::pow(stdInv, 3.0) * -0.5;
+  g.set_size(arma::size(gy));
 
-  // dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
-  // dl / dmu * 1 / m.
-  g = (norm.each_row() % stdInv) + (inputMean.each_row() %
-      var * 2 / input.n_rows);
-
-  // sum (dl / dxhat * -1 / stdInv) + variance *
-  // (sum -2 * (x - mu)) / m.
-  g.each_row() += arma::sum(norm.each_row() % -stdInv, 0) / input.n_rows;
+  // With dxhat = dl / dy * gamma, the gradient with respect to the input is
+  // stdInv * (dxhat - mean(dxhat) - xhat * mean(dxhat * xhat)).
+  for (size_t c = 0; c < gy.n_cols; ++c)
+  {
+    const eT* error = gy.colptr(c);
+    const double* xhat = normalized.colptr(c);
+
+    double normSum = 0.0, normDot = 0.0;
+    for (size_t r = 0; r < gy.n_rows; ++r)
+    {
+      const double dxhat = error[r] * gamma[r];
+      normSum += dxhat;
+      normDot += dxhat * xhat[r];
+    }
+    normSum /= gy.n_rows;
+    normDot /= gy.n_rows;
+
+    const double stdInv = 1.0 / std::sqrt(variance(c) + eps);
+    eT* delta = g.colptr(c);
+    for (size_t r = 0; r < gy.n_rows; ++r)
+      delta[r] = stdInv * (error[r] * gamma[r] - normSum - xhat[r] * normDot);
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -106,14 +123,19 @@ void LayerNorm<InputDataType, OutputDataType>::Gradient(
     const arma::Mat<eT>& error,
     arma::Mat<eT>& gradient)
 {
-  gradient.set_size(size + size, 1);
+  gradient.zeros(size + size, 1);
 
-  // Step 5: dl / dy * xhat.
-  gradient.submat(0, 0, gamma.n_elem - 1, 0) = arma::sum(normalized % error, 1);
-
-  // Step 6: dl / dy.
-  gradient.submat(gamma.n_elem, 0, gradient.n_elem - 1, 0) =
-      arma::sum(error, 1);
+  // Step 5: dl / dy * xhat, and step 6: dl / dy, in the same pass.
+  for (size_t c = 0; c < error.n_cols; ++c)
+  {
+    const eT* e = error.colptr(c);
+    const double* xhat = normalized.colptr(c);
+    for (size_t r = 0; r < error.n_rows; ++r)
+    {
+      gradient[r] += xhat[r] * e[r];
+      gradient[size + r] += e[r];
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
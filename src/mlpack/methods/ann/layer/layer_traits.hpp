@@ -88,6 +88,10 @@ HAS_MEM_FUNC(Reset, HasResetCheck);
 // we can use with SFINAE to catch when a type has a ResetCell() function.
 HAS_MEM_FUNC(ResetCell, HasResetCellCheck);
 
+// This gives us a HasCarryCellCheck<T, U> type (where U is a function pointer)
+// we can use with SFINAE to catch when a type has a CarryCell() function.
+HAS_MEM_FUNC(CarryCell, HasCarryCellCheck);
+
 // This gives us a HasRewardCheck<T, U> type (where U is a function pointer) we
 // can use with SFINAE to catch when a type has a Reward() function.
 HAS_MEM_FUNC(Reward, HasRewardCheck);
@@ -120,6 +124,11 @@ HAS_MEM_FUNC(Bias, HasBiasCheck);
 // we can use with SFINAE to catch when a type has a MaxIterations() function.
 HAS_MEM_FUNC(MaxIterations, HasMaxIterations);
 
+// This gives us a HasUsedColumnsCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when a type has a UsedColumns()
+// function.
+HAS_MEM_FUNC(UsedColumns, HasUsedColumnsCheck);
+
 // This gives us a HasInShapeCheck<T> type we can use with SFINAE to catch when
 // a type has a function named InputShape.
 HAS_ANY_METHOD_FORM(InputShape, HasInputShapeCheck);
@@ -67,6 +67,7 @@
 #include <mlpack/methods/ann/convolution_rules/border_modes.hpp>
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 
 // Regularizers.
 #include <mlpack/methods/ann/regularizer/no_regularizer.hpp>
@@ -84,6 +85,7 @@ template<typename InputDataType, typename OutputDataType> class LayerNorm;
 template<typename InputDataType, typename OutputDataType> class LSTM;
 template<typename InputDataType, typename OutputDataType> class GRU;
 template<typename InputDataType, typename OutputDataType> class FastLSTM;
+template<typename InputDataType, typename OutputDataType> class FusedLSTM;
 template<typename InputDataType, typename OutputDataType> class VRClassReward;
 template<typename InputDataType, typename OutputDataType> class Concatenate;
 template<typename InputDataType, typename OutputDataType> class Padding;
@@ -99,6 +101,19 @@ template<typename InputDataType,
          typename Activation>
 class RBF;
 
+template<typename ActivationFunction,
+         typename InputDataType,
+         typename OutputDataType>
+class FusedLinear;
+
+template<typename InputDataType,
+         typename OutputDataType>
+class QuantizedLinear;
+
+template<typename InputDataType,
+         typename OutputDataType>
+class QuantizedConvolution;
+
 template<typename InputDataType,
          typename OutputDataType,
          typename RegularizerType>
@@ -251,7 +266,20 @@ using MoreTypes = boost::variant<
         ISRLU<arma::mat, arma::mat>*,
         BicubicInterpolation<arma::mat, arma::mat>*,
         NearestInterpolation<arma::mat, arma::mat>*,
-        GroupNorm<arma::mat, arma::mat>*
+        GroupNorm<arma::mat, arma::mat>*,
+        FusedLinear<IdentityFunction, arma::mat, arma::mat>*,
+        FusedLinear<RectifierFunction, arma::mat, arma::mat>*,
+        FusedLinear<LogisticFunction, arma::mat, arma::mat>*,
+        FusedLinear<TanhFunction, arma::mat, arma::mat>*,
+        QuantizedLinear<arma::mat, arma::mat>*,
+        QuantizedConvolution<arma::mat, arma::mat>*,
+        Convolution<Im2ColConvolution<ValidConvolution>,
+                    Im2ColConvolution<FullConvolution>,
+                    Im2ColConvolution<ValidConvolution>,
+                    arma::mat, arma::mat>*,
+        FusedLSTM<arma::mat, arma::mat>*,
+        BaseLayer<FastLogisticFunction, arma::mat, arma::mat>*,
+        BaseLayer<FastTanhFunction, arma::mat, arma::mat>*
 >;
 
 template <typename... CustomLayers>
@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/ann/regularizer/no_regularizer.hpp>
+#include <mlpack/methods/ann/util/device_gemm.hpp>
 
 #include "layer_types.hpp"
 
@@ -194,6 +195,10 @@ class Linear
 
   //! Locally-stored regularizer object.
   RegularizerType regularizer;
+
+  //! Copy of the weights on the GPU, made once per batch (only used with
+  //! Bandicoot).
+  DeviceMatrix<typename OutputDataType::elem_type> deviceWeight;
 }; // class Linear
 
 } // namespace ann
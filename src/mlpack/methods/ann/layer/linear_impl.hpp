@@ -101,9 +101,10 @@ template<typename InputDataType, typename OutputDataType,
     typename RegularizerType>
 void Linear<InputDataType, OutputDataType, RegularizerType>::Reset()
 {
-  weight = arma::mat(weights.memptr(), outSize, inSize, false, false);
-  bias = arma::mat(weights.memptr() + weight.n_elem,
+  weight = OutputDataType(weights.memptr(), outSize, inSize, false, false);
+  bias = OutputDataType(weights.memptr() + weight.n_elem,
       outSize, 1, false, false);
+  deviceWeight.Invalidate();
 }
 
 template<typename InputDataType, typename OutputDataType,
@@ -112,7 +113,9 @@ template<typename eT>
 void Linear<InputDataType, OutputDataType, RegularizerType>::Forward(
     const arma::Mat<eT>& input, arma::Mat<eT>& output)
 {
-  output = weight * input;
+  // The weights may have changed since the last batch.
+  deviceWeight.Invalidate();
+  DeviceGemm(weight, false, input, false, output, &deviceWeight);
   output.each_col() += bias;
 }
 
@@ -122,7 +125,7 @@ template<typename eT>
 void Linear<InputDataType, OutputDataType, RegularizerType>::Backward(
     const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
 {
-  g = weight.t() * gy;
+  DeviceGemm(weight, true, gy, false, g, &deviceWeight);
 }
 
 template<typename InputDataType, typename OutputDataType,
@@ -133,8 +136,9 @@ void Linear<InputDataType, OutputDataType, RegularizerType>::Gradient(
     const arma::Mat<eT>& error,
     arma::Mat<eT>& gradient)
 {
-  gradient.submat(0, 0, weight.n_elem - 1, 0) = arma::vectorise(
-      error * input.t());
+  arma::Mat<eT> weightGradient(gradient.memptr(), outSize, inSize, false,
+      true);
+  DeviceGemm(error, false, input, true, weightGradient);
   gradient.submat(weight.n_elem, 0, gradient.n_elem - 1, 0) =
       arma::sum(error, 1);
   regularizer.Evaluate(weights, gradient);
@@ -75,6 +75,12 @@ class Lookup
 
   /**
    * Calculate the gradient using the output delta and the input activation.
+   * Only the columns of the tokens of the batch are nonzero; they can be
+   * obtained afterwards with UsedColumns().  If the gradient matrix is the
+   * one of the layer (see Gradient()) and was used by the previous call, as
+   * when the layer is part of an FFN, only the columns of the previous batch
+   * are cleared instead of the whole embedding table, so the matrix must not be
+   * modified between the calls except by clearing it.
    *
    * @param input The input parameter used for calculating the gradient.
    * @param error The calculated error.
@@ -111,6 +117,10 @@ class Lookup
   //! Get the length of each embedding vector.
   size_t EmbeddingSize() const { return embeddingSize; }
 
+  //! Get the sorted indices of the columns of the embedding table used by the
+  //! last call to Gradient(), that is, its only nonzero columns.
+  const arma::uvec& UsedColumns() const { return usedColumns; }
+
   /**
    * Serialize the layer
    */
@@ -135,6 +145,12 @@ class Lookup
 
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
+
+  //! The columns of the embedding table used by the last batch.
+  arma::uvec usedColumns;
+
+  //! The memory of the gradient of the last call to Gradient().
+  const void* lastGradient;
 }; // class Lookup
 
 // Alias for using as embedding layer.
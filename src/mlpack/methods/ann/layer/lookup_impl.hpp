@@ -24,7 +24,8 @@ Lookup<InputDataType, OutputDataType>::Lookup(
     const size_t vocabSize,
     const size_t embeddingSize) :
     vocabSize(vocabSize),
-    embeddingSize(embeddingSize)
+    embeddingSize(embeddingSize),
+    lastGradient(NULL)
 {
   weights.set_size(embeddingSize, vocabSize);
 }
@@ -72,14 +73,32 @@ void Lookup<InputDataType, OutputDataType>::Gradient(
   arma::Cube<eT> errorTemp(const_cast<arma::Mat<eT>&>(error).memptr(),
       embeddingSize, seqLength, batchSize, false, false);
 
-  gradient.set_size(arma::size(weights));
-  gradient.zeros();
+  // The gradient of a large embedding table is mostly zero, so if the gradient
+  // is the one of the layer and was used by the previous call, only the columns
+  // of the previous batch are cleared.
+  if (static_cast<const void*>(&gradient) ==
+      static_cast<const void*>(&this->gradient) &&
+      gradient.memptr() == lastGradient &&
+      gradient.n_rows == weights.n_rows && gradient.n_cols == weights.n_cols)
+  {
+    for (size_t i = 0; i < usedColumns.n_elem; ++i)
+      gradient.col(usedColumns[i]).zeros();
+  }
+  else
+  {
+    gradient.set_size(arma::size(weights));
+    gradient.zeros();
+  }
 
   for (size_t i = 0; i < batchSize; ++i)
   {
     gradient.cols(arma::conv_to<arma::uvec>::from(input.col(i)) - 1)
         += errorTemp.slice(i);
   }
+
+  usedColumns = arma::unique(
+      arma::conv_to<arma::uvec>::from(arma::vectorise(input)) - 1);
+  lastGradient = gradient.memptr();
 }
 
 template<typename InputDataType, typename OutputDataType>
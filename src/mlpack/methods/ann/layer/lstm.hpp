@@ -140,6 +140,18 @@ class LSTM
    */
   void ResetCell(const size_t size);
 
+  /*
+   * Resets the cell like ResetCell(), but the next sequence starts from the
+   * output and the cell state after the last step of the previous forward
+   * pass instead of from zero.  This breaks the BPTT chain, but not the
+   * recurrence, so a long sequence can be given in consecutive parts.  If the
+   * batch size of the next forward pass is not the same, the state is reset to
+   * zero.
+   *
+   * @param size The current maximum number of steps through time.
+   */
+  void CarryCell(const size_t size);
+
   /*
    * Calculate the gradient using the output delta and the input activation.
    *
@@ -349,6 +361,13 @@ class LSTM
 
   //! Current backpropagate through time steps.
   size_t bpttSteps;
+
+  //! Whether a step has been computed since the last reset of the cell.
+  bool hasState;
+
+  //! The cell before the first step, if the state was carried over by
+  //! CarryCell() (and empty otherwise).
+  OutputDataType initialCell;
 }; // class LSTM
 
 } // namespace ann
@@ -19,7 +19,8 @@ namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
 template<typename InputDataType, typename OutputDataType>
-LSTM<InputDataType, OutputDataType>::LSTM()
+LSTM<InputDataType, OutputDataType>::LSTM() :
+    hasState(false)
 {
   // Nothing to do here.
 }
@@ -38,7 +39,8 @@ LSTM<InputDataType, OutputDataType>::LSTM(
     batchStep(layer.batchStep),
     gradientStepIdx(layer.gradientStepIdx),
     rhoSize(layer.rho),
-    bpttSteps(layer.bpttSteps)
+    bpttSteps(layer.bpttSteps),
+    hasState(false)
 {
   // Nothing to do here.
 }
@@ -57,7 +59,8 @@ LSTM<InputDataType, OutputDataType>::LSTM(
     batchStep(std::move(layer.batchStep)),
     gradientStepIdx(std::move(layer.gradientStepIdx)),
     rhoSize(std::move(layer.rho)),
-    bpttSteps(std::move(layer.bpttSteps))
+    bpttSteps(std::move(layer.bpttSteps)),
+    hasState(false)
 {
   // Nothing to do here.
 }
@@ -81,6 +84,8 @@ LSTM<InputDataType, OutputDataType> :: operator=(const LSTM& layer)
     grad = layer.grad;
     rhoSize = layer.rho;
     bpttSteps = layer.bpttSteps;
+    hasState = false;
+    initialCell.reset();
   }
   return *this;
 }
@@ -104,6 +109,8 @@ LSTM<InputDataType, OutputDataType> :: operator=(LSTM&& layer)
     grad = std::move(layer.grad);
     rhoSize = std::move(layer.rho);
     bpttSteps = std::move(layer.bpttSteps);
+    hasState = false;
+    initialCell.reset();
   }
   return *this;
 }
@@ -121,7 +128,8 @@ LSTM<InputDataType, OutputDataType>::LSTM(
     batchStep(0),
     gradientStepIdx(0),
     rhoSize(rho),
-    bpttSteps(0)
+    bpttSteps(0),
+    hasState(false)
 {
   weights.set_size(WeightSize(), 1);
 }
@@ -133,6 +141,8 @@ void LSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
     return;
 
   rhoSize = size;
+  hasState = false;
+  initialCell.reset();
 
   if (batchSize == 0)
     return;
@@ -165,6 +175,38 @@ void LSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
   outParameter.zeros(outSize, (size + 1) * batchSize);
 }
 
+template<typename InputDataType, typename OutputDataType>
+void LSTM<InputDataType, OutputDataType>::CarryCell(const size_t size)
+{
+  if (size == std::numeric_limits<size_t>::max())
+    return;
+
+  // Take the state after the last step that was computed; if no step was
+  // computed since the last reset, keep the state that was carried over then.
+  OutputDataType lastOutput, lastCell;
+  if (batchSize > 0 && hasState)
+  {
+    const size_t last = ((forwardStep == 0) ? bpttSteps :
+        forwardStep / batchSize) - 1;
+    lastOutput = outParameter.cols((last + 1) * batchSize,
+        (last + 2) * batchSize - 1);
+    lastCell = cell.cols(last * batchSize, (last + 1) * batchSize - 1);
+  }
+  else if (batchSize > 0 && !initialCell.is_empty())
+  {
+    lastOutput = outParameter.cols(0, batchStep);
+    lastCell = std::move(initialCell);
+  }
+
+  ResetCell(size);
+
+  if (!lastCell.is_empty())
+  {
+    outParameter.cols(0, batchStep) = lastOutput;
+    initialCell = std::move(lastCell);
+  }
+}
+
 template<typename InputDataType, typename OutputDataType>
 void LSTM<InputDataType, OutputDataType>::Reset()
 {
@@ -293,6 +335,14 @@ void LSTM<InputDataType, OutputDataType>::Forward(const InputType& input,
         arma::repmat(cell2GateForgetWeight, 1, batchSize) %
         cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep);
   }
+  else if (!initialCell.is_empty())
+  {
+    // The state was carried over from the previous sequence.
+    inputGate.cols(0, batchStep) += arma::repmat(cell2GateInputWeight, 1,
+        batchSize) % initialCell;
+    forgetGate.cols(0, batchStep) += arma::repmat(cell2GateForgetWeight, 1,
+        batchSize) % initialCell;
+  }
 
   inputGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
       (1 + arma::exp(-inputGate.cols(forwardStep, forwardStep + batchStep)));
@@ -310,12 +360,18 @@ void LSTM<InputDataType, OutputDataType>::Forward(const InputType& input,
   hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep) =
       arma::tanh(hiddenLayer.cols(forwardStep, forwardStep + batchStep));
 
-  if (forwardStep == 0)
+  if (forwardStep == 0 && initialCell.is_empty())
   {
     cell.cols(forwardStep, forwardStep + batchStep) =
         inputGateActivation.cols(forwardStep, forwardStep + batchStep) %
         hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep);
   }
+  else if (forwardStep == 0)
+  {
+    cell.cols(0, batchStep) = forgetGateActivation.cols(0, batchStep) %
+        initialCell + inputGateActivation.cols(0, batchStep) %
+        hiddenLayerActivation.cols(0, batchStep);
+  }
   else
   {
     cell.cols(forwardStep, forwardStep + batchStep) =
@@ -350,6 +406,7 @@ void LSTM<InputDataType, OutputDataType>::Forward(const InputType& input,
   cellState = OutputType(cell.memptr() +
       forwardStep * outSize, outSize, batchSize, false, false);
 
+  hasState = true;
   forwardStep += batchSize;
   if ((forwardStep / batchSize) == bpttSteps)
   {
@@ -398,6 +455,12 @@ void LSTM<InputDataType, OutputDataType>::Backward(
       backwardStep - batchStep, backwardStep) % (1.0 -
       forgetGateActivation.cols(backwardStep - batchStep, backwardStep)));
   }
+  else if (!initialCell.is_empty())
+  {
+    forgetGateError = initialCell % cellError % (forgetGateActivation.cols(
+        backwardStep - batchStep, backwardStep) % (1.0 -
+        forgetGateActivation.cols(backwardStep - batchStep, backwardStep)));
+  }
   else
   {
     forgetGateError.zeros();
@@ -517,6 +580,14 @@ void LSTM<InputDataType, OutputDataType>::Gradient(
                   cell.cols((gradientStep - batchSize) - batchStep,
                             (gradientStep - batchSize)), 1);
   }
+  else if (!initialCell.is_empty())
+  {
+    gradient.submat(offset, 0, offset + cell2GateForgetWeight.n_elem - 1, 0) =
+        arma::sum(forgetGateError % initialCell, 1);
+    gradient.submat(offset + cell2GateForgetWeight.n_elem, 0, offset +
+        cell2GateForgetWeight.n_elem + cell2GateInputWeight.n_elem - 1, 0) =
+        arma::sum(inputGateError % initialCell, 1);
+  }
   else
   {
     gradient.submat(offset, 0, offset +
@@ -560,6 +631,13 @@ void LSTM<InputDataType, OutputDataType>::serialize(
   ar(CEREAL_NVP(cellActivation));
   ar(CEREAL_NVP(prevError));
   ar(CEREAL_NVP(outParameter));
+
+  // A state carried over by CarryCell() is not saved.
+  if (cereal::is_loading<Archive>())
+  {
+    hasState = false;
+    initialCell.reset();
+  }
 }
 
 } // namespace ann
@@ -48,6 +48,25 @@ namespace ann /** Artificial Neural Network. */ {
  * of shape `(embedDim * tgtSeqLen, batchSize)`. The embeddings are stored
  * consequently.
  *
+ * By default the attention weights of shape `(tgtSeqLen, srcSeqLen)` are
+ * stored for every head and every point in the batch.  If a block size is
+ * given, the attention is computed block by block instead: the softmax
+ * normalizers are found with a streaming (online) log-sum-exp pass, the
+ * attention weights of each block are recomputed when they are needed in the
+ * backward pass, and only the normalizers are kept.  The memory used then
+ * grows linearly with the sequence lengths instead of quadratically, at the
+ * cost of computing the scores more than once; the results are the same.
+ *
+ * For autoregressive generation, the layer can be switched to decoding mode
+ * with Decoding().  Each call to Forward() then takes the query, key and value
+ * of the next step(s) only, laid out as above with one sequence element each,
+ * and appends the projected query, key and value to a cache that holds up to
+ * srcSeqLen steps.  The output is the output of the new step(s) that
+ * Forward() on the whole prefix (with the corresponding part of the masks)
+ * gives, but each step only costs time linear in the length of the prefix.
+ * The cache is cleared with ResetCache(), before each new sequence.  Backward()
+ * and Gradient() are not available in decoding mode.
+ *
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
  * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
@@ -74,11 +93,14 @@ class MultiheadAttention
    * @param srcSeqLen Source sequence length.
    * @param embedDim Total dimension of the model.
    * @param numHeads Number of parallel attention heads.
+   * @param blockSize Number of sequence elements in each block of the
+   *     attention weights; 0 stores the full attention weights.
    */
   MultiheadAttention(const size_t tgtSeqLen,
                      const size_t srcSeqLen,
                      const size_t embedDim,
-                     const size_t numHeads);
+                     const size_t numHeads,
+                     const size_t blockSize = 0);
 
   /**
    * Reset the layer parameters.
@@ -149,6 +171,22 @@ class MultiheadAttention
   //! Modify the number of attention heads.
   size_t& NumHeads() { return numHeads; }
 
+  //! Get whether the layer is in decoding mode.
+  bool Decoding() const { return decoding; }
+  //! Modify whether the layer is in decoding mode.
+  bool& Decoding() { return decoding; }
+
+  //! Get the number of steps held by the decoding cache.
+  size_t CacheLength() const { return cacheLength; }
+
+  //! Clear the decoding cache, so that the next step is the first one.
+  void ResetCache() { cacheLength = 0; }
+
+  //! Get the block size of the attention weights (0 if they are stored).
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the block size of the attention weights (0 if they are stored).
+  size_t& BlockSize() { return blockSize; }
+
   //! Get the two dimensional Attention Mask.
   OutputDataType const& AttentionMask() const { return attnMask; }
   //! Modify the two dimensional Attention Mask.
@@ -181,6 +219,10 @@ class MultiheadAttention
 
   size_t InputShape() const
   {
+    // In decoding mode, the input holds a single step.
+    if (decoding)
+      return 3 * embedDim;
+
     return embedDim * (tgtSeqLen + 2 * srcSeqLen);
   }
 
@@ -188,6 +230,55 @@ class MultiheadAttention
   //! Element Type of the input.
   typedef typename OutputDataType::elem_type ElemType;
 
+  /**
+   * Forward pass in decoding mode: append the given step(s) to the cache and
+   * compute their output.
+   */
+  template<typename eT>
+  void DecodingForward(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+
+  //! Get the value of the attention and key padding masks for the score of
+  //! target i and source j.
+  ElemType MaskValue(const size_t i, const size_t j) const;
+
+  /**
+   * Compute the attention output of each head from qProj, kProj and vProj
+   * block by block, and store the log-sum-exp of each column of scores.
+   *
+   * @param slices The number of heads times the batch size.
+   */
+  void BlockedForward(const size_t slices);
+
+  /**
+   * Compute the masked scores of the block of target rows [rowBegin, rowEnd]
+   * and source columns [colBegin, colEnd] of the given slice.  If normalize
+   * is true, the scores are turned into attention weights with the stored
+   * log-sum-exp values.
+   */
+  void BlockScores(const size_t slice,
+                   const size_t rowBegin,
+                   const size_t rowEnd,
+                   const size_t colBegin,
+                   const size_t colEnd,
+                   const bool normalize,
+                   arma::Mat<ElemType>& block);
+
+  /**
+   * Backpropagate the error of the attention output of each head to the
+   * projected query (not yet divided by sqrt(headDim)), key and value.
+   *
+   * @param gy The error of attnOut, of shape
+   *     (tgtSeqLen, headDim, numHeads * batchSize).
+   * @param dQuery The error of qProj.
+   * @param dKey The error of kProj.
+   * @param dValue The error of vProj.
+   */
+  template<typename eT>
+  void AttentionBackward(const arma::Cube<eT>& gy,
+                         arma::Cube<eT>& dQuery,
+                         arma::Cube<eT>& dKey,
+                         arma::Cube<eT>& dValue);
+
   //! Target sequence length.
   size_t tgtSeqLen;
 
@@ -203,6 +294,15 @@ class MultiheadAttention
   //! Dimensionality of each head.
   size_t headDim;
 
+  //! Number of sequence elements in each block of the attention weights.
+  size_t blockSize;
+
+  //! Whether the layer is in decoding mode.
+  bool decoding;
+
+  //! Number of steps held by the decoding cache.
+  size_t cacheLength;
+
   //! Two dimensional Attention Mask of shape (tgtSeqLen, srcSeqLen).
   OutputDataType attnMask;
 
@@ -251,6 +351,28 @@ class MultiheadAttention
   //! Locally-stored attention output weight to be fed to last linear layer.
   arma::Cube<ElemType> attnOut;
 
+  //! Locally-stored log-sum-exp of each column of scores, of shape
+  //! (srcSeqLen, numHeads * batchSize); only used if blockSize > 0.
+  arma::Mat<ElemType> logSumExp;
+
+  //! Decoding cache of the scaled projected queries of each head, of shape
+  //! (srcSeqLen, headDim, numHeads * batchSize).
+  arma::Cube<ElemType> queryCache;
+
+  //! Decoding cache of the projected keys of each head.
+  arma::Cube<ElemType> keyCache;
+
+  //! Decoding cache of the projected values of each head.
+  arma::Cube<ElemType> valueCache;
+
+  //! Running maximum of each column of scores over the cached steps, of shape
+  //! (srcSeqLen, numHeads * batchSize).
+  arma::Mat<ElemType> columnMax;
+
+  //! Running sum of the exponentials of each column of scores (relative to
+  //! columnMax) over the cached steps.
+  arma::Mat<ElemType> columnSum;
+
   //! Softmax layer to represent the probabilities of next sequence.
   Softmax<InputDataType, OutputDataType> softmax;
 
@@ -29,7 +29,10 @@ MultiheadAttention() :
     srcSeqLen(0),
     embedDim(0),
     numHeads(0),
-    headDim(0)
+    headDim(0),
+    blockSize(0),
+    decoding(false),
+    cacheLength(0)
 {
   // Nothing to do here.
 }
@@ -41,11 +44,15 @@ MultiheadAttention(
     const size_t tgtSeqLen,
     const size_t srcSeqLen,
     const size_t embedDim,
-    const size_t numHeads) :
+    const size_t numHeads,
+    const size_t blockSize) :
     tgtSeqLen(tgtSeqLen),
     srcSeqLen(srcSeqLen),
     embedDim(embedDim),
-    numHeads(numHeads)
+    numHeads(numHeads),
+    blockSize(blockSize),
+    decoding(false),
+    cacheLength(0)
 {
   if (embedDim % numHeads != 0)
   {
@@ -90,6 +97,12 @@ Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
 {
   typedef typename arma::Cube<eT> CubeType;
 
+  if (decoding)
+  {
+    DecodingForward(input, output);
+    return;
+  }
+
   if (input.n_rows != embedDim * (tgtSeqLen + 2 * srcSeqLen))
   {
     Log::Fatal << "Incorrect input dimensions!" << std::endl;
@@ -139,42 +152,52 @@ Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
   kProj.reshape(srcSeqLen, headDim, numHeads * batchSize);
   vProj.reshape(srcSeqLen, headDim, numHeads * batchSize);
 
-  // Calculate the scores i.e. perform the matrix multiplication operation
-  // on qProj and kProj. Here score = qProj . kProj'
-  scores = math::MultiplyCube2Cube(qProj, kProj, false, true);
-
-  // Apply the attention mask if provided. The attention mask is used to black-
-  // out future sequences and generally used in Encoder-Decoder attention.
-  // The attention mask has elements 0 or -infinity.
+  // The attention mask is used to black-out future sequences and generally
+  // used in Encoder-Decoder attention.  The key padding mask blacks-out any
+  // particular word in the sequence.  Both masks have elements 0 or -infinity.
   // The shape of the attention mask : (tgtSeqLen, srcSeqLen).
-  if (!attnMask.is_empty())
+  // The shape of keyPaddingMask : (1, srcSeqLen).
+  if (!attnMask.is_empty() &&
+      (attnMask.n_rows != tgtSeqLen || attnMask.n_cols != srcSeqLen))
   {
-    if (attnMask.n_rows != tgtSeqLen || attnMask.n_cols != srcSeqLen)
-      Log::Fatal << "The size of the 'attn_mask' is not correct.\n";
-    scores.each_slice() += attnMask;
+    Log::Fatal << "The size of the 'attn_mask' is not correct.\n";
   }
 
-  // Apply the key padding mask when provided. It blacks-out any particular
-  // word in the sequence.
-  // The key padding mask has elements 0 or -infinity.
-  // The shape of keyPaddingMask : (1, srcSeqLen).
-  if (!keyPaddingMask.is_empty())
+  if (!keyPaddingMask.is_empty() &&
+      (keyPaddingMask.n_rows != 1 || keyPaddingMask.n_cols != srcSeqLen))
   {
-    if (keyPaddingMask.n_rows != 1 || keyPaddingMask.n_cols != srcSeqLen)
-        Log::Fatal << "The size of the 'keyPaddingMask' is not correct.\n";
-    scores.each_slice() += arma::repmat(keyPaddingMask, tgtSeqLen, 1);
+    Log::Fatal << "The size of the 'keyPaddingMask' is not correct.\n";
   }
 
-  for (size_t i = 0; i < numHeads * batchSize; ++i)
+  if (blockSize > 0)
   {
-    softmax.Forward(scores.slice(i), softmax.OutputParameter());
-    scores.slice(i) = softmax.OutputParameter();
+    // The attention weights are computed block by block and never stored.
+    scores.reset();
+    BlockedForward(numHeads * batchSize);
+  }
+  else
+  {
+    // Calculate the scores i.e. perform the matrix multiplication operation
+    // on qProj and kProj. Here score = qProj . kProj'
+    scores = math::MultiplyCube2Cube(qProj, kProj, false, true);
+
+    if (!attnMask.is_empty())
+      scores.each_slice() += attnMask;
+
+    if (!keyPaddingMask.is_empty())
+      scores.each_slice() += arma::repmat(keyPaddingMask, tgtSeqLen, 1);
+
+    for (size_t i = 0; i < numHeads * batchSize; ++i)
+    {
+      softmax.Forward(scores.slice(i), softmax.OutputParameter());
+      scores.slice(i) = softmax.OutputParameter();
+    }
+
+    // Calculate the attention output i.e. matrix multiplication of softmax
+    // output and vProj.
+    // The shape of attnOutput : (tgtSeqLen, headDim, numHeads * batchSize).
+    attnOut = math::MultiplyCube2Cube(scores, vProj, false, false);
   }
-
-  // Calculate the attention output i.e. matrix multiplication of softmax
-  // output and vProj.
-  // The shape of attnOutput : (tgtSeqLen, headDim, numHeads * batchSize).
-  attnOut = math::MultiplyCube2Cube(scores, vProj, false, false);
 
   // Now we will concatenate output of all the heads i.e. we will reshape
   // attnOut to (tgtSeqLen, embedDim, batchSize).
@@ -198,6 +221,9 @@ Backward(const arma::Mat<eT>& /* input */,
 {
   typedef typename arma::Cube<eT> CubeType;
 
+  if (decoding)
+    Log::Fatal << "Backward() is not available in decoding mode!" << std::endl;
+
   if (gy.n_rows != tgtSeqLen * embedDim)
   {
     Log::Fatal << "Backpropagated error has incorrect dimensions!" << std::endl;
@@ -223,60 +249,38 @@ Backward(const arma::Mat<eT>& /* input */,
   // The shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
   gyTemp.reshape(tgtSeqLen, headDim, numHeads * batchSize);
 
-  // Obtain backpropagted error of value.
-  // Shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
-  // Shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The shape of tmp : (srcSeqLen, headDim, numHeads * batchSize).
-  CubeType tmp = math::MultiplyCube2Cube(scores, gyTemp, true, false);
+  // Obtain the backpropagated errors of the projected query, key and value.
+  // The shape of dQuery : (tgtSeqLen, headDim, numHeads * batchSize).
+  // The shape of dKey and dValue : (srcSeqLen, headDim, numHeads * batchSize).
+  CubeType dQuery, dKey, dValue;
+  AttentionBackward(gyTemp, dQuery, dKey, dValue);
 
   // Concatenate results of all the attention heads.
-  tmp.reshape(srcSeqLen, embedDim, batchSize);
+  dValue.reshape(srcSeqLen, embedDim, batchSize);
 
   for (size_t i = 0; i < batchSize; ++i)
   {
     g.submat((tgtSeqLen + srcSeqLen) * embedDim, i, g.n_rows - 1, i)
-        = arma::vectorise(arma::trans(tmp.slice(i) * valueWt));
-  }
-
-  // The shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
-  // The shape of vProj : (srcSeqLen, headDim, numHeads * batchSize).
-  // So the new shape of gyTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  gyTemp = math::MultiplyCube2Cube(gyTemp, vProj, false, true);
-
-  for (size_t i = 0; i < numHeads * batchSize; ++i)
-  {
-    // We will perform backpropagation of softmax over each slice of gyTemp.
-    softmax.Backward(scores.slice(i), gyTemp.slice(i), gyTemp.slice(i));
+        = arma::vectorise(arma::trans(dValue.slice(i) * valueWt));
   }
 
-  // Obtain backpropagated error of key.
-  // The shape of qProj : (tgtSeqLen, headDim, numHeads * batchSize).
-  // The shape of gyTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The new shape of tmp : (srcSeqLen, headDim, numHeads * batchSize).
-  tmp = math::MultiplyCube2Cube(gyTemp, qProj, true, false);
-
   // Concatenate results of all the attention heads.
-  tmp.reshape(srcSeqLen, embedDim, batchSize);
+  dKey.reshape(srcSeqLen, embedDim, batchSize);
 
   for (size_t i = 0; i < batchSize; ++i)
   {
     g.submat(tgtSeqLen * embedDim, i, (tgtSeqLen + srcSeqLen) * embedDim - 1, i)
-        = arma::vectorise(arma::trans(tmp.slice(i) * keyWt));
+        = arma::vectorise(arma::trans(dKey.slice(i) * keyWt));
   }
 
-  // Obtain backpropagated error of the query.
-  // The shape of kProj : (srcSeqLen, headDim, numHeads * batchSize).
-  // The shape of gyTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The new shape of tmp : (tgtSeqLen, headDim, numHeads * batchSize).
-  tmp = math::MultiplyCube2Cube(gyTemp, kProj) / std::sqrt(headDim);
-
   // Concatenate results of all the attention heads.
-  tmp.reshape(tgtSeqLen, embedDim, batchSize);
+  dQuery /= std::sqrt(headDim);
+  dQuery.reshape(tgtSeqLen, embedDim, batchSize);
 
   for (size_t i = 0; i < batchSize; ++i)
   {
     g.submat(0, i, tgtSeqLen * embedDim - 1, i)
-        = arma::vectorise(arma::trans(tmp.slice(i) * queryWt));
+        = arma::vectorise(arma::trans(dQuery.slice(i) * queryWt));
   }
 }
 
@@ -291,6 +295,9 @@ Gradient(const arma::Mat<eT>& input,
   typedef typename arma::Cube<eT> CubeType;
   typedef typename arma::Mat<eT> MatType;
 
+  if (decoding)
+    Log::Fatal << "Gradient() is not available in decoding mode!" << std::endl;
+
   if (input.n_rows != embedDim * (tgtSeqLen + 2 * srcSeqLen))
   {
     Log::Fatal << "Incorrect input dimensions!" << std::endl;
@@ -343,10 +350,11 @@ Gradient(const arma::Mat<eT>& input,
   // (tgtSeqLen, headDim, numHeads * batchSize).
   gyTemp.reshape(tgtSeqLen, headDim, numHeads * batchSize);
 
-  // Shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
-  // Shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The new shape of errorTemp : (srcSeqLen, headDim, numHeads * batchSize).
-  errorTemp = math::MultiplyCube2Cube(scores, gyTemp, true, false);
+  // Obtain the backpropagated errors of the projected query, key and value.
+  // The shape of errorTemp (the error of the value) : (srcSeqLen, headDim,
+  // numHeads * batchSize).
+  CubeType dQuery, dKey;
+  AttentionBackward(gyTemp, dQuery, dKey, errorTemp);
 
   // Now we will concatenate the propagated errors from all heads i.e. we
   // will reshape errorTemp to (srcSeqLen, embedDim, batchSize).
@@ -367,26 +375,9 @@ Gradient(const arma::Mat<eT>& input,
   gradient.rows(2 * wtSize, 3 * wtSize - 1)
       = arma::vectorise(arma::sum(errorTemp, 2));
 
-  // Now, the shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
-  // The shape of vProj : (srcSeqLen, headDim, numHeads * batchSize).
-  // The new shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  errorTemp = math::MultiplyCube2Cube(gyTemp, vProj, false, true);
-
-  for (size_t i = 0; i < numHeads * batchSize; ++i)
-  {
-    // The shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-    // The shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-    // The new shape of errorTemp remain same.
-    softmax.Backward(scores.slice(i), errorTemp.slice(i), errorTemp.slice(i));
-  }
-
-  // The shape of qProj : (tgtSeqLen, headDim, numHeads * batchSize).
-  // The shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The shape of gyTemp : (srcSeqLen, headDim, numHeads * batchSize).
-  gyTemp = math::MultiplyCube2Cube(errorTemp, qProj, true, false);
-
-  // We will now conctenate the propagated errors from all heads.
+  // We will now conctenate the propagated errors of the key from all heads.
   // The new shape of gyTemp : (srcSeqLen, embedDim, batchSize).
+  gyTemp = std::move(dKey);
   gyTemp.reshape(srcSeqLen, embedDim, batchSize);
 
   // Gradient wrt. kBias, i.e. dL/d(kBias). We will take summation over all the
@@ -403,12 +394,8 @@ Gradient(const arma::Mat<eT>& input,
   // batches of dkeyWt.
   gradient.rows(wtSize, 2 * wtSize - 1) = arma::vectorise(arma::sum(gyTemp, 2));
 
-  // The shape of kProj : (srcSeqLen, headDim, numHeads * batchSize).
-  // The shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
-  gyTemp = math::MultiplyCube2Cube(errorTemp, kProj, false, false);
-
-  // Now, we will concatenate propagated error of all heads.
+  // Now, we will concatenate propagated error of the query of all heads.
+  gyTemp = std::move(dQuery);
   gyTemp.reshape(tgtSeqLen, embedDim, batchSize);
   gyTemp /= std::sqrt(headDim);
 
@@ -430,6 +417,337 @@ Gradient(const arma::Mat<eT>& input,
   regularizer.Evaluate(weights, gradient);
 }
 
+template <typename InputDataType, typename OutputDataType,
+          typename RegularizerType>
+template <typename eT>
+void MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
+DecodingForward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  typedef typename arma::Mat<eT> MatType;
+  typedef typename arma::Cube<eT> CubeType;
+
+  if (input.n_rows == 0 || input.n_rows % (3 * embedDim) != 0)
+  {
+    Log::Fatal << "Incorrect input dimensions!" << std::endl;
+  }
+
+  const size_t steps = input.n_rows / (3 * embedDim);
+  const size_t batchSize = input.n_cols;
+  const size_t slices = numHeads * batchSize;
+
+  if (cacheLength > 0 && queryCache.n_slices != slices)
+  {
+    Log::Fatal << "The batch size changed while decoding; call ResetCache() "
+        << "before each new sequence!" << std::endl;
+  }
+
+  if (cacheLength + steps > srcSeqLen)
+  {
+    Log::Fatal << "The decoding cache is full; it holds " << srcSeqLen
+        << " steps!" << std::endl;
+  }
+
+  if (!attnMask.is_empty() &&
+      (attnMask.n_rows < srcSeqLen || attnMask.n_cols != srcSeqLen))
+  {
+    Log::Fatal << "The size of the 'attn_mask' is not correct.\n";
+  }
+
+  if (!keyPaddingMask.is_empty() &&
+      (keyPaddingMask.n_rows != 1 || keyPaddingMask.n_cols != srcSeqLen))
+  {
+    Log::Fatal << "The size of the 'keyPaddingMask' is not correct.\n";
+  }
+
+  // The cache is allocated once for the whole sequence.
+  if (queryCache.n_rows != srcSeqLen || queryCache.n_cols != headDim ||
+      queryCache.n_slices != slices)
+  {
+    queryCache.set_size(srcSeqLen, headDim, slices);
+    keyCache.set_size(srcSeqLen, headDim, slices);
+    valueCache.set_size(srcSeqLen, headDim, slices);
+    columnMax.set_size(srcSeqLen, slices);
+    columnSum.set_size(srcSeqLen, slices);
+  }
+
+  // The query, key and value of the new steps are laid out in the same way as
+  // the query, key and value of Forward().
+  const CubeType q(const_cast<MatType&>(input).memptr(),
+      embedDim, steps, batchSize, false, false);
+  const CubeType k(const_cast<MatType&>(input).memptr() +
+      embedDim * steps * batchSize, embedDim, steps, batchSize, false, false);
+  const CubeType v(const_cast<MatType&>(input).memptr() +
+      2 * embedDim * steps * batchSize, embedDim, steps, batchSize, false,
+      false);
+
+  output.set_size(embedDim * steps, batchSize);
+
+  const eT inf = std::numeric_limits<eT>::infinity();
+  arma::Row<eT> qRow, kRow, vRow, attnRow(embedDim), rowScores;
+  arma::Col<eT> colScores;
+  for (size_t t = 0; t < steps; ++t)
+  {
+    const size_t p = cacheLength + t;
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      qRow = arma::trans(queryWt * q.slice(b).col(t) + qBias) /
+          std::sqrt(headDim);
+      kRow = arma::trans(keyWt * k.slice(b).col(t) + kBias);
+      vRow = arma::trans(valueWt * v.slice(b).col(t) + vBias);
+
+      for (size_t h = 0; h < numHeads; ++h)
+      {
+        const size_t s = b * numHeads + h;
+        const size_t first = h * headDim;
+        const size_t last = (h + 1) * headDim - 1;
+        queryCache.slice(s).row(p) = qRow.cols(first, last);
+        keyCache.slice(s).row(p) = kRow.cols(first, last);
+        valueCache.slice(s).row(p) = vRow.cols(first, last);
+
+        // The softmax is taken over each column of scores.  The column of the
+        // new key is computed against all the cached queries.
+        colScores = queryCache.slice(s).rows(0, p) *
+            arma::trans(keyCache.slice(s).row(p));
+        for (size_t i = 0; i <= p; ++i)
+          colScores[i] += MaskValue(i, p);
+
+        columnMax(p, s) = colScores.max();
+        columnSum(p, s) = (columnMax(p, s) == -inf) ? 0 :
+            arma::accu(arma::exp(colScores - columnMax(p, s)));
+
+        // The new query adds one score to each of the earlier columns.
+        rowScores = queryCache.slice(s).row(p) *
+            arma::trans(keyCache.slice(s).rows(0, p));
+        rowScores[p] = colScores[p];
+        for (size_t j = 0; j < p; ++j)
+        {
+          rowScores[j] += MaskValue(p, j);
+
+          const eT newMax = std::max(columnMax(j, s), rowScores[j]);
+          if (newMax == -inf)
+            continue;
+
+          columnSum(j, s) = columnSum(j, s) *
+              std::exp(columnMax(j, s) - newMax) +
+              std::exp(rowScores[j] - newMax);
+          columnMax(j, s) = newMax;
+        }
+
+        // Turn the scores of the new query into attention weights.
+        for (size_t j = 0; j <= p; ++j)
+        {
+          rowScores[j] = (columnMax(j, s) == -inf) ? 0 :
+              std::exp(rowScores[j] - columnMax(j, s)) / columnSum(j, s);
+        }
+
+        attnRow.cols(first, last) = rowScores * valueCache.slice(s).rows(0, p);
+      }
+
+      output.submat(t * embedDim, b, (t + 1) * embedDim - 1, b) =
+          arma::trans(attnRow * outWt + outBias);
+    }
+  }
+
+  cacheLength += steps;
+}
+
+template <typename InputDataType, typename OutputDataType,
+          typename RegularizerType>
+typename OutputDataType::elem_type
+MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
+MaskValue(const size_t i, const size_t j) const
+{
+  ElemType value = 0;
+  if (!attnMask.is_empty())
+    value += attnMask(i, j);
+  if (!keyPaddingMask.is_empty())
+    value += keyPaddingMask(j);
+
+  return value;
+}
+
+template <typename InputDataType, typename OutputDataType,
+          typename RegularizerType>
+void MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
+BlockedForward(const size_t slices)
+{
+  typedef typename arma::Mat<ElemType> MatType;
+
+  const ElemType inf = std::numeric_limits<ElemType>::infinity();
+  logSumExp.set_size(srcSeqLen, slices);
+  attnOut.set_size(tgtSeqLen, headDim, slices);
+
+  MatType block;
+  for (size_t s = 0; s < slices; ++s)
+  {
+    // The softmax is taken over each column of scores, so the first pass
+    // streams over the blocks of target rows and keeps a running maximum and
+    // a running sum of exponentials for each source column.
+    arma::Col<ElemType> maxScore(srcSeqLen);
+    maxScore.fill(-inf);
+    arma::Col<ElemType> sumExp(srcSeqLen, arma::fill::zeros);
+    for (size_t j = 0; j < srcSeqLen; j += blockSize)
+    {
+      const size_t jEnd = std::min(j + blockSize, srcSeqLen) - 1;
+      for (size_t i = 0; i < tgtSeqLen; i += blockSize)
+      {
+        const size_t iEnd = std::min(i + blockSize, tgtSeqLen) - 1;
+        BlockScores(s, i, iEnd, j, jEnd, false, block);
+
+        for (size_t c = 0; c < block.n_cols; ++c)
+        {
+          const ElemType newMax = std::max(maxScore[j + c],
+              (ElemType) block.col(c).max());
+          if (newMax == -inf)
+            continue;
+
+          sumExp[j + c] = sumExp[j + c] * std::exp(maxScore[j + c] - newMax) +
+              arma::accu(arma::exp(block.col(c) - newMax));
+          maxScore[j + c] = newMax;
+        }
+      }
+    }
+
+    for (size_t j = 0; j < srcSeqLen; ++j)
+    {
+      logSumExp(j, s) = (maxScore[j] == -inf) ? -inf :
+          maxScore[j] + std::log(sumExp[j]);
+    }
+
+    // The second pass recomputes the attention weights of each block and
+    // accumulates the attention output.
+    MatType output(attnOut.slice_memptr(s), tgtSeqLen, headDim, false, true);
+    output.zeros();
+    for (size_t j = 0; j < srcSeqLen; j += blockSize)
+    {
+      const size_t jEnd = std::min(j + blockSize, srcSeqLen) - 1;
+      for (size_t i = 0; i < tgtSeqLen; i += blockSize)
+      {
+        const size_t iEnd = std::min(i + blockSize, tgtSeqLen) - 1;
+        BlockScores(s, i, iEnd, j, jEnd, true, block);
+        output.rows(i, iEnd) += block * vProj.slice(s).rows(j, jEnd);
+      }
+    }
+  }
+}
+
+template <typename InputDataType, typename OutputDataType,
+          typename RegularizerType>
+void MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
+BlockScores(const size_t slice,
+            const size_t rowBegin,
+            const size_t rowEnd,
+            const size_t colBegin,
+            const size_t colEnd,
+            const bool normalize,
+            arma::Mat<ElemType>& block)
+{
+  block = qProj.slice(slice).rows(rowBegin, rowEnd) *
+      kProj.slice(slice).rows(colBegin, colEnd).t();
+
+  if (!attnMask.is_empty())
+    block += attnMask.submat(rowBegin, colBegin, rowEnd, colEnd);
+
+  if (!keyPaddingMask.is_empty())
+    block.each_row() += keyPaddingMask.cols(colBegin, colEnd);
+
+  if (!normalize)
+    return;
+
+  const ElemType inf = std::numeric_limits<ElemType>::infinity();
+  for (size_t c = 0; c < block.n_cols; ++c)
+  {
+    const ElemType lse = logSumExp(colBegin + c, slice);
+    if (lse == -inf)
+      block.col(c).zeros();
+    else
+      block.col(c) = arma::exp(block.col(c) - lse);
+  }
+}
+
+template <typename InputDataType, typename OutputDataType,
+          typename RegularizerType>
+template<typename eT>
+void MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
+AttentionBackward(const arma::Cube<eT>& gy,
+                  arma::Cube<eT>& dQuery,
+                  arma::Cube<eT>& dKey,
+                  arma::Cube<eT>& dValue)
+{
+  typedef typename arma::Mat<eT> MatType;
+  typedef typename arma::Cube<eT> CubeType;
+
+  if (blockSize == 0)
+  {
+    // Shape of gy : (tgtSeqLen, headDim, numHeads * batchSize).
+    // Shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
+    // The shape of dValue : (srcSeqLen, headDim, numHeads * batchSize).
+    dValue = math::MultiplyCube2Cube(scores, gy, true, false);
+
+    // The shape of vProj : (srcSeqLen, headDim, numHeads * batchSize).
+    // The shape of dScores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
+    CubeType dScores = math::MultiplyCube2Cube(gy, vProj, false, true);
+    for (size_t i = 0; i < dScores.n_slices; ++i)
+    {
+      // We will perform backpropagation of softmax over each slice.
+      softmax.Backward(scores.slice(i), dScores.slice(i), dScores.slice(i));
+    }
+
+    // The shape of dKey : (srcSeqLen, headDim, numHeads * batchSize).
+    dKey = math::MultiplyCube2Cube(dScores, qProj, true, false);
+    // The shape of dQuery : (tgtSeqLen, headDim, numHeads * batchSize).
+    dQuery = math::MultiplyCube2Cube(dScores, kProj);
+    return;
+  }
+
+  dQuery.zeros(tgtSeqLen, headDim, gy.n_slices);
+  dKey.zeros(srcSeqLen, headDim, gy.n_slices);
+  dValue.zeros(srcSeqLen, headDim, gy.n_slices);
+
+  MatType block, dScores;
+  for (size_t s = 0; s < gy.n_slices; ++s)
+  {
+    // The first pass recomputes the attention weights and accumulates the
+    // error of the value.
+    for (size_t j = 0; j < srcSeqLen; j += blockSize)
+    {
+      const size_t jEnd = std::min(j + blockSize, srcSeqLen) - 1;
+      for (size_t i = 0; i < tgtSeqLen; i += blockSize)
+      {
+        const size_t iEnd = std::min(i + blockSize, tgtSeqLen) - 1;
+        BlockScores(s, i, iEnd, j, jEnd, true, block);
+        dValue.slice(s).rows(j, jEnd) += block.t() * gy.slice(s).rows(i, iEnd);
+      }
+    }
+
+    // The softmax backward pass of column j needs the sum over the targets of
+    // the attention weights times their error, which is the dot product of
+    // the value j and its error.
+    const arma::Col<eT> weightedError = arma::sum(vProj.slice(s) %
+        dValue.slice(s), 1);
+
+    // The second pass recomputes the attention weights again and
+    // backpropagates through the softmax to the query and the key.
+    for (size_t j = 0; j < srcSeqLen; j += blockSize)
+    {
+      const size_t jEnd = std::min(j + blockSize, srcSeqLen) - 1;
+      for (size_t i = 0; i < tgtSeqLen; i += blockSize)
+      {
+        const size_t iEnd = std::min(i + blockSize, tgtSeqLen) - 1;
+        BlockScores(s, i, iEnd, j, jEnd, true, block);
+
+        dScores = gy.slice(s).rows(i, iEnd) * vProj.slice(s).rows(j, jEnd).t();
+        dScores.each_row() -= weightedError.subvec(j, jEnd).t();
+        dScores %= block;
+
+        dQuery.slice(s).rows(i, iEnd) += dScores * kProj.slice(s).rows(j, jEnd);
+        dKey.slice(s).rows(j, jEnd) += dScores.t() *
+            qProj.slice(s).rows(i, iEnd);
+      }
+    }
+  }
+}
+
 template <typename InputDataType, typename OutputDataType,
           typename RegularizerType>
 template <typename Archive>
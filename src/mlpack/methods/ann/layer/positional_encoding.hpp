@@ -25,6 +25,12 @@ namespace ann /** Artificial Neural Network. */ {
  * `(embedDim * maxSequenceLength, batchSize)`. The embeddings are stored
  * consequently.
  *
+ * In incremental mode (see Incremental()), used for autoregressive decoding,
+ * each call to Forward() takes the embeddings of the next step(s) only, of
+ * shape `(embedDim * steps, batchSize)`, and adds the encoding of the
+ * positions that follow the steps seen so far.  The position is reset with
+ * ResetOffset(), before each new sequence.
+ *
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
  * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
@@ -93,8 +99,23 @@ class PositionalEncoding
   //! Get the positional encoding vector.
   InputDataType const& Encoding() const { return positionalEncoding; }
 
+  //! Get whether the layer is in incremental mode.
+  bool Incremental() const { return incremental; }
+  //! Modify whether the layer is in incremental mode.
+  bool& Incremental() { return incremental; }
+
+  //! Get the position of the next step in incremental mode.
+  size_t Offset() const { return offset; }
+
+  //! Start a new sequence in incremental mode.
+  void ResetOffset() { offset = 0; }
+
   size_t InputShape() const
   {
+    // In incremental mode, the input holds a single step.
+    if (incremental)
+      return embedDim;
+
     return embedDim * maxSequenceLength;
   }
 
@@ -119,6 +140,12 @@ class PositionalEncoding
   //! Locally-stored positional encodings.
   InputDataType positionalEncoding;
 
+  //! Whether the layer is in incremental mode.
+  bool incremental;
+
+  //! The position of the next step in incremental mode.
+  size_t offset;
+
   //! Locally-stored delta object.
   OutputDataType delta;
 
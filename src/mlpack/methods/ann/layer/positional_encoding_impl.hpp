@@ -22,7 +22,9 @@ namespace ann /** Artificial Neural Network. */ {
 template<typename InputDataType, typename OutputDataType>
 PositionalEncoding<InputDataType, OutputDataType>::PositionalEncoding() :
     embedDim(0),
-    maxSequenceLength(0)
+    maxSequenceLength(0),
+    incremental(false),
+    offset(0)
 {
   // Nothing to do here.
 }
@@ -32,7 +34,9 @@ PositionalEncoding<InputDataType, OutputDataType>::PositionalEncoding(
     const size_t embedDim,
     const size_t maxSequenceLength) :
     embedDim(embedDim),
-    maxSequenceLength(maxSequenceLength)
+    maxSequenceLength(maxSequenceLength),
+    incremental(false),
+    offset(0)
 {
   InitPositionalEncoding();
 }
@@ -58,6 +62,24 @@ template<typename eT>
 void PositionalEncoding<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>& input, arma::Mat<eT>& output)
 {
+  if (incremental)
+  {
+    if (input.n_rows == 0 || input.n_rows % embedDim != 0)
+      Log::Fatal << "Incorrect input dimensions!" << std::endl;
+
+    const size_t steps = input.n_rows / embedDim;
+    if (offset + steps > maxSequenceLength)
+    {
+      Log::Fatal << "The sequence is longer than the maximum sequence length "
+          << "(" << maxSequenceLength << ")!" << std::endl;
+    }
+
+    output = input.each_col() + positionalEncoding.rows(offset * embedDim,
+        (offset + steps) * embedDim - 1);
+    offset += steps;
+    return;
+  }
+
   if (input.n_rows != embedDim * maxSequenceLength)
     Log::Fatal << "Incorrect input dimensions!" << std::endl;
 
@@ -0,0 +1,214 @@
+/**
+ * @file methods/ann/layer/quantized_convolution.hpp
+ *
+ * Definition of the QuantizedConvolution layer class, an inference-only
+ * convolution layer with int8 weights and activations.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/util/int8_gemm.hpp>
+
+#include "layer_types.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Implementation of the QuantizedConvolution layer class, the int8 counterpart
+ * of the Convolution layer for inference.  The kernels are quantized
+ * symmetrically with one scale for each output map, and the input is
+ * quantized symmetrically with a single scale, found by calibration (see
+ * QuantizeNetwork()).  The convolution is computed on the int8 values with
+ * int32 accumulation, in the same way as NaiveConvolution with
+ * ValidConvolution (after padding), and then scaled back and shifted by the
+ * bias, so the output of the layer is a regular (floating-point) activation.
+ *
+ * The layer has no trainable parameters and no backward pass: it is built
+ * from a trained Convolution layer, and only used for inference.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class QuantizedConvolution
+{
+ public:
+  //! Create the QuantizedConvolution object.
+  QuantizedConvolution();
+
+  /**
+   * Create the QuantizedConvolution layer by quantizing the kernels of the
+   * given (trained) convolution layer.  The layer must have its parameters
+   * set, so that its Weight() and Bias() are valid.
+   *
+   * @param layer The convolution layer to quantize.
+   * @param inputScale The scale of the quantized inputs (the largest absolute
+   *     input value divided by 127).
+   */
+  template<typename ConvolutionType>
+  QuantizedConvolution(const ConvolutionType& layer, const double inputScale);
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+
+  /**
+   * The backward pass is not supported by quantized layers; this throws a
+   * std::logic_error.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>& /* input */,
+                const arma::Mat<eT>& /* gy */,
+                arma::Mat<eT>& /* g */);
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the input width.
+  size_t InputWidth() const { return inputWidth; }
+  //! Modify input the width.
+  size_t& InputWidth() { return inputWidth; }
+
+  //! Get the input height.
+  size_t InputHeight() const { return inputHeight; }
+  //! Modify the input height.
+  size_t& InputHeight() { return inputHeight; }
+
+  //! Get the output width.
+  size_t OutputWidth() const { return outputWidth; }
+  //! Modify the output width.
+  size_t& OutputWidth() { return outputWidth; }
+
+  //! Get the output height.
+  size_t OutputHeight() const { return outputHeight; }
+  //! Modify the output height.
+  size_t& OutputHeight() { return outputHeight; }
+
+  //! Get the number of input maps.
+  size_t InputSize() const { return inSize; }
+
+  //! Get the number of output maps.
+  size_t OutputSize() const { return outSize; }
+
+  //! Get the quantized kernels; column o * InputSize() + i holds the kernel of
+  //! output map o and input map i.
+  const arma::Mat<int8_t>& QuantizedWeights() const { return weights; }
+
+  //! Get the scale of the kernels of each output map.
+  const arma::vec& WeightScales() const { return weightScales; }
+
+  //! Get the bias.
+  const arma::vec& Bias() const { return bias; }
+
+  //! Get the scale of the quantized inputs.
+  double InputScale() const { return inputScale; }
+
+  //! Get the shape of the input.
+  size_t InputShape() const
+  {
+    return inputHeight * inputWidth * inSize;
+  }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Locally-stored number of input channels.
+  size_t inSize;
+
+  //! Locally-stored number of output channels.
+  size_t outSize;
+
+  //! Locally-stored filter/kernel width.
+  size_t kernelWidth;
+
+  //! Locally-stored filter/kernel height.
+  size_t kernelHeight;
+
+  //! Locally-stored stride of the filter in x-direction.
+  size_t strideWidth;
+
+  //! Locally-stored stride of the filter in y-direction.
+  size_t strideHeight;
+
+  //! Locally-stored left-side padding width.
+  size_t padWLeft;
+
+  //! Locally-stored right-side padding width.
+  size_t padWRight;
+
+  //! Locally-stored bottom padding height.
+  size_t padHBottom;
+
+  //! Locally-stored top padding height.
+  size_t padHTop;
+
+  //! The quantized kernels (kernelWidth * kernelHeight x outSize * inSize).
+  arma::Mat<int8_t> weights;
+
+  //! The scale of the kernels of each output map.
+  arma::vec weightScales;
+
+  //! The bias of each output map.
+  arma::vec bias;
+
+  //! The scale of the quantized inputs.
+  double inputScale;
+
+  //! Locally-stored input width.
+  size_t inputWidth;
+
+  //! Locally-stored input height.
+  size_t inputHeight;
+
+  //! Locally-stored output width.
+  size_t outputWidth;
+
+  //! Locally-stored output height.
+  size_t outputHeight;
+
+  //! The padded, quantized input (workspace).
+  arma::Mat<int8_t> quantizedInput;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class QuantizedConvolution
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_convolution_impl.hpp"
+
+#endif
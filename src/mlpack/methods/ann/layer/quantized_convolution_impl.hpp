@@ -0,0 +1,195 @@
+/**
+ * @file methods/ann/layer/quantized_convolution_impl.hpp
+ *
+ * Implementation of the QuantizedConvolution layer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "quantized_convolution.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+QuantizedConvolution<InputDataType, OutputDataType>::QuantizedConvolution() :
+    inSize(0),
+    outSize(0),
+    kernelWidth(0),
+    kernelHeight(0),
+    strideWidth(0),
+    strideHeight(0),
+    padWLeft(0),
+    padWRight(0),
+    padHBottom(0),
+    padHTop(0),
+    inputScale(0.0),
+    inputWidth(0),
+    inputHeight(0),
+    outputWidth(0),
+    outputHeight(0)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename ConvolutionType>
+QuantizedConvolution<InputDataType, OutputDataType>::QuantizedConvolution(
+    const ConvolutionType& layer,
+    const double inputScale) :
+    inSize(layer.InputSize()),
+    outSize(layer.OutputSize()),
+    kernelWidth(layer.KernelWidth()),
+    kernelHeight(layer.KernelHeight()),
+    strideWidth(layer.StrideWidth()),
+    strideHeight(layer.StrideHeight()),
+    padWLeft(layer.PadWLeft()),
+    padWRight(layer.PadWRight()),
+    padHBottom(layer.PadHBottom()),
+    padHTop(layer.PadHTop()),
+    bias(arma::vectorise(layer.Bias())),
+    inputScale(inputScale),
+    inputWidth(layer.InputWidth()),
+    inputHeight(layer.InputHeight()),
+    outputWidth(layer.OutputWidth()),
+    outputHeight(layer.OutputHeight())
+{
+  const size_t kernelSize = kernelWidth * kernelHeight;
+  if (layer.Weight().n_elem != kernelSize * inSize * outSize)
+  {
+    throw std::invalid_argument("QuantizedConvolution::QuantizedConvolution(): "
+        "the parameters of the convolution layer are not set");
+  }
+
+  // One scale for each output map, shared by its kernels for all input maps.
+  weights.set_size(kernelSize, inSize * outSize);
+  weightScales.set_size(outSize);
+  for (size_t o = 0; o < outSize; ++o)
+  {
+    double maxWeight = 0.0;
+    for (size_t i = 0; i < inSize; ++i)
+    {
+      maxWeight = std::max(maxWeight,
+          arma::abs(layer.Weight().slice(o * inSize + i)).max());
+    }
+
+    weightScales[o] = maxWeight / 127.0;
+    const double invScale = (maxWeight > 0.0) ? 1.0 / weightScales[o] : 0.0;
+    for (size_t i = 0; i < inSize; ++i)
+    {
+      const arma::mat& kernel = layer.Weight().slice(o * inSize + i);
+      for (size_t k = 0; k < kernelSize; ++k)
+        weights(k, o * inSize + i) = Quantize(kernel[k], invScale);
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedConvolution<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  const size_t batchSize = input.n_cols;
+  const size_t paddedWidth = inputWidth + padWLeft + padWRight;
+  const size_t paddedHeight = inputHeight + padHTop + padHBottom;
+  outputWidth = (paddedWidth - kernelWidth) / strideWidth + 1;
+  outputHeight = (paddedHeight - kernelHeight) / strideHeight + 1;
+
+  // Quantize and pad each input map; the padding is zero, which is exact.
+  const double invScale = (inputScale > 0.0) ? 1.0 / inputScale : 0.0;
+  quantizedInput.zeros(paddedWidth * paddedHeight, inSize * batchSize);
+  for (size_t s = 0; s < inSize * batchSize; ++s)
+  {
+    const eT* in = input.memptr() + s * inputWidth * inputHeight;
+    int8_t* padded = quantizedInput.colptr(s);
+    for (size_t c = 0; c < inputHeight; ++c)
+    {
+      for (size_t r = 0; r < inputWidth; ++r)
+      {
+        padded[(c + padHTop) * paddedWidth + r + padWLeft] =
+            Quantize(in[c * inputWidth + r], invScale);
+      }
+    }
+  }
+
+  // The convolution is computed as in NaiveConvolution<ValidConvolution>, with
+  // int32 accumulation over all input maps.
+  const size_t mapSize = outputWidth * outputHeight;
+  output.set_size(mapSize * outSize, batchSize);
+  for (size_t b = 0; b < batchSize; ++b)
+  {
+    for (size_t o = 0; o < outSize; ++o)
+    {
+      eT* out = output.colptr(b) + o * mapSize;
+      const double scale = inputScale * weightScales[o];
+      for (size_t j = 0; j < outputHeight; ++j)
+      {
+        for (size_t i = 0; i < outputWidth; ++i)
+        {
+          int32_t acc = 0;
+          for (size_t m = 0; m < inSize; ++m)
+          {
+            const int8_t* in = quantizedInput.colptr(b * inSize + m);
+            const int8_t* kernel = weights.colptr(o * inSize + m);
+            for (size_t kj = 0; kj < kernelHeight; ++kj)
+            {
+              const int8_t* inPtr = in + (kj + j * strideWidth) * paddedWidth +
+                  i * strideHeight;
+              for (size_t ki = 0; ki < kernelWidth; ++ki, ++kernel)
+                acc += (int32_t) (*kernel) * inPtr[ki];
+            }
+          }
+
+          out[j * outputWidth + i] = scale * acc + bias[o];
+        }
+      }
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedConvolution<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>& /* input */,
+    const arma::Mat<eT>& /* gy */,
+    arma::Mat<eT>& /* g */)
+{
+  throw std::logic_error("QuantizedConvolution::Backward(): quantized layers "
+      "can only be used for inference");
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void QuantizedConvolution<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(inSize));
+  ar(CEREAL_NVP(outSize));
+  ar(CEREAL_NVP(kernelWidth));
+  ar(CEREAL_NVP(kernelHeight));
+  ar(CEREAL_NVP(strideWidth));
+  ar(CEREAL_NVP(strideHeight));
+  ar(CEREAL_NVP(padWLeft));
+  ar(CEREAL_NVP(padWRight));
+  ar(CEREAL_NVP(padHBottom));
+  ar(CEREAL_NVP(padHTop));
+  ar(CEREAL_NVP(weights));
+  ar(CEREAL_NVP(weightScales));
+  ar(CEREAL_NVP(bias));
+  ar(CEREAL_NVP(inputScale));
+  ar(CEREAL_NVP(inputWidth));
+  ar(CEREAL_NVP(inputHeight));
+  ar(CEREAL_NVP(outputWidth));
+  ar(CEREAL_NVP(outputHeight));
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
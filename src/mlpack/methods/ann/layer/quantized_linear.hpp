@@ -0,0 +1,165 @@
+/**
+ * @file methods/ann/layer/quantized_linear.hpp
+ *
+ * Definition of the QuantizedLinear layer class, an inference-only linear
+ * layer with int8 weights and activations.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/util/int8_gemm.hpp>
+
+#include "layer_types.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Implementation of the QuantizedLinear layer class, the int8 counterpart of
+ * the Linear layer for inference.  The weights are quantized symmetrically
+ * with one scale for each output unit, and the input is quantized
+ * symmetrically with a single scale, found by calibration (see
+ * QuantizeNetwork()).  The product is computed with Int8Gemm(), with int32
+ * accumulation, and then scaled back and shifted by the bias, so the output of
+ * the layer is a regular (floating-point) activation.
+ *
+ * The layer has no trainable parameters: it is built from a trained Linear
+ * layer, and the backward pass (which uses the dequantized weights) is only
+ * provided so that the layer can be part of any network.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class QuantizedLinear
+{
+ public:
+  //! Create the QuantizedLinear object.
+  QuantizedLinear();
+
+  /**
+   * Create the QuantizedLinear layer by quantizing the given weights.
+   *
+   * @param weight The weight matrix of the linear layer (outSize x inSize).
+   * @param bias The bias of the linear layer.
+   * @param inputScale The scale of the quantized inputs (the largest absolute
+   *     input value divided by 127).
+   */
+  QuantizedLinear(const arma::mat& weight,
+                  const arma::vec& bias,
+                  const double inputScale);
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, using the dequantized
+   * weights.
+   *
+   * @param * (input) The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>& /* input */,
+                const arma::Mat<eT>& gy,
+                arma::Mat<eT>& g);
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the input size.
+  size_t InputSize() const { return inSize; }
+
+  //! Get the output size.
+  size_t OutputSize() const { return outSize; }
+
+  //! Get the quantized weights, packed so that column i holds the weights of
+  //! output unit i.
+  const arma::Mat<int8_t>& QuantizedWeights() const { return weights; }
+
+  //! Get the scale of the weights of each output unit.
+  const arma::vec& WeightScales() const { return weightScales; }
+
+  //! Get the bias.
+  const arma::vec& Bias() const { return bias; }
+
+  //! Get the scale of the quantized inputs.
+  double InputScale() const { return inputScale; }
+
+  //! Get the shape of the input.
+  size_t InputShape() const
+  {
+    return inSize;
+  }
+
+  /**
+   * Serialize the layer
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of output units.
+  size_t outSize;
+
+  //! The quantized weights (inSize x outSize).
+  arma::Mat<int8_t> weights;
+
+  //! The scale of the weights of each output unit.
+  arma::vec weightScales;
+
+  //! The bias.
+  arma::vec bias;
+
+  //! The scale of the quantized inputs.
+  double inputScale;
+
+  //! The quantized input (workspace).
+  arma::Mat<int8_t> quantizedInput;
+
+  //! The int32 result of the product (workspace).
+  arma::Mat<int32_t> accumulator;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class QuantizedLinear
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_linear_impl.hpp"
+
+#endif
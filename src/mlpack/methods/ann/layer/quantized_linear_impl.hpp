@@ -0,0 +1,105 @@
+/**
+ * @file methods/ann/layer/quantized_linear_impl.hpp
+ *
+ * Implementation of the QuantizedLinear layer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "quantized_linear.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+QuantizedLinear<InputDataType, OutputDataType>::QuantizedLinear() :
+    inSize(0),
+    outSize(0),
+    inputScale(0.0)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+QuantizedLinear<InputDataType, OutputDataType>::QuantizedLinear(
+    const arma::mat& weight,
+    const arma::vec& bias,
+    const double inputScale) :
+    inSize(weight.n_cols),
+    outSize(weight.n_rows),
+    bias(bias),
+    inputScale(inputScale)
+{
+  if (bias.n_elem != outSize)
+  {
+    throw std::invalid_argument("QuantizedLinear::QuantizedLinear(): the bias "
+        "must have one element for each row of the weight matrix");
+  }
+
+  // One scale for each output unit; units with only zero weights get scale 0,
+  // and so zero quantized weights.
+  weights.set_size(inSize, outSize);
+  weightScales.set_size(outSize);
+  for (size_t o = 0; o < outSize; ++o)
+  {
+    weightScales[o] = arma::abs(weight.row(o)).max() / 127.0;
+    const double invScale = (weightScales[o] > 0.0) ?
+        1.0 / weightScales[o] : 0.0;
+    for (size_t i = 0; i < inSize; ++i)
+      weights(i, o) = Quantize(weight(o, i), invScale);
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedLinear<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  Quantize(input, inputScale, quantizedInput);
+  Int8Gemm(weights, quantizedInput, accumulator);
+
+  output.set_size(outSize, input.n_cols);
+  for (size_t j = 0; j < output.n_cols; ++j)
+  {
+    const int32_t* acc = accumulator.colptr(j);
+    eT* out = output.colptr(j);
+    for (size_t o = 0; o < outSize; ++o)
+      out[o] = inputScale * weightScales[o] * acc[o] + bias[o];
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedLinear<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+{
+  // The transposed dequantized weight matrix is the packed weight matrix, with
+  // column o scaled by the scale of output unit o.
+  arma::mat weightT = arma::conv_to<arma::mat>::from(weights);
+  weightT.each_row() %= weightScales.t();
+  g = weightT * gy;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void QuantizedLinear<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(inSize));
+  ar(CEREAL_NVP(outSize));
+  ar(CEREAL_NVP(weights));
+  ar(CEREAL_NVP(weightScales));
+  ar(CEREAL_NVP(bias));
+  ar(CEREAL_NVP(inputScale));
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_LAYER_SEQUENTIAL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/make_alias.hpp>
 
 #include "../visitor/delete_visitor.hpp"
 #include "../visitor/copy_visitor.hpp"
@@ -56,6 +57,22 @@ namespace ann /** Artificial Neural Network. */ {
  * Note: This class should at least have two layers for a call to its Gradient()
  *       function.
  *
+ * The block can be checkpointed (see Checkpoint()) to save memory during
+ * training.  A checkpointed block keeps only its input after Forward(), and
+ * releases the outputs of its layers.  Backward() recomputes them from the
+ * input, backpropagates through the layers, computes the gradient of the
+ * layers right away and then releases the outputs and the deltas of the
+ * layers again; Gradient() only copies the stored gradient.  This costs one
+ * more forward pass of the block.  Layers that draw random numbers during
+ * training (like Dropout<>) draw them again when the outputs are recomputed,
+ * so they should not be placed in a checkpointed block.
+ *
+ * Unless the block is a residual block or is checkpointed, the output of
+ * Forward() is an alias of the output of the last layer, and the delta of
+ * Backward() is an alias of the delta of the first layer, so no activations
+ * are copied.  They are valid until the next call to Forward() (or
+ * Backward()), and should be treated as read-only.
+ *
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
  * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
@@ -183,6 +200,12 @@ class Sequential
   //! Modify the gradient.
   arma::mat& Gradient() { return gradient; }
 
+  //! Get whether the activations of the block are recomputed in Backward().
+  bool Checkpoint() const { return checkpoint; }
+  //! Modify whether the activations of the block are recomputed in
+  //! Backward().
+  bool& Checkpoint() { return checkpoint; }
+
   size_t InputShape() const;
 
   /**
@@ -192,6 +215,22 @@ class Sequential
   void serialize(Archive& ar, const uint32_t /* version */);
 
  private:
+  /**
+   * Pass the input through the layers of the block; the output of the block
+   * is the output parameter of its last layer.
+   */
+  template<typename eT>
+  void ForwardLayers(const arma::Mat<eT>& input);
+
+  /**
+   * Compute the gradient of the layers of the block.
+   */
+  template<typename eT>
+  void GradientLayers(const arma::Mat<eT>& input, const arma::Mat<eT>& error);
+
+  //! Release the outputs and the deltas of the layers of the block.
+  void ReleaseActivations();
+
   //! Parameter which indicates if the modules should be exposed.
   bool model;
 
@@ -245,6 +284,16 @@ class Sequential
 
   //! Whether we are responsible for deleting the layers held in this module.
   bool ownsLayers;
+
+  //! Whether the activations of the block are recomputed in Backward().
+  bool checkpoint;
+
+  //! The input of the last Forward() call, if the block is checkpointed.
+  arma::mat checkpointInput;
+
+  //! The gradient of the layers computed in Backward(), if the block is
+  //! checkpointed.
+  arma::mat checkpointGradient;
 }; // class Sequential
 
 /*
@@ -19,9 +19,12 @@
 #include "../visitor/forward_visitor.hpp"
 #include "../visitor/backward_visitor.hpp"
 #include "../visitor/gradient_visitor.hpp"
+#include "../visitor/gradient_set_visitor.hpp"
+#include "../visitor/gradient_update_visitor.hpp"
 #include "../visitor/set_input_height_visitor.hpp"
 #include "../visitor/set_input_width_visitor.hpp"
 #include "../visitor/input_shape_visitor.hpp"
+#include "../visitor/weight_size_visitor.hpp"
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -30,7 +33,12 @@ template <typename InputDataType, typename OutputDataType, bool Residual,
           typename... CustomLayers>
 Sequential<InputDataType, OutputDataType, Residual, CustomLayers...>::
 Sequential(const bool model) :
-    model(model), reset(false), width(0), height(0), ownsLayers(!model)
+    model(model),
+    reset(false),
+    width(0),
+    height(0),
+    ownsLayers(!model),
+    checkpoint(false)
 {
   // Nothing to do here.
 }
@@ -39,7 +47,12 @@ template <typename InputDataType, typename OutputDataType, bool Residual,
           typename... CustomLayers>
 Sequential<InputDataType, OutputDataType, Residual, CustomLayers...>::
 Sequential(const bool model, const bool ownsLayers) :
-    model(model), reset(false), width(0), height(0), ownsLayers(ownsLayers)
+    model(model),
+    reset(false),
+    width(0),
+    height(0),
+    ownsLayers(ownsLayers),
+    checkpoint(false)
 {
   // Nothing to do here.
 }
@@ -52,7 +65,8 @@ Sequential(const Sequential& layer) :
     reset(layer.reset),
     width(layer.width),
     height(layer.height),
-    ownsLayers(layer.ownsLayers)
+    ownsLayers(layer.ownsLayers),
+    checkpoint(layer.checkpoint)
 {
   // Nothing to do here.
 }
@@ -70,6 +84,7 @@ operator = (const Sequential& layer)
     width = layer.width;
     height = layer.height;
     ownsLayers = layer.ownsLayers;
+    checkpoint = layer.checkpoint;
     parameters = layer.parameters;
     network.clear();
     // Build new layers according to source network.
@@ -118,6 +133,42 @@ template<typename InputDataType, typename OutputDataType, bool Residual,
 template<typename eT>
 void Sequential<InputDataType, OutputDataType, Residual, CustomLayers...>::
 Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  ForwardLayers(input);
+
+  // Unless the output is changed below, or the outputs of the layers are
+  // released, make it an alias of the output of the last layer instead of a
+  // copy.  That output stays valid until the next call to Forward().
+  if (Residual || checkpoint)
+    output = boost::apply_visitor(outputParameterVisitor, network.back());
+  else
+    output = math::MakeAlias(boost::apply_visitor(outputParameterVisitor,
+        network.back()), false);
+
+  if (Residual)
+  {
+    if (arma::size(output) != arma::size(input))
+    {
+      Log::Fatal << "The sizes of the output and input matrices of the Residual"
+          << " block should be equal. Please examine the network architecture."
+          << std::endl;
+    }
+    output += input;
+  }
+
+  // Only the input is needed to recompute the outputs of the layers.
+  if (checkpoint)
+  {
+    checkpointInput = input;
+    ReleaseActivations();
+  }
+}
+
+template<typename InputDataType, typename OutputDataType, bool Residual,
+         typename... CustomLayers>
+template<typename eT>
+void Sequential<InputDataType, OutputDataType, Residual, CustomLayers...>::
+ForwardLayers(const arma::Mat<eT>& input)
 {
   boost::apply_visitor(ForwardVisitor(input,
       boost::apply_visitor(outputParameterVisitor, network.front())),
@@ -172,19 +223,6 @@ Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
   {
     reset = true;
   }
-
-  output = boost::apply_visitor(outputParameterVisitor, network.back());
-
-  if (Residual)
-  {
-    if (arma::size(output) != arma::size(input))
-    {
-      Log::Fatal << "The sizes of the output and input matrices of the Residual"
-          << " block should be equal. Please examine the network architecture."
-          << std::endl;
-    }
-    output += input;
-  }
 }
 
 template<typename InputDataType, typename OutputDataType, bool Residual,
@@ -196,6 +234,9 @@ void Sequential<
         const arma::Mat<eT>& gy,
         arma::Mat<eT>& g)
 {
+  if (checkpoint)
+    ForwardLayers(checkpointInput);
+
   boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
       outputParameterVisitor, network.back()), gy,
       boost::apply_visitor(deltaVisitor, network.back())),
@@ -210,12 +251,40 @@ void Sequential<
         network[network.size() - i]);
   }
 
-  g = boost::apply_visitor(deltaVisitor, network.front());
+  // As in Forward(), alias the delta of the first layer if possible.
+  if (Residual || checkpoint)
+    g = boost::apply_visitor(deltaVisitor, network.front());
+  else
+    g = math::MakeAlias(boost::apply_visitor(deltaVisitor, network.front()),
+        false);
 
   if (Residual)
   {
     g += gy;
   }
+
+  if (checkpoint)
+  {
+    // Compute the gradient of the layers while their outputs and deltas are
+    // available.  The gradients of the layers are pointed at
+    // checkpointGradient for that; Gradient() copies it into the gradients
+    // that the network sets.
+    size_t size = 0;
+    for (size_t i = 0; i < network.size(); ++i)
+      size += boost::apply_visitor(WeightSizeVisitor(), network[i]);
+    checkpointGradient.set_size(size, 1);
+
+    size_t offset = 0;
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+      offset += boost::apply_visitor(GradientSetVisitor(checkpointGradient,
+          offset), network[i]);
+    }
+
+    GradientLayers(checkpointInput, gy);
+    ReleaseActivations();
+    checkpointInput.reset();
+  }
 }
 
 template<typename InputDataType, typename OutputDataType, bool Residual,
@@ -225,6 +294,27 @@ void Sequential<InputDataType, OutputDataType, Residual, CustomLayers...>::
 Gradient(const arma::Mat<eT>& input,
          const arma::Mat<eT>& error,
          arma::Mat<eT>& /* gradient */)
+{
+  if (checkpoint)
+  {
+    size_t offset = 0;
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+      offset += boost::apply_visitor(GradientUpdateVisitor(checkpointGradient,
+          offset), network[i]);
+    }
+
+    return;
+  }
+
+  GradientLayers(input, error);
+}
+
+template<typename InputDataType, typename OutputDataType, bool Residual,
+         typename... CustomLayers>
+template<typename eT>
+void Sequential<InputDataType, OutputDataType, Residual, CustomLayers...>::
+GradientLayers(const arma::Mat<eT>& input, const arma::Mat<eT>& error)
 {
   boost::apply_visitor(GradientVisitor(boost::apply_visitor(
       outputParameterVisitor, network[network.size() - 2]), error),
@@ -242,6 +332,18 @@ Gradient(const arma::Mat<eT>& input,
       boost::apply_visitor(deltaVisitor, network[1])), network.front());
 }
 
+template<typename InputDataType, typename OutputDataType, bool Residual,
+         typename... CustomLayers>
+void Sequential<InputDataType, OutputDataType, Residual, CustomLayers...>::
+ReleaseActivations()
+{
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    boost::apply_visitor(outputParameterVisitor, network[i]).reset();
+    boost::apply_visitor(deltaVisitor, network[i]).reset();
+  }
+}
+
 template<typename InputDataType, typename OutputDataType, bool Residual,
          typename... CustomLayers>
 template<typename Archive>
@@ -0,0 +1,190 @@
+/**
+ * @file methods/ann/layer_profiler.hpp
+ *
+ * Definition of the LayerProfiler class, which records the time spent in the
+ * Forward(), Backward() and Gradient() functions of each layer of a network.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_PROFILER_HPP
+#define MLPACK_METHODS_ANN_LAYER_PROFILER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <chrono>
+
+#include "visitor/delta_visitor.hpp"
+#include "visitor/layer_type_name_visitor.hpp"
+#include "visitor/output_parameter_visitor.hpp"
+#include "visitor/weight_size_visitor.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The LayerProfiler records the time spent in each pass (Forward(), Backward()
+ * and Gradient()) of each layer of an FFN or RNN, so that the layers that
+ * dominate the run time can be found without an external profiler.  It is
+ * disabled by default; when it is disabled, each layer call only costs a
+ * branch.
+ *
+ * For each layer, the profiler keeps the name of the layer type, the number of
+ * calls and the total time of each pass, the number of weights, and the
+ * largest output and delta seen (in bytes), which is the activation memory the
+ * layer holds.  Print() writes this as a table.  If Trace() is set, each call
+ * is also recorded as an event, and WriteTrace() writes all events in the
+ * Chrome trace event format, which can be loaded in chrome://tracing or
+ * Perfetto.  The events are kept in memory, so tracing should only be enabled
+ * for short runs.
+ *
+ * @code
+ * extern FFN<NegativeLogLikelihood<>> model;
+ * extern arma::mat trainData, trainLabels;
+ *
+ * model.Profiler().Enabled() = true;
+ * model.Train(trainData, trainLabels);
+ * model.Profiler().Print(std::cout);
+ * @endcode
+ */
+class LayerProfiler
+{
+ public:
+  //! The passes of a layer.
+  enum PassTypes
+  {
+    FORWARD,
+    BACKWARD,
+    GRADIENT
+  };
+
+  //! The statistics of one layer.
+  struct LayerStatistics
+  {
+    //! The name of the type of the layer.
+    std::string name;
+    //! The number of calls of each pass.
+    size_t calls[3];
+    //! The total time of each pass.
+    std::chrono::nanoseconds time[3];
+    //! The number of weights of the layer.
+    size_t weights;
+    //! The largest output of the layer, in bytes.
+    size_t outputBytes;
+    //! The largest delta of the layer, in bytes.
+    size_t deltaBytes;
+  };
+
+  //! One call of a pass of a layer.
+  struct TraceEvent
+  {
+    //! The index of the layer.
+    size_t layer;
+    //! The pass.
+    PassTypes pass;
+    //! The start of the call, relative to the creation (or the last Reset())
+    //! of the profiler.
+    std::chrono::nanoseconds start;
+    //! The duration of the call.
+    std::chrono::nanoseconds duration;
+  };
+
+  //! Create a disabled profiler.
+  LayerProfiler();
+
+  //! Get whether the profiler records the layer calls.
+  bool Enabled() const { return enabled; }
+  //! Modify whether the profiler records the layer calls.
+  bool& Enabled() { return enabled; }
+
+  //! Get whether each call is recorded as a trace event.
+  bool Trace() const { return trace; }
+  //! Modify whether each call is recorded as a trace event.
+  bool& Trace() { return trace; }
+
+  //! Discard all recorded statistics and events.
+  void Reset();
+
+  /**
+   * Mark the start of a layer call.  This does nothing if the profiler is
+   * disabled.
+   */
+  void Start()
+  {
+    if (enabled)
+      start = Clock::now();
+  }
+
+  /**
+   * Mark the end of the layer call started with the last call to Start(), and
+   * record it.  This does nothing if the profiler is disabled.
+   *
+   * @param index The index of the layer in the network.
+   * @param pass The pass of the layer that was called.
+   * @param layer The layer that was called.
+   */
+  template<typename LayerType>
+  void Stop(const size_t index, const PassTypes pass, LayerType& layer)
+  {
+    if (enabled)
+      Record(index, pass, layer);
+  }
+
+  //! Get the statistics of each layer.
+  const std::vector<LayerStatistics>& Statistics() const { return statistics; }
+  //! Get the recorded trace events.
+  const std::vector<TraceEvent>& Events() const { return events; }
+
+  /**
+   * Write a table with the statistics of each layer.
+   *
+   * @param stream The stream to write to.
+   */
+  void Print(std::ostream& stream) const;
+
+  /**
+   * Write the recorded trace events as a Chrome trace (JSON).
+   *
+   * @param stream The stream to write to.
+   */
+  void WriteTrace(std::ostream& stream) const;
+
+  /**
+   * Write the recorded trace events as a Chrome trace (JSON) to the given
+   * file.  A std::runtime_error is thrown if the file cannot be written.
+   *
+   * @param filename The name of the file to write to.
+   */
+  void WriteTrace(const std::string& filename) const;
+
+ private:
+  //! The clock used for all timings (the same as the one of Timer).
+  typedef std::chrono::high_resolution_clock Clock;
+
+  //! Record the call that has just ended.
+  template<typename LayerType>
+  void Record(const size_t index, const PassTypes pass, LayerType& layer);
+
+  //! Whether the profiler is enabled.
+  bool enabled;
+  //! Whether each call is recorded as a trace event.
+  bool trace;
+  //! The time the profiler was created or reset.
+  Clock::time_point epoch;
+  //! The start of the current layer call.
+  Clock::time_point start;
+  //! The statistics of each layer.
+  std::vector<LayerStatistics> statistics;
+  //! The recorded trace events.
+  std::vector<TraceEvent> events;
+}; // class LayerProfiler
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "layer_profiler_impl.hpp"
+
+#endif
@@ -0,0 +1,202 @@
+/**
+ * @file methods/ann/layer_profiler_impl.hpp
+ *
+ * Implementation of the LayerProfiler class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_PROFILER_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_PROFILER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "layer_profiler.hpp"
+
+#include <fstream>
+#include <iomanip>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+inline LayerProfiler::LayerProfiler() :
+    enabled(false),
+    trace(false),
+    epoch(Clock::now())
+{
+  // Nothing to do here.
+}
+
+inline void LayerProfiler::Reset()
+{
+  statistics.clear();
+  events.clear();
+  epoch = Clock::now();
+}
+
+template<typename LayerType>
+void LayerProfiler::Record(const size_t index,
+                           const PassTypes pass,
+                           LayerType& layer)
+{
+  const Clock::time_point end = Clock::now();
+  const std::chrono::nanoseconds duration =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+  if (index >= statistics.size())
+  {
+    const size_t oldSize = statistics.size();
+    statistics.resize(index + 1);
+    for (size_t i = oldSize; i <= index; ++i)
+    {
+      for (size_t p = 0; p < 3; ++p)
+      {
+        statistics[i].calls[p] = 0;
+        statistics[i].time[p] = std::chrono::nanoseconds(0);
+      }
+      statistics[i].weights = 0;
+      statistics[i].outputBytes = 0;
+      statistics[i].deltaBytes = 0;
+    }
+  }
+
+  LayerStatistics& s = statistics[index];
+  if (s.name.empty())
+  {
+    s.name = boost::apply_visitor(LayerTypeNameVisitor(), layer);
+    s.weights = boost::apply_visitor(WeightSizeVisitor(), layer);
+  }
+
+  s.calls[pass]++;
+  s.time[pass] += duration;
+  if (pass == FORWARD)
+  {
+    s.outputBytes = std::max(s.outputBytes, (size_t) boost::apply_visitor(
+        OutputParameterVisitor(), layer).n_elem * sizeof(double));
+  }
+  else if (pass == BACKWARD)
+  {
+    s.deltaBytes = std::max(s.deltaBytes, (size_t) boost::apply_visitor(
+        DeltaVisitor(), layer).n_elem * sizeof(double));
+  }
+
+  if (trace)
+  {
+    TraceEvent event;
+    event.layer = index;
+    event.pass = pass;
+    event.start = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        start - epoch);
+    event.duration = duration;
+    events.push_back(event);
+  }
+}
+
+inline void LayerProfiler::Print(std::ostream& stream) const
+{
+  double total = 0.0;
+  for (size_t i = 0; i < statistics.size(); ++i)
+    for (size_t p = 0; p < 3; ++p)
+      total += statistics[i].time[p].count();
+
+  const std::ios::fmtflags flags = stream.flags();
+  const std::streamsize precision = stream.precision();
+
+  stream << std::left << std::setw(6) << "layer" << std::setw(40) << "type"
+      << std::right << std::setw(10) << "calls" << std::setw(14)
+      << "forward (ms)" << std::setw(15) << "backward (ms)" << std::setw(15)
+      << "gradient (ms)" << std::setw(9) << "time %" << std::setw(12)
+      << "weights" << std::setw(14) << "output (KiB)" << std::endl;
+
+  stream << std::fixed;
+  for (size_t i = 0; i < statistics.size(); ++i)
+  {
+    const LayerStatistics& s = statistics[i];
+    if (s.name.empty())
+      continue;
+
+    // Long names are cut, so that the table stays aligned.
+    std::string name = s.name;
+    if (name.size() > 39)
+      name = name.substr(0, 36) + "...";
+
+    double layerTotal = 0.0;
+    for (size_t p = 0; p < 3; ++p)
+      layerTotal += s.time[p].count();
+
+    stream << std::left << std::setw(6) << i << std::setw(40) << name
+        << std::right << std::setw(10) << s.calls[FORWARD]
+        << std::setprecision(3)
+        << std::setw(14) << s.time[FORWARD].count() / 1e6
+        << std::setw(15) << s.time[BACKWARD].count() / 1e6
+        << std::setw(15) << s.time[GRADIENT].count() / 1e6
+        << std::setprecision(1)
+        << std::setw(9) << ((total > 0.0) ? 100.0 * layerTotal / total : 0.0)
+        << std::setw(12) << s.weights
+        << std::setw(14) << (s.outputBytes + s.deltaBytes) / 1024.0
+        << std::endl;
+  }
+
+  stream.flags(flags);
+  stream.precision(precision);
+}
+
+inline void LayerProfiler::WriteTrace(std::ostream& stream) const
+{
+  const char* passNames[3] = { "Forward", "Backward", "Gradient" };
+
+  const std::ios::fmtflags flags = stream.flags();
+  const std::streamsize precision = stream.precision();
+  stream << std::fixed << std::setprecision(3);
+
+  // The timestamps of the Chrome trace format are in microseconds.
+  stream << "{\"traceEvents\":[";
+  for (size_t i = 0; i < events.size(); ++i)
+  {
+    const TraceEvent& e = events[i];
+
+    // Type names do not contain quotes or backslashes, but escape them anyway.
+    std::string name;
+    const std::string& typeName = statistics[e.layer].name;
+    for (size_t c = 0; c < typeName.size(); ++c)
+    {
+      if (typeName[c] == '"' || typeName[c] == '\\')
+        name += '\\';
+      name += typeName[c];
+    }
+
+    stream << ((i == 0) ? "\n" : ",\n") << "{\"name\":\"" << e.layer << ": "
+        << name << "\",\"cat\":\"" << passNames[e.pass] << "\",\"ph\":\"X\","
+        << "\"ts\":" << e.start.count() / 1e3 << ",\"dur\":"
+        << e.duration.count() / 1e3 << ",\"pid\":0,\"tid\":0,\"args\":{"
+        << "\"layer\":" << e.layer << ",\"pass\":\"" << passNames[e.pass]
+        << "\"}}";
+  }
+  stream << "\n]}" << std::endl;
+
+  stream.flags(flags);
+  stream.precision(precision);
+}
+
+inline void LayerProfiler::WriteTrace(const std::string& filename) const
+{
+  std::ofstream stream(filename.c_str());
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("LayerProfiler::WriteTrace(): cannot open file '"
+        + filename + "' for writing");
+  }
+
+  WriteTrace(stream);
+  if (!stream.good())
+  {
+    throw std::runtime_error("LayerProfiler::WriteTrace(): cannot write the "
+        "trace to file '" + filename + "'");
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
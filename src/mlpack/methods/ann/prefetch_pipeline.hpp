@@ -0,0 +1,293 @@
+/**
+ * @file methods/ann/prefetch_pipeline.hpp
+ *
+ * Definition of the PrefetchPipeline class, which prepares minibatches for the
+ * training of a network in a background thread.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_PREFETCH_PIPELINE_HPP
+#define MLPACK_METHODS_ANN_PREFETCH_PIPELINE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * A PrefetchPipeline streams minibatches to the training of an FFN or an RNN.
+ * FFN::Train() and RNN::Train() need the whole dataset in memory, and
+ * shuffling it (with Shuffle()) copies the whole dataset every epoch.  With a
+ * pipeline, a producer thread calls a loader for each minibatch (which may
+ * read the batch from disk, decode it, and augment it), and puts the batches
+ * into a ring buffer of bounded capacity, while the optimizer consumes them.
+ * So the dataset does not have to fit into memory, loading the next batches
+ * overlaps with the computation on the current one, and only the order of the
+ * batches (not the data) is shuffled, once per epoch.
+ *
+ * The loader is called with the index of the batch (between 0 and
+ * NumBatches() - 1), and fills the predictors and the responses of that
+ * batch, as an arma::mat for FFN or an arma::cube for RNN (in the same format
+ * as for FFN::Train() and RNN::Train()).  It is called in the producer thread,
+ * so it must not use state shared with the optimizer.  If it throws, the
+ * exception is rethrown by the consumer.
+ *
+ * For data that fits into memory, the pipeline can also be built from the
+ * predictors and responses directly; then a new random order of the points
+ * is drawn each epoch, and each batch gathers its columns, so no full copy of
+ * the data is ever made.
+ *
+ * @code
+ * // Load the batches from one file each.
+ * PrefetchPipeline<> pipeline([](const size_t i, arma::mat& x, arma::mat& y)
+ * {
+ *   data::Load("batch" + std::to_string(i) + ".bin", x);
+ *   data::Load("labels" + std::to_string(i) + ".bin", y);
+ * }, numBatches, 256);
+ *
+ * ens::Adam optimizer(0.001, 256); // The same batch size as the pipeline.
+ * pipeline.Train(model, optimizer);
+ * @endcode
+ *
+ * Each call of the optimizer to evaluate the objective consumes the next
+ * batch of the pipeline, regardless of the batch size requested by the
+ * optimizer; so the batch size of the optimizer should be the batch size of
+ * the pipeline, so that the epochs of the optimizer match those of the
+ * pipeline.
+ *
+ * @tparam DataType The type of the batches (arma::mat or arma::cube).
+ */
+template<typename DataType = arma::mat>
+class PrefetchPipeline
+{
+ public:
+  //! The type of the function that loads one batch.
+  typedef std::function<void(const size_t, DataType&, DataType&)> LoaderType;
+
+  /**
+   * Create the pipeline from the given loader.
+   *
+   * @param loader The function that loads the batch with the given index.
+   * @param numBatches The number of batches in one epoch.
+   * @param batchSize The number of points in each batch.
+   * @param capacity The maximum number of batches that are held in memory.
+   * @param shuffle Whether to visit the batches in a new random order each
+   *     epoch.
+   */
+  PrefetchPipeline(LoaderType loader,
+                   const size_t numBatches,
+                   const size_t batchSize,
+                   const size_t capacity = 4,
+                   const bool shuffle = true);
+
+  /**
+   * Create the pipeline from data in memory.  The data is not copied, and
+   * must outlive the pipeline.
+   *
+   * @param predictors The input points.
+   * @param responses The responses of the input points.
+   * @param batchSize The number of points in each batch (the last batch of an
+   *     epoch may be smaller).
+   * @param capacity The maximum number of batches that are held in memory.
+   * @param shuffle Whether to visit the points in a new random order each
+   *     epoch.
+   */
+  PrefetchPipeline(const DataType& predictors,
+                   const DataType& responses,
+                   const size_t batchSize,
+                   const size_t capacity = 4,
+                   const bool shuffle = true);
+
+  //! The producer thread uses the pipeline, so it cannot be copied.
+  PrefetchPipeline(const PrefetchPipeline& other) = delete;
+  //! The producer thread uses the pipeline, so it cannot be copied.
+  PrefetchPipeline& operator=(const PrefetchPipeline& other) = delete;
+
+  //! Stop the producer thread.
+  ~PrefetchPipeline();
+
+  /**
+   * Get the next batch, waiting for the producer if it is not ready yet.  The
+   * producer thread is started if it is not running.  The memory of the given
+   * matrices is reused for later batches.
+   *
+   * @param predictors The predictors of the batch.
+   * @param responses The responses of the batch.
+   */
+  void Next(DataType& predictors, DataType& responses);
+
+  /**
+   * Stop the producer thread and discard the prepared batches.  The next call
+   * to Next() starts a new epoch.
+   */
+  void Stop();
+
+  /**
+   * Train the given network (an FFN or an RNN) with the batches of the
+   * pipeline.  If the network has no parameters yet, they are initialized.
+   *
+   * @param network The network to train.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename NetworkType,
+           typename OptimizerType,
+           typename... CallbackTypes>
+  double Train(NetworkType& network,
+               OptimizerType& optimizer,
+               CallbackTypes&&... callbacks);
+
+  //! Get the number of batches in one epoch.
+  size_t NumBatches() const { return numBatches; }
+  //! Get the number of points in each batch.
+  size_t BatchSize() const { return batchSize; }
+  //! Get the number of points in one epoch.
+  size_t NumPoints() const { return numPoints; }
+  //! Get the maximum number of batches that are held in memory.
+  size_t Capacity() const { return capacity; }
+
+ private:
+  /**
+   * The function that is optimized by Train(): each evaluation loads the next
+   * batch into the network, and evaluates the network on it.
+   */
+  template<typename NetworkType>
+  class NetworkFunction
+  {
+   public:
+    NetworkFunction(NetworkType& network, PrefetchPipeline& pipeline) :
+        network(network), pipeline(pipeline) { }
+
+    double Evaluate(const arma::mat& parameters,
+                    const size_t /* begin */,
+                    const size_t /* batchSize */)
+    {
+      pipeline.Next(network.Predictors(), network.Responses());
+      return network.Evaluate(parameters, 0, network.Responses().n_cols);
+    }
+
+    double EvaluateWithGradient(const arma::mat& parameters,
+                                const size_t /* begin */,
+                                arma::mat& gradient,
+                                const size_t /* batchSize */)
+    {
+      pipeline.Next(network.Predictors(), network.Responses());
+      return network.EvaluateWithGradient(parameters, 0, gradient,
+          network.Responses().n_cols);
+    }
+
+    void Gradient(const arma::mat& parameters,
+                  const size_t begin,
+                  arma::mat& gradient,
+                  const size_t batchSize)
+    {
+      EvaluateWithGradient(parameters, begin, gradient, batchSize);
+    }
+
+    //! The batches are shuffled by the producer.
+    void Shuffle() { }
+
+    size_t NumFunctions() const { return pipeline.NumPoints(); }
+
+   private:
+    NetworkType& network;
+    PrefetchPipeline& pipeline;
+  };
+
+  /**
+   * The loader of a pipeline built from data in memory.  It draws a new
+   * order of the points whenever a new epoch starts.
+   */
+  class MemoryLoader
+  {
+   public:
+    MemoryLoader(const DataType& predictors,
+                 const DataType& responses,
+                 const size_t batchSize,
+                 const bool shuffle,
+                 const size_t seed);
+
+    void operator()(const size_t batch,
+                    DataType& batchPredictors,
+                    DataType& batchResponses);
+
+   private:
+    //! Gather the given columns of a matrix.
+    static void Gather(const arma::mat& input,
+                       const arma::uvec& indices,
+                       arma::mat& output);
+
+    //! Gather the given columns of each slice of a cube.
+    static void Gather(const arma::cube& input,
+                       const arma::uvec& indices,
+                       arma::cube& output);
+
+    const DataType& predictors;
+    const DataType& responses;
+    size_t batchSize;
+    bool shuffle;
+    std::mt19937 generator;
+    std::vector<arma::uword> order;
+    size_t delivered;
+  };
+
+  //! The loop of the producer thread.
+  void Produce();
+
+  //! The function that loads one batch.
+  LoaderType loader;
+  //! The number of batches in one epoch.
+  size_t numBatches;
+  //! The number of points in each batch.
+  size_t batchSize;
+  //! The number of points in one epoch.
+  size_t numPoints;
+  //! The maximum number of batches that are held in memory.
+  size_t capacity;
+  //! Whether to visit the batches in a new random order each epoch.
+  bool shuffle;
+  //! The random number generator of the producer.
+  std::mt19937 generator;
+
+  //! The predictors of the batches in the ring buffer.
+  std::vector<DataType> slotPredictors;
+  //! The responses of the batches in the ring buffer.
+  std::vector<DataType> slotResponses;
+  //! The slot of the next batch to consume.
+  size_t head;
+  //! The number of batches that are ready.
+  size_t count;
+  //! Whether the producer has to stop.
+  bool stop;
+  //! The exception thrown by the loader, if any.
+  std::exception_ptr error;
+
+  //! The mutex that protects the state of the ring buffer.
+  std::mutex mutex;
+  //! Signalled when a slot is freed.
+  std::condition_variable notFull;
+  //! Signalled when a batch is ready (or the loader failed).
+  std::condition_variable notEmpty;
+  //! The producer thread.
+  std::thread producer;
+}; // class PrefetchPipeline
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "prefetch_pipeline_impl.hpp"
+
+#endif
@@ -0,0 +1,266 @@
+/**
+ * @file methods/ann/prefetch_pipeline_impl.hpp
+ *
+ * Implementation of the PrefetchPipeline class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_PREFETCH_PIPELINE_IMPL_HPP
+#define MLPACK_METHODS_ANN_PREFETCH_PIPELINE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "prefetch_pipeline.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename DataType>
+PrefetchPipeline<DataType>::PrefetchPipeline(LoaderType loader,
+                                             const size_t numBatches,
+                                             const size_t batchSize,
+                                             const size_t capacity,
+                                             const bool shuffle) :
+    loader(std::move(loader)),
+    numBatches(numBatches),
+    batchSize(batchSize),
+    numPoints(numBatches * batchSize),
+    capacity(capacity),
+    shuffle(shuffle),
+    generator(math::RandInt(std::numeric_limits<int>::max())),
+    slotPredictors(capacity),
+    slotResponses(capacity),
+    head(0),
+    count(0),
+    stop(false)
+{
+  if (numBatches == 0 || batchSize == 0 || capacity == 0)
+  {
+    throw std::invalid_argument("PrefetchPipeline::PrefetchPipeline(): the "
+        "number of batches, the batch size and the capacity must be positive");
+  }
+}
+
+template<typename DataType>
+PrefetchPipeline<DataType>::PrefetchPipeline(const DataType& predictors,
+                                             const DataType& responses,
+                                             const size_t batchSize,
+                                             const size_t capacity,
+                                             const bool shuffle) :
+    numBatches(batchSize == 0 ? 0 :
+        (predictors.n_cols + batchSize - 1) / batchSize),
+    batchSize(batchSize),
+    numPoints(predictors.n_cols),
+    capacity(capacity),
+    shuffle(shuffle),
+    generator(math::RandInt(std::numeric_limits<int>::max())),
+    slotPredictors(capacity),
+    slotResponses(capacity),
+    head(0),
+    count(0),
+    stop(false)
+{
+  if (predictors.n_cols == 0 || batchSize == 0 || capacity == 0)
+  {
+    throw std::invalid_argument("PrefetchPipeline::PrefetchPipeline(): the "
+        "data, the batch size and the capacity must not be empty");
+  }
+
+  if (predictors.n_cols != responses.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "PrefetchPipeline::PrefetchPipeline(): the number of predictors ("
+        << predictors.n_cols << ") does not match the number of responses ("
+        << responses.n_cols << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  loader = MemoryLoader(predictors, responses, batchSize, shuffle,
+      generator());
+}
+
+template<typename DataType>
+PrefetchPipeline<DataType>::~PrefetchPipeline()
+{
+  Stop();
+}
+
+template<typename DataType>
+void PrefetchPipeline<DataType>::Next(DataType& predictors,
+                                      DataType& responses)
+{
+  if (!producer.joinable())
+    producer = std::thread(&PrefetchPipeline::Produce, this);
+
+  std::unique_lock<std::mutex> lock(mutex);
+  notEmpty.wait(lock, [this]() { return count > 0 || error; });
+  if (count == 0)
+    std::rethrow_exception(error);
+
+  // The consumer gets the memory of the batch, and the slot gets the memory of
+  // the previous batch of the consumer, which the loader can reuse.
+  std::swap(predictors, slotPredictors[head]);
+  std::swap(responses, slotResponses[head]);
+  head = (head + 1) % capacity;
+  --count;
+
+  lock.unlock();
+  notFull.notify_one();
+}
+
+template<typename DataType>
+void PrefetchPipeline<DataType>::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  notFull.notify_all();
+
+  if (producer.joinable())
+    producer.join();
+
+  stop = false;
+  head = 0;
+  count = 0;
+  error = std::exception_ptr();
+}
+
+template<typename DataType>
+template<typename NetworkType,
+         typename OptimizerType,
+         typename... CallbackTypes>
+double PrefetchPipeline<DataType>::Train(NetworkType& network,
+                                         OptimizerType& optimizer,
+                                         CallbackTypes&&... callbacks)
+{
+  if (network.Parameters().is_empty())
+    network.ResetParameters();
+
+  // The network only ever holds the current batch.
+  network.Predictors().reset();
+  network.Responses().reset();
+
+  NetworkFunction<NetworkType> function(network, *this);
+  const double out = optimizer.Optimize(function, network.Parameters(),
+      callbacks...);
+  Stop();
+
+  Log::Info << "PrefetchPipeline::Train(): final objective of trained model "
+      << "is " << out << "." << std::endl;
+  return out;
+}
+
+template<typename DataType>
+void PrefetchPipeline<DataType>::Produce()
+{
+  std::vector<size_t> order(numBatches);
+  for (size_t i = 0; i < numBatches; ++i)
+    order[i] = i;
+
+  while (true)
+  {
+    if (shuffle)
+      std::shuffle(order.begin(), order.end(), generator);
+
+    for (size_t i = 0; i < numBatches; ++i)
+    {
+      size_t slot;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this]() { return stop || count < capacity; });
+        if (stop)
+          return;
+
+        slot = (head + count) % capacity;
+      }
+
+      // The slot is not visible to the consumer until the count is increased,
+      // so it can be filled without holding the lock.
+      try
+      {
+        loader(order[i], slotPredictors[slot], slotResponses[slot]);
+      }
+      catch (...)
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          error = std::current_exception();
+        }
+        notEmpty.notify_all();
+        return;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++count;
+      }
+      notEmpty.notify_one();
+    }
+  }
+}
+
+template<typename DataType>
+PrefetchPipeline<DataType>::MemoryLoader::MemoryLoader(
+    const DataType& predictors,
+    const DataType& responses,
+    const size_t batchSize,
+    const bool shuffle,
+    const size_t seed) :
+    predictors(predictors),
+    responses(responses),
+    batchSize(batchSize),
+    shuffle(shuffle),
+    generator(seed),
+    order(predictors.n_cols),
+    delivered(0)
+{
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+}
+
+template<typename DataType>
+void PrefetchPipeline<DataType>::MemoryLoader::operator()(
+    const size_t batch,
+    DataType& batchPredictors,
+    DataType& batchResponses)
+{
+  // Draw a new order of the points at the start of each epoch.
+  const size_t numBatches = (order.size() + batchSize - 1) / batchSize;
+  if (delivered == 0 && shuffle)
+    std::shuffle(order.begin(), order.end(), generator);
+  delivered = (delivered + 1) % numBatches;
+
+  const size_t begin = batch * batchSize;
+  const size_t end = std::min(begin + batchSize, order.size());
+  const arma::uvec indices(order.data() + begin, end - begin);
+  Gather(predictors, indices, batchPredictors);
+  Gather(responses, indices, batchResponses);
+}
+
+template<typename DataType>
+void PrefetchPipeline<DataType>::MemoryLoader::Gather(
+    const arma::mat& input,
+    const arma::uvec& indices,
+    arma::mat& output)
+{
+  output = input.cols(indices);
+}
+
+template<typename DataType>
+void PrefetchPipeline<DataType>::MemoryLoader::Gather(
+    const arma::cube& input,
+    const arma::uvec& indices,
+    arma::cube& output)
+{
+  output.set_size(input.n_rows, indices.n_elem, input.n_slices);
+  for (size_t s = 0; s < input.n_slices; ++s)
+    output.slice(s) = input.slice(s).cols(indices);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,79 @@
+/**
+ * @file methods/ann/quantize_network.hpp
+ *
+ * Definition of QuantizeNetwork(), which builds an int8 version of a trained
+ * FFN for inference.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_QUANTIZE_NETWORK_HPP
+#define MLPACK_METHODS_ANN_QUANTIZE_NETWORK_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "ffn.hpp"
+#include "visitor/copy_visitor.hpp"
+#include "visitor/deterministic_set_visitor.hpp"
+#include "visitor/forward_visitor.hpp"
+#include "visitor/set_input_height_visitor.hpp"
+#include "visitor/set_input_width_visitor.hpp"
+#include "visitor/weight_size_visitor.hpp"
+#include "util/check_input_shape.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Build a quantized version of a trained network for inference (post-training
+ * quantization).  The calibration data is passed through the network in
+ * deterministic mode, and the largest absolute value of the input of each
+ * layer is recorded.  Then each Linear layer is replaced by a QuantizedLinear
+ * layer and each Convolution layer by a QuantizedConvolution layer: their
+ * weights are quantized symmetrically to int8 with one scale for each output
+ * unit (or map), their inputs are quantized symmetrically to int8 with the
+ * scale found by calibration, and the products are accumulated in int32.  All
+ * other layers are copied.
+ *
+ * The calibration data should be representative of the data the quantized
+ * network is used for: inputs larger than the calibrated range are clamped.
+ * The quantized network gives approximately the same predictions as the
+ * trained network, and can be serialized like any other network, but it
+ * cannot be trained.
+ *
+ * @code
+ * extern FFN<NegativeLogLikelihood<>> model; // A trained network.
+ * extern arma::mat calibrationData; // A few hundred training points.
+ *
+ * FFN<NegativeLogLikelihood<>> quantized;
+ * QuantizeNetwork(model, calibrationData, quantized);
+ * quantized.Predict(testData, predictions);
+ * @endcode
+ *
+ * @param network The trained network; its layers are set to deterministic
+ *     mode.
+ * @param calibrationData The points used to find the range of the inputs of
+ *     each layer.
+ * @param quantized The network to build; it must not have any layers.
+ * @param batchSize The number of calibration points passed through the network
+ *     at once.
+ * @return The number of layers that were quantized.
+ */
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename... CustomLayers>
+size_t QuantizeNetwork(
+    FFN<OutputLayerType, InitializationRuleType, CustomLayers...>& network,
+    const arma::mat& calibrationData,
+    FFN<OutputLayerType, InitializationRuleType, CustomLayers...>& quantized,
+    const size_t batchSize = 128);
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantize_network_impl.hpp"
+
+#endif
@@ -0,0 +1,157 @@
+/**
+ * @file methods/ann/quantize_network_impl.hpp
+ *
+ * Implementation of QuantizeNetwork().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_QUANTIZE_NETWORK_IMPL_HPP
+#define MLPACK_METHODS_ANN_QUANTIZE_NETWORK_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "quantize_network.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename... CustomLayers>
+size_t QuantizeNetwork(
+    FFN<OutputLayerType, InitializationRuleType, CustomLayers...>& network,
+    const arma::mat& calibrationData,
+    FFN<OutputLayerType, InitializationRuleType, CustomLayers...>& quantized,
+    const size_t batchSize)
+{
+  if (network.Parameters().is_empty())
+  {
+    throw std::invalid_argument("QuantizeNetwork(): the network has no "
+        "parameters; train it first");
+  }
+
+  if (!quantized.Model().empty())
+  {
+    throw std::invalid_argument("QuantizeNetwork(): the quantized network "
+        "must not have any layers");
+  }
+
+  if (calibrationData.n_cols == 0 || batchSize == 0)
+  {
+    throw std::invalid_argument("QuantizeNetwork(): the calibration data and "
+        "the batch size must not be empty");
+  }
+
+  std::vector<LayerTypes<CustomLayers...> >& layers = network.Model();
+  CheckInputShape(layers, calibrationData.n_rows, "QuantizeNetwork()");
+
+  for (size_t i = 0; i < layers.size(); ++i)
+    boost::apply_visitor(DeterministicSetVisitor(true), layers[i]);
+
+  // Find the range of the input of each layer.  The input width and height of
+  // the layers are set in the same way as in FFN::Forward().
+  std::vector<double> inputRange(layers.size(), 0.0);
+  for (size_t begin = 0; begin < calibrationData.n_cols; begin += batchSize)
+  {
+    const size_t end = std::min(begin + batchSize,
+        (size_t) calibrationData.n_cols) - 1;
+    arma::mat input = calibrationData.cols(begin, end);
+    arma::mat output;
+    size_t width = 0, height = 0;
+    for (size_t i = 0; i < layers.size(); ++i)
+    {
+      if (i > 0)
+      {
+        boost::apply_visitor(SetInputWidthVisitor(width), layers[i]);
+        boost::apply_visitor(SetInputHeightVisitor(height), layers[i]);
+      }
+
+      inputRange[i] = std::max(inputRange[i], arma::abs(input).max());
+      boost::apply_visitor(ForwardVisitor(input, output), layers[i]);
+
+      if (boost::apply_visitor(OutputWidthVisitor(), layers[i]) != 0)
+        width = boost::apply_visitor(OutputWidthVisitor(), layers[i]);
+      if (boost::apply_visitor(OutputHeightVisitor(), layers[i]) != 0)
+        height = boost::apply_visitor(OutputHeightVisitor(), layers[i]);
+
+      input = std::move(output);
+    }
+  }
+
+  const arma::mat& parameters = network.Parameters();
+  CopyVisitor<CustomLayers...> copyVisitor;
+
+  // The parameters of each copied layer.  They can only be set once all layers
+  // have been added.
+  std::vector<arma::vec> copiedWeights;
+
+  size_t numQuantized = 0;
+  size_t offset = 0;
+  for (size_t i = 0; i < layers.size(); ++i)
+  {
+    const size_t weightSize = boost::apply_visitor(WeightSizeVisitor(),
+        layers[i]);
+    const double* weights = parameters.memptr() + offset;
+    offset += weightSize;
+
+    Linear<>* const* linear = boost::get<Linear<>*>(&layers[i]);
+    Convolution<>* const* convolution =
+        boost::get<Convolution<>*>(&layers[i]);
+    const double inputScale = inputRange[i] / 127.0;
+
+    if (linear != NULL)
+    {
+      const size_t inSize = (*linear)->InputSize();
+      const size_t outSize = (*linear)->OutputSize();
+      const arma::mat weight(const_cast<double*>(weights), outSize, inSize,
+          false, true);
+      const arma::vec bias(const_cast<double*>(weights) + weight.n_elem,
+          outSize, false, true);
+
+      quantized.template Add<QuantizedLinear<> >(weight, bias, inputScale);
+      ++numQuantized;
+    }
+    else if (convolution != NULL)
+    {
+      quantized.template Add<QuantizedConvolution<> >(**convolution,
+          inputScale);
+      ++numQuantized;
+    }
+    else
+    {
+      quantized.Add(boost::apply_visitor(copyVisitor, layers[i]));
+      copiedWeights.push_back(arma::vec(weights, weightSize));
+    }
+  }
+
+  // Let the quantized network allocate the parameters of the copied layers and
+  // set up their aliases, then overwrite the initial parameters.
+  quantized.ResetParameters();
+
+  size_t quantizedOffset = 0;
+  for (size_t l = 0; l < copiedWeights.size(); ++l)
+  {
+    if (copiedWeights[l].n_elem == 0)
+      continue;
+
+    if (quantizedOffset + copiedWeights[l].n_elem >
+        quantized.Parameters().n_elem)
+    {
+      throw std::logic_error("QuantizeNetwork(): the quantized network has "
+          "fewer parameters than expected");
+    }
+
+    quantized.Parameters().rows(quantizedOffset, quantizedOffset +
+        copiedWeights[l].n_elem - 1) = copiedWeights[l];
+    quantizedOffset += copiedWeights[l].n_elem;
+  }
+
+  return numQuantized;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
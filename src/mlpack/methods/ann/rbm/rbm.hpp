@@ -442,6 +442,15 @@ class RBM
   arma::Mat<ElemType> positiveGradient;
   //! Locally-stored temporary output of Gibbs chain.
   arma::Mat<ElemType> gibbsTemporary;
+  //! Locally-stored hidden means of a batch, used by the BinaryRBM Phase().
+  DataType hiddenActivation;
+  //! Locally-stored mean of the visible points of a batch (SpikeSlabRBM).
+  DataType visibleAverage;
+  //! Locally-stored product of the weights of all hidden units with the mean
+  //! of the visible points (SpikeSlabRBM).
+  DataType slabProjection;
+  //! Locally-stored slab variables scaled by their spikes (SpikeSlabRBM).
+  DataType scaledSlab;
   //! Locally-stored persistent CD-k boolean flag.
   bool persistence;
   //! Locally-stored reset variable.
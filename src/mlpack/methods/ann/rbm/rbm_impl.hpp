@@ -116,7 +116,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::FreeEnergy(
   preActivation = (weight.slice(0) * input);
   preActivation.each_col() += hiddenBias;
   return -(arma::accu(arma::log(1 + arma::trunc_exp(preActivation))) +
-      arma::dot(input, arma::repmat(visibleBias, 1, input.n_cols)));
+      arma::dot(arma::sum(input, 1), visibleBias));
 }
 
 template<
@@ -130,14 +130,21 @@ RBM<InitializationRuleType, DataType, PolicyType>::Phase(
     const InputType& input,
     DataType& gradient)
 {
-  arma::Cube<ElemType> weightGrad = arma::Cube<ElemType>(gradient.memptr(),
-      hiddenSize, visibleSize, 1, false, false);
+  // The hidden means of all points of the batch are computed at once; the
+  // gradients of the biases are their sums over the batch.
+  HiddenMean(input, hiddenActivation);
 
-  DataType hiddenBiasGrad = DataType(gradient.memptr() + weightGrad.n_elem,
-      hiddenSize, 1, false, false);
+  arma::Mat<ElemType> weightGrad(gradient.memptr(), hiddenSize, visibleSize,
+      false, true);
+  weightGrad = hiddenActivation * input.t();
+
+  DataType hiddenBiasGrad(gradient.memptr() + weightGrad.n_elem, hiddenSize, 1,
+      false, true);
+  hiddenBiasGrad = arma::sum(hiddenActivation, 1);
 
-  HiddenMean(input, hiddenBiasGrad);
-  weightGrad.slice(0) = hiddenBiasGrad * input.t();
+  DataType visibleBiasGrad(gradient.memptr() + weightGrad.n_elem +
+      hiddenBiasGrad.n_elem, visibleSize, 1, false, true);
+  visibleBiasGrad = arma::sum(input, 1);
 }
 
 template<
@@ -150,10 +157,12 @@ double RBM<InitializationRuleType, DataType, PolicyType>::Evaluate(
     const size_t i,
     const size_t batchSize)
 {
-  Gibbs(predictors.cols(i, i + batchSize - 1),
-      negativeSamples);
-  return std::fabs(FreeEnergy(predictors.cols(i,
-      i + batchSize - 1)) - FreeEnergy(negativeSamples));
+  // Alias the batch instead of copying it.
+  const arma::Mat<ElemType> batch(const_cast<ElemType*>(predictors.colptr(i)),
+      predictors.n_rows, batchSize, false, true);
+
+  Gibbs(batch, negativeSamples);
+  return std::fabs(FreeEnergy(batch) - FreeEnergy(negativeSamples));
 }
 
 template<
@@ -274,13 +283,17 @@ void RBM<InitializationRuleType, DataType, PolicyType>::Gradient(
   positiveGradient.zeros();
   negativeGradient.zeros();
 
-  Phase(predictors.cols(i, i + batchSize - 1),
-      positiveGradient);
+  // Alias the batch instead of copying it.
+  const arma::Mat<ElemType> batch(const_cast<ElemType*>(predictors.colptr(i)),
+      predictors.n_rows, batchSize, false, true);
+
+  Phase(batch, positiveGradient);
 
-  for (size_t i = 0; i < negSteps; ++i)
+  for (size_t step = 0; step < negSteps; ++step)
   {
-    Gibbs(predictors.cols(i, i + batchSize - 1),
-        negativeSamples);
+    // The chains start from the points of the batch (or from the persistent
+    // state).
+    Gibbs(batch, negativeSamples);
     Phase(negativeSamples, tempNegativeGradient);
 
     negativeGradient += tempNegativeGradient;
@@ -75,10 +75,17 @@ RBM<InitializationRuleType, DataType, PolicyType>::FreeEnergy(
   freeEnergy -= 0.5 * hiddenSize * poolSize *
       std::log((2.0 * M_PI) / slabPenalty);
 
+  // The products of the input with the weights of all hidden units are
+  // computed at once; the slices of the weight cube are the column blocks of
+  // one visibleSize x (poolSize * hiddenSize) matrix.
+  const arma::Mat<ElemType> weights(weight.memptr(), visibleSize,
+      poolSize * hiddenSize, false, true);
+  preActivation = weights.t() * input;
+
   for (size_t i = 0; i < hiddenSize; ++i)
   {
-    ElemType sum = arma::accu(arma::square(input.t() * weight.slice(i))) /
-        (2.0 * slabPenalty);
+    ElemType sum = arma::accu(arma::square(preActivation.rows(i * poolSize,
+        (i + 1) * poolSize - 1))) / (2.0 * slabPenalty);
     freeEnergy -= SoftplusFunction::Fn(spikeBias(i) - sum);
   }
 
@@ -96,8 +103,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::Phase(
     const InputType& input,
     DataType& gradient)
 {
-  arma::Cube<ElemType> weightGrad = arma::Cube<ElemType>
-      (gradient.memptr(), visibleSize, poolSize, hiddenSize, false, false);
+  arma::Mat<ElemType> weightGrad(gradient.memptr(), visibleSize,
+      poolSize * hiddenSize, false, true);
 
   DataType spikeBiasGrad = DataType(gradient.memptr() + weightGrad.n_elem,
       hiddenSize, 1, false, false);
@@ -106,11 +113,13 @@ RBM<InitializationRuleType, DataType, PolicyType>::Phase(
   SampleSpike(spikeMean, spikeSamples);
   SlabMean(input, spikeSamples, slabMean);
 
-  for (size_t i = 0 ; i < hiddenSize; ++i)
-  {
-    weightGrad.slice(i) = input * arma::repmat(slabMean.col(i).t(),
-        input.n_cols, 1) * spikeMean(i);
-  }
+  // The gradient of the weights of hidden unit i is the outer product of the
+  // sum of the inputs with the slab mean of the unit, scaled by its spike
+  // mean, so the gradients of all units are one outer product.
+  scaledSlab = slabMean.each_row() % spikeMean.t();
+  const arma::Mat<ElemType> slabRow(scaledSlab.memptr(), 1, scaledSlab.n_elem,
+      false, true);
+  weightGrad = arma::sum(input, 1) * slabRow;
 
   spikeBiasGrad = spikeMean;
   // Setting visiblePenaltyGrad.
@@ -190,18 +199,20 @@ RBM<InitializationRuleType, DataType, PolicyType>::VisibleMean(
     InputType& input,
     DataType& output)
 {
-  output.zeros(visibleSize, 1);
-
   DataType spike(input.memptr(), hiddenSize, 1, false, false);
   DataType slab(input.memptr() + hiddenSize, poolSize, hiddenSize, false,
       false);
 
-  for (size_t i = 0; i < hiddenSize; ++i)
-  {
-    output += weight.slice(i) * slab.col(i) * spike(i);
-  }
+  // The sum of the products of the weights of each hidden unit with its slab
+  // variables, scaled by its spike, is one matrix-vector product.
+  const arma::Mat<ElemType> weights(weight.memptr(), visibleSize,
+      poolSize * hiddenSize, false, true);
+  scaledSlab = slab.each_row() % spike.t();
+  const arma::Mat<ElemType> slabColumn(scaledSlab.memptr(), scaledSlab.n_elem,
+      1, false, true);
 
-  output = ((1.0 / visiblePenalty(0)) * output);
+  output = weights * slabColumn;
+  output *= (1.0 / visiblePenalty(0));
 }
 
 template<
@@ -237,11 +248,18 @@ RBM<InitializationRuleType, DataType, PolicyType>::SpikeMean(
     const InputType& visible,
     DataType& spikeMean)
 {
+  // accu(v^T W_i W_i^T v) / n^2 is the squared norm of W_i^T mean(v), so the
+  // projections of all hidden units are one matrix-vector product.
+  const arma::Mat<ElemType> weights(weight.memptr(), visibleSize,
+      poolSize * hiddenSize, false, true);
+  visibleAverage = arma::mean(visible, 1);
+  slabProjection = weights.t() * visibleAverage;
+
   for (size_t i = 0; i < hiddenSize; ++i)
   {
-    spikeMean(i) = LogisticFunction::Fn(0.5 * (1.0 / slabPenalty) * arma::accu(
-        visible.t() * (weight.slice(i) * weight.slice(i).t()) * visible)
-        / std::pow(visible.n_cols, 2) + spikeBias(i));
+    spikeMean(i) = LogisticFunction::Fn(0.5 * (1.0 / slabPenalty) *
+        arma::accu(arma::square(slabProjection.rows(i * poolSize,
+        (i + 1) * poolSize - 1))) + spikeBias(i));
   }
 }
 
@@ -274,10 +292,17 @@ RBM<InitializationRuleType, DataType, PolicyType>::SlabMean(
     DataType& spike,
     DataType& slabMean)
 {
+  // The mean over the points of W_i^T v is W_i^T mean(v), for all hidden
+  // units at once.
+  const arma::Mat<ElemType> weights(weight.memptr(), visibleSize,
+      poolSize * hiddenSize, false, true);
+  visibleAverage = arma::mean(visible, 1);
+  slabProjection = weights.t() * visibleAverage;
+
   for (size_t i = 0; i < hiddenSize; ++i)
   {
-    slabMean.col(i) = arma::mean((1.0 / slabPenalty) * spike(i) *
-        weight.slice(i).t() * visible, 1);
+    slabMean.col(i) = ((1.0 / slabPenalty) * spike(i)) *
+        slabProjection.rows(i * poolSize, (i + 1) * poolSize - 1);
   }
 }
 
@@ -20,6 +20,7 @@
 #include "visitor/reset_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "layer_profiler.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
@@ -179,6 +180,51 @@ class RNN
                arma::cube responses,
                CallbackTypes&&... callbacks);
 
+  /**
+   * Train the recurrent neural network on the next part of a set of long
+   * sequences, with truncated backpropagation through time (BPTT).  This is
+   * used to train on sequences that are too long to be held in memory at
+   * once: they are given to TrainChunk() in consecutive parts, in the same
+   * format as for Train() (each column is one sequence, and each slice is one
+   * time step).  The part is split into windows of Rho() time steps (the last
+   * window may be shorter), and an optimization is run for each window in
+   * turn.  The recurrent state (of the layers that implement CarryCell(), such
+   * as LSTM and FusedLSTM) is carried over from each window to the next one,
+   * and from one call to the next, but BPTT stops at the beginning of each
+   * window.  Call ResetState() before the first part of new sequences.
+   *
+   * This sets CarryState(), so each evaluation of the objective must cover all
+   * sequences at once, and the order of the sequences is not shuffled.  The
+   * optimizer should be set up to make one step for each window: e.g. for
+   * ens::SGD, the batch size and the maximum number of iterations should both
+   * be the number of sequences.  For optimizers with a state (such as
+   * ens::Adam), set resetPolicy to false, so that the state is kept from one
+   * window to the next.
+   *
+   * @code
+   * // Four sequences, given in parts of 500 time steps.
+   * ens::Adam optimizer(0.01, 4, 0.9, 0.999, 1e-8, 4, 1e-8, false, false);
+   * model.ResetState();
+   * while (loader.Next(predictors, responses))
+   *   model.TrainChunk(predictors, responses, optimizer);
+   * @endcode
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors The next part of the input sequences.
+   * @param responses The next part of the output sequences.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The sum of the objectives of the windows, as returned by the
+   *      optimizer.
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  double TrainChunk(const arma::cube& predictors,
+                    const arma::cube& responses,
+                    OptimizerType& optimizer,
+                    CallbackTypes&&... callbacks);
+
   /**
    * Predict the responses to a given set of predictors. The responses will
    * reflect the output of the given output layer as returned by the
@@ -202,6 +248,35 @@ class RNN
                arma::cube& results,
                const size_t batchSize = 256);
 
+  /**
+   * Predict the responses to sequences of different lengths.  The sequences
+   * are held in the predictors as for Predict(), each followed by padding up
+   * to the number of slices of the predictors; the padding is never given to
+   * the network.  The sequences are sorted by length and predicted in batches
+   * of sequences of similar lengths, each for the number of steps of its
+   * longest sequence only, so that many short sequences can be predicted
+   * together efficiently.
+   *
+   * The responses have the same format as the predictors, and are zero after
+   * the end of each sequence.  If the network predicts only the last element
+   * of the sequence (see the constructor), the responses have one slice, that
+   * holds the response to the last step of each sequence.
+   *
+   * The recurrent layers of the network must reset their state with
+   * ResetCell() (as LSTM, FastLSTM, FusedLSTM and GRU do), and hold at least
+   * as many steps as the longest sequence.  This cannot be used if
+   * CarryState() is set.
+   *
+   * @param predictors Input predictors, padded after the end of each sequence.
+   * @param results Matrix to put output predictions of responses into.
+   * @param lengths The number of steps of each sequence.
+   * @param batchSize Number of sequences to predict at once.
+   */
+  void Predict(arma::cube predictors,
+               arma::cube& results,
+               const arma::Row<size_t>& lengths,
+               const size_t batchSize = 256);
+
   /**
    * Evaluate the recurrent neural network with the given parameters. This
    * function is usually called by the optimizer to train the model.
@@ -313,6 +388,29 @@ class RNN
   //! Modify the matrix of data points (predictors).
   arma::cube& Predictors() { return predictors; }
 
+  //! Get whether the recurrent state is carried over from one evaluation to the
+  //! next.
+  bool CarryState() const { return carryState; }
+  //! Modify whether the recurrent state is carried over from one evaluation to
+  //! the next (instead of being reset to zero).  If set, each evaluation (and
+  //! Predict()) must be given all sequences at once, and Shuffle() does
+  //! nothing.
+  bool& CarryState() { return carryState; }
+
+  /**
+   * Reset the recurrent state of the network to zero, so that the next
+   * evaluation starts new sequences.  This is only needed if CarryState() is
+   * set.
+   */
+  void ResetState() { ResetCells(); }
+
+  //! Get the profiler of the layers of the network.
+  const LayerProfiler& Profiler() const { return profiler; }
+  //! Modify the profiler of the layers of the network.  Set
+  //! Profiler().Enabled() to record the time spent in each layer (over all
+  //! time steps).
+  LayerProfiler& Profiler() { return profiler; }
+
   /**
    * Reset the state of the network.  This ensures that all internally-held
    * gradients are set to 0, all memory cells are reset, and the parameters
@@ -345,6 +443,26 @@ class RNN
    */
   void ResetCells();
 
+  /**
+   * Reset the state of RNN cells in the network for new input sequences of
+   * the given number of steps.
+   */
+  void ResetCells(const size_t steps);
+
+  /**
+   * Reset the state of RNN cells in the network for the next part of the input
+   * sequence, keeping the state after the previous part.
+   */
+  void CarryCells();
+
+  /**
+   * Reset or carry over the state of the RNN cells before a pass over the
+   * points [begin, begin + batchSize), depending on CarryState().
+   */
+  void PrepareCells(const size_t begin,
+                    const size_t batchSize,
+                    const char* caller);
+
   /**
    * The Backward algorithm (part of the Forward-Backward algorithm). Computes
    * backward pass for module.
@@ -394,6 +512,9 @@ class RNN
     //! Only predict the last element of the input sequence.
   bool single;
 
+  //! Whether the recurrent state is carried over between evaluations.
+  bool carryState;
+
   //! Locally-stored model modules.
   std::vector<LayerTypes<CustomLayers...> > network;
 
@@ -439,6 +560,9 @@ class RNN
   //! The current gradient for the gradient pass.
   arma::mat currentGradient;
 
+  //! The profiler of the layers.
+  LayerProfiler profiler;
+
   // The BRN class should have access to internal members.
   template<
     typename OutputLayerType1,
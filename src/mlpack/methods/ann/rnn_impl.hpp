@@ -20,12 +20,14 @@
 #include "visitor/forward_visitor.hpp"
 #include "visitor/backward_visitor.hpp"
 #include "visitor/reset_cell_visitor.hpp"
+#include "visitor/carry_cell_visitor.hpp"
 #include "visitor/deterministic_set_visitor.hpp"
 #include "visitor/gradient_set_visitor.hpp"
 #include "visitor/gradient_visitor.hpp"
 #include "visitor/weight_set_visitor.hpp"
 
 #include "util/check_input_shape.hpp"
+#include "util/sequence_batches.hpp"
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -45,6 +47,7 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     targetSize(0),
     reset(false),
     single(single),
+    carryState(false),
     numFunctions(0),
     deterministic(true)
 {
@@ -63,9 +66,11 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     targetSize(network.targetSize),
     reset(network.reset),
     single(network.single),
+    carryState(network.carryState),
     parameter(network.parameter),
     numFunctions(network.numFunctions),
-    deterministic(network.deterministic)
+    deterministic(network.deterministic),
+    profiler(network.profiler)
 {
   for (size_t i = 0; i < network.network.size(); ++i)
   {
@@ -87,10 +92,12 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     targetSize(std::move(network.targetSize)),
     reset(std::move(network.reset)),
     single(std::move(network.single)),
+    carryState(std::move(network.carryState)),
     network(std::move(network.network)),
     parameter(std::move(network.parameter)),
     numFunctions(std::move(network.numFunctions)),
-    deterministic(std::move(network.deterministic))
+    deterministic(std::move(network.deterministic)),
+    profiler(std::move(network.profiler))
 {
   // Nothing to do here.
 }
@@ -179,11 +186,118 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::ResetCells()
+{
+  ResetCells(rho);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetCells(const size_t steps)
+{
+  for (size_t i = 1; i < network.size(); ++i)
+  {
+    boost::apply_visitor(ResetCellVisitor(steps), network[i]);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::CarryCells()
 {
   for (size_t i = 1; i < network.size(); ++i)
   {
-    boost::apply_visitor(ResetCellVisitor(rho), network[i]);
+    boost::apply_visitor(CarryCellVisitor(rho), network[i]);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::PrepareCells(const size_t begin,
+                                        const size_t batchSize,
+                                        const char* caller)
+{
+  if (!carryState)
+  {
+    ResetCells();
+    return;
+  }
+
+  // The layers hold one state for each column of the batch, so the state can
+  // only be carried over if the batch is always the same set of sequences.
+  if (begin != 0 || batchSize != predictors.n_cols)
+  {
+    std::ostringstream oss;
+    oss << caller << ": the recurrent state is carried over (CarryState() is "
+        << "set), so all " << predictors.n_cols << " sequences must be given "
+        << "at once, but the batch is [" << begin << ", " << begin + batchSize
+        << ")";
+    throw std::logic_error(oss.str());
+  }
+
+  CarryCells();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename OptimizerType, typename... CallbackTypes>
+double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+TrainChunk(const arma::cube& predictors,
+           const arma::cube& responses,
+           OptimizerType& optimizer,
+           CallbackTypes&&... callbacks)
+{
+  CheckInputShape<std::vector<LayerTypes<CustomLayers...> > >(
+      network, predictors.n_rows, "RNN<>::TrainChunk()");
+
+  if (single)
+  {
+    throw std::invalid_argument("RNN::TrainChunk(): networks that predict "
+        "only the last element of the sequence cannot be trained on parts of "
+        "the sequence");
+  }
+
+  if (responses.n_cols != predictors.n_cols ||
+      responses.n_slices != predictors.n_slices)
+  {
+    std::ostringstream oss;
+    oss << "RNN::TrainChunk(): the predictors have " << predictors.n_cols
+        << " sequences of " << predictors.n_slices << " steps, but the "
+        << "responses have " << responses.n_cols << " sequences of "
+        << responses.n_slices << " steps";
+    throw std::invalid_argument(oss.str());
+  }
+
+  carryState = true;
+  numFunctions = predictors.n_cols;
+
+  if (!reset)
+  {
+    ResetParameters();
+  }
+
+  // Each window of (at most) rho steps is one optimization; only the window
+  // is copied.  The number of steps of the last window is given to the cells
+  // through rho, which is restored afterwards.
+  const size_t bpttSteps = rho;
+  double out = 0.0;
+  for (size_t first = 0; first < predictors.n_slices; first += bpttSteps)
+  {
+    const size_t last = std::min(first + bpttSteps,
+        size_t(predictors.n_slices)) - 1;
+    this->predictors = predictors.slices(first, last);
+    this->responses = responses.slices(first, last);
+    rho = last - first + 1;
+
+    out += optimizer.Optimize(*this, parameter, callbacks...);
   }
+  rho = bpttSteps;
+
+  Log::Info << "RNN::TrainChunk(): objective of the part is " << out << "."
+      << std::endl;
+  return out;
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -230,7 +344,22 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
   CheckInputShape<std::vector<LayerTypes<CustomLayers...> > >(
       network, predictors.n_rows, "RNN<>::Predict()");
 
-  ResetCells();
+  if (carryState && batchSize < predictors.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "RNN::Predict(): the recurrent state is carried over (CarryState() "
+        << "is set), so all " << predictors.n_cols << " sequences must be "
+        << "predicted at once, but the batch size is " << batchSize;
+    throw std::logic_error(oss.str());
+  }
+  else if (carryState)
+  {
+    CarryCells();
+  }
+  else
+  {
+    ResetCells();
+  }
 
   if (parameter.is_empty())
   {
@@ -273,6 +402,80 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
+    arma::cube predictors,
+    arma::cube& results,
+    const arma::Row<size_t>& lengths,
+    const size_t batchSize)
+{
+  CheckInputShape<std::vector<LayerTypes<CustomLayers...> > >(
+      network, predictors.n_rows, "RNN<>::Predict()");
+
+  if (carryState)
+  {
+    throw std::logic_error("RNN::Predict(): sequences of different lengths "
+        "cannot be predicted when the recurrent state is carried over "
+        "(CarryState() is set)");
+  }
+
+  const arma::uvec order = SortSequenceLengths(predictors, lengths,
+      "RNN::Predict()");
+
+  if (parameter.is_empty())
+  {
+    ResetParameters();
+  }
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  results.reset();
+  arma::mat input;
+  for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols - begin));
+
+    // The first sequence of the batch is the longest one; the batch is done
+    // once it ends.
+    const size_t steps = lengths[order[begin]];
+    ResetCells(steps);
+
+    input.set_size(predictors.n_rows, effectiveBatchSize);
+    for (size_t seqNum = 0; seqNum < steps; ++seqNum)
+    {
+      GatherSequenceStep(predictors, lengths, order, begin, seqNum, false,
+          input);
+      Forward(input);
+
+      const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+          network.back());
+      if (results.is_empty())
+      {
+        outputSize = output.n_rows;
+        results.zeros(outputSize, predictors.n_cols,
+            single ? 1 : predictors.n_slices);
+      }
+
+      // Only keep the responses to the steps of the sequences that have not
+      // ended.
+      for (size_t i = 0; i < effectiveBatchSize; ++i)
+      {
+        const size_t sequence = order[begin + i];
+        if (!single && seqNum < lengths[sequence])
+          results.slice(seqNum).col(sequence) = output.col(i);
+        else if (single && seqNum + 1 == lengths[sequence])
+          results.slice(0).col(sequence) = output.col(i);
+      }
+    }
+  }
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
@@ -302,7 +505,7 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     targetSize = responses.n_rows;
   }
 
-  ResetCells();
+  PrepareCells(begin, batchSize, "RNN::Evaluate()");
 
   double performance = 0;
   size_t responseSeq = 0;
@@ -383,7 +586,7 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     targetSize = responses.n_rows;
   }
 
-  ResetCells();
+  PrepareCells(begin, batchSize, "RNN::EvaluateWithGradient()");
 
   double performance = 0;
   size_t responseSeq = 0;
@@ -480,6 +683,10 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
 {
+  // The recurrent state of each sequence is held in its column of the batch.
+  if (carryState)
+    return;
+
   arma::cube newPredictors, newResponses;
   math::ShuffleData(predictors, responses, newPredictors, newResponses);
 
@@ -541,16 +748,20 @@ template<typename InputType>
 void RNN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Forward(const InputType& input)
 {
+  profiler.Start();
   boost::apply_visitor(ForwardVisitor(input,
       boost::apply_visitor(outputParameterVisitor, network.front())),
       network.front());
+  profiler.Stop(0, LayerProfiler::FORWARD, network.front());
 
   for (size_t i = 1; i < network.size(); ++i)
   {
+    profiler.Start();
     boost::apply_visitor(ForwardVisitor(
         boost::apply_visitor(outputParameterVisitor, network[i - 1]),
         boost::apply_visitor(outputParameterVisitor, network[i])),
         network[i]);
+    profiler.Stop(i, LayerProfiler::FORWARD, network[i]);
   }
 }
 
@@ -558,19 +769,24 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward()
 {
+  profiler.Start();
   boost::apply_visitor(BackwardVisitor(
         boost::apply_visitor(outputParameterVisitor, network.back()),
         error, boost::apply_visitor(deltaVisitor,
         network.back())), network.back());
+  profiler.Stop(network.size() - 1, LayerProfiler::BACKWARD, network.back());
 
   for (size_t i = 2; i < network.size(); ++i)
   {
+    profiler.Start();
     boost::apply_visitor(BackwardVisitor(
         boost::apply_visitor(outputParameterVisitor,
         network[network.size() - i]), boost::apply_visitor(
         deltaVisitor, network[network.size() - i + 1]),
         boost::apply_visitor(deltaVisitor, network[network.size() - i])),
         network[network.size() - i]);
+    profiler.Stop(network.size() - i, LayerProfiler::BACKWARD,
+        network[network.size() - i]);
   }
 }
 
@@ -580,15 +796,19 @@ template<typename InputType>
 void RNN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Gradient(const InputType& input)
 {
+  profiler.Start();
   boost::apply_visitor(GradientVisitor(input,
       boost::apply_visitor(deltaVisitor, network[1])), network.front());
+  profiler.Stop(0, LayerProfiler::GRADIENT, network.front());
 
   for (size_t i = 1; i < network.size() - 1; ++i)
   {
+    profiler.Start();
     boost::apply_visitor(GradientVisitor(
         boost::apply_visitor(outputParameterVisitor, network[i - 1]),
         boost::apply_visitor(deltaVisitor, network[i + 1])),
         network[i]);
+    profiler.Stop(i, LayerProfiler::GRADIENT, network[i]);
   }
 }
 
@@ -0,0 +1,586 @@
+/**
+ * @file methods/ann/static_ffn.hpp
+ *
+ * Definition of the StaticFFN class, a feed forward network whose layer types
+ * are fixed at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "visitor/backward_visitor.hpp"
+#include "visitor/deterministic_set_visitor.hpp"
+#include "visitor/forward_visitor.hpp"
+#include "visitor/gradient_set_visitor.hpp"
+#include "visitor/gradient_visitor.hpp"
+#include "visitor/loss_visitor.hpp"
+#include "visitor/output_height_visitor.hpp"
+#include "visitor/output_width_visitor.hpp"
+#include "visitor/reset_visitor.hpp"
+#include "visitor/set_input_height_visitor.hpp"
+#include "visitor/set_input_width_visitor.hpp"
+#include "visitor/weight_set_visitor.hpp"
+#include "visitor/weight_size_visitor.hpp"
+
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <mlpack/methods/ann/init_rules/init_rules_traits.hpp>
+#include <mlpack/methods/ann/init_rules/random_init.hpp>
+#include <ensmallen.hpp>
+
+#include <tuple>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Implementation of a feed forward network whose structure is known at compile
+ * time.  The FFN class holds its layers in a vector of boost::variant pointers,
+ * so each call into a layer goes through a visitor dispatch that the compiler
+ * cannot see through.  StaticFFN instead holds the layers by value in a
+ * std::tuple and walks that tuple with template recursion, so every call into a
+ * layer is a direct (and inlinable) call on the concrete layer type.  The same
+ * layer implementations are used as for FFN, and networks built with the same
+ * layers and parameters give the same results.
+ *
+ * The network cannot be changed after construction.  Layers are given to the
+ * constructor in the order they are applied to the input:
+ *
+ * @code
+ * StaticFFN<NegativeLogLikelihood<>, RandomInitialization,
+ *     Linear<>, SigmoidLayer<>, Linear<>, LogSoftMax<>> model(
+ *     Linear<>(inputSize, 8), SigmoidLayer<>(), Linear<>(8, 3),
+ *     LogSoftMax<>());
+ * model.Train(trainData, trainLabels);
+ * @endcode
+ *
+ * @tparam OutputLayerType The output layer type used to evaluate the network.
+ * @tparam InitializationRuleType Rule used to initialize the weight matrix.
+ * @tparam Layers Types of the layers of the network, in order.
+ */
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename... Layers>
+class StaticFFN
+{
+  static_assert(sizeof...(Layers) > 0,
+      "StaticFFN must have at least one layer.");
+
+ public:
+  //! Convenience typedef for the internal model construction.
+  using NetworkType = StaticFFN<OutputLayerType, InitializationRuleType,
+                                Layers...>;
+
+  //! The type of the layers of the network.
+  typedef std::tuple<Layers...> LayersType;
+
+  //! The matrix type of the network (for the data, the parameters and the
+  //! gradients), given by the output type of the first layer; for instance,
+  //! a network of layers over arma::fmat is trained in single precision.
+  typedef typename std::decay<decltype(std::declval<
+      typename std::tuple_element<0, LayersType>::type&>().OutputParameter())
+      >::type MatType;
+
+  //! The element type of the network.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Create the StaticFFN object with the given layers, and default-constructed
+   * output layer and initialization rule.
+   *
+   * @param layers The layers of the network, in order.
+   */
+  explicit StaticFFN(Layers... layers);
+
+  /**
+   * Create the StaticFFN object with the given output layer, initialization
+   * rule, and layers.
+   *
+   * @param outputLayer Output layer used to evaluate the network.
+   * @param initializeRule Optional instantiated InitializationRule object
+   *        for initializing the network parameter.
+   * @param layers The layers of the network, in order.
+   */
+  StaticFFN(OutputLayerType outputLayer,
+            InitializationRuleType initializeRule,
+            Layers... layers);
+
+  //! Copy constructor.
+  StaticFFN(const StaticFFN& network);
+
+  //! Move constructor.
+  StaticFFN(StaticFFN&& network);
+
+  //! Copy/move assignment operator.
+  StaticFFN& operator=(StaticFFN network);
+
+  /**
+   * Train the feedforward network on the given input data using the given
+   * optimizer.
+   *
+   * This will use the existing model parameters as a starting point for the
+   * optimization. If this is not what you want, then you should access the
+   * parameters vector directly with Parameters() and modify it as desired.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  double Train(MatType predictors,
+               MatType responses,
+               OptimizerType& optimizer,
+               CallbackTypes&&... callbacks);
+
+  /**
+   * Train the feedforward network on the given input data. By default, the
+   * RMSProp optimization algorithm is used, but others can be specified
+   * (such as ens::SGD).
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType = ens::RMSProp, typename... CallbackTypes>
+  double Train(MatType predictors,
+               MatType responses,
+               CallbackTypes&&... callbacks);
+
+  /**
+   * Train the network like Train(), but let the optimizer update a double
+   * precision master copy of the parameters.  Before each evaluation, the
+   * master copy is rounded into the parameters of the network, and the
+   * gradient computed by the network is converted to double precision for
+   * the update.  For networks in single precision, this keeps small updates
+   * from being lost to rounding, while the forward and backward passes still
+   * run in single precision.  At the end, the trained master copy is rounded
+   * into the parameters of the network.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  double TrainMixedPrecision(MatType predictors,
+                             MatType responses,
+                             OptimizerType& optimizer,
+                             CallbackTypes&&... callbacks);
+
+  /**
+   * Predict the responses to a given set of predictors. The responses will
+   * reflect the output of the given output layer as returned by the
+   * output layer function.  Unlike FFN::Predict(), the predictors are passed
+   * through the network in batches instead of one at a time.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of predictors to pass through the network at once.
+   */
+  void Predict(MatType predictors,
+               MatType& results,
+               const size_t batchSize = 128);
+
+  /**
+   * Evaluate the feedforward network with the given predictors and responses.
+   * This functions is usually used to monitor progress while training.
+   *
+   * @param predictors Input variables.
+   * @param responses Target outputs for input variables.
+   */
+  template<typename PredictorsType, typename ResponsesType>
+  double Evaluate(const PredictorsType& predictors,
+                  const ResponsesType& responses);
+
+  /**
+   * Evaluate the feedforward network with the given parameters. This function
+   * is usually called by the optimizer to train the model.
+   *
+   * @param parameters Matrix model parameters.
+   */
+  double Evaluate(const MatType& parameters);
+
+  /**
+   * Evaluate the feedforward network with the given parameters, but using only
+   * a number of data points. This is useful for optimizers such as SGD, which
+   * require a separable objective function.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   * @param deterministic Whether or not to train or test the model. Note some
+   *        layer act differently in training or testing mode.
+   */
+  double Evaluate(const MatType& parameters,
+                  const size_t begin,
+                  const size_t batchSize,
+                  const bool deterministic);
+
+  /**
+   * Evaluate the feedforward network with the given parameters, but using only
+   * a number of data points. This is useful for optimizers such as SGD, which
+   * require a separable objective function.  This just calls the overload of
+   * Evaluate() with deterministic = true.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  double Evaluate(const MatType& parameters,
+                  const size_t begin,
+                  const size_t batchSize);
+
+  /**
+   * Evaluate the feedforward network with the given parameters.
+   * This function is usually called by the optimizer to train the model.
+   * This just calls the overload of EvaluateWithGradient() with batchSize = 1.
+   *
+   * @param parameters Matrix model parameters.
+   * @param gradient Matrix to output gradient into.
+   */
+  template<typename GradType>
+  double EvaluateWithGradient(const MatType& parameters, GradType& gradient);
+
+  /**
+   * Evaluate the feedforward network with the given parameters, but using only
+   * a number of data points. This is useful for optimizers such as SGD, which
+   * require a separable objective function.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  template<typename GradType>
+  double EvaluateWithGradient(const MatType& parameters,
+                              const size_t begin,
+                              GradType& gradient,
+                              const size_t batchSize);
+
+  /**
+   * Evaluate the gradient of the feedforward network with the given parameters,
+   * and with respect to only a number of points in the dataset. This is useful
+   * for optimizers such as SGD, which require a separable objective function.
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the starting point to use for objective function
+   *        gradient evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function gradient evaluation.
+   */
+  void Gradient(const MatType& parameters,
+                const size_t begin,
+                MatType& gradient,
+                const size_t batchSize);
+
+  /**
+   * Shuffle the order of function visitation. This may be called by the
+   * optimizer.
+   */
+  void Shuffle();
+
+  /**
+   * Perform the forward pass of the data in real batch mode.
+   *
+   * @param inputs The input data.
+   * @param results The predicted results.
+   */
+  template<typename PredictorsType, typename ResponsesType>
+  void Forward(const PredictorsType& inputs, ResponsesType& results);
+
+  //! Get the layers of the network.
+  const LayersType& Model() const { return network; }
+
+  //! Get the layer with the given index.
+  template<size_t I>
+  const typename std::tuple_element<I, LayersType>::type& Layer() const
+  { return std::get<I>(network); }
+  //! Modify the layer with the given index.
+  template<size_t I>
+  typename std::tuple_element<I, LayersType>::type& Layer()
+  { return std::get<I>(network); }
+
+  //! Get the number of layers of the network.
+  static constexpr size_t NumLayers() { return sizeof...(Layers); }
+
+  //! Return the number of separable functions (the number of predictor
+  //! points).
+  size_t NumFunctions() const { return numFunctions; }
+
+  //! Return the initial point for the optimization.
+  const MatType& Parameters() const { return parameter; }
+  //! Modify the initial point for the optimization.
+  MatType& Parameters() { return parameter; }
+
+  //! Get the matrix of responses to the input data points.
+  const MatType& Responses() const { return responses; }
+  //! Modify the matrix of responses to the input data points.
+  MatType& Responses() { return responses; }
+
+  //! Get the matrix of data points (predictors).
+  const MatType& Predictors() const { return predictors; }
+  //! Modify the matrix of data points (predictors).
+  MatType& Predictors() { return predictors; }
+
+  /**
+   * Reset the module information (weights/parameters).
+   */
+  void ResetParameters();
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  /**
+   * The function that is optimized by TrainMixedPrecision(): it evaluates the
+   * network with the master copy of the parameters, in double precision.
+   */
+  class MasterWeightsFunction
+  {
+   public:
+    MasterWeightsFunction(StaticFFN& network) : network(network) { }
+
+    double Evaluate(const arma::mat& master,
+                    const size_t begin,
+                    const size_t batchSize)
+    {
+      network.SetParameters(master);
+      return network.Evaluate(network.parameter, begin, batchSize);
+    }
+
+    double EvaluateWithGradient(const arma::mat& master,
+                                const size_t begin,
+                                arma::mat& gradient,
+                                const size_t batchSize)
+    {
+      network.SetParameters(master);
+      const double res = network.EvaluateWithGradient(network.parameter,
+          begin, networkGradient, batchSize);
+      gradient = arma::conv_to<arma::mat>::from(networkGradient);
+      return res;
+    }
+
+    void Gradient(const arma::mat& master,
+                  const size_t begin,
+                  arma::mat& gradient,
+                  const size_t batchSize)
+    {
+      EvaluateWithGradient(master, begin, gradient, batchSize);
+    }
+
+    void Shuffle() { network.Shuffle(); }
+
+    size_t NumFunctions() const { return network.NumFunctions(); }
+
+   private:
+    StaticFFN& network;
+    //! The gradient in the precision of the network.
+    MatType networkGradient;
+  };
+
+  //! Round the given master copy into the parameters, in place, so that the
+  //! weight aliases of the layers stay valid.
+  void SetParameters(const arma::mat& master)
+  { std::copy(master.begin(), master.end(), parameter.begin()); }
+
+  /**
+   * Prepare the network for the given data.
+   *
+   * @param predictors Input data variables.
+   * @param responses Outputs results from input data variables.
+   */
+  void ResetData(MatType predictors, MatType responses);
+
+  //! Pass the deterministic flag on to each layer.
+  void ResetDeterministic();
+
+  //! Point the gradient of each layer at its part of the given matrix.
+  void ResetGradients(MatType& gradient);
+
+  //! Point the weights of each layer at their part of the parameters, and let
+  //! the layers reset their weight and bias aliases.
+  void ResetWeights();
+
+  //! Evaluate the output layer and the layer losses on the given responses.
+  template<typename ResponsesType>
+  double Loss(const ResponsesType& responses);
+
+  //! Perform the forward pass of the given input through the whole network.
+  void Forward(const MatType& input);
+
+  //! Perform the backward pass of the error from the output layer.
+  void Backward();
+
+  //! Compute the gradient of each layer for the given input.
+  void Gradient(const MatType& input);
+
+  // Each of the functions below handles the layer with index I and then calls
+  // itself for the next layer; the overload for I == sizeof...(Layers) (or
+  // I == 0 for Backward) ends the recursion.
+
+  //! Return the total number of weights of layers I, I + 1, ....
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(Layers)), size_t>::type
+  WeightSize();
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(Layers)), size_t>::type
+  WeightSize() { return 0; }
+
+  //! Initialize the weights of layers I, I + 1, ... separately.
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(Layers)), void>::type
+  InitializeLayers(const size_t offset);
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(Layers)), void>::type
+  InitializeLayers(const size_t /* offset */) { }
+
+  //! Set and reset the weights of layers I, I + 1, ....
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(Layers)), void>::type
+  ResetWeights(const size_t offset);
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(Layers)), void>::type
+  ResetWeights(const size_t /* offset */) { }
+
+  //! Set the deterministic flag of layers I, I + 1, ....
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(Layers)), void>::type
+  ResetDeterministic();
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(Layers)), void>::type
+  ResetDeterministic() { }
+
+  //! Set the gradients of layers I, I + 1, ....
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(Layers)), void>::type
+  ResetGradients(MatType& gradient, const size_t offset);
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(Layers)), void>::type
+  ResetGradients(MatType& /* gradient */, const size_t /* offset */) { }
+
+  //! Return the sum of the losses of layers I, I + 1, ....
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(Layers)), double>::type
+  LayerLoss();
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(Layers)), double>::type
+  LayerLoss() { return 0.0; }
+
+  //! Perform the forward pass of layers I, I + 1, ..., where layer I - 1 has
+  //! already been computed.
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(Layers)), void>::type
+  Forward();
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(Layers)), void>::type
+  Forward() { }
+
+  //! Perform the backward pass of layers I, I - 1, ..., 1.
+  template<size_t I>
+  typename std::enable_if<(I > 0), void>::type
+  Backward();
+  template<size_t I>
+  typename std::enable_if<(I == 0), void>::type
+  Backward() { }
+
+  //! Compute the gradient of layers I, I + 1, ..., where I > 0.
+  template<size_t I>
+  typename std::enable_if<(I < sizeof...(Layers)), void>::type
+  Gradient();
+  template<size_t I>
+  typename std::enable_if<(I == sizeof...(Layers)), void>::type
+  Gradient() { }
+
+  //! Serialize layers I, I + 1, ....
+  template<size_t I, typename Archive>
+  typename std::enable_if<(I < sizeof...(Layers)), void>::type
+  SerializeLayers(Archive& ar);
+  template<size_t I, typename Archive>
+  typename std::enable_if<(I == sizeof...(Layers)), void>::type
+  SerializeLayers(Archive& /* ar */) { }
+
+  //! Get the error passed back to layer I: the delta of the next layer, or the
+  //! error of the output layer for the last layer.
+  template<size_t I>
+  typename std::enable_if<(I + 1 < sizeof...(Layers)), MatType&>::type
+  LayerError() { return std::get<I + 1>(network).Delta(); }
+  template<size_t I>
+  typename std::enable_if<(I + 1 == sizeof...(Layers)), MatType&>::type
+  LayerError() { return error; }
+
+  //! Get the output of the last layer.
+  MatType& OutputParameter()
+  { return std::get<sizeof...(Layers) - 1>(network).OutputParameter(); }
+
+  //! Instantiated outputlayer used to evaluate the network.
+  OutputLayerType outputLayer;
+
+  //! Instantiated InitializationRule object for initializing the network
+  //! parameter.
+  InitializationRuleType initializeRule;
+
+  //! The layers of the network.
+  LayersType network;
+
+  //! The input width.
+  size_t width;
+
+  //! The input height.
+  size_t height;
+
+  //! Indicator if we already passed data through the network, so that the
+  //! input width and height of each layer are known.
+  bool reset;
+
+  //! The matrix of data points (predictors).
+  MatType predictors;
+
+  //! The matrix of responses to the input data points.
+  MatType responses;
+
+  //! Matrix of (trained) parameters.
+  MatType parameter;
+
+  //! The number of separable functions (the number of predictor points).
+  size_t numFunctions;
+
+  //! The current error for the backward pass.
+  MatType error;
+
+  //! The current evaluation mode (training or testing).
+  bool deterministic;
+}; // class StaticFFN
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "static_ffn_impl.hpp"
+
+#endif
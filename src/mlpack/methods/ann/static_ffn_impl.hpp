@@ -0,0 +1,635 @@
+/**
+ * @file methods/ann/static_ffn_impl.hpp
+ *
+ * Implementation of the StaticFFN class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "static_ffn.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    Layers... layers) :
+    network(std::move(layers)...),
+    width(0),
+    height(0),
+    reset(false),
+    numFunctions(0),
+    deterministic(false)
+{
+  /* Nothing to do here. */
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    OutputLayerType outputLayer,
+    InitializationRuleType initializeRule,
+    Layers... layers) :
+    outputLayer(std::move(outputLayer)),
+    initializeRule(std::move(initializeRule)),
+    network(std::move(layers)...),
+    width(0),
+    height(0),
+    reset(false),
+    numFunctions(0),
+    deterministic(false)
+{
+  /* Nothing to do here. */
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    const StaticFFN& network) :
+    outputLayer(network.outputLayer),
+    initializeRule(network.initializeRule),
+    network(network.network),
+    width(network.width),
+    height(network.height),
+    reset(network.reset),
+    predictors(network.predictors),
+    responses(network.responses),
+    parameter(network.parameter),
+    numFunctions(network.numFunctions),
+    error(network.error),
+    deterministic(network.deterministic)
+{
+  // The copied layers still hold copies of the weights of the other network;
+  // point them at our own parameters instead.
+  if (!parameter.is_empty())
+    ResetWeights();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    StaticFFN&& network) :
+    outputLayer(std::move(network.outputLayer)),
+    initializeRule(std::move(network.initializeRule)),
+    network(std::move(network.network)),
+    width(network.width),
+    height(network.height),
+    reset(network.reset),
+    predictors(std::move(network.predictors)),
+    responses(std::move(network.responses)),
+    parameter(std::move(network.parameter)),
+    numFunctions(network.numFunctions),
+    error(std::move(network.error)),
+    deterministic(network.deterministic)
+{
+  // Small matrices are copied instead of moved by Armadillo, so the weight
+  // aliases of the layers have to be set again.
+  if (!parameter.is_empty())
+    ResetWeights();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>&
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::operator=(
+    StaticFFN network)
+{
+  outputLayer = std::move(network.outputLayer);
+  initializeRule = std::move(network.initializeRule);
+  this->network = std::move(network.network);
+  width = network.width;
+  height = network.height;
+  reset = network.reset;
+  predictors = std::move(network.predictors);
+  responses = std::move(network.responses);
+  parameter = std::move(network.parameter);
+  numFunctions = network.numFunctions;
+  error = std::move(network.error);
+  deterministic = network.deterministic;
+
+  if (!parameter.is_empty())
+    ResetWeights();
+
+  return *this;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::ResetData(
+    MatType predictors, MatType responses)
+{
+  numFunctions = responses.n_cols;
+  this->predictors = std::move(predictors);
+  this->responses = std::move(responses);
+  this->deterministic = false;
+  ResetDeterministic();
+
+  if (parameter.is_empty())
+    ResetParameters();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename OptimizerType, typename... CallbackTypes>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Train(
+    MatType predictors,
+    MatType responses,
+    OptimizerType& optimizer,
+    CallbackTypes&&... callbacks)
+{
+  ResetData(std::move(predictors), std::move(responses));
+
+  // Train the model.
+  const double out = optimizer.Optimize(*this, parameter, callbacks...);
+
+  Log::Info << "StaticFFN::Train(): final objective of trained model is "
+      << out << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename OptimizerType, typename... CallbackTypes>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Train(
+    MatType predictors,
+    MatType responses,
+    CallbackTypes&&... callbacks)
+{
+  OptimizerType optimizer;
+  return Train(std::move(predictors), std::move(responses), optimizer,
+      callbacks...);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename OptimizerType, typename... CallbackTypes>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+TrainMixedPrecision(MatType predictors,
+                    MatType responses,
+                    OptimizerType& optimizer,
+                    CallbackTypes&&... callbacks)
+{
+  ResetData(std::move(predictors), std::move(responses));
+
+  // The optimizer updates the master copy; the network only ever sees it
+  // rounded to its own precision.
+  arma::mat master = arma::conv_to<arma::mat>::from(parameter);
+  MasterWeightsFunction function(*this);
+  const double out = optimizer.Optimize(function, master, callbacks...);
+  SetParameters(master);
+
+  Log::Info << "StaticFFN::TrainMixedPrecision(): final objective of trained "
+      << "model is " << out << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Predict(
+    MatType predictors, MatType& results, const size_t batchSize)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("StaticFFN::Predict(): the batch size must be "
+        "positive");
+  }
+
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
+  {
+    const size_t end = std::min(begin + batchSize, (size_t) predictors.n_cols);
+    Forward(MatType(predictors.colptr(begin), predictors.n_rows,
+        end - begin, false, true));
+
+    // The size of the output is only known after the first batch.
+    if (begin == 0)
+      results.set_size(OutputParameter().n_rows, predictors.n_cols);
+
+    results.cols(begin, end - 1) = OutputParameter();
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename PredictorsType, typename ResponsesType>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Evaluate(
+    const PredictorsType& predictors, const ResponsesType& responses)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  Forward(MatType(predictors));
+  return Loss(responses);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Evaluate(
+    const MatType& parameters)
+{
+  double res = 0;
+  for (size_t i = 0; i < predictors.n_cols; ++i)
+    res += Evaluate(parameters, i, 1, true);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Evaluate(
+    const MatType& /* parameters */,
+    const size_t begin,
+    const size_t batchSize,
+    const bool deterministic)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (deterministic != this->deterministic)
+  {
+    this->deterministic = deterministic;
+    ResetDeterministic();
+  }
+
+  Forward(MatType(predictors.colptr(begin), predictors.n_rows, batchSize,
+      false, true));
+  return Loss(responses.cols(begin, begin + batchSize - 1));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Evaluate(
+    const MatType& parameters, const size_t begin, const size_t batchSize)
+{
+  return Evaluate(parameters, begin, batchSize, true);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename GradType>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+EvaluateWithGradient(const MatType& parameters, GradType& gradient)
+{
+  double res = 0;
+  for (size_t i = 0; i < predictors.n_cols; ++i)
+    res += EvaluateWithGradient(parameters, i, gradient, 1);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename GradType>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+EvaluateWithGradient(const MatType& /* parameters */,
+                     const size_t begin,
+                     GradType& gradient,
+                     const size_t batchSize)
+{
+  if (gradient.is_empty())
+  {
+    if (parameter.is_empty())
+      ResetParameters();
+
+    gradient = arma::zeros<MatType>(parameter.n_rows, parameter.n_cols);
+  }
+  else
+  {
+    gradient.zeros();
+  }
+
+  if (this->deterministic)
+  {
+    this->deterministic = false;
+    ResetDeterministic();
+  }
+
+  // Alias the batch instead of copying it.
+  const MatType input(const_cast<ElemType*>(predictors.colptr(begin)),
+      predictors.n_rows, batchSize, false, true);
+  const MatType target(const_cast<ElemType*>(responses.colptr(begin)),
+      responses.n_rows, batchSize, false, true);
+
+  Forward(input);
+  const double res = Loss(target);
+
+  outputLayer.Backward(OutputParameter(), target, error);
+
+  Backward();
+  ResetGradients(gradient);
+  Gradient(input);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Gradient(
+    const MatType& parameters,
+    const size_t begin,
+    MatType& gradient,
+    const size_t batchSize)
+{
+  this->EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Shuffle()
+{
+  math::ShuffleData(predictors, responses, predictors, responses);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename PredictorsType, typename ResponsesType>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Forward(
+    const PredictorsType& inputs, ResponsesType& results)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  Forward(MatType(inputs));
+  results = OutputParameter();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::ResetParameters()
+{
+  ResetDeterministic();
+
+  // This is the same initialization as NetworkInitialization::Initialize().
+  parameter.set_size(WeightSize<0>(), 1);
+  if (ann::InitTraits<InitializationRuleType>::UseLayer)
+    InitializeLayers<0>(0);
+  else
+    initializeRule.Initialize(parameter, parameter.n_elem, 1);
+
+  ResetWeights();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename Archive>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(parameter));
+  ar(CEREAL_NVP(width));
+  ar(CEREAL_NVP(height));
+  ar(CEREAL_NVP(reset));
+
+  SerializeLayers<0>(ar);
+
+  // If we are loading, we need to initialize the weights.
+  if (cereal::is_loading<Archive>())
+  {
+    ResetWeights();
+
+    deterministic = true;
+    ResetDeterministic();
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::ResetDeterministic()
+{
+  ResetDeterministic<0>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::ResetGradients(MatType& gradient)
+{
+  ResetGradients<0>(gradient, 0);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::ResetWeights()
+{
+  ResetWeights<0>(0);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename ResponsesType>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Loss(
+    const ResponsesType& responses)
+{
+  return outputLayer.Forward(OutputParameter(), responses) + LayerLoss<0>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Forward(
+    const MatType& input)
+{
+  typename std::tuple_element<0, LayersType>::type& layer =
+      std::get<0>(network);
+  ForwardVisitor(input, layer.OutputParameter())(&layer);
+
+  if (!reset)
+  {
+    if (OutputWidthVisitor()(&layer) != 0)
+      width = OutputWidthVisitor()(&layer);
+
+    if (OutputHeightVisitor()(&layer) != 0)
+      height = OutputHeightVisitor()(&layer);
+  }
+
+  Forward<1>();
+
+  if (!reset)
+    reset = true;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Backward()
+{
+  Backward<sizeof...(Layers) - 1>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Gradient(
+    const MatType& input)
+{
+  typename std::tuple_element<0, LayersType>::type& layer =
+      std::get<0>(network);
+  GradientVisitor(input, LayerError<0>())(&layer);
+
+  Gradient<1>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(Layers)), size_t>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::WeightSize()
+{
+  return WeightSizeVisitor()(&std::get<I>(network)) + WeightSize<I + 1>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(Layers)), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+InitializeLayers(const size_t offset)
+{
+  const size_t weight = WeightSizeVisitor()(&std::get<I>(network));
+  MatType tmp(parameter.memptr() + offset, weight, 1, false, false);
+  initializeRule.Initialize(tmp, tmp.n_elem, 1);
+
+  InitializeLayers<I + 1>(offset + weight);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(Layers)), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::ResetWeights(
+    const size_t offset)
+{
+  typename std::tuple_element<I, LayersType>::type& layer =
+      std::get<I>(network);
+  const size_t weight = WeightSetVisitor(parameter, offset)(&layer);
+  ResetVisitor()(&layer);
+
+  ResetWeights<I + 1>(offset + weight);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(Layers)), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+ResetDeterministic()
+{
+  DeterministicSetVisitor(deterministic)(&std::get<I>(network));
+  ResetDeterministic<I + 1>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(Layers)), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::ResetGradients(
+    MatType& gradient, const size_t offset)
+{
+  const size_t weight =
+      GradientSetVisitor(gradient, offset)(&std::get<I>(network));
+  ResetGradients<I + 1>(gradient, offset + weight);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(Layers)), double>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::LayerLoss()
+{
+  return LossVisitor()(&std::get<I>(network)) + LayerLoss<I + 1>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(Layers)), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Forward()
+{
+  typename std::tuple_element<I, LayersType>::type& layer =
+      std::get<I>(network);
+
+  if (!reset)
+  {
+    // Set the input width and height.
+    SetInputWidthVisitor(width)(&layer);
+    SetInputHeightVisitor(height)(&layer);
+  }
+
+  ForwardVisitor(std::get<I - 1>(network).OutputParameter(),
+      layer.OutputParameter())(&layer);
+
+  if (!reset)
+  {
+    // Get the output width and height.
+    if (OutputWidthVisitor()(&layer) != 0)
+      width = OutputWidthVisitor()(&layer);
+
+    if (OutputHeightVisitor()(&layer) != 0)
+      height = OutputHeightVisitor()(&layer);
+  }
+
+  Forward<I + 1>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+typename std::enable_if<(I > 0), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Backward()
+{
+  typename std::tuple_element<I, LayersType>::type& layer =
+      std::get<I>(network);
+  BackwardVisitor(layer.OutputParameter(), LayerError<I>(), layer.Delta())(
+      &layer);
+
+  Backward<I - 1>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(Layers)), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Gradient()
+{
+  GradientVisitor(std::get<I - 1>(network).OutputParameter(),
+      LayerError<I>())(&std::get<I>(network));
+
+  Gradient<I + 1>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I, typename Archive>
+typename std::enable_if<(I < sizeof...(Layers)), void>::type
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::SerializeLayers(
+    Archive& ar)
+{
+  ar(cereal::make_nvp("layer", std::get<I>(network)));
+  SerializeLayers<I + 1>(ar);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,178 @@
+/**
+ * @file methods/ann/util/device_gemm.hpp
+ *
+ * Definition of the DeviceGemm() function, which runs the large matrix
+ * products of the layers on a GPU with Bandicoot when it is available, and of
+ * the DeviceMatrix class that keeps an operand on the GPU between products.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_UTIL_DEVICE_GEMM_HPP
+#define MLPACK_METHODS_ANN_UTIL_DEVICE_GEMM_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef HAS_BANDICOOT
+  #include <bandicoot>
+#endif
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The smallest number of multiply-adds of a product that is run on the GPU;
+ * for smaller products, the time to copy the operands to the GPU and the
+ * result back is larger than the time saved.
+ */
+static const size_t deviceGemmMinimumSize = (size_t(1) << 24);
+
+/**
+ * Whether the product of an m x k matrix and a k x n matrix is run on the
+ * GPU by DeviceGemm(): this is the case if mlpack was built with Bandicoot
+ * (USE_BANDICOOT) and the product is large enough.
+ */
+inline bool UseDevice(const size_t m, const size_t n, const size_t k)
+{
+  #ifdef HAS_BANDICOOT
+    return m * n * k >= deviceGemmMinimumSize;
+  #else
+    (void) m;
+    (void) n;
+    (void) k;
+    return false;
+  #endif
+}
+
+/**
+ * A DeviceMatrix keeps a copy of a host matrix in the memory of the GPU, so
+ * that an operand used by several products (such as the weights of a layer,
+ * used by the forward and the backward pass of a batch) is only copied once.
+ * The copy is made by the first product that uses it after Invalidate(),
+ * which the layers call when the host matrix may have changed, that is, at
+ * the start of each batch during training.  Without Bandicoot, it holds
+ * nothing.
+ */
+template<typename eT>
+class DeviceMatrix
+{
+ public:
+  //! Create an empty copy.
+  DeviceMatrix() : valid(false) { }
+
+  //! Copying a layer does not copy the memory of the GPU.
+  DeviceMatrix(const DeviceMatrix& /* other */) : valid(false) { }
+  //! Copying a layer does not copy the memory of the GPU.
+  DeviceMatrix& operator=(const DeviceMatrix& /* other */)
+  {
+    valid = false;
+    return *this;
+  }
+
+  //! Mark the copy as outdated; it is made again when it is next used.
+  void Invalidate() { valid = false; }
+  //! Get whether the copy is up to date.
+  bool Valid() const { return valid; }
+
+  #ifdef HAS_BANDICOOT
+  //! Get the copy of the given host matrix, making it if needed.
+  const coot::Mat<eT>& Get(const arma::Mat<eT>& host)
+  {
+    if (!valid)
+    {
+      device = coot::conv_to<coot::Mat<eT>>::from(host);
+      valid = true;
+    }
+
+    return device;
+  }
+  #endif
+
+ private:
+  #ifdef HAS_BANDICOOT
+  //! The copy in the memory of the GPU.
+  coot::Mat<eT> device;
+  #endif
+
+  //! Whether the copy is up to date.
+  bool valid;
+};
+
+/**
+ * Compute c = op(a) * op(b), where op() transposes its operand if the
+ * corresponding flag is set.  If UseDevice() holds for the product, it is run
+ * on the GPU: the operands are copied there (or taken from their
+ * DeviceMatrix, if one is given), and only the result is copied back.
+ * Otherwise, Armadillo computes it on the CPU as usual.  If c already has the
+ * size of the result, its memory is reused, so it may be an alias of the
+ * memory of another matrix.
+ *
+ * @param a Left operand.
+ * @param transA Whether to transpose the left operand.
+ * @param b Right operand.
+ * @param transB Whether to transpose the right operand.
+ * @param c Matrix to store the product in.
+ * @param deviceA Copy of the left operand on the GPU, or NULL.
+ * @param deviceB Copy of the right operand on the GPU, or NULL.
+ */
+template<typename eT>
+void DeviceGemm(const arma::Mat<eT>& a,
+                const bool transA,
+                const arma::Mat<eT>& b,
+                const bool transB,
+                arma::Mat<eT>& c,
+                DeviceMatrix<eT>* deviceA = NULL,
+                DeviceMatrix<eT>* deviceB = NULL)
+{
+  const size_t m = transA ? a.n_cols : a.n_rows;
+  const size_t k = transA ? a.n_rows : a.n_cols;
+  const size_t n = transB ? b.n_rows : b.n_cols;
+
+  #ifdef HAS_BANDICOOT
+  if (UseDevice(m, n, k))
+  {
+    coot::Mat<eT> copyA, copyB;
+    if (deviceA == NULL)
+      copyA = coot::conv_to<coot::Mat<eT>>::from(a);
+    if (deviceB == NULL)
+      copyB = coot::conv_to<coot::Mat<eT>>::from(b);
+    const coot::Mat<eT>& da = (deviceA == NULL) ? copyA : deviceA->Get(a);
+    const coot::Mat<eT>& db = (deviceB == NULL) ? copyB : deviceB->Get(b);
+
+    coot::Mat<eT> dc;
+    if (transA && transB)
+      dc = da.t() * db.t();
+    else if (transA)
+      dc = da.t() * db;
+    else if (transB)
+      dc = da * db.t();
+    else
+      dc = da * db;
+
+    c = coot::conv_to<arma::Mat<eT>>::from(dc);
+    return;
+  }
+  #else
+  (void) m;
+  (void) k;
+  (void) n;
+  (void) deviceA;
+  (void) deviceB;
+  #endif
+
+  if (transA && transB)
+    c = a.t() * b.t();
+  else if (transA)
+    c = a.t() * b;
+  else if (transB)
+    c = a * b.t();
+  else
+    c = a * b;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,118 @@
+/**
+ * @file methods/ann/util/int8_gemm.hpp
+ *
+ * Definition of the Int8Gemm() function and of the Quantize() helpers used by
+ * the quantized layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_UTIL_INT8_GEMM_HPP
+#define MLPACK_METHODS_ANN_UTIL_INT8_GEMM_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Quantize a value symmetrically to int8 with the given scale, so that the
+ * value is approximately scale * result.  Values out of range are clamped.
+ *
+ * @param value The value to quantize.
+ * @param invScale The inverse of the scale.
+ */
+inline int8_t Quantize(const double value, const double invScale)
+{
+  const double q = std::round(value * invScale);
+  return (int8_t) std::max(-127.0, std::min(127.0, q));
+}
+
+/**
+ * Quantize each element of the given matrix to int8 with the given scale.
+ *
+ * @param input The matrix to quantize.
+ * @param scale The scale of the quantized values.
+ * @param output The quantized matrix.
+ */
+template<typename eT>
+void Quantize(const arma::Mat<eT>& input,
+              const double scale,
+              arma::Mat<int8_t>& output)
+{
+  output.set_size(input.n_rows, input.n_cols);
+  const double invScale = (scale > 0.0) ? 1.0 / scale : 0.0;
+  for (size_t i = 0; i < input.n_elem; ++i)
+    output[i] = Quantize(input[i], invScale);
+}
+
+/**
+ * Compute the product C = A^T B of two int8 matrices, accumulating into int32.
+ * The left operand is given transposed (A is k x m), so that both operands of
+ * each dot product are contiguous in memory; the weights of the quantized
+ * layers are stored packed in this way.  Four columns of B are handled at
+ * once, so that each column of A is loaded once for four dot products.  The
+ * products of int8 values fit in int32 for any k below 2^17.
+ *
+ * @param a The left operand, transposed (k x m).
+ * @param b The right operand (k x n).
+ * @param c The result (m x n).
+ */
+inline void Int8Gemm(const arma::Mat<int8_t>& a,
+                     const arma::Mat<int8_t>& b,
+                     arma::Mat<int32_t>& c)
+{
+  Log::Assert(a.n_rows == b.n_rows, "Int8Gemm(): incompatible matrix sizes.");
+
+  const size_t k = a.n_rows;
+  c.set_size(a.n_cols, b.n_cols);
+
+  size_t j = 0;
+  for (; j + 4 <= b.n_cols; j += 4)
+  {
+    const int8_t* b0 = b.colptr(j);
+    const int8_t* b1 = b.colptr(j + 1);
+    const int8_t* b2 = b.colptr(j + 2);
+    const int8_t* b3 = b.colptr(j + 3);
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      const int8_t* ai = a.colptr(i);
+      int32_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+      for (size_t l = 0; l < k; ++l)
+      {
+        const int32_t av = ai[l];
+        s0 += av * b0[l];
+        s1 += av * b1[l];
+        s2 += av * b2[l];
+        s3 += av * b3[l];
+      }
+
+      c(i, j) = s0;
+      c(i, j + 1) = s1;
+      c(i, j + 2) = s2;
+      c(i, j + 3) = s3;
+    }
+  }
+
+  // The remaining columns.
+  for (; j < b.n_cols; ++j)
+  {
+    const int8_t* bj = b.colptr(j);
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      const int8_t* ai = a.colptr(i);
+      int32_t s = 0;
+      for (size_t l = 0; l < k; ++l)
+        s += (int32_t) ai[l] * bj[l];
+
+      c(i, j) = s;
+    }
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
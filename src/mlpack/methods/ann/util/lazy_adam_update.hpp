@@ -0,0 +1,183 @@
+/**
+ * @file methods/ann/util/lazy_adam_update.hpp
+ *
+ * Definition of LazyAdamUpdate, an Adam update policy for ens::SGD that only
+ * updates the elements of the parameters that have a nonzero gradient.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_UTIL_LAZY_ADAM_UPDATE_HPP
+#define MLPACK_METHODS_ANN_UTIL_LAZY_ADAM_UPDATE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * LazyAdamUpdate is the Adam update rule, applied only to the elements of the
+ * parameters whose gradient is stored in a sparse gradient matrix.  The moment
+ * estimates of the other elements are left as they are, instead of being
+ * decayed, so the cost of a step only depends on the number of nonzero
+ * elements of the gradient.  With the sparse gradients of FFN::TrainSparse(),
+ * the rows of a large embedding table that are not used by a batch are thus
+ * never touched.  With a dense gradient, this is the usual Adam update.
+ *
+ * It is used as the update policy of ens::SGD:
+ *
+ * @code
+ * ens::SGD<LazyAdamUpdate> optimizer(0.001, 32, 100000);
+ * model.TrainSparse(predictors, responses, optimizer);
+ * @endcode
+ *
+ * ens::SGD with ens::VanillaUpdate already only updates the elements with a
+ * nonzero gradient when the gradient is sparse.
+ */
+class LazyAdamUpdate
+{
+ public:
+  /**
+   * Create the update policy.
+   *
+   * @param epsilon The value used to initialise the mean squared gradient
+   *     parameter.
+   * @param beta1 The exponential decay rate for the 1st moment estimates.
+   * @param beta2 The exponential decay rate for the 2nd moment estimates.
+   */
+  LazyAdamUpdate(const double epsilon = 1e-8,
+                 const double beta1 = 0.9,
+                 const double beta2 = 0.999) :
+      epsilon(epsilon),
+      beta1(beta1),
+      beta2(beta2)
+  {
+    // Nothing to do.
+  }
+
+  //! Get the value used to initialise the squared gradient parameter.
+  double Epsilon() const { return epsilon; }
+  //! Modify the value used to initialise the squared gradient parameter.
+  double& Epsilon() { return epsilon; }
+
+  //! Get the exponential decay rate for the 1st moment estimates.
+  double Beta1() const { return beta1; }
+  //! Modify the exponential decay rate for the 1st moment estimates.
+  double& Beta1() { return beta1; }
+
+  //! Get the exponential decay rate for the 2nd moment estimates.
+  double Beta2() const { return beta2; }
+  //! Modify the exponential decay rate for the 2nd moment estimates.
+  double& Beta2() { return beta2; }
+
+  /**
+   * The UpdatePolicyType policy classes must contain an internal 'Policy'
+   * template class with two template arguments: MatType and GradType.  This is
+   * instantiated at the start of the optimization, and holds parameters
+   * specific to an individual optimization.
+   */
+  template<typename MatType, typename GradType>
+  class Policy
+  {
+   public:
+    /**
+     * This constructor is called by the SGD Optimize() method before the start
+     * of the iteration update process.
+     *
+     * @param parent Instantiated parent class.
+     * @param rows Number of rows in the gradient matrix.
+     * @param cols Number of columns in the gradient matrix.
+     */
+    Policy(LazyAdamUpdate& parent, const size_t rows, const size_t cols) :
+        parent(parent),
+        iteration(0)
+    {
+      m.zeros(rows, cols);
+      v.zeros(rows, cols);
+    }
+
+    /**
+     * Update step for Adam, for the nonzero elements of a sparse gradient.
+     *
+     * @param iterate Parameters that minimize the function.
+     * @param stepSize Step size to be used for the given iteration.
+     * @param gradient The sparse gradient matrix.
+     */
+    template<typename eT>
+    void Update(MatType& iterate,
+                const double stepSize,
+                const arma::SpMat<eT>& gradient)
+    {
+      ++iteration;
+      const double step = StepSize(stepSize);
+
+      typename arma::SpMat<eT>::const_iterator it = gradient.begin();
+      for (; it != gradient.end(); ++it)
+      {
+        const size_t row = it.row();
+        const size_t col = it.col();
+        const double g = (*it);
+        m(row, col) = parent.beta1 * m(row, col) + (1 - parent.beta1) * g;
+        v(row, col) = parent.beta2 * v(row, col) + (1 - parent.beta2) * g * g;
+        iterate(row, col) -= step * m(row, col) /
+            (std::sqrt(v(row, col)) + parent.epsilon);
+      }
+    }
+
+    /**
+     * Update step for Adam, for all the elements of a dense gradient.
+     *
+     * @param iterate Parameters that minimize the function.
+     * @param stepSize Step size to be used for the given iteration.
+     * @param gradient The dense gradient matrix.
+     */
+    template<typename eT>
+    void Update(MatType& iterate,
+                const double stepSize,
+                const arma::Mat<eT>& gradient)
+    {
+      ++iteration;
+      const double step = StepSize(stepSize);
+
+      m *= parent.beta1;
+      m += (1 - parent.beta1) * gradient;
+      v *= parent.beta2;
+      v += (1 - parent.beta2) * (gradient % gradient);
+      iterate -= step * m / (arma::sqrt(v) + parent.epsilon);
+    }
+
+   private:
+    //! Get the step size of the current iteration, with the bias corrections
+    //! of the moment estimates.
+    double StepSize(const double stepSize) const
+    {
+      const double biasCorrection1 = 1.0 - std::pow(parent.beta1, iteration);
+      const double biasCorrection2 = 1.0 - std::pow(parent.beta2, iteration);
+      return stepSize * std::sqrt(biasCorrection2) / biasCorrection1;
+    }
+
+    //! Instantiated parent object.
+    LazyAdamUpdate& parent;
+    //! The exponential moving average of gradient values.
+    MatType m;
+    //! The exponential moving average of squared gradient values.
+    MatType v;
+    //! The number of iterations.
+    size_t iteration;
+  };
+
+ private:
+  //! The epsilon value used to initialise the squared gradient parameter.
+  double epsilon;
+  //! The smoothing parameter.
+  double beta1;
+  //! The second moment coefficient.
+  double beta2;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,87 @@
+/**
+ * @file methods/ann/util/normalization.hpp
+ *
+ * Definition of the WelfordStatistics class, used by the normalization layers
+ * to compute the mean and variance of their inputs in a single pass.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_UTIL_NORMALIZATION_HPP
+#define MLPACK_METHODS_ANN_UTIL_NORMALIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The running mean and (biased) variance of a set of values, which are added
+ * in contiguous blocks with Update().  The values are read once.  They are
+ * handled in chunks of a few elements: the mean and the sum of squared
+ * deviations of each chunk are computed while it is in registers, and are
+ * merged into the running statistics with the pairwise update of Chan et al.
+ * This is as accurate as the element-wise Welford update, but it needs one
+ * division per chunk instead of one per element, and the loops over a chunk
+ * can be vectorized.
+ */
+class WelfordStatistics
+{
+ public:
+  //! Create empty statistics.
+  WelfordStatistics() : count(0), mean(0.0), m2(0.0) { }
+
+  /**
+   * Add the n values starting at x to the statistics.
+   *
+   * @param x The values to add.
+   * @param n The number of values.
+   */
+  template<typename eT>
+  void Update(const eT* x, const size_t n)
+  {
+    const size_t chunkSize = 16;
+    for (size_t begin = 0; begin < n; begin += chunkSize)
+    {
+      const size_t chunk = std::min(chunkSize, n - begin);
+      const eT* c = x + begin;
+
+      double chunkSum = 0.0;
+      for (size_t i = 0; i < chunk; ++i)
+        chunkSum += c[i];
+      const double chunkMean = chunkSum / chunk;
+
+      double chunkM2 = 0.0;
+      for (size_t i = 0; i < chunk; ++i)
+        chunkM2 += (c[i] - chunkMean) * (c[i] - chunkMean);
+
+      const double delta = chunkMean - mean;
+      const size_t total = count + chunk;
+      mean += delta * chunk / total;
+      m2 += chunkM2 + delta * delta * ((double) count * chunk / total);
+      count = total;
+    }
+  }
+
+  //! Get the number of values.
+  size_t Count() const { return count; }
+  //! Get the mean of the values.
+  double Mean() const { return mean; }
+  //! Get the (biased) variance of the values.
+  double Variance() const { return (count == 0) ? 0.0 : m2 / count; }
+
+ private:
+  //! The number of values.
+  size_t count;
+  //! The mean of the values.
+  double mean;
+  //! The sum of the squared deviations from the mean.
+  double m2;
+}; // class WelfordStatistics
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
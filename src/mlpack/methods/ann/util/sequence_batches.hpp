@@ -0,0 +1,95 @@
+/**
+ * @file methods/ann/util/sequence_batches.hpp
+ *
+ * Helper functions to predict batches of sequences of different lengths with
+ * RNN and BRNN.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_UTIL_SEQUENCE_BATCHES_HPP
+#define MLPACK_METHODS_ANN_UTIL_SEQUENCE_BATCHES_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Check the lengths of the sequences held in the given predictors (one column
+ * per sequence, one slice per step, padded after the end of each sequence),
+ * and return the indices of the sequences sorted by decreasing length, so that
+ * sequences of similar lengths can be predicted in the same batch.
+ *
+ * @param predictors The padded sequences.
+ * @param lengths The number of steps of each sequence.
+ * @param functionName Name of the calling function, for the error messages.
+ */
+inline arma::uvec SortSequenceLengths(const arma::cube& predictors,
+                                      const arma::Row<size_t>& lengths,
+                                      const std::string& functionName)
+{
+  if (lengths.n_elem != predictors.n_cols)
+  {
+    throw std::invalid_argument(functionName + ": " +
+        std::to_string(lengths.n_elem) + " lengths were given for " +
+        std::to_string(predictors.n_cols) + " sequences");
+  }
+
+  for (size_t i = 0; i < lengths.n_elem; ++i)
+  {
+    if (lengths[i] == 0 || lengths[i] > predictors.n_slices)
+    {
+      throw std::invalid_argument(functionName + ": the length of sequence " +
+          std::to_string(i) + " is " + std::to_string(lengths[i]) + ", but "
+          "it must be between 1 and the number of slices of the predictors (" +
+          std::to_string(predictors.n_slices) + ")");
+    }
+  }
+
+  return arma::stable_sort_index(lengths, "descend");
+}
+
+/**
+ * Gather one step of the given sequences into the columns of a batch.  If
+ * reverse is true, each sequence is read backwards from its own last step, so
+ * that the padding of every sequence still comes after its end.  The columns
+ * of the sequences that have already ended are set to zero.
+ *
+ * @param predictors The padded sequences.
+ * @param lengths The number of steps of each sequence.
+ * @param order The indices of the sequences, sorted by decreasing length.
+ * @param begin Index in order of the first sequence of the batch.
+ * @param step The step to gather.
+ * @param reverse Whether to read the sequences backwards.
+ * @param batch The batch; its number of columns is the batch size.
+ */
+inline void GatherSequenceStep(const arma::cube& predictors,
+                               const arma::Row<size_t>& lengths,
+                               const arma::uvec& order,
+                               const size_t begin,
+                               const size_t step,
+                               const bool reverse,
+                               arma::mat& batch)
+{
+  for (size_t i = 0; i < batch.n_cols; ++i)
+  {
+    const size_t sequence = order[begin + i];
+    const size_t length = lengths[sequence];
+    if (step >= length)
+    {
+      batch.col(i).zeros();
+      continue;
+    }
+
+    const size_t slice = reverse ? (length - step - 1) : step;
+    batch.col(i) = predictors.slice(slice).col(sequence);
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,80 @@
+/**
+ * @file methods/ann/visitor/gradient_ranges_visitor.hpp
+ *
+ * This file provides an abstraction to get the ranges of the gradient of
+ * different layers that may be nonzero, and automatically directs any
+ * parameter to the right layer type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_GRADIENT_RANGES_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_GRADIENT_RANGES_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include "weight_size_visitor.hpp"
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * GradientRangesVisitor appends to the given list the ranges of the gradient
+ * of the given module that may be nonzero after the last call to its
+ * Gradient() function, as (first index, number of elements) pairs, and returns
+ * the number of weights of the module.  The gradient of a module that
+ * implements the UsedColumns() function (such as Lookup) is nonzero only in
+ * these columns; the whole gradient of the other modules is used.
+ */
+class GradientRangesVisitor : public boost::static_visitor<size_t>
+{
+ public:
+  /**
+   * Create the visitor.
+   *
+   * @param ranges The list of ranges to append to.
+   * @param offset The index of the first weight of the module.
+   */
+  GradientRangesVisitor(std::vector<std::pair<size_t, size_t> >& ranges,
+                        const size_t offset);
+
+  //! Append the ranges of the module and return its number of weights.
+  template<typename LayerType>
+  size_t operator()(LayerType* layer) const;
+
+  size_t operator()(MoreTypes layer) const;
+
+ private:
+  //! The list of ranges to append to.
+  std::vector<std::pair<size_t, size_t> >& ranges;
+
+  //! The index of the first weight of the module.
+  size_t offset;
+
+  //! Append the whole gradient if the module doesn't implement the
+  //! UsedColumns() function.
+  template<typename T>
+  typename std::enable_if<
+      !HasUsedColumnsCheck<T, const arma::uvec&(T::*)() const>::value,
+      size_t>::type
+  LayerRanges(T* layer) const;
+
+  //! Append one range for each used column if the module implements the
+  //! UsedColumns() function.
+  template<typename T>
+  typename std::enable_if<
+      HasUsedColumnsCheck<T, const arma::uvec&(T::*)() const>::value,
+      size_t>::type
+  LayerRanges(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "gradient_ranges_visitor_impl.hpp"
+
+#endif
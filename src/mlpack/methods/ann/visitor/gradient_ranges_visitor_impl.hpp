@@ -0,0 +1,71 @@
+/**
+ * @file methods/ann/visitor/gradient_ranges_visitor_impl.hpp
+ *
+ * Implementation of the gradient ranges layer abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_GRADIENT_RANGES_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_GRADIENT_RANGES_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "gradient_ranges_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! GradientRangesVisitor visitor class.
+inline GradientRangesVisitor::GradientRangesVisitor(
+    std::vector<std::pair<size_t, size_t> >& ranges,
+    const size_t offset) :
+    ranges(ranges),
+    offset(offset)
+{
+  /* Nothing to do here. */
+}
+
+template<typename LayerType>
+inline size_t GradientRangesVisitor::operator()(LayerType* layer) const
+{
+  return LayerRanges(layer);
+}
+
+inline size_t GradientRangesVisitor::operator()(MoreTypes layer) const
+{
+  return layer.apply_visitor(*this);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasUsedColumnsCheck<T, const arma::uvec&(T::*)() const>::value,
+    size_t>::type
+GradientRangesVisitor::LayerRanges(T* layer) const
+{
+  const size_t size = WeightSizeVisitor()(layer);
+  if (size > 0)
+    ranges.push_back(std::make_pair(offset, size));
+
+  return size;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasUsedColumnsCheck<T, const arma::uvec&(T::*)() const>::value,
+    size_t>::type
+GradientRangesVisitor::LayerRanges(T* layer) const
+{
+  const size_t rows = layer->Parameters().n_rows;
+  const arma::uvec& usedColumns = layer->UsedColumns();
+  for (size_t i = 0; i < usedColumns.n_elem; ++i)
+    ranges.push_back(std::make_pair(offset + usedColumns[i] * rows, rows));
+
+  return layer->Parameters().n_elem;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,44 @@
+/**
+ * @file methods/ann/visitor/layer_type_name_visitor.hpp
+ *
+ * This file provides a readable name of the type of the given layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_LAYER_TYPE_NAME_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_LAYER_TYPE_NAME_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * LayerTypeNameVisitor returns the name of the C++ type of the given layer,
+ * without the mlpack::ann namespace and with arma::Mat<double> shortened to
+ * mat, e.g. "Linear<mat, mat, NoRegularizer>".  On compilers whose type names
+ * cannot be demangled, the implementation-defined name is returned.
+ */
+class LayerTypeNameVisitor : public boost::static_visitor<std::string>
+{
+ public:
+  //! Return the name of the type of the layer.
+  template<typename LayerType>
+  std::string operator()(LayerType* layer) const;
+
+  std::string operator()(MoreTypes layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "layer_type_name_visitor_impl.hpp"
+
+#endif
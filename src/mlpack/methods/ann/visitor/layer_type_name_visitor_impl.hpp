@@ -0,0 +1,67 @@
+/**
+ * @file methods/ann/visitor/layer_type_name_visitor_impl.hpp
+ *
+ * Implementation of the layer type name abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_LAYER_TYPE_NAME_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_LAYER_TYPE_NAME_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "layer_type_name_visitor.hpp"
+
+#include <cstdlib>
+#include <typeinfo>
+#if defined(__GNUG__)
+  #include <cxxabi.h>
+#endif
+
+namespace mlpack {
+namespace ann {
+
+//! LayerTypeNameVisitor visitor class.
+template<typename LayerType>
+inline std::string LayerTypeNameVisitor::operator()(LayerType* /* layer */)
+    const
+{
+  std::string name = typeid(LayerType).name();
+
+  #if defined(__GNUG__)
+  int status = 0;
+  char* demangled = abi::__cxa_demangle(name.c_str(), NULL, NULL, &status);
+  if (status == 0 && demangled != NULL)
+    name = demangled;
+  std::free(demangled);
+  #endif
+
+  // Shorten the name.
+  const std::string replacements[3][2] = {
+      { "mlpack::ann::", "" },
+      { "arma::Mat<double>", "mat" },
+      { "mlpack::", "" } };
+  for (size_t i = 0; i < 3; ++i)
+  {
+    size_t pos = 0;
+    while ((pos = name.find(replacements[i][0], pos)) != std::string::npos)
+    {
+      name.replace(pos, replacements[i][0].size(), replacements[i][1]);
+      pos += replacements[i][1].size();
+    }
+  }
+
+  return name;
+}
+
+inline std::string LayerTypeNameVisitor::operator()(MoreTypes layer) const
+{
+  return layer.apply_visitor(*this);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
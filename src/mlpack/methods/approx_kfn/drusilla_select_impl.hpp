@@ -179,19 +179,48 @@ void DrusillaSelect<MatType>::Search(const MatType& querySet,
     throw std::invalid_argument("DrusillaSelect::Search(): requested k is "
         "greater than number of points in candidate set!  Increase l or m.");
 
-  // We'll use the NeighborSearchRules class to perform our brute-force search.
-  // Note that we aren't using trees for our search, so we can use 'int' as a
-  // TreeType.
-  metric::EuclideanDistance metric;
-  NeighborSearchRules<FurthestNeighborSort, metric::EuclideanDistance,
-      tree::KDTree<metric::EuclideanDistance, tree::EmptyStatistic, MatType>>
-      rules(candidateSet, querySet, k, metric, 0, false);
-
-  for (size_t q = 0; q < querySet.n_cols; ++q)
-    for (size_t r = 0; r < candidateSet.n_cols; ++r)
-      rules.BaseCase(q, r);
-
-  rules.GetResults(neighbors, distances);
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  if (k == 0)
+    return;
+
+  // Every query is a brute-force search over the same candidate set, so the
+  // queries are independent and are searched in parallel.  Each thread keeps
+  // the k furthest candidates of its current query in a reused heap, with the
+  // nearest of them on top.
+  typedef std::pair<double, size_t> Candidate;
+  #pragma omp parallel
+  {
+    std::vector<Candidate> heap;
+    heap.reserve(k);
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+    {
+      heap.assign(k, std::make_pair(-1.0, size_t(0)));
+      for (size_t r = 0; r < candidateSet.n_cols; ++r)
+      {
+        const double distance = metric::EuclideanDistance::Evaluate(
+            querySet.col(q), candidateSet.col(r));
+        if (distance > heap.front().first)
+        {
+          std::pop_heap(heap.begin(), heap.end(),
+              std::greater<Candidate>());
+          heap.back() = std::make_pair(distance, r);
+          std::push_heap(heap.begin(), heap.end(),
+              std::greater<Candidate>());
+        }
+      }
+
+      // Sort the candidates from the furthest to the nearest.
+      std::sort_heap(heap.begin(), heap.end(), std::greater<Candidate>());
+      for (size_t j = 0; j < k; ++j)
+      {
+        neighbors(j, q) = heap[j].second;
+        distances(j, q) = heap[j].first;
+      }
+    }
+  }
 
   // Map the neighbors back to their original indices in the reference set.
   for (size_t i = 0; i < neighbors.n_elem; ++i)
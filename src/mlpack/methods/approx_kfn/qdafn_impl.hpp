@@ -15,7 +15,7 @@
 // In case it hasn't been included yet.
 #include "qdafn.hpp"
 
-#include <queue>
+#include <algorithm>
 #include <mlpack/methods/neighbor_search/sort_policies/furthest_neighbor_sort.hpp>
 
 namespace mlpack {
@@ -104,75 +104,80 @@ void QDAFN<MatType>::Search(const MatType& querySet,
   neighbors.fill(size_t() - 1);
   distances.zeros(k, querySet.n_cols);
 
-  // Search for each point.
-  for (size_t q = 0; q < querySet.n_cols; ++q)
-  {
-    // Initialize a priority queue.
-    // The size_t represents the index of the table, and the double represents
-    // the value of l_i * S_i - l_i * query (see line 6 of Algorithm 1).
-    std::priority_queue<std::pair<double, size_t>> queue;
-    for (size_t i = 0; i < l; ++i)
-    {
-      const double val = sValues(0, i) - arma::dot(querySet.col(q),
-          lines.col(i));
-      queue.push(std::make_pair(val, i));
-    }
+  // Project every query onto every line at once.
+  const arma::mat queryProjections = lines.t() * querySet;
 
+  // The queries are independent, so they are searched in parallel; each thread
+  // reuses its buffers for all of its queries.
+  #pragma omp parallel
+  {
+    // The heap of tables to take the next candidate from.  The size_t
+    // represents the index of the table, and the double represents the value
+    // of l_i * S_i - l_i * query (see line 6 of Algorithm 1).
+    std::vector<std::pair<double, size_t>> queue;
+    queue.reserve(l);
     // To track where we are in each S table, we keep the next index to look at
-    // in each table (they start at 0).
-    arma::Col<size_t> tableLocations = arma::zeros<arma::Col<size_t>>(l);
-
-    // Now that the queue is initialized, iterate over m elements.
-    std::vector<std::pair<double, size_t>> v(k, std::make_pair(-1.0,
-        size_t(-1)));
-    std::priority_queue<std::pair<double, size_t>>
-        resultsQueue(std::less<std::pair<double, size_t>>(), std::move(v));
-    for (size_t i = 0; i < m; ++i)
+    // in each table.
+    std::vector<size_t> tableLocations(l);
+    // The distance to each of the m candidates, and its index.
+    std::vector<std::pair<double, size_t>> results;
+    results.reserve(m);
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
     {
-      std::pair<size_t, double> p = queue.top();
-      queue.pop();
-
-      // Get index of reference point to look at.
-      const size_t tableIndex = tableLocations[p.second];
-
-      // Calculate distance from query point.
-      const double dist = mlpack::metric::EuclideanDistance::Evaluate(
-          querySet.col(q), candidateSet[p.second].col(tableIndex));
-
-      resultsQueue.push(std::make_pair(dist, sIndices(tableIndex, p.second)));
-
-      // Now (line 14) get the next element and insert into the queue.  Do this
-      // by adjusting the previous value.  Don't insert anything if we are at
-      // the end of the search, though.
-      if (i < m - 1)
+      queue.clear();
+      for (size_t i = 0; i < l; ++i)
+        queue.push_back(std::make_pair(sValues(0, i) - queryProjections(i, q),
+            i));
+      std::make_heap(queue.begin(), queue.end());
+      std::fill(tableLocations.begin(), tableLocations.end(), 0);
+
+      // Now that the queue is initialized, iterate over m elements.
+      results.clear();
+      for (size_t i = 0; i < m; ++i)
       {
-        tableLocations[p.second]++;
-        const double val = p.first - sValues(tableIndex, p.second) +
-            sValues(tableIndex + 1, p.second);
-
-        queue.push(std::make_pair(val, p.second));
+        std::pop_heap(queue.begin(), queue.end());
+        const std::pair<double, size_t> p = queue.back();
+        queue.pop_back();
+
+        // Get index of reference point to look at.
+        const size_t tableIndex = tableLocations[p.second];
+
+        // Calculate distance from query point.
+        const double dist = mlpack::metric::EuclideanDistance::Evaluate(
+            querySet.col(q), candidateSet[p.second].col(tableIndex));
+
+        results.push_back(std::make_pair(dist, sIndices(tableIndex,
+            p.second)));
+
+        // Now (line 14) get the next element and insert into the queue.  Do
+        // this by adjusting the previous value.  Don't insert anything if we
+        // are at the end of the search, though.
+        if (i < m - 1)
+        {
+          tableLocations[p.second]++;
+          const double val = p.first - sValues(tableIndex, p.second) +
+              sValues(tableIndex + 1, p.second);
+
+          queue.push_back(std::make_pair(val, p.second));
+          std::push_heap(queue.begin(), queue.end());
+        }
       }
-    }
 
-    // Extract the results and deduplicate them.
-    size_t extracted = 1;
-    neighbors(0, q) = resultsQueue.top().second;
-    distances(0, q) = resultsQueue.top().first;
-    resultsQueue.pop();
-
-    while (!resultsQueue.empty())
-    {
-      if (extracted == k)
-        break;
-
-      std::pair<double, size_t> result = resultsQueue.top();
-      resultsQueue.pop();
-
-      // Avoid inserting any duplicates.
-      if (neighbors(extracted - 1, q) != result.second)
+      // Extract the furthest results.  A point may have been found in more
+      // than one table; its copies are next to each other once sorted, so
+      // they are easy to skip.
+      std::sort(results.begin(), results.end(),
+          std::greater<std::pair<double, size_t>>());
+      size_t extracted = 0;
+      for (size_t i = 0; i < results.size() && extracted < k; ++i)
       {
-        neighbors(extracted, q) = resultsQueue.top().second;
-        distances(extracted, q) = resultsQueue.top().first;
+        if (extracted > 0 && neighbors(extracted - 1, q) == results[i].second)
+          continue;
+
+        neighbors(extracted, q) = results[i].second;
+        distances(extracted, q) = results[i].first;
         ++extracted;
       }
     }
@@ -33,23 +33,66 @@ BayesianLinearRegression::BayesianLinearRegression(const bool centerData,
 double BayesianLinearRegression::Train(const arma::mat& data,
                                        const arma::rowvec& responses)
 {
-  arma::mat phi;
-  arma::rowvec t;
-  arma::colvec eigVal;
-  arma::mat eigVec;
+  // Compute the offsets and scales of the data and the responses.
+  ComputeOffsets(data, responses);
+  const arma::rowvec t = responses - responsesOffset;
+
+  // Accumulate phi * phi^T and phi * t^T over blocks of points in parallel, so
+  // the processed data is never held in memory all at once.  The blocks are
+  // summed in order.
+  const size_t numBlocks = ParallelPolicy::Current().NumBlocks(data.n_cols,
+      4096);
+  const size_t blockSize = (data.n_cols + numBlocks - 1) / numBlocks;
+
+  std::vector<arma::mat> blockGrams(numBlocks);
+  std::vector<arma::colvec> blockPhiTs(numBlocks);
+  #pragma omp parallel for schedule(static, 1) if (numBlocks > 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = (size_t) b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+
+    const arma::mat block(const_cast<double*>(data.colptr(begin)),
+        data.n_rows, end - begin, false, true);
+    arma::mat phi;
+    CenterScaleDataPred(block, phi);
+    blockGrams[b] = phi * phi.t();
+    blockPhiTs[b] = phi * t.subvec(begin, end - 1).t();
+  }
 
-  // Preprocess the data. Center and scale.
-  responsesOffset = CenterScaleData(data, responses, phi, t);
+  arma::mat gram = std::move(blockGrams[0]);
+  arma::colvec phiT = std::move(blockPhiTs[0]);
+  for (size_t b = 1; b < numBlocks; ++b)
+  {
+    gram += blockGrams[b];
+    phiT += blockPhiTs[b];
+  }
 
-  if (!arma::eig_sym(eigVal, eigVec, arma::symmatu(phi * phi.t())))
+  arma::colvec eigVal;
+  arma::mat eigVec;
+  if (!arma::eig_sym(eigVal, eigVec, arma::symmatu(gram)))
   {
     Log::Fatal << "BayesianLinearRegression::Train(): Eigendecomposition "
                << "of covariance failed!" << std::endl;
   }
 
-  // Compute this quantities once and for all.
-  const arma::mat eigVecInv = inv(eigVec);
-  const arma::colvec eigVecInvPhitT = eigVecInv * phi * t.t();
+  // Compute these quantities once and for all; the eigenvectors are
+  // orthonormal, so their inverse is their transpose.  In the basis of the
+  // eigenvectors, the solution is diagonal, and so each iteration below only
+  // costs O(d).
+  const arma::colvec eigVecTPhiT = eigVec.t() * phiT;
+
+  // The squared residual of the responses splits into the part outside the
+  // span of the data, which does not depend on the hyperparameters, and the
+  // part along each of the eigenvectors of nonzero eigenvalue.
+  const double threshold = eigVal.n_elem * arma::datum::eps *
+      std::max(arma::max(eigVal), 0.0);
+  const arma::uvec span = arma::find(eigVal > threshold);
+  const arma::colvec spanEigVal = eigVal.elem(span);
+  const arma::colvec spanProjections = arma::square(eigVecTPhiT.elem(span)) /
+      spanEigVal;
+  const double outsideResidual = std::max(arma::dot(t, t) -
+      arma::accu(spanProjections), 0.0);
 
   // Initialize the hyperparameters and begin with an infinitely broad prior.
   alpha = 1e-6;
@@ -62,17 +105,19 @@ double BayesianLinearRegression::Train(const arma::mat& data,
   {
     deltaAlpha = -alpha;
     double deltaBeta = -beta;
+    const double ratio = alpha / beta;
 
-    // Update the solution.
-    omega = eigVec * diagmat(1 / (eigVal + (alpha / beta))) * eigVecInvPhitT;
+    // Update the solution, in the basis of the eigenvectors.
+    const arma::colvec z = eigVecTPhiT / (eigVal + ratio);
 
     // Update alpha.
-    gamma = sum(eigVal / (alpha / beta + eigVal));
-    alpha = gamma / dot(omega, omega);
+    gamma = sum(eigVal / (ratio + eigVal));
+    alpha = gamma / dot(z, z);
 
     // Update beta.
-    const arma::rowvec temp = t - omega.t() * phi;
-    beta = (data.n_cols - gamma) / dot(temp, temp);
+    const double residual = outsideResidual + arma::accu(spanProjections %
+        arma::square(ratio / (spanEigVal + ratio)));
+    beta = (data.n_cols - gamma) / residual;
 
     // Compute the stopping criterion.
     deltaAlpha += alpha;
@@ -80,8 +125,11 @@ double BayesianLinearRegression::Train(const arma::mat& data,
     crit = std::abs(deltaAlpha / alpha + deltaBeta / beta);
     i++;
   }
+
+  omega = eigVec * (eigVecTPhiT / (eigVal + alpha / beta));
+
   // Compute the covariance matrix for the uncertainties later.
-  matCovariance = eigVec * diagmat(1 / (beta * eigVal + alpha)) * eigVecInv;
+  matCovariance = eigVec * diagmat(1 / (beta * eigVal + alpha)) * eigVec.t();
 
   return RMSE(data, responses);
 }
@@ -115,46 +163,21 @@ double BayesianLinearRegression::RMSE(const arma::mat& data,
   return sqrt(mean(square(responses - predictions)));
 }
 
-double BayesianLinearRegression::CenterScaleData(const arma::mat& data,
-                                                 const arma::rowvec& responses,
-                                                 arma::mat& dataProc,
-                                                 arma::rowvec& responsesProc)
+void BayesianLinearRegression::ComputeOffsets(const arma::mat& data,
+                                              const arma::rowvec& responses)
 {
-  if (!centerData && !scaleData)
-  {
-    dataProc = arma::mat(const_cast<double*>(data.memptr()), data.n_rows,
-                                             data.n_cols, false, true);
-    responsesProc = arma::rowvec(const_cast<double*>(responses.memptr()),
-                                                     responses.n_elem, false,
-                                                     true);
-  }
-
-  else if (centerData && !scaleData)
+  if (centerData)
   {
     dataOffset = mean(data, 1);
     responsesOffset = mean(responses);
-    dataProc = data.each_col() - dataOffset;
-    responsesProc = responses - responsesOffset;
   }
-
-  else if (!centerData && scaleData)
+  else
   {
-    dataScale = stddev(data, 0, 1);
-    dataProc = data.each_col() / dataScale;
-    responsesProc = arma::rowvec(const_cast<double*>(responses.memptr()),
-                                                     responses.n_elem, false,
-                                                     true);
+    responsesOffset = 0.0;
   }
 
-  else
-  {
-    dataOffset = mean(data, 1);
+  if (scaleData)
     dataScale = stddev(data, 0, 1);
-    responsesOffset = mean(responses);
-    dataProc = (data.each_col() - dataOffset).each_col() / dataScale;
-    responsesProc = responses - responsesOffset;
-  }
-  return responsesOffset;
 }
 
 void BayesianLinearRegression::CenterScaleDataPred(
@@ -122,6 +122,11 @@ class BayesianLinearRegression
    * should be column-major -- each column is an observation and each row is a
    * dimension.
    *
+   * The data is only read to compute the products phi * phi^T and phi * t^T,
+   * in parallel over blocks of points, and to compute the final error; the
+   * evidence maximization iterations then work in the eigenbasis of
+   * phi * phi^T, at a cost of O(P) each.
+   *
    * @param data Column-major input data, dim(P, N).
    * @param responses A vector of targets, dim(N).
    * @return Root mean squared error.
@@ -283,19 +288,13 @@ class BayesianLinearRegression
   arma::mat matCovariance;
 
   /**
-   * Center and scale the data accordind to centerData and scaleData.
-   * Allows future modifications of new points.
+   * Compute the offsets and the scales of the data and of the responses,
+   * according to centerData and scaleData.
    *
    * @param data Design matrix in column-major format, dim(P, N).
    * @param responses A vector of targets.
-   * @param dataProc Data processed, dim(P, N).
-   * @param responsesProc Responses processed, dim(N).
-   * @return reponsesOffset Mean of responses.
    */
-  double CenterScaleData(const arma::mat& data,
-                         const arma::rowvec& responses,
-                         arma::mat& dataProc,
-                         arma::rowvec& responsesProc);
+  void ComputeOffsets(const arma::mat& data, const arma::rowvec& responses);
 
   /**
    * Center and scale the points before prediction.
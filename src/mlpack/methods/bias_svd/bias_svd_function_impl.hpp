@@ -15,6 +15,7 @@
 
 #include "bias_svd_function.hpp"
 #include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/methods/regularized_svd/rating_blocks.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -267,14 +268,14 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
   double overallObjective = DBL_MAX;
   double lastObjective;
 
-  // The order in which the functions will be visited.
-  arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
-      (function.NumFunctions() - 1), function.NumFunctions());
-
   const arma::mat data = function.Dataset();
   const size_t numUsers = function.NumUsers();
   const double lambda = function.Lambda();
 
+  // Threads update disjoint blocks of users and items (with their biases), so
+  // no synchronization is needed.
+  mlpack::svd::RatingBlocks blocks(data, numUsers, function.NumItems());
+
   // Rank of decomposition.
   const size_t rank = function.Rank();
 
@@ -316,60 +317,40 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
     double stepSize = decayPolicy.StepSize(i);
 
     if (shuffle) // Determine order of visitation.
-      std::shuffle(visitationOrder.begin(), visitationOrder.end(),
-          mlpack::math::randGen);
+      blocks.Shuffle();
 
-    #pragma omp parallel
+    blocks.Visit([&](const size_t j)
     {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize.
-      size_t threadId = 0;
-      #ifdef HAS_OPENMP
-        threadId = omp_get_thread_num();
-      #endif
-
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
-      {
-        // Indices for accessing the the correct parameter columns.
-        const size_t user = data(0, visitationOrder[j]);
-        const size_t item = data(1, visitationOrder[j]) + numUsers;
-
-        // Prediction error for the example.
-        const double rating = data(2, visitationOrder[j]);
-        const double userBias = iterate(rank, user);
-        const double itemBias = iterate(rank, item);
-        double ratingError = rating - userBias - itemBias -
-            arma::dot(iterate.col(user).subvec(0, rank - 1),
-                      iterate.col(item).subvec(0, rank - 1));
-
-        arma::mat userVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(user).subvec(0, rank - 1) -
-            ratingError * iterate.col(item).subvec(0, rank - 1));
-        arma::mat itemVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(item).subvec(0, rank - 1) -
-            ratingError * iterate.col(user).subvec(0, rank - 1));
-        double userBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, user) - ratingError);
-        double itemBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, item) - ratingError);
-
-        // Gradient is non-zero only for the parameter columns corresponding to
-        // the example.
-        for (size_t i = 0; i < rank; ++i)
-        {
-          #pragma omp atomic
-          iterate(i, user) -= userVecUpdate(i);
-          #pragma omp atomic
-          iterate(i, item) -= itemVecUpdate(i);
-        }
-        #pragma omp atomic
-        iterate(rank, user) -= userBiasUpdate;
-        #pragma omp atomic
-        iterate(rank, item) -= itemBiasUpdate;
-      }
-    }
+      // Indices for accessing the the correct parameter columns.
+      const size_t user = data(0, j);
+      const size_t item = data(1, j) + numUsers;
+
+      // Prediction error for the example.
+      const double rating = data(2, j);
+      const double userBias = iterate(rank, user);
+      const double itemBias = iterate(rank, item);
+      const double ratingError = rating - userBias - itemBias -
+          arma::dot(iterate.col(user).subvec(0, rank - 1),
+                    iterate.col(item).subvec(0, rank - 1));
+
+      const arma::vec userVecUpdate = stepSize * 2 * (
+          lambda * iterate.col(user).subvec(0, rank - 1) -
+          ratingError * iterate.col(item).subvec(0, rank - 1));
+      const arma::vec itemVecUpdate = stepSize * 2 * (
+          lambda * iterate.col(item).subvec(0, rank - 1) -
+          ratingError * iterate.col(user).subvec(0, rank - 1));
+      const double userBiasUpdate = stepSize * 2 * (
+          lambda * iterate(rank, user) - ratingError);
+      const double itemBiasUpdate = stepSize * 2 * (
+          lambda * iterate(rank, item) - ratingError);
+
+      // Gradient is non-zero only for the parameter columns corresponding to
+      // the example.
+      iterate.col(user).subvec(0, rank - 1) -= userVecUpdate;
+      iterate.col(item).subvec(0, rank - 1) -= itemVecUpdate;
+      iterate(rank, user) -= userBiasUpdate;
+      iterate(rank, item) -= itemBiasUpdate;
+    });
   }
   mlpack::Log::Info << "\n Parallel SGD terminated with objective : "
     << overallObjective << std::endl;
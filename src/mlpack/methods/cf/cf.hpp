@@ -18,6 +18,8 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/fastmks/fastmks.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
 #include <mlpack/methods/amf/amf.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_als.hpp>
 #include <mlpack/methods/amf/termination_policies/simple_residue_termination.hpp>
@@ -26,6 +28,7 @@
 #include <mlpack/methods/cf/neighbor_search_policies/lmetric_search.hpp>
 #include <mlpack/methods/cf/interpolation_policies/average_interpolation.hpp>
 #include <set>
+#include <typeinfo>
 #include <map>
 #include <iostream>
 
@@ -143,6 +146,49 @@ class CFType
              const double minResidue = 1e-5,
              const bool mit = false);
 
+  /**
+   * Add ratings to a trained model without retraining it.  The ratings are
+   * normalized with the statistics of the training data and stored in the
+   * cleaned data (replacing earlier ratings of the same user and item), and the
+   * factors of every user with new ratings are solved for again against the
+   * fixed item factors (see FoldInUser()).  Users that the model has not seen
+   * are added to it; items must already be known to the model.
+   *
+   * Folding in is much cheaper than training, but the item factors do not
+   * learn from the new ratings, so the model should be refreshed from time to
+   * time with Refresh().
+   *
+   * @param ratings New ratings; dense matrix (coordinate lists).
+   * @param lambda Regularization parameter of the user solves.
+   */
+  void AddRatings(const arma::mat& ratings, const double lambda = 0.05);
+
+  /**
+   * Solve for the factors of the given user against the fixed item factors,
+   * with the ratings of the user in the cleaned data.  The items and the other
+   * users are not changed.
+   *
+   * @param user User ID.
+   * @param lambda Regularization parameter of the user solve.
+   */
+  void FoldInUser(const size_t user, const double lambda = 0.05);
+
+  /**
+   * Factorize the cleaned data again, including all the ratings added with
+   * AddRatings(), with the current rank and decomposition.  The normalization
+   * statistics are not recomputed.  Refresh() only changes this object, so a
+   * periodic refresh can be done in the background on a copy of the model,
+   * while the original keeps serving requests, and the copy can then be
+   * swapped in.
+   *
+   * @param maxIterations Maximum number of iterations.
+   * @param minResidue Residue required to terminate.
+   * @param mit Whether to terminate only when maxIterations is reached.
+   */
+  void Refresh(const size_t maxIterations = 1000,
+               const double minResidue = 1e-5,
+               const bool mit = false);
+
   //! Sets number of users for calculating similarity.
   void NumUsersForSimilarity(const size_t num)
   {
@@ -153,6 +199,7 @@ class CFType
       return;
     }
     this->numUsersForSimilarity = num;
+    ClearNeighborhoodIndex();
   }
 
   //! Gets number of users for calculating similarity.
@@ -216,6 +263,90 @@ class CFType
                           arma::Mat<size_t>& recommendations,
                           const arma::Col<size_t>& users);
 
+  /**
+   * Generates the given number of recommendations for all users, with a
+   * maximum inner product search over the item vectors of the decomposition
+   * instead of computing the ratings of every item.  See the other overload of
+   * GetMIPSRecommendations() for details.
+   *
+   * @tparam NeighborSearchPolicy The policy used to search neighbors of
+   *     query set in referece set.
+   * @tparam InterpolationPolicy The policy used to calculate interpolation
+   *     weights.
+   *
+   * @param numRecs Number of Recommendations.
+   * @param recommendations Matrix to save recommendations into.
+   */
+  template<typename NeighborSearchPolicy = EuclideanSearch,
+           typename InterpolationPolicy = AverageInterpolation>
+  void GetMIPSRecommendations(const size_t numRecs,
+                              arma::Mat<size_t>& recommendations);
+
+  /**
+   * Generates the given number of recommendations for the specified users,
+   * with a maximum inner product search (FastMKS with the linear kernel) over
+   * the item vectors of the decomposition, instead of computing the ratings of
+   * every item.  The recommendations are the same as those of
+   * GetRecommendations(), up to ties.
+   *
+   * The interpolated ratings of each user are written as inner products of a
+   * query vector with the item vectors given by the GetItemVectors() and
+   * GetUserVector() methods of the DecompositionPolicy, with one extra
+   * dimension holding the item-dependent part of the normalization.  Items
+   * the user already rated are skipped: users are grouped by the number of
+   * items they rated, and each group searches for enough items that the given
+   * number of recommendations is left after filtering.
+   *
+   * @tparam NeighborSearchPolicy The policy used to search neighbors of
+   *     query set in referece set.
+   * @tparam InterpolationPolicy The policy used to calculate interpolation
+   *     weights.
+   *
+   * @param numRecs Number of Recommendations.
+   * @param recommendations Matrix to save recommendations.
+   * @param users Users for which recommendations are to be generated.
+   */
+  template<typename NeighborSearchPolicy = EuclideanSearch,
+           typename InterpolationPolicy = AverageInterpolation>
+  void GetMIPSRecommendations(const size_t numRecs,
+                              arma::Mat<size_t>& recommendations,
+                              const arma::Col<size_t>& users);
+
+  /**
+   * Precompute the neighborhood of every user and its interpolation weights,
+   * and keep them in the model as an index.  Later calls to Predict() and
+   * GetRecommendations() with the same NeighborSearchPolicy and
+   * InterpolationPolicy read the neighborhoods and weights of the queried
+   * users from the index, instead of searching for the neighbors and solving
+   * for the weights again.  The index is discarded whenever the model changes.
+   *
+   * @tparam NeighborSearchPolicy The policy used to search neighbors of
+   *     query set in referece set.
+   * @tparam InterpolationPolicy The policy used to calculate interpolation
+   *     weights.
+   */
+  template<typename NeighborSearchPolicy = EuclideanSearch,
+           typename InterpolationPolicy = AverageInterpolation>
+  void BuildNeighborhoodIndex();
+
+  //! Discard the neighborhood index, if there is one.
+  void ClearNeighborhoodIndex()
+  {
+    indexNeighborhood.reset();
+    indexWeights.reset();
+    indexKey = 0;
+  }
+
+  //! Get whether there is a neighborhood index for the given policies.
+  template<typename NeighborSearchPolicy = EuclideanSearch,
+           typename InterpolationPolicy = AverageInterpolation>
+  bool HasNeighborhoodIndex() const
+  {
+    return (indexWeights.n_cols != 0) && (indexKey ==
+        typeid(std::pair<NeighborSearchPolicy, InterpolationPolicy>)
+        .hash_code());
+  }
+
   //! Converts the User, Item, Value Matrix to User-Item Table.
   static void CleanData(const arma::mat& data, arma::sp_mat& cleanedData);
 
@@ -273,6 +404,24 @@ class CFType
   arma::sp_mat cleanedData;
   //! Data normalization object.
   NormalizationType normalization;
+  //! Neighborhood of each user in the neighborhood index.
+  arma::Mat<size_t> indexNeighborhood;
+  //! Interpolation weights of each user in the neighborhood index.
+  arma::mat indexWeights;
+  //! Hash of the policies the neighborhood index was built with.
+  size_t indexKey;
+
+  /**
+   * Find the neighborhoods of the given users and their interpolation weights,
+   * from the neighborhood index if it was built with the same policies.
+   * Otherwise, the weights of the users are solved for in parallel, so
+   * InterpolationPolicy::GetWeights() must be const and thread-safe.
+   */
+  template<typename NeighborSearchPolicy,
+           typename InterpolationPolicy>
+  void ComputeNeighborhoods(const arma::Col<size_t>& users,
+                            arma::Mat<size_t>& neighborhood,
+                            arma::mat& weights) const;
 
   //! Candidate represents a possible recommendation (value, item).
   typedef std::pair<double, size_t> Candidate;
@@ -30,7 +30,8 @@ CFType<DecompositionPolicy,
 CFType(const size_t numUsersForSimilarity,
        const size_t rank) :
     numUsersForSimilarity(numUsersForSimilarity),
-    rank(rank)
+    rank(rank),
+    indexKey(0)
 {
   // Validate neighbourhood size.
   if (numUsersForSimilarity < 1)
@@ -58,7 +59,8 @@ CFType(const MatType& data,
        const double minResidue,
        const bool mit) :
     numUsersForSimilarity(numUsersForSimilarity),
-    rank(rank)
+    rank(rank),
+    indexKey(0)
 {
   // Validate neighbourhood size.
   if (numUsersForSimilarity < 1)
@@ -84,6 +86,7 @@ Train(const arma::mat& data,
       const bool mit)
 {
   this->decomposition = decomposition;
+  ClearNeighborhoodIndex();
 
   // Make a copy of data before performing normalization.
   arma::mat normalizedData(data);
@@ -123,6 +126,7 @@ Train(const arma::sp_mat& data,
       const bool mit)
 {
   this->decomposition = decomposition;
+  ClearNeighborhoodIndex();
 
   // data is not used in the following decomposition.Apply() method, so we only
   // need to Normalize cleanedData.
@@ -150,6 +154,96 @@ Train(const arma::sp_mat& data,
       data, cleanedData, rank, maxIterations, minResidue, mit);
 }
 
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+AddRatings(const arma::mat& ratings, const double lambda)
+{
+  if (ratings.n_rows != 3)
+  {
+    std::ostringstream oss;
+    oss << "CFType::AddRatings(): ratings must have 3 rows (user, item, "
+        << "rating), but " << ratings.n_rows << " rows were given";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (ratings.n_cols == 0)
+    return;
+
+  if ((size_t) arma::max(ratings.row(1)) >= cleanedData.n_rows)
+  {
+    throw std::invalid_argument("CFType::AddRatings(): ratings of items that "
+        "are unknown to the model can only be added by retraining");
+  }
+
+  // The neighborhoods change with the new ratings.
+  ClearNeighborhoodIndex();
+
+  // Normalize the new ratings with the statistics of the training data.
+  arma::mat normalizedRatings(ratings);
+  normalization.NormalizeNewRatings(normalizedRatings);
+
+  // Merge the new ratings into the cleaned data; a new rating replaces the old
+  // rating of the same user and item.
+  const size_t numUsers = std::max((size_t) cleanedData.n_cols,
+      (size_t) arma::max(ratings.row(0)) + 1);
+  arma::sp_mat newData;
+  CleanData(normalizedRatings, newData);
+  newData.resize(cleanedData.n_rows, numUsers);
+  cleanedData.resize(cleanedData.n_rows, numUsers);
+  cleanedData = cleanedData - cleanedData % arma::spones(newData) + newData;
+
+  // Fold in every user with new ratings.  The users are visited from the
+  // largest ID down, so that the user matrix grows only once.
+  const arma::vec users = arma::unique(ratings.row(0).t());
+  for (size_t i = users.n_elem; i > 0; --i)
+    decomposition.FoldInUser((size_t) users[i - 1], cleanedData, lambda);
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+FoldInUser(const size_t user, const double lambda)
+{
+  if (user >= cleanedData.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "CFType::FoldInUser(): user " << user << " is unknown to the model "
+        << "(" << cleanedData.n_cols << " users)";
+    throw std::invalid_argument(oss.str());
+  }
+
+  ClearNeighborhoodIndex();
+  decomposition.FoldInUser(user, cleanedData, lambda);
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+Refresh(const size_t maxIterations,
+        const double minResidue,
+        const bool mit)
+{
+  ClearNeighborhoodIndex();
+
+  // Some decompositions take the ratings as a coordinate list, so rebuild it
+  // from the (already normalized) cleaned data.
+  arma::mat normalizedData(3, cleanedData.n_nonzero);
+  arma::sp_mat::const_iterator it = cleanedData.begin();
+  for (size_t i = 0; it != cleanedData.end(); ++it, ++i)
+  {
+    normalizedData(0, i) = it.col();
+    normalizedData(1, i) = it.row();
+    normalizedData(2, i) = (*it);
+  }
+
+  decomposition.Apply(
+      normalizedData, cleanedData, rank, maxIterations, minResidue, mit);
+}
+
 template<typename DecompositionPolicy,
          typename NormalizationType>
 template<typename NeighborSearchPolicy,
@@ -183,16 +277,15 @@ GetRecommendations(const size_t numRecs,
 {
   // Temporary storage for neighborhood of the queried users.
   arma::Mat<size_t> neighborhood;
-  // Resulting similarities.
-  arma::mat similarities;
+  // Interpolation weights of the neighbors.
+  arma::mat weights;
 
   // Calculate the neighborhood of the queried users.  Note that the query user
   // is part of the neighborhood---this is intentional.  We want to use the
   // weighted sum of both the query user and the local neighborhood of the
   // query user.
-  // Calculate the neighborhood of the queried users.
-  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
-      users, numUsersForSimilarity, neighborhood, similarities);
+  ComputeNeighborhoods<NeighborSearchPolicy, InterpolationPolicy>(users,
+      neighborhood, weights);
 
   // Generate recommendations for each query user by finding the maximum numRecs
   // elements in the ratings vector.
@@ -201,29 +294,31 @@ GetRecommendations(const size_t numRecs,
   recommendations.fill(SIZE_MAX);
   values.fill(DBL_MAX);
 
-  // Initialization of an InterpolationPolicy object should be put ahead of the
-  // following loop, because the initialization may takes a relatively long
-  // time and we don't want to repeat the initialization process in each loop.
-  InterpolationPolicy interpolation(cleanedData);
-
-  for (size_t i = 0; i < users.n_elem; ++i)
+  // The recommendations of different users are independent.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) users.n_elem; ++i)
   {
     // First, calculate the weighted sum of neighborhood values.
     arma::vec ratings;
     ratings.zeros(cleanedData.n_rows);
 
-    // Calculate interpolation weights.
-    arma::vec weights(numUsersForSimilarity);
-    interpolation.GetWeights(weights, decomposition, users(i),
-        neighborhood.col(i), similarities.col(i), cleanedData);
-
     for (size_t j = 0; j < neighborhood.n_rows; ++j)
     {
       arma::vec neighborRatings;
       decomposition.GetRatingOfUser(neighborhood(j, i), neighborRatings);
-      ratings += weights(j) * neighborRatings;
+      ratings += weights(j, i) * neighborRatings;
     }
 
+    // Mark the items the user already rated.  The algorithm omits rating of
+    // zero. Thus, when normalizing original ratings in Normalize(), if
+    // normalized rating equals zero, it is set to the smallest positive double
+    // value.
+    std::vector<bool> rated(cleanedData.n_rows, false);
+    arma::sp_mat::const_iterator it = cleanedData.begin_col(users(i));
+    arma::sp_mat::const_iterator itEnd = cleanedData.end_col(users(i));
+    for (; it != itEnd; ++it)
+      rated[it.row()] = true;
+
     // Let's build the list of candidate recomendations for the given user.
     // Default candidate: the smallest possible value and invalid item number.
     const Candidate def = std::make_pair(-DBL_MAX, cleanedData.n_rows);
@@ -236,10 +331,7 @@ GetRecommendations(const size_t numRecs,
     for (size_t j = 0; j < ratings.n_rows; ++j)
     {
       // Ensure that the user hasn't already rated the item.
-      // The algorithm omits rating of zero. Thus, when normalizing original
-      // ratings in Normalize(), if normalized rating equals zero, it is set
-      // to the smallest positive double value.
-      if (cleanedData(j, users(i)) != 0.0)
+      if (rated[j])
         continue; // The user already rated the item.
 
       // Is the estimated value better than the worst candidate?
@@ -259,16 +351,148 @@ GetRecommendations(const size_t numRecs,
       values(numRecs - p, i) = pqueue.top().first;
       pqueue.pop();
     }
+  }
 
-    // If we were not able to come up with enough recommendations, issue a
-    // warning.
-    if (recommendations(numRecs - 1, i) == def.second)
+  // If we were not able to come up with enough recommendations, issue a
+  // warning.
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    if (numRecs > 0 && recommendations(numRecs - 1, i) == cleanedData.n_rows)
       Log::Warn << "Could not provide " << numRecs << " recommendations "
           << "for user " << users(i) << " (not enough un-rated items)!"
           << std::endl;
   }
 }
 
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename NeighborSearchPolicy,
+         typename InterpolationPolicy>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetMIPSRecommendations(const size_t numRecs,
+                       arma::Mat<size_t>& recommendations)
+{
+  arma::Col<size_t> users = arma::linspace<arma::Col<size_t> >(0,
+      cleanedData.n_cols - 1, cleanedData.n_cols);
+
+  GetMIPSRecommendations<NeighborSearchPolicy,
+                         InterpolationPolicy>(numRecs, recommendations, users);
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename NeighborSearchPolicy,
+         typename InterpolationPolicy>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetMIPSRecommendations(const size_t numRecs,
+                       arma::Mat<size_t>& recommendations,
+                       const arma::Col<size_t>& users)
+{
+  // Calculate the neighborhood of the queried users, as GetRecommendations()
+  // does.
+  arma::Mat<size_t> neighborhood;
+  arma::mat similarities;
+  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
+      users, numUsersForSimilarity, neighborhood, similarities);
+
+  InterpolationPolicy interpolation(cleanedData);
+
+  // The denormalized rating of an item is a * rating + b(item) + c(user), so
+  // the slope is folded into the item vectors, and the item-dependent offset
+  // is held in an extra dimension.  The user-dependent offset does not change
+  // the order of the items.
+  arma::mat itemVectors;
+  decomposition.GetItemVectors(itemVectors);
+  const size_t numItems = itemVectors.n_cols;
+  const double offset = normalization.Denormalize(0, 0, 0.0);
+  const double slope = normalization.Denormalize(0, 0, 1.0) - offset;
+
+  arma::mat referenceSet(itemVectors.n_rows + 1, numItems);
+  referenceSet.head_rows(itemVectors.n_rows) = slope * itemVectors;
+  for (size_t j = 0; j < numItems; ++j)
+  {
+    referenceSet(itemVectors.n_rows, j) =
+        normalization.Denormalize(0, j, 0.0) - offset;
+  }
+
+  // The query vector of each user is the weighted sum of the vectors of its
+  // neighborhood.
+  arma::mat querySet(referenceSet.n_rows, users.n_elem);
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    arma::vec weights(numUsersForSimilarity);
+    interpolation.GetWeights(weights, decomposition, users(i),
+        neighborhood.col(i), similarities.col(i), cleanedData);
+
+    arma::vec query(itemVectors.n_rows, arma::fill::zeros);
+    arma::vec userVector;
+    for (size_t j = 0; j < neighborhood.n_rows; ++j)
+    {
+      decomposition.GetUserVector(neighborhood(j, i), userVector);
+      query += weights(j) * userVector;
+    }
+
+    querySet.submat(0, i, itemVectors.n_rows - 1, i) = query;
+    querySet(itemVectors.n_rows, i) = 1.0;
+  }
+
+  // Group the users by the number of items they rated, rounded up to a power
+  // of two, so that each group can search for the number of recommendations
+  // plus that many items, and still have enough unrated items left.
+  std::map<size_t, std::vector<size_t>> groups;
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    const size_t rated = cleanedData.col(users(i)).n_nonzero;
+    size_t bucket = 1;
+    while (bucket < rated)
+      bucket *= 2;
+    groups[bucket].push_back(i);
+  }
+
+  fastmks::FastMKS<kernel::LinearKernel> mips(std::move(referenceSet));
+
+  recommendations.set_size(numRecs, users.n_elem);
+  for (auto it = groups.begin(); it != groups.end(); ++it)
+  {
+    const std::vector<size_t>& group = it->second;
+    const size_t k = std::min(numRecs + it->first, numItems);
+
+    arma::Mat<size_t> indices;
+    arma::mat products;
+    const arma::mat groupQueries =
+        querySet.cols(arma::conv_to<arma::uvec>::from(group));
+    mips.Search(groupQueries, k, indices, products);
+
+    for (size_t g = 0; g < group.size(); ++g)
+    {
+      const size_t i = group[g];
+
+      // Take the best items that the user hasn't already rated.
+      size_t found = 0;
+      for (size_t j = 0; j < k && found < numRecs; ++j)
+      {
+        const size_t item = indices(j, g);
+        if (cleanedData(item, users(i)) != 0.0)
+          continue; // The user already rated the item.
+
+        recommendations(found++, i) = item;
+      }
+
+      // If we were not able to come up with enough recommendations, issue a
+      // warning.
+      if (found < numRecs)
+      {
+        recommendations.submat(found, i, numRecs - 1, i).fill(numItems);
+        Log::Warn << "Could not provide " << numRecs << " recommendations "
+            << "for user " << users(i) << " (not enough un-rated items)!"
+            << std::endl;
+      }
+    }
+  }
+}
+
 // Predict the rating for a single user/item combination.
 template<typename DecompositionPolicy,
          typename NormalizationType>
@@ -283,30 +507,22 @@ Predict(const size_t user, const size_t item) const
 
   // Temporary storage for neighborhood of the queried users.
   arma::Mat<size_t> neighborhood;
-  // Resulting similarities.
-  arma::mat similarities;
+  // Interpolation weights of the neighbors.
+  arma::mat weights;
 
   // Calculate the neighborhood of the queried users.  Note that the query user
   // is part of the neighborhood---this is intentional.  We want to use the
   // weighted sum of both the query user and the local neighborhood of the
   // query user.
-  // Calculate the neighborhood of the queried users.
   arma::Col<size_t> users(1);
   users(0) = user;
-  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
-      users, numUsersForSimilarity, neighborhood, similarities);
-
-  arma::vec weights(numUsersForSimilarity);
-
-  // Calculate interpolation weights.
-  InterpolationPolicy interpolation(cleanedData);
-  interpolation.GetWeights(weights, decomposition, user,
-      neighborhood.col(0), similarities.col(0), cleanedData);
+  ComputeNeighborhoods<NeighborSearchPolicy, InterpolationPolicy>(users,
+      neighborhood, weights);
 
   double rating = 0; // We'll take the weighted sum of neighborhood values.
 
   for (size_t j = 0; j < neighborhood.n_rows; ++j)
-    rating += weights(j) * decomposition.GetRating(neighborhood(j, 0), item);
+    rating += weights(j, 0) * decomposition.GetRating(neighborhood(j, 0), item);
 
   // Denormalize rating and return.
   double realRating = normalization.Denormalize(user, item, rating);
@@ -336,45 +552,38 @@ Predict(const arma::Mat<size_t>& combinations,
 
   // Temporary storage for neighborhood of the queried users.
   arma::Mat<size_t> neighborhood;
-  // Resulting similarities.
-  arma::mat similarities;
+  // Interpolation weights of the neighbors.
+  arma::mat weights;
 
   // Calculate the neighborhood of the queried users.  Note that the query user
   // is part of the neighborhood---this is intentional.  We want to use the
   // weighted sum of both the query user and the local neighborhood of the
   // query user.
-  // Calculate the neighborhood of the queried users.
-  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
-      users, numUsersForSimilarity, neighborhood, similarities);
+  ComputeNeighborhoods<NeighborSearchPolicy, InterpolationPolicy>(users,
+      neighborhood, weights);
 
-  arma::mat weights(numUsersForSimilarity, users.n_elem);
-
-  // Calculate interpolation weights.
-  InterpolationPolicy interpolation(cleanedData);
-  for (size_t i = 0; i < users.n_elem; ++i)
+  // Map each combination's user to the user ID used for kNN.  This is a
+  // cumulative count, because the combinations are sorted by user.
+  arma::Col<size_t> userIndices(sortedCombinations.n_cols);
+  size_t user = 0;
+  for (size_t i = 0; i < sortedCombinations.n_cols; ++i)
   {
-    interpolation.GetWeights(weights.col(i), decomposition, users[i],
-        neighborhood.col(i), similarities.col(i), cleanedData);
+    while (users[user] < sortedCombinations(0, i))
+      ++user;
+    userIndices[i] = user;
   }
 
   // Now that we have the neighborhoods we need, calculate the predictions.
   predictions.set_size(combinations.n_cols);
 
-  size_t user = 0; // Cumulative user count, because we are doing it in order.
-  for (size_t i = 0; i < sortedCombinations.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) sortedCombinations.n_cols; ++i)
   {
-    // Could this be made faster by calculating dot products for multiple items
-    // at once?
     double rating = 0.0;
-
-    // Map the combination's user to the user ID used for kNN.
-    while (users[user] < sortedCombinations(0, i))
-      ++user;
-
     for (size_t j = 0; j < neighborhood.n_rows; ++j)
     {
-      rating += weights(j, user) * decomposition.GetRating(
-          neighborhood(j, user), sortedCombinations(1, i));
+      rating += weights(j, userIndices[i]) * decomposition.GetRating(
+          neighborhood(j, userIndices[i]), sortedCombinations(1, i));
     }
 
     predictions(ordering[i]) = rating;
@@ -384,6 +593,68 @@ Predict(const arma::Mat<size_t>& combinations,
   normalization.Denormalize(combinations, predictions);
 }
 
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename NeighborSearchPolicy,
+         typename InterpolationPolicy>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+BuildNeighborhoodIndex()
+{
+  ClearNeighborhoodIndex();
+
+  const arma::Col<size_t> users = arma::linspace<arma::Col<size_t>>(0,
+      cleanedData.n_cols - 1, cleanedData.n_cols);
+  ComputeNeighborhoods<NeighborSearchPolicy, InterpolationPolicy>(users,
+      indexNeighborhood, indexWeights);
+  indexKey = typeid(std::pair<NeighborSearchPolicy, InterpolationPolicy>)
+      .hash_code();
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename NeighborSearchPolicy,
+         typename InterpolationPolicy>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+ComputeNeighborhoods(const arma::Col<size_t>& users,
+                     arma::Mat<size_t>& neighborhood,
+                     arma::mat& weights) const
+{
+  if (HasNeighborhoodIndex<NeighborSearchPolicy, InterpolationPolicy>())
+  {
+    neighborhood.set_size(indexNeighborhood.n_rows, users.n_elem);
+    weights.set_size(indexWeights.n_rows, users.n_elem);
+    for (size_t i = 0; i < users.n_elem; ++i)
+    {
+      neighborhood.col(i) = indexNeighborhood.col(users[i]);
+      weights.col(i) = indexWeights.col(users[i]);
+    }
+
+    return;
+  }
+
+  // Resulting similarities.
+  arma::mat similarities;
+  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
+      users, numUsersForSimilarity, neighborhood, similarities);
+
+  // Initialization of an InterpolationPolicy object should be put ahead of the
+  // following loop, because the initialization may takes a relatively long
+  // time and we don't want to repeat the initialization process in each loop.
+  const InterpolationPolicy interpolation(cleanedData);
+
+  // The weights of different users are independent, so solve for them in
+  // parallel.
+  weights.set_size(neighborhood.n_rows, users.n_elem);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) users.n_elem; ++i)
+  {
+    interpolation.GetWeights(weights.col(i), decomposition, users[i],
+        neighborhood.col(i), similarities.col(i), cleanedData);
+  }
+}
+
 template<typename DecompositionPolicy,
          typename NormalizationType>
 void CFType<DecompositionPolicy,
@@ -432,6 +703,10 @@ serialize(Archive& ar, const uint32_t /* version */)
   ar(CEREAL_NVP(decomposition));
   ar(CEREAL_NVP(cleanedData));
   ar(CEREAL_NVP(normalization));
+
+  // The neighborhood index is not saved.
+  if (cereal::is_loading<Archive>())
+    ClearNeighborhoodIndex();
 }
 
 } // namespace cf
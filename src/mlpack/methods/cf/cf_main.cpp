@@ -11,6 +11,7 @@
  */
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/io.hpp>
+#include <chrono>
 
 #ifdef BINDING_NAME
   #undef BINDING_NAME
@@ -22,6 +23,7 @@
 
 #include "cf.hpp"
 #include "cf_model.hpp"
+#include "latency_histogram.hpp"
 
 #include <mlpack/methods/cf/decomposition_policies/batch_svd_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/randomized_svd_method.hpp>
@@ -95,6 +97,8 @@ BINDING_LONG_DESC(
     " - 'SVDCompleteIncremental' -- SVD complete incremental learning\n"
     " - 'BiasSVD' -- Bias SVD using a SGD optimizer\n"
     " - 'SVDPP' -- SVD++ using a SGD optimizer\n"
+    " - 'ALS' -- Weighted-lambda alternating least squares, solved in "
+    "parallel\n"
     "\n\n"
     "The following neighbor search algorithms can be specified via" +
     " the " + PRINT_PARAM_STRING("neighbor_search") + " parameter:"
@@ -120,7 +124,18 @@ BINDING_LONG_DESC(
     " - 'z_score'  -- Z-Score Normalization\n"
     "\n"
     "A trained model may be saved to with the " +
-    PRINT_PARAM_STRING("output_model") + " output parameter.");
+    PRINT_PARAM_STRING("output_model") + " output parameter."
+    "\n\n"
+    "To measure serving performance, a query log may be replayed with the " +
+    PRINT_PARAM_STRING("benchmark_queries") + " parameter, which holds one "
+    "query per column: a user to generate recommendations for, and optionally "
+    "an item whose rating for that user is predicted.  The queries are run one "
+    "at a time, and their throughput and latency quantiles (p50, p99, p999) "
+    "are written as a JSON report to the file given with the " +
+    PRINT_PARAM_STRING("benchmark_report") + " parameter (or printed, if it "
+    "is not given).  If " + PRINT_PARAM_STRING("benchmark_all_policies") +
+    " is specified, every combination of neighbor search and interpolation "
+    "algorithm is benchmarked.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -199,6 +214,15 @@ PARAM_STRING_IN("interpolation", "Algorithm used for weight interpolation.",
 PARAM_STRING_IN("neighbor_search", "Algorithm used for neighbor search.",
     "S", "euclidean");
 
+// Serving benchmark.
+PARAM_UMATRIX_IN("benchmark_queries", "Query log to replay as a serving "
+    "benchmark: each column holds a user, and optionally an item whose rating "
+    "by the user is predicted.", "b");
+PARAM_FLAG("benchmark_all_policies", "Benchmark every neighbor search and "
+    "interpolation algorithm, instead of only the given ones.", "P");
+PARAM_STRING_OUT("benchmark_report", "File to write the JSON report of the "
+    "serving benchmark to.", "B");
+
 void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 {
   if (params.Get<int>("seed") == 0)
@@ -220,7 +244,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
   RequireParamInSet<string>(params, "algorithm", { "NMF", "BatchSVD",
       "SVDIncompleteIncremental", "SVDCompleteIncremental", "RegSVD",
-      "RandSVD", "BiasSVD", "SVDPP" }, true, "unknown algorithm");
+      "RandSVD", "BiasSVD", "SVDPP", "ALS" }, true, "unknown algorithm");
 
   ReportIgnoredParam(params, {{ "iteration_only_termination", true }},
       "min_residue");
@@ -228,6 +252,14 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   RequireParamValue<int>(params, "recommendations",
       [](int x) { return x > 0; }, true, "recommendations must be positive");
 
+  if (!params.Has("benchmark_queries"))
+  {
+    ReportIgnoredParam(params, "benchmark_all_policies", "no benchmark query "
+        "log given");
+    ReportIgnoredParam(params, "benchmark_report", "no benchmark query log "
+        "given");
+  }
+
   // Either load from a model, or train a model.
   CFModel* cf;
   if (params.Has("training"))
@@ -306,6 +338,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
           "when max_iterations is reached");
       cf->DecompositionType() = CFModel::SVD_PLUS_PLUS;
     }
+    else if (algo == "ALS")
+    {
+      cf->DecompositionType() = CFModel::ALS;
+    }
 
     // Perform the factorization and do whatever the user wanted.
     const size_t neighborhood = (size_t) params.Get<int>("neighborhood");
@@ -340,7 +376,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   {
     // Load from a model after validating parameters.
     RequireAtLeastOnePassed(params, { "query", "all_user_recommendations",
-        "test" }, true);
+        "test", "benchmark_queries" }, true);
 
     // Load an input model.
     cf = std::move(params.Get<CFModel*>("input_model"));
@@ -437,5 +473,118 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     Log::Info << "RMSE is " << rmse << "." << endl;
   }
 
+  if (params.Has("benchmark_queries"))
+  {
+    arma::Mat<size_t> queries =
+        std::move(params.Get<arma::Mat<size_t>>("benchmark_queries"));
+    if (queries.n_rows != 1 && queries.n_rows != 2)
+    {
+      Log::Fatal << "Benchmark queries must have one row (users) or two rows "
+          << "(users and items)!" << endl;
+    }
+
+    const size_t numRecs = (size_t) params.Get<int>("recommendations");
+    const char* algorithmNames[] = { "NMF", "BatchSVD", "RandSVD", "RegSVD",
+        "SVDCompleteIncremental", "SVDIncompleteIncremental", "BiasSVD",
+        "SVDPP", "ALS" };
+    const char* nsNames[] = { "cosine", "euclidean", "pearson" };
+    const char* interpolationNames[] = { "average", "regression",
+        "similarity" };
+
+    // Either the given policies, or all of them.
+    std::vector<std::pair<NeighborSearchTypes, InterpolationTypes>> policies;
+    if (params.Has("benchmark_all_policies"))
+    {
+      for (size_t n = 0; n < 3; ++n)
+        for (size_t i = 0; i < 3; ++i)
+          policies.emplace_back((NeighborSearchTypes) n,
+              (InterpolationTypes) i);
+    }
+    else
+    {
+      policies.emplace_back(nsType, interpolationType);
+    }
+
+    std::ostringstream report;
+    report << "{\n  \"algorithm\": \""
+        << algorithmNames[cf->DecompositionType()] << "\",\n"
+        << "  \"queries\": " << queries.n_cols << ",\n"
+        << "  \"recommendations\": " << numRecs << ",\n"
+        << "  \"policies\": [";
+
+    timers.Start("cf_benchmark");
+    for (size_t p = 0; p < policies.size(); ++p)
+    {
+      const NeighborSearchTypes ns = policies[p].first;
+      const InterpolationTypes interpolation = policies[p].second;
+
+      // Replay the log one query at a time, as a server would see it.
+      LatencyHistogram recommendationLatency, predictionLatency;
+      arma::Col<size_t> user(1);
+      arma::Mat<size_t> recommendations, combination(2, 1);
+      arma::vec prediction;
+      for (size_t i = 0; i < queries.n_cols; ++i)
+      {
+        user[0] = queries(0, i);
+        std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+        cf->GetRecommendations(ns, interpolation, numRecs, recommendations,
+            user);
+        recommendationLatency.Add(std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count());
+
+        if (queries.n_rows == 2)
+        {
+          combination(0, 0) = queries(0, i);
+          combination(1, 0) = queries(1, i);
+          start = std::chrono::steady_clock::now();
+          cf->Predict(ns, interpolation, combination, prediction);
+          predictionLatency.Add(std::chrono::duration<double>(
+              std::chrono::steady_clock::now() - start).count());
+        }
+      }
+
+      Log::Info << "Benchmark with " << nsNames[ns] << " search and "
+          << interpolationNames[interpolation] << " interpolation: "
+          << "recommendation latency p50 "
+          << recommendationLatency.Quantile(0.5) * 1e6 << "us, p99 "
+          << recommendationLatency.Quantile(0.99) * 1e6 << "us, p999 "
+          << recommendationLatency.Quantile(0.999) * 1e6 << "us." << endl;
+
+      report << (p > 0 ? "," : "") << "\n    { \"neighbor_search\": \""
+          << nsNames[ns] << "\", \"interpolation\": \""
+          << interpolationNames[interpolation] << "\",\n"
+          << "      \"get_recommendations\": ";
+      recommendationLatency.ToJSON(report);
+      if (queries.n_rows == 2)
+      {
+        report << ",\n      \"predict\": ";
+        predictionLatency.ToJSON(report);
+      }
+      report << " }";
+    }
+    timers.Stop("cf_benchmark");
+    report << "\n  ]\n}\n";
+
+    if (params.Has("benchmark_report"))
+    {
+      const string reportFile = params.Get<string>("benchmark_report");
+      fstream reportStream(reportFile.c_str(), fstream::out);
+      if (!reportStream.is_open())
+      {
+        Log::Warn << "Cannot open file '" << reportFile << "' to save the "
+            << "benchmark report to!" << endl;
+      }
+      else
+      {
+        reportStream << report.str();
+      }
+    }
+    else
+    {
+      Log::Info << report.str();
+    }
+  }
+
   params.Get<CFModel*>("output_model") = cf;
 }
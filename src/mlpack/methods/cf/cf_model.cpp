@@ -166,6 +166,11 @@ void CFModel::Train(const arma::mat& data,
       cf = TrainHelper(SVDPlusPlusPolicy(), normalizationType, data,
           numUsersForSimilarity, rank, maxIterations, minResidue, mit);
       break;
+
+    case ALS:
+      cf = TrainHelper(ALSPolicy(), normalizationType, data,
+          numUsersForSimilarity, rank, maxIterations, minResidue, mit);
+      break;
   }
 }
 
@@ -198,5 +203,19 @@ void CFModel::GetRecommendations(const NeighborSearchTypes nsType,
   cf->GetRecommendations(nsType, interpolationType, numRecs, recommendations);
 }
 
+//! Add ratings without retraining.
+void CFModel::AddRatings(const arma::mat& ratings, const double lambda)
+{
+  cf->AddRatings(ratings, lambda);
+}
+
+//! Factorize the ratings again.
+void CFModel::Refresh(const size_t maxIterations,
+                      const double minResidue,
+                      const bool mit)
+{
+  cf->Refresh(maxIterations, minResidue, mit);
+}
+
 } // namespace cf
 } // namespace mlpack
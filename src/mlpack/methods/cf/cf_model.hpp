@@ -78,6 +78,14 @@ class CFWrapperBase
       const size_t numRecs,
       arma::Mat<size_t>& recommendations,
       const arma::Col<size_t>& users) = 0;
+
+  //! Add ratings without retraining.
+  virtual void AddRatings(const arma::mat& ratings, const double lambda) = 0;
+
+  //! Factorize the ratings again.
+  virtual void Refresh(const size_t maxIterations,
+                       const double minResidue,
+                       const bool mit) = 0;
 };
 
 /**
@@ -144,6 +152,14 @@ class CFWrapper : public CFWrapperBase
       arma::Mat<size_t>& recommendations,
       const arma::Col<size_t>& users);
 
+  //! Add ratings without retraining.
+  virtual void AddRatings(const arma::mat& ratings, const double lambda);
+
+  //! Factorize the ratings again.
+  virtual void Refresh(const size_t maxIterations,
+                       const double minResidue,
+                       const bool mit);
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -171,7 +187,8 @@ class CFModel
     SVD_COMPLETE,
     SVD_INCOMPLETE,
     BIAS_SVD,
-    SVD_PLUS_PLUS
+    SVD_PLUS_PLUS,
+    ALS
   };
 
   enum NormalizationTypes
@@ -267,6 +284,29 @@ class CFModel
                           const size_t numRecs,
                           arma::Mat<size_t>& recommendations);
 
+  /**
+   * Add ratings to the model without retraining it: the factors of the users
+   * with new ratings are solved for against the fixed item factors.  See
+   * CFType::AddRatings().
+   *
+   * @param ratings New ratings; dense matrix (coordinate lists).
+   * @param lambda Regularization parameter of the user solves.
+   */
+  void AddRatings(const arma::mat& ratings, const double lambda = 0.05);
+
+  /**
+   * Factorize all the ratings of the model again, including the ratings added
+   * with AddRatings().  To refresh a model in the background, refresh a copy
+   * of it and then move the copy into place.
+   *
+   * @param maxIterations Maximum number of iterations.
+   * @param minResidue Residue required to terminate.
+   * @param mit Whether to terminate only when maxIterations is reached.
+   */
+  void Refresh(const size_t maxIterations = 1000,
+               const double minResidue = 1e-5,
+               const bool mit = false);
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
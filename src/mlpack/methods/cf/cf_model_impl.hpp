@@ -22,6 +22,7 @@
 #include "neighbor_search_policies/lmetric_search.hpp"
 #include "neighbor_search_policies/pearson_search.hpp"
 
+#include "decomposition_policies/als_method.hpp"
 #include "decomposition_policies/batch_svd_method.hpp"
 #include "decomposition_policies/bias_svd_method.hpp"
 #include "decomposition_policies/nmf_method.hpp"
@@ -206,6 +207,23 @@ void CFWrapper<DecompositionPolicy, NormalizationPolicy>::GetRecommendations(
   }
 }
 
+template<typename DecompositionPolicy, typename NormalizationPolicy>
+void CFWrapper<DecompositionPolicy, NormalizationPolicy>::AddRatings(
+    const arma::mat& ratings,
+    const double lambda)
+{
+  cf.AddRatings(ratings, lambda);
+}
+
+template<typename DecompositionPolicy, typename NormalizationPolicy>
+void CFWrapper<DecompositionPolicy, NormalizationPolicy>::Refresh(
+    const size_t maxIterations,
+    const double minResidue,
+    const bool mit)
+{
+  cf.Refresh(maxIterations, minResidue, mit);
+}
+
 template<typename DecompositionPolicy>
 CFWrapperBase* InitializeModelHelper(
     CFModel::NormalizationTypes normalizationType)
@@ -261,6 +279,9 @@ inline CFWrapperBase* InitializeModel(
 
     case CFModel::SVD_PLUS_PLUS:
       return InitializeModelHelper<SVDPlusPlusPolicy>(normalizationType);
+
+    case CFModel::ALS:
+      return InitializeModelHelper<ALSPolicy>(normalizationType);
   }
 
   // This shouldn't ever happen.
@@ -368,6 +389,10 @@ void CFModel::serialize(Archive& ar, const uint32_t /* version */)
     case SVD_PLUS_PLUS:
       SerializeHelper<SVDPlusPlusPolicy>(ar, cf, normalizationType);
       break;
+
+    case ALS:
+      SerializeHelper<ALSPolicy>(ar, cf, normalizationType);
+      break;
   }
 }
 
@@ -0,0 +1,278 @@
+/**
+ * @file methods/cf/decomposition_policies/als_method.hpp
+ *
+ * Weighted-lambda alternating least squares for use in Collaborative
+ * Filtering, with explicit or implicit feedback.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_ALS_METHOD_HPP
+#define MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_ALS_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "fold_in_factors.hpp"
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * Implementation of the weighted-lambda alternating least squares (ALS)
+ * policy, for use within CFType.  The rating matrix X is factorized as
+ * X = W H by alternately solving the normal equations of every user (with W
+ * fixed) and of every item (with H fixed).  The solves are independent, so
+ * they are done in parallel with OpenMP.  The user solves read the ratings of
+ * each user from the columns of the cleaned (item x user) data, and the item
+ * solves read the ratings of each item from the columns of its transpose, so
+ * both directions have compressed-column access.
+ *
+ * With explicit feedback, only the observed ratings are fit, and the
+ * regularization of each user and item is scaled by its number of ratings
+ * (Zhou et al., 2008).  With implicit feedback, the observed values are
+ * treated as confidences c = 1 + alpha * r that the user prefers the item, and
+ * every unobserved entry is fit to 0 with confidence 1 (Hu, Koren and
+ * Volinsky, 2008); the Gram matrix of the fixed factors is computed once per
+ * half-iteration and shared by all the solves.
+ *
+ * @code
+ * @inproceedings{zhou2008large,
+ *   title={Large-scale parallel collaborative filtering for the Netflix
+ *       prize},
+ *   author={Zhou, Yunhong and Wilkinson, Dennis and Schreiber, Robert and
+ *       Pan, Rong},
+ *   booktitle={International Conference on Algorithmic Applications in
+ *       Management},
+ *   pages={337--348},
+ *   year={2008}
+ * }
+ *
+ * @inproceedings{hu2008collaborative,
+ *   title={Collaborative filtering for implicit feedback datasets},
+ *   author={Hu, Yifan and Koren, Yehuda and Volinsky, Chris},
+ *   booktitle={2008 Eighth IEEE International Conference on Data Mining},
+ *   pages={263--272},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * An example of how to use ALSPolicy in CF is shown below:
+ *
+ * @code
+ * extern arma::mat data; // data is a (user, item, rating) table.
+ * arma::Mat<size_t> recommendations; // Resulting recommendations.
+ *
+ * CFType<ALSPolicy> cf(data);
+ *
+ * // Generate 10 recommendations for all users.
+ * cf.GetRecommendations(10, recommendations);
+ * @endcode
+ */
+class ALSPolicy
+{
+ public:
+  /**
+   * Use weighted-lambda alternating least squares to perform collaborative
+   * filtering.
+   *
+   * @param lambda Regularization parameter.
+   * @param implicit Whether the ratings are implicit feedback (confidences)
+   *     instead of explicit ratings.
+   * @param alpha Scale of the confidence of implicit feedback.
+   */
+  ALSPolicy(const double lambda = 0.05,
+            const bool implicit = false,
+            const double alpha = 40.0) :
+      lambda(lambda),
+      implicit(implicit),
+      alpha(alpha)
+  {
+    /* Nothing to do here */
+  }
+
+  /**
+   * Apply Collaborative Filtering to the provided data set using alternating
+   * least squares.
+   *
+   * @param * (data) Data matrix: dense matrix (coordinate lists)
+   *    or sparse matrix(cleaned).
+   * @param cleanedData item user table in form of sparse matrix.
+   * @param rank Rank parameter for matrix factorization.
+   * @param maxIterations Maximum number of iterations.
+   * @param minResidue Residue required to terminate.
+   * @param mit Whether to terminate only when maxIterations is reached.
+   */
+  void Apply(const arma::mat& /* data */,
+             const arma::sp_mat& cleanedData,
+             const size_t rank,
+             const size_t maxIterations,
+             const double minResidue,
+             const bool mit);
+
+  /**
+   * Return predicted rating given user ID and item ID.
+   *
+   * @param user User ID.
+   * @param item Item ID.
+   */
+  double GetRating(const size_t user, const size_t item) const
+  {
+    double rating = arma::as_scalar(w.row(item) * h.col(user));
+    return rating;
+  }
+
+  /**
+   * Get predicted ratings for a user.
+   *
+   * @param user User ID.
+   * @param rating Resulting rating vector.
+   */
+  void GetRatingOfUser(const size_t user, arma::vec& rating) const
+  {
+    rating = w * h.col(user);
+  }
+
+  /**
+   * Get the latent vectors of the items.  The ratings of a user are the inner
+   * products of these vectors with the vector of the user (see
+   * GetUserVector()), up to a term that depends only on the user, so the
+   * items with the highest ratings can be found with a maximum inner product
+   * search.
+   *
+   * @param itemVectors Matrix to store the vectors of the items in, one per
+   *     column.
+   */
+  void GetItemVectors(arma::mat& itemVectors) const
+  {
+    itemVectors = w.t();
+  }
+
+  /**
+   * Get the latent vector of a user, whose inner products with the vectors of
+   * GetItemVectors() give the ratings of the user.
+   *
+   * @param user User ID.
+   * @param userVector Resulting user vector.
+   */
+  void GetUserVector(const size_t user, arma::vec& userVector) const
+  {
+    userVector = h.col(user);
+  }
+
+  /**
+   * Fold a new or changed user into the model, by solving for the factors of
+   * the user against the fixed item matrix (see FoldInFactors()).  The item
+   * matrix and the other users are not changed.
+   *
+   * @param user User ID; if the user is new, the user matrix grows.
+   * @param cleanedData Item user table in form of sparse matrix.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUser(const size_t user,
+                  const arma::sp_mat& cleanedData,
+                  const double lambda)
+  {
+    if (user >= h.n_cols)
+      h.resize(h.n_rows, user + 1);
+
+    h.col(user) = FoldInFactors(w, cleanedData, user, lambda);
+  }
+
+  /**
+   * Get the neighborhood and corresponding similarities for a set of users.
+   *
+   * @tparam NeighborSearchPolicy The policy to perform neighbor search.
+   *
+   * @param users Users whose neighborhood is to be computed.
+   * @param numUsersForSimilarity The number of neighbors returned for
+   *     each user.
+   * @param neighborhood Neighbors represented by user IDs.
+   * @param similarities Similarity between each user and each of its
+   *     neighbors.
+   */
+  template<typename NeighborSearchPolicy>
+  void GetNeighborhood(const arma::Col<size_t>& users,
+                       const size_t numUsersForSimilarity,
+                       arma::Mat<size_t>& neighborhood,
+                       arma::mat& similarities) const
+  {
+    // Do the nearest neighbor search on H, stretched by the Cholesky factor of
+    // W^T W, as RegSVDPolicy does.
+    arma::mat l = arma::chol(w.t() * w);
+    arma::mat stretchedH = l * h; // Due to the Armadillo API, l is L^T.
+
+    // Temporarily store feature vector of queried users.
+    arma::mat query(stretchedH.n_rows, users.n_elem);
+    // Select feature vectors of queried users.
+    for (size_t i = 0; i < users.n_elem; ++i)
+      query.col(i) = stretchedH.col(users(i));
+
+    NeighborSearchPolicy neighborSearch(stretchedH);
+    neighborSearch.Search(
+        query, numUsersForSimilarity, neighborhood, similarities);
+  }
+
+  //! Get the Item Matrix.
+  const arma::mat& W() const { return w; }
+  //! Get the User Matrix.
+  const arma::mat& H() const { return h; }
+
+  //! Get the regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization parameter.
+  double& Lambda() { return lambda; }
+
+  //! Get whether the ratings are implicit feedback.
+  bool Implicit() const { return implicit; }
+  //! Modify whether the ratings are implicit feedback.
+  bool& Implicit() { return implicit; }
+
+  //! Get the scale of the confidence of implicit feedback.
+  double Alpha() const { return alpha; }
+  //! Modify the scale of the confidence of implicit feedback.
+  double& Alpha() { return alpha; }
+
+  /**
+   * Serialization.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(w));
+    ar(CEREAL_NVP(h));
+  }
+
+ private:
+  /**
+   * Solve the regularized least squares problem of each column of the given
+   * ratings, with the fixed factors held constant, in parallel.
+   *
+   * @param ratings Ratings; each column holds the ratings of the factor to be
+   *     solved, and each row corresponds to a column of the fixed factors.
+   * @param fixed Fixed factors (rank x ratings.n_rows).
+   * @param solved Factors to solve for (rank x ratings.n_cols).
+   */
+  void SolveFactors(const arma::sp_mat& ratings,
+                    const arma::mat& fixed,
+                    arma::mat& solved) const;
+
+  //! Regularization parameter.
+  double lambda;
+  //! Whether the ratings are implicit feedback.
+  bool implicit;
+  //! Scale of the confidence of implicit feedback.
+  double alpha;
+  //! Item matrix.
+  arma::mat w;
+  //! User matrix.
+  arma::mat h;
+};
+
+} // namespace cf
+} // namespace mlpack
+
+// Include implementation.
+#include "als_method_impl.hpp"
+
+#endif
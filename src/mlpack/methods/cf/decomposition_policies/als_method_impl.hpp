@@ -0,0 +1,124 @@
+/**
+ * @file methods/cf/decomposition_policies/als_method_impl.hpp
+ *
+ * Implementation of the weighted-lambda alternating least squares policy for
+ * Collaborative Filtering.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_ALS_METHOD_IMPL_HPP
+#define MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_ALS_METHOD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "als_method.hpp"
+
+namespace mlpack {
+namespace cf {
+
+inline void ALSPolicy::Apply(const arma::mat& /* data */,
+                             const arma::sp_mat& cleanedData,
+                             const size_t rank,
+                             const size_t maxIterations,
+                             const double minResidue,
+                             const bool mit)
+{
+  // The cleaned data holds the ratings of each user in a column; its transpose
+  // holds the ratings of each item in a column.
+  const arma::sp_mat itemRatings = cleanedData.t();
+
+  // The item factors are kept transposed (rank x items) while solving, so that
+  // the factors of each item are contiguous.
+  arma::mat wt(rank, cleanedData.n_rows, arma::fill::randu);
+  wt /= std::sqrt((double) rank);
+  h.zeros(rank, cleanedData.n_cols);
+
+  double lastNorm = 0.0;
+  for (size_t i = 0; i < maxIterations; ++i)
+  {
+    SolveFactors(cleanedData, wt, h);
+    SolveFactors(itemRatings, h, wt);
+
+    // Terminate when the norm of the factors stops changing, as
+    // SimpleResidueTermination does.
+    const double norm = std::sqrt(arma::accu(arma::square(wt)) *
+        arma::accu(arma::square(h)));
+    const double residue = std::abs(norm - lastNorm) / std::max(norm, 1e-50);
+    lastNorm = norm;
+
+    Log::Info << "ALS iteration " << i << ": residue " << residue << "."
+        << std::endl;
+    if (!mit && residue < minResidue)
+      break;
+  }
+
+  w = wt.t();
+}
+
+inline void ALSPolicy::SolveFactors(const arma::sp_mat& ratings,
+                                    const arma::mat& fixed,
+                                    arma::mat& solved) const
+{
+  const size_t rank = fixed.n_rows;
+
+  // With implicit feedback, every unobserved entry contributes to the normal
+  // equations, and the sum of those contributions is the same Gram matrix for
+  // all columns.
+  arma::mat gram;
+  if (implicit)
+    gram = fixed * fixed.t();
+
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t j = 0; j < (omp_size_t) ratings.n_cols; ++j)
+  {
+    arma::sp_mat::const_iterator it = ratings.begin_col(j);
+    arma::sp_mat::const_iterator itEnd = ratings.end_col(j);
+    if (it == itEnd)
+    {
+      // Nothing is known about this column, so its factors are zero.
+      solved.col(j).zeros();
+      continue;
+    }
+
+    arma::mat a;
+    if (implicit)
+      a = gram;
+    else
+      a.zeros(rank, rank);
+    arma::vec b(rank, arma::fill::zeros);
+
+    size_t count = 0;
+    for (; it != itEnd; ++it)
+    {
+      const arma::vec f = fixed.col(it.row());
+      if (implicit)
+      {
+        // Fit a preference of 1 with confidence 1 + alpha * r.
+        const double confidence = 1.0 + alpha * (*it);
+        a += (confidence - 1.0) * f * f.t();
+        b += confidence * f;
+      }
+      else
+      {
+        a += f * f.t();
+        b += (*it) * f;
+      }
+      ++count;
+    }
+
+    // Weighted-lambda regularization: scale by the number of ratings.
+    a.diag() += lambda * count;
+
+    arma::vec x;
+    if (!arma::solve(x, a, b))
+      x.zeros(rank);
+    solved.col(j) = x;
+  }
+}
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/bias_svd/bias_svd.hpp>
+#include "fold_in_factors.hpp"
 
 namespace mlpack {
 namespace cf {
@@ -106,6 +107,61 @@ class BiasSVDPolicy
     rating = w * h.col(user) + p + q(user);
   }
 
+  /**
+   * Get the latent vectors of the items.  The ratings of a user are the inner
+   * products of these vectors with the vector of the user (see
+   * GetUserVector()), up to a term that depends only on the user, so the
+   * items with the highest ratings can be found with a maximum inner product
+   * search.
+   *
+   * @param itemVectors Matrix to store the vectors of the items in, one per
+   *     column.
+   */
+  void GetItemVectors(arma::mat& itemVectors) const
+  {
+    // The last dimension holds the item biases.
+    itemVectors = arma::join_cols(w.t(), p.t());
+  }
+
+  /**
+   * Get the latent vector of a user, whose inner products with the vectors of
+   * GetItemVectors() give the ratings of the user.
+   *
+   * @param user User ID.
+   * @param userVector Resulting user vector.
+   */
+  void GetUserVector(const size_t user, arma::vec& userVector) const
+  {
+    userVector.set_size(h.n_rows + 1);
+    userVector.head(h.n_rows) = h.col(user);
+    userVector[h.n_rows] = 1.0;
+  }
+
+  /**
+   * Fold a new or changed user into the model, by solving for the factors and
+   * the bias of the user against the fixed item matrix and item biases (see
+   * FoldInFactors()).  The items and the other users are not changed.
+   *
+   * @param user User ID; if the user is new, the user matrix grows.
+   * @param cleanedData Item user table in form of sparse matrix.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUser(const size_t user,
+                  const arma::sp_mat& cleanedData,
+                  const double lambda)
+  {
+    if (user >= h.n_cols)
+    {
+      h.resize(h.n_rows, user + 1);
+      q.resize(user + 1);
+    }
+
+    const arma::vec factors = FoldInFactors(w, cleanedData, user, lambda, true,
+        [&](const size_t item) { return p(item); });
+    h.col(user) = factors.head(h.n_rows);
+    q(user) = factors(h.n_rows);
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
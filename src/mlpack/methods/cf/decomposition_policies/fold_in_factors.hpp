@@ -0,0 +1,107 @@
+/**
+ * @file methods/cf/decomposition_policies/fold_in_factors.hpp
+ *
+ * Solve for the factors of a single user against fixed item factors, so that
+ * new users and new ratings can be folded into a trained model without
+ * retraining it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_FOLD_IN_FACTORS_HPP
+#define MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_FOLD_IN_FACTORS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * Solve the regularized least squares problem of the ratings of one user, with
+ * the item factors held fixed:
+ *
+ *   min_x sum_i (r_ui - offset(i) - [w_i; 1]^T x)^2 + lambda n_u ||x||^2,
+ *
+ * where the sum runs over the n_u items the user rated, and the constant 1 is
+ * only appended to the item factors w_i when bias is true (so that the last
+ * element of x is the bias of the user).  This is one half-step of
+ * weighted-lambda alternating least squares, and costs O(n_u r^2 + r^3) for
+ * rank r, independently of the number of users and items.
+ *
+ * If the user has no ratings, its factors are zero.
+ *
+ * @param w Item matrix, with the factors of each item in a row.
+ * @param cleanedData Item user table in form of sparse matrix.
+ * @param user User ID.
+ * @param lambda Regularization parameter.
+ * @param bias Whether to solve for a bias of the user as well.
+ * @param offset Function of the item ID giving the part of each rating that
+ *     is not explained by the factors (for instance, the item bias).
+ * @return The factors of the user (and its bias, if bias is true).
+ */
+template<typename OffsetType>
+inline arma::vec FoldInFactors(const arma::mat& w,
+                               const arma::sp_mat& cleanedData,
+                               const size_t user,
+                               const double lambda,
+                               const bool bias,
+                               const OffsetType& offset)
+{
+  const size_t rank = w.n_cols + (bias ? 1 : 0);
+  arma::mat a(rank, rank, arma::fill::zeros);
+  arma::vec b(rank, arma::fill::zeros);
+  arma::vec f(rank);
+  if (bias)
+    f(rank - 1) = 1.0;
+
+  size_t count = 0;
+  if (user < cleanedData.n_cols)
+  {
+    arma::sp_mat::const_iterator it = cleanedData.begin_col(user);
+    arma::sp_mat::const_iterator itEnd = cleanedData.end_col(user);
+    for (; it != itEnd; ++it)
+    {
+      f.head(w.n_cols) = w.row(it.row()).t();
+      a += f * f.t();
+      b += ((*it) - offset(it.row())) * f;
+      ++count;
+    }
+  }
+
+  arma::vec x(rank, arma::fill::zeros);
+  if (count == 0)
+    return x;
+
+  // Weighted-lambda regularization: scale by the number of ratings.
+  a.diag() += lambda * count;
+  if (!arma::solve(x, a, b))
+    x.zeros(rank);
+
+  return x;
+}
+
+/**
+ * Solve the regularized least squares problem of the ratings of one user, with
+ * the item factors held fixed and no offsets or bias.
+ *
+ * @param w Item matrix, with the factors of each item in a row.
+ * @param cleanedData Item user table in form of sparse matrix.
+ * @param user User ID.
+ * @param lambda Regularization parameter.
+ * @return The factors of the user.
+ */
+inline arma::vec FoldInFactors(const arma::mat& w,
+                               const arma::sp_mat& cleanedData,
+                               const size_t user,
+                               const double lambda)
+{
+  return FoldInFactors(w, cleanedData, user, lambda, false,
+      [](const size_t /* item */) { return 0.0; });
+}
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/regularized_svd/regularized_svd.hpp>
+#include "fold_in_factors.hpp"
 
 namespace mlpack {
 namespace cf {
@@ -100,6 +101,52 @@ class RegSVDPolicy
     rating = w * h.col(user);
   }
 
+  /**
+   * Get the latent vectors of the items.  The ratings of a user are the inner
+   * products of these vectors with the vector of the user (see
+   * GetUserVector()), up to a term that depends only on the user, so the
+   * items with the highest ratings can be found with a maximum inner product
+   * search.
+   *
+   * @param itemVectors Matrix to store the vectors of the items in, one per
+   *     column.
+   */
+  void GetItemVectors(arma::mat& itemVectors) const
+  {
+    itemVectors = w.t();
+  }
+
+  /**
+   * Get the latent vector of a user, whose inner products with the vectors of
+   * GetItemVectors() give the ratings of the user.
+   *
+   * @param user User ID.
+   * @param userVector Resulting user vector.
+   */
+  void GetUserVector(const size_t user, arma::vec& userVector) const
+  {
+    userVector = h.col(user);
+  }
+
+  /**
+   * Fold a new or changed user into the model, by solving for the factors of
+   * the user against the fixed item matrix (see FoldInFactors()).  The item
+   * matrix and the other users are not changed.
+   *
+   * @param user User ID; if the user is new, the user matrix grows.
+   * @param cleanedData Item user table in form of sparse matrix.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUser(const size_t user,
+                  const arma::sp_mat& cleanedData,
+                  const double lambda)
+  {
+    if (user >= h.n_cols)
+      h.resize(h.n_rows, user + 1);
+
+    h.col(user) = FoldInFactors(w, cleanedData, user, lambda);
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/svdplusplus/svdplusplus.hpp>
+#include "fold_in_factors.hpp"
 
 namespace mlpack {
 namespace cf {
@@ -141,6 +142,97 @@ class SVDPlusPlusPolicy
     rating = w * userVec + p + q(user);
   }
 
+  /**
+   * Get the latent vectors of the items.  The ratings of a user are the inner
+   * products of these vectors with the vector of the user (see
+   * GetUserVector()), up to a term that depends only on the user, so the
+   * items with the highest ratings can be found with a maximum inner product
+   * search.
+   *
+   * @param itemVectors Matrix to store the vectors of the items in, one per
+   *     column.
+   */
+  void GetItemVectors(arma::mat& itemVectors) const
+  {
+    // The last dimension holds the item biases.
+    itemVectors = arma::join_cols(w.t(), p.t());
+  }
+
+  /**
+   * Get the latent vector of a user, whose inner products with the vectors of
+   * GetItemVectors() give the ratings of the user.
+   *
+   * @param user User ID.
+   * @param userVector Resulting user vector.
+   */
+  void GetUserVector(const size_t user, arma::vec& userVector) const
+  {
+    // Iterate through each item which the user interacted with to calculate
+    // user vector.
+    arma::vec userVec(h.n_rows, arma::fill::zeros);
+    arma::sp_mat::const_iterator it = implicitData.begin_col(user);
+    arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
+    size_t implicitCount = 0;
+    for (; it != it_end; ++it)
+    {
+      userVec += y.col(it.row());
+      implicitCount += 1;
+    }
+    if (implicitCount != 0)
+      userVec /= std::sqrt(implicitCount);
+    userVec += h.col(user);
+
+    userVector.set_size(h.n_rows + 1);
+    userVector.head(h.n_rows) = userVec;
+    userVector[h.n_rows] = 1.0;
+  }
+
+  /**
+   * Fold a new or changed user into the model.  The implicit feedback of the
+   * user becomes the set of items it rated in the cleaned data, and the
+   * explicit factors and the bias of the user are solved for against the fixed
+   * item matrix, item biases and implicit item factors (see FoldInFactors()).
+   * The items and the other users are not changed.
+   *
+   * @param user User ID; if the user is new, the user matrix grows.
+   * @param cleanedData Item user table in form of sparse matrix.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUser(const size_t user,
+                  const arma::sp_mat& cleanedData,
+                  const double lambda)
+  {
+    if (user >= h.n_cols)
+    {
+      h.resize(h.n_rows, user + 1);
+      q.resize(user + 1);
+      implicitData.resize(implicitData.n_rows, user + 1);
+    }
+
+    // Update the implicit feedback of the user, and compute its implicit
+    // vector.
+    arma::vec implicitVec(h.n_rows, arma::fill::zeros);
+    size_t implicitCount = 0;
+    arma::sp_mat::const_iterator it = cleanedData.begin_col(user);
+    arma::sp_mat::const_iterator it_end = cleanedData.end_col(user);
+    for (; it != it_end; ++it)
+    {
+      implicitData(it.row(), user) = 1;
+      implicitVec += y.col(it.row());
+      implicitCount += 1;
+    }
+    if (implicitCount != 0)
+      implicitVec /= std::sqrt(implicitCount);
+
+    const arma::vec factors = FoldInFactors(w, cleanedData, user, lambda, true,
+        [&](const size_t item)
+        {
+          return p(item) + arma::dot(w.row(item), implicitVec);
+        });
+    h.col(user) = factors.head(h.n_rows);
+    q(user) = factors(h.n_rows);
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -67,7 +67,7 @@ class AverageInterpolation
                   const size_t /* queryUser */,
                   const arma::Col<size_t>& neighbors,
                   const arma::vec& /* similarities */,
-                  const arma::sp_mat& /* cleanedData */)
+                  const arma::sp_mat& /* cleanedData */) const
   {
     if (neighbors.n_elem == 0)
     {
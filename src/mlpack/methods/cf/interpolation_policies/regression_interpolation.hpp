@@ -62,16 +62,13 @@ class RegressionInterpolation
   RegressionInterpolation() { }
 
   /**
-   * Use cleanedData to perform necessary preprocessing.
+   * Nothing needs to be precomputed; the coefficients of each query user are
+   * computed from the predicted ratings of its neighbors, so GetWeights() may
+   * be called for different users in parallel.
    *
-   * @param cleanedData Sparse rating matrix.
+   * @param * (cleanedData) Sparse rating matrix.
    */
-  RegressionInterpolation(const arma::sp_mat& cleanedData)
-  {
-    const size_t userNum = cleanedData.n_cols;
-    a.set_size(userNum, userNum);
-    b.set_size(userNum, userNum);
-  }
+  RegressionInterpolation(const arma::sp_mat& /* cleanedData */) { }
 
   /**
    * The regression-based interpolation problem can be solved by a linear
@@ -97,7 +94,7 @@ class RegressionInterpolation
                   const size_t queryUser,
                   const arma::Col<size_t>& neighbors,
                   const arma::vec& /* similarities*/,
-                  const arma::sp_mat& cleanedData)
+                  const arma::sp_mat& cleanedData) const
   {
     if (weights.n_elem != neighbors.n_elem)
     {
@@ -110,14 +107,7 @@ class RegressionInterpolation
     const arma::mat& h = decomposition.H();
     const size_t itemNum = cleanedData.n_rows;
     const size_t neighborNum = neighbors.size();
-
-    // Coeffcients of the linear equations used to compute weights.
-    arma::mat coeff(neighborNum, neighborNum);
-    // Constant terms of the linear equations used to compute weights.
-    arma::vec constant(neighborNum);
-
-    arma::vec userRating(cleanedData.col(queryUser));
-    const size_t support = arma::accu(userRating != 0);
+    const size_t support = cleanedData.col(queryUser).n_nonzero;
 
     // If user has no rating at all, average interpolation is used.
     if (support == 0)
@@ -126,60 +116,25 @@ class RegressionInterpolation
       return;
     }
 
+    // Predicted ratings of each neighbor for all items.
+    arma::mat neighborRatings(itemNum, neighborNum);
     for (size_t i = 0; i < neighborNum; ++i)
-    {
-      // Calculate coefficient.
-      arma::vec iPrediction;
-      for (size_t j = i; j < neighborNum; ++j)
-      {
-        if (a(neighbors(i), neighbors(j)) != 0)
-        {
-          // The coefficient has already been cached.
-          coeff(i, j) = a(neighbors(i), neighbors(j));
-          coeff(j, i) = coeff(i, j);
-        }
-        else
-        {
-          // Calculate the coefficient.
-          if (iPrediction.size() == 0)
-            // Avoid recalculation of iPrediction.
-            iPrediction = w * h.col(neighbors(i));
-          arma::vec jPrediction = w * h.col(neighbors(j));
-          coeff(i, j) = arma::dot(iPrediction, jPrediction) / itemNum;
-          if (coeff(i, j) == 0)
-            coeff(i, j) = std::numeric_limits<double>::min();
-          coeff(j, i) = coeff(i, j);
-          // Cache calcualted coefficient.
-          a(neighbors(i), neighbors(j)) = coeff(i, j);
-          a(neighbors(j), neighbors(i)) = coeff(i, j);
-        }
-      }
+      neighborRatings.col(i) = w * h.col(neighbors(i));
+
+    // Coefficients of the linear equations used to compute weights.
+    const arma::mat coeff = neighborRatings.t() * neighborRatings / itemNum;
+
+    // Constant terms of the linear equations used to compute weights; only the
+    // items rated by the query user contribute.
+    arma::vec constant(neighborNum, arma::fill::zeros);
+    arma::sp_mat::const_iterator it = cleanedData.begin_col(queryUser);
+    arma::sp_mat::const_iterator itEnd = cleanedData.end_col(queryUser);
+    for (; it != itEnd; ++it)
+      constant += (*it) * neighborRatings.row(it.row()).t();
+    constant /= support;
 
-      // Calculate constant terms.
-      if (b(neighbors(i), queryUser) != 0)
-        // The constant term has already been cached.
-        constant(i) = b(neighbors(i), queryUser);
-      else
-      {
-        // Calcuate the constant term.
-        if (iPrediction.size() == 0)
-            // Avoid recalculation of iPrediction.
-            iPrediction = w * h.col(neighbors(i));
-        constant(i) = arma::dot(iPrediction, userRating) / support;
-        if (constant(i) == 0)
-          constant(i) = std::numeric_limits<double>::min();
-        // Cache calculated constant term.
-        b(neighbors(i), queryUser) = constant(i);
-      }
-    }
     weights = arma::solve(coeff, constant);
   }
-
- private:
-  //! Cached coefficients used in linear equations to compute weights.
-  arma::sp_mat a;
-  //! Cached constant terms used in linear equations to compute weights.
-  arma::sp_mat b;
 };
 
 } // namespace cf
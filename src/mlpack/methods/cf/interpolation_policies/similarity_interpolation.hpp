@@ -69,7 +69,7 @@ class SimilarityInterpolation
                   const size_t /* queryUser */,
                   const arma::Col<size_t>& neighbors,
                   const arma::vec& similarities,
-                  const arma::sp_mat& /* cleanedData */)
+                  const arma::sp_mat& /* cleanedData */) const
   {
     if (similarities.n_elem == 0)
     {
@@ -0,0 +1,121 @@
+/**
+ * @file methods/cf/latency_histogram.hpp
+ *
+ * A record of the latencies of a sequence of queries, used by the serving
+ * benchmark of the cf binding.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_LATENCY_HISTOGRAM_HPP
+#define MLPACK_METHODS_CF_LATENCY_HISTOGRAM_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * The latencies of a sequence of queries.  Every latency is kept, so that the
+ * quantiles are exact, and they are also counted in a histogram of
+ * power-of-two buckets of microseconds: bucket b holds the latencies in
+ * [2^b, 2^(b + 1)) microseconds (bucket 0 also holds those below 1
+ * microsecond).
+ */
+class LatencyHistogram
+{
+ public:
+  //! Create an empty histogram.
+  LatencyHistogram() : sorted(true), total(0.0) { }
+
+  /**
+   * Record the latency of a query.
+   *
+   * @param seconds Latency of the query, in seconds.
+   */
+  void Add(const double seconds)
+  {
+    samples.push_back(seconds);
+    sorted = false;
+    total += seconds;
+
+    const double microseconds = seconds * 1e6;
+    const size_t bucket = (microseconds < 1.0) ? 0 :
+        (size_t) std::floor(std::log2(microseconds));
+    if (bucket >= buckets.size())
+      buckets.resize(bucket + 1, 0);
+    ++buckets[bucket];
+  }
+
+  //! Get the number of recorded queries.
+  size_t Count() const { return samples.size(); }
+  //! Get the sum of the recorded latencies, in seconds.
+  double Total() const { return total; }
+  //! Get the mean latency, in seconds.
+  double Mean() const { return samples.empty() ? 0.0 : total / Count(); }
+
+  /**
+   * Get the given quantile of the latencies, in seconds (the smallest latency
+   * such that a fraction q of the queries were at least as fast).
+   *
+   * @param q Quantile to compute, in [0, 1].
+   */
+  double Quantile(const double q) const
+  {
+    if (samples.empty())
+      return 0.0;
+
+    if (!sorted)
+    {
+      std::sort(samples.begin(), samples.end());
+      sorted = true;
+    }
+
+    const double rank = std::ceil(q * samples.size());
+    const size_t index = (rank < 1.0) ? 0 :
+        std::min((size_t) rank - 1, samples.size() - 1);
+    return samples[index];
+  }
+
+  //! Get the number of latencies in each power-of-two bucket of microseconds.
+  const std::vector<size_t>& Buckets() const { return buckets; }
+
+  /**
+   * Write the statistics of the latencies as a JSON object, with times in
+   * microseconds.
+   *
+   * @param stream Stream to write to.
+   */
+  void ToJSON(std::ostream& stream) const
+  {
+    stream << "{ \"queries\": " << Count()
+        << ", \"seconds\": " << Total()
+        << ", \"throughput\": " << (Total() > 0.0 ? Count() / Total() : 0.0)
+        << ", \"mean_us\": " << Mean() * 1e6
+        << ", \"p50_us\": " << Quantile(0.5) * 1e6
+        << ", \"p99_us\": " << Quantile(0.99) * 1e6
+        << ", \"p999_us\": " << Quantile(0.999) * 1e6
+        << ", \"max_us\": " << Quantile(1.0) * 1e6
+        << ", \"histogram_log2_us\": [";
+    for (size_t b = 0; b < buckets.size(); ++b)
+      stream << (b > 0 ? ", " : "") << buckets[b];
+    stream << "] }";
+  }
+
+ private:
+  //! The recorded latencies, in seconds (sorted lazily by Quantile()).
+  mutable std::vector<double> samples;
+  //! Whether the latencies are sorted.
+  mutable bool sorted;
+  //! The number of latencies in each bucket.
+  std::vector<size_t> buckets;
+  //! The sum of the recorded latencies.
+  double total;
+};
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
@@ -60,6 +60,17 @@ class CombinedNormalization
     SequenceNormalize<0>(data);
   }
 
+  /**
+   * Normalize ratings added after training by calling NormalizeNewRatings() in
+   * each normalization object.
+   *
+   * @param data New ratings in the form of coordinate list.
+   */
+  void NormalizeNewRatings(arma::mat& data)
+  {
+    SequenceNormalizeNewRatings<0>(data);
+  }
+
   /**
    * Denormalize rating by calling Denormalize() in each normalization object.
    * Note that the order of objects calling Denormalize() should be the
@@ -130,6 +141,23 @@ class CombinedNormalization
       typename = void>
   void SequenceNormalize(MatType& /* data */) { }
 
+  //! Unpack normalizations tuple to normalize new ratings.
+  template<
+      int I, /* Which normalization in tuple to use */
+      typename = std::enable_if_t<(I < std::tuple_size<TupleType>::value)>>
+  void SequenceNormalizeNewRatings(arma::mat& data)
+  {
+    std::get<I>(normalizations).NormalizeNewRatings(data);
+    SequenceNormalizeNewRatings<I + 1>(data);
+  }
+
+  //! End of tuple unpacking.
+  template<
+      int I, /* Which normalization in tuple to use */
+      typename = std::enable_if_t<(I >= std::tuple_size<TupleType>::value)>,
+      typename = void>
+  void SequenceNormalizeNewRatings(arma::mat& /* data */) { }
+
   //! Unpack normalizations tuple to denormalize.
   template<
       int I, /* Which normalization in tuple to use */
@@ -120,6 +120,27 @@ class ItemMeanNormalization
     }
   }
 
+  /**
+   * Normalize ratings added after training by subtracting the item means of
+   * the ratings the model was trained on.  Items without a mean are left as
+   * they are.
+   *
+   * @param data New ratings in the form of coordinate list.
+   */
+  void NormalizeNewRatings(arma::mat& data) const
+  {
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t item = (size_t) datapoint(1);
+      if (item < itemMean.n_elem)
+        datapoint(2) -= itemMean(item);
+      // The algorithm omits rating of zero. If normalized rating equals zero,
+      // it is set to the smallest positive float value.
+      if (datapoint(2) == 0)
+        datapoint(2) = std::numeric_limits<float>::min();
+    });
+  }
+
   /**
    * Denormalize computed rating by adding item mean.
    *
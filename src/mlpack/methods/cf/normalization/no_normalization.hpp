@@ -36,6 +36,13 @@ class NoNormalization
   template<typename MatType>
   inline void Normalize(const MatType& /* data */) const { }
 
+  /**
+   * Do nothing.
+   *
+   * @param * (data) New ratings in the form of coordinate list.
+   */
+  inline void NormalizeNewRatings(const arma::mat& /* data */) const { }
+
   /**
    * Do nothing.
    *
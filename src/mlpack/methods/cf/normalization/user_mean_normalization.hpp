@@ -120,6 +120,51 @@ class UserMeanNormalization
     }
   }
 
+  /**
+   * Normalize ratings added after training by subtracting the user means of
+   * the ratings the model was trained on.  The mean of a user that is not
+   * known yet is the mean of its new ratings.
+   *
+   * @param data New ratings in the form of coordinate list.
+   */
+  void NormalizeNewRatings(arma::mat& data)
+  {
+    const size_t oldUserNum = userMean.n_elem;
+    const size_t userNum = std::max(oldUserNum,
+        (size_t) arma::max(data.row(0)) + 1);
+    if (userNum > oldUserNum)
+    {
+      userMean.resize(userNum);
+      userMean.tail(userNum - oldUserNum).zeros();
+      arma::Row<size_t> ratingNum(userNum - oldUserNum, arma::fill::zeros);
+      data.each_col([&](arma::vec& datapoint)
+      {
+        const size_t user = (size_t) datapoint(0);
+        if (user >= oldUserNum)
+        {
+          userMean(user) += datapoint(2);
+          ratingNum(user - oldUserNum) += 1;
+        }
+      });
+
+      for (size_t i = 0; i < ratingNum.n_elem; ++i)
+      {
+        if (ratingNum(i) != 0)
+          userMean(oldUserNum + i) /= ratingNum(i);
+      }
+    }
+
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t user = (size_t) datapoint(0);
+      datapoint(2) -= userMean(user);
+      // The algorithm omits rating of zero. If normalized rating equals zero,
+      // it is set to the smallest positive double value.
+      if (datapoint(2) == 0)
+        datapoint(2) = std::numeric_limits<double>::min();
+    });
+  }
+
   /**
    * Denormalize computed rating by adding user mean.
    *
@@ -105,6 +105,24 @@ class ZScoreNormalization
     }
   }
 
+  /**
+   * Normalize ratings added after training with the mean and standard
+   * deviation of the ratings the model was trained on.
+   *
+   * @param data New ratings in the form of coordinate list.
+   */
+  void NormalizeNewRatings(arma::mat& data) const
+  {
+    data.row(2) = (data.row(2) - mean) / stddev;
+    // The algorithm omits rating of zero. If normalized rating equals zero,
+    // it is set to the smallest positive float value.
+    data.row(2).for_each([](double& x)
+    {
+      if (x == 0)
+        x = std::numeric_limits<float>::min();
+    });
+  }
+
   /**
    * Denormalize computed rating by adding mean and multiplying stddev.
    *
@@ -16,6 +16,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
 #include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 #include "random_point_selection.hpp"
 #include "ordered_point_selection.hpp"
 
@@ -43,9 +44,12 @@ namespace dbscan {
  * range search technique used and the point selection strategy by means of
  * template parameters.
  *
- * @tparam RangeSearchType Class to use for range searching.
+ * @tparam RangeSearchType Class to use for range searching.  In batch mode it
+ *      must provide the Stream() method of RangeSearch; in pointwise mode only
+ *      Train() and Search() are used.
  * @tparam PointSelectionPolicy Strategy for selecting next point to cluster
- *      with.
+ *      with.  Clusters are numbered in the order in which their first point is
+ *      selected.
  */
 template<typename RangeSearchType = range::RangeSearch<>,
          typename PointSelectionPolicy = OrderedPointSelection>
@@ -59,6 +63,13 @@ class DBSCAN
    * When batchMode is false, each point will be searched iteratively, which
    * could be slower but will use less memory.
    *
+   * In batch mode, the results of the range search are merged as soon as they
+   * are found, so RangeSearchType must provide the Stream() method of
+   * RangeSearch; with naive or single-tree range search, points are searched
+   * in parallel if OpenMP is available.  Both modes give the same clusters,
+   * which are numbered in the order in which the point selection policy
+   * selects their first point.
+   *
    * @param epsilon Size of range query.
    * @param minPoints Minimum number of points for each cluster.
    * @param batchMode If true, all points are searched in batch.
@@ -128,32 +139,48 @@ class DBSCAN
   //! Instantiated point selection policy.
   PointSelectionPolicy pointSelector;
 
+  //! Union each range search result with its query point.
+  struct UnionCallback
+  {
+    UnionCallback(emst::ConcurrentUnionFind& uf) : uf(uf) { }
+
+    void operator()(const size_t queryIndex,
+                    const size_t referenceIndex,
+                    const double /* distance */)
+    {
+      uf.Union(queryIndex, referenceIndex);
+    }
+
+    emst::ConcurrentUnionFind& uf;
+  };
+
   /**
    * Performs DBSCAN clustering on the data, returning the number of clusters and
-   * also the list of cluster assignments.  This searches each point iteratively,
-   * and can save on RAM usage.  It may be slower than the batch search with a
-   * dual-tree algorithm.
+   * also the list of cluster assignments.  This searches each point iteratively
+   * (in the order given by the point selection policy), and can save on RAM
+   * usage.  It may be slower than the batch search with a dual-tree algorithm.
    *
    * @param data Dataset to cluster.
-   * @param assignments Assignments for each point.
+   * @param order Order in which the points are searched.
    * @param uf UnionFind structure that will be modified.
    */
   template<typename MatType>
   void PointwiseCluster(const MatType& data,
+                        const std::vector<size_t>& order,
                         emst::UnionFind& uf);
 
   /**
    * Performs DBSCAN clustering on the data, returning number of clusters
    * and also the list of cluster assignments.  This can perform search in batch,
-   * so it is well suited for dual-tree or naive search.
+   * so it is well suited for dual-tree or naive search.  The range search may
+   * call Union() from several threads.
    *
    * @param data Dataset to cluster.
-   * @param assignments Assignments for each point.
-   * @param uf UnionFind structure that will be modified.
+   * @param uf ConcurrentUnionFind structure that will be modified.
    */
   template<typename MatType>
   void BatchCluster(const MatType& data,
-                    emst::UnionFind& uf);
+                    emst::ConcurrentUnionFind& uf);
 };
 
 } // namespace dbscan
@@ -100,35 +100,48 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
     const MatType& data,
     arma::Row<size_t>& assignments)
 {
-  // Initialize the UnionFind object.
-  emst::UnionFind uf(data.n_cols);
   rangeSearch.Train(data);
 
+  // Get the order in which the points are visited.
+  std::vector<size_t> order(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    order[i] = pointSelector.Select(i, data);
+
+  // Set each assignment to the component of the point.
+  assignments.set_size(data.n_cols);
   if (batchMode)
+  {
+    // The range search may find neighbors in parallel, so the components are
+    // merged with a concurrent union-find structure.
+    emst::ConcurrentUnionFind uf(data.n_cols);
     BatchCluster(data, uf);
+    for (size_t i = 0; i < data.n_cols; ++i)
+      assignments[i] = uf.Find(i);
+  }
   else
-    PointwiseCluster(data, uf);
-
-  // Now set assignments.
-  assignments.set_size(data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-    assignments[i] = uf.Find(i);
+  {
+    emst::UnionFind uf(data.n_cols);
+    PointwiseCluster(data, order, uf);
+    for (size_t i = 0; i < data.n_cols; ++i)
+      assignments[i] = uf.Find(i);
+  }
 
   // Get a count of all clusters.
-  const size_t numClusters = arma::max(assignments) + 1;
-  arma::Col<size_t> counts(numClusters, arma::fill::zeros);
+  arma::Col<size_t> counts(data.n_cols, arma::fill::zeros);
   for (size_t i = 0; i < assignments.n_elem; ++i)
     counts[assignments[i]]++;
 
-  // Now assign clusters to new indices.
+  // Now assign clusters to new indices, in the order in which the first point
+  // of each cluster is visited, so that the result does not depend on which
+  // point of a cluster is its component.
   size_t currentCluster = 0;
-  arma::Col<size_t> newAssignments(numClusters);
-  for (size_t i = 0; i < counts.n_elem; ++i)
+  arma::Col<size_t> newAssignments(data.n_cols);
+  newAssignments.fill(SIZE_MAX);
+  for (size_t i = 0; i < order.size(); ++i)
   {
-    if (counts[i] >= minPoints)
-      newAssignments[i] = currentCluster++;
-    else
-      newAssignments[i] = SIZE_MAX;
+    const size_t component = assignments[order[i]];
+    if (counts[component] >= minPoints && newAssignments[component] == SIZE_MAX)
+      newAssignments[component] = currentCluster++;
   }
 
   // Now reassign.
@@ -143,13 +156,14 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
 /**
  * Performs DBSCAN clustering on the data, returning the number of clusters and
  * also the list of cluster assignments.  This searches each point iteratively,
- * and can save on RAM usage.  It may be slower than the batch search with a
- * dual-tree algorithm.
+ * in the given order, and can save on RAM usage.  It may be slower than the
+ * batch search with a dual-tree algorithm.
  */
 template<typename RangeSearchType, typename PointSelectionPolicy>
 template<typename MatType>
 void DBSCAN<RangeSearchType, PointSelectionPolicy>::PointwiseCluster(
     const MatType& data,
+    const std::vector<size_t>& order,
     emst::UnionFind& uf)
 {
   std::vector<std::vector<size_t>> neighbors;
@@ -160,43 +174,37 @@ void DBSCAN<RangeSearchType, PointSelectionPolicy>::PointwiseCluster(
     if (i % 10000 == 0 && i > 0)
       Log::Info << "DBSCAN clustering on point " << i << "..." << std::endl;
 
+    // Get the next index.
+    const size_t index = order[i];
+
     // Do the range search for only this point.
-    rangeSearch.Search(data.col(i), math::Range(0.0, epsilon), neighbors,
+    rangeSearch.Search(data.col(index), math::Range(0.0, epsilon), neighbors,
         distances);
 
     // Union to all neighbors.
     for (size_t j = 0; j < neighbors[0].size(); ++j)
-      uf.Union(i, neighbors[0][j]);
+      uf.Union(index, neighbors[0][j]);
   }
 }
 
 /**
  * Performs DBSCAN clustering on the data, returning number of clusters
- * and also the list of cluster assignments.  This can perform search in batch,
- * naive search).
+ * and also the list of cluster assignments.  This performs the search in
+ * batch, so it is well suited for dual-tree or naive search.  The neighbors
+ * are merged as soon as they are found, so they are never stored.
  */
 template<typename RangeSearchType, typename PointSelectionPolicy>
 template<typename MatType>
 void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
     const MatType& data,
-    emst::UnionFind& uf)
+    emst::ConcurrentUnionFind& uf)
 {
-  // For each point, find the points in epsilon-nighborhood and their distances.
-  std::vector<std::vector<size_t>> neighbors;
-  std::vector<std::vector<double>> distances;
+  // For each point, find the points in epsilon-neighborhood and union them
+  // with the point.
   Log::Info << "Performing range search." << std::endl;
-  rangeSearch.Train(data);
-  rangeSearch.Search(data, math::Range(0.0, epsilon), neighbors, distances);
+  UnionCallback callback(uf);
+  rangeSearch.Stream(math::Range(0.0, epsilon), callback);
   Log::Info << "Range search complete." << std::endl;
-
-  // Now loop over all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
-  {
-    // Get the next index.
-    const size_t index = pointSelector.Select(i, data);
-    for (size_t j = 0; j < neighbors[index].size(); ++j)
-      uf.Union(index, neighbors[index][j]);
-  }
 }
 
 } // namespace dbscan
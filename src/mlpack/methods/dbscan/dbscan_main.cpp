@@ -69,7 +69,9 @@ BINDING_LONG_DESC(
     " 'hilbert-r', 'r-plus', 'r-plus-plus', 'cover', 'ball'. The " +
     PRINT_PARAM_STRING("single_mode") + " parameter will force single-tree "
     "search (as opposed to the default dual-tree search), and '" +
-    PRINT_PARAM_STRING("naive") + " will force brute-force range search.");
+    PRINT_PARAM_STRING("naive") + " will force brute-force range search.  "
+    "Single-tree and brute-force search are performed in parallel if OpenMP "
+    "is available.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -98,8 +100,9 @@ PARAM_INT_IN("min_size", "Minimum number of points for a cluster.", "m", 5);
 PARAM_STRING_IN("tree_type", "If using single-tree or dual-tree search, the "
     "type of tree to use ('kd', 'r', 'r-star', 'x', 'hilbert-r', 'r-plus', "
     "'r-plus-plus', 'cover', 'ball').", "t", "kd");
-PARAM_STRING_IN("selection_type", "If using point selection policy, the "
-    "type of selection to use ('ordered', 'random').", "s", "ordered");
+PARAM_STRING_IN("selection_type", "Order in which the points are visited; "
+    "clusters are numbered in the order of their first visited point "
+    "('ordered', 'random').", "s", "ordered");
 PARAM_FLAG("single_mode", "If set, single-tree range search (not dual-tree) "
     "will be used.", "S");
 PARAM_FLAG("naive", "If set, brute-force range search (not tree-based) "
@@ -120,8 +123,11 @@ void RunDBSCAN(util::Params& params,
   const size_t minSize = (size_t) params.Get<int>("min_size");
   arma::Row<size_t> assignments;
 
+  // Batch mode does not store the range search results, so it is always used;
+  // with single-tree search it is also parallel.  The point selection policy
+  // sets the order in which the clusters are numbered.
   DBSCAN<RangeSearchType, PointSelectionPolicy> d(epsilon, minSize,
-      !params.Has("single_mode"), rs, pointSelector);
+      true, rs, pointSelector);
 
   // If possible, avoid the overhead of calculating centroids.
   if (params.Has("centroids"))
@@ -85,6 +85,41 @@ class BestBinaryNumericSplit
       arma::vec& splitInfo,
       AuxiliarySplitInfo& aux);
 
+  /**
+   * Check if we can split a node, given the values of the dimension in sorted
+   * order, and the labels and weights in the same order.  This is the same as
+   * SplitIfBetter(), without the sorting; it is used by the decision trees,
+   * which sort each dimension once at the root and keep the order in each
+   * node.
+   *
+   * This overload is used only for classification tasks.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param sortedData The values of the dimension, in sorted order.
+   * @param sortedLabels Labels for each point, in the same order.
+   * @param numClasses Number of classes in the dataset.
+   * @param sortedWeights Weights associated with labels, in the same order.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param splitInfo Stores split information on a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename VecType, typename LabelsType,
+           typename WeightVecType>
+  static double SplitIfBetterSorted(
+      const double bestGain,
+      const VecType& sortedData,
+      const LabelsType& sortedLabels,
+      const size_t numClasses,
+      const WeightVecType& sortedWeights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::vec& splitInfo,
+      AuxiliarySplitInfo& aux);
+
   /**
    * Check if we can split a node.  If we can split a node in a way that
    * improves on 'bestGain', then we return the improved gain.  Otherwise we
@@ -109,10 +144,7 @@ class BestBinaryNumericSplit
    */
   template<bool UseWeights, typename VecType, typename ResponsesType,
            typename WeightVecType>
-  static typename std::enable_if<
-      !HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
-      double>::type
-  SplitIfBetter(
+  static double SplitIfBetter(
       const double bestGain,
       const VecType& data,
       const ResponsesType& responses,
@@ -124,19 +156,56 @@ class BestBinaryNumericSplit
       FitnessFunction& fitnessFunction);
 
   /**
-   * Check if we can split a node.  If we can split a node in a way that
-   * improves on 'bestGain', then we return the improved gain.  Otherwise we
-   * return the value 'bestGain'.  If a split is made, then splitInfo and aux
-   * may be modified.
+   * Check if we can split a node, given the values of the dimension in sorted
+   * order, and the responses and weights in the same order.  This is the same
+   * as SplitIfBetter(), without the sorting.
+   *
+   * This overload is used only for regression tasks.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param sortedData The values of the dimension, in sorted order.
+   * @param sortedResponses Responses for each point, in the same order.
+   * @param sortedWeights Weights associated with responses, in the same order.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param splitInfo Stores split information on a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   * @param fitnessFunction The FitnessFunction object instance. It it used to
+   *      evaluate the gain for the split.
+   */
+  template<bool UseWeights, typename VecType, typename ResponsesType,
+           typename WeightVecType>
+  static typename std::enable_if<
+      !HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
+      double>::type
+  SplitIfBetterSorted(
+      const double bestGain,
+      const VecType& sortedData,
+      const ResponsesType& sortedResponses,
+      const WeightVecType& sortedWeights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      double& splitInfo,
+      AuxiliarySplitInfo& aux,
+      FitnessFunction& fitnessFunction);
+
+  /**
+   * Check if we can split a node, given the values of the dimension in sorted
+   * order, and the responses and weights in the same order.  This is the same
+   * as SplitIfBetter(), without the sorting.
    *
    * This overload is specialized for any fitness function that implements
    * BinaryScanInitialize(), BinaryStep() and BinaryGains() functions.
    *
    * @param bestGain Best gain seen so far (we'll only split if we find gain
    *      better than this).
-   * @param data The dimension of data points to check for a split in.
-   * @param responses Responses for each point.
-   * @param weights Weights associated with responses.
+   * @param sortedData The values of the dimension, in sorted order.
+   * @param sortedResponses Responses for each point, in the same order.
+   * @param sortedWeights Weights associated with responses, in the same
+   *      order.
    * @param minimumLeafSize Minimum number of points in a leaf node for
    *      splitting.
    * @param minimumGainSplit Minimum gain split.
@@ -149,11 +218,11 @@ class BestBinaryNumericSplit
   static typename std::enable_if<
       HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
       double>::type
-  SplitIfBetter(
+  SplitIfBetterSorted(
       const double bestGain,
-      const VecType& data,
-      const ResponsesType& responses,
-      const WeightVecType& weights,
+      const VecType& sortedData,
+      const ResponsesType& sortedResponses,
+      const WeightVecType& sortedWeights,
       const size_t minimumLeafSize,
       const double minimumGainSplit,
       double& splitInfo,
@@ -183,6 +252,24 @@ class BestBinaryNumericSplit
       const AuxiliarySplitInfo& /* aux */);
 };
 
+/**
+ * SupportsSortedData<SplitType>::value is true if the numeric split type has
+ * SplitIfBetterSorted() functions, so that the decision trees can sort each
+ * dimension once at the root instead of in every node.
+ */
+template<typename SplitType>
+struct SupportsSortedData
+{
+  static const bool value = false;
+};
+
+//! BestBinaryNumericSplit can split sorted data.
+template<typename FitnessFunction>
+struct SupportsSortedData<BestBinaryNumericSplit<FitnessFunction>>
+{
+  static const bool value = true;
+};
+
 } // namespace tree
 } // namespace mlpack
 
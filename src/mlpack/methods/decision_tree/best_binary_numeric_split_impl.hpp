@@ -27,7 +27,7 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     arma::vec& splitInfo,
-    AuxiliarySplitInfo& /* aux */)
+    AuxiliarySplitInfo& aux)
 {
   // First sanity check: if we don't have enough points, we can't split.
   if (data.n_elem < (minimumLeafSize * 2))
@@ -37,15 +37,14 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
 
   // Next, sort the data.
   arma::uvec sortedIndices = arma::sort_index(data);
+  arma::Row<typename VecType::elem_type> sortedData(data.n_elem);
   arma::Row<size_t> sortedLabels(labels.n_elem);
   arma::rowvec sortedWeights;
   for (size_t i = 0; i < sortedLabels.n_elem; ++i)
+  {
+    sortedData[i] = data[sortedIndices[i]];
     sortedLabels[i] = labels[sortedIndices[i]];
-
-  // Sanity check: if the first element is the same as the last, we can't split
-  // in this dimension.
-  if (data[sortedIndices[0]] == data[sortedIndices[sortedIndices.n_elem - 1]])
-    return DBL_MAX;
+  }
 
   // Only initialize if we are using weights.
   if (UseWeights)
@@ -56,6 +55,37 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       sortedWeights[i] = weights[sortedIndices[i]];
   }
 
+  return SplitIfBetterSorted<UseWeights>(bestGain, sortedData, sortedLabels,
+      numClasses, sortedWeights, minimumLeafSize, minimumGainSplit, splitInfo,
+      aux);
+}
+
+// Overload used for classification, on sorted data.
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename LabelsType,
+         typename WeightVecType>
+double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetterSorted(
+    const double bestGain,
+    const VecType& sortedData,
+    const LabelsType& sortedLabels,
+    const size_t numClasses,
+    const WeightVecType& sortedWeights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::vec& splitInfo,
+    AuxiliarySplitInfo& /* aux */)
+{
+  // First sanity check: if we don't have enough points, we can't split.
+  if (sortedData.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // Sanity check: if the first element is the same as the last, we can't split
+  // in this dimension.
+  if (sortedData[0] == sortedData[sortedData.n_elem - 1])
+    return DBL_MAX;
+
   // Loop through all possible split points, choosing the best one.  Also, force
   // a minimum leaf size of 1 (empty children don't make sense).
   double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
@@ -83,7 +113,7 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     }
 
     // These points have to be on the right.
-    for (size_t i = minimum - 1; i < data.n_elem; ++i)
+    for (size_t i = minimum - 1; i < sortedData.n_elem; ++i)
     {
       classWeightSums(sortedLabels[i], 1) += sortedWeights[i];
       totalRightWeight += sortedWeights[i];
@@ -92,7 +122,7 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
   else
   {
     classCounts.zeros(numClasses, 2);
-    bestFoundGain *= data.n_elem;
+    bestFoundGain *= sortedData.n_elem;
 
     // Initialize the counts.
     // These points have to be on the left.
@@ -100,11 +130,11 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       ++classCounts(sortedLabels[i], 0);
 
     // These points have to be on the right.
-    for (size_t i = minimum - 1; i < data.n_elem; ++i)
+    for (size_t i = minimum - 1; i < sortedData.n_elem; ++i)
       ++classCounts(sortedLabels[i], 1);
   }
 
-  for (size_t index = minimum; index < data.n_elem - minimum; ++index)
+  for (size_t index = minimum; index < sortedData.n_elem - minimum; ++index)
   {
     // Update class weight sums or counts.
     if (UseWeights)
@@ -121,7 +151,7 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     }
 
     // Make sure that the value has changed.
-    if (data[sortedIndices[index]] == data[sortedIndices[index - 1]])
+    if (sortedData[index] == sortedData[index - 1])
       continue;
 
     // Calculate the gain for the left and right child.  Only use weights if
@@ -156,8 +186,8 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       // take this one. The actual split value will be halfway between the
       // value at index - 1 and index.
       splitInfo.set_size(1);
-      splitInfo[0] = (data[sortedIndices[index - 1]] +
-          data[sortedIndices[index]]) / 2.0;
+      splitInfo[0] = (sortedData[index - 1] +
+          sortedData[index]) / 2.0;
 
       return gain;
     }
@@ -166,8 +196,8 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       // We still have a better split.
       bestFoundGain = gain;
       splitInfo.set_size(1);
-      splitInfo[0] = (data[sortedIndices[index - 1]] +
-          data[sortedIndices[index]]) / 2.0;
+      splitInfo[0] = (sortedData[index - 1] +
+          sortedData[index]) / 2.0;
       improved = true;
     }
   }
@@ -189,10 +219,7 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
 template<typename FitnessFunction>
 template<bool UseWeights, typename VecType, typename ResponsesType,
          typename WeightVecType>
-typename std::enable_if<
-    !HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
-    double>::type
-BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
+double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     const double bestGain,
     const VecType& data,
     const ResponsesType& responses,
@@ -200,7 +227,7 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     double& splitInfo,
-    AuxiliarySplitInfo& /* aux */,
+    AuxiliarySplitInfo& aux,
     FitnessFunction& fitnessFunction)
 {
   typedef typename ResponsesType::elem_type RType;
@@ -214,15 +241,14 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
 
   // Next, sort the data.
   arma::uvec sortedIndices = arma::sort_index(data);
+  arma::Row<typename VecType::elem_type> sortedData(data.n_elem);
   arma::Row<RType> sortedResponses(responses.n_elem);
   arma::Row<WType> sortedWeights;
   for (size_t i = 0; i < sortedResponses.n_elem; ++i)
+  {
+    sortedData[i] = data[sortedIndices[i]];
     sortedResponses[i] = responses[sortedIndices[i]];
-
-  // Sanity check: if the first element is the same as the last, we can't split
-  // in this dimension.
-  if (data[sortedIndices[0]] == data[sortedIndices[sortedIndices.n_elem - 1]])
-    return DBL_MAX;
+  }
 
   // Only initialize if we are using weights.
   if (UseWeights)
@@ -233,6 +259,42 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       sortedWeights[i] = weights[sortedIndices[i]];
   }
 
+  return SplitIfBetterSorted<UseWeights>(bestGain, sortedData,
+      sortedResponses, sortedWeights, minimumLeafSize, minimumGainSplit,
+      splitInfo, aux, fitnessFunction);
+}
+
+// Overload used for regression, on sorted data.
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename ResponsesType,
+         typename WeightVecType>
+typename std::enable_if<
+    !HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
+    double>::type
+BestBinaryNumericSplit<FitnessFunction>::SplitIfBetterSorted(
+    const double bestGain,
+    const VecType& sortedData,
+    const ResponsesType& sortedResponses,
+    const WeightVecType& sortedWeights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    double& splitInfo,
+    AuxiliarySplitInfo& /* aux */,
+    FitnessFunction& fitnessFunction)
+{
+  typedef typename WeightVecType::elem_type WType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (sortedData.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // Sanity check: if the first element is the same as the last, we can't split
+  // in this dimension.
+  if (sortedData[0] == sortedData[sortedData.n_elem - 1])
+    return DBL_MAX;
+
   double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
   bool improved = false;
   // Force a minimum leaf size of 1 (empty children don't make sense).
@@ -250,16 +312,16 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     for (size_t i = 0; i < minimum - 1; ++i)
       totalLeftWeight += sortedWeights[i];
 
-    for (size_t i = minimum - 1; i < data.n_elem; ++i)
+    for (size_t i = minimum - 1; i < sortedData.n_elem; ++i)
       totalRightWeight += sortedWeights[i];
   }
   else
   {
-    bestFoundGain *= data.n_elem;
+    bestFoundGain *= sortedData.n_elem;
   }
 
   // Loop through all possible split points, choosing the best one.
-  for (size_t index = minimum; index < data.n_elem - minimum + 1; ++index)
+  for (size_t index = minimum; index < sortedData.n_elem - minimum + 1; ++index)
   {
     if (UseWeights)
     {
@@ -267,7 +329,7 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       totalRightWeight -= sortedWeights[index - 1];
     }
     // Make sure that the value has changed.
-    if (data[sortedIndices[index]] == data[sortedIndices[index - 1]])
+    if (sortedData[index] == sortedData[index - 1])
       continue;
 
     // Calculate the gain for the left and right child.
@@ -275,7 +337,7 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
         Evaluate<UseWeights>(sortedResponses, sortedWeights, 0, index);
     const double rightGain = fitnessFunction.template
         Evaluate<UseWeights>(sortedResponses, sortedWeights, index,
-            responses.n_elem);
+            sortedResponses.n_elem);
 
     double gain;
     if (UseWeights)
@@ -295,8 +357,8 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       // We can take a shortcut: no split will be better than this, so just
       // take this one. The actual split value will be halfway between the
       // value at index - 1 and index.
-      splitInfo = (data[sortedIndices[index - 1]] +
-          data[sortedIndices[index]]) / 2.0;
+      splitInfo = (sortedData[index - 1] +
+          sortedData[index]) / 2.0;
 
       return gain;
     }
@@ -304,8 +366,8 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     {
       // We still have a better split.
       bestFoundGain = gain;
-      splitInfo = (data[sortedIndices[index - 1]] +
-          data[sortedIndices[index]]) / 2.0;
+      splitInfo = (sortedData[index - 1] +
+          sortedData[index]) / 2.0;
       improved = true;
     }
   }
@@ -318,60 +380,44 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
   if (UseWeights)
     bestFoundGain /= totalWeight;
   else
-    bestFoundGain /= data.n_elem;
+    bestFoundGain /= sortedData.n_elem;
 
   return bestFoundGain;
 }
 
 // Optimized version for any fitness function that implements
-// BinaryScanInitialize(), BinaryStep() and BinaryGains() functions.
+// BinaryScanInitialize(), BinaryStep() and BinaryGains() functions, on sorted
+// data.
 template<typename FitnessFunction>
 template<bool UseWeights, typename VecType, typename ResponsesType,
          typename WeightVecType>
 typename std::enable_if<
     HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
     double>::type
-BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
+BestBinaryNumericSplit<FitnessFunction>::SplitIfBetterSorted(
     const double bestGain,
-    const VecType& data,
-    const ResponsesType& responses,
-    const WeightVecType& weights,
+    const VecType& sortedData,
+    const ResponsesType& sortedResponses,
+    const WeightVecType& sortedWeights,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     double& splitInfo,
     AuxiliarySplitInfo& /* aux */,
     FitnessFunction& fitnessFunction)
 {
-  typedef typename ResponsesType::elem_type RType;
   typedef typename WeightVecType::elem_type WType;
 
   // First sanity check: if we don't have enough points, we can't split.
-  if (data.n_elem < (minimumLeafSize * 2))
+  if (sortedData.n_elem < (minimumLeafSize * 2))
     return DBL_MAX;
   if (bestGain == 0.0)
     return DBL_MAX; // It can't be outperformed.
 
-  // Next, sort the data.
-  arma::uvec sortedIndices = arma::sort_index(data);
-  arma::Row<RType> sortedResponses(responses.n_elem);
-  arma::Row<WType> sortedWeights;
-  for (size_t i = 0; i < sortedResponses.n_elem; ++i)
-    sortedResponses[i] = responses[sortedIndices[i]];
-
   // Sanity check: if the first element is the same as the last, we can't split
   // in this dimension.
-  if (data[sortedIndices[0]] == data[sortedIndices[sortedIndices.n_elem - 1]])
+  if (sortedData[0] == sortedData[sortedData.n_elem - 1])
     return DBL_MAX;
 
-  // Only initialize if we are using weights.
-  if (UseWeights)
-  {
-    sortedWeights.set_size(sortedResponses.n_elem);
-    // The weights must keep the same order as the responses.
-    for (size_t i = 0; i < sortedResponses.n_elem; ++i)
-      sortedWeights[i] = weights[sortedIndices[i]];
-  }
-
   double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
   bool improved = false;
   // Force a minimum leaf size of 1 (empty children don't make sense).
@@ -389,12 +435,12 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     for (size_t i = 0; i < minimum - 1; ++i)
       leftChildWeight += sortedWeights[i];
 
-    for (size_t i = minimum - 1; i < data.n_elem; ++i)
+    for (size_t i = minimum - 1; i < sortedData.n_elem; ++i)
       rightChildWeight += sortedWeights[i];
   }
   else
   {
-    bestFoundGain *= data.n_elem;
+    bestFoundGain *= sortedData.n_elem;
   }
 
   // Initialize and precompute various statistics to efficiently compute gain
@@ -403,7 +449,7 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       sortedWeights, minimum);
 
   // Loop through all possible split points, choosing the best one.
-  for (size_t index = minimum; index < data.n_elem - minimum + 1; ++index)
+  for (size_t index = minimum; index < sortedData.n_elem - minimum + 1; ++index)
   {
     if (UseWeights)
     {
@@ -416,7 +462,7 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
         sortedWeights, index - 1);
 
     // Make sure that the value has changed.
-    if (data[sortedIndices[index]] == data[sortedIndices[index - 1]])
+    if (sortedData[index] == sortedData[index - 1])
       continue;
 
     // Calculate the gain for the left and right child.
@@ -442,8 +488,8 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       // We can take a shortcut: no split will be better than this, so just
       // take this one. The actual split value will be halfway between the
       // value at index - 1 and index.
-      splitInfo = (data[sortedIndices[index - 1]] +
-          data[sortedIndices[index]]) / 2.0;
+      splitInfo = (sortedData[index - 1] +
+          sortedData[index]) / 2.0;
 
       return gain;
     }
@@ -451,8 +497,8 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     {
       // We still have a better split.
       bestFoundGain = gain;
-      splitInfo = (data[sortedIndices[index - 1]] +
-          data[sortedIndices[index]]) / 2.0;
+      splitInfo = (sortedData[index - 1] +
+          sortedData[index]) / 2.0;
       improved = true;
     }
   }
@@ -464,7 +510,7 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
   if (UseWeights)
     bestFoundGain /= totalWeight;
   else
-    bestFoundGain /= data.n_elem;
+    bestFoundGain /= sortedData.n_elem;
 
   return bestFoundGain;
 }
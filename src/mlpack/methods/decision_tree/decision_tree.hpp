@@ -20,6 +20,7 @@
 #include "random_binary_numeric_split.hpp"
 #include "all_categorical_split.hpp"
 #include "all_dimension_select.hpp"
+#include "presorted_indices.hpp"
 #include <type_traits>
 
 namespace mlpack {
@@ -397,6 +398,42 @@ class DecisionTree :
                const std::enable_if_t<arma::is_arma_type<typename
                    std::remove_reference<WeightsType>::type>::value>* = 0);
 
+  /**
+   * Train the decision tree on the points of the given dataset with the given
+   * indices, which may repeat (as in a bootstrap sample).  The dataset is only
+   * read, never copied or modified, so it can be shared by many trees that are
+   * trained at the same time; only the indices, labels and weights of the
+   * points are copied.  The labels and the weights are those of all the
+   * points of the dataset.
+   *
+   * @tparam UseWeights Whether to use the weights.
+   * @tparam UseDatasetInfo Whether to use the dataset information; if false,
+   *      all dimensions are assumed to be numeric.
+   * @param data Dataset to train on.
+   * @param indices Indices of the points of the dataset to train on.
+   * @param datasetInfo Type information for each dimension of the dataset.
+   * @param labels Labels for each point of the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of each point of the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @return The final entropy of decision tree.
+   */
+  template<bool UseWeights, bool UseDatasetInfo, typename MatType>
+  double TrainOnIndices(const MatType& data,
+                        const arma::Row<size_t>& indices,
+                        const data::DatasetInfo& datasetInfo,
+                        const arma::Row<size_t>& labels,
+                        const size_t numClasses,
+                        const arma::rowvec& weights,
+                        const size_t minimumLeafSize = 10,
+                        const double minimumGainSplit = 1e-7,
+                        const size_t maximumDepth = 0,
+                        DimensionSelectionType dimensionSelector =
+                            DimensionSelectionType());
+
   /**
    * Classify the given point, using the entire tree.  The predicted label is
    * returned.
@@ -463,6 +500,13 @@ class DecisionTree :
   //! Get the split dimension (only meaningful if this is a non-leaf in a
   //! trained tree).
   size_t SplitDimension() const { return splitDimension; }
+  //! Get the type of the split dimension (only meaningful if this is a
+  //! non-leaf in a trained tree).
+  data::Datatype SplitDimensionType() const
+  { return (data::Datatype) dimensionTypeOrMajorityClass; }
+  //! Get the class probabilities of a leaf.  For a non-leaf, this holds the
+  //! information of the numeric or categorical split instead.
+  const arma::vec& ClassProbabilities() const { return classProbabilities; }
 
   /**
    * Given a point and that this node is not a leaf, calculate the index of the
@@ -517,9 +561,11 @@ class DecisionTree :
    * avoiding unnecessary copies during training.  This function is called to
    * train children.
    *
-   * @param data Dataset to train on.
-   * @param begin Index of the starting point in the dataset that belongs to
-   *      this node.
+   * @param data Dataset to train on.  It is not modified.
+   * @param points Columns of the dataset of the training points; the points
+   *      are reordered so that those of each node are contiguous.
+   * @param begin Index of the starting point in points that belongs to this
+   *      node.
    * @param count Number of points in this node.
    * @param datasetInfo Type information for each dimension.
    * @param labels Labels for each training point.
@@ -530,7 +576,8 @@ class DecisionTree :
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType>
-  double Train(MatType& data,
+  double Train(const MatType& data,
+               arma::Row<size_t>& points,
                const size_t begin,
                const size_t count,
                const data::DatasetInfo& datasetInfo,
@@ -547,19 +594,28 @@ class DecisionTree :
    * avoiding unnecessary copies during training.  This method is called for
    * training children.
    *
-   * @param data Dataset to train on.
-   * @param begin Index of the starting point in the dataset that belongs to
-   *      this node.
+   * If the numeric split supports sorted data and all dimensions are
+   * considered in each node, the dimensions are sorted once at the root, and
+   * the sorted order is passed down to the children (see PresortedIndices).
+   *
+   * @param data Dataset to train on.  It is not modified.
+   * @param points Columns of the dataset of the training points; the points
+   *      are reordered so that those of each node are contiguous.
+   * @param begin Index of the starting point in points that belongs to this
+   *      node.
    * @param count Number of points in this node.
    * @param labels Labels for each training point.
    * @param numClasses Number of classes in the dataset.
    * @param minimumLeafSize Minimum number of points in each leaf node.
    * @param minimumGainSplit Minimum gain for the node to split.
    * @param maximumDepth Maximum depth for the tree.
+   * @param presorted The sorted order of the points in each dimension, or
+   *      NULL if it has not been computed yet.
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType>
-  double Train(MatType& data,
+  double Train(const MatType& data,
+               arma::Row<size_t>& points,
                const size_t begin,
                const size_t count,
                arma::Row<size_t>& labels,
@@ -568,7 +624,98 @@ class DecisionTree :
                const size_t minimumLeafSize,
                const double minimumGainSplit,
                const size_t maximumDepth,
-               DimensionSelectionType& dimensionSelector);
+               DimensionSelectionType& dimensionSelector,
+               PresortedIndices* presorted = NULL);
+
+  /**
+   * Find the best split of the given dimension with the numeric split, using
+   * the sorted order of the points of this node in that dimension.  The split
+   * is stored in splitInfo and aux instead of in this node, so several
+   * dimensions can be searched at the same time.
+   */
+  template<bool UseWeights, typename MatType, typename SplitType = NumericSplit>
+  typename std::enable_if<SupportsSortedData<SplitType>::value, double>::type
+  SortedSplitIfBetter(const double bestGain,
+                      const MatType& data,
+                      const arma::Row<size_t>& points,
+                      const size_t dimension,
+                      const size_t begin,
+                      const size_t count,
+                      const arma::Row<size_t>& labels,
+                      const size_t numClasses,
+                      const arma::rowvec& weights,
+                      const size_t minimumLeafSize,
+                      const double minimumGainSplit,
+                      const PresortedIndices& presorted,
+                      arma::vec& splitInfo,
+                      NumericAuxiliarySplitInfo& aux) const;
+
+  //! This overload is never called, since the dimensions are only presorted
+  //! if the numeric split supports it.
+  template<bool UseWeights, typename MatType, typename SplitType = NumericSplit>
+  typename std::enable_if<!SupportsSortedData<SplitType>::value, double>::type
+  SortedSplitIfBetter(const double /* bestGain */,
+                      const MatType& /* data */,
+                      const arma::Row<size_t>& /* points */,
+                      const size_t /* dimension */,
+                      const size_t /* begin */,
+                      const size_t /* count */,
+                      const arma::Row<size_t>& /* labels */,
+                      const size_t /* numClasses */,
+                      const arma::rowvec& /* weights */,
+                      const size_t /* minimumLeafSize */,
+                      const double /* minimumGainSplit */,
+                      const PresortedIndices& /* presorted */,
+                      arma::vec& /* splitInfo */,
+                      NumericAuxiliarySplitInfo& /* aux */) const
+  {
+    return DBL_MAX;
+  }
+
+  /**
+   * Train the children of this node, whose points are
+   * points[childBegins[i], childBegins[i] + childCounts[i]).  If
+   * parallel is true, each child is trained in its own OpenMP task; this must
+   * then be called from inside a parallel region.
+   *
+   * @return The gain of the children, weighted by their number of points (or
+   *     0 if NoRecursion is true).
+   */
+  template<bool UseWeights, typename MatType>
+  double TrainChildren(const MatType& data,
+                       arma::Row<size_t>& points,
+                       const arma::Row<size_t>& childBegins,
+                       const arma::Row<size_t>& childCounts,
+                       arma::Row<size_t>& labels,
+                       const size_t numClasses,
+                       arma::rowvec& weights,
+                       const size_t minimumLeafSize,
+                       const double minimumGainSplit,
+                       const size_t maximumDepth,
+                       DimensionSelectionType& dimensionSelector,
+                       PresortedIndices* presorted,
+                       const bool parallel);
+
+  //! Get the values of the given dimension of points[begin, begin + count).
+  template<typename MatType>
+  static void GatherDimension(const MatType& data,
+                              const arma::Row<size_t>& points,
+                              const size_t dimension,
+                              const size_t begin,
+                              const size_t count,
+                              arma::Row<typename MatType::elem_type>& values)
+  {
+    values.set_size(count);
+    for (size_t i = 0; i < count; ++i)
+      values[i] = data(dimension, points[begin + i]);
+  }
+
+  //! Whether the dimensions are sorted once at the root when all dimensions
+  //! are numeric.  This is only done if every node considers every dimension,
+  //! since all dimensions have to be kept sorted for the children.
+  static const bool UsePresorting =
+      SupportsSortedData<NumericSplit>::value &&
+      std::is_same<DimensionSelectionType, AllDimensionSelect>::value;
 };
 
 /**
@@ -50,8 +50,10 @@ DecisionTree<FitnessFunction,
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
-      weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+  arma::Row<size_t> points =
+      arma::regspace<arma::Row<size_t>>(0, tmpData.n_cols - 1);
+  Train<false>(tmpData, points, 0, tmpData.n_cols, datasetInfo, tmpLabels,
+      numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
 
@@ -87,8 +89,11 @@ DecisionTree<FitnessFunction,
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, weights,
-      minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
+  arma::Row<size_t> points =
+      arma::regspace<arma::Row<size_t>>(0, tmpData.n_cols - 1);
+  Train<false>(tmpData, points, 0, tmpData.n_cols, tmpLabels, numClasses,
+      weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
 }
 
 //! Construct and train with weights.
@@ -128,8 +133,10 @@ DecisionTree<FitnessFunction,
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
-      tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+  arma::Row<size_t> points =
+      arma::regspace<arma::Row<size_t>>(0, tmpData.n_cols - 1);
+  Train<true>(tmpData, points, 0, tmpData.n_cols, datasetInfo, tmpLabels,
+      numClasses, tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
 
@@ -168,8 +175,10 @@ DecisionTree<FitnessFunction,
   TrueWeightsType tmpWeights(std::move(weights));
 
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
-              tmpWeights, minimumLeafSize, minimumGainSplit);
+  arma::Row<size_t> points =
+      arma::regspace<arma::Row<size_t>>(0, tmpData.n_cols - 1);
+  Train<true>(tmpData, points, 0, tmpData.n_cols, datasetInfo, tmpLabels,
+      numClasses, tmpWeights, minimumLeafSize, minimumGainSplit);
 }
 
 //! Construct and train with weights.
@@ -210,8 +219,11 @@ DecisionTree<FitnessFunction,
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, tmpWeights,
-      minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
+  arma::Row<size_t> points =
+      arma::regspace<arma::Row<size_t>>(0, tmpData.n_cols - 1);
+  Train<true>(tmpData, points, 0, tmpData.n_cols, tmpLabels, numClasses,
+      tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
 }
 
 //! Construct and train with weights.
@@ -254,8 +266,11 @@ DecisionTree<FitnessFunction,
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, tmpWeights,
-      minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
+  arma::Row<size_t> points =
+      arma::regspace<arma::Row<size_t>>(0, tmpData.n_cols - 1);
+  Train<true>(tmpData, points, 0, tmpData.n_cols, tmpLabels, numClasses,
+      tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
 }
 
 //! Construct, don't train.
@@ -455,9 +470,11 @@ double DecisionTree<FitnessFunction,
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  return Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels,
-      numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
-      dimensionSelector);
+  arma::Row<size_t> points =
+      arma::regspace<arma::Row<size_t>>(0, tmpData.n_cols - 1);
+  return Train<false>(tmpData, points, 0, tmpData.n_cols, datasetInfo,
+      tmpLabels, numClasses, weights, minimumLeafSize, minimumGainSplit,
+      maximumDepth, dimensionSelector);
 }
 
 //! Train on the given data, assuming all dimensions are numeric.
@@ -495,7 +512,9 @@ double DecisionTree<FitnessFunction,
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  return Train<false>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses,
+  arma::Row<size_t> points =
+      arma::regspace<arma::Row<size_t>>(0, tmpData.n_cols - 1);
+  return Train<false>(tmpData, points, 0, tmpData.n_cols, tmpLabels, numClasses,
       weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
@@ -542,7 +561,9 @@ double DecisionTree<FitnessFunction,
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
   // Pass off work to the Train() method.
-  return Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels,
+  arma::Row<size_t> points =
+      arma::regspace<arma::Row<size_t>>(0, tmpData.n_cols - 1);
+  return Train<true>(tmpData, points, 0, tmpData.n_cols, datasetInfo, tmpLabels,
       numClasses, tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
@@ -588,11 +609,85 @@ double DecisionTree<FitnessFunction,
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
   // Pass off work to the Train() method.
-  return Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses,
+  arma::Row<size_t> points =
+      arma::regspace<arma::Row<size_t>>(0, tmpData.n_cols - 1);
+  return Train<true>(tmpData, points, 0, tmpData.n_cols, tmpLabels, numClasses,
       tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
 
+//! Train on the points of the given dataset with the given indices.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<bool UseWeights, bool UseDatasetInfo, typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    NoRecursion>::TrainOnIndices(
+    const MatType& data,
+    const arma::Row<size_t>& indices,
+    const data::DatasetInfo& datasetInfo,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType dimensionSelector)
+{
+  // Sanity check on data.
+  util::CheckSameSizes(data, labels, "DecisionTree::TrainOnIndices()");
+  if (UseWeights)
+  {
+    util::CheckSameSizes(data, weights, "DecisionTree::TrainOnIndices()",
+        "weights");
+  }
+
+  if (indices.n_elem == 0)
+  {
+    throw std::invalid_argument("DecisionTree::TrainOnIndices(): no points "
+        "to train on!");
+  }
+
+  if (indices.max() >= data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::TrainOnIndices(): index " << indices.max()
+        << " is out of bounds for a dataset with " << data.n_cols
+        << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Only the indices, labels and weights of the points are copied, since they
+  // are reordered while the tree is built.
+  arma::Row<size_t> points(indices);
+  arma::Row<size_t> pointLabels = labels.cols(indices);
+  arma::rowvec pointWeights;
+  if (UseWeights)
+    pointWeights = weights.cols(indices);
+
+  // Set the correct dimensionality for the dimension selector.
+  dimensionSelector.Dimensions() = data.n_rows;
+
+  // Pass off work to the Train() method.
+  if (UseDatasetInfo)
+  {
+    return Train<UseWeights>(data, points, 0, points.n_elem, datasetInfo,
+        pointLabels, numClasses, pointWeights, minimumLeafSize,
+        minimumGainSplit, maximumDepth, dimensionSelector);
+  }
+  else
+  {
+    return Train<UseWeights>(data, points, 0, points.n_elem, pointLabels,
+        numClasses, pointWeights, minimumLeafSize, minimumGainSplit,
+        maximumDepth, dimensionSelector);
+  }
+}
+
 //! Train on the given data, assuming all dimensions are numeric.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
@@ -605,7 +700,8 @@ double DecisionTree<FitnessFunction,
                     CategoricalSplitType,
                     DimensionSelectionType,
                     NoRecursion>::Train(
-    MatType& data,
+    const MatType& data,
+    arma::Row<size_t>& points,
     const size_t begin,
     const size_t count,
     const data::DatasetInfo& datasetInfo,
@@ -636,14 +732,17 @@ double DecisionTree<FitnessFunction,
 
   if (maximumDepth != 1)
   {
+    arma::Row<typename MatType::elem_type> dimData;
     for (size_t i = dimensionSelector.Begin(); i != end;
          i = dimensionSelector.Next())
     {
+      GatherDimension(data, points, i, begin, count, dimData);
+
       double dimGain = -DBL_MAX;
       if (datasetInfo.Type(i) == data::Datatype::categorical)
       {
         dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
+            dimData,
             datasetInfo.NumMappings(i),
             labels.subvec(begin, begin + count - 1),
             numClasses,
@@ -656,7 +755,7 @@ double DecisionTree<FitnessFunction,
       else if (datasetInfo.Type(i) == data::Datatype::numeric)
       {
         dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
+            dimData,
             labels.subvec(begin, begin + count - 1),
             numClasses,
             UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
@@ -700,14 +799,14 @@ double DecisionTree<FitnessFunction,
     {
       for (size_t j = begin; j < begin + count; ++j)
         childAssignments[j - begin] = CategoricalSplit::CalculateDirection(
-            data(bestDim, j), classProbabilities[0], *this);
+            data(bestDim, points[j]), classProbabilities[0], *this);
     }
     else
     {
       for (size_t j = begin; j < begin + count; ++j)
       {
         childAssignments[j - begin] = NumericSplit::CalculateDirection(
-            data(bestDim, j), classProbabilities[0], *this);
+            data(bestDim, points[j]), classProbabilities[0], *this);
       }
     }
 
@@ -732,7 +831,7 @@ double DecisionTree<FitnessFunction,
         if (childAssignments[j - begin] == i)
         {
           childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
+          points.swap_cols(currentCol, j);
           labels.swap_cols(currentCol, j);
           if (UseWeights)
             weights.swap_cols(currentCol, j);
@@ -744,7 +843,7 @@ double DecisionTree<FitnessFunction,
       DecisionTree* child = new DecisionTree();
       if (NoRecursion)
       {
-        child->Train<UseWeights>(data, currentChildBegin,
+        child->Train<UseWeights>(data, points, currentChildBegin,
             currentCol - currentChildBegin, datasetInfo, labels, numClasses,
             weights, currentCol - currentChildBegin, minimumGainSplit,
             maximumDepth - 1, dimensionSelector);
@@ -752,10 +851,10 @@ double DecisionTree<FitnessFunction,
       else
       {
         // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
+        double childGain = child->Train<UseWeights>(data, points,
+            currentChildBegin, currentCol - currentChildBegin, datasetInfo,
+            labels, numClasses, weights, minimumLeafSize, minimumGainSplit,
+            maximumDepth - 1, dimensionSelector);
         bestGain += double(childCounts[i]) / double(count) * (-childGain);
       }
       children.push_back(child);
@@ -789,7 +888,8 @@ double DecisionTree<FitnessFunction,
                     CategoricalSplitType,
                     DimensionSelectionType,
                     NoRecursion>::Train(
-    MatType& data,
+    const MatType& data,
+    arma::Row<size_t>& points,
     const size_t begin,
     const size_t count,
     arma::Row<size_t>& labels,
@@ -798,8 +898,18 @@ double DecisionTree<FitnessFunction,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     const size_t maximumDepth,
-    DimensionSelectionType& dimensionSelector)
+    DimensionSelectionType& dimensionSelector,
+    PresortedIndices* presorted)
 {
+  // Sort each dimension once at the root, if the numeric split can use it.
+  if (UsePresorting && presorted == NULL && count > 0 && maximumDepth != 1)
+  {
+    PresortedIndices rootIndices(data, points, begin, count);
+    return Train<UseWeights>(data, points, begin, count, labels, numClasses,
+        weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+        dimensionSelector, &rootIndices);
+  }
+
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
@@ -819,23 +929,72 @@ double DecisionTree<FitnessFunction,
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
   size_t bestDim = data.n_rows; // This means "no split".
 
-  if (maximumDepth != 1)
+  // Nodes with fewer points than this are not worth searching or splitting
+  // in parallel.
+  const size_t minParallelSplitSize = 5000;
+
+  if (maximumDepth != 1 && presorted != NULL)
+  {
+    // Every dimension is searched (the dimension selector is
+    // AllDimensionSelect), so the dimensions are searched in parallel, each
+    // against the gain of this node.  The best splits of the dimensions are
+    // then taken in order with the same rule as the serial search below, so
+    // the tree does not depend on the number of threads.
+    const size_t dimensions = data.n_rows;
+    arma::vec dimGains(dimensions);
+    std::vector<arma::vec> splitInfos(dimensions);
+    std::vector<NumericAuxiliarySplitInfo> auxes(dimensions);
+
+    #pragma omp parallel for if (count >= minParallelSplitSize)
+    for (omp_size_t i = 0; i < (omp_size_t) dimensions; ++i)
+    {
+      dimGains[i] = SortedSplitIfBetter<UseWeights>(bestGain, data, points, i,
+          begin, count, labels, numClasses, weights, minimumLeafSize,
+          minimumGainSplit, *presorted, splitInfos[i], auxes[i]);
+    }
+
+    for (size_t i = 0; i < dimensions; ++i)
+    {
+      if (dimGains[i] == DBL_MAX)
+        continue;
+
+      // A later dimension only replaces the best split if its gain is better
+      // by minimumGainSplit, as in BestBinaryNumericSplit::SplitIfBetter().
+      if (bestDim != data.n_rows && dimGains[i] < 0.0 &&
+          dimGains[i] <= std::min(bestGain + minimumGainSplit, 0.0))
+        continue;
+
+      bestDim = i;
+      bestGain = dimGains[i];
+
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
+
+    if (bestDim != data.n_rows)
+    {
+      classProbabilities = splitInfos[bestDim];
+      NumericAuxiliarySplitInfo::operator=(auxes[bestDim]);
+    }
+  }
+  else if (maximumDepth != 1)
   {
+    arma::Row<typename MatType::elem_type> dimData;
     for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
          i = dimensionSelector.Next())
     {
+      GatherDimension(data, points, i, begin, count, dimData);
       const double dimGain = NumericSplitType<FitnessFunction>::template
           SplitIfBetter<UseWeights>(bestGain,
-                                    data.cols(begin, begin + count - 1).row(i),
-                                    labels.cols(begin, begin + count - 1),
-                                    numClasses,
-                                    UseWeights ?
-                                        weights.cols(begin, begin + count - 1) :
-                                        weights,
-                                    minimumLeafSize,
-                                    minimumGainSplit,
-                                    classProbabilities,
-                                    *this);
+              dimData,
+              labels.cols(begin, begin + count - 1),
+              numClasses,
+              UseWeights ? weights.cols(begin, begin + count - 1) : weights,
+              minimumLeafSize,
+              minimumGainSplit,
+              classProbabilities,
+              *this);
 
       // If the splitter did not report that it improved, then move to the next
       // dimension.
@@ -866,7 +1025,7 @@ double DecisionTree<FitnessFunction,
     for (size_t j = begin; j < begin + count; ++j)
     {
       childAssignments[j - begin] = NumericSplit::CalculateDirection(
-          data(bestDim, j), classProbabilities[0], *this);
+          data(bestDim, points[j]), classProbabilities[0], *this);
     }
 
     // Calculate counts of children in each node.
@@ -875,49 +1034,83 @@ double DecisionTree<FitnessFunction,
     for (size_t j = begin; j < begin + count; ++j)
       childCounts[childAssignments[j - begin]]++;
 
-    // Initialize bestGain if recursive split is allowed.
-    if (!NoRecursion)
+    // If the dimensions are presorted, remember the child of each column and
+    // where each column is moved to, so the sorted order of the children can
+    // be computed.
+    arma::Row<size_t> originalAssignments, columns;
+    if (presorted != NULL)
     {
-      bestGain = 0.0;
+      originalAssignments = childAssignments;
+      columns = arma::regspace<arma::Row<size_t>>(0, count - 1);
     }
 
+    // Move the points of each child next to each other.
+    arma::Row<size_t> childBegins(numChildren);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = childBegins[i]; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
           childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
+          points.swap_cols(currentCol, j);
           labels.swap_cols(currentCol, j);
           if (UseWeights)
             weights.swap_cols(currentCol, j);
+          if (presorted != NULL)
+            columns.swap_cols(currentCol - begin, j - begin);
           ++currentCol;
         }
       }
+    }
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            currentCol - currentChildBegin, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-      }
-      else
+    if (presorted != NULL)
+    {
+      arma::Row<size_t> newColumns(count);
+      for (size_t j = 0; j < count; ++j)
+        newColumns[columns[j]] = begin + j;
+      presorted->Partition(begin, count, originalAssignments, childCounts,
+          newColumns);
+    }
+
+    // Each child only touches its own part of the points, the labels, the
+    // weights and the presorted indices, and the dimension selector is not
+    // used when the dimensions are presorted, so in that case the children
+    // can be trained at the same time.  If we are not inside a parallel region
+    // yet (i.e., this is the first large node), start one; the tasks of all
+    // the descendants will then run in it.
+    const bool parallel = (presorted != NULL) &&
+        (count >= 2 * minParallelSplitSize);
+    bool inParallel = false;
+    #ifdef HAS_OPENMP
+      inParallel = omp_in_parallel();
+    #endif
+
+    double childrenGain = 0.0;
+    if (parallel && !inParallel)
+    {
+      #pragma omp parallel
       {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
+        #pragma omp single
+        childrenGain = TrainChildren<UseWeights>(data, points, childBegins,
+            childCounts, labels, numClasses, weights, minimumLeafSize,
+            minimumGainSplit, maximumDepth, dimensionSelector, presorted,
+            true);
       }
-      children.push_back(child);
     }
+    else
+    {
+      childrenGain = TrainChildren<UseWeights>(data, points, childBegins,
+          childCounts, labels, numClasses, weights, minimumLeafSize,
+          minimumGainSplit, maximumDepth, dimensionSelector, presorted,
+          parallel);
+    }
+
+    // During recursion entropy of child node may change.
+    if (!NoRecursion)
+      bestGain = childrenGain;
   }
   else
   {
@@ -934,6 +1127,112 @@ double DecisionTree<FitnessFunction,
   return -bestGain;
 }
 
+//! Find the best split of a dimension, using the presorted order.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType, typename SplitType>
+typename std::enable_if<SupportsSortedData<SplitType>::value, double>::type
+DecisionTree<FitnessFunction,
+             NumericSplitType,
+             CategoricalSplitType,
+             DimensionSelectionType,
+             NoRecursion>::SortedSplitIfBetter(
+    const double bestGain,
+    const MatType& data,
+    const arma::Row<size_t>& points,
+    const size_t dimension,
+    const size_t begin,
+    const size_t count,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const PresortedIndices& presorted,
+    arma::vec& splitInfo,
+    NumericAuxiliarySplitInfo& aux) const
+{
+  arma::Row<typename MatType::elem_type> sortedData;
+  arma::Row<size_t> sortedLabels;
+  arma::rowvec sortedWeights;
+  presorted.GatherData(data, points, dimension, begin, count, sortedData);
+  presorted.Gather(labels, dimension, begin, count, sortedLabels);
+  if (UseWeights)
+    presorted.Gather(weights, dimension, begin, count, sortedWeights);
+
+  return SplitType::template SplitIfBetterSorted<UseWeights>(bestGain,
+      sortedData, sortedLabels, numClasses, sortedWeights, minimumLeafSize,
+      minimumGainSplit, splitInfo, aux);
+}
+
+//! Train the children of a node.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    NoRecursion>::TrainChildren(
+    const MatType& data,
+    arma::Row<size_t>& points,
+    const arma::Row<size_t>& childBegins,
+    const arma::Row<size_t>& childCounts,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType& dimensionSelector,
+    PresortedIndices* presorted,
+    const bool parallel)
+{
+  const size_t numChildren = childCounts.n_elem;
+  children.resize(numChildren, NULL);
+  arma::vec childGains(numChildren, arma::fill::zeros);
+
+  for (size_t i = 0; i < numChildren; ++i)
+  {
+    #pragma omp task if (parallel) firstprivate(i) \
+        shared(data, points, labels, weights, dimensionSelector, childGains)
+    {
+      // Now build the child recursively.
+      DecisionTree* child = new DecisionTree();
+      if (NoRecursion)
+      {
+        child->Train<UseWeights>(data, points, childBegins[i], childCounts[i],
+            labels, numClasses, weights, childCounts[i], minimumGainSplit,
+            maximumDepth - 1, dimensionSelector, presorted);
+      }
+      else
+      {
+        childGains[i] = child->Train<UseWeights>(data, points, childBegins[i],
+            childCounts[i], labels, numClasses, weights, minimumLeafSize,
+            minimumGainSplit, maximumDepth - 1, dimensionSelector, presorted);
+      }
+      children[i] = child;
+    }
+  }
+
+  #pragma omp taskwait
+
+  // The gains are summed in order, so the result does not depend on the order
+  // the tasks ran in.
+  const size_t count = arma::accu(childCounts);
+  double gain = 0.0;
+  for (size_t i = 0; i < numChildren; ++i)
+    gain += double(childCounts[i]) / double(count) * (-childGains[i]);
+
+  return gain;
+}
+
 //! Return the class.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
@@ -1004,7 +1303,8 @@ void DecisionTree<FitnessFunction,
   }
 
   // Loop over each point.
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
     predictions[i] = Classify(data.col(i));
 }
 
@@ -20,6 +20,7 @@
 #include "all_categorical_split.hpp"
 #include "random_binary_numeric_split.hpp"
 #include "all_dimension_select.hpp"
+#include "presorted_indices.hpp"
 #include <type_traits>
 
 
@@ -513,6 +514,8 @@ class DecisionTreeRegressor :
    * @param maximumDepth Maximum depth for the tree.
    * @param fitnessFunction Instantiated fitnessFunction. It is used to
    *      evaluate the fitness score for splitting each node.
+   * @param presorted The sorted order of the points in each dimension, or
+   *      NULL if it has not been computed yet.
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType, typename ResponsesType>
@@ -525,7 +528,54 @@ class DecisionTreeRegressor :
                const double minimumGainSplit,
                const size_t maximumDepth,
                DimensionSelectionType& dimensionSelector,
-               FitnessFunction fitnessFunction = FitnessFunction());
+               FitnessFunction fitnessFunction = FitnessFunction(),
+               PresortedIndices* presorted = NULL);
+
+  /**
+   * Find the best split of the given dimension with the numeric split, using
+   * the sorted order of the points of this node in that dimension.
+   */
+  template<bool UseWeights, typename MatType, typename ResponsesType,
+           typename SplitType = NumericSplit>
+  typename std::enable_if<SupportsSortedData<SplitType>::value, double>::type
+  SortedSplitIfBetter(const double bestGain,
+                      const MatType& data,
+                      const size_t dimension,
+                      const size_t begin,
+                      const size_t count,
+                      const ResponsesType& responses,
+                      const arma::rowvec& weights,
+                      const size_t minimumLeafSize,
+                      const double minimumGainSplit,
+                      FitnessFunction& fitnessFunction,
+                      const PresortedIndices& presorted);
+
+  //! This overload is never called, since the dimensions are only presorted
+  //! if the numeric split supports it.
+  template<bool UseWeights, typename MatType, typename ResponsesType,
+           typename SplitType = NumericSplit>
+  typename std::enable_if<!SupportsSortedData<SplitType>::value, double>::type
+  SortedSplitIfBetter(const double /* bestGain */,
+                      const MatType& /* data */,
+                      const size_t /* dimension */,
+                      const size_t /* begin */,
+                      const size_t /* count */,
+                      const ResponsesType& /* responses */,
+                      const arma::rowvec& /* weights */,
+                      const size_t /* minimumLeafSize */,
+                      const double /* minimumGainSplit */,
+                      FitnessFunction& /* fitnessFunction */,
+                      const PresortedIndices& /* presorted */)
+  {
+    return DBL_MAX;
+  }
+
+  //! Whether the dimensions are sorted once at the root when all dimensions
+  //! are numeric.  This is only done if every node considers every dimension,
+  //! since all dimensions have to be kept sorted for the children.
+  static const bool UsePresorting =
+      SupportsSortedData<NumericSplit>::value &&
+      std::is_same<DimensionSelectionType, AllDimensionSelect>::value;
 };
 
 
@@ -793,8 +793,18 @@ double DecisionTreeRegressor<FitnessFunction,
     const double minimumGainSplit,
     const size_t maximumDepth,
     DimensionSelectionType& dimensionSelector,
-    FitnessFunction fitnessFunction)
+    FitnessFunction fitnessFunction,
+    PresortedIndices* presorted)
 {
+  // Sort each dimension once at the root, if the numeric split can use it.
+  if (UsePresorting && presorted == NULL && count > 0 && maximumDepth != 1)
+  {
+    PresortedIndices rootIndices(data, begin, count);
+    return Train<UseWeights>(data, begin, count, responses, weights,
+        minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector,
+        fitnessFunction, &rootIndices);
+  }
+
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
@@ -817,18 +827,26 @@ double DecisionTreeRegressor<FitnessFunction,
     for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
          i = dimensionSelector.Next())
     {
-      const double dimGain = NumericSplitType<FitnessFunction>::template
-          SplitIfBetter<UseWeights>(bestGain,
-                                    data.cols(begin, begin + count - 1).row(i),
-                                    responses.cols(begin, begin + count - 1),
-                                    UseWeights ?
-                                        weights.cols(begin, begin + count - 1) :
-                                        weights,
-                                    minimumLeafSize,
-                                    minimumGainSplit,
-                                    splitPointOrPrediction,
-                                    *this,
-                                    fitnessFunction);
+      double dimGain;
+      if (presorted != NULL)
+      {
+        dimGain = SortedSplitIfBetter<UseWeights>(bestGain, data, i, begin,
+            count, responses, weights, minimumLeafSize, minimumGainSplit,
+            fitnessFunction, *presorted);
+      }
+      else
+      {
+        dimGain = NumericSplitType<FitnessFunction>::template
+            SplitIfBetter<UseWeights>(bestGain,
+                data.cols(begin, begin + count - 1).row(i),
+                responses.cols(begin, begin + count - 1),
+                UseWeights ? weights.cols(begin, begin + count - 1) : weights,
+                minimumLeafSize,
+                minimumGainSplit,
+                splitPointOrPrediction,
+                *this,
+                fitnessFunction);
+      }
 
       // If the splitter did not report that it improved, then move to the next
       // dimension.
@@ -874,11 +892,23 @@ double DecisionTreeRegressor<FitnessFunction,
       bestGain = 0.0;
     }
 
+    // If the dimensions are presorted, remember the child of each column and
+    // where each column is moved to, so the sorted order of the children can
+    // be computed.
+    arma::Row<size_t> originalAssignments, columns;
+    if (presorted != NULL)
+    {
+      originalAssignments = childAssignments;
+      columns = arma::regspace<arma::Row<size_t>>(0, count - 1);
+    }
+
+    // Move the points of each child next to each other.
+    arma::Row<size_t> childBegins(numChildren);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = childBegins[i]; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
@@ -887,26 +917,39 @@ double DecisionTreeRegressor<FitnessFunction,
           responses.swap_cols(currentCol, j);
           if (UseWeights)
             weights.swap_cols(currentCol, j);
+          if (presorted != NULL)
+            columns.swap_cols(currentCol - begin, j - begin);
           ++currentCol;
         }
       }
+    }
 
+    if (presorted != NULL)
+    {
+      arma::Row<size_t> newColumns(count);
+      for (size_t j = 0; j < count; ++j)
+        newColumns[columns[j]] = begin + j;
+      presorted->Partition(begin, count, originalAssignments, childCounts,
+          newColumns);
+    }
+
+    for (size_t i = 0; i < numChildren; ++i)
+    {
       // Now build the child recursively.
       DecisionTreeRegressor* child = new DecisionTreeRegressor();
       if (NoRecursion)
       {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, responses, weights,
-            currentCol - currentChildBegin, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
+        child->Train<UseWeights>(data, childBegins[i], childCounts[i],
+            responses, weights, childCounts[i], minimumGainSplit,
+            maximumDepth - 1, dimensionSelector, FitnessFunction(), presorted);
       }
       else
       {
         // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, responses, weights,
-            minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
+        double childGain = child->Train<UseWeights>(data, childBegins[i],
+            childCounts[i], responses, weights, minimumLeafSize,
+            minimumGainSplit, maximumDepth - 1, dimensionSelector,
+            FitnessFunction(), presorted);
         bestGain += double(childCounts[i]) / double(count) * (-childGain);
       }
       children.push_back(child);
@@ -927,6 +970,45 @@ double DecisionTreeRegressor<FitnessFunction,
   return -bestGain;
 }
 
+//! Find the best split of a dimension, using the presorted order.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType, typename ResponsesType,
+         typename SplitType>
+typename std::enable_if<SupportsSortedData<SplitType>::value, double>::type
+DecisionTreeRegressor<FitnessFunction,
+                      NumericSplitType,
+                      CategoricalSplitType,
+                      DimensionSelectionType,
+                      NoRecursion>::SortedSplitIfBetter(
+    const double bestGain,
+    const MatType& data,
+    const size_t dimension,
+    const size_t begin,
+    const size_t count,
+    const ResponsesType& responses,
+    const arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    FitnessFunction& fitnessFunction,
+    const PresortedIndices& presorted)
+{
+  arma::Row<typename MatType::elem_type> sortedData;
+  arma::Row<typename ResponsesType::elem_type> sortedResponses;
+  arma::rowvec sortedWeights;
+  presorted.Gather(data.row(dimension), dimension, begin, count, sortedData);
+  presorted.Gather(responses, dimension, begin, count, sortedResponses);
+  if (UseWeights)
+    presorted.Gather(weights, dimension, begin, count, sortedWeights);
+
+  return SplitType::template SplitIfBetterSorted<UseWeights>(bestGain,
+      sortedData, sortedResponses, sortedWeights, minimumLeafSize,
+      minimumGainSplit, splitPointOrPrediction, *this, fitnessFunction);
+}
+
 //! Return the prediction.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
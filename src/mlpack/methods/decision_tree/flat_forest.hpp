@@ -0,0 +1,291 @@
+/**
+ * @file methods/decision_tree/flat_forest.hpp
+ *
+ * Definition of the FlatForest class, which holds trained decision trees in
+ * flat node arrays for fast classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_FLAT_FOREST_HPP
+#define MLPACK_METHODS_DECISION_TREE_FLAT_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/map_policies/datatype.hpp>
+#include "best_binary_numeric_split.hpp"
+#include "random_binary_numeric_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * IsThresholdSplit<SplitType>::value is true if the numeric split type sends
+ * a point to the first of two children when its value is at most the split
+ * information, so that its nodes can be stored as thresholds in a FlatForest.
+ */
+template<typename SplitType>
+struct IsThresholdSplit
+{
+  static const bool value = false;
+};
+
+//! BestBinaryNumericSplit splits on a threshold.
+template<typename FitnessFunction>
+struct IsThresholdSplit<BestBinaryNumericSplit<FitnessFunction>>
+{
+  static const bool value = true;
+};
+
+//! RandomBinaryNumericSplit splits on a threshold.
+template<typename FitnessFunction>
+struct IsThresholdSplit<RandomBinaryNumericSplit<FitnessFunction>>
+{
+  static const bool value = true;
+};
+
+/**
+ * The FlatForest class holds one or more trained DecisionTrees (for instance
+ * the trees of a RandomForest) in a form that is only meant for
+ * classification.  The nodes of all the trees are stored in flat arrays (the
+ * split dimension, the threshold and the first child of each node), with the
+ * children of each node next to each other, and the class probabilities of
+ * the leaves are stored one after the other.  Classifying a point then reads
+ * a few contiguous arrays instead of following the pointers between the nodes
+ * of a DecisionTree.
+ *
+ * Sets of points are classified in blocks: each tree is walked by all the
+ * points of a block at once, one level at a time, so that the memory accesses
+ * of the different points do not wait for each other.
+ *
+ * If every tree has only numeric splits and at most 64 leaves, sets of points
+ * are instead classified with the QuickScorer algorithm, described in the
+ * paper below.  The leaves of each tree are numbered from left to right, and
+ * each node is given a bitmask of the leaves that are not in its left
+ * subtree.  For each dimension, the nodes of all the trees are sorted by
+ * threshold.  To classify a point, the nodes whose thresholds are smaller
+ * than the value of the point (the nodes that send it to the right) are
+ * found by a scan of each dimension, and their masks are applied to a
+ * bitvector of their tree; the leaf of the point in each tree is then the
+ * first leaf whose bit is still set.  No branch depends on the path of the
+ * point through a tree, which makes this fast for shallow trees.  (Points
+ * with NaN values must not be classified this way.)
+ *
+ * In both cases the predictions and probabilities are those of the original
+ * DecisionTree or RandomForest: the probabilities of the trees are averaged,
+ * and the prediction is the class with the highest probability.
+ *
+ * @code
+ * @inproceedings{lucchese2015quickscorer,
+ *   title={QuickScorer: A Fast Algorithm to Rank Documents with Additive
+ *       Ensembles of Regression Trees},
+ *   author={Lucchese, Claudio and Nardini, Franco Maria and Orlando, Salvatore
+ *       and Perego, Raffaele and Tonellotto, Nicola and Venturini, Rossano},
+ *   booktitle={Proceedings of the 38th International ACM SIGIR Conference on
+ *       Research and Development in Information Retrieval},
+ *   pages={73--82},
+ *   year={2015}
+ * }
+ * @endcode
+ */
+class FlatForest
+{
+ public:
+  //! Create an empty forest.
+  FlatForest() :
+      numClasses(0),
+      dimensionality(0),
+      quickScorerAvailable(false),
+      useQuickScorer(true)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Create a forest holding the given tree.
+   *
+   * @param tree Trained DecisionTree.
+   */
+  template<typename TreeType>
+  explicit FlatForest(const TreeType& tree);
+
+  /**
+   * Add the given tree to the forest.  Its numeric split must split on a
+   * threshold (see IsThresholdSplit), and its categorical split must be
+   * AllCategoricalSplit.
+   *
+   * @param tree Trained DecisionTree.
+   */
+  template<typename TreeType>
+  void Add(const TreeType& tree);
+
+  //! Remove all the trees of the forest.
+  void Clear();
+
+  /**
+   * Classify the given point.  The predicted class is returned.
+   *
+   * @param point Point to classify.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Classify the given point and also return the probability of each class.
+   *
+   * @param point Point to classify.
+   * @param prediction This will be set to the predicted class of the point.
+   * @param probabilities This will be filled with the class probabilities of
+   *      the point.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Classify the given points.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with the predictions of the points.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Classify the given points and also return the probability of each class.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with the predictions of the points.
+   * @param probabilities This will be filled with the class probabilities of
+   *      each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of trees.
+  size_t NumTrees() const { return roots.size(); }
+  //! Get the number of nodes of all the trees.
+  size_t NumNodes() const { return children.size(); }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+  //! Get whether the trees are small enough to be evaluated with QuickScorer.
+  bool QuickScorerAvailable() const { return quickScorerAvailable; }
+  //! Get whether sets of points are classified with QuickScorer when it is
+  //! available.
+  bool UseQuickScorer() const { return useQuickScorer; }
+  //! Modify whether sets of points are classified with QuickScorer when it is
+  //! available.
+  bool& UseQuickScorer() { return useQuickScorer; }
+
+  //! Serialize the forest.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Store the given node of a tree (and its descendants) at the given index.
+  template<typename TreeType>
+  void AddNode(const TreeType& node, const size_t index);
+
+  //! Compute the QuickScorer tables, if every tree allows it.
+  void BuildQuickScorer();
+
+  /**
+   * Set the bitmask of each node in the subtree of the given node, and return
+   * the range [first, last) of the (tree-relative) indices of its leaves.
+   */
+  std::pair<size_t, size_t> BuildMasks(const size_t node,
+                                       const size_t firstLeaf,
+                                       std::vector<uint64_t>& masks) const;
+
+  //! Get the child of the given node a value goes to.
+  size_t Child(const size_t node, const double value) const
+  {
+    if (categoricalSplits[node])
+      return children[node] + (size_t) value;
+    else
+      return children[node] + ((value <= thresholds[node]) ? 0 : 1);
+  }
+
+  //! Add the class probabilities of the leaf of the given point in each tree
+  //! to the given column.
+  template<typename VecType>
+  void Accumulate(const VecType& point, double* probabilities) const;
+
+  //! Add the class probabilities of the points [begin, end) to their columns,
+  //! walking each tree with all the points at once.
+  template<typename MatType>
+  void AccumulateBlock(const MatType& data,
+                       const size_t begin,
+                       const size_t end,
+                       arma::mat& probabilities) const;
+
+  //! Add the class probabilities of the points [begin, end) to their columns,
+  //! with QuickScorer.
+  template<typename MatType>
+  void QuickScoreBlock(const MatType& data,
+                       const size_t begin,
+                       const size_t end,
+                       arma::mat& probabilities) const;
+
+  //! Get the index of the lowest set bit of a nonzero value.
+  static size_t LowestSetBit(uint64_t value)
+  {
+    #if defined(__GNUC__)
+      return __builtin_ctzll(value);
+    #else
+      size_t bit = 0;
+      while ((value & 1) == 0)
+      {
+        value >>= 1;
+        ++bit;
+      }
+      return bit;
+    #endif
+  }
+
+  //! The root node of each tree.
+  std::vector<size_t> roots;
+  //! The index of the first leaf of each tree.
+  std::vector<size_t> firstLeaves;
+  //! The split dimension of each node, or the index of the leaf for leaves.
+  std::vector<size_t> dimensions;
+  //! The threshold of each numeric node.
+  std::vector<double> thresholds;
+  //! The first child of each node, or 0 for leaves.
+  std::vector<size_t> children;
+  //! Whether each node splits on a categorical dimension.
+  std::vector<unsigned char> categoricalSplits;
+  //! The class probabilities of each leaf, one leaf after the other.
+  std::vector<double> leafProbabilities;
+  //! The number of classes.
+  size_t numClasses;
+  //! One more than the largest split dimension.
+  size_t dimensionality;
+
+  //! Whether QuickScorer can be used.
+  bool quickScorerAvailable;
+  //! Whether QuickScorer is used when it is available.
+  bool useQuickScorer;
+  //! The nodes of dimension d are in [nodeOffsets[d], nodeOffsets[d + 1]) of
+  //! the three arrays below, sorted by threshold.
+  std::vector<size_t> nodeOffsets;
+  //! The threshold of each node, for QuickScorer.
+  std::vector<double> nodeThresholds;
+  //! The tree of each node, for QuickScorer.
+  std::vector<size_t> nodeTrees;
+  //! The bitmask of each node, for QuickScorer.
+  std::vector<uint64_t> nodeMasks;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_forest_impl.hpp"
+
+#endif
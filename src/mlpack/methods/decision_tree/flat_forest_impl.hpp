@@ -0,0 +1,414 @@
+/**
+ * @file methods/decision_tree/flat_forest_impl.hpp
+ *
+ * Implementation of the FlatForest class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_FLAT_FOREST_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_FLAT_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType>
+FlatForest::FlatForest(const TreeType& tree) :
+    numClasses(0),
+    dimensionality(0),
+    quickScorerAvailable(false),
+    useQuickScorer(true)
+{
+  Add(tree);
+}
+
+template<typename TreeType>
+void FlatForest::Add(const TreeType& tree)
+{
+  static_assert(IsThresholdSplit<typename TreeType::NumericSplit>::value,
+      "FlatForest::Add(): the numeric split of the tree must split on a "
+      "threshold");
+
+  const size_t treeClasses = tree.NumClasses();
+  if (treeClasses == 0)
+  {
+    throw std::invalid_argument("FlatForest::Add(): the tree has no "
+        "classes!");
+  }
+
+  if (roots.size() > 0 && treeClasses != numClasses)
+  {
+    std::ostringstream oss;
+    oss << "FlatForest::Add(): the tree has " << treeClasses << " classes, "
+        << "but the other trees have " << numClasses << " classes!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  numClasses = treeClasses;
+  roots.push_back(children.size());
+  firstLeaves.push_back(leafProbabilities.size() / numClasses);
+
+  children.push_back(0);
+  dimensions.push_back(0);
+  thresholds.push_back(0.0);
+  categoricalSplits.push_back(0);
+  AddNode(tree, roots.back());
+
+  BuildQuickScorer();
+}
+
+inline void FlatForest::Clear()
+{
+  roots.clear();
+  firstLeaves.clear();
+  dimensions.clear();
+  thresholds.clear();
+  children.clear();
+  categoricalSplits.clear();
+  leafProbabilities.clear();
+  numClasses = 0;
+  dimensionality = 0;
+
+  BuildQuickScorer();
+}
+
+template<typename TreeType>
+void FlatForest::AddNode(const TreeType& node, const size_t index)
+{
+  if (node.NumChildren() == 0)
+  {
+    // The leaves are numbered in the order they are reached, so the leaves of
+    // each tree are numbered from left to right.
+    const arma::vec& probabilities = node.ClassProbabilities();
+    dimensions[index] = leafProbabilities.size() / numClasses;
+    leafProbabilities.insert(leafProbabilities.end(), probabilities.begin(),
+        probabilities.end());
+    return;
+  }
+
+  const size_t first = children.size();
+  children[index] = first;
+  dimensions[index] = node.SplitDimension();
+  dimensionality = std::max(dimensionality, node.SplitDimension() + 1);
+  if (node.SplitDimensionType() == data::Datatype::categorical)
+    categoricalSplits[index] = 1;
+  else
+    thresholds[index] = node.ClassProbabilities()[0];
+
+  // The children of the node are next to each other.
+  const size_t newSize = first + node.NumChildren();
+  children.resize(newSize, 0);
+  dimensions.resize(newSize, 0);
+  thresholds.resize(newSize, 0.0);
+  categoricalSplits.resize(newSize, 0);
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    AddNode(node.Child(i), first + i);
+}
+
+inline void FlatForest::BuildQuickScorer()
+{
+  quickScorerAvailable = false;
+  nodeOffsets.clear();
+  nodeThresholds.clear();
+  nodeTrees.clear();
+  nodeMasks.clear();
+
+  if (roots.size() == 0)
+    return;
+
+  // Each tree must have at most 64 leaves, and only numeric splits.
+  const size_t numLeaves = leafProbabilities.size() / numClasses;
+  for (size_t t = 0; t < roots.size(); ++t)
+  {
+    const size_t treeLeaves = ((t + 1 < roots.size()) ? firstLeaves[t + 1] :
+        numLeaves) - firstLeaves[t];
+    if (treeLeaves > 64)
+      return;
+  }
+
+  for (size_t i = 0; i < categoricalSplits.size(); ++i)
+  {
+    if (categoricalSplits[i])
+      return;
+  }
+
+  // The nodes of each tree are contiguous.
+  std::vector<uint64_t> masks(children.size(), ~uint64_t(0));
+  std::vector<size_t> trees(children.size());
+  std::vector<size_t> splitNodes;
+  for (size_t t = 0; t < roots.size(); ++t)
+  {
+    BuildMasks(roots[t], firstLeaves[t], masks);
+
+    const size_t end = (t + 1 < roots.size()) ? roots[t + 1] : children.size();
+    for (size_t i = roots[t]; i < end; ++i)
+    {
+      trees[i] = t;
+      if (children[i] != 0)
+        splitNodes.push_back(i);
+    }
+  }
+
+  // Sort the nodes by dimension, then by threshold.  The order of nodes with
+  // the same threshold does not matter, since they are always applied
+  // together.
+  std::sort(splitNodes.begin(), splitNodes.end(),
+      [this](const size_t a, const size_t b)
+      {
+        if (dimensions[a] != dimensions[b])
+          return dimensions[a] < dimensions[b];
+        if (thresholds[a] != thresholds[b])
+          return thresholds[a] < thresholds[b];
+        return a < b;
+      });
+
+  nodeOffsets.assign(dimensionality + 1, 0);
+  nodeThresholds.resize(splitNodes.size());
+  nodeTrees.resize(splitNodes.size());
+  nodeMasks.resize(splitNodes.size());
+  for (size_t i = 0; i < splitNodes.size(); ++i)
+  {
+    const size_t node = splitNodes[i];
+    ++nodeOffsets[dimensions[node] + 1];
+    nodeThresholds[i] = thresholds[node];
+    nodeTrees[i] = trees[node];
+    nodeMasks[i] = masks[node];
+  }
+
+  for (size_t d = 0; d < dimensionality; ++d)
+    nodeOffsets[d + 1] += nodeOffsets[d];
+
+  quickScorerAvailable = true;
+}
+
+inline std::pair<size_t, size_t> FlatForest::BuildMasks(
+    const size_t node,
+    const size_t firstLeaf,
+    std::vector<uint64_t>& masks) const
+{
+  if (children[node] == 0)
+  {
+    const size_t leaf = dimensions[node] - firstLeaf;
+    return std::make_pair(leaf, leaf + 1);
+  }
+
+  const std::pair<size_t, size_t> left = BuildMasks(children[node], firstLeaf,
+      masks);
+  const std::pair<size_t, size_t> right = BuildMasks(children[node] + 1,
+      firstLeaf, masks);
+
+  // A point that goes right can not reach any leaf of the left subtree.
+  const size_t leftLeaves = left.second - left.first;
+  const uint64_t leftBits = (leftLeaves == 64) ? ~uint64_t(0) :
+      ((uint64_t(1) << leftLeaves) - 1) << left.first;
+  masks[node] = ~leftBits;
+
+  return std::make_pair(left.first, right.second);
+}
+
+template<typename VecType>
+size_t FlatForest::Classify(const VecType& point) const
+{
+  // Pass off to another Classify() overload.
+  size_t prediction;
+  arma::vec probabilities;
+  Classify(point, prediction, probabilities);
+
+  return prediction;
+}
+
+template<typename VecType>
+void FlatForest::Classify(const VecType& point,
+                          size_t& prediction,
+                          arma::vec& probabilities) const
+{
+  if (roots.size() == 0)
+  {
+    probabilities.clear();
+    prediction = 0;
+    throw std::invalid_argument("FlatForest::Classify(): the forest has no "
+        "trees!");
+  }
+
+  probabilities.zeros(numClasses);
+  Accumulate(point, probabilities.memptr());
+
+  // Find maximum element after renormalizing probabilities.
+  probabilities /= roots.size();
+  arma::uword maxIndex = 0;
+  probabilities.max(maxIndex);
+  prediction = (size_t) maxIndex;
+}
+
+template<typename MatType>
+void FlatForest::Classify(const MatType& data,
+                          arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename MatType>
+void FlatForest::Classify(const MatType& data,
+                          arma::Row<size_t>& predictions,
+                          arma::mat& probabilities) const
+{
+  if (roots.size() == 0)
+  {
+    predictions.clear();
+    probabilities.clear();
+    throw std::invalid_argument("FlatForest::Classify(): the forest has no "
+        "trees!");
+  }
+
+  if (data.n_rows < dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "FlatForest::Classify(): the points have " << data.n_rows
+        << " dimensions, but the trees split on dimension "
+        << (dimensionality - 1) << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  probabilities.zeros(numClasses, data.n_cols);
+  predictions.set_size(data.n_cols);
+
+  const size_t blockSize = 64;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+  const bool quickScore = useQuickScorer && quickScorerAvailable;
+
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+    if (quickScore)
+      QuickScoreBlock(data, begin, end, probabilities);
+    else
+      AccumulateBlock(data, begin, end, probabilities);
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      probabilities.col(i) /= roots.size();
+      arma::uword maxIndex = 0;
+      probabilities.col(i).max(maxIndex);
+      predictions[i] = (size_t) maxIndex;
+    }
+  }
+}
+
+template<typename VecType>
+void FlatForest::Accumulate(const VecType& point, double* probabilities) const
+{
+  for (size_t t = 0; t < roots.size(); ++t)
+  {
+    size_t node = roots[t];
+    while (children[node] != 0)
+      node = Child(node, point[dimensions[node]]);
+
+    const double* leaf = &leafProbabilities[dimensions[node] * numClasses];
+    for (size_t c = 0; c < numClasses; ++c)
+      probabilities[c] += leaf[c];
+  }
+}
+
+template<typename MatType>
+void FlatForest::AccumulateBlock(const MatType& data,
+                                 const size_t begin,
+                                 const size_t end,
+                                 arma::mat& probabilities) const
+{
+  std::vector<size_t> nodes(end - begin);
+  for (size_t t = 0; t < roots.size(); ++t)
+  {
+    // Move all the points down one level at a time, until they are all in
+    // leaves.
+    std::fill(nodes.begin(), nodes.end(), roots[t]);
+    bool moved = true;
+    while (moved)
+    {
+      moved = false;
+      for (size_t j = 0; j < nodes.size(); ++j)
+      {
+        const size_t node = nodes[j];
+        if (children[node] != 0)
+        {
+          nodes[j] = Child(node, data(dimensions[node], begin + j));
+          moved = true;
+        }
+      }
+    }
+
+    for (size_t j = 0; j < nodes.size(); ++j)
+    {
+      const double* leaf = &leafProbabilities[dimensions[nodes[j]] *
+          numClasses];
+      double* pointProbabilities = probabilities.colptr(begin + j);
+      for (size_t c = 0; c < numClasses; ++c)
+        pointProbabilities[c] += leaf[c];
+    }
+  }
+}
+
+template<typename MatType>
+void FlatForest::QuickScoreBlock(const MatType& data,
+                                 const size_t begin,
+                                 const size_t end,
+                                 arma::mat& probabilities) const
+{
+  std::vector<uint64_t> leaves(roots.size());
+  for (size_t i = begin; i < end; ++i)
+  {
+    // Remove the leaves that the point can not reach from the bitvector of
+    // each tree.  The nodes with a threshold smaller than the value of the
+    // point send it to the right.
+    std::fill(leaves.begin(), leaves.end(), ~uint64_t(0));
+    for (size_t d = 0; d < dimensionality; ++d)
+    {
+      const double value = data(d, i);
+      for (size_t j = nodeOffsets[d];
+           j < nodeOffsets[d + 1] && nodeThresholds[j] < value; ++j)
+      {
+        leaves[nodeTrees[j]] &= nodeMasks[j];
+      }
+    }
+
+    double* pointProbabilities = probabilities.colptr(i);
+    for (size_t t = 0; t < roots.size(); ++t)
+    {
+      const size_t leaf = firstLeaves[t] + LowestSetBit(leaves[t]);
+      const double* leafValues = &leafProbabilities[leaf * numClasses];
+      for (size_t c = 0; c < numClasses; ++c)
+        pointProbabilities[c] += leafValues[c];
+    }
+  }
+}
+
+template<typename Archive>
+void FlatForest::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(roots));
+  ar(CEREAL_NVP(firstLeaves));
+  ar(CEREAL_NVP(dimensions));
+  ar(CEREAL_NVP(thresholds));
+  ar(CEREAL_NVP(children));
+  ar(CEREAL_NVP(categoricalSplits));
+  ar(CEREAL_NVP(leafProbabilities));
+  ar(CEREAL_NVP(numClasses));
+  ar(CEREAL_NVP(dimensionality));
+  ar(CEREAL_NVP(useQuickScorer));
+
+  // The QuickScorer tables are not saved, since they can be recomputed.
+  if (cereal::is_loading<Archive>())
+    BuildQuickScorer();
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
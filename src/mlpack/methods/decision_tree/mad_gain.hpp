@@ -122,6 +122,165 @@ class MADGain
       return sum / responses.n_elem;
     }
   }
+
+  /**
+   * Calculates the mean absolute deviation gain for the left and right
+   * children for the current index.
+   *
+   * The absolute deviation of a child around its mean m can be written with
+   * the total weight W_< and weighted sum S_< of the values of the child that
+   * are at most m, and the total weight W and weighted sum S of the child:
+   *
+   * @f{eqnarray*}{
+   *   MAD = \dfrac{(m W_< - S_<) + ((S - S_<) - m (W - W_<))}{W}
+   * @f}
+   *
+   * W_< and S_< are queried from binary indexed (Fenwick) trees over the
+   * ranks of the responses, so each gain takes O(log n) time instead of a pass
+   * over the child.
+   */
+  std::tuple<double, double> BinaryGains()
+  {
+    double madLeft = 0.0;
+    double madRight = 0.0;
+
+    if (leftSize > 1e-9)
+    {
+      const double mean = leftSum / leftSize;
+      const size_t rank = Rank(mean);
+      double belowSize, belowSum;
+      Prefix(rank, belowSize, belowSum);
+      madLeft = ((mean * belowSize - belowSum) +
+          ((leftSum - belowSum) - mean * (leftSize - belowSize))) / leftSize;
+    }
+
+    const double rightSize = totalSize - leftSize;
+    const double rightSum = totalSum - leftSum;
+    if (rightSize > 1e-9)
+    {
+      const double mean = rightSum / rightSize;
+      const size_t rank = Rank(mean);
+      double leftBelowSize, leftBelowSum;
+      Prefix(rank, leftBelowSize, leftBelowSum);
+      const double belowSize = totalPrefixSizes[rank] - leftBelowSize;
+      const double belowSum = totalPrefixSums[rank] - leftBelowSum;
+      madRight = ((mean * belowSize - belowSum) +
+          ((rightSum - belowSum) - mean * (rightSize - belowSize))) /
+          rightSize;
+    }
+
+    return std::make_tuple(-madLeft, -madRight);
+  }
+
+  /**
+   * Ranks the responses and caches their prefix sums in sorted order, so that
+   * the gain of each split can be computed efficiently.  The first minimum - 1
+   * responses are put in the left child.
+   *
+   * @param responses The set of responses on which statistics are computed.
+   * @param weights The set of weights associated to each response.
+   * @param minimum The minimum number of elements in a leaf.
+   */
+  template<bool UseWeights, typename ResponsesType, typename WeightVecType>
+  void BinaryScanInitialize(const ResponsesType& responses,
+                            const WeightVecType& weights,
+                            const size_t minimum)
+  {
+    const size_t n = responses.n_elem;
+    const arma::uvec order = arma::sort_index(responses);
+
+    sortedResponses.set_size(n);
+    ranks.set_size(n);
+    totalPrefixSizes.zeros(n + 1);
+    totalPrefixSums.zeros(n + 1);
+    for (size_t i = 0; i < n; ++i)
+    {
+      const double w = UseWeights ? (double) weights[order[i]] : 1.0;
+      const double x = responses[order[i]];
+
+      sortedResponses[i] = x;
+      ranks[order[i]] = i;
+      totalPrefixSizes[i + 1] = totalPrefixSizes[i] + w;
+      totalPrefixSums[i + 1] = totalPrefixSums[i] + w * x;
+    }
+
+    totalSize = totalPrefixSizes[n];
+    totalSum = totalPrefixSums[n];
+
+    // The left child starts empty.
+    leftSizes.zeros(n + 1);
+    leftSums.zeros(n + 1);
+    leftSize = 0.0;
+    leftSum = 0.0;
+    for (size_t i = 0; i < minimum - 1; ++i)
+      BinaryStep<UseWeights>(responses, weights, i);
+  }
+
+  /**
+   * Moves the response at the given index to the left child.
+   *
+   * @param responses The set of responses on which statistics are computed.
+   * @param weights The set of weights associated to each response.
+   * @param index The current index.
+   */
+  template<bool UseWeights, typename ResponsesType, typename WeightVecType>
+  void BinaryStep(const ResponsesType& responses,
+                  const WeightVecType& weights,
+                  const size_t index)
+  {
+    const double w = UseWeights ? (double) weights[index] : 1.0;
+    const double x = responses[index];
+
+    leftSize += w;
+    leftSum += w * x;
+
+    // Update the Fenwick trees (which are indexed from 1).
+    for (size_t i = ranks[index] + 1; i < leftSizes.n_elem; i += (i & (~i + 1)))
+    {
+      leftSizes[i] += w;
+      leftSums[i] += w * x;
+    }
+  }
+
+ private:
+  //! Get the number of sorted responses that are at most the given value.
+  size_t Rank(const double value) const
+  {
+    return std::upper_bound(sortedResponses.begin(), sortedResponses.end(),
+        value) - sortedResponses.begin();
+  }
+
+  //! Get the total weight and weighted sum of the responses of the left child
+  //! whose ranks are below the given rank.
+  void Prefix(size_t rank, double& size, double& sum) const
+  {
+    size = 0.0;
+    sum = 0.0;
+    for (; rank > 0; rank -= (rank & (~rank + 1)))
+    {
+      size += leftSizes[rank];
+      sum += leftSums[rank];
+    }
+  }
+
+  // The responses of the node, in sorted order.
+  arma::vec sortedResponses;
+  // The rank of each response in sorted order.
+  arma::uvec ranks;
+  // The total weight and weighted sum of the responses of ranks below each
+  // rank (for all the points of the node).
+  arma::vec totalPrefixSizes;
+  arma::vec totalPrefixSums;
+  // The total weight and weighted sum of the node.
+  double totalSize;
+  double totalSum;
+  // Fenwick trees of the weights and weighted responses of the left child,
+  // indexed by rank.
+  arma::vec leftSizes;
+  arma::vec leftSums;
+  // The total weight and weighted sum of the left child.
+  double leftSize;
+  double leftSum;
 };
 
 } // namespace tree
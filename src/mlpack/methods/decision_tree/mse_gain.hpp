@@ -120,28 +120,43 @@ class MSEGain
   }
 
   /**
-   * Calculates the  mean squared error gain for the left and right children
-   * for the current index.
+   * Calculates the mean squared error gain for the left and right children
+   * for the current index, from the cached sums of the left child and of the
+   * whole node.
    *
    * X = array of values of size n.
    *
    * @f{eqnarray*}{
-   *   MSE = \sum\limits_{i=1}^n {X_i}^2 -
+   *   MSE = \dfrac{\sum\limits_{i=1}^n {X_i}^2}{n} -
    *       {\dfrac{\sum\limits_{j=1}^n X_j}{n}}^2
    * @f}
    */
   std::tuple<double, double> BinaryGains()
   {
-    double mseLeft = leftSumSquares / leftSize - leftMean * leftMean;
-    double mseRight = (totalSumSquares - leftSumSquares) / rightSize
-          - rightMean * rightMean;
+    double mseLeft = 0.0;
+    double mseRight = 0.0;
+
+    if (leftSize > 1e-9)
+    {
+      const double leftMean = leftSum / leftSize;
+      mseLeft = leftSumSquares / leftSize - leftMean * leftMean;
+    }
+
+    const double rightSize = totalSize - leftSize;
+    if (rightSize > 1e-9)
+    {
+      const double rightMean = (totalSum - leftSum) / rightSize;
+      mseRight = (totalSumSquares - leftSumSquares) / rightSize -
+          rightMean * rightMean;
+    }
 
     return std::make_tuple(-mseLeft, -mseRight);
   }
 
   /**
-   * Caches the prefix sum of squares to efficiently compute gain value for
-   * each split. It also computes the initial mean for left and right child.
+   * Caches the sums of the whole node, and the prefix sums of the first
+   * minimum - 1 responses (which start in the left child), to efficiently
+   * compute the gain value for each split.
    *
    * @param responses The set of responses on which statistics are computed.
    * @param weights The set of weights associated to each response.
@@ -152,75 +167,28 @@ class MSEGain
                             const WeightVecType& weights,
                             const size_t minimum)
   {
-    typedef typename ResponsesType::elem_type RType;
-    typedef typename WeightVecType::elem_type WType;
-
-    // Initializing data members to cache statistics.
-    leftMean = 0.0;
-    rightMean = 0.0;
-    leftSize = 0.0;
-    rightSize = 0.0;
-    leftSumSquares = 0.0;
-    totalSumSquares = 0.0;
-
     if (UseWeights)
     {
+      totalSize = arma::accu(weights);
+      totalSum = arma::dot(weights, responses);
       totalSumSquares = arma::accu(weights % arma::square(responses));
-      for (size_t i = 0; i < minimum - 1; ++i)
-      {
-        const WType w = weights[i];
-        const RType x = responses[i];
-
-        // Calculating initial weighted mean of responses for the left child.
-        leftSize += w;
-        leftMean += w * x;
-        leftSumSquares += w * x * x;
-      }
-      if (leftSize > 1e-9)
-        leftMean /= leftSize;
-
-      for (size_t i = minimum - 1; i < responses.n_elem; ++i)
-      {
-        const WType w = weights[i];
-        const RType x = responses[i];
-
-        // Calculating initial weighted mean of responses for the right child.
-        rightSize += w;
-        rightMean += w * x;
-      }
-      if (rightSize > 1e-9)
-        rightMean /= rightSize;
     }
     else
     {
+      totalSize = responses.n_elem;
+      totalSum = arma::accu(responses);
       totalSumSquares = arma::accu(arma::square(responses));
-      for (size_t i = 0; i < minimum - 1; ++i)
-      {
-        const RType x = responses[i];
-
-        // Calculating the initial mean of responses for the left child.
-        ++leftSize;
-        leftMean += x;
-        leftSumSquares += x * x;
-      }
-      if (leftSize > 1e-9)
-        leftMean /= leftSize;
-
-      for (size_t i = minimum - 1; i < responses.n_elem; ++i)
-      {
-        const RType x = responses[i];
-
-        // Calculating the initial mean of responses for the right child.
-        ++rightSize;
-        rightMean += x;
-      }
-      if (rightSize > 1e-9)
-        rightMean /= rightSize;
     }
+
+    leftSize = 0.0;
+    leftSum = 0.0;
+    leftSumSquares = 0.0;
+    for (size_t i = 0; i < minimum - 1; ++i)
+      BinaryStep<UseWeights>(responses, weights, i);
   }
 
   /**
-   * Updates the statistics for the given index.
+   * Moves the response at the given index to the left child.
    *
    * @param responses The set of responses on which statistics are computed.
    * @param weights The set of weights associated to each response.
@@ -231,56 +199,31 @@ class MSEGain
                   const WeightVecType& weights,
                   const size_t index)
   {
-    typedef typename ResponsesType::elem_type RType;
-    typedef typename WeightVecType::elem_type WType;
-
-    if (UseWeights)
-    {
-      const WType w = weights[index];
-      const RType x = responses[index];
-
-      // Update weighted sum of squares for left child.
-      leftSumSquares += w * x * x;
-
-      // Update weighted mean for both childs.
-      leftMean = (leftMean * leftSize + w * x) / (leftSize + w);
-      leftSize += w;
-
-      rightMean = (rightMean * rightSize - w * x) / (rightSize - w);
-      rightSize -= w;
-    }
-    else
-    {
-      const RType x = responses[index];
-
-      // Update sum of squares for left child.
-      leftSumSquares += x * x;
+    const double w = UseWeights ? (double) weights[index] : 1.0;
+    const double x = responses[index];
 
-      // Update mean for both childs.
-      leftMean = (leftMean * leftSize + x) / (leftSize + 1);
-      ++leftSize;
-
-      rightMean = (rightMean * rightSize - x) / (rightSize - 1);
-      --rightSize;
-    }
+    leftSize += w;
+    leftSum += w * x;
+    leftSumSquares += w * x * x;
   }
 
  private:
   /**
    * The following data members cache statistics for weighted data when
-   * `UseWeights` is true, else it will calculate unweighted statistics.
+   * `UseWeights` is true, else it will calculate unweighted statistics.  The
+   * statistics of the right child are those of the node minus those of the
+   * left child.
    */
-  // Stores the sum of squares / weighted sum of squares for the left child.
-  double leftSumSquares;
-  // For unweighted data, stores the number of elements in each child.
-  // For weighted data, stores the sum of weights of elements in each
-  // child.
+  // For unweighted data, stores the number of elements of the left child and
+  // of the node.  For weighted data, stores the sum of their weights.
   double leftSize;
-  double rightSize;
-  // Stores the mean / weighted mean.
-  double leftMean;
-  double rightMean;
-  // Stores the total sum of squares / total weighted sum of squares.
+  double totalSize;
+  // Stores the sum / weighted sum of the left child and of the node.
+  double leftSum;
+  double totalSum;
+  // Stores the sum of squares / weighted sum of squares of the left child and
+  // of the node.
+  double leftSumSquares;
   double totalSumSquares;
 };
 
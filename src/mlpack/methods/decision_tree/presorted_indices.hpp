@@ -0,0 +1,195 @@
+/**
+ * @file methods/decision_tree/presorted_indices.hpp
+ *
+ * Definition of the PresortedIndices class, which holds the order of the
+ * points of each node of a decision tree along each dimension, so that each
+ * dimension only has to be sorted once while the tree is built.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_PRESORTED_INDICES_HPP
+#define MLPACK_METHODS_DECISION_TREE_PRESORTED_INDICES_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The decision trees keep the points of each node in the contiguous positions
+ * [begin, begin + count), either columns of their copy of the dataset or
+ * entries of an array of column indices into a shared dataset.  For each
+ * dimension d, Indices()(d, begin) to Indices()(d, begin + count - 1) are
+ * these positions, sorted by the value of dimension d.  The columns are sorted once at the
+ * root; when a node is split, the sorted columns of each dimension are
+ * partitioned stably into those of the children (as in SLIQ), which keeps them
+ * sorted.  So the split search of a node takes time linear in the number of
+ * points of the node, instead of the O(n log n) time of sorting them.
+ *
+ * @code
+ * @inproceedings{mehta1996sliq,
+ *   title={SLIQ: A Fast Scalable Classifier for Data Mining},
+ *   author={Mehta, Manish and Agrawal, Rakesh and Rissanen, Jorma},
+ *   booktitle={International Conference on Extending Database Technology},
+ *   pages={18--32},
+ *   year={1996}
+ * }
+ * @endcode
+ */
+class PresortedIndices
+{
+ public:
+  /**
+   * Sort the columns [begin, begin + count) of the given dataset along each
+   * dimension.
+   *
+   * @param data The dataset.
+   * @param begin The first column to sort.
+   * @param count The number of columns to sort.
+   */
+  template<typename MatType>
+  PresortedIndices(const MatType& data, const size_t begin, const size_t count)
+  {
+    indices.set_size(data.n_rows, data.n_cols);
+    for (size_t d = 0; d < data.n_rows; ++d)
+    {
+      const arma::uvec order = arma::stable_sort_index(
+          data.row(d).cols(begin, begin + count - 1));
+      for (size_t i = 0; i < count; ++i)
+        indices(d, begin + i) = begin + order[i];
+    }
+  }
+
+  /**
+   * Sort the points points[begin, begin + count) of the given dataset along
+   * each dimension, where points holds column indices into the dataset.
+   *
+   * @param data The dataset.
+   * @param points The column of the dataset at each position.
+   * @param begin The first position to sort.
+   * @param count The number of positions to sort.
+   */
+  template<typename MatType>
+  PresortedIndices(const MatType& data,
+                   const arma::Row<size_t>& points,
+                   const size_t begin,
+                   const size_t count)
+  {
+    indices.set_size(data.n_rows, points.n_elem);
+    arma::Row<typename MatType::elem_type> values(count);
+    for (size_t d = 0; d < data.n_rows; ++d)
+    {
+      for (size_t i = 0; i < count; ++i)
+        values[i] = data(d, points[begin + i]);
+
+      const arma::uvec order = arma::stable_sort_index(values);
+      for (size_t i = 0; i < count; ++i)
+        indices(d, begin + i) = begin + order[i];
+    }
+  }
+
+  /**
+   * Gather the elements of the given row for the columns of a node, in the
+   * order of the given dimension.
+   *
+   * @param row The row to gather the elements of (a row of the dataset, the
+   *     labels or responses, or the weights).
+   * @param dimension The dimension whose order is used.
+   * @param begin The first column of the node.
+   * @param count The number of columns of the node.
+   * @param sorted Row to store the gathered elements in.
+   */
+  template<typename RowType, typename SortedRowType>
+  void Gather(const RowType& row,
+              const size_t dimension,
+              const size_t begin,
+              const size_t count,
+              SortedRowType& sorted) const
+  {
+    sorted.set_size(count);
+    for (size_t i = 0; i < count; ++i)
+      sorted[i] = row[indices(dimension, begin + i)];
+  }
+
+  /**
+   * Gather the values of the given dimension of the dataset for the positions
+   * of a node, in sorted order, where points holds the column of the dataset
+   * at each position.
+   *
+   * @param data The dataset.
+   * @param points The column of the dataset at each position.
+   * @param dimension The dimension to gather.
+   * @param begin The first position of the node.
+   * @param count The number of positions of the node.
+   * @param sorted Row to store the gathered values in.
+   */
+  template<typename MatType, typename SortedRowType>
+  void GatherData(const MatType& data,
+                  const arma::Row<size_t>& points,
+                  const size_t dimension,
+                  const size_t begin,
+                  const size_t count,
+                  SortedRowType& sorted) const
+  {
+    sorted.set_size(count);
+    for (size_t i = 0; i < count; ++i)
+      sorted[i] = data(dimension, points[indices(dimension, begin + i)]);
+  }
+
+  /**
+   * Partition the sorted columns of a node into those of its children, after
+   * the columns of the node have been permuted so that the points of each
+   * child are contiguous, in order.
+   *
+   * @param begin The first column of the node.
+   * @param count The number of columns of the node.
+   * @param assignments The child of each column of the node, before the
+   *     permutation.
+   * @param childCounts The number of points of each child.
+   * @param newColumns The column of each point after the permutation, indexed
+   *     by its column before the permutation (minus begin).
+   */
+  void Partition(const size_t begin,
+                 const size_t count,
+                 const arma::Row<size_t>& assignments,
+                 const arma::Row<size_t>& childCounts,
+                 const arma::Row<size_t>& newColumns)
+  {
+    std::vector<size_t> childBegins(childCounts.n_elem);
+    arma::Row<size_t> buffer(count);
+    for (size_t d = 0; d < indices.n_rows; ++d)
+    {
+      size_t childBegin = 0;
+      for (size_t c = 0; c < childCounts.n_elem; ++c)
+      {
+        childBegins[c] = childBegin;
+        childBegin += childCounts[c];
+      }
+
+      // Visiting the columns in sorted order keeps each child sorted.
+      for (size_t i = 0; i < count; ++i)
+      {
+        const size_t oldColumn = indices(d, begin + i) - begin;
+        buffer[childBegins[assignments[oldColumn]]++] = newColumns[oldColumn];
+      }
+
+      for (size_t i = 0; i < count; ++i)
+        indices(d, begin + i) = buffer[i];
+    }
+  }
+
+  //! Get the sorted columns of each dimension.
+  const arma::Mat<size_t>& Indices() const { return indices; }
+
+ private:
+  //! The sorted columns of each dimension.
+  arma::Mat<size_t> indices;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_DET_DTREE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/decision_tree/presorted_indices.hpp>
 
 namespace mlpack {
 namespace det /** Density Estimation Trees */ {
@@ -151,6 +152,11 @@ class DTree
    * Greedily expand the tree.  The points in the dataset will be reordered
    * during tree growth.
    *
+   * For dense matrices, each dimension is sorted once, and the sorted order is
+   * partitioned between the children of each split, so finding a split takes
+   * time linear in the number of points of the node.  The subtrees of large
+   * nodes are grown in parallel with OpenMP tasks.
+   *
    * @param data Dataset to build tree on.
    * @param oldFromNew Mappings from old points to new points.
    * @param useVolReg If true, volume regularization is used.
@@ -336,22 +342,39 @@ class DTree
   // Utility methods.
 
   /**
-   * Find the dimension to split on.
+   * Greedily expand the tree, given the sorted order of the points of the node
+   * along each dimension (or NULL, if the points have to be sorted at each
+   * node).
+   */
+  double Grow(MatType& data,
+              arma::Col<size_t>& oldFromNew,
+              const bool useVolReg,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              tree::PresortedIndices* presorted);
+
+  /**
+   * Find the dimension to split on.  If presorted is not NULL, it gives the
+   * sorted order of the points of the node along each dimension.
    */
   bool FindSplit(const MatType& data,
                  size_t& splitDim,
                  ElemType& splitValue,
                  double& leftError,
                  double& rightError,
-                 const size_t minLeafSize = 5) const;
+                 const size_t minLeafSize = 5,
+                 const tree::PresortedIndices* presorted = NULL) const;
 
   /**
-   * Split the data, returning the number of points left of the split.
+   * Split the data, returning the number of points left of the split.  If
+   * newColumns is not NULL, it is filled with the new column of each point of
+   * the node, indexed by its old column (minus the start of the node).
    */
   size_t SplitData(MatType& data,
                    const size_t splitDim,
                    const ElemType splitValue,
-                   arma::Col<size_t>& oldFromNew) const;
+                   arma::Col<size_t>& oldFromNew,
+                   arma::Row<size_t>* newColumns = NULL) const;
 
   void  FillMinMax(const StatType& mins,
                    const StatType& maxs);
@@ -147,6 +147,62 @@ void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
   }
 }
 
+/**
+ * Extract the splits of the given dimension from the values of the points of
+ * the node in sorted order, which are given by the presorted indices, so that
+ * they do not have to be sorted again.
+ */
+template<typename ElemType, typename MatType>
+void ExtractSortedSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
+                         const MatType& data,
+                         const tree::PresortedIndices& presorted,
+                         size_t dim,
+                         const size_t start,
+                         const size_t end,
+                         const size_t minLeafSize)
+{
+  typedef std::pair<ElemType, size_t> SplitItem;
+  const arma::Mat<size_t>& indices = presorted.Indices();
+  arma::Row<ElemType> dimVec(end - start);
+  for (size_t i = start; i < end; ++i)
+    dimVec[i - start] = data(dim, indices(dim, i));
+
+  for (size_t i = minLeafSize - 1; i < dimVec.n_elem - minLeafSize; ++i)
+  {
+    // See the dense implementation of ExtractSplits().
+    const ElemType split = (dimVec[i] + dimVec[i + 1]) / 2.0;
+
+    if (split != dimVec[i])
+      splitVec.push_back(SplitItem(split, i + 1));
+  }
+}
+
+/**
+ * Sort the given columns of a dense matrix along each dimension.
+ */
+template<typename MatType>
+typename std::enable_if<std::is_same<MatType,
+    arma::Mat<typename MatType::elem_type>>::value,
+    tree::PresortedIndices*>::type
+Presort(const MatType& data, const size_t start, const size_t count)
+{
+  return new tree::PresortedIndices(data, start, count);
+}
+
+/**
+ * Other matrices (i.e. sparse matrices) are sorted at each node instead.
+ */
+template<typename MatType>
+typename std::enable_if<!std::is_same<MatType,
+    arma::Mat<typename MatType::elem_type>>::value,
+    tree::PresortedIndices*>::type
+Presort(const MatType& /* data */,
+        const size_t /* start */,
+        const size_t /* count */)
+{
+  return NULL;
+}
+
 } // namespace details
 
 template<typename MatType, typename TagType>
@@ -439,7 +495,9 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
                                         ElemType& splitValue,
                                         double& leftError,
                                         double& rightError,
-                                        const size_t minLeafSize) const
+                                        const size_t minLeafSize,
+                                        const tree::PresortedIndices* presorted)
+    const
 {
   typedef std::pair<ElemType, size_t> SplitItem;
 
@@ -485,11 +543,19 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
     //   dimVec = arma::sort(dimVec);
     // could be quite inefficient for sparse matrices, due to
     // copy operations (3). This one has custom implementation for dense and
-    // sparse matrices.
+    // sparse matrices.  If the points are presorted, no sort is needed at all.
 
     std::vector<SplitItem> splitVec;
-    details::ExtractSplits<ElemType>(splitVec, data, dim, start, end,
-        minLeafSize);
+    if (presorted)
+    {
+      details::ExtractSortedSplits<ElemType>(splitVec, data, *presorted, dim,
+          start, end, minLeafSize);
+    }
+    else
+    {
+      details::ExtractSplits<ElemType>(splitVec, data, dim, start, end,
+          minLeafSize);
+    }
 
     // Iterate on all the splits for this dimension
     for (typename std::vector<SplitItem>::iterator i = splitVec.begin();
@@ -555,8 +621,15 @@ template<typename MatType, typename TagType>
 size_t DTree<MatType, TagType>::SplitData(MatType& data,
                                           const size_t splitDim,
                                           const ElemType splitValue,
-                                          arma::Col<size_t>& oldFromNew) const
+                                          arma::Col<size_t>& oldFromNew,
+                                          arma::Row<size_t>* newColumns) const
 {
+  // The old column (minus start) of the point at each column, if the new
+  // columns are needed.
+  arma::Row<size_t> oldColumns;
+  if (newColumns)
+    oldColumns = arma::regspace<arma::Row<size_t>>(0, end - start - 1);
+
   // Swap all columns such that any columns with value in dimension splitDim
   // less than or equal to splitValue are on the left side, and all others are
   // on the right side.  A similar sort to this is also performed in
@@ -579,6 +652,16 @@ size_t DTree<MatType, TagType>::SplitData(MatType& data,
     const size_t tmp = oldFromNew[left];
     oldFromNew[left] = oldFromNew[right];
     oldFromNew[right] = tmp;
+
+    if (newColumns)
+      oldColumns.swap_cols(left - start, right - start);
+  }
+
+  if (newColumns)
+  {
+    newColumns->set_size(end - start);
+    for (size_t i = start; i < end; ++i)
+      (*newColumns)[oldColumns[i - start]] = i;
   }
 
   // This now refers to the first index of the "right" side.
@@ -592,6 +675,27 @@ double DTree<MatType, TagType>::Grow(MatType& data,
                                      const bool useVolReg,
                                      const size_t maxLeafSize,
                                      const size_t minLeafSize)
+{
+  // Sort the points along each dimension once, if there is anything to split.
+  tree::PresortedIndices* presorted = NULL;
+  if ((size_t) (end - start) > maxLeafSize)
+    presorted = details::Presort(data, start, end - start);
+
+  const double alpha = Grow(data, oldFromNew, useVolReg, maxLeafSize,
+      minLeafSize, presorted);
+
+  delete presorted;
+  return alpha;
+}
+
+// Greedily expand the tree, with the given presorted points.
+template<typename MatType, typename TagType>
+double DTree<MatType, TagType>::Grow(MatType& data,
+                                     arma::Col<size_t>& oldFromNew,
+                                     const bool useVolReg,
+                                     const size_t maxLeafSize,
+                                     const size_t minLeafSize,
+                                     tree::PresortedIndices* presorted)
 {
   Log::Assert(data.n_rows == maxVals.n_elem);
   Log::Assert(data.n_rows == minVals.n_elem);
@@ -614,11 +718,31 @@ double DTree<MatType, TagType>::Grow(MatType& data,
     size_t dim;
     double splitValueTmp;
     double leftError, rightError;
-    if (FindSplit(data, dim, splitValueTmp, leftError, rightError, minLeafSize))
+    if (FindSplit(data, dim, splitValueTmp, leftError, rightError, minLeafSize,
+        presorted))
     {
+      // The side of each point, needed to partition the presorted points.
+      arma::Row<size_t> assignments;
+      arma::Row<size_t> newColumns;
+      if (presorted)
+      {
+        assignments.set_size(end - start);
+        for (size_t i = start; i < end; ++i)
+          assignments[i - start] = (data(dim, i) <= splitValueTmp) ? 0 : 1;
+      }
+
       // Move the data around for the children to have points in a node lie
       // contiguously (to increase efficiency during the training).
-      const size_t splitIndex = SplitData(data, dim, splitValueTmp, oldFromNew);
+      const size_t splitIndex = SplitData(data, dim, splitValueTmp, oldFromNew,
+          presorted ? &newColumns : NULL);
+
+      if (presorted)
+      {
+        const arma::Row<size_t> childCounts = { splitIndex - start,
+                                                end - splitIndex };
+        presorted->Partition(start, end - start, assignments, childCounts,
+            newColumns);
+      }
 
       // Make max and min vals for the children.
       StatType maxValsL(maxVals);
@@ -637,10 +761,44 @@ double DTree<MatType, TagType>::Grow(MatType& data,
       left = new DTree(maxValsL, minValsL, start, splitIndex, leftError);
       right = new DTree(maxValsR, minValsR, splitIndex, end, rightError);
 
-      leftG = left->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                         minLeafSize);
-      rightG = right->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                           minLeafSize);
+      // Each child only touches its own columns of the data, of oldFromNew
+      // and of the presorted indices, so the children of large nodes are grown
+      // in parallel.  If we are not inside a parallel region yet (i.e., this
+      // is the first large node), start one; the tasks of all the descendants
+      // will then run in it.
+      const size_t minParallelSplitSize = 5000;
+      const bool parallel = (presorted != NULL) &&
+          ((size_t) (end - start) >= 2 * minParallelSplitSize);
+      if (!parallel)
+      {
+        leftG = left->Grow(data, oldFromNew, useVolReg, maxLeafSize,
+                           minLeafSize, presorted);
+        rightG = right->Grow(data, oldFromNew, useVolReg, maxLeafSize,
+                             minLeafSize, presorted);
+      }
+      else
+      {
+        bool inParallel = false;
+        #ifdef HAS_OPENMP
+          inParallel = omp_in_parallel();
+        #endif
+
+        #pragma omp parallel if (!inParallel)
+        {
+          #pragma omp single
+          {
+            #pragma omp task shared(leftG, data, oldFromNew)
+            leftG = left->Grow(data, oldFromNew, useVolReg, maxLeafSize,
+                               minLeafSize, presorted);
+
+            #pragma omp task shared(rightG, data, oldFromNew)
+            rightG = right->Grow(data, oldFromNew, useVolReg, maxLeafSize,
+                                 minLeafSize, presorted);
+
+            #pragma omp taskwait
+          }
+        }
+      }
 
       // Store values of R(T~) and |T~|.
       subtreeLeaves = left->SubtreeLeaves() + right->SubtreeLeaves();
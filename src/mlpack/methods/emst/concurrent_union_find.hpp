@@ -0,0 +1,103 @@
+/**
+ * @file methods/emst/concurrent_union_find.hpp
+ *
+ * Implements a lock-free union-find data structure, which can be used by
+ * several threads at the same time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+#define MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <atomic>
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * A lock-free union-find data structure, with the same interface as UnionFind.
+ * Find() and Union() may be called concurrently from any number of threads.
+ *
+ * The parent of each element is stored as an atomic; Union() links two roots
+ * with a compare-and-swap and retries if another thread changed either root in
+ * the meantime, and Find() compresses paths by path halving, which is also
+ * done with a compare-and-swap.  Roots are always linked so that the root with
+ * the larger index points to the root with the smaller index.  Therefore the
+ * root of each component is its smallest element, no matter in which order
+ * (or by how many threads) the unions were performed.
+ */
+class ConcurrentUnionFind
+{
+ public:
+  //! Construct the object with the given size.
+  ConcurrentUnionFind(const size_t size) : parent(size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      parent[i].store(i, std::memory_order_relaxed);
+  }
+
+  /**
+   * Returns the component containing an element.  This is the smallest
+   * element of the component, once all concurrent calls to Union() have
+   * finished.
+   *
+   * @param x the component to be found
+   * @return The index of the component containing x
+   */
+  size_t Find(size_t x)
+  {
+    while (true)
+    {
+      size_t p = parent[x].load();
+      if (p == x)
+        return x;
+
+      // Point x at its grandparent.  If this fails, another thread has already
+      // changed the parent of x to some other ancestor, which is just as good.
+      const size_t gp = parent[p].load();
+      if (gp != p)
+        parent[x].compare_exchange_weak(p, gp);
+
+      x = gp;
+    }
+  }
+
+  /**
+   * Union the components containing x and y.
+   *
+   * @param x one component
+   * @param y the other component
+   */
+  void Union(size_t x, size_t y)
+  {
+    while (true)
+    {
+      x = Find(x);
+      y = Find(y);
+      if (x == y)
+        return;
+
+      // Link the larger root to the smaller root.  This only succeeds if x is
+      // still a root; otherwise, find the new roots and try again.
+      if (x < y)
+        std::swap(x, y);
+
+      size_t expected = x;
+      if (parent[x].compare_exchange_strong(expected, y))
+        return;
+    }
+  }
+
+ private:
+  //! The parent of each element.
+  std::vector<std::atomic<size_t>> parent;
+}; // class ConcurrentUnionFind
+
+} // namespace emst
+} // namespace mlpack
+
+#endif
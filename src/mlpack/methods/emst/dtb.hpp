@@ -27,6 +27,7 @@
 
 #include "dtb_stat.hpp"
 #include "edge_pair.hpp"
+#include "concurrent_union_find.hpp"
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
@@ -68,6 +69,14 @@ namespace emst /** Euclidean Minimum Spanning Trees. */ {
  * More advanced usage of the class can use different types of trees, pass in an
  * already-built tree, or compute the MST using the O(n^2) naive algorithm.
  *
+ * If mlpack is compiled with OpenMP, the search for the nearest neighbor of
+ * each component in each Boruvka round is split between threads: the tree is
+ * divided into disjoint query subtrees, and each thread traverses its subtrees
+ * against the whole tree, keeping its own candidate edges.  The candidates are
+ * then merged before the edges of the round are added.  Trees with
+ * self-children (such as cover trees) or overlapping children are searched by a
+ * single thread, except in naive mode.
+ *
  * @tparam MetricType The metric to use.
  * @tparam MatType The type of data matrix to use.
  * @tparam TreeType Type of tree to use.  This should follow the TreeType policy
@@ -102,8 +111,8 @@ class DualTreeBoruvka
   //! Edges.
   std::vector<EdgePair> edges; // We must use vector with non-numerical types.
 
-  //! Connections.
-  UnionFind connections;
+  //! Connections.  These may be searched by several threads at once.
+  ConcurrentUnionFind connections;
 
   //! List of edge nodes.
   arma::Col<size_t> neighborsInComponent;
@@ -186,6 +195,15 @@ class DualTreeBoruvka
    */
   void AddAllEdges();
 
+  /**
+   * Merge the candidate edges found by one thread into the candidate edges of
+   * each component.  Ties are broken by the indices of the endpoints, so that
+   * the result does not depend on the order in which threads finish.
+   */
+  void MergeCandidates(const arma::vec& distances,
+                       const arma::Col<size_t>& inComponent,
+                       const arma::Col<size_t>& outComponent);
+
   /**
    * Unpermute the edge list and output it to results.
    */
@@ -14,6 +14,8 @@
 
 #include "dtb_rules.hpp"
 
+#include <mlpack/core/tree/parallel_subtrees.hpp>
+
 namespace mlpack {
 namespace emst {
 
@@ -122,21 +124,51 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
   totalDist = 0; // Reset distance.
 
   typedef DTBRules<MetricType, Tree> RuleType;
-  RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
-                 neighborsOutComponent, metric);
+
+  // The query side of each traversal is split into disjoint subtrees, which
+  // can be handled by different threads.
+  std::vector<Tree*> queryNodes;
+  if (!naive)
+    queryNodes = tree::ParallelSubtrees(*tree);
+
+  size_t baseCases = 0;
+  size_t scores = 0;
   while (edges.size() < (data.n_cols - 1))
   {
-    if (naive)
+    #pragma omp parallel reduction(+:baseCases, scores)
     {
-      // Full O(N^2) traversal.
-      for (size_t i = 0; i < data.n_cols; ++i)
-        for (size_t j = 0; j < data.n_cols; ++j)
-          rules.BaseCase(i, j);
-    }
-    else
-    {
-      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-      traverser.Traverse(*tree, *tree);
+      // Points of one component may be handled by several threads, so each
+      // thread keeps its own candidate edges.
+      arma::vec threadDistances(data.n_cols);
+      threadDistances.fill(DBL_MAX);
+      arma::Col<size_t> threadInComponent(data.n_cols);
+      arma::Col<size_t> threadOutComponent(data.n_cols);
+      RuleType rules(data, connections, threadDistances, threadInComponent,
+                     threadOutComponent, metric);
+
+      if (naive)
+      {
+        // Full O(N^2) traversal.
+        #pragma omp for schedule(dynamic, 16)
+        for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+          for (size_t j = 0; j < data.n_cols; ++j)
+            rules.BaseCase(i, j);
+      }
+      else
+      {
+        #pragma omp for schedule(dynamic)
+        for (omp_size_t i = 0; i < (omp_size_t) queryNodes.size(); ++i)
+        {
+          typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+          traverser.Traverse(*queryNodes[i], *tree);
+        }
+      }
+
+      #pragma omp critical(dtbMergeCandidates)
+      MergeCandidates(threadDistances, threadInComponent, threadOutComponent);
+
+      baseCases += rules.BaseCases();
+      scores += rules.Scores();
     }
 
     AddAllEdges();
@@ -146,8 +178,8 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
     Log::Info << edges.size() << " edges found so far." << std::endl;
     if (!naive)
     {
-      Log::Info << rules.BaseCases() << " cumulative base cases." << std::endl;
-      Log::Info << rules.Scores() << " cumulative node combinations scored."
+      Log::Info << baseCases << " cumulative base cases." << std::endl;
+      Log::Info << scores << " cumulative node combinations scored."
           << std::endl;
     }
   }
@@ -207,6 +239,44 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::AddAllEdges()
   }
 }
 
+/**
+ * Merge the candidate edges found by one thread.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::MergeCandidates(
+    const arma::vec& distances,
+    const arma::Col<size_t>& inComponent,
+    const arma::Col<size_t>& outComponent)
+{
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    if (distances[i] == DBL_MAX)
+      continue;
+
+    // If no candidate has been merged yet, the distance is DBL_MAX and the
+    // indices are not compared.
+    bool better = (distances[i] < neighborsDistances[i]);
+    if (!better && distances[i] == neighborsDistances[i])
+    {
+      better = (inComponent[i] < neighborsInComponent[i]) ||
+          (inComponent[i] == neighborsInComponent[i] &&
+           outComponent[i] < neighborsOutComponent[i]);
+    }
+
+    if (better)
+    {
+      neighborsDistances[i] = distances[i];
+      neighborsInComponent[i] = inComponent[i];
+      neighborsOutComponent[i] = outComponent[i];
+    }
+  }
+}
+
 /**
  * Unpermute the edge list (if necessary) and output it to results.
  */
@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/ip_metric.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 #include "fastmks_stat.hpp"
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <queue>
@@ -48,6 +49,12 @@ namespace fastmks /** Fast max-kernel search. */ {
  * on points in the dataset (and not centroids of regions or anything like
  * that).
  *
+ * By default the search is exact.  If Epsilon() is set to a nonzero value, tree
+ * search prunes more aggressively and each returned kernel value is only
+ * guaranteed to be within a relative error of about epsilon of the true k'th
+ * best value; naive search is always exact.  For serving, BatchSearch() splits
+ * a large query set into blocks that each share one dual-tree traversal.
+ *
  * @tparam KernelType Type of kernel to run FastMKS with.
  * @tparam MatType Type of data matrix (usually arma::mat).
  * @tparam TreeType Type of tree to run FastMKS with; it must satisfy the
@@ -287,6 +294,30 @@ class FastMKS
               arma::Mat<size_t>& indices,
               arma::mat& products);
 
+  /**
+   * Search for the points in the reference set with maximum kernel evaluation
+   * to each point in the given query set, processing the query set in blocks of
+   * batchSize points.  A query tree is built on each block, and each block is
+   * searched with a single dual-tree traversal of the reference tree, so that
+   * all the queries of a block share the traversal.  If mlpack is compiled with
+   * OpenMP, the blocks are searched in parallel (the reference tree is only
+   * read during dual-tree search).  The results are stored as with Search().
+   *
+   * In naive or single-tree mode, there is no traversal to share, and this is
+   * the same as Search().
+   *
+   * @param querySet Set of query points.
+   * @param k The number of maximum kernels to find.
+   * @param indices Matrix to store resulting indices of max-kernel search in.
+   * @param kernels Matrix to store resulting max-kernel values in.
+   * @param batchSize Number of query points in each block.
+   */
+  void BatchSearch(const MatType& querySet,
+                   const size_t k,
+                   arma::Mat<size_t>& indices,
+                   arma::mat& kernels,
+                   const size_t batchSize = 256);
+
   //! Get the inner-product metric induced by the given kernel.
   const metric::IPMetric<KernelType>& Metric() const { return metric; }
   //! Modify the inner-product metric induced by the given kernel.
@@ -302,6 +333,12 @@ class FastMKS
   //! Modify whether or not brute-force (naive) search is used.
   bool& Naive() { return naive; }
 
+  //! Get the relative approximation allowed by tree search (0 means exact).
+  double Epsilon() const { return epsilon; }
+  //! Modify the relative approximation allowed by tree search (0 means exact).
+  //! It must be in [0, 1).
+  double& Epsilon() { return epsilon; }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
@@ -321,10 +358,18 @@ class FastMKS
   bool singleMode;
   //! If true, naive (brute-force) search is used.
   bool naive;
+  //! The relative approximation allowed by tree search.
+  double epsilon;
 
   //! The instantiated inner-product metric induced by the given kernel.
   metric::IPMetric<KernelType> metric;
 
+  //! Throw an exception if epsilon is not in [0, 1).
+  void CheckEpsilon() const;
+
+  //! The maximum number of elements of a block of kernels in naive search.
+  static const size_t naiveBlockElements = 1 << 22;
+
   //! Candidate represents a possible candidate point (value, index).
   typedef std::pair<double, size_t> Candidate;
 
@@ -35,7 +35,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(const bool singleMode,
     treeOwner(true),
     setOwner(true),
     singleMode(singleMode),
-    naive(naive)
+    naive(naive),
+    epsilon(0.0)
 {
   if (!naive)
     referenceTree = new Tree(*referenceSet);
@@ -56,7 +57,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(
     treeOwner(true),
     setOwner(false),
     singleMode(singleMode),
-    naive(naive)
+    naive(naive),
+    epsilon(0.0)
 {
   if (!naive)
     referenceTree = new Tree(referenceSet);
@@ -78,6 +80,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(const MatType& referenceSet,
     setOwner(false),
     singleMode(singleMode),
     naive(naive),
+    epsilon(0.0),
     metric(kernel)
 {
   // If necessary, the reference tree should be built.  There is no query tree.
@@ -100,7 +103,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(
     treeOwner(true),
     setOwner(naive),
     singleMode(singleMode),
-    naive(naive)
+    naive(naive),
+    epsilon(0.0)
 {
   if (!naive)
   {
@@ -125,6 +129,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(MatType&& referenceSet,
     setOwner(naive),
     singleMode(singleMode),
     naive(naive),
+    epsilon(0.0),
     metric(kernel)
 {
   // If necessary, the reference tree should be built.  There is no query tree.
@@ -149,6 +154,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(Tree* referenceTree,
     setOwner(false),
     singleMode(singleMode),
     naive(false),
+    epsilon(0.0),
     metric(referenceTree->Metric())
 {
   // Nothing to do.
@@ -166,6 +172,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(const FastMKS& other) :
     setOwner(other.referenceTree == NULL),
     singleMode(other.singleMode),
     naive(other.naive),
+    epsilon(other.epsilon),
     metric(other.metric)
 {
   // Set reference set correctly.
@@ -187,6 +194,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(FastMKS&& other) :
     setOwner(other.setOwner),
     singleMode(other.singleMode),
     naive(other.naive),
+    epsilon(other.epsilon),
     metric(std::move(other.metric))
 {
   // Clear information from the other.
@@ -196,6 +204,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(FastMKS&& other) :
   other.setOwner = false;
   other.singleMode = false;
   other.naive = false;
+  other.epsilon = 0.0;
 }
 
 template<typename KernelType,
@@ -234,6 +243,10 @@ FastMKS<KernelType, MatType, TreeType>::operator=(const FastMKS& other)
 
   singleMode = other.singleMode;
   naive = other.naive;
+  epsilon = other.epsilon;
+  metric = other.metric;
+
+  return *this;
 }
 
 template<typename KernelType,
@@ -252,6 +265,7 @@ FastMKS<KernelType, MatType, TreeType>::operator=(FastMKS&& other)
     setOwner = other.setOwner;
     singleMode = other.singleMode;
     naive = other.naive;
+    epsilon = other.epsilon;
     metric = std::move(other.metric);
 
     // Clear information from the other.
@@ -261,6 +275,7 @@ FastMKS<KernelType, MatType, TreeType>::operator=(FastMKS&& other)
     other.setOwner = false;
     other.singleMode = false;
     other.naive = false;
+    other.epsilon = 0.0;
   }
   return *this;
 }
@@ -439,44 +454,58 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < querySet.n_cols; ++q)
+    // Compute the kernels of all reference points with blocks of query points,
+    // and then find the best candidates of each query point of the block in
+    // parallel.  The blocks bound the size of the kernel matrix.
+    const size_t blockSize = std::max((size_t) 1, std::min(
+        (size_t) querySet.n_cols, naiveBlockElements /
+        std::max((size_t) referenceSet->n_cols, (size_t) 1)));
+    arma::mat blockKernels;
+    for (size_t begin = 0; begin < querySet.n_cols; begin += blockSize)
     {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
+      const size_t end = std::min(begin + blockSize, (size_t) querySet.n_cols);
+      kernel::KernelMatrix(metric.Kernel(), *referenceSet,
+          querySet.cols(begin, end - 1), blockKernels);
 
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
+      #pragma omp parallel for schedule(static)
+      for (omp_size_t q = (omp_size_t) begin; q < (omp_size_t) end; ++q)
       {
-        const double eval = metric.Kernel().Evaluate(querySet.col(q),
-                                                     referenceSet->col(r));
+        const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
+        std::vector<Candidate> cList(k, def);
+        CandidateList pqueue(CandidateCmp(), std::move(cList));
 
-        if (eval > pqueue.top().first)
+        const double* evals = blockKernels.colptr((size_t) q - begin);
+        for (size_t r = 0; r < referenceSet->n_cols; ++r)
         {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
+          if (evals[r] > pqueue.top().first)
+          {
+            Candidate c = std::make_pair(evals[r], r);
+            pqueue.pop();
+            pqueue.push(c);
+          }
         }
-      }
 
-      for (size_t j = 1; j <= k; ++j)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
+        for (size_t j = 1; j <= k; ++j)
+        {
+          indices(k - j, q) = pqueue.top().second;
+          kernels(k - j, q) = pqueue.top().first;
+          pqueue.pop();
+        }
       }
     }
 
     return;
   }
 
+  CheckEpsilon();
+
   // Single-tree implementation.
   if (singleMode)
   {
     // Create rules object (this will store the results).  This constructor
     // precalculates each self-kernel value.
     typedef FastMKSRules<KernelType, Tree> RuleType;
-    RuleType rules(*referenceSet, querySet, k, metric.Kernel());
+    RuleType rules(*referenceSet, querySet, k, metric.Kernel(), epsilon);
 
     typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
 
@@ -532,12 +561,15 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
         "single mode or naive search is enabled");
   }
 
+  CheckEpsilon();
+
   // No remapping will be necessary because we are using the cover tree.
   indices.set_size(k, queryTree->Dataset().n_cols);
   kernels.set_size(k, queryTree->Dataset().n_cols);
 
   typedef FastMKSRules<KernelType, Tree> RuleType;
-  RuleType rules(*referenceSet, queryTree->Dataset(), k, metric.Kernel());
+  RuleType rules(*referenceSet, queryTree->Dataset(), k, metric.Kernel(),
+      epsilon);
 
   typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
 
@@ -566,47 +598,63 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < referenceSet->n_cols; ++q)
+    // Compute the kernels of all reference points with blocks of reference
+    // points, and then find the best candidates of each point of the block in
+    // parallel.  The blocks bound the size of the kernel matrix.
+    const size_t blockSize = std::max((size_t) 1, std::min(
+        (size_t) referenceSet->n_cols, naiveBlockElements /
+        std::max((size_t) referenceSet->n_cols, (size_t) 1)));
+    arma::mat blockKernels;
+    for (size_t begin = 0; begin < referenceSet->n_cols; begin += blockSize)
     {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
+      const size_t end = std::min(begin + blockSize,
+          (size_t) referenceSet->n_cols);
+      kernel::KernelMatrix(metric.Kernel(), *referenceSet,
+          referenceSet->cols(begin, end - 1), blockKernels);
 
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
+      #pragma omp parallel for schedule(static)
+      for (omp_size_t q = (omp_size_t) begin; q < (omp_size_t) end; ++q)
       {
-        if (q == r)
-          continue; // Don't return the point as its own candidate.
+        const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
+        std::vector<Candidate> cList(k, def);
+        CandidateList pqueue(CandidateCmp(), std::move(cList));
 
-        const double eval = metric.Kernel().Evaluate(referenceSet->col(q),
-                                                     referenceSet->col(r));
+        const double* evals = blockKernels.colptr((size_t) q - begin);
+        for (size_t r = 0; r < referenceSet->n_cols; ++r)
+        {
+          if ((size_t) q == r)
+            continue; // Don't return the point as its own candidate.
+
+          if (evals[r] > pqueue.top().first)
+          {
+            Candidate c = std::make_pair(evals[r], r);
+            pqueue.pop();
+            pqueue.push(c);
+          }
+        }
 
-        if (eval > pqueue.top().first)
+        for (size_t j = 1; j <= k; ++j)
         {
-          Candidate c = std::make_pair(eval, r);
+          indices(k - j, q) = pqueue.top().second;
+          kernels(k - j, q) = pqueue.top().first;
           pqueue.pop();
-          pqueue.push(c);
         }
       }
-
-      for (size_t j = 1; j <= k; ++j)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
     }
 
     return;
   }
 
+  CheckEpsilon();
+
   // Single-tree implementation.
   if (singleMode)
   {
     // Create rules object (this will store the results).  This constructor
     // precalculates each self-kernel value.
     typedef FastMKSRules<KernelType, Tree> RuleType;
-    RuleType rules(*referenceSet, *referenceSet, k, metric.Kernel());
+    RuleType rules(*referenceSet, *referenceSet, k, metric.Kernel(),
+        epsilon);
 
     typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
 
@@ -630,6 +678,104 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   Search(referenceTree, k, indices, kernels);
 }
 
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::BatchSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels,
+    const size_t batchSize)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("FastMKS::BatchSearch(): batchSize must be "
+        "greater than 0");
+  }
+
+  // There is nothing to share in naive or single-tree mode, and one block is
+  // just a regular dual-tree search.
+  if (naive || singleMode || batchSize >= querySet.n_cols)
+  {
+    Search(querySet, k, indices, kernels);
+    return;
+  }
+
+  // Everything is checked here, since exceptions can't be thrown from inside
+  // the parallel loop.
+  if (k > referenceSet->n_cols)
+  {
+    std::stringstream ss;
+    ss << "requested value of k (" << k << ") is greater than the number of "
+        << "points in the reference set (" << referenceSet->n_cols << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  if (querySet.n_rows != referenceSet->n_rows)
+  {
+    std::stringstream ss;
+    ss << "The number of dimensions in the query set (" << querySet.n_rows
+        << ") must be equal to the number of dimensions in the reference set ("
+        << referenceSet->n_rows << ")!";
+    throw std::invalid_argument(ss.str());
+  }
+
+  CheckEpsilon();
+
+  indices.set_size(k, querySet.n_cols);
+  kernels.set_size(k, querySet.n_cols);
+
+  typedef FastMKSRules<KernelType, Tree> RuleType;
+  const size_t numBatches = (querySet.n_cols + batchSize - 1) / batchSize;
+  size_t baseCases = 0;
+  size_t scores = 0;
+
+  #pragma omp parallel for schedule(dynamic) reduction(+:baseCases, scores)
+  for (omp_size_t b = 0; b < (omp_size_t) numBatches; ++b)
+  {
+    const size_t begin = b * batchSize;
+    const size_t end = std::min(begin + batchSize, (size_t) querySet.n_cols);
+
+    // As in Search(), we assume that the query tree doesn't map anything.
+    Tree queryTree(MatType(querySet.cols(begin, end - 1)));
+
+    RuleType rules(*referenceSet, queryTree.Dataset(), k, metric.Kernel(),
+        epsilon);
+    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    traverser.Traverse(queryTree, *referenceTree);
+
+    arma::Mat<size_t> batchIndices;
+    arma::mat batchKernels;
+    rules.GetResults(batchIndices, batchKernels);
+    indices.cols(begin, end - 1) = batchIndices;
+    kernels.cols(begin, end - 1) = batchKernels;
+
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+  }
+
+  Log::Info << baseCases << " base cases." << std::endl;
+  Log::Info << scores << " scores." << std::endl;
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::CheckEpsilon() const
+{
+  if (epsilon < 0.0 || epsilon >= 1.0)
+  {
+    std::ostringstream oss;
+    oss << "FastMKS::Search(): epsilon must be in [0, 1), but is " << epsilon;
+    throw std::invalid_argument(oss.str());
+  }
+}
+
 //! Serialize the model.
 template<typename KernelType,
          typename MatType,
@@ -643,6 +789,7 @@ void FastMKS<KernelType, MatType, TreeType>::serialize(
   // Serialize preferences for search.
   ar(CEREAL_NVP(naive));
   ar(CEREAL_NVP(singleMode));
+  ar(CEREAL_NVP(epsilon));
 
   // If we are doing naive search, serialize the dataset.  Otherwise we
   // serialize the tree.
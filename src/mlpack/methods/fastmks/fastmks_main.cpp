@@ -107,6 +107,10 @@ PARAM_INT_IN("k", "Number of maximum kernels to find.", "k", 0);
 PARAM_FLAG("naive", "If true, O(n^2) naive mode is used for computation.", "N");
 PARAM_FLAG("single", "If true, single-tree search is used (as opposed to "
     "dual-tree search.", "S");
+PARAM_DOUBLE_IN("epsilon", "If nonzero, perform approximate tree search: each "
+    "returned kernel value is within a relative error of about epsilon of the "
+    "true value.  Must be in [0, 1).  If an input model is given and this is "
+    "not specified, the epsilon of the model is used.", "e", 0.0);
 
 PARAM_MATRIX_OUT("kernels", "Output matrix of kernels.", "p");
 PARAM_UMATRIX_OUT("indices", "Output matrix of indices.", "i");
@@ -149,8 +153,16 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
         true, "base must be greater than or equal to 1!");
   }
 
+  if (params.Has("epsilon"))
+  {
+    RequireParamValue<double>(params, "epsilon",
+        [](double x) { return x >= 0.0 && x < 1.0; }, true,
+        "epsilon must be in [0, 1)");
+  }
+
   // Naive mode overrides single mode.
   ReportIgnoredParam(params, {{ "naive", true }}, "single");
+  ReportIgnoredParam(params, {{ "naive", true }}, "epsilon");
 
   FastMKSModel* model;
   arma::mat referenceData;
@@ -235,6 +247,8 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   // Set search preferences.
   model->Naive() = params.Has("naive");
   model->SingleMode() = params.Has("single");
+  if (params.Has("reference") || params.Has("epsilon"))
+    model->Epsilon() = params.Get<double>("epsilon");
 
   // Should we do search?
   if (params.Has("k"))
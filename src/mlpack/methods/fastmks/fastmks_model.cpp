@@ -247,6 +247,52 @@ bool& FastMKSModel::SingleMode()
   throw std::runtime_error("invalid model type");
 }
 
+double FastMKSModel::Epsilon() const
+{
+  switch (kernelType)
+  {
+    case LINEAR_KERNEL:
+      return linear->Epsilon();
+    case POLYNOMIAL_KERNEL:
+      return polynomial->Epsilon();
+    case COSINE_DISTANCE:
+      return cosine->Epsilon();
+    case GAUSSIAN_KERNEL:
+      return gaussian->Epsilon();
+    case EPANECHNIKOV_KERNEL:
+      return epan->Epsilon();
+    case TRIANGULAR_KERNEL:
+      return triangular->Epsilon();
+    case HYPTAN_KERNEL:
+      return hyptan->Epsilon();
+  }
+
+  throw std::runtime_error("invalid model type");
+}
+
+double& FastMKSModel::Epsilon()
+{
+  switch (kernelType)
+  {
+    case LINEAR_KERNEL:
+      return linear->Epsilon();
+    case POLYNOMIAL_KERNEL:
+      return polynomial->Epsilon();
+    case COSINE_DISTANCE:
+      return cosine->Epsilon();
+    case GAUSSIAN_KERNEL:
+      return gaussian->Epsilon();
+    case EPANECHNIKOV_KERNEL:
+      return epan->Epsilon();
+    case TRIANGULAR_KERNEL:
+      return triangular->Epsilon();
+    case HYPTAN_KERNEL:
+      return hyptan->Epsilon();
+  }
+
+  throw std::runtime_error("invalid model type");
+}
+
 void FastMKSModel::Search(util::Timers& timers,
                           const arma::mat& querySet,
                           const size_t k,
@@ -90,6 +90,11 @@ class FastMKSModel
   //! Set whether or not single-tree search is used.
   bool& SingleMode();
 
+  //! Get the relative approximation allowed by tree search (0 means exact).
+  double Epsilon() const;
+  //! Set the relative approximation allowed by tree search (0 means exact).
+  double& Epsilon();
+
   //! Get the kernel type.
   int KernelType() const { return kernelType; }
   //! Modify the kernel type.
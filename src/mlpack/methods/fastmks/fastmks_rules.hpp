@@ -23,9 +23,14 @@ namespace fastmks {
 
 /**
  * The FastMKSRules class is a template helper class used by FastMKS class when
- * performing exact max-kernel search. For each point in the query dataset, it
+ * performing max-kernel search. For each point in the query dataset, it
  * keeps track of the k best candidates in the reference dataset.
  *
+ * If epsilon is nonzero, the search is approximate: a node is pruned unless it
+ * could contain a kernel value larger than B + epsilon * |B|, where B is the
+ * current bound on the k'th best kernel value.  Then each returned kernel
+ * value is within a relative error of about epsilon of the true value.
+ *
  * @tparam KernelType Type of kernel to run FastMKS with.
  * @tparam TreeType Type of tree to run FastMKS with; it must satisfy the
  *     TreeType policy API.
@@ -42,11 +47,14 @@ class FastMKSRules
    * @param querySet Set of query data.
    * @param k Number of candidates to search for.
    * @param kernel Kernel to run FastMKS with.
+   * @param epsilon Relative approximation allowed when pruning (0 means exact
+   *     search).
    */
   FastMKSRules(const typename TreeType::Mat& referenceSet,
                const typename TreeType::Mat& querySet,
                const size_t k,
-               KernelType& kernel);
+               KernelType& kernel,
+               const double epsilon = 0.0);
 
   /**
    * Store the list of candidates for each query point in the given matrices.
@@ -128,6 +136,9 @@ class FastMKSRules
   //! results.
   size_t MinimumBaseCases() const { return k; }
 
+  //! Get the relative approximation allowed when pruning.
+  double Epsilon() const { return epsilon; }
+
  private:
   //! The reference dataset.
   const typename TreeType::Mat& referenceSet;
@@ -166,6 +177,9 @@ class FastMKSRules
   //! The instantiated kernel.
   KernelType& kernel;
 
+  //! The relative approximation allowed when pruning.
+  double epsilon;
+
   //! The last query index BaseCase() was called with.
   size_t lastQueryIndex;
   //! The last reference index BaseCase() was called with.
@@ -176,6 +190,18 @@ class FastMKSRules
   //! Calculate the bound for a given query node.
   double CalculateBound(TreeType& queryNode) const;
 
+  /**
+   * Return the kernel value that a node must be able to reach to be recursed
+   * into, given the current bound on the k'th best kernel value.  For exact
+   * search this is the bound itself; otherwise a node is also pruned when it
+   * cannot improve the bound by more than a relative factor of epsilon.
+   */
+  double PruneBound(const double bestKernel) const
+  {
+    return (bestKernel == -DBL_MAX) ? bestKernel :
+        bestKernel + epsilon * std::abs(bestKernel);
+  }
+
   /**
    * Helper function to insert a point into the list of candidate points.
    *
@@ -23,11 +23,13 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     const typename TreeType::Mat& referenceSet,
     const typename TreeType::Mat& querySet,
     const size_t k,
-    KernelType& kernel) :
+    KernelType& kernel,
+    const double epsilon) :
     referenceSet(referenceSet),
     querySet(querySet),
     k(k),
     kernel(kernel),
+    epsilon(epsilon),
     lastQueryIndex(-1),
     lastReferenceIndex(-1),
     lastKernel(0.0),
@@ -128,8 +130,9 @@ template<typename KernelType, typename TreeType>
 double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
                                                  TreeType& referenceNode)
 {
-  // Compare with the current best.
-  const double bestKernel = candidates[queryIndex].top().first;
+  // Compare with the current best (loosened by epsilon, if the search is
+  // approximate).
+  const double bestKernel = PruneBound(candidates[queryIndex].top().first);
 
   // See if we can perform a parent-child prune.
   const double furthestDist = referenceNode.FurthestDescendantDistance();
@@ -184,7 +187,7 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
   }
   else
   {
-    arma::vec refCenter;
+    arma::Col<typename TreeType::ElemType> refCenter;
     referenceNode.Center(refCenter);
 
     kernelEval = kernel.Evaluate(querySet.col(queryIndex), refCenter);
@@ -222,9 +225,10 @@ template<typename KernelType, typename TreeType>
 double FastMKSRules<KernelType, TreeType>::Score(TreeType& queryNode,
                                                  TreeType& referenceNode)
 {
-  // Update and get the query node's bound.
+  // Update and get the query node's bound.  The stored bound is exact; only
+  // the value used for pruning is loosened by epsilon.
   queryNode.Stat().Bound() = CalculateBound(queryNode);
-  const double bestKernel = queryNode.Stat().Bound();
+  const double bestKernel = PruneBound(queryNode.Stat().Bound());
 
   // First, see if we can make a parent-child or parent-parent prune.  These
   // four bounds on the maximum kernel value are looser than the bound normally
@@ -352,8 +356,8 @@ double FastMKSRules<KernelType, TreeType>::Score(TreeType& queryNode,
   else
   {
     // Calculate the maximum possible kernel value.
-    arma::vec queryCenter;
-    arma::vec refCenter;
+    arma::Col<typename TreeType::ElemType> queryCenter;
+    arma::Col<typename TreeType::ElemType> refCenter;
     queryNode.Center(queryCenter);
     referenceNode.Center(refCenter);
 
@@ -412,7 +416,7 @@ double FastMKSRules<KernelType, TreeType>::Rescore(const size_t queryIndex,
                                                    TreeType& /*referenceNode*/,
                                                    const double oldScore) const
 {
-  const double bestKernel = candidates[queryIndex].top().first;
+  const double bestKernel = PruneBound(candidates[queryIndex].top().first);
 
   return ((1.0 / oldScore) >= bestKernel) ? oldScore : DBL_MAX;
 }
@@ -423,7 +427,7 @@ double FastMKSRules<KernelType, TreeType>::Rescore(TreeType& queryNode,
                                                    const double oldScore) const
 {
   queryNode.Stat().Bound() = CalculateBound(queryNode);
-  const double bestKernel = queryNode.Stat().Bound();
+  const double bestKernel = PruneBound(queryNode.Stat().Bound());
 
   return ((1.0 / oldScore) >= bestKernel) ? oldScore : DBL_MAX;
 }
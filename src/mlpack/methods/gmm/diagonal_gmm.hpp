@@ -19,6 +19,8 @@
 
 // This is the default fitting method class.
 #include "em_fit.hpp"
+// Online fitting, used by Update().
+#include "online_em_fit.hpp"
 
 // This is the default covariance matrix constraint.
 #include "diagonal_constraint.hpp"
@@ -279,6 +281,21 @@ class DiagonalGMM
                const bool useExistingModel = false,
                FittingType fitter = FittingType());
 
+  /**
+   * Fold the given observations into the existing model with one step of the
+   * given online fitter, without refitting on the data the model was trained
+   * on.  The model must already be trained.  The fitter keeps track of the
+   * steps taken so far (which set its step size), so the same fitter should
+   * be given to every call.
+   *
+   * @tparam FittingType The type of online fitting method to use
+   *     (OnlineEMFit is suggested).
+   * @param observations Minibatch of new observations.
+   * @param fitter The fitter to use.
+   */
+  template<typename FittingType>
+  void Update(const arma::mat& observations, FittingType& fitter);
+
   /**
    * Classify the given observations as being from an individual component in
    * this DiagonalGMM. The resultant classifications are stored in the 'labels'
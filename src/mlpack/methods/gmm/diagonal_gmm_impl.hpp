@@ -189,6 +189,13 @@ double DiagonalGMM::Train(const arma::mat& observations,
   return bestLikelihood;
 }
 
+//! Fold new observations into the model with one online step.
+template<typename FittingType>
+void DiagonalGMM::Update(const arma::mat& observations, FittingType& fitter)
+{
+  fitter.Update(observations, dists, weights);
+}
+
 //! Serialize the object.
 template<typename Archive>
 void DiagonalGMM::serialize(Archive& ar, const uint32_t /* version */)
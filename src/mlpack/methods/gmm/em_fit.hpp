@@ -148,19 +148,23 @@ class EMFit
       arma::vec& weights);
 
   /**
-   * Calculate the log-likelihood of a model.  Yes, this is reimplemented in the
-   * GMM code.  Intuition suggests that the log-likelihood is not the best way
-   * to determine if the EM algorithm has converged.
+   * Run one step of the EM algorithm.  The points are processed in blocks, in
+   * parallel with OpenMP if available, and each block is used for both the
+   * E-step and the accumulation of the statistics of the M-step, so the
+   * responsibilities of all the points are never stored at once.  This is a
+   * helper function for both overloads of Estimate().
    *
-   * @param data Data matrix.
-   * @param means Vector of means.
-   * @param dists Distributions to store model in.
-   * @param weights Vector of a priori weights.
+   * @param observations List of observations.
+   * @param probabilities Probability of each point being from this model, or
+   *      an empty vector if all points are from this model.
+   * @param dists Distributions of the model, to be updated.
+   * @param weights A priori weights of the model, to be updated.
+   * @return The log-likelihood of the model before the update.
    */
-  double LogLikelihood(
-      const arma::mat& data,
-      const std::vector<Distribution>& dists,
-      const arma::vec& weights) const;
+  double Step(const arma::mat& observations,
+              const arma::vec& probabilities,
+              std::vector<Distribution>& dists,
+              arma::vec& weights);
 
   /**
    * Use the Armadillo gmm_diag clusterer to train a GMM with diagonal
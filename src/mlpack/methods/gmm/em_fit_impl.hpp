@@ -71,97 +71,22 @@ Estimate(const arma::mat& observations,
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
-
-  Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
-      << l << std::endl;
-
+  // Iterate to update the model until no more improvement is found.  Each
+  // step gives the log-likelihood of the model it started from.
   double lOld = -DBL_MAX;
-  arma::mat condLogProb(observations.n_cols, dists.size());
-
-  // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
-  while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
+  while (iteration != maxIterations)
   {
-    Log::Info << "EMFit::Estimate(): iteration " << iteration << ", "
-        << "log-likelihood " << l << "." << std::endl;
-
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += log(weights[i]);
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; ++i)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = mlpack::math::AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
-
-    // Store the sum of the probability of each state over all the observations.
-    arma::vec probRowSums(dists.size());
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      probRowSums(i) = mlpack::math::AccuLog(condLogProb.col(i));
-    }
+    MLPACK_TRACE_SCOPE("em_iteration");
+    const double l = Step(observations, arma::vec(), dists, weights);
 
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != -std::numeric_limits<double>::infinity())
-        dists[i].Mean() = observations * arma::exp(condLogProb.col(i) -
-                                                   probRowSums[i]);
-      else
-        continue;
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations.each_col() - dists[i].Mean();
-
-      // If the distribution is DiagonalGaussianDistribution, calculate the
-      // covariance only with diagonal components.
-      if (std::is_same<Distribution,
-          distribution::DiagonalGaussianDistribution>::value)
-      {
-        arma::vec covariance = arma::sum((tmp % tmp) %
-            (arma::ones<arma::vec>(observations.n_rows) *
-            trans(arma::exp(condLogProb.col(i) - probRowSums[i]))), 1);
+    MLPACK_LOG(Log::Info) << "EMFit::Estimate(): iteration " << iteration
+        << ", log-likelihood " << l << "." << std::endl;
 
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-      else
-      {
-        arma::mat tmpB = tmp.each_row() % trans(arma::exp(condLogProb.col(i) -
-                                                          probRowSums[i]));
-        arma::mat covariance = tmp * trans(tmpB);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-    }
+    if (std::abs(l - lOld) <= tolerance)
+      break;
 
-    // Calculate the new values for omega using the updated conditional
-    // probabilities.
-    weights = arma::exp(probRowSums - std::log(observations.n_cols));
-
-    // Update values of l; calculate new log-likelihood.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
-
     iteration++;
   }
 }
@@ -179,104 +104,163 @@ Estimate(const arma::mat& observations,
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
-
-  Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
-      << l << std::endl;
-
+  // Iterate to update the model until no more improvement is found.  Each
+  // step gives the log-likelihood of the model it started from.
   double lOld = -DBL_MAX;
-  arma::mat condLogProb(observations.n_cols, dists.size());
-
-  // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
-  while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
+  while (iteration != maxIterations)
   {
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += log(weights[i]);
-    }
+    MLPACK_TRACE_SCOPE("em_iteration");
+    const double l = Step(observations, probabilities, dists, weights);
 
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; ++i)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = mlpack::math::AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
+    if (std::abs(l - lOld) <= tolerance)
+      break;
 
-    // This will store the sum of probabilities of each state over all the
-    // observations.
-    arma::vec probRowSums(dists.size());
+    lOld = l;
+    iteration++;
+  }
+}
 
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    arma::vec logProbabilities = arma::log(probabilities);
-    for (size_t i = 0; i < dists.size(); ++i)
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+double EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+Step(const arma::mat& observations,
+     const arma::vec& probabilities,
+     std::vector<Distribution>& dists,
+     arma::vec& weights)
+{
+  // If the distribution is DiagonalGaussianDistribution, only the diagonal
+  // components of the covariances are accumulated.
+  const bool isDiagGaussDist = std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value;
+
+  // The points are handled in blocks of about 256kB, so that the block stays
+  // in cache while it is used for every component.
+  const size_t dimensionality = observations.n_rows;
+  const size_t blockSize = std::max((size_t) 1,
+      (size_t) 32768 / std::max(dimensionality, (size_t) 1));
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+
+  // The sufficient statistics of each component: the sum of its
+  // responsibilities, and the first and second moments of the points weighted
+  // by those responsibilities.  The moments are centered on the current means,
+  // which are close to the new ones, so that the covariances can be computed
+  // in the same pass without losing precision.
+  arma::vec respSums(dists.size(), arma::fill::zeros);
+  arma::mat firstMoments(dimensionality, dists.size(), arma::fill::zeros);
+  std::vector<arma::mat> secondMoments(dists.size(), arma::mat(dimensionality,
+      isDiagGaussDist ? 1 : dimensionality, arma::fill::zeros));
+
+  const arma::vec logWeights = arma::log(weights);
+  double logLikelihood = 0.0;
+
+  #pragma omp parallel reduction(+:logLikelihood)
+  {
+    arma::vec localRespSums(dists.size(), arma::fill::zeros);
+    arma::mat localFirstMoments(dimensionality, dists.size(),
+        arma::fill::zeros);
+    std::vector<arma::mat> localSecondMoments(secondMoments);
+    arma::mat resp;
+    arma::vec logProbs;
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
     {
-      // Calculate the sum of probabilities of points, which is the
-      // conditional probability of each point being from Gaussian i
-      // multiplied by the probability of the point being from this mixture
-      // model.
-      arma::vec tmpProb = condLogProb.col(i) + logProbabilities;
-      probRowSums[i] = mlpack::math::AccuLog(tmpProb);
-
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != -std::numeric_limits<double>::infinity())
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize,
+          (size_t) observations.n_cols);
+      const arma::mat block(const_cast<double*>(observations.colptr(begin)),
+          dimensionality, end - begin, false, true);
+
+      // E-step: compute the log-responsibilities of the points in the block,
+      // then normalize them.
+      resp.set_size(dists.size(), block.n_cols);
+      for (size_t i = 0; i < dists.size(); ++i)
       {
-        dists[i].Mean() = observations *
-              arma::exp(condLogProb.col(i) + logProbabilities - probRowSums[i]);
+        dists[i].LogProbability(block, logProbs);
+        resp.row(i) = trans(logProbs) + logWeights[i];
       }
-      else
-        continue;
 
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations.each_col() - dists[i].Mean();
-
-      // If the distribution is DiagonalGaussianDistribution, calculate the
-      // covariance only with diagonal components.
-      if (std::is_same<Distribution,
-          distribution::DiagonalGaussianDistribution>::value)
+      for (size_t j = 0; j < block.n_cols; ++j)
       {
-        arma::vec cov = arma::sum((tmp % tmp) %
-            (arma::ones<arma::vec>(observations.n_rows) *
-            trans(arma::exp(condLogProb.col(i) +
-                            logProbabilities - probRowSums[i]))), 1);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(cov);
-        dists[i].Covariance(std::move(cov));
+        const double probSum = mlpack::math::AccuLog(resp.col(j));
+        logLikelihood += probSum;
+
+        // Avoid dividing by zero; if the probability for everything is 0, the
+        // point is not given to any component.
+        if (probSum == -std::numeric_limits<double>::infinity())
+        {
+          resp.col(j).zeros();
+          continue;
+        }
+
+        resp.col(j) = arma::exp(resp.col(j) - probSum);
+        if (!probabilities.is_empty())
+          resp.col(j) *= probabilities[begin + j];
       }
-      else
-      {
-        arma::mat tmpB = tmp.each_row() % trans(arma::exp(condLogProb.col(i) +
-            logProbabilities - probRowSums[i]));
-        arma::mat cov = (tmp * trans(tmpB));
 
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(cov);
-        dists[i].Covariance(std::move(cov));
+      // M-step: accumulate the statistics of each component.
+      for (size_t i = 0; i < dists.size(); ++i)
+      {
+        const arma::mat centered = block.each_col() - dists[i].Mean();
+        const arma::mat weighted = centered.each_row() % resp.row(i);
+
+        localRespSums[i] += arma::accu(resp.row(i));
+        localFirstMoments.col(i) += arma::sum(weighted, 1);
+        if (isDiagGaussDist)
+          localSecondMoments[i] += arma::sum(weighted % centered, 1);
+        else
+          localSecondMoments[i] += weighted * trans(centered);
       }
     }
 
-    // Calculate the new values for omega using the updated conditional
-    // probabilities.
-    weights = arma::exp(probRowSums - mlpack::math::AccuLog(logProbabilities));
+    // Combine the statistics of each thread.
+    #pragma omp critical
+    {
+      respSums += localRespSums;
+      firstMoments += localFirstMoments;
+      for (size_t i = 0; i < dists.size(); ++i)
+        secondMoments[i] += localSecondMoments[i];
+    }
+  }
 
-    // Update values of l; calculate new log-likelihood.
-    lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+  // Calculate the new means and covariances from the statistics.
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (respSums[i] == 0.0)
+      continue;
 
-    iteration++;
+    const arma::vec shift = firstMoments.col(i) / respSums[i];
+    dists[i].Mean() += shift;
+
+    if (isDiagGaussDist)
+    {
+      arma::vec covariance = secondMoments[i] / respSums[i] -
+          arma::square(shift);
+
+      // Apply covariance constraint.
+      constraint.ApplyConstraint(covariance);
+      dists[i].Covariance(std::move(covariance));
+    }
+    else
+    {
+      arma::mat covariance = secondMoments[i] / respSums[i] -
+          shift * trans(shift);
+
+      // Apply covariance constraint.
+      constraint.ApplyConstraint(covariance);
+      dists[i].Covariance(std::move(covariance));
+    }
   }
+
+  // Calculate the new values for omega using the updated conditional
+  // probabilities.
+  weights = respSums / (probabilities.is_empty() ?
+      (double) observations.n_cols : arma::accu(probabilities));
+
+  return logLikelihood;
 }
 
 template<typename InitialClusteringType,
@@ -373,40 +357,6 @@ InitialClustering(const arma::mat& observations,
   weights /= accu(weights);
 }
 
-template<typename InitialClusteringType,
-         typename CovarianceConstraintPolicy,
-         typename Distribution>
-double EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
-LogLikelihood(const arma::mat& observations,
-              const std::vector<Distribution>& dists,
-              const arma::vec& weights) const
-{
-  double logLikelihood = 0;
-
-  arma::vec logPhis;
-  arma::mat logLikelihoods(dists.size(), observations.n_cols);
-
-  // It has to be LogProbability() otherwise Probability() would overflow easily
-  for (size_t i = 0; i < dists.size(); ++i)
-  {
-    dists[i].LogProbability(observations, logPhis);
-    logLikelihoods.row(i) = log(weights(i)) + trans(logPhis);
-  }
-  // Now sum over every point.
-  for (size_t j = 0; j < observations.n_cols; ++j)
-  {
-    if (mlpack::math::AccuLog(logLikelihoods.col(j)) ==
-        -std::numeric_limits<double>::infinity())
-    {
-      Log::Info << "Likelihood of point " << j << " is 0!  It is probably an "
-          << "outlier." << std::endl;
-    }
-    logLikelihood += mlpack::math::AccuLog(logLikelihoods.col(j));
-  }
-
-  return logLikelihood;
-}
-
 template<typename InitialClusteringType,
          typename CovarianceConstraintPolicy,
          typename Distribution>
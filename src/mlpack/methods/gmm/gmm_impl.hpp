@@ -187,6 +187,15 @@ double GMM::Train(const arma::mat& observations,
   return bestLikelihood;
 }
 
+/**
+ * Fold new observations into the model with one online step.
+ */
+template<typename FittingType>
+void GMM::Update(const arma::mat& observations, FittingType& fitter)
+{
+  fitter.Update(observations, dists, weights);
+}
+
 /**
  * Serialize the object.
  */
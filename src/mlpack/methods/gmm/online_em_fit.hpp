@@ -0,0 +1,202 @@
+/**
+ * @file methods/gmm/online_em_fit.hpp
+ *
+ * Utility class to fit a GMM with online (stochastic) EM on minibatches of
+ * observations.  Used by GMM::Train<>(), DiagonalGMM::Train<>(), and the
+ * Update() methods of both models.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * This class fits a GMM to observations with the online EM algorithm of Cappé
+ * and Moulines:
+ *
+ * @code
+ * @article{cappe2009online,
+ *   title={On-line expectation-maximization algorithm for latent data
+ *       models},
+ *   author={Capp{\'e}, Olivier and Moulines, Eric},
+ *   journal={Journal of the Royal Statistical Society: Series B (Statistical
+ *       Methodology)},
+ *   volume={71},
+ *   number={3},
+ *   pages={593--613},
+ *   year={2009}
+ * }
+ * @endcode
+ *
+ * Each step computes the sufficient statistics of a minibatch (the
+ * responsibility of each component, and the first and second moments of the
+ * points weighted by it), and blends them into the statistics of the current
+ * model with the step size (t + t0)^(-kappa), where t is the number of steps
+ * taken so far.  The statistics of the model are given by its weights, means
+ * and covariances, so an existing model can be warm-started: new data is
+ * folded in with Update(), without refitting on the data it was trained on.
+ * For a model trained by another fitter, Steps() can be set beforehand so that
+ * the first step sizes reflect how much data the model has already seen.
+ *
+ * When used as the FittingType of GMM::Train() or DiagonalGMM::Train(), the
+ * observations are visited in shuffled minibatches for the given number of
+ * passes.  If the existing model is not used, it is first initialized by the
+ * initial clustering of EMFit on the first minibatch.
+ */
+template<typename InitialClusteringType = kmeans::KMeans<>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename Distribution = distribution::GaussianDistribution>
+class OnlineEMFit
+{
+ public:
+  /**
+   * Construct the OnlineEMFit object.
+   *
+   * @param batchSize Number of observations in each minibatch.
+   * @param passes Number of passes over the observations for Estimate().
+   * @param kappa Exponent of the step size; must be in (0.5, 1].
+   * @param t0 Offset of the step size; larger values give smaller first steps.
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Constraint policy of covariance.
+   */
+  OnlineEMFit(const size_t batchSize = 1000,
+              const size_t passes = 1,
+              const double kappa = 0.6,
+              const double t0 = 2.0,
+              InitialClusteringType clusterer = InitialClusteringType(),
+              CovarianceConstraintPolicy constraint =
+                  CovarianceConstraintPolicy());
+
+  /**
+   * Fit the observations to a Gaussian mixture model (GMM) with online EM over
+   * minibatches of the observations.  The size of the vectors (indicating the
+   * number of components) must already be set.  If useInitialModel is true,
+   * the given model is used as the initial model.
+   *
+   * @param observations List of observations to train on.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Fit the observations to a Gaussian mixture model (GMM) with online EM over
+   * minibatches of the observations, taking into account the probabilities of
+   * each point being from this mixture.
+   *
+   * @param observations List of observations to train on.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Take one online EM step on the given minibatch, updating the given model.
+   * The model must already be initialized.
+   *
+   * @param batch Minibatch of observations.
+   * @param dists Distributions of the model, to be updated.
+   * @param weights A priori weights of the model, to be updated.
+   */
+  void Update(const arma::mat& batch,
+              std::vector<Distribution>& dists,
+              arma::vec& weights);
+
+  /**
+   * Take one online EM step on the given minibatch, taking into account the
+   * probabilities of each point being from this mixture.
+   *
+   * @param batch Minibatch of observations.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Distributions of the model, to be updated.
+   * @param weights A priori weights of the model, to be updated.
+   */
+  void Update(const arma::mat& batch,
+              const arma::vec& probabilities,
+              std::vector<Distribution>& dists,
+              arma::vec& weights);
+
+  //! Get the number of observations in each minibatch.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of observations in each minibatch.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the number of passes over the observations.
+  size_t Passes() const { return passes; }
+  //! Modify the number of passes over the observations.
+  size_t& Passes() { return passes; }
+
+  //! Get the exponent of the step size.
+  double Kappa() const { return kappa; }
+  //! Modify the exponent of the step size.
+  double& Kappa() { return kappa; }
+
+  //! Get the offset of the step size.
+  double T0() const { return t0; }
+  //! Modify the offset of the step size.
+  double& T0() { return t0; }
+
+  //! Get the number of steps taken so far.
+  size_t Steps() const { return steps; }
+  //! Modify the number of steps taken so far.
+  size_t& Steps() { return steps; }
+
+  //! Get the clusterer.
+  const InitialClusteringType& Clusterer() const { return clusterer; }
+  //! Modify the clusterer.
+  InitialClusteringType& Clusterer() { return clusterer; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+  //! Serialize the fitter.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t version);
+
+ private:
+  //! Number of observations in each minibatch.
+  size_t batchSize;
+  //! Number of passes over the observations for Estimate().
+  size_t passes;
+  //! Exponent of the step size.
+  double kappa;
+  //! Offset of the step size.
+  double t0;
+  //! Number of steps taken so far.
+  size_t steps;
+  //! Object which will perform the clustering.
+  InitialClusteringType clusterer;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+// Include implementation.
+#include "online_em_fit_impl.hpp"
+
+#endif
@@ -0,0 +1,226 @@
+/**
+ * @file methods/gmm/online_em_fit_impl.hpp
+ *
+ * Implementation of online EM for fitting GMMs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "online_em_fit.hpp"
+#include <mlpack/core/math/log_add.hpp>
+
+namespace mlpack {
+namespace gmm {
+
+//! Constructor.
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+OnlineEMFit(const size_t batchSize,
+            const size_t passes,
+            const double kappa,
+            const double t0,
+            InitialClusteringType clusterer,
+            CovarianceConstraintPolicy constraint) :
+    batchSize(batchSize),
+    passes(passes),
+    kappa(kappa),
+    t0(t0),
+    steps(0),
+    clusterer(clusterer),
+    constraint(constraint)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("OnlineEMFit::OnlineEMFit(): batchSize must "
+        "be positive!");
+  }
+
+  if (kappa <= 0.5 || kappa > 1.0)
+  {
+    throw std::invalid_argument("OnlineEMFit::OnlineEMFit(): kappa must be in "
+        "(0.5, 1]!");
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  Estimate(observations, arma::ones<arma::vec>(observations.n_cols), dists,
+      weights, useInitialModel);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            const arma::vec& probabilities,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  // A new model starts a new step size schedule.
+  bool initialized = useInitialModel;
+  if (!useInitialModel)
+    steps = 0;
+
+  for (size_t pass = 0; pass < passes; ++pass)
+  {
+    const arma::uvec order = arma::randperm(observations.n_cols);
+    for (size_t begin = 0; begin < observations.n_cols; begin += batchSize)
+    {
+      const size_t end = std::min(begin + batchSize,
+          (size_t) observations.n_cols);
+      const arma::uvec indices = order.subvec(begin, end - 1);
+      const arma::mat batch = observations.cols(indices);
+      const arma::vec batchProbabilities = probabilities.elem(indices);
+
+      // The initial model is fit on the first minibatch with the initial
+      // clustering of EMFit.
+      if (!initialized)
+      {
+        EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>
+            fitter(1, 1e-10, clusterer, constraint);
+        fitter.Estimate(batch, batchProbabilities, dists, weights, false);
+        initialized = true;
+        continue;
+      }
+
+      Update(batch, batchProbabilities, dists, weights);
+    }
+
+    Log::Info << "OnlineEMFit::Estimate(): pass " << pass << " done, "
+        << steps << " steps taken." << std::endl;
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Update(const arma::mat& batch,
+                          std::vector<Distribution>& dists,
+                          arma::vec& weights)
+{
+  Update(batch, arma::ones<arma::vec>(batch.n_cols), dists, weights);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Update(const arma::mat& batch,
+                          const arma::vec& probabilities,
+                          std::vector<Distribution>& dists,
+                          arma::vec& weights)
+{
+  // If the distribution is DiagonalGaussianDistribution, only the diagonal
+  // components of the covariances are updated.
+  const bool isDiagGaussDist = std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value;
+
+  // E-step: compute the responsibilities of each component for the minibatch.
+  arma::mat resp(dists.size(), batch.n_cols);
+  arma::vec logProbs;
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    dists[i].LogProbability(batch, logProbs);
+    resp.row(i) = trans(logProbs) + std::log(weights[i]);
+  }
+
+  for (size_t j = 0; j < batch.n_cols; ++j)
+  {
+    // Avoid dividing by zero; if the probability for everything is 0, the
+    // point is not given to any component.
+    const double probSum = mlpack::math::AccuLog(resp.col(j));
+    if (probSum == -std::numeric_limits<double>::infinity())
+      resp.col(j).zeros();
+    else
+      resp.col(j) = arma::exp(resp.col(j) - probSum) * probabilities[j];
+  }
+
+  const double totalProbability = arma::accu(resp);
+  if (totalProbability == 0.0)
+    return;
+
+  // Blend the statistics of the minibatch into those of the model.  Both are
+  // centered on the current means, where the first moment of the model is
+  // zero and its second moment is its covariance.
+  const double stepSize = std::pow(steps + t0, -kappa);
+  arma::vec newWeights(dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    const double batchWeight = arma::accu(resp.row(i)) / totalProbability;
+    newWeights[i] = (1.0 - stepSize) * weights[i] + stepSize * batchWeight;
+
+    // Don't update if there's no probability of the Gaussian having points.
+    if (newWeights[i] == 0.0)
+      continue;
+
+    const arma::mat centered = batch.each_col() - dists[i].Mean();
+    const arma::mat weighted = centered.each_row() % resp.row(i);
+    const arma::vec shift = stepSize * arma::sum(weighted, 1) /
+        (totalProbability * newWeights[i]);
+
+    if (isDiagGaussDist)
+    {
+      arma::vec covariance = ((1.0 - stepSize) * weights[i] *
+          dists[i].Covariance() + stepSize * arma::sum(weighted % centered, 1) /
+          totalProbability) / newWeights[i] - arma::square(shift);
+
+      // Apply covariance constraint.
+      constraint.ApplyConstraint(covariance);
+      dists[i].Covariance(std::move(covariance));
+    }
+    else
+    {
+      arma::mat covariance = ((1.0 - stepSize) * weights[i] *
+          dists[i].Covariance() + stepSize * weighted * trans(centered) /
+          totalProbability) / newWeights[i] - shift * trans(shift);
+
+      // Apply covariance constraint.
+      constraint.ApplyConstraint(covariance);
+      dists[i].Covariance(std::move(covariance));
+    }
+
+    dists[i].Mean() += shift;
+  }
+
+  weights = std::move(newWeights);
+  ++steps;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+template<typename Archive>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(batchSize));
+  ar(CEREAL_NVP(passes));
+  ar(CEREAL_NVP(kappa));
+  ar(CEREAL_NVP(t0));
+  ar(CEREAL_NVP(steps));
+  ar(CEREAL_NVP(clusterer));
+  ar(CEREAL_NVP(constraint));
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
@@ -158,6 +158,8 @@ class HMM
    * log-likelihood of the model between iterations is less than the tolerance,
    * the Baum-Welch algorithm terminates.
    *
+   * The sequences are processed in parallel with OpenMP, if available.
+   *
    * @note
    * Train() can be called multiple times with different sequences; each time it
    * is called, it uses the current parameters of the HMM as a starting point
@@ -290,6 +292,32 @@ class HMM
    */
   double LogLikelihood(const arma::mat& dataSeq) const;
 
+  /**
+   * Compute the most probable hidden state sequence for each of the given data
+   * sequences, using the Viterbi algorithm.  The sequences are processed in
+   * parallel with OpenMP, if available.
+   *
+   * @param dataSeqs Sequences of observations.
+   * @param stateSeqs Vector in which the most probable state sequence of each
+   *    data sequence will be stored.
+   * @param logLikelihoods Vector in which the log-likelihood of the most
+   *    probable state sequence of each data sequence will be stored.
+   */
+  void Predict(const std::vector<arma::mat>& dataSeqs,
+               std::vector<arma::Row<size_t>>& stateSeqs,
+               arma::vec& logLikelihoods) const;
+
+  /**
+   * Compute the log-likelihood of each of the given data sequences.  The
+   * sequences are processed in parallel with OpenMP, if available.
+   *
+   * @param dataSeqs Data sequences to evaluate the likelihood of.
+   * @param logLikelihoods Vector in which the log-likelihood of each sequence
+   *    will be stored.
+   */
+  void LogLikelihood(const std::vector<arma::mat>& dataSeqs,
+                     arma::vec& logLikelihoods) const;
+
   /**
    * Compute the log of the scaling factor of the given emission probability
    * at time t. To calculate the log-likelihood for the whole sequence,
@@ -539,6 +567,25 @@ class HMM
    * Should be removed in mlpack 4.0.
    */
   mutable bool recalculateTransition;
+
+  /**
+   * Update the sparse copy of the transition matrix from logTransition.  This
+   * must be called whenever logTransition changes.
+   */
+  void SparsifyTransition() const;
+
+  /**
+   * Sparse copy of the transition matrix (in linear space), used instead of
+   * logTransition by Forward(), Backward(), Predict() and Train() when most
+   * transitions are impossible (as in left-to-right HMMs).
+   */
+  mutable arma::sp_mat sparseTransition;
+
+  //! Log of the nonzero values of sparseTransition, in storage order.
+  mutable arma::vec sparseLogTransition;
+
+  //! Whether sparseTransition is used.
+  mutable bool useSparseTransition;
 };
 
 } // namespace hmm
@@ -44,6 +44,7 @@ HMM<Distribution>::HMM(const size_t states,
 
   logTransition = log(transitionProxy);
   logInitial = log(initialProxy);
+  SparsifyTransition();
 }
 
 /**
@@ -74,6 +75,8 @@ HMM<Distribution>::HMM(const arma::vec& initial,
         << std::endl;
     dimensionality = 0;
   }
+
+  SparsifyTransition();
 }
 
 /**
@@ -114,10 +117,24 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   }
 
   // These are used later for training of each distribution.  We initialize it
-  // all now so we don't have to do any allocation later on.
+  // all now so we don't have to do any allocation later on.  The observations
+  // do not change between iterations, so they are only copied once; each
+  // sequence owns the columns starting at its offset.
   std::vector<arma::vec> emissionProb(logTransition.n_cols,
       arma::vec(totalLength));
   arma::mat emissionList(dimensionality, totalLength);
+  std::vector<size_t> offsets(dataSeq.size());
+  size_t sumTime = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    offsets[seq] = sumTime;
+    if (dataSeq[seq].n_cols > 0)
+    {
+      emissionList.cols(sumTime, sumTime + dataSeq[seq].n_cols - 1) =
+          dataSeq[seq];
+    }
+    sumTime += dataSeq[seq].n_cols;
+  }
 
   // This should be the Baum-Welch algorithm (EM for HMM estimation). This
   // follows the procedure outlined in Elliot, Aggoun, and Moore's book "Hidden
@@ -133,70 +150,108 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
     // Reset log likelihood.
     loglik = 0;
 
-    // Sum over time.
-    size_t sumTime = 0;
+    // The sequences are processed in parallel, so the log-space parameters
+    // must be up to date before any thread reads them.
+    ConvertToLogSpace();
 
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    #pragma omp parallel reduction(+:loglik)
     {
-      arma::mat stateLogProb;
-      arma::mat forwardLog;
-      arma::mat backwardLog;
-      arma::vec logScales;
-
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += LogEstimate(dataSeq[seq], stateLogProb, forwardLog,
-          backwardLog, logScales);
-
-      // Add to estimate of initial probability for state j.
-      math::LogSumExp<arma::vec, true>(stateLogProb.unsafe_col(0),
-          newLogInitial);
-
-      // Define a variable to store the value of log-probability for data.
-      arma::mat logProbs(dataSeq[seq].n_cols, logTransition.n_rows);
-      // Save the values of log-probability to logProbs.
-      for (size_t i = 0; i < logTransition.n_rows; i++)
-      {
-        // Define alias of desired column.
-        arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
-        // Use advanced constructor for using logProbs directly.
-        emission[i].LogProbability(dataSeq[seq], alias);
-      }
-
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+      // Each thread accumulates its own estimates, which are combined at the
+      // end.
+      arma::vec localLogInitial(newLogInitial);
+      arma::mat localLogTransition(newLogTransition);
+
+      // Loop over each sequence.
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); seq++)
       {
-        // Assemble temporary vector that's used in log-sum computation.
-        if (t < dataSeq[seq].n_cols - 1)
+        arma::mat stateLogProb;
+        arma::mat forwardLog;
+        arma::mat backwardLog;
+        arma::vec logScales;
+
+        // Add the log-likelihood of this sequence.  This is the E-step.
+        loglik += LogEstimate(dataSeq[seq], stateLogProb, forwardLog,
+            backwardLog, logScales);
+
+        // Add to estimate of initial probability for state j.
+        math::LogSumExp<arma::vec, true>(stateLogProb.unsafe_col(0),
+            localLogInitial);
+
+        // Define a variable to store the value of log-probability for data.
+        arma::mat logProbs(dataSeq[seq].n_cols, logTransition.n_rows);
+        // Save the values of log-probability to logProbs.
+        for (size_t i = 0; i < logTransition.n_rows; i++)
         {
-          // This term is the same across all states, so compute it once and
-          // cache it.
-          const arma::vec tmp = backwardLog.col(t + 1) +
-              logProbs.row(t + 1).t() - logScales[t + 1];
-          arma::vec output;
-          math::LogSumExp(tmp, output);
+          // Define alias of desired column.
+          arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
+          // Use advanced constructor for using logProbs directly.
+          emission[i].LogProbability(dataSeq[seq], alias);
+        }
 
-          for (size_t j = 0; j < logTransition.n_cols; ++j)
+        // Now re-estimate the parameters.  This is the M-step.
+        //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+        //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t])
+        //           b(i, t + 1)))
+        //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t)
+        //           b(i, t)
+        // We store the new estimates in a different matrix.
+        for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+        {
+          // Assemble temporary vector that's used in log-sum computation.
+          if (t < dataSeq[seq].n_cols - 1)
           {
+            // This term is the same across all states, so compute it once and
+            // cache it.
+            const arma::vec tmp = backwardLog.col(t + 1) +
+                logProbs.row(t + 1).t() - logScales[t + 1];
+            arma::vec output;
+            math::LogSumExp(tmp, output);
+
             // Compute the estimate of T_ij (probability of transition from
             // state j to state i).  We postpone multiplication of the old T_ij
-            // until later.
-            arma::vec tmp2 = output + forwardLog(j, t);
-            arma::vec alias = newLogTransition.unsafe_col(j);
-            math::LogSumExp<arma::vec, true>(tmp2, alias);
+            // until later, so impossible transitions can be skipped.
+            if (useSparseTransition)
+            {
+              for (size_t j = 0; j < sparseTransition.n_cols; ++j)
+              {
+                for (size_t k = sparseTransition.col_ptrs[j];
+                     k < sparseTransition.col_ptrs[j + 1]; ++k)
+                {
+                  const size_t i = sparseTransition.row_indices[k];
+                  localLogTransition(i, j) = math::LogAdd(
+                      localLogTransition(i, j), output[i] + forwardLog(j, t));
+                }
+              }
+            }
+            else
+            {
+              for (size_t j = 0; j < logTransition.n_cols; ++j)
+              {
+                arma::vec tmp2 = output + forwardLog(j, t);
+                arma::vec alias = localLogTransition.unsafe_col(j);
+                math::LogSumExp<arma::vec, true>(tmp2, alias);
+              }
+            }
           }
+
+          // Add to list of emission probabilities, for
+          // Distribution::Train().
+          for (size_t j = 0; j < logTransition.n_cols; ++j)
+            emissionProb[j][offsets[seq] + t] = exp(stateLogProb(j, t));
         }
+      }
 
-        // Add to list of emission observations, for Distribution::Train().
+      // Combine the estimates of each thread.
+      #pragma omp critical
+      {
+        math::LogSumExp<arma::vec, true>(localLogInitial, newLogInitial);
         for (size_t j = 0; j < logTransition.n_cols; ++j)
-          emissionProb[j][sumTime] = exp(stateLogProb(j, t));
-        emissionList.col(sumTime) = dataSeq[seq].col(t);
-        sumTime++;
+        {
+          arma::vec alias = newLogTransition.unsafe_col(j);
+          math::LogSumExp<arma::vec, true>(localLogTransition.unsafe_col(j),
+              alias);
+        }
       }
     }
 
@@ -232,6 +287,7 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
 
     initialProxy = exp(logInitial);
     transitionProxy = exp(logTransition);
+    SparsifyTransition();
     // Now estimate emission probabilities.
     for (size_t state = 0; state < logTransition.n_cols; state++)
       emission[state].Train(emissionList, emissionProb[state]);
@@ -317,6 +373,7 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq,
   transitionProxy = transition;
   logTransition = log(transition);
   logInitial = log(initial);
+  SparsifyTransition();
 
   // Estimate emission matrix.
   for (size_t state = 0; state < transition.n_cols; state++)
@@ -527,11 +584,36 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
     // Assemble the state probability for this element.
     // Given that we are in state j, we use state with the highest probability
     // of being the previous state.
-    for (size_t j = 0; j < logTransition.n_rows; j++)
+    if (useSparseTransition)
+    {
+      // Only the possible transitions are considered; the previous states are
+      // visited in order, so ties are broken as in the dense case.
+      logStateProb.col(t).fill(-std::numeric_limits<double>::infinity());
+      stateSeqBack.col(t).zeros();
+      for (size_t i = 0; i < sparseTransition.n_cols; ++i)
+      {
+        for (size_t k = sparseTransition.col_ptrs[i];
+             k < sparseTransition.col_ptrs[i + 1]; ++k)
+        {
+          const size_t j = sparseTransition.row_indices[k];
+          const double prob = logStateProb(i, t - 1) + sparseLogTransition[k];
+          if (prob > logStateProb(j, t))
+          {
+            logStateProb(j, t) = prob;
+            stateSeqBack(j, t) = i;
+          }
+        }
+      }
+      logStateProb.col(t) += logProbs.row(t).t();
+    }
+    else
     {
-      arma::vec prob = logStateProb.col(t - 1) + logTransition.row(j).t();
-      logStateProb(j, t) = prob.max(index) + logProbs(t, j);
-      stateSeqBack(j, t) = index;
+      for (size_t j = 0; j < logTransition.n_rows; j++)
+      {
+        arma::vec prob = logStateProb.col(t - 1) + logTransition.row(j).t();
+        logStateProb(j, t) = prob.max(index) + logProbs(t, j);
+        stateSeqBack(j, t) = index;
+      }
     }
   }
 
@@ -574,6 +656,43 @@ double HMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
   return accu(logScales);
 }
 
+/**
+ * Compute the most probable hidden state sequence of each of the given data
+ * sequences in parallel.
+ */
+template<typename Distribution>
+void HMM<Distribution>::Predict(const std::vector<arma::mat>& dataSeqs,
+                                std::vector<arma::Row<size_t>>& stateSeqs,
+                                arma::vec& logLikelihoods) const
+{
+  stateSeqs.resize(dataSeqs.size());
+  logLikelihoods.set_size(dataSeqs.size());
+
+  // Make sure no thread has to update the log-space parameters.
+  ConvertToLogSpace();
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) dataSeqs.size(); ++i)
+    logLikelihoods[i] = Predict(dataSeqs[i], stateSeqs[i]);
+}
+
+/**
+ * Compute the log-likelihood of each of the given data sequences in parallel.
+ */
+template<typename Distribution>
+void HMM<Distribution>::LogLikelihood(const std::vector<arma::mat>& dataSeqs,
+                                      arma::vec& logLikelihoods) const
+{
+  logLikelihoods.set_size(dataSeqs.size());
+
+  // Make sure no thread has to update the log-space parameters.
+  ConvertToLogSpace();
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) dataSeqs.size(); ++i)
+    logLikelihoods[i] = LogLikelihood(dataSeqs[i]);
+}
+
 /**
  * Compute the log of the scaling factor of the given emission probability
  * at time t. To calculate the log-likelihood for the whole sequence,
@@ -750,9 +869,19 @@ arma::vec HMM<Distribution>::ForwardAtTn(const arma::vec& emissionLogProb,
   // and emitting the given observation.  To do this computation in log-space,
   // we can use LogSumExp().
   arma::vec forwardLogProb;
-  arma::mat tmp = logTransition + repmat(prevForwardLogProb.t(),
-      logTransition.n_rows, 1);
-  math::LogSumExp(tmp, forwardLogProb);
+  if (useSparseTransition)
+  {
+    // The previous forward probabilities are normalized, so they can be taken
+    // out of log-space for a sparse matrix-vector product.
+    forwardLogProb = arma::log(sparseTransition *
+        arma::exp(prevForwardLogProb));
+  }
+  else
+  {
+    arma::mat tmp = logTransition + repmat(prevForwardLogProb.t(),
+        logTransition.n_rows, 1);
+    math::LogSumExp(tmp, forwardLogProb);
+  }
   forwardLogProb += emissionLogProb;
 
   // Normalize probability.
@@ -817,11 +946,28 @@ void HMM<Distribution>::Backward(const arma::mat& dataSeq,
     // from the current state multiplied by the probability of each of those
     // states emitting the given observation.  To compute this in log-space, we
     // can use LogSumExpT().
-    const arma::mat tmp = logTransition +
-        repmat(backwardLogProb.col(t + 1), 1, logTransition.n_cols) +
-        repmat(logProbs.row(t + 1).t(), 1, logTransition.n_cols);
-    arma::vec alias = backwardLogProb.unsafe_col(t);
-    math::LogSumExpT<arma::mat, true>(tmp, alias);
+    if (useSparseTransition)
+    {
+      // Shift the terms by their maximum so that they can be taken out of
+      // log-space for a sparse vector-matrix product.
+      const arma::vec next = backwardLogProb.col(t + 1) +
+          logProbs.row(t + 1).t();
+      const double maxNext = next.max();
+      if (std::isfinite(maxNext))
+      {
+        const arma::rowvec sums = arma::exp(next - maxNext).t() *
+            sparseTransition;
+        backwardLogProb.col(t) = arma::log(sums.t()) + maxNext;
+      }
+    }
+    else
+    {
+      const arma::mat tmp = logTransition +
+          repmat(backwardLogProb.col(t + 1), 1, logTransition.n_cols) +
+          repmat(logProbs.row(t + 1).t(), 1, logTransition.n_cols);
+      arma::vec alias = backwardLogProb.unsafe_col(t);
+      math::LogSumExpT<arma::mat, true>(tmp, alias);
+    }
 
     // Normalize by the weights from the forward algorithm.
     if (std::isfinite(logScales[t + 1]))
@@ -846,6 +992,31 @@ void HMM<Distribution>::ConvertToLogSpace() const
   {
     logTransition = log(transitionProxy);
     recalculateTransition = false;
+    SparsifyTransition();
+  }
+}
+
+/**
+ * Keep a sparse copy of the transition matrix if most transitions are
+ * impossible.
+ */
+template<typename Distribution>
+void HMM<Distribution>::SparsifyTransition() const
+{
+  sparseTransition = arma::sp_mat(arma::exp(logTransition));
+
+  // With more nonzeros, the dense log-space computations are faster.
+  useSparseTransition = (4 * sparseTransition.n_nonzero <=
+      sparseTransition.n_elem);
+  if (useSparseTransition)
+  {
+    sparseLogTransition = arma::log(arma::vec(sparseTransition.values,
+        sparseTransition.n_nonzero));
+  }
+  else
+  {
+    sparseTransition.reset();
+    sparseLogTransition.reset();
   }
 }
 
@@ -871,6 +1042,7 @@ void HMM<Distribution>::load(Archive& ar, const uint32_t /* version */)
   logInitial = log(initial);
   initialProxy = std::move(initial);
   transitionProxy = std::move(transition);
+  SparsifyTransition();
 }
 
 //! Serialize the HMM.
@@ -106,6 +106,16 @@ class BinaryNumericSplit
   //! The probability of the majority class given the points seen so far.
   double MajorityProbability() const;
 
+  //! The number of bytes used by the object and the points seen so far (each
+  //! element of the multimap is counted with the three pointers and the color
+  //! of its tree node).
+  size_t MemoryUsage() const
+  {
+    return sizeof(*this) + classCounts.n_elem * sizeof(size_t) +
+        sortedElements.size() * (sizeof(std::pair<const ObservationType,
+        size_t>) + 4 * sizeof(void*));
+  }
+
   //! Serialize the object.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
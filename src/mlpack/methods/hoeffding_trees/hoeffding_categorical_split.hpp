@@ -106,6 +106,12 @@ class HoeffdingCategoricalSplit
   //! Get the probability of the majority class given the points seen so far.
   double MajorityProbability() const;
 
+  //! Get the number of bytes used by the object and its statistics.
+  size_t MemoryUsage() const
+  {
+    return sizeof(*this) + sufficientStatistics.n_elem * sizeof(size_t);
+  }
+
   //! Serialize the categorical split.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
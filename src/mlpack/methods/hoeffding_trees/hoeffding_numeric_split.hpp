@@ -119,12 +119,21 @@ class HoeffdingNumericSplit
   //! Return the number of bins.
   size_t Bins() const { return bins; }
 
+  //! Return the number of bytes used by the object and its statistics.
+  size_t MemoryUsage() const
+  {
+    return sizeof(*this) + (observations.n_elem + splitPoints.n_elem) *
+        sizeof(ObservationType) + (labels.n_elem +
+        sufficientStatistics.n_elem) * sizeof(size_t);
+  }
+
   //! Serialize the object.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
 
  private:
-  //! Before binning, this holds the points we have seen so far.
+  //! Before binning, this holds the points we have seen so far (it is only
+  //! allocated when the first point is seen, and freed after binning).
   arma::Col<ObservationType> observations;
   //! This holds the labels of the points before binning.
   arma::Col<size_t> labels;
@@ -22,30 +22,24 @@ HoeffdingNumericSplit<FitnessFunction, ObservationType>::HoeffdingNumericSplit(
     const size_t numClasses,
     const size_t bins,
     const size_t observationsBeforeBinning) :
-    observations(observationsBeforeBinning - 1),
-    labels(observationsBeforeBinning - 1),
     bins(bins),
     observationsBeforeBinning(observationsBeforeBinning),
     samplesSeen(0),
     sufficientStatistics(arma::zeros<arma::Mat<size_t>>(numClasses, bins))
 {
-  observations.zeros();
-  labels.zeros();
+  // Nothing to do.
 }
 
 template<typename FitnessFunction, typename ObservationType>
 HoeffdingNumericSplit<FitnessFunction, ObservationType>::HoeffdingNumericSplit(
     const size_t numClasses,
     const HoeffdingNumericSplit& other) :
-    observations(other.observationsBeforeBinning - 1),
-    labels(other.observationsBeforeBinning - 1),
     bins(other.bins),
     observationsBeforeBinning(other.observationsBeforeBinning),
     samplesSeen(0),
     sufficientStatistics(arma::zeros<arma::Mat<size_t>>(numClasses, bins))
 {
-  observations.zeros();
-  labels.zeros();
+  // Nothing to do.
 }
 
 template<typename FitnessFunction, typename ObservationType>
@@ -55,6 +49,14 @@ void HoeffdingNumericSplit<FitnessFunction, ObservationType>::Train(
 {
   if (samplesSeen < observationsBeforeBinning - 1)
   {
+    // The buffer of points before binning is only allocated when it is needed,
+    // so that untrained splits take little memory.
+    if (samplesSeen == 0)
+    {
+      observations.zeros(observationsBeforeBinning - 1);
+      labels.zeros(observationsBeforeBinning - 1);
+    }
+
     // Add this to the samples we have seen.
     observations[samplesSeen] = value;
     labels[samplesSeen] = label;
@@ -92,6 +94,10 @@ void HoeffdingNumericSplit<FitnessFunction, ObservationType>::Train(
 
       sufficientStatistics(labels[i], bin)++;
     }
+
+    // The points are not needed anymore.
+    observations.clear();
+    labels.clear();
   }
 
   // If we've gotten to here, then we need to add the point to the sufficient
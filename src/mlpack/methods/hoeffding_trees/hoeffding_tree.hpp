@@ -186,6 +186,11 @@ class HoeffdingTree
    * the given labels.  If `resetTree` is set to `true`, then reset the state of
    * the tree to an empty tree before training.
    *
+   * In streaming mode the points are treated as a minibatch of the stream:
+   * the result is the same as passing them one at a time to `Train()`, but the
+   * points of each leaf are handled together, and the statistics of all the
+   * dimensions are updated in parallel.
+   *
    * Note that the tree will be automatically reset if the dimensionality of
    * `data` does not match the dimensionality that the tree was currently
    * trained with.  The tree will also be reset if `numClasses` is passed.
@@ -285,6 +290,31 @@ class HoeffdingTree
   //! Modify the number of samples before a split check is performed.
   void CheckInterval(const size_t checkInterval);
 
+  //! Get the maximum number of bytes of split statistics (0 means no limit).
+  size_t MemoryLimit() const { return memoryLimit; }
+  /**
+   * Modify the maximum number of bytes the split statistics of the tree may
+   * use (0 means no limit).  The limit is enforced at the end of each call to
+   * Train() with a set of points, and every checkInterval calls to Train()
+   * with a single point, as in VFDT: if the statistics of the leaves do not
+   * fit, the least promising leaves (those with the fewest points times the
+   * smallest error rate) are deactivated, and inactive leaves that become more
+   * promising than active ones are reactivated when they fit.  An inactive
+   * leaf keeps its majority class but does not collect statistics, so it
+   * cannot split.  With a limit, a leaf also stops collecting statistics for
+   * dimensions that the Hoeffding bound shows cannot be its best split.
+   *
+   * The split types must provide MemoryUsage().
+   */
+  void MemoryLimit(const size_t memoryLimit);
+
+  //! Get the number of bytes used by the split statistics of the tree.
+  size_t MemoryUsage() const;
+
+  //! Get whether this node collects statistics (it is false for leaves that
+  //! have been deactivated because of the memory limit).
+  bool Active() const { return active; }
+
   /**
    * Given a point and that this node is not a leaf, calculate the index of the
    * child node this point would go towards.  This method is primarily used by
@@ -387,6 +417,17 @@ class HoeffdingTree
   bool ownsInfo;
   //! The required probability of success for a split to be performed.
   double successProbability;
+  //! The maximum number of bytes of split statistics (0 means no limit).
+  size_t memoryLimit;
+  //! Whether this leaf collects statistics.
+  bool active;
+  //! The number of points this leaf has seen, whether or not it was active.
+  size_t seenSamples;
+  //! If not empty, the dimensions whose statistics have been dropped.
+  std::vector<bool> droppedDimensions;
+  //! The number of single points trained on since the memory limit was last
+  //! enforced.
+  size_t pointsSinceMemoryCheck;
 
   // And we need to keep some information for after we have split.
 
@@ -413,6 +454,54 @@ class HoeffdingTree
                      const arma::Row<size_t>& labels,
                      const bool batchTraining);
 
+  /**
+   * Train on a single point, without enforcing the memory limit.
+   */
+  template<typename VecType>
+  void TrainPoint(const VecType& point, const size_t label);
+
+  /**
+   * Train in streaming mode on the given points (column indices into data),
+   * in order.  This gives the same tree as passing the points one at a time
+   * to Train(), but the statistics of a leaf are updated for a whole run of
+   * points at once (in parallel over the dimensions), where a run ends when
+   * the leaf reaches its next split check.
+   */
+  template<typename MatType>
+  void TrainStream(const MatType& data,
+                   const arma::Row<size_t>& labels,
+                   const arma::uvec& points);
+
+  //! Get whether the statistics of the given dimension have been dropped.
+  bool Dropped(const size_t dimension) const
+  {
+    return !droppedDimensions.empty() && droppedDimensions[dimension];
+  }
+
+  /**
+   * Replace the split object of the given dimension with an untrained one.  If
+   * allocate is false, the new object is created for zero classes, so it uses
+   * (almost) no memory but must not be trained.
+   */
+  void ClearSplit(const size_t dimension, const bool allocate);
+
+  //! Get the number of bytes the statistics of this leaf would use right after
+  //! being reset.
+  size_t ClearedMemoryUsage() const;
+
+  //! Stop collecting statistics at this leaf and free them.
+  void Deactivate();
+
+  //! Start collecting statistics at this (inactive) leaf again.
+  void Activate();
+
+  //! Add the leaves of the subtree of this node to the given vector.
+  void GatherLeaves(std::vector<HoeffdingTree*>& leaves);
+
+  //! Deactivate and reactivate leaves so that the statistics of the tree fit
+  //! in the memory limit.
+  void EnforceMemoryLimit();
+
   /**
    * Reset the tree.  This assumes datasetInfo is set correctly.
    */
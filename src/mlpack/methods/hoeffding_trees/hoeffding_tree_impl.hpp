@@ -49,6 +49,10 @@ HoeffdingTree<
     datasetInfo(new data::DatasetInfo(datasetInfoIn)),
     ownsInfo(true),
     successProbability(successProbability),
+    memoryLimit(0),
+    active(true),
+    seenSamples(0),
+    pointsSinceMemoryCheck(0),
     splitDimension(size_t(-1)),
     majorityClass(0),
     majorityProbability(0.0),
@@ -93,6 +97,10 @@ HoeffdingTree<
         &datasetInfo),
     ownsInfo(copyDatasetInfo),
     successProbability(successProbability),
+    memoryLimit(0),
+    active(true),
+    seenSamples(0),
+    pointsSinceMemoryCheck(0),
     splitDimension(size_t(-1)),
     majorityClass(0),
     majorityProbability(0.0),
@@ -141,6 +149,10 @@ HoeffdingTree<
     datasetInfo(new data::DatasetInfo()),
     ownsInfo(true),
     successProbability(0.95),
+    memoryLimit(0),
+    active(true),
+    seenSamples(0),
+    pointsSinceMemoryCheck(0),
     splitDimension(size_t(-1)),
     majorityClass(0),
     majorityProbability(0.0),
@@ -169,6 +181,11 @@ HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>::
     datasetInfo(new data::DatasetInfo(*other.datasetInfo)),
     ownsInfo(true),
     successProbability(other.successProbability),
+    memoryLimit(other.memoryLimit),
+    active(other.active),
+    seenSamples(other.seenSamples),
+    droppedDimensions(other.droppedDimensions),
+    pointsSinceMemoryCheck(other.pointsSinceMemoryCheck),
     splitDimension(other.splitDimension),
     majorityClass(other.majorityClass),
     majorityProbability(other.majorityProbability),
@@ -209,6 +226,11 @@ HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>::
     datasetInfo(other.datasetInfo),
     ownsInfo(true),
     successProbability(other.successProbability),
+    memoryLimit(other.memoryLimit),
+    active(other.active),
+    seenSamples(other.seenSamples),
+    droppedDimensions(other.droppedDimensions),
+    pointsSinceMemoryCheck(other.pointsSinceMemoryCheck),
     splitDimension(other.splitDimension),
     majorityClass(other.majorityClass),
     majorityProbability(other.majorityProbability),
@@ -253,6 +275,11 @@ HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>&
     datasetInfo = new data::DatasetInfo(*other.datasetInfo);
     ownsInfo = true;
     successProbability = other.successProbability;
+    memoryLimit = other.memoryLimit;
+    active = other.active;
+    seenSamples = other.seenSamples;
+    droppedDimensions = other.droppedDimensions;
+    pointsSinceMemoryCheck = other.pointsSinceMemoryCheck;
     splitDimension = other.splitDimension;
     majorityClass = other.majorityClass;
     majorityProbability = other.majorityProbability;
@@ -299,6 +326,11 @@ HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>&
     datasetInfo = other.datasetInfo;
     ownsInfo = true;
     successProbability = other.successProbability;
+    memoryLimit = other.memoryLimit;
+    active = other.active;
+    seenSamples = other.seenSamples;
+    droppedDimensions = other.droppedDimensions;
+    pointsSinceMemoryCheck = other.pointsSinceMemoryCheck;
     splitDimension = other.splitDimension;
     majorityClass = other.majorityClass;
     majorityProbability = other.majorityProbability;
@@ -370,6 +402,8 @@ void HoeffdingTree<
   }
 
   TrainInternal(data, labels, batchTraining);
+  if (memoryLimit > 0)
+    EnforceMemoryLimit();
 }
 
 //! Train on a set of points.
@@ -400,6 +434,8 @@ void HoeffdingTree<
 
   // Now train.
   TrainInternal(data, labels, batchTraining);
+  if (memoryLimit > 0)
+    EnforceMemoryLimit();
 }
 
 //! Train on one point.
@@ -412,18 +448,51 @@ void HoeffdingTree<
     NumericSplitType,
     CategoricalSplitType
 >::Train(const VecType& point, const size_t label)
+{
+  TrainPoint(point, label);
+
+  if (memoryLimit > 0 && ++pointsSinceMemoryCheck >= checkInterval)
+  {
+    pointsSinceMemoryCheck = 0;
+    EnforceMemoryLimit();
+  }
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename VecType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::TrainPoint(const VecType& point, const size_t label)
 {
   if (splitDimension == size_t(-1))
   {
+    ++seenSamples;
+
+    // An inactive leaf does not collect any statistics.
+    if (!active)
+      return;
+
     ++numSamples;
     size_t numericIndex = 0;
     size_t categoricalIndex = 0;
     for (size_t i = 0; i < point.n_rows; ++i)
     {
       if (datasetInfo->Type(i) == data::Datatype::categorical)
-        categoricalSplits[categoricalIndex++].Train(point[i], label);
+      {
+        if (!Dropped(i))
+          categoricalSplits[categoricalIndex].Train(point[i], label);
+        ++categoricalIndex;
+      }
       else if (datasetInfo->Type(i) == data::Datatype::numeric)
-        numericSplits[numericIndex++].Train(point[i], label);
+      {
+        if (!Dropped(i))
+          numericSplits[numericIndex].Train(point[i], label);
+        ++numericIndex;
+      }
     }
 
     // Grab majority class from splits.
@@ -455,7 +524,7 @@ void HoeffdingTree<
   {
     // Already split.  Pass the training point to the relevant child.
     size_t direction = CalculateDirection(point);
-    children[direction]->Train(point, label);
+    children[direction]->TrainPoint(point, label);
   }
 }
 
@@ -488,8 +557,14 @@ size_t HoeffdingTree<
   double largest = -DBL_MAX;
   size_t largestIndex = 0;
   double secondLargest = -DBL_MAX;
+  arma::vec gains(categoricalSplits.size() + numericSplits.size());
+  gains.fill(-DBL_MAX);
   for (size_t i = 0; i < categoricalSplits.size() + numericSplits.size(); ++i)
   {
+    // Dropped dimensions cannot be split on.
+    if (Dropped(i))
+      continue;
+
     size_t type = dimensionMappings->at(i).first;
     size_t index = dimensionMappings->at(i).second;
 
@@ -502,6 +577,7 @@ size_t HoeffdingTree<
           secondBestGain);
     else if (type == data::Datatype::numeric)
       numericSplits[index].EvaluateFitnessFunction(bestGain, secondBestGain);
+    gains[i] = bestGain;
 
     // See if these gains are better than the previous.
     if (bestGain > largest)
@@ -544,6 +620,29 @@ size_t HoeffdingTree<
   }
   else
   {
+    // With a memory limit, the statistics of the dimensions whose gain is
+    // more than epsilon below the best gain are dropped, since with
+    // probability successProbability they cannot become the best split (as in
+    // VFDT).  The split that gives the majority class is always kept.
+    if (memoryLimit > 0 && largest > 0.0)
+    {
+      for (size_t i = 0; i < gains.n_elem; ++i)
+      {
+        const std::pair<size_t, size_t>& mapping = dimensionMappings->at(i);
+        const bool majoritySplit = (mapping.second == 0) &&
+            ((categoricalSplits.size() > 0) ?
+            (mapping.first == data::Datatype::categorical) :
+            (mapping.first == data::Datatype::numeric));
+        if (Dropped(i) || majoritySplit || largest - gains[i] <= epsilon)
+          continue;
+
+        if (droppedDimensions.empty())
+          droppedDimensions.resize(gains.n_elem, false);
+        droppedDimensions[i] = true;
+        ClearSplit(i, true);
+      }
+    }
+
     return 0; // Don't split.
   }
 }
@@ -612,6 +711,208 @@ void HoeffdingTree<
     children[i]->CheckInterval(checkInterval);
 }
 
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::MemoryLimit(const size_t memoryLimit)
+{
+  this->memoryLimit = memoryLimit;
+  for (size_t i = 0; i < children.size(); ++i)
+    children[i]->MemoryLimit(memoryLimit);
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+size_t HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::MemoryUsage() const
+{
+  size_t memory = 0;
+  for (size_t i = 0; i < numericSplits.size(); ++i)
+    memory += numericSplits[i].MemoryUsage();
+  for (size_t i = 0; i < categoricalSplits.size(); ++i)
+    memory += categoricalSplits[i].MemoryUsage();
+  for (size_t i = 0; i < children.size(); ++i)
+    memory += children[i]->MemoryUsage();
+
+  return memory;
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::ClearSplit(const size_t dimension, const bool allocate)
+{
+  const size_t splitClasses = allocate ? numClasses : 0;
+  const std::pair<size_t, size_t>& mapping = dimensionMappings->at(dimension);
+  if (mapping.first == data::Datatype::categorical)
+  {
+    const size_t numCategories = allocate ?
+        datasetInfo->NumMappings(dimension) : 0;
+    categoricalSplits[mapping.second] = CategoricalSplitType<FitnessFunction>(
+        numCategories, splitClasses, categoricalSplits[mapping.second]);
+  }
+  else
+  {
+    numericSplits[mapping.second] = NumericSplitType<FitnessFunction>(
+        splitClasses, numericSplits[mapping.second]);
+  }
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+size_t HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::ClearedMemoryUsage() const
+{
+  size_t memory = 0;
+  if (numericSplits.size() > 0)
+  {
+    memory += numericSplits.size() * NumericSplitType<FitnessFunction>(
+        numClasses, numericSplits[0]).MemoryUsage();
+  }
+
+  for (size_t i = 0; i < categoricalSplits.size() + numericSplits.size(); ++i)
+  {
+    const std::pair<size_t, size_t>& mapping = dimensionMappings->at(i);
+    if (mapping.first == data::Datatype::categorical)
+    {
+      memory += CategoricalSplitType<FitnessFunction>(
+          datasetInfo->NumMappings(i), numClasses,
+          categoricalSplits[mapping.second]).MemoryUsage();
+    }
+  }
+
+  return memory;
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Deactivate()
+{
+  // The majority class and its probability are kept for classification.
+  for (size_t i = 0; i < categoricalSplits.size() + numericSplits.size(); ++i)
+    ClearSplit(i, false);
+
+  droppedDimensions.clear();
+  numSamples = 0;
+  active = false;
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Activate()
+{
+  for (size_t i = 0; i < categoricalSplits.size() + numericSplits.size(); ++i)
+    ClearSplit(i, true);
+
+  active = true;
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::GatherLeaves(std::vector<HoeffdingTree*>& leaves)
+{
+  if (splitDimension == size_t(-1))
+    leaves.push_back(this);
+
+  for (size_t i = 0; i < children.size(); ++i)
+    children[i]->GatherLeaves(leaves);
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::EnforceMemoryLimit()
+{
+  std::vector<HoeffdingTree*> leaves;
+  GatherLeaves(leaves);
+
+  // The promise of a leaf is the number of points it has seen times its error
+  // rate: this is (proportional to) the improvement in accuracy that can be
+  // expected from splitting it.
+  std::vector<std::pair<double, size_t>> promises(leaves.size());
+  for (size_t i = 0; i < leaves.size(); ++i)
+  {
+    promises[i] = std::make_pair(double(leaves[i]->seenSamples) *
+        (1.0 - leaves[i]->majorityProbability), i);
+  }
+  std::sort(promises.begin(), promises.end(),
+      std::greater<std::pair<double, size_t>>());
+
+  // Keep (or make) the most promising leaves active as long as their
+  // statistics fit.  (The empty split objects of inactive leaves take a little
+  // memory too.)
+  size_t memory = 0;
+  for (size_t i = 0; i < promises.size(); ++i)
+  {
+    HoeffdingTree* leaf = leaves[promises[i].second];
+    const size_t leafMemory = leaf->active ? leaf->MemoryUsage() :
+        leaf->ClearedMemoryUsage();
+    if (memory + leafMemory <= memoryLimit)
+    {
+      if (!leaf->active)
+        leaf->Activate();
+      memory += leafMemory;
+    }
+    else
+    {
+      if (leaf->active)
+        leaf->Deactivate();
+      memory += leaf->MemoryUsage();
+    }
+  }
+}
+
 template<
     typename FitnessFunction,
     template<typename> class NumericSplitType,
@@ -806,6 +1107,7 @@ void HoeffdingTree<
     }
 
     children[i]->MajorityClass() = childMajorities[i];
+    children[i]->memoryLimit = memoryLimit;
   }
 
   // Eliminate now-unnecessary split information.
@@ -888,6 +1190,12 @@ void HoeffdingTree<
       categoricalSplit = typename CategoricalSplitType<FitnessFunction>::
           SplitInfo(numClasses);
       numericSplit = typename NumericSplitType<FitnessFunction>::SplitInfo();
+
+      // Inactive leaves are saved without statistics, so they are loaded as
+      // active leaves that have not seen any points.
+      active = true;
+      seenSamples = numSamples;
+      droppedDimensions.clear();
     }
 
     // There's no need to serialize if there's no information contained in the
@@ -956,7 +1264,7 @@ void HoeffdingTree<
     size_t oldMaxSamples = maxSamples;
     maxSamples = std::max(size_t(data.n_cols - 1), size_t(5));
     for (size_t i = 0; i < data.n_cols; ++i)
-      Train(data.col(i), labels[i]);
+      TrainPoint(data.col(i), labels[i]);
     maxSamples = oldMaxSamples;
 
     // Now, if we did split, find out which points go to which child, and
@@ -1001,15 +1309,135 @@ void HoeffdingTree<
         // unfortunately, instead, we'll just extract the non-contiguous
         // submatrix.
         MatType childData = data.cols(indices[i].subvec(0, counts[i] - 1));
-        children[i]->Train(childData, childLabels, true);
+        children[i]->TrainInternal(childData, childLabels, true);
       }
     }
   }
   else
   {
-    // We aren't training in batch mode; loop through the points.
-    for (size_t i = 0; i < data.n_cols; ++i)
-      Train(data.col(i), labels[i]);
+    // We aren't training in batch mode; stream the points through the tree.
+    if (data.n_cols > 0)
+    {
+      const arma::uvec points = arma::regspace<arma::uvec>(0,
+          data.n_cols - 1);
+      TrainStream(data, labels, points);
+    }
+  }
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::TrainStream(const MatType& data,
+               const arma::Row<size_t>& labels,
+               const arma::uvec& points)
+{
+  if (splitDimension != size_t(-1))
+  {
+    // Already split.  Pass each point to the relevant child, keeping the
+    // points in order.
+    std::vector<arma::uvec> indices(children.size(),
+        arma::uvec(points.n_elem));
+    arma::Col<size_t> counts = arma::zeros<arma::Col<size_t>>(children.size());
+    for (size_t i = 0; i < points.n_elem; ++i)
+    {
+      const size_t direction = CalculateDirection(data.col(points[i]));
+      indices[direction][counts[direction]++] = points[i];
+    }
+
+    for (size_t i = 0; i < children.size(); ++i)
+    {
+      if (counts[i] > 0)
+      {
+        children[i]->TrainStream(data, labels,
+            indices[i].subvec(0, counts[i] - 1));
+      }
+    }
+
+    return;
+  }
+
+  // An inactive leaf does not collect any statistics.
+  if (!active)
+  {
+    seenSamples += points.n_elem;
+    return;
+  }
+
+  // Below this many updates, the statistics are not updated in parallel.
+  const size_t minParallelUpdates = 10000;
+
+  size_t begin = 0;
+  while (begin < points.n_elem)
+  {
+    // Take the points up to the next split check.
+    const size_t count = std::min(size_t(points.n_elem - begin),
+        checkInterval - (numSamples % checkInterval));
+    const size_t end = begin + count;
+
+    // The statistics of each dimension only depend on that dimension, so the
+    // dimensions can be updated independently.
+    #pragma omp parallel for if (count * data.n_rows >= minParallelUpdates)
+    for (omp_size_t d = 0; d < (omp_size_t) data.n_rows; ++d)
+    {
+      if (Dropped(d))
+        continue;
+
+      const std::pair<size_t, size_t>& mapping = dimensionMappings->at(d);
+      if (mapping.first == data::Datatype::categorical)
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          categoricalSplits[mapping.second].Train(data(d, points[i]),
+              labels[points[i]]);
+        }
+      }
+      else if (mapping.first == data::Datatype::numeric)
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          numericSplits[mapping.second].Train(data(d, points[i]),
+              labels[points[i]]);
+        }
+      }
+    }
+
+    numSamples += count;
+    seenSamples += count;
+    begin = end;
+
+    // Grab majority class from splits.
+    if (categoricalSplits.size() > 0)
+    {
+      majorityClass = categoricalSplits[0].MajorityClass();
+      majorityProbability = categoricalSplits[0].MajorityProbability();
+    }
+    else
+    {
+      majorityClass = numericSplits[0].MajorityClass();
+      majorityProbability = numericSplits[0].MajorityProbability();
+    }
+
+    // Check for a split, if we should.
+    if (numSamples % checkInterval == 0)
+    {
+      const size_t numChildren = SplitCheck();
+      if (numChildren > 0)
+      {
+        children.clear();
+        CreateChildren();
+
+        // The rest of the points go to the new children.
+        if (begin < points.n_elem)
+          TrainStream(data, labels, points.subvec(begin, points.n_elem - 1));
+        return;
+      }
+    }
   }
 }
 
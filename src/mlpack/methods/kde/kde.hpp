@@ -64,6 +64,15 @@ struct KDEDefaultParams
  * This implementation performs this estimation using a tree-independent
  * dual-tree algorithm. Details about this algorithm are available in KDERules.
  *
+ * If OpenMP is available, evaluations are split between threads on the query
+ * side: in single-tree mode each thread takes blocks of query points, and in
+ * dual-tree mode each thread takes disjoint subtrees of the query tree (except
+ * for tree types with self-children or overlapping children, which are
+ * traversed by a single thread).  All threads share the reference tree, and
+ * the error tolerances apply to each query point as in a serial evaluation.
+ * Monte Carlo estimations are reproducible for a given random seed and number
+ * of threads.
+ *
  * @tparam KernelType Kernel function to use for KDE calculations.
  * @tparam MetricType Metric to use for KDE calculations.
  * @tparam MatType Type of data to use.
@@ -225,6 +234,67 @@ class KDE
    */
   void Evaluate(arma::vec& estimations);
 
+  /**
+   * Add the given points to the reference set without rebuilding the reference
+   * tree.  The new points are held in a separate buffer whose contribution to
+   * each density is computed exactly, by brute force, and they are merged into
+   * the tree (along with the removal of any deleted points) when Rebuild() is
+   * called.  This happens automatically once the number of pending insertions
+   * and deletions exceeds RebuildFraction() times the number of points in the
+   * tree.
+   *
+   * The new points are given consecutive indices, starting with the returned
+   * value; these are the indices to pass to Delete().  Indices of existing
+   * points never change, even when the tree is rebuilt.  Points of the
+   * original reference set have the index of their column.
+   *
+   * This requires a tree type that rearranges the dataset (such as the kd-tree
+   * or ball tree).
+   *
+   * @pre The model has to be previously trained.
+   * @param points Points to add to the reference set.
+   * @return Index of the first inserted point.
+   */
+  size_t Insert(const MatType& points);
+
+  /**
+   * Remove the point with the given index from the reference set.  Points in
+   * the reference tree are only marked as deleted until the next call to
+   * Rebuild(): they no longer contribute to any density, and the number of
+   * deleted descendants of each node is kept in its statistic so that the
+   * error bounds only count the remaining points.  Monte Carlo estimations are
+   * not used for reference nodes with deleted descendants.  An exception is
+   * thrown if no point has the given index, or if it is the last point of the
+   * reference set.
+   *
+   * @pre The model has to be previously trained.
+   * @param index Index of the point to remove.
+   */
+  void Delete(const size_t index);
+
+  /**
+   * Rebuild the reference tree on the current reference set: pending inserted
+   * points are added to the tree and deleted points are removed from it.
+   * Indices of points are preserved.  The tree is built with the default
+   * parameters of its constructor.
+   */
+  void Rebuild();
+
+  //! Get the number of inserted points that are not in the reference tree yet.
+  size_t NumPending() const { return pendingSet.n_cols; }
+  //! Get the number of deleted points that are still in the reference tree.
+  size_t NumDeleted() const { return numDeleted; }
+
+  //! Get the number of base cases computed by the last evaluation.
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of node combinations scored by the last evaluation.
+  size_t Scores() const { return scores; }
+
+  //! Get the fraction of pending changes that triggers a rebuild.
+  double RebuildFraction() const { return rebuildFraction; }
+  //! Modify the fraction of pending changes that triggers a rebuild.
+  double& RebuildFraction() { return rebuildFraction; }
+
   //! Get the kernel.
   const KernelType& Kernel() const { return kernel; }
 
@@ -346,6 +416,76 @@ class KDE
   //! is the limit before Monte Carlo estimation recurses.
   double mcBreakCoef;
 
+  //! Inserted points that have not been added to the reference tree yet.
+  MatType pendingSet;
+  //! Indices of the points in pendingSet.
+  std::vector<size_t> pendingIds;
+  //! Points in the reference tree that have been deleted.  This is empty if no
+  //! points have been deleted since the tree was built.
+  std::vector<bool> deletedReferences;
+  //! The number of points marked in deletedReferences.
+  size_t numDeleted;
+  //! The index that the next inserted point will get (SIZE_MAX if it has not
+  //! been computed yet).
+  size_t nextIndex;
+  //! The position of each point in the reference tree, indexed by point index.
+  //! This is built when it is first needed.
+  std::vector<size_t> treePositions;
+  //! The fraction of pending changes that triggers a rebuild.
+  double rebuildFraction;
+  //! The number of base cases computed by the last evaluation.
+  size_t baseCases;
+  //! The number of node combinations scored by the last evaluation.
+  size_t scores;
+
+  /**
+   * Evaluate the given query set with single-tree traversals of the reference
+   * tree.  The query points are split into blocks that are traversed by
+   * different threads, each with its own rules.
+   *
+   * @param querySet Set of query points (the reference set if sameSet).
+   * @param estimations Vector of density estimations (already set to zero).
+   * @param sameSet Whether the query set is the reference set.
+   */
+  void SingleTreeEvaluate(const MatType& querySet,
+                          arma::vec& estimations,
+                          const bool sameSet);
+
+  /**
+   * Evaluate the given query tree with dual-tree traversals.  Unless the tree
+   * type has self-children or overlapping children, the query tree is split
+   * into disjoint subtrees that are traversed against the reference tree by
+   * different threads, each with its own rules.
+   *
+   * @param queryTree Query tree (the reference tree if sameSet).
+   * @param estimations Vector of density estimations (already set to zero).
+   * @param sameSet Whether the query tree is the reference tree.
+   */
+  void DualTreeEvaluate(Tree& queryTree,
+                        arma::vec& estimations,
+                        const bool sameSet);
+
+  //! Forget any pending insertions and deletions; this is used when the
+  //! reference set changes.
+  void ResetIncrementalState();
+
+  //! Prepare the object for Insert() or Delete(), and throw an exception if
+  //! that is not possible.
+  void PrepareUpdate(const std::string& method);
+
+  //! Rebuild the reference tree if there are any pending insertions or
+  //! deletions (if force is true), or if there are more of them than
+  //! RebuildFraction() allows (if force is false).
+  void FlushUpdates(const bool force);
+
+  //! Add the (unnormalized) contribution of the pending inserted points to the
+  //! density of each query point.
+  void AddPending(const MatType& querySet, arma::vec& estimations);
+
+  //! Return the number of points in the reference set, including pending
+  //! points and excluding deleted points.
+  size_t NumReferencePoints() const;
+
   //! Check whether absolute and relative error values are compatible.
   static void CheckErrorValues(const double relError, const double absError);
 
@@ -13,6 +13,8 @@
 #include "kde.hpp"
 #include "kde_rules.hpp"
 
+#include <mlpack/core/tree/parallel_subtrees.hpp>
+
 namespace mlpack {
 namespace kde {
 
@@ -72,7 +74,12 @@ KDE(const double relError,
     trained(false),
     mode(mode),
     monteCarlo(monteCarlo),
-    initialSampleSize(initialSampleSize)
+    initialSampleSize(initialSampleSize),
+    numDeleted(0),
+    nextIndex(SIZE_MAX),
+    rebuildFraction(0.1),
+    baseCases(0),
+    scores(0)
 {
   CheckErrorValues(relError, absError);
   MCProb(mcProb);
@@ -106,7 +113,16 @@ KDE(const KDE& other) :
     mcProb(other.mcProb),
     initialSampleSize(other.initialSampleSize),
     mcEntryCoef(other.mcEntryCoef),
-    mcBreakCoef(other.mcBreakCoef)
+    mcBreakCoef(other.mcBreakCoef),
+    pendingSet(other.pendingSet),
+    pendingIds(other.pendingIds),
+    deletedReferences(other.deletedReferences),
+    numDeleted(other.numDeleted),
+    nextIndex(other.nextIndex),
+    treePositions(other.treePositions),
+    rebuildFraction(other.rebuildFraction),
+    baseCases(other.baseCases),
+    scores(other.scores)
 {
   if (trained)
   {
@@ -152,7 +168,16 @@ KDE(KDE&& other) :
     mcProb(other.mcProb),
     initialSampleSize(other.initialSampleSize),
     mcEntryCoef(other.mcEntryCoef),
-    mcBreakCoef(other.mcBreakCoef)
+    mcBreakCoef(other.mcBreakCoef),
+    pendingSet(std::move(other.pendingSet)),
+    pendingIds(std::move(other.pendingIds)),
+    deletedReferences(std::move(other.deletedReferences)),
+    numDeleted(other.numDeleted),
+    nextIndex(other.nextIndex),
+    treePositions(std::move(other.treePositions)),
+    rebuildFraction(other.rebuildFraction),
+    baseCases(other.baseCases),
+    scores(other.scores)
 {
   other.kernel = std::move(KernelType());
   other.metric = std::move(MetricType());
@@ -168,6 +193,7 @@ KDE(KDE&& other) :
   other.initialSampleSize = KDEDefaultParams::initialSampleSize;
   other.mcEntryCoef = KDEDefaultParams::mcEntryCoef;
   other.mcBreakCoef = KDEDefaultParams::mcBreakCoef;
+  other.ResetIncrementalState();
 }
 
 template<typename KernelType,
@@ -212,6 +238,15 @@ operator=(const KDE& other)
     initialSampleSize = other.initialSampleSize;
     mcEntryCoef = other.mcEntryCoef;
     mcBreakCoef = other.mcBreakCoef;
+    pendingSet = other.pendingSet;
+    pendingIds = other.pendingIds;
+    deletedReferences = other.deletedReferences;
+    numDeleted = other.numDeleted;
+    nextIndex = other.nextIndex;
+    treePositions = other.treePositions;
+    rebuildFraction = other.rebuildFraction;
+    baseCases = other.baseCases;
+    scores = other.scores;
     if (trained)
     {
       if (ownsReferenceTree)
@@ -276,6 +311,22 @@ operator=(KDE&& other)
     this->initialSampleSize = other.initialSampleSize;
     this->mcEntryCoef = other.mcEntryCoef;
     this->mcBreakCoef = other.mcBreakCoef;
+    this->pendingSet = std::move(other.pendingSet);
+    this->pendingIds = std::move(other.pendingIds);
+    this->deletedReferences = std::move(other.deletedReferences);
+    this->numDeleted = other.numDeleted;
+    this->nextIndex = other.nextIndex;
+    this->treePositions = std::move(other.treePositions);
+    this->rebuildFraction = other.rebuildFraction;
+    this->baseCases = other.baseCases;
+    this->scores = other.scores;
+
+    // The other object no longer has a model.
+    other.referenceTree = nullptr;
+    other.oldFromNewReferences = nullptr;
+    other.ownsReferenceTree = false;
+    other.trained = false;
+    other.ResetIncrementalState();
   }
   return *this;
 }
@@ -337,6 +388,7 @@ Train(MatType referenceSet)
   this->referenceTree = BuildTree<Tree>(std::move(referenceSet),
                                         *oldFromNewReferences);
   this->trained = true;
+  ResetIncrementalState();
 }
 
 template<typename KernelType,
@@ -372,6 +424,7 @@ Train(Tree* referenceTree, std::vector<size_t>* oldFromNewReferences)
   this->referenceTree = referenceTree;
   this->oldFromNewReferences = oldFromNewReferences;
   this->trained = true;
+  ResetIncrementalState();
 }
 
 template<typename KernelType,
@@ -436,34 +489,9 @@ Evaluate(MatType querySet, arma::vec& estimations)
     }
 
     // Evaluate.
-    typedef KDERules<MetricType, KernelType, Tree> RuleType;
-    RuleType rules = RuleType(referenceTree->Dataset(),
-                              querySet,
-                              estimations,
-                              relError,
-                              absError,
-                              mcProb,
-                              initialSampleSize,
-                              mcEntryCoef,
-                              mcBreakCoef,
-                              metric,
-                              kernel,
-                              monteCarlo,
-                              false);
-
-    // Create traverser.
-    SingleTreeTraversalType<RuleType> traverser(rules);
-
-    // Traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    estimations /= referenceTree->Dataset().n_cols;
-
-    Log::Info << rules.Scores() << " node combinations were scored."
-              << std::endl;
-    Log::Info << rules.BaseCases() << " base cases were calculated."
-              << std::endl;
+    SingleTreeEvaluate(querySet, estimations, false);
+    AddPending(querySet, estimations);
+    estimations /= NumReferencePoints();
   }
 }
 
@@ -529,31 +557,12 @@ Evaluate(Tree* queryTree,
   }
 
   // Evaluate.
-  typedef KDERules<MetricType, KernelType, Tree> RuleType;
-  RuleType rules = RuleType(referenceTree->Dataset(),
-                            queryTree->Dataset(),
-                            estimations,
-                            relError,
-                            absError,
-                            mcProb,
-                            initialSampleSize,
-                            mcEntryCoef,
-                            mcBreakCoef,
-                            metric,
-                            kernel,
-                            monteCarlo,
-                            false);
-
-  // Create traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(*queryTree, *referenceTree);
-  estimations /= referenceTree->Dataset().n_cols;
+  DualTreeEvaluate(*queryTree, estimations, false);
+  AddPending(queryTree->Dataset(), estimations);
+  estimations /= NumReferencePoints();
 
   // Rearrange if necessary.
   RearrangeEstimations(oldFromNewQueries, estimations);
-
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
 }
 
 template<typename KernelType,
@@ -579,6 +588,10 @@ Evaluate(arma::vec& estimations)
                              "trained before evaluation");
   }
 
+  // Pending insertions and deletions must be in the tree, since every point
+  // of the reference set is a query point.
+  FlushUpdates(true);
+
   // Get estimations vector ready.
   estimations.clear();
   estimations.set_size(referenceTree->Dataset().n_cols);
@@ -593,40 +606,41 @@ Evaluate(arma::vec& estimations)
   }
 
   // Evaluate.
-  typedef KDERules<MetricType, KernelType, Tree> RuleType;
-  RuleType rules = RuleType(referenceTree->Dataset(),
-                            referenceTree->Dataset(),
-                            estimations,
-                            relError,
-                            absError,
-                            mcProb,
-                            initialSampleSize,
-                            mcEntryCoef,
-                            mcBreakCoef,
-                            metric,
-                            kernel,
-                            monteCarlo,
-                            true);
-
   if (mode == DUAL_TREE_MODE)
-  {
-    // Create traverser.
-    DualTreeTraversalType<RuleType> traverser(rules);
-    traverser.Traverse(*referenceTree, *referenceTree);
-  }
+    DualTreeEvaluate(*referenceTree, estimations, true);
   else if (mode == SINGLE_TREE_MODE)
-  {
-    SingleTreeTraversalType<RuleType> traverser(rules);
-    for (size_t i = 0; i < referenceTree->Dataset().n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-  }
+    SingleTreeEvaluate(referenceTree->Dataset(), estimations, true);
 
   estimations /= referenceTree->Dataset().n_cols;
-  // Rearrange if necessary.
-  RearrangeEstimations(*oldFromNewReferences, estimations);
 
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
+  // Rearrange if necessary.  Once points have been deleted, the indices of the
+  // points may not be contiguous anymore; the estimations are then returned in
+  // increasing order of index.
+  const size_t n = referenceTree->Dataset().n_cols;
+  if (tree::TreeTraits<Tree>::RearrangesDataset &&
+      oldFromNewReferences->size() == n && n > 0 &&
+      *std::max_element(oldFromNewReferences->begin(),
+                        oldFromNewReferences->end()) >= n)
+  {
+    const std::vector<size_t>& indices = *oldFromNewReferences;
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; ++i)
+      order[i] = i;
+    std::sort(order.begin(), order.end(),
+        [&indices](const size_t a, const size_t b)
+        {
+          return indices[a] < indices[b];
+        });
+
+    std::vector<size_t> ranks(n);
+    for (size_t i = 0; i < n; ++i)
+      ranks[order[i]] = i;
+    RearrangeEstimations(ranks, estimations);
+  }
+  else
+  {
+    RearrangeEstimations(*oldFromNewReferences, estimations);
+  }
 }
 
 template<typename KernelType,
@@ -759,6 +773,11 @@ void KDE<KernelType,
          SingleTreeTraversalType>::
 serialize(Archive& ar, const uint32_t /* version */)
 {
+  // Pending insertions and deletions are not serialized, so they must be
+  // added to the tree first.
+  if (cereal::is_saving<Archive>() && trained)
+    FlushUpdates(true);
+
   // Serialize preferences.
   ar(CEREAL_NVP(relError));
   ar(CEREAL_NVP(absError));
@@ -787,6 +806,480 @@ serialize(Archive& ar, const uint32_t /* version */)
   ar(CEREAL_NVP(metric));
   ar(CEREAL_POINTER(referenceTree));
   ar(CEREAL_POINTER(oldFromNewReferences));
+
+  if (cereal::is_loading<Archive>())
+    ResetIncrementalState();
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+SingleTreeEvaluate(const MatType& querySet,
+                   arma::vec& estimations,
+                   const bool sameSet)
+{
+  typedef KDERules<MetricType, KernelType, Tree> RuleType;
+
+  // Compute Monte Carlo alphas beforehand, so that the traversals do not modify
+  // the shared reference tree.
+  if (monteCarlo && std::is_same<KernelType, kernel::GaussianKernel>::value)
+    RuleType::InitializeAlpha(*referenceTree, mcProb);
+
+  // Use more blocks than threads so that dynamic scheduling can balance
+  // queries that take different amounts of time.
+  size_t numBlocks = 1;
+  #ifdef HAS_OPENMP
+  numBlocks = std::min((size_t) querySet.n_cols,
+      (size_t) (16 * omp_get_max_threads()));
+  #endif
+  const size_t blockSize = (querySet.n_cols + numBlocks - 1) / numBlocks;
+  numBlocks = (querySet.n_cols + blockSize - 1) / blockSize;
+
+  // Each block seeds the random number generator of its rules, so that the
+  // Monte Carlo samples do not depend on which thread takes the block.
+  std::vector<size_t> seeds(numBlocks);
+  for (size_t b = 0; b < numBlocks; ++b)
+    seeds[b] = math::RandInt(std::numeric_limits<int>::max());
+
+  size_t baseCases = 0;
+  size_t scores = 0;
+  #pragma omp parallel reduction(+:baseCases, scores)
+  {
+    RuleType rules(referenceTree->Dataset(), querySet, estimations, relError,
+        absError, mcProb, initialSampleSize, mcEntryCoef, mcBreakCoef, metric,
+        kernel, monteCarlo, sameSet);
+    if (numDeleted > 0)
+      rules.DeletedReferences() = &deletedReferences;
+    SingleTreeTraversalType<RuleType> traverser(rules);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      rules.RandomGenerator().seed((uint32_t) seeds[b]);
+      const size_t end = std::min((size_t) (b + 1) * blockSize,
+          (size_t) querySet.n_cols);
+      for (size_t i = b * blockSize; i < end; ++i)
+        traverser.Traverse(i, *referenceTree);
+    }
+
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+  }
+
+  Log::Info << scores << " node combinations were scored." << std::endl;
+  Log::Info << baseCases << " base cases were calculated." << std::endl;
+  this->baseCases = baseCases;
+  this->scores = scores;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+DualTreeEvaluate(Tree& queryTree,
+                 arma::vec& estimations,
+                 const bool sameSet)
+{
+  typedef KDERules<MetricType, KernelType, Tree> RuleType;
+
+  // Compute Monte Carlo alphas beforehand, so that the traversals do not modify
+  // the shared reference tree.
+  if (monteCarlo && std::is_same<KernelType, kernel::GaussianKernel>::value)
+    RuleType::InitializeAlpha(*referenceTree, mcProb);
+
+  // Split the query tree into disjoint subtrees, so that each thread can
+  // traverse some of them.
+  const std::vector<Tree*> queryNodes = tree::ParallelSubtrees(queryTree);
+
+  // Each subtree seeds the random number generator of its rules, so that the
+  // Monte Carlo samples do not depend on which thread takes the subtree.
+  std::vector<size_t> seeds(queryNodes.size());
+  for (size_t i = 0; i < queryNodes.size(); ++i)
+    seeds[i] = math::RandInt(std::numeric_limits<int>::max());
+
+  size_t baseCases = 0;
+  size_t scores = 0;
+  #pragma omp parallel reduction(+:baseCases, scores)
+  {
+    RuleType rules(referenceTree->Dataset(), queryTree.Dataset(), estimations,
+        relError, absError, mcProb, initialSampleSize, mcEntryCoef, mcBreakCoef,
+        metric, kernel, monteCarlo, sameSet);
+    if (numDeleted > 0)
+      rules.DeletedReferences() = &deletedReferences;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) queryNodes.size(); ++i)
+    {
+      rules.RandomGenerator().seed((uint32_t) seeds[i]);
+      rules.TraversalInfo() = typename RuleType::TraversalInfoType();
+
+      DualTreeTraversalType<RuleType> traverser(rules);
+      traverser.Traverse(*queryNodes[i], *referenceTree);
+    }
+
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+  }
+
+  Log::Info << scores << " node combinations were scored." << std::endl;
+  Log::Info << baseCases << " base cases were calculated." << std::endl;
+  this->baseCases = baseCases;
+  this->scores = scores;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+size_t KDE<KernelType,
+           MetricType,
+           MatType,
+           TreeType,
+           DualTreeTraversalType,
+           SingleTreeTraversalType>::
+Insert(const MatType& points)
+{
+  PrepareUpdate("Insert");
+
+  if (points.n_cols > 0 && points.n_rows != referenceTree->Dataset().n_rows)
+  {
+    std::ostringstream oss;
+    oss << "KDE::Insert(): dimensionality of new points (" << points.n_rows
+        << ") does not match dimensionality of reference set ("
+        << referenceTree->Dataset().n_rows << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t firstIndex = nextIndex;
+  if (pendingSet.n_cols == 0)
+    pendingSet = points;
+  else
+    pendingSet.insert_cols(pendingSet.n_cols, points);
+
+  for (size_t i = 0; i < points.n_cols; ++i)
+    pendingIds.push_back(nextIndex++);
+
+  FlushUpdates(false);
+  return firstIndex;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+Delete(const size_t index)
+{
+  PrepareUpdate("Delete");
+
+  if (NumReferencePoints() == 1)
+  {
+    throw std::invalid_argument("KDE::Delete(): cannot delete the last point "
+        "of the reference set");
+  }
+
+  // The point may not be in the tree yet.
+  for (size_t i = 0; i < pendingIds.size(); ++i)
+  {
+    if (pendingIds[i] == index)
+    {
+      pendingSet.shed_col(i);
+      pendingIds.erase(pendingIds.begin() + i);
+      return;
+    }
+  }
+
+  // Otherwise we have to find its position in the tree.
+  const size_t numTreePoints = referenceTree->Dataset().n_cols;
+  if (treePositions.empty())
+  {
+    treePositions.resize(nextIndex, SIZE_MAX);
+    for (size_t i = 0; i < numTreePoints; ++i)
+    {
+      treePositions[oldFromNewReferences->empty() ? i :
+          (*oldFromNewReferences)[i]] = i;
+    }
+  }
+
+  if (index >= treePositions.size() || treePositions[index] == SIZE_MAX ||
+      (!deletedReferences.empty() && deletedReferences[treePositions[index]]))
+  {
+    std::ostringstream oss;
+    oss << "KDE::Delete(): there is no point with index " << index << " in "
+        << "the reference set";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t position = treePositions[index];
+  if (deletedReferences.empty())
+    deletedReferences.resize(numTreePoints, false);
+  deletedReferences[position] = true;
+  ++numDeleted;
+
+  // Count the point in the statistic of each node that holds it.  Since the
+  // tree rearranges the dataset, the descendants of each node are contiguous.
+  Tree* node = referenceTree;
+  while (node != NULL)
+  {
+    ++node->Stat().NumDeleted();
+
+    Tree* next = NULL;
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+    {
+      Tree& child = node->Child(i);
+      if (child.NumDescendants() > 0 && child.Descendant(0) <= position &&
+          position < child.Descendant(0) + child.NumDescendants())
+      {
+        next = &child;
+        break;
+      }
+    }
+    node = next;
+  }
+
+  FlushUpdates(false);
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+Rebuild()
+{
+  PrepareUpdate("Rebuild");
+
+  // Collect the live points in the tree, followed by the pending points.
+  const MatType& referenceSet = referenceTree->Dataset();
+  const size_t numPoints = NumReferencePoints();
+  MatType dataset(referenceSet.n_rows, numPoints);
+  std::vector<size_t> indices(numPoints);
+  size_t col = 0;
+  for (size_t i = 0; i < referenceSet.n_cols; ++i)
+  {
+    if (!deletedReferences.empty() && deletedReferences[i])
+      continue;
+
+    dataset.col(col) = referenceSet.col(i);
+    indices[col++] = oldFromNewReferences->empty() ? i :
+        (*oldFromNewReferences)[i];
+  }
+  for (size_t i = 0; i < pendingSet.n_cols; ++i)
+  {
+    dataset.col(col) = pendingSet.col(i);
+    indices[col++] = pendingIds[i];
+  }
+
+  // Remember the next index, since ResetIncrementalState() will forget it.
+  const size_t newNextIndex = nextIndex;
+
+  if (ownsReferenceTree)
+  {
+    delete referenceTree;
+    delete oldFromNewReferences;
+  }
+
+  std::vector<size_t> oldFromNew;
+  referenceTree = BuildTree<Tree>(std::move(dataset), oldFromNew);
+  ownsReferenceTree = true;
+
+  // Map the new positions to the original indices of the points.
+  oldFromNewReferences = new std::vector<size_t>(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+    (*oldFromNewReferences)[i] = indices[oldFromNew[i]];
+
+  ResetIncrementalState();
+  nextIndex = newNextIndex;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+ResetIncrementalState()
+{
+  pendingSet.reset();
+  pendingIds.clear();
+  deletedReferences.clear();
+  numDeleted = 0;
+  nextIndex = SIZE_MAX;
+  treePositions.clear();
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+PrepareUpdate(const std::string& method)
+{
+  if (!trained)
+  {
+    throw std::runtime_error("KDE::" + method + "(): the model needs to be "
+        "trained first");
+  }
+
+  if (!tree::TreeTraits<Tree>::RearrangesDataset)
+  {
+    throw std::invalid_argument("KDE::" + method + "(): the tree type must "
+        "rearrange the dataset");
+  }
+
+  if (nextIndex == SIZE_MAX)
+  {
+    // The tree may have been built without a mapping, in which case each
+    // point's index is its position.
+    if (oldFromNewReferences->empty())
+    {
+      nextIndex = referenceTree->Dataset().n_cols;
+    }
+    else
+    {
+      nextIndex = 0;
+      for (size_t i = 0; i < oldFromNewReferences->size(); ++i)
+        nextIndex = std::max(nextIndex, (*oldFromNewReferences)[i] + 1);
+    }
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+FlushUpdates(const bool force)
+{
+  const size_t changes = pendingSet.n_cols + numDeleted;
+  if (changes == 0)
+    return;
+
+  if (force || changes > rebuildFraction *
+      (referenceTree->Dataset().n_cols - numDeleted))
+  {
+    Rebuild();
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+AddPending(const MatType& querySet, arma::vec& estimations)
+{
+  if (pendingSet.n_cols == 0)
+    return;
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+  {
+    double density = 0.0;
+    for (size_t j = 0; j < pendingSet.n_cols; ++j)
+    {
+      density += kernel.Evaluate(metric.Evaluate(querySet.col(i),
+          pendingSet.col(j)));
+    }
+    estimations[i] += density;
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+size_t KDE<KernelType,
+           MetricType,
+           MatType,
+           TreeType,
+           DualTreeTraversalType,
+           SingleTreeTraversalType>::
+NumReferencePoints() const
+{
+  return referenceTree->Dataset().n_cols - numDeleted + pendingSet.n_cols;
 }
 
 template<typename KernelType,
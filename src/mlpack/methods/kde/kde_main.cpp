@@ -155,7 +155,9 @@ PARAM_STRING_IN("kernel", "Kernel to use for the prediction."
     "('gaussian', 'epanechnikov', 'laplacian', 'spherical', 'triangular').",
     "k", "gaussian");
 PARAM_STRING_IN("tree", "Tree to use for the prediction."
-    "('kd-tree', 'ball-tree', 'cover-tree', 'octree', 'r-tree').",
+    "('kd-tree', 'ball-tree', 'cover-tree', 'octree', 'r-tree', 'auto').  "
+    "'auto' chooses the tree by building each one on a sample of the reference "
+    "set and timing the evaluation of a sample of the queries.",
     "t", "kd-tree");
 PARAM_STRING_IN("algorithm", "Algorithm to use for the prediction."
     "('dual-tree', 'single-tree').",
@@ -236,7 +238,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   RequireParamInSet<string>(params, "kernel", { "gaussian", "epanechnikov",
       "laplacian", "spherical", "triangular" }, true, "unknown kernel type");
   RequireParamInSet<string>(params, "tree", { "kd-tree", "ball-tree",
-      "cover-tree", "octree", "r-tree"}, true, "unknown tree type");
+      "cover-tree", "octree", "r-tree", "auto"}, true, "unknown tree type");
   RequireParamInSet<string>(params, "algorithm", { "dual-tree", "single-tree"},
       true, "unknown algorithm");
   RequireParamValue<double>(params, "rel_error",
@@ -265,7 +267,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   {
     arma::mat reference = std::move(params.Get<arma::mat>("reference"));
 
-    kde = new KDEModel();
+    // The settings of the estimation are needed to tune the tree.
+    kde = new KDEModel(bandwidth, relError, absError,
+        KDEModel::GAUSSIAN_KERNEL, KDEModel::KD_TREE, monteCarlo, mcProb,
+        (size_t) initialSampleSize, mcEntryCoef, mcBreakCoef);
 
     // Set KernelType.
     if (kernelStr == "gaussian")
@@ -291,14 +296,23 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     else if (treeStr == "r-tree")
       kde->TreeType() = KDEModel::R_TREE;
 
+    const KDEMode mode = (modeStr == "single-tree") ?
+        KDEMode::SINGLE_TREE_MODE : KDEMode::DUAL_TREE_MODE;
+
+    // The tree is tuned for the evaluation that will be done.
+    if (treeStr == "auto")
+    {
+      const arma::mat noQueries;
+      const arma::mat& queries = params.Has("query") ?
+          params.Get<arma::mat>("query") : noQueries;
+      kde->Tune(timers, reference, queries, mode);
+    }
+
     // Build model.
     kde->BuildModel(timers, std::move(reference));
 
     // Set Mode.
-    if (modeStr == "dual-tree")
-      kde->Mode() = KDEMode::DUAL_TREE_MODE;
-    else if (modeStr == "single-tree")
-      kde->Mode() = KDEMode::SINGLE_TREE_MODE;
+    kde->Mode() = mode;
   }
   else
   {
@@ -239,6 +239,51 @@ void KDEModel::BuildModel(util::Timers& timers, arma::mat&& referenceSet)
   kdeModel->Train(timers, std::move(referenceSet));
 }
 
+// Choose the tree type.
+void KDEModel::Tune(util::Timers& timers,
+                    const arma::mat& referenceSet,
+                    const arma::mat& querySet,
+                    const KDEMode mode,
+                    const tree::TreeTuner& tuner)
+{
+  timers.Start("tree_tuning");
+  Log::Info << "Choosing the tree type for kernel density estimation..."
+      << std::endl;
+
+  KDEModel trial(bandwidth, relError, absError, kernelType, treeType,
+      monteCarlo, mcProb, initialSampleSize, mcEntryCoef, mcBreakCoef);
+
+  // The trees of KDE take no leaf size.
+  std::vector<tree::TreeCandidate> candidates;
+  tuner.AddCandidates(candidates, KD_TREE, "kd-tree", false);
+  tuner.AddCandidates(candidates, BALL_TREE, "ball tree", false);
+  tuner.AddCandidates(candidates, COVER_TREE, "cover tree", false);
+  tuner.AddCandidates(candidates, OCTREE, "octree", false);
+  tuner.AddCandidates(candidates, R_TREE, "R tree", false);
+
+  auto build = [&](const tree::TreeCandidate& candidate,
+                   arma::mat&& references)
+  {
+    trial.treeType = (TreeTypes) candidate.treeType;
+
+    util::Timers buildTimers;
+    trial.BuildModel(buildTimers, std::move(references));
+    trial.Mode() = mode;
+  };
+
+  auto search = [&](arma::mat&& queries, util::Timers& searchTimers)
+  {
+    arma::vec estimations;
+    trial.Evaluate(searchTimers, std::move(queries), estimations);
+  };
+
+  const size_t best = tuner.Tune(referenceSet, querySet, candidates, build,
+      search);
+  treeType = (TreeTypes) candidates[best].treeType;
+
+  timers.Stop("tree_tuning");
+}
+
 // Perform bichromatic evaluation.
 void KDEModel::Evaluate(util::Timers& timers,
                         arma::mat&& querySet,
@@ -253,6 +298,24 @@ void KDEModel::Evaluate(util::Timers& timers, arma::vec& estimates)
   kdeModel->Evaluate(timers, estimates);
 }
 
+// Add points to the reference set.
+size_t KDEModel::Insert(const arma::mat& points)
+{
+  return kdeModel->Insert(points);
+}
+
+// Remove a point from the reference set.
+void KDEModel::Delete(const size_t index)
+{
+  kdeModel->Delete(index);
+}
+
+// Rebuild the reference tree.
+void KDEModel::Rebuild()
+{
+  kdeModel->Rebuild();
+}
+
 // Clean memory.
 void KDEModel::CleanMemory()
 {
@@ -17,6 +17,7 @@
 #include <mlpack/core/tree/octree.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
+#include <mlpack/core/tree/tree_tuner.hpp>
 
 // Include core.
 #include <mlpack/core.hpp>
@@ -125,6 +126,15 @@ class KDEWrapperBase
 
   //! Perform monochromatic KDE (i.e. with the reference set as the query set).
   virtual void Evaluate(util::Timers& timers, arma::vec& estimates) = 0;
+
+  //! Add points to the reference set without retraining.
+  virtual size_t Insert(const arma::mat& points) = 0;
+
+  //! Remove a point from the reference set without retraining.
+  virtual void Delete(const size_t index) = 0;
+
+  //! Rebuild the reference tree with all insertions and deletions.
+  virtual void Rebuild() = 0;
 };
 
 /**
@@ -205,6 +215,15 @@ class KDEWrapper : public KDEWrapperBase
   //! Perform monochromatic KDE (i.e. with the reference set as the query set).
   virtual void Evaluate(util::Timers& timers, arma::vec& estimates);
 
+  //! Add points to the reference set without retraining.
+  virtual size_t Insert(const arma::mat& points) { return kde.Insert(points); }
+
+  //! Remove a point from the reference set without retraining.
+  virtual void Delete(const size_t index) { kde.Delete(index); }
+
+  //! Rebuild the reference tree with all insertions and deletions.
+  virtual void Rebuild() { kde.Rebuild(); }
+
   //! Serialize the KDE model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -432,6 +451,28 @@ class KDEModel
    */
   void BuildModel(util::Timers& timers, arma::mat&& referenceSet);
 
+  /**
+   * Choose the tree type with the given tuner: each tree type is built on a
+   * sample of the reference set and used to estimate the density of a sample
+   * of the queries, with the kernel and the error tolerances of the model, and
+   * TreeType() is set to the tree type with the lowest estimated cost of
+   * building the tree and evaluating all the queries.  The tree is not built;
+   * call BuildModel() afterwards.  This is what the kde binding does when the
+   * tree type is 'auto'.
+   *
+   * @param timers Object to hold timing information in.
+   * @param referenceSet Reference set the model will be built on.
+   * @param querySet Query set that will be evaluated; if empty, the evaluation
+   *     is assumed to be monochromatic.
+   * @param mode Mode of the evaluation (dual-tree or single-tree).
+   * @param tuner Tuner that samples the data and tries the candidates.
+   */
+  void Tune(util::Timers& timers,
+            const arma::mat& referenceSet,
+            const arma::mat& querySet,
+            const KDEMode mode,
+            const tree::TreeTuner& tuner = tree::TreeTuner());
+
   /**
    * Perform kernel density estimation on the given query set.
    * Takes possession of the query set to avoid a copy, so the query set
@@ -459,6 +500,33 @@ class KDEModel
    */
   void Evaluate(util::Timers& timers, arma::vec& estimations);
 
+  /**
+   * Add the given points to the reference set of the model without retraining
+   * it.  See KDE::Insert() for details; this is only supported for kd-trees,
+   * ball trees and octrees.
+   *
+   * @pre The model has to be previously created with BuildModel.
+   * @param points Points to add to the reference set.
+   * @return Index of the first inserted point.
+   */
+  size_t Insert(const arma::mat& points);
+
+  /**
+   * Remove the point with the given index from the reference set of the model
+   * without retraining it.  See KDE::Delete() for details.
+   *
+   * @pre The model has to be previously created with BuildModel.
+   * @param index Index of the point to remove.
+   */
+  void Delete(const size_t index);
+
+  /**
+   * Rebuild the reference tree of the model, so that it holds all inserted
+   * points and none of the deleted points.
+   *
+   * @pre The model has to be previously created with BuildModel.
+   */
+  void Rebuild();
 
  private:
   //! Clean memory.
@@ -53,6 +53,8 @@ void KDEWrapper<KernelType, TreeType>::Evaluate(util::Timers& timers,
     timers.Start("computing_kde");
     kde.Evaluate(queryTree, oldFromNewQueries, estimates);
     timers.Stop("computing_kde");
+    timers.Count("base_cases", kde.BaseCases());
+    timers.Count("scores", kde.Scores());
 
     delete queryTree;
   }
@@ -61,6 +63,8 @@ void KDEWrapper<KernelType, TreeType>::Evaluate(util::Timers& timers,
     timers.Start("computing_kde");
     kde.Evaluate(std::move(querySet), estimates);
     timers.Stop("computing_kde");
+    timers.Count("base_cases", kde.BaseCases());
+    timers.Count("scores", kde.Scores());
   }
 
   timers.Start("applying_normalizer");
@@ -81,6 +85,8 @@ void KDEWrapper<KernelType, TreeType>::Evaluate(util::Timers& timers,
   timers.Start("computing_kde");
   kde.Evaluate(estimates);
   timers.Stop("computing_kde");
+  timers.Count("base_cases", kde.BaseCases());
+  timers.Count("scores", kde.Scores());
 
   timers.Start("applying_normalizer");
   const size_t dimension = kde.ReferenceTree()->Dataset().n_rows;
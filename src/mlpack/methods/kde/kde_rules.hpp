@@ -21,6 +21,13 @@ namespace kde {
 /**
  * A dual-tree traversal Rules class for kernel density estimation.  This
  * contains the Score() and BaseCase() implementations.
+ *
+ * A KDERules object must only be used by one thread at a time, but several
+ * objects may traverse disjoint sets of query points (or disjoint query
+ * subtrees) against the same reference tree at once, as long as
+ * InitializeAlpha() has been called on the reference tree first when Monte
+ * Carlo estimations are used.  Each object samples with its own random number
+ * generator.
  */
 template<typename MetricType, typename KernelType, typename TreeType>
 class KDERules
@@ -97,6 +104,31 @@ class KDERules
   //! results.
   size_t MinimumBaseCases() const { return 0; }
 
+  //! Get the random number generator used for Monte Carlo estimations.
+  const std::mt19937& RandomGenerator() const { return randGen; }
+  //! Modify the random number generator used for Monte Carlo estimations.
+  std::mt19937& RandomGenerator() { return randGen; }
+
+  /**
+   * Compute the Monte Carlo alpha of the given node and all of its
+   * descendants.  Scoring computes it lazily and stores it in the reference
+   * node statistics; computing it beforehand means the traversal does not
+   * modify the reference tree, so that several threads can share it.
+   *
+   * @param node Root of the reference tree.
+   * @param mcProb Probability of relative error compliance for Monte Carlo
+   *     estimations.
+   */
+  static void InitializeAlpha(TreeType& node, const double mcProb);
+
+  //! Get the set of deleted reference points (NULL if there are none).
+  const std::vector<bool>* DeletedReferences() const
+  { return deletedReferences; }
+  //! Modify the set of deleted reference points.  A reference point marked as
+  //! deleted does not contribute to the densities; the reference tree
+  //! statistics must hold the number of deleted descendants of each node.
+  const std::vector<bool>*& DeletedReferences() { return deletedReferences; }
+
  private:
   //! Evaluate kernel value of 2 points given their indexes.
   double EvaluateKernel(const size_t queryIndex,
@@ -107,7 +139,13 @@ class KDERules
                         const arma::vec& reference) const;
 
   //! Calculate depth alpha for some node.
-  double CalculateAlpha(TreeType* node);
+  static double CalculateAlpha(TreeType* node, const double mcBeta);
+
+  //! Return the number of descendants of the node that have not been deleted.
+  size_t NumLiveDescendants(const TreeType& node) const;
+
+  //! Pick a random index in [lo, hiExclusive) with the random number generator.
+  size_t RandomIndex(const size_t lo, const size_t hiExclusive);
 
   //! The reference set.
   const arma::mat& referenceSet;
@@ -179,6 +217,12 @@ class KDERules
 
   //! The number of scores.
   size_t scores;
+
+  //! Random number generator for Monte Carlo estimations.
+  std::mt19937 randGen;
+
+  //! If not NULL, reference points marked true here are ignored.
+  const std::vector<bool>* deletedReferences;
 };
 
 /**
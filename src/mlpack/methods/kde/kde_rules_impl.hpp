@@ -54,7 +54,8 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
     baseCases(0),
-    scores(0)
+    scores(0),
+    deletedReferences(NULL)
 {
   // Initialize accumError.
   accumError = arma::vec(querySet.n_cols, arma::fill::zeros);
@@ -83,11 +84,16 @@ double KDERules<MetricType, KernelType, TreeType>::BaseCase(
   // Calculations.
   const double distance = metric.Evaluate(querySet.col(queryIndex),
                                           referenceSet.col(referenceIndex));
-  const double kernelValue = kernel.Evaluate(distance);
-  densities(queryIndex) += kernelValue;
 
-  // Update accumulated relative error tolerance for single-tree pruning.
-  accumError(queryIndex) += 2 * relError * kernelValue;
+  // Deleted reference points don't contribute to the density.
+  if (!deletedReferences || !(*deletedReferences)[referenceIndex])
+  {
+    const double kernelValue = kernel.Evaluate(distance);
+    densities(queryIndex) += kernelValue;
+
+    // Update accumulated relative error tolerance for single-tree pruning.
+    accumError(queryIndex) += 2 * relError * kernelValue;
+  }
 
   ++baseCases;
   lastQueryIndex = queryIndex;
@@ -103,17 +109,29 @@ Score(const size_t queryIndex, TreeType& referenceNode)
 {
   // Auxiliary variables.
   const arma::vec& queryPoint = querySet.unsafe_col(queryIndex);
-  const size_t refNumDesc = referenceNode.NumDescendants();
+  const size_t refNumDesc = NumLiveDescendants(referenceNode);
   double score, minDistance, maxDistance, depthAlpha;
   // Calculations are not duplicated.
   bool alreadyDidRefPoint0 = false;
 
   // Calculate alpha if Monte Carlo is available.
   if (monteCarlo && kernelIsGaussian)
-    depthAlpha = CalculateAlpha(&referenceNode);
+    depthAlpha = CalculateAlpha(&referenceNode, mcBeta);
   else
     depthAlpha = -1;
 
+  // If every descendant has been deleted, there is nothing to estimate.
+  if (refNumDesc == 0)
+  {
+    if (kernelIsGaussian && monteCarlo)
+      accumMCAlpha(queryIndex) += depthAlpha;
+
+    ++scores;
+    traversalInfo.LastReferenceNode() = &referenceNode;
+    traversalInfo.LastScore() = DBL_MAX;
+    return DBL_MAX;
+  }
+
   if (tree::TreeTraits<TreeType>::FirstPointIsCentroid &&
       lastQueryIndex == queryIndex &&
       traversalInfo.LastReferenceNode() != NULL &&
@@ -186,7 +204,8 @@ Score(const size_t queryIndex, TreeType& referenceNode)
   }
   else if (monteCarlo &&
            refNumDesc >= mcAccessCoef * initialSampleSize &&
-           kernelIsGaussian)
+           kernelIsGaussian &&
+           (!deletedReferences || referenceNode.Stat().NumDeleted() == 0))
   {
     // Monte Carlo probabilistic estimation.
     // Calculate z using accumulated alpha if possible.
@@ -222,9 +241,9 @@ Score(const size_t queryIndex, TreeType& referenceNode)
         // Sample and evaluate random points from the reference node.
         size_t randomPoint;
         if (alreadyDidRefPoint0)
-          randomPoint = math::RandInt(1, refNumDesc);
+          randomPoint = RandomIndex(1, refNumDesc);
         else
-          randomPoint = math::RandInt(0, refNumDesc);
+          randomPoint = RandomIndex(0, refNumDesc);
 
         sample(oldSize + i) =
             EvaluateKernel(queryIndex, referenceNode.Descendant(randomPoint));
@@ -309,14 +328,14 @@ inline double KDERules<MetricType, KernelType, TreeType>::
 Score(TreeType& queryNode, TreeType& referenceNode)
 {
   kde::KDEStat& queryStat = queryNode.Stat();
-  const size_t refNumDesc = referenceNode.NumDescendants();
+  const size_t refNumDesc = NumLiveDescendants(referenceNode);
   double score, minDistance, maxDistance, depthAlpha;
   // Calculations are not duplicated.
   bool alreadyDidRefPoint0 = false;
 
   // Calculate alpha if Monte Carlo is available.
   if (monteCarlo && kernelIsGaussian)
-    depthAlpha = CalculateAlpha(&referenceNode);
+    depthAlpha = CalculateAlpha(&referenceNode, mcBeta);
   else
     depthAlpha = -1;
 
@@ -327,6 +346,20 @@ Score(TreeType& queryNode, TreeType& referenceNode)
                                referenceNode.IsLeaf() &&
                                queryNode.IsLeaf();
 
+  // If every reference descendant has been deleted, there is nothing to
+  // estimate.
+  if (refNumDesc == 0)
+  {
+    if (kernelIsGaussian && monteCarlo)
+      queryStat.AccumAlpha() += depthAlpha;
+
+    ++scores;
+    traversalInfo.LastQueryNode() = &queryNode;
+    traversalInfo.LastReferenceNode() = &referenceNode;
+    traversalInfo.LastScore() = DBL_MAX;
+    return DBL_MAX;
+  }
+
   if (tree::TreeTraits<TreeType>::FirstPointIsCentroid &&
       (traversalInfo.LastQueryNode() != NULL) &&
       (traversalInfo.LastReferenceNode() != NULL) &&
@@ -395,7 +428,8 @@ Score(TreeType& queryNode, TreeType& referenceNode)
   }
   else if (monteCarlo &&
            refNumDesc >= mcAccessCoef * initialSampleSize &&
-           kernelIsGaussian)
+           kernelIsGaussian &&
+           (!deletedReferences || referenceNode.Stat().NumDeleted() == 0))
   {
     // Monte Carlo probabilistic estimation.
     // Calculate z using accumulated alpha if possible.
@@ -439,9 +473,9 @@ Score(TreeType& queryNode, TreeType& referenceNode)
           // Sample and evaluate random points from the reference node.
           size_t randomPoint;
           if (alreadyDidRefPoint0)
-            randomPoint = math::RandInt(1, refNumDesc);
+            randomPoint = RandomIndex(1, refNumDesc);
           else
-            randomPoint = math::RandInt(0, refNumDesc);
+            randomPoint = RandomIndex(0, refNumDesc);
 
           sample(oldSize + i) =
               EvaluateKernel(queryIndex, referenceNode.Descendant(randomPoint));
@@ -544,9 +578,36 @@ EvaluateKernel(const arma::vec& query, const arma::vec& reference) const
   return kernel.Evaluate(metric.Evaluate(query, reference));
 }
 
+template<typename MetricType, typename KernelType, typename TreeType>
+void KDERules<MetricType, KernelType, TreeType>::
+InitializeAlpha(TreeType& node, const double mcProb)
+{
+  CalculateAlpha(&node, 1 - mcProb);
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    InitializeAlpha(node.Child(i), mcProb);
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+inline force_inline size_t KDERules<MetricType, KernelType, TreeType>::
+NumLiveDescendants(const TreeType& node) const
+{
+  if (deletedReferences)
+    return node.NumDescendants() - node.Stat().NumDeleted();
+  else
+    return node.NumDescendants();
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+inline force_inline size_t KDERules<MetricType, KernelType, TreeType>::
+RandomIndex(const size_t lo, const size_t hiExclusive)
+{
+  std::uniform_int_distribution<size_t> dist(lo, hiExclusive - 1);
+  return dist(randGen);
+}
+
 template<typename MetricType, typename KernelType, typename TreeType>
 inline force_inline double KDERules<MetricType, KernelType, TreeType>::
-CalculateAlpha(TreeType* node)
+CalculateAlpha(TreeType* node, const double mcBeta)
 {
   KDEStat& stat = node->Stat();
 
@@ -29,7 +29,8 @@ class KDEStat
       mcBeta(0),
       mcAlpha(0),
       accumAlpha(0),
-      accumError(0)
+      accumError(0),
+      numDeleted(0)
   { /* Nothing to do.*/ }
 
   //! Initialization for a fully initialized node.
@@ -38,7 +39,8 @@ class KDEStat
       mcBeta(0),
       mcAlpha(0),
       accumAlpha(0),
-      accumError(0)
+      accumError(0),
+      numDeleted(0)
   { /* Nothing to do. */ }
 
   //! Get accumulated Monte Carlo alpha of the node.
@@ -65,6 +67,13 @@ class KDEStat
   //! Modify Monte Carlo alpha of the node.
   inline double& MCAlpha() { return mcAlpha; }
 
+  //! Get the number of descendants of the node that have been deleted from the
+  //! reference set (see KDE::Delete()).
+  inline size_t NumDeleted() const { return numDeleted; }
+
+  //! Modify the number of descendants of the node that have been deleted.
+  inline size_t& NumDeleted() { return numDeleted; }
+
   //! Serialize the statistic to/from an archive.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -73,6 +82,10 @@ class KDEStat
     ar(CEREAL_NVP(mcAlpha));
     ar(CEREAL_NVP(accumAlpha));
     ar(CEREAL_NVP(accumError));
+
+    // Deleted points are removed before a model is saved.
+    if (cereal::is_loading<Archive>())
+      numDeleted = 0;
   }
 
  private:
@@ -87,6 +100,9 @@ class KDEStat
 
   //! Accumulated not used error tolerance in the current node.
   double accumError;
+
+  //! Number of deleted descendants of the node.
+  size_t numDeleted;
 };
 
 } // namespace kde
@@ -0,0 +1,128 @@
+/**
+ * @file methods/kmeans/center_distances.hpp
+ *
+ * Lower bounds on the distances between a block of points and each centroid,
+ * computed with a single matrix product when the metric is the Euclidean
+ * distance.  These are used by the bound-based Lloyd steps (ElkanKMeans and
+ * HamerlyKMeans) for the points that their bounds could not prune.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_CENTER_DISTANCES_HPP
+#define MLPACK_METHODS_KMEANS_CENTER_DISTANCES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/math/pairwise_distances.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * UsesBlockedDistances<MetricType, MatType>::value is true if the distances
+ * between the points of a MatType and the centroids can be computed with
+ * matrix products: ||x - c||^2 = ||x||^2 + ||c||^2 - 2 x^T c.
+ */
+template<typename MetricType, typename MatType>
+struct UsesBlockedDistances
+{
+  static const bool value = false;
+};
+
+//! The Euclidean distance on dense matrices can use matrix products.
+template<>
+struct UsesBlockedDistances<metric::EuclideanDistance, arma::mat>
+{
+  static const bool value = true;
+};
+
+//! The number of points the bound-based Lloyd steps handle at once.
+const size_t CenterDistanceBlockSize = 256;
+
+/**
+ * Compute lower bounds on the distances between the given points of the
+ * dataset and each centroid, as a matrix with one row per centroid and
+ * one column per point.  The squared norms of the points and of the centroids
+ * are computed once, and all the dot products are given by one matrix product
+ * (which the BLAS computes in blocks with SIMD instructions).  This form
+ * loses precision, so a bound on its rounding error is subtracted from each
+ * squared distance; the results are then never larger than the exact
+ * distances, which is all the pruning of the bound-based steps needs.
+ *
+ * @param dataset Dataset.
+ * @param points Indices of the points to use.
+ * @param centroids Centroids.
+ * @param metric Instantiated metric.
+ * @param bounds Matrix to store the lower bounds in.
+ * @return The number of distances computed.
+ */
+template<typename MetricType, typename MatType>
+size_t CenterDistanceBounds(
+    const MatType& dataset,
+    const arma::uvec& points,
+    const arma::mat& centroids,
+    MetricType& /* metric */,
+    arma::mat& bounds,
+    const typename std::enable_if_t<
+        UsesBlockedDistances<MetricType, MatType>::value>* = 0)
+{
+  const arma::mat block = dataset.cols(points);
+  const arma::vec pointNorms = arma::sum(arma::square(block), 0).t();
+  const arma::vec centroidNorms = arma::sum(arma::square(centroids), 0).t();
+
+  math::PairwiseSquaredDistances(centroids, block, centroidNorms, pointNorms,
+      bounds);
+
+  // Each of the three terms is off by at most a few (dimensionality + 2)
+  // machine epsilons of the squared norms.  The squared distances are at
+  // least 0, so subtracting the error from them gives the same bounds.
+  const double epsilon = 4.0 * (dataset.n_rows + 2) *
+      std::numeric_limits<double>::epsilon();
+  for (size_t j = 0; j < bounds.n_cols; ++j)
+  {
+    for (size_t c = 0; c < bounds.n_rows; ++c)
+    {
+      const double error = epsilon * (pointNorms[j] + centroidNorms[c]);
+      bounds(c, j) = std::sqrt(std::max(bounds(c, j) - error, 0.0));
+    }
+  }
+
+  return bounds.n_elem;
+}
+
+/**
+ * Compute the distances between the given points of the dataset and each
+ * centroid with the metric, when matrix products cannot be used.
+ *
+ * @param dataset Dataset.
+ * @param points Indices of the points to use.
+ * @param centroids Centroids.
+ * @param metric Instantiated metric.
+ * @param bounds Matrix to store the distances in.
+ * @return The number of distances computed.
+ */
+template<typename MetricType, typename MatType>
+size_t CenterDistanceBounds(
+    const MatType& dataset,
+    const arma::uvec& points,
+    const arma::mat& centroids,
+    MetricType& metric,
+    arma::mat& bounds,
+    const typename std::enable_if_t<
+        !UsesBlockedDistances<MetricType, MatType>::value>* = 0)
+{
+  bounds.set_size(centroids.n_cols, points.n_elem);
+  for (size_t j = 0; j < points.n_elem; ++j)
+    for (size_t c = 0; c < centroids.n_cols; ++c)
+      bounds(c, j) = metric.Evaluate(dataset.col(points[j]), centroids.col(c));
+
+  return bounds.n_elem;
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,127 @@
+/**
+ * @file methods/kmeans/distributed_kmeans.hpp
+ *
+ * K-means clustering of a dataset sharded over several processes, each of
+ * which runs the Lloyd steps on its own shard.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/distributed/local_communicator.hpp>
+#include <mlpack/core/distributed/mpi_communicator.hpp>
+
+#include "naive_kmeans.hpp"
+#include "sample_initialization.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * DistributedKMeans runs k-means clustering on a dataset of which each process
+ * of a group holds one shard, for datasets that do not fit on one machine.
+ * Every process runs the Lloyd step of the LloydStepType on its own shard;
+ * then the sums and counts of the points of each cluster are summed over all
+ * the processes, so that every process gets the same new centroids, which are
+ * the centroids that KMeans would compute on the whole dataset.  Only the
+ * centroids are exchanged, never the points.
+ *
+ * The initial centroids are sampled from the shard of the first process (which
+ * must hold at least as many points as there are clusters) and broadcast to
+ * the others, unless they are given.  Empty clusters keep their centroid, as
+ * with AllowEmptyClusters.
+ *
+ * The LloydStepType must not keep bounds between its iterations, since the
+ * centroids given to each step are the global ones, not the ones the step
+ * computed; NaiveKMeans and PellegMooreKMeans can be used, but ElkanKMeans,
+ * HamerlyKMeans and DualTreeKMeans cannot.
+ *
+ * Every process of the group must call Cluster() with its shard and the same
+ * parameters.
+ *
+ * @code
+ * distributed::MPICommunicator comm;
+ * DistributedKMeans<distributed::MPICommunicator> k(comm, 100);
+ * arma::mat centroids;
+ * k.Cluster(shard, 1000, centroids);
+ * // centroids is the same in every process.
+ * @endcode
+ *
+ * @tparam CommunicatorType Type of communicator between the processes
+ *     (distributed::MPICommunicator, or distributed::LocalCommunicator for a
+ *     single process).
+ * @tparam MetricType Metric to use.
+ * @tparam LloydStepType Implementation of the Lloyd step run on each shard.
+ * @tparam MatType Type of the shards.
+ */
+template<typename CommunicatorType,
+         typename MetricType = metric::EuclideanDistance,
+         template<class, class> class LloydStepType = NaiveKMeans,
+         typename MatType = arma::mat>
+class DistributedKMeans
+{
+ public:
+  /**
+   * Create the object.  The communicator is kept by reference and must
+   * outlive the object.
+   *
+   * @param communicator Communicator between the processes.
+   * @param maxIterations Maximum number of iterations (0 for no limit).
+   * @param metric Metric to use.
+   */
+  DistributedKMeans(CommunicatorType& communicator,
+                    const size_t maxIterations = 1000,
+                    const MetricType metric = MetricType());
+
+  /**
+   * Cluster the sharded dataset, and store the centroids of the clusters in
+   * every process.
+   *
+   * @param shard Points held by this process.
+   * @param clusters Number of clusters to compute.
+   * @param centroids Matrix to store the centroids in.
+   * @param initialGuess If true, centroids holds the initial centroids (which
+   *     must be the same in every process).
+   */
+  void Cluster(const MatType& shard,
+               const size_t clusters,
+               arma::mat& centroids,
+               const bool initialGuess = false);
+
+  //! Get the number of iterations of the last call to Cluster().
+  size_t Iterations() const { return iterations; }
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+ private:
+  //! The communicator between the processes.
+  CommunicatorType& communicator;
+  //! The maximum number of iterations.
+  size_t maxIterations;
+  //! The metric.
+  MetricType metric;
+  //! The number of iterations of the last call to Cluster().
+  size_t iterations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "distributed_kmeans_impl.hpp"
+
+#endif
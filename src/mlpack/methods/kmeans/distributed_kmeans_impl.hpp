@@ -0,0 +1,122 @@
+/**
+ * @file methods/kmeans/distributed_kmeans_impl.hpp
+ *
+ * Implementation of k-means clustering of a sharded dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "distributed_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename CommunicatorType,
+         typename MetricType,
+         template<class, class> class LloydStepType,
+         typename MatType>
+DistributedKMeans<CommunicatorType, MetricType, LloydStepType, MatType>::
+DistributedKMeans(CommunicatorType& communicator,
+                  const size_t maxIterations,
+                  const MetricType metric) :
+    communicator(communicator),
+    maxIterations(maxIterations),
+    metric(metric),
+    iterations(0)
+{
+  // Nothing to do.
+}
+
+template<typename CommunicatorType,
+         typename MetricType,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void DistributedKMeans<CommunicatorType, MetricType, LloydStepType, MatType>::
+Cluster(const MatType& shard,
+        const size_t clusters,
+        arma::mat& centroids,
+        const bool initialGuess)
+{
+  if (initialGuess)
+  {
+    if (centroids.n_cols != clusters || centroids.n_rows != shard.n_rows)
+    {
+      Log::Fatal << "DistributedKMeans::Cluster(): initial centroids have size "
+          << centroids.n_rows << "x" << centroids.n_cols << ", should be "
+          << shard.n_rows << "x" << clusters << "!" << std::endl;
+    }
+  }
+  else
+  {
+    if (communicator.Rank() == 0)
+    {
+      if (shard.n_cols < clusters)
+      {
+        Log::Fatal << "DistributedKMeans::Cluster(): the shard of the first "
+            << "process has " << shard.n_cols << " points, but " << clusters
+            << " initial centroids are needed!" << std::endl;
+      }
+
+      SampleInitialization::Cluster(shard, clusters, centroids);
+    }
+
+    communicator.Broadcast(centroids, 0);
+  }
+
+  LloydStepType<MetricType, MatType> lloydStep(shard, metric);
+  arma::mat newCentroids;
+  arma::Col<size_t> counts;
+
+  // The sums of the points of each cluster, with their counts in the last
+  // row, so that one reduction per iteration is enough.
+  arma::mat sums(shard.n_rows + 1, clusters);
+
+  iterations = 0;
+  double cNorm;
+  do
+  {
+    lloydStep.Iterate(centroids, newCentroids, counts);
+
+    for (size_t c = 0; c < clusters; ++c)
+    {
+      sums.submat(0, c, shard.n_rows - 1, c) = newCentroids.col(c) *
+          (double) counts[c];
+      sums(shard.n_rows, c) = (double) counts[c];
+    }
+
+    communicator.AllReduceSum(sums);
+
+    cNorm = 0.0;
+    for (size_t c = 0; c < clusters; ++c)
+    {
+      const double count = sums(shard.n_rows, c);
+      if (count == 0.0)
+        continue;
+
+      newCentroids.col(c) = sums.submat(0, c, shard.n_rows - 1, c) / count;
+      cNorm += std::pow(metric.Evaluate(centroids.col(c),
+          newCentroids.col(c)), 2.0);
+      centroids.col(c) = newCentroids.col(c);
+    }
+    cNorm = std::sqrt(cNorm);
+
+    ++iterations;
+    Log::Info << "DistributedKMeans::Cluster(): iteration " << iterations
+        << ", residual " << cNorm << ".\n";
+  } while (cNorm > 1e-5 && iterations != maxIterations);
+
+  Log::Info << "DistributedKMeans::Cluster(): " << iterations
+      << " iterations over " << communicator.Size() << " processes."
+      << std::endl;
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -30,6 +30,13 @@ namespace kmeans {
  * dataset.  The conditions under which this will perform best are probably
  * limited to the case where k is close to the number of points in the dataset,
  * and the number of iterations of the k-means algorithm will be few.
+ *
+ * The dataset may be an arma::fmat, in which case the trees are built on float
+ * data and the centroids are converted to float before each search.  The tree
+ * built on the centroids is kept between iterations: when the centroids moved
+ * by less than a quarter of the median distance between neighboring
+ * centroids, its points are moved and its bounds are refit (for
+ * BinarySpaceTree types) instead of building a new tree.
  */
 template<
     typename MetricType,
@@ -88,6 +95,15 @@ class DualTreeKMeans
   //! The metric.
   MetricType metric;
 
+  //! The nearest neighbor search type used on the centroids.
+  typedef neighbor::NeighborSearch<neighbor::NearestNeighborSort, MetricType,
+      MatType, NNSTreeType> CentroidSearchType;
+  //! The search on the centroids, whose tree is kept between iterations (or
+  //! NULL before the first iteration).
+  CentroidSearchType* centroidSearch;
+  //! Mappings from the points of the centroid tree to the centroids.
+  std::vector<size_t> oldFromNewCentroids;
+
   //! Track distance calculations.
   size_t distanceCalculations;
   //! Track iteration number.
@@ -113,7 +129,7 @@ class DualTreeKMeans
   //! Update the bounds in the tree before the next iteration.
   //! centroids is the current (not yet searched) centroids.
   void UpdateTree(Tree& node,
-                  const arma::mat& centroids,
+                  const MatType& centroids,
                   const double parentUpperBound = 0.0,
                   const double adjustedParentUpperBound = DBL_MAX,
                   const double parentLowerBound = DBL_MAX,
@@ -129,6 +145,28 @@ class DualTreeKMeans
   void DecoalesceTree(Tree& node);
 };
 
+//! Utility function for refitting a centroid tree to moved centroids.  This
+//! is called for trees that cannot be refit, and returns false, so that a new
+//! tree is built.
+template<typename TreeType, typename MatType>
+bool RefitCentroidTree(TreeType& tree,
+                       const MatType& centroids,
+                       const std::vector<size_t>& oldFromNew);
+
+//! Utility function for refitting a centroid tree to moved centroids.  This
+//! is called for BinarySpaceTree types: the points of the tree are moved, and
+//! the bounds and the statistics of the nodes are recomputed.
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+bool RefitCentroidTree(tree::BinarySpaceTree<MetricType, StatisticType,
+                           MatType, BoundType, SplitType>& tree,
+                       const MatType& centroids,
+                       const std::vector<size_t>& oldFromNew);
+
 //! Utility function for hiding children.  This actually does something, and is
 //! called if the tree is not a binary tree.
 template<typename TreeType>
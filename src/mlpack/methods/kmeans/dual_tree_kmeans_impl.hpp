@@ -47,6 +47,49 @@ TreeType* BuildTree(
   return new TreeType(std::forward<MatType>(dataset));
 }
 
+//! Trees other than BinarySpaceTrees are rebuilt.
+template<typename TreeType, typename MatType>
+bool RefitCentroidTree(TreeType& /* tree */,
+                       const MatType& /* centroids */,
+                       const std::vector<size_t>& /* oldFromNew */)
+{
+  return false;
+}
+
+//! Recompute the statistics of a node and its descendants, children first.
+template<typename TreeType>
+void ResetCentroidStatistics(TreeType& node)
+{
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    ResetCentroidStatistics(node.Child(i));
+
+  node.Stat() = DualTreeKMeansStatistic(node);
+}
+
+//! Move the points of a BinarySpaceTree and refit its bounds.
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+bool RefitCentroidTree(tree::BinarySpaceTree<MetricType, StatisticType,
+                           MatType, BoundType, SplitType>& tree,
+                       const MatType& centroids,
+                       const std::vector<size_t>& oldFromNew)
+{
+  MatType& points = tree.Dataset();
+  for (size_t i = 0; i < points.n_cols; ++i)
+    points.col(i) = centroids.col(oldFromNew[i]);
+
+  tree.RefitBounds();
+
+  // The statistics hold the centroids of the nodes, and the bounds of the last
+  // nearest neighbor search.
+  ResetCentroidStatistics(tree);
+  return true;
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
@@ -59,6 +102,7 @@ DualTreeKMeans<MetricType, MatType, TreeType>::DualTreeKMeans(
     tree(new Tree(const_cast<MatType&>(dataset))),
     dataset(tree->Dataset()),
     metric(metric),
+    centroidSearch(NULL),
     distanceCalculations(0),
     iteration(0),
     upperBounds(dataset.n_cols),
@@ -86,6 +130,7 @@ DualTreeKMeans<MetricType, MatType, TreeType>::~DualTreeKMeans()
 {
   if (tree)
     delete tree;
+  delete centroidSearch;
 }
 
 // Run a single iteration.
@@ -99,16 +144,39 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
     arma::mat& newCentroids,
     arma::Col<size_t>& counts)
 {
-  // Build a tree on the centroids.  This will make a copy if necessary, which
-  // is unfortunate, but I don't see a reasonable way around it.
-  std::vector<size_t> oldFromNewCentroids;
-  Tree* centroidTree = BuildTree<Tree>(centroids, oldFromNewCentroids);
+  // The centroids, with the element type of the dataset.
+  const MatType treeCentroids = arma::conv_to<MatType>::from(centroids);
+
+  // If the centroids moved little during the last iteration, the tree built on
+  // them can still be used: move its points and refit its bounds.
+  bool refit = false;
+  if (centroidSearch != NULL && iteration > 1 &&
+      centroidSearch->ReferenceTree().Dataset().n_cols == centroids.n_cols)
+  {
+    const double maxMovement = clusterDistances[centroids.n_cols];
+    const double spacing = arma::median(arma::vectorise(interclusterDistances));
+    if (maxMovement <= 0.25 * spacing)
+    {
+      refit = RefitCentroidTree(centroidSearch->ReferenceTree(), treeCentroids,
+          oldFromNewCentroids);
+    }
+  }
 
-  // Find the nearest neighbors of each of the clusters.  We have to make our
-  // own TreeType, which is a little bit abuse, but we know for sure the
-  // TreeStatType we have will work.
-  neighbor::NeighborSearch<neighbor::NearestNeighborSort, MetricType, MatType,
-      NNSTreeType> nns(std::move(*centroidTree));
+  if (!refit)
+  {
+    // Build a tree on the centroids.  This will make a copy if necessary,
+    // which is unfortunate, but I don't see a reasonable way around it.
+    delete centroidSearch;
+    oldFromNewCentroids.clear();
+    Tree* centroidTree = BuildTree<Tree>(treeCentroids, oldFromNewCentroids);
+
+    // Find the nearest neighbors of each of the clusters.  We have to make our
+    // own TreeType, which is a little bit abuse, but we know for sure the
+    // TreeStatType we have will work.
+    centroidSearch = new CentroidSearchType(std::move(*centroidTree));
+    delete centroidTree;
+  }
+  CentroidSearchType& nns = *centroidSearch;
 
   // Reset information in the tree, if we need to.
   if (iteration > 0)
@@ -132,7 +200,7 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
       delete interclusterDistancesTemp;
     }
 
-    UpdateTree(*tree, centroids);
+    UpdateTree(*tree, treeCentroids);
 
     for (size_t i = 0; i < dataset.n_cols; ++i)
       visited[i] = false;
@@ -191,8 +259,6 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
   }
   distanceCalculations += centroids.n_cols;
 
-  delete centroidTree;
-
   ++iteration;
 
   return std::sqrt(residual);
@@ -205,7 +271,7 @@ template<typename MetricType,
                   typename TreeMatType> class TreeType>
 void DualTreeKMeans<MetricType, MatType, TreeType>::UpdateTree(
     Tree& node,
-    const arma::mat& centroids,
+    const MatType& centroids,
     const double parentUpperBound,
     const double adjustedParentUpperBound,
     const double parentLowerBound,
@@ -518,7 +584,8 @@ node.Stat().UpperBound() << " and owner " << node.Stat().Owner() << ".\n";
       for (size_t i = 0; i < node.NumPoints(); ++i)
       {
         const size_t owner = assignments[node.Point(i)];
-        newCentroids.col(owner) += dataset.col(node.Point(i));
+        newCentroids.col(owner) += arma::conv_to<arma::vec>::from(
+            dataset.col(node.Point(i)));
         ++newCounts[owner];
 
 /*
@@ -23,8 +23,8 @@ template<typename MetricType, typename TreeType>
 class DualTreeKMeansRules
 {
  public:
-  DualTreeKMeansRules(const arma::mat& centroids,
-                      const arma::mat& dataset,
+  DualTreeKMeansRules(const typename TreeType::Mat& centroids,
+                      const typename TreeType::Mat& dataset,
                       arma::Row<size_t>& assignments,
                       arma::vec& upperBounds,
                       arma::vec& lowerBounds,
@@ -60,8 +60,8 @@ class DualTreeKMeansRules
   size_t MinimumBaseCases() const { return 0; }
 
  private:
-  const arma::mat& centroids;
-  const arma::mat& dataset;
+  const typename TreeType::Mat& centroids;
+  const typename TreeType::Mat& dataset;
   arma::Row<size_t>& assignments;
   arma::vec& upperBounds;
   arma::vec& lowerBounds;
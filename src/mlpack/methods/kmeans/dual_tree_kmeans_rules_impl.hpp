@@ -19,8 +19,8 @@ namespace kmeans {
 
 template<typename MetricType, typename TreeType>
 DualTreeKMeansRules<MetricType, TreeType>::DualTreeKMeansRules(
-    const arma::mat& centroids,
-    const arma::mat& dataset,
+    const typename TreeType::Mat& centroids,
+    const typename TreeType::Mat& dataset,
     arma::Row<size_t>& assignments,
     arma::vec& upperBounds,
     arma::vec& lowerBounds,
@@ -233,7 +233,8 @@ inline double DualTreeKMeansRules<MetricType, TreeType>::Score(
   if (score != DBL_MAX)
   {
     // Get minimum and maximum distances.
-    const math::Range distances = queryNode.RangeDistance(referenceNode);
+    const math::RangeType<typename TreeType::ElemType> distances =
+        queryNode.RangeDistance(referenceNode);
 
     score = distances.Lo();
     ++scores;
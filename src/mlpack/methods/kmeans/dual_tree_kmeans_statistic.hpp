@@ -57,7 +57,8 @@ class DualTreeKMeansStatistic : public
       if (tree::TreeTraits<TreeType>::HasSelfChildren && i == 0 &&
           node.NumChildren() > 0)
         continue;
-      centroid += node.Dataset().col(node.Point(i));
+      centroid += arma::conv_to<arma::vec>::from(
+          node.Dataset().col(node.Point(i)));
     }
 
     for (size_t i = 0; i < node.NumChildren(); ++i)
@@ -12,6 +12,8 @@
 #ifndef MLPACK_METHODS_KMEANS_ELKAN_KMEANS_HPP
 #define MLPACK_METHODS_KMEANS_ELKAN_KMEANS_HPP
 
+#include "center_distances.hpp"
+
 namespace mlpack {
 namespace kmeans {
 
@@ -26,7 +28,8 @@ class ElkanKMeans
 
   /**
    * Run a single iteration of Elkan's algorithm, updating the given centroids
-   * into the newCentroids matrix.
+   * into the newCentroids matrix.  The points are processed in parallel with
+   * OpenMP, if available.
    *
    * @param centroids Current cluster centroids.
    * @param newCentroids New cluster centroids.
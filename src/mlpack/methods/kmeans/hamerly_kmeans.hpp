@@ -12,6 +12,8 @@
 #ifndef MLPACK_METHODS_KMEANS_HAMERLY_KMEANS_HPP
 #define MLPACK_METHODS_KMEANS_HAMERLY_KMEANS_HPP
 
+#include "center_distances.hpp"
+
 namespace mlpack {
 namespace kmeans {
 
@@ -27,7 +29,8 @@ class HamerlyKMeans
 
   /**
    * Run a single iteration of Hamerly's algorithm, updating the given centroids
-   * into the newCentroids matrix.
+   * into the newCentroids matrix.  The points are processed in parallel with
+   * OpenMP, if available.
    *
    * @param centroids Current cluster centroids.
    * @param newCentroids New cluster centroids.
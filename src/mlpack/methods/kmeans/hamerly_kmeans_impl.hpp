@@ -67,64 +67,126 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     }
   }
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // Every point only touches its own bounds, so the points are split into
+  // blocks over the threads, and each thread sums its own centroids.
+  const size_t numBlocks = (dataset.n_cols + CenterDistanceBlockSize - 1) /
+      CenterDistanceBlockSize;
+  size_t newDistanceCalculations = 0;
+  #pragma omp parallel reduction(+:newDistanceCalculations, hamerlyPruned)
   {
-    const double m = std::max(minClusterDistances(assignments[i]),
-                              lowerBounds(i));
-
-    // First bound test.
-    if (upperBounds(i) <= m)
+    arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
+        arma::fill::zeros);
+    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+    std::vector<arma::uword> unpruned;
+    arma::mat bounds;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
     {
-      ++hamerlyPruned;
-      newCentroids.col(assignments[i]) += dataset.col(i);
-      ++counts(assignments[i]);
-      continue;
-    }
-
-    // Tighten upper bound.
-    upperBounds(i) = metric.Evaluate(dataset.col(i),
-                                     centroids.col(assignments[i]));
-    ++distanceCalculations;
+      const size_t begin = b * CenterDistanceBlockSize;
+      const size_t end = std::min(begin + CenterDistanceBlockSize,
+          (size_t) dataset.n_cols);
 
-    // Second bound test.
-    if (upperBounds(i) <= m)
-    {
-      newCentroids.col(assignments[i]) += dataset.col(i);
-      ++counts(assignments[i]);
-      continue;
-    }
+      unpruned.clear();
+      for (size_t i = begin; i < end; ++i)
+      {
+        const double m = std::max(minClusterDistances(assignments[i]),
+                                  lowerBounds(i));
+
+        // First bound test.
+        if (upperBounds(i) <= m)
+        {
+          ++hamerlyPruned;
+          localCentroids.col(assignments[i]) += dataset.col(i);
+          ++localCounts(assignments[i]);
+          continue;
+        }
+
+        // Tighten upper bound.
+        upperBounds(i) = metric.Evaluate(dataset.col(i),
+                                         centroids.col(assignments[i]));
+        ++newDistanceCalculations;
+
+        // Second bound test.
+        if (upperBounds(i) <= m)
+        {
+          localCentroids.col(assignments[i]) += dataset.col(i);
+          ++localCounts(assignments[i]);
+          continue;
+        }
+
+        unpruned.push_back(i);
+      }
 
-    // The bounds failed.  So test against all other clusters.
-    // This is Hamerly's Point-All-Ctrs() function from the paper.
-    // We have to reset the lower bound first.
-    lowerBounds(i) = DBL_MAX;
-    for (size_t c = 0; c < centroids.n_cols; ++c)
-    {
-      if (c == assignments[i])
+      if (unpruned.empty())
         continue;
 
-      const double dist = metric.Evaluate(dataset.col(i), centroids.col(c));
-
-      // Is this a better cluster?  At this point, upperBounds[i] = d(i, c(i)).
-      if (dist < upperBounds(i))
+      // The bounds failed for these points.  So test against all other
+      // clusters.  This is Hamerly's Point-All-Ctrs() function from the paper.
+      // When the distances reduce to a matrix product, lower bounds on all of
+      // them are computed at once, and only the clusters whose lower bound is
+      // below the current upper bound need an exact distance.
+      const bool blocked = UsesBlockedDistances<MetricType, MatType>::value;
+      if (blocked)
       {
-        // lowerBounds holds the second closest cluster.
-        lowerBounds(i) = upperBounds(i);
-        upperBounds(i) = dist;
-        assignments[i] = c;
+        newDistanceCalculations += CenterDistanceBounds(dataset,
+            arma::uvec(unpruned), centroids, metric, bounds);
       }
-      else if (dist < lowerBounds(i))
+
+      for (size_t j = 0; j < unpruned.size(); ++j)
       {
-        // This is a closer second-closest cluster.
-        lowerBounds(i) = dist;
+        const size_t i = unpruned[j];
+
+        // We have to reset the lower bound first.
+        lowerBounds(i) = DBL_MAX;
+        for (size_t c = 0; c < centroids.n_cols; ++c)
+        {
+          if (c == assignments[i])
+            continue;
+
+          if (blocked && bounds(c, j) >= upperBounds(i))
+          {
+            // This cluster can't be closer, but its bound may still be the
+            // best bound on the second-closest cluster.
+            if (bounds(c, j) < lowerBounds(i))
+              lowerBounds(i) = bounds(c, j);
+            continue;
+          }
+
+          const double dist = metric.Evaluate(dataset.col(i),
+                                              centroids.col(c));
+          ++newDistanceCalculations;
+
+          // Is this a better cluster?  At this point, upperBounds[i] =
+          // d(i, c(i)).
+          if (dist < upperBounds(i))
+          {
+            // lowerBounds holds the second closest cluster.
+            lowerBounds(i) = upperBounds(i);
+            upperBounds(i) = dist;
+            assignments[i] = c;
+          }
+          else if (dist < lowerBounds(i))
+          {
+            // This is a closer second-closest cluster.
+            lowerBounds(i) = dist;
+          }
+        }
+
+        // Update new centroids.
+        localCentroids.col(assignments[i]) += dataset.col(i);
+        ++localCounts(assignments[i]);
       }
     }
-    distanceCalculations += centroids.n_cols - 1;
 
-    // Update new centroids.
-    newCentroids.col(assignments[i]) += dataset.col(i);
-    ++counts(assignments[i]);
+    // Combine the sums of each thread.
+    #pragma omp critical
+    {
+      newCentroids += localCentroids;
+      counts += localCounts;
+    }
   }
+  distanceCalculations += newDistanceCalculations;
 
   // Normalize centroids and calculate cluster movement (contains parts of
   // Move-Centers() and Update-Bounds()).
@@ -158,7 +220,8 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   }
 
   // Now update bounds (lines 3-8 of Update-Bounds()).
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
     upperBounds(i) += centroidMovements(assignments[i]);
     if (assignments[i] == furthestMovingCluster)
@@ -18,6 +18,7 @@
 #include "sample_initialization.hpp"
 #include "max_variance_new_cluster.hpp"
 #include "naive_kmeans.hpp"
+#include "mini_batch_kmeans.hpp"
 
 #include <mlpack/core/tree/binary_space_tree.hpp>
 
@@ -63,7 +64,7 @@ namespace kmeans /** K-Means clustering. */ {
  * @tparam LloydStepType Implementation of single Lloyd step to use.
  *
  * @see RandomPartition, SampleInitialization, RefinedStart, AllowEmptyClusters,
- *      MaxVarianceNewCluster, NaiveKMeans, ElkanKMeans
+ *      MaxVarianceNewCluster, NaiveKMeans, ElkanKMeans, MiniBatchKMeans
  */
 template<typename MetricType = metric::EuclideanDistance,
          typename InitialPartitionPolicy = SampleInitialization,
@@ -155,6 +156,47 @@ class KMeans
                const bool initialAssignmentGuess = false,
                const bool initialCentroidGuess = false);
 
+  /**
+   * Perform mini-batch k-means clustering on data given in chunks by the
+   * source, returning the centroids of each cluster in the centroids matrix.
+   * This is for datasets that do not fit in memory: each chunk is used once,
+   * as one batch of MiniBatchKMeans (whatever the LloydStepType is, since the
+   * other steps need the whole dataset), and the initial centroids are given
+   * by the InitialPartitionPolicy on the first chunk, unless the centroids
+   * matrix is filled with the initial centroids and initialGuess is true.
+   * Empty clusters are handled by the EmptyClusterPolicy on the current chunk.
+   * At most MaxIterations() batches are used (0 means no limit).
+   *
+   * The source is called as 'bool source(MatType& chunk)'; it should fill
+   * the matrix with the next chunk of points and return true, or return false
+   * once there are no more points.
+   *
+   * @code
+   * // Cluster a dataset stored in many files.
+   * size_t file = 0;
+   * auto source = [&](arma::mat& chunk)
+   * {
+   *   return file < numFiles && data::Load(files[file++], chunk);
+   * };
+   * KMeans<> k(0);
+   * k.ClusterStream(source, 100, centroids);
+   * @endcode
+   *
+   * @param source Source of the chunks of the dataset.
+   * @param clusters Number of clusters to compute.
+   * @param centroids Matrix in which centroids are stored.
+   * @param initialGuess If true, then it is assumed that centroids contains the
+   *      initial cluster centroids.
+   * @param batchSize Chunks larger than this are split into batches of this
+   *      size.
+   */
+  template<typename ChunkSourceType>
+  void ClusterStream(ChunkSourceType& source,
+                     const size_t clusters,
+                     arma::mat& centroids,
+                     const bool initialGuess = false,
+                     const size_t batchSize = 1024);
+
   //! Get the maximum number of iterations.
   size_t MaxIterations() const { return maxIterations; }
   //! Set the maximum number of iterations.
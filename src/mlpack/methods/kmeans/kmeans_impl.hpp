@@ -337,6 +337,117 @@ Cluster(const MatType& data,
   }
 }
 
+/**
+ * Perform mini-batch k-means clustering on chunks of the data given by the
+ * source, returning the centroids of each cluster.
+ */
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         template<class, class> class LloydStepType,
+         typename MatType>
+template<typename ChunkSourceType>
+void KMeans<
+    MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    LloydStepType,
+    MatType>::
+ClusterStream(ChunkSourceType& source,
+              const size_t clusters,
+              arma::mat& centroids,
+              const bool initialGuess,
+              const size_t batchSize)
+{
+  MatType chunk;
+  if (!source(chunk))
+  {
+    Log::Warn << "KMeans::ClusterStream(): the source gave no points."
+        << std::endl;
+    return;
+  }
+
+  if (initialGuess)
+  {
+    if (centroids.n_cols != clusters)
+      Log::Fatal << "KMeans::ClusterStream(): wrong number of initial cluster "
+        << "centroids (" << centroids.n_cols << ", should be " << clusters
+        << ")!" << std::endl;
+  }
+  else
+  {
+    // The initial centroids are found from the first chunk only.
+    arma::Row<size_t> assignments;
+    bool gotAssignments = GetInitialAssignmentsOrCentroids(partitioner, chunk,
+        clusters, assignments, centroids);
+    if (gotAssignments)
+    {
+      arma::Row<size_t> counts;
+      counts.zeros(clusters);
+      centroids.zeros(chunk.n_rows, clusters);
+      for (size_t i = 0; i < chunk.n_cols; ++i)
+      {
+        centroids.col(assignments[i]) += arma::vec(chunk.col(i));
+        counts[assignments[i]]++;
+      }
+
+      for (size_t i = 0; i < clusters; ++i)
+        if (counts[i] != 0)
+          centroids.col(i) /= counts[i];
+    }
+  }
+
+  // Counts of the points given to each cluster, over all the batches.
+  arma::Col<size_t> counts(clusters, arma::fill::zeros);
+
+  size_t iteration = 0;
+
+  MiniBatchKMeans<MetricType, MatType> miniBatchStep(chunk, metric, batchSize);
+  arma::mat newCentroids;
+
+  do
+  {
+    if (chunk.n_rows != centroids.n_rows)
+      Log::Fatal << "KMeans::ClusterStream(): chunk has wrong dimensionality ("
+          << chunk.n_rows << ", should be " << centroids.n_rows << ")!"
+          << std::endl;
+
+    for (size_t begin = 0; begin < chunk.n_cols && iteration != maxIterations;
+        begin += batchSize)
+    {
+      if (chunk.n_cols <= batchSize)
+      {
+        miniBatchStep.Step(chunk, centroids, newCentroids, counts);
+      }
+      else
+      {
+        const size_t end = std::min(begin + batchSize, (size_t) chunk.n_cols);
+        const MatType batch = chunk.cols(begin, end - 1);
+        miniBatchStep.Step(batch, centroids, newCentroids, counts);
+      }
+
+      // A cluster is only empty if it has never been given a point.
+      for (size_t i = 0; i < counts.n_elem; ++i)
+      {
+        if (counts[i] == 0)
+        {
+          Log::Info << "Cluster " << i << " is empty.\n";
+          emptyClusterAction.EmptyCluster(chunk, i, centroids, newCentroids,
+              counts, metric, iteration);
+        }
+      }
+
+      centroids.swap(newCentroids);
+      iteration++;
+    }
+  } while (iteration != maxIterations && source(chunk));
+
+  Log::Info << "KMeans::ClusterStream(): used " << iteration << " batches."
+      << std::endl;
+  Log::Info << miniBatchStep.DistanceCalculations() << " distance "
+      << "calculations." << std::endl;
+}
+
 template<typename MetricType,
          typename InitialPartitionPolicy,
          typename EmptyClusterPolicy,
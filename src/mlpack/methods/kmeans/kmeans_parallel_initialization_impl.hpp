@@ -0,0 +1,134 @@
+/**
+ * @file methods/kmeans/kmeans_parallel_initialization_impl.hpp
+ *
+ * Implementation of the k-means|| initialization strategy.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kmeans_parallel_initialization.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MatType>
+void KMeansParallelInitialization::Cluster(const MatType& data,
+                                           const size_t clusters,
+                                           arma::mat& centroids) const
+{
+  // The first candidate is sampled fully randomly.
+  arma::mat candidates(data.n_rows, 1);
+  candidates.col(0) = data.col(math::RandInt(0, data.n_cols));
+
+  // The squared distance between each point and its closest candidate, and
+  // the index of that candidate.
+  arma::vec distances(data.n_cols);
+  distances.fill(std::numeric_limits<double>::max());
+  arma::Col<size_t> closest(data.n_cols, arma::fill::zeros);
+
+  const double expectedSamples = oversampling * clusters;
+  size_t oldCandidates = 0;
+  for (size_t r = 0; r <= rounds; ++r)
+  {
+    // Only the candidates sampled in the last round can be closer.
+    #pragma omp parallel for
+    for (omp_size_t p = 0; p < (omp_size_t) data.n_cols; ++p)
+    {
+      for (size_t c = oldCandidates; c < candidates.n_cols; ++c)
+      {
+        const double distance = metric::SquaredEuclideanDistance::Evaluate(
+            data.col(p), candidates.col(c));
+        if (distance < distances[p])
+        {
+          distances[p] = distance;
+          closest[p] = c;
+        }
+      }
+    }
+    oldCandidates = candidates.n_cols;
+
+    // The last pass only assigns the points to the newest candidates.
+    if (r == rounds)
+      break;
+
+    // If every point is already a candidate, there is nothing left to sample.
+    const double cost = arma::accu(distances);
+    if (cost == 0.0)
+      break;
+
+    // Sample each point independently with probability
+    // l * d^2(x, C) / cost.
+    const arma::vec samples = arma::randu<arma::vec>(data.n_cols);
+    std::vector<size_t> sampled;
+    for (size_t p = 0; p < data.n_cols; ++p)
+      if (samples[p] * cost < expectedSamples * distances[p])
+        sampled.push_back(p);
+
+    candidates.resize(data.n_rows, oldCandidates + sampled.size());
+    for (size_t i = 0; i < sampled.size(); ++i)
+      candidates.col(oldCandidates + i) = data.col(sampled[i]);
+  }
+
+  centroids.set_size(data.n_rows, clusters);
+
+  // With too few candidates, the remaining centroids are random points.
+  if (candidates.n_cols <= clusters)
+  {
+    centroids.cols(0, candidates.n_cols - 1) = candidates;
+    for (size_t i = candidates.n_cols; i < clusters; ++i)
+      centroids.col(i) = data.col(math::RandInt(0, data.n_cols));
+    return;
+  }
+
+  // Weight each candidate by the number of points closest to it.
+  arma::vec weights(candidates.n_cols, arma::fill::zeros);
+  for (size_t p = 0; p < data.n_cols; ++p)
+    weights[closest[p]] += 1.0;
+
+  // Now reduce the candidates to the final centroids with weighted k-means++:
+  // each candidate is sampled with probability proportional to its weight
+  // times its squared distance to the closest chosen centroid.
+  arma::vec candidateDistances(candidates.n_cols);
+  candidateDistances.fill(1.0);
+  for (size_t i = 0; i < clusters; ++i)
+  {
+    if (i > 0)
+    {
+      for (size_t c = 0; c < candidates.n_cols; ++c)
+      {
+        const double distance = metric::SquaredEuclideanDistance::Evaluate(
+            candidates.col(c), centroids.col(i - 1));
+        candidateDistances[c] = (i == 1) ? distance :
+            std::min(distance, candidateDistances[c]);
+      }
+    }
+
+    const arma::vec distribution = arma::cumsum(weights % candidateDistances);
+    const double total = distribution[distribution.n_elem - 1];
+
+    // If every candidate is already a centroid, any candidate will do.
+    if (total == 0.0)
+    {
+      centroids.col(i) = candidates.col(math::RandInt(0, candidates.n_cols));
+      continue;
+    }
+
+    const double sampleValue = math::Random() * total;
+    const double* elem = std::lower_bound(distribution.begin(),
+        distribution.end(), sampleValue);
+    const size_t position = std::min((size_t) (elem - distribution.begin()),
+        (size_t) candidates.n_cols - 1);
+    centroids.col(i) = candidates.col(position);
+  }
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -37,7 +37,8 @@ class KMeansPlusPlusInitialization
 
   /**
    * Initialize the centroids matrix by randomly sampling points from the data
-   * matrix.
+   * matrix.  The distance of each point to its closest centroid is updated
+   * incrementally, in parallel over the points with OpenMP if available.
    *
    * @param data Dataset.
    * @param clusters Number of clusters.
@@ -54,47 +55,41 @@ class KMeansPlusPlusInitialization
     size_t firstPoint = mlpack::math::RandInt(0, data.n_cols);
     centroids.col(0) = data.col(firstPoint);
 
-    // Utility variable.
-    arma::vec distribution(data.n_cols);
+    // The squared distance between each point and its closest already-chosen
+    // centroid.  Only the newest centroid can change it, so each pass only
+    // needs one distance per point.
+    arma::vec distances(data.n_cols);
+    distances.fill(std::numeric_limits<double>::max());
 
     // Now, sample other points...
     for (size_t i = 1; i < clusters; ++i)
     {
-      // We must compute the CDF for sampling... this depends on the computation
-      // of the minimum distance between each point and its closest
-      // already-chosen centroid.
-      //
-      // This computation is ripe for speedup with trees!  I am not sure exactly
-      // how much we would need to approximate, but I think it could be done
-      // without breaking the O(log k)-competitive guarantee (I think).
-      for (size_t p = 0; p < data.n_cols; ++p)
+      #pragma omp parallel for
+      for (omp_size_t p = 0; p < (omp_size_t) data.n_cols; ++p)
       {
-        double minDistance = std::numeric_limits<double>::max();
-        for (size_t j = 0; j < i; ++j)
-        {
-          const double distance =
-              mlpack::metric::SquaredEuclideanDistance::Evaluate(data.col(p),
-              centroids.col(j));
-          minDistance = std::min(distance, minDistance);
-        }
-
-        distribution[p] = minDistance;
+        const double distance =
+            mlpack::metric::SquaredEuclideanDistance::Evaluate(data.col(p),
+            centroids.col(i - 1));
+        distances[p] = std::min(distance, distances[p]);
       }
 
-      // Next normalize the distribution (actually technically we could avoid
-      // this).
-      distribution /= arma::accu(distribution);
+      // Turn the distances into an (unnormalized) CDF for sampling.
+      const arma::vec distribution = arma::cumsum(distances);
+      const double total = distribution[distribution.n_elem - 1];
 
-      // Turn it into a CDF for convenience...
-      for (size_t j = 1; j < distribution.n_elem; ++j)
-        distribution[j] += distribution[j - 1];
+      // If every point is already a centroid, any point will do.
+      if (total == 0.0)
+      {
+        centroids.col(i) = data.col(mlpack::math::RandInt(0, data.n_cols));
+        continue;
+      }
 
       // Sample a point...
-      const double sampleValue = mlpack::math::Random();
+      const double sampleValue = mlpack::math::Random() * total;
       const double* elem = std::lower_bound(distribution.begin(),
           distribution.end(), sampleValue);
-      const size_t position = (size_t)
-          (elem - distribution.begin()) / sizeof(double);
+      const size_t position = std::min((size_t) (elem - distribution.begin()),
+          (size_t) data.n_cols - 1);
       centroids.col(i) = data.col(position);
     }
   }
@@ -0,0 +1,129 @@
+/**
+ * @file methods/kmeans/mini_batch_kmeans.hpp
+ *
+ * An implementation of a mini-batch step of k-means clustering, where each
+ * iteration only visits a small random sample of the dataset.  This is the
+ * choice for datasets too large for full Lloyd iterations.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * This is an implementation of the mini-batch k-means algorithm of Sculley.
+ * Instead of assigning every point of the dataset to its closest centroid,
+ * each iteration draws a random batch of points, assigns them to their
+ * closest centroids, and moves each centroid towards each of its points in
+ * turn, with a learning rate of one over the number of points that have
+ * been assigned to the centroid so far.  So each centroid is the running mean
+ * of the points it has been given, and centroids that have seen many points
+ * move less.  The dataset is never visited as a whole, so each iteration
+ * costs time linear in the batch size instead of the size of the dataset.
+ *
+ * The number of points of each cluster passed to and returned from Iterate()
+ * is the number of points assigned to the cluster since the first iteration
+ * (so the counts must be kept between iterations, as KMeans does).  A cluster
+ * is then only empty if no point has ever been assigned to it, and the
+ * EmptyClusterPolicy of KMeans handles it as usual.
+ *
+ * The updates are noisy, so the change of the centroids rarely falls below
+ * the tolerance of KMeans; the maximum number of iterations of KMeans is
+ * the number of batches to process.  To cluster a dataset that does not fit
+ * in memory, give its chunks to Step() (or use KMeans::ClusterStream()).
+ *
+ * @code
+ * @inproceedings{sculley2010web,
+ *   title={Web-Scale K-Means Clustering},
+ *   author={Sculley, D.},
+ *   booktitle={Proceedings of the 19th International Conference on World Wide
+ *       Web},
+ *   pages={1177--1178},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * @param MetricType Type of metric used with this implementation.
+ * @param MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename MetricType, typename MatType>
+class MiniBatchKMeans
+{
+ public:
+  /**
+   * Construct the MiniBatchKMeans object with the given dataset and metric.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   * @param batchSize Number of points sampled in each iteration.
+   */
+  MiniBatchKMeans(const MatType& dataset,
+                  MetricType& metric,
+                  const size_t batchSize = 1024);
+
+  /**
+   * Run a single iteration on a random batch of the dataset, updating the
+   * given centroids into the newCentroids matrix.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Number of points assigned to each cluster so far; this is
+   *     reset on the first iteration.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  /**
+   * Update the given centroids into the newCentroids matrix with the given
+   * batch of points, which does not have to be part of the dataset.
+   *
+   * @param batch Batch of points.
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Number of points assigned to each cluster so far; this is
+   *     updated with the points of the batch.
+   * @return The distance the centroids moved.
+   */
+  template<typename BatchType>
+  double Step(const BatchType& batch,
+              const arma::mat& centroids,
+              arma::mat& newCentroids,
+              arma::Col<size_t>& counts);
+
+  //! Get the number of points sampled in each iteration.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points sampled in each iteration.
+  size_t& BatchSize() { return batchSize; }
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The number of points sampled in each iteration.
+  size_t batchSize;
+  //! The number of iterations run.
+  size_t iteration;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "mini_batch_kmeans_impl.hpp"
+
+#endif
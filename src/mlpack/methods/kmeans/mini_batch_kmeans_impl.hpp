@@ -0,0 +1,123 @@
+/**
+ * @file methods/kmeans/mini_batch_kmeans_impl.hpp
+ *
+ * Implementation of the mini-batch step of k-means clustering.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mini_batch_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+MiniBatchKMeans<MetricType, MatType>::MiniBatchKMeans(const MatType& dataset,
+                                                      MetricType& metric,
+                                                      const size_t batchSize) :
+    dataset(dataset),
+    metric(metric),
+    batchSize(batchSize),
+    iteration(0),
+    distanceCalculations(0)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("MiniBatchKMeans::MiniBatchKMeans(): the "
+        "batch size must be positive!");
+  }
+}
+
+// Run a single iteration on a random batch.
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  // The counts given to the first iteration are not ours.
+  if (iteration++ == 0)
+    counts.zeros(centroids.n_cols);
+
+  // Sample the batch with replacement, so that no permutation of the dataset
+  // is needed.
+  const size_t size = std::min(batchSize, (size_t) dataset.n_cols);
+  std::uniform_int_distribution<size_t> point(0, dataset.n_cols - 1);
+  MatType batch(dataset.n_rows, size);
+  for (size_t i = 0; i < size; ++i)
+    batch.col(i) = dataset.col(point(math::randGen));
+
+  return Step(batch, centroids, newCentroids, counts);
+}
+
+// Update the centroids with a batch.
+template<typename MetricType, typename MatType>
+template<typename BatchType>
+double MiniBatchKMeans<MetricType, MatType>::Step(
+    const BatchType& batch,
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  if (counts.n_elem != centroids.n_cols)
+    counts.zeros(centroids.n_cols);
+
+  // Find the closest centroid to each point of the batch in parallel; all the
+  // points are assigned with the centroids from before the batch.
+  arma::Row<size_t> assignments(batch.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) batch.n_cols; ++i)
+  {
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      const double distance = metric.Evaluate(batch.col(i),
+          centroids.unsafe_col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    Log::Assert(closestCluster != centroids.n_cols);
+    assignments[i] = closestCluster;
+  }
+  distanceCalculations += centroids.n_cols * batch.n_cols;
+
+  // Now move each centroid towards its points, one at a time, with a learning
+  // rate of one over the number of points the centroid has been given.
+  newCentroids = centroids;
+  for (size_t i = 0; i < batch.n_cols; ++i)
+  {
+    const size_t cluster = assignments[i];
+    const double eta = 1.0 / ++counts[cluster];
+    newCentroids.col(cluster) += eta * (arma::vec(batch.col(i)) -
+        newCentroids.col(cluster));
+  }
+
+  // Calculate how far the centroids moved.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
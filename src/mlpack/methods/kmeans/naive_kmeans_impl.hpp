@@ -48,7 +48,9 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
         arma::fill::zeros);
     arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
 
-    #pragma omp for
+    // The static schedule gives each thread the columns that
+    // data::FirstTouch() placed on its NUMA node.
+    #pragma omp for schedule(static)
     for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
     {
       // Find the closest centroid to this point.
@@ -197,10 +197,9 @@ double LARS::Train(const arma::mat& matX,
   // Set up ignores set variables. Initialized empty.
   isIgnored.resize(dataRef.n_cols, false);
 
-  // Initialize yHat and beta.
+  // Initialize beta.  The prediction yHat is not needed: the correlations are
+  // updated from the Gram matrix instead.
   beta = arma::zeros(dataRef.n_cols);
-  arma::vec yHat = arma::zeros(dataRef.n_rows);
-  arma::vec yHatDirection(dataRef.n_rows);
 
   bool lassocond = false;
 
@@ -227,15 +226,13 @@ double LARS::Train(const arma::mat& matX,
     return maxCorr;
   }
 
-  // Compute the Gram matrix.  If this is the elastic net problem, we will add
-  // lambda2 * I_n to the matrix.
-  if (matGram->n_elem != dataRef.n_cols * dataRef.n_cols)
+  // Compute the Gram matrix, unless one was given.  The lambda2 * I_n term of
+  // the elastic net problem is added where the matrix is used.
+  if (matGram == &matGramInternal ||
+      matGram->n_elem != dataRef.n_cols * dataRef.n_cols)
   {
-    // In this case, matGram should reference matGramInternal.
+    matGram = &matGramInternal;
     matGramInternal = trans(dataRef) * dataRef;
-
-    if (elasticNet && !useCholesky)
-      matGramInternal += lambda2 * arma::eye(dataRef.n_cols, dataRef.n_cols);
   }
 
   // Main loop.
@@ -328,6 +325,8 @@ double LARS::Train(const arma::mat& matX,
       for (size_t i = 0; i < activeSet.size(); ++i)
         for (size_t j = 0; j < activeSet.size(); ++j)
           matGramActive(i, j) = (*matGram)(activeSet[i], activeSet[j]);
+      if (elasticNet)
+        matGramActive.diag() += lambda2;
 
       // Check for singularity.
       arma::mat matS = s * arma::ones<arma::mat>(1, activeSet.size());
@@ -353,8 +352,10 @@ double LARS::Train(const arma::mat& matX,
       }
     }
 
-    // compute "equiangular" direction in output space
-    ComputeYHatDirection(dataRef, betaDirection, yHatDirection);
+    // Correlate every dimension with the "equiangular" direction in output
+    // space.
+    arma::vec dirCorr;
+    ComputeDirectionCorrelations(betaDirection, dirCorr);
 
     double gamma = maxCorr / normalization;
 
@@ -367,9 +368,10 @@ double LARS::Train(const arma::mat& matX,
         if (isActive[ind] || isIgnored[ind])
           continue;
 
-        const double dirCorr = dot(dataRef.col(ind), yHatDirection);
-        const double val1 = (maxCorr - corr(ind)) / (normalization - dirCorr);
-        const double val2 = (maxCorr + corr(ind)) / (normalization + dirCorr);
+        const double val1 = (maxCorr - corr(ind)) /
+            (normalization - dirCorr(ind));
+        const double val2 = (maxCorr + corr(ind)) /
+            (normalization + dirCorr(ind));
         if ((val1 > 0.0) && (val1 < gamma))
            gamma = val1;
         if ((val2 > 0.0) && (val2 < gamma))
@@ -405,13 +407,14 @@ double LARS::Train(const arma::mat& matX,
       }
     }
 
-    // Update the prediction.
-    yHat += gamma * yHatDirection;
-
-    // Update the estimator.
+    // Update the estimator, and the correlations X^T (y - yHat) - lambda2 beta
+    // with it.
+    corr -= gamma * dirCorr;
     for (size_t i = 0; i < activeSet.size(); ++i)
     {
       beta(activeSet[i]) += gamma * betaDirection(i);
+      if (elasticNet)
+        corr(activeSet[i]) -= lambda2 * gamma * betaDirection(i);
     }
 
     // Sanity check to make sure the kicked out dimension is actually zero.
@@ -432,10 +435,6 @@ double LARS::Train(const arma::mat& matX,
       Deactivate(changeInd);
     }
 
-    corr = vecXTy - trans(dataRef) * yHat;
-    if (elasticNet)
-      corr -= lambda2 * beta;
-
     double curLambda = 0;
     for (size_t i = 0; i < activeSet.size(); ++i)
       curLambda += fabs(corr(activeSet[i]));
@@ -469,6 +468,50 @@ double LARS::Train(const arma::mat& data,
   return Train(data, responses, beta, transposeData);
 }
 
+void LARS::TrainPath(const arma::mat& data,
+                     const arma::rowvec& responses,
+                     const arma::vec& lambda1Values,
+                     arma::mat& betas,
+                     const bool transposeData)
+{
+  if (lambda1Values.is_empty() || lambda1Values.min() <= 0.0)
+  {
+    throw std::invalid_argument("LARS::TrainPath(): the values of lambda1 must "
+        "be positive!");
+  }
+
+  // Run the path down to the smallest value.
+  lambda1 = lambda1Values.min();
+  arma::vec beta;
+  Train(data, responses, beta, transposeData);
+
+  // The path is linear between its knots, at which lambda1 decreases.
+  betas.set_size(beta.n_elem, lambda1Values.n_elem);
+  for (size_t j = 0; j < lambda1Values.n_elem; ++j)
+  {
+    const double lambda = lambda1Values[j];
+    size_t k = 0;
+    while (k < lambdaPath.size() && lambdaPath[k] > lambda)
+      ++k;
+
+    if (k == 0)
+    {
+      betas.col(j) = betaPath.front();
+    }
+    else if (k == lambdaPath.size())
+    {
+      // The path stopped before reaching this value.
+      betas.col(j) = betaPath.back();
+    }
+    else
+    {
+      const double interp = (lambdaPath[k - 1] - lambda) /
+          (lambdaPath[k - 1] - lambdaPath[k]);
+      betas.col(j) = (1 - interp) * betaPath[k - 1] + interp * betaPath[k];
+    }
+  }
+}
+
 void LARS::Predict(const arma::mat& points,
                    arma::rowvec& predictions,
                    const bool rowMajor) const
@@ -499,13 +542,24 @@ void LARS::Ignore(const size_t varInd)
   ignoreSet.push_back(varInd);
 }
 
-void LARS::ComputeYHatDirection(const arma::mat& matX,
-                                const arma::vec& betaDirection,
-                                arma::vec& yHatDirection)
+void LARS::ComputeDirectionCorrelations(const arma::vec& betaDirection,
+                                        arma::vec& dirCorr) const
 {
-  yHatDirection.fill(0);
-  for (size_t i = 0; i < activeSet.size(); ++i)
-    yHatDirection += betaDirection(i) * matX.col(activeSet[i]);
+  // The Gram matrix is symmetric, so the entries of row i on the active set
+  // are read from column i, which is contiguous.
+  const size_t dims = matGram->n_cols;
+  dirCorr.set_size(dims);
+
+  #pragma omp parallel for schedule(static) \
+      if (dims * activeSet.size() >= 65536)
+  for (omp_size_t i = 0; i < (omp_size_t) dims; ++i)
+  {
+    const double* gramCol = matGram->colptr(i);
+    double sum = 0.0;
+    for (size_t k = 0; k < activeSet.size(); ++k)
+      sum += gramCol[activeSet[k]] * betaDirection[k];
+    dirCorr[i] = sum;
+  }
 }
 
 void LARS::InterpolateBeta()
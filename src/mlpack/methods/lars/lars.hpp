@@ -110,7 +110,8 @@ class LARS
    *
    * @param useCholesky Whether or not to use Cholesky decomposition when
    *    solving linear system (as opposed to using the full Gram matrix).
-   * @param gramMatrix Gram matrix.
+   * @param gramMatrix Gram matrix (X^T X, without the lambda2 term).  It is
+   *     not copied, so it can be shared by many LARS objects.
    * @param lambda1 Regularization parameter for l1-norm penalty.
    * @param lambda2 Regularization parameter for l2-norm penalty.
    * @param tolerance Run until the maximum correlation of elements in (X^T y)
@@ -155,7 +156,7 @@ class LARS
    *     false otherwise.
    * @param useCholesky Whether or not to use Cholesky decomposition when
    *     solving linear system (as opposed to using the full Gram matrix).
-   * @param gramMatrix Gram matrix.
+   * @param gramMatrix Gram matrix (X^T X, without the lambda2 term).
    * @param lambda1 Regularization parameter for l1-norm penalty.
    * @param lambda2 Regularization parameter for l2-norm penalty.
    * @param tolerance Run until the maximum correlation of elements in (X^T y)
@@ -236,6 +237,27 @@ class LARS
                const arma::rowvec& responses,
                const bool transposeData = true);
 
+  /**
+   * Compute the LASSO (or Elastic Net) solutions for several values of lambda1
+   * at once.  Since the LARS path is piecewise linear in lambda1, it is run
+   * once, down to the smallest of the given values, and the solution for each
+   * value is interpolated from it; so the Gram matrix and the path are
+   * computed only once for the whole sweep.  Afterwards the model holds the
+   * solution for the smallest value, and Lambda1() is set to it.
+   *
+   * @param data Input data.
+   * @param responses A vector of targets.
+   * @param lambda1Values The (positive) values of lambda1 to solve for.
+   * @param betas Matrix to store the solutions in, one column per value.
+   * @param transposeData Should be true if the input data is column-major and
+   *     false otherwise.
+   */
+  void TrainPath(const arma::mat& data,
+                 const arma::rowvec& responses,
+                 const arma::vec& lambda1Values,
+                 arma::mat& betas,
+                 const bool transposeData = true);
+
   /**
    * Predict y_i for each data point in the given data matrix using the
    * currently-trained LARS model.
@@ -375,10 +397,18 @@ class LARS
    */
   void Ignore(const size_t varInd);
 
-  // compute "equiangular" direction in output space
-  void ComputeYHatDirection(const arma::mat& matX,
-                            const arma::vec& betaDirection,
-                            arma::vec& yHatDirection);
+  /**
+   * Compute the correlation of every dimension with the "equiangular"
+   * direction in output space, X^T X_A betaDirection, from the columns of the
+   * Gram matrix of the active set.  This costs O(d |A|) instead of the O(n d)
+   * of forming the direction and correlating the data with it; the dimensions
+   * are processed in parallel.
+   *
+   * @param betaDirection Direction of the coefficients of the active set.
+   * @param dirCorr Vector to store the correlations in.
+   */
+  void ComputeDirectionCorrelations(const arma::vec& betaDirection,
+                                    arma::vec& dirCorr) const;
 
   // interpolate to compute last solution vector
   void InterpolateBeta();
@@ -48,44 +48,141 @@ double LinearRegression::Train(const arma::mat& predictors,
 {
   this->intercept = intercept;
 
+  // Forget the statistics of any earlier data.
+  gram.reset();
+  responseProducts.reset();
+
+  Accumulate(predictors, responses, weights);
+  Solve();
+  return ComputeError(predictors, responses);
+}
+
+double LinearRegression::Update(const arma::mat& predictors,
+                                const arma::rowvec& responses)
+{
+  return Update(predictors, responses, arma::rowvec());
+}
+
+double LinearRegression::Update(const arma::mat& predictors,
+                                const arma::rowvec& responses,
+                                const arma::rowvec& weights)
+{
+  const size_t dimensionality = predictors.n_rows + (intercept ? 1 : 0);
+  if (!gram.is_empty() && gram.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "LinearRegression::Update(): the new data has " << predictors.n_rows
+        << " dimensions, but the model was trained on data with "
+        << (gram.n_rows - (intercept ? 1 : 0)) << " dimensions!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  Accumulate(predictors, responses, weights);
+  Solve();
+  return ComputeError(predictors, responses);
+}
+
+void LinearRegression::Accumulate(const arma::mat& predictors,
+                                  const arma::rowvec& responses,
+                                  const arma::rowvec& weights)
+{
   /*
    * We want to calculate the a_i coefficients of:
    * \sum_{i=0}^n (a_i * x_i^i)
-   * In order to get the intercept value, we will add a row of ones.
+   * In order to get the intercept value, we would add a row of ones to the
+   * predictors; instead, its products with the data, which are sums, are
+   * accumulated directly, so the data is never copied.
    */
+  const size_t n = predictors.n_cols;
+  const size_t offset = intercept ? 1 : 0;
+  const size_t last = predictors.n_rows + offset - 1;
+  if (responses.n_elem != n || (weights.n_elem > 0 && weights.n_elem != n))
+  {
+    std::ostringstream oss;
+    oss << "LinearRegression: the predictors have " << n << " points, but "
+        << "there are " << responses.n_elem << " responses and "
+        << weights.n_elem << " weights!";
+    throw std::invalid_argument(oss.str());
+  }
 
-  // We store the number of rows and columns of the predictors.
-  // Reminder: Armadillo stores the data transposed from how we think of it,
-  //           that is, columns are actually rows (see: column major order).
-  const size_t nCols = predictors.n_cols;
+  if (gram.is_empty())
+  {
+    gram.zeros(last + 1, last + 1);
+    responseProducts.zeros(last + 1);
+  }
 
-  arma::mat p = predictors;
-  arma::rowvec r = responses;
+  if (n == 0)
+    return;
 
-  // Here we add the row of ones to the predictors.
-  // The intercept is not penalized. Add an "all ones" row to design and set
-  // intercept = false to get a penalized intercept.
-  if (intercept)
+  // Only split the points if there are enough of them to be worth it.
+  const size_t numBlocks = ParallelPolicy::Current().NumBlocks(n, 4096);
+  const size_t blockSize = (n + numBlocks - 1) / numBlocks;
+
+  std::vector<arma::mat> blockGrams(numBlocks);
+  std::vector<arma::vec> blockProducts(numBlocks);
+  #pragma omp parallel for schedule(static, 1) if (numBlocks > 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    p.insert_rows(0, arma::ones<arma::mat>(1, nCols));
+    const size_t begin = (size_t) b * blockSize;
+    const size_t end = std::min(begin + blockSize, n) - 1;
+    const arma::mat block(const_cast<double*>(predictors.colptr(begin)),
+        predictors.n_rows, end - begin + 1, false, true);
+
+    // The weighted products are those of X W, where W = diag(weights).
+    arma::mat weightedBlock;
+    if (weights.n_elem > 0)
+      weightedBlock = block.each_row() % weights.cols(begin, end);
+    const arma::mat& weighted = (weights.n_elem > 0) ? weightedBlock : block;
+
+    arma::mat& blockGram = blockGrams[b];
+    arma::vec& blockProduct = blockProducts[b];
+    blockGram.set_size(last + 1, last + 1);
+    blockProduct.set_size(last + 1);
+    blockGram.submat(offset, offset, last, last) = weighted * block.t();
+    blockProduct.subvec(offset, last) = weighted * responses.cols(begin,
+        end).t();
+
+    if (intercept)
+    {
+      blockGram(0, 0) = (weights.n_elem > 0) ?
+          arma::accu(weights.cols(begin, end)) : (double) (end - begin + 1);
+      blockGram.submat(1, 0, last, 0) = arma::sum(weighted, 1);
+      blockGram.submat(0, 1, 0, last) = blockGram.submat(1, 0, last, 0).t();
+      blockProduct[0] = (weights.n_elem > 0) ?
+          arma::dot(weights.cols(begin, end), responses.cols(begin, end)) :
+          arma::accu(responses.cols(begin, end));
+    }
   }
 
-  if (weights.n_elem > 0)
+  // Sum the blocks in order.
+  for (size_t b = 0; b < numBlocks; ++b)
   {
-    p = p * diagmat(sqrt(weights));
-    r = sqrt(weights) % responses;
+    gram += blockGrams[b];
+    responseProducts += blockProducts[b];
   }
+}
 
+void LinearRegression::Solve()
+{
   // Convert to this form:
-  // a * (X X^T) = y X^T.
-  // Then we'll use Armadillo to solve it.
-  // The total runtime of this should be O(d^2 N) + O(d^3) + O(dN).
-  // (assuming the SVD is used to solve it)
-  arma::mat cov = p * p.t() +
-      lambda * arma::eye<arma::mat>(p.n_rows, p.n_rows);
-
-  parameters = arma::solve(cov, p * r.t());
-  return ComputeError(predictors, responses);
+  // a * (X X^T + lambda I) = y X^T.
+  // The intercept is penalized like the other parameters.  The total runtime
+  // of this is O(d^3), on top of the O(d^2 N) of accumulating X X^T.
+  arma::mat cov = gram;
+  cov.diag() += lambda;
+
+  arma::mat upper;
+  if (arma::chol(upper, cov))
+  {
+    parameters = arma::solve(arma::trimatu(upper),
+        arma::solve(arma::trimatl(upper.t()), responseProducts));
+  }
+  else
+  {
+    // The system is singular (for instance, collinear data without
+    // regularization), so let Armadillo find an approximate solution.
+    parameters = arma::solve(cov, responseProducts);
+  }
 }
 
 void LinearRegression::Predict(const arma::mat& points,
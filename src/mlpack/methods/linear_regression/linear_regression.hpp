@@ -22,6 +22,12 @@ namespace regression /** Regression methods. */ {
  * A simple linear regression algorithm using ordinary least squares.
  * Optionally, this class can perform ridge regression, if the lambda parameter
  * is set to a number greater than zero.
+ *
+ * The model is fit from the sufficient statistics X X^T and X y of the
+ * training data, which are accumulated in parallel without copying the data
+ * and then solved by a Cholesky decomposition.  The statistics are kept, so
+ * the model can be updated with new data by calling Update(); a dataset that
+ * does not fit in memory can be streamed through Update() chunk by chunk.
  */
 class LinearRegression
 {
@@ -63,10 +69,9 @@ class LinearRegression
 
   /**
    * Train the LinearRegression model on the given data. Careful! This will
-   * completely ignore and overwrite the existing model. This particular
-   * implementation does not have an incremental training algorithm.  To set the
-   * regularization parameter lambda, call Lambda() or set a different value in
-   * the constructor.
+   * completely ignore and overwrite the existing model; to add data to it, use
+   * Update() instead.  To set the regularization parameter lambda, call
+   * Lambda() or set a different value in the constructor.
    *
    * @param predictors X, the matrix of data points to train the model on.
    * @param responses y, the responses to the data points.
@@ -79,10 +84,9 @@ class LinearRegression
 
   /**
    * Train the LinearRegression model on the given data and weights. Careful!
-   * This will completely ignore and overwrite the existing model. This
-   * particular implementation does not have an incremental training algorithm.
-   * To set the regularization parameter lambda, call Lambda() or set a
-   * different value in the constructor.
+   * This will completely ignore and overwrite the existing model; to add data
+   * to it, use Update() instead.  To set the regularization parameter lambda,
+   * call Lambda() or set a different value in the constructor.
    *
    * @param predictors X, the matrix of data points to train the model on.
    * @param responses y, the responses to the data points.
@@ -95,6 +99,38 @@ class LinearRegression
                const arma::rowvec& weights,
                const bool intercept = true);
 
+  /**
+   * Update the model with the given new data, as if it had been trained on
+   * both the data it was trained on and the new data.  The old data is not
+   * needed: only its accumulated statistics are, so the cost is linear in the
+   * size of the new data.  The intercept setting of the model is kept, and the
+   * current value of lambda is used.  A model that has not been trained yet is
+   * trained on the new data.
+   *
+   * @param predictors X, the matrix of new data points.
+   * @param responses y, the responses to the new data points.
+   * @return The least squares error of the updated model on the new data.
+   */
+  double Update(const arma::mat& predictors,
+                const arma::rowvec& responses);
+
+  /**
+   * Update the model with the given new data and weights, as if it had been
+   * trained on both the data it was trained on and the new data.  The old data
+   * is not needed: only its accumulated statistics are, so the cost is linear
+   * in the size of the new data.  The intercept setting of the model is kept,
+   * and the current value of lambda is used.  A model that has not been
+   * trained yet is trained on the new data.
+   *
+   * @param predictors X, the matrix of new data points.
+   * @param responses y, the responses to the new data points.
+   * @param weights Observation weights of the new data points.
+   * @return The least squares error of the updated model on the new data.
+   */
+  double Update(const arma::mat& predictors,
+                const arma::rowvec& responses,
+                const arma::rowvec& weights);
+
   /**
    * Calculate y_i for each data point in points.
    *
@@ -145,9 +181,27 @@ class LinearRegression
     ar(CEREAL_NVP(parameters));
     ar(CEREAL_NVP(lambda));
     ar(CEREAL_NVP(intercept));
+    ar(CEREAL_NVP(gram));
+    ar(CEREAL_NVP(responseProducts));
   }
 
  private:
+  /**
+   * Add the statistics of the given data to gram and responseProducts.  The
+   * data is split into blocks that are accumulated in parallel, each into its
+   * own buffers, and the buffers are then summed in order.
+   *
+   * @param predictors X, the matrix of data points.
+   * @param responses y, the responses to the data points.
+   * @param weights Observation weights, or an empty vector for unit weights.
+   */
+  void Accumulate(const arma::mat& predictors,
+                  const arma::rowvec& responses,
+                  const arma::rowvec& weights);
+
+  //! Solve the regularized normal equations for the parameters.
+  void Solve();
+
   /**
    * The calculated B.
    * Initialized and filled by constructor to hold the least squares solution.
@@ -162,6 +216,14 @@ class LinearRegression
 
   //! Indicates whether first parameter is intercept.
   bool intercept;
+
+  //! The accumulated (weighted) X X^T of the training data, with a leading row
+  //! and column for the intercept if it is used.
+  arma::mat gram;
+
+  //! The accumulated (weighted) X y of the training data, with a leading
+  //! element for the intercept if it is used.
+  arma::vec responseProducts;
 };
 
 } // namespace regression
@@ -46,7 +46,9 @@ class LinearSVMFunction
                     const bool fitIntercept = false);
 
   /**
-   * Shuffle the dataset.
+   * Shuffle the order in which the batches visit the datapoints.  Only an
+   * ordering of the points is shuffled; the dataset is neither copied nor
+   * reordered.
    */
   void Shuffle();
 
@@ -179,15 +181,39 @@ class LinearSVMFunction
   size_t NumFunctions() const;
 
  private:
+  /**
+   * Compute the sum of the hinge losses of the given points and, if gradient
+   * is not NULL, its gradient, both without the regularization or the
+   * averaging.  Large batches are split into blocks that are processed in
+   * parallel, each into its own buffers, and the buffers are then summed in
+   * order; so the result does not depend on the scheduling, and sparse or
+   * narrow datasets (for which BLAS does not help) still use all the threads.
+   *
+   * @param parameters The parameters of the SVM.
+   * @param begin Index of the first point.
+   * @param batchSize Number of points.
+   * @param order If not empty, the points are taken through this ordering.
+   * @param gradient If not NULL, will hold the gradient.
+   */
+  double HingeLoss(const arma::mat& parameters,
+                   const size_t begin,
+                   const size_t batchSize,
+                   const arma::uvec& order,
+                   arma::mat* gradient) const;
+
   //! The initial point, from which to start the optimization.
   arma::mat initialPoint;
 
   //! Label matrix for provided data
   arma::sp_mat groundTruth;
 
-  //! The datapoints for training.
+  //! The datapoints for training.  This is an alias of the given matrix.
   MatType dataset;
 
+  //! The order in which the batches visit the points; empty until shuffling
+  //! is done.
+  arma::uvec ordering;
+
   //! Number of Classes.
   size_t numClasses;
 
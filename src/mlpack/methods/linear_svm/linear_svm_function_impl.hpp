@@ -15,7 +15,7 @@
 #define MLPACK_METHODS_LINEAR_SVM_LINEAR_SVM_FUNCTION_IMPL_HPP
 
 #include <mlpack/core/math/make_alias.hpp>
-#include <mlpack/core/math/shuffle_data.hpp>
+#include <mlpack/core/math/multiply_columns.hpp>
 
 // In case it hasn't been included yet.
 #include "linear_svm_function.hpp"
@@ -110,36 +110,10 @@ void LinearSVMFunction<MatType>::GetGroundTruthMatrix(
 template <typename MatType>
 void LinearSVMFunction<MatType>::Shuffle()
 {
-  // Determine new ordering.
-  arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
+  // Only the order of visitation is shuffled, so the dataset stays an alias
+  // and the label matrix is unchanged.
+  ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
       dataset.n_cols - 1, dataset.n_cols));
-
-  // Re-sort data.
-  arma::mat newData = dataset.cols(ordering);
-  math::ClearAlias(dataset);
-  dataset = std::move(newData);
-
-  // Assemble data for batch constructor.  We need reverse orderings though...
-  arma::uvec reverseOrdering(ordering.n_elem);
-  for (size_t i = 0; i < ordering.n_elem; ++i)
-    reverseOrdering[ordering[i]] = i;
-
-  arma::umat newLocations(2, groundTruth.n_nonzero);
-  arma::vec values(groundTruth.n_nonzero);
-  arma::sp_mat::const_iterator it = groundTruth.begin();
-  size_t loc = 0;
-  while (it != groundTruth.end())
-  {
-    newLocations(0, loc) = reverseOrdering(it.col());
-    newLocations(1, loc) = it.row();
-    values(loc) = (*it);
-
-    ++it;
-    ++loc;
-  }
-
-  groundTruth = arma::sp_mat(newLocations, values, groundTruth.n_rows,
-                             groundTruth.n_cols);
 }
 
 template <typename MatType>
@@ -152,42 +126,14 @@ double LinearSVMFunction<MatType>::Evaluate(
   // Calculate the loss and regularization terms.
   // L_i = Σ_i Σ_m max(0, Δ + (w_m x_i + b_m) - (w_{y_i} x_i + b_{y_i}))
   // where (m != y_i)
-  double loss, regularization;
-
-  // Scores for each class are evaluated.
-  arma::mat scores;
-
-  // Check intercept condition.
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset;
-  }
-  else
-  {
-    // When using `fitIntercept` we need to add the `b_i` term explicitly.
-    // The first `parameters.n_rows - 1` rows of parameters holds the value
-    // of Weights `w_i`, and the last row holds `b_i`.
-    // On calculating the score, we add `b_i` term to each element of
-    // `i_th` row of `scores`.
-    scores = parameters.rows(0, dataset.n_rows - 1).t() * dataset
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1,
-        dataset.n_cols);
-  }
-
-  // Evaluate the margin by the following steps:
-  //  - Subtracting the score of correct class from all the class scores.
-  //  - Adding the margin parameter `delta`.
-  //  - Removing the `delta` parameter from correct class label in each
-  //    column.
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
-      * (scores % groundTruth), numClasses, 1)) + delta
-      - (delta * groundTruth);
-
-  // The Hinge Loss Function
-  loss = arma::accu(arma::clamp(margin, 0.0, DBL_MAX)) / dataset.n_cols;
+  // The sum over all the points does not depend on their order, so the data
+  // is read in its own order.
+  const double loss = HingeLoss(parameters, 0, dataset.n_cols, arma::uvec(),
+      NULL) / dataset.n_cols;
 
   // Adding the regularization term.
-  regularization = 0.5 * lambda * arma::dot(parameters, parameters);
+  const double regularization = 0.5 * lambda *
+      arma::dot(parameters, parameters);
 
   return loss + regularization;
 }
@@ -198,40 +144,14 @@ double LinearSVMFunction<MatType>::Evaluate(
     const size_t firstId,
     const size_t batchSize)
 {
-  const size_t lastId = firstId + batchSize - 1;
-
-  // Calculate the loss and regularization terms.
-  double loss, regularization, cost;
-
-  // Scores for each class are evaluated.
-  arma::mat scores;
-
-  // Check intercept condition.
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset.cols(firstId, lastId);
-  }
-  else
-  {
-    scores = parameters.rows(0, dataset.n_rows - 1).t()
-        * dataset.cols(firstId, lastId)
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1,
-        dataset.n_cols);
-  }
-
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
-      * (scores % groundTruth.cols(firstId, lastId)), numClasses, 1))
-      + delta - (delta * groundTruth.cols(firstId, lastId));
-
-  // The Hinge Loss Function
-  loss = arma::accu(arma::clamp(margin, 0.0, DBL_MAX));
-  loss /= batchSize;
+  const double loss = HingeLoss(parameters, firstId, batchSize, ordering,
+      NULL) / batchSize;
 
   // Adding the regularization term.
-  regularization = 0.5 * lambda * arma::dot(parameters, parameters);
+  const double regularization = 0.5 * lambda *
+      arma::dot(parameters, parameters);
 
-  cost = loss + regularization;
-  return cost;
+  return loss + regularization;
 }
 
 template <typename MatType>
@@ -240,62 +160,15 @@ void LinearSVMFunction<MatType>::Gradient(
     const arma::mat& parameters,
     GradType& gradient)
 {
-  // The objective is to minimize the loss, which is evaluated as the sum
-  // of all the positive elements of `margin` matrix.
-  // So, we focus of these positive elements and reduce them.
-  // Also, we need to increase the score of the correct class.
-
-  // Scores for each class are evaluated.
-  arma::mat scores;
-
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset;
-  }
-  else
-  {
-    scores = parameters.rows(0, dataset.n_rows - 1).t() * dataset
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1,
-        dataset.n_cols);
-  }
-
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
-      * (scores % groundTruth), numClasses, 1)) + delta
-      - (delta * groundTruth);
-
-  // An element of `mask` matrix holds `1` corresponding to
-  // each positive element of `margin` matrix.
-  arma::mat mask = margin.for_each([](arma::mat::elem_type& val)
-      { val = (val > 0) ? 1: 0; });
-
-  arma::mat difference = groundTruth
-      % (-arma::repmat(arma::sum(mask), numClasses, 1)) + mask;
-
-  // The gradient is evaluated as follows:
-  //  - Add `x_i` to `w_j` if `margin_i_m`is positive.
-  //  - Subtract `x_i` from `w_y_i` for each positive
-  //    `margin_i_j`.
-  //  - Take the average over the size of dataset.
-  //  - Add the regularization parameter.
+  arma::mat fullGradient;
+  HingeLoss(parameters, 0, dataset.n_cols, arma::uvec(), &fullGradient);
 
-  // Check intercept condition
-  if (!fitIntercept)
-  {
-    gradient = dataset * difference.t();
-  }
-  else
-  {
-    gradient.set_size(arma::size(parameters));
-    gradient.submat(0, 0, parameters.n_rows - 2, parameters.n_cols - 1) =
-        dataset * difference.t();
-    gradient.row(parameters.n_rows - 1) =
-        arma::ones<arma::rowvec>(dataset.n_cols) * difference.t();
-  }
-
-  gradient /= dataset.n_cols;
+  // Take the average over the size of dataset, and add the regularization
+  // contribution to the gradient.
+  fullGradient /= dataset.n_cols;
+  fullGradient += lambda * parameters;
 
-  // Adding the regularization contribution to the gradient.
-  gradient += lambda * parameters;
+  gradient = std::move(fullGradient);
 }
 
 template <typename MatType>
@@ -306,53 +179,13 @@ void LinearSVMFunction<MatType>::Gradient(
     GradType& gradient,
     const size_t batchSize)
 {
-  const size_t lastId = firstId + batchSize - 1;
-
-  // Scores for each class are evaluated.
-  arma::mat scores;
-
-  // Check intercept condition.
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset.cols(firstId, lastId);
-  }
-  else
-  {
-    scores = parameters.rows(0, dataset.n_rows - 1).t()
-        * dataset.cols(firstId, lastId)
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1, batchSize);
-  }
-
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
-      * (scores % groundTruth.cols(firstId, lastId)), numClasses, 1))
-      + delta - (delta * groundTruth.cols(firstId, lastId));
+  arma::mat batchGradient;
+  HingeLoss(parameters, firstId, batchSize, ordering, &batchGradient);
 
-  // For each sample, find the total number of classes where
-  // ( margin > 0 ).
-  arma::mat mask = margin.for_each([](arma::mat::elem_type& val)
-      { val = (val > 0) ? 1: 0; });
+  batchGradient /= batchSize;
+  batchGradient += lambda * parameters;
 
-  arma::mat difference = groundTruth.cols(firstId, lastId)
-      % (-arma::repmat(arma::sum(mask), numClasses, 1)) + mask;
-
-  // Check intercept condition
-  if (!fitIntercept)
-  {
-    gradient = dataset.cols(firstId, lastId) * difference.t();
-  }
-  else
-  {
-    gradient.set_size(arma::size(parameters));
-    gradient.submat(0, 0, parameters.n_rows - 2, parameters.n_cols - 1) =
-        dataset.cols(firstId, lastId) * difference.t();
-    gradient.row(parameters.n_rows - 1) =
-        arma::ones<arma::rowvec>(batchSize) * difference.t();
-  }
-
-  gradient /= batchSize;
-
-  // Adding the regularization contribution to the gradient.
-  gradient += lambda * parameters;
+  gradient = std::move(batchGradient);
 }
 
 template <typename MatType>
@@ -361,62 +194,19 @@ double LinearSVMFunction<MatType>::EvaluateWithGradient(
     const arma::mat& parameters,
     GradType& gradient) const
 {
-  double loss, regularization, cost;
+  arma::mat fullGradient;
+  const double loss = HingeLoss(parameters, 0, dataset.n_cols, arma::uvec(),
+      &fullGradient) / dataset.n_cols;
 
-  // Scores for each class are evaluated.
-  arma::mat scores;
-
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset;
-  }
-  else
-  {
-    scores = parameters.rows(0, dataset.n_rows - 1).t() * dataset
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1,
-        dataset.n_cols);
-  }
-
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
-      * (scores % groundTruth), numClasses, 1)) + delta
-      - (delta * groundTruth);
-
-  // For each sample, find the total number of classes where
-  // ( margin > 0 ).
-  arma::mat mask = margin.for_each([](arma::mat::elem_type& val)
-      { val = (val > 0) ? 1: 0; });
-
-  arma::mat difference = groundTruth
-      % (-arma::repmat(arma::sum(mask), numClasses, 1)) + mask;
-
-  // Check intercept condition
-  if (!fitIntercept)
-  {
-    gradient = dataset * difference.t();
-  }
-  else
-  {
-    gradient.set_size(arma::size(parameters));
-    gradient.submat(0, 0, parameters.n_rows - 2, parameters.n_cols - 1) =
-            dataset * difference.t();
-    gradient.row(parameters.n_rows - 1) =
-            arma::ones<arma::rowvec>(dataset.n_cols) * difference.t();
-  }
-
-  gradient /= dataset.n_cols;
-
-  // Adding the regularization contribution to the gradient.
-  gradient += lambda * parameters;
-
-  // The Hinge Loss Function
-  loss = arma::accu(arma::clamp(margin, 0.0, DBL_MAX));
-  loss /= dataset.n_cols;
+  fullGradient /= dataset.n_cols;
+  fullGradient += lambda * parameters;
+  gradient = std::move(fullGradient);
 
   // Adding the regularization term.
-  regularization = 0.5 * lambda * arma::dot(parameters, parameters);
+  const double regularization = 0.5 * lambda *
+      arma::dot(parameters, parameters);
 
-  cost = loss + regularization;
-  return cost;
+  return loss + regularization;
 }
 
 template <typename MatType>
@@ -427,67 +217,111 @@ double LinearSVMFunction<MatType>::EvaluateWithGradient(
     GradType& gradient,
     const size_t batchSize) const
 {
-  const size_t lastId = firstId + batchSize - 1;
+  arma::mat batchGradient;
+  const double loss = HingeLoss(parameters, firstId, batchSize, ordering,
+      &batchGradient) / batchSize;
 
-  // Calculate the loss and regularization terms.
-  double loss, regularization, cost;
+  batchGradient /= batchSize;
+  batchGradient += lambda * parameters;
+  gradient = std::move(batchGradient);
 
-  // Scores for each class are evaluated.
-  arma::mat scores;
+  // Adding the regularization term.
+  const double regularization = 0.5 * lambda *
+      arma::dot(parameters, parameters);
 
-  // Check intercept condition.
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset.cols(firstId, lastId);
-  }
-  else
-  {
-    scores = parameters.rows(0, dataset.n_rows - 1).t()
-        * dataset.cols(firstId, lastId)
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1, dataset.n_cols);
-  }
+  return loss + regularization;
+}
 
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
-      * (scores % groundTruth.cols(firstId, lastId)), numClasses, 1))
-      + delta - (delta * groundTruth.cols(firstId, lastId));
+template <typename MatType>
+double LinearSVMFunction<MatType>::HingeLoss(
+    const arma::mat& parameters,
+    const size_t begin,
+    const size_t batchSize,
+    const arma::uvec& order,
+    arma::mat* gradient) const
+{
+  // The first `dataset.n_rows` rows of parameters hold the weights `w_m`, and
+  // when using `fitIntercept` the last row holds the intercepts `b_m`.
+  const arma::mat weights = parameters.rows(0, dataset.n_rows - 1).t();
 
-  // For each sample, find the total number of classes where
-  // ( margin > 0 ).
-  arma::mat mask = margin.for_each([](arma::mat::elem_type& val)
-      { val = (val > 0) ? 1: 0; });
+  // The ground truth matrix has one entry per column, at the label.
+  groundTruth.sync();
 
-  arma::mat difference = groundTruth.cols(firstId, lastId)
-      % (-arma::repmat(arma::sum(mask), numClasses, 1)) + mask;
+  // Only split the points if there are enough of them to be worth it.
+  const size_t numBlocks = ParallelPolicy::Current().NumBlocks(batchSize, 4096);
+  const size_t blockSize = (batchSize + numBlocks - 1) / numBlocks;
 
-  // Check intercept condition
-  if (!fitIntercept)
+  arma::vec blockLosses(numBlocks);
+  std::vector<arma::mat> blockGradients(gradient ? numBlocks : 0);
+  #pragma omp parallel for schedule(static, 1) if (numBlocks > 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    gradient = dataset.cols(firstId, lastId) * difference.t();
+    const size_t blockBegin = begin + (size_t) b * blockSize;
+    const size_t blockCount = std::min(blockSize,
+        begin + batchSize - blockBegin);
+
+    // Scores for each class are evaluated.
+    arma::mat scores;
+    math::MultiplyColumns(weights, dataset, blockBegin, blockCount, scores,
+        order);
+    if (fitIntercept)
+      scores.each_col() += parameters.row(dataset.n_rows).t();
+
+    // The margin of each other class m is Δ + s_m - s_{y_i}; the positive
+    // margins are the loss.  The gradient adds `x_i` to `w_m` for each
+    // positive margin, and subtracts it from `w_{y_i}` as many times.
+    double loss = 0.0;
+    arma::mat difference;
+    if (gradient)
+      difference.zeros(numClasses, blockCount);
+    for (size_t c = 0; c < blockCount; ++c)
+    {
+      const size_t point = order.is_empty() ? blockBegin + c :
+          order[blockBegin + c];
+      const size_t label = groundTruth.row_indices[groundTruth.col_ptrs[point]];
+      const double correctScore = scores(label, c);
+
+      size_t positiveMargins = 0;
+      for (size_t m = 0; m < numClasses; ++m)
+      {
+        const double margin = scores(m, c) - correctScore + delta;
+        if (m == label || margin <= 0)
+          continue;
+
+        loss += margin;
+        ++positiveMargins;
+        if (gradient)
+          difference(m, c) = 1;
+      }
+
+      if (gradient)
+        difference(label, c) = -((double) positiveMargins);
+    }
+    blockLosses[b] = loss;
+
+    if (gradient)
+    {
+      arma::mat weightGradient;
+      math::MultiplyColumnsTrans(difference, dataset, blockBegin, blockCount,
+          weightGradient, order);
+
+      arma::mat& blockGradient = blockGradients[b];
+      blockGradient.set_size(arma::size(parameters));
+      blockGradient.rows(0, dataset.n_rows - 1) = weightGradient.t();
+      if (fitIntercept)
+        blockGradient.row(dataset.n_rows) = arma::sum(difference, 1).t();
+    }
   }
-  else
+
+  // Sum the blocks in order.
+  if (gradient)
   {
-    gradient.set_size(arma::size(parameters));
-    gradient.submat(0, 0, parameters.n_rows - 2, parameters.n_cols - 1) =
-        dataset.cols(firstId, lastId) * difference.t();
-    gradient.row(parameters.n_rows - 1) =
-        arma::ones<arma::rowvec>(batchSize) * difference.t();
+    *gradient = std::move(blockGradients[0]);
+    for (size_t b = 1; b < numBlocks; ++b)
+      *gradient += blockGradients[b];
   }
 
-  gradient /= batchSize;
-
-
-  // Adding the regularization contribution to the gradient.
-  gradient += lambda * parameters;
-
-  // The Hinge Loss Function
-  loss = arma::accu(arma::clamp(margin.cols(firstId, lastId), 0.0, DBL_MAX));
-  loss /= batchSize;
-
-  // Adding the regularization term.
-  regularization = 0.5 * lambda * arma::dot(parameters, parameters);
-
-  cost = loss + regularization;
-  return cost;
+  return arma::accu(blockLosses);
 }
 
 template <typename MatType>
@@ -26,6 +26,16 @@ namespace lmnn {
  * of each data point), Impostors() (used for calculating impostors of each
  * data point) and Triplets() (Generates sets of {dataset, target neighbors,
  * impostors} tripltets.)
+ *
+ * When MetricType is the (squared) Euclidean distance, the impostors found by
+ * a search over the whole dataset are kept as candidates, with some slack:
+ * more than k of them are kept for each point.  A later call for some of the
+ * points, on a dataset whose points have moved (for instance, under an updated
+ * linear transformation), first checks the cached candidates: if the k
+ * nearest of them are closer than any other point could have become, given how
+ * far the points have moved, they are the impostors and no search is needed.
+ * Only the remaining points are searched for, and when too many remain, the
+ * cache is refreshed with a new search over the whole dataset.
  */
 template<typename MetricType = metric::SquaredEuclideanDistance>
 class Constraints
@@ -207,6 +217,78 @@ class Constraints
   //! False if nothing has ever been precalculated.
   bool precalculated;
 
+  //! The dataset the cached impostor candidates were found on.
+  arma::mat candidateDataset;
+
+  //! The cached impostor candidates of each point, nearest first.
+  arma::Mat<size_t> candidates;
+
+  //! The Euclidean distance to each of the cached impostor candidates.
+  arma::mat candidateDistances;
+
+  /**
+   * Calculate the k impostors (and their distances) of the given points,
+   * using the cached candidates where possible, and store them in the
+   * corresponding columns of the output matrices.
+   *
+   * @param outputNeighbors Coordinates matrix to store impostors.
+   * @param outputDistance Matrix to store distances.
+   * @param dataset Input dataset.
+   * @param labels Input dataset labels.
+   * @param norms Input dataset norms.
+   * @param queries Indices of the points to calculate impostors for.
+   */
+  void ComputeImpostors(arma::Mat<size_t>& outputNeighbors,
+                        arma::mat& outputDistance,
+                        const arma::mat& dataset,
+                        const arma::Row<size_t>& labels,
+                        const arma::vec& norms,
+                        const arma::uvec& queries);
+
+  /**
+   * Search for the impostors of the given points, and store the given number
+   * of them in the output matrices (not using the cache).
+   */
+  void SearchImpostors(arma::Mat<size_t>& outputNeighbors,
+                       arma::mat& outputDistance,
+                       const arma::mat& dataset,
+                       const arma::Row<size_t>& labels,
+                       const arma::vec& norms,
+                       const arma::uvec& queries,
+                       const size_t numImpostors);
+
+  /**
+   * Find the impostors of the given points from the cached candidates, where
+   * the candidates are guaranteed to contain them, and return the points that
+   * still have to be searched for.
+   */
+  arma::uvec ImpostorsFromCandidates(arma::Mat<size_t>& outputNeighbors,
+                                     arma::mat& outputDistance,
+                                     const arma::mat& dataset,
+                                     const arma::Row<size_t>& labels,
+                                     const arma::vec& norms,
+                                     const arma::uvec& queries);
+
+  //! Refresh the cached candidates with a search over the whole dataset.
+  void RefreshCandidates(const arma::mat& dataset,
+                         const arma::Row<size_t>& labels,
+                         const arma::vec& norms);
+
+  //! Return whether impostor candidates can be cached for MetricType: the
+  //! bounds used to check them only hold for the (squared) Euclidean distance.
+  static bool CanCacheCandidates()
+  {
+    return std::is_same<MetricType, metric::SquaredEuclideanDistance>::value ||
+        std::is_same<MetricType, metric::EuclideanDistance>::value;
+  }
+
+  //! Convert a distance given by MetricType to the Euclidean distance.
+  static double EuclideanDistance(const double distance)
+  {
+    return std::is_same<MetricType, metric::SquaredEuclideanDistance>::value ?
+        std::sqrt(distance) : distance;
+  }
+
   /**
   * Precalculate the unique labels, and indices of similar
   * and different datapoints on the basis of labels.
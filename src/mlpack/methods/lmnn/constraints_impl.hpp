@@ -168,33 +168,9 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
                                         const arma::Row<size_t>& labels,
                                         const arma::vec& norms)
 {
-  // Perform pre-calculation. If neccesary.
-  Precalculate(labels);
-
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; ++i)
-  {
-    // Perform KNN search with differently labeled points as reference
-    // set and  same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(indexSame[i]), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; ++j)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
-
-    // Store impostors.
-    outputMatrix.cols(indexSame[i]) = neighbors;
-  }
+  arma::mat distances(k, dataset.n_cols);
+  ComputeImpostors(outputMatrix, distances, dataset, labels, norms,
+      arma::linspace<arma::uvec>(0, dataset.n_cols - 1, dataset.n_cols));
 }
 
 // Calculates k differently labeled nearest neighbors. The function
@@ -206,34 +182,8 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
                                         const arma::Row<size_t>& labels,
                                         const arma::vec& norms)
 {
-  // Perform pre-calculation. If neccesary.
-  Precalculate(labels);
-
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; ++i)
-  {
-    // Perform KNN search with differently labeled points as reference
-    // set and  same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(indexSame[i]), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; ++j)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
-
-    // Store impostors.
-    outputNeighbors.cols(indexSame[i]) = neighbors;
-    outputDistance.cols(indexSame[i]) = distances;
-  }
+  ComputeImpostors(outputNeighbors, outputDistance, dataset, labels, norms,
+      arma::linspace<arma::uvec>(0, dataset.n_cols - 1, dataset.n_cols));
 }
 
 // Calculates k differently labeled nearest neighbors on a
@@ -246,42 +196,9 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
                                         const size_t begin,
                                         const size_t batchSize)
 {
-  // Perform pre-calculation. If neccesary.
-  Precalculate(labels);
-
-  arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
-  arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
-
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; ++i)
-  {
-    // Calculate impostors.
-    subIndexSame = arma::find(sublabels == uniqueLabels[i]);
-
-    // Perform KNN search with differently labeled points as reference
-    // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(subDataset.cols(subIndexSame), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; ++j)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
-
-    // Store impostors.
-    outputMatrix.cols(begin + subIndexSame) = neighbors;
-  }
+  arma::mat distances(k, dataset.n_cols);
+  ComputeImpostors(outputMatrix, distances, dataset, labels, norms,
+      arma::linspace<arma::uvec>(begin, begin + batchSize - 1, batchSize));
 }
 
 // Calculates k differently labeled nearest neighbors & distances on a
@@ -294,31 +211,113 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
                                         const arma::vec& norms,
                                         const size_t begin,
                                         const size_t batchSize)
+{
+  ComputeImpostors(outputNeighbors, outputDistance, dataset, labels, norms,
+      arma::linspace<arma::uvec>(begin, begin + batchSize - 1, batchSize));
+}
+
+// Calculates k differently labeled nearest neighbors & distances over some
+// data points.
+template<typename MetricType>
+void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
+                                        arma::mat& outputDistance,
+                                        const arma::mat& dataset,
+                                        const arma::Row<size_t>& labels,
+                                        const arma::vec& norms,
+                                        const arma::uvec& points,
+                                        const size_t numPoints)
+{
+  ComputeImpostors(outputNeighbors, outputDistance, dataset, labels, norms,
+      points.head(numPoints));
+}
+
+// Calculates k differently labeled nearest neighbors & distances of the given
+// points, using the cached candidates where possible.
+template<typename MetricType>
+void Constraints<MetricType>::ComputeImpostors(
+    arma::Mat<size_t>& outputNeighbors,
+    arma::mat& outputDistance,
+    const arma::mat& dataset,
+    const arma::Row<size_t>& labels,
+    const arma::vec& norms,
+    const arma::uvec& queries)
 {
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
-  arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
+  if (queries.n_elem == 0)
+    return;
+
+  if (!CanCacheCandidates())
+  {
+    SearchImpostors(outputNeighbors, outputDistance, dataset, labels, norms,
+        queries, k);
+    return;
+  }
 
+  // A call for the whole dataset (or on a different dataset) refreshes the
+  // cache first.
+  bool refreshed = false;
+  if (candidateDataset.n_rows != dataset.n_rows ||
+      candidateDataset.n_cols != dataset.n_cols ||
+      candidates.n_rows < k ||
+      queries.n_elem == dataset.n_cols)
+  {
+    RefreshCandidates(dataset, labels, norms);
+    refreshed = true;
+  }
+
+  arma::uvec unresolved = ImpostorsFromCandidates(outputNeighbors,
+      outputDistance, dataset, labels, norms, queries);
+
+  // If the points have moved so far that many of them can't be answered from
+  // the cache anymore, a search over the whole dataset costs little more than
+  // a search for those points, and gives a fresh cache.
+  if (!refreshed && unresolved.n_elem > dataset.n_cols / 4)
+  {
+    RefreshCandidates(dataset, labels, norms);
+    unresolved = ImpostorsFromCandidates(outputNeighbors, outputDistance,
+        dataset, labels, norms, unresolved);
+  }
+
+  if (unresolved.n_elem > 0)
+  {
+    SearchImpostors(outputNeighbors, outputDistance, dataset, labels, norms,
+        unresolved, k);
+  }
+}
+
+// Searches for the impostors of the given points.
+template<typename MetricType>
+void Constraints<MetricType>::SearchImpostors(
+    arma::Mat<size_t>& outputNeighbors,
+    arma::mat& outputDistance,
+    const arma::mat& dataset,
+    const arma::Row<size_t>& labels,
+    const arma::vec& norms,
+    const arma::uvec& queries,
+    const size_t numImpostors)
+{
   // KNN instance.
   KNN knn;
 
   arma::Mat<size_t> neighbors;
   arma::mat distances;
 
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
-
+  const arma::Row<size_t> queryLabels = labels.cols(queries);
   for (size_t i = 0; i < uniqueLabels.n_cols; ++i)
   {
     // Calculate impostors.
-    subIndexSame = arma::find(sublabels == uniqueLabels[i]);
+    const arma::uvec classQueries = queries.elem(
+        arma::find(queryLabels == uniqueLabels[i]));
+    if (classQueries.n_elem == 0)
+      continue;
 
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
     knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(subDataset.cols(subIndexSame), k, neighbors, distances);
+    knn.Search(dataset.cols(classQueries), numImpostors, neighbors,
+        distances);
 
     // Re-order neighbors on the basis of increasing norm in case
     // of ties among distances.
@@ -329,58 +328,105 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
       neighbors(j) = indexDiff[i].at(neighbors(j));
 
     // Store impostors.
-    outputNeighbors.cols(begin + subIndexSame) = neighbors;
-    outputDistance.cols(begin + subIndexSame) = distances;
+    outputNeighbors.cols(classQueries) = neighbors;
+    outputDistance.cols(classQueries) = distances;
   }
 }
 
-// Calculates k differently labeled nearest neighbors & distances over some
-// data points.
+// Finds the impostors of the given points from the cached candidates.
 template<typename MetricType>
-void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
-                                        arma::mat& outputDistance,
-                                        const arma::mat& dataset,
-                                        const arma::Row<size_t>& labels,
-                                        const arma::vec& norms,
-                                        const arma::uvec& points,
-                                        const size_t numPoints)
+arma::uvec Constraints<MetricType>::ImpostorsFromCandidates(
+    arma::Mat<size_t>& outputNeighbors,
+    arma::mat& outputDistance,
+    const arma::mat& dataset,
+    const arma::Row<size_t>& labels,
+    const arma::vec& norms,
+    const arma::uvec& queries)
 {
-  // Perform pre-calculation. If neccesary.
-  Precalculate(labels);
-
-  // KNN instance.
-  KNN knn;
+  const size_t numCandidates = candidates.n_rows;
 
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
+  // How far each point has moved since the candidates were found.
+  const arma::rowvec displacement = arma::sqrt(arma::sum(arma::square(
+      dataset - candidateDataset), 0));
+  const double maxDisplacement = displacement.max();
 
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
+  arma::uvec resolved(queries.n_elem, arma::fill::zeros);
+  MetricType metric;
 
-  for (size_t i = 0; i < uniqueLabels.n_cols; ++i)
+  #pragma omp parallel
   {
-    // Calculate impostors.
-    subIndexSame = arma::find(labels.cols(points.head(numPoints)) ==
-        uniqueLabels[i]);
+    std::vector<std::pair<double, size_t>> sorted(numCandidates);
+    arma::Mat<size_t> neighbors(k, 1);
+    arma::mat distances(k, 1);
 
-    // Perform KNN search with differently labeled points as reference
-    // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(points.elem(subIndexSame)),
-        k, neighbors, distances);
+    #pragma omp for schedule(static)
+    for (omp_size_t q = 0; q < (omp_size_t) queries.n_elem; ++q)
+    {
+      const size_t i = queries[q];
+      for (size_t c = 0; c < numCandidates; ++c)
+      {
+        const size_t j = candidates(c, i);
+        sorted[c] = std::make_pair(metric.Evaluate(dataset.col(i),
+            dataset.col(j)), j);
+      }
+      std::partial_sort(sorted.begin(), sorted.begin() + k, sorted.end());
+
+      // Any point that is not a candidate was at least as far as the furthest
+      // candidate, and since then the distance can only have shrunk by as much
+      // as the two points have moved.  (If every differently labeled point is
+      // a candidate, there is no other point.)
+      const size_t labelIndex = std::lower_bound(uniqueLabels.begin(),
+          uniqueLabels.end(), labels[i]) - uniqueLabels.begin();
+      if (numCandidates < indexDiff[labelIndex].n_elem)
+      {
+        const double bound = candidateDistances(numCandidates - 1, i) -
+            displacement[i] - maxDisplacement;
+        if (!(EuclideanDistance(sorted[k - 1].first) < bound))
+          continue;
+      }
 
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
+      for (size_t j = 0; j < k; ++j)
+      {
+        neighbors[j] = sorted[j].second;
+        distances[j] = sorted[j].first;
+      }
 
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; ++j)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
+      // Re-order neighbors on the basis of increasing norm in case
+      // of ties among distances.
+      ReorderResults(distances, neighbors, norms);
 
-    // Store impostors.
-    outputNeighbors.cols(points.elem(subIndexSame)) = neighbors;
-    outputDistance.cols(points.elem(subIndexSame)) = distances;
+      outputNeighbors.col(i) = neighbors;
+      outputDistance.col(i) = distances;
+      resolved[q] = 1;
+    }
   }
+
+  return queries.elem(arma::find(resolved == 0));
+}
+
+// Refreshes the cached impostor candidates.
+template<typename MetricType>
+void Constraints<MetricType>::RefreshCandidates(
+    const arma::mat& dataset,
+    const arma::Row<size_t>& labels,
+    const arma::vec& norms)
+{
+  // Keep a few times more candidates than impostors, so that the cache stays
+  // useful while the points move; but there can't be more candidates than
+  // differently labeled points.
+  size_t numCandidates = 3 * k;
+  for (size_t i = 0; i < indexDiff.size(); ++i)
+    numCandidates = std::min(numCandidates, (size_t) indexDiff[i].n_elem);
+
+  candidates.set_size(numCandidates, dataset.n_cols);
+  candidateDistances.set_size(numCandidates, dataset.n_cols);
+  SearchImpostors(candidates, candidateDistances, dataset, labels, norms,
+      arma::linspace<arma::uvec>(0, dataset.n_cols - 1, dataset.n_cols),
+      numCandidates);
+
+  for (size_t i = 0; i < candidateDistances.n_elem; ++i)
+    candidateDistances[i] = EuclideanDistance(candidateDistances[i]);
+  candidateDataset = dataset;
 }
 
 // Generates {data point, target neighbors, impostors} triplets using
@@ -429,6 +475,11 @@ inline void Constraints<MetricType>::Precalculate(
 
   uniqueLabels = arma::unique(labels);
 
+  // The cached impostor candidates may be for other labels.
+  candidateDataset.reset();
+  candidates.reset();
+  candidateDistances.reset();
+
   indexSame.resize(uniqueLabels.n_elem);
   indexDiff.resize(uniqueLabels.n_elem);
 
@@ -11,6 +11,7 @@
  */
 #include "lcc.hpp"
 #include <mlpack/core/math/lin_alg.hpp>
+#include <mlpack/core/math/pairwise_distances.hpp>
 
 namespace mlpack {
 namespace lcc {
@@ -30,36 +31,56 @@ LocalCoordinateCoding::LocalCoordinateCoding(
 
 void LocalCoordinateCoding::Encode(const arma::mat& data, arma::mat& codes)
 {
-  arma::mat invSqDists = 1.0 / (repmat(trans(sum(square(dictionary))), 1,
-      data.n_cols) + repmat(sum(square(data)), atoms, 1) - 2 * trans(dictionary)
-      * data);
+  arma::mat invSqDists;
+  math::PairwiseSquaredDistances(dictionary, data, invSqDists);
+  invSqDists = 1.0 / invSqDists;
 
+  // The Gram matrix of the dictionary is shared by the solvers of all the
+  // points.
   arma::mat dictGram = trans(dictionary) * dictionary;
-  arma::mat dictGramTD(dictGram.n_rows, dictGram.n_cols);
 
   codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-  {
-    // Report progress.
-    if ((i % 100) == 0)
-    {
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
-    }
-
-    arma::vec invW = invSqDists.unsafe_col(i);
-    arma::mat dictPrime = dictionary * diagmat(invW);
 
-    arma::mat dictGramTD = diagmat(invW) * dictGram * diagmat(invW);
+  // The points are coded independently, so they are split across threads.
+  // Each thread keeps its own weighted dictionary and Gram matrix, which keep
+  // their memory from point to point, and one LARS object that refers to its
+  // Gram matrix.
+  #pragma omp parallel
+  {
+    arma::mat dictPrime(arma::size(dictionary));
+    arma::mat dictGramTD(arma::size(dictGram));
+    arma::rowvec responses(data.n_rows);
 
     bool useCholesky = false;
     regression::LARS lars(useCholesky, dictGramTD, 0.5 * lambda);
 
-    // Run LARS for this point, by making an alias of the point and passing
-    // that.
-    arma::vec beta = codes.unsafe_col(i);
-    arma::rowvec responses = data.unsafe_col(i).t();
-    lars.Train(dictPrime, responses, beta, false);
-    beta %= invW; // Remember, beta is an alias of codes.col(i).
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    {
+      // Report progress.
+      if ((i % 100) == 0)
+      {
+        #pragma omp critical
+        Log::Debug << "Optimization at point " << i << "." << std::endl;
+      }
+
+      arma::vec invW = invSqDists.unsafe_col((size_t) i);
+
+      // dictPrime = dictionary * diagmat(invW), and
+      // dictGramTD = diagmat(invW) * dictGram * diagmat(invW), in place.
+      dictPrime = dictionary;
+      dictPrime.each_row() %= invW.t();
+      dictGramTD = dictGram;
+      dictGramTD.each_col() %= invW;
+      dictGramTD.each_row() %= invW.t();
+
+      // Run LARS for this point, by making an alias of the point and passing
+      // that.
+      arma::vec beta = codes.unsafe_col((size_t) i);
+      responses = data.col((size_t) i).t();
+      lars.Train(dictPrime, responses, beta, false);
+      beta %= invW; // Remember, beta is an alias of codes.col(i).
+    }
   }
 }
 
@@ -242,6 +242,12 @@ class LogisticRegression
   void serialize(Archive& ar, const uint32_t /* version */);
 
  private:
+  /**
+   * Compute the score (without the intercept) of each of the given points;
+   * sparse points are read directly from their compressed columns.
+   */
+  void Scores(const MatType& dataset, arma::mat& scores) const;
+
   //! Vector of trained parameters (size: dimensionality plus one).
   arma::rowvec parameters;
   //! L2-regularization penalty parameter.
@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/core/math/multiply_columns.hpp>
 #include <mlpack/core/math/shuffle_data.hpp>
 
 namespace mlpack {
@@ -53,6 +54,8 @@ class LogisticRegressionFunction
 
   /**
   * Shuffle the order of function visitation.  This may be called by the optimizer.
+  * Only an ordering of the points is shuffled; the predictors and responses are
+  * neither copied nor reordered.
   */
   void Shuffle();
 
@@ -159,14 +162,54 @@ class LogisticRegressionFunction
   size_t NumFeatures() const { return predictors.n_rows + 1; }
 
  private:
-  //! The matrix of data points (predictors).  This is an alias until shuffling
-  //! is done.
+  /**
+   * Compute the negative log-likelihood of the given points and, if gradient
+   * is not NULL, its gradient, both without the regularization.  Large
+   * batches are split into blocks that are processed in parallel, each into
+   * its own buffers, and the buffers are then summed in order; so the result
+   * does not depend on the scheduling, and sparse or narrow predictors (for
+   * which BLAS does not help) still use all the threads.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the first point.
+   * @param batchSize Number of points.
+   * @param order If not empty, the points are taken through this ordering.
+   * @param gradient If not NULL, will hold the gradient.
+   */
+  double NegativeLogLikelihood(const arma::mat& parameters,
+                               const size_t begin,
+                               const size_t batchSize,
+                               const arma::uvec& order,
+                               arma::mat* gradient) const;
+
+  /**
+   * Compute the sigmoid of the score of each of the given points.  Sparse
+   * predictors are read directly from their compressed columns, without
+   * densifying them.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the first point.
+   * @param batchSize Number of points.
+   * @param order If not empty, the points are taken through this ordering.
+   * @param sigmoids Will hold the sigmoid of each point.
+   */
+  void Sigmoids(const arma::mat& parameters,
+                const size_t begin,
+                const size_t batchSize,
+                const arma::uvec& order,
+                arma::rowvec& sigmoids) const;
+
+  //! The matrix of data points (predictors).  This is an alias of the given
+  //! matrix.
   MatType predictors;
-  //! The vector of responses to the input data points.  This is an alias until
-  //! shuffling is done.
+  //! The vector of responses to the input data points.  This is an alias of
+  //! the given vector.
   arma::Row<size_t> responses;
   //! The regularization parameter for L2-regularization.
   double lambda;
+  //! The order in which the batches visit the points; empty until shuffling
+  //! is done.
+  arma::uvec ordering;
 };
 
 } // namespace regression
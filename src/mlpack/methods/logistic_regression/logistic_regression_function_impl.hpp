@@ -47,18 +47,9 @@ LogisticRegressionFunction<MatType>::LogisticRegressionFunction(
 template<typename MatType>
 void LogisticRegressionFunction<MatType>::Shuffle()
 {
-  MatType newPredictors;
-  arma::Row<size_t> newResponses;
-
-  math::ShuffleData(predictors, responses, newPredictors, newResponses);
-
-  // If we are an alias, make sure we don't write to the original data.
-  math::ClearAlias(predictors);
-  math::ClearAlias(responses);
-
-  // Take ownership of the new data.
-  predictors = std::move(newPredictors);
-  responses = std::move(newResponses);
+  // Only the order of visitation is shuffled, so the data stays an alias.
+  ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
+      predictors.n_cols - 1, predictors.n_cols));
 }
 
 /**
@@ -82,23 +73,13 @@ double LogisticRegressionFunction<MatType>::Evaluate(
       arma::dot(parameters.tail_cols(parameters.n_elem - 1),
       parameters.tail_cols(parameters.n_elem - 1));
 
-  // Calculate vectors of sigmoids.  The intercept term is parameters(0, 0) and
-  // does not need to be multiplied by any of the predictors.
-  const arma::rowvec sigmoid = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) * predictors)));
-
   // Assemble full objective function.  Often the objective function and the
   // regularization as given are divided by the number of features, but this
   // doesn't actually affect the optimization result, so we'll just ignore those
-  // terms for computational efficiency.  Note that the conversion causes some
-  // copy and slowdown, but this is so negligible compared to the rest of the
-  // calculation it is not worth optimizing for.
-  const double result = arma::accu(arma::log(1.0 -
-      arma::conv_to<arma::rowvec>::from(responses) + sigmoid %
-      (2 * arma::conv_to<arma::rowvec>::from(responses) - 1.0)));
-
-  // Invert the result, because it's a minimization.
-  return regularization - result;
+  // terms for computational efficiency.  The sum over all the points does not
+  // depend on their order, so the data is read in its own order.
+  return regularization + NegativeLogLikelihood(parameters, 0,
+      predictors.n_cols, arma::uvec(), NULL);
 }
 
 /**
@@ -117,19 +98,8 @@ double LogisticRegressionFunction<MatType>::Evaluate(
       arma::dot(parameters.tail_cols(parameters.n_elem - 1),
                 parameters.tail_cols(parameters.n_elem - 1));
 
-  // Calculate the sigmoid function values.
-  const arma::rowvec sigmoid = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) *
-      predictors.cols(begin, begin + batchSize - 1))));
-
-  // Compute the objective for the given batch size from a given point.
-  arma::rowvec respD = arma::conv_to<arma::rowvec>::from(responses.subvec(begin,
-      begin + batchSize - 1));
-  const double result = arma::accu(arma::log(1.0 - respD + sigmoid %
-      (2 * respD - 1.0)));
-
-  // Invert the result, because it's a minimization.
-  return regularization - result;
+  return regularization + NegativeLogLikelihood(parameters, begin, batchSize,
+      ordering, NULL);
 }
 
 //! Evaluate the gradient of the logistic regression objective function.
@@ -138,17 +108,12 @@ void LogisticRegressionFunction<MatType>::Gradient(
     const arma::mat& parameters,
     arma::mat& gradient) const
 {
-  // Regularization term.
-  arma::mat regularization;
-  regularization = lambda * parameters.tail_cols(parameters.n_elem - 1);
-
-  const arma::rowvec sigmoids = (1 / (1 + arma::exp(-parameters(0, 0)
-      - parameters.tail_cols(parameters.n_elem - 1) * predictors)));
+  NegativeLogLikelihood(parameters, 0, predictors.n_cols, arma::uvec(),
+      &gradient);
 
-  gradient.set_size(arma::size(parameters));
-  gradient[0] = -arma::accu(responses - sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids - responses) *
-      predictors.t() + regularization;
+  // Regularization term.
+  gradient.tail_cols(parameters.n_elem - 1) += lambda *
+      parameters.tail_cols(parameters.n_elem - 1);
 }
 
 //! Evaluate the gradient of the logistic regression objective function for a
@@ -161,23 +126,16 @@ void LogisticRegressionFunction<MatType>::Gradient(
                 GradType& gradient,
                 const size_t batchSize) const
 {
+  arma::mat batchGradient;
+  NegativeLogLikelihood(parameters, begin, batchSize, ordering,
+      &batchGradient);
+
   // Regularization term.
-  arma::mat regularization;
-  regularization = lambda * parameters.tail_cols(parameters.n_elem - 1)
-      / predictors.n_cols * batchSize;
-
-  const arma::rowvec exponents = parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) *
-      predictors.cols(begin, begin + batchSize - 1);
-  // Calculating the sigmoid function values.
-  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-exponents));
-
-  gradient.set_size(parameters.n_rows, parameters.n_cols);
-  gradient[0] = -arma::accu(responses.subvec(begin, begin + batchSize - 1) -
-      sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids -
-      responses.subvec(begin, begin + batchSize - 1)) *
-      predictors.cols(begin, begin + batchSize - 1).t() + regularization;
+  batchGradient.tail_cols(parameters.n_elem - 1) += lambda *
+      parameters.tail_cols(parameters.n_elem - 1) / predictors.n_cols *
+      batchSize;
+
+  gradient = std::move(batchGradient);
 }
 
 /**
@@ -190,8 +148,9 @@ void LogisticRegressionFunction<MatType>::PartialGradient(
     const size_t j,
     arma::sp_mat& gradient) const
 {
-  const arma::rowvec diffs = responses - (1 / (1 + arma::exp(-parameters(0, 0)
-      - parameters.tail_cols(parameters.n_elem - 1) * predictors)));
+  arma::rowvec sigmoids;
+  Sigmoids(parameters, 0, predictors.n_cols, arma::uvec(), sigmoids);
+  const arma::rowvec diffs = responses - sigmoids;
 
   gradient.set_size(arma::size(parameters));
 
@@ -212,30 +171,20 @@ double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
     const arma::mat& parameters,
     GradType& gradient) const
 {
-  // Regularization term.
-  arma::mat regularization = lambda *
-      parameters.tail_cols(parameters.n_elem - 1);
-
   const double objectiveRegularization = lambda / 2.0 *
       arma::dot(parameters.tail_cols(parameters.n_elem - 1),
                 parameters.tail_cols(parameters.n_elem - 1));
 
-  // Calculate the sigmoid function values.
-  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) * predictors)));
+  arma::mat fullGradient;
+  const double objective = NegativeLogLikelihood(parameters, 0,
+      predictors.n_cols, arma::uvec(), &fullGradient);
 
-  gradient.set_size(arma::size(parameters));
-  gradient[0] = -arma::accu(responses - sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids - responses) *
-      predictors.t() + regularization;
-
-  // Now compute the objective function using the sigmoids.
-  double result = arma::accu(arma::log(1.0 -
-      arma::conv_to<arma::rowvec>::from(responses) + sigmoids %
-      (2 * arma::conv_to<arma::rowvec>::from(responses) - 1.0)));
+  // Regularization term.
+  fullGradient.tail_cols(parameters.n_elem - 1) += lambda *
+      parameters.tail_cols(parameters.n_elem - 1);
 
-  // Invert the result, because it's a minimization.
-  return objectiveRegularization - result;
+  gradient = std::move(fullGradient);
+  return objectiveRegularization + objective;
 }
 
 template<typename MatType>
@@ -246,36 +195,100 @@ double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
     GradType& gradient,
     const size_t batchSize) const
 {
-  // Regularization term.
-  arma::mat regularization =
-      lambda * parameters.tail_cols(parameters.n_elem - 1) / predictors.n_cols *
-      batchSize;
-
   const double objectiveRegularization = lambda *
       (batchSize / (2.0 * predictors.n_cols)) *
       arma::dot(parameters.tail_cols(parameters.n_elem - 1),
                 parameters.tail_cols(parameters.n_elem - 1));
 
-  // Calculate the sigmoid function values.
-  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) *
-      predictors.cols(begin, begin + batchSize - 1))));
-
-  gradient.set_size(parameters.n_rows, parameters.n_cols);
-  gradient[0] = -arma::accu(responses.subvec(begin, begin + batchSize - 1) -
-      sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids -
-      responses.subvec(begin, begin + batchSize - 1)) *
-      predictors.cols(begin, begin + batchSize - 1).t() + regularization;
-
-  // Now compute the objective function using the sigmoids.
-  arma::rowvec respD = arma::conv_to<arma::rowvec>::from(responses.subvec(begin,
-      begin + batchSize - 1));
-  const double result = arma::accu(arma::log(1.0 - respD + sigmoids %
-      (2 * respD - 1.0)));
-
-  // Invert the result, because it's a minimization.
-  return objectiveRegularization - result;
+  arma::mat batchGradient;
+  const double objective = NegativeLogLikelihood(parameters, begin, batchSize,
+      ordering, &batchGradient);
+
+  // Regularization term.
+  batchGradient.tail_cols(parameters.n_elem - 1) += lambda *
+      parameters.tail_cols(parameters.n_elem - 1) / predictors.n_cols *
+      batchSize;
+
+  gradient = std::move(batchGradient);
+  return objectiveRegularization + objective;
+}
+
+template<typename MatType>
+double LogisticRegressionFunction<MatType>::NegativeLogLikelihood(
+    const arma::mat& parameters,
+    const size_t begin,
+    const size_t batchSize,
+    const arma::uvec& order,
+    arma::mat* gradient) const
+{
+  // Only split the points if there are enough of them to be worth it.
+  const size_t numBlocks = ParallelPolicy::Current().NumBlocks(batchSize, 4096);
+  const size_t blockSize = (batchSize + numBlocks - 1) / numBlocks;
+
+  arma::vec blockObjectives(numBlocks);
+  std::vector<arma::mat> blockGradients(gradient ? numBlocks : 0);
+  #pragma omp parallel for schedule(static, 1) if (numBlocks > 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t blockBegin = begin + (size_t) b * blockSize;
+    const size_t blockCount = std::min(blockSize,
+        begin + batchSize - blockBegin);
+
+    // The intercept term is parameters(0, 0) and does not need to be
+    // multiplied by any of the predictors.
+    arma::rowvec sigmoids;
+    Sigmoids(parameters, blockBegin, blockCount, order, sigmoids);
+
+    arma::rowvec blockResponses(blockCount);
+    for (size_t i = 0; i < blockCount; ++i)
+    {
+      blockResponses[i] = responses[order.is_empty() ? blockBegin + i :
+          order[blockBegin + i]];
+    }
+
+    blockObjectives[b] = -arma::accu(arma::log(1.0 - blockResponses +
+        sigmoids % (2 * blockResponses - 1.0)));
+
+    if (gradient)
+    {
+      const arma::rowvec errors = sigmoids - blockResponses;
+      arma::mat errorGradient;
+      math::MultiplyColumnsTrans(errors, predictors, blockBegin, blockCount,
+          errorGradient, order);
+
+      blockGradients[b].set_size(arma::size(parameters));
+      blockGradients[b][0] = arma::accu(errors);
+      blockGradients[b].tail_cols(parameters.n_elem - 1) = errorGradient;
+    }
+  }
+
+  // Sum the blocks in order.
+  if (gradient)
+  {
+    *gradient = std::move(blockGradients[0]);
+    for (size_t b = 1; b < numBlocks; ++b)
+      *gradient += blockGradients[b];
+  }
+
+  return arma::accu(blockObjectives);
+}
+
+template<typename MatType>
+void LogisticRegressionFunction<MatType>::Sigmoids(
+    const arma::mat& parameters,
+    const size_t begin,
+    const size_t batchSize,
+    const arma::uvec& order,
+    arma::rowvec& sigmoids) const
+{
+  // The weights are all the parameters but the intercept; they are contiguous,
+  // so they can be used without a copy.
+  const arma::mat weights(const_cast<double*>(parameters.memptr()) + 1, 1,
+      parameters.n_elem - 1, false, true);
+
+  arma::mat scores;
+  math::MultiplyColumns(weights, predictors, begin, batchSize, scores, order);
+  sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) + scores)));
 }
 
 } // namespace regression
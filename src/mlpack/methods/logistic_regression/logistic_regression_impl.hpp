@@ -117,10 +117,10 @@ void LogisticRegression<MatType>::Classify(const MatType& dataset,
 {
   // Calculate sigmoid function for each point.  The (1.0 - decisionBoundary)
   // term correctly sets an offset so that floor() returns 0 or 1 correctly.
+  arma::mat scores;
+  Scores(dataset, scores);
   labels = arma::conv_to<arma::Row<size_t>>::from((1.0 /
-      (1.0 + arma::exp(-parameters(0) -
-      parameters.tail_cols(parameters.n_elem - 1) * dataset))) +
-      (1.0 - decisionBoundary));
+      (1.0 + arma::exp(-parameters(0) - scores))) + (1.0 - decisionBoundary));
 }
 
 template<typename MatType>
@@ -130,8 +130,9 @@ void LogisticRegression<MatType>::Classify(const MatType& dataset,
   // Set correct size of output matrix.
   probabilities.set_size(2, dataset.n_cols);
 
-  probabilities.row(1) = 1.0 / (1.0 + arma::exp(-parameters(0) -
-      parameters.tail_cols(parameters.n_elem - 1) * dataset));
+  arma::mat scores;
+  Scores(dataset, scores);
+  probabilities.row(1) = 1.0 / (1.0 + arma::exp(-parameters(0) - scores));
   probabilities.row(0) = 1.0 - probabilities.row(1);
 }
 
@@ -141,7 +142,7 @@ double LogisticRegression<MatType>::ComputeError(
     const arma::Row<size_t>& responses) const
 {
   // Construct a new error function.
-  LogisticRegressionFunction<> newErrorFunction(predictors, responses,
+  LogisticRegressionFunction<MatType> newErrorFunction(predictors, responses,
       lambda);
 
   return newErrorFunction.Evaluate(parameters);
@@ -177,6 +178,17 @@ void LogisticRegression<MatType>::serialize(Archive& ar,
   ar(CEREAL_NVP(lambda));
 }
 
+template<typename MatType>
+void LogisticRegression<MatType>::Scores(const MatType& dataset,
+                                         arma::mat& scores) const
+{
+  // The weights are all the parameters but the intercept; they are contiguous,
+  // so they can be used without a copy.
+  const arma::mat weights(const_cast<double*>(parameters.memptr()) + 1, 1,
+      parameters.n_elem - 1, false, true);
+  math::MultiplyColumns(weights, dataset, 0, dataset.n_cols, scores);
+}
+
 } // namespace regression
 } // namespace mlpack
 
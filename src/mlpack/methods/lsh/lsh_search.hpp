@@ -62,6 +62,10 @@ namespace neighbor {
  * this hash to compute the distance-approximate nearest-neighbors of the given
  * queries.
  *
+ * The projection tables are stored with the element type of MatType, so with
+ * arma::fmat the reference set, the projections and the hashing of the points
+ * all use single precision.
+ *
  * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
  * @tparam MatType Type of matrix to use to store the data.
  */
@@ -72,6 +76,9 @@ template<
 class LSHSearch
 {
  public:
+  //! The type of the elements of the data and of the projection tables.
+  typedef typename MatType::elem_type ElemType;
+
   /**
    * This function initializes the LSH class. It builds the hash on the
    * reference set with 2-stable distributions. See the individual functions
@@ -95,7 +102,7 @@ class LSHSearch
    *     can be arbitrarily large---be careful!).
    */
   LSHSearch(MatType referenceSet,
-            const arma::cube& projections,
+            const arma::Cube<ElemType>& projections,
             const double hashWidth = 0.0,
             const size_t secondHashSize = 99901,
             const size_t bucketSize = 500);
@@ -194,7 +201,20 @@ class LSHSearch
              const double hashWidth = 0.0,
              const size_t secondHashSize = 99901,
              const size_t bucketSize = 500,
-             const arma::cube& projection = arma::cube());
+             const arma::Cube<ElemType>& projection =
+                 arma::Cube<ElemType>());
+
+  /**
+   * Add the given points to the reference set, hashing them into the existing
+   * tables.  The points already in the reference set are not hashed again, and
+   * the projections, offsets and hash width are kept, so this is much cheaper
+   * than training on the whole set again.  Inserted points get the indices
+   * after the points already in the reference set.  As in Train(), the points
+   * that fall into a full bucket are not stored in that bucket.
+   *
+   * @param newPoints Points to add to the reference set.
+   */
+  void Insert(const MatType& newPoints);
 
   /**
    * Compute the nearest neighbors of the points in the given query set and
@@ -290,15 +310,28 @@ class LSHSearch
   //! Get the bucket size of the second hash.
   size_t BucketSize() const { return bucketSize; }
 
-  //! Get the second hash table.
-  const std::vector<arma::Col<size_t>>& SecondHashTable() const
-      { return secondHashTable; }
+  /**
+   * Get the points in all the buckets of the second hash table, stored one
+   * bucket after another; the points of bucket i are in
+   * [BucketOffsets()[i], BucketOffsets()[i + 1]).
+   */
+  const arma::Col<size_t>& BucketContents() const { return bucketContents; }
+
+  //! Get the start of each bucket of the second hash table in
+  //! BucketContents(), followed by the end of the last bucket.
+  const arma::Col<size_t>& BucketOffsets() const { return bucketOffsets; }
+
+  /**
+   * Get the second hash table, as one vector for each bucket.  This copies
+   * the table; use BucketContents() and BucketOffsets() instead.
+   */
+  mlpack_deprecated std::vector<arma::Col<size_t>> SecondHashTable() const;
 
   //! Get the projection tables.
-  const arma::cube& Projections() { return projections; }
+  const arma::Cube<ElemType>& Projections() { return projections; }
 
   //! Change the projection tables (this retrains the LSH model).
-  void Projections(const arma::cube& projTables)
+  void Projections(const arma::Cube<ElemType>& projTables)
   {
     // Simply call Train() with the given projection tables.
     Train(referenceSet, numProj, numTables, hashWidth, secondHashSize,
@@ -307,25 +340,67 @@ class LSHSearch
 
  private:
   /**
-   * This function takes a query and hashes it into each of the hash tables to
-   * get keys for the query and then the key is hashed to a bucket of the second
-   * hash table and all the points (if any) in those buckets are collected as
-   * the potential neighbor candidates.
+   * Hash each of the given points into the second hash table, once for each
+   * table.
+   *
+   * @param points Points to hash.
+   * @param secondHashVectors Matrix to store the bucket of each point in each
+   *    table in; the bucket of point j in table i is in row i, column j.
+   */
+  void HashPoints(const MatType& points,
+                  arma::Mat<size_t>& secondHashVectors) const;
+
+  /**
+   * Search for the neighbors of every point in the query set.  The queries are
+   * processed in blocks: the projections of a whole block in all the tables are
+   * computed with one matrix multiplication, and then the queries of the block
+   * are searched in parallel.
    *
-   * @param queryPoint The query point currently being processed.
-   * @param referenceIndices The list of neighbor candidates obtained from
-   *    hashing the query into all the hash tables and eventually into
-   *    multiple buckets of the second hash table.
+   * @param querySet Set of query points.
+   * @param monochromatic If true, the query set is the reference set, and a
+   *    point is not returned as its own neighbor.
+   * @param k Number of neighbors to search for.
+   * @param resultingNeighbors Matrix storing lists of neighbors for each query
+   *    point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *    point.
    * @param numTablesToSearch The number of tables to perform the search in. If
    *    0, all tables are searched.
    * @param T The number of additional probing bins for multiprobe LSH. If 0,
    *    single-probe is used.
    */
-  template<typename VecType>
-  void ReturnIndicesFromTable(const VecType& queryPoint,
-                              arma::uvec& referenceIndices,
-                              size_t numTablesToSearch,
-                              const size_t T) const;
+  void SearchInternal(const MatType& querySet,
+                      const bool monochromatic,
+                      const size_t k,
+                      arma::Mat<size_t>& resultingNeighbors,
+                      arma::mat& distances,
+                      size_t numTablesToSearch,
+                      const size_t T);
+
+  /**
+   * This function takes the projections of a query in each of the hash tables
+   * to get keys for the query and then the key is hashed to a bucket of the
+   * second hash table and all the points (if any) in those buckets are
+   * collected as the potential neighbor candidates.
+   *
+   * @param queryCodes The projections of the query (plus offsets) in each of
+   *    the tables to search, one column per table.
+   * @param probingSequence The probing sequence for multiprobe LSH, from
+   *    GetProbingSequence().
+   * @param T The number of additional probing bins for multiprobe LSH. If 0,
+   *    single-probe is used.
+   * @param candidateMarks One mark for each reference point, all false; used to
+   *    skip duplicate candidates, and left all false again.
+   * @param candidates Buffer to store the candidates in (sorted); it is only
+   *    grown when needed, so it can be reused across queries.
+   * @return The number of candidates stored in `candidates`.
+   */
+  size_t ReturnIndicesFromTable(
+      const arma::Mat<ElemType>& queryCodes,
+      const std::vector<std::vector<size_t>>& probingSequence,
+      const size_t T,
+      std::vector<bool>& candidateMarks,
+      arma::uvec& candidates) const;
 
   /**
    * This is a helper function that computes the distance of the query to the
@@ -378,13 +453,32 @@ class LSHSearch
    * @param queryCodeNotFloored vector containing the projection location of the
    *    query.
    * @param T number of additional probing bins.
+   * @param probingSequence The probing sequence shared by all queries, from
+   *    GetProbingSequence().
    * @param additionalProbingBins matrix. Each column will hold one additional
    *    bin.
   */
-  void GetAdditionalProbingBins(const arma::vec& queryCode,
-                                const arma::vec& queryCodeNotFloored,
-                                const size_t T,
-                                arma::mat& additionalProbingBins) const;
+  void GetAdditionalProbingBins(
+      const arma::vec& queryCode,
+      const arma::vec& queryCodeNotFloored,
+      const size_t T,
+      const std::vector<std::vector<size_t>>& probingSequence,
+      arma::mat& additionalProbingBins) const;
+
+  /**
+   * Compute the probing sequence of multiprobe LSH, shared by all queries: the
+   * T most likely perturbation sets, each given as the positions it perturbs
+   * in a query's perturbations sorted by score.  As in the paper, the sets are
+   * ranked with the expected scores of the sorted positions, so the sequence
+   * does not depend on the query.  The sequence is only needed if T > 2;
+   * otherwise it is left empty.
+   *
+   * @param T number of additional probing bins.
+   * @param probingSequence Vector to store the probing sequence in.
+   */
+  void GetProbingSequence(
+      const size_t T,
+      std::vector<std::vector<size_t>>& probingSequence) const;
 
   /**
    * Returns the score of a perturbation vector generated by perturbation set A.
@@ -432,8 +526,9 @@ class LSHSearch
   //! The number of hash tables.
   size_t numTables;
 
-  //! The arma::cube containing the projection matrix of each table.
-  arma::cube projections; // should be [numProj x dims] x numTables slices
+  //! The cube containing the projection matrix of each table (one
+  //! [dims x numProj] slice per table).
+  arma::Cube<ElemType> projections;
 
   //! The list of the offsets 'b' for each of the projection for each table.
   arma::mat offsets; // should be numProj x numTables
@@ -450,15 +545,15 @@ class LSHSearch
   //! The bucket size of the second hash.
   size_t bucketSize;
 
-  //! The final hash table; should be (< secondHashSize) vectors each with
-  //! (<= bucketSize) elements.
-  std::vector<arma::Col<size_t>> secondHashTable;
+  //! The final hash table: the points of each of its (< secondHashSize)
+  //! buckets, each with (<= bucketSize) elements, stored one after another.
+  arma::Col<size_t> bucketContents;
 
-  //! The number of elements present in each hash bucket; should be
-  //! secondHashSize.
-  arma::Col<size_t> bucketContentSize;
+  //! The start of each bucket in bucketContents, followed by the end of the
+  //! last bucket.
+  arma::Col<size_t> bucketOffsets;
 
-  //! For a particular hash value, points to the row in secondHashTable
+  //! For a particular hash value, points to the bucket of the final hash table
   //! corresponding to this value. Length secondHashSize.
   arma::Col<size_t> bucketRowInHashTable;
 
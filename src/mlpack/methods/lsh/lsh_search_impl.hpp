@@ -43,7 +43,7 @@ LSHSearch(MatType referenceSet,
 template<typename SortPolicy, typename MatType>
 LSHSearch<SortPolicy, MatType>::
 LSHSearch(MatType referenceSet,
-          const arma::cube& projections,
+          const arma::Cube<ElemType>& projections,
           const double hashWidthIn,
           const size_t secondHashSize,
           const size_t bucketSize) :
@@ -83,8 +83,8 @@ LSHSearch<SortPolicy, MatType>::LSHSearch(const LSHSearch& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(other.secondHashWeights),
     bucketSize(other.bucketSize),
-    secondHashTable(other.secondHashTable),
-    bucketContentSize(other.bucketContentSize),
+    bucketContents(other.bucketContents),
+    bucketOffsets(other.bucketOffsets),
     bucketRowInHashTable(other.bucketRowInHashTable),
     distanceEvaluations(other.distanceEvaluations)
 {
@@ -103,8 +103,8 @@ LSHSearch<SortPolicy, MatType>::LSHSearch(LSHSearch&& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(std::move(other.secondHashWeights)),
     bucketSize(other.bucketSize),
-    secondHashTable(std::move(other.secondHashTable)),
-    bucketContentSize(std::move(other.bucketContentSize)),
+    bucketContents(std::move(other.bucketContents)),
+    bucketOffsets(std::move(other.bucketOffsets)),
     bucketRowInHashTable(std::move(other.bucketRowInHashTable)),
     distanceEvaluations(other.distanceEvaluations)
 {
@@ -131,8 +131,8 @@ LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
   secondHashSize = other.secondHashSize;
   secondHashWeights = other.secondHashWeights;
   bucketSize = other.bucketSize;
-  secondHashTable = other.secondHashTable;
-  bucketContentSize = other.bucketContentSize;
+  bucketContents = other.bucketContents;
+  bucketOffsets = other.bucketOffsets;
   bucketRowInHashTable = other.bucketRowInHashTable;
   distanceEvaluations = other.distanceEvaluations;
 
@@ -153,8 +153,8 @@ LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
   secondHashSize = other.secondHashSize;
   secondHashWeights = std::move(other.secondHashWeights);
   bucketSize = other.bucketSize;
-  secondHashTable = std::move(other.secondHashTable);
-  bucketContentSize = std::move(other.bucketContentSize);
+  bucketContents = std::move(other.bucketContents);
+  bucketOffsets = std::move(other.bucketOffsets);
   bucketRowInHashTable = std::move(other.bucketRowInHashTable);
   distanceEvaluations = other.distanceEvaluations;
 
@@ -171,13 +171,14 @@ LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
 
 // Train on a new reference set.
 template<typename SortPolicy, typename MatType>
-void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
-                                           const size_t numProj,
-                                           const size_t numTables,
-                                           const double hashWidthIn,
-                                           const size_t secondHashSize,
-                                           const size_t bucketSize,
-                                           const arma::cube& projection)
+void LSHSearch<SortPolicy, MatType>::Train(
+    MatType referenceSet,
+    const size_t numProj,
+    const size_t numTables,
+    const double hashWidthIn,
+    const size_t secondHashSize,
+    const size_t bucketSize,
+    const arma::Cube<ElemType>& projection)
 {
   // Set new reference set.
   this->referenceSet = std::move(referenceSet);
@@ -253,10 +254,80 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
         "tables provided must be equal to numProj");
   }
 
+  // Steps IV and V: hash every point into the second hash table, once for
+  // each table.
+  arma::Mat<size_t> secondHashVectors;
+  HashPoints(this->referenceSet, secondHashVectors);
+
+  // Now, using the hash vectors for each table, count the number of rows we
+  // have in the second hash table.
+  arma::Row<size_t> secondHashBinCounts(secondHashSize, arma::fill::zeros);
+  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
+    secondHashBinCounts[secondHashVectors[i]]++;
+
+  // Enforce the maximum bucket size.
+  const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
+  secondHashBinCounts.transform([effectiveBucketSize](size_t val)
+      { return std::min(val, effectiveBucketSize); });
+
+  // The buckets are stored one after another in 'bucketContents', so that the
+  // whole table takes a single allocation and the points of a bucket are
+  // contiguous.  Each bucket gets a row in the order in which it is first
+  // seen; first we find the rows and where each of them starts.
+  const size_t numRowsInTable = arma::accu(secondHashBinCounts > 0);
+  bucketOffsets.set_size(numRowsInTable + 1);
+  bucketOffsets[0] = 0;
+  bucketContents.set_size(arma::accu(secondHashBinCounts));
+
+  size_t currentRow = 0;
+  for (size_t i = 0; i < numTables; ++i)
+  {
+    for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
+    {
+      // This is the bucket number.
+      const size_t hashInd = (size_t) secondHashVectors(i, j);
+
+      // If this is currently an empty bucket, start a new row keep track of
+      // which row corresponds to the bucket.
+      if (bucketRowInHashTable[hashInd] == secondHashSize)
+      {
+        bucketRowInHashTable[hashInd] = currentRow;
+        bucketOffsets[currentRow + 1] = bucketOffsets[currentRow] +
+            secondHashBinCounts[hashInd];
+        currentRow++;
+      }
+    }
+  }
+
+  // Next we must assign each point in each table to its bucket, as long as
+  // the bucket is not full.
+  arma::Col<size_t> bucketEnd(bucketOffsets.memptr(), numRowsInTable);
+  for (size_t i = 0; i < numTables; ++i)
+  {
+    for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
+    {
+      // The point ID is 'j'.
+      const size_t row = bucketRowInHashTable[secondHashVectors(i, j)];
+      if (bucketEnd[row] < bucketOffsets[row + 1])
+        bucketContents[bucketEnd[row]++] = j;
+    } // Loop over all points in the reference set.
+  } // Loop over tables.
+
+  Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
+            << "maximum length of " << arma::max(secondHashBinCounts) << ", "
+            << "totaling " << arma::accu(secondHashBinCounts) << " elements."
+            << std::endl;
+}
+
+// Hash points into the second hash table.
+template<typename SortPolicy, typename MatType>
+void LSHSearch<SortPolicy, MatType>::HashPoints(
+    const MatType& points,
+    arma::Mat<size_t>& secondHashVectors) const
+{
   // We will store the second hash vectors in this matrix; the second hash
-  // vector for table i will be held in row i.  We have to use int and not
-  // size_t, otherwise negative numbers are cast to 0.
-  arma::Mat<size_t> secondHashVectors(numTables, this->referenceSet.n_cols);
+  // vector for table i will be held in row i.
+  secondHashVectors.set_size(numTables, points.n_cols);
 
   for (size_t i = 0; i < numTables; ++i)
   {
@@ -265,22 +336,22 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
 
     // The following code performs the task of hashing each point to a
     // 'numProj'-dimensional integer key.  Hence you get a ('numProj' x
-    // 'referenceSet.n_cols') key matrix.
+    // 'points.n_cols') key matrix.
     //
     // For a single table, let the 'numProj' projections be denoted by 'proj_i'
     // and the corresponding offset be 'offset_i'.  Then the key of a single
     // point is obtained as:
     // key = { floor((<proj_i, point> + offset_i) / 'hashWidth') forall i }
-    arma::mat offsetMat = arma::repmat(offsets.unsafe_col(i), 1,
-                                       this->referenceSet.n_cols);
-    arma::mat hashMat = projections.slice(i).t() * (this->referenceSet);
-    hashMat += offsetMat;
-    hashMat /= hashWidth;
+    arma::Mat<ElemType> hashMat = projections.slice(i).t() * points;
+    hashMat.each_col() += arma::conv_to<arma::Col<ElemType>>::from(
+        offsets.unsafe_col(i));
+    hashMat /= (ElemType) hashWidth;
 
-    // Step V: Putting the points in the 'secondHashTable' by hashing the key.
+    // Step V: Putting the points in the second hash table by hashing the key.
     // Now we hash every key, point ID to its corresponding bucket.  We must
     // also normalize the hashes to the range [0, secondHashSize).
-    arma::rowvec unmodVector = secondHashWeights.t() * arma::floor(hashMat);
+    arma::rowvec unmodVector = secondHashWeights.t() *
+        arma::conv_to<arma::mat>::from(arma::floor(hashMat));
     for (size_t j = 0; j < unmodVector.n_elem; ++j)
     {
       double shs = (double) secondHashSize; // Convenience cast.
@@ -297,56 +368,90 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
       }
     }
   }
+}
 
-  // Now, using the hash vectors for each table, count the number of rows we
-  // have in the second hash table.
-  arma::Row<size_t> secondHashBinCounts(secondHashSize, arma::fill::zeros);
-  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
-    secondHashBinCounts[secondHashVectors[i]]++;
+// Add points to the reference set and the hash tables.
+template<typename SortPolicy, typename MatType>
+void LSHSearch<SortPolicy, MatType>::Insert(const MatType& newPoints)
+{
+  if (numTables == 0 || bucketOffsets.n_elem == 0)
+  {
+    throw std::invalid_argument("LSHSearch::Insert(): the model must be "
+        "trained before points can be inserted");
+  }
 
-  // Enforce the maximum bucket size.
-  const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
-  secondHashBinCounts.transform([effectiveBucketSize](size_t val)
-      { return std::min(val, effectiveBucketSize); });
+  util::CheckSameDimensionality(newPoints, referenceSet, "LSHSearch::Insert()",
+      "new points");
 
-  const size_t numRowsInTable = arma::accu(secondHashBinCounts > 0);
-  bucketContentSize.zeros(numRowsInTable);
-  secondHashTable.resize(numRowsInTable);
+  if (newPoints.n_cols == 0)
+    return;
+
+  const size_t firstIndex = referenceSet.n_cols;
+  referenceSet.insert_cols(firstIndex, newPoints);
+
+  // Only the new points need to be hashed.
+  arma::Mat<size_t> secondHashVectors;
+  HashPoints(newPoints, secondHashVectors);
+
+  // Find the size of every row after the insertion.  Buckets that were empty
+  // get new rows after the existing ones, in the order in which they are first
+  // seen, just like in Train().
+  const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
+  const size_t oldNumRows = bucketOffsets.n_elem - 1;
+  std::vector<size_t> rowSizes(oldNumRows);
+  for (size_t row = 0; row < oldNumRows; ++row)
+    rowSizes[row] = bucketOffsets[row + 1] - bucketOffsets[row];
 
-  // Next we must assign each point in each table to the right second hash
-  // table.
-  size_t currentRow = 0;
   for (size_t i = 0; i < numTables; ++i)
   {
-    // Insert the point in the corresponding row to its bucket in the
-    // 'secondHashTable'.
     for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
     {
-      // This is the bucket number.
-      size_t hashInd = (size_t) secondHashVectors(i, j);
-      // The point ID is 'j'.
-
-      // If this is currently an empty bucket, start a new row keep track of
-      // which row corresponds to the bucket.
-      const size_t maxSize = secondHashBinCounts[hashInd];
+      const size_t hashInd = secondHashVectors(i, j);
       if (bucketRowInHashTable[hashInd] == secondHashSize)
       {
-        bucketRowInHashTable[hashInd] = currentRow;
-        secondHashTable[currentRow].set_size(maxSize);
-        currentRow++;
+        bucketRowInHashTable[hashInd] = rowSizes.size();
+        rowSizes.push_back(0);
       }
 
-      // If this vector in the hash table is not full, add the point.
-      const size_t index = bucketRowInHashTable[hashInd];
-      if (bucketContentSize[index] < maxSize)
-        secondHashTable[index](bucketContentSize[index]++) = j;
-    } // Loop over all points in the reference set.
-  } // Loop over tables.
+      const size_t row = bucketRowInHashTable[hashInd];
+      if (rowSizes[row] < effectiveBucketSize)
+        ++rowSizes[row];
+    }
+  }
 
-  Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
-            << "maximum length of " << arma::max(secondHashBinCounts) << ", "
-            << "totaling " << arma::accu(secondHashBinCounts) << " elements."
-            << std::endl;
+  // Lay out the new table: each row keeps its points and gets the new points
+  // after them.
+  arma::Col<size_t> newBucketOffsets(rowSizes.size() + 1);
+  newBucketOffsets[0] = 0;
+  for (size_t row = 0; row < rowSizes.size(); ++row)
+    newBucketOffsets[row + 1] = newBucketOffsets[row] + rowSizes[row];
+
+  arma::Col<size_t> newBucketContents(newBucketOffsets[rowSizes.size()]);
+  arma::Col<size_t> bucketEnd(newBucketOffsets.memptr(), rowSizes.size());
+  for (size_t row = 0; row < oldNumRows; ++row)
+  {
+    std::copy(bucketContents.begin() + bucketOffsets[row],
+              bucketContents.begin() + bucketOffsets[row + 1],
+              newBucketContents.begin() + bucketEnd[row]);
+    bucketEnd[row] += bucketOffsets[row + 1] - bucketOffsets[row];
+  }
+
+  for (size_t i = 0; i < numTables; ++i)
+  {
+    for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
+    {
+      const size_t row = bucketRowInHashTable[secondHashVectors(i, j)];
+      if (bucketEnd[row] < newBucketOffsets[row + 1])
+        newBucketContents[bucketEnd[row]++] = firstIndex + j;
+    }
+  }
+
+  bucketContents = std::move(newBucketContents);
+  bucketOffsets = std::move(newBucketOffsets);
+
+  Log::Info << "Inserted " << newPoints.n_cols << " points; hash table size: "
+      << rowSizes.size() << " rows, totaling " << bucketContents.n_elem
+      << " elements." << std::endl;
 }
 
 // Base case where the query set is the reference set.  (So, we can't return
@@ -525,6 +630,7 @@ void LSHSearch<SortPolicy, MatType>::GetAdditionalProbingBins(
     const arma::vec& queryCode,
     const arma::vec& queryCodeNotFloored,
     const size_t T,
+    const std::vector<std::vector<size_t>>& probingSequence,
     arma::mat& additionalProbingBins) const
 {
   // No additional bins requested. Our work is done.
@@ -616,12 +722,46 @@ void LSHSearch<SortPolicy, MatType>::GetAdditionalProbingBins(
     return;
   }
 
-  // General case: more than 2 perturbation vectors require use of minheap.
-  // Sort everything in increasing order.
-  arma::uvec sortidx = arma::sort_index(scores);
-  scores = scores(sortidx);
-  actions = actions(sortidx);
-  positions = positions(sortidx);
+  // General case: apply the probing sequence, which is shared by all queries,
+  // to this query's perturbations sorted by score.
+  const arma::uvec sortidx = arma::sort_index(scores);
+  for (size_t pvec = 0; pvec < T; ++pvec)
+  {
+    const std::vector<size_t>& positionsToPerturb = probingSequence[pvec];
+    for (size_t p = 0; p < positionsToPerturb.size(); ++p)
+    {
+      const size_t pos = sortidx[positionsToPerturb[p]];
+      additionalProbingBins(positions(pos), pvec) += actions(pos);
+    }
+  }
+}
+
+// Compute the probing sequence shared by all queries.
+template<typename SortPolicy, typename MatType>
+void LSHSearch<SortPolicy, MatType>::GetProbingSequence(
+    const size_t T,
+    std::vector<std::vector<size_t>>& probingSequence) const
+{
+  probingSequence.clear();
+
+  // The special cases of 1 or 2 codes don't need a sequence.
+  if (T <= 2)
+    return;
+
+  // Each query sorts its 2 * M perturbation scores (the squared distances of
+  // its projections to the limits of its bins, with M = numProj).  Relative to
+  // hashWidth^2, the expected value of the j'th smallest sorted score is
+  // j * (j + 1) / (4 * (M + 1) * (M + 2)) for j <= M, and that of the j'th
+  // largest is 1 - j / (M + 1) + j * (j + 1) / (4 * (M + 1) * (M + 2)).  The
+  // sequence is built for these expected scores, which are increasing.
+  const double m = (double) numProj;
+  const double scale = 4.0 * (m + 1) * (m + 2);
+  arma::vec scores(2 * numProj);
+  for (size_t j = 1; j <= numProj; ++j)
+  {
+    scores[j - 1] = j * (j + 1) / scale;
+    scores[2 * numProj - j] = 1.0 - j / (m + 1) + j * (j + 1) / scale;
+  }
 
   // Theory:
   // A probing sequence is a sequence of T probing bins where a query's
@@ -656,9 +796,10 @@ void LSHSearch<SortPolicy, MatType>::GetAdditionalProbingBins(
   // Start by adding the lowest scoring set to the minheap.
   minHeap.push(std::make_pair(PerturbationScore(Ao, scores), 0));
 
-  // Loop invariable: after pvec iterations, additionalProbingBins contains pvec
-  // valid codes of the lowest-scoring bins (bins most likely to contain
-  // neighbors of the query).
+  // Loop invariable: after pvec iterations, probingSequence contains pvec
+  // valid perturbation sets of the lowest-scoring bins (bins most likely to
+  // contain neighbors of the query).
+  probingSequence.resize(T);
   for (size_t pvec = 0; pvec < T; ++pvec)
   {
     std::vector<bool> Ai;
@@ -693,45 +834,28 @@ void LSHSearch<SortPolicy, MatType>::GetAdditionalProbingBins(
       }
     } while (!PerturbationValid(Ai)); // Discard invalid perturbations
 
-    // Found valid perturbation set Ai. Construct perturbation vector from set.
+    // Found valid perturbation set Ai; store the positions it marks.
     for (size_t pos = 0; pos < Ai.size(); ++pos)
-    {
-      // If Ai[pos] is marked, add action to probing vector.
-      additionalProbingBins(positions(pos), pvec) += Ai[pos] ? actions(pos) : 0;
-    }
+      if (Ai[pos])
+        probingSequence[pvec].push_back(pos);
   }
 }
 
 template<typename SortPolicy, typename MatType>
-template<typename VecType>
-void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
-    const VecType& queryPoint,
-    arma::uvec& referenceIndices,
-    size_t numTablesToSearch,
-    const size_t T) const
+size_t LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
+    const arma::Mat<ElemType>& queryCodes,
+    const std::vector<std::vector<size_t>>& probingSequence,
+    const size_t T,
+    std::vector<bool>& candidateMarks,
+    arma::uvec& candidates) const
 {
-  // Decide on the number of tables to look into.
-  if (numTablesToSearch == 0) // If no user input is given, search all.
-    numTablesToSearch = numTables;
-
-  // Sanity check to make sure that the existing number of tables is not
-  // exceeded.
-  if (numTablesToSearch > numTables)
-    numTablesToSearch = numTables;
-
-  // Hash the query in each of the 'numTablesToSearch' hash tables using the
-  // 'numProj' projections for each table. This gives us 'numTablesToSearch'
-  // keys for the query where each key is a 'numProj' dimensional integer
-  // vector.
+  const size_t numTablesToSearch = queryCodes.n_cols;
+  const arma::mat queryCodesNotFloored = arma::conv_to<arma::mat>::from(
+      queryCodes);
 
-  // Compute the projection of the query in each table.
-  arma::mat allProjInTables(numProj, numTablesToSearch);
-  arma::mat queryCodesNotFloored(numProj, numTablesToSearch);
-  for (size_t i = 0; i < numTablesToSearch; ++i)
-    queryCodesNotFloored.unsafe_col(i) = projections.slice(i).t() * queryPoint;
-
-  queryCodesNotFloored += offsets.cols(0, numTablesToSearch - 1);
-  allProjInTables = arma::floor(queryCodesNotFloored / hashWidth);
+  // The query's key in each table is its 'numProj'-dimensional integer code.
+  const arma::mat allProjInTables = arma::floor(queryCodesNotFloored /
+      hashWidth);
 
   // Use hashMat to store the primary probing codes and any additional codes
   // from multiprobe LSH.
@@ -739,7 +863,7 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
   hashMat.set_size(T + 1, numTablesToSearch);
 
   // Compute the primary hash value of each key of the query into a bucket of
-  // the secondHashTable using the secondHashWeights.
+  // the second hash table using the secondHashWeights.
   hashMat.row(0) = arma::conv_to<arma::Row<size_t>> // Floor by typecasting
       ::from(secondHashWeights.t() * allProjInTables);
   // Mod to compute 2nd-level codes.
@@ -754,12 +878,13 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
       // Construct this table's probing sequence of length T.
       arma::mat additionalProbingBins;
       GetAdditionalProbingBins(allProjInTables.unsafe_col(i),
-                                queryCodesNotFloored.unsafe_col(i),
-                                T,
-                                additionalProbingBins);
+                               queryCodesNotFloored.unsafe_col(i),
+                               T,
+                               probingSequence,
+                               additionalProbingBins);
 
-      // Map each probing bin to a bin in secondHashTable (just like we did for
-      // the primary hash table).
+      // Map each probing bin to a bin in the second hash table (just like we
+      // did for the primary hash table).
       hashMat(arma::span(1, T), i) = // Compute code of rows 1:end of column i
         arma::conv_to< arma::Col<size_t> >:: // floor by typecasting to size_t
         from(secondHashWeights.t() * additionalProbingBins);
@@ -774,84 +899,134 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
   {
     for (size_t p = 0; p < T + 1; ++p)
     {
-      const size_t hashInd = hashMat(p, i); // find query's bucket
-      const size_t tableRow = bucketRowInHashTable[hashInd];
+      const size_t tableRow = bucketRowInHashTable[hashMat(p, i)];
       if (tableRow < secondHashSize)
-        maxNumPoints += bucketContentSize[tableRow]; // count bucket contents
+        maxNumPoints += bucketOffsets[tableRow + 1] - bucketOffsets[tableRow];
     }
   }
 
-  // There are two ways to proceed here:
-  // Either allocate a maxNumPoints-size vector, place all candidates, and run
-  // unique on the vector to discard duplicates.
-  // Or allocate a referenceSet.n_cols size vector (i.e. number of reference
-  // points) of zeros, and mark found indices as 1.
-  // Option 1 runs faster for small maxNumPoints but worse for larger values, so
-  // we choose based on a heuristic.
-  const float cutoff = 0.1;
-  const float selectivity = static_cast<float>(maxNumPoints) /
-      static_cast<float>(referenceSet.n_cols);
-
-  if (selectivity > cutoff)
-  {
-    // Heuristic: larger maxNumPoints means we should use find() because it
-    // should be faster.
-    // Reference points hashed in the same bucket as the query are set to >0.
-    arma::Col<size_t> refPointsConsidered;
-    refPointsConsidered.zeros(referenceSet.n_cols);
+  // Collect the candidates, keeping one copy of each: a candidate is marked
+  // when it is first found, and the marks of the candidates are cleared at the
+  // end, so this takes time proportional to the number of candidates (not to
+  // the size of the reference set) and the marks can be reused for the next
+  // query.
+  if (candidates.n_elem < maxNumPoints)
+    candidates.set_size(maxNumPoints);
 
-    for (size_t i = 0; i < numTablesToSearch; ++i) // for all tables
+  size_t numCandidates = 0;
+  for (size_t i = 0; i < numTablesToSearch; ++i) // For all tables.
+  {
+    for (size_t p = 0; p < T + 1; ++p) // For entire probing sequence.
     {
-      for (size_t p = 0; p < T + 1; ++p) // For entire probing sequence.
-      {
-        // get the sequence code
-        size_t hashInd = hashMat(p, i);
-        size_t tableRow = bucketRowInHashTable[hashInd];
+      const size_t tableRow = bucketRowInHashTable[hashMat(p, i)];
+      if (tableRow >= secondHashSize)
+        continue;
 
-        if (tableRow < secondHashSize && bucketContentSize[tableRow] > 0)
+      for (size_t j = bucketOffsets[tableRow]; j < bucketOffsets[tableRow + 1];
+           ++j)
+      {
+        const size_t index = bucketContents[j];
+        if (!candidateMarks[index])
         {
-          // Pick the indices in the bucket corresponding to hashInd.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsidered[ secondHashTable[tableRow](j) ]++;
+          candidateMarks[index] = true;
+          candidates[numCandidates++] = index;
         }
       }
     }
-
-    // Only keep reference points found in at least one bucket.
-    referenceIndices = arma::find(refPointsConsidered > 0);
-    return;
   }
-  else
-  {
-    // Heuristic: smaller maxNumPoints means we should use unique() because it
-    // should be faster.
-    // Allocate space for the query's potential neighbors.
-    arma::uvec refPointsConsideredSmall;
-    refPointsConsideredSmall.zeros(maxNumPoints);
 
-    // Retrieve candidates.
-    size_t start = 0;
+  for (size_t c = 0; c < numCandidates; ++c)
+    candidateMarks[candidates[c]] = false;
+
+  // Return the candidates in increasing order, so that ties between equally
+  // distant candidates are broken the same way for every query.
+  std::sort(candidates.begin(), candidates.begin() + numCandidates);
+  return numCandidates;
+}
 
-    for (size_t i = 0; i < numTablesToSearch; ++i) // For all tables
+template<typename SortPolicy, typename MatType>
+void LSHSearch<SortPolicy, MatType>::SearchInternal(
+    const MatType& querySet,
+    const bool monochromatic,
+    const size_t k,
+    arma::Mat<size_t>& resultingNeighbors,
+    arma::mat& distances,
+    size_t numTablesToSearch,
+    const size_t T)
+{
+  // Decide on the number of tables to look into.  If no user input is given,
+  // search all; also make sure that the existing number of tables is not
+  // exceeded.
+  if (numTablesToSearch == 0 || numTablesToSearch > numTables)
+    numTablesToSearch = numTables;
+
+  // The probing sequence of multiprobe LSH is the same for all queries.
+  std::vector<std::vector<size_t>> probingSequence;
+  GetProbingSequence(T, probingSequence);
+
+  // The projections of all the tables to search, as a single matrix (without a
+  // copy): the projections of table i are columns [i * numProj, (i + 1) *
+  // numProj).  So the projections of a block of queries in every table are
+  // computed with one matrix multiplication, and the projections of a query in
+  // table i are rows [i * numProj, (i + 1) * numProj) of its column.
+  const arma::Mat<ElemType> allProjections(
+      const_cast<ElemType*>(projections.memptr()), projections.n_rows,
+      numProj * numTablesToSearch, false, true);
+  const arma::Col<ElemType> allOffsets = arma::conv_to<arma::Col<ElemType>>::
+      from(arma::vectorise(offsets.cols(0, numTablesToSearch - 1)));
+
+  // Queries are projected in blocks, to bound the memory used for the codes.
+  const size_t blockSize = 1024;
+  arma::Mat<ElemType> blockCodes;
+
+  size_t totalIndicesReturned = 0;
+
+  // Parallelization to process more than one query at a time.
+  #pragma omp parallel reduction(+:totalIndicesReturned)
+  {
+    // Each thread reuses its candidate buffers for all of its queries.
+    std::vector<bool> candidateMarks(referenceSet.n_cols, false);
+    arma::uvec candidates;
+
+    for (size_t begin = 0; begin < querySet.n_cols; begin += blockSize)
     {
-      for (size_t p = 0; p < T + 1; ++p)
+      const size_t end = std::min(begin + blockSize, (size_t) querySet.n_cols);
+
+      #pragma omp single
       {
-        const size_t hashInd =  hashMat(p, i); // Find the query's bucket.
-        const size_t tableRow = bucketRowInHashTable[hashInd];
+        blockCodes = allProjections.t() * querySet.cols(begin, end - 1);
+        blockCodes.each_col() += allOffsets;
+      }
 
-        if (tableRow < secondHashSize)
-        {
-          // Store all secondHashTable points in the candidates set.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsideredSmall(start++) = secondHashTable[tableRow](j);
-       }
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t i = (omp_size_t) begin; i < (omp_size_t) end; ++i)
+      {
+        // Hash the query into every hash table and eventually into the second
+        // hash table to obtain the neighbor candidates.
+        const arma::Mat<ElemType> queryCodes(blockCodes.colptr(i - begin),
+            numProj, numTablesToSearch, false, true);
+        const size_t numCandidates = ReturnIndicesFromTable(queryCodes,
+            probingSequence, T, candidateMarks, candidates);
+
+        // An informative book-keeping for the number of neighbor candidates
+        // returned on average.
+        totalIndicesReturned += numCandidates;
+
+        // Sequentially go through all the candidates and save the best 'k'
+        // candidates.
+        const arma::uvec refIndices(candidates.memptr(), numCandidates, false,
+            true);
+        if (monochromatic)
+          BaseCase(i, refIndices, k, resultingNeighbors, distances);
+        else
+          BaseCase(i, refIndices, k, querySet, resultingNeighbors, distances);
       }
     }
-
-    // Keep only one copy of each candidate.
-    referenceIndices = arma::unique(refPointsConsideredSmall);
-    return;
   }
+
+  distanceEvaluations += totalIndicesReturned;
+  Log::Info << (totalIndicesReturned / querySet.n_cols)
+      << " distinct indices returned on average." << std::endl;
 }
 
 // Search for nearest neighbors in a given query set.
@@ -901,37 +1076,8 @@ void LSHSearch<SortPolicy, MatType>::Search(
     Log::Info << "Running multiprobe LSH with " << Teffective
         <<" additional probing bins per table per query." << std::endl;
 
-  size_t avgIndicesReturned = 0;
-
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
-      reduction(+:avgIndicesReturned)
-  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
-  {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
-    arma::uvec refIndices;
-    ReturnIndicesFromTable(querySet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running
-    // #pragma omp atomic
-    avgIndicesReturned = avgIndicesReturned + refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, querySet, resultingNeighbors, distances);
-  }
-
-  distanceEvaluations += avgIndicesReturned;
-  avgIndicesReturned /= querySet.n_cols;
-  Log::Info << avgIndicesReturned << " distinct indices returned on average." <<
-      std::endl;
+  SearchInternal(querySet, false, k, resultingNeighbors, distances,
+      numTablesToSearch, Teffective);
 }
 
 // Search for approximate neighbors of the reference set.
@@ -963,37 +1109,8 @@ Search(const size_t k,
     Log::Info << "Running multiprobe LSH with " << Teffective <<
       " additional probing bins per table per query."<< std::endl;
 
-  size_t avgIndicesReturned = 0;
-
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
-      reduction(+:avgIndicesReturned)
-  for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
-  {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
-    arma::uvec refIndices;
-    ReturnIndicesFromTable(referenceSet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running.
-    // #pragma omp atomic
-    avgIndicesReturned += refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, resultingNeighbors, distances);
-  }
-
-  distanceEvaluations += avgIndicesReturned;
-  avgIndicesReturned /= referenceSet.n_cols;
-  Log::Info << avgIndicesReturned << " distinct indices returned on average." <<
-      std::endl;
+  SearchInternal(referenceSet, true, k, resultingNeighbors, distances,
+      numTablesToSearch, Teffective);
 }
 
 template<typename SortPolicy, typename MatType>
@@ -1023,6 +1140,24 @@ double LSHSearch<SortPolicy, MatType>::ComputeRecall(
   return ((double) found) / realNeighbors.n_elem;
 }
 
+template<typename SortPolicy, typename MatType>
+std::vector<arma::Col<size_t>>
+LSHSearch<SortPolicy, MatType>::SecondHashTable() const
+{
+  std::vector<arma::Col<size_t>> secondHashTable;
+  if (bucketOffsets.n_elem == 0)
+    return secondHashTable;
+
+  secondHashTable.resize(bucketOffsets.n_elem - 1);
+  for (size_t i = 0; i + 1 < bucketOffsets.n_elem; ++i)
+  {
+    secondHashTable[i] = bucketContents.subvec(bucketOffsets[i],
+        bucketOffsets[i + 1] - 1);
+  }
+
+  return secondHashTable;
+}
+
 template<typename SortPolicy, typename MatType>
 template<typename Archive>
 void LSHSearch<SortPolicy, MatType>::serialize(Archive& ar,
@@ -1042,8 +1177,8 @@ void LSHSearch<SortPolicy, MatType>::serialize(Archive& ar,
   ar(CEREAL_NVP(secondHashSize));
   ar(CEREAL_NVP(secondHashWeights));
   ar(CEREAL_NVP(bucketSize));
-  ar(CEREAL_NVP(secondHashTable));
-  ar(CEREAL_NVP(bucketContentSize));
+  ar(CEREAL_NVP(bucketContents));
+  ar(CEREAL_NVP(bucketOffsets));
   ar(CEREAL_NVP(bucketRowInHashTable));
   ar(CEREAL_NVP(distanceEvaluations));
 }
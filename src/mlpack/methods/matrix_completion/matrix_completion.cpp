@@ -20,11 +20,10 @@ MatrixCompletion::MatrixCompletion(const size_t m,
                                    const arma::umat& indices,
                                    const arma::vec& values,
                                    const size_t r) :
-    m(m), n(n), indices(indices), values(values),
-    sdp(indices.n_cols, 0, arma::randu<arma::mat>(m + n, r))
+    m(m), n(n),
+    function(m, n, indices, values, arma::randu<arma::mat>(r, m + n))
 {
-  CheckValues();
-  InitSDP();
+  CheckValues(indices, values);
 }
 
 MatrixCompletion::MatrixCompletion(const size_t m,
@@ -32,26 +31,25 @@ MatrixCompletion::MatrixCompletion(const size_t m,
                                    const arma::umat& indices,
                                    const arma::vec& values,
                                    const arma::mat& initialPoint) :
-    m(m), n(n), indices(indices), values(values),
-    sdp(indices.n_cols, 0, initialPoint)
+    m(m), n(n),
+    function(m, n, indices, values, initialPoint.t())
 {
-  CheckValues();
-  InitSDP();
+  CheckValues(indices, values);
 }
 
 MatrixCompletion::MatrixCompletion(const size_t m,
                                    const size_t n,
                                    const arma::umat& indices,
                                    const arma::vec& values) :
-    m(m), n(n), indices(indices), values(values),
-    sdp(indices.n_cols, 0,
-        arma::randu<arma::mat>(m + n, DefaultRank(m, n, indices.n_cols)))
+    m(m), n(n),
+    function(m, n, indices, values, arma::randu<arma::mat>(
+        DefaultRank(m, n, indices.n_cols), m + n))
 {
-  CheckValues();
-  InitSDP();
+  CheckValues(indices, values);
 }
 
-void MatrixCompletion::CheckValues()
+void MatrixCompletion::CheckValues(const arma::umat& indices,
+                                   const arma::vec& values) const
 {
   if (indices.n_rows != 2)
   {
@@ -77,25 +75,39 @@ void MatrixCompletion::CheckValues()
   }
 }
 
-void MatrixCompletion::InitSDP()
+void MatrixCompletion::Observations(const arma::umat& indices,
+                                    const arma::vec& values)
 {
-  sdp.SDP().C().eye(m + n, m + n);
-  sdp.SDP().SparseB() = 2. * values;
-  const size_t p = indices.n_cols;
-  for (size_t i = 0; i < p; ++i)
+  CheckValues(indices, values);
+
+  // The multipliers belong to the sorted constraints, so they only carry over
+  // if the known entries are the same.
+  const arma::uvec oldRows = function.Rows();
+  const arma::uvec oldCols = function.Cols();
+  function.Observations(indices, values);
+  if (oldRows.n_elem != function.Rows().n_elem ||
+      arma::any(oldRows != function.Rows()) ||
+      arma::any(oldCols != function.Cols()))
   {
-    sdp.SDP().SparseA()[i].zeros(m + n, m + n);
-    sdp.SDP().SparseA()[i](indices(0, i), m + indices(1, i)) = 1.;
-    sdp.SDP().SparseA()[i](m + indices(1, i), indices(0, i)) = 1.;
+    optimizer.Lambda().zeros(function.NumConstraints());
+    optimizer.Sigma() = 10;
   }
 }
 
 void MatrixCompletion::Recover(arma::mat& recovered)
 {
-  recovered = sdp.Function().GetInitialPoint();
-  sdp.Optimize(recovered);
-  recovered = recovered * trans(recovered);
-  recovered = recovered(arma::span(0, m - 1), arma::span(m, m + n - 1));
+  // Start from the initial point the first time, and from the previous
+  // solution afterwards.
+  if (coordinates.is_empty())
+    coordinates = function.GetInitialPoint();
+  if (optimizer.Lambda().n_elem != function.NumConstraints())
+    optimizer.Lambda().zeros(function.NumConstraints());
+  optimizer.Optimize(function, coordinates);
+
+  // The completed matrix is R_1 R_2^T, where R_1 holds the factors of the rows
+  // and R_2 the factors of the columns.
+  recovered = coordinates.cols(0, m - 1).t() *
+      coordinates.cols(m, m + n - 1);
 }
 
 size_t MatrixCompletion::DefaultRank(const size_t m,
@@ -16,6 +16,8 @@
 #include <ensmallen.hpp>
 #include <mlpack/prereqs.hpp>
 
+#include "matrix_completion_function.hpp"
+
 namespace mlpack {
 namespace matrix_completion {
 
@@ -48,7 +50,14 @@ namespace matrix_completion {
  * mc.Recover(recovered);
  * @endcode
  *
- * @see LRSDP
+ * The SDP is solved in its low-rank factored form with the augmented
+ * Lagrangian method, as ens::LRSDP does, but through MatrixCompletionFunction,
+ * which only stores the known entries and evaluates the constraints and their
+ * gradient in parallel.  Recover() can be called again after the known
+ * entries change (see Observations()); the optimization then starts from the
+ * previous solution and Lagrange multipliers.
+ *
+ * @see MatrixCompletionFunction
  */
 class MatrixCompletion
 {
@@ -81,7 +90,8 @@ class MatrixCompletion
    *    [2 x p]).
    * @param values Vector containing the values of the known entries (must be
    *    length p).
-   * @param initialPoint Starting point for the SDP optimization.
+   * @param initialPoint Starting point for the SDP optimization (must be
+   *    (m + n) x r).
    */
   MatrixCompletion(const size_t m,
                    const size_t n,
@@ -111,31 +121,52 @@ class MatrixCompletion
    */
   void Recover(arma::mat& recovered);
 
-  //! Return the underlying SDP.
-  const ens::LRSDP<ens::SDP<arma::sp_mat>>& Sdp() const
+  /**
+   * Replace the known entries of the matrix.  The next call to Recover() is
+   * warm started from the previous solution; the Lagrange multipliers are kept
+   * if the entries are the same (for instance, only their values changed),
+   * and are reset otherwise.
+   *
+   * @param indices Matrix containing the indices of the known entries (must be
+   *    [2 x p]).
+   * @param values Vector containing the values of the known entries (must be
+   *    length p).
+   */
+  void Observations(const arma::umat& indices, const arma::vec& values);
+
+  //! Return the low-rank factor of the solution (or of the initial point, if
+  //! Recover() has not been called), with the factor of each row and column of
+  //! the matrix in a column.
+  const arma::mat& Factors() const
   {
-    return sdp;
+    return coordinates.is_empty() ? function.GetInitialPoint() : coordinates;
   }
-  //! Modify the underlying SDP.
-  ens::LRSDP<ens::SDP<arma::sp_mat>>& Sdp() { return sdp; }
+
+  //! Return the function being optimized.
+  const MatrixCompletionFunction& Function() const { return function; }
+  //! Modify the function being optimized.
+  MatrixCompletionFunction& Function() { return function; }
+
+  //! Return the augmented Lagrangian optimizer.
+  const ens::AugLagrangian& Optimizer() const { return optimizer; }
+  //! Modify the augmented Lagrangian optimizer.
+  ens::AugLagrangian& Optimizer() { return optimizer; }
 
  private:
   //! Number of rows in original matrix.
   size_t m;
   //! Number of columns in original matrix.
   size_t n;
-  //! Matrix containing the indices of the known entries (has two rows).
-  arma::umat indices;
-  //! Vector containing the values of the known entries.
-  arma::mat values;
 
-  //! The underlying SDP to be solved.
-  ens::LRSDP<ens::SDP<arma::sp_mat>> sdp;
+  //! The SDP to be solved, in its factored form.
+  MatrixCompletionFunction function;
+  //! The optimizer, which also holds the Lagrange multipliers between calls.
+  ens::AugLagrangian optimizer;
+  //! The current solution (empty until Recover() is called).
+  arma::mat coordinates;
 
   //! Validate the input matrices.
-  void CheckValues();
-  //! Initialize the SDP.
-  void InitSDP();
+  void CheckValues(const arma::umat& indices, const arma::vec& values) const;
 
   //! Select a rank of the matrix given that is of size m x n and has p known
   //! elements.
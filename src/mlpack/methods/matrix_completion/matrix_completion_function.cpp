@@ -0,0 +1,160 @@
+/**
+ * @file methods/matrix_completion/matrix_completion_function.cpp
+ *
+ * Implementation of MatrixCompletionFunction and of the augmented Lagrangian
+ * for it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#include "matrix_completion_function.hpp"
+
+namespace mlpack {
+namespace matrix_completion {
+
+MatrixCompletionFunction::MatrixCompletionFunction(
+    const size_t m,
+    const size_t n,
+    const arma::umat& indices,
+    const arma::vec& values,
+    const arma::mat& initialPoint) :
+    m(m), n(n), initialPoint(initialPoint)
+{
+  Observations(indices, values);
+}
+
+void MatrixCompletionFunction::Observations(const arma::umat& indices,
+                                            const arma::vec& values)
+{
+  // Sort the entries by column and then by row, so that the constraints of a
+  // column are contiguous and read the row factors in increasing order.
+  const arma::uvec unsortedRows = indices.row(0).t();
+  const arma::uvec unsortedCols = indices.row(1).t();
+  const arma::uvec order = arma::stable_sort_index(unsortedCols * m +
+      unsortedRows);
+  rows = unsortedRows.elem(order);
+  cols = unsortedCols.elem(order);
+  this->values = values.elem(order);
+
+  colStart.zeros(n + 1);
+  for (size_t i = 0; i < cols.n_elem; ++i)
+    ++colStart[cols[i] + 1];
+  colStart = arma::cumsum(colStart);
+
+  // The same entries, sorted by row (and then still by column).
+  rowOrder = arma::stable_sort_index(rows);
+  rowStart.zeros(m + 1);
+  for (size_t i = 0; i < rows.n_elem; ++i)
+    ++rowStart[rows[i] + 1];
+  rowStart = arma::cumsum(rowStart);
+}
+
+double MatrixCompletionFunction::Evaluate(const arma::mat& coordinates) const
+{
+  return arma::accu(arma::square(coordinates));
+}
+
+void MatrixCompletionFunction::Gradient(const arma::mat& coordinates,
+                                        arma::mat& gradient) const
+{
+  gradient = 2.0 * coordinates;
+}
+
+void MatrixCompletionFunction::GradientConstraint(const size_t index,
+                                                  const arma::mat& coordinates,
+                                                  arma::mat& gradient) const
+{
+  gradient.zeros(coordinates.n_rows, coordinates.n_cols);
+  gradient.col(rows[index]) += 2.0 * coordinates.col(m + cols[index]);
+  gradient.col(m + cols[index]) += 2.0 * coordinates.col(rows[index]);
+}
+
+void MatrixCompletionFunction::AddConstraintGradients(
+    const arma::vec& weights,
+    const arma::mat& coordinates,
+    arma::mat& gradient) const
+{
+  // The factors of the columns of M: each thread owns a range of columns.
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t j = 0; j < (omp_size_t) n; ++j)
+  {
+    for (size_t k = colStart[j]; k < colStart[j + 1]; ++k)
+      gradient.col(m + j) += (2.0 * weights[k]) * coordinates.col(rows[k]);
+  }
+
+  // The factors of the rows of M: each thread owns a range of rows.
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) m; ++i)
+  {
+    for (size_t k = rowStart[i]; k < rowStart[i + 1]; ++k)
+    {
+      const size_t index = rowOrder[k];
+      gradient.col(i) += (2.0 * weights[index]) *
+          coordinates.col(m + cols[index]);
+    }
+  }
+}
+
+} // namespace matrix_completion
+} // namespace mlpack
+
+namespace ens {
+
+AugLagrangianFunction<mlpack::matrix_completion::MatrixCompletionFunction>::
+AugLagrangianFunction(FunctionType& function) :
+    function(function),
+    lambda(function.NumConstraints(), arma::fill::zeros),
+    sigma(10)
+{
+  // Nothing to do.
+}
+
+AugLagrangianFunction<mlpack::matrix_completion::MatrixCompletionFunction>::
+AugLagrangianFunction(FunctionType& function,
+                      const arma::vec& lambda,
+                      const double sigma) :
+    function(function),
+    lambda(lambda),
+    sigma(sigma)
+{
+  // Nothing to do.
+}
+
+double AugLagrangianFunction<
+    mlpack::matrix_completion::MatrixCompletionFunction>::Evaluate(
+    const arma::mat& coordinates) const
+{
+  // L(R, y, s) = ||R||_F^2 - sum_i y_i c_i(R) + (s / 2) sum_i c_i(R)^2.
+  double constraints = 0.0;
+  #pragma omp parallel for reduction(+:constraints) schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) function.NumConstraints(); ++i)
+  {
+    const double c = function.EvaluateConstraint(i, coordinates);
+    constraints += c * (0.5 * sigma * c - lambda[i]);
+  }
+
+  return function.Evaluate(coordinates) + constraints;
+}
+
+void AugLagrangianFunction<
+    mlpack::matrix_completion::MatrixCompletionFunction>::Gradient(
+    const arma::mat& coordinates,
+    arma::mat& gradient) const
+{
+  // The gradient is 2 R + sum_i (s c_i(R) - y_i) grad c_i(R).
+  weights.set_size(function.NumConstraints());
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) function.NumConstraints(); ++i)
+  {
+    weights[i] = sigma * function.EvaluateConstraint(i, coordinates) -
+        lambda[i];
+  }
+
+  function.Gradient(coordinates, gradient);
+  function.AddConstraintGradients(weights, coordinates, gradient);
+}
+
+} // namespace ens
@@ -0,0 +1,217 @@
+/**
+ * @file methods/matrix_completion/matrix_completion_function.hpp
+ *
+ * The low-rank semidefinite program solved by MatrixCompletion, written in
+ * terms of the observed entries only, and the specialization of the augmented
+ * Lagrangian of ensmallen for it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_MATRIX_COMPLETION_MATRIX_COMPLETION_FUNCTION_HPP
+#define MLPACK_METHODS_MATRIX_COMPLETION_MATRIX_COMPLETION_FUNCTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <ensmallen.hpp>
+
+namespace mlpack {
+namespace matrix_completion {
+
+/**
+ * The Burer-Monteiro factorization of the nuclear norm minimization SDP
+ *
+ *   min ||R||_F^2 subj to 2 (R R^T)_{i, m + j} = 2 M_ij for each known M_ij,
+ *
+ * for an m x n matrix M, where the (m + n) x r factor R holds the factors of
+ * the rows of M followed by the factors of its columns.  This is the problem
+ * ens::LRSDP solves when given the sparse constraint matrices of the SDP, but
+ * each constraint here only touches two factors, so evaluating it costs O(r)
+ * and nothing of size (m + n) x (m + n) is ever formed.
+ *
+ * The coordinates are stored transposed, as an r x (m + n) matrix, so that the
+ * factors of each row and column of M are contiguous.  The constraints are
+ * sorted by column and then by row of M, and a permutation sorting them by row
+ * is kept as well; these two orders let the gradient be accumulated in
+ * parallel without two threads writing to the same factor.
+ *
+ * This class satisfies the LagrangianFunction interface of ens::AugLagrangian.
+ */
+class MatrixCompletionFunction
+{
+ public:
+  /**
+   * Create the function for the given known entries.
+   *
+   * @param m Number of rows of original matrix.
+   * @param n Number of columns of original matrix.
+   * @param indices Matrix containing the indices of the known entries (must be
+   *    [2 x p]).
+   * @param values Vector containing the values of the known entries (must be
+   *    length p).
+   * @param initialPoint Initial point of the optimization (must be
+   *    r x (m + n)).
+   */
+  MatrixCompletionFunction(const size_t m,
+                           const size_t n,
+                           const arma::umat& indices,
+                           const arma::vec& values,
+                           const arma::mat& initialPoint);
+
+  /**
+   * Replace the known entries, sorting them for the evaluation of the
+   * constraints.
+   *
+   * @param indices Matrix containing the indices of the known entries (must be
+   *    [2 x p]).
+   * @param values Vector containing the values of the known entries (must be
+   *    length p).
+   */
+  void Observations(const arma::umat& indices, const arma::vec& values);
+
+  //! Evaluate the objective ||R||_F^2 (without the constraints).
+  double Evaluate(const arma::mat& coordinates) const;
+
+  //! Evaluate the gradient 2 R of the objective (without the constraints).
+  void Gradient(const arma::mat& coordinates, arma::mat& gradient) const;
+
+  //! Get the number of constraints, which is the number of known entries.
+  size_t NumConstraints() const { return values.n_elem; }
+
+  /**
+   * Evaluate the given constraint, 2 (R R^T)_{i, m + j} - 2 M_ij, in O(r).
+   *
+   * @param index Index of the constraint, in the sorted order.
+   * @param coordinates Coordinates to evaluate the constraint at.
+   */
+  double EvaluateConstraint(const size_t index,
+                            const arma::mat& coordinates) const
+  {
+    return 2.0 * (arma::dot(coordinates.col(rows[index]),
+        coordinates.col(m + cols[index])) - values[index]);
+  }
+
+  /**
+   * Evaluate the gradient of the given constraint.  Only two columns of the
+   * gradient are nonzero.
+   *
+   * @param index Index of the constraint, in the sorted order.
+   * @param coordinates Coordinates to evaluate the gradient at.
+   * @param gradient Matrix to store the gradient in.
+   */
+  void GradientConstraint(const size_t index,
+                          const arma::mat& coordinates,
+                          arma::mat& gradient) const;
+
+  /**
+   * Add sum_k weights[k] * g_k to the given gradient, where g_k is the
+   * gradient of constraint k.  The columns of M are processed in parallel,
+   * and then the rows of M.
+   *
+   * @param weights Weight of each constraint, in the sorted order.
+   * @param coordinates Coordinates to evaluate the gradients at.
+   * @param gradient Matrix to add the weighted gradients to.
+   */
+  void AddConstraintGradients(const arma::vec& weights,
+                              const arma::mat& coordinates,
+                              arma::mat& gradient) const;
+
+  //! Get the initial point of the optimization.
+  const arma::mat& GetInitialPoint() const { return initialPoint; }
+  //! Modify the initial point of the optimization.
+  arma::mat& GetInitialPoint() { return initialPoint; }
+
+  //! Get the number of rows of the original matrix.
+  size_t NumRows() const { return m; }
+  //! Get the number of columns of the original matrix.
+  size_t NumCols() const { return n; }
+
+  //! Get the row of each known entry, in the sorted order.
+  const arma::uvec& Rows() const { return rows; }
+  //! Get the column of each known entry, in the sorted order.
+  const arma::uvec& Cols() const { return cols; }
+  //! Get the value of each known entry, in the sorted order.
+  const arma::vec& Values() const { return values; }
+
+ private:
+  //! Number of rows in original matrix.
+  size_t m;
+  //! Number of columns in original matrix.
+  size_t n;
+  //! The row of each known entry, sorted by column and then by row.
+  arma::uvec rows;
+  //! The column of each known entry, sorted by column and then by row.
+  arma::uvec cols;
+  //! The value of each known entry, sorted by column and then by row.
+  arma::vec values;
+  //! The known entries of column j are colStart[j] to colStart[j + 1] - 1.
+  arma::uvec colStart;
+  //! The known entries, sorted by row instead.
+  arma::uvec rowOrder;
+  //! The known entries of row i are rowOrder[rowStart[i]] to
+  //! rowOrder[rowStart[i + 1] - 1].
+  arma::uvec rowStart;
+  //! The initial point of the optimization.
+  arma::mat initialPoint;
+};
+
+} // namespace matrix_completion
+} // namespace mlpack
+
+/**
+ * @cond NO_DOXYGEN
+ */
+
+namespace ens {
+
+/**
+ * Template specialization of the augmented Lagrangian for matrix completion.
+ * The generic version evaluates the gradient of each constraint as a dense
+ * matrix; this one weights each constraint once, in parallel, and accumulates
+ * all the gradients in a single parallel pass over the sorted entries, as
+ * ens::LRSDP does for its own function.
+ */
+template<>
+class AugLagrangianFunction<mlpack::matrix_completion::MatrixCompletionFunction>
+{
+ public:
+  typedef mlpack::matrix_completion::MatrixCompletionFunction FunctionType;
+
+  AugLagrangianFunction(FunctionType& function);
+
+  AugLagrangianFunction(FunctionType& function,
+                        const arma::vec& lambda,
+                        const double sigma);
+
+  double Evaluate(const arma::mat& coordinates) const;
+
+  void Gradient(const arma::mat& coordinates, arma::mat& gradient) const;
+
+  const arma::mat& GetInitialPoint() const
+  { return function.GetInitialPoint(); }
+
+  const FunctionType& Function() const { return function; }
+  FunctionType& Function() { return function; }
+
+  const arma::vec& Lambda() const { return lambda; }
+  arma::vec& Lambda() { return lambda; }
+
+  double Sigma() const { return sigma; }
+  double& Sigma() { return sigma; }
+
+ private:
+  FunctionType& function;
+  arma::vec lambda;
+  double sigma;
+  //! Scratch space for the weight of each constraint in the gradient.
+  mutable arma::vec weights;
+};
+
+} // namespace ens
+
+/**
+ * @endcond
+ */
+
+#endif
@@ -77,6 +77,13 @@ class MeanShift
    * Perform mean shift clustering on the data, returning a list of cluster
    * assignments and centroids.
    *
+   * One tree is built on the data and used for every iteration.  In each
+   * iteration, the range searches of all the seeds that have not converged yet
+   * are done in parallel (if OpenMP is available), and the new centroids are
+   * accumulated as the points in range are found, without storing them.
+   * Seeds that converge, or that have no points in range, are dropped from
+   * the following iterations.
+   *
    * @tparam MatType Type of matrix.
    * @param data Dataset to cluster.
    * @param assignments Vector to store cluster assignments in.
@@ -126,34 +133,22 @@ class MeanShift
                 MatType& seeds);
 
   /**
-   * Use kernel to calculate new centroid given dataset and valid neighbors.
+   * Return the weight of a neighbor at the given distance from the current
+   * centroid, given by the kernel.  Neighbors at distance 0 have no weight.
    *
-   * @param data The whole dataset
-   * @param neighbors Valid neighbors
-   * @param distances Distances to neighbors
-   # @param centroid Store calculated centroid
+   * @param distance Distance between the neighbor and the centroid.
    */
   template<bool ApplyKernel = UseKernel>
-  typename std::enable_if<ApplyKernel, bool>::type
-  CalculateCentroid(const MatType& data,
-                    const std::vector<size_t>& neighbors,
-                    const std::vector<double>& distances,
-                    arma::colvec& centroid);
+  typename std::enable_if<ApplyKernel, double>::type
+  Weight(const double distance);
 
   /**
-   * Use mean to calculate new centroid given dataset and valid neighbors.
-   *
-   * @param data The whole dataset
-   * @param neighbors Valid neighbors
-   * @param distances Distances to neighbors
-   # @param centroid Store calculated centroid
+   * Return the weight of a neighbor when the new centroid is the mean of the
+   * neighbors, which is always 1.
    */
   template<bool ApplyKernel = UseKernel>
-  typename std::enable_if<!ApplyKernel, bool>::type
-  CalculateCentroid(const MatType& data,
-                    const std::vector<size_t>& neighbors,
-                    const std::vector<double>&, /*unused*/
-                    arma::colvec& centroid);
+  typename std::enable_if<!ApplyKernel, double>::type
+  Weight(const double /* distance */) { return 1.0; }
 
   /**
    * If distance of two centroids is less than radius, one will be removed.
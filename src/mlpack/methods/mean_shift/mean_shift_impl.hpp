@@ -101,10 +101,7 @@ void MeanShift<UseKernel, KernelType, MatType>::GenSeeds(
   for (size_t i = 0; i < data.n_cols; ++i)
   {
     VecType binnedPoint = arma::floor(data.unsafe_col(i) / binSize);
-    if (allSeeds.find(binnedPoint) == allSeeds.end())
-      allSeeds[binnedPoint] = 1;
-    else
-      allSeeds[binnedPoint]++;
+    ++allSeeds[binnedPoint];
   }
 
   // Remove seeds with too few points.  First we count the number of seeds we
@@ -129,51 +126,17 @@ void MeanShift<UseKernel, KernelType, MatType>::GenSeeds(
   seeds *= binSize;
 }
 
-// Calculate new centroid with given kernel.
+// Weight of a neighbor given by the kernel.
 template<bool UseKernel, typename KernelType, typename MatType>
 template<bool ApplyKernel>
-typename std::enable_if<ApplyKernel, bool>::type
-MeanShift<UseKernel, KernelType, MatType>::
-CalculateCentroid(const MatType& data,
-                  const std::vector<size_t>& neighbors,
-                  const std::vector<double>& distances,
-                  arma::colvec& centroid)
+typename std::enable_if<ApplyKernel, double>::type
+MeanShift<UseKernel, KernelType, MatType>::Weight(const double distance)
 {
-  double sumWeight = 0;
-  for (size_t i = 0; i < neighbors.size(); ++i)
-  {
-    if (distances[i] > 0)
-    {
-      double dist = distances[i] / radius;
-      double weight = kernel.Gradient(dist) / dist;
-      sumWeight += weight;
-      centroid += weight * data.unsafe_col(neighbors[i]);
-    }
-  }
+  if (distance <= 0)
+    return 0.0;
 
-  if (sumWeight != 0)
-  {
-    centroid /= sumWeight;
-    return true;
-  }
-  return false;
-}
-
-// Calculate new centroid by mean.
-template<bool UseKernel, typename KernelType, typename MatType>
-template<bool ApplyKernel>
-typename std::enable_if<!ApplyKernel, bool>::type
-MeanShift<UseKernel, KernelType, MatType>::
-CalculateCentroid(const MatType& data,
-                  const std::vector<size_t>& neighbors,
-                  const std::vector<double>&, /*unused*/
-                  arma::colvec& centroid)
-{
-  for (size_t i = 0; i < neighbors.size(); ++i)
-    centroid += data.unsafe_col(neighbors[i]);
-
-  centroid /= neighbors.size();
-  return true;
+  const double dist = distance / radius;
+  return kernel.Gradient(dist) / dist;
 }
 
 /**
@@ -203,62 +166,104 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
   }
 
   // Holds all centroids before removing duplicate ones.
-  arma::mat allCentroids(pSeeds->n_rows, pSeeds->n_cols);
+  arma::mat allCentroids(*pSeeds);
 
   assignments.set_size(data.n_cols);
 
-  range::RangeSearch<> rangeSearcher(data);
+  // The tree is built once, and single-tree search lets the seeds be searched
+  // in parallel.
+  range::RangeSearch<> rangeSearcher(data, false, true);
   math::Range validRadius(0, radius);
-  std::vector<std::vector<size_t> > neighbors;
-  std::vector<std::vector<double> > distances;
 
-  // For each seed, perform mean shift algorithm.
-  for (size_t i = 0; i < pSeeds->n_cols; ++i)
+  // The seeds that are still moving, and whether each seed has converged.
+  arma::uvec active;
+  if (pSeeds->n_cols > 0)
+    active = arma::regspace<arma::uvec>(0, pSeeds->n_cols - 1);
+  std::vector<bool> converged(pSeeds->n_cols, false);
+
+  // The weighted sum of the points in range of each active seed, their total
+  // weight, and their number.
+  arma::mat sums;
+  arma::vec weights;
+  arma::Col<size_t> counts;
+
+  // Accumulate each point in range as it is found.  The callback is never
+  // called by two threads at the same time for the same seed.
+  auto accumulate = [&](const size_t seed,
+                        const size_t point,
+                        const double distance)
   {
-    // Initial centroid is the seed itself.
-    allCentroids.col(i) = pSeeds->unsafe_col(i);
-    for (size_t completedIterations = 0; completedIterations < maxIterations
-        || forceConvergence; completedIterations++)
+    const double weight = Weight(distance);
+    if (weight != 0)
     {
-      // Store new centroid in this.
-      arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
+      sums.col(seed) += weight * data.col(point);
+      weights[seed] += weight;
+    }
+    ++counts[seed];
+  };
 
-      rangeSearcher.Search(allCentroids.unsafe_col(i), validRadius,
-          neighbors, distances);
-      if (neighbors[0].size() == 0) // There are no points in the cluster.
-        break;
+  // Move all the active seeds at once, and drop them as they converge.
+  for (size_t completedIterations = 0; (completedIterations < maxIterations
+      || forceConvergence) && active.n_elem > 0; completedIterations++)
+  {
+    const arma::mat queries = allCentroids.cols(active);
+    sums.zeros(queries.n_rows, queries.n_cols);
+    weights.zeros(queries.n_cols);
+    counts.zeros(queries.n_cols);
+    rangeSearcher.Stream(queries, validRadius, accumulate);
+
+    size_t stillActive = 0;
+    for (size_t j = 0; j < active.n_elem; ++j)
+    {
+      const size_t i = active[j];
+
+      // There are no points in the cluster.
+      if (counts[j] == 0)
+        continue;
 
       // Calculate new centroid.
-      if (!CalculateCentroid(data, neighbors[0], distances[0], newCentroid))
-        newCentroid = allCentroids.unsafe_col(i);
+      arma::colvec newCentroid = queries.col(j);
+      if (weights[j] != 0)
+        newCentroid = sums.col(j) / weights[j];
 
       // If the mean shift vector is small enough, it has converged.
       if (metric::EuclideanDistance::Evaluate(newCentroid,
           allCentroids.unsafe_col(i)) < 1e-3 * radius)
       {
-        // Determine if the new centroid is duplicate with old ones.
-        bool isDuplicated = false;
-        for (size_t k = 0; k < centroids.n_cols; ++k)
-        {
-          const double distance = metric::EuclideanDistance::Evaluate(
-              allCentroids.unsafe_col(i), centroids.unsafe_col(k));
-          if (distance < radius)
-          {
-            isDuplicated = true;
-            break;
-          }
-        }
-
-        if (!isDuplicated)
-          centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
-
-        // Get out of the loop.
-        break;
+        converged[i] = true;
+        continue;
       }
 
       // Update the centroid.
       allCentroids.col(i) = newCentroid;
+      active[stillActive++] = i;
     }
+
+    active.resize(stillActive);
+  }
+
+  // Keep the converged centroids that are not duplicates of earlier ones, in
+  // the order of the seeds.
+  for (size_t i = 0; i < allCentroids.n_cols; ++i)
+  {
+    if (!converged[i])
+      continue;
+
+    // Determine if the new centroid is duplicate with old ones.
+    bool isDuplicated = false;
+    for (size_t k = 0; k < centroids.n_cols; ++k)
+    {
+      const double distance = metric::EuclideanDistance::Evaluate(
+          allCentroids.unsafe_col(i), centroids.unsafe_col(k));
+      if (distance < radius)
+      {
+        isDuplicated = true;
+        break;
+      }
+    }
+
+    if (!isDuplicated)
+      centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
   }
 
   // If no centroid has converged due to too little iterations and without
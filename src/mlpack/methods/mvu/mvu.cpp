@@ -12,14 +12,13 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include "mvu.hpp"
-
-#include <mlpack/core/optimizers/sdp/lrsdp.hpp>
+#include "mvu_function.hpp"
 
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 
 using namespace mlpack;
 using namespace mlpack::mvu;
-using namespace mlpack::optimization;
+using namespace mlpack::neighbor;
 
 MVU::MVU(const arma::mat& data) : data(data)
 {
@@ -30,82 +29,53 @@ void MVU::Unfold(const size_t newDim,
                  const size_t numNeighbors,
                  arma::mat& outputData)
 {
-  // First we have to choose the output point.  We'll take a linear projection
-  // of the data for now (this is probably not a good final solution).
-//  outputData = trans(data.rows(0, newDim - 1));
-  // Following Nick's idea.
-  outputData.randu(data.n_cols, newDim);
-
-  // The number of constraints is the number of nearest neighbors plus one.
-  LRSDP<arma::sp_mat> mvuSolver(numNeighbors * data.n_cols + 1, outputData);
-
-  // Set up the objective.  Because we are maximizing the trace of (R R^T),
-  // we'll instead state it as min(-I_n * (R R^T)), meaning C() is -I_n.
-  mvuSolver.C().eye(data.n_cols, data.n_cols);
-  mvuSolver.C() *= -1;
-
-  // Now set up each of the constraints.
-  // The first constraint is trace(ones * R * R^T) = 0.
-  mvuSolver.B()[0] = 0;
-  mvuSolver.A()[0].ones(data.n_cols, data.n_cols);
-
-  // All of our other constraints will be sparse except the first.  So set that
-  // vector of modes accordingly.
-  mvuSolver.AModes().ones();
-  mvuSolver.AModes()[0] = 0;
-
-  // Now all of the other constraints.  We first have to run KNN to get the
-  // list of nearest neighbors.
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  KNN knn(data);
-  knn.Search(numNeighbors, neighbors, distances);
+  // First we have to choose the output point.  Following Nick's idea, it is
+  // random.  Each column is a point, so the coordinates of a point are
+  // contiguous.
+  outputData.randu(newDim, data.n_cols);
+
+  // The neighbors are sorted by distance, so an earlier search for at least as
+  // many neighbors can be reused.
+  if (neighbors.n_cols != data.n_cols || neighbors.n_rows < numNeighbors)
+  {
+    KNN knn(data);
+    knn.Search(numNeighbors, neighbors, distances);
+  }
 
-  // Add each of the other constraints.  They are sparse constraints:
-  //   Tr(A_ij K) = d_ij;
-  //   A_ij = zeros except for 1 at (i, i), (j, j); -1 at (i, j), (j, i).
-  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  // Each constraint Tr(A_ij K) = d_ij^2, with A_ij = 1 at (i, i) and (j, j)
+  // and -1 at (i, j) and (j, i), is the rank-one constraint
+  // ||r_i - r_j||^2 = d_ij^2.  A pair that are each other's neighbors only
+  // needs one constraint.
+  std::vector<std::pair<size_t, size_t>> pairList;
+  pairList.reserve(numNeighbors * data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
   {
     for (size_t j = 0; j < numNeighbors; ++j)
     {
-      // This is the index of the constraint.
-      const size_t index = (i * numNeighbors) + j + 1;
-
-      arma::mat& aRef = mvuSolver.A()[index];
-
-      aRef.set_size(3, 4);
-
-      // A_ij(i, i) = 1.
-      aRef(0, 0) = i;
-      aRef(1, 0) = i;
-      aRef(2, 0) = 1;
-
-      // A_ij(i, j) = -1.
-      aRef(0, 1) = i;
-      aRef(1, 1) = neighbors(j, i);
-      aRef(2, 1) = -1;
-
-      // A_ij(j, i) = -1.
-      aRef(0, 2) = neighbors(j, i);
-      aRef(1, 2) = i;
-      aRef(2, 2) = -1;
-
-      // A_ij(j, j) = 1.
-      aRef(0, 3) = neighbors(j, i);
-      aRef(1, 3) = neighbors(j, i);
-      aRef(2, 3) = 1;
-
-      // The constraint b_ij is the distance between these two points.
-      mvuSolver.B()[index] = distances(j, i);
+      pairList.push_back(std::make_pair(std::min(i, neighbors(j, i)),
+          std::max(i, neighbors(j, i))));
     }
   }
+  std::sort(pairList.begin(), pairList.end());
+  pairList.erase(std::unique(pairList.begin(), pairList.end()),
+      pairList.end());
 
-  // Now on with the solving.
-  double objective = mvuSolver.Optimize(outputData);
+  arma::umat pairs(2, pairList.size());
+  arma::vec squaredDistances(pairList.size());
+  for (size_t k = 0; k < pairList.size(); ++k)
+  {
+    pairs(0, k) = pairList[k].first;
+    pairs(1, k) = pairList[k].second;
+    squaredDistances[k] = arma::accu(arma::square(
+        data.col(pairList[k].first) - data.col(pairList[k].second)));
+  }
 
-  Log::Info << "Final objective is " << objective << "." << std::endl;
+  // Now on with the solving.
+  MVUFunction function(pairs, squaredDistances, outputData);
+  ens::AugLagrangian optimizer;
+  optimizer.Lambda().zeros(function.NumConstraints());
+  optimizer.Optimize(function, outputData);
 
-  // Revert to original data format.
-  outputData = trans(outputData);
+  Log::Info << "Final objective is " << function.Evaluate(outputData) << "."
+      << std::endl;
 }
@@ -28,18 +28,40 @@ namespace mvu {
  *
  * - dataset
  * - new dimensionality
+ *
+ * The semidefinite program is solved through MVUFunction, whose constraints
+ * are the neighbor pairs themselves, so the cost of each iteration is linear in
+ * the number of points.  The nearest neighbors of the dataset are computed
+ * once and reused by later calls to Unfold() that need as many neighbors or
+ * fewer.
+ *
+ * @see MVUFunction
  */
 class MVU
 {
  public:
   MVU(const arma::mat& dataIn);
 
+  /**
+   * Unfold the dataset into the given number of dimensions.
+   *
+   * @param newDim Dimensionality of the unfolded dataset.
+   * @param numNeighbors Number of nearest neighbors of each point whose
+   *    distances are preserved.
+   * @param outputCoordinates Matrix to store the unfolded dataset in (newDim x
+   *    n).
+   */
   void Unfold(const size_t newDim,
               const size_t numNeighbors,
               arma::mat& outputCoordinates);
 
  private:
   const arma::mat& data;
+
+  //! The nearest neighbors of each point, from the last search.
+  arma::Mat<size_t> neighbors;
+  //! The distances to the nearest neighbors of each point.
+  arma::mat distances;
 };
 
 } // namespace mvu
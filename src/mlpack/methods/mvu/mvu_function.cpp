@@ -0,0 +1,175 @@
+/**
+ * @file methods/mvu/mvu_function.cpp
+ *
+ * Implementation of MVUFunction and of the augmented Lagrangian for it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#include "mvu_function.hpp"
+
+namespace mlpack {
+namespace mvu {
+
+MVUFunction::MVUFunction(const arma::umat& pairs,
+                         const arma::vec& squaredDistances,
+                         const arma::mat& initialPoint) :
+    pairs(pairs),
+    squaredDistances(squaredDistances),
+    initialPoint(initialPoint)
+{
+  // Group the pairs by the points they contain; each pair is listed under both
+  // of its points.
+  const size_t n = initialPoint.n_cols;
+  pointStart.zeros(n + 1);
+  for (size_t k = 0; k < pairs.n_cols; ++k)
+  {
+    ++pointStart[pairs(0, k) + 1];
+    ++pointStart[pairs(1, k) + 1];
+  }
+  pointStart = arma::cumsum(pointStart);
+
+  arma::uvec next = pointStart.subvec(0, n - 1);
+  pointPairs.set_size(2 * pairs.n_cols);
+  for (size_t k = 0; k < pairs.n_cols; ++k)
+  {
+    pointPairs[next[pairs(0, k)]++] = k;
+    pointPairs[next[pairs(1, k)]++] = k;
+  }
+}
+
+double MVUFunction::Evaluate(const arma::mat& coordinates) const
+{
+  return -arma::accu(arma::square(coordinates));
+}
+
+void MVUFunction::Gradient(const arma::mat& coordinates,
+                           arma::mat& gradient) const
+{
+  gradient = -2.0 * coordinates;
+}
+
+double MVUFunction::EvaluateConstraint(const size_t index,
+                                       const arma::mat& coordinates) const
+{
+  if (index == 0)
+    return arma::accu(arma::square(arma::sum(coordinates, 1)));
+
+  const size_t k = index - 1;
+  const double* a = coordinates.colptr(pairs(0, k));
+  const double* b = coordinates.colptr(pairs(1, k));
+  double distance = 0.0;
+  for (size_t d = 0; d < coordinates.n_rows; ++d)
+    distance += (a[d] - b[d]) * (a[d] - b[d]);
+
+  return distance - squaredDistances[k];
+}
+
+void MVUFunction::GradientConstraint(const size_t index,
+                                     const arma::mat& coordinates,
+                                     arma::mat& gradient) const
+{
+  if (index == 0)
+  {
+    gradient = arma::repmat(2.0 * arma::sum(coordinates, 1), 1,
+        coordinates.n_cols);
+    return;
+  }
+
+  const size_t k = index - 1;
+  gradient.zeros(coordinates.n_rows, coordinates.n_cols);
+  gradient.col(pairs(0, k)) = 2.0 * (coordinates.col(pairs(0, k)) -
+      coordinates.col(pairs(1, k)));
+  gradient.col(pairs(1, k)) = -gradient.col(pairs(0, k));
+}
+
+void MVUFunction::AddConstraintGradients(const arma::vec& weights,
+                                         const arma::mat& coordinates,
+                                         arma::mat& gradient) const
+{
+  // The centering constraint adds the same vector to every point.
+  const arma::vec center = (2.0 * weights[0]) * arma::sum(coordinates, 1);
+
+  // Each thread owns a range of points, and adds the gradients of the pairs
+  // of its points only to them.
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) coordinates.n_cols; ++i)
+  {
+    gradient.col(i) += center;
+    for (size_t p = pointStart[i]; p < pointStart[i + 1]; ++p)
+    {
+      const size_t k = pointPairs[p];
+      const size_t other = (pairs(0, k) == (size_t) i) ? pairs(1, k) :
+          pairs(0, k);
+      gradient.col(i) += (2.0 * weights[k + 1]) * (coordinates.col(i) -
+          coordinates.col(other));
+    }
+  }
+}
+
+} // namespace mvu
+} // namespace mlpack
+
+namespace ens {
+
+AugLagrangianFunction<mlpack::mvu::MVUFunction>::AugLagrangianFunction(
+    FunctionType& function) :
+    function(function),
+    lambda(function.NumConstraints(), arma::fill::zeros),
+    sigma(10)
+{
+  // Nothing to do.
+}
+
+AugLagrangianFunction<mlpack::mvu::MVUFunction>::AugLagrangianFunction(
+    FunctionType& function,
+    const arma::vec& lambda,
+    const double sigma) :
+    function(function),
+    lambda(lambda),
+    sigma(sigma)
+{
+  // Nothing to do.
+}
+
+double AugLagrangianFunction<mlpack::mvu::MVUFunction>::Evaluate(
+    const arma::mat& coordinates) const
+{
+  // L(R, y, s) = -||R||_F^2 - sum_i y_i c_i(R) + (s / 2) sum_i c_i(R)^2.  The
+  // centering constraint costs as much as all the others, so it is evaluated
+  // on its own.
+  const double center = function.EvaluateConstraint(0, coordinates);
+  double constraints = center * (0.5 * sigma * center - lambda[0]);
+  #pragma omp parallel for reduction(+:constraints) schedule(static)
+  for (omp_size_t i = 1; i < (omp_size_t) function.NumConstraints(); ++i)
+  {
+    const double c = function.EvaluateConstraint(i, coordinates);
+    constraints += c * (0.5 * sigma * c - lambda[i]);
+  }
+
+  return function.Evaluate(coordinates) + constraints;
+}
+
+void AugLagrangianFunction<mlpack::mvu::MVUFunction>::Gradient(
+    const arma::mat& coordinates,
+    arma::mat& gradient) const
+{
+  // The gradient is -2 R + sum_i (s c_i(R) - y_i) grad c_i(R).
+  weights.set_size(function.NumConstraints());
+  weights[0] = sigma * function.EvaluateConstraint(0, coordinates) -
+      lambda[0];
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 1; i < (omp_size_t) function.NumConstraints(); ++i)
+  {
+    weights[i] = sigma * function.EvaluateConstraint(i, coordinates) -
+        lambda[i];
+  }
+
+  function.Gradient(coordinates, gradient);
+  function.AddConstraintGradients(weights, coordinates, gradient);
+}
+
+} // namespace ens
@@ -0,0 +1,180 @@
+/**
+ * @file methods/mvu/mvu_function.hpp
+ *
+ * The low-rank semidefinite program solved by MVU, written in terms of the
+ * nearest neighbor pairs only, and the specialization of the augmented
+ * Lagrangian of ensmallen for it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_MVU_MVU_FUNCTION_HPP
+#define MLPACK_METHODS_MVU_MVU_FUNCTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <ensmallen.hpp>
+
+namespace mlpack {
+namespace mvu {
+
+/**
+ * The Burer-Monteiro factorization of the MVU semidefinite program
+ *
+ *   max tr(K) subj to sum_ij K_ij = 0,
+ *                     K_ii - 2 K_ij + K_jj = d_ij^2 for each neighbor pair,
+ *
+ * with K = R^T R, for a d x n factor R whose columns are the embedded points.
+ * It is stated as a minimization of -||R||_F^2.  Each neighbor constraint is
+ * the rank-one constraint ||r_i - r_j||^2 = d_ij^2, so evaluating it costs
+ * O(d), and the centering constraint is ||R 1||^2 = 0; nothing of size n x n
+ * is ever formed.
+ *
+ * Constraint 0 is the centering constraint, and constraint k + 1 is the k'th
+ * neighbor pair.  For the gradient, the pairs each point belongs to are kept
+ * in a compressed list, so that the gradient can be accumulated in parallel
+ * over points without two threads writing to the same column.
+ *
+ * This class satisfies the LagrangianFunction interface of ens::AugLagrangian.
+ */
+class MVUFunction
+{
+ public:
+  /**
+   * Create the function for the given neighbor pairs.
+   *
+   * @param pairs Indices of the neighbor pairs (must be [2 x p]).
+   * @param squaredDistances Squared distance between the points of each pair
+   *    (must be length p).
+   * @param initialPoint Initial point of the optimization (must be d x n).
+   */
+  MVUFunction(const arma::umat& pairs,
+              const arma::vec& squaredDistances,
+              const arma::mat& initialPoint);
+
+  //! Evaluate the objective -||R||_F^2 (without the constraints).
+  double Evaluate(const arma::mat& coordinates) const;
+
+  //! Evaluate the gradient -2 R of the objective (without the constraints).
+  void Gradient(const arma::mat& coordinates, arma::mat& gradient) const;
+
+  //! Get the number of constraints: the neighbor pairs and the centering.
+  size_t NumConstraints() const { return squaredDistances.n_elem + 1; }
+
+  /**
+   * Evaluate the given constraint: ||R 1||^2 for the centering constraint,
+   * in O(nd), and ||r_i - r_j||^2 - d_ij^2 for a neighbor pair, in O(d).
+   *
+   * @param index Index of the constraint.
+   * @param coordinates Coordinates to evaluate the constraint at.
+   */
+  double EvaluateConstraint(const size_t index,
+                            const arma::mat& coordinates) const;
+
+  /**
+   * Evaluate the gradient of the given constraint.  For a neighbor pair, only
+   * two columns of the gradient are nonzero.
+   *
+   * @param index Index of the constraint.
+   * @param coordinates Coordinates to evaluate the gradient at.
+   * @param gradient Matrix to store the gradient in.
+   */
+  void GradientConstraint(const size_t index,
+                          const arma::mat& coordinates,
+                          arma::mat& gradient) const;
+
+  /**
+   * Add sum_k weights[k] * g_k to the given gradient, where g_k is the
+   * gradient of constraint k.  The points are processed in parallel.
+   *
+   * @param weights Weight of each constraint.
+   * @param coordinates Coordinates to evaluate the gradients at.
+   * @param gradient Matrix to add the weighted gradients to.
+   */
+  void AddConstraintGradients(const arma::vec& weights,
+                              const arma::mat& coordinates,
+                              arma::mat& gradient) const;
+
+  //! Get the initial point of the optimization.
+  const arma::mat& GetInitialPoint() const { return initialPoint; }
+  //! Modify the initial point of the optimization.
+  arma::mat& GetInitialPoint() { return initialPoint; }
+
+  //! Get the indices of the neighbor pairs.
+  const arma::umat& Pairs() const { return pairs; }
+  //! Get the squared distance between the points of each neighbor pair.
+  const arma::vec& SquaredDistances() const { return squaredDistances; }
+
+ private:
+  //! The indices of the neighbor pairs.
+  arma::umat pairs;
+  //! The squared distance between the points of each neighbor pair.
+  arma::vec squaredDistances;
+  //! The pairs of point i are pointPairs[pointStart[i]] to
+  //! pointPairs[pointStart[i + 1] - 1].
+  arma::uvec pointStart;
+  //! The neighbor pairs of each point, grouped by point.
+  arma::uvec pointPairs;
+  //! The initial point of the optimization.
+  arma::mat initialPoint;
+};
+
+} // namespace mvu
+} // namespace mlpack
+
+/**
+ * @cond NO_DOXYGEN
+ */
+
+namespace ens {
+
+/**
+ * Template specialization of the augmented Lagrangian for MVU.  The generic
+ * version evaluates the gradient of each constraint as a dense matrix; this
+ * one weights each constraint once, in parallel, and accumulates all the
+ * gradients in a single parallel pass over the points.
+ */
+template<>
+class AugLagrangianFunction<mlpack::mvu::MVUFunction>
+{
+ public:
+  typedef mlpack::mvu::MVUFunction FunctionType;
+
+  AugLagrangianFunction(FunctionType& function);
+
+  AugLagrangianFunction(FunctionType& function,
+                        const arma::vec& lambda,
+                        const double sigma);
+
+  double Evaluate(const arma::mat& coordinates) const;
+
+  void Gradient(const arma::mat& coordinates, arma::mat& gradient) const;
+
+  const arma::mat& GetInitialPoint() const
+  { return function.GetInitialPoint(); }
+
+  const FunctionType& Function() const { return function; }
+  FunctionType& Function() { return function; }
+
+  const arma::vec& Lambda() const { return lambda; }
+  arma::vec& Lambda() { return lambda; }
+
+  double Sigma() const { return sigma; }
+  double& Sigma() { return sigma; }
+
+ private:
+  FunctionType& function;
+  arma::vec lambda;
+  double sigma;
+  //! Scratch space for the weight of each constraint in the gradient.
+  mutable arma::vec weights;
+};
+
+} // namespace ens
+
+/**
+ * @endcond
+ */
+
+#endif
@@ -78,7 +78,7 @@ class NaiveBayesClassifier
    * @param incrementalVariance If true, an incremental algorithm is used to
    *     calculate the variance; this can prevent loss of precision in some
    *     cases, but will be somewhat slower to calculate.
-   * @param epsilon Small value to prevent log of zero.
+   * @param epsilon Small value added to the variances to prevent log of zero.
    */
   template<typename MatType>
   NaiveBayesClassifier(const MatType& data,
@@ -113,6 +113,12 @@ class NaiveBayesClassifier
    * @param numClasses The numbe of classes in the dataset.
    * @param incremental Whether or not to use the incremental algorithm for
    *      training.
+   *
+   * The statistics of the given data are computed in parallel over blocks of
+   * points, and merged with each other and with the current model with the
+   * pairwise update of Chan, Golub and LeVeque.  So, training incrementally on
+   * the parts of a dataset gives the same model as training on all of it at
+   * once, up to floating-point error.
    */
   template<typename MatType>
   void Train(const MatType& data,
@@ -204,7 +210,7 @@ class NaiveBayesClassifier
   //! Modify the sample means for each class.
   ModelMatType& Means() { return means; }
 
-  //! Get the sample variances for each class.
+  //! Get the sample variances for each class (epsilon is not included).
   const ModelMatType& Variances() const { return variances; }
   //! Modify the sample variances for each class.
   ModelMatType& Variances() { return variances; }
@@ -227,7 +233,7 @@ class NaiveBayesClassifier
   ModelMatType probabilities;
   //! Number of training points seen so far.
   size_t trainingPoints;
-  //! Small value to prevent log of zero.
+  //! Small value added to the variances to prevent log of zero.
   double epsilon;
 
   /**
@@ -241,6 +247,25 @@ class NaiveBayesClassifier
   template<typename MatType>
   void LogLikelihood(const MatType& data,
                      ModelMatType& logLikelihoods) const;
+
+  /**
+   * Merge the statistics of a set of points into the statistics of another
+   * set of points, per class.
+   *
+   * @param counts Number of points of each class; will be updated.
+   * @param means Sample mean of each class; will be updated.
+   * @param m2 Sum of squared deviations from the mean of each class; will be
+   *     updated.
+   * @param otherCounts Number of points of each class of the other set.
+   * @param otherMeans Sample mean of each class of the other set.
+   * @param otherM2 Sum of squared deviations of each class of the other set.
+   */
+  static void MergeStatistics(arma::vec& counts,
+                              ModelMatType& means,
+                              ModelMatType& m2,
+                              const arma::vec& otherCounts,
+                              const ModelMatType& otherMeans,
+                              const ModelMatType& otherM2);
 };
 
 } // namespace naive_bayes
@@ -85,94 +85,101 @@ void NaiveBayesClassifier<ModelMatType>::Train(
       "NaiveBayesClassifier: element type of given data must match the element "
       "type of the model!");
 
-  // Do we need to resize the model?
-  if (probabilities.n_elem != numClasses)
+  // Do we need to resize the model?  If so, the current model is meaningless.
+  if (probabilities.n_elem != numClasses || means.n_rows != data.n_rows)
   {
-    // Perform training, after initializing the model to 0 (that is, if Train()
-    // won't do that for us, which it won't if we're using the incremental
-    // algorithm).
-    if (incremental)
-    {
-      probabilities.zeros(numClasses);
-      means.zeros(data.n_rows, numClasses);
-      variances.zeros(data.n_rows, numClasses);
-    }
-    else
-    {
-      probabilities.set_size(numClasses);
-      means.set_size(data.n_rows, numClasses);
-      variances.set_size(data.n_rows, numClasses);
-    }
+    probabilities.zeros(numClasses);
+    means.zeros(data.n_rows, numClasses);
+    variances.zeros(data.n_rows, numClasses);
+    trainingPoints = 0;
   }
 
-  // Calculate the class probabilities as well as the sample mean and variance
-  // for each of the features with respect to each of the labels.
-  if (incremental)
+  // Calculate the class counts as well as the sample mean and the sum of
+  // squared deviations (M2) of each of the features with respect to each of
+  // the labels.  The points are split into blocks whose statistics are computed
+  // in parallel, each with the two-pass algorithm (which avoids the precision
+  // issues of the one-pass algorithm), and then merged in order.
+  const size_t numBlocks = ParallelPolicy::Current().NumBlocks(data.n_cols,
+      4096);
+  const size_t blockSize = (data.n_cols + numBlocks - 1) / numBlocks;
+
+  std::vector<arma::vec> blockCounts(numBlocks);
+  std::vector<ModelMatType> blockMeans(numBlocks);
+  std::vector<ModelMatType> blockM2s(numBlocks);
+  #pragma omp parallel for schedule(static, 1) if (numBlocks > 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    // Use incremental algorithm.
-    // Fist, de-normalize probabilities.
-    probabilities *= trainingPoints;
+    const size_t begin = (size_t) b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
 
-    for (size_t j = 0; j < data.n_cols; ++j)
-    {
-      const size_t label = labels[j];
-      ++probabilities[label];
-
-      arma::vec delta = data.col(j) - means.col(label);
-      means.col(label) += delta / probabilities[label];
-      variances.col(label) += delta % (data.col(j) - means.col(label));
-    }
-
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-    {
-      if (probabilities[i] > 2)
-        variances.col(i) /= (probabilities[i] - 1);
-    }
-  }
-  else
-  {
-    // Set all parameters to zero.
-    probabilities.zeros();
-    means.zeros();
-    variances.zeros();
-
-    // Don't use incremental algorithm.  This is a two-pass algorithm.  It is
-    // possible to calculate the means and variances using a faster one-pass
-    // algorithm but there are some precision and stability issues.  If this is
-    // too slow, it's an option to use the faster algorithm by default and then
-    // have this (and the incremental algorithm) be other options.
+    arma::vec& counts = blockCounts[b];
+    ModelMatType& blockMean = blockMeans[b];
+    ModelMatType& blockM2 = blockM2s[b];
+    counts.zeros(numClasses);
+    blockMean.zeros(data.n_rows, numClasses);
+    blockM2.zeros(data.n_rows, numClasses);
 
     // Calculate the means.
-    for (size_t j = 0; j < data.n_cols; ++j)
+    for (size_t j = begin; j < end; ++j)
     {
       const size_t label = labels[j];
-      ++probabilities[label];
-      means.col(label) += data.col(j);
+      ++counts[label];
+      blockMean.col(label) += data.col(j);
     }
 
-    // Normalize means.
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-      if (probabilities[i] != 0.0)
-        means.col(i) /= probabilities[i];
+    for (size_t i = 0; i < numClasses; ++i)
+      if (counts[i] != 0.0)
+        blockMean.col(i) /= counts[i];
 
-    // Calculate variances.
-    for (size_t j = 0; j < data.n_cols; ++j)
+    // Calculate the sums of squared deviations.
+    for (size_t j = begin; j < end; ++j)
     {
       const size_t label = labels[j];
-      variances.col(label) += square(data.col(j) - means.col(label));
+      blockM2.col(label) += square(data.col(j) - blockMean.col(label));
     }
+  }
 
-    // Normalize variances.
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-      if (probabilities[i] > 1)
-        variances.col(i) /= (probabilities[i] - 1);
+  for (size_t b = 1; b < numBlocks; ++b)
+  {
+    MergeStatistics(blockCounts[0], blockMeans[0], blockM2s[0], blockCounts[b],
+        blockMeans[b], blockM2s[b]);
   }
 
-  // Add epsilon to prevent log of zero.
-  variances += epsilon;
+  arma::vec counts = std::move(blockCounts[0]);
+  ModelMatType m2 = std::move(blockM2s[0]);
+  if (incremental && trainingPoints > 0)
+  {
+    // Recover the statistics of the current model, and merge the new ones
+    // into them.
+    arma::vec modelCounts = arma::round(arma::conv_to<arma::vec>::from(
+        probabilities) * trainingPoints);
+    ModelMatType modelM2 = variances;
+    for (size_t i = 0; i < numClasses; ++i)
+      modelM2.col(i) *= (modelCounts[i] > 1) ? (modelCounts[i] - 1) : 0.0;
+
+    MergeStatistics(modelCounts, means, modelM2, counts, blockMeans[0], m2);
+    counts = std::move(modelCounts);
+    m2 = std::move(modelM2);
+  }
+  else
+  {
+    means = std::move(blockMeans[0]);
+  }
 
-  probabilities /= data.n_cols;
-  trainingPoints += data.n_cols;
+  // Normalize the variances and the probabilities.
+  variances = std::move(m2);
+  for (size_t i = 0; i < numClasses; ++i)
+  {
+    if (counts[i] > 1)
+      variances.col(i) /= (counts[i] - 1);
+    else
+      variances.col(i).zeros();
+  }
+
+  const double totalPoints = arma::accu(counts);
+  if (totalPoints > 0)
+    probabilities = arma::conv_to<ModelMatType>::from(counts / totalPoints);
+  trainingPoints = (size_t) totalPoints;
 }
 
 template<typename ModelMatType>
@@ -210,23 +217,44 @@ void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
       "NaiveBayesClassifier: element type of given data must match the element "
       "type of the model!");
 
-  logLikelihoods = arma::log(arma::repmat(probabilities, 1, data.n_cols));
-  ModelMatType invVar = 1.0 / variances;
-
-  // Calculate the joint log likelihood of point for each of the
-  // means.n_cols.
+  // This is an adaptation of gmm::phi() for the case where the covariance is
+  // a diagonal matrix.  Expanding the square of (x - mu) in the exponent, the
+  // log likelihoods of all the points and classes are given by two matrix
+  // products with the whole data, plus a constant for each class:
+  //   log p(x | y) = (mu / var)^T x - 0.5 (1 / var)^T (x % x)
+  //       - 0.5 (d log(2 pi) + sum(log(var)) + sum(mu % mu / var)).
+  // Epsilon is added to the variances to prevent log of zero.
+  const ModelMatType invVar = 1.0 / (variances + epsilon);
+  logLikelihoods = (means % invVar).t() * data -
+      0.5 * invVar.t() * (data % data);
+
+  const ModelMatType constants = arma::log(probabilities) -
+      0.5 * (data.n_rows * log(2 * M_PI) + arma::sum(arma::log(variances +
+      epsilon) + means % means % invVar, 0).t());
+  logLikelihoods.each_col() += constants;
+}
 
-  // Loop over every class.
-  for (size_t i = 0; i < means.n_cols; ++i)
+template<typename ModelMatType>
+void NaiveBayesClassifier<ModelMatType>::MergeStatistics(
+    arma::vec& counts,
+    ModelMatType& means,
+    ModelMatType& m2,
+    const arma::vec& otherCounts,
+    const ModelMatType& otherMeans,
+    const ModelMatType& otherM2)
+{
+  // This is the pairwise update of Chan, Golub and LeVeque.
+  for (size_t i = 0; i < counts.n_elem; ++i)
   {
-    // This is an adaptation of gmm::phi() for the case where the covariance is
-    // a diagonal matrix.
-    ModelMatType diffs = data - arma::repmat(means.col(i), 1, data.n_cols);
-    ModelMatType rhs = -0.5 * arma::diagmat(invVar.col(i)) * diffs;
-    arma::Mat<ElemType> exponents = arma::sum(diffs % rhs, 0);
-
-    logLikelihoods.row(i) += (data.n_rows / -2.0 * log(2 * M_PI) - 0.5 *
-        arma::accu(arma::log(variances.col(i))) + exponents);
+    if (otherCounts[i] == 0.0)
+      continue;
+
+    const double total = counts[i] + otherCounts[i];
+    const arma::Col<ElemType> delta = otherMeans.col(i) - means.col(i);
+    means.col(i) += (otherCounts[i] / total) * delta;
+    m2.col(i) += otherM2.col(i) +
+        (counts[i] * otherCounts[i] / total) * (delta % delta);
+    counts[i] = total;
   }
 }
 
@@ -162,12 +162,32 @@ class SoftmaxErrorFunction
    *
    * This will update last_coordinates_ and stretched_dataset_, and also
    * calculate the p_i and denominators_ which are used in the calculation of
-   * p_i or p_ij.  The calculation will be O((n * (n + 1)) / 2), which is not
-   * great.
+   * p_i or p_ij.  The calculation will be O(n^2), which is not great, but it
+   * is done in parallel blocks of points.
    *
    * @param coordinates Coordinates matrix to use for precalculation.
    */
   void Precalculate(const arma::mat& coordinates);
+
+  //! Get the number of points whose kernel values are computed at once.
+  size_t BlockSize() const;
+
+  /**
+   * Compute exp(-D(A x_k, A x_i)) for every point k of the stretched dataset
+   * and every point i in [begin, end), with 0 when k == i.  For the squared
+   * Euclidean distance, all the distances of the block are computed with one
+   * matrix multiplication.
+   *
+   * @param begin First point of the block.
+   * @param end One past the last point of the block.
+   * @param squaredNorms Squared norms of the points of the stretched dataset.
+   * @param kernel Matrix to store the values in, with one column for each
+   *     point of the block.
+   */
+  void SoftmaxKernel(const size_t begin,
+                     const size_t end,
+                     const arma::rowvec& squaredNorms,
+                     arma::mat& kernel);
 };
 
 } // namespace nca
@@ -68,42 +68,57 @@ double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates,
 {
   // Unfortunately each evaluation will take O(N) time because it requires a
   // scan over all points in the dataset.  Our objective is to compute p_i.
-  double denominator = 0;
-  double numerator = 0;
   double result = 0;
 
   // It's quicker to do this now than one point at a time later.
   stretchedDataset = coordinates * dataset;
-  for (size_t i = begin; i < begin + batchSize; ++i)
-  {
-    for (size_t k = 0; k < dataset.n_cols; ++k)
-    {
-      // Don't consider the case where the points are the same.
-      if (k == i)
-        continue;
+  const arma::rowvec squaredNorms = arma::sum(arma::square(stretchedDataset),
+      0);
 
-      // We want to evaluate exp(-D(A x_i, A x_k)).
-      double eval = std::exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                              stretchedDataset.unsafe_col(k)));
+  const size_t blockSize = BlockSize();
+  const size_t numBlocks = (batchSize + blockSize - 1) / blockSize;
 
-      // If they are in the same class, update the numerator.
-      if (labels[i] == labels[k])
-        numerator += eval;
-
-      denominator += eval;
-    }
+  #pragma omp parallel reduction(+:result)
+  {
+    arma::mat kernel;
 
-    // Now the result is just a simple division, but we have to be sure that the
-    // denominator is not 0.
-    if (denominator == 0.0)
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
     {
-      Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
-      continue;
-    }
+      const size_t blockBegin = begin + b * blockSize;
+      const size_t blockEnd = std::min(blockBegin + blockSize,
+          begin + batchSize);
+      SoftmaxKernel(blockBegin, blockEnd, squaredNorms, kernel);
 
-    result += -(numerator / denominator); // Negate because the optimizer is a
-                                          // minimizer.
+      for (size_t i = blockBegin; i < blockEnd; ++i)
+      {
+        // The kernel holds exp(-D(A x_i, A x_k)) for every k.  If x_k is in
+        // the same class, it adds to the numerator.
+        const double* eval = kernel.colptr(i - blockBegin);
+        double numerator = 0;
+        double denominator = 0;
+        for (size_t k = 0; k < dataset.n_cols; ++k)
+        {
+          if (labels[i] == labels[k])
+            numerator += eval[k];
+          denominator += eval[k];
+        }
+
+        // Now the result is just a simple division, but we have to be sure
+        // that the denominator is not 0.
+        if (denominator == 0.0)
+        {
+          #pragma omp critical
+          Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
+          continue;
+        }
+
+        result += -(numerator / denominator); // Negate because the optimizer
+                                              // is a minimizer.
+      }
+    }
   }
+
   return result;
 }
 
@@ -119,36 +134,63 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
   //   sum_i (p_i sum_k (p_ik x_ik x_ik^T) -
   //       sum_{j in class of i} (p_ij x_ij x_ij^T)
   // We can algebraically manipulate the whole thing to produce a more
-  // memory-friendly way to calculate this.  Looping over each i and k (again
-  // O((n * (n + 1)) / 2) as with the last step, we can add the following to the
-  // sum:
+  // memory-friendly way to calculate this.  Summing over each pair i < k, we
+  // can add the following weight times x_ik x_ik^T to the sum:
   //
-  //   if class of i is the same as the class of k, add
-  //     (((p_i - (1 / p_i)) p_ik) + ((p_k - (1 / p_k)) p_ki)) x_ik x_ik^T
-  //   otherwise, add
-  //     (p_i p_ik + p_k p_ki) x_ik x_ik^T
+  //   if class of i is the same as the class of k,
+  //     w_ik = ((p_i - 1) p_ik) + ((p_k - 1) p_ki)
+  //   otherwise,
+  //     w_ik = (p_i p_ik + p_k p_ki)
+  //
+  // Since w is symmetric, the sum over pairs of w_ik x_ik x_ik^T is
+  // X (D - W) X^T, where D is the diagonal matrix of the sums of the rows of
+  // W.  So the weights of a block of points against all points are computed at
+  // once, and their contribution is added with matrix multiplications.
+  const size_t n = stretchedDataset.n_cols;
+  const arma::rowvec squaredNorms = arma::sum(arma::square(stretchedDataset),
+      0);
+
+  const size_t blockSize = BlockSize();
+  const size_t numBlocks = (n + blockSize - 1) / blockSize;
+
   arma::mat sum;
-  sum.zeros(stretchedDataset.n_rows, stretchedDataset.n_rows);
-  for (size_t i = 0; i < stretchedDataset.n_cols; ++i)
+  sum.zeros(dataset.n_rows, dataset.n_rows);
+
+  #pragma omp parallel
   {
-    for (size_t k = (i + 1); k < stretchedDataset.n_cols; ++k)
+    arma::mat kernel;
+    arma::mat threadSum(dataset.n_rows, dataset.n_rows, arma::fill::zeros);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
     {
-      // Calculate p_ik and p_ki first.
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(k)));
-      double p_ik = 0, p_ki = 0;
-      p_ik = eval / denominators(i);
-      p_ki = eval / denominators(k);
-
-      // Subtract x_i from x_k.  We are not using stretched points here.
-      arma::vec x_ik = dataset.col(i) - dataset.col(k);
-      arma::mat secondTerm = (x_ik * trans(x_ik));
-
-      if (labels[i] == labels[k])
-        sum += ((p[i] - 1) * p_ik + (p[k] - 1) * p_ki) * secondTerm;
-      else
-        sum += (p[i] * p_ik + p[k] * p_ki) * secondTerm;
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize, n);
+      SoftmaxKernel(begin, end, squaredNorms, kernel);
+
+      // Turn the kernel into the weights.
+      for (size_t i = begin; i < end; ++i)
+      {
+        double* w = kernel.colptr(i - begin);
+        for (size_t k = 0; k < n; ++k)
+        {
+          const double p_ik = w[k] / denominators(i);
+          const double p_ki = w[k] / denominators(k);
+          if (labels[i] == labels[k])
+            w[k] = (p[i] - 1) * p_ik + (p[k] - 1) * p_ki;
+          else
+            w[k] = p[i] * p_ik + p[k] * p_ki;
+        }
+      }
+
+      // We are not using stretched points here.
+      const arma::mat blockPoints = dataset.cols(begin, end - 1);
+      threadSum += blockPoints * arma::diagmat(arma::sum(kernel, 0)) *
+          blockPoints.t() - blockPoints * (dataset * kernel).t();
     }
+
+    #pragma omp critical
+    sum += threadSum;
   }
 
   // Assemble the final gradient.
@@ -163,72 +205,95 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
                                                 GradType& gradient,
                                                 const size_t batchSize)
 {
-  // The gradient involves two matrix terms which are eventually combined into
-  // one.
-  GradType firstTerm, secondTerm;
-  // We will need to calculate p_i before this evaluation is done, so
-  // these two variables will hold the information necessary for that.
-  double numerator, denominator;
-
-  gradient.zeros(coordinates.n_rows, coordinates.n_rows);
+  // For each point i of the batch, the gradient is
+  //   -2 A (p_i sum_k (p_ik x_ik x_ik^T) -
+  //       sum_{j in class of i} (p_ij x_ij x_ij^T)),
+  // so it is a weighted sum of x_ik x_ik^T with weights
+  //   c_ik = p_ik (p_i - [class of i is the class of k]).
+  // The sum of c_ik x_ik x_ik^T over the batch is
+  //   sum_i r_i x_i x_i^T - X_b C^T X^T - X C X_b^T + X diag(s) X^T,
+  // where C holds the weights of the batch (one column per point i), X_b the
+  // points of the batch, r_i the sum of the weights of point i, and s_k the
+  // sum of the weights of point k over the batch.
+  const size_t n = dataset.n_cols;
 
   // Compute the stretched dataset.
   stretchedDataset = coordinates * dataset;
-  for (size_t i = begin; i < begin + batchSize; ++i)
-  {
-    numerator = 0;
-    denominator = 0;
+  const arma::rowvec squaredNorms = arma::sum(arma::square(stretchedDataset),
+      0);
+
+  const size_t blockSize = BlockSize();
+  const size_t numBlocks = (batchSize + blockSize - 1) / blockSize;
 
-    firstTerm.zeros(coordinates.n_rows, coordinates.n_cols);
-    secondTerm.zeros(coordinates.n_rows, coordinates.n_cols);
+  arma::mat sum;
+  sum.zeros(dataset.n_rows, dataset.n_rows);
+  arma::vec weightSums(n, arma::fill::zeros);
 
-    for (size_t k = 0; k < dataset.n_cols; ++k)
+  #pragma omp parallel
+  {
+    arma::mat kernel;
+    arma::mat threadSum(dataset.n_rows, dataset.n_rows, arma::fill::zeros);
+    arma::vec threadWeightSums(n, arma::fill::zeros);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
     {
-      // Don't consider the case where the points are the same.
-      if (i == k)
-        continue;
-
-      // Calculate the numerator of p_ik.
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(k)));
-
-      // If the points are in the same class, we must add to the second term of
-      // the gradient as well as the numerator of p_i.  We will divide by the
-      // denominator of p_ik later.  For x_ik we are not using stretched points.
-      GradType x_ik = dataset.col(i) - dataset.col(k);
-      if (labels[i] == labels[k])
+      const size_t blockBegin = begin + b * blockSize;
+      const size_t blockEnd = std::min(blockBegin + blockSize,
+          begin + batchSize);
+      SoftmaxKernel(blockBegin, blockEnd, squaredNorms, kernel);
+
+      for (size_t i = blockBegin; i < blockEnd; ++i)
       {
-        numerator += eval;
-        secondTerm += eval * x_ik * trans(x_ik);
+        // We will need to calculate p_i before the weights can be computed.
+        double* c = kernel.colptr(i - blockBegin);
+        double numerator = 0;
+        double denominator = 0;
+        for (size_t k = 0; k < n; ++k)
+        {
+          if (labels[i] == labels[k])
+            numerator += c[k];
+          denominator += c[k];
+        }
+
+        if (denominator == 0)
+        {
+          #pragma omp critical
+          Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
+          // If the denominator is zero, then all p_ik should be zero and there
+          // is no gradient contribution from this point.
+          continue;
+        }
+
+        const double p_i = numerator / denominator;
+        for (size_t k = 0; k < n; ++k)
+        {
+          c[k] /= denominator;
+          c[k] *= (labels[i] == labels[k]) ? (p_i - 1) : p_i;
+        }
       }
 
-      // We always have to add to the denominator of p_i
-      // and the first term of the gradient computation.
-      // We will divide by the denominator of p_ik later.
-      denominator += eval;
-      firstTerm += eval * x_ik * trans(x_ik);
+      // For x_ik we are not using stretched points.
+      const arma::mat blockPoints = dataset.cols(blockBegin, blockEnd - 1);
+      const arma::mat weighted = dataset * kernel;
+      threadSum += blockPoints * arma::diagmat(arma::sum(kernel, 0)) *
+          blockPoints.t() - blockPoints * weighted.t() -
+          weighted * blockPoints.t();
+      threadWeightSums += arma::sum(kernel, 1);
     }
 
-    // Calculate p_i.
-    double p = 0;
-    if (denominator == 0)
+    #pragma omp critical
     {
-      Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
-      // If the denominator is zero, then all p_ik should be zero and there is
-      // no gradient contribution from this point.
-      continue;
+      sum += threadSum;
+      weightSums += threadWeightSums;
     }
-    else
-    {
-      p = numerator / denominator;
-      firstTerm /= denominator;
-      secondTerm /= denominator;
-    }
-
-    // Now multiply the first term by p_i, and add the two together and multiply
-    // all by 2 * A.  We negate it though, because our optimizer is a minimizer.
-    gradient += -2 * coordinates * (p * firstTerm - secondTerm);
   }
+
+  sum += dataset * arma::diagmat(weightSums) * dataset.t();
+
+  // Multiply all by 2 * A.  We negate it though, because our optimizer is a
+  // minimizer.
+  gradient = -2 * coordinates * sum;
 }
 
 template<typename MetricType>
@@ -261,27 +326,41 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
   //   p_ij = exp( -K(x_i, x_j) ) / ( sum_{k != i} ( exp( -K(x_i, x_k) )))
   //   p_i = sum_{j in class of i} p_ij
   // We will do this by keeping track of the denominators for each i as well as
-  // the numerators (the sum for all j in class of i).  This will be on the
-  // order of O((n * (n + 1)) / 2), which really isn't all that great.
-  p.zeros(stretchedDataset.n_cols);
-  denominators.zeros(stretchedDataset.n_cols);
-  for (size_t i = 0; i < stretchedDataset.n_cols; ++i)
+  // the numerators (the sum for all j in class of i).  The kernel values of a
+  // block of points against all points are computed at once, and the blocks
+  // are processed in parallel; this is O(n^2) work, but only O(n) memory for
+  // each block.
+  const size_t n = stretchedDataset.n_cols;
+  const arma::rowvec squaredNorms = arma::sum(arma::square(stretchedDataset),
+      0);
+
+  const size_t blockSize = BlockSize();
+  const size_t numBlocks = (n + blockSize - 1) / blockSize;
+
+  p.zeros(n);
+  denominators.zeros(n);
+
+  #pragma omp parallel
   {
-    for (size_t j = (i + 1); j < stretchedDataset.n_cols; ++j)
-    {
-      // Evaluate exp(-d(x_i, x_j)).
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(j)));
+    arma::mat kernel;
 
-      // Add this to the denominators of both p_i and p_j: K(i, j) = K(j, i).
-      denominators[i] += eval;
-      denominators[j] += eval;
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize, n);
+      SoftmaxKernel(begin, end, squaredNorms, kernel);
 
-      // If i and j are the same class, add to numerator of both.
-      if (labels[i] == labels[j])
+      for (size_t i = begin; i < end; ++i)
       {
-        p[i] += eval;
-        p[j] += eval;
+        // If i and j are the same class, add to the numerator.
+        const double* eval = kernel.colptr(i - begin);
+        for (size_t j = 0; j < n; ++j)
+        {
+          denominators[i] += eval[j];
+          if (labels[i] == labels[j])
+            p[i] += eval[j];
+        }
       }
     }
   }
@@ -306,6 +385,54 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
   precalculated = true;
 }
 
+template<typename MetricType>
+size_t SoftmaxErrorFunction<MetricType>::BlockSize() const
+{
+  // Keep the kernel of a block (one column of all points for each point of the
+  // block) at about 32MB, so that it fits in memory for every thread even for
+  // large datasets.
+  const size_t maxBlockSize = 256;
+  const size_t maxElements = 4194304;
+  return std::max((size_t) 1, std::min(maxBlockSize,
+      maxElements / std::max((size_t) 1, (size_t) dataset.n_cols)));
+}
+
+template<typename MetricType>
+void SoftmaxErrorFunction<MetricType>::SoftmaxKernel(
+    const size_t begin,
+    const size_t end,
+    const arma::rowvec& squaredNorms,
+    arma::mat& kernel)
+{
+  if (std::is_same<MetricType, metric::SquaredEuclideanDistance>::value)
+  {
+    // Use ||x_k - x_i||^2 = ||x_k||^2 + ||x_i||^2 - 2 <x_k, x_i>, so that the
+    // distances of the whole block are one matrix multiplication.  Rounding
+    // can make a distance slightly negative, so clamp it.
+    kernel = stretchedDataset.t() * stretchedDataset.cols(begin, end - 1);
+    kernel *= -2.0;
+    kernel.each_col() += squaredNorms.t();
+    kernel.each_row() += squaredNorms.subvec(begin, end - 1);
+    kernel = arma::exp(-arma::clamp(kernel, 0.0, DBL_MAX));
+  }
+  else
+  {
+    kernel.set_size(stretchedDataset.n_cols, end - begin);
+    for (size_t i = begin; i < end; ++i)
+    {
+      for (size_t k = 0; k < stretchedDataset.n_cols; ++k)
+      {
+        kernel(k, i - begin) = std::exp(-metric.Evaluate(
+            stretchedDataset.unsafe_col(k), stretchedDataset.unsafe_col(i)));
+      }
+    }
+  }
+
+  // Don't consider the case where the points are the same.
+  for (size_t i = begin; i < end; ++i)
+    kernel(i, i - begin) = 0.0;
+}
+
 } // namespace nca
 } // namespace mlpack
 
@@ -0,0 +1,130 @@
+/**
+ * @file methods/neighbor_search/distributed_neighbor_search.hpp
+ *
+ * Defines the DistributedNeighborSearch class, which performs exact
+ * k-neighbor search on a reference set sharded over several processes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_DISTRIBUTED_NEIGHBOR_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_DISTRIBUTED_NEIGHBOR_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/distributed/local_communicator.hpp>
+#include <mlpack/core/distributed/mpi_communicator.hpp>
+
+#include "neighbor_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The DistributedNeighborSearch class searches the k nearest (or furthest)
+ * neighbors in a reference set of which each process of a group holds one
+ * shard, for reference sets that do not fit on one machine.  Each process
+ * builds a NeighborSearch object (and its tree) on its own shard; a search
+ * finds the k best neighbors of the queries in every shard, and the lists of
+ * all the processes are merged so that every process gets the k best
+ * neighbors over the whole reference set.
+ *
+ * The indices of the neighbors refer to the concatenation of the shards in the
+ * order of the ranks of the processes: the points of the shard of process r
+ * have the indices Offset() to Offset() + shard.n_cols - 1 of that process.
+ *
+ * Every process of the group must build the object and call Search() with the
+ * same parameters and the same query set (which can be sent from one process
+ * with the Broadcast() function of the communicator).
+ *
+ * @code
+ * distributed::MPICommunicator comm;
+ * DistributedNeighborSearch<distributed::MPICommunicator> knn(comm,
+ *     std::move(shard));
+ *
+ * comm.Broadcast(queries, 0);
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * knn.Search(queries, 10, neighbors, distances);
+ * @endcode
+ *
+ * @tparam CommunicatorType Type of communicator between the processes
+ *     (distributed::MPICommunicator, or distributed::LocalCommunicator for a
+ *     single process).
+ * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ * @tparam MetricType The metric to use for computation.
+ * @tparam MatType The type of data matrix.
+ * @tparam TreeType The tree type to build on each shard.
+ */
+template<typename CommunicatorType,
+         typename SortPolicy = NearestNeighborSort,
+         typename MetricType = mlpack::metric::EuclideanDistance,
+         typename MatType = arma::mat,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::KDTree>
+class DistributedNeighborSearch
+{
+ public:
+  //! The type of the search object of each shard.
+  typedef NeighborSearch<SortPolicy, MetricType, MatType, TreeType> SearchType;
+
+  /**
+   * Build the search object on the shard of this process.  The communicator is
+   * kept by reference and must outlive the object.
+   *
+   * @param communicator Communicator between the processes.
+   * @param shard Reference points held by this process.
+   * @param mode Search mode of each shard.
+   * @param epsilon Relative approximation error of each shard.
+   * @param metric Metric to use.
+   */
+  DistributedNeighborSearch(CommunicatorType& communicator,
+                            MatType shard,
+                            const NeighborSearchMode mode = DUAL_TREE_MODE,
+                            const double epsilon = 0,
+                            const MetricType metric = MetricType());
+
+  /**
+   * Find the k best neighbors of each query in the whole reference set.  The
+   * results are the same in every process.
+   *
+   * @param querySet Set of query points (the same in every process).
+   * @param k Number of neighbors to find.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances to the neighbors in.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  //! Get the index of the first point of the shard of this process.
+  size_t Offset() const { return offset; }
+  //! Get the number of reference points over all the processes.
+  size_t NumReferencePoints() const { return numReferencePoints; }
+
+  //! Get the search object of the shard of this process.
+  const SearchType& LocalSearch() const { return search; }
+
+ private:
+  //! The communicator between the processes.
+  CommunicatorType& communicator;
+  //! The search object of the shard of this process.
+  SearchType search;
+  //! The number of points of the shard of this process.
+  size_t shardSize;
+  //! The index of the first point of the shard of this process.
+  size_t offset;
+  //! The number of reference points over all the processes.
+  size_t numReferencePoints;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "distributed_neighbor_search_impl.hpp"
+
+#endif
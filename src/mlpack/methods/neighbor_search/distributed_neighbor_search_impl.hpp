@@ -0,0 +1,128 @@
+/**
+ * @file methods/neighbor_search/distributed_neighbor_search_impl.hpp
+ *
+ * Implementation of the DistributedNeighborSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_DISTRIBUTED_NEIGHBOR_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_DISTRIBUTED_NEIGHBOR_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "distributed_neighbor_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename CommunicatorType,
+         typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+DistributedNeighborSearch<CommunicatorType, SortPolicy, MetricType, MatType,
+    TreeType>::
+DistributedNeighborSearch(CommunicatorType& communicator,
+                          MatType shard,
+                          const NeighborSearchMode mode,
+                          const double epsilon,
+                          const MetricType metric) :
+    communicator(communicator),
+    search(mode, epsilon, metric),
+    shardSize(shard.n_cols),
+    offset(0),
+    numReferencePoints(0)
+{
+  // A process may hold no points; it then takes no part in the searches.
+  if (shardSize > 0)
+    search.Train(std::move(shard));
+
+  std::vector<size_t> shardSizes;
+  communicator.AllGather(shardSize, shardSizes);
+  for (size_t i = 0; i < shardSizes.size(); ++i)
+  {
+    if (i < communicator.Rank())
+      offset += shardSizes[i];
+    numReferencePoints += shardSizes[i];
+  }
+}
+
+template<typename CommunicatorType,
+         typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void DistributedNeighborSearch<CommunicatorType, SortPolicy, MetricType,
+    MatType, TreeType>::
+Search(const MatType& querySet,
+       const size_t k,
+       arma::Mat<size_t>& neighbors,
+       arma::mat& distances)
+{
+  if (k > numReferencePoints)
+  {
+    Log::Fatal << "DistributedNeighborSearch::Search(): requested value of k ("
+        << k << ") is greater than the number of points in the reference set ("
+        << numReferencePoints << ")" << std::endl;
+  }
+
+  // Search the shard of this process, and give global indices to the results.
+  const size_t localK = std::min(k, shardSize);
+  arma::Mat<size_t> localNeighbors;
+  arma::mat localDistances;
+  if (localK > 0)
+  {
+    search.Search(querySet, localK, localNeighbors, localDistances);
+    localNeighbors += offset;
+  }
+
+  std::vector<arma::Mat<size_t>> allNeighbors;
+  std::vector<arma::mat> allDistances;
+  communicator.AllGather(localNeighbors, allNeighbors);
+  communicator.AllGather(localDistances, allDistances);
+
+  // Merge the candidates of all the processes, and keep the k best.  Ties are
+  // broken by index, so that every process gets the same results.
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  std::vector<std::pair<double, size_t>> candidates;
+  for (size_t q = 0; q < querySet.n_cols; ++q)
+  {
+    candidates.clear();
+    for (size_t p = 0; p < allNeighbors.size(); ++p)
+    {
+      for (size_t i = 0; i < allNeighbors[p].n_rows; ++i)
+      {
+        candidates.push_back(std::make_pair(allDistances[p](i, q),
+            allNeighbors[p](i, q)));
+      }
+    }
+
+    std::partial_sort(candidates.begin(), candidates.begin() + k,
+        candidates.end(),
+        [](const std::pair<double, size_t>& a,
+           const std::pair<double, size_t>& b) -> bool
+        {
+          if (a.first == b.first)
+            return a.second < b.second;
+          return SortPolicy::IsBetter(a.first, b.first);
+        });
+
+    for (size_t i = 0; i < k; ++i)
+    {
+      distances(i, q) = candidates[i].first;
+      neighbors(i, q) = candidates[i].second;
+    }
+  }
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,327 @@
+/**
+ * @file methods/neighbor_search/hnsw.hpp
+ *
+ * Defines the HNSW class, an index for approximate k-nearest-neighbor search
+ * based on a hierarchical navigable small world graph.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_HNSW_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_HNSW_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+#include "sort_policies/nearest_neighbor_sort.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The HNSW class is an index for approximate k-nearest-neighbor search with a
+ * hierarchical navigable small world graph (Malkov and Yashunin, 2018).  Each
+ * point is linked to nearby points on a random number of levels; the upper
+ * levels hold exponentially fewer points, so a search descends greedily from
+ * the top level to find a good entry point, and then explores the bottom level
+ * with a beam of ef candidates.  Unlike trees, the cost of a search grows
+ * slowly with the dimensionality of the data, which makes HNSW suited to
+ * high-dimensional embeddings.
+ *
+ * Any metric with an Evaluate() function can be used; for cosine distance,
+ * use metric::IPMetric<kernel::CosineDistance>, whose distance is a monotone
+ * function of the cosine distance.
+ *
+ * Points are inserted in parallel, in batches: the points of a batch search
+ * the graph built so far at the same time and choose their links, and then
+ * the reverse links are added, grouped by point, so no locks are needed.  Each
+ * batch is a fraction of the points already inserted, so the graph each point
+ * sees is nearly complete.  Queries are also searched in parallel.
+ *
+ * @code
+ * extern arma::mat referenceSet, querySet;
+ *
+ * HNSW<> hnsw(referenceSet);
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * hnsw.Search(querySet, 10, neighbors, distances);
+ * @endcode
+ *
+ * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ * @tparam MetricType The metric to use for computation.
+ * @tparam MatType The type of data matrix.
+ */
+template<typename SortPolicy = NearestNeighborSort,
+         typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat>
+class HNSW
+{
+ public:
+  /**
+   * Build the index on the given reference set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param m Number of links of each point on the upper levels (there are
+   *     2 * m on the bottom level).
+   * @param efConstruction Number of candidates explored when inserting a
+   *     point.
+   * @param ef Number of candidates explored when searching (at least k are).
+   * @param metric Instantiated metric.
+   */
+  HNSW(MatType referenceSet,
+       const size_t m = 16,
+       const size_t efConstruction = 200,
+       const size_t ef = 50,
+       const MetricType metric = MetricType());
+
+  /**
+   * Create an empty index with the given parameters.  Call Train() or Insert()
+   * before searching.
+   *
+   * @param m Number of links of each point on the upper levels (there are
+   *     2 * m on the bottom level).
+   * @param efConstruction Number of candidates explored when inserting a
+   *     point.
+   * @param ef Number of candidates explored when searching (at least k are).
+   * @param metric Instantiated metric.
+   */
+  HNSW(const size_t m = 16,
+       const size_t efConstruction = 200,
+       const size_t ef = 50,
+       const MetricType metric = MetricType());
+
+  /**
+   * Build the index on the given reference set, replacing the current one.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Insert the given points into the index.  They are given the indices
+   * following those of the points already in the index.
+   *
+   * @param points Points to insert.
+   */
+  void Insert(const MatType& points);
+
+  /**
+   * For each point in the query set, find approximately the k nearest
+   * neighbors in the reference set.  The results have the same form as those
+   * of NeighborSearch::Search().  If fewer than k neighbors are found for a
+   * query point, the remaining neighbors are set to SIZE_MAX and their
+   * distances to the worst distance of the SortPolicy.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * Find approximately the k nearest neighbors of each point of the reference
+   * set, excluding the point itself, as with NeighborSearch::Search() without a
+   * query set.
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each point.
+   * @param distances Matrix storing distances of neighbors for each point.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  //! Get the reference set.
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+  //! Get the number of links of each point on the upper levels.
+  size_t M() const { return m; }
+  //! Get the number of candidates explored when inserting a point.
+  size_t EfConstruction() const { return efConstruction; }
+  //! Modify the number of candidates explored when inserting a point.
+  size_t& EfConstruction() { return efConstruction; }
+  //! Get the number of candidates explored when searching.
+  size_t Ef() const { return ef; }
+  //! Modify the number of candidates explored when searching.
+  size_t& Ef() { return ef; }
+
+  //! Get the number of levels of the graph.
+  size_t NumLevels() const { return links.empty() ? 0 : maxLevel + 1; }
+  //! Get the level of the given point (the highest level it is linked on).
+  size_t Level(const size_t point) const { return links[point].size() - 1; }
+  //! Get the links of the given point on the given level.
+  const std::vector<size_t>& Links(const size_t point, const size_t level) const
+  {
+    return links[point][level];
+  }
+
+  //! Get the number of distance evaluations of the last search.
+  size_t BaseCases() const { return baseCases; }
+
+  //! Access the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+  //! Serialize the index.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Candidate represents a possible candidate neighbor (distance, index).
+  typedef std::pair<double, size_t> Candidate;
+
+  //! Compare two candidates based on the distance; the worse candidate is
+  //! "larger", so a priority queue holds the worst candidate on top.
+  struct CandidateCmp
+  {
+    bool operator()(const Candidate& c1, const Candidate& c2) const
+    {
+      return !SortPolicy::IsBetter(c2.first, c1.first);
+    }
+  };
+
+  //! Compare two candidates so that a priority queue holds the best candidate
+  //! on top.
+  struct ReverseCandidateCmp
+  {
+    bool operator()(const Candidate& c1, const Candidate& c2) const
+    {
+      return !SortPolicy::IsBetter(c1.first, c2.first);
+    }
+  };
+
+  //! A link from a new point that is added to the lists of an older point.
+  struct ReverseLink
+  {
+    size_t target;
+    size_t level;
+    size_t source;
+
+    bool operator<(const ReverseLink& other) const
+    {
+      if (target != other.target)
+        return target < other.target;
+      if (level != other.level)
+        return level < other.level;
+      return source < other.source;
+    }
+  };
+
+  //! The points visited by a search, marked with the number of the search so
+  //! that the marks do not need to be cleared.
+  struct VisitedList
+  {
+    VisitedList(const size_t n) : marks(n, 0), epoch(0) { }
+
+    //! Start a new search.
+    void Reset()
+    {
+      if (++epoch == 0)
+      {
+        std::fill(marks.begin(), marks.end(), 0);
+        epoch = 1;
+      }
+    }
+
+    //! Mark the given point, and return whether it was marked already.
+    bool Visit(const size_t point)
+    {
+      if (marks[point] == epoch)
+        return true;
+      marks[point] = epoch;
+      return false;
+    }
+
+    std::vector<uint32_t> marks;
+    uint32_t epoch;
+  };
+
+  //! Get the maximum number of links of a point on the given level.
+  size_t MaxLinks(const size_t level) const
+  {
+    return (level == 0) ? 2 * m : m;
+  }
+
+  /**
+   * Starting from the given candidate, move greedily to better neighbors on the
+   * given level until none is found, and return the candidate reached.
+   */
+  template<typename VecType>
+  Candidate GreedySearch(const VecType& query,
+                         Candidate entry,
+                         const size_t level,
+                         size_t& evaluations) const;
+
+  /**
+   * Explore the given level from the given entry points with a beam of the
+   * given width, and return the best candidates found (at most beamWidth),
+   * from best to worst.
+   */
+  template<typename VecType>
+  std::vector<Candidate> SearchLevel(const VecType& query,
+                                     const std::vector<Candidate>& entries,
+                                     const size_t beamWidth,
+                                     const size_t level,
+                                     VisitedList& visited,
+                                     size_t& evaluations) const;
+
+  /**
+   * Choose at most maxLinks links among the given candidates (sorted from best
+   * to worst), skipping candidates that are closer to an already chosen link
+   * than to the point itself, so that links cover several directions.
+   */
+  std::vector<size_t> SelectLinks(const std::vector<Candidate>& candidates,
+                                  const size_t maxLinks,
+                                  size_t& evaluations) const;
+
+  /**
+   * Link the points of the reference set from the given index on into the
+   * graph.
+   */
+  void Build(const size_t begin);
+
+  /**
+   * Search for neighbors of each query point.  If sameSet is true, the query
+   * set is the reference set and each point is not its own neighbor.
+   */
+  void SearchInternal(const MatType& querySet,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances,
+                      const bool sameSet);
+
+  //! The reference set.
+  MatType referenceSet;
+  //! The number of links of each point on the upper levels.
+  size_t m;
+  //! The number of candidates explored when inserting a point.
+  size_t efConstruction;
+  //! The number of candidates explored when searching.
+  size_t ef;
+  //! The links of each point, on each of its levels.
+  std::vector<std::vector<std::vector<size_t>>> links;
+  //! The point that every search starts from, on the top level.
+  size_t entryPoint;
+  //! The top level of the graph.
+  size_t maxLevel;
+  //! The instantiated metric.
+  MetricType metric;
+  //! The number of distance evaluations of the last search.
+  size_t baseCases;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "hnsw_impl.hpp"
+
+#endif
@@ -0,0 +1,475 @@
+/**
+ * @file methods/neighbor_search/hnsw_impl.hpp
+ *
+ * Implementation of the HNSW class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_HNSW_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_HNSW_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hnsw.hpp"
+
+#include <mlpack/core/math/random.hpp>
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+HNSW<SortPolicy, MetricType, MatType>::HNSW(MatType referenceSet,
+                                            const size_t m,
+                                            const size_t efConstruction,
+                                            const size_t ef,
+                                            const MetricType metric) :
+    HNSW(m, efConstruction, ef, metric)
+{
+  Train(std::move(referenceSet));
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+HNSW<SortPolicy, MetricType, MatType>::HNSW(const size_t m,
+                                            const size_t efConstruction,
+                                            const size_t ef,
+                                            const MetricType metric) :
+    m(m),
+    efConstruction(efConstruction),
+    ef(ef),
+    entryPoint(0),
+    maxLevel(0),
+    metric(metric),
+    baseCases(0)
+{
+  if (m < 2)
+    throw std::invalid_argument("HNSW::HNSW(): m must be at least 2");
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+void HNSW<SortPolicy, MetricType, MatType>::Train(MatType referenceSet)
+{
+  this->referenceSet = std::move(referenceSet);
+  links.clear();
+  entryPoint = 0;
+  maxLevel = 0;
+  Build(0);
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+void HNSW<SortPolicy, MetricType, MatType>::Insert(const MatType& points)
+{
+  if (referenceSet.n_cols > 0)
+  {
+    util::CheckSameDimensionality(points, referenceSet, "HNSW::Insert()",
+        "points");
+  }
+
+  const size_t begin = referenceSet.n_cols;
+  if (begin == 0)
+    referenceSet = points;
+  else
+    referenceSet.insert_cols(begin, points);
+
+  Build(begin);
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+void HNSW<SortPolicy, MetricType, MatType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  util::CheckSameDimensionality(querySet, referenceSet, "HNSW::Search()",
+      "query set");
+  if (k > referenceSet.n_cols)
+  {
+    std::stringstream ss;
+    ss << "HNSW::Search(): requested value of k (" << k << ") is greater "
+        << "than the number of points in the reference set ("
+        << referenceSet.n_cols << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  SearchInternal(querySet, k, neighbors, distances, false);
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+void HNSW<SortPolicy, MetricType, MatType>::Search(
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  if (k >= referenceSet.n_cols)
+  {
+    std::stringstream ss;
+    ss << "HNSW::Search(): requested value of k (" << k << ") must be less "
+        << "than the number of points in the reference set ("
+        << referenceSet.n_cols << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  SearchInternal(referenceSet, k, neighbors, distances, true);
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+template<typename Archive>
+void HNSW<SortPolicy, MetricType, MatType>::serialize(
+    Archive& ar,
+    const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(referenceSet));
+  ar(CEREAL_NVP(m));
+  ar(CEREAL_NVP(efConstruction));
+  ar(CEREAL_NVP(ef));
+  ar(CEREAL_NVP(links));
+  ar(CEREAL_NVP(entryPoint));
+  ar(CEREAL_NVP(maxLevel));
+  ar(CEREAL_NVP(metric));
+
+  if (cereal::is_loading<Archive>())
+    baseCases = 0;
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+template<typename VecType>
+typename HNSW<SortPolicy, MetricType, MatType>::Candidate
+HNSW<SortPolicy, MetricType, MatType>::GreedySearch(
+    const VecType& query,
+    Candidate entry,
+    const size_t level,
+    size_t& evaluations) const
+{
+  bool improved = true;
+  while (improved)
+  {
+    improved = false;
+    const std::vector<size_t>& neighbors = links[entry.second][level];
+    for (size_t j = 0; j < neighbors.size(); ++j)
+    {
+      const double distance = metric.Evaluate(query,
+          referenceSet.col(neighbors[j]));
+      ++evaluations;
+      if (distance != entry.first &&
+          SortPolicy::IsBetter(distance, entry.first))
+      {
+        entry = Candidate(distance, neighbors[j]);
+        improved = true;
+      }
+    }
+  }
+
+  return entry;
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+template<typename VecType>
+std::vector<typename HNSW<SortPolicy, MetricType, MatType>::Candidate>
+HNSW<SortPolicy, MetricType, MatType>::SearchLevel(
+    const VecType& query,
+    const std::vector<Candidate>& entries,
+    const size_t beamWidth,
+    const size_t level,
+    VisitedList& visited,
+    size_t& evaluations) const
+{
+  // The candidates left to expand, best first, and the best candidates found
+  // so far, worst first.
+  std::priority_queue<Candidate, std::vector<Candidate>, ReverseCandidateCmp>
+      frontier;
+  std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp> results;
+
+  visited.Reset();
+  for (size_t i = 0; i < entries.size(); ++i)
+  {
+    visited.Visit(entries[i].second);
+    frontier.push(entries[i]);
+    results.push(entries[i]);
+    if (results.size() > beamWidth)
+      results.pop();
+  }
+
+  while (!frontier.empty())
+  {
+    // Once the best candidate left is worse than all the results, no better
+    // result can be reached.
+    const Candidate current = frontier.top();
+    if (results.size() >= beamWidth && current.first != results.top().first &&
+        SortPolicy::IsBetter(results.top().first, current.first))
+      break;
+    frontier.pop();
+
+    const std::vector<size_t>& neighbors = links[current.second][level];
+    for (size_t j = 0; j < neighbors.size(); ++j)
+    {
+      if (visited.Visit(neighbors[j]))
+        continue;
+
+      const double distance = metric.Evaluate(query,
+          referenceSet.col(neighbors[j]));
+      ++evaluations;
+      if (results.size() < beamWidth || (distance != results.top().first &&
+          SortPolicy::IsBetter(distance, results.top().first)))
+      {
+        frontier.push(Candidate(distance, neighbors[j]));
+        results.push(Candidate(distance, neighbors[j]));
+        if (results.size() > beamWidth)
+          results.pop();
+      }
+    }
+  }
+
+  std::vector<Candidate> found(results.size());
+  for (size_t i = found.size(); i > 0; --i)
+  {
+    found[i - 1] = results.top();
+    results.pop();
+  }
+
+  return found;
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+std::vector<size_t> HNSW<SortPolicy, MetricType, MatType>::SelectLinks(
+    const std::vector<Candidate>& candidates,
+    const size_t maxLinks,
+    size_t& evaluations) const
+{
+  std::vector<size_t> selected;
+  selected.reserve(maxLinks);
+  for (size_t i = 0; i < candidates.size() && selected.size() < maxLinks; ++i)
+  {
+    bool keep = true;
+    for (size_t j = 0; j < selected.size(); ++j)
+    {
+      const double distance = metric.Evaluate(
+          referenceSet.col(candidates[i].second),
+          referenceSet.col(selected[j]));
+      ++evaluations;
+      if (distance != candidates[i].first &&
+          SortPolicy::IsBetter(distance, candidates[i].first))
+      {
+        keep = false;
+        break;
+      }
+    }
+
+    if (keep)
+      selected.push_back(candidates[i].second);
+  }
+
+  return selected;
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+void HNSW<SortPolicy, MetricType, MatType>::Build(const size_t begin)
+{
+  const size_t n = referenceSet.n_cols;
+  if (begin == n)
+    return;
+
+  // Draw the level of each new point from a geometric distribution with
+  // parameter 1 / m.  This is done serially, so that the graph only depends on
+  // the random seed.
+  links.resize(n);
+  const double levelScale = 1.0 / std::log((double) m);
+  for (size_t i = begin; i < n; ++i)
+  {
+    // 1 - Random() is in (0, 1], so the level is finite.
+    const double u = 1.0 - math::Random();
+    links[i].resize((size_t) std::floor(-std::log(u) * levelScale) + 1);
+  }
+
+  size_t next = begin;
+  if (begin == 0)
+  {
+    entryPoint = 0;
+    maxLevel = links[0].size() - 1;
+    next = 1;
+  }
+
+  size_t evaluations = 0;
+  std::vector<ReverseLink> reverseLinks;
+  std::vector<size_t> segments;
+  while (next < n)
+  {
+    // Points are inserted in batches of a fraction of the points already in
+    // the graph.  The points of a batch do not see each other, but they see
+    // nearly all of the graph.
+    const size_t batchSize = std::min(n - next, std::max((size_t) 1,
+        std::min(next / 4, (size_t) 1024)));
+    const size_t batchEnd = next + batchSize;
+
+    // Find the links of each point of the batch.  The graph is only read here,
+    // and each point only writes its own lists, which no other point links to
+    // yet.
+    #pragma omp parallel reduction(+:evaluations)
+    {
+      VisitedList visited(next);
+
+      #pragma omp for schedule(dynamic, 4)
+      for (omp_size_t p = next; p < (omp_size_t) batchEnd; ++p)
+      {
+        const size_t level = links[p].size() - 1;
+        Candidate entry(metric.Evaluate(referenceSet.col(p),
+            referenceSet.col(entryPoint)), entryPoint);
+        ++evaluations;
+        for (size_t l = maxLevel; l > level; --l)
+          entry = GreedySearch(referenceSet.col(p), entry, l, evaluations);
+
+        std::vector<Candidate> entries(1, entry);
+        for (size_t l = std::min(level, maxLevel) + 1; l > 0; --l)
+        {
+          std::vector<Candidate> found = SearchLevel(referenceSet.col(p),
+              entries, efConstruction, l - 1, visited, evaluations);
+          links[p][l - 1] = SelectLinks(found, MaxLinks(l - 1), evaluations);
+          entries = std::move(found);
+        }
+      }
+    }
+
+    // Group the reverse links by the point they are added to, so that the
+    // lists of each point are only changed by one thread.
+    reverseLinks.clear();
+    for (size_t p = next; p < batchEnd; ++p)
+    {
+      for (size_t l = 0; l < links[p].size(); ++l)
+      {
+        for (size_t j = 0; j < links[p][l].size(); ++j)
+          reverseLinks.push_back(ReverseLink{ links[p][l][j], l, p });
+      }
+    }
+    std::sort(reverseLinks.begin(), reverseLinks.end());
+
+    segments.clear();
+    for (size_t r = 0; r < reverseLinks.size(); ++r)
+    {
+      if (r == 0 || reverseLinks[r].target != reverseLinks[r - 1].target)
+        segments.push_back(r);
+    }
+    segments.push_back(reverseLinks.size());
+
+    #pragma omp parallel reduction(+:evaluations)
+    {
+      std::vector<Candidate> candidates;
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t s = 0; s < (omp_size_t) segments.size() - 1; ++s)
+      {
+        const size_t target = reverseLinks[segments[s]].target;
+        for (size_t r = segments[s]; r < segments[s + 1]; ++r)
+        {
+          links[target][reverseLinks[r].level].push_back(
+              reverseLinks[r].source);
+        }
+
+        // Shrink the lists that are too long, keeping links in several
+        // directions.
+        for (size_t l = 0; l < links[target].size(); ++l)
+        {
+          std::vector<size_t>& list = links[target][l];
+          if (list.size() <= MaxLinks(l))
+            continue;
+
+          candidates.resize(list.size());
+          for (size_t j = 0; j < list.size(); ++j)
+          {
+            candidates[j] = Candidate(metric.Evaluate(referenceSet.col(target),
+                referenceSet.col(list[j])), list[j]);
+          }
+          evaluations += list.size();
+
+          std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate& a, const Candidate& b)
+              {
+                if (a.first == b.first)
+                  return a.second < b.second;
+                return SortPolicy::IsBetter(a.first, b.first);
+              });
+          list = SelectLinks(candidates, MaxLinks(l), evaluations);
+        }
+      }
+    }
+
+    // The highest point becomes the entry point.
+    for (size_t p = next; p < batchEnd; ++p)
+    {
+      if (links[p].size() - 1 > maxLevel)
+      {
+        maxLevel = links[p].size() - 1;
+        entryPoint = p;
+      }
+    }
+
+    next = batchEnd;
+  }
+
+  Log::Info << "HNSW::Build(): inserted " << (n - begin) << " points with "
+      << evaluations << " distance evaluations; the graph has " << NumLevels()
+      << " levels." << std::endl;
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+void HNSW<SortPolicy, MetricType, MatType>::SearchInternal(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    const bool sameSet)
+{
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  baseCases = 0;
+  if (k == 0)
+    return;
+
+  // When the query set is the reference set, each point finds itself.
+  const size_t beamWidth = std::max(ef, sameSet ? k + 1 : k);
+  size_t evaluations = 0;
+  #pragma omp parallel reduction(+:evaluations)
+  {
+    VisitedList visited(referenceSet.n_cols);
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      Candidate entry(metric.Evaluate(querySet.col(i),
+          referenceSet.col(entryPoint)), entryPoint);
+      ++evaluations;
+      for (size_t l = maxLevel; l > 0; --l)
+        entry = GreedySearch(querySet.col(i), entry, l, evaluations);
+
+      const std::vector<Candidate> found = SearchLevel(querySet.col(i),
+          std::vector<Candidate>(1, entry), beamWidth, 0, visited,
+          evaluations);
+
+      size_t j = 0;
+      for (size_t f = 0; f < found.size() && j < k; ++f)
+      {
+        if (sameSet && found[f].second == (size_t) i)
+          continue;
+
+        neighbors(j, i) = found[f].second;
+        distances(j, i) = found[f].first;
+        ++j;
+      }
+
+      // The graph may not connect enough points to the query.
+      for (; j < k; ++j)
+      {
+        neighbors(j, i) = SIZE_MAX;
+        distances(j, i) = SortPolicy::WorstDistance();
+      }
+    }
+  }
+
+  baseCases = evaluations;
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
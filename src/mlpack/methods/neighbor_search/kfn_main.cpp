@@ -103,7 +103,9 @@ PARAM_INT_IN("k", "Number of furthest neighbors to find.", "k", 0);
 // building.
 PARAM_STRING_IN("tree_type", "Type of tree to use: 'kd', 'vp', 'rp', 'max-rp', "
     "'ub', 'cover', 'r', 'r-star', 'x', 'ball', 'hilbert-r', 'r-plus', "
-    "'r-plus-plus', 'oct'.", "t", "kd");
+    "'r-plus-plus', 'oct', 'auto'.  'auto' chooses the tree type and the leaf "
+    "size by building candidate trees on a sample of the reference set and "
+    "timing a sample of the queries.", "t", "kd");
 PARAM_INT_IN("leaf_size", "Leaf size for tree building (used for kd-trees, "
     "vp trees, random projection trees, UB trees, R trees, R* trees, X trees, "
     "Hilbert R trees, R+ trees, R++ trees, and octrees).", "l", 20);
@@ -205,7 +207,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     // Get all the parameters.
     RequireParamInSet<string>(params, "tree_type", { "kd", "cover", "r",
         "r-star", "ball", "x", "hilbert-r", "r-plus", "r-plus-plus", "vp", "rp",
-        "max-rp", "ub", "oct" }, true, "unknown tree type");
+        "max-rp", "ub", "oct", "auto" }, true, "unknown tree type");
     const string treeType = params.Get<string>("tree_type");
     const bool randomBasis = params.Has("random_basis");
 
@@ -250,6 +252,16 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     arma::mat referenceSet = std::move(params.Get<arma::mat>("reference"));
 
+    // The tree is tuned for the search that will be done, if any.
+    if (treeType == "auto")
+    {
+      const arma::mat noQueries;
+      const arma::mat& queries = (params.Has("k") && params.Has("query")) ?
+          params.Get<arma::mat>("query") : noQueries;
+      const size_t k = params.Has("k") ? (size_t) params.Get<int>("k") : 1;
+      kfn->Tune(timers, referenceSet, queries, k, searchMode, epsilon);
+    }
+
     kfn->BuildModel(timers, std::move(referenceSet), searchMode, epsilon);
   }
   else
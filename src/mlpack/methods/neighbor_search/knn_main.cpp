@@ -109,15 +109,28 @@ PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
 // building.
 PARAM_STRING_IN("tree_type", "Type of tree to use: 'kd', 'vp', 'rp', 'max-rp', "
     "'ub', 'cover', 'r', 'r-star', 'x', 'ball', 'hilbert-r', 'r-plus', "
-    "'r-plus-plus', 'spill', 'oct'.", "t", "kd");
+    "'r-plus-plus', 'spill', 'oct', 'morton', 'hnsw', 'auto'.  'hnsw' builds "
+    "an approximate HNSW graph instead of a tree, and ignores the search "
+    "algorithm.  'auto' chooses the tree type and the leaf size by building "
+    "candidate trees on a sample of the reference set and timing a sample of "
+    "the queries.", "t", "kd");
 PARAM_INT_IN("leaf_size", "Leaf size for tree building (used for kd-trees, vp "
     "trees, random projection trees, UB trees, R trees, R* trees, X trees, "
-    "Hilbert R trees, R+ trees, R++ trees, spill trees, and octrees).", "l",
-    20);
+    "Hilbert R trees, R+ trees, R++ trees, spill trees, octrees, and Morton "
+    "trees).", "l", 20);
 PARAM_DOUBLE_IN("tau", "Overlapping size (only valid for spill trees).", "u",
     0);
 PARAM_DOUBLE_IN("rho", "Balance threshold (only valid for spill trees).", "b",
     0.7);
+PARAM_INT_IN("hnsw_m", "Number of links of each point of the HNSW graph on its "
+    "upper levels (twice as many on the bottom level) (only valid for HNSW "
+    "graphs).", "", 16);
+PARAM_INT_IN("ef_construction", "Number of candidate neighbors explored when "
+    "inserting a point into the HNSW graph (only valid for HNSW graphs).", "",
+    200);
+PARAM_INT_IN("ef", "Number of candidate neighbors explored when searching the "
+    "HNSW graph; larger values give better recall (only valid for HNSW "
+    "graphs).", "", 50);
 
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
@@ -128,6 +141,20 @@ PARAM_STRING_IN("algorithm", "Type of neighbor search: 'naive', 'single_tree', "
     "'dual_tree', 'greedy'.", "a", "dual_tree");
 PARAM_DOUBLE_IN("epsilon", "If specified, will do approximate nearest neighbor "
     "search with given relative error.", "e", 0);
+PARAM_FLAG("quantize", "If set, base cases are computed with an 8-bit "
+    "quantized copy of the reference set; the returned neighbors and distances "
+    "are exact for the quantized reference points.  This cannot be used with "
+    "HNSW graphs.", "");
+
+// Traversal statistics.
+PARAM_UMATRIX_OUT("query_statistics", "If specified, the traversal statistics "
+    "of each query point are saved to this matrix: one column for each query "
+    "point, with rows holding the number of base cases, the number of scored "
+    "reference nodes, and the number of pruned reference nodes.", "");
+PARAM_UMATRIX_OUT("level_statistics", "If specified, the traversal statistics "
+    "of each level of the reference tree are saved to this matrix: one column "
+    "for each level (starting at the root), with rows holding the number of "
+    "scored nodes and the number of pruned nodes.", "");
 
 void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 {
@@ -167,6 +194,8 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   ReportIgnoredParam(params, {{ "k", false }}, "true_neighbors");
   ReportIgnoredParam(params, {{ "k", false }}, "true_distances");
   ReportIgnoredParam(params, {{ "k", false }}, "query");
+  ReportIgnoredParam(params, {{ "k", false }}, "query_statistics");
+  ReportIgnoredParam(params, {{ "k", false }}, "level_statistics");
 
   // Sanity check on leaf size.
   RequireParamValue<int>(params, "leaf_size", [](int x) { return x > 0; },
@@ -190,6 +219,23 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     ReportIgnoredParam(params, "rho", "spill trees are not being used");
   }
 
+  // Sanity checks on the HNSW graph parameters.
+  RequireParamValue<int>(params, "hnsw_m", [](int x) { return x >= 2; },
+      true, "hnsw_m must be at least 2");
+  RequireParamValue<int>(params, "ef_construction",
+      [](int x) { return x > 0; }, true, "ef_construction must be positive");
+  RequireParamValue<int>(params, "ef", [](int x) { return x > 0; }, true,
+      "ef must be positive");
+  ReportIgnoredParam(params, {{ "input_model", true }}, "hnsw_m");
+  ReportIgnoredParam(params, {{ "input_model", true }}, "ef_construction");
+  if (!params.Has("input_model") && params.Get<string>("tree_type") != "hnsw")
+  {
+    ReportIgnoredParam(params, "hnsw_m", "HNSW graphs are not being used");
+    ReportIgnoredParam(params, "ef_construction", "HNSW graphs are not being "
+        "used");
+    ReportIgnoredParam(params, "ef", "HNSW graphs are not being used");
+  }
+
   // Sanity check on epsilon.
   const double epsilon = params.Get<double>("epsilon");
   RequireParamValue<double>(params, "epsilon",
@@ -221,7 +267,8 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     KNNModel::TreeTypes tree = KNNModel::KD_TREE;
     RequireParamInSet<string>(params, "tree_type", { "kd", "cover", "r",
         "r-star", "ball", "x", "hilbert-r", "r-plus", "r-plus-plus", "spill",
-        "vp", "rp", "max-rp", "ub", "oct" }, true, "unknown tree type");
+        "vp", "rp", "max-rp", "ub", "oct", "morton", "hnsw", "auto" }, true,
+        "unknown tree type");
 
     knn = new KNNModel();
 
@@ -255,18 +302,35 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
       tree = KNNModel::UB_TREE;
     else if (treeType == "oct")
       tree = KNNModel::OCTREE;
+    else if (treeType == "morton")
+      tree = KNNModel::MORTON_TREE;
+    else if (treeType == "hnsw")
+      tree = KNNModel::HNSW_GRAPH;
 
     knn->TreeType() = tree;
     knn->RandomBasis() = randomBasis;
     knn->LeafSize() = size_t(lsInt);
     knn->Tau() = tau;
     knn->Rho() = rho;
+    knn->HNSWM() = (size_t) params.Get<int>("hnsw_m");
+    knn->EfConstruction() = (size_t) params.Get<int>("ef_construction");
+    knn->Ef() = (size_t) params.Get<int>("ef");
 
     Log::Info << "Using reference data from "
         << params.GetPrintable<arma::mat>("reference") << "." << endl;
 
     arma::mat referenceSet = std::move(params.Get<arma::mat>("reference"));
 
+    // The tree is tuned for the search that will be done, if any.
+    if (treeType == "auto")
+    {
+      const arma::mat noQueries;
+      const arma::mat& queries = (params.Has("k") && params.Has("query")) ?
+          params.Get<arma::mat>("query") : noQueries;
+      const size_t k = params.Has("k") ? (size_t) params.Get<int>("k") : 1;
+      knn->Tune(timers, referenceSet, queries, k, searchMode, epsilon);
+    }
+
     knn->BuildModel(timers, std::move(referenceSet), searchMode, epsilon);
   }
   else
@@ -284,6 +348,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     if (params.Has("leaf_size"))
       knn->LeafSize() = size_t(lsInt);
 
+    // Likewise, ef may be changed for a loaded HNSW graph.
+    if (params.Has("ef"))
+      knn->Ef() = (size_t) params.Get<int>("ef");
+
     Log::Info << "Loaded kNN model from '"
         << params.GetPrintable<KNNModel*>("input_model") << "' (trained on "
         << knn->Dataset().n_rows << "x" << knn->Dataset().n_cols
@@ -343,6 +411,24 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     arma::Mat<size_t> neighbors;
     arma::mat distances;
 
+    // The quantized reference set is not part of the model, so it is computed
+    // for each search.
+    if (params.Has("quantize"))
+    {
+      if (knn->TreeType() == KNNModel::HNSW_GRAPH)
+      {
+        if (params.Has("reference"))
+          delete knn;
+        Log::Fatal << PRINT_PARAM_STRING("quantize") << " cannot be used with "
+            << "HNSW graphs!" << endl;
+      }
+
+      knn->Quantize();
+    }
+
+    knn->CollectStatistics() = params.Has("query_statistics") ||
+        params.Has("level_statistics");
+
     if (params.Has("query"))
       knn->Search(timers, std::move(queryData), k, neighbors, distances);
     else
@@ -350,10 +436,46 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     Log::Info << "Search complete." << endl;
 
+    if (knn->CollectStatistics())
+    {
+      const TraversalStatistics& stats = knn->Statistics();
+      Log::Info << "Time spent in base cases: " << stats.BaseCaseTime()
+          << "s; time spent in scores: " << stats.ScoreTime() << "s." << endl;
+      for (size_t l = 0; l < stats.LevelScores().n_elem; ++l)
+      {
+        Log::Info << "Reference tree level " << l << ": "
+            << stats.LevelScores()[l] << " nodes scored, "
+            << stats.LevelPrunes()[l] << " nodes pruned." << endl;
+      }
+
+      if (params.Has("query_statistics"))
+      {
+        arma::Mat<size_t>& queryStatistics =
+            params.Get<arma::Mat<size_t>>("query_statistics");
+        queryStatistics.set_size(3, stats.QueryBaseCases().n_elem);
+        queryStatistics.row(0) = stats.QueryBaseCases().t();
+        queryStatistics.row(1) = stats.QueryScores().t();
+        queryStatistics.row(2) = stats.QueryPrunes().t();
+      }
+
+      if (params.Has("level_statistics"))
+      {
+        arma::Mat<size_t>& levelStatistics =
+            params.Get<arma::Mat<size_t>>("level_statistics");
+        levelStatistics.set_size(2, stats.LevelScores().n_elem);
+        levelStatistics.row(0) = stats.LevelScores().t();
+        levelStatistics.row(1) = stats.LevelPrunes().t();
+      }
+
+      knn->CollectStatistics() = false;
+    }
+
     // Calculate the effective error, if desired.
     if (params.Has("true_distances"))
     {
-      if (knn->TreeType() != KNNModel::SPILL_TREE && knn->Epsilon() == 0)
+      if (knn->TreeType() != KNNModel::SPILL_TREE &&
+          knn->TreeType() != KNNModel::HNSW_GRAPH && knn->Epsilon() == 0 &&
+          !knn->Quantized())
         Log::Warn << PRINT_PARAM_STRING("true_distances") << "specified, but "
             << "the search is exact, so there is no need to calculate the "
             << "error!" << endl;
@@ -377,7 +499,9 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     // Calculate the recall, if desired.
     if (params.Has("true_neighbors"))
     {
-      if (knn->TreeType() != KNNModel::SPILL_TREE && knn->Epsilon() == 0)
+      if (knn->TreeType() != KNNModel::SPILL_TREE &&
+          knn->TreeType() != KNNModel::HNSW_GRAPH && knn->Epsilon() == 0 &&
+          !knn->Quantized())
         Log::Warn << PRINT_PARAM_STRING("true_neighbors") << " specified, but "
             << " the search is exact, so there is no need to calculate the "
             << "recall!" << endl;
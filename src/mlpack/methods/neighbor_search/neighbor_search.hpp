@@ -24,6 +24,7 @@
 #include "neighbor_search_stat.hpp"
 #include "sort_policies/nearest_neighbor_sort.hpp"
 #include "neighbor_search_rules.hpp"
+#include "quantized_dataset.hpp"
 
 namespace mlpack {
 // Neighbor-search routines. These include all-nearest-neighbors and
@@ -35,6 +36,7 @@ template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 class LeafSizeNSWrapper;
@@ -277,6 +279,89 @@ class NeighborSearch
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
+  /**
+   * For each point in the query set, compute the nearest neighbors with a
+   * bound on the total amount of work, storing the output in the given
+   * matrices.  This is meant for small query batches against a fixed reference
+   * tree: no query tree is built (even in dual-tree mode), and if the matrices
+   * already have size k x n, they are reused without any reallocation.
+   *
+   * Query points are answered in order with exact single-tree search until
+   * either maxBaseCases base cases have been computed or maxTime seconds have
+   * passed; every query point after that is answered with greedy single-tree
+   * search, which is approximate but has a small and predictable cost.  The
+   * budget is checked between query points, so a query point that is already
+   * being searched is always completed.  In GREEDY_SINGLE_TREE_MODE, all query
+   * points use greedy search.  This cannot be used in NAIVE_MODE, since there
+   * is no reference tree.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *      point.
+   * @param maxBaseCases Maximum number of base cases for exact search (0 means
+   *      no limit).
+   * @param maxTime Maximum time in seconds for exact search (0 means no
+   *      limit).
+   * @return Number of query points that were answered with greedy search
+   *      because the budget was exhausted.
+   */
+  size_t BoundedSearch(const MatType& querySet,
+                       const size_t k,
+                       arma::Mat<size_t>& neighbors,
+                       arma::mat& distances,
+                       const size_t maxBaseCases,
+                       const double maxTime = 0.0);
+
+  /**
+   * Add the given points to the reference set without rebuilding the reference
+   * tree.  The new points are held in a separate buffer that is searched by
+   * brute force, and are merged into the tree (along with the removal of any
+   * deleted points) when Rebuild() is called.  This happens automatically once
+   * the number of pending insertions and deletions exceeds RebuildFraction()
+   * times the number of points in the tree.
+   *
+   * The new points are given consecutive indices, starting with the returned
+   * value; these are the indices that will be returned by Search().  Indices
+   * of existing points never change, even when the tree is rebuilt.
+   *
+   * This requires a tree type that rearranges the dataset (such as the
+   * kd-tree or ball tree), and cannot be used in naive mode.
+   *
+   * @param points Points to add to the reference set.
+   * @return Index of the first inserted point.
+   */
+  size_t Insert(const MatType& points);
+
+  /**
+   * Remove the point with the given index from the reference set.  Points in
+   * the reference tree are only marked as deleted (so they are still visited
+   * during traversals, but never returned), until the next call to Rebuild().
+   * An exception is thrown if no point has the given index.
+   *
+   * @param index Index of the point to remove.
+   */
+  void Delete(const size_t index);
+
+  /**
+   * Rebuild the reference tree on the current reference set: pending inserted
+   * points are added to the tree and deleted points are removed from it.  The
+   * tree is built with the default parameters of its constructor.  Indices of
+   * points are preserved.
+   */
+  void Rebuild();
+
+  //! Get the number of inserted points that are not in the reference tree yet.
+  size_t NumPending() const { return pendingSet.n_cols; }
+  //! Get the number of deleted points that are still in the reference tree.
+  size_t NumDeleted() const { return numDeleted; }
+
+  //! Get the fraction of pending changes that triggers a rebuild.
+  double RebuildFraction() const { return rebuildFraction; }
+  //! Modify the fraction of pending changes that triggers a rebuild.
+  double& RebuildFraction() { return rebuildFraction; }
+
   /**
    * Calculate the average relative error (effective error) between the
    * distances calculated and the true distances provided.  The input matrices
@@ -316,6 +401,39 @@ class NeighborSearch
   //! Return the number of node combination scores during the last search.
   size_t Scores() const { return scores; }
 
+  //! Get whether or not traversal statistics are collected during searches.
+  bool CollectStatistics() const { return collectStatistics; }
+  //! Modify whether or not traversal statistics are collected during searches.
+  //! Statistics cannot be collected with a parallel dual-tree traverser.
+  bool& CollectStatistics() { return collectStatistics; }
+
+  //! Get the traversal statistics of the last search (empty if
+  //! CollectStatistics() was false).  Per-query counters are indexed by the
+  //! original index of each query point.
+  const tree::TraversalStatistics& Statistics() const { return statistics; }
+
+  /**
+   * Set whether or not base cases are computed with an 8-bit scalar-quantized
+   * copy of the reference set (see QuantizedDataset).  Each dimension of each
+   * reference point then costs one byte to read instead of four or eight, and
+   * the pruning bounds of the tree search are loosened by the quantization
+   * error, so the results are the exact neighbors among the quantized
+   * reference points, and the returned distances are the distances to the
+   * quantized points.  Points inserted with Insert() are compared at full
+   * precision until the tree is rebuilt.  Only the Euclidean distance is
+   * supported.
+   *
+   * The codes are recomputed every time the reference set changes.  This
+   * setting is not serialized.
+   *
+   * @param quantize Whether or not to search the quantized reference set.
+   */
+  void Quantize(const bool quantize = true);
+
+  //! Get whether or not base cases are computed with the quantized reference
+  //! set.
+  bool Quantized() const { return quantized; }
+
   //! Access the search mode.
   NeighborSearchMode SearchMode() const { return searchMode; }
   //! Modify the search mode.
@@ -326,6 +444,13 @@ class NeighborSearch
   //! Modify the relative error to be considered in approximate search.
   double& Epsilon() { return epsilon; }
 
+  //! Get the minimum number of query points for which a query tree is built in
+  //! dual-tree mode; smaller query sets use single-tree search.
+  size_t DualTreeQueryThreshold() const { return dualTreeQueryThreshold; }
+  //! Modify the minimum number of query points for which a query tree is built
+  //! in dual-tree mode; smaller query sets use single-tree search.
+  size_t& DualTreeQueryThreshold() { return dualTreeQueryThreshold; }
+
   //! Access the reference dataset.
   const MatType& ReferenceSet() const { return *referenceSet; }
 
@@ -363,9 +488,80 @@ class NeighborSearch
   //! Search() without a query set.
   bool treeNeedsReset;
 
+  //! Query sets with fewer points than this are searched with single-tree
+  //! search in dual-tree mode.
+  size_t dualTreeQueryThreshold;
+
+  //! Inserted points that have not been added to the reference tree yet.
+  MatType pendingSet;
+  //! Indices of the points in pendingSet.
+  std::vector<size_t> pendingIds;
+  //! Points in the reference tree that have been deleted.  This is empty if no
+  //! points have been deleted since the tree was built.
+  std::vector<bool> deletedReferences;
+  //! The number of points marked in deletedReferences.
+  size_t numDeleted;
+  //! The index that the next inserted point will get (SIZE_MAX if it has not
+  //! been computed yet).
+  size_t nextIndex;
+  //! The position of each point in the reference tree, indexed by point index.
+  //! This is built when it is first needed.
+  std::vector<size_t> treePositions;
+  //! The fraction of pending changes that triggers a rebuild.
+  double rebuildFraction;
+
+  //! If true, traversal statistics are collected during searches.
+  bool collectStatistics;
+  //! The traversal statistics of the last search.
+  tree::TraversalStatistics statistics;
+
+  //! If true, base cases are computed with quantizedSet.
+  bool quantized;
+  //! The quantized reference set (empty if quantized is false).
+  QuantizedDataset<MatType> quantizedSet;
+
+  /**
+   * Perform a naive, single-tree, or greedy single-tree search for every point
+   * in the given query set.  The query set is split into contiguous blocks,
+   * which are processed in parallel if OpenMP is available.  Each block uses
+   * its own NeighborSearchRules object (and so its own candidate lists), so the
+   * results are identical to those of a serial search.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the neighbor indices in.
+   * @param distances Matrix to store the distances in.
+   * @param mode Search mode to use; this may not be DUAL_TREE_MODE.
+   * @param sameSet If true, the query set is the reference set.
+   */
+  void SearchQueryBlocks(const MatType& querySet,
+                         const size_t k,
+                         arma::Mat<size_t>& neighbors,
+                         arma::mat& distances,
+                         const NeighborSearchMode mode,
+                         const bool sameSet);
+
+  //! Forget any pending insertions and deletions, and recompute the quantized
+  //! reference set if needed; this is used when the reference set changes.
+  void ResetIncrementalState();
+
+  //! Prepare the object for Insert() or Delete(), and throw an exception if
+  //! that is not possible.
+  void PrepareUpdate(const std::string& method);
+
+  //! Rebuild the reference tree if there are any pending insertions or
+  //! deletions (if force is true), or if there are more of them than
+  //! RebuildFraction() allows (if force is false).
+  void FlushUpdates(const bool force);
+
+  //! Merge the pending inserted points into the results of a search.
+  void MergePending(const MatType& querySet,
+                    arma::Mat<size_t>& neighbors,
+                    arma::mat& distances);
+
   //! The NSModel class should have access to internal members.
-  friend class LeafSizeNSWrapper<SortPolicy, TreeType, DualTreeTraversalType,
-      SingleTreeTraversalType>;
+  friend class LeafSizeNSWrapper<SortPolicy, TreeType, MatType,
+      DualTreeTraversalType, SingleTreeTraversalType>;
 }; // class NeighborSearch
 
 } // namespace neighbor
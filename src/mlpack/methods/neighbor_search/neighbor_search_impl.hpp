@@ -68,7 +68,13 @@ SingleTreeTraversalType>::NeighborSearch(MatType referenceSetIn,
     metric(metric),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    dualTreeQueryThreshold(0),
+    numDeleted(0),
+    nextIndex(SIZE_MAX),
+    rebuildFraction(0.1),
+    collectStatistics(false),
+    quantized(false)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -95,7 +101,13 @@ SingleTreeTraversalType>::NeighborSearch(Tree referenceTree,
     metric(metric),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    dualTreeQueryThreshold(0),
+    numDeleted(0),
+    nextIndex(SIZE_MAX),
+    rebuildFraction(0.1),
+    collectStatistics(false),
+    quantized(false)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -121,7 +133,13 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearchMode mode,
     metric(metric),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    dualTreeQueryThreshold(0),
+    numDeleted(0),
+    nextIndex(SIZE_MAX),
+    rebuildFraction(0.1),
+    collectStatistics(false),
+    quantized(false)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -129,7 +147,7 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearchMode mode,
   // Build the tree on the empty dataset, if necessary.
   if (mode != NAIVE_MODE)
   {
-    referenceTree = BuildTree<Tree>(std::move(arma::mat()),
+    referenceTree = BuildTree<Tree>(std::move(MatType()),
         oldFromNewReferences);
     referenceSet = &referenceTree->Dataset();
   }
@@ -155,7 +173,19 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearch& other) :
     metric(other.metric),
     baseCases(other.baseCases),
     scores(other.scores),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    dualTreeQueryThreshold(other.dualTreeQueryThreshold),
+    pendingSet(other.pendingSet),
+    pendingIds(other.pendingIds),
+    deletedReferences(other.deletedReferences),
+    numDeleted(other.numDeleted),
+    nextIndex(other.nextIndex),
+    treePositions(other.treePositions),
+    rebuildFraction(other.rebuildFraction),
+    collectStatistics(other.collectStatistics),
+    statistics(other.statistics),
+    quantized(other.quantized),
+    quantizedSet(other.quantizedSet)
 {
   // Nothing else to do.
 }
@@ -179,7 +209,19 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
     scores(other.scores),
-    treeNeedsReset(other.treeNeedsReset)
+    treeNeedsReset(other.treeNeedsReset),
+    dualTreeQueryThreshold(other.dualTreeQueryThreshold),
+    pendingSet(std::move(other.pendingSet)),
+    pendingIds(std::move(other.pendingIds)),
+    deletedReferences(std::move(other.deletedReferences)),
+    numDeleted(other.numDeleted),
+    nextIndex(other.nextIndex),
+    treePositions(std::move(other.treePositions)),
+    rebuildFraction(other.rebuildFraction),
+    collectStatistics(other.collectStatistics),
+    statistics(std::move(other.statistics)),
+    quantized(other.quantized),
+    quantizedSet(std::move(other.quantizedSet))
 {
   // Clear the other model.
   other.referenceTree = BuildTree<Tree>(std::move(MatType()),
@@ -190,6 +232,8 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
   other.baseCases = 0;
   other.scores = 0;
   other.treeNeedsReset = false;
+  other.quantized = false;
+  other.ResetIncrementalState();
 }
 
 // Copy operator.
@@ -233,6 +277,20 @@ NeighborSearch<SortPolicy,
   baseCases = other.baseCases;
   scores = other.scores;
   treeNeedsReset = false;
+  dualTreeQueryThreshold = other.dualTreeQueryThreshold;
+  pendingSet = other.pendingSet;
+  pendingIds = other.pendingIds;
+  deletedReferences = other.deletedReferences;
+  numDeleted = other.numDeleted;
+  nextIndex = other.nextIndex;
+  treePositions = other.treePositions;
+  rebuildFraction = other.rebuildFraction;
+  collectStatistics = other.collectStatistics;
+  statistics = other.statistics;
+  quantized = other.quantized;
+  quantizedSet = other.quantizedSet;
+
+  return *this;
 }
 
 // Move operator.
@@ -275,12 +333,24 @@ NeighborSearch<SortPolicy,
   baseCases = other.baseCases;
   scores = other.scores;
   treeNeedsReset = other.treeNeedsReset;
+  dualTreeQueryThreshold = other.dualTreeQueryThreshold;
+  pendingSet = std::move(other.pendingSet);
+  pendingIds = std::move(other.pendingIds);
+  deletedReferences = std::move(other.deletedReferences);
+  numDeleted = other.numDeleted;
+  nextIndex = other.nextIndex;
+  treePositions = std::move(other.treePositions);
+  rebuildFraction = other.rebuildFraction;
+  collectStatistics = other.collectStatistics;
+  statistics = std::move(other.statistics);
+  quantized = other.quantized;
+  quantizedSet = std::move(other.quantizedSet);
 
   // Reset the other object.  Clean memory if needed.
   if (!other.referenceTree)
     delete other.referenceSet;
 
-  other.referenceTree = BuildTree<Tree>(std::move(arma::mat()),
+  other.referenceTree = BuildTree<Tree>(std::move(MatType()),
       other.oldFromNewReferences);
   other.referenceSet = &other.referenceTree->Dataset();
   other.searchMode = DUAL_TREE_MODE,
@@ -288,6 +358,10 @@ NeighborSearch<SortPolicy,
   other.baseCases = 0;
   other.scores = 0;
   other.treeNeedsReset = false;
+  other.quantized = false;
+  other.ResetIncrementalState();
+
+  return *this;
 }
 
 // Clean memory.
@@ -342,6 +416,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(MatType referenceSetIn)
   {
     referenceSet = new MatType(std::move(referenceSetIn));
   }
+
+  ResetIncrementalState();
 }
 
 template<typename SortPolicy,
@@ -371,6 +447,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree referenceTree)
 
   this->referenceTree = new Tree(std::move(referenceTree));
   this->referenceSet = &this->referenceTree->Dataset();
+
+  ResetIncrementalState();
 }
 
 /**
@@ -392,16 +470,33 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     arma::Mat<size_t>& neighbors,
     arma::mat& distances)
 {
-  if (k > referenceSet->n_cols)
+  MLPACK_TRACE_SCOPE("neighbor_search");
+
+  // Every query point must find k neighbors in the reference tree before the
+  // pending points are merged in, so add them to the tree if there are not
+  // enough live points in it.
+  if (k > referenceSet->n_cols - numDeleted && pendingSet.n_cols > 0)
+    FlushUpdates(true);
+
+  if (k > referenceSet->n_cols - numDeleted)
   {
     std::stringstream ss;
     ss << "Requested value of k (" << k << ") is greater than the number of "
-        << "points in the reference set (" << referenceSet->n_cols << ")";
+        << "points in the reference set (" << referenceSet->n_cols - numDeleted
+        << ")";
     throw std::invalid_argument(ss.str());
   }
 
   baseCases = 0;
   scores = 0;
+  if (collectStatistics)
+    statistics.Reset(querySet.n_cols);
+
+  // Building a query tree is not worthwhile for very small query sets, so
+  // those are answered with single-tree search.
+  const NeighborSearchMode mode = (searchMode == DUAL_TREE_MODE &&
+      querySet.n_cols < dualTreeQueryThreshold) ? SINGLE_TREE_MODE :
+      searchMode;
 
   // This will hold mappings for query points, if necessary.
   std::vector<size_t> oldFromNewQueries;
@@ -413,16 +508,12 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   arma::Mat<size_t>* neighborPtr = &neighbors;
   arma::mat* distancePtr = &distances;
 
-  // Mapping is only necessary if the tree rearranges points.
-  if (tree::TreeTraits<Tree>::RearrangesDataset)
+  // Mapping is only necessary if the tree rearranges points.  If only the
+  // reference indices need to be mapped, that is done in place.
+  if (tree::TreeTraits<Tree>::RearrangesDataset && mode == DUAL_TREE_MODE)
   {
-    if (searchMode == DUAL_TREE_MODE)
-    {
-      distancePtr = new arma::mat; // Query indices need to be mapped.
-      neighborPtr = new arma::Mat<size_t>;
-    }
-    else if (!oldFromNewReferences.empty())
-      neighborPtr = new arma::Mat<size_t>; // Reference indices need mapping.
+    distancePtr = new arma::mat; // Query indices need to be mapped.
+    neighborPtr = new arma::Mat<size_t>;
   }
 
   // Set the size of the neighbor and distance matrices.
@@ -431,44 +522,13 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
 
-  switch (searchMode)
+  switch (mode)
   {
     case NAIVE_MODE:
-    {
-      // Create the helper object for the tree traversal.
-      RuleType rules(*referenceSet, querySet, k, metric, epsilon);
-
-      // The naive brute-force traversal.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        for (size_t j = 0; j < referenceSet->n_cols; ++j)
-          rules.BaseCase(i, j);
-
-      baseCases += querySet.n_cols * referenceSet->n_cols;
-
-      rules.GetResults(*neighborPtr, *distancePtr);
-      break;
-    }
     case SINGLE_TREE_MODE:
+    case GREEDY_SINGLE_TREE_MODE:
     {
-      // Create the helper object for the tree traversal.
-      RuleType rules(*referenceSet, querySet, k, metric, epsilon);
-
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
-
-      rules.GetResults(*neighborPtr, *distancePtr);
+      SearchQueryBlocks(querySet, k, *neighborPtr, *distancePtr, mode, false);
       break;
     }
     case DUAL_TREE_MODE:
@@ -478,54 +538,41 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, epsilon);
+      if (numDeleted > 0)
+        rules.DeletedReferences() = &deletedReferences;
+      if (quantized)
+        rules.QuantizedReferences() = &quantizedSet;
+      if (collectStatistics)
+        rules.Statistics() = &statistics;
 
       // Create the traverser.
       DualTreeTraversalType<RuleType> traverser(rules);
 
       traverser.Traverse(*queryTree, *referenceTree);
 
+      // The per-query counters are in the order of the query tree.
+      if (collectStatistics && tree::TreeTraits<Tree>::RearrangesDataset)
+        statistics.MapQueries(oldFromNewQueries);
+
       scores += rules.Scores();
       baseCases += rules.BaseCases();
 
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
+      MLPACK_LOG(Log::Info) << rules.Scores()
+          << " node combinations were scored." << std::endl;
+      MLPACK_LOG(Log::Info) << rules.BaseCases()
+          << " base cases were calculated." << std::endl;
 
       rules.GetResults(*neighborPtr, *distancePtr);
 
       delete queryTree;
       break;
     }
-    case GREEDY_SINGLE_TREE_MODE:
-    {
-      // Create the helper object for the tree traversal.
-      RuleType rules(*referenceSet, querySet, k, metric);
-
-      // Create the traverser.
-      tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
-
-      rules.GetResults(*neighborPtr, *distancePtr);
-      break;
-    }
   }
 
   // Map points back to original indices, if necessary.
   if (tree::TreeTraits<Tree>::RearrangesDataset)
   {
-    if (searchMode == DUAL_TREE_MODE && !oldFromNewReferences.empty())
+    if (mode == DUAL_TREE_MODE && !oldFromNewReferences.empty())
     {
       // We must map both query and reference indices.
       neighbors.set_size(k, querySet.n_cols);
@@ -548,7 +595,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       delete neighborPtr;
       delete distancePtr;
     }
-    else if (searchMode == DUAL_TREE_MODE)
+    else if (mode == DUAL_TREE_MODE)
     {
       // We must map query indices only.
       neighbors.set_size(k, querySet.n_cols);
@@ -568,18 +615,17 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     }
     else if (!oldFromNewReferences.empty())
     {
-      // We must map reference indices only.
-      neighbors.set_size(k, querySet.n_cols);
-
-      // Map indices of neighbors.
-      for (size_t i = 0; i < neighbors.n_cols; ++i)
-        for (size_t j = 0; j < neighbors.n_rows; ++j)
-          neighbors(j, i) = oldFromNewReferences[(*neighborPtr)(j, i)];
-
-      // Finished with temporary matrix.
-      delete neighborPtr;
+      // We must map reference indices only; this can be done in place.  Greedy
+      // search may not find k points if some have been deleted.
+      for (size_t i = 0; i < neighbors.n_elem; ++i)
+        if (neighbors[i] != SIZE_MAX)
+          neighbors[i] = oldFromNewReferences[neighbors[i]];
     }
   }
+
+  // Finally, consider the points that are not in the reference tree yet.
+  if (pendingSet.n_cols > 0)
+    MergePending(querySet, neighbors, distances);
 } // Search()
 
 template<typename SortPolicy,
@@ -598,6 +644,9 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     arma::mat& distances,
     bool sameSet)
 {
+  // Traversals with a given query tree use the reference tree only.
+  FlushUpdates(true);
+
   if (k > referenceSet->n_cols)
   {
     std::stringstream ss;
@@ -616,6 +665,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   // Get a reference to the query set.
   const MatType& querySet = queryTree.Dataset();
+  if (collectStatistics)
+    statistics.Reset(querySet.n_cols);
 
   // We won't need to map query indices, but will we need to map distances?
   arma::Mat<size_t>* neighborPtr = &neighbors;
@@ -630,6 +681,10 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   // Create the helper object for the traversal.
   typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
   RuleType rules(*referenceSet, querySet, k, metric, epsilon, sameSet);
+  if (quantized)
+    rules.QuantizedReferences() = &quantizedSet;
+  if (collectStatistics)
+    rules.Statistics() = &statistics;
 
   // Create the traverser.
   DualTreeTraversalType<RuleType> traverser(rules);
@@ -638,13 +693,17 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   scores += rules.Scores();
   baseCases += rules.BaseCases();
 
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
+  MLPACK_LOG(Log::Info) << rules.Scores()
+      << " node combinations were scored." << std::endl;
+  MLPACK_LOG(Log::Info) << rules.BaseCases()
+      << " base cases were calculated." << std::endl;
 
   rules.GetResults(*neighborPtr, distances);
 
-  Log::Info << rules.Scores() << " node combinations were scored.\n";
-  Log::Info << rules.BaseCases() << " base cases were calculated.\n";
+  MLPACK_LOG(Log::Info) << rules.Scores()
+      << " node combinations were scored.\n";
+  MLPACK_LOG(Log::Info) << rules.BaseCases()
+      << " base cases were calculated.\n";
 
   // Do we need to map indices?
   if (!oldFromNewReferences.empty() &&
@@ -677,6 +736,19 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     arma::Mat<size_t>& neighbors,
     arma::mat& distances)
 {
+  MLPACK_TRACE_SCOPE("neighbor_search");
+
+  // The reference set is the query set, so it must be up to date.
+  FlushUpdates(true);
+
+  // The results are indexed by point index, so the indices must be contiguous.
+  if (nextIndex != SIZE_MAX && nextIndex != referenceSet->n_cols)
+  {
+    throw std::invalid_argument("NeighborSearch::Search(): cannot search "
+        "without a query set after points have been deleted; call Train() on "
+        "the reference set first");
+  }
+
   if (k > referenceSet->n_cols)
   {
     std::stringstream ss;
@@ -695,6 +767,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   baseCases = 0;
   scores = 0;
+  if (collectStatistics)
+    statistics.Reset(referenceSet->n_cols);
 
   arma::Mat<size_t>* neighborPtr = &neighbors;
   arma::mat* distancePtr = &distances;
@@ -711,39 +785,15 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   neighborPtr->set_size(k, referenceSet->n_cols);
   distancePtr->set_size(k, referenceSet->n_cols);
 
-  // Create the helper object for the traversal.
-  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
-      true /* don't return the same point as nearest neighbor */);
-
   switch (searchMode)
   {
     case NAIVE_MODE:
-    {
-      // The naive brute-force solution.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        for (size_t j = 0; j < referenceSet->n_cols; ++j)
-          rules.BaseCase(i, j);
-
-      baseCases += referenceSet->n_cols * referenceSet->n_cols;
-      break;
-    }
     case SINGLE_TREE_MODE:
+    case GREEDY_SINGLE_TREE_MODE:
     {
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
+      SearchQueryBlocks(*referenceSet, k, *neighborPtr, *distancePtr,
+          searchMode,
+          true /* don't return the same point as nearest neighbor */);
       break;
     }
     case DUAL_TREE_MODE:
@@ -768,6 +818,15 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
         }
       }
 
+      // Create the helper object for the traversal.
+      typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+      RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
+          true /* don't return the same point as nearest neighbor */);
+      if (quantized)
+        rules.QuantizedReferences() = &quantizedSet;
+      if (collectStatistics)
+        rules.Statistics() = &statistics;
+
       // Create the traverser.
       DualTreeTraversalType<RuleType> traverser(rules);
 
@@ -788,37 +847,19 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       scores += rules.Scores();
       baseCases += rules.BaseCases();
 
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
+      MLPACK_LOG(Log::Info) << rules.Scores()
+          << " node combinations were scored." << std::endl;
+      MLPACK_LOG(Log::Info) << rules.BaseCases()
+          << " base cases were calculated." << std::endl;
+
+      rules.GetResults(*neighborPtr, *distancePtr);
 
       // Next time we perform this search, we'll need to reset the tree.
       treeNeedsReset = true;
       break;
     }
-    case GREEDY_SINGLE_TREE_MODE:
-    {
-      // Create the traverser.
-      tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
-      break;
-    }
   }
 
-  rules.GetResults(*neighborPtr, *distancePtr);
-
   // Do we need to map the reference indices?
   if (!oldFromNewReferences.empty() &&
       tree::TreeTraits<Tree>::RearrangesDataset)
@@ -840,9 +881,557 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     // Finished with temporary matrices.
     delete neighborPtr;
     delete distancePtr;
+
+    if (collectStatistics)
+      statistics.MapQueries(oldFromNewReferences);
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+size_t NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::BoundedSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    const size_t maxBaseCases,
+    const double maxTime)
+{
+  if (k > referenceSet->n_cols - numDeleted && pendingSet.n_cols > 0)
+    FlushUpdates(true);
+
+  if (k > referenceSet->n_cols - numDeleted)
+  {
+    std::stringstream ss;
+    ss << "Requested value of k (" << k << ") is greater than the number of "
+        << "points in the reference set (" << referenceSet->n_cols - numDeleted
+        << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  if (searchMode == NAIVE_MODE)
+    throw std::invalid_argument("NeighborSearch::BoundedSearch(): cannot be "
+        "used in naive mode");
+
+  baseCases = 0;
+  scores = 0;
+  if (collectStatistics)
+    statistics.Reset(querySet.n_cols);
+
+  // These do not reallocate if the matrices already have the right size.
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+  RuleType rules(*referenceSet, querySet, k, metric, epsilon);
+  if (numDeleted > 0)
+    rules.DeletedReferences() = &deletedReferences;
+  if (quantized)
+    rules.QuantizedReferences() = &quantizedSet;
+  if (collectStatistics)
+    rules.Statistics() = &statistics;
+
+  SingleTreeTraversalType<RuleType> traverser(rules);
+  tree::GreedySingleTreeTraverser<Tree, RuleType> greedyTraverser(rules);
+
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  size_t greedyQueries = 0;
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    if (searchMode == GREEDY_SINGLE_TREE_MODE)
+    {
+      greedyTraverser.Traverse(i, *referenceTree);
+      continue;
+    }
+
+    const bool outOfBaseCases = (maxBaseCases > 0) &&
+        (rules.BaseCases() >= maxBaseCases);
+    const bool outOfTime = (maxTime > 0.0) &&
+        (std::chrono::duration<double>(std::chrono::steady_clock::now() -
+        start).count() >= maxTime);
+
+    if (outOfBaseCases || outOfTime)
+    {
+      greedyTraverser.Traverse(i, *referenceTree);
+      ++greedyQueries;
+    }
+    else
+    {
+      traverser.Traverse(i, *referenceTree);
+    }
+  }
+
+  scores += rules.Scores();
+  baseCases += rules.BaseCases();
+
+  rules.GetResults(neighbors, distances);
+
+  // Query points are not rearranged, so only the reference indices may need to
+  // be mapped; that is done in place.
+  if (tree::TreeTraits<Tree>::RearrangesDataset &&
+      !oldFromNewReferences.empty())
+  {
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+      if (neighbors[i] != SIZE_MAX)
+        neighbors[i] = oldFromNewReferences[neighbors[i]];
+  }
+
+  if (pendingSet.n_cols > 0)
+    MergePending(querySet, neighbors, distances);
+
+  if (greedyQueries > 0)
+  {
+    Log::Info << "Search budget exhausted; " << greedyQueries << " of "
+        << querySet.n_cols << " query points used greedy search." << std::endl;
+  }
+
+  return greedyQueries;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::SearchQueryBlocks(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    const NeighborSearchMode mode,
+    const bool sameSet)
+{
+  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+
+  if (querySet.n_cols == 0)
+    return;
+
+  // Trees with self-children (i.e. the cover tree) cache the last computed
+  // distance in the node statistics during single-tree scoring, so they cannot
+  // be traversed by several query blocks at the same time.
+  size_t numBlocks = 1;
+  #ifdef HAS_OPENMP
+  if (mode == NAIVE_MODE || !tree::TreeTraits<Tree>::HasSelfChildren)
+  {
+    // Use more blocks than threads so that dynamic scheduling can balance
+    // queries that take different amounts of time.
+    numBlocks = std::min((size_t) querySet.n_cols,
+        (size_t) (16 * omp_get_max_threads()));
+  }
+  #endif
+  const size_t blockSize = (querySet.n_cols + numBlocks - 1) / numBlocks;
+  numBlocks = (querySet.n_cols + blockSize - 1) / blockSize;
+
+  size_t totalBaseCases = 0;
+  size_t totalScores = 0;
+
+  #pragma omp parallel for schedule(dynamic) if (numBlocks > 1) \
+      reduction(+:totalBaseCases, totalScores)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) querySet.n_cols);
+
+    // Only copy the query points if the query set is actually split.
+    MatType queryBlock;
+    if (numBlocks > 1)
+      queryBlock = querySet.cols(begin, end - 1);
+    const MatType& blockSet = (numBlocks > 1) ? queryBlock : querySet;
+
+    RuleType rules(*referenceSet, blockSet, k, metric, epsilon, sameSet,
+        begin);
+    if (numDeleted > 0)
+      rules.DeletedReferences() = &deletedReferences;
+    if (quantized)
+      rules.QuantizedReferences() = &quantizedSet;
+
+    // Statistics are not thread-safe, so each block collects its own.
+    tree::TraversalStatistics blockStatistics;
+    if (collectStatistics)
+    {
+      blockStatistics.Reset(blockSet.n_cols);
+      rules.Statistics() = &blockStatistics;
+    }
+
+    switch (mode)
+    {
+      case NAIVE_MODE:
+      {
+        // The naive brute-force traversal.
+        for (size_t i = 0; i < blockSet.n_cols; ++i)
+          rules.BaseCaseBlock(i, 0, referenceSet->n_cols);
+
+        totalBaseCases += blockSet.n_cols * referenceSet->n_cols;
+        break;
+      }
+      case SINGLE_TREE_MODE:
+      {
+        SingleTreeTraversalType<RuleType> traverser(rules);
+
+        for (size_t i = 0; i < blockSet.n_cols; ++i)
+          traverser.Traverse(i, *referenceTree);
+
+        totalScores += rules.Scores();
+        totalBaseCases += rules.BaseCases();
+        break;
+      }
+      case GREEDY_SINGLE_TREE_MODE:
+      {
+        tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
+
+        for (size_t i = 0; i < blockSet.n_cols; ++i)
+          traverser.Traverse(i, *referenceTree);
+
+        totalScores += rules.Scores();
+        totalBaseCases += rules.BaseCases();
+        break;
+      }
+      default:
+        break;
+    }
+
+    if (numBlocks == 1)
+    {
+      // The output matrices already have the right size, so the results can
+      // be written to them directly.
+      rules.GetResults(neighbors, distances);
+    }
+    else
+    {
+      arma::Mat<size_t> blockNeighbors;
+      arma::mat blockDistances;
+      rules.GetResults(blockNeighbors, blockDistances);
+
+      neighbors.cols(begin, end - 1) = blockNeighbors;
+      distances.cols(begin, end - 1) = blockDistances;
+    }
+
+    if (collectStatistics)
+    {
+      #pragma omp critical
+      statistics.Merge(blockStatistics, begin);
+    }
+  }
+
+  scores += totalScores;
+  baseCases += totalBaseCases;
+
+  if (mode != NAIVE_MODE)
+  {
+    MLPACK_LOG(Log::Info) << totalScores
+        << " node combinations were scored." << std::endl;
+    MLPACK_LOG(Log::Info) << totalBaseCases
+        << " base cases were calculated." << std::endl;
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+size_t NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Insert(
+    const MatType& points)
+{
+  PrepareUpdate("Insert");
+
+  if (points.n_cols > 0 && referenceSet->n_cols + pendingSet.n_cols > 0 &&
+      points.n_rows != std::max(referenceSet->n_rows, pendingSet.n_rows))
+  {
+    std::ostringstream oss;
+    oss << "NeighborSearch::Insert(): dimensionality of new points ("
+        << points.n_rows << ") does not match dimensionality of reference set ("
+        << std::max(referenceSet->n_rows, pendingSet.n_rows) << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t firstIndex = nextIndex;
+  if (pendingSet.n_cols == 0)
+    pendingSet = points;
+  else
+    pendingSet.insert_cols(pendingSet.n_cols, points);
+
+  for (size_t i = 0; i < points.n_cols; ++i)
+    pendingIds.push_back(nextIndex++);
+
+  FlushUpdates(false);
+  return firstIndex;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Delete(const size_t index)
+{
+  PrepareUpdate("Delete");
+
+  // The point may not be in the tree yet.
+  for (size_t i = 0; i < pendingIds.size(); ++i)
+  {
+    if (pendingIds[i] == index)
+    {
+      pendingSet.shed_col(i);
+      pendingIds.erase(pendingIds.begin() + i);
+      return;
+    }
+  }
+
+  // Otherwise we have to find its position in the tree.
+  if (treePositions.empty())
+  {
+    treePositions.resize(nextIndex, SIZE_MAX);
+    for (size_t i = 0; i < oldFromNewReferences.size(); ++i)
+      treePositions[oldFromNewReferences[i]] = i;
+  }
+
+  if (index >= treePositions.size() || treePositions[index] == SIZE_MAX ||
+      (!deletedReferences.empty() && deletedReferences[treePositions[index]]))
+  {
+    std::ostringstream oss;
+    oss << "NeighborSearch::Delete(): there is no point with index " << index
+        << " in the reference set";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (deletedReferences.empty())
+    deletedReferences.resize(referenceSet->n_cols, false);
+  deletedReferences[treePositions[index]] = true;
+  ++numDeleted;
+
+  FlushUpdates(false);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Rebuild()
+{
+  if (searchMode == NAIVE_MODE)
+    return;
+
+  // Collect the live points in the tree, followed by the pending points.
+  const size_t numPoints = referenceSet->n_cols - numDeleted +
+      pendingSet.n_cols;
+  MatType dataset(std::max(referenceSet->n_rows, pendingSet.n_rows),
+      numPoints);
+  std::vector<size_t> indices(numPoints);
+  size_t col = 0;
+  for (size_t i = 0; i < referenceSet->n_cols; ++i)
+  {
+    if (!deletedReferences.empty() && deletedReferences[i])
+      continue;
+
+    dataset.col(col) = referenceSet->col(i);
+    indices[col++] = oldFromNewReferences.empty() ? i : oldFromNewReferences[i];
+  }
+  for (size_t i = 0; i < pendingSet.n_cols; ++i)
+  {
+    dataset.col(col) = pendingSet.col(i);
+    indices[col++] = pendingIds[i];
+  }
+
+  // Remember the next index, since ResetIncrementalState() will forget it.
+  const size_t newNextIndex = nextIndex;
+
+  delete referenceTree;
+  std::vector<size_t> oldFromNew;
+  referenceTree = BuildTree<Tree>(std::move(dataset), oldFromNew);
+  referenceSet = &referenceTree->Dataset();
+  treeNeedsReset = false;
+
+  // Map the new positions to the original indices of the points.
+  if (tree::TreeTraits<Tree>::RearrangesDataset)
+  {
+    oldFromNewReferences.resize(numPoints);
+    for (size_t i = 0; i < numPoints; ++i)
+      oldFromNewReferences[i] = indices[oldFromNew[i]];
+  }
+
+  ResetIncrementalState();
+  nextIndex = newNextIndex;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Quantize(const bool quantize)
+{
+  static_assert(std::is_same<MetricType, metric::EuclideanDistance>::value,
+      "NeighborSearch::Quantize() is only supported with the Euclidean "
+      "distance.");
+
+  if (quantize == quantized)
+    return;
+
+  quantized = quantize;
+  if (quantized)
+    quantizedSet.Train(*referenceSet);
+  else
+    quantizedSet = QuantizedDataset<MatType>();
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::ResetIncrementalState()
+{
+  pendingSet.reset();
+  pendingIds.clear();
+  deletedReferences.clear();
+  numDeleted = 0;
+  nextIndex = SIZE_MAX;
+  treePositions.clear();
+
+  // The codes follow the order of the points in the reference tree.
+  if (quantized)
+    quantizedSet.Train(*referenceSet);
+  else
+    quantizedSet = QuantizedDataset<MatType>();
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::PrepareUpdate(
+    const std::string& method)
+{
+  if (searchMode == NAIVE_MODE)
+  {
+    throw std::invalid_argument("NeighborSearch::" + method + "(): cannot be "
+        "used in naive mode");
+  }
+
+  if (!tree::TreeTraits<Tree>::RearrangesDataset)
+  {
+    throw std::invalid_argument("NeighborSearch::" + method + "(): the tree "
+        "type must rearrange the dataset");
+  }
+
+  // The tree may have been built without a mapping (i.e. if it was passed to
+  // Train()), in which case each point's index is its position.
+  if (oldFromNewReferences.empty() && referenceSet->n_cols > 0)
+  {
+    oldFromNewReferences.resize(referenceSet->n_cols);
+    for (size_t i = 0; i < referenceSet->n_cols; ++i)
+      oldFromNewReferences[i] = i;
+  }
+
+  if (nextIndex == SIZE_MAX)
+  {
+    nextIndex = 0;
+    for (size_t i = 0; i < oldFromNewReferences.size(); ++i)
+      nextIndex = std::max(nextIndex, oldFromNewReferences[i] + 1);
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::FlushUpdates(const bool force)
+{
+  const size_t changes = pendingSet.n_cols + numDeleted;
+  if (changes == 0)
+    return;
+
+  if (force || changes > rebuildFraction * (referenceSet->n_cols - numDeleted))
+    Rebuild();
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::MergePending(
+    const MatType& querySet,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  const size_t k = neighbors.n_rows;
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+  {
+    for (size_t j = 0; j < pendingSet.n_cols; ++j)
+    {
+      const double distance = metric.Evaluate(querySet.col(i),
+          pendingSet.col(j));
+      if (!SortPolicy::IsBetter(distance, distances(k - 1, i)))
+        continue;
+
+      // Insert the point into the sorted list, dropping the worst candidate.
+      size_t pos = k - 1;
+      while (pos > 0 && SortPolicy::IsBetter(distance, distances(pos - 1, i)))
+      {
+        distances(pos, i) = distances(pos - 1, i);
+        neighbors(pos, i) = neighbors(pos - 1, i);
+        --pos;
+      }
+
+      distances(pos, i) = distance;
+      neighbors(pos, i) = pendingIds[j];
+    }
+  }
+
+  baseCases += querySet.n_cols * pendingSet.n_cols;
+}
+
 //! Calculate the average relative error.
 template<typename SortPolicy,
          typename MetricType,
@@ -926,6 +1515,11 @@ void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
 DualTreeTraversalType, SingleTreeTraversalType>::serialize(
     Archive& ar, const uint32_t /* version */)
 {
+  // Pending insertions and deletions are not serialized, so they must be
+  // added to the tree first.
+  if (cereal::is_saving<Archive>())
+    FlushUpdates(true);
+
   // Serialize preferences for search.
   ar(CEREAL_NVP(searchMode));
   ar(CEREAL_NVP(treeNeedsReset));
@@ -978,6 +1572,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::serialize(
   {
     baseCases = 0;
     scores = 0;
+    statistics.Reset(0);
+    ResetIncrementalState();
   }
 }
 
@@ -14,7 +14,12 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
+#include "quantized_dataset.hpp"
+
+#include <chrono>
+#include <memory>
 #include <queue>
 
 namespace mlpack {
@@ -46,13 +51,17 @@ class NeighborSearchRules
    * @param epsilon Relative approximate error.
    * @param sameSet If true, the query and reference set are taken to be the
    *      same, and a query point will not return itself in the results.
+   * @param queryOffset If sameSet is true, this gives the index of the first
+   *      query point in the reference set; this allows the query set to be a
+   *      contiguous block of the reference set.
    */
   NeighborSearchRules(const typename TreeType::Mat& referenceSet,
                       const typename TreeType::Mat& querySet,
                       const size_t k,
                       MetricType& metric,
                       const double epsilon = 0,
-                      const bool sameSet = false);
+                      const bool sameSet = false,
+                      const size_t queryOffset = 0);
 
   /**
    * Store the list of candidates for each query point in the given matrices.
@@ -73,6 +82,21 @@ class NeighborSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Run the base cases between the query point and each of the reference
+   * points [referenceBegin, referenceBegin + count), which is usually the set
+   * of points held in a reference leaf.  The distances are computed as one
+   * block, which is much faster than calling BaseCase() for each reference
+   * point when the metric supports it.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceBegin Index of the first reference point.
+   * @param count Number of reference points.
+   */
+  void BaseCaseBlock(const size_t queryIndex,
+                     const size_t referenceBegin,
+                     const size_t count);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -161,6 +185,32 @@ class NeighborSearchRules
   //! results.  This is only needed in defeatist search mode.
   size_t MinimumBaseCases() const { return k; }
 
+  //! Get the set of deleted reference points (NULL if there are none).
+  const std::vector<bool>* DeletedReferences() const
+  { return deletedReferences; }
+  //! Modify the set of deleted reference points.  A reference point marked as
+  //! deleted is never returned as a neighbor.
+  const std::vector<bool>*& DeletedReferences() { return deletedReferences; }
+
+  //! Get the object that traversal statistics are collected in (NULL if they
+  //! are not collected).
+  tree::TraversalStatistics* Statistics() const { return statistics; }
+  //! Modify the object that traversal statistics are collected in.  If this is
+  //! not NULL, every call to BaseCase(), Score(), and Rescore() is recorded.
+  tree::TraversalStatistics*& Statistics() { return statistics; }
+
+  //! Get the quantized reference set (NULL if base cases use the reference
+  //! set).
+  const QuantizedDataset<typename TreeType::Mat>* QuantizedReferences() const
+  { return quantizedReferences; }
+  //! Modify the quantized reference set.  If this is not NULL, base cases are
+  //! computed with the quantized reference points, and the pruning bounds are
+  //! loosened by the quantization error, so that the results are the exact
+  //! neighbors among the quantized reference points.  Only the Euclidean
+  //! distance is supported.
+  const QuantizedDataset<typename TreeType::Mat>*& QuantizedReferences()
+  { return quantizedReferences; }
+
  protected:
   //! The reference set.
   const typename TreeType::Mat& referenceSet;
@@ -183,8 +233,13 @@ class NeighborSearchRules
   typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
       CandidateList;
 
+  //! Storage for the candidate neighbors.  This is shared between copies of
+  //! the rules, so that copies used by a parallel traversal fill in the same
+  //! results.
+  std::shared_ptr<std::vector<CandidateList>> candidateStorage;
+
   //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  std::vector<CandidateList>& candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -195,6 +250,10 @@ class NeighborSearchRules
   //! Denotes whether or not the reference and query sets are the same.
   bool sameSet;
 
+  //! If sameSet is true, the index of the first query point in the reference
+  //! set.
+  size_t queryOffset;
+
   //! Relative error to be considered in approximate search.
   const double epsilon;
 
@@ -214,6 +273,40 @@ class NeighborSearchRules
   //! traversal before each call to Score().
   TraversalInfoType traversalInfo;
 
+  //! Buffer for the distances computed by BaseCaseBlock().
+  std::vector<typename TreeType::ElemType> distanceBlock;
+
+  //! If not NULL, reference points marked true here are never returned.
+  const std::vector<bool>* deletedReferences;
+
+  //! If not NULL, traversal statistics are collected here.
+  tree::TraversalStatistics* statistics;
+
+  //! If not NULL, base cases are computed with these quantized points.
+  const QuantizedDataset<typename TreeType::Mat>* quantizedReferences;
+
+  //! Loosen the given pruning bound by the quantization error, if base cases
+  //! use quantized points.
+  double Loosen(const double bound) const;
+
+  //! Compute the base case; this is BaseCase() without statistics.
+  double ComputeBaseCase(const size_t queryIndex, const size_t referenceIndex);
+
+  //! Compute the score of a query point and a reference node; this is Score()
+  //! without statistics.
+  double ComputeScore(const size_t queryIndex, TreeType& referenceNode);
+
+  //! Compute the score of a query node and a reference node; this is Score()
+  //! without statistics.
+  double ComputeScore(TreeType& queryNode, TreeType& referenceNode);
+
+  //! Return the number of seconds since the given time.
+  static double Elapsed(const std::chrono::steady_clock::time_point& start)
+  {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+        start).count();
+  }
+
   /**
    * Recalculate the bound for a given query node.
    */
@@ -229,6 +322,25 @@ class NeighborSearchRules
   void InsertNeighbor(const size_t queryIndex,
                       const size_t neighbor,
                       const double distance);
+
+  //! Compute the distances for BaseCaseBlock() with a metric that can evaluate
+  //! blocks of points.
+  template<typename MT = MetricType>
+  void EvaluateBlock(
+      const size_t queryIndex,
+      const size_t referenceBegin,
+      const size_t count,
+      const typename std::enable_if_t<
+          metric::HasEvaluateBlock<MT>::value>* = 0);
+
+  //! Compute the distances for BaseCaseBlock() one pair at a time.
+  template<typename MT = MetricType>
+  void EvaluateBlock(
+      const size_t queryIndex,
+      const size_t referenceBegin,
+      const size_t count,
+      const typename std::enable_if_t<
+          !metric::HasEvaluateBlock<MT>::value>* = 0);
 };
 
 } // namespace neighbor
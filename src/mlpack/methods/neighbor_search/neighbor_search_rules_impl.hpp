@@ -26,17 +26,24 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     const size_t k,
     MetricType& metric,
     const double epsilon,
-    const bool sameSet) :
+    const bool sameSet,
+    const size_t queryOffset) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidateStorage(new std::vector<CandidateList>()),
+    candidates(*candidateStorage),
     k(k),
     metric(metric),
     sameSet(sameSet),
+    queryOffset(queryOffset),
     epsilon(epsilon),
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
     baseCases(0),
-    scores(0)
+    scores(0),
+    deletedReferences(NULL),
+    statistics(NULL),
+    quantizedReferences(NULL)
 {
   // We must set the traversal info last query and reference node pointers to
   // something that is both invalid (i.e. not a tree node) and not NULL.  We'll
@@ -83,21 +90,41 @@ template<typename SortPolicy, typename MetricType, typename TreeType>
 inline force_inline // Absolutely MUST be inline so optimizations can happen.
 double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
 BaseCase(const size_t queryIndex, const size_t referenceIndex)
+{
+  if (!statistics)
+    return ComputeBaseCase(queryIndex, referenceIndex);
+
+  const size_t oldBaseCases = baseCases;
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  const double distance = ComputeBaseCase(queryIndex, referenceIndex);
+  statistics->AddBaseCases(queryIndex, baseCases - oldBaseCases,
+      Elapsed(start));
+  return distance;
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline force_inline // Absolutely MUST be inline so optimizations can happen.
+double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
+ComputeBaseCase(const size_t queryIndex, const size_t referenceIndex)
 {
   // If the datasets are the same, then this search is only using one dataset
   // and we should not return identical points.
-  if (sameSet && (queryIndex == referenceIndex))
+  if (sameSet && (queryIndex + queryOffset == referenceIndex))
     return 0.0;
 
   // If we have already performed this base case, then do not perform it again.
   if ((lastQueryIndex == queryIndex) && (lastReferenceIndex == referenceIndex))
     return lastBaseCase;
 
-  double distance = metric.Evaluate(querySet.col(queryIndex),
-                                    referenceSet.col(referenceIndex));
+  double distance = quantizedReferences ?
+      quantizedReferences->Evaluate(querySet.col(queryIndex), referenceIndex) :
+      metric.Evaluate(querySet.col(queryIndex),
+                      referenceSet.col(referenceIndex));
   ++baseCases;
 
-  InsertNeighbor(queryIndex, referenceIndex, distance);
+  if (!deletedReferences || !(*deletedReferences)[referenceIndex])
+    InsertNeighbor(queryIndex, referenceIndex, distance);
 
   // Cache this information for the next time BaseCase() is called.
   lastQueryIndex = queryIndex;
@@ -107,10 +134,109 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
   return distance;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline void NeighborSearchRules<SortPolicy, MetricType, TreeType>::
+BaseCaseBlock(
+    const size_t queryIndex,
+    const size_t referenceBegin,
+    const size_t count)
+{
+  if (count == 0)
+    return;
+
+  const size_t oldBaseCases = baseCases;
+  std::chrono::steady_clock::time_point start;
+  if (statistics)
+    start = std::chrono::steady_clock::now();
+
+  distanceBlock.resize(count);
+  if (quantizedReferences)
+  {
+    quantizedReferences->EvaluateBlock(querySet.col(queryIndex),
+        referenceBegin, count, distanceBlock.data());
+  }
+  else
+  {
+    EvaluateBlock(queryIndex, referenceBegin, count);
+  }
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    const size_t referenceIndex = referenceBegin + i;
+
+    // Skip identical points and base cases that were already performed, just
+    // like BaseCase().
+    if (sameSet && (queryIndex + queryOffset == referenceIndex))
+      continue;
+    if ((lastQueryIndex == queryIndex) &&
+        (lastReferenceIndex == referenceIndex))
+      continue;
+
+    ++baseCases;
+    if (!deletedReferences || !(*deletedReferences)[referenceIndex])
+      InsertNeighbor(queryIndex, referenceIndex, distanceBlock[i]);
+
+    lastQueryIndex = queryIndex;
+    lastReferenceIndex = referenceIndex;
+    lastBaseCase = distanceBlock[i];
+  }
+
+  if (statistics)
+  {
+    statistics->AddBaseCases(queryIndex, baseCases - oldBaseCases,
+        Elapsed(start));
+  }
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+template<typename MT>
+inline void NeighborSearchRules<SortPolicy, MetricType, TreeType>::
+EvaluateBlock(
+    const size_t queryIndex,
+    const size_t referenceBegin,
+    const size_t count,
+    const typename std::enable_if_t<metric::HasEvaluateBlock<MT>::value>*)
+{
+  metric.EvaluateBlock(querySet.col(queryIndex), referenceSet, referenceBegin,
+      count, distanceBlock.data());
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+template<typename MT>
+inline void NeighborSearchRules<SortPolicy, MetricType, TreeType>::
+EvaluateBlock(
+    const size_t queryIndex,
+    const size_t referenceBegin,
+    const size_t count,
+    const typename std::enable_if_t<!metric::HasEvaluateBlock<MT>::value>*)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    distanceBlock[i] = metric.Evaluate(querySet.col(queryIndex),
+        referenceSet.col(referenceBegin + i));
+  }
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     const size_t queryIndex,
     TreeType& referenceNode)
+{
+  if (!statistics)
+    return ComputeScore(queryIndex, referenceNode);
+
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  const double score = ComputeScore(queryIndex, referenceNode);
+  statistics->AddScore(queryIndex,
+      tree::TraversalStatistics::Level(referenceNode), score == DBL_MAX,
+      Elapsed(start));
+  return score;
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
+ComputeScore(const size_t queryIndex, TreeType& referenceNode)
 {
   ++scores; // Count number of Score() calls.
   double distance;
@@ -144,7 +270,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
 
   // Compare against the best k'th distance for this query point so far.
   double bestDistance = candidates[queryIndex].top().first;
-  bestDistance = SortPolicy::Relax(bestDistance, epsilon);
+  bestDistance = Loosen(SortPolicy::Relax(bestDistance, epsilon));
 
   return (SortPolicy::IsBetter(distance, bestDistance)) ?
       SortPolicy::ConvertToScore(distance) : DBL_MAX;
@@ -169,7 +295,7 @@ GetBestChild(const TreeType& queryNode, TreeType& referenceNode)
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Rescore(
     const size_t queryIndex,
-    TreeType& /* referenceNode */,
+    TreeType& referenceNode,
     const double oldScore) const
 {
   // If we are already pruning, still prune.
@@ -180,20 +306,45 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Rescore(
 
   // Just check the score again against the distances.
   double bestDistance = candidates[queryIndex].top().first;
-  bestDistance = SortPolicy::Relax(bestDistance, epsilon);
+  bestDistance = Loosen(SortPolicy::Relax(bestDistance, epsilon));
+
+  if (SortPolicy::IsBetter(distance, bestDistance))
+    return oldScore;
 
-  return (SortPolicy::IsBetter(distance, bestDistance)) ? oldScore : DBL_MAX;
+  if (statistics)
+  {
+    statistics->AddPrune(queryIndex,
+        tree::TraversalStatistics::Level(referenceNode));
+  }
+
+  return DBL_MAX;
 }
 
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     TreeType& queryNode,
     TreeType& referenceNode)
+{
+  if (!statistics)
+    return ComputeScore(queryNode, referenceNode);
+
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  const double score = ComputeScore(queryNode, referenceNode);
+  statistics->AddScore(SIZE_MAX,
+      tree::TraversalStatistics::Level(referenceNode), score == DBL_MAX,
+      Elapsed(start));
+  return score;
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
+ComputeScore(TreeType& queryNode, TreeType& referenceNode)
 {
   ++scores; // Count number of Score() calls.
 
   // Update our bound.
-  const double bestDistance = CalculateBound(queryNode);
+  const double bestDistance = Loosen(CalculateBound(queryNode));
 
   // Use the traversal info to see if a parent-child or parent-parent prune is
   // possible.  This is a looser bound than we could make, but it might be
@@ -349,7 +500,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Rescore(
     TreeType& queryNode,
-    TreeType& /* referenceNode */,
+    TreeType& referenceNode,
     const double oldScore) const
 {
   if (oldScore == DBL_MAX || oldScore == 0.0)
@@ -358,9 +509,18 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Rescore(
   const double distance = SortPolicy::ConvertToDistance(oldScore);
 
   // Update our bound.
-  const double bestDistance = CalculateBound(queryNode);
+  const double bestDistance = Loosen(CalculateBound(queryNode));
+
+  if (SortPolicy::IsBetter(distance, bestDistance))
+    return oldScore;
+
+  if (statistics)
+  {
+    statistics->AddPrune(SIZE_MAX,
+        tree::TraversalStatistics::Level(referenceNode));
+  }
 
-  return (SortPolicy::IsBetter(distance, bestDistance)) ? oldScore : DBL_MAX;
+  return DBL_MAX;
 }
 
 // Calculate the bound for a given query node in its current state and update
@@ -483,6 +643,20 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
     return bestDistance;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Loosen(
+    const double bound) const
+{
+  if (!quantizedReferences)
+    return bound;
+
+  // The nodes are bounded with the full-precision reference points, and each
+  // quantized point is within MaxError() of its full-precision point.  The
+  // first point of a node may be used as its center, so a node can hold
+  // quantized points up to twice that much better than its score.
+  return SortPolicy::CombineWorst(bound, 2 * quantizedReferences->MaxError());
+}
+
 /**
  * Helper function to insert a point into the list of candidate points.
  *
@@ -0,0 +1,164 @@
+/**
+ * @file methods/neighbor_search/nn_descent.hpp
+ *
+ * Defines the NNDescent class, which builds an approximate all-k-nearest-
+ * neighbor graph of a dataset with the NN-Descent algorithm.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NN_DESCENT_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NN_DESCENT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+#include "sort_policies/nearest_neighbor_sort.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The NNDescent class builds an approximate all-k-nearest-neighbor graph with
+ * NN-Descent (Dong, Charikar and Li, 2011), which relies on the neighbors of
+ * the neighbors of a point being likely to be its neighbors too.  Starting
+ * from random neighbor lists, each iteration compares, for every point, the
+ * pairs of points in its neighbor lists and in its reverse neighbor lists (the
+ * "local join"), and keeps the better neighbors found.  Only pairs with at
+ * least one neighbor that is new since the last iteration are compared, and
+ * the iterations stop when few neighbor lists change.
+ *
+ * Unlike a tree, this needs nothing but distance evaluations, so it does not
+ * degrade with the dimensionality of the data, and any metric can be used
+ * (such as metric::LMetric or metric::IPMetric).  The neighbor lists are
+ * sorted as with NeighborSearchRules, according to the SortPolicy.
+ *
+ * The local joins of each iteration run in parallel; the proposed neighbors
+ * are then grouped by point and merged into the neighbor lists in parallel, so
+ * no locks are needed.
+ *
+ * @code
+ * extern arma::mat dataset;
+ *
+ * NNDescent<> nnd;
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * nnd.Search(dataset, 10, neighbors, distances);
+ * @endcode
+ *
+ * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ * @tparam MetricType The metric to use for computation.
+ * @tparam MatType The type of data matrix.
+ */
+template<typename SortPolicy = NearestNeighborSort,
+         typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat>
+class NNDescent
+{
+ public:
+  /**
+   * Create the NNDescent object with the given parameters.
+   *
+   * @param maxIterations Maximum number of iterations.
+   * @param sampleRate Fraction of k of the new and reverse neighbors of each
+   *     point that take part in its local join in each iteration.
+   * @param tolerance The iterations stop when fewer than tolerance * n * k
+   *     neighbors change in an iteration.
+   * @param metric Instantiated metric.
+   */
+  NNDescent(const size_t maxIterations = 10,
+            const double sampleRate = 1.0,
+            const double tolerance = 0.001,
+            const MetricType metric = MetricType());
+
+  /**
+   * Compute the approximate k nearest neighbors of each point of the dataset,
+   * excluding the point itself.  The results have the same form as those of
+   * NeighborSearch::Search() without a query set: column i of neighbors and
+   * distances holds the neighbors of point i, from best to worst.
+   *
+   * @param referenceSet Set of points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each point.
+   * @param distances Matrix storing distances of neighbors for each point.
+   */
+  void Search(const MatType& referenceSet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the sample rate.
+  double SampleRate() const { return sampleRate; }
+  //! Modify the sample rate.
+  double& SampleRate() { return sampleRate; }
+
+  //! Get the tolerance.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the number of iterations of the last search.
+  size_t Iterations() const { return iterations; }
+  //! Get the number of distance evaluations of the last search.
+  size_t DistanceEvaluations() const { return distanceEvaluations; }
+
+  //! Access the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+ private:
+  //! A neighbor proposed to a point by a local join.
+  struct Update
+  {
+    size_t point;
+    size_t neighbor;
+    double distance;
+  };
+
+  /**
+   * Insert a neighbor into the sorted list of the given point if it is better
+   * than the worst neighbor and not in the list yet.  Return whether it was
+   * inserted.
+   */
+  bool Insert(const size_t point,
+              const size_t neighbor,
+              const double distance,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              std::vector<char>& isNew) const;
+
+  /**
+   * Keep a random subset of at most the given number of elements of the given
+   * list.
+   */
+  static void Sample(std::vector<size_t>& list, const size_t size);
+
+  //! The maximum number of iterations.
+  size_t maxIterations;
+  //! The fraction of k of the new and reverse neighbors that are joined.
+  double sampleRate;
+  //! The fraction of neighbors that must change to keep iterating.
+  double tolerance;
+  //! The instantiated metric.
+  MetricType metric;
+  //! The number of iterations of the last search.
+  size_t iterations;
+  //! The number of distance evaluations of the last search.
+  size_t distanceEvaluations;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "nn_descent_impl.hpp"
+
+#endif
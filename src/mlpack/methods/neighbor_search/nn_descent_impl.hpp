@@ -0,0 +1,319 @@
+/**
+ * @file methods/neighbor_search/nn_descent_impl.hpp
+ *
+ * Implementation of the NNDescent class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NN_DESCENT_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NN_DESCENT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "nn_descent.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+NNDescent<SortPolicy, MetricType, MatType>::NNDescent(
+    const size_t maxIterations,
+    const double sampleRate,
+    const double tolerance,
+    const MetricType metric) :
+    maxIterations(maxIterations),
+    sampleRate(sampleRate),
+    tolerance(tolerance),
+    metric(metric),
+    iterations(0),
+    distanceEvaluations(0)
+{
+  if (sampleRate <= 0.0 || sampleRate > 1.0)
+  {
+    throw std::invalid_argument("NNDescent::NNDescent(): sampleRate must be in "
+        "(0, 1]");
+  }
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+void NNDescent<SortPolicy, MetricType, MatType>::Search(
+    const MatType& referenceSet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  const size_t n = referenceSet.n_cols;
+  if (k >= n)
+  {
+    std::stringstream ss;
+    ss << "NNDescent::Search(): requested value of k (" << k << ") must be "
+        << "less than the number of points in the reference set (" << n << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  neighbors.set_size(k, n);
+  distances.set_size(k, n);
+  iterations = 0;
+  distanceEvaluations = 0;
+  if (k == 0)
+    return;
+
+  // Start from random neighbors.  They are drawn serially, so that the result
+  // only depends on the random seed.
+  for (size_t i = 0; i < n; ++i)
+  {
+    for (size_t j = 0; j < k; ++j)
+    {
+      size_t candidate;
+      do
+      {
+        candidate = (size_t) math::RandInt(n);
+      } while (candidate == i || std::find(neighbors.colptr(i),
+          neighbors.colptr(i) + j, candidate) != neighbors.colptr(i) + j);
+
+      neighbors(j, i) = candidate;
+    }
+  }
+
+  #pragma omp parallel
+  {
+    std::vector<std::pair<double, size_t>> list(k);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+    {
+      for (size_t j = 0; j < k; ++j)
+      {
+        list[j].first = metric.Evaluate(referenceSet.col(i),
+            referenceSet.col(neighbors(j, i)));
+        list[j].second = neighbors(j, i);
+      }
+
+      std::sort(list.begin(), list.end(),
+          [](const std::pair<double, size_t>& a,
+             const std::pair<double, size_t>& b)
+          {
+            if (a.first == b.first)
+              return a.second < b.second;
+            return SortPolicy::IsBetter(a.first, b.first);
+          });
+
+      for (size_t j = 0; j < k; ++j)
+      {
+        distances(j, i) = list[j].first;
+        neighbors(j, i) = list[j].second;
+      }
+    }
+  }
+  distanceEvaluations += n * k;
+
+  // Every neighbor is new at first.
+  std::vector<char> isNew(n * k, 1);
+
+  const size_t sampleSize = std::max((size_t) 1,
+      (size_t) std::ceil(sampleRate * k));
+  std::vector<std::vector<size_t>> newLists(n), oldLists(n);
+  std::vector<std::vector<size_t>> newReverse(n), oldReverse(n);
+  std::vector<size_t> newPositions;
+  std::vector<Update> updates;
+
+  while (iterations < maxIterations)
+  {
+    ++iterations;
+
+    // Split the neighbors of each point into old ones and a sample of the new
+    // ones; the sampled new neighbors are old from now on.
+    for (size_t i = 0; i < n; ++i)
+    {
+      newLists[i].clear();
+      oldLists[i].clear();
+      newReverse[i].clear();
+      oldReverse[i].clear();
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+      newPositions.clear();
+      for (size_t j = 0; j < k; ++j)
+      {
+        if (isNew[i * k + j])
+          newPositions.push_back(j);
+        else
+          oldLists[i].push_back(neighbors(j, i));
+      }
+
+      Sample(newPositions, sampleSize);
+      for (size_t j = 0; j < newPositions.size(); ++j)
+      {
+        isNew[i * k + newPositions[j]] = 0;
+        newLists[i].push_back(neighbors(newPositions[j], i));
+      }
+
+      for (size_t j = 0; j < newLists[i].size(); ++j)
+        newReverse[newLists[i][j]].push_back(i);
+      for (size_t j = 0; j < oldLists[i].size(); ++j)
+        oldReverse[oldLists[i][j]].push_back(i);
+    }
+
+    // Add a sample of the reverse neighbors of each point.
+    for (size_t i = 0; i < n; ++i)
+    {
+      Sample(newReverse[i], sampleSize);
+      newLists[i].insert(newLists[i].end(), newReverse[i].begin(),
+          newReverse[i].end());
+      std::sort(newLists[i].begin(), newLists[i].end());
+      newLists[i].erase(std::unique(newLists[i].begin(), newLists[i].end()),
+          newLists[i].end());
+
+      Sample(oldReverse[i], sampleSize);
+      oldLists[i].insert(oldLists[i].end(), oldReverse[i].begin(),
+          oldReverse[i].end());
+      std::sort(oldLists[i].begin(), oldLists[i].end());
+      oldLists[i].erase(std::unique(oldLists[i].begin(), oldLists[i].end()),
+          oldLists[i].end());
+    }
+
+    // The worst distance of each point only improves during the iteration, so
+    // proposals that are not better than the worst distance at the start of
+    // the iteration can be dropped right away.
+    const arma::vec worst = distances.row(k - 1).t();
+
+    // The local join of each point compares its new neighbors with each other
+    // and with its old neighbors, and proposes each pair to both points.
+    updates.clear();
+    size_t evaluations = 0;
+    #pragma omp parallel reduction(+:evaluations)
+    {
+      std::vector<Update> localUpdates;
+      auto join = [&](const size_t a, const size_t b)
+      {
+        const double distance = metric.Evaluate(referenceSet.col(a),
+            referenceSet.col(b));
+        ++evaluations;
+        if (distance != worst[a] && SortPolicy::IsBetter(distance, worst[a]))
+          localUpdates.push_back(Update{ a, b, distance });
+        if (distance != worst[b] && SortPolicy::IsBetter(distance, worst[b]))
+          localUpdates.push_back(Update{ b, a, distance });
+      };
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t v = 0; v < (omp_size_t) n; ++v)
+      {
+        const std::vector<size_t>& newList = newLists[v];
+        const std::vector<size_t>& oldList = oldLists[v];
+        for (size_t a = 0; a < newList.size(); ++a)
+        {
+          for (size_t b = a + 1; b < newList.size(); ++b)
+            join(newList[a], newList[b]);
+          for (size_t b = 0; b < oldList.size(); ++b)
+          {
+            if (oldList[b] != newList[a])
+              join(newList[a], oldList[b]);
+          }
+        }
+      }
+
+      #pragma omp critical
+      updates.insert(updates.end(), localUpdates.begin(), localUpdates.end());
+    }
+    distanceEvaluations += evaluations;
+
+    // Group the proposals by point, so that each point's list is only updated
+    // by one thread.  The resulting lists do not depend on the order of the
+    // proposals.
+    std::vector<size_t> start(n + 1, 0);
+    for (size_t u = 0; u < updates.size(); ++u)
+      ++start[updates[u].point + 1];
+    for (size_t i = 0; i < n; ++i)
+      start[i + 1] += start[i];
+    std::vector<size_t> order(updates.size());
+    std::vector<size_t> next(start.begin(), start.end() - 1);
+    for (size_t u = 0; u < updates.size(); ++u)
+      order[next[updates[u].point]++] = u;
+
+    size_t changes = 0;
+    #pragma omp parallel for reduction(+:changes) schedule(dynamic, 64)
+    for (omp_size_t v = 0; v < (omp_size_t) n; ++v)
+    {
+      for (size_t u = start[v]; u < start[v + 1]; ++u)
+      {
+        const Update& update = updates[order[u]];
+        if (Insert(v, update.neighbor, update.distance, neighbors, distances,
+            isNew))
+          ++changes;
+      }
+    }
+
+    Log::Info << "NNDescent::Search(): iteration " << iterations << ": "
+        << changes << " neighbors changed." << std::endl;
+    if (changes == 0 || changes < tolerance * n * k)
+      break;
+  }
+
+  Log::Info << "NNDescent::Search(): " << distanceEvaluations << " distance "
+      << "evaluations in " << iterations << " iterations." << std::endl;
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+bool NNDescent<SortPolicy, MetricType, MatType>::Insert(
+    const size_t point,
+    const size_t neighbor,
+    const double distance,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    std::vector<char>& isNew) const
+{
+  const size_t k = neighbors.n_rows;
+  size_t* pointNeighbors = neighbors.colptr(point);
+  double* pointDistances = distances.colptr(point);
+  char* pointIsNew = &isNew[point * k];
+
+  if (distance == pointDistances[k - 1] ||
+      !SortPolicy::IsBetter(distance, pointDistances[k - 1]))
+    return false;
+  if (std::find(pointNeighbors, pointNeighbors + k, neighbor) !=
+      pointNeighbors + k)
+    return false;
+
+  // Shift the worse neighbors down, dropping the worst one.
+  size_t position = k - 1;
+  while (position > 0 && distance != pointDistances[position - 1] &&
+      SortPolicy::IsBetter(distance, pointDistances[position - 1]))
+  {
+    pointNeighbors[position] = pointNeighbors[position - 1];
+    pointDistances[position] = pointDistances[position - 1];
+    pointIsNew[position] = pointIsNew[position - 1];
+    --position;
+  }
+
+  pointNeighbors[position] = neighbor;
+  pointDistances[position] = distance;
+  pointIsNew[position] = 1;
+  return true;
+}
+
+template<typename SortPolicy, typename MetricType, typename MatType>
+void NNDescent<SortPolicy, MetricType, MatType>::Sample(
+    std::vector<size_t>& list,
+    const size_t size)
+{
+  if (list.size() <= size)
+    return;
+
+  // A partial Fisher-Yates shuffle.
+  for (size_t i = 0; i < size; ++i)
+  {
+    const size_t j = (size_t) math::RandInt((int) i, (int) list.size());
+    std::swap(list[i], list[j]);
+  }
+  list.resize(size);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -21,7 +21,11 @@
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/spill_tree.hpp>
 #include <mlpack/core/tree/octree.hpp>
+#include <mlpack/core/tree/tree_tuner.hpp>
+#include <mlpack/core/data/mapped_file.hpp>
+#include <fstream>
 #include "neighbor_search.hpp"
+#include "hnsw.hpp"
 
 namespace mlpack {
 namespace neighbor {
@@ -31,7 +35,10 @@ namespace neighbor {
  * supported by NSModel.  All NeighborSearch type wrappers inherit from this
  * class, allowing a simple interface via inheritance for all the different
  * types we want to support.
+ *
+ * @tparam MatType The type of data matrix.
  */
+template<typename MatType = arma::mat>
 class NSWrapperBase
 {
  public:
@@ -47,7 +54,7 @@ class NSWrapperBase
   virtual ~NSWrapperBase() { }
 
   //! Return a reference to the dataset.
-  virtual const arma::mat& Dataset() const = 0;
+  virtual const MatType& Dataset() const = 0;
 
   //! Get the search mode.
   virtual NeighborSearchMode SearchMode() const = 0;
@@ -59,9 +66,21 @@ class NSWrapperBase
   //! Modify the approximation parameter epsilon.
   virtual double& Epsilon() = 0;
 
+  //! Get whether or not traversal statistics are collected.
+  virtual bool CollectStatistics() const = 0;
+  //! Modify whether or not traversal statistics are collected.
+  virtual bool& CollectStatistics() = 0;
+  //! Get the traversal statistics of the last search.
+  virtual const tree::TraversalStatistics& Statistics() const = 0;
+
+  //! Get whether or not base cases use the quantized reference set.
+  virtual bool Quantized() const = 0;
+  //! Set whether or not base cases use the quantized reference set.
+  virtual void Quantize(const bool quantize) = 0;
+
   //! Train the NeighborSearch model with the given parameters.
   virtual void Train(util::Timers& timers,
-                     arma::mat&& referenceSet,
+                     MatType&& referenceSet,
                      const size_t leafSize,
                      const double tau,
                      const double rho) = 0;
@@ -69,7 +88,7 @@ class NSWrapperBase
   //! Perform bichromatic neighbor search (i.e. search with a separate query
   //! set).
   virtual void Search(util::Timers& timers,
-                      arma::mat&& querySet,
+                      MatType&& querySet,
                       const size_t k,
                       arma::Mat<size_t>& neighbors,
                       arma::mat& distances,
@@ -91,15 +110,16 @@ template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType = arma::mat,
          template<typename RuleType> class DualTreeTraversalType =
              TreeType<metric::EuclideanDistance,
                       NeighborSearchStat<SortPolicy>,
-                      arma::mat>::template DualTreeTraverser,
+                      MatType>::template DualTreeTraverser,
          template<typename RuleType> class SingleTreeTraversalType =
              TreeType<metric::EuclideanDistance,
                       NeighborSearchStat<SortPolicy>,
-                      arma::mat>::template SingleTreeTraverser>
-class NSWrapper : public NSWrapperBase
+                      MatType>::template SingleTreeTraverser>
+class NSWrapper : public NSWrapperBase<MatType>
 {
  public:
   //! Construct the NSWrapper object, initializing the internally-held
@@ -119,7 +139,7 @@ class NSWrapper : public NSWrapperBase
   virtual NSWrapper* Clone() const { return new NSWrapper(*this); }
 
   //! Get a reference to the reference set.
-  const arma::mat& Dataset() const { return ns.ReferenceSet(); }
+  const MatType& Dataset() const { return ns.ReferenceSet(); }
 
   //! Get the search mode.
   NeighborSearchMode SearchMode() const { return ns.SearchMode(); }
@@ -131,10 +151,25 @@ class NSWrapper : public NSWrapperBase
   //! Modify epsilon, the approximation parameter.
   double& Epsilon() { return ns.Epsilon(); }
 
+  //! Get whether or not traversal statistics are collected.
+  bool CollectStatistics() const { return ns.CollectStatistics(); }
+  //! Modify whether or not traversal statistics are collected.
+  bool& CollectStatistics() { return ns.CollectStatistics(); }
+  //! Get the traversal statistics of the last search.
+  const tree::TraversalStatistics& Statistics() const
+  {
+    return ns.Statistics();
+  }
+
+  //! Get whether or not base cases use the quantized reference set.
+  bool Quantized() const { return ns.Quantized(); }
+  //! Set whether or not base cases use the quantized reference set.
+  void Quantize(const bool quantize) { ns.Quantize(quantize); }
+
   //! Train the model with the given options.  For NSWrapper, we ignore the
   //! extra parameters.
   virtual void Train(util::Timers& timers,
-                     arma::mat&& referenceSet,
+                     MatType&& referenceSet,
                      const size_t /* leafSize */,
                      const double /* tau */,
                      const double /* rho */);
@@ -142,7 +177,7 @@ class NSWrapper : public NSWrapperBase
   //! Perform bichromatic neighbor search (i.e. search with a separate query
   //! set).  For NSWrapper, we ignore the extra parameters.
   virtual void Search(util::Timers& timers,
-                      arma::mat&& querySet,
+                      MatType&& querySet,
                       const size_t k,
                       arma::Mat<size_t>& neighbors,
                       arma::mat& distances,
@@ -167,7 +202,7 @@ class NSWrapper : public NSWrapperBase
   // Convenience typedef for the neighbor search type held by this class.
   typedef NeighborSearch<SortPolicy,
                          metric::EuclideanDistance,
-                         arma::mat,
+                         MatType,
                          TreeType,
                          DualTreeTraversalType,
                          SingleTreeTraversalType> NSType;
@@ -185,17 +220,19 @@ template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType = arma::mat,
          template<typename RuleType> class DualTreeTraversalType =
              TreeType<metric::EuclideanDistance,
                       NeighborSearchStat<SortPolicy>,
-                      arma::mat>::template DualTreeTraverser,
+                      MatType>::template DualTreeTraverser,
          template<typename RuleType> class SingleTreeTraversalType =
              TreeType<metric::EuclideanDistance,
                       NeighborSearchStat<SortPolicy>,
-                      arma::mat>::template SingleTreeTraverser>
+                      MatType>::template SingleTreeTraverser>
 class LeafSizeNSWrapper :
     public NSWrapper<SortPolicy,
                      TreeType,
+                     MatType,
                      DualTreeTraversalType,
                      SingleTreeTraversalType>
 {
@@ -206,6 +243,7 @@ class LeafSizeNSWrapper :
                     const double epsilon) :
       NSWrapper<SortPolicy,
                 TreeType,
+                MatType,
                 DualTreeTraversalType,
                 SingleTreeTraversalType>(searchMode, epsilon)
   {
@@ -224,7 +262,7 @@ class LeafSizeNSWrapper :
   //! Train a model with the given parameters.  This overload uses leafSize but
   //! ignores the other parameters.
   virtual void Train(util::Timers& timers,
-                     arma::mat&& referenceSet,
+                     MatType&& referenceSet,
                      const size_t leafSize,
                      const double /* tau */,
                      const double /* rho */);
@@ -232,7 +270,7 @@ class LeafSizeNSWrapper :
   //! Perform bichromatic search (e.g. search with a separate query set).  This
   //! overload uses the leaf size, but ignores the other parameters.
   virtual void Search(util::Timers& timers,
-                      arma::mat&& querySet,
+                      MatType&& querySet,
                       const size_t k,
                       arma::Mat<size_t>& neighbors,
                       arma::mat& distances,
@@ -246,28 +284,53 @@ class LeafSizeNSWrapper :
     ar(CEREAL_NVP(ns));
   }
 
+  /**
+   * Write the reference tree and the point mapping to the given stream in the
+   * flat layout of tree::FlatTree.  The tree must use HRectBound bounds.
+   *
+   * @param stream Binary stream to write to.
+   */
+  void SaveFlat(std::ostream& stream) const;
+
+  /**
+   * Load the reference tree and the point mapping from the given mapped file,
+   * starting at the given offset, which is then updated to point past the
+   * data.  The dataset of the tree is not copied: it refers to the mapped
+   * memory, so the file is held by the wrapper until it is no longer needed.
+   *
+   * @param file Mapped file to load from.
+   * @param offset Offset (in bytes) of the tree in the file.
+   */
+  void LoadFlat(const std::shared_ptr<data::MappedFile>& file, size_t& offset);
+
  protected:
   using NSWrapper<SortPolicy,
                   TreeType,
+                  MatType,
                   DualTreeTraversalType,
                   SingleTreeTraversalType>::ns;
+
+  //! The mapped file the reference tree refers to, if it was loaded with
+  //! LoadFlat().
+  std::shared_ptr<data::MappedFile> mappedFile;
 };
 
 /**
  * The SpillNSWrapper class wraps the NeighborSearch class when the spill tree
  * is used.
  */
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType = arma::mat>
 class SpillNSWrapper :
     public NSWrapper<
         SortPolicy,
         tree::SPTree,
+        MatType,
         tree::SPTree<metric::EuclideanDistance,
                      NeighborSearchStat<SortPolicy>,
-                     arma::mat>::template DefeatistDualTreeTraverser,
+                     MatType>::template DefeatistDualTreeTraverser,
         tree::SPTree<metric::EuclideanDistance,
                      NeighborSearchStat<SortPolicy>,
-                     arma::mat>::template DefeatistSingleTreeTraverser>
+                     MatType>::template DefeatistSingleTreeTraverser>
 {
  public:
   //! Construct the SpillNSWrapper.
@@ -276,12 +339,13 @@ class SpillNSWrapper :
       NSWrapper<
           SortPolicy,
           tree::SPTree,
+          MatType,
           tree::SPTree<metric::EuclideanDistance,
                        NeighborSearchStat<SortPolicy>,
-                       arma::mat>::template DefeatistDualTreeTraverser,
+                       MatType>::template DefeatistDualTreeTraverser,
           tree::SPTree<metric::EuclideanDistance,
                        NeighborSearchStat<SortPolicy>,
-                       arma::mat>::template DefeatistSingleTreeTraverser>(
+                       MatType>::template DefeatistSingleTreeTraverser>(
           searchMode, epsilon)
   {
     // Nothing to do.
@@ -295,7 +359,7 @@ class SpillNSWrapper :
 
   //! Train the model using the given parameters.
   virtual void Train(util::Timers& timers,
-                     arma::mat&& referenceSet,
+                     MatType&& referenceSet,
                      const size_t leafSize,
                      const double tau,
                      const double rho);
@@ -303,7 +367,7 @@ class SpillNSWrapper :
   //! Perform bichromatic search (i.e. search with a different query set) using
   //! the given parameters.
   virtual void Search(util::Timers& timers,
-                      arma::mat&& querySet,
+                      MatType&& querySet,
                       const size_t k,
                       arma::Mat<size_t>& neighbors,
                       arma::mat& distances,
@@ -321,12 +385,133 @@ class SpillNSWrapper :
   using NSWrapper<
       SortPolicy,
       tree::SPTree,
+      MatType,
       tree::SPTree<metric::EuclideanDistance,
                    NeighborSearchStat<SortPolicy>,
-                   arma::mat>::template DefeatistDualTreeTraverser,
+                   MatType>::template DefeatistDualTreeTraverser,
       tree::SPTree<metric::EuclideanDistance,
                    NeighborSearchStat<SortPolicy>,
-                   arma::mat>::template DefeatistSingleTreeTraverser>::ns;
+                   MatType>::template DefeatistSingleTreeTraverser>::ns;
+};
+
+/**
+ * The HNSWWrapper class wraps the HNSW graph index.  The graph takes the place
+ * of the reference tree; the search mode and epsilon are kept, but they do not
+ * affect the search, and no traversal statistics are collected.
+ */
+template<typename SortPolicy, typename MatType = arma::mat>
+class HNSWWrapper : public NSWrapperBase<MatType>
+{
+ public:
+  //! Construct the HNSWWrapper with the given graph parameters.
+  HNSWWrapper(const NeighborSearchMode searchMode,
+              const double epsilon,
+              const size_t m,
+              const size_t efConstruction,
+              const size_t ef) :
+      hnsw(m, efConstruction, ef),
+      searchMode(searchMode),
+      epsilon(epsilon),
+      collectStatistics(false)
+  {
+    // Nothing else to do.
+  }
+
+  //! Destruct the HNSWWrapper.
+  virtual ~HNSWWrapper() { }
+
+  //! Return a copy of the HNSWWrapper.
+  virtual HNSWWrapper* Clone() const { return new HNSWWrapper(*this); }
+
+  //! Get a reference to the reference set.
+  const MatType& Dataset() const { return hnsw.ReferenceSet(); }
+
+  //! Get the search mode.
+  NeighborSearchMode SearchMode() const { return searchMode; }
+  //! Modify the search mode.
+  NeighborSearchMode& SearchMode() { return searchMode; }
+
+  //! Get epsilon, the approximation parameter.
+  double Epsilon() const { return epsilon; }
+  //! Modify epsilon, the approximation parameter.
+  double& Epsilon() { return epsilon; }
+
+  //! Get whether or not traversal statistics are collected.
+  bool CollectStatistics() const { return collectStatistics; }
+  //! Modify whether or not traversal statistics are collected.
+  bool& CollectStatistics() { return collectStatistics; }
+  //! Get the traversal statistics of the last search (always empty).
+  const tree::TraversalStatistics& Statistics() const { return statistics; }
+
+  //! The HNSW graph does not use quantized base cases.
+  bool Quantized() const { return false; }
+  //! The HNSW graph does not use quantized base cases, so this throws an
+  //! exception if quantize is true.
+  void Quantize(const bool quantize)
+  {
+    if (quantize)
+    {
+      throw std::invalid_argument("NSModel::Quantize(): quantized search is "
+          "not supported with HNSW graphs");
+    }
+  }
+
+  //! Get the graph index.
+  const HNSW<SortPolicy, metric::EuclideanDistance, MatType>& Index() const
+  {
+    return hnsw;
+  }
+  //! Modify the graph index.
+  HNSW<SortPolicy, metric::EuclideanDistance, MatType>& Index()
+  {
+    return hnsw;
+  }
+
+  //! Build the graph on the given reference set.  The tree parameters are
+  //! ignored.
+  virtual void Train(util::Timers& timers,
+                     MatType&& referenceSet,
+                     const size_t /* leafSize */,
+                     const double /* tau */,
+                     const double /* rho */);
+
+  //! Perform bichromatic search (i.e. search with a separate query set).  The
+  //! tree parameters are ignored.
+  virtual void Search(util::Timers& timers,
+                      MatType&& querySet,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances,
+                      const size_t /* leafSize */,
+                      const double /* rho */);
+
+  //! Perform monochromatic neighbor search (i.e. use the reference set as the
+  //! query set).
+  virtual void Search(util::Timers& timers,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances);
+
+  //! Serialize the graph index.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(hnsw));
+    ar(CEREAL_NVP(searchMode));
+    ar(CEREAL_NVP(epsilon));
+  }
+
+ protected:
+  //! The graph index.
+  HNSW<SortPolicy, metric::EuclideanDistance, MatType> hnsw;
+  //! The search mode (unused by the graph).
+  NeighborSearchMode searchMode;
+  //! The approximation parameter (unused by the graph).
+  double epsilon;
+  //! Whether traversal statistics are requested (none are collected).
+  bool collectStatistics;
+  //! Empty traversal statistics.
+  tree::TraversalStatistics statistics;
 };
 
 /**
@@ -338,8 +523,9 @@ class SpillNSWrapper :
  * mlpack_knn and mlpack_kfn, be aware that it is limited!
  *
  * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ * @tparam MatType The type of data matrix (i.e. arma::mat or arma::fmat).
  */
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType = arma::mat>
 class NSModel
 {
  public:
@@ -360,7 +546,9 @@ class NSModel
     MAX_RP_TREE,
     SPILL_TREE,
     UB_TREE,
-    OCTREE
+    OCTREE,
+    MORTON_TREE,
+    HNSW_GRAPH
   };
 
  private:
@@ -370,17 +558,37 @@ class NSModel
   //! If true, random projections are used.
   bool randomBasis;
   //! This is the random projection matrix; only used if randomBasis is true.
-  arma::mat q;
+  MatType q;
 
   size_t leafSize;
   double tau;
   double rho;
 
+  //! Parameters of the HNSW graph; only used if treeType is HNSW_GRAPH.
+  size_t hnswM;
+  size_t efConstruction;
+  size_t ef;
+
   /**
    * nSearch holds an instance of the NeighborSearch class for the current
    * treeType. It is initialized every time BuildModel is executed.
    */
-  NSWrapperBase* nSearch;
+  NSWrapperBase<MatType>* nSearch;
+
+  //! Identifier written at the start of files saved with SaveMapped().
+  static constexpr uint64_t mappedMagic = 0x3150414D4E4B4C4DULL;
+
+  //! The header of files saved with SaveMapped().
+  struct MappedHeader
+  {
+    uint64_t magic;
+    uint64_t searchMode;
+    double epsilon;
+    uint64_t leafSize;
+    uint64_t randomBasis;
+    uint64_t qRows;
+    uint64_t qCols;
+  };
 
  public:
   /**
@@ -429,7 +637,7 @@ class NSModel
   void serialize(Archive& ar, const uint32_t /* version */);
 
   //! Expose the dataset.
-  const arma::mat& Dataset() const;
+  const MatType& Dataset() const;
 
   //! Expose SearchMode.
   NeighborSearchMode SearchMode() const;
@@ -447,10 +655,41 @@ class NSModel
   double Rho() const { return rho; }
   double& Rho() { return rho; }
 
+  //! Expose the number of links of each point of the HNSW graph.
+  size_t HNSWM() const { return hnswM; }
+  size_t& HNSWM() { return hnswM; }
+
+  //! Expose the number of candidates explored when building the HNSW graph.
+  size_t EfConstruction() const { return efConstruction; }
+  size_t& EfConstruction() { return efConstruction; }
+
+  //! Expose the number of candidates explored when searching the HNSW graph.
+  size_t Ef() const { return ef; }
+  size_t& Ef() { return ef; }
+
   //! Expose Epsilon.
   double Epsilon() const;
   double& Epsilon();
 
+  //! Expose whether or not traversal statistics are collected.
+  bool CollectStatistics() const;
+  bool& CollectStatistics();
+
+  //! Expose the traversal statistics of the last search.
+  const tree::TraversalStatistics& Statistics() const;
+
+  /**
+   * Set whether or not base cases are computed with an 8-bit scalar-quantized
+   * copy of the reference set; see NeighborSearch::Quantize().  This must be
+   * called after BuildModel() or after the model is loaded, since neither
+   * keeps the setting.  HNSW graphs cannot be quantized.
+   *
+   * @param quantize Whether or not to search the quantized reference set.
+   */
+  void Quantize(const bool quantize = true);
+  //! Get whether or not base cases use the quantized reference set.
+  bool Quantized() const;
+
   //! Expose treeType.
   TreeTypes TreeType() const { return treeType; }
   TreeTypes& TreeType() { return treeType; }
@@ -465,13 +704,40 @@ class NSModel
 
   //! Build the reference tree.
   void BuildModel(util::Timers& timers,
-                  arma::mat&& referenceSet,
+                  MatType&& referenceSet,
                   const NeighborSearchMode searchMode,
                   const double epsilon = 0);
 
+  /**
+   * Choose the tree type and the leaf size with the given tuner: kd-trees,
+   * ball trees, vantage point trees, random projection trees, cover trees and
+   * R* trees are built on a sample of the reference set and searched with a
+   * sample of the queries, and TreeType() and LeafSize() are set to the
+   * configuration with the lowest estimated cost of building the tree and
+   * answering all the queries.  The tree is not built; call BuildModel()
+   * afterwards.  This is what the knn and kfn bindings do when the tree type is
+   * 'auto'.
+   *
+   * @param timers Object to hold timing information in.
+   * @param referenceSet Reference set the model will be built on.
+   * @param querySet Query set that will be searched; if empty, the search is
+   *      assumed to be monochromatic.
+   * @param k Number of neighbors that will be searched for.
+   * @param searchMode Search mode that will be used.
+   * @param epsilon Relative approximation error that will be used.
+   * @param tuner Tuner that samples the data and tries the candidates.
+   */
+  void Tune(util::Timers& timers,
+            const MatType& referenceSet,
+            const MatType& querySet,
+            const size_t k,
+            const NeighborSearchMode searchMode,
+            const double epsilon = 0,
+            const tree::TreeTuner& tuner = tree::TreeTuner());
+
   //! Perform neighbor search.  The query set will be reordered.
   void Search(util::Timers& timers,
-              arma::mat&& querySet,
+              MatType&& querySet,
               const size_t k,
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
@@ -482,6 +748,26 @@ class NSModel
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
+  /**
+   * Save the model to the given file in a flat binary layout that LoadMapped()
+   * can use without deserialization: the reference set is stored in one
+   * contiguous block and is memory-mapped, not copied, when the model is
+   * loaded.  Only kd-tree models are supported.  The file uses the byte order
+   * of the current machine.
+   *
+   * @param filename File to save to.
+   */
+  void SaveMapped(const std::string& filename) const;
+
+  /**
+   * Load a model that was saved with SaveMapped().  The reference set remains
+   * memory-mapped for the lifetime of the model, so the file must not be
+   * modified while the model is in use.
+   *
+   * @param filename File to load from.
+   */
+  void LoadMapped(const std::string& filename);
+
   //! Return a string representation of the current tree type.
   std::string TreeName() const;
 };
@@ -27,12 +27,14 @@ template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 void NSWrapper<
-    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+    SortPolicy, TreeType, MatType, DualTreeTraversalType,
+    SingleTreeTraversalType
 >::Train(util::Timers& timers,
-         arma::mat&& referenceSet,
+         MatType&& referenceSet,
          const size_t /* leafSize */,
          const double /* tau */,
          const double /* rho */)
@@ -52,12 +54,14 @@ template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 void NSWrapper<
-    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+    SortPolicy, TreeType, MatType, DualTreeTraversalType,
+    SingleTreeTraversalType
 >::Search(util::Timers& timers,
-          arma::mat&& querySet,
+          MatType&& querySet,
           const size_t k,
           arma::Mat<size_t>& neighbors,
           arma::mat& distances,
@@ -74,12 +78,16 @@ void NSWrapper<
     timers.Start("computing_neighbors");
     ns.Search(queryTree, k, neighbors, distances);
     timers.Stop("computing_neighbors");
+    timers.Count("base_cases", ns.BaseCases());
+    timers.Count("scores", ns.Scores());
   }
   else
   {
     timers.Start("computing_neighbors");
     ns.Search(std::move(querySet), k, neighbors, distances);
     timers.Stop("computing_neighbors");
+    timers.Count("base_cases", ns.BaseCases());
+    timers.Count("scores", ns.Scores());
   }
 }
 
@@ -89,10 +97,12 @@ template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 void NSWrapper<
-    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+    SortPolicy, TreeType, MatType, DualTreeTraversalType,
+    SingleTreeTraversalType
 >::Search(util::Timers& timers,
           const size_t k,
           arma::Mat<size_t>& neighbors,
@@ -101,6 +111,8 @@ void NSWrapper<
   timers.Start("computing_neighbors");
   ns.Search(k, neighbors, distances);
   timers.Stop("computing_neighbors");
+  timers.Count("base_cases", ns.BaseCases());
+  timers.Count("scores", ns.Scores());
 }
 
 //! Train a model with the given parameters.  This overload uses leafSize but
@@ -109,12 +121,14 @@ template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 void LeafSizeNSWrapper<
-    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+    SortPolicy, TreeType, MatType, DualTreeTraversalType,
+    SingleTreeTraversalType
 >::Train(util::Timers& timers,
-         arma::mat&& referenceSet,
+         MatType&& referenceSet,
          const size_t leafSize,
          const double /* tau */,
          const double /* rho */)
@@ -142,12 +156,14 @@ template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 void LeafSizeNSWrapper<
-    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+    SortPolicy, TreeType, MatType, DualTreeTraversalType,
+    SingleTreeTraversalType
 >::Search(util::Timers& timers,
-          arma::mat&& querySet,
+          MatType&& querySet,
           const size_t k,
           arma::Mat<size_t>& neighbors,
           arma::mat& distances,
@@ -171,6 +187,8 @@ void LeafSizeNSWrapper<
     timers.Start("computing_neighbors");
     ns.Search(queryTree, k, neighborsOut, distancesOut);
     timers.Stop("computing_neighbors");
+    timers.Count("base_cases", ns.BaseCases());
+    timers.Count("scores", ns.Scores());
 
     // Unmap the query points.
     distances.set_size(distancesOut.n_rows, distancesOut.n_cols);
@@ -180,22 +198,122 @@ void LeafSizeNSWrapper<
       neighbors.col(oldFromNewQueries[i]) = neighborsOut.col(i);
       distances.col(oldFromNewQueries[i]) = distancesOut.col(i);
     }
+
+    if (ns.CollectStatistics())
+      ns.statistics.MapQueries(oldFromNewQueries);
   }
   else
   {
     timers.Start("computing_neighbors");
     ns.Search(querySet, k, neighbors, distances);
     timers.Stop("computing_neighbors");
+    timers.Count("base_cases", ns.BaseCases());
+    timers.Count("scores", ns.Scores());
+  }
+}
+
+
+//! Write the reference tree and point mapping in the flat layout.
+template<typename SortPolicy,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         typename MatType,
+         template<typename RuleType> class DualTreeTraversalType,
+         template<typename RuleType> class SingleTreeTraversalType>
+void LeafSizeNSWrapper<
+    SortPolicy, TreeType, MatType, DualTreeTraversalType,
+    SingleTreeTraversalType
+>::SaveFlat(std::ostream& stream) const
+{
+  if (ns.SearchMode() == NAIVE_MODE)
+  {
+    throw std::invalid_argument("LeafSizeNSWrapper::SaveFlat(): cannot save a "
+        "model without a reference tree");
+  }
+
+  if (ns.NumPending() > 0 || ns.NumDeleted() > 0)
+  {
+    throw std::invalid_argument("LeafSizeNSWrapper::SaveFlat(): the model has "
+        "pending insertions or deletions; call Rebuild() first");
+  }
+
+  tree::FlatTree::Save(ns.ReferenceTree(), stream);
+
+  const uint64_t numMappings = ns.oldFromNewReferences.size();
+  stream.write((const char*) &numMappings, sizeof(uint64_t));
+  for (size_t i = 0; i < ns.oldFromNewReferences.size(); ++i)
+  {
+    const uint64_t index = ns.oldFromNewReferences[i];
+    stream.write((const char*) &index, sizeof(uint64_t));
+  }
+}
+
+//! Load the reference tree and point mapping from a mapped file.
+template<typename SortPolicy,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         typename MatType,
+         template<typename RuleType> class DualTreeTraversalType,
+         template<typename RuleType> class SingleTreeTraversalType>
+void LeafSizeNSWrapper<
+    SortPolicy, TreeType, MatType, DualTreeTraversalType,
+    SingleTreeTraversalType
+>::LoadFlat(const std::shared_ptr<data::MappedFile>& file, size_t& offset)
+{
+  if (ns.SearchMode() == NAIVE_MODE)
+  {
+    throw std::invalid_argument("LeafSizeNSWrapper::LoadFlat(): cannot load a "
+        "reference tree for naive search");
+  }
+
+  typedef typename decltype(ns)::Tree Tree;
+  Tree* referenceTree = tree::FlatTree::Load<Tree>(*file, offset);
+
+  uint64_t numMappings = 0;
+  if (offset + sizeof(uint64_t) <= file->Size())
+    std::memcpy(&numMappings, file->Data() + offset, sizeof(uint64_t));
+  offset += sizeof(uint64_t);
+  if (numMappings != referenceTree->Dataset().n_cols ||
+      offset + sizeof(uint64_t) * numMappings > file->Size())
+  {
+    delete referenceTree;
+    throw std::runtime_error("LeafSizeNSWrapper::LoadFlat(): file '" +
+        file->Filename() + "' is truncated or corrupt");
+  }
+
+  std::vector<size_t> oldFromNewReferences(numMappings);
+  for (size_t i = 0; i < numMappings; ++i)
+  {
+    uint64_t index;
+    std::memcpy(&index, file->Data() + offset, sizeof(uint64_t));
+    oldFromNewReferences[i] = index;
+    offset += sizeof(uint64_t);
   }
+
+  // Release whatever the NeighborSearch object held before; this must happen
+  // before the old mapped file (if any) is released.
+  if (ns.referenceTree)
+    delete ns.referenceTree;
+  else
+    delete ns.referenceSet;
+
+  ns.referenceTree = referenceTree;
+  ns.referenceSet = &referenceTree->Dataset();
+  ns.oldFromNewReferences = std::move(oldFromNewReferences);
+  ns.treeNeedsReset = false;
+  ns.ResetIncrementalState();
+  mappedFile = file;
 }
 
 //! Train the model using the given parameters.
-template<typename SortPolicy>
-void SpillNSWrapper<SortPolicy>::Train(util::Timers& timers,
-                                       arma::mat&& referenceSet,
-                                       const size_t leafSize,
-                                       const double tau,
-                                       const double rho)
+template<typename SortPolicy, typename MatType>
+void SpillNSWrapper<SortPolicy, MatType>::Train(util::Timers& timers,
+                                                MatType&& referenceSet,
+                                                const size_t leafSize,
+                                                const double tau,
+                                                const double rho)
 {
   timers.Start("tree_building");
   typename decltype(ns)::Tree tree(std::move(referenceSet), tau, leafSize,
@@ -207,14 +325,15 @@ void SpillNSWrapper<SortPolicy>::Train(util::Timers& timers,
 
 //! Perform bichromatic search (i.e. search with a different query set) using
 //! the given parameters.
-template<typename SortPolicy>
-void SpillNSWrapper<SortPolicy>::Search(util::Timers& timers,
-                                        arma::mat&& querySet,
-                                        const size_t k,
-                                        arma::Mat<size_t>& neighbors,
-                                        arma::mat& distances,
-                                        const size_t leafSize,
-                                        const double rho)
+template<typename SortPolicy, typename MatType>
+void SpillNSWrapper<SortPolicy, MatType>::Search(
+    util::Timers& timers,
+    MatType&& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    const size_t leafSize,
+    const double rho)
 {
   if (ns.SearchMode() == DUAL_TREE_MODE)
   {
@@ -228,52 +347,108 @@ void SpillNSWrapper<SortPolicy>::Search(util::Timers& timers,
     timers.Start("computing_neighbors");
     ns.Search(queryTree, k, neighbors, distances);
     timers.Stop("computing_neighbors");
+    timers.Count("base_cases", ns.BaseCases());
+    timers.Count("scores", ns.Scores());
   }
   else
   {
     timers.Start("computing_neighbors");
     ns.Search(querySet, k, neighbors, distances);
     timers.Stop("computing_neighbors");
+    timers.Count("base_cases", ns.BaseCases());
+    timers.Count("scores", ns.Scores());
   }
 }
 
+//! Build the graph on the given reference set.
+template<typename SortPolicy, typename MatType>
+void HNSWWrapper<SortPolicy, MatType>::Train(util::Timers& timers,
+                                             MatType&& referenceSet,
+                                             const size_t /* leafSize */,
+                                             const double /* tau */,
+                                             const double /* rho */)
+{
+  timers.Start("tree_building");
+  hnsw.Train(std::move(referenceSet));
+  timers.Stop("tree_building");
+}
+
+//! Perform bichromatic search (i.e. search with a separate query set).
+template<typename SortPolicy, typename MatType>
+void HNSWWrapper<SortPolicy, MatType>::Search(util::Timers& timers,
+                                              MatType&& querySet,
+                                              const size_t k,
+                                              arma::Mat<size_t>& neighbors,
+                                              arma::mat& distances,
+                                              const size_t /* leafSize */,
+                                              const double /* rho */)
+{
+  timers.Start("computing_neighbors");
+  hnsw.Search(querySet, k, neighbors, distances);
+  timers.Stop("computing_neighbors");
+  timers.Count("base_cases", hnsw.BaseCases());
+}
+
+//! Perform monochromatic search (i.e. use the reference set as the query
+//! set).
+template<typename SortPolicy, typename MatType>
+void HNSWWrapper<SortPolicy, MatType>::Search(util::Timers& timers,
+                                              const size_t k,
+                                              arma::Mat<size_t>& neighbors,
+                                              arma::mat& distances)
+{
+  timers.Start("computing_neighbors");
+  hnsw.Search(k, neighbors, distances);
+  timers.Stop("computing_neighbors");
+  timers.Count("base_cases", hnsw.BaseCases());
+}
+
 /**
  * Initialize the NSModel with the given type and whether or not a random
  * basis should be used.
  */
-template<typename SortPolicy>
-NSModel<SortPolicy>::NSModel(TreeTypes treeType, bool randomBasis) :
+template<typename SortPolicy, typename MatType>
+NSModel<SortPolicy, MatType>::NSModel(TreeTypes treeType, bool randomBasis) :
     treeType(treeType),
     randomBasis(randomBasis),
     leafSize(20),
     tau(0.0),
     rho(0.7),
+    hnswM(16),
+    efConstruction(200),
+    ef(50),
     nSearch(NULL)
 {
   // Nothing to do.
 }
 
-template<typename SortPolicy>
-NSModel<SortPolicy>::NSModel(const NSModel& other) :
+template<typename SortPolicy, typename MatType>
+NSModel<SortPolicy, MatType>::NSModel(const NSModel& other) :
     treeType(other.treeType),
     randomBasis(other.randomBasis),
     q(other.q),
     leafSize(other.leafSize),
     tau(other.tau),
     rho(other.rho),
+    hnswM(other.hnswM),
+    efConstruction(other.efConstruction),
+    ef(other.ef),
     nSearch(other.nSearch->Clone())
 {
   // Nothing to do.
 }
 
-template<typename SortPolicy>
-NSModel<SortPolicy>::NSModel(NSModel&& other) :
+template<typename SortPolicy, typename MatType>
+NSModel<SortPolicy, MatType>::NSModel(NSModel&& other) :
     treeType(other.treeType),
     randomBasis(other.randomBasis),
     q(std::move(other.q)),
     leafSize(other.leafSize),
     tau(other.tau),
     rho(other.rho),
+    hnswM(other.hnswM),
+    efConstruction(other.efConstruction),
+    ef(other.ef),
     nSearch(other.nSearch)
 {
   // Reset parameters of the other model.
@@ -282,11 +457,15 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
   other.leafSize = 20;
   other.tau = 0.0;
   other.rho = 0.7;
+  other.hnswM = 16;
+  other.efConstruction = 200;
+  other.ef = 50;
   other.nSearch = NULL;
 }
 
-template<typename SortPolicy>
-NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(const NSModel& other)
+template<typename SortPolicy, typename MatType>
+NSModel<SortPolicy, MatType>&
+NSModel<SortPolicy, MatType>::operator=(const NSModel& other)
 {
   if (this != &other)
   {
@@ -298,14 +477,18 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(const NSModel& other)
     leafSize = other.leafSize;
     tau = other.tau;
     rho = other.rho;
+    hnswM = other.hnswM;
+    efConstruction = other.efConstruction;
+    ef = other.ef;
     nSearch = other.nSearch->Clone();
   }
 
   return *this;
 }
 
-template<typename SortPolicy>
-NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
+template<typename SortPolicy, typename MatType>
+NSModel<SortPolicy, MatType>&
+NSModel<SortPolicy, MatType>::operator=(NSModel&& other)
 {
   if (this != &other)
   {
@@ -317,6 +500,9 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
     leafSize = other.leafSize;
     tau = other.tau;
     rho = other.rho;
+    hnswM = other.hnswM;
+    efConstruction = other.efConstruction;
+    ef = other.ef;
     nSearch = other.nSearch;
 
     // Reset parameters of the other model.
@@ -325,6 +511,9 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
     other.leafSize = 20;
     other.tau = 0.0;
     other.rho = 0.7;
+    other.hnswM = 16;
+    other.efConstruction = 200;
+    other.ef = 50;
     other.nSearch = NULL;
   }
 
@@ -332,16 +521,17 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
 }
 
 //! Clean memory, if necessary.
-template<typename SortPolicy>
-NSModel<SortPolicy>::~NSModel()
+template<typename SortPolicy, typename MatType>
+NSModel<SortPolicy, MatType>::~NSModel()
 {
   delete nSearch;
 }
 
 //! Serialize the kNN model.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<typename Archive>
-void NSModel<SortPolicy>::serialize(Archive& ar, const uint32_t /* version */)
+void NSModel<SortPolicy, MatType>::serialize(Archive& ar,
+                                             const uint32_t /* version */)
 {
   ar(CEREAL_NVP(treeType));
   ar(CEREAL_NVP(randomBasis));
@@ -359,154 +549,212 @@ void NSModel<SortPolicy>::serialize(Archive& ar, const uint32_t /* version */)
   {
     case KD_TREE:
       {
-        LeafSizeNSWrapper<SortPolicy, tree::KDTree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy,
-                         tree::KDTree>&>(*nSearch);
+        typedef LeafSizeNSWrapper<SortPolicy, tree::KDTree, MatType>
+            WrapperType;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case COVER_TREE:
       {
-        NSWrapper<SortPolicy, tree::StandardCoverTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy,
-                                   tree::StandardCoverTree>&>(*nSearch);
+        typedef NSWrapper<SortPolicy, tree::StandardCoverTree, MatType>
+            WrapperType;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case R_TREE:
       {
-        NSWrapper<SortPolicy, tree::RTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, tree::RTree>&>(*nSearch);
+        typedef NSWrapper<SortPolicy, tree::RTree, MatType> WrapperType;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case R_STAR_TREE:
       {
-        NSWrapper<SortPolicy, tree::RStarTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, tree::RStarTree>&>(*nSearch);
+        typedef NSWrapper<SortPolicy, tree::RStarTree, MatType> WrapperType;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case BALL_TREE:
       {
-        LeafSizeNSWrapper<SortPolicy, tree::BallTree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy,
-                                           tree::BallTree>&>(*nSearch);
+        typedef LeafSizeNSWrapper<SortPolicy, tree::BallTree, MatType>
+            WrapperType;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case X_TREE:
       {
-        NSWrapper<SortPolicy, tree::XTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, tree::XTree>&>(*nSearch);
+        typedef NSWrapper<SortPolicy, tree::XTree, MatType> WrapperType;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case HILBERT_R_TREE:
       {
-        NSWrapper<SortPolicy, tree::HilbertRTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, tree::HilbertRTree>&>(*nSearch);
+        typedef NSWrapper<SortPolicy, tree::HilbertRTree, MatType> WrapperType;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case R_PLUS_TREE:
       {
-        NSWrapper<SortPolicy, tree::RPlusTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, tree::RPlusTree>&>(*nSearch);
+        typedef NSWrapper<SortPolicy, tree::RPlusTree, MatType> WrapperType;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case R_PLUS_PLUS_TREE:
       {
-        NSWrapper<SortPolicy, tree::RPlusPlusTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, tree::RPlusPlusTree>&>(*nSearch);
+        typedef NSWrapper<SortPolicy, tree::RPlusPlusTree, MatType> WrapperType;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case SPILL_TREE:
       {
-        SpillNSWrapper<SortPolicy>& typedSearch =
-            dynamic_cast<SpillNSWrapper<SortPolicy>&>(*nSearch);
+        typedef SpillNSWrapper<SortPolicy, MatType> WrapperType;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case VP_TREE:
       {
-        LeafSizeNSWrapper<SortPolicy, tree::VPTree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy, tree::VPTree>&>(*nSearch);
+        typedef LeafSizeNSWrapper<SortPolicy, tree::VPTree, MatType>
+            WrapperType;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case RP_TREE:
       {
-        LeafSizeNSWrapper<SortPolicy, tree::RPTree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy, tree::RPTree>&>(*nSearch);
+        typedef LeafSizeNSWrapper<SortPolicy, tree::RPTree, MatType>
+            WrapperType;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case MAX_RP_TREE:
       {
-        LeafSizeNSWrapper<SortPolicy, tree::MaxRPTree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy, tree::MaxRPTree>&>(
-            *nSearch);
+        typedef LeafSizeNSWrapper<SortPolicy, tree::MaxRPTree, MatType>
+            WrapperType;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case UB_TREE:
       {
-        LeafSizeNSWrapper<SortPolicy, tree::UBTree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy, tree::UBTree>&>(*nSearch);
+        typedef LeafSizeNSWrapper<SortPolicy, tree::UBTree, MatType>
+            WrapperType;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case OCTREE:
       {
-        LeafSizeNSWrapper<SortPolicy, tree::Octree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy,
-                                           tree::Octree>&>(*nSearch);
+        typedef LeafSizeNSWrapper<SortPolicy, tree::Octree, MatType>
+            WrapperType;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
+    case MORTON_TREE:
+      {
+        typedef LeafSizeNSWrapper<SortPolicy, tree::MortonTree, MatType>
+            WrapperType;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
+        ar(CEREAL_NVP(typedSearch));
+        break;
+      }
+    case HNSW_GRAPH:
+      {
+        typedef HNSWWrapper<SortPolicy, MatType> WrapperType;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
+        ar(CEREAL_NVP(typedSearch));
+
+        // The graph parameters are held by the graph.
+        if (cereal::is_loading<Archive>())
+        {
+          hnswM = typedSearch.Index().M();
+          efConstruction = typedSearch.Index().EfConstruction();
+          ef = typedSearch.Index().Ef();
+        }
+        break;
+      }
   }
 }
 
 //! Expose the dataset.
-template<typename SortPolicy>
-const arma::mat& NSModel<SortPolicy>::Dataset() const
+template<typename SortPolicy, typename MatType>
+const MatType& NSModel<SortPolicy, MatType>::Dataset() const
 {
   return nSearch->Dataset();
 }
 
 //! Access the search mode.
-template<typename SortPolicy>
-NeighborSearchMode NSModel<SortPolicy>::SearchMode() const
+template<typename SortPolicy, typename MatType>
+NeighborSearchMode NSModel<SortPolicy, MatType>::SearchMode() const
 {
   return nSearch->SearchMode();
 }
 
 //! Modify the search mode.
-template<typename SortPolicy>
-NeighborSearchMode& NSModel<SortPolicy>::SearchMode()
+template<typename SortPolicy, typename MatType>
+NeighborSearchMode& NSModel<SortPolicy, MatType>::SearchMode()
 {
   return nSearch->SearchMode();
 }
 
-template<typename SortPolicy>
-double NSModel<SortPolicy>::Epsilon() const
+template<typename SortPolicy, typename MatType>
+double NSModel<SortPolicy, MatType>::Epsilon() const
 {
   return nSearch->Epsilon();
 }
 
-template<typename SortPolicy>
-double& NSModel<SortPolicy>::Epsilon()
+template<typename SortPolicy, typename MatType>
+double& NSModel<SortPolicy, MatType>::Epsilon()
 {
   return nSearch->Epsilon();
 }
 
+template<typename SortPolicy, typename MatType>
+bool NSModel<SortPolicy, MatType>::CollectStatistics() const
+{
+  return nSearch->CollectStatistics();
+}
+
+template<typename SortPolicy, typename MatType>
+bool& NSModel<SortPolicy, MatType>::CollectStatistics()
+{
+  return nSearch->CollectStatistics();
+}
+
+template<typename SortPolicy, typename MatType>
+const tree::TraversalStatistics& NSModel<SortPolicy, MatType>::Statistics()
+    const
+{
+  return nSearch->Statistics();
+}
+
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::Quantize(const bool quantize)
+{
+  nSearch->Quantize(quantize);
+}
+
+template<typename SortPolicy, typename MatType>
+bool NSModel<SortPolicy, MatType>::Quantized() const
+{
+  return nSearch->Quantized();
+}
+
 //! Initialize a model given the tree type.  (No training happens here.)
-template<typename SortPolicy>
-void NSModel<SortPolicy>::InitializeModel(const NeighborSearchMode searchMode,
-                                          const double epsilon)
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::InitializeModel(
+    const NeighborSearchMode searchMode,
+    const double epsilon)
 {
   // Clear existing memory.
   if (nSearch)
@@ -515,69 +763,82 @@ void NSModel<SortPolicy>::InitializeModel(const NeighborSearchMode searchMode,
   switch (treeType)
   {
     case KD_TREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, tree::KDTree>(searchMode,
-          epsilon);
+      nSearch = new LeafSizeNSWrapper<SortPolicy, tree::KDTree, MatType>(
+          searchMode, epsilon);
       break;
     case COVER_TREE:
-      nSearch = new NSWrapper<SortPolicy, tree::StandardCoverTree>(searchMode,
-          epsilon);
+      nSearch = new NSWrapper<SortPolicy, tree::StandardCoverTree, MatType>(
+          searchMode, epsilon);
       break;
     case R_TREE:
-      nSearch = new NSWrapper<SortPolicy, tree::RTree>(searchMode, epsilon);
+      nSearch = new NSWrapper<SortPolicy, tree::RTree, MatType>(
+          searchMode, epsilon);
       break;
     case R_STAR_TREE:
-      nSearch = new NSWrapper<SortPolicy, tree::RStarTree>(searchMode, epsilon);
+      nSearch = new NSWrapper<SortPolicy, tree::RStarTree, MatType>(
+          searchMode, epsilon);
       break;
     case BALL_TREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, tree::BallTree>(searchMode,
-          epsilon);
+      nSearch = new LeafSizeNSWrapper<SortPolicy, tree::BallTree, MatType>(
+          searchMode, epsilon);
       break;
     case X_TREE:
-      nSearch = new NSWrapper<SortPolicy, tree::XTree>(searchMode, epsilon);
+      nSearch = new NSWrapper<SortPolicy, tree::XTree, MatType>(
+          searchMode, epsilon);
       break;
     case HILBERT_R_TREE:
-      nSearch = new NSWrapper<SortPolicy, tree::HilbertRTree>(searchMode,
-          epsilon);
+      nSearch = new NSWrapper<SortPolicy, tree::HilbertRTree, MatType>(
+          searchMode, epsilon);
       break;
     case R_PLUS_TREE:
-      nSearch = new NSWrapper<SortPolicy, tree::RPlusTree>(searchMode, epsilon);
+      nSearch = new NSWrapper<SortPolicy, tree::RPlusTree, MatType>(
+          searchMode, epsilon);
       break;
     case R_PLUS_PLUS_TREE:
-      nSearch = new NSWrapper<SortPolicy, tree::RPlusPlusTree>(searchMode,
-          epsilon);
+      nSearch = new NSWrapper<SortPolicy, tree::RPlusPlusTree, MatType>(
+          searchMode, epsilon);
+      break;
+    case SPILL_TREE:
+      nSearch = new SpillNSWrapper<SortPolicy, MatType>(searchMode, epsilon);
       break;
     case VP_TREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, tree::VPTree>(searchMode,
-          epsilon);
+      nSearch = new LeafSizeNSWrapper<SortPolicy, tree::VPTree, MatType>(
+          searchMode, epsilon);
       break;
     case RP_TREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, tree::RPTree>(searchMode,
-          epsilon);
+      nSearch = new LeafSizeNSWrapper<SortPolicy, tree::RPTree, MatType>(
+          searchMode, epsilon);
       break;
     case MAX_RP_TREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, tree::MaxRPTree>(searchMode,
-          epsilon);
-      break;
-    case SPILL_TREE:
-      nSearch = new SpillNSWrapper<SortPolicy>(searchMode, epsilon);
+      nSearch = new LeafSizeNSWrapper<SortPolicy, tree::MaxRPTree, MatType>(
+          searchMode, epsilon);
       break;
     case UB_TREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, tree::UBTree>(searchMode,
-          epsilon);
+      nSearch = new LeafSizeNSWrapper<SortPolicy, tree::UBTree, MatType>(
+          searchMode, epsilon);
       break;
     case OCTREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, tree::Octree>(searchMode,
-          epsilon);
+      nSearch = new LeafSizeNSWrapper<SortPolicy, tree::Octree, MatType>(
+          searchMode, epsilon);
+      break;
+    case MORTON_TREE:
+      nSearch = new LeafSizeNSWrapper<SortPolicy, tree::MortonTree, MatType>(
+          searchMode, epsilon);
+      break;
+    case HNSW_GRAPH:
+      nSearch = new HNSWWrapper<SortPolicy, MatType>(searchMode, epsilon,
+          hnswM, efConstruction, ef);
       break;
   }
 }
 
 //! Build the reference tree.
-template<typename SortPolicy>
-void NSModel<SortPolicy>::BuildModel(util::Timers& timers,
-                                     arma::mat&& referenceSet,
-                                     const NeighborSearchMode searchMode,
-                                     const double epsilon)
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::BuildModel(
+    util::Timers& timers,
+    MatType&& referenceSet,
+    const NeighborSearchMode searchMode,
+    const double epsilon)
 {
   // Initialize random basis if necessary.
   if (randomBasis)
@@ -588,11 +849,11 @@ void NSModel<SortPolicy>::BuildModel(util::Timers& timers,
     {
       // [Q, R] = qr(randn(d, d));
       // Q = Q * diag(sign(diag(R)));
-      arma::mat r;
-      if (arma::qr(q, r, arma::randn<arma::mat>(referenceSet.n_rows,
+      MatType r;
+      if (arma::qr(q, r, arma::randn<MatType>(referenceSet.n_rows,
               referenceSet.n_rows)))
       {
-        arma::vec rDiag(r.n_rows);
+        arma::Col<typename MatType::elem_type> rDiag(r.n_rows);
         for (size_t i = 0; i < rDiag.n_elem; ++i)
         {
           if (r(i, i) < 0)
@@ -615,23 +876,88 @@ void NSModel<SortPolicy>::BuildModel(util::Timers& timers,
     timers.Stop("computing_random_basis");
   }
 
-  if (searchMode != NAIVE_MODE)
+  if (treeType == HNSW_GRAPH)
+    Log::Info << "Building " << TreeName() << "..." << std::endl;
+  else if (searchMode != NAIVE_MODE)
     Log::Info << "Building reference tree..." << std::endl;
 
   InitializeModel(searchMode, epsilon);
   nSearch->Train(timers, std::move(referenceSet), leafSize, tau, rho);
 
-  if (searchMode != NAIVE_MODE)
+  if (treeType == HNSW_GRAPH || searchMode != NAIVE_MODE)
     Log::Info << "Tree built." << std::endl;
 }
 
+//! Choose the tree type and the leaf size.
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::Tune(util::Timers& timers,
+                                        const MatType& referenceSet,
+                                        const MatType& querySet,
+                                        const size_t k,
+                                        const NeighborSearchMode searchMode,
+                                        const double epsilon,
+                                        const tree::TreeTuner& tuner)
+{
+  timers.Start("tree_tuning");
+  Log::Info << "Choosing the tree type for " << k << "-neighbor search..."
+      << std::endl;
+
+  // The candidates are searched directly through their wrappers, so that the
+  // trials are not reported like real searches.
+  NSModel trial;
+  trial.tau = tau;
+  trial.rho = rho;
+
+  const TreeTypes treeTypes[] = { KD_TREE, BALL_TREE, VP_TREE, MAX_RP_TREE,
+      COVER_TREE, R_STAR_TREE };
+  std::vector<tree::TreeCandidate> candidates;
+  for (size_t i = 0; i < sizeof(treeTypes) / sizeof(TreeTypes); ++i)
+  {
+    trial.treeType = treeTypes[i];
+    tuner.AddCandidates(candidates, treeTypes[i], trial.TreeName(),
+        treeTypes[i] != COVER_TREE && treeTypes[i] != R_STAR_TREE);
+  }
+
+  // The reference sample may have fewer points than the number of neighbors.
+  const size_t sampleK = std::max<size_t>(1, std::min(k,
+      std::min((size_t) referenceSet.n_cols, tuner.ReferenceSamples())));
+
+  auto build = [&](const tree::TreeCandidate& candidate,
+                   MatType&& references)
+  {
+    trial.treeType = (TreeTypes) candidate.treeType;
+    trial.leafSize = (candidate.leafSize > 0) ? candidate.leafSize : leafSize;
+    trial.InitializeModel(searchMode, epsilon);
+
+    util::Timers buildTimers;
+    trial.nSearch->Train(buildTimers, std::move(references), trial.leafSize,
+        trial.tau, trial.rho);
+  };
+
+  auto search = [&](MatType&& queries, util::Timers& searchTimers)
+  {
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    trial.nSearch->Search(searchTimers, std::move(queries), sampleK, neighbors,
+        distances, trial.leafSize, trial.rho);
+  };
+
+  const size_t best = tuner.Tune(referenceSet, querySet, candidates, build,
+      search);
+  treeType = (TreeTypes) candidates[best].treeType;
+  if (candidates[best].leafSize > 0)
+    leafSize = candidates[best].leafSize;
+
+  timers.Stop("tree_tuning");
+}
+
 //! Perform neighbor search.  The query set will be reordered.
-template<typename SortPolicy>
-void NSModel<SortPolicy>::Search(util::Timers& timers,
-                                 arma::mat&& querySet,
-                                 const size_t k,
-                                 arma::Mat<size_t>& neighbors,
-                                 arma::mat& distances)
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::Search(util::Timers& timers,
+                                          MatType&& querySet,
+                                          const size_t k,
+                                          arma::Mat<size_t>& neighbors,
+                                          arma::mat& distances)
 {
   // We may need to map the query set randomly.
   if (randomBasis)
@@ -643,21 +969,32 @@ void NSModel<SortPolicy>::Search(util::Timers& timers,
 
   Log::Info << "Searching for " << k << " neighbors with ";
 
-  switch (SearchMode())
+  // The graph is searched the same way in every search mode, with the current
+  // value of ef.
+  if (treeType == HNSW_GRAPH)
   {
-    case NAIVE_MODE:
-      Log::Info << "brute-force (naive) search..." << std::endl;
-      break;
-    case SINGLE_TREE_MODE:
-      Log::Info << "single-tree " << TreeName() << " search..." << std::endl;
-      break;
-    case DUAL_TREE_MODE:
-      Log::Info << "dual-tree " << TreeName() << " search..." << std::endl;
-      break;
-    case GREEDY_SINGLE_TREE_MODE:
-      Log::Info << "greedy single-tree " << TreeName() << " search..."
-          << std::endl;
-      break;
+    dynamic_cast<HNSWWrapper<SortPolicy, MatType>&>(*nSearch).Index().Ef() =
+        ef;
+    Log::Info << TreeName() << " search (ef = " << ef << ")..." << std::endl;
+  }
+  else
+  {
+    switch (SearchMode())
+    {
+      case NAIVE_MODE:
+        Log::Info << "brute-force (naive) search..." << std::endl;
+        break;
+      case SINGLE_TREE_MODE:
+        Log::Info << "single-tree " << TreeName() << " search..." << std::endl;
+        break;
+      case DUAL_TREE_MODE:
+        Log::Info << "dual-tree " << TreeName() << " search..." << std::endl;
+        break;
+      case GREEDY_SINGLE_TREE_MODE:
+        Log::Info << "greedy single-tree " << TreeName() << " search..."
+            << std::endl;
+        break;
+    }
   }
 
   nSearch->Search(timers, std::move(querySet), k, neighbors, distances,
@@ -665,41 +1002,135 @@ void NSModel<SortPolicy>::Search(util::Timers& timers,
 }
 
 //! Perform neighbor search.
-template<typename SortPolicy>
-void NSModel<SortPolicy>::Search(util::Timers& timers,
-                                 const size_t k,
-                                 arma::Mat<size_t>& neighbors,
-                                 arma::mat& distances)
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::Search(util::Timers& timers,
+                                          const size_t k,
+                                          arma::Mat<size_t>& neighbors,
+                                          arma::mat& distances)
 {
   Log::Info << "Searching for " << k << " neighbors with ";
 
-  switch (SearchMode())
+  // The graph is searched the same way in every search mode, with the current
+  // value of ef.
+  if (treeType == HNSW_GRAPH)
   {
-    case NAIVE_MODE:
-      Log::Info << "brute-force (naive) search..." << std::endl;
-      break;
-    case SINGLE_TREE_MODE:
-      Log::Info << "single-tree " << TreeName() << " search..." << std::endl;
-      break;
-    case DUAL_TREE_MODE:
-      Log::Info << "dual-tree " << TreeName() << " search..." << std::endl;
-      break;
-    case GREEDY_SINGLE_TREE_MODE:
-      Log::Info << "greedy single-tree " << TreeName() << " search..."
-          << std::endl;
-      break;
+    dynamic_cast<HNSWWrapper<SortPolicy, MatType>&>(*nSearch).Index().Ef() =
+        ef;
+    Log::Info << TreeName() << " search (ef = " << ef << ")..." << std::endl;
+  }
+  else
+  {
+    switch (SearchMode())
+    {
+      case NAIVE_MODE:
+        Log::Info << "brute-force (naive) search..." << std::endl;
+        break;
+      case SINGLE_TREE_MODE:
+        Log::Info << "single-tree " << TreeName() << " search..." << std::endl;
+        break;
+      case DUAL_TREE_MODE:
+        Log::Info << "dual-tree " << TreeName() << " search..." << std::endl;
+        break;
+      case GREEDY_SINGLE_TREE_MODE:
+        Log::Info << "greedy single-tree " << TreeName() << " search..."
+            << std::endl;
+        break;
+    }
   }
 
-  if (Epsilon() != 0 && SearchMode() != NAIVE_MODE)
+  if (Epsilon() != 0 && SearchMode() != NAIVE_MODE && treeType != HNSW_GRAPH)
     Log::Info << "Maximum of " << Epsilon() * 100 << "% relative error."
         << std::endl;
 
   nSearch->Search(timers, k, neighbors, distances);
 }
 
+//! Save the model in the flat, memory-mappable layout.
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::SaveMapped(const std::string& filename) const
+{
+  if (treeType != KD_TREE)
+  {
+    throw std::invalid_argument("NSModel::SaveMapped(): only kd-tree models "
+        "can be saved in the mapped format");
+  }
+
+  std::ofstream stream(filename, std::ios::binary | std::ios::trunc);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("NSModel::SaveMapped(): cannot open file '" +
+        filename + "' for writing");
+  }
+
+  MappedHeader header;
+  header.magic = mappedMagic;
+  header.searchMode = (uint64_t) SearchMode();
+  header.epsilon = Epsilon();
+  header.leafSize = leafSize;
+  header.randomBasis = randomBasis ? 1 : 0;
+  header.qRows = q.n_rows;
+  header.qCols = q.n_cols;
+
+  stream.write((const char*) &header, sizeof(MappedHeader));
+  stream.write((const char*) q.memptr(),
+      sizeof(typename MatType::elem_type) * q.n_elem);
+
+  dynamic_cast<const LeafSizeNSWrapper<SortPolicy, tree::KDTree, MatType>&>(
+      *nSearch).SaveFlat(stream);
+
+  if (!stream.good())
+  {
+    throw std::runtime_error("NSModel::SaveMapped(): error writing file '" +
+        filename + "'");
+  }
+}
+
+//! Load a model saved with SaveMapped().
+template<typename SortPolicy, typename MatType>
+void NSModel<SortPolicy, MatType>::LoadMapped(const std::string& filename)
+{
+  std::shared_ptr<data::MappedFile> file(new data::MappedFile(filename));
+
+  MappedHeader header;
+  if (file->Size() < sizeof(MappedHeader))
+  {
+    throw std::runtime_error("NSModel::LoadMapped(): file '" + filename +
+        "' is not a mapped neighbor search model");
+  }
+  std::memcpy(&header, file->Data(), sizeof(MappedHeader));
+  if (header.magic != mappedMagic)
+  {
+    throw std::runtime_error("NSModel::LoadMapped(): file '" + filename +
+        "' is not a mapped neighbor search model");
+  }
+
+  size_t offset = sizeof(MappedHeader);
+  const size_t qSize = sizeof(typename MatType::elem_type) * header.qRows *
+      header.qCols;
+  if (offset + qSize > file->Size())
+  {
+    throw std::runtime_error("NSModel::LoadMapped(): file '" + filename +
+        "' is truncated");
+  }
+
+  // The projection matrix is small, so it is copied.
+  MatType newQ(header.qRows, header.qCols);
+  std::memcpy(newQ.memptr(), file->Data() + offset, qSize);
+  offset += qSize;
+
+  treeType = KD_TREE;
+  randomBasis = (header.randomBasis != 0);
+  leafSize = header.leafSize;
+  q = std::move(newQ);
+
+  InitializeModel((NeighborSearchMode) header.searchMode, header.epsilon);
+  dynamic_cast<LeafSizeNSWrapper<SortPolicy, tree::KDTree, MatType>&>(
+      *nSearch).LoadFlat(file, offset);
+}
+
 //! Get the name of the tree type.
-template<typename SortPolicy>
-std::string NSModel<SortPolicy>::TreeName() const
+template<typename SortPolicy, typename MatType>
+std::string NSModel<SortPolicy, MatType>::TreeName() const
 {
   switch (treeType)
   {
@@ -733,6 +1164,10 @@ std::string NSModel<SortPolicy>::TreeName() const
       return "UB tree";
     case OCTREE:
       return "octree";
+    case MORTON_TREE:
+      return "Morton tree";
+    case HNSW_GRAPH:
+      return "HNSW graph";
     default:
       return "unknown tree";
   }
@@ -0,0 +1,116 @@
+/**
+ * @file methods/neighbor_search/quantized_dataset.hpp
+ *
+ * Defines the QuantizedDataset class, which stores a dataset with 8 bits per
+ * dimension and computes Euclidean distances to the quantized points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_QUANTIZED_DATASET_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_QUANTIZED_DATASET_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The QuantizedDataset class holds a scalar-quantized copy of a dataset: each
+ * dimension of each point is stored as an 8-bit code.  All dimensions share the
+ * same quantization step, so the quantized points are a scaled grid in the
+ * original space, and each quantized point is within MaxError() (in Euclidean
+ * distance) of the point it was made from.
+ *
+ * The Evaluate() and EvaluateBlock() functions compute the Euclidean distance
+ * between a full-precision point and quantized points, reading one byte per
+ * dimension of each quantized point.  NeighborSearch uses them in its base
+ * cases when NeighborSearch::Quantize() has been called.
+ *
+ * @tparam MatType The type of data matrix.
+ */
+template<typename MatType = arma::mat>
+class QuantizedDataset
+{
+ public:
+  //! The element type of the data.
+  typedef typename MatType::elem_type ElemType;
+
+  //! Create an empty QuantizedDataset.
+  QuantizedDataset();
+
+  /**
+   * Quantize the given dataset.
+   *
+   * @param dataset Dataset to quantize.
+   */
+  QuantizedDataset(const MatType& dataset);
+
+  /**
+   * Quantize the given dataset, replacing the current codes.
+   *
+   * @param dataset Dataset to quantize.
+   */
+  void Train(const MatType& dataset);
+
+  /**
+   * Compute the Euclidean distance between the given point and the quantized
+   * point with the given index.
+   *
+   * @param point Full-precision point.
+   * @param index Index of the quantized point.
+   */
+  template<typename VecType>
+  double Evaluate(const VecType& point, const size_t index) const;
+
+  /**
+   * Compute the Euclidean distances between the given point and the quantized
+   * points [begin, begin + count), and store them in the given array.
+   *
+   * @param point Full-precision point.
+   * @param begin Index of the first quantized point.
+   * @param count Number of quantized points.
+   * @param distances Output array; must have room for count elements.
+   */
+  template<typename VecType>
+  void EvaluateBlock(const VecType& point,
+                     const size_t begin,
+                     const size_t count,
+                     ElemType* distances) const;
+
+  //! Get the maximum Euclidean distance between a point of the dataset and its
+  //! quantized point.
+  double MaxError() const
+  {
+    return 0.5 * (double) step * std::sqrt((double) codes.n_rows);
+  }
+
+  //! Get the codes of the quantized points (one column per point).
+  const arma::Mat<unsigned char>& Codes() const { return codes; }
+  //! Get the minimum value of each dimension of the dataset.
+  const arma::Col<ElemType>& Minimums() const { return minimums; }
+  //! Get the quantization step.
+  ElemType Step() const { return step; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! The codes of the quantized points.
+  arma::Mat<unsigned char> codes;
+  //! The minimum value of each dimension.
+  arma::Col<ElemType> minimums;
+  //! The quantization step shared by all dimensions.
+  ElemType step;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_dataset_impl.hpp"
+
+#endif
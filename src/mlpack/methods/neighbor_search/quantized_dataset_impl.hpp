@@ -0,0 +1,118 @@
+/**
+ * @file methods/neighbor_search/quantized_dataset_impl.hpp
+ *
+ * Implementation of the QuantizedDataset class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_QUANTIZED_DATASET_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_QUANTIZED_DATASET_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "quantized_dataset.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MatType>
+QuantizedDataset<MatType>::QuantizedDataset() : step(1)
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+QuantizedDataset<MatType>::QuantizedDataset(const MatType& dataset) : step(1)
+{
+  Train(dataset);
+}
+
+template<typename MatType>
+void QuantizedDataset<MatType>::Train(const MatType& dataset)
+{
+  minimums.zeros(dataset.n_rows);
+  step = 1;
+  if (dataset.n_cols > 0)
+  {
+    minimums = arma::min(dataset, 1);
+    const arma::Col<ElemType> ranges = arma::max(dataset, 1) - minimums;
+    const ElemType maxRange = (ranges.n_elem > 0) ? ranges.max() : 0;
+
+    // All dimensions use the same step, so that the quantized space is a
+    // scaled copy of the original space.
+    if (maxRange > 0)
+      step = maxRange / 255;
+  }
+
+  codes.set_size(dataset.n_rows, dataset.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+  {
+    for (size_t d = 0; d < dataset.n_rows; ++d)
+    {
+      const ElemType value = std::round((dataset(d, i) - minimums[d]) / step);
+      codes(d, i) = (unsigned char) std::min(std::max(value, (ElemType) 0),
+          (ElemType) 255);
+    }
+  }
+}
+
+template<typename MatType>
+template<typename VecType>
+inline double QuantizedDataset<MatType>::Evaluate(const VecType& point,
+                                                  const size_t index) const
+{
+  const unsigned char* c = codes.colptr(index);
+  const ElemType* m = minimums.memptr();
+  double sum = 0;
+  for (size_t d = 0; d < codes.n_rows; ++d)
+  {
+    const double diff = (double) point[d] - (double) (m[d] + step * c[d]);
+    sum += diff * diff;
+  }
+
+  return std::sqrt(sum);
+}
+
+template<typename MatType>
+template<typename VecType>
+inline void QuantizedDataset<MatType>::EvaluateBlock(const VecType& point,
+                                                     const size_t begin,
+                                                     const size_t count,
+                                                     ElemType* distances) const
+{
+  // Move the point into the code space once, so that each quantized point only
+  // costs one subtraction per dimension.
+  const arma::Col<ElemType> scaled = (point - minimums) / step;
+  const ElemType* q = scaled.memptr();
+  for (size_t i = 0; i < count; ++i)
+  {
+    const unsigned char* c = codes.colptr(begin + i);
+    double sum = 0;
+    for (size_t d = 0; d < codes.n_rows; ++d)
+    {
+      const double diff = (double) q[d] - (double) c[d];
+      sum += diff * diff;
+    }
+
+    distances[i] = (ElemType) (step * std::sqrt(sum));
+  }
+}
+
+template<typename MatType>
+template<typename Archive>
+void QuantizedDataset<MatType>::serialize(Archive& ar,
+                                          const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(codes));
+  ar(CEREAL_NVP(minimums));
+  ar(CEREAL_NVP(step));
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
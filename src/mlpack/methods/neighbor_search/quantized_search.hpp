@@ -0,0 +1,136 @@
+/**
+ * @file methods/neighbor_search/quantized_search.hpp
+ *
+ * Defines the QuantizedSearch class, which performs k-nearest-neighbor search
+ * on a reference set that is stored with 8 bits per dimension.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_QUANTIZED_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_QUANTIZED_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "quantized_dataset.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The QuantizedSearch class performs k-nearest-neighbor search with the
+ * Euclidean distance on a scalar-quantized copy of the reference set.  Each
+ * dimension of each reference point is stored as an 8-bit code; all dimensions
+ * share the same quantization step, so distances between codes are (up to a
+ * constant factor) Euclidean distances.  A query then scans one byte per
+ * dimension instead of four or eight, which reduces both the memory used by
+ * the reference set and the memory bandwidth needed to search it.
+ *
+ * By default only the codes are kept, and the returned distances are the
+ * distances to the quantized reference points.  If the rerank factor is
+ * nonzero, the full-precision reference set is kept as well: for each query
+ * point, the (rerankFactor * k) best candidates under the quantized distance
+ * are re-ranked with exact distances, and the exact distances are returned.
+ *
+ * This class scans all the codes for each query.  For large reference sets,
+ * NeighborSearch::Quantize() uses the same codes in the base cases of a tree
+ * search instead.
+ *
+ * @code
+ * extern arma::fmat referenceSet, querySet;
+ *
+ * // Keep the full-precision points, and re-rank 4k candidates per query.
+ * QuantizedSearch<> search(referenceSet, 4);
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * search.Search(querySet, 5, neighbors, distances);
+ * @endcode
+ *
+ * @tparam MatType The type of data matrix.
+ */
+template<typename MatType = arma::fmat>
+class QuantizedSearch
+{
+ public:
+  //! The element type of the data.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Quantize the given reference set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param rerankFactor Number of candidates (as a multiple of k) to re-rank
+   *     with exact distances; if 0 (the default), the full-precision
+   *     reference set is not kept and distances are approximate.
+   */
+  QuantizedSearch(const MatType& referenceSet, const size_t rerankFactor = 0);
+
+  //! Create a QuantizedSearch object without any reference data.
+  QuantizedSearch(const size_t rerankFactor = 0);
+
+  /**
+   * Quantize the given reference set, replacing the current one.  The value of
+   * RerankFactor() determines whether or not the full-precision reference set
+   * is kept.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(const MatType& referenceSet);
+
+  /**
+   * For each point in the query set, find the k nearest neighbors in the
+   * reference set.  The matrices are set to k rows and one column for each
+   * query point, as with NeighborSearch::Search().  If the reference set is not
+   * kept, RerankFactor() has no effect.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  //! Get the quantized reference set.
+  const QuantizedDataset<MatType>& Dataset() const { return dataset; }
+  //! Get the codes of the quantized reference set (one column per point).
+  const arma::Mat<unsigned char>& Codes() const { return dataset.Codes(); }
+  //! Get the minimum value of each dimension of the reference set.
+  const arma::Col<ElemType>& Minimums() const { return dataset.Minimums(); }
+  //! Get the quantization step.
+  ElemType Step() const { return dataset.Step(); }
+
+  //! Get the full-precision reference set (empty if it is not kept).
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+  //! Get the number of candidates re-ranked for each neighbor.
+  size_t RerankFactor() const { return rerankFactor; }
+  //! Modify the number of candidates re-ranked for each neighbor.  This only
+  //! has an effect if the reference set was kept when Train() was called.
+  size_t& RerankFactor() { return rerankFactor; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! The quantized reference set.
+  QuantizedDataset<MatType> dataset;
+  //! The full-precision reference set, if re-ranking is used.
+  MatType referenceSet;
+  //! The number of candidates re-ranked for each neighbor.
+  size_t rerankFactor;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_search_impl.hpp"
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ * @file methods/neighbor_search/quantized_search_impl.hpp
+ *
+ * Implementation of the QuantizedSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_QUANTIZED_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_QUANTIZED_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "quantized_search.hpp"
+
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MatType>
+QuantizedSearch<MatType>::QuantizedSearch(const MatType& referenceSet,
+                                          const size_t rerankFactor) :
+    rerankFactor(rerankFactor)
+{
+  Train(referenceSet);
+}
+
+template<typename MatType>
+QuantizedSearch<MatType>::QuantizedSearch(const size_t rerankFactor) :
+    rerankFactor(rerankFactor)
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+void QuantizedSearch<MatType>::Train(const MatType& referenceSetIn)
+{
+  dataset.Train(referenceSetIn);
+
+  // The full-precision points are only needed for re-ranking.
+  if (rerankFactor > 0)
+    referenceSet = referenceSetIn;
+  else
+    referenceSet.reset();
+}
+
+template<typename MatType>
+void QuantizedSearch<MatType>::Search(const MatType& querySet,
+                                      const size_t k,
+                                      arma::Mat<size_t>& neighbors,
+                                      arma::mat& distances) const
+{
+  const arma::Mat<unsigned char>& codes = dataset.Codes();
+  const arma::Col<ElemType>& minimums = dataset.Minimums();
+  const ElemType step = dataset.Step();
+
+  if (k > codes.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "QuantizedSearch::Search(): requested value of k (" << k << ") is "
+        << "greater than the number of points in the reference set ("
+        << codes.n_cols << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (querySet.n_rows != codes.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "QuantizedSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") does not match dimensionality of reference "
+        << "set (" << codes.n_rows << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const bool rerank = (rerankFactor > 0 &&
+      referenceSet.n_cols == codes.n_cols);
+  const size_t numCandidates = rerank ?
+      std::min((size_t) codes.n_cols, rerankFactor * k) : k;
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  if (k == 0)
+    return;
+
+  typedef std::pair<ElemType, size_t> Candidate;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+  {
+    // Map the query point into the quantized space; it is not rounded, so
+    // that the only error is the quantization of the reference points.
+    const arma::Col<ElemType> query = (querySet.col(i) - minimums) / step;
+    const ElemType* q = query.memptr();
+
+    // This is a max-heap, so the worst candidate is on top.
+    std::priority_queue<Candidate> heap;
+    for (size_t j = 0; j < codes.n_cols; ++j)
+    {
+      const unsigned char* c = codes.colptr(j);
+      ElemType distance = 0;
+      for (size_t d = 0; d < codes.n_rows; ++d)
+      {
+        const ElemType diff = q[d] - (ElemType) c[d];
+        distance += diff * diff;
+      }
+
+      if (heap.size() < numCandidates)
+      {
+        heap.push(Candidate(distance, j));
+      }
+      else if (distance < heap.top().first)
+      {
+        heap.pop();
+        heap.push(Candidate(distance, j));
+      }
+    }
+
+    // Compute the distances of the candidates: exact distances if we are
+    // re-ranking, and scaled quantized distances otherwise.
+    std::vector<std::pair<double, size_t>> candidates;
+    candidates.reserve(heap.size());
+    while (!heap.empty())
+    {
+      const size_t index = heap.top().second;
+      const double distance = rerank ?
+          metric::EuclideanDistance::Evaluate(querySet.col(i),
+              referenceSet.col(index)) :
+          step * std::sqrt((double) heap.top().first);
+      candidates.push_back(std::make_pair(distance, index));
+      heap.pop();
+    }
+
+    std::partial_sort(candidates.begin(), candidates.begin() + k,
+        candidates.end());
+    for (size_t j = 0; j < k; ++j)
+    {
+      distances(j, i) = candidates[j].first;
+      neighbors(j, i) = candidates[j].second;
+    }
+  }
+}
+
+template<typename MatType>
+template<typename Archive>
+void QuantizedSearch<MatType>::serialize(Archive& ar,
+                                         const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(dataset));
+  ar(CEREAL_NVP(referenceSet));
+  ar(CEREAL_NVP(rerankFactor));
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
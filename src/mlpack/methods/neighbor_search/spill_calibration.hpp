@@ -0,0 +1,166 @@
+/**
+ * @file methods/neighbor_search/spill_calibration.hpp
+ *
+ * Defines the SpillCalibration class, which chooses the overlapping size, the
+ * balance threshold, and the number of trees of a SpillForest for a target
+ * recall and latency budget.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SPILL_CALIBRATION_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SPILL_CALIBRATION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "spill_forest.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * A setting of a SpillForest, with the recall and the query time measured for
+ * it by SpillCalibration.
+ */
+struct SpillSetting
+{
+  //! The overlapping size of the trees.
+  double tau;
+  //! The balance threshold of the trees.
+  double rho;
+  //! The number of trees that are searched.
+  size_t numTrees;
+  //! The recall measured on the calibration queries, in [0, 1].
+  double recall;
+  //! The average search time of a calibration query, in seconds.
+  double queryTime;
+};
+
+/**
+ * The SpillCalibration class chooses the parameters of a SpillForest (and so
+ * of a single spill tree) for a given dataset.  The recall of defeatist search
+ * on a spill tree depends on tau and rho in a way that is hard to predict: a
+ * larger overlapping size makes defeatist search more accurate, but once the
+ * overlap of a node is larger than rho allows, the node is split without
+ * overlap and searched exactly (and so more slowly) instead.
+ *
+ * Calibrate() builds a forest of MaxTrees() trees for each combination of the
+ * given values of tau and rho, and searches a sample of held-out query points
+ * with the first 1, 2, ..., MaxTrees() trees.  The recall of each setting is
+ * measured against exact search, along with the average time of a query.  The
+ * settings that are not dominated by another setting (i.e. no setting has at
+ * least the same recall in less time) form the Pareto front, and the chosen
+ * setting is the fastest one that reaches the target recall within the latency
+ * budget.  If no setting does, the setting with the best recall within the
+ * budget is chosen, and if no setting is within the budget, the fastest setting
+ * is chosen.
+ *
+ * @code
+ * extern arma::mat referenceSet, heldOutQueries;
+ *
+ * SpillCalibration<> calibration(arma::vec("0.0 0.05 0.1 0.2"),
+ *     arma::vec("0.5 0.7 0.9"), 4);
+ * const SpillSetting& setting = calibration.Calibrate(referenceSet,
+ *     heldOutQueries, 10, 0.9, 1e-4);
+ *
+ * SpillForest<> forest(referenceSet, setting.numTrees, setting.tau,
+ *     setting.rho);
+ * @endcode
+ *
+ * @tparam TreeType The spill tree type to use (e.g. tree::SPTree or
+ *     tree::NonOrtSPTree).
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::SPTree>
+class SpillCalibration
+{
+ public:
+  /**
+   * Create the calibration object with the given values to try.
+   *
+   * @param taus Values of the overlapping size to try.
+   * @param rhos Values of the balance threshold to try.
+   * @param maxTrees Maximum number of trees of the forest.
+   * @param leafSize Maximum leaf size of the trees.
+   */
+  SpillCalibration(const arma::vec& taus,
+                   const arma::vec& rhos = arma::vec("0.7"),
+                   const size_t maxTrees = 1,
+                   const size_t leafSize = 20);
+
+  /**
+   * Measure the recall and the query time of each setting on the given
+   * held-out query points, and choose a setting.  Settings() and ParetoFront()
+   * are replaced.
+   *
+   * @param referenceSet Set of reference points.
+   * @param querySet Held-out query points to measure the settings on.
+   * @param k Number of neighbors to search for.
+   * @param targetRecall Recall to reach, in [0, 1].
+   * @param latencyBudget Maximum average time of a query, in seconds (0 means
+   *     no budget).
+   * @return The chosen setting.
+   */
+  const SpillSetting& Calibrate(const arma::mat& referenceSet,
+                                const arma::mat& querySet,
+                                const size_t k,
+                                const double targetRecall,
+                                const double latencyBudget = 0.0);
+
+  //! Get all measured settings, in the order they were measured.
+  const std::vector<SpillSetting>& Settings() const { return settings; }
+  //! Get the Pareto front of the measured settings, in order of query time.
+  const std::vector<SpillSetting>& ParetoFront() const { return paretoFront; }
+  //! Get the chosen setting.  Only valid after Calibrate() has been called.
+  const SpillSetting& Selected() const { return settings[selected]; }
+
+  //! Get the values of the overlapping size to try.
+  const arma::vec& Taus() const { return taus; }
+  //! Modify the values of the overlapping size to try.
+  arma::vec& Taus() { return taus; }
+  //! Get the values of the balance threshold to try.
+  const arma::vec& Rhos() const { return rhos; }
+  //! Modify the values of the balance threshold to try.
+  arma::vec& Rhos() { return rhos; }
+  //! Get the maximum number of trees.
+  size_t MaxTrees() const { return maxTrees; }
+  //! Modify the maximum number of trees.
+  size_t& MaxTrees() { return maxTrees; }
+  //! Get the maximum leaf size of the trees.
+  size_t LeafSize() const { return leafSize; }
+  //! Modify the maximum leaf size of the trees.
+  size_t& LeafSize() { return leafSize; }
+
+ private:
+  //! Compute the Pareto front of the measured settings.
+  void ComputeParetoFront();
+
+  //! Choose a setting, and return its index in settings.
+  size_t Select(const double targetRecall, const double latencyBudget) const;
+
+  //! The values of the overlapping size to try.
+  arma::vec taus;
+  //! The values of the balance threshold to try.
+  arma::vec rhos;
+  //! The maximum number of trees.
+  size_t maxTrees;
+  //! The maximum leaf size of the trees.
+  size_t leafSize;
+
+  //! All measured settings.
+  std::vector<SpillSetting> settings;
+  //! The Pareto front of the measured settings.
+  std::vector<SpillSetting> paretoFront;
+  //! The index of the chosen setting.
+  size_t selected;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "spill_calibration_impl.hpp"
+
+#endif
@@ -0,0 +1,200 @@
+/**
+ * @file methods/neighbor_search/spill_calibration_impl.hpp
+ *
+ * Implementation of the SpillCalibration class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SPILL_CALIBRATION_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SPILL_CALIBRATION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "spill_calibration.hpp"
+
+#include <chrono>
+
+namespace mlpack {
+namespace neighbor {
+
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+SpillCalibration<TreeType>::SpillCalibration(const arma::vec& taus,
+                                             const arma::vec& rhos,
+                                             const size_t maxTrees,
+                                             const size_t leafSize) :
+    taus(taus),
+    rhos(rhos),
+    maxTrees(maxTrees),
+    leafSize(leafSize),
+    selected(0)
+{
+  // Nothing to do.
+}
+
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+const SpillSetting& SpillCalibration<TreeType>::Calibrate(
+    const arma::mat& referenceSet,
+    const arma::mat& querySet,
+    const size_t k,
+    const double targetRecall,
+    const double latencyBudget)
+{
+  if (taus.n_elem == 0 || rhos.n_elem == 0)
+  {
+    throw std::invalid_argument("SpillCalibration::Calibrate(): at least one "
+        "value of tau and rho must be given");
+  }
+
+  if (maxTrees == 0)
+  {
+    throw std::invalid_argument("SpillCalibration::Calibrate(): the maximum "
+        "number of trees must be positive");
+  }
+
+  if (querySet.n_cols == 0)
+  {
+    throw std::invalid_argument("SpillCalibration::Calibrate(): no query "
+        "points given");
+  }
+
+  if (k == 0 || k > referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "SpillCalibration::Calibrate(): k (" << k << ") must be between 1 "
+        << "and the number of reference points (" << referenceSet.n_cols
+        << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  for (size_t i = 0; i < rhos.n_elem; ++i)
+  {
+    if (rhos[i] < 0.0 || rhos[i] > 1.0)
+    {
+      throw std::invalid_argument("SpillCalibration::Calibrate(): rho must be "
+          "in [0, 1]");
+    }
+  }
+
+  // The exact neighbors of the query points.
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  KNN exact(referenceSet);
+  exact.Search(querySet, k, trueNeighbors, trueDistances);
+
+  settings.clear();
+  for (size_t t = 0; t < taus.n_elem; ++t)
+  {
+    for (size_t r = 0; r < rhos.n_elem; ++r)
+    {
+      SpillForest<TreeType> forest(referenceSet, maxTrees, taus[t], rhos[r],
+          leafSize);
+
+      for (size_t numTrees = 1; numTrees <= maxTrees; ++numTrees)
+      {
+        arma::Mat<size_t> neighbors;
+        arma::mat distances;
+
+        const std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+        forest.Search(querySet, k, neighbors, distances, numTrees);
+        const double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+
+        SpillSetting setting;
+        setting.tau = taus[t];
+        setting.rho = rhos[r];
+        setting.numTrees = numTrees;
+        setting.recall = KNN::Recall(neighbors, trueNeighbors);
+        setting.queryTime = seconds / querySet.n_cols;
+        settings.push_back(setting);
+
+        Log::Info << "tau " << setting.tau << ", rho " << setting.rho << ", "
+            << numTrees << " tree(s): recall " << setting.recall << ", "
+            << setting.queryTime << "s per query." << std::endl;
+      }
+    }
+  }
+
+  ComputeParetoFront();
+  selected = Select(targetRecall, latencyBudget);
+  return settings[selected];
+}
+
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void SpillCalibration<TreeType>::ComputeParetoFront()
+{
+  // Sort the settings by query time (and the best recall first, for equal
+  // times); then a setting is on the front if its recall is better than the
+  // recall of every faster setting.
+  std::vector<size_t> order(settings.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+
+  const std::vector<SpillSetting>& s = settings;
+  std::sort(order.begin(), order.end(), [&s](const size_t a, const size_t b)
+  {
+    if (s[a].queryTime != s[b].queryTime)
+      return s[a].queryTime < s[b].queryTime;
+    return s[a].recall > s[b].recall;
+  });
+
+  paretoFront.clear();
+  double bestRecall = -1.0;
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    if (settings[order[i]].recall > bestRecall)
+    {
+      paretoFront.push_back(settings[order[i]]);
+      bestRecall = settings[order[i]].recall;
+    }
+  }
+}
+
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t SpillCalibration<TreeType>::Select(const double targetRecall,
+                                          const double latencyBudget) const
+{
+  const bool hasBudget = (latencyBudget > 0.0);
+
+  size_t fastest = 0;
+  size_t best = settings.size(); // The best recall within the budget.
+  size_t chosen = settings.size(); // The fastest that reaches the target.
+  for (size_t i = 0; i < settings.size(); ++i)
+  {
+    const SpillSetting& s = settings[i];
+    if (s.queryTime < settings[fastest].queryTime)
+      fastest = i;
+
+    if (hasBudget && s.queryTime > latencyBudget)
+      continue;
+
+    if (best == settings.size() || s.recall > settings[best].recall)
+      best = i;
+
+    if (s.recall >= targetRecall && (chosen == settings.size() ||
+        s.queryTime < settings[chosen].queryTime))
+      chosen = i;
+  }
+
+  if (chosen < settings.size())
+    return chosen;
+  else if (best < settings.size())
+    return best;
+  else
+    return fastest;
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
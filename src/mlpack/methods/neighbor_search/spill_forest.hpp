@@ -0,0 +1,151 @@
+/**
+ * @file methods/neighbor_search/spill_forest.hpp
+ *
+ * Defines the SpillForest class, which performs approximate k-nearest-neighbor
+ * search with defeatist search on several spill trees, each built on a
+ * different random rotation of the reference set.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SPILL_FOREST_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SPILL_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/spill_tree.hpp>
+
+#include "neighbor_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The SpillForest class is a forest of hybrid spill trees for approximate
+ * k-nearest-neighbor search with the Euclidean distance.  Defeatist search on
+ * a single spill tree is fast, but it misses the neighbors that were split
+ * from the query near the top of the tree.  Each tree of the forest is built on
+ * a different random rotation of the reference set, so the trees split the
+ * data along different directions and tend to miss different neighbors; the
+ * results of all the trees that are searched are merged.
+ *
+ * The first tree is built on the reference set itself, so a forest of one tree
+ * gives the same results as SpillKNN.  Since the cost of a search grows with
+ * the number of trees that are searched, Search() can search only the first
+ * trees of the forest, to stay within a latency budget (see
+ * SpillCalibration to choose the number of trees).
+ *
+ * @code
+ * extern arma::mat referenceSet, querySet;
+ *
+ * SpillForest<> forest(referenceSet, 4, 0.1);
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * forest.Search(querySet, 5, neighbors, distances);
+ * @endcode
+ *
+ * @tparam TreeType The spill tree type to use (e.g. tree::SPTree or
+ *     tree::NonOrtSPTree).
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::SPTree>
+class SpillForest
+{
+ public:
+  //! The type of the search object for each tree.
+  typedef DefeatistKNN<TreeType> SearchType;
+
+  /**
+   * Build a forest of the given number of trees on the given reference set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numTrees Number of trees.
+   * @param tau Overlapping size of each tree.
+   * @param rho Balance threshold of each tree.
+   * @param leafSize Maximum leaf size of each tree.
+   */
+  SpillForest(const arma::mat& referenceSet,
+              const size_t numTrees = 1,
+              const double tau = 0,
+              const double rho = 0.7,
+              const size_t leafSize = 20);
+
+  //! Create an empty forest.  Call Train() before searching.
+  SpillForest();
+
+  /**
+   * Build a forest of the given number of trees on the given reference set,
+   * replacing the current trees.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numTrees Number of trees.
+   * @param tau Overlapping size of each tree.
+   * @param rho Balance threshold of each tree.
+   * @param leafSize Maximum leaf size of each tree.
+   */
+  void Train(const arma::mat& referenceSet,
+             const size_t numTrees = 1,
+             const double tau = 0,
+             const double rho = 0.7,
+             const size_t leafSize = 20);
+
+  /**
+   * For each point in the query set, search each of the first numTrees trees
+   * with defeatist single-tree search, and return the best k distinct
+   * neighbors that were found.  If fewer than k neighbors are found for a
+   * query point, the remaining neighbors are set to SIZE_MAX and their
+   * distances to DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   * @param numTrees Number of trees to search (0 means all of them).
+   */
+  void Search(const arma::mat& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              const size_t numTrees = 0);
+
+  //! Get the number of trees in the forest.
+  size_t NumTrees() const { return searchers.size(); }
+  //! Get the search object of the given tree.
+  const SearchType& Searcher(const size_t i) const { return searchers[i]; }
+  //! Get the rotation of the given tree (empty for the unrotated first tree).
+  const arma::mat& Rotation(const size_t i) const { return rotations[i]; }
+
+  //! Get the overlapping size of the trees.
+  double Tau() const { return tau; }
+  //! Get the balance threshold of the trees.
+  double Rho() const { return rho; }
+  //! Get the maximum leaf size of the trees.
+  size_t LeafSize() const { return leafSize; }
+
+  //! Serialize the forest.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! The search object of each tree.
+  std::vector<SearchType> searchers;
+  //! The rotation applied to the data of each tree.
+  std::vector<arma::mat> rotations;
+  //! The overlapping size of the trees.
+  double tau;
+  //! The balance threshold of the trees.
+  double rho;
+  //! The maximum leaf size of the trees.
+  size_t leafSize;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "spill_forest_impl.hpp"
+
+#endif
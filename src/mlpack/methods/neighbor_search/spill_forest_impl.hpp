@@ -0,0 +1,199 @@
+/**
+ * @file methods/neighbor_search/spill_forest_impl.hpp
+ *
+ * Implementation of the SpillForest class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SPILL_FOREST_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SPILL_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "spill_forest.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+SpillForest<TreeType>::SpillForest(const arma::mat& referenceSet,
+                                   const size_t numTrees,
+                                   const double tau,
+                                   const double rho,
+                                   const size_t leafSize)
+{
+  Train(referenceSet, numTrees, tau, rho, leafSize);
+}
+
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+SpillForest<TreeType>::SpillForest() :
+    tau(0),
+    rho(0.7),
+    leafSize(20)
+{
+  // Nothing to do.
+}
+
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void SpillForest<TreeType>::Train(const arma::mat& referenceSet,
+                                  const size_t numTrees,
+                                  const double tau,
+                                  const double rho,
+                                  const size_t leafSize)
+{
+  if (numTrees == 0)
+  {
+    throw std::invalid_argument("SpillForest::Train(): the number of trees "
+        "must be positive");
+  }
+
+  this->tau = tau;
+  this->rho = rho;
+  this->leafSize = leafSize;
+
+  // Draw all the rotations first, so that they do not depend on how the trees
+  // are built.  The first tree is not rotated.
+  rotations.clear();
+  rotations.resize(numTrees);
+  for (size_t i = 1; i < numTrees; ++i)
+  {
+    arma::mat r;
+    arma::qr_econ(rotations[i], r, arma::randn<arma::mat>(referenceSet.n_rows,
+        referenceSet.n_rows));
+  }
+
+  searchers.clear();
+  searchers.resize(numTrees, SearchType(SINGLE_TREE_MODE));
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) numTrees; ++i)
+  {
+    if (i == 0)
+    {
+      typename SearchType::Tree tree(referenceSet, tau, leafSize, rho);
+      searchers[i] = SearchType(std::move(tree), SINGLE_TREE_MODE);
+    }
+    else
+    {
+      typename SearchType::Tree tree(arma::mat(rotations[i].t() *
+          referenceSet), tau, leafSize, rho);
+      searchers[i] = SearchType(std::move(tree), SINGLE_TREE_MODE);
+    }
+  }
+}
+
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void SpillForest<TreeType>::Search(const arma::mat& querySet,
+                                   const size_t k,
+                                   arma::Mat<size_t>& neighbors,
+                                   arma::mat& distances,
+                                   const size_t numTrees)
+{
+  if (searchers.empty())
+  {
+    throw std::invalid_argument("SpillForest::Search(): no reference set "
+        "given; call Train() first");
+  }
+
+  if (numTrees > searchers.size())
+  {
+    std::ostringstream oss;
+    oss << "SpillForest::Search(): requested number of trees (" << numTrees
+        << ") is greater than the number of trees in the forest ("
+        << searchers.size() << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t treesToSearch = (numTrees == 0) ? searchers.size() : numTrees;
+  if (treesToSearch == 1)
+  {
+    searchers[0].Search(querySet, k, neighbors, distances);
+    return;
+  }
+
+  // Search each tree.  Each search is parallel over the query points already.
+  std::vector<arma::Mat<size_t>> treeNeighbors(treesToSearch);
+  std::vector<arma::mat> treeDistances(treesToSearch);
+  searchers[0].Search(querySet, k, treeNeighbors[0], treeDistances[0]);
+  for (size_t t = 1; t < treesToSearch; ++t)
+  {
+    searchers[t].Search(arma::mat(rotations[t].t() * querySet), k,
+        treeNeighbors[t], treeDistances[t]);
+  }
+
+  // Now merge the results of the trees for each query point.
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+  {
+    std::vector<std::pair<double, size_t>> candidates;
+    candidates.reserve(treesToSearch * k);
+    for (size_t t = 0; t < treesToSearch; ++t)
+    {
+      for (size_t j = 0; j < k; ++j)
+      {
+        if (treeNeighbors[t](j, i) != SIZE_MAX)
+        {
+          candidates.push_back(std::make_pair(treeDistances[t](j, i),
+              treeNeighbors[t](j, i)));
+        }
+      }
+    }
+
+    // Several trees may find the same neighbor (with distances that may differ
+    // slightly, since the trees are rotated), so skip neighbors that were
+    // already taken.
+    std::sort(candidates.begin(), candidates.end());
+    size_t found = 0;
+    for (size_t c = 0; c < candidates.size() && found < k; ++c)
+    {
+      bool duplicate = false;
+      for (size_t j = 0; j < found && !duplicate; ++j)
+        duplicate = (neighbors(j, i) == candidates[c].second);
+
+      if (!duplicate)
+      {
+        distances(found, i) = candidates[c].first;
+        neighbors(found, i) = candidates[c].second;
+        ++found;
+      }
+    }
+
+    for (size_t j = found; j < k; ++j)
+    {
+      distances(j, i) = DBL_MAX;
+      neighbors(j, i) = SIZE_MAX;
+    }
+  }
+}
+
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename Archive>
+void SpillForest<TreeType>::serialize(Archive& ar,
+                                      const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(searchers));
+  ar(CEREAL_NVP(rotations));
+  ar(CEREAL_NVP(tau));
+  ar(CEREAL_NVP(rho));
+  ar(CEREAL_NVP(leafSize));
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,143 @@
+/**
+ * @file methods/pca/incremental_pca.hpp
+ *
+ * Definition of IncrementalPCA, which computes the principal components of a
+ * dataset that is seen one minibatch at a time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PCA_INCREMENTAL_PCA_HPP
+#define MLPACK_METHODS_PCA_INCREMENTAL_PCA_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/randomized_svd/column_blocks.hpp>
+
+namespace mlpack {
+namespace pca {
+
+/**
+ * IncrementalPCA computes the leading principal components of a dataset that
+ * is seen one minibatch at a time, so the dataset never has to be held in
+ * memory at once.  It keeps the mean of the points seen so far and a truncated
+ * SVD of the centered points; each minibatch is folded into the SVD with the
+ * sequential Karhunen-Loeve update with mean correction of Ross et al.:
+ *
+ * @code
+ * @article{ross2008incremental,
+ *   title = {Incremental Learning for Robust Visual Tracking},
+ *   author = {Ross, David A. and Lim, Jongwoo and Lin, Ruei-Sung and
+ *       Yang, Ming-Hsuan},
+ *   journal = {International Journal of Computer Vision},
+ *   volume = {77},
+ *   number = {1--3},
+ *   pages = {125--141},
+ *   year = {2008}
+ * }
+ * @endcode
+ *
+ * Each update costs one SVD of a d x (rank + b + 1) matrix for d-dimensional
+ * points and minibatches of b points.  If no component is dropped (rank 0),
+ * the components are those of exact PCA on all the points seen so far;
+ * otherwise each update drops the smallest components, and the result
+ * approximates them.
+ *
+ * @code
+ * extern arma::mat batch1, batch2, data;
+ * IncrementalPCA ipca(10);
+ * ipca.Update(batch1);
+ * ipca.Update(batch2);
+ *
+ * arma::mat transformed;
+ * ipca.Transform(data, transformed);
+ * @endcode
+ */
+class IncrementalPCA
+{
+ public:
+  /**
+   * Create the IncrementalPCA object, keeping the given number of components.
+   *
+   * @param rank Number of principal components to keep.
+   */
+  IncrementalPCA(const size_t rank = 0);
+
+  /**
+   * Fold the given minibatch of points into the principal components.  The
+   * points must have the same dimensionality as the previous minibatches.
+   *
+   * @param batch Minibatch of points, one point per column.
+   */
+  void Update(const arma::mat& batch);
+
+  /**
+   * Compute the principal components of a matrix that is read one block of
+   * columns at a time (for instance, from a file with
+   * svd::BinaryFileColumnBlocks); each block is a minibatch.  The current
+   * components are discarded first.
+   *
+   * @tparam ColumnBlocksType Source of the matrix, such as
+   *     svd::MatColumnBlocks or svd::BinaryFileColumnBlocks.
+   * @param blocks Source of the data matrix.
+   */
+  template<typename ColumnBlocksType>
+  void Train(const ColumnBlocksType& blocks);
+
+  /**
+   * Project the given points onto the principal components.
+   *
+   * @param data Points to project, one point per column.
+   * @param transformedData Will hold the projected points, one per column.
+   */
+  void Transform(const arma::mat& data, arma::mat& transformedData) const;
+
+  //! Discard the components and the points seen so far.
+  void Reset();
+
+  //! Get the number of components to keep.
+  size_t Rank() const { return rank; }
+  //! Modify the number of components to keep (0 keeps all of them).  This
+  //! takes effect at the next update.
+  size_t& Rank() { return rank; }
+
+  //! Get the number of points seen so far.
+  size_t NumPoints() const { return numPoints; }
+
+  //! Get the mean of the points seen so far.
+  const arma::vec& Mean() const { return mean; }
+
+  //! Get the principal components (eigenvectors), one per column.
+  const arma::mat& EigenVectors() const { return eigvec; }
+
+  //! Get the singular values of the centered points seen so far.
+  const arma::vec& SingularValues() const { return singularValues; }
+
+  //! Get the variance along each of the principal components (eigenvalues).
+  arma::vec EigenValues() const;
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Number of components to keep (0 keeps all of them).
+  size_t rank;
+  //! Number of points seen so far.
+  size_t numPoints;
+  //! Mean of the points seen so far.
+  arma::vec mean;
+  //! Principal components, one per column.
+  arma::mat eigvec;
+  //! Singular values of the centered points seen so far.
+  arma::vec singularValues;
+};
+
+} // namespace pca
+} // namespace mlpack
+
+// Include implementation.
+#include "incremental_pca_impl.hpp"
+
+#endif
@@ -0,0 +1,145 @@
+/**
+ * @file methods/pca/incremental_pca_impl.hpp
+ *
+ * Implementation of IncrementalPCA.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PCA_INCREMENTAL_PCA_IMPL_HPP
+#define MLPACK_METHODS_PCA_INCREMENTAL_PCA_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "incremental_pca.hpp"
+
+namespace mlpack {
+namespace pca {
+
+inline IncrementalPCA::IncrementalPCA(const size_t rank) :
+    rank(rank),
+    numPoints(0)
+{
+  // Nothing to do.
+}
+
+inline void IncrementalPCA::Update(const arma::mat& batch)
+{
+  if (batch.n_cols == 0)
+    return;
+
+  if (numPoints > 0 && batch.n_rows != mean.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "IncrementalPCA::Update(): dimensionality of batch (" << batch.n_rows
+        << ") does not match the dimensionality of the model (" << mean.n_elem
+        << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const double n = numPoints;
+  const double m = batch.n_cols;
+  const arma::vec batchMean = arma::sum(batch, 1) / m;
+
+  // The centered points seen so far are represented by their truncated SVD,
+  // U S; the new points are centered on their own mean, and one more column
+  // accounts for the shift of the mean of all the points.
+  arma::mat augmented;
+  if (numPoints == 0)
+  {
+    augmented = batch.each_col() - batchMean;
+  }
+  else
+  {
+    const size_t k = eigvec.n_cols;
+    augmented.set_size(batch.n_rows, k + batch.n_cols + 1);
+    if (k > 0)
+    {
+      augmented.cols(0, k - 1) = eigvec;
+      augmented.cols(0, k - 1).each_row() %= singularValues.t();
+    }
+    augmented.cols(k, k + batch.n_cols - 1) = batch.each_col() - batchMean;
+    augmented.col(k + batch.n_cols) = std::sqrt(n * m / (n + m)) *
+        (batchMean - mean);
+  }
+
+  // Only the left singular vectors are needed.
+  arma::mat v;
+  if (!arma::svd_econ(eigvec, singularValues, v, augmented, 'l'))
+  {
+    Log::Fatal << "IncrementalPCA::Update(): failed to compute the SVD of the "
+        << "update." << std::endl;
+  }
+
+  const size_t keep = (rank == 0) ? singularValues.n_elem :
+      std::min(rank, (size_t) singularValues.n_elem);
+  if (keep < singularValues.n_elem)
+  {
+    eigvec.shed_cols(keep, eigvec.n_cols - 1);
+    singularValues.shed_rows(keep, singularValues.n_elem - 1);
+  }
+
+  if (numPoints == 0)
+    mean = batchMean;
+  else
+    mean = (n * mean + m * batchMean) / (n + m);
+  numPoints += batch.n_cols;
+}
+
+template<typename ColumnBlocksType>
+void IncrementalPCA::Train(const ColumnBlocksType& blocks)
+{
+  Reset();
+  blocks.Visit([&](const size_t /* first */, const arma::mat& block)
+  {
+    Update(block);
+  });
+}
+
+inline void IncrementalPCA::Transform(const arma::mat& data,
+                                      arma::mat& transformedData) const
+{
+  if (data.n_rows != mean.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "IncrementalPCA::Transform(): dimensionality of data ("
+        << data.n_rows << ") does not match the dimensionality of the model ("
+        << mean.n_elem << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  transformedData = eigvec.t() * (data.each_col() - mean);
+}
+
+inline void IncrementalPCA::Reset()
+{
+  numPoints = 0;
+  mean.clear();
+  eigvec.clear();
+  singularValues.clear();
+}
+
+inline arma::vec IncrementalPCA::EigenValues() const
+{
+  // The covariance matrix is X * X' / (N - 1).
+  if (numPoints < 2)
+    return arma::zeros<arma::vec>(singularValues.n_elem);
+
+  return arma::square(singularValues) / (numPoints - 1);
+}
+
+template<typename Archive>
+void IncrementalPCA::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(rank));
+  ar(CEREAL_NVP(numPoints));
+  ar(CEREAL_NVP(mean));
+  ar(CEREAL_NVP(eigvec));
+  ar(CEREAL_NVP(singularValues));
+}
+
+} // namespace pca
+} // namespace mlpack
+
+#endif
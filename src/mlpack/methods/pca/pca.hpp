@@ -18,6 +18,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
+#include <mlpack/methods/pca/incremental_pca.hpp>
 
 namespace mlpack {
 namespace pca {
@@ -45,7 +46,8 @@ class PCA
 
   /**
    * Apply Principal Component Analysis to the provided data set. It is safe
-   * to pass the same matrix reference for both data and transformedData.
+   * to pass the same matrix reference for both data and transformedData; in
+   * that case the data is centered in place, without a copy.
    *
    * @param data Data matrix.
    * @param transformedData Matrix to put results of PCA into.
@@ -137,10 +139,24 @@ class PCA
         if (stdDev[i] == 0)
           stdDev[i] = 1e-50;
 
-      centeredData /= arma::repmat(stdDev, 1, centeredData.n_cols);
+      centeredData.each_col() /= stdDev;
     }
   }
 
+  /**
+   * Center (and scale, if requested) the data in place, and apply the
+   * decomposition, overwriting the data with its transformation.
+   *
+   * @param data Data matrix; will hold the results of PCA.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Rank of the decomposition.
+   */
+  void ApplyInPlace(arma::mat& data,
+                    arma::vec& eigVal,
+                    arma::mat& eigvec,
+                    const size_t rank);
+
   //! Whether or not the data will be scaled by standard deviation when PCA is
   //! performed.
   bool scaleData;
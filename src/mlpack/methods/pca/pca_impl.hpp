@@ -44,6 +44,13 @@ void PCA<DecompositionPolicy>::Apply(const arma::mat& data,
                                      arma::vec& eigVal,
                                      arma::mat& eigvec)
 {
+  // If the data is to be overwritten by the result, center it in place.
+  if (&data == &transformedData)
+  {
+    ApplyInPlace(transformedData, eigVal, eigvec, data.n_rows);
+    return;
+  }
+
   // Center the data into a temporary matrix.
   arma::mat centeredData;
   math::Center(data, centeredData);
@@ -113,14 +120,7 @@ double PCA<DecompositionPolicy>::Apply(arma::mat& data,
   arma::mat eigvec;
   arma::vec eigVal;
 
-  // Center the data into a temporary matrix.
-  arma::mat centeredData;
-  math::Center(data, centeredData);
-
-  // Scale the data if the user ask for.
-  ScaleData(centeredData);
-
-  decomposition.Apply(data, centeredData, data, eigVal, eigvec, newDimension);
+  ApplyInPlace(data, eigVal, eigvec, newDimension);
 
   if (newDimension < eigvec.n_rows)
     // Drop unnecessary rows.
@@ -159,7 +159,7 @@ double PCA<DecompositionPolicy>::Apply(arma::mat& data,
   arma::mat eigvec;
   arma::vec eigVal;
 
-  Apply(data, data, eigVal, eigvec);
+  ApplyInPlace(data, eigVal, eigvec, data.n_rows);
 
   // Calculate the dimension we should keep.
   size_t newDimension = 0;
@@ -178,6 +178,27 @@ double PCA<DecompositionPolicy>::Apply(arma::mat& data,
   return varSum;
 }
 
+/**
+ * Center and scale the data in place, and then decompose it, overwriting it
+ * with its transformation.  The data is overwritten by the result anyway, so
+ * this avoids a copy of the centered data.
+ */
+template<typename DecompositionPolicy>
+void PCA<DecompositionPolicy>::ApplyInPlace(arma::mat& data,
+                                            arma::vec& eigVal,
+                                            arma::mat& eigvec,
+                                            const size_t rank)
+{
+  math::Center(data);
+
+  // Scale the data if the user ask for.
+  ScaleData(data);
+
+  // The decomposition policies only use the uncentered data for its size or
+  // to center it again, so the centered data is passed for both.
+  decomposition.Apply(data, data, data, eigVal, eigvec, rank);
+}
+
 } // namespace pca
 } // namespace mlpack
 
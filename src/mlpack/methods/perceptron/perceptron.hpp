@@ -95,6 +95,16 @@ class Perceptron
    * This training does not reset the model weights, so you can call Train() on
    * multiple datasets sequentially.
    *
+   * The scores of consecutive points are computed with one matrix product
+   * until a point is misclassified, so training gets faster as it converges.
+   * If Averaged() is set, the final weights are the average of the weights
+   * after each point of each iteration (the averaged perceptron).  If
+   * ParameterMixing() is set and OpenMP is available, each thread makes the
+   * pass of an iteration over its own shard of the data, starting from the
+   * current weights, and the weights of the shards are then averaged
+   * (iterative parameter mixing, McDonald et al., 2010); the result differs
+   * from the sequential algorithm.
+   *
    * @param data Dataset on which training should be performed.
    * @param labels Labels of the dataset.
    * @param numClasses Number of classes in the data.
@@ -127,6 +137,16 @@ class Perceptron
   //! Modify the maximum number of iterations.
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Get whether the weights are averaged over the training.
+  bool Averaged() const { return averaged; }
+  //! Modify whether the weights are averaged over the training.
+  bool& Averaged() { return averaged; }
+
+  //! Get whether the training is parallelized with parameter mixing.
+  bool ParameterMixing() const { return parameterMixing; }
+  //! Modify whether the training is parallelized with parameter mixing.
+  bool& ParameterMixing() { return parameterMixing; }
+
   //! Get the number of classes this perceptron has been trained for.
   size_t NumClasses() const { return weights.n_cols; }
 
@@ -154,6 +174,39 @@ class Perceptron
 
   //! The biases for each class.
   arma::vec biases;
+
+  //! Whether the weights are averaged over the training.
+  bool averaged;
+
+  //! Whether the training is parallelized with parameter mixing.
+  bool parameterMixing;
+
+  /**
+   * Make one pass over the points in [begin, end), updating the given weights
+   * and biases at each misclassified point.
+   *
+   * @param data Data to train on.
+   * @param labels Labels of data.
+   * @param instanceWeights Cost of mispredicting each point, or empty.
+   * @param begin Index of the first point.
+   * @param end One past the index of the last point.
+   * @param currentWeights Weights to update.
+   * @param currentBiases Biases to update.
+   * @param weightSum If not empty, the weights after each point are added to
+   *     it.
+   * @param biasSum If weightSum is not empty, the biases after each point are
+   *     added to it.
+   * @return The number of misclassified points.
+   */
+  size_t TrainPoints(const MatType& data,
+                     const arma::Row<size_t>& labels,
+                     const arma::rowvec& instanceWeights,
+                     const size_t begin,
+                     const size_t end,
+                     arma::mat& currentWeights,
+                     arma::vec& currentBiases,
+                     arma::mat& weightSum,
+                     arma::vec& biasSum) const;
 };
 
 } // namespace perceptron
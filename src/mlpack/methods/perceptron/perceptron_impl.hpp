@@ -30,7 +30,9 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const size_t numClasses,
     const size_t dimensionality,
     const size_t maxIterations) :
-    maxIterations(maxIterations)
+    maxIterations(maxIterations),
+    averaged(false),
+    parameterMixing(false)
 {
   WeightInitializationPolicy wip;
   wip.Initialize(weights, biases, dimensionality, numClasses);
@@ -56,7 +58,9 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const size_t maxIterations) :
-    maxIterations(maxIterations)
+    maxIterations(maxIterations),
+    averaged(false),
+    parameterMixing(false)
 {
   // Start training.
   Train(data, labels, numClasses);
@@ -84,7 +88,9 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const arma::rowvec& instanceWeights) :
-    maxIterations(other.maxIterations)
+    maxIterations(other.maxIterations),
+    averaged(other.averaged),
+    parameterMixing(other.parameterMixing)
 {
   Train(data, labels, numClasses, instanceWeights);
 }
@@ -106,16 +112,12 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::vec tempLabelMat;
-  arma::uword maxIndex = 0;
+  // Compute the scores of all the points at once.
+  arma::mat scores = weights.t() * test;
+  scores.each_col() += biases;
 
-  // Could probably be faster if done in batch.
-  for (size_t i = 0; i < test.n_cols; ++i)
-  {
-    tempLabelMat = weights.t() * test.col(i) + biases;
-    tempLabelMat.max(maxIndex);
-    predictedLabels(0, i) = maxIndex;
-  }
+  predictedLabels = arma::conv_to<arma::Row<size_t>>::from(
+      arma::index_max(scores));
 }
 
 /**
@@ -139,59 +141,201 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Train(
     const arma::rowvec& instanceWeights)
 {
   // Do we need to resize the weights?
-  if (weights.n_elem != numClasses)
+  if (weights.n_cols != numClasses || weights.n_rows != data.n_rows)
   {
     WeightInitializationPolicy wip;
     wip.Initialize(weights, biases, data.n_rows, numClasses);
   }
 
-  size_t j, i = 0;
-  bool converged = false;
-  size_t tempLabel;
-  arma::uword maxIndexRow = 0, maxIndexCol = 0;
-  arma::mat tempLabelMat;
+  // With parameter mixing, each thread trains on its own shard of the data
+  // during an iteration, starting from the current weights, and the weights of
+  // the shards are then averaged.
+  size_t numShards = 1;
+  #ifdef HAS_OPENMP
+  if (parameterMixing)
+  {
+    numShards = std::min((size_t) omp_get_max_threads(),
+        (size_t) data.n_cols / 1024);
+  }
+  #endif
+  numShards = std::max(numShards, (size_t) 1);
+  const size_t shardSize = (data.n_cols + numShards - 1) / numShards;
 
-  LearnPolicy LP;
+  // For the averaged perceptron, accumulate the sum of the weights after each
+  // point.
+  arma::mat weightSum;
+  arma::vec biasSum;
+  size_t numSteps = 0;
+  if (averaged)
+  {
+    weightSum.zeros(arma::size(weights));
+    biasSum.zeros(biases.n_elem);
+  }
 
-  const bool hasWeights = (instanceWeights.n_elem > 0);
+  std::vector<arma::mat> shardWeights(numShards);
+  std::vector<arma::vec> shardBiases(numShards);
+  std::vector<arma::mat> shardWeightSums(numShards);
+  std::vector<arma::vec> shardBiasSums(numShards);
+  std::vector<size_t> shardMistakes(numShards);
 
+  size_t i = 0;
+  bool converged = false;
   while ((i < maxIterations) && (!converged))
   {
     // This outer loop is for each iteration, and we use the 'converged'
     // variable for noting whether or not convergence has been reached.
     ++i;
-    converged = true;
 
-    // Now this inner loop is for going through the dataset in each iteration.
-    for (j = 0; j < data.n_cols; ++j)
+    if (numShards == 1)
+    {
+      converged = (TrainPoints(data, labels, instanceWeights, 0, data.n_cols,
+          weights, biases, weightSum, biasSum) == 0);
+    }
+    else
     {
-      // Multiply for each variable and check whether the current weight vector
-      // correctly classifies this.
-      tempLabelMat = weights.t() * data.col(j) + biases;
+      #pragma omp parallel for schedule(static, 1)
+      for (omp_size_t shard = 0; shard < (omp_size_t) numShards; ++shard)
+      {
+        const size_t begin = (size_t) shard * shardSize;
+        const size_t end = std::min(begin + shardSize, (size_t) data.n_cols);
+
+        shardWeights[shard] = weights;
+        shardBiases[shard] = biases;
+        if (averaged)
+        {
+          shardWeightSums[shard].zeros(arma::size(weights));
+          shardBiasSums[shard].zeros(biases.n_elem);
+        }
 
-      tempLabelMat.max(maxIndexRow, maxIndexCol);
+        shardMistakes[shard] = TrainPoints(data, labels, instanceWeights,
+            begin, end, shardWeights[shard], shardBiases[shard],
+            shardWeightSums[shard], shardBiasSums[shard]);
+      }
 
-      // Check whether prediction is correct.
-      if (maxIndexRow != labels(0, j))
+      // Mix the weights of the shards, in order.
+      converged = true;
+      weights = shardWeights[0];
+      biases = shardBiases[0];
+      for (size_t shard = 1; shard < numShards; ++shard)
       {
-        // Due to incorrect prediction, convergence set to false.
-        converged = false;
-        tempLabel = labels(0, j);
-
-        // Send maxIndexRow for knowing which weight to update, send j to know
-        // the value of the vector to update it with.  Send tempLabel to know
-        // the correct class.
-        if (hasWeights)
-          LP.UpdateWeights(data.col(j), weights, biases, maxIndexRow, tempLabel,
-              instanceWeights(j));
-        else
-          LP.UpdateWeights(data.col(j), weights, biases, maxIndexRow,
-              tempLabel);
+        weights += shardWeights[shard];
+        biases += shardBiases[shard];
+      }
+      weights /= numShards;
+      biases /= numShards;
+
+      for (size_t shard = 0; shard < numShards; ++shard)
+      {
+        converged &= (shardMistakes[shard] == 0);
+        if (averaged)
+        {
+          weightSum += shardWeightSums[shard];
+          biasSum += shardBiasSums[shard];
+        }
       }
     }
+
+    numSteps += data.n_cols;
+  }
+
+  if (averaged && numSteps > 0)
+  {
+    weights = weightSum / numSteps;
+    biases = biasSum / numSteps;
   }
 }
 
+/**
+ * Make one pass of the perceptron learning algorithm over the given range of
+ * points, updating the given weights.  The scores of a block of points are
+ * computed with one matrix product; the block is cut short at each mistake,
+ * since the weights change, and grows while the points are classified
+ * correctly.
+ */
+template<
+    typename LearnPolicy,
+    typename WeightInitializationPolicy,
+    typename MatType
+>
+size_t Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::
+TrainPoints(const MatType& data,
+            const arma::Row<size_t>& labels,
+            const arma::rowvec& instanceWeights,
+            const size_t begin,
+            const size_t end,
+            arma::mat& currentWeights,
+            arma::vec& currentBiases,
+            arma::mat& weightSum,
+            arma::vec& biasSum) const
+{
+  LearnPolicy LP;
+
+  const bool hasWeights = (instanceWeights.n_elem > 0);
+
+  size_t mistakes = 0;
+  // The number of points since the weights last changed.
+  size_t unchanged = 0;
+  size_t blockSize = 1;
+  arma::mat scores;
+  size_t j = begin;
+  while (j < end)
+  {
+    const size_t blockEnd = std::min(j + blockSize, end);
+    scores = currentWeights.t() * data.cols(j, blockEnd - 1);
+    scores.each_col() += currentBiases;
+
+    // Go through the block until the first incorrect prediction.
+    bool mistake = false;
+    for (size_t k = 0; k < scores.n_cols; ++k, ++j)
+    {
+      const size_t prediction = scores.col(k).index_max();
+      if (prediction == labels[j])
+      {
+        ++unchanged;
+        continue;
+      }
+
+      // The weights are about to change, so add the current ones to the
+      // sum for the points they were used for.
+      ++mistakes;
+      if (weightSum.n_elem > 0)
+      {
+        weightSum += unchanged * currentWeights;
+        biasSum += unchanged * currentBiases;
+      }
+      unchanged = 1;
+
+      // Send prediction for knowing which weight to update, send j to know
+      // the value of the vector to update it with.  Send labels[j] to know
+      // the correct class.
+      if (hasWeights)
+      {
+        LP.UpdateWeights(data.col(j), currentWeights, currentBiases,
+            prediction, labels[j], instanceWeights[j]);
+      }
+      else
+      {
+        LP.UpdateWeights(data.col(j), currentWeights, currentBiases,
+            prediction, labels[j]);
+      }
+
+      ++j;
+      mistake = true;
+      break;
+    }
+
+    blockSize = mistake ? 1 : std::min(2 * blockSize, (size_t) 1024);
+  }
+
+  if (weightSum.n_elem > 0)
+  {
+    weightSum += unchanged * currentWeights;
+    biasSum += unchanged * currentBiases;
+  }
+
+  return mistakes;
+}
+
 //! Serialize the perceptron.
 template<typename LearnPolicy,
          typename WeightInitializationPolicy,
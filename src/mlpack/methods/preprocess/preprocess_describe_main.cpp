@@ -18,6 +18,7 @@
 #define BINDING_NAME preprocess_describe
 
 #include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/data/feature_statistics.hpp>
 
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
@@ -51,7 +52,11 @@ BINDING_LONG_DESC(
     "specific dimension to analyze if there are too many dimensions. The " +
     PRINT_PARAM_STRING("population") + " parameter can be specified when the "
     "dataset should be considered as a population.  Otherwise, the dataset "
-    "will be considered as a sample.");
+    "will be considered as a sample."
+    "\n\n"
+    "All the statistics are computed in a single pass over the data.  The "
+    "median is estimated with a quantile sketch; it is exact for datasets with "
+    "fewer than 1000 points.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -85,85 +90,6 @@ PARAM_FLAG("row_major", "If specified, the program will calculate statistics "
     "across rows, not across columns.  (Remember that in mlpack, a column "
     "represents a point, so this option is generally not necessary.)", "r");
 
-/**
- * Calculates the sum of deviations to the Nth Power.
- *
- * @param input Vector that captures a dimension of a dataset.
- * @param rowMean Mean of the given vector.
- * @param n Degree of power.
- * @return sum of nth power deviations.
- */
-double SumNthPowerDeviations(const arma::rowvec& input,
-                             const double& fMean,
-                             size_t n)
-{
-  return arma::sum(arma::pow(input - fMean, static_cast<double>(n)));
-}
-
-/**
- * Calculates Skewness of the given vector.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @param rowMean Mean of the given vector.
- * @return Skewness of the given vector.
- */
-double Skewness(const arma::rowvec& input,
-                const double& fStd,
-                const double& fMean,
-                const bool population)
-{
-  double skewness = 0;
-  const double S3 = pow(fStd, 3);
-  const double M3 = SumNthPowerDeviations(input, fMean, 3);
-  const double n = input.n_elem;
-  if (population)
-  {
-    // Calculate population skewness
-    skewness = M3 / (n * S3);
-  }
-  else
-  {
-    // Calculate sample skewness.
-    skewness = n * M3 / ((n - 1) * (n - 2) * S3);
-  }
-  return skewness;
-}
-
-/**
- * Calculates excess kurtosis of the given vector.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @param rowMean Mean of the given vector.
- * @return Kurtosis of the given vector.
- */
-double Kurtosis(const arma::rowvec& input,
-                const double& fStd,
-                const double& fMean,
-                const bool population)
-{
-  double kurtosis = 0;
-  const double M4 = SumNthPowerDeviations(input, fMean, 4);
-  const double n = input.n_elem;
-  if (population)
-  {
-    // Calculate population excess kurtosis.
-    const double M2 = SumNthPowerDeviations(input, fMean, 2);
-    kurtosis = n * (M4 / pow(M2, 2)) - 3;
-  }
-  else
-  {
-    // Calculate sample excess kurtosis.
-    const double S4 = pow(fStd, 4);
-    const double norm3 = (3 * (n - 1) * (n - 1)) / ((n - 2) * (n - 3));
-    const double normC = (n * (n + 1)) / ((n - 1) * (n - 2) * (n - 3));
-    const double normM = M4 / S4;
-    kurtosis = normC * normM - norm3;
-  }
-  return kurtosis;
-}
-
 /**
  * Calculates standard error of standard deviation.
  *
@@ -207,50 +133,51 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
       % "dim" % "var" % "mean" % "std" % "median" % "min" % "max"
       % "range" % "skew" % "kurt" % "SE" << endl;
 
-  // Lambda function to print out the results.
-  auto PrintStatResults = [&](size_t dim, bool rowMajor)
+  // Compute the statistics of all the dimensions to describe in a single pass.
+  // The median is estimated with a quantile sketch, which is exact for
+  // datasets with fewer points than its size.
+  FeatureStatistics statistics(1000);
+  if (params.Has("dimension"))
+  {
+    statistics.Update(rowMajor ? arma::mat(data.col(dimension).t()) :
+        arma::mat(data.row(dimension)));
+  }
+  else if (rowMajor)
+  {
+    statistics.Update(arma::mat(data.t()));
+  }
+  else
   {
-    arma::rowvec feature;
-    if (rowMajor)
-      feature = arma::conv_to<arma::rowvec>::from(data.col(dim));
-    else
-      feature = data.row(dim);
+    statistics.Update(data);
+  }
 
-    // f at the front of the variable names means "feature".
-    const double fMax = arma::max(feature);
-    const double fMin = arma::min(feature);
-    const double fMean = arma::mean(feature);
-    const double fStd = arma::stddev(feature, population);
+  // f at the front of the variable names means "feature".
+  const arma::vec fVar = statistics.Variance(population);
+  const arma::vec fStd = statistics.StdDev(population);
+  const arma::vec fSkew = statistics.Skewness(population);
+  const arma::vec fKurt = statistics.Kurtosis(population);
+
+  // If the user specified dimension, describe statistics of the given
+  // dimension. If a dimension is not specified, describe all dimensions.
+  for (size_t i = 0; i < statistics.Dimensionality(); ++i)
+  {
+    const double fMax = statistics.Max()[i];
+    const double fMin = statistics.Min()[i];
 
     // Print statistics of the given dimension.
     Log::Info << boost::format(numberFormat)
-        % dim
-        % arma::var(feature, population)
-        % fMean
-        % fStd
-        % arma::median(feature)
+        % (params.Has("dimension") ? dimension : i)
+        % fVar[i]
+        % statistics.Mean()[i]
+        % fStd[i]
+        % statistics.Quantile(i, 0.5)
         % fMin
         % fMax
         % (fMax - fMin) // range
-        % Skewness(feature, fStd, fMean, population)
-        % Kurtosis(feature, fStd, fMean, population)
-        % StandardError(feature.n_elem, fStd)
+        % fSkew[i]
+        % fKurt[i]
+        % StandardError(statistics.Count(), fStd[i])
         << endl;
-  };
-
-  // If the user specified dimension, describe statistics of the given
-  // dimension. If a dimension is not specified, describe all dimensions.
-  if (params.Has("dimension"))
-  {
-    PrintStatResults(dimension, rowMajor);
-  }
-  else
-  {
-    const size_t dimensions = rowMajor ? data.n_cols : data.n_rows;
-    for (size_t i = 0; i < dimensions; ++i)
-    {
-      PrintStatResults(i, rowMajor);
-    }
   }
   timers.Stop("statistics");
 }
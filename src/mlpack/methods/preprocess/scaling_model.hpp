@@ -80,6 +80,10 @@ class ScalingModel
   template<typename MatType>
   void Transform(const MatType& input, MatType& output);
 
+  //! Transform to scale features in place, without allocating another matrix.
+  template<typename MatType>
+  void Transform(MatType& data);
+
   // Fit to intialize the scaling parameter.
   template<typename MatType>
   void Fit(const MatType& input);
@@ -88,6 +92,10 @@ class ScalingModel
   template<typename MatType>
   void InverseTransform(const MatType& input, MatType& output);
 
+  // Scale back the dataset to their original values in place.
+  template<typename MatType>
+  void InverseTransform(MatType& data);
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
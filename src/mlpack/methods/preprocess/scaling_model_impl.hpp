@@ -233,6 +233,35 @@ void ScalingModel::Transform(const MatType& input, MatType& output)
   }
 }
 
+template<typename MatType>
+void ScalingModel::Transform(MatType& data)
+{
+  if (scalerType == ScalerTypes::STANDARD_SCALER)
+  {
+    standardscale->Transform(data);
+  }
+  else if (scalerType == ScalerTypes::MIN_MAX_SCALER)
+  {
+    minmaxscale->Transform(data);
+  }
+  else if (scalerType == ScalerTypes::MEAN_NORMALIZATION)
+  {
+    meanscale->Transform(data);
+  }
+  else if (scalerType == ScalerTypes::MAX_ABS_SCALER)
+  {
+    maxabsscale->Transform(data);
+  }
+  else if (scalerType == ScalerTypes::PCA_WHITENING)
+  {
+    pcascale->Transform(data);
+  }
+  else if (scalerType == ScalerTypes::ZCA_WHITENING)
+  {
+    zcascale->Transform(data);
+  }
+}
+
 template<typename MatType>
 void ScalingModel::InverseTransform(const MatType& input, MatType& output)
 {
@@ -262,6 +291,35 @@ void ScalingModel::InverseTransform(const MatType& input, MatType& output)
   }
 }
 
+template<typename MatType>
+void ScalingModel::InverseTransform(MatType& data)
+{
+  if (scalerType == ScalerTypes::STANDARD_SCALER)
+  {
+    standardscale->InverseTransform(data);
+  }
+  else if (scalerType == ScalerTypes::MIN_MAX_SCALER)
+  {
+    minmaxscale->InverseTransform(data);
+  }
+  else if (scalerType == ScalerTypes::MEAN_NORMALIZATION)
+  {
+    meanscale->InverseTransform(data);
+  }
+  else if (scalerType == ScalerTypes::MAX_ABS_SCALER)
+  {
+    maxabsscale->InverseTransform(data);
+  }
+  else if (scalerType == ScalerTypes::PCA_WHITENING)
+  {
+    pcascale->InverseTransform(data);
+  }
+  else if (scalerType == ScalerTypes::ZCA_WHITENING)
+  {
+    zcascale->InverseTransform(data);
+  }
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -14,6 +14,8 @@
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/timers.hpp>
 
+#include <cstring>
+
 using namespace std;
 using namespace arma;
 using namespace mlpack;
@@ -41,20 +43,78 @@ void Radical::CopyAndPerturb(mat& xNew, const mat& x) const
 }
 
 
-double Radical::Vasicek(vec& z) const
+namespace {
+
+/**
+ * Sort the given values in place with a least-significant-digit radix sort,
+ * which takes linear time.  The bits of each value are flipped so that their
+ * order as unsigned integers is the order of the values (negative values have
+ * all their bits flipped, and non-negative values only their sign bit).  The
+ * values must not be NaN.
+ */
+void RadixSort(double* values, const size_t n)
 {
-  z = sort(z);
+  static const uint64_t signBit = uint64_t(1) << 63;
+
+  // Reused across calls, so that sorting does not allocate.
+  thread_local std::vector<uint64_t> keys, buffer;
+  keys.resize(n);
+  buffer.resize(n);
+
+  // The histograms of all eight bytes are computed in a single pass.
+  size_t counts[8][256];
+  std::memset(counts, 0, sizeof(counts));
+  for (size_t i = 0; i < n; ++i)
+  {
+    uint64_t key;
+    std::memcpy(&key, &values[i], sizeof(key));
+    key = (key & signBit) ? ~key : (key | signBit);
+    keys[i] = key;
+    for (size_t b = 0; b < 8; ++b)
+      ++counts[b][(key >> (8 * b)) & 0xFF];
+  }
 
-  // Apparently slower.
-  /*
-  vec logs = log(z.subvec(m, z.n_elem - 1) - z.subvec(0, z.n_elem - 1 - m));
-  //vec val = sum(log(z.subvec(m, nPoints - 1) - z.subvec(0, nPoints - 1 - m)));
-  return (double) sum(logs);
-  */
+  for (size_t b = 0; b < 8; ++b)
+  {
+    // A byte that is the same for all values does not change the order; this
+    // is common for the high bytes, which hold the sign and exponent.
+    const size_t shift = 8 * b;
+    if (n == 0 || counts[b][(keys[0] >> shift) & 0xFF] == n)
+      continue;
+
+    size_t offset = 0;
+    for (size_t d = 0; d < 256; ++d)
+    {
+      const size_t count = counts[b][d];
+      counts[b][d] = offset;
+      offset += count;
+    }
+
+    for (size_t i = 0; i < n; ++i)
+      buffer[counts[b][(keys[i] >> shift) & 0xFF]++] = keys[i];
+    keys.swap(buffer);
+  }
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    const uint64_t key = (keys[i] & signBit) ? (keys[i] & ~signBit) : ~keys[i];
+    std::memcpy(&values[i], &key, sizeof(key));
+  }
+}
+
+} // anonymous namespace
+
+double Radical::Vasicek(vec& z) const
+{
+  // The m-spacings need the full order of the sample, which a radix sort gives
+  // in linear time.
+  RadixSort(z.memptr(), z.n_elem);
 
-  // Apparently faster.
   double sum = 0;
-  uword range = z.n_elem - m;
+  if (z.n_elem <= m)
+    return sum;
+
+  const uword range = z.n_elem - m;
   for (uword i = 0; i < range; ++i)
   {
     sum += log(max(z(i + m) - z(i), DBL_MIN));
@@ -70,26 +130,37 @@ double Radical::DoRadical2D(const mat& matX, util::Timers& timers)
   CopyAndPerturb(perturbed, matX);
   timers.Stop("radical_copy_and_perturb");
 
-  mat::fixed<2, 2> matJacobi;
+  const size_t nPoints = perturbed.n_rows;
+  const double* x1 = perturbed.colptr(0);
+  const double* x2 = perturbed.colptr(1);
 
   vec values(angles);
 
-  for (size_t i = 0; i < angles; ++i)
+  // The same perturbed data is rotated by every angle, and each angle is
+  // independent of the others, so they are evaluated in parallel, each thread
+  // rotating the data into its own buffers.
+  #pragma omp parallel
   {
-    const double theta = (i / (double) angles) * M_PI / 2.0;
-    const double cosTheta = cos(theta);
-    const double sinTheta = sin(theta);
+    vec candidateY1(nPoints);
+    vec candidateY2(nPoints);
 
-    matJacobi(0, 0) = cosTheta;
-    matJacobi(1, 0) = -sinTheta;
-    matJacobi(0, 1) = sinTheta;
-    matJacobi(1, 1) = cosTheta;
+    #pragma omp for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) angles; ++i)
+    {
+      const double theta = (i / (double) angles) * M_PI / 2.0;
+      const double cosTheta = cos(theta);
+      const double sinTheta = sin(theta);
 
-    candidate = perturbed * matJacobi;
-    vec candidateY1 = candidate.unsafe_col(0);
-    vec candidateY2 = candidate.unsafe_col(1);
+      // This is the product of the perturbed data with the Jacobi rotation
+      // [cos(theta), sin(theta); -sin(theta), cos(theta)].
+      for (size_t p = 0; p < nPoints; ++p)
+      {
+        candidateY1[p] = cosTheta * x1[p] - sinTheta * x2[p];
+        candidateY2[p] = sinTheta * x1[p] + cosTheta * x2[p];
+      }
 
-    values(i) = Vasicek(candidateY1) + Vasicek(candidateY2);
+      values(i) = Vasicek(candidateY1) + Vasicek(candidateY2);
+    }
   }
 
   uword indOpt = 0;
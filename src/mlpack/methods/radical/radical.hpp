@@ -82,6 +82,9 @@ class Radical
    * Vasicek's m-spacing estimator of entropy, with overlap modification from
    * (Learned-Miller and Fisher, 2003).
    *
+   * The sample is sorted in place (with a radix sort).  This may be called
+   * from several threads at once.
+   *
    * @param x Empirical sample (one-dimensional) over which to estimate entropy.
    */
   double Vasicek(arma::vec& x) const;
@@ -93,7 +96,8 @@ class Radical
    */
   void CopyAndPerturb(arma::mat& xNew, const arma::mat& x) const;
 
-  //! Two-dimensional version of RADICAL.
+  //! Two-dimensional version of RADICAL.  The angles are evaluated in
+  //! parallel when OpenMP is enabled.
   double DoRadical2D(const arma::mat& matX,
                      util::Timers& timers = IO::GetTimers());
 
@@ -137,8 +141,6 @@ class Radical
 
   //! Internal matrix, held as member variable to prevent memory reallocations.
   arma::mat perturbed;
-  //! Internal matrix, held as member variable to prevent memory reallocations.
-  arma::mat candidate;
 };
 
 void WhitenFeatureMajorMatrix(const arma::mat& matX,
@@ -13,6 +13,8 @@
 #ifndef MLPACK_METHODS_RANDOM_FOREST_BOOTSTRAP_HPP
 #define MLPACK_METHODS_RANDOM_FOREST_BOOTSTRAP_HPP
 
+#include <mlpack/core/math/random_stream.hpp>
+
 namespace mlpack {
 namespace tree {
 
@@ -44,6 +46,34 @@ void Bootstrap(const MatType& dataset,
     bootstrapWeights = weights.cols(indices);
 }
 
+/**
+ * Draw a bootstrap sample of the given number of points, as the indices of the
+ * sampled points (with repetitions).  The indices are sorted, so that the
+ * sampled points are read in the order they are stored in.  This represents
+ * the same sample as the dataset built by Bootstrap() above, without copying
+ * the points.  The sample is drawn from the given stream, so that samples can
+ * be drawn in parallel.
+ *
+ * @param numPoints Number of points of the dataset.
+ * @param indices Indices of the sampled points.
+ * @param stream Random stream to draw the sample from.
+ */
+inline void BootstrapIndices(const size_t numPoints,
+                             arma::Row<size_t>& indices,
+                             math::RandomStream& stream)
+{
+  // Random sampling with replacement.
+  arma::rowvec uniform(numPoints);
+  stream.Randu(uniform);
+  indices.set_size(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    indices[i] = std::min((size_t) (uniform[i] * numPoints),
+        numPoints - 1);
+  }
+  indices = arma::sort(indices);
+}
+
 } // namespace tree
 } // namespace mlpack
 
@@ -14,6 +14,7 @@
 
 #include <mlpack/methods/decision_tree/decision_tree.hpp>
 #include <mlpack/methods/decision_tree/multiple_random_dimension_select.hpp>
+#include <mlpack/methods/decision_tree/flat_forest.hpp>
 #include "bootstrap.hpp"
 
 namespace mlpack {
@@ -361,6 +362,16 @@ class RandomForest
   //! Get the number of trees in the forest.
   size_t NumTrees() const { return trees.size(); }
 
+  /**
+   * Store the trees of the forest in the given FlatForest (replacing its
+   * trees), which gives the same predictions and probabilities as the forest
+   * but classifies faster.  If the forest is trained again, the FlatForest
+   * has to be rebuilt.
+   *
+   * @param flatForest FlatForest to store the trees in.
+   */
+  void Flatten(FlatForest& flatForest) const;
+
   /**
    * Serialize the random forest.
    */
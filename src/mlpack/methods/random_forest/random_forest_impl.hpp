@@ -437,6 +437,33 @@ void RandomForest<
   }
 }
 
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    bool UseBootstrap
+>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    UseBootstrap
+>::Flatten(FlatForest& flatForest) const
+{
+  // Check edge case.
+  if (trees.size() == 0)
+  {
+    throw std::invalid_argument("RandomForest::Flatten(): no random forest "
+        "trained!");
+  }
+
+  flatForest.Clear();
+  for (size_t i = 0; i < trees.size(); ++i)
+    flatForest.Add(trees[i]);
+}
+
 template<
     typename FitnessFunction,
     typename DimensionSelectionType,
@@ -504,65 +531,34 @@ double RandomForest<
   // Convert avgGain to total gain.
   double totalGain = avgGain * oldNumTrees;
 
+  // All the trees are trained on the dataset itself; only the indices of the
+  // points of each tree (and their labels and weights) are copied.
+  arma::Row<size_t> allPoints;
+  if (!UseBootstrap)
+    allPoints = arma::regspace<arma::Row<size_t>>(0, dataset.n_cols - 1);
+
+  // Each tree draws its bootstrap sample from its own stream, so the forest
+  // does not depend on the number of threads.
+  math::RandomStream stream;
+  if (UseBootstrap)
+    stream = math::NewRandomStream();
+
   // Train each tree individually.
   #pragma omp parallel for reduction( + : totalGain)
   for (omp_size_t i = 0; i < numTrees; ++i)
   {
-    MatType bootstrapDataset;
-    arma::Row<size_t> bootstrapLabels;
-    arma::rowvec bootstrapWeights;
+    arma::Row<size_t> bootstrapPoints;
     if (UseBootstrap)
     {
-      Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
-          bootstrapLabels, bootstrapWeights);
+      math::RandomStream treeStream = stream.Split(i);
+      BootstrapIndices(dataset.n_cols, bootstrapPoints, treeStream);
     }
 
-    if (UseWeights)
-    {
-      if (UseDatasetInfo)
-      {
-        totalGain += UseBootstrap ?
-            trees[oldNumTrees + i].Train(bootstrapDataset, datasetInfo,
-                bootstrapLabels, numClasses, bootstrapWeights, minimumLeafSize,
-                minimumGainSplit, maximumDepth, dimensionSelector) :
-            trees[oldNumTrees + i].Train(dataset, datasetInfo, labels,
-                numClasses, weights, minimumLeafSize, minimumGainSplit,
-                maximumDepth, dimensionSelector);
-      }
-      else
-      {
-        totalGain += UseBootstrap ?
-            trees[oldNumTrees + i].Train(bootstrapDataset, bootstrapLabels,
-                numClasses, bootstrapWeights, minimumLeafSize,
-                minimumGainSplit, maximumDepth, dimensionSelector) :
-            trees[oldNumTrees + i].Train(dataset, labels, numClasses,
-                weights, minimumLeafSize, minimumGainSplit, maximumDepth,
-                dimensionSelector);
-      }
-    }
-    else
-    {
-      if (UseDatasetInfo)
-      {
-        totalGain += UseBootstrap ?
-            trees[oldNumTrees + i].Train(bootstrapDataset, datasetInfo,
-                bootstrapLabels, numClasses, minimumLeafSize, minimumGainSplit,
-                maximumDepth, dimensionSelector) :
-            trees[oldNumTrees + i].Train(dataset, datasetInfo, labels,
-                numClasses, minimumLeafSize, minimumGainSplit, maximumDepth,
-                dimensionSelector);
-      }
-      else
-      {
-        totalGain += UseBootstrap ?
-            trees[oldNumTrees + i].Train(bootstrapDataset, bootstrapLabels,
-                numClasses, minimumLeafSize, minimumGainSplit, maximumDepth,
-                dimensionSelector) :
-            trees[oldNumTrees + i].Train(dataset, labels, numClasses,
-                minimumLeafSize, minimumGainSplit, maximumDepth,
-                dimensionSelector);
-      }
-    }
+    totalGain += trees[oldNumTrees + i].template
+        TrainOnIndices<UseWeights, UseDatasetInfo>(dataset,
+            UseBootstrap ? bootstrapPoints : allPoints, datasetInfo, labels,
+            numClasses, weights, minimumLeafSize, minimumGainSplit,
+            maximumDepth, dimensionSelector);
   }
 
   avgGain = totalGain / trees.size();
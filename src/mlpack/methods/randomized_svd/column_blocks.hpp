@@ -0,0 +1,155 @@
+/**
+ * @file methods/randomized_svd/column_blocks.hpp
+ *
+ * Sources of a matrix that is read one block of columns at a time, for the
+ * out-of-core randomized SVD.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOMIZED_SVD_COLUMN_BLOCKS_HPP
+#define MLPACK_METHODS_RANDOMIZED_SVD_COLUMN_BLOCKS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <fstream>
+
+namespace mlpack {
+namespace svd {
+
+/**
+ * A matrix in memory, visited one block of columns at a time.  The blocks are
+ * aliases of the matrix, so no data is copied; this is mostly useful to check
+ * the out-of-core algorithms against their in-memory versions.
+ *
+ * Every column block source provides NumRows(), NumCols(), and Visit(f), which
+ * calls f(firstColumn, block) for consecutive blocks of columns, in order.
+ */
+class MatColumnBlocks
+{
+ public:
+  /**
+   * Visit the given matrix in blocks of the given number of columns.
+   *
+   * @param data Matrix to visit.
+   * @param blockSize Number of columns of each block.
+   */
+  MatColumnBlocks(const arma::mat& data, const size_t blockSize = 1024) :
+      data(data),
+      blockSize(std::max(blockSize, (size_t) 1))
+  {
+    /* Nothing to do here. */
+  }
+
+  //! Get the number of rows of the matrix.
+  size_t NumRows() const { return data.n_rows; }
+  //! Get the number of columns of the matrix.
+  size_t NumCols() const { return data.n_cols; }
+
+  /**
+   * Call visitor(firstColumn, block) for each block of columns.
+   *
+   * @param visitor Function to call on each block.
+   */
+  template<typename VisitorType>
+  void Visit(const VisitorType& visitor) const
+  {
+    for (size_t first = 0; first < data.n_cols; first += blockSize)
+    {
+      const size_t cols = std::min(blockSize, (size_t) data.n_cols - first);
+      const arma::mat block(const_cast<double*>(data.colptr(first)),
+          data.n_rows, cols, false, true);
+      visitor(first, block);
+    }
+  }
+
+ private:
+  //! The matrix.
+  const arma::mat& data;
+  //! The number of columns of each block.
+  size_t blockSize;
+};
+
+/**
+ * A matrix stored in a file as raw column-major doubles (as written by
+ * arma::mat::save() with arma::raw_binary), read one block of columns at a
+ * time.  Only one block is held in memory, so the matrix can be larger than
+ * the available memory.
+ */
+class BinaryFileColumnBlocks
+{
+ public:
+  /**
+   * Read the given file in blocks of the given number of columns.
+   *
+   * @param filename File holding the matrix.
+   * @param numRows Number of rows of the matrix.
+   * @param numCols Number of columns of the matrix.
+   * @param blockSize Number of columns of each block.
+   */
+  BinaryFileColumnBlocks(const std::string& filename,
+                         const size_t numRows,
+                         const size_t numCols,
+                         const size_t blockSize = 1024) :
+      filename(filename),
+      numRows(numRows),
+      numCols(numCols),
+      blockSize(std::max(blockSize, (size_t) 1))
+  {
+    /* Nothing to do here. */
+  }
+
+  //! Get the number of rows of the matrix.
+  size_t NumRows() const { return numRows; }
+  //! Get the number of columns of the matrix.
+  size_t NumCols() const { return numCols; }
+
+  /**
+   * Read the file and call visitor(firstColumn, block) for each block of
+   * columns.  A std::runtime_error is thrown if the file cannot be read.
+   *
+   * @param visitor Function to call on each block.
+   */
+  template<typename VisitorType>
+  void Visit(const VisitorType& visitor) const
+  {
+    std::ifstream stream(filename, std::ios::binary);
+    if (!stream.is_open())
+    {
+      throw std::runtime_error("BinaryFileColumnBlocks::Visit(): cannot open "
+          "'" + filename + "'");
+    }
+
+    arma::mat buffer;
+    for (size_t first = 0; first < numCols; first += blockSize)
+    {
+      const size_t cols = std::min(blockSize, numCols - first);
+      buffer.set_size(numRows, cols);
+      stream.read(reinterpret_cast<char*>(buffer.memptr()),
+          buffer.n_elem * sizeof(double));
+      if (!stream)
+      {
+        throw std::runtime_error("BinaryFileColumnBlocks::Visit(): '" +
+            filename + "' is too short for the given matrix size");
+      }
+
+      visitor(first, buffer);
+    }
+  }
+
+ private:
+  //! The file holding the matrix.
+  std::string filename;
+  //! The number of rows of the matrix.
+  size_t numRows;
+  //! The number of columns of the matrix.
+  size_t numCols;
+  //! The number of columns of each block.
+  size_t blockSize;
+};
+
+} // namespace svd
+} // namespace mlpack
+
+#endif
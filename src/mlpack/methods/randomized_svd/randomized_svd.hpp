@@ -15,6 +15,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "column_blocks.hpp"
+
 namespace mlpack {
 namespace svd {
 
@@ -231,6 +233,31 @@ class RandomizedSVD
     }
   }
 
+  /**
+   * Apply Principal Component Analysis to a matrix that is read one block of
+   * columns at a time (for instance, from a file with BinaryFileColumnBlocks),
+   * using randomized SVD.  The products with the data matrix and its transpose
+   * are accumulated block by block, so only O((m + n) l) memory is needed for
+   * an m x n matrix, where l is the size of the normalized power iterations;
+   * the matrix itself is never held in memory.  Each power iteration reads the
+   * matrix twice, and computing the mean and the final projection read it
+   * once each.
+   *
+   * @tparam ColumnBlocksType Source of the matrix, such as MatColumnBlocks or
+   *     BinaryFileColumnBlocks.
+   * @param blocks Source of the data matrix.
+   * @param u First unitary matrix.
+   * @param s Diagonal "Sigma" matrix of singular values.
+   * @param v Second unitary matrix.
+   * @param rank Rank of the approximation.
+   */
+  template<typename ColumnBlocksType>
+  void ApplyStreaming(const ColumnBlocksType& blocks,
+                      arma::mat& u,
+                      arma::vec& s,
+                      arma::mat& v,
+                      const size_t rank);
+
   //! Get the size of the normalized power iterations.
   size_t IteratedPower() const { return iteratedPower; }
   //! Modify the size of the normalized power iterations.
@@ -260,4 +287,7 @@ class RandomizedSVD
 } // namespace svd
 } // namespace mlpack
 
+// Include implementation.
+#include "randomized_svd_impl.hpp"
+
 #endif
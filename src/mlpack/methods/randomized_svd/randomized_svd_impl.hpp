@@ -0,0 +1,110 @@
+/**
+ * @file methods/randomized_svd/randomized_svd_impl.hpp
+ *
+ * Implementation of the out-of-core randomized SVD, which reads the data
+ * matrix one block of columns at a time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOMIZED_SVD_RANDOMIZED_SVD_IMPL_HPP
+#define MLPACK_METHODS_RANDOMIZED_SVD_RANDOMIZED_SVD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "randomized_svd.hpp"
+
+namespace mlpack {
+namespace svd {
+
+template<typename ColumnBlocksType>
+void RandomizedSVD::ApplyStreaming(const ColumnBlocksType& blocks,
+                                   arma::mat& u,
+                                   arma::vec& s,
+                                   arma::mat& v,
+                                   const size_t rank)
+{
+  if (iteratedPower == 0)
+    iteratedPower = rank + 2;
+
+  const size_t n = blocks.NumCols();
+
+  // Center the data; the centered matrix A - mean 1^T is never formed, and the
+  // mean is subtracted from each product instead.
+  arma::vec rowMean(blocks.NumRows(), arma::fill::zeros);
+  blocks.Visit([&](const size_t /* first */, const arma::mat& block)
+  {
+    rowMean += arma::sum(block, 1);
+  });
+  rowMean = rowMean / n + eps;
+
+  // Apply the centered data matrix to a random matrix, obtaining Q, one block
+  // of the random matrix at a time.
+  arma::mat Q(blocks.NumRows(), iteratedPower, arma::fill::zeros);
+  arma::rowvec rSums(iteratedPower, arma::fill::zeros);
+  blocks.Visit([&](const size_t /* first */, const arma::mat& block)
+  {
+    const arma::mat R = arma::randn<arma::mat>(block.n_cols, iteratedPower);
+    Q += block * R;
+    rSums += arma::sum(R, 0);
+  });
+  Q -= rowMean * rSums;
+
+  // Form a matrix Q whose columns constitute a well-conditioned basis for the
+  // columns of the earlier Q.
+  arma::mat Z, tmp;
+  if (maxIterations == 0)
+    arma::qr_econ(Q, tmp, Q);
+  else
+    arma::lu(Q, tmp, Q);
+
+  // Perform normalized power iterations.
+  for (size_t i = 0; i < maxIterations; ++i)
+  {
+    // Z = (A - mean 1^T)^T Q, one block of rows of Z at a time.
+    const arma::rowvec meanQ = rowMean.t() * Q;
+    Z.set_size(n, Q.n_cols);
+    blocks.Visit([&](const size_t first, const arma::mat& block)
+    {
+      Z.rows(first, first + block.n_cols - 1) = block.t() * Q;
+      Z.rows(first, first + block.n_cols - 1).each_row() -= meanQ;
+    });
+    arma::lu(Z, tmp, Z);
+
+    // Q = (A - mean 1^T) Z, accumulated over the blocks.
+    Q.zeros(blocks.NumRows(), Z.n_cols);
+    blocks.Visit([&](const size_t first, const arma::mat& block)
+    {
+      Q += block * Z.rows(first, first + block.n_cols - 1);
+    });
+    Q -= rowMean * arma::sum(Z, 0);
+
+    // Computing the LU decomposition is more efficient than computing the QR
+    // decomposition, so we only use it in the last iteration, a pivoted QR
+    // decomposition which renormalizes Q, ensuring that the columns of Q are
+    // orthonormal.
+    if (i < (maxIterations - 1))
+      arma::lu(Q, tmp, Q);
+    else
+      arma::qr_econ(Q, tmp, Q);
+  }
+
+  // Project the centered data onto Q, one block of columns at a time, and do
+  // an economical singular value decomposition of the projection.
+  arma::mat Qdata(Q.n_cols, n);
+  const arma::vec qMean = Q.t() * rowMean;
+  blocks.Visit([&](const size_t first, const arma::mat& block)
+  {
+    Qdata.cols(first, first + block.n_cols - 1) = Q.t() * block;
+    Qdata.cols(first, first + block.n_cols - 1).each_col() -= qMean;
+  });
+
+  arma::svd_econ(u, s, v, Qdata);
+  u = Q * u;
+}
+
+} // namespace svd
+} // namespace mlpack
+
+#endif
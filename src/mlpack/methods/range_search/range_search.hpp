@@ -17,6 +17,7 @@
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include "range_search_stat.hpp"
+#include "range_search_results.hpp"
 
 namespace mlpack {
 namespace range /** Range-search routines. */ {
@@ -268,6 +269,70 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Count the reference points in the given range of each point in the query
+   * set, without storing them.  The limit given by MaxResults() applies, so if
+   * it is nonzero the search for a query point stops as soon as that many
+   * points are found; this is useful to check whether points have a minimum
+   * number of neighbors.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param counts Vector that will hold the number of reference points in
+   *      range of each query point.
+   */
+  void Count(const MatType& querySet,
+             const math::Range& range,
+             arma::Row<size_t>& counts);
+
+  /**
+   * Count the points in the given range of each point in the reference set,
+   * without storing them; the query set is the reference set, and a point is
+   * not counted in its own range.  See the other overload of Count().
+   *
+   * @param range Range of distances in which to search.
+   * @param counts Vector that will hold the number of points in range of each
+   *      reference point.
+   */
+  void Count(const math::Range& range, arma::Row<size_t>& counts);
+
+  /**
+   * Search for all reference points in the given range of each point in the
+   * query set, and pass each result to the given callback as soon as it is
+   * found, instead of storing it.  This allows range searches whose results do
+   * not fit in memory.  The callback is called as
+   *
+   * @code
+   * callback(queryIndex, referenceIndex, distance);
+   * @endcode
+   *
+   * with the original indices of the points, in no particular order.  The
+   * limit given by MaxResults() applies.
+   *
+   * In naive and single-tree mode, query points are searched in parallel if
+   * OpenMP is available, so the callback may be called from several threads at
+   * the same time (but never at the same time for the same query point).
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param callback Callback to call for each result.
+   */
+  template<typename CallbackType>
+  void Stream(const MatType& querySet,
+              const math::Range& range,
+              CallbackType& callback);
+
+  /**
+   * Search for all points in the given range of each point in the reference
+   * set, and pass each result to the given callback; the query set is the
+   * reference set.  See the other overload of Stream().
+   *
+   * @param range Range of distances in which to search.
+   * @param callback Callback to call for each result.
+   */
+  template<typename CallbackType>
+  void Stream(const math::Range& range, CallbackType& callback);
+
   //! Get whether single-tree search is being used.
   bool SingleMode() const { return singleMode; }
   //! Modify whether single-tree search is being used.
@@ -278,6 +343,14 @@ class RangeSearch
   //! Modify whether naive search is being used.
   bool& Naive() { return naive; }
 
+  //! Get the maximum number of results for each query point (0 means no
+  //! limit).
+  size_t MaxResults() const { return maxResults; }
+  //! Modify the maximum number of results for each query point (0 means no
+  //! limit).  When a query point reaches the limit, the search for it stops,
+  //! and which of the points in range are returned is unspecified.
+  size_t& MaxResults() { return maxResults; }
+
   //! Get the number of base cases during the last search.
   size_t BaseCases() const { return baseCases; }
   //! Get the number of scores during the last search.
@@ -318,6 +391,22 @@ class RangeSearch
   //! The total number of scores during the last search.
   size_t scores;
 
+  //! The maximum number of results for each query point (0 means no limit).
+  size_t maxResults;
+
+  //! Return the mapping to the original reference indices, or NULL if the
+  //! reference indices do not need to be mapped.
+  const std::vector<size_t>* ReferenceMapping() const;
+
+  //! Search with the given query set (or with the reference set if querySet is
+  //! NULL), giving the results to the given result policy.  If a query tree is
+  //! built, oldFromNewQueries is filled before the traversal starts.
+  template<typename ResultType>
+  void SearchResults(const MatType* querySet,
+                     const math::Range& range,
+                     ResultType& results,
+                     std::vector<size_t>& oldFromNewQueries);
+
   //! For access to mappings when building models.
   friend class LeafSizeRSWrapper<TreeType>;
 };
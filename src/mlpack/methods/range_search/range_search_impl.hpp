@@ -61,7 +61,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     singleMode(!naive && singleMode),
     metric(metric),
     baseCases(0),
-    scores(0)
+    scores(0),
+    maxResults(0)
 {
   // Nothing to do.
 }
@@ -82,7 +83,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     singleMode(singleMode),
     metric(metric),
     baseCases(0),
-    scores(0)
+    scores(0),
+    maxResults(0)
 {
   // Nothing else to initialize.
 }
@@ -103,7 +105,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     singleMode(singleMode),
     metric(metric),
     baseCases(0),
-    scores(0)
+    scores(0),
+    maxResults(0)
 {
   // Build the tree on the empty dataset, if necessary.
   if (!naive)
@@ -131,7 +134,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     singleMode(other.singleMode),
     metric(other.metric),
     baseCases(other.baseCases),
-    scores(other.scores)
+    scores(other.scores),
+    maxResults(other.maxResults)
 {
   // Nothing to do.
 }
@@ -150,7 +154,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(RangeSearch&& other) :
     singleMode(other.singleMode),
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
-    scores(other.scores)
+    scores(other.scores),
+    maxResults(other.maxResults)
 {
   // Clear other object.
   other.referenceTree =
@@ -184,6 +189,7 @@ RangeSearch<MetricType, MatType, TreeType>::operator=(const RangeSearch& other)
     metric = other.metric;
     baseCases = other.baseCases;
     scores = other.scores;
+    maxResults = other.maxResults;
   }
   return *this;
 }
@@ -214,6 +220,7 @@ RangeSearch<MetricType, MatType, TreeType>::operator=(RangeSearch&& other)
     metric = std::move(other.metric);
     baseCases = other.baseCases;
     scores = other.scores;
+    maxResults = other.maxResults;
 
     // Clear other object.
     other.referenceTree = nullptr;
@@ -352,57 +359,10 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   distancePtr->clear();
   distancePtr->resize(querySet.n_cols);
 
-  // Create the helper object for the traversal.
-  typedef RangeSearchRules<MetricType, Tree> RuleType;
-
-  // Reset counts.
-  baseCases = 0;
-  scores = 0;
-
-  if (naive)
-  {
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
-
-    // The naive brute-force solution.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
-
-    baseCases += (querySet.n_cols * referenceSet->n_cols);
-  }
-  else if (singleMode)
-  {
-    // Create the traverser.
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    baseCases += rules.BaseCases();
-    scores += rules.Scores();
-  }
-  else // Dual-tree recursion.
-  {
-    // Build the query tree.
-    Tree* queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
-
-    // Create the traverser.
-    RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
-        *distancePtr, metric);
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-    traverser.Traverse(*queryTree, *referenceTree);
-
-    baseCases += rules.BaseCases();
-    scores += rules.Scores();
-
-    // Clean up tree memory.
-    delete queryTree;
-  }
+  // Perform the search; this fills oldFromNewQueries if a query tree is
+  // built.
+  VectorRangeResults results(*neighborPtr, *distancePtr, maxResults);
+  SearchResults(&querySet, range, results, oldFromNewQueries);
 
   // Map points back to original indices, if necessary.
   if (tree::TreeTraits<Tree>::RearrangesDataset)
@@ -508,8 +468,8 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
 
   // Create the helper object for the traversal.
   typedef RangeSearchRules<MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
-      distances, metric);
+  VectorRangeResults results(*neighborPtr, distances, maxResults);
+  RuleType rules(*referenceSet, queryTree->Dataset(), range, results, metric);
 
   // Create the traverser.
   typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
@@ -569,43 +529,10 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   distancePtr->clear();
   distancePtr->resize(referenceSet->n_cols);
 
-  // Create the helper object for the traversal.
-  typedef RangeSearchRules<MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
-      *distancePtr, metric, true /* don't return the query in the results */);
-
-  if (naive)
-  {
-    // The naive brute-force solution.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
-
-    baseCases = (referenceSet->n_cols * referenceSet->n_cols);
-    scores = 0;
-  }
-  else if (singleMode)
-  {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    baseCases = rules.BaseCases();
-    scores = rules.Scores();
-  }
-  else // Dual-tree recursion.
-  {
-    // Create the traverser.
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-    traverser.Traverse(*referenceTree, *referenceTree);
-
-    baseCases = rules.BaseCases();
-    scores = rules.Scores();
-  }
+  // Perform the search, with the reference set as the query set.
+  VectorRangeResults results(*neighborPtr, *distancePtr, maxResults);
+  std::vector<size_t> oldFromNewQueries; // Unused.
+  SearchResults(NULL, range, results, oldFromNewQueries);
 
   // Do we need to map the reference indices?
   if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
@@ -635,6 +562,186 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
 }
 
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const MatType& querySet,
+    const math::Range& range,
+    arma::Row<size_t>& counts)
+{
+  util::CheckSameDimensionality(querySet, *referenceSet,
+      "RangeSearch::Count()", "query set");
+
+  counts.zeros(querySet.n_cols);
+  std::vector<size_t> oldFromNewQueries;
+  CountRangeResults results(counts, maxResults, &oldFromNewQueries);
+  SearchResults(&querySet, range, results, oldFromNewQueries);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const math::Range& range,
+    arma::Row<size_t>& counts)
+{
+  counts.zeros(referenceSet->n_cols);
+  std::vector<size_t> oldFromNewQueries;
+  // The query points are the reference points.
+  CountRangeResults results(counts, maxResults, ReferenceMapping());
+  SearchResults(NULL, range, results, oldFromNewQueries);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename CallbackType>
+void RangeSearch<MetricType, MatType, TreeType>::Stream(
+    const MatType& querySet,
+    const math::Range& range,
+    CallbackType& callback)
+{
+  util::CheckSameDimensionality(querySet, *referenceSet,
+      "RangeSearch::Stream()", "query set");
+
+  std::vector<size_t> oldFromNewQueries;
+  CallbackRangeResults<CallbackType> results(callback, querySet.n_cols,
+      maxResults, &oldFromNewQueries, ReferenceMapping());
+  SearchResults(&querySet, range, results, oldFromNewQueries);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename CallbackType>
+void RangeSearch<MetricType, MatType, TreeType>::Stream(
+    const math::Range& range,
+    CallbackType& callback)
+{
+  std::vector<size_t> oldFromNewQueries;
+  CallbackRangeResults<CallbackType> results(callback, referenceSet->n_cols,
+      maxResults, ReferenceMapping(), ReferenceMapping());
+  SearchResults(NULL, range, results, oldFromNewQueries);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+const std::vector<size_t>*
+RangeSearch<MetricType, MatType, TreeType>::ReferenceMapping() const
+{
+  // Reference indices only need to be mapped if we built the reference tree
+  // ourselves.
+  return (!naive && treeOwner && tree::TreeTraits<Tree>::RearrangesDataset) ?
+      &oldFromNewReferences : NULL;
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename ResultType>
+void RangeSearch<MetricType, MatType, TreeType>::SearchResults(
+    const MatType* querySet,
+    const math::Range& range,
+    ResultType& results,
+    std::vector<size_t>& oldFromNewQueries)
+{
+  typedef RangeSearchRules<MetricType, Tree, ResultType> RuleType;
+
+  // Reset counts.
+  baseCases = 0;
+  scores = 0;
+
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
+
+  // If no query set is given, the reference set is the query set.
+  const bool sameSet = (querySet == NULL);
+  const MatType& queries = sameSet ? *referenceSet : *querySet;
+
+  if (naive || singleMode)
+  {
+    // Query points are independent, so they are searched in parallel, with
+    // one set of rules for each thread.  Trees with self-children (i.e. the
+    // cover tree) cache the last computed distance in the node statistics
+    // during single-tree scoring, so they cannot be traversed by several
+    // threads at the same time.
+    const bool parallel = naive || !tree::TreeTraits<Tree>::HasSelfChildren;
+    size_t totalBaseCases = 0;
+    size_t totalScores = 0;
+
+    #pragma omp parallel if (parallel) reduction(+:totalBaseCases, totalScores)
+    {
+      RuleType rules(*referenceSet, queries, range, results, metric, sameSet);
+      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) queries.n_cols; ++i)
+      {
+        if (naive)
+        {
+          // The naive brute-force solution.
+          for (size_t j = 0; j < referenceSet->n_cols; ++j)
+            rules.BaseCase(i, j);
+        }
+        else
+        {
+          traverser.Traverse(i, *referenceTree);
+        }
+      }
+
+      totalBaseCases += rules.BaseCases();
+      totalScores += rules.Scores();
+    }
+
+    // The naive search counts the skipped base cases too.
+    baseCases += naive ? (queries.n_cols * referenceSet->n_cols) :
+        totalBaseCases;
+    scores += totalScores;
+  }
+  else if (sameSet)
+  {
+    RuleType rules(*referenceSet, *referenceSet, range, results, metric, true);
+    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+
+    traverser.Traverse(*referenceTree, *referenceTree);
+
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+  }
+  else
+  {
+    // Build the query tree; this also fills the query mapping that the results
+    // object uses.
+    Tree* queryTree = BuildTree<Tree>(queries, oldFromNewQueries);
+
+    RuleType rules(*referenceSet, queryTree->Dataset(), range, results,
+        metric);
+    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+
+    traverser.Traverse(*queryTree, *referenceTree);
+
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+
+    delete queryTree;
+  }
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
@@ -107,7 +107,9 @@ PARAM_DOUBLE_IN("min", "Lower bound in range.", "L", 0.0);
 // building.
 PARAM_STRING_IN("tree_type", "Type of tree to use: 'kd', 'vp', 'rp', 'max-rp', "
     "'ub', 'cover', 'r', 'r-star', 'x', 'ball', 'hilbert-r', 'r-plus', "
-    "'r-plus-plus', 'oct'.", "t", "kd");
+    "'r-plus-plus', 'oct', 'auto'.  'auto' chooses the tree type and the leaf "
+    "size by building candidate trees on a sample of the reference set and "
+    "timing a sample of the queries.", "t", "kd");
 PARAM_INT_IN("leaf_size", "Leaf size for tree building (used for kd-trees, "
     "vp trees, random projection trees, UB trees, R trees, R* trees, X trees, "
     "Hilbert R trees, R+ trees, R++ trees, and octrees).", "l", 20);
@@ -175,7 +177,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     const string treeType = params.Get<string>("tree_type");
     RequireParamInSet<string>(params, "tree_type", { "kd", "cover", "r",
         "r-star", "ball", "x", "hilbert-r", "r-plus", "r-plus-plus", "vp", "rp",
-        "max-rp", "ub", "oct" }, true, "unknown tree type");
+        "max-rp", "ub", "oct", "auto" }, true, "unknown tree type");
     const bool randomBasis = params.Has("random_basis");
 
     rs = new RSModel();
@@ -218,9 +220,21 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     arma::mat referenceSet = std::move(params.Get<arma::mat>("reference"));
 
-    const size_t leafSize = size_t(lsInt);
+    rs->LeafSize() = size_t(lsInt);
+
+    // The tree is tuned for the search that will be done, if any.
+    if (treeType == "auto")
+    {
+      const arma::mat noQueries;
+      const arma::mat& queries = ((params.Has("min") || params.Has("max")) &&
+          params.Has("query")) ? params.Get<arma::mat>("query") : noQueries;
+      const math::Range r(params.Get<double>("min"), params.Has("max") ?
+          params.Get<double>("max") : DBL_MAX);
+      rs->Tune(timers, referenceSet, queries, r, naive, singleMode);
+    }
 
-    rs->BuildModel(timers, std::move(referenceSet), leafSize, naive, singleMode);
+    rs->BuildModel(timers, std::move(referenceSet), rs->LeafSize(), naive,
+        singleMode);
   }
   else
   {
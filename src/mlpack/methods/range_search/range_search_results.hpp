@@ -0,0 +1,249 @@
+/**
+ * @file methods/range_search/range_search_results.hpp
+ *
+ * Result policies for RangeSearchRules.  A result policy decides what happens
+ * to each (query point, reference point, distance) triple found by a range
+ * search: it can be stored, counted, or passed to a callback.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RESULTS_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RESULTS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace range {
+
+/**
+ * Store the results of a range search in a vector of neighbor indices and a
+ * vector of distances for each query point.  This is the policy used by
+ * RangeSearch::Search().
+ *
+ * Each result policy provides the same interface:
+ *
+ *  - `static const bool NeedsDistances`: if false, the distances passed to
+ *    Add() are not used, so they need not be computed when every point of a
+ *    reference node is known to be in range.
+ *  - `bool Full(queryIndex) const`: whether the query point has reached its
+ *    maximum number of results, so that no more results need to be found.
+ *  - `void Reserve(queryIndex, count)`: a hint that up to count more results
+ *    are about to be added for the query point.
+ *  - `void Add(queryIndex, referenceIndex, distance)`: add one result.
+ *
+ * Indices passed to the policy are indices in the datasets given to the rules
+ * (i.e. possibly rearranged by tree building).
+ */
+class VectorRangeResults
+{
+ public:
+  //! The distances of the results are stored.
+  static const bool NeedsDistances = true;
+
+  /**
+   * Store the results in the given vectors, which must already hold one
+   * (possibly empty) vector for each query point.
+   *
+   * @param neighbors Vector to store the neighbors of each query point in.
+   * @param distances Vector to store the distances of each query point in.
+   * @param maxResults Maximum number of results for each query point (0 means
+   *     no limit).
+   */
+  VectorRangeResults(std::vector<std::vector<size_t>>& neighbors,
+                     std::vector<std::vector<double>>& distances,
+                     const size_t maxResults = 0) :
+      neighbors(neighbors),
+      distances(distances),
+      maxResults(maxResults)
+  { }
+
+  //! Return whether the given query point has reached the maximum number of
+  //! results.
+  bool Full(const size_t queryIndex) const
+  {
+    return (maxResults > 0) && (neighbors[queryIndex].size() >= maxResults);
+  }
+
+  //! Reserve space for the given number of additional results.
+  void Reserve(const size_t queryIndex, const size_t count)
+  {
+    size_t newSize = neighbors[queryIndex].size() + count;
+    if (maxResults > 0)
+      newSize = std::min(newSize, maxResults);
+
+    neighbors[queryIndex].reserve(newSize);
+    distances[queryIndex].reserve(newSize);
+  }
+
+  //! Add a result.
+  void Add(const size_t queryIndex,
+           const size_t referenceIndex,
+           const double distance)
+  {
+    neighbors[queryIndex].push_back(referenceIndex);
+    distances[queryIndex].push_back(distance);
+  }
+
+ private:
+  //! The neighbors of each query point.
+  std::vector<std::vector<size_t>>& neighbors;
+  //! The distances of each query point.
+  std::vector<std::vector<double>>& distances;
+  //! The maximum number of results for each query point.
+  size_t maxResults;
+};
+
+/**
+ * Count the number of results of each query point, without storing them.
+ * Query indices are mapped to their original indices before they are counted,
+ * so the counts are in the order of the original query set.
+ */
+class CountRangeResults
+{
+ public:
+  //! Counting does not need distances.
+  static const bool NeedsDistances = false;
+
+  /**
+   * Store the counts in the given vector, which must already have one element
+   * for each query point, set to zero.
+   *
+   * @param counts Vector to store the number of results of each query point.
+   * @param maxResults Count at most this many results for each query point (0
+   *     means no limit).
+   * @param oldFromNewQueries Mapping to the original query indices, or NULL
+   *     (or empty) if the query indices are not rearranged.
+   */
+  CountRangeResults(arma::Row<size_t>& counts,
+                    const size_t maxResults = 0,
+                    const std::vector<size_t>* oldFromNewQueries = NULL) :
+      counts(counts),
+      maxResults(maxResults),
+      oldFromNewQueries(oldFromNewQueries)
+  { }
+
+  //! Return whether the given query point has reached the maximum number of
+  //! results.
+  bool Full(const size_t queryIndex) const
+  {
+    return (maxResults > 0) && (counts[Query(queryIndex)] >= maxResults);
+  }
+
+  //! Nothing is stored, so nothing needs to be reserved.
+  void Reserve(const size_t /* queryIndex */, const size_t /* count */) { }
+
+  //! Count a result.
+  void Add(const size_t queryIndex,
+           const size_t /* referenceIndex */,
+           const double /* distance */)
+  {
+    ++counts[Query(queryIndex)];
+  }
+
+ private:
+  //! Return the original index of the given query point.
+  size_t Query(const size_t queryIndex) const
+  {
+    return (oldFromNewQueries && !oldFromNewQueries->empty()) ?
+        (*oldFromNewQueries)[queryIndex] : queryIndex;
+  }
+
+  //! The number of results of each query point.
+  arma::Row<size_t>& counts;
+  //! The maximum number of results for each query point.
+  size_t maxResults;
+  //! The mapping to the original query indices.
+  const std::vector<size_t>* oldFromNewQueries;
+};
+
+/**
+ * Pass each result to a callback as soon as it is found, without storing it.
+ * The callback is called as `callback(queryIndex, referenceIndex, distance)`,
+ * with the original indices of the query and reference points.  Results are
+ * not found in any particular order.
+ *
+ * @tparam CallbackType Type of the callback.
+ */
+template<typename CallbackType>
+class CallbackRangeResults
+{
+ public:
+  //! The callback is given the distances.
+  static const bool NeedsDistances = true;
+
+  /**
+   * Pass the results to the given callback.
+   *
+   * @param callback Callback to call for each result.
+   * @param numQueries Number of query points.
+   * @param maxResults Maximum number of results for each query point (0 means
+   *     no limit).
+   * @param oldFromNewQueries Mapping to the original query indices, or NULL
+   *     (or empty) if the query indices are not rearranged.
+   * @param oldFromNewReferences Mapping to the original reference indices, or
+   *     NULL (or empty) if the reference indices are not rearranged.
+   */
+  CallbackRangeResults(
+      CallbackType& callback,
+      const size_t numQueries,
+      const size_t maxResults = 0,
+      const std::vector<size_t>* oldFromNewQueries = NULL,
+      const std::vector<size_t>* oldFromNewReferences = NULL) :
+      callback(callback),
+      maxResults(maxResults),
+      oldFromNewQueries(oldFromNewQueries),
+      oldFromNewReferences(oldFromNewReferences)
+  {
+    // The number of results is only needed to enforce the limit.
+    if (maxResults > 0)
+      counts.zeros(numQueries);
+  }
+
+  //! Return whether the given query point has reached the maximum number of
+  //! results.
+  bool Full(const size_t queryIndex) const
+  {
+    return (maxResults > 0) && (counts[queryIndex] >= maxResults);
+  }
+
+  //! Nothing is stored, so nothing needs to be reserved.
+  void Reserve(const size_t /* queryIndex */, const size_t /* count */) { }
+
+  //! Pass a result to the callback.
+  void Add(const size_t queryIndex,
+           const size_t referenceIndex,
+           const double distance)
+  {
+    if (maxResults > 0)
+      ++counts[queryIndex];
+
+    callback(Map(oldFromNewQueries, queryIndex),
+        Map(oldFromNewReferences, referenceIndex), distance);
+  }
+
+ private:
+  //! Map the given index with the given mapping, if there is one.
+  static size_t Map(const std::vector<size_t>* oldFromNew, const size_t index)
+  {
+    return (oldFromNew && !oldFromNew->empty()) ? (*oldFromNew)[index] : index;
+  }
+
+  //! The callback.
+  CallbackType& callback;
+  //! The number of results of each query point (if there is a limit).
+  arma::Col<size_t> counts;
+  //! The maximum number of results for each query point.
+  size_t maxResults;
+  //! The mapping to the original query indices.
+  const std::vector<size_t>* oldFromNewQueries;
+  //! The mapping to the original reference indices.
+  const std::vector<size_t>* oldFromNewReferences;
+};
+
+} // namespace range
+} // namespace mlpack
+
+#endif
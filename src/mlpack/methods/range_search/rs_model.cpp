@@ -195,6 +195,60 @@ void RSModel::BuildModel(util::Timers& timers,
     Log::Info << "Tree built." << std::endl;
 }
 
+// Choose the tree type and the leaf size.
+void RSModel::Tune(util::Timers& timers,
+                   const arma::mat& referenceSet,
+                   const arma::mat& querySet,
+                   const math::Range& range,
+                   const bool naive,
+                   const bool singleMode,
+                   const tree::TreeTuner& tuner)
+{
+  timers.Start("tree_tuning");
+  Log::Info << "Choosing the tree type for range search..." << std::endl;
+
+  // The candidates are searched directly through their wrappers, so that the
+  // trials are not reported like real searches.
+  RSModel trial;
+
+  const TreeTypes treeTypes[] = { KD_TREE, BALL_TREE, VP_TREE, MAX_RP_TREE,
+      COVER_TREE, R_STAR_TREE };
+  std::vector<tree::TreeCandidate> candidates;
+  for (size_t i = 0; i < sizeof(treeTypes) / sizeof(TreeTypes); ++i)
+  {
+    trial.treeType = treeTypes[i];
+    tuner.AddCandidates(candidates, treeTypes[i], trial.TreeName(),
+        treeTypes[i] != COVER_TREE && treeTypes[i] != R_STAR_TREE);
+  }
+
+  auto build = [&](const tree::TreeCandidate& candidate,
+                   arma::mat&& references)
+  {
+    trial.treeType = (TreeTypes) candidate.treeType;
+    trial.leafSize = (candidate.leafSize > 0) ? candidate.leafSize : leafSize;
+    trial.InitializeModel(naive, singleMode);
+
+    util::Timers buildTimers;
+    trial.rSearch->Train(buildTimers, std::move(references), trial.leafSize);
+  };
+
+  auto search = [&](arma::mat&& queries, util::Timers& searchTimers)
+  {
+    std::vector<std::vector<size_t>> neighbors;
+    std::vector<std::vector<double>> distances;
+    trial.rSearch->Search(searchTimers, std::move(queries), range, neighbors,
+        distances, trial.leafSize);
+  };
+
+  const size_t best = tuner.Tune(referenceSet, querySet, candidates, build,
+      search);
+  treeType = (TreeTypes) candidates[best].treeType;
+  if (candidates[best].leafSize > 0)
+    leafSize = candidates[best].leafSize;
+
+  timers.Stop("tree_tuning");
+}
+
 // Perform range search.
 void RSModel::Search(util::Timers& timers,
                      arma::mat&& querySet,
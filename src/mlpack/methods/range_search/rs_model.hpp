@@ -19,6 +19,7 @@
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/octree.hpp>
+#include <mlpack/core/tree/tree_tuner.hpp>
 
 #include "range_search.hpp"
 
@@ -328,6 +329,33 @@ class RSModel
                   const bool naive,
                   const bool singleMode);
 
+  /**
+   * Choose the tree type and the leaf size with the given tuner: kd-trees,
+   * ball trees, vantage point trees, random projection trees, cover trees and
+   * R* trees are built on a sample of the reference set and searched with a
+   * sample of the queries, and TreeType() and LeafSize() are set to the
+   * configuration with the lowest estimated cost of building the tree and
+   * answering all the queries.  The tree is not built; call BuildModel()
+   * afterwards with LeafSize().  This is what the range_search binding does
+   * when the tree type is 'auto'.
+   *
+   * @param timers Object to hold timing information in.
+   * @param referenceSet Reference set the model will be built on.
+   * @param querySet Query set that will be searched; if empty, the search is
+   *     assumed to be monochromatic.
+   * @param range Range that will be searched for.
+   * @param naive Whether naive search will be used.
+   * @param singleMode Whether single-tree search will be used.
+   * @param tuner Tuner that samples the data and tries the candidates.
+   */
+  void Tune(util::Timers& timers,
+            const arma::mat& referenceSet,
+            const arma::mat& querySet,
+            const math::Range& range,
+            const bool naive,
+            const bool singleMode,
+            const tree::TreeTuner& tuner = tree::TreeTuner());
+
   /**
    * Perform range search.  This takes possession of the query set, so the query
    * set will not be usable after the search.  For more information on the
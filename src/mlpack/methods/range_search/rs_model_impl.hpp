@@ -55,12 +55,16 @@ void RSWrapper<TreeType>::Search(util::Timers& timers,
     timers.Start("computing_neighbors");
     rs.Search(&queryTree, range, neighbors, distances);
     timers.Stop("computing_neighbors");
+    timers.Count("base_cases", rs.BaseCases());
+    timers.Count("scores", rs.Scores());
   }
   else
   {
     timers.Start("computing_neighbors");
     rs.Search(std::move(querySet), range, neighbors, distances);
     timers.Stop("computing_neighbors");
+    timers.Count("base_cases", rs.BaseCases());
+    timers.Count("scores", rs.Scores());
   }
 }
 
@@ -75,6 +79,8 @@ void RSWrapper<TreeType>::Search(util::Timers& timers,
   timers.Start("computing_neighbors");
   rs.Search(range, neighbors, distances);
   timers.Stop("computing_neighbors");
+  timers.Count("base_cases", rs.BaseCases());
+  timers.Count("scores", rs.Scores());
 }
 
 template<template<typename TreeMetricType,
@@ -133,6 +139,8 @@ void LeafSizeRSWrapper<TreeType>::Search(
     timers.Start("computing_neighbors");
     rs.Search(&queryTree, range, neighborsOut, distancesOut);
     timers.Stop("computing_neighbors");
+    timers.Count("base_cases", rs.BaseCases());
+    timers.Count("scores", rs.Scores());
 
     // Remap the query points.
     neighbors.resize(queryTree.Dataset().n_cols);
@@ -148,6 +156,8 @@ void LeafSizeRSWrapper<TreeType>::Search(
     timers.Start("computing_neighbors");
     rs.Search(std::move(querySet), range, neighbors, distances);
     timers.Stop("computing_neighbors");
+    timers.Count("base_cases", rs.BaseCases());
+    timers.Count("scores", rs.Scores());
   }
 }
 
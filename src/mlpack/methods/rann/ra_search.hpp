@@ -64,6 +64,12 @@ class LeafSizeRAWrapper;
  *
  * RASearch is currently known to not work with ball trees (#356).
  *
+ * If OpenMP is available, query points (or, in dual-tree mode, disjoint query
+ * subtrees) are searched in parallel.  Each query point or subtree samples from
+ * its own stream of random numbers, derived from a single draw of the global
+ * random number generator, so for a fixed random seed (see math::RandomSeed())
+ * the results do not depend on the number of threads.
+ *
  * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
  * @tparam MetricType The metric to use for computation.
  * @tparam TreeType The tree type to use.
@@ -17,6 +17,8 @@
 
 #include "ra_search_rules.hpp"
 
+#include <mlpack/core/tree/parallel_subtrees.hpp>
+
 namespace mlpack {
 namespace neighbor {
 
@@ -289,13 +291,20 @@ Search(const MatType& querySet,
 
   typedef RASearchRules<SortPolicy, MetricType, Tree> RuleType;
 
+  // Each query point (or, in dual-tree mode, each query subtree) samples from
+  // its own stream of random numbers, so the results for a given random seed
+  // do not depend on the number of threads.
+  const size_t seed = (size_t) math::RandInt(std::numeric_limits<int>::max());
+  size_t numDistComputations = 0;
+
   if (naive)
   {
     RuleType rules(*referenceSet, querySet, k, metric, tau, alpha, naive,
         sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
 
     // Find how many samples from the reference set we need and sample uniformly
-    // from the reference set without replacement.
+    // from the reference set without replacement.  The same samples are used
+    // for every query point.
     const size_t numSamples = RAUtil::MinimumSamplesReqd(referenceSet->n_cols,
         k, tau, alpha);
     arma::uvec distinctSamples;
@@ -303,12 +312,22 @@ Search(const MatType& querySet,
         distinctSamples);
 
     // Run the base case on each combination of query point and sampled
-    // reference point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      for (size_t j = 0; j < distinctSamples.n_elem; ++j)
-        rules.BaseCase(i, (size_t) distinctSamples[j]);
+    // reference point.  Base cases only modify the candidates of their query
+    // point, so the copy of the rules of each thread shares the candidates,
+    // and only counts its own base cases.
+    #pragma omp parallel
+    {
+      RuleType threadRules(rules);
 
-    rules.GetResults(*neighborPtr, *distancePtr);
+      #pragma omp for schedule(static)
+      for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+      {
+        for (size_t j = 0; j < distinctSamples.n_elem; ++j)
+          threadRules.BaseCase(i, (size_t) distinctSamples[j]);
+
+        threadRules.GetResult(i, *neighborPtr, *distancePtr);
+      }
+    }
   }
   else if (singleMode)
   {
@@ -321,20 +340,34 @@ Search(const MatType& querySet,
     {
       Log::Info << "Performing single-tree traversal..." << std::endl;
 
-      // Create the traverser.
-      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+      // Now have each thread traverse for its query points, each with its own
+      // copy of the rules (and so its own random number generator); the copies
+      // share the candidates, and each touches only its own query points.
+      #pragma omp parallel reduction(+:numDistComputations)
+      {
+        RuleType threadRules(rules);
+        typename Tree::template SingleTreeTraverser<RuleType>
+            traverser(threadRules);
 
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+        #pragma omp for schedule(dynamic, 16)
+        for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+        {
+          threadRules.Seed(seed, i);
+          traverser.Traverse(i, *referenceTree);
+          threadRules.GetResult(i, *neighborPtr, *distancePtr);
+        }
+
+        numDistComputations += threadRules.NumDistComputations();
+      }
 
       Log::Info << "Single-tree traversal complete." << std::endl;
       Log::Info << "Average number of distance calculations per query point: "
-          << (rules.NumDistComputations() / querySet.n_cols) << "."
-          << std::endl;
+          << (numDistComputations / querySet.n_cols) << "." << std::endl;
+    }
+    else
+    {
+      rules.GetResults(*neighborPtr, *distancePtr);
     }
-
-    rules.GetResults(*neighborPtr, *distancePtr);
   }
   else // Dual-tree recursion.
   {
@@ -346,18 +379,41 @@ Search(const MatType& querySet,
 
     RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, tau, alpha,
         naive, sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
 
     Log::Info << "Query statistic pre-search: "
         << queryTree->Stat().NumSamplesMade() << std::endl;
 
-    traverser.Traverse(*queryTree, *referenceTree);
+    // Split the query tree into subtrees that are traversed independently, in
+    // a way that does not depend on the number of threads.
+    const std::vector<Tree*> subtrees = tree::SplitSubtrees(*queryTree,
+        std::max((size_t) 1000, (size_t) (queryTree->NumDescendants() / 64)));
+
+    // The copy of the rules of each thread shares the candidates; the subtrees
+    // are disjoint, so each query point is only touched by one thread.
+    #pragma omp parallel reduction(+:numDistComputations)
+    {
+      RuleType threadRules(rules);
+      typename Tree::template DualTreeTraverser<RuleType>
+          traverser(threadRules);
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t s = 0; s < (omp_size_t) subtrees.size(); ++s)
+      {
+        threadRules.Seed(seed, s);
+        traverser.Traverse(*subtrees[s], *referenceTree);
+        for (size_t i = 0; i < subtrees[s]->NumDescendants(); ++i)
+        {
+          threadRules.GetResult(subtrees[s]->Descendant(i), *neighborPtr,
+              *distancePtr);
+        }
+      }
+
+      numDistComputations += threadRules.NumDistComputations();
+    }
 
     Log::Info << "Dual-tree traversal complete." << std::endl;
     Log::Info << "Average number of distance calculations per query point: "
-        << (rules.NumDistComputations() / querySet.n_cols) << "." << std::endl;
-
-    rules.GetResults(*neighborPtr, *distancePtr);
+        << (numDistComputations / querySet.n_cols) << "." << std::endl;
 
     delete queryTree;
   }
@@ -458,6 +514,7 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
 
   // Create the traverser.
   typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+  rules.Seed((size_t) math::RandInt(std::numeric_limits<int>::max()), 0);
   traverser.Traverse(*queryTree, *referenceTree);
 
   rules.GetResults(*neighborPtr, distances);
@@ -508,40 +565,59 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   RuleType rules(*referenceSet, *referenceSet, k, metric, tau, alpha, naive,
       sampleAtLeaves, firstLeafExact, singleSampleLimit, true /* same sets */);
 
+  // As in the bichromatic case, each query point samples from its own stream of
+  // random numbers.
+  const size_t seed = (size_t) math::RandInt(std::numeric_limits<int>::max());
+
   if (naive)
   {
-    // Find how many samples from the reference set we need and sample uniformly
-    // from the reference set without replacement.
-    const size_t numSamples = RAUtil::MinimumSamplesReqd(referenceSet->n_cols,
-        k, tau, alpha);
-    arma::uvec distinctSamples;
-    math::ObtainDistinctSamples(0, referenceSet->n_cols, numSamples,
-        distinctSamples);
+    // The naive brute-force solution.  Base cases only modify the candidates of
+    // their query point, so the copy of the rules of each thread shares the
+    // candidates.
+    #pragma omp parallel
+    {
+      RuleType threadRules(rules);
+
+      #pragma omp for schedule(static)
+      for (omp_size_t i = 0; i < (omp_size_t) referenceSet->n_cols; ++i)
+      {
+        for (size_t j = 0; j < referenceSet->n_cols; ++j)
+          threadRules.BaseCase(i, j);
 
-    // The naive brute-force solution.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
+        threadRules.GetResult(i, *neighborPtr, *distancePtr);
+      }
+    }
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    // Now have each thread traverse for its query points, with a copy of the
+    // rules that shares the candidates.
+    #pragma omp parallel
+    {
+      RuleType threadRules(rules);
+      typename Tree::template SingleTreeTraverser<RuleType>
+          traverser(threadRules);
 
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) referenceSet->n_cols; ++i)
+      {
+        threadRules.Seed(seed, i);
+        traverser.Traverse(i, *referenceTree);
+        threadRules.GetResult(i, *neighborPtr, *distancePtr);
+      }
+    }
   }
   else
   {
-    // Create the traverser.
+    // The query tree is the reference tree, so its statistics are read and
+    // written by the same traversal; this is done by a single thread.
     typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
 
+    rules.Seed(seed, 0);
     traverser.Traverse(*referenceTree, *referenceTree);
+    rules.GetResults(*neighborPtr, *distancePtr);
   }
 
-  rules.GetResults(*neighborPtr, *distancePtr);
-
   // Do we need to map the reference indices?
   if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
   {
@@ -66,6 +66,19 @@ class RASearchRules
                 const size_t singleSampleLimit = 20,
                 const bool sameSet = false);
 
+  /**
+   * Construct a RASearchRules object that shares the candidate lists and the
+   * numbers of samples made of the given rules, so that several threads can
+   * search disjoint sets of query points without copying the candidates of
+   * every query point.  Each thread must only touch its own query points.  The
+   * random number generator and the traversal information are copied, and the
+   * number of distance computations starts at zero.  The given rules must
+   * outlive the new object.
+   *
+   * @param other Rules to share the candidate lists of.
+   */
+  RASearchRules(const RASearchRules& other);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -75,6 +88,31 @@ class RASearchRules
    */
   void GetResults(arma::Mat<size_t>& neighbors, arma::mat& distances);
 
+  /**
+   * Store the list of candidates for the given query point in the given column
+   * of the matrices, which must already have k rows and a column for each
+   * query point.  Each query point may only be extracted once.
+   *
+   * @param queryIndex Index of the query point.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void GetResult(const size_t queryIndex,
+                 arma::Mat<size_t>& neighbors,
+                 arma::mat& distances);
+
+  /**
+   * Restart the random number generator used for sampling, at the given
+   * stream of the given seed.  Samples depend only on the seed, the stream,
+   * and the calls made since then, so a traversal gives the same results no
+   * matter which thread (or which copy of the rules) runs it.
+   *
+   * @param seed Seed shared by all streams.
+   * @param stream Index of the stream (e.g. a query point or a query subtree).
+   */
+  void Seed(const size_t seed, const size_t stream);
+
   /**
    * Get the distance from the query point to the reference point.
    * This will update the list of candidates with the new point if appropriate.
@@ -268,8 +306,12 @@ class RASearchRules
   typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
       CandidateList;
 
-  //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  //! Set of candidate neighbors for each point, if owned by this object.
+  std::vector<CandidateList> ownCandidates;
+
+  //! Set of candidate neighbors for each point (possibly shared with the rules
+  //! this object was copied from).
+  std::vector<CandidateList>& candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -289,8 +331,12 @@ class RASearchRules
   //! The minimum number of samples required per query.
   size_t numSamplesReqd;
 
-  //! The number of samples made for every query.
-  arma::Col<size_t> numSamplesMade;
+  //! The number of samples made for every query, if owned by this object.
+  arma::Col<size_t> ownNumSamplesMade;
+
+  //! The number of samples made for every query (possibly shared with the
+  //! rules this object was copied from).
+  arma::Col<size_t>& numSamplesMade;
 
   //! The sampling ratio.
   double samplingRatio;
@@ -303,6 +349,19 @@ class RASearchRules
 
   TraversalInfoType traversalInfo;
 
+  //! The random number generator used for sampling.
+  std::mt19937 randGen;
+
+  /**
+   * Obtain no more than maxNumSamples distinct samples from [loInclusive,
+   * hiExclusive), like math::ObtainDistinctSamples(), but with the random
+   * number generator of this object instead of the global one.
+   */
+  void ObtainDistinctSamples(const size_t loInclusive,
+                             const size_t hiExclusive,
+                             const size_t maxNumSamples,
+                             arma::uvec& distinctSamples);
+
   /**
    * Helper function to insert a point into the list of candidate points.
    *
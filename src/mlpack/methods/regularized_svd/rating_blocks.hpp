@@ -0,0 +1,145 @@
+/**
+ * @file methods/regularized_svd/rating_blocks.hpp
+ *
+ * Partition of a rating coordinate list into blocks of users and items, used to
+ * schedule parallel SGD for matrix factorization without synchronization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_REGULARIZED_SVD_RATING_BLOCKS_HPP
+#define MLPACK_METHODS_REGULARIZED_SVD_RATING_BLOCKS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace svd {
+
+/**
+ * The ratings of a (user, item, rating) coordinate list, split into a grid of
+ * numBlocks x numBlocks blocks by contiguous ranges of users and of items.  An
+ * epoch of SGD visits the grid in numBlocks strata; the blocks of a stratum
+ * share no users and no items, so they are visited in parallel, and the
+ * updates of different threads never touch the same parameters (DSGD; Gemulla
+ * et al., 2011).  Each thread works on a contiguous range of user and item
+ * columns, which keeps its parameters in cache.
+ *
+ * @code
+ * @inproceedings{gemulla2011large,
+ *   title={Large-scale matrix factorization with distributed stochastic
+ *       gradient descent},
+ *   author={Gemulla, Rainer and Nijkamp, Erik and Haas, Peter J. and
+ *       Sismanis, Yannis},
+ *   booktitle={Proceedings of the 17th ACM SIGKDD International Conference on
+ *       Knowledge Discovery and Data Mining},
+ *   pages={69--77},
+ *   year={2011}
+ * }
+ * @endcode
+ */
+class RatingBlocks
+{
+ public:
+  /**
+   * Split the ratings into blocks.  If numBlocks is 0, one block of users and
+   * of items is used per OpenMP thread.
+   *
+   * @param data Ratings, as a (user, item, rating) coordinate list.
+   * @param numUsers Number of users.
+   * @param numItems Number of items.
+   * @param numBlocks Number of blocks of users and of items.
+   */
+  RatingBlocks(const arma::mat& data,
+               const size_t numUsers,
+               const size_t numItems,
+               const size_t numBlocks = 0) :
+      numBlocks(numBlocks)
+  {
+    if (this->numBlocks == 0)
+    {
+      this->numBlocks = 1;
+      #ifdef HAS_OPENMP
+      this->numBlocks = (size_t) omp_get_max_threads();
+      #endif
+    }
+    this->numBlocks = std::max((size_t) 1, std::min(this->numBlocks,
+        std::min(numUsers, numItems)));
+
+    // Count the ratings of each block, then fill the blocks in the order of the
+    // data.
+    arma::Col<size_t> blockOf(data.n_cols);
+    arma::Col<size_t> counts(this->numBlocks * this->numBlocks,
+        arma::fill::zeros);
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      const size_t userBlock = (size_t) data(0, i) * this->numBlocks / numUsers;
+      const size_t itemBlock = (size_t) data(1, i) * this->numBlocks / numItems;
+      blockOf[i] = userBlock * this->numBlocks + itemBlock;
+      ++counts[blockOf[i]];
+    }
+
+    blocks.resize(counts.n_elem);
+    for (size_t b = 0; b < blocks.size(); ++b)
+      blocks[b].set_size(counts[b]);
+
+    counts.zeros();
+    for (size_t i = 0; i < data.n_cols; ++i)
+      blocks[blockOf[i]][counts[blockOf[i]]++] = i;
+
+    strata = arma::linspace<arma::Col<size_t>>(0, this->numBlocks - 1,
+        this->numBlocks);
+  }
+
+  /**
+   * Shuffle the order of the strata, and the order of the ratings inside each
+   * block.  The ratings never leave their blocks, so the shuffle keeps the
+   * locality of the blocks.
+   */
+  void Shuffle()
+  {
+    std::shuffle(strata.begin(), strata.end(), math::randGen);
+    for (size_t b = 0; b < blocks.size(); ++b)
+      std::shuffle(blocks[b].begin(), blocks[b].end(), math::randGen);
+  }
+
+  /**
+   * Visit every rating once, calling visitor(i) with the column of the rating
+   * in the data.  Ratings in blocks with distinct users and items are visited
+   * in parallel.
+   *
+   * @param visitor Function to call on each rating.
+   */
+  template<typename VisitorType>
+  void Visit(const VisitorType& visitor) const
+  {
+    for (size_t s = 0; s < numBlocks; ++s)
+    {
+      #pragma omp parallel for schedule(static, 1)
+      for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+      {
+        const arma::Col<size_t>& block =
+            blocks[b * numBlocks + (b + strata[s]) % numBlocks];
+        for (size_t j = 0; j < block.n_elem; ++j)
+          visitor(block[j]);
+      }
+    }
+  }
+
+  //! Get the number of blocks of users and of items.
+  size_t NumBlocks() const { return numBlocks; }
+
+ private:
+  //! The number of blocks of users and of items.
+  size_t numBlocks;
+  //! The ratings of each (user block, item block) pair.
+  std::vector<arma::Col<size_t>> blocks;
+  //! The order in which the strata are visited.
+  arma::Col<size_t> strata;
+};
+
+} // namespace svd
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,221 @@
+/**
+ * @file methods/reinforcement_learning/apex.hpp
+ *
+ * This file is the definition of ApeX, an actor-learner architecture for
+ * distributed prioritized experience replay.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_APEX_HPP
+#define MLPACK_METHODS_RL_APEX_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "q_learning.hpp"
+#include "replay/prioritized_replay.hpp"
+#include "training_config.hpp"
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Implementation of the Ape-X actor-learner architecture for DQN.  Several
+ * actors, each with its own copy of the environment, of the network and of the
+ * behavior policy, generate experience; they compute the initial priority of
+ * their transitions themselves, and add them to a shared prioritized replay.
+ * A single learner (a QLearning agent) samples batches from the replay,
+ * updates the network and the priorities, and the parameters of the network
+ * are periodically copied to the actors.
+ *
+ * Training goes in rounds.  In each round, the actors and the learner run in
+ * parallel (on config.NumWorkers() + 1 threads): each actor takes
+ * config.UpdateInterval() steps with its own parameters, keeping its
+ * transitions in a local buffer, while the learner takes LearnerSteps()
+ * training steps on the experience of the previous rounds.  Since the actors
+ * do not touch the shared replay or the learning network while they act, no
+ * lock is needed; at the end of the round the buffers of the actors are added
+ * to the replay, and every BroadcastInterval() rounds the parameters of the
+ * learner are copied to the actors.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @inproceedings{horgan2018distributed,
+ *   title     = {Distributed Prioritized Experience Replay},
+ *   author    = {Horgan, Dan and Quan, John and Budden, David and
+ *                Barth-Maron, Gabriel and Hessel, Matteo and
+ *                van Hasselt, Hado and Silver, David},
+ *   booktitle = {International Conference on Learning Representations},
+ *   year      = {2018}
+ * }
+ * @endcode
+ *
+ * @tparam EnvironmentType The environment of the reinforcement learning task.
+ * @tparam NetworkType The network to compute action value.
+ * @tparam UpdaterType How to apply gradients when training.
+ * @tparam PolicyType Behavior policy of the agent.
+ */
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType
+>
+class ApeX
+{
+ public:
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  //! Convenient typedef for the replay method.
+  using ReplayType = PrioritizedReplay<EnvironmentType>;
+
+  //! Convenient typedef for the learner.
+  using LearnerType = QLearning<EnvironmentType, NetworkType, UpdaterType,
+      PolicyType, ReplayType>;
+
+  /**
+   * Create the actors and the learner.  config.NumWorkers() gives the number
+   * of actors, and config.UpdateInterval() the number of steps each actor
+   * takes in a round.
+   *
+   * @param config Hyper-parameters for training.
+   * @param network The network to train; each actor gets a copy of it.
+   * @param policy Behavior policy; each actor gets a copy of it.
+   * @param replayMethod The shared prioritized replay.  It must not combine
+   *     transitions into n-step transitions.
+   * @param updater How to apply gradients when training.
+   * @param environment Reinforcement learning task; each actor gets a copy
+   *     of it.
+   */
+  ApeX(TrainingConfig& config,
+       NetworkType& network,
+       PolicyType& policy,
+       ReplayType& replayMethod,
+       UpdaterType updater = UpdaterType(),
+       EnvironmentType environment = EnvironmentType());
+
+  /**
+   * Train until the given measure says to stop.
+   *
+   * @tparam Measure The type of the measurement. It should be a
+   *   callable object like
+   *   @code
+   *   bool foo(double reward);
+   *   @endcode
+   *   which is called with the return of each episode an actor finishes, in
+   *   order, and whose return value indicates whether the training process
+   *   is completed.
+   * @param measure The measurement instance.
+   */
+  template <typename Measure>
+  void Train(Measure& measure);
+
+  //! Get the number of training steps of the learner per round.
+  size_t LearnerSteps() const { return learnerSteps; }
+  //! Modify the number of training steps of the learner per round.
+  size_t& LearnerSteps() { return learnerSteps; }
+
+  //! Get the number of rounds between two copies of the parameters to the
+  //! actors.
+  size_t BroadcastInterval() const { return broadcastInterval; }
+  //! Modify the number of rounds between two copies of the parameters to the
+  //! actors.
+  size_t& BroadcastInterval() { return broadcastInterval; }
+
+  //! Get the total number of steps taken by the actors.
+  size_t TotalSteps() const { return totalSteps; }
+
+  //! Get the learner.
+  const LearnerType& Learner() const { return learner; }
+  //! Modify the learner.
+  LearnerType& Learner() { return learner; }
+
+ private:
+  //! The state of an actor.
+  struct Actor
+  {
+    //! Create an actor with copies of the given objects, and start an episode.
+    Actor(const NetworkType& network,
+          const PolicyType& policy,
+          const EnvironmentType& environment) :
+        network(network),
+        policy(policy),
+        environment(environment),
+        state(this->environment.InitialSample()),
+        episodeReturn(0.0),
+        episodeSteps(0),
+        totalSteps(0)
+    { /* Nothing to do here. */ }
+
+    //! The copy of the network the actor selects its actions with.
+    NetworkType network;
+    //! The behavior policy of the actor.
+    PolicyType policy;
+    //! The copy of the environment of the actor.
+    EnvironmentType environment;
+    //! The current state of the actor.
+    StateType state;
+    //! The return of the current episode.
+    double episodeReturn;
+    //! The number of steps of the current episode.
+    size_t episodeSteps;
+    //! The number of steps the actor took.
+    size_t totalSteps;
+
+    //! The transitions of the current round.
+    std::vector<StateType> states;
+    std::vector<ActionType> actions;
+    std::vector<double> rewards;
+    std::vector<StateType> nextStates;
+    std::vector<bool> isTerminal;
+    //! The initial priority of each transition of the current round.
+    arma::vec priorities;
+    //! The returns of the episodes finished in the current round.
+    std::vector<double> finishedReturns;
+  };
+
+  //! Take config.UpdateInterval() steps with the given actor, and compute the
+  //! priorities of its new transitions.
+  void Act(Actor& actor);
+
+  //! Take LearnerSteps() training steps with the learner.
+  void Learn();
+
+  //! Locally-stored hyper-parameters.
+  TrainingConfig& config;
+
+  //! Locally-stored reference of the network being trained.
+  NetworkType& network;
+
+  //! Locally-stored reference of the shared replay.
+  ReplayType& replayMethod;
+
+  //! Locally-stored learner.
+  LearnerType learner;
+
+  //! Locally-stored actors.
+  std::vector<Actor> actors;
+
+  //! Locally-stored number of training steps of the learner per round.
+  size_t learnerSteps;
+
+  //! Locally-stored number of rounds between two broadcasts.
+  size_t broadcastInterval;
+
+  //! Locally-stored total number of steps taken by the actors.
+  size_t totalSteps;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+// Include implementation
+#include "apex_impl.hpp"
+#endif
@@ -0,0 +1,238 @@
+/**
+ * @file methods/reinforcement_learning/apex_impl.hpp
+ *
+ * This file is the implementation of ApeX class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_APEX_IMPL_HPP
+#define MLPACK_METHODS_RL_APEX_IMPL_HPP
+
+#include "apex.hpp"
+
+namespace mlpack {
+namespace rl {
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType
+>
+ApeX<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType
+>::ApeX(TrainingConfig& config,
+        NetworkType& network,
+        PolicyType& policy,
+        ReplayType& replayMethod,
+        UpdaterType updater,
+        EnvironmentType environment) :
+    config(config),
+    network(network),
+    replayMethod(replayMethod),
+    learner(config, network, policy, replayMethod, std::move(updater),
+        environment),
+    learnerSteps(1),
+    broadcastInterval(1),
+    totalSteps(0)
+{
+  // The learner has initialized the parameters of the network, so that the
+  // actors start from them.
+  actors.reserve(config.NumWorkers());
+  for (size_t i = 0; i < config.NumWorkers(); ++i)
+    actors.emplace_back(network, policy, environment);
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType
+>
+template <typename Measure>
+void ApeX<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType
+>::Train(Measure& measure)
+{
+  if (config.IsCategorical())
+  {
+    throw std::invalid_argument("ApeX::Train(): categorical networks are not "
+        "supported");
+  }
+
+  if (replayMethod.NSteps() > 1)
+  {
+    throw std::invalid_argument("ApeX::Train(): the replay method must not "
+        "make n-step transitions");
+  }
+
+  if (actors.empty() || config.UpdateInterval() == 0 || broadcastInterval == 0)
+  {
+    throw std::invalid_argument("ApeX::Train(): the number of workers, the "
+        "update interval and the broadcast interval must be positive");
+  }
+
+  size_t rounds = 0;
+  while (true)
+  {
+    // The learner trains on the experience of the previous rounds while the
+    // actors gather new experience with their own parameters.
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (omp_size_t i = 0; i <= (omp_size_t) actors.size(); ++i)
+    {
+      if (i == 0)
+        Learn();
+      else
+        Act(actors[i - 1]);
+    }
+
+    // Add the experience of the actors to the shared replay, in order.
+    bool stop = false;
+    for (size_t a = 0; a < actors.size(); ++a)
+    {
+      Actor& actor = actors[a];
+      for (size_t t = 0; t < actor.states.size(); ++t)
+      {
+        replayMethod.Insert(actor.states[t], actor.actions[t],
+            actor.rewards[t], actor.nextStates[t], actor.isTerminal[t],
+            actor.priorities[t]);
+      }
+      totalSteps += actor.states.size();
+
+      for (size_t e = 0; e < actor.finishedReturns.size() && !stop; ++e)
+        stop = measure(actor.finishedReturns[e]);
+    }
+
+    if (stop)
+      break;
+
+    // Broadcast the parameters of the learner to the actors.
+    if (++rounds % broadcastInterval == 0)
+    {
+      for (size_t a = 0; a < actors.size(); ++a)
+        actors[a].network.Parameters() = network.Parameters();
+    }
+  }
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType
+>
+void ApeX<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType
+>::Act(Actor& actor)
+{
+  actor.states.clear();
+  actor.actions.clear();
+  actor.rewards.clear();
+  actor.nextStates.clear();
+  actor.isTerminal.clear();
+  actor.finishedReturns.clear();
+
+  for (size_t step = 0; step < config.UpdateInterval(); ++step)
+  {
+    arma::colvec actionValue;
+    actor.network.Predict(actor.state.Encode(), actionValue);
+    const ActionType action = actor.policy.Sample(actionValue, false,
+        config.NoisyQLearning());
+
+    StateType nextState;
+    const double reward = actor.environment.Sample(actor.state, action,
+        nextState);
+    const bool isEnd = actor.environment.IsTerminal(nextState);
+
+    actor.states.push_back(actor.state);
+    actor.actions.push_back(action);
+    actor.rewards.push_back(reward);
+    actor.nextStates.push_back(nextState);
+    actor.isTerminal.push_back(isEnd);
+
+    actor.episodeReturn += reward;
+    ++actor.episodeSteps;
+    if (++actor.totalSteps > config.ExplorationSteps())
+      actor.policy.Anneal();
+
+    if (isEnd || (config.StepLimit() != 0 &&
+        actor.episodeSteps >= config.StepLimit()))
+    {
+      actor.finishedReturns.push_back(actor.episodeReturn);
+      actor.episodeReturn = 0.0;
+      actor.episodeSteps = 0;
+      actor.state = actor.environment.InitialSample();
+    }
+    else
+    {
+      actor.state = nextState;
+    }
+  }
+
+  // Compute the initial priorities of all the new transitions with two
+  // forward passes: the absolute one-step TD errors under the parameters of
+  // the actor.
+  const size_t numTransitions = actor.states.size();
+  const size_t dimension = actor.states[0].Encode().n_elem;
+  arma::mat encodedStates(dimension, numTransitions);
+  arma::mat encodedNextStates(dimension, numTransitions);
+  for (size_t t = 0; t < numTransitions; ++t)
+  {
+    encodedStates.col(t) = actor.states[t].Encode();
+    encodedNextStates.col(t) = actor.nextStates[t].Encode();
+  }
+
+  arma::mat actionValues, nextActionValues;
+  actor.network.Predict(encodedStates, actionValues);
+  actor.network.Predict(encodedNextStates, nextActionValues);
+
+  actor.priorities.set_size(numTransitions);
+  for (size_t t = 0; t < numTransitions; ++t)
+  {
+    const double target = actor.rewards[t] + config.Discount() *
+        nextActionValues.col(t).max() * (1 - actor.isTerminal[t]);
+    actor.priorities[t] = std::abs(target -
+        actionValues(actor.actions[t].action, t));
+  }
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType
+>
+void ApeX<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType
+>::Learn()
+{
+  // Wait for enough experience.
+  if (totalSteps < config.ExplorationSteps() || replayMethod.Size() == 0)
+    return;
+
+  for (size_t step = 0; step < learnerSteps; ++step)
+  {
+    ++learner.TotalSteps();
+    learner.TrainAgent();
+  }
+}
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
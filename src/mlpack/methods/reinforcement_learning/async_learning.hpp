@@ -19,6 +19,7 @@
 #include "worker/one_step_sarsa_worker.hpp"
 #include "worker/n_step_q_learning_worker.hpp"
 #include "training_config.hpp"
+#include "training_metrics.hpp"
 
 namespace mlpack {
 namespace rl {
@@ -113,6 +114,16 @@ class AsyncLearning
   //! Modify the environment.
   const EnvironmentType& Environment() const { return environment; }
 
+  /**
+   * Get the training metrics.  The steps of all the workers are counted, and
+   * the episodes are the evaluation episodes of the deterministic worker, at
+   * the end of which the callback of the metrics is called.  The workers do
+   * not time their phases.
+   */
+  const TrainingMetrics& Metrics() const { return metrics; }
+  //! Modify the training metrics, e.g. to set their callback.
+  TrainingMetrics& Metrics() { return metrics; }
+
  private:
   //! Locally-stored hyper-parameters.
   TrainingConfig config;
@@ -128,6 +139,9 @@ class AsyncLearning
 
   //! Locally-stored task.
   EnvironmentType environment;
+
+  //! Locally-stored training metrics.
+  TrainingMetrics metrics;
 };
 
 /**
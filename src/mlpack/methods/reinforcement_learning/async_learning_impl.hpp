@@ -68,22 +68,19 @@ void AsyncLearning<
   NetworkType learningNetwork = std::move(this->learningNetwork);
   if (learningNetwork.Parameters().is_empty())
     learningNetwork.ResetParameters();
-  NetworkType targetNetwork = learningNetwork;
   size_t totalSteps = 0;
   PolicyType policy = this->policy;
   bool stop = false;
+  const size_t initialSteps = metrics.Steps();
 
-  // Set up worker pool, worker 0 will be deterministic for evaluation.
+  // Set up worker pool, worker 0 will be deterministic for evaluation.  Each
+  // worker keeps its own snapshot of the target network.
   std::vector<WorkerType> workers;
   for (size_t i = 0; i <= config.NumWorkers(); ++i)
   {
     workers.push_back(WorkerType(updater, environment, config, !i));
     workers.back().Initialize(learningNetwork);
   }
-  // Set up task queue corresponding to worker pool.
-  std::queue<size_t> tasks;
-  for (size_t i = 0; i <= config.NumWorkers(); ++i)
-    tasks.push(i);
 
   /**
    * Compute the number of threads for the for-loop. In general, we should use
@@ -95,8 +92,11 @@ void AsyncLearning<
   numThreads++;
   Log::Debug << numThreads << " threads will be used in total." << std::endl;
 
-  #pragma omp parallel for shared(stop, workers, tasks, learningNetwork, \
-      targetNetwork, totalSteps, policy)
+  // Thread i steps workers i, i + numThreads, ... in turn, so that no lock is
+  // needed to hand out the workers; thread 0 owns the deterministic worker and
+  // is the only one to call the measure.
+  #pragma omp parallel for shared(stop, workers, learningNetwork, totalSteps, \
+      policy)
   for (omp_size_t i = 0; i < numThreads; ++i)
   {
     #pragma omp critical
@@ -106,37 +106,40 @@ void AsyncLearning<
             " started." << std::endl;
       #endif
     }
-    size_t task = std::numeric_limits<size_t>::max();
-    while (!stop)
+
+    // This may happen when threads are more than workers.
+    if ((size_t) i >= workers.size())
+      continue;
+
+    bool done = false;
+    while (!done)
     {
-      // Assign task to current thread from queue.
-      #pragma omp critical
+      for (size_t task = i; task < workers.size(); task += numThreads)
       {
-        if (task != std::numeric_limits<size_t>::max())
-          tasks.push(task);
-
-        if (!tasks.empty())
+        double episodeReturn;
+        if (workers[task].Step(learningNetwork, totalSteps, policy,
+            episodeReturn) && !task)
         {
-          task = tasks.front();
-          tasks.pop();
-        }
-      };
+          // Only this thread touches the metrics.
+          size_t steps;
+          #pragma omp atomic read
+          steps = totalSteps;
+          metrics.Steps() = initialSteps + steps;
+          metrics.EndEpisode(episodeReturn);
 
-      // This may happen when threads are more than workers.
-      if (task == std::numeric_limits<size_t>::max())
-        continue;
-
-      // Get corresponding worker.
-      WorkerType& worker = workers[task];
-      double episodeReturn;
-      if (worker.Step(learningNetwork, targetNetwork, totalSteps,
-          policy, episodeReturn) && !task)
-      {
-        stop = measure(episodeReturn);
+          const bool finished = measure(episodeReturn);
+          #pragma omp atomic write
+          stop = finished;
+        }
       }
+
+      #pragma omp atomic read
+      done = stop;
     }
   }
 
+  metrics.Steps() = initialSteps + totalSteps;
+
   // Write back the learning network.
   this->learningNetwork = std::move(learningNetwork);
 };
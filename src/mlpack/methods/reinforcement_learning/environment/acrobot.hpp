@@ -38,7 +38,7 @@ class Acrobot
     /**
      * Construct a state instance.
      */
-    State(): data(dimension) { /* nothing to do here */ }
+    State(): data(arma::fill::zeros) { /* nothing to do here */ }
 
     /**
      * Construct a state instance from given data.
@@ -79,7 +79,7 @@ class Acrobot
 
    private:
     //! Locally-Stored (theta1, theta2, angular velocity 1, angular velocity2).
-    arma::colvec data;
+    arma::vec::fixed<dimension> data;
   };
 
   /*
@@ -165,10 +165,11 @@ class Acrobot
     stepsPerformed++;
 
     // Make a vector to estimate nextstate.
-    arma::colvec currentState = {state.Theta1(), state.Theta2(),
+    const arma::vec::fixed<4> currentState = {state.Theta1(), state.Theta2(),
         state.AngularVelocity1(), state.AngularVelocity2()};
 
-    arma::colvec currentNextState = Rk4(currentState, Torque(action));
+    const arma::vec::fixed<4> currentNextState = Rk4(currentState,
+        Torque(action));
 
     nextState.Theta1() = Wrap(currentNextState[0], -M_PI, M_PI);
 
@@ -213,7 +214,10 @@ class Acrobot
   State InitialSample()
   {
     stepsPerformed = 0;
-    return State((arma::randu<arma::colvec>(4) - 0.5) / 5.0);
+    State state;
+    state.Data().randu();
+    state.Data() = (state.Data() - 0.5) / 5.0;
+    return state;
   }
 
   /**
@@ -246,7 +250,8 @@ class Acrobot
    * @param state Current State.
    * @param torque The torque Applied.
    */
-  arma::colvec Dsdt(arma::colvec state, const double torque) const
+  arma::vec::fixed<4> Dsdt(const arma::vec::fixed<4>& state,
+                           const double torque) const
   {
     const double m1 = linkMass1;
     const double m2 = linkMass2;
@@ -260,7 +265,7 @@ class Acrobot
     const double theta1 = state[0];
     const double theta2 = state[1];
 
-    arma::colvec values(4);
+    arma::vec::fixed<4> values;
     values[0] = state[2];
     values[1] = state[3];
 
@@ -332,15 +337,16 @@ class Acrobot
    * @param state The current State.
    * @param torque The torque applied.
    */
-  arma::colvec Rk4(const arma::colvec state, const double torque) const
+  arma::vec::fixed<4> Rk4(const arma::vec::fixed<4>& state,
+                          const double torque) const
   {
-    arma::colvec k1 = Dsdt(state, torque);
-    arma::colvec k2 = Dsdt(state + dt * k1 / 2, torque);
-    arma::colvec k3 = Dsdt(state + dt * k2 / 2, torque);
-    arma::colvec k4 = Dsdt(state + dt * k3, torque);
-    arma::colvec nextState = state + dt * (k1 + 2 * k2 + 2 * k3 + k4) / 6;
+    typedef arma::vec::fixed<4> VecType;
+    const VecType k1 = Dsdt(state, torque);
+    const VecType k2 = Dsdt(VecType(state + dt * k1 / 2), torque);
+    const VecType k3 = Dsdt(VecType(state + dt * k2 / 2), torque);
+    const VecType k4 = Dsdt(VecType(state + dt * k3), torque);
 
-    return nextState;
+    return VecType(state + dt * (k1 + 2 * k2 + 2 * k3 + k4) / 6);
   };
 
   //! Get the number of steps performed.
@@ -36,7 +36,7 @@ class CartPole
     /**
      * Construct a state instance.
      */
-    State() : data(dimension)
+    State() : data(arma::fill::zeros)
     { /* Nothing to do here. */ }
 
     /**
@@ -78,7 +78,7 @@ class CartPole
 
    private:
     //! Locally-stored (position, velocity, angle, angular velocity).
-    arma::colvec data;
+    arma::vec::fixed<dimension> data;
   };
 
   /**
@@ -207,7 +207,10 @@ class CartPole
   State InitialSample()
   {
     stepsPerformed = 0;
-    return State((arma::randu<arma::colvec>(4) - 0.5) / 10.0);
+    State state;
+    state.Data().randu();
+    state.Data() = (state.Data() - 0.5) / 10.0;
+    return state;
   }
 
   /**
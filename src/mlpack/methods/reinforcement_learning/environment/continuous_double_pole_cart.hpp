@@ -39,7 +39,7 @@ class ContinuousDoublePoleCart
     /**
      * Construct a state instance.
      */
-    State() : data(dimension)
+    State() : data(arma::fill::zeros)
     { /* Nothing to do here. */ }
 
     /**
@@ -51,7 +51,7 @@ class ContinuousDoublePoleCart
     { /* Nothing to do here */ }
 
     //! Get the internal representation of the state
-    arma::colvec Data() const { return data; }
+    const arma::colvec& Data() const { return data; }
     //! Modify the internal representation of the state.
     arma::colvec& Data() { return data; }
 
@@ -83,7 +83,7 @@ class ContinuousDoublePoleCart
 
    private:
     //! Locally-stored state data.
-    arma::colvec data;
+    arma::vec::fixed<dimension> data;
   };
 
   /**
@@ -157,7 +157,7 @@ class ContinuousDoublePoleCart
     // Update the number of steps performed.
     stepsPerformed++;
 
-    arma::vec dydx(6, arma::fill::zeros);
+    arma::vec::fixed<6> dydx(arma::fill::zeros);
     dydx[0] = state.Velocity();
     dydx[2] = state.AngularVelocity(1);
     dydx[4] = state.AngularVelocity(2);
@@ -236,9 +236,9 @@ class ContinuousDoublePoleCart
   {
     const double hh = tau * 0.5;
     const double h6 = tau / 6;
-    arma::vec yt(6);
-    arma::vec dyt(6);
-    arma::vec dym(6);
+    arma::vec::fixed<6> yt;
+    arma::vec::fixed<6> dyt;
+    arma::vec::fixed<6> dym;
 
     yt = state.Data() + (hh * dydx);
     Dsdt(State(yt), action, dyt);
@@ -283,7 +283,10 @@ class ContinuousDoublePoleCart
   State InitialSample()
   {
     stepsPerformed = 0;
-    return State((arma::randu<arma::vec>(6) - 0.5) / 10.0);
+    State state;
+    state.Data().randu();
+    state.Data() = (state.Data() - 0.5) / 10.0;
+    return state;
   }
 
   /**
@@ -39,7 +39,7 @@ class ContinuousMountainCar
     /**
      * Construct a state instance.
      */
-    State() : data(dimension, arma::fill::zeros)
+    State() : data(arma::fill::zeros)
     { /* Nothing to do here. */ }
 
     /**
@@ -71,7 +71,7 @@ class ContinuousMountainCar
 
    private:
     //! Locally-stored velocity and position vector.
-    arma::colvec data;
+    arma::vec::fixed<dimension> data;
   };
 
   /**
@@ -38,7 +38,7 @@ class DoublePoleCart
     /**
      * Construct a state instance.
      */
-    State() : data(dimension)
+    State() : data(arma::fill::zeros)
     { /* Nothing to do here. */ }
 
     /**
@@ -50,7 +50,7 @@ class DoublePoleCart
     { /* Nothing to do here */ }
 
     //! Get the internal representation of the state
-    arma::colvec Data() const { return data; }
+    const arma::colvec& Data() const { return data; }
     //! Modify the internal representation of the state.
     arma::colvec& Data() { return data; }
 
@@ -82,7 +82,7 @@ class DoublePoleCart
 
    private:
     //! Locally-stored state data.
-    arma::colvec data;
+    arma::vec::fixed<dimension> data;
   };
 
   /**
@@ -163,7 +163,7 @@ class DoublePoleCart
     // Update the number of steps performed.
     stepsPerformed++;
 
-    arma::vec dydx(6, arma::fill::zeros);
+    arma::vec::fixed<6> dydx(arma::fill::zeros);
     dydx[0] = state.Velocity();
     dydx[2] = state.AngularVelocity(1);
     dydx[4] = state.AngularVelocity(2);
@@ -242,9 +242,9 @@ class DoublePoleCart
   {
     const double hh = tau * 0.5;
     const double h6 = tau / 6;
-    arma::vec yt(6);
-    arma::vec dyt(6);
-    arma::vec dym(6);
+    arma::vec::fixed<6> yt;
+    arma::vec::fixed<6> dyt;
+    arma::vec::fixed<6> dym;
 
     yt = state.Data() + (hh * dydx);
     Dsdt(State(yt), action, dyt);
@@ -289,7 +289,10 @@ class DoublePoleCart
   State InitialSample()
   {
     stepsPerformed = 0;
-    return State((arma::randu<arma::vec>(6) - 0.5) / 10.0);
+    State state;
+    state.Data().randu();
+    state.Data() = (state.Data() - 0.5) / 10.0;
+    return state;
   }
 
   /**
@@ -38,7 +38,7 @@ class MountainCar
     /**
      * Construct a state instance.
      */
-    State(): data(dimension, arma::fill::zeros)
+    State(): data(arma::fill::zeros)
     { /* Nothing to do here. */ }
 
     /**
@@ -70,7 +70,7 @@ class MountainCar
 
    private:
     //! Locally-stored velocity and position vector.
-    arma::colvec data;
+    arma::vec::fixed<dimension> data;
   };
 
   /**
@@ -41,7 +41,7 @@ class Pendulum
     /**
      * Construct a state instance.
      */
-    State() : theta(0), data(dimension, arma::fill::zeros)
+    State() : theta(0), data(arma::fill::zeros)
     { /* Nothing to do here. */ }
 
     /**
@@ -84,7 +84,7 @@ class Pendulum
     double theta;
 
     //! Locally-stored (sin(theta), cos(theta), angular velocity) vector.
-    arma::colvec data;
+    arma::vec::fixed<dimension> data;
   };
 
   /**
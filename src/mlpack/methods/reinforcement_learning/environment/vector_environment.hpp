@@ -0,0 +1,189 @@
+/**
+ * @file methods/reinforcement_learning/environment/vector_environment.hpp
+ *
+ * This file defines VectorEnvironment, which runs several copies of an
+ * environment in lockstep.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_ENVIRONMENT_VECTOR_ENVIRONMENT_HPP
+#define MLPACK_METHODS_RL_ENVIRONMENT_VECTOR_ENVIRONMENT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * VectorEnvironment holds several copies of an environment (CartPole,
+ * MountainCar, Pendulum, Acrobot, ...), each with its own current state, and
+ * steps all of them at once.  The encoded current states are kept together in
+ * one matrix, one column per environment, so that an agent can select the
+ * actions of all the environments with a single forward pass of its network
+ * (see QLearning::Steps() and SAC::Steps()).
+ *
+ * An environment whose episode ends is restarted right away from a new initial
+ * state, and the return of the finished episode is recorded.
+ *
+ * @code
+ * VectorEnvironment<CartPole> environments(16);
+ * QLearning<CartPole, decltype(network), AdamUpdate, decltype(policy)>
+ *     agent(config, network, policy, replayMethod);
+ * agent.Steps(environments, 1000);
+ * std::vector<double>& returns = environments.FinishedReturns();
+ * @endcode
+ *
+ * @tparam EnvironmentType The environment to run copies of.
+ */
+template<typename EnvironmentType>
+class VectorEnvironment
+{
+ public:
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  /**
+   * Create the given number of copies of the given environment, and start an
+   * episode in each of them.
+   *
+   * @param numEnvironments Number of copies of the environment.
+   * @param environment Environment to copy.
+   */
+  VectorEnvironment(const size_t numEnvironments,
+                    const EnvironmentType& environment = EnvironmentType()) :
+      environments(numEnvironments, environment)
+  {
+    if (numEnvironments == 0)
+    {
+      throw std::invalid_argument("VectorEnvironment: the number of "
+          "environments must be positive");
+    }
+
+    Reset();
+  }
+
+  /**
+   * Start a new episode in every environment, and forget the returns of the
+   * episodes that finished.
+   */
+  void Reset()
+  {
+    states.resize(environments.size());
+    for (size_t i = 0; i < environments.size(); ++i)
+      states[i] = environments[i].InitialSample();
+
+    encodedStates.set_size(states[0].Encode().n_elem, environments.size());
+    for (size_t i = 0; i < environments.size(); ++i)
+      encodedStates.col(i) = states[i].Encode();
+
+    returns.zeros(environments.size());
+    episodeSteps.assign(environments.size(), 0);
+    finishedReturns.clear();
+  }
+
+  /**
+   * Take the given action in each environment.  The environments whose
+   * episode ended (or reached stepLimit steps) are then restarted.
+   *
+   * @param actions Action to take in each environment.
+   * @param previousStates Will hold the state each action was taken in.
+   * @param rewards Will hold the reward of each action.
+   * @param nextStates Will hold the state each action led to.
+   * @param terminal Will hold whether each of nextStates is terminal.
+   * @param stepLimit Maximum number of steps of an episode (0 means no
+   *     limit, other than that of the environment).
+   */
+  void Step(const std::vector<ActionType>& actions,
+            std::vector<StateType>& previousStates,
+            arma::rowvec& rewards,
+            std::vector<StateType>& nextStates,
+            std::vector<bool>& terminal,
+            const size_t stepLimit = 0)
+  {
+    if (actions.size() != environments.size())
+    {
+      std::ostringstream oss;
+      oss << "VectorEnvironment::Step(): " << actions.size() << " actions "
+          << "given for " << environments.size() << " environments";
+      throw std::invalid_argument(oss.str());
+    }
+
+    rewards.set_size(environments.size());
+    nextStates.resize(environments.size());
+    terminal.resize(environments.size());
+    for (size_t i = 0; i < environments.size(); ++i)
+    {
+      rewards[i] = environments[i].Sample(states[i], actions[i],
+          nextStates[i]);
+      terminal[i] = environments[i].IsTerminal(nextStates[i]);
+    }
+
+    previousStates.swap(states);
+    states = nextStates;
+    for (size_t i = 0; i < environments.size(); ++i)
+    {
+      returns[i] += rewards[i];
+      ++episodeSteps[i];
+      if (terminal[i] || (stepLimit != 0 && episodeSteps[i] >= stepLimit))
+      {
+        finishedReturns.push_back(returns[i]);
+        returns[i] = 0.0;
+        episodeSteps[i] = 0;
+        states[i] = environments[i].InitialSample();
+      }
+
+      encodedStates.col(i) = states[i].Encode();
+    }
+  }
+
+  //! Get the number of environments.
+  size_t NumEnvironments() const { return environments.size(); }
+
+  //! Get the given environment.
+  const EnvironmentType& Environment(const size_t i) const
+  { return environments[i]; }
+  //! Modify the given environment.
+  EnvironmentType& Environment(const size_t i) { return environments[i]; }
+
+  //! Get the current state of each environment.
+  const std::vector<StateType>& States() const { return states; }
+
+  //! Get the encoded current states, one column per environment.
+  const arma::mat& EncodedStates() const { return encodedStates; }
+
+  //! Get the returns of the episodes that finished, in order.
+  const std::vector<double>& FinishedReturns() const
+  { return finishedReturns; }
+  //! Modify the returns of the episodes that finished (to clear them).
+  std::vector<double>& FinishedReturns() { return finishedReturns; }
+
+ private:
+  //! The copies of the environment.
+  std::vector<EnvironmentType> environments;
+
+  //! The current state of each environment.
+  std::vector<StateType> states;
+
+  //! The encoded current states, one column per environment.
+  arma::mat encodedStates;
+
+  //! The return of the current episode of each environment.
+  arma::rowvec returns;
+
+  //! The number of steps of the current episode of each environment.
+  std::vector<size_t> episodeSteps;
+
+  //! The returns of the episodes that finished.
+  std::vector<double> finishedReturns;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -39,7 +39,8 @@ class AggregatedPolicy
   AggregatedPolicy(std::vector<PolicyType> policies,
                    const arma::colvec& distribution) :
       policies(std::move(policies)),
-      sampler({distribution})
+      sampler({distribution}),
+      cumulativeDistribution(arma::cumsum(distribution))
   { /* Nothing to do here. */ };
 
   /**
@@ -57,6 +58,50 @@ class AggregatedPolicy
     return policies[selected].Sample(actionValue, false);
   }
 
+  /**
+   * Sample an action for each column of the given action values.  The child
+   * policy of every column is drawn at once, and each child policy then
+   * samples the actions of all its columns together.
+   *
+   * @param actionValues Values for each action, one column per state.
+   * @param actions Will hold the sampled action of each column.
+   * @param deterministic Always select the actions greedily.
+   */
+  void Sample(const arma::mat& actionValues,
+              std::vector<ActionType>& actions,
+              const bool deterministic = false)
+  {
+    if (deterministic)
+    {
+      policies.front().Sample(actionValues, actions, true);
+      return;
+    }
+
+    // Select the child policy of each column by inverting the cumulative
+    // distribution; the last policy takes any rounding error.
+    draws.randu(actionValues.n_cols);
+    selected.set_size(actionValues.n_cols);
+    for (size_t i = 0; i < actionValues.n_cols; ++i)
+    {
+      size_t p = 0;
+      while (p + 1 < policies.size() && draws[i] >= cumulativeDistribution[p])
+        ++p;
+      selected[i] = p;
+    }
+
+    actions.resize(actionValues.n_cols);
+    for (size_t p = 0; p < policies.size(); ++p)
+    {
+      const arma::uvec columns = arma::find(selected == p);
+      if (columns.is_empty())
+        continue;
+
+      policies[p].Sample(actionValues.cols(columns), policyActions, false);
+      for (size_t i = 0; i < columns.n_elem; ++i)
+        actions[columns[i]] = policyActions[i];
+    }
+  }
+
   /**
    * Exploration probability will anneal at each step.
    */
@@ -72,6 +117,14 @@ class AggregatedPolicy
 
   //! Locally-stored sampler under the given distribution.
   distribution::DiscreteDistribution sampler;
+
+  //! Locally-stored cumulative distribution of the child policies.
+  arma::colvec cumulativeDistribution;
+
+  //! Buffers of the random numbers, child policies, and actions of a batch.
+  arma::rowvec draws;
+  arma::urowvec selected;
+  std::vector<ActionType> policyActions;
 };
 
 } // namespace rl
@@ -79,11 +79,49 @@ class GreedyPolicy
     else
     {
       action.action = static_cast<decltype(action.action)>(
-          arma::as_scalar(arma::find(actionValue == actionValue.max(), 1)));
+          actionValue.index_max());
     }
     return action;
   }
 
+  /**
+   * Sample an action for each column of the given action values.  The random
+   * numbers that decide whether to explore are drawn all at once, and the
+   * greedy actions are found with one pass over the matrix.
+   *
+   * @param actionValues Values for each action, one column per state.
+   * @param actions Will hold the sampled action of each column.
+   * @param deterministic Always select the actions greedily.
+   * @param isNoisy Specifies whether the network used is noisy.
+   */
+  void Sample(const arma::mat& actionValues,
+              std::vector<ActionType>& actions,
+              const bool deterministic = false,
+              const bool isNoisy = false)
+  {
+    greedyActions = arma::index_max(actionValues, 0);
+    actions.resize(actionValues.n_cols);
+    for (size_t i = 0; i < actionValues.n_cols; ++i)
+    {
+      actions[i].action = static_cast<decltype(actions[i].action)>(
+          greedyActions[i]);
+    }
+
+    if (deterministic || isNoisy)
+      return;
+
+    // Replace the greedy action of the explored columns with a random one.
+    explorations.randu(actionValues.n_cols);
+    for (size_t i = 0; i < actionValues.n_cols; ++i)
+    {
+      if (explorations[i] < epsilon)
+      {
+        actions[i].action = static_cast<decltype(actions[i].action)>(
+            math::RandInt(ActionType::size));
+      }
+    }
+  }
+
   /**
    * Exploration probability will anneal at each step.
    */
@@ -107,6 +145,13 @@ class GreedyPolicy
 
   //! Locally-stored stride for epsilon to anneal.
   double delta;
+
+  //! Buffer of the greedy actions of a batch.
+  arma::urowvec greedyActions;
+
+  //! Buffer of the random numbers that decide which columns of a batch are
+  //! explored.
+  arma::rowvec explorations;
 };
 
 } // namespace rl
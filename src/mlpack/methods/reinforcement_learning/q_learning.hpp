@@ -18,7 +18,9 @@
 
 #include "replay/random_replay.hpp"
 #include "replay/prioritized_replay.hpp"
+#include "environment/vector_environment.hpp"
 #include "training_config.hpp"
+#include "training_metrics.hpp"
 
 namespace mlpack {
 namespace rl {
@@ -111,6 +113,32 @@ class QLearning
    */
   double Episode();
 
+  /**
+   * Select an action for each of the given states, with a single forward pass
+   * of the network.  The policy must be able to sample a batch of actions (see
+   * GreedyPolicy::Sample()).
+   *
+   * @param states Encoded states, one per column.
+   * @param actions Will hold the action selected for each state.
+   */
+  void SelectActions(const arma::mat& states, std::vector<ActionType>& actions);
+
+  /**
+   * Step all the environments of the given VectorEnvironment the given number
+   * of times, selecting the actions of all of them with one forward pass of
+   * the network.  The transitions are stored and the agent is trained after
+   * each of them, as if the environments were stepped one after the other;
+   * the returns of the episodes that finish can be found with
+   * environments.FinishedReturns().  Since the transitions of the
+   * environments are interleaved, n-step replay (NSteps() > 1) is only
+   * supported with a single environment.
+   *
+   * @param environments Copies of the environment to step.
+   * @param numSteps Number of steps of each environment.
+   */
+  void Steps(VectorEnvironment<EnvironmentType>& environments,
+             const size_t numSteps);
+
   //! Modify total steps from beginning.
   size_t& TotalSteps() { return totalSteps; }
   //! Get total steps from beginning.
@@ -139,6 +167,11 @@ class QLearning
   //! Modify the learning network.
   NetworkType& Network() { return learningNetwork; }
 
+  //! Get the training metrics (steps, updates, and time of each phase).
+  const TrainingMetrics& Metrics() const { return metrics; }
+  //! Modify the training metrics, e.g. to set their callback.
+  TrainingMetrics& Metrics() { return metrics; }
+
  private:
   /**
    * Select the best action based on given action value.
@@ -182,6 +215,19 @@ class QLearning
 
   //! Locally-stored flag indicating training mode or test mode.
   bool deterministic;
+
+  //! Locally-stored training metrics.
+  TrainingMetrics metrics;
+
+  //! Buffers for the sampled transitions, reused by each training step.
+  arma::mat sampledStates;
+  std::vector<ActionType> sampledActions;
+  arma::rowvec sampledRewards;
+  arma::mat sampledNextStates;
+  arma::irowvec isTerminal;
+
+  //! Buffer for the action values of the states given to SelectActions().
+  arma::mat batchActionValues;
 };
 
 } // namespace rl
@@ -134,36 +134,37 @@ void QLearning<
 {
   // Start experience replay.
 
-  // Sample from previous experience.
-  arma::mat sampledStates;
-  std::vector<ActionType> sampledActions;
-  arma::rowvec sampledRewards;
-  arma::mat sampledNextStates;
-  arma::irowvec isTerminal;
-
-  replayMethod.Sample(sampledStates, sampledActions, sampledRewards,
-      sampledNextStates, isTerminal);
-
-  // Compute action value for next state with target network.
-  arma::mat nextActionValues;
-  targetNetwork.Predict(sampledNextStates, nextActionValues);
-
-  arma::Col<size_t> bestActions;
-  if (config.DoubleQLearning())
+  // Sample from previous experience, into the buffers of the last step.
   {
-    // If use double Q-Learning, use learning network to select the best action.
-    arma::mat nextActionValues;
-    learningNetwork.Predict(sampledNextStates, nextActionValues);
-    bestActions = BestAction(nextActionValues);
+    TrainingMetrics::Scope scope(metrics, TrainingMetrics::Phase::replaySample);
+    replayMethod.Sample(sampledStates, sampledActions, sampledRewards,
+        sampledNextStates, isTerminal);
   }
-  else
+
+  arma::mat nextActionValues, target;
+  arma::Col<size_t> bestActions;
   {
-    bestActions = BestAction(nextActionValues);
-  }
+    TrainingMetrics::Scope scope(metrics, TrainingMetrics::Phase::forward);
+
+    // Compute action value for next state with target network.
+    targetNetwork.Predict(sampledNextStates, nextActionValues);
+
+    if (config.DoubleQLearning())
+    {
+      // If use double Q-Learning, use learning network to select the best
+      // action.
+      arma::mat nextActionValues;
+      learningNetwork.Predict(sampledNextStates, nextActionValues);
+      bestActions = BestAction(nextActionValues);
+    }
+    else
+    {
+      bestActions = BestAction(nextActionValues);
+    }
 
-  // Compute the update target.
-  arma::mat target;
-  learningNetwork.Forward(sampledStates, target);
+    // Compute the update target.
+    learningNetwork.Forward(sampledStates, target);
+  }
 
   double discount = std::pow(config.Discount(), replayMethod.NSteps());
 
@@ -180,8 +181,12 @@ void QLearning<
 
   // Learn from experience.
   arma::mat gradients;
-  learningNetwork.Backward(sampledStates, target, gradients);
+  {
+    TrainingMetrics::Scope scope(metrics, TrainingMetrics::Phase::backward);
+    learningNetwork.Backward(sampledStates, target, gradients);
+  }
 
+  TrainingMetrics::Scope scope(metrics, TrainingMetrics::Phase::update);
   replayMethod.Update(target, sampledActions, nextActionValues, gradients);
 
   #if ENS_VERSION_MAJOR == 1
@@ -190,6 +195,7 @@ void QLearning<
   updatePolicy->Update(learningNetwork.Parameters(), config.StepSize(),
       gradients);
   #endif
+  metrics.AddUpdate();
 
   if (config.NoisyQLearning() == true)
   {
@@ -221,15 +227,12 @@ void QLearning<
 {
   // Start experience replay.
 
-  // Sample from previous experience.
-  arma::mat sampledStates;
-  std::vector<ActionType> sampledActions;
-  arma::rowvec sampledRewards;
-  arma::mat sampledNextStates;
-  arma::irowvec isTerminal;
-
-  replayMethod.Sample(sampledStates, sampledActions, sampledRewards,
-      sampledNextStates, isTerminal);
+  // Sample from previous experience, into the buffers of the last step.
+  {
+    TrainingMetrics::Scope scope(metrics, TrainingMetrics::Phase::replaySample);
+    replayMethod.Sample(sampledStates, sampledActions, sampledRewards,
+        sampledNextStates, isTerminal);
+  }
 
   size_t atomSize = config.AtomSize();
   arma::colvec support = arma::linspace<arma::colvec>(config.VMin(),
@@ -237,63 +240,87 @@ void QLearning<
 
   size_t batchSize = sampledNextStates.n_cols;
 
-  // Compute action value for next state with target network.
-  arma::mat nextActionValues;
-  targetNetwork.Predict(sampledNextStates, nextActionValues);
-
+  arma::mat nextActionValues, nextDists, dists;
   arma::Col<size_t> nextAction;
-  if (config.DoubleQLearning())
   {
-    // If use double Q-Learning, use learning network to select the best action.
-    arma::mat nextActionValues;
-    learningNetwork.Predict(sampledNextStates, nextActionValues);
-    nextAction = BestAction(nextActionValues);
-  }
-  else
-  {
-    nextAction = BestAction(nextActionValues);
-  }
+    TrainingMetrics::Scope scope(metrics, TrainingMetrics::Phase::forward);
 
-  arma::mat nextDists, nextDist(atomSize, batchSize);
-  targetNetwork.Forward(sampledNextStates, nextDists);
-  for (size_t i = 0; i < batchSize; ++i)
-  {
-    nextDist.col(i) = nextDists(nextAction(i) * atomSize, i,
-        arma::size(atomSize, 1));
-  }
+    // Compute action value for next state with target network.
+    targetNetwork.Predict(sampledNextStates, nextActionValues);
 
-  arma::mat tZ = (arma::conv_to<arma::mat>::from(config.Discount() *
-      (support * (1 - isTerminal))).each_row() + sampledRewards);
-  tZ = arma::clamp(tZ, config.VMin(), config.VMax());
-  arma::mat b = (tZ - config.VMin()) / (config.VMax() - config.VMin()) *
-      (atomSize - 1);
-  arma::mat l = arma::floor(b);
-  arma::mat u = arma::ceil(b);
+    if (config.DoubleQLearning())
+    {
+      // If use double Q-Learning, use learning network to select the best
+      // action.
+      arma::mat nextActionValues;
+      learningNetwork.Predict(sampledNextStates, nextActionValues);
+      nextAction = BestAction(nextActionValues);
+    }
+    else
+    {
+      nextAction = BestAction(nextActionValues);
+    }
 
-  arma::mat projDistUpper = nextDist % (u - b);
-  arma::mat projDistLower = nextDist % (b - l);
+    targetNetwork.Forward(sampledNextStates, nextDists);
+    learningNetwork.Forward(sampledStates, dists);
+  }
 
-  arma::mat projDist = arma::zeros<arma::mat>(arma::size(nextDist));
-  for (size_t batchNo = 0; batchNo < batchSize; batchNo++)
+  // The projection is timed with the backward pass, since it computes the
+  // gradient of the loss.
+  arma::mat gradients;
   {
-    for (size_t j = 0; j < atomSize; j++)
+    TrainingMetrics::Scope scope(metrics, TrainingMetrics::Phase::backward);
+
+    // Project the target distribution of each transition onto the support,
+    // and turn it directly into the gradient of the cross-entropy loss, in the
+    // rows of the sampled action; the rows of the other actions have no
+    // gradient.
+    const double vMin = config.VMin();
+    const double vMax = config.VMax();
+    const double deltaZ = (vMax - vMin) / (atomSize - 1);
+    arma::mat lossGradients(arma::size(dists), arma::fill::zeros);
+
+    // Small batches are not worth the threads.
+    #pragma omp parallel for schedule(static) \
+        if (batchSize * atomSize >= 16384)
+    for (omp_size_t i = 0; i < (omp_size_t) batchSize; ++i)
     {
-      projDist(l(j, batchNo), batchNo) += projDistUpper(j, batchNo);
-      projDist(u(j, batchNo), batchNo) += projDistLower(j, batchNo);
+      const double* nextDist = nextDists.colptr(i) + nextAction(i) * atomSize;
+      const double* dist = dists.colptr(i) +
+          sampledActions[i].action * atomSize;
+      double* projDist = lossGradients.colptr(i) +
+          sampledActions[i].action * atomSize;
+      const double discount = config.Discount() * (1 - isTerminal[i]);
+
+      for (size_t j = 0; j < atomSize; ++j)
+      {
+        const double tZ = std::min(std::max(sampledRewards[i] + discount *
+            support[j], vMin), vMax);
+        const double b = (tZ - vMin) / deltaZ;
+        const size_t l = std::min((size_t) std::floor(b), atomSize - 1);
+        const size_t u = std::min((size_t) std::ceil(b), atomSize - 1);
+
+        // If tZ is on an atom, all its probability goes to that atom.
+        if (l == u)
+        {
+          projDist[l] += nextDist[j];
+        }
+        else
+        {
+          projDist[l] += nextDist[j] * (u - b);
+          projDist[u] += nextDist[j] * (b - l);
+        }
+      }
+
+      for (size_t j = 0; j < atomSize; ++j)
+        projDist[j] = -projDist[j] / (1e-10 + dist[j]);
     }
+
+    // Learn from experience.
+    learningNetwork.Backward(sampledStates, lossGradients, gradients);
   }
-  arma::mat dists;
-  learningNetwork.Forward(sampledStates, dists);
-  arma::mat lossGradients = arma::zeros<arma::mat>(arma::size(dists));
-  for (size_t i = 0; i < batchSize; ++i)
-  {
-    lossGradients(sampledActions[i].action * atomSize, i,
-        arma::size(atomSize, 1)) = -(projDist.col(i) / (1e-10 + dists(
-        sampledActions[i].action * atomSize, i, arma::size(atomSize, 1))));
-  }
-  // Learn from experience.
-  arma::mat gradients;
-  learningNetwork.Backward(sampledStates, lossGradients, gradients);
+
+  TrainingMetrics::Scope scope(metrics, TrainingMetrics::Phase::update);
 
   #if ENS_VERSION_MAJOR == 1
   updater.Update(learningNetwork.Parameters(), config.StepSize(), gradients);
@@ -301,6 +328,7 @@ void QLearning<
   updatePolicy->Update(learningNetwork.Parameters(), config.StepSize(),
       gradients);
   #endif
+  metrics.AddUpdate();
 
   if (config.NoisyQLearning() == true)
   {
@@ -332,7 +360,10 @@ void QLearning<
 {
   // Get the action value for each action at current state.
   arma::colvec actionValue;
-  learningNetwork.Predict(state.Encode(), actionValue);
+  {
+    TrainingMetrics::Scope scope(metrics, TrainingMetrics::Phase::forward);
+    learningNetwork.Predict(state.Encode(), actionValue);
+  }
 
   // Select an action according to the behavior policy.
   action = policy.Sample(actionValue, deterministic, config.NoisyQLearning());
@@ -366,14 +397,21 @@ double QLearning<
 
     // Interact with the environment to advance to next state.
     StateType nextState;
-    double reward = environment.Sample(state, action, nextState);
+    double reward;
+    {
+      TrainingMetrics::Scope scope(metrics,
+          TrainingMetrics::Phase::environment);
+      reward = environment.Sample(state, action, nextState);
+    }
 
     totalReturn += reward;
     totalSteps++;
+    metrics.AddSteps();
 
     // Store the transition for replay.
     replayMethod.Store(state, action, reward, nextState,
         environment.IsTerminal(nextState), config.Discount());
+    metrics.ReplayOccupancy() = replayMethod.Size();
     // Update current state.
     state = nextState;
 
@@ -384,9 +422,105 @@ double QLearning<
     else
       TrainAgent();
   }
+
+  metrics.EndEpisode(totalReturn);
   return totalReturn;
 }
 
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+void QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::SelectActions(const arma::mat& states, std::vector<ActionType>& actions)
+{
+  // Get the action values of all the states at once, into the buffer of the
+  // last call, and sample all the actions together.
+  {
+    TrainingMetrics::Scope scope(metrics, TrainingMetrics::Phase::forward);
+    learningNetwork.Predict(states, batchActionValues);
+  }
+
+  policy.Sample(batchActionValues, actions, deterministic,
+      config.NoisyQLearning());
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+void QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::Steps(VectorEnvironment<EnvironmentType>& environments,
+         const size_t numSteps)
+{
+  if (replayMethod.NSteps() > 1 && environments.NumEnvironments() > 1)
+  {
+    throw std::invalid_argument("QLearning::Steps(): n-step replay needs the "
+        "transitions of one environment at a time");
+  }
+
+  std::vector<ActionType> actions;
+  std::vector<StateType> previousStates, nextStates;
+  arma::rowvec rewards;
+  std::vector<bool> terminal;
+  for (size_t step = 0; step < numSteps; ++step)
+  {
+    SelectActions(environments.EncodedStates(), actions);
+    const size_t numFinished = environments.FinishedReturns().size();
+    {
+      TrainingMetrics::Scope scope(metrics,
+          TrainingMetrics::Phase::environment);
+      environments.Step(actions, previousStates, rewards, nextStates,
+          terminal);
+    }
+
+    for (size_t e = numFinished; e < environments.FinishedReturns().size();
+        ++e)
+    {
+      metrics.EndEpisode(environments.FinishedReturns()[e]);
+    }
+
+    for (size_t i = 0; i < environments.NumEnvironments(); ++i)
+    {
+      totalSteps++;
+      metrics.AddSteps();
+
+      // Store the transition for replay.
+      replayMethod.Store(previousStates[i], actions[i], rewards[i],
+          nextStates[i], terminal[i], config.Discount());
+      metrics.ReplayOccupancy() = replayMethod.Size();
+
+      if (deterministic || totalSteps < config.ExplorationSteps())
+        continue;
+      if (config.IsCategorical())
+        TrainCategoricalAgent();
+      else
+        TrainAgent();
+    }
+  }
+
+  // Remember the last state and action, like Episode() does.
+  state = environments.States().back();
+  if (!actions.empty())
+    action = actions.back();
+}
+
 } // namespace rl
 } // namespace mlpack
 
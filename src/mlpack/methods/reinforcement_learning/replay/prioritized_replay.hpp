@@ -33,9 +33,15 @@ namespace rl {
  *  }
  * @endcode
  *
+ * As in RandomReplay, the transitions are kept in preallocated, contiguous
+ * matrices whose elements can be stored as float, and Sample() reuses the
+ * given matrices.  Unlike RandomReplay, the transitions have to be stored and
+ * sampled from a single thread, since the priorities are kept in a sum tree.
+ *
  * @tparam EnvironmentType Desired task.
+ * @tparam ElemType Type used to store the encoded states (double or float).
  */
-template <typename EnvironmentType>
+template <typename EnvironmentType, typename ElemType = double>
 class PrioritizedReplay
 {
  public:
@@ -119,11 +125,11 @@ class PrioritizedReplay
    * @param isEnd Whether next state is terminal state.
    * @param discount The discount parameter.
    */
-  void Store(StateType state,
-             ActionType action,
-             double reward,
-             StateType nextState,
-             bool isEnd,
+  void Store(const StateType& state,
+             const ActionType& action,
+             const double reward,
+             const StateType& nextState,
+             const bool isEnd,
              const double& discount)
   {
     nStepBuffer.push_back({state, action, reward, nextState, isEnd});
@@ -140,17 +146,48 @@ class PrioritizedReplay
     assert(nStepBuffer.size() == nSteps);
 
     // Make a n-step transition.
-    GetNStepInfo(reward, nextState, isEnd, discount);
+    double nStepReward;
+    StateType nStepNextState;
+    bool nStepIsEnd;
+    GetNStepInfo(nStepReward, nStepNextState, nStepIsEnd, discount);
+
+    Insert(nStepBuffer.front().state, nStepBuffer.front().action, nStepReward,
+        nStepNextState, nStepIsEnd, maxPriority);
+  }
 
-    state = nStepBuffer.front().state;
-    action = nStepBuffer.front().action;
-    states.col(position) = state.Encode();
+  /**
+   * Store the given transition as it is (without combining it with the
+   * previous ones into an n-step transition), with the given priority.  This
+   * is used when the priority of a transition is computed by the agent that
+   * generated it, as the actors of ApeX do.
+   *
+   * @param state Given state.
+   * @param action Given action.
+   * @param reward Given reward.
+   * @param nextState Given next state.
+   * @param isEnd Whether next state is terminal state.
+   * @param priority Priority of the transition.
+   */
+  void Insert(const StateType& state,
+              const ActionType& action,
+              const double reward,
+              const StateType& nextState,
+              const bool isEnd,
+              const double priority)
+  {
+    const auto& encodedState = state.Encode();
+    const auto& encodedNextState = nextState.Encode();
+    for (size_t d = 0; d < states.n_rows; ++d)
+    {
+      states(d, position) = ElemType(encodedState[d]);
+      nextStates(d, position) = ElemType(encodedNextState[d]);
+    }
     actions[position] = action;
     rewards(position) = reward;
-    nextStates.col(position) = nextState.Encode();
     isTerminal(position) = isEnd;
 
-    idxSum.Set(position, maxPriority * alpha);
+    maxPriority = std::max(maxPriority, priority);
+    idxSum.Set(position, priority * alpha);
 
     position++;
     if (position == capacity)
@@ -197,19 +234,17 @@ class PrioritizedReplay
    */
   arma::ucolvec SampleProportional()
   {
-    arma::ucolvec idxes(batchSize);
-    double totalSum = idxSum.Sum(0, (full ? capacity : position));
-    double sumPerRange = totalSum / batchSize;
-    for (size_t bt = 0; bt < batchSize; bt++)
-    {
-      const double mass = arma::randu() * sumPerRange + bt * sumPerRange;
-      idxes(bt) = idxSum.FindPrefixSum(mass);
-    }
+    // The transitions that were not stored yet have a priority of zero, so
+    // they are never sampled.
+    arma::ucolvec idxes;
+    idxSum.StratifiedSample(batchSize, idxes);
     return idxes;
   }
 
   /**
-   * Sample some experience according to their priorities.
+   * Sample some experience according to their priorities.  The given
+   * matrices and vector are overwritten, and only reallocated if they do not
+   * have the right size already.
    *
    * @param sampledStates Sampled encoded states.
    * @param sampledActions Sampled actions.
@@ -224,24 +259,36 @@ class PrioritizedReplay
               arma::mat& sampledNextStates,
               arma::irowvec& isTerminal)
   {
-    sampledIndices = SampleProportional();
+    idxSum.StratifiedSample(batchSize, sampledIndices);
     BetaAnneal();
 
-    sampledStates = states.cols(sampledIndices);
-    for (size_t t = 0; t < sampledIndices.n_rows; t ++)
-      sampledActions.push_back(actions[sampledIndices[t]]);
-    sampledRewards = rewards.elem(sampledIndices).t();
-    sampledNextStates = nextStates.cols(sampledIndices);
-    isTerminal = this->isTerminal.elem(sampledIndices).t();
+    sampledStates.set_size(states.n_rows, sampledIndices.n_elem);
+    sampledActions.resize(sampledIndices.n_elem);
+    sampledRewards.set_size(sampledIndices.n_elem);
+    sampledNextStates.set_size(nextStates.n_rows, sampledIndices.n_elem);
+    isTerminal.set_size(sampledIndices.n_elem);
+    for (size_t t = 0; t < sampledIndices.n_elem; ++t)
+    {
+      const size_t index = sampledIndices[t];
+      for (size_t d = 0; d < states.n_rows; ++d)
+      {
+        sampledStates(d, t) = double(states(d, index));
+        sampledNextStates(d, t) = double(nextStates(d, index));
+      }
+      sampledActions[t] = actions[index];
+      sampledRewards[t] = rewards[index];
+      isTerminal[t] = this->isTerminal[index];
+    }
 
     // Calculate the weights of sampled transitions.
 
     size_t numSample = full ? capacity : position;
-    weights = arma::rowvec(sampledIndices.n_rows);
+    weights.set_size(sampledIndices.n_rows);
 
+    const double totalSum = idxSum.Sum();
     for (size_t i = 0; i < sampledIndices.n_rows; ++i)
     {
-      double p_sample = idxSum.Get(sampledIndices(i)) / idxSum.Sum();
+      double p_sample = idxSum.Get(sampledIndices(i)) / totalSum;
       weights(i) = pow(numSample * p_sample, -beta);
     }
     weights /= weights.max();
@@ -265,7 +312,7 @@ class PrioritizedReplay
    *
    * @return Actual used memory size.
    */
-  const size_t& Size()
+  size_t Size() const
   {
     return full ? capacity : position;
   }
@@ -286,9 +333,9 @@ class PrioritizedReplay
    * @param nextActionValues Agent's next action.
    * @param gradients The model's gradients.
    */
-  void Update(arma::mat target,
-              std::vector<ActionType> sampledActions,
-              arma::mat nextActionValues,
+  void Update(const arma::mat& target,
+              const std::vector<ActionType>& sampledActions,
+              const arma::mat& nextActionValues,
               arma::mat& gradients)
   {
     arma::colvec tdError(target.n_cols);
@@ -301,7 +348,7 @@ class PrioritizedReplay
     UpdatePriorities(sampledIndices, tdError);
 
     // Update the gradient
-    gradients = arma::mean(weights) * gradients;
+    gradients *= arma::mean(weights);
   }
 
   //! Get the number of steps for n-step agent.
@@ -352,7 +399,7 @@ class PrioritizedReplay
   std::deque<Transition> nStepBuffer;
 
   //! Locally-stored encoded previous states.
-  arma::mat states;
+  arma::Mat<ElemType> states;
 
   //! Locally-stored previous actions.
   std::vector<ActionType> actions;
@@ -361,7 +408,7 @@ class PrioritizedReplay
   arma::rowvec rewards;
 
   //! Locally-stored encoded previous next states.
-  arma::mat nextStates;
+  arma::Mat<ElemType> nextStates;
 
   //! Locally-stored termination information of previous experience.
   arma::irowvec isTerminal;
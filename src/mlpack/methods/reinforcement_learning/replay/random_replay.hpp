@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <cassert>
+#include <mutex>
 
 namespace mlpack {
 namespace rl {
@@ -27,6 +28,19 @@ namespace rl {
  * train the agent. Typically this would be a random sample and
  * the memory will be a First-In-First-Out buffer.
  *
+ * The transitions are kept in a ring of preallocated, contiguous matrices
+ * (one column per transition), whose elements can be stored as float to halve
+ * the memory of large buffers.  Sample() writes into the given matrices, which
+ * are only reallocated if their size changes, so reusing them between training
+ * steps does not allocate anything.
+ *
+ * Several actor threads can call Insert() concurrently, while the learner
+ * calls Sample(): each insertion claims its slot of the ring with an atomic
+ * counter, and each slot is protected by its own lock, which is only held
+ * while the transition is copied in or out of the slot.  If two insertions
+ * claim the same slot (because the ring wrapped around while the first one
+ * was waiting), the most recent transition is kept.
+ *
  * For more information, see the following.
  *
  * @code
@@ -39,8 +53,9 @@ namespace rl {
  * @endcode
  *
  * @tparam EnvironmentType Desired task.
+ * @tparam ElemType Type used to store the encoded states (double or float).
  */
-template <typename EnvironmentType>
+template <typename EnvironmentType, typename ElemType = double>
 class RandomReplay
 {
  public:
@@ -62,8 +77,7 @@ class RandomReplay
   RandomReplay():
       batchSize(0),
       capacity(0),
-      position(0),
-      full(false),
+      insertions(0),
       nSteps(0)
   { /* Nothing to do here. */ }
 
@@ -81,18 +95,22 @@ class RandomReplay
                const size_t dimension = StateType::dimension) :
       batchSize(batchSize),
       capacity(capacity),
-      position(0),
-      full(false),
+      insertions(0),
       nSteps(nSteps),
       states(dimension, capacity),
       actions(capacity),
       rewards(capacity),
       nextStates(dimension, capacity),
-      isTerminal(capacity)
+      isTerminal(capacity),
+      tickets(capacity, 0),
+      locks(capacity)
   { /* Nothing to do here. */ }
 
   /**
-   * Store the given experience.
+   * Store the given experience.  The last nSteps experiences are combined into
+   * an n-step transition, so this should be called with the consecutive
+   * experiences of one agent; use Insert() to store transitions from several
+   * threads.
    *
    * @param state Given state.
    * @param action Given action.
@@ -101,11 +119,11 @@ class RandomReplay
    * @param isEnd Whether next state is terminal state.
    * @param discount The discount parameter.
    */
-  void Store(StateType state,
-             ActionType action,
-             double reward,
-             StateType nextState,
-             bool isEnd,
+  void Store(const StateType& state,
+             const ActionType& action,
+             const double reward,
+             const StateType& nextState,
+             const bool isEnd,
              const double& discount)
   {
     nStepBuffer.push_back({state, action, reward, nextState, isEnd});
@@ -122,22 +140,58 @@ class RandomReplay
     assert(nStepBuffer.size() == nSteps);
 
     // Make a n-step transition.
-    GetNStepInfo(reward, nextState, isEnd, discount);
-
-    state = nStepBuffer.front().state;
-    action = nStepBuffer.front().action;
-
-    states.col(position) = state.Encode();
-    actions[position] = action;
-    rewards(position) = reward;
-    nextStates.col(position) = nextState.Encode();
-    isTerminal(position) = isEnd;
-    position++;
-    if (position == capacity)
+    double nStepReward;
+    StateType nStepNextState;
+    bool nStepIsEnd;
+    GetNStepInfo(nStepReward, nStepNextState, nStepIsEnd, discount);
+
+    Insert(nStepBuffer.front().state, nStepBuffer.front().action, nStepReward,
+        nStepNextState, nStepIsEnd);
+  }
+
+  /**
+   * Insert the given transition in the memory, overwriting the oldest one if
+   * the memory is full.  This can be called from several threads at once, and
+   * while another thread calls Sample().
+   *
+   * @param state Given state.
+   * @param action Given action.
+   * @param reward Given reward.
+   * @param nextState Given next state.
+   * @param isEnd Whether next state is terminal state.
+   */
+  void Insert(const StateType& state,
+              const ActionType& action,
+              const double reward,
+              const StateType& nextState,
+              const bool isEnd)
+  {
+    // Claim the next slot of the ring.
+    size_t ticket;
+    #pragma omp atomic capture
+    ticket = insertions++;
+    const size_t slot = ticket % capacity;
+
+    const auto& encodedState = state.Encode();
+    const auto& encodedNextState = nextState.Encode();
+
+    std::lock_guard<std::mutex> lock(locks[slot]);
+
+    // A more recent transition may already have been written to this slot.
+    if (tickets[slot] > ticket)
+      return;
+
+    ElemType* stateCol = states.colptr(slot);
+    ElemType* nextStateCol = nextStates.colptr(slot);
+    for (size_t d = 0; d < states.n_rows; ++d)
     {
-      full = true;
-      position = 0;
+      stateCol[d] = ElemType(encodedState[d]);
+      nextStateCol[d] = ElemType(encodedNextState[d]);
     }
+    actions[slot] = action;
+    rewards[slot] = reward;
+    isTerminal[slot] = isEnd;
+    tickets[slot] = ticket + 1;
   }
 
   /**
@@ -171,7 +225,8 @@ class RandomReplay
   }
 
   /**
-   * Sample some experiences.
+   * Sample some experiences.  The given matrices and vector are overwritten,
+   * and only reallocated if they do not have the right size already.
    *
    * @param sampledStates Sampled encoded states.
    * @param sampledActions Sampled actions.
@@ -186,16 +241,50 @@ class RandomReplay
               arma::mat& sampledNextStates,
               arma::irowvec& isTerminal)
   {
-    size_t upperBound = full ? capacity : position;
+    const size_t upperBound = Size();
+    if (upperBound == 0)
+    {
+      throw std::logic_error("RandomReplay::Sample(): no transition has been "
+          "stored");
+    }
+
     arma::uvec sampledIndices = arma::randi<arma::uvec>(
         batchSize, arma::distr_param(0, upperBound - 1));
 
-    sampledStates = states.cols(sampledIndices);
-    for (size_t t = 0; t < sampledIndices.n_rows; t ++)
-      sampledActions.push_back(actions[sampledIndices[t]]);
-    sampledRewards = rewards.elem(sampledIndices).t();
-    sampledNextStates = nextStates.cols(sampledIndices);
-    isTerminal = this->isTerminal.elem(sampledIndices).t();
+    sampledStates.set_size(states.n_rows, batchSize);
+    sampledActions.resize(batchSize);
+    sampledRewards.set_size(batchSize);
+    sampledNextStates.set_size(nextStates.n_rows, batchSize);
+    isTerminal.set_size(batchSize);
+    for (size_t t = 0; t < batchSize; ++t)
+    {
+      size_t index = sampledIndices[t];
+      while (true)
+      {
+        std::lock_guard<std::mutex> lock(locks[index]);
+
+        // A slot may have been claimed but not written yet.
+        if (tickets[index] != 0)
+        {
+          const ElemType* stateCol = states.colptr(index);
+          const ElemType* nextStateCol = nextStates.colptr(index);
+          double* sampledStateCol = sampledStates.colptr(t);
+          double* sampledNextStateCol = sampledNextStates.colptr(t);
+          for (size_t d = 0; d < states.n_rows; ++d)
+          {
+            sampledStateCol[d] = double(stateCol[d]);
+            sampledNextStateCol[d] = double(nextStateCol[d]);
+          }
+          sampledActions[t] = actions[index];
+          sampledRewards[t] = rewards[index];
+          isTerminal[t] = this->isTerminal[index];
+          break;
+        }
+
+        // The slot is still empty; take another one.
+        index = math::RandInt(upperBound);
+      }
+    }
   }
 
   /**
@@ -203,9 +292,12 @@ class RandomReplay
    *
    * @return Actual used memory size
    */
-  const size_t& Size()
+  size_t Size() const
   {
-    return full ? capacity : position;
+    size_t count;
+    #pragma omp atomic read
+    count = insertions;
+    return std::min(count, capacity);
   }
 
   /**
@@ -216,9 +308,9 @@ class RandomReplay
    * @param * (nextActionValues) Agent's next action
    * @param * (gradients) The model's gradients
    */
-  void Update(arma::mat /* target */,
-              std::vector<ActionType> /* sampledActions */,
-              arma::mat /* nextActionValues */,
+  void Update(const arma::mat& /* target */,
+              const std::vector<ActionType>& /* sampledActions */,
+              const arma::mat& /* nextActionValues */,
               arma::mat& /* gradients */)
   {
     /* Do nothing for random replay. */
@@ -234,11 +326,9 @@ class RandomReplay
   //! Locally-stored total memory limit.
   size_t capacity;
 
-  //! Indicate the position to store new transition.
-  size_t position;
-
-  //! Locally-stored indicator that whether the memory is full or not
-  bool full;
+  //! The number of transitions inserted so far; the next one goes to slot
+  //! (insertions % capacity).
+  size_t insertions;
 
   //! Locally-stored number of steps to look into the future.
   size_t nSteps;
@@ -247,7 +337,7 @@ class RandomReplay
   std::deque<Transition> nStepBuffer;
 
   //! Locally-stored encoded previous states.
-  arma::mat states;
+  arma::Mat<ElemType> states;
 
   //! Locally-stored previous actions.
   std::vector<ActionType> actions;
@@ -256,10 +346,17 @@ class RandomReplay
   arma::rowvec rewards;
 
   //! Locally-stored encoded previous next states.
-  arma::mat nextStates;
+  arma::Mat<ElemType> nextStates;
 
   //! Locally-stored termination information of previous experience.
   arma::irowvec isTerminal;
+
+  //! The ticket of the transition stored in each slot, plus one (0 if the slot
+  //! is empty).  Only accessed with the lock of the slot held.
+  std::vector<size_t> tickets;
+
+  //! The lock of each slot, held while a transition is copied in or out.
+  std::vector<std::mutex> locks;
 };
 
 } // namespace rl
@@ -26,11 +26,23 @@ namespace rl {
  *
  * Used to maintain prefix-sum of an array.
  *
+ * The tree is stored one level at a time, each level in a contiguous array,
+ * and each node is the sum of Fanout consecutive nodes of the level below; with
+ * the default fanout, the children of a node fill one cache line, so a
+ * root-to-leaf walk touches one cache line per level, and the tree is much
+ * shallower than a binary one.  Several prefix-sum queries (as needed to
+ * sample a batch) are answered together, one level at a time, and several
+ * elements are updated together, each sum of the tree being recomputed once;
+ * large batches are processed in parallel.
+ *
  * @tparam T The array's element type.
+ * @tparam Fanout The number of children of each node.
  */
-template<typename T>
+template<typename T, size_t Fanout = 8>
 class SumTree
 {
+  static_assert(Fanout >= 2, "SumTree: the fanout must be at least 2.");
+
  public:
   /**
    * Default constructor.
@@ -45,7 +57,16 @@ class SumTree
    */
   SumTree(const size_t capacity) : capacity(capacity)
   {
-    element = std::vector<T>(2 * capacity);
+    // Each level is padded with zeros to a whole number of groups of
+    // children; the root is the first element of the last level.
+    size_t levelSize = std::max(capacity, (size_t) 1);
+    while (true)
+    {
+      levels.push_back(std::vector<T>(RoundUp(levelSize), T(0)));
+      if (levelSize == 1)
+        break;
+      levelSize = (levelSize + Fanout - 1) / Fanout;
+    }
   }
 
   /**
@@ -56,32 +77,43 @@ class SumTree
    */
   void Set(size_t idx, const T value)
   {
-    idx += capacity;
-    element[idx] = value;
-    idx /= 2;
-    while (idx >= 1)
+    levels[0][idx] = value;
+    for (size_t l = 1; l < levels.size(); ++l)
     {
-      element[idx] = element[2 * idx] + element[2 * idx + 1];
-      idx /= 2;
+      idx /= Fanout;
+      levels[l][idx] = GroupSum(levels[l - 1], idx);
     }
   }
 
   /**
    * Update the data with batch rather loop over the indices with set method.
+   * Each sum of the tree that depends on the given indices is recomputed only
+   * once, and in parallel if there are enough of them.
    *
    * @param indices The indices of data to be changed.
    * @param data The data that array with indices to be.
    */
   void BatchUpdate(const arma::ucolvec& indices, const arma::Col<T>& data)
   {
-    for (size_t i = 0; i < indices.n_rows; ++i)
-    {
-      element[indices[i] + capacity] = data[i];
-    }
-    // update the total tree with bottom-up technique.
-    for (size_t i = capacity - 1; i > 0; i--)
+    for (size_t i = 0; i < indices.n_elem; ++i)
+      levels[0][indices[i]] = data[i];
+
+    // The nodes to recompute at each level, in increasing order.
+    dirtyNodes.assign(indices.begin(), indices.end());
+    std::sort(dirtyNodes.begin(), dirtyNodes.end());
+    for (size_t l = 1; l < levels.size(); ++l)
     {
-      element[i] = element[2 * i] + element[2 * i + 1];
+      for (size_t i = 0; i < dirtyNodes.size(); ++i)
+        dirtyNodes[i] /= Fanout;
+      dirtyNodes.erase(std::unique(dirtyNodes.begin(), dirtyNodes.end()),
+          dirtyNodes.end());
+
+      const std::vector<T>& children = levels[l - 1];
+      std::vector<T>& level = levels[l];
+      #pragma omp parallel for schedule(static) \
+          if (dirtyNodes.size() >= minParallelNodes)
+      for (omp_size_t i = 0; i < (omp_size_t) dirtyNodes.size(); ++i)
+        level[dirtyNodes[i]] = GroupSum(children, dirtyNodes[i]);
     }
   }
 
@@ -90,100 +122,165 @@ class SumTree
    *
    * @param idx The array idx to get data.
    */
-  T Get(size_t idx)
+  T Get(const size_t idx) const
   {
-    idx += capacity;
-    return element[idx];
+    return levels[0][idx];
   }
 
   /**
-   * Help function for the `sum` function
+   * Calculate the sum of contiguous subsequence of the array.
    *
    * @param start The starting position of subsequence.
    * @param end The end position of subsequence.
-   * @param node Reference position.
-   * @param nodeStart Starting position of reference segment.
-   * @param nodeEnd End position of reference segment.
    */
-  T SumHelper(const size_t start,
-              const size_t end,
-              const size_t node,
-              const size_t nodeStart,
-              const size_t nodeEnd)
+  T Sum(size_t start, size_t end) const
   {
-    if (start == nodeStart && end == nodeEnd)
-    {
-      return element[node];
-    }
-    size_t mid = (nodeStart + nodeEnd) / 2;
-    if (end <= mid)
+    // Add the nodes at both ends of the range that do not make a whole group
+    // of children, and go up to the sums of the groups in between.
+    T sum = T(0);
+    for (size_t l = 0; l < levels.size() && start < end; ++l)
     {
-      return SumHelper(start, end, 2 * node, nodeStart, mid);
-    }
-    else
-    {
-      if (mid + 1 <= start)
-      {
-        return SumHelper(start, end, 2 * node + 1, mid + 1 , nodeEnd);
-      }
-      else
-      {
-        return SumHelper(start, mid, 2 * node, nodeStart, mid) +
-            SumHelper(mid + 1, end, 2 * node + 1, mid + 1 , nodeEnd);
-      }
+      const std::vector<T>& level = levels[l];
+      while (start < end && start % Fanout != 0)
+        sum += level[start++];
+      while (end > start && end % Fanout != 0)
+        sum += level[--end];
+
+      start /= Fanout;
+      end /= Fanout;
     }
+
+    return sum;
   }
 
   /**
-   * Calculate the sum of contiguous subsequence of the array.
+   * Shortcut for calculating the sum of whole array.
+   */
+  T Sum() const
+  {
+    return levels.empty() ? T(0) : levels.back()[0];
+  }
+
+  /**
+   * Find the highest index `idx` in the array such that
+   * sum(arr[0] + arr[1] + ... + arr[idx]) <= mass.
    *
-   * @param start The starting position of subsequence.
-   * @param end The end position of subsequence.
+   * @param mass The upper bound of segment array sum.
    */
-  T Sum(const size_t start, size_t end)
+  size_t FindPrefixSum(T mass) const
   {
-    end -= 1;
-    return SumHelper(start, end, 1, 0, capacity - 1);
+    size_t node = 0;
+    for (size_t l = levels.size(); l > 1; --l)
+      node = Descend(levels[l - 2], node, mass);
+
+    return node;
   }
 
   /**
-   * Shortcut for calculating the sum of whole array.
+   * Answer FindPrefixSum() for each of the given masses.  The queries go down
+   * the tree together, one level at a time, so that each level is read while
+   * it is in cache; large batches are processed in parallel.
+   *
+   * @param masses The upper bounds of segment array sum.
+   * @param indices The index found for each mass.
    */
-  T Sum()
+  void FindPrefixSums(const arma::Col<T>& masses, arma::ucolvec& indices)
   {
-    return Sum(0, capacity);
+    remainingMasses = masses;
+    DescendAll(indices);
   }
 
   /**
-   * Find the highest index `idx` in the array such that
-   * sum(arr[0] + arr[1] + ... + arr[idx]) <= mass.
+   * Sample the given number of indices with probability proportional to their
+   * data, with stratified sampling: the total sum is split into numSamples
+   * equal ranges, and one mass is drawn uniformly from each range.
    *
-   * @param mass The upper bound of segment array sum.
+   * @param numSamples The number of indices to sample.
+   * @param indices The sampled indices, in increasing order.
+   */
+  void StratifiedSample(const size_t numSamples, arma::ucolvec& indices)
+  {
+    const T range = Sum() / T(numSamples);
+    remainingMasses.set_size(numSamples);
+    for (size_t i = 0; i < numSamples; ++i)
+      remainingMasses[i] = (T(i) + T(arma::randu())) * range;
+
+    DescendAll(indices);
+  }
+
+ private:
+  //! The number of nodes from which a level is updated or searched in
+  //! parallel.
+  static constexpr size_t minParallelNodes = 4096;
+
+  //! Round the given size up to a whole number of groups of children.
+  static size_t RoundUp(const size_t size)
+  {
+    return ((size + Fanout - 1) / Fanout) * Fanout;
+  }
+
+  //! Compute the sum of the children of the given node.
+  static T GroupSum(const std::vector<T>& children, const size_t node)
+  {
+    const T* first = children.data() + node * Fanout;
+    T sum = T(0);
+    for (size_t c = 0; c < Fanout; ++c)
+      sum += first[c];
+    return sum;
+  }
+
+  /**
+   * Find the child of the given node to go down to for the given mass, and
+   * subtract from the mass the sums of the children before it.  If rounding
+   * errors make the mass exceed the sum of the children, the last non-empty
+   * child is taken.
    */
-  size_t FindPrefixSum(T mass)
+  static size_t Descend(const std::vector<T>& children,
+                        const size_t node,
+                        T& mass)
   {
-    size_t idx = 1;
-    while (idx < capacity)
+    const T* first = children.data() + node * Fanout;
+    size_t last = 0;
+    for (size_t c = 0; c < Fanout; ++c)
     {
-      if (element[2 * idx] > mass)
-      {
-        idx = 2 * idx;
-      }
-      else
-      {
-        mass -= element[2 * idx];
-        idx = 2 * idx + 1;
-      }
+      if (first[c] > mass)
+        return node * Fanout + c;
+
+      mass -= first[c];
+      if (first[c] > T(0))
+        last = c;
+    }
+
+    mass = first[last];
+    return node * Fanout + last;
+  }
+
+  //! Answer FindPrefixSum() for each mass in remainingMasses.
+  void DescendAll(arma::ucolvec& indices)
+  {
+    const size_t numQueries = remainingMasses.n_elem;
+    indices.zeros(numQueries);
+    for (size_t l = levels.size(); l > 1; --l)
+    {
+      const std::vector<T>& children = levels[l - 2];
+      #pragma omp parallel for schedule(static) \
+          if (numQueries >= minParallelNodes)
+      for (omp_size_t i = 0; i < (omp_size_t) numQueries; ++i)
+        indices[i] = Descend(children, indices[i], remainingMasses[i]);
     }
-    return idx - capacity;
   }
 
- private:
   //! The capacity of the data array.
   size_t capacity;
 
-  //! Double size of capacity, maintain the segment sum of data.
-  std::vector<T> element;
+  //! The levels of the tree, from the data array up to the root.
+  std::vector<std::vector<T>> levels;
+
+  //! Buffer of the nodes to recompute in BatchUpdate().
+  std::vector<size_t> dirtyNodes;
+
+  //! Buffer of the masses left in the batched queries.
+  arma::Col<T> remainingMasses;
 };
 
 } // namespace rl
@@ -17,6 +17,7 @@
 #include <ensmallen.hpp>
 
 #include "replay/random_replay.hpp"
+#include "environment/vector_environment.hpp"
 #include <mlpack/methods/ann/activation_functions/tanh_function.hpp>
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/visitor/parameters_visitor.hpp>
@@ -123,6 +124,30 @@ class SAC
    */
   double Episode();
 
+  /**
+   * Select an action for each of the given states, with a single forward pass
+   * of the policy network.
+   *
+   * @param states Encoded states, one per column.
+   * @param actions Will hold the action selected for each state.
+   */
+  void SelectActions(const arma::mat& states, std::vector<ActionType>& actions);
+
+  /**
+   * Step all the environments of the given VectorEnvironment the given number
+   * of times, selecting the actions of all of them with one forward pass of
+   * the policy network.  The transitions are stored and the agent is updated
+   * after each of them, as if the environments were stepped one after the
+   * other; episodes are cut after config.StepLimit() steps, like in
+   * Episode().  Since the transitions of the environments are interleaved,
+   * n-step replay (NSteps() > 1) is only supported with a single environment.
+   *
+   * @param environments Copies of the environment to step.
+   * @param numSteps Number of steps of each environment.
+   */
+  void Steps(VectorEnvironment<EnvironmentType>& environments,
+             const size_t numSteps);
+
   //! Modify total steps from beginning.
   size_t& TotalSteps() { return totalSteps; }
   //! Get total steps from beginning.
@@ -167,6 +192,13 @@ class SAC
       qNetworkUpdatePolicy;
   #endif
 
+  //! Locally-stored updater of the second Q network.
+  UpdaterType q2NetworkUpdater;
+  #if ENS_VERSION_MAJOR >= 2
+  typename UpdaterType::template Policy<arma::mat, arma::mat>*
+      q2NetworkUpdatePolicy;
+  #endif
+
   //! Locally-stored updater.
   UpdaterType policyNetworkUpdater;
   #if ENS_VERSION_MAJOR >= 2
@@ -191,6 +223,23 @@ class SAC
 
   //! Locally-stored loss function.
   mlpack::ann::MeanSquaredError<> lossFunction;
+
+  //! Buffers for the sampled transitions, reused by each training step.
+  arma::mat sampledStates;
+  std::vector<ActionType> sampledActions;
+  arma::rowvec sampledRewards;
+  arma::mat sampledNextStates;
+  arma::irowvec isTerminal;
+
+  //! Whether the buffers below hold the batch of the next update.
+  bool prefetched;
+
+  //! Buffers for the batch of the next update, sampled during the last one.
+  arma::mat prefetchedStates;
+  std::vector<ActionType> prefetchedActions;
+  arma::rowvec prefetchedRewards;
+  arma::mat prefetchedNextStates;
+  arma::irowvec prefetchedIsTerminal;
 };
 
 } // namespace rl
@@ -48,13 +48,18 @@ SAC<
   #if ENS_VERSION_MAJOR >= 2
   qNetworkUpdatePolicy(NULL),
   #endif
+  q2NetworkUpdater(this->qNetworkUpdater),
+  #if ENS_VERSION_MAJOR >= 2
+  q2NetworkUpdatePolicy(NULL),
+  #endif
   policyNetworkUpdater(std::move(policyNetworkUpdater)),
   #if ENS_VERSION_MAJOR >= 2
   policyNetworkUpdatePolicy(NULL),
   #endif
   environment(std::move(environment)),
   totalSteps(0),
-  deterministic(false)
+  deterministic(false),
+  prefetched(false)
 {
   // Set up q-learning and policy networks.
   targetQ1Network = learningQ1Network;
@@ -75,14 +80,22 @@ SAC<
   targetQ1Network.ResetParameters();
   targetQ2Network.ResetParameters();
 
+  // Each critic has its own optimizer state, so that they can be updated
+  // concurrently.
   #if ENS_VERSION_MAJOR == 1
   this->qNetworkUpdater.Initialize(learningQ1Network.Parameters().n_rows,
                                    learningQ1Network.Parameters().n_cols);
+  this->q2NetworkUpdater.Initialize(learningQ2Network.Parameters().n_rows,
+                                    learningQ2Network.Parameters().n_cols);
   #else
   this->qNetworkUpdatePolicy = new typename UpdaterType::template
       Policy<arma::mat, arma::mat>(this->qNetworkUpdater,
                                    learningQ1Network.Parameters().n_rows,
                                    learningQ1Network.Parameters().n_cols);
+  this->q2NetworkUpdatePolicy = new typename UpdaterType::template
+      Policy<arma::mat, arma::mat>(this->q2NetworkUpdater,
+                                   learningQ2Network.Parameters().n_rows,
+                                   learningQ2Network.Parameters().n_cols);
   #endif
 
   #if ENS_VERSION_MAJOR == 1
@@ -117,6 +130,7 @@ SAC<
 {
   #if ENS_VERSION_MAJOR >= 2
   delete qNetworkUpdatePolicy;
+  delete q2NetworkUpdatePolicy;
   delete policyNetworkUpdatePolicy;
   #endif
 }
@@ -136,10 +150,19 @@ void SAC<
   ReplayType
 >::SoftUpdate(double rho)
 {
-  targetQ1Network.Parameters() = (1 - rho) * targetQ1Network.Parameters() +
-      rho * learningQ1Network.Parameters();
-  targetQ2Network.Parameters() = (1 - rho) * targetQ2Network.Parameters() +
-      rho * learningQ2Network.Parameters();
+  // target += rho * (learning - target), in place.
+  double* target1 = targetQ1Network.Parameters().memptr();
+  double* target2 = targetQ2Network.Parameters().memptr();
+  const double* learning1 = learningQ1Network.Parameters().memptr();
+  const double* learning2 = learningQ2Network.Parameters().memptr();
+  const size_t numParameters = learningQ1Network.Parameters().n_elem;
+
+  #pragma omp parallel for schedule(static) if (numParameters >= 65536)
+  for (omp_size_t i = 0; i < (omp_size_t) numParameters; ++i)
+  {
+    target1[i] += rho * (learning1[i] - target1[i]);
+    target2[i] += rho * (learning2[i] - target2[i]);
+  }
 }
 
 template <
@@ -157,15 +180,20 @@ void SAC<
   ReplayType
 >::Update()
 {
-  // Sample from previous experience.
-  arma::mat sampledStates;
-  std::vector<ActionType> sampledActions;
-  arma::rowvec sampledRewards;
-  arma::mat sampledNextStates;
-  arma::irowvec isTerminal;
-
-  replayMethod.Sample(sampledStates, sampledActions, sampledRewards,
-      sampledNextStates, isTerminal);
+  // Use the batch sampled during the last update if there is one.
+  if (prefetched)
+  {
+    std::swap(sampledStates, prefetchedStates);
+    std::swap(sampledActions, prefetchedActions);
+    std::swap(sampledRewards, prefetchedRewards);
+    std::swap(sampledNextStates, prefetchedNextStates);
+    std::swap(isTerminal, prefetchedIsTerminal);
+  }
+  else
+  {
+    replayMethod.Sample(sampledStates, sampledActions, sampledRewards,
+        sampledNextStates, isTerminal);
+  }
 
   // Critic network update.
 
@@ -187,31 +215,36 @@ void SAC<
                                  (sampledActions[i].action);
   arma::mat learningQInput = arma::join_vert(sampledActionValues,
       sampledStates);
-  learningQ1Network.Forward(learningQInput, Q1);
-  learningQ2Network.Forward(learningQInput, Q2);
 
-  arma::mat gradQ1Loss, gradQ2Loss;
-  lossFunction.Backward(Q1, nextQ, gradQ1Loss);
-  lossFunction.Backward(Q2, nextQ, gradQ2Loss);
+  // Update the two critics concurrently (they share no state), while the
+  // batch of the next update is sampled.
+  #pragma omp parallel for schedule(static, 1) num_threads(3)
+  for (omp_size_t task = 0; task < 3; ++task)
+  {
+    if (task == 2)
+    {
+      replayMethod.Sample(prefetchedStates, prefetchedActions,
+          prefetchedRewards, prefetchedNextStates, prefetchedIsTerminal);
+      continue;
+    }
 
-  // Update the critic networks.
-  arma::mat gradientQ1, gradientQ2;
-  learningQ1Network.Backward(learningQInput, gradQ1Loss, gradientQ1);
-  #if ENS_VERSION_MAJOR == 1
-  qNetworkUpdater.Update(learningQ1Network.Parameters(), config.StepSize(),
-      gradientQ1);
-  #else
-  qNetworkUpdatePolicy->Update(learningQ1Network.Parameters(),
-      config.StepSize(), gradientQ1);
-  #endif
-  learningQ2Network.Backward(learningQInput, gradQ2Loss, gradientQ2);
-  #if ENS_VERSION_MAJOR == 1
-  qNetworkUpdater.Update(learningQ2Network.Parameters(), config.StepSize(),
-      gradientQ2);
-  #else
-  qNetworkUpdatePolicy->Update(learningQ2Network.Parameters(),
-      config.StepSize(), gradientQ2);
-  #endif
+    QNetworkType& network = (task == 0) ? learningQ1Network :
+        learningQ2Network;
+    arma::mat q, gradLoss, gradient;
+    network.Forward(learningQInput, q);
+    lossFunction.Backward(q, nextQ, gradLoss);
+    network.Backward(learningQInput, gradLoss, gradient);
+
+    #if ENS_VERSION_MAJOR == 1
+    UpdaterType& updater = (task == 0) ? qNetworkUpdater : q2NetworkUpdater;
+    updater.Update(network.Parameters(), config.StepSize(), gradient);
+    #else
+    typename UpdaterType::template Policy<arma::mat, arma::mat>* updatePolicy =
+        (task == 0) ? qNetworkUpdatePolicy : q2NetworkUpdatePolicy;
+    updatePolicy->Update(network.Parameters(), config.StepSize(), gradient);
+    #endif
+  }
+  prefetched = true;
 
   // Actor network update.
 
@@ -234,22 +267,14 @@ void SAC<
     arma::colvec singlePi;
     policyNetwork.Forward(singleState, singlePi);
     arma::colvec input = arma::join_vert(singlePi, singleState);
-    arma::mat weightLastLayer;
-
-    if (Q1(i) < Q2(i))
-    {
-      learningQ1Network.Forward(input, q);
-      learningQ1Network.Backward(input, -1, gradQ);
-      weightLastLayer = arma::reshape(learningQ1Network.Parameters().
-          rows(0, hidden1 * singlePi.n_rows - 1), hidden1, singlePi.n_rows);
-    }
-    else
-    {
-      learningQ2Network.Forward(input, q);
-      learningQ2Network.Backward(input, -1, gradQ);
-      weightLastLayer = arma::reshape(learningQ2Network.Parameters().
-          rows(0, hidden1 * singlePi.n_rows - 1), hidden1, singlePi.n_rows);
-    }
+    // The weights of the actions in the first layer of the critic are its
+    // first parameters; alias them instead of copying them.
+    QNetworkType& critic = (Q1(i) < Q2(i)) ? learningQ1Network :
+        learningQ2Network;
+    critic.Forward(input, q);
+    critic.Backward(input, -1, gradQ);
+    const arma::mat weightLastLayer(critic.Parameters().memptr(), hidden1,
+        singlePi.n_rows, false, true);
 
     arma::colvec gradQBias = gradQ(input.n_rows * hidden1, 0,
         arma::size(hidden1, 1));
@@ -358,6 +383,93 @@ double SAC<
   return totalReturn;
 }
 
+template <
+  typename EnvironmentType,
+  typename QNetworkType,
+  typename PolicyNetworkType,
+  typename UpdaterType,
+  typename ReplayType
+>
+void SAC<
+  EnvironmentType,
+  QNetworkType,
+  PolicyNetworkType,
+  UpdaterType,
+  ReplayType
+>::SelectActions(const arma::mat& states, std::vector<ActionType>& actions)
+{
+  // Get the actions of all the states at once.
+  arma::mat outputActions;
+  policyNetwork.Predict(states, outputActions);
+
+  if (!deterministic)
+  {
+    arma::mat noise = arma::randn<arma::mat>(arma::size(outputActions)) * 0.1;
+    noise = arma::clamp(noise, -0.25, 0.25);
+    outputActions += noise;
+  }
+
+  actions.resize(states.n_cols);
+  for (size_t i = 0; i < states.n_cols; ++i)
+  {
+    actions[i].action = arma::conv_to<std::vector<double>>::from(
+        outputActions.col(i));
+  }
+}
+
+template <
+  typename EnvironmentType,
+  typename QNetworkType,
+  typename PolicyNetworkType,
+  typename UpdaterType,
+  typename ReplayType
+>
+void SAC<
+  EnvironmentType,
+  QNetworkType,
+  PolicyNetworkType,
+  UpdaterType,
+  ReplayType
+>::Steps(VectorEnvironment<EnvironmentType>& environments,
+         const size_t numSteps)
+{
+  if (replayMethod.NSteps() > 1 && environments.NumEnvironments() > 1)
+  {
+    throw std::invalid_argument("SAC::Steps(): n-step replay needs the "
+        "transitions of one environment at a time");
+  }
+
+  std::vector<ActionType> actions;
+  std::vector<StateType> previousStates, nextStates;
+  arma::rowvec rewards;
+  std::vector<bool> terminal;
+  for (size_t step = 0; step < numSteps; ++step)
+  {
+    SelectActions(environments.EncodedStates(), actions);
+    environments.Step(actions, previousStates, rewards, nextStates, terminal,
+        config.StepLimit());
+
+    for (size_t i = 0; i < environments.NumEnvironments(); ++i)
+    {
+      totalSteps++;
+
+      // Store the transition for replay.
+      replayMethod.Store(previousStates[i], actions[i], rewards[i],
+          nextStates[i], terminal[i], config.Discount());
+
+      if (deterministic || totalSteps < config.ExplorationSteps())
+        continue;
+      for (size_t j = 0; j < config.UpdateInterval(); j++)
+        Update();
+    }
+  }
+
+  // Remember the last state and action, like Episode() does.
+  state = environments.States().back();
+  if (!actions.empty())
+    action = actions.back();
+}
+
 } // namespace rl
 } // namespace mlpack
 #endif
@@ -0,0 +1,273 @@
+/**
+ * @file methods/reinforcement_learning/training_metrics.hpp
+ *
+ * This file defines TrainingMetrics, which counts the steps and the updates of
+ * a reinforcement learning agent, and measures where the training time goes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_TRAINING_METRICS_HPP
+#define MLPACK_METHODS_RL_TRAINING_METRICS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * TrainingMetrics keeps the throughput counters of an agent (environment
+ * steps, learner updates and finished episodes since the last Reset()), the
+ * occupancy of its replay buffer, and, when TimePhases() is set, the time
+ * spent in each phase of training: stepping the environment, forward passes,
+ * backward passes, applying the updates, and sampling from the replay.
+ *
+ * The agent calls the given callback at the end of each episode, so that the
+ * training can be monitored as it goes:
+ *
+ * @code
+ * agent.Metrics().TimePhases() = true;
+ * agent.Metrics().Callback() = [](const TrainingMetrics& metrics)
+ * {
+ *   std::cout << metrics.StepsPerSecond() << " steps/s, "
+ *       << metrics.UpdatesPerSecond() << " updates/s, replay sampling takes "
+ *       << metrics.MeanReplaySampleTime() << "s" << std::endl;
+ * };
+ * @endcode
+ *
+ * When UseTimer() is also set, each phase is additionally timed with the
+ * mlpack Timer (as "rl_environment", "rl_forward", "rl_backward", "rl_update"
+ * and "rl_replay_sample"), so that the split shows up with the other timers
+ * of a program.  Phase timing costs two clock reads per phase and is off by
+ * default; the counters are always kept.
+ *
+ * A TrainingMetrics object is not thread-safe; each agent owns its own.
+ */
+class TrainingMetrics
+{
+ public:
+  //! The phases of training that can be timed.
+  enum class Phase
+  {
+    environment,
+    forward,
+    backward,
+    update,
+    replaySample
+  };
+
+  //! The number of phases.
+  static constexpr size_t numPhases = 5;
+
+  //! Convenient typedef for the clock used to time the phases.
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * Times a phase for as long as it is in scope, if the metrics time the
+   * phases.
+   */
+  class Scope
+  {
+   public:
+    //! Start timing the given phase.
+    Scope(TrainingMetrics& metrics, const Phase phase) :
+        metrics(metrics.timePhases ? &metrics : NULL),
+        phase(phase)
+    {
+      if (!this->metrics)
+        return;
+
+      if (metrics.useTimer)
+        Timer::Start(TimerName(phase));
+      start = Clock::now();
+    }
+
+    //! Stop timing the phase, and add its time to the metrics.
+    ~Scope()
+    {
+      if (!metrics)
+        return;
+
+      metrics->phaseTimes[(size_t) phase] += Clock::now() - start;
+      ++metrics->phaseCounts[(size_t) phase];
+      if (metrics->useTimer)
+        Timer::Stop(TimerName(phase));
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    //! The metrics to add the time to, or NULL if the phase is not timed.
+    TrainingMetrics* metrics;
+    //! The phase being timed.
+    Phase phase;
+    //! When the phase started.
+    Clock::time_point start;
+  };
+
+  /**
+   * Create the metrics, with phase timing off and no callback.
+   */
+  TrainingMetrics() : timePhases(false), useTimer(false)
+  {
+    Reset();
+  }
+
+  /**
+   * Set all the counters and times to zero, and restart the clock of the
+   * throughputs.
+   */
+  void Reset()
+  {
+    steps = 0;
+    updates = 0;
+    episodes = 0;
+    lastReturn = 0.0;
+    replayOccupancy = 0;
+    for (size_t p = 0; p < numPhases; ++p)
+    {
+      phaseTimes[p] = Clock::duration::zero();
+      phaseCounts[p] = 0;
+    }
+    start = Clock::now();
+  }
+
+  //! Count the given number of environment steps.
+  void AddSteps(const size_t numSteps = 1) { steps += numSteps; }
+
+  //! Count a learner update.
+  void AddUpdate() { ++updates; }
+
+  /**
+   * Count a finished episode with the given return, and call the callback.
+   *
+   * @param episodeReturn The return of the episode.
+   */
+  void EndEpisode(const double episodeReturn)
+  {
+    ++episodes;
+    lastReturn = episodeReturn;
+    if (callback)
+      callback(*this);
+  }
+
+  //! Get the number of environment steps.
+  size_t Steps() const { return steps; }
+  //! Modify the number of environment steps.
+  size_t& Steps() { return steps; }
+
+  //! Get the number of learner updates.
+  size_t Updates() const { return updates; }
+
+  //! Get the number of finished episodes.
+  size_t Episodes() const { return episodes; }
+
+  //! Get the return of the last finished episode.
+  double LastReturn() const { return lastReturn; }
+
+  //! Get the number of transitions in the replay buffer.
+  size_t ReplayOccupancy() const { return replayOccupancy; }
+  //! Modify the number of transitions in the replay buffer.
+  size_t& ReplayOccupancy() { return replayOccupancy; }
+
+  //! Get the time since the last Reset(), in seconds.
+  double ElapsedTime() const
+  {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  }
+
+  //! Get the number of environment steps per second since the last Reset().
+  double StepsPerSecond() const { return Rate(steps); }
+
+  //! Get the number of learner updates per second since the last Reset().
+  double UpdatesPerSecond() const { return Rate(updates); }
+
+  //! Get the total time spent in the given phase, in seconds.
+  double Time(const Phase phase) const
+  {
+    return std::chrono::duration<double>(phaseTimes[(size_t) phase]).count();
+  }
+
+  //! Get the number of times the given phase was timed.
+  size_t Count(const Phase phase) const { return phaseCounts[(size_t) phase]; }
+
+  //! Get the mean time of a replay sample, in seconds.
+  double MeanReplaySampleTime() const
+  {
+    const size_t count = Count(Phase::replaySample);
+    return (count == 0) ? 0.0 : Time(Phase::replaySample) / count;
+  }
+
+  //! Get whether the phases are timed.
+  bool TimePhases() const { return timePhases; }
+  //! Modify whether the phases are timed.
+  bool& TimePhases() { return timePhases; }
+
+  //! Get whether the phases are also timed with the mlpack Timer.
+  bool UseTimer() const { return useTimer; }
+  //! Modify whether the phases are also timed with the mlpack Timer.
+  bool& UseTimer() { return useTimer; }
+
+  //! Get the callback called at the end of each episode.
+  const std::function<void(const TrainingMetrics&)>& Callback() const
+  { return callback; }
+  //! Modify the callback called at the end of each episode.
+  std::function<void(const TrainingMetrics&)>& Callback() { return callback; }
+
+  //! Get the name of the Timer of the given phase.
+  static const char* TimerName(const Phase phase)
+  {
+    static const char* names[numPhases] = { "rl_environment", "rl_forward",
+        "rl_backward", "rl_update", "rl_replay_sample" };
+    return names[(size_t) phase];
+  }
+
+ private:
+  //! Compute the rate of the given count since the last Reset().
+  double Rate(const size_t count) const
+  {
+    const double elapsed = ElapsedTime();
+    return (elapsed > 0.0) ? count / elapsed : 0.0;
+  }
+
+  //! The number of environment steps.
+  size_t steps;
+
+  //! The number of learner updates.
+  size_t updates;
+
+  //! The number of finished episodes.
+  size_t episodes;
+
+  //! The return of the last finished episode.
+  double lastReturn;
+
+  //! The number of transitions in the replay buffer.
+  size_t replayOccupancy;
+
+  //! The total time spent in each phase.
+  Clock::duration phaseTimes[numPhases];
+
+  //! The number of times each phase was timed.
+  size_t phaseCounts[numPhases];
+
+  //! When the metrics were last reset.
+  Clock::time_point start;
+
+  //! Whether the phases are timed.
+  bool timePhases;
+
+  //! Whether the phases are also timed with the mlpack Timer.
+  bool useTimer;
+
+  //! The callback called at the end of each episode.
+  std::function<void(const TrainingMetrics&)> callback;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -61,7 +61,8 @@ class OneStepQLearningWorker
       environment(environment),
       config(config),
       deterministic(deterministic),
-      pending(config.UpdateInterval())
+      pending(config.UpdateInterval()),
+      targetSequence(0)
   { Reset(); }
 
   /**
@@ -82,6 +83,8 @@ class OneStepQLearningWorker
       pending(other.pending),
       pendingIndex(other.pendingIndex),
       network(other.network),
+      targetNetwork(other.targetNetwork),
+      targetSequence(other.targetSequence),
       state(other.state)
   {
     #if ENS_VERSION_MAJOR >= 2
@@ -112,6 +115,8 @@ class OneStepQLearningWorker
       pending(std::move(other.pending)),
       pendingIndex(std::move(other.pendingIndex)),
       network(std::move(other.network)),
+      targetNetwork(std::move(other.targetNetwork)),
+      targetSequence(other.targetSequence),
       state(std::move(other.state))
   {
     #if ENS_VERSION_MAJOR >= 2
@@ -147,6 +152,8 @@ class OneStepQLearningWorker
     pending = other.pending;
     pendingIndex = other.pendingIndex;
     network = other.network;
+    targetNetwork = other.targetNetwork;
+    targetSequence = other.targetSequence;
     state = other.state;
 
     #if ENS_VERSION_MAJOR >= 2
@@ -184,6 +191,8 @@ class OneStepQLearningWorker
     pending = std::move(other.pending);
     pendingIndex = std::move(other.pendingIndex);
     network = std::move(other.network);
+    targetNetwork = std::move(other.targetNetwork);
+    targetSequence = other.targetSequence;
     state = std::move(other.state);
 
     #if ENS_VERSION_MAJOR >= 2
@@ -226,15 +235,22 @@ class OneStepQLearningWorker
                                      learningNetwork.Parameters().n_cols);
     #endif
 
-    // Build local network.
+    // Build local network, and the snapshot of the target network.
     network = learningNetwork;
+    targetNetwork = learningNetwork;
+    targetSequence = 0;
   }
 
   /**
    * The agent will execute one step.
    *
+   * The shared learning network is read and updated without any lock
+   * (Hogwild!-style), and the targets are computed with a snapshot of it that
+   * is local to the worker, refreshed whenever the shared step counter
+   * crosses a multiple of config.TargetNetworkSyncInterval().  The steps of
+   * the worker are added to the shared counter once per update.
+   *
    * @param learningNetwork The shared learning network.
-   * @param targetNetwork The shared target network.
    * @param totalSteps The shared counter for total steps.
    * @param policy The shared behavior policy.
    * @param totalReward This will be the episode return if the episode ends
@@ -242,7 +258,6 @@ class OneStepQLearningWorker
    * @return Indicate whether current episode ends after this step.
    */
   bool Step(NetworkType& learningNetwork,
-            NetworkType& targetNetwork,
             size_t& totalSteps,
             PolicyType& policy,
             double& totalReward)
@@ -266,21 +281,25 @@ class OneStepQLearningWorker
         totalReward = episodeReturn;
         Reset();
         // Sync with latest learning network.
-        network = learningNetwork;
+        network.Parameters() = learningNetwork.Parameters();
         return true;
       }
       state = nextState;
       return false;
     }
 
-    #pragma omp atomic
-    totalSteps++;
-
     pending[pendingIndex] = std::make_tuple(state, action, reward, nextState);
     pendingIndex++;
 
     if (terminal || pendingIndex >= config.UpdateInterval())
     {
+      // Count the steps since the last update in the shared counter, and
+      // refresh the target network if it was synced since.
+      size_t globalSteps;
+      #pragma omp atomic capture
+      globalSteps = totalSteps += pendingIndex;
+      SyncTargetNetwork(learningNetwork, globalSteps);
+
       // Initialize the gradient storage.
       arma::mat totalGradients(learningNetwork.Parameters().n_rows,
           learningNetwork.Parameters().n_cols, arma::fill::zeros);
@@ -290,11 +309,7 @@ class OneStepQLearningWorker
 
         // Compute the target state-action value.
         arma::colvec actionValue;
-        #pragma omp critical
-        {
-          targetNetwork.Predict(
-              std::get<3>(transition).Encode(), actionValue);
-        };
+        targetNetwork.Predict(std::get<3>(transition).Encode(), actionValue);
         double targetActionValue = actionValue.max();
         if (terminal && i == pending.size() - 1)
           targetActionValue = 0;
@@ -330,18 +345,11 @@ class OneStepQLearningWorker
       #endif
 
       // Sync the local network with the global network.
-      network = learningNetwork;
+      network.Parameters() = learningNetwork.Parameters();
 
       pendingIndex = 0;
     }
 
-    // Update global target network.
-    if (totalSteps % config.TargetNetworkSyncInterval() == 0)
-    {
-      #pragma omp critical
-      { targetNetwork = learningNetwork; }
-    }
-
     policy.Anneal();
 
     if (terminal)
@@ -355,6 +363,24 @@ class OneStepQLearningWorker
   }
 
  private:
+  /**
+   * Copy the parameters of the shared learning network to the target network
+   * if the shared step counter crossed a multiple of the sync interval since
+   * the last copy.
+   *
+   * @param learningNetwork The shared learning network.
+   * @param totalSteps The value of the shared step counter.
+   */
+  void SyncTargetNetwork(NetworkType& learningNetwork, const size_t totalSteps)
+  {
+    const size_t sequence = totalSteps / config.TargetNetworkSyncInterval();
+    if (sequence != targetSequence)
+    {
+      targetNetwork.Parameters() = learningNetwork.Parameters();
+      targetSequence = sequence;
+    }
+  }
+
   /**
    * Reset the worker for a new episode.
    */
@@ -396,6 +422,12 @@ class OneStepQLearningWorker
   //! Local network of the worker.
   NetworkType network;
 
+  //! Local snapshot of the learning network used to compute the targets.
+  NetworkType targetNetwork;
+
+  //! Number of target network syncs the snapshot corresponds to.
+  size_t targetSequence;
+
   //! Current state of the agent.
   StateType state;
 };
@@ -32,29 +32,15 @@ void SoftmaxRegression::Classify(const arma::mat& dataset,
     const
 {
   arma::mat probabilities;
-  Classify(dataset, probabilities);
-
-  // Prepare necessary data.
-  labels.zeros(dataset.n_cols);
-  double maxProbability = 0;
-
-  // For each test input.
-  for (size_t i = 0; i < dataset.n_cols; ++i)
-  {
-    // For each class.
-    for (size_t j = 0; j < numClasses; ++j)
-    {
-      // If a higher class probability is encountered, change prediction.
-      if (probabilities(j, i) > maxProbability)
-      {
-        maxProbability = probabilities(j, i);
-        labels(i) = j;
-      }
-    }
+  Classify(dataset, labels, probabilities);
+}
 
-    // Set maximum probability to zero for the next input.
-    maxProbability = 0;
-  }
+void SoftmaxRegression::Classify(const arma::sp_mat& dataset,
+                                 arma::Row<size_t>& labels)
+    const
+{
+  arma::mat probabilities;
+  Classify(dataset, labels, probabilities);
 }
 
 void SoftmaxRegression::Classify(const arma::mat& dataset,
@@ -62,59 +48,31 @@ void SoftmaxRegression::Classify(const arma::mat& dataset,
                                  arma::mat& probabilities)
     const
 {
-  Classify(dataset, probabilities);
-
-  // Prepare necessary data.
-  labels.zeros(dataset.n_cols);
-  double maxProbability = 0;
-
-  // For each test input.
-  for (size_t i = 0; i < dataset.n_cols; ++i)
-  {
-    // For each class.
-    for (size_t j = 0; j < numClasses; ++j)
-    {
-      // If a higher class probability is encountered, change prediction.
-      if (probabilities(j, i) > maxProbability)
-      {
-        maxProbability = probabilities(j, i);
-        labels(i) = j;
-      }
-    }
+  Probabilities(dataset, probabilities);
+  MostProbable(probabilities, labels);
+}
 
-    // Set maximum probability to zero for the next input.
-    maxProbability = 0;
-  }
+void SoftmaxRegression::Classify(const arma::sp_mat& dataset,
+                                 arma::Row<size_t>& labels,
+                                 arma::mat& probabilities)
+    const
+{
+  Probabilities(dataset, probabilities);
+  MostProbable(probabilities, labels);
 }
 
 void SoftmaxRegression::Classify(const arma::mat& dataset,
                                  arma::mat& probabilities)
     const
 {
-  util::CheckSameDimensionality(dataset, FeatureSize(),
-      "SoftmaxRegression::Classify()");
-
-  // Calculate the probabilities for each test input.
-  arma::mat hypothesis;
-  if (fitIntercept)
-  {
-    // In order to add the intercept term, we should compute following matrix:
-    //     [1; data] = arma::join_cols(ones(1, data.n_cols), data)
-    //     hypothesis = arma::exp(parameters * [1; data]).
-    //
-    // Since the cost of join maybe high due to the copy of original data,
-    // split the hypothesis computation to two components.
-    hypothesis = arma::exp(
-      arma::repmat(parameters.col(0), 1, dataset.n_cols) +
-      parameters.cols(1, parameters.n_cols - 1) * dataset);
-  }
-  else
-  {
-    hypothesis = arma::exp(parameters * dataset);
-  }
+  Probabilities(dataset, probabilities);
+}
 
-  probabilities = hypothesis / arma::repmat(arma::sum(hypothesis, 0),
-                                            numClasses, 1);
+void SoftmaxRegression::Classify(const arma::sp_mat& dataset,
+                                 arma::mat& probabilities)
+    const
+{
+  Probabilities(dataset, probabilities);
 }
 
 double SoftmaxRegression::ComputeAccuracy(
@@ -136,5 +94,42 @@ double SoftmaxRegression::ComputeAccuracy(
   return (count * 100.0) / predictions.n_elem;
 }
 
+double SoftmaxRegression::ComputeAccuracy(
+    const arma::sp_mat& testData,
+    const arma::Row<size_t>& labels) const
+{
+  arma::Row<size_t> predictions;
+  Classify(testData, predictions);
+
+  // Return percentage accuracy.
+  return (arma::accu(predictions == labels) * 100.0) / predictions.n_elem;
+}
+
+void SoftmaxRegression::MostProbable(const arma::mat& probabilities,
+                                     arma::Row<size_t>& labels) const
+{
+  // Prepare necessary data.
+  labels.zeros(probabilities.n_cols);
+  double maxProbability = 0;
+
+  // For each test input.
+  for (size_t i = 0; i < probabilities.n_cols; ++i)
+  {
+    // For each class.
+    for (size_t j = 0; j < numClasses; ++j)
+    {
+      // If a higher class probability is encountered, change prediction.
+      if (probabilities(j, i) > maxProbability)
+      {
+        maxProbability = probabilities(j, i);
+        labels(i) = j;
+      }
+    }
+
+    // Set maximum probability to zero for the next input.
+    maxProbability = 0;
+  }
+}
+
 } // namespace regression
 } // namespace mlpack
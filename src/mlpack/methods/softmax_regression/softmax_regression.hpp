@@ -78,6 +78,7 @@ class SoftmaxRegression
    * function. By default, the model takes a small value.
    *
    * @tparam OptimizerType Desired optimizer type.
+   * @tparam MatType Type of the data (arma::mat or arma::sp_mat).
    * @param data Input training features. Each column associate with one sample
    * @param labels Labels associated with the feature data.
    * @param numClasses Number of classes for classification.
@@ -85,8 +86,8 @@ class SoftmaxRegression
    * @param lambda L2-regularization constant.
    * @param fitIntercept add intercept term or not.
    */
-  template<typename OptimizerType = ens::L_BFGS>
-  SoftmaxRegression(const arma::mat& data,
+  template<typename OptimizerType = ens::L_BFGS, typename MatType = arma::mat>
+  SoftmaxRegression(const MatType& data,
                     const arma::Row<size_t>& labels,
                     const size_t numClasses,
                     const double lambda = 0.0001,
@@ -99,6 +100,7 @@ class SoftmaxRegression
    * function. By default, the model takes a small value.
    *
    * @tparam OptimizerType Desired optimizer type.
+   * @tparam MatType Type of the data (arma::mat or arma::sp_mat).
    * @tparam CallbackTypes Types of Callback Functions.
    * @param data Input training features. Each column associate with one sample
    * @param labels Labels associated with the feature data.
@@ -109,8 +111,8 @@ class SoftmaxRegression
    * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
    *        See https://www.ensmallen.org/docs.html#callback-documentation.
    */
-  template<typename OptimizerType, typename... CallbackTypes>
-  SoftmaxRegression(const arma::mat& data,
+  template<typename OptimizerType, typename MatType, typename... CallbackTypes>
+  SoftmaxRegression(const MatType& data,
                     const arma::Row<size_t>& labels,
                     const size_t numClasses,
                     const double lambda,
@@ -126,6 +128,15 @@ class SoftmaxRegression
    * @param labels Predicted labels for each point.
    */
   void Classify(const arma::mat& dataset, arma::Row<size_t>& labels) const;
+
+  /**
+   * Classify the given sparse points, returning the predicted labels for each
+   * point.
+   *
+   * @param dataset Set of points to classify.
+   * @param labels Predicted labels for each point.
+   */
+  void Classify(const arma::sp_mat& dataset, arma::Row<size_t>& labels) const;
   /**
    * Classify the given point. The predicted class label is returned.
    * The function calculates the probabilites for every class, given the point.
@@ -151,6 +162,18 @@ class SoftmaxRegression
                 arma::Row<size_t>& labels,
                 arma::mat& probabilities) const;
 
+  /**
+   * Classify the given sparse points, returning class probabilities and
+   * predicted class label for each point.
+   *
+   * @param dataset Matrix of data points to be classified.
+   * @param labels Predicted labels for each point.
+   * @param probabilities Class probabilities for each point.
+   */
+  void Classify(const arma::sp_mat& dataset,
+                arma::Row<size_t>& labels,
+                arma::mat& probabilities) const;
+
   /**
    * Classify the given points, returning class probabilities for each point.
    *
@@ -160,6 +183,16 @@ class SoftmaxRegression
   void Classify(const arma::mat& dataset,
                 arma::mat& probabilities) const;
 
+  /**
+   * Classify the given sparse points, returning class probabilities for each
+   * point.  The points are not densified.
+   *
+   * @param dataset Matrix of data points to be classified.
+   * @param probabilities Class probabilities for each point.
+   */
+  void Classify(const arma::sp_mat& dataset,
+                arma::mat& probabilities) const;
+
   /**
    * Computes accuracy of the learned model given the feature data and the
    * labels associated with each data point. Predictions are made using the
@@ -170,18 +203,29 @@ class SoftmaxRegression
    */
   double ComputeAccuracy(const arma::mat& testData,
                          const arma::Row<size_t>& labels) const;
+
+  /**
+   * Computes accuracy of the learned model given sparse feature data and the
+   * labels associated with each data point.
+   *
+   * @param testData Matrix of data points using which predictions are made.
+   * @param labels Vector of labels associated with the data.
+   */
+  double ComputeAccuracy(const arma::sp_mat& testData,
+                         const arma::Row<size_t>& labels) const;
   /**
    * Train the softmax regression with the given training data.
    *
    * @tparam OptimizerType Desired optimizer type.
+   * @tparam MatType Type of the data (arma::mat or arma::sp_mat).
    * @param data Input data with each column as one example.
    * @param labels Labels associated with the feature data.
    * @param numClasses Number of classes for classification.
    * @param optimizer Desired optimizer.
    * @return Objective value of the final point.
    */
-  template<typename OptimizerType = ens::L_BFGS>
-  double Train(const arma::mat& data,
+  template<typename OptimizerType = ens::L_BFGS, typename MatType = arma::mat>
+  double Train(const MatType& data,
                const arma::Row<size_t>& labels,
                const size_t numClasses,
                OptimizerType optimizer = OptimizerType());
@@ -189,6 +233,7 @@ class SoftmaxRegression
    * Train the softmax regression with the given training data.
    *
    * @tparam OptimizerType Desired optimizer type.
+   * @tparam MatType Type of the data (arma::mat or arma::sp_mat).
    * @tparam CallbackTypes Types of Callback Functions.
    * @param data Input data with each column as one example.
    * @param labels Labels associated with the feature data.
@@ -198,8 +243,10 @@ class SoftmaxRegression
    *      See https://www.ensmallen.org/docs.html#callback-documentation.
    * @return Objective value of the final point.
    */
-  template<typename OptimizerType = ens::L_BFGS, typename... CallbackTypes>
-  double Train(const arma::mat& data,
+  template<typename OptimizerType = ens::L_BFGS,
+           typename MatType = arma::mat,
+           typename... CallbackTypes>
+  double Train(const MatType& data,
                const arma::Row<size_t>& labels,
                const size_t numClasses,
                OptimizerType optimizer,
@@ -241,6 +288,18 @@ class SoftmaxRegression
   }
 
  private:
+  /**
+   * Compute the class probabilities of the given dense or sparse points.
+   */
+  template<typename MatType>
+  void Probabilities(const MatType& dataset, arma::mat& probabilities) const;
+
+  /**
+   * Select the most probable class of each point.
+   */
+  void MostProbable(const arma::mat& probabilities,
+                    arma::Row<size_t>& labels) const;
+
   //! Parameters after optimization.
   arma::mat parameters;
   //! Number of classes.
@@ -18,9 +18,9 @@
 namespace mlpack {
 namespace regression {
 
-template<typename OptimizerType>
+template<typename OptimizerType, typename MatType>
 SoftmaxRegression::SoftmaxRegression(
-    const arma::mat& data,
+    const MatType& data,
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const double lambda,
@@ -33,9 +33,9 @@ SoftmaxRegression::SoftmaxRegression(
   Train(data, labels, numClasses, optimizer);
 }
 
-template<typename OptimizerType, typename... CallbackTypes>
+template<typename OptimizerType, typename MatType, typename... CallbackTypes>
 SoftmaxRegression::SoftmaxRegression(
-    const arma::mat& data,
+    const MatType& data,
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const double lambda,
@@ -57,14 +57,14 @@ size_t SoftmaxRegression::Classify(const VecType& point) const
   return size_t(label(0));
 }
 
-template<typename OptimizerType>
-double SoftmaxRegression::Train(const arma::mat& data,
+template<typename OptimizerType, typename MatType>
+double SoftmaxRegression::Train(const MatType& data,
                                 const arma::Row<size_t>& labels,
                                 const size_t numClasses,
                                 OptimizerType optimizer)
 {
-  SoftmaxRegressionFunction regressor(data, labels, numClasses, lambda,
-                                      fitIntercept);
+  SoftmaxRegressionFunctionType<MatType> regressor(data, labels, numClasses,
+      lambda, fitIntercept);
   if (parameters.n_elem != regressor.GetInitialPoint().n_elem)
     parameters = regressor.GetInitialPoint();
 
@@ -77,15 +77,15 @@ double SoftmaxRegression::Train(const arma::mat& data,
   return out;
 }
 
-template<typename OptimizerType, typename... CallbackTypes>
-double SoftmaxRegression::Train(const arma::mat& data,
+template<typename OptimizerType, typename MatType, typename... CallbackTypes>
+double SoftmaxRegression::Train(const MatType& data,
                                 const arma::Row<size_t>& labels,
                                 const size_t numClasses,
                                 OptimizerType optimizer,
                                 CallbackTypes&&... callbacks)
 {
-  SoftmaxRegressionFunction regressor(data, labels, numClasses, lambda,
-                                      fitIntercept);
+  SoftmaxRegressionFunctionType<MatType> regressor(data, labels, numClasses,
+      lambda, fitIntercept);
   if (parameters.n_elem != regressor.GetInitialPoint().n_elem)
     parameters = regressor.GetInitialPoint();
 
@@ -98,6 +98,40 @@ double SoftmaxRegression::Train(const arma::mat& data,
   return out;
 }
 
+template<typename MatType>
+void SoftmaxRegression::Probabilities(const MatType& dataset,
+                                      arma::mat& probabilities) const
+{
+  util::CheckSameDimensionality(dataset, FeatureSize(),
+      "SoftmaxRegression::Classify()");
+
+  // Calculate the probabilities for each test input.
+  arma::mat hypothesis;
+  if (fitIntercept)
+  {
+    // In order to add the intercept term, we should compute following matrix:
+    //     [1; data] = arma::join_cols(ones(1, data.n_cols), data)
+    //     hypothesis = arma::exp(parameters * [1; data]).
+    //
+    // Since the cost of join maybe high due to the copy of original data,
+    // split the hypothesis computation to two components.  The columns of the
+    // parameters after the intercept are contiguous, so they are used without
+    // a copy.
+    const arma::mat weights(const_cast<double*>(parameters.colptr(1)),
+        parameters.n_rows, parameters.n_cols - 1, false, true);
+    math::MultiplyColumns(weights, dataset, 0, dataset.n_cols, hypothesis);
+    hypothesis.each_col() += parameters.col(0);
+  }
+  else
+  {
+    math::MultiplyColumns(parameters, dataset, 0, dataset.n_cols, hypothesis);
+  }
+
+  hypothesis = arma::exp(hypothesis);
+  probabilities = hypothesis / arma::repmat(arma::sum(hypothesis, 0),
+                                            numClasses, 1);
+}
+
 } // namespace regression
 } // namespace mlpack
 
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_SPARSE_AUTOENCODER_SPARSE_AUTOENCODER_FUNCTION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/make_alias.hpp>
 
 namespace mlpack {
 namespace nn {
@@ -22,8 +23,21 @@ namespace nn {
  * This is a class for the sparse autoencoder objective function. It can be used
  * to create learning models like self-taught learning, stacked autoencoders,
  * conditional random fields (CRFs), and so forth.
+ *
+ * The objective can be evaluated together with its gradient in a single
+ * forward pass, and it is separable over the data points, so it can be
+ * optimized with L-BFGS as well as with minibatch optimizers such as SGD.  For
+ * a minibatch, the reconstruction error is that of its points, the weight
+ * decay and the KL divergence are scaled by the fraction of the points in the
+ * minibatch, and the average activations of the hidden layer are estimated
+ * from the minibatch only.  The activations are kept between calls, so a
+ * function object must not be evaluated from several threads at once.
+ *
+ * @tparam MatType Type of the data and the parameters (arma::mat or
+ *     arma::fmat).
  */
-class SparseAutoencoderFunction
+template<typename MatType = arma::mat>
+class SparseAutoencoderFunctionType
 {
  public:
   /**
@@ -37,15 +51,18 @@ class SparseAutoencoderFunction
    * @param beta KL divergence parameter.
    * @param rho Sparsity parameter.
    */
-  SparseAutoencoderFunction(const arma::mat& data,
-                            const size_t visibleSize,
-                            const size_t hiddenSize,
-                            const double lambda = 0.0001,
-                            const double beta = 3,
-                            const double rho = 0.01);
+  SparseAutoencoderFunctionType(const MatType& data,
+                                const size_t visibleSize,
+                                const size_t hiddenSize,
+                                const double lambda = 0.0001,
+                                const double beta = 3,
+                                const double rho = 0.01);
 
   //! Initializes the parameters of the model to suitable values.
-  const arma::mat InitializeWeights();
+  const MatType InitializeWeights();
+
+  //! Shuffle the data points.
+  void Shuffle();
 
   /**
    * Evaluates the objective function of the sparse autoencoder model using the
@@ -57,7 +74,20 @@ class SparseAutoencoderFunction
    *
    * @param parameters Current values of the model parameters.
    */
-  double Evaluate(const arma::mat& parameters) const;
+  double Evaluate(const MatType& parameters) const;
+
+  /**
+   * Evaluate the objective function on a minibatch of the data points.  The
+   * sum of the objectives of the minibatches of an epoch approximates the
+   * objective on all points (it is exact without the KL divergence term).
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin First point of the minibatch.
+   * @param batchSize Number of points in the minibatch.
+   */
+  double Evaluate(const MatType& parameters,
+                  const size_t begin,
+                  const size_t batchSize = 1) const;
 
   /**
    * Evaluates the gradient values of the objective function given the current
@@ -68,7 +98,45 @@ class SparseAutoencoderFunction
    * @param parameters Current values of the model parameters.
    * @param gradient Matrix where gradient values will be stored.
    */
-  void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
+  void Gradient(const MatType& parameters, MatType& gradient) const;
+
+  /**
+   * Evaluate the gradient of the objective function on a minibatch of the data
+   * points.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin First point of the minibatch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of points in the minibatch.
+   */
+  void Gradient(const MatType& parameters,
+                const size_t begin,
+                MatType& gradient,
+                const size_t batchSize = 1) const;
+
+  /**
+   * Evaluate the objective function and its gradient with a single forward
+   * pass over the data.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param gradient Matrix where gradient values will be stored.
+   */
+  double EvaluateWithGradient(const MatType& parameters,
+                              MatType& gradient) const;
+
+  /**
+   * Evaluate the objective function and its gradient on a minibatch of the
+   * data points, with a single forward pass over the minibatch.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin First point of the minibatch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of points in the minibatch.
+   */
+  double EvaluateWithGradient(const MatType& parameters,
+                              const size_t begin,
+                              MatType& gradient,
+                              const size_t batchSize = 1) const;
 
   /**
    * Returns the elementwise sigmoid of the passed matrix, where the sigmoid
@@ -77,13 +145,16 @@ class SparseAutoencoderFunction
    * @param x Matrix of real values for which we require the sigmoid activation.
    * @param output Output matrix.
    */
-  void Sigmoid(const arma::mat& x, arma::mat& output) const
+  void Sigmoid(const MatType& x, MatType& output) const
   {
     output = (1.0 / (1 + arma::exp(-x)));
   }
 
   //! Return the initial point for the optimization.
-  const arma::mat& GetInitialPoint() const { return initialPoint; }
+  const MatType& GetInitialPoint() const { return initialPoint; }
+
+  //! Return the number of separable functions (the number of data points).
+  size_t NumFunctions() const { return data.n_cols; }
 
   //! Sets size of the visible layer.
   void VisibleSize(const size_t visible)
@@ -146,10 +217,23 @@ class SparseAutoencoderFunction
   }
 
  private:
-  //! The matrix of data points.
-  const arma::mat& data;
+  //! The element type of the data and the parameters.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Compute the activations of the hidden and output layers for a minibatch,
+   * and the reconstruction error, and return the objective on the minibatch.
+   * The difference between the reconstruction and the minibatch is left in
+   * delOut.
+   */
+  double Forward(const MatType& parameters,
+                 const size_t begin,
+                 const size_t batchSize) const;
+
+  //! The matrix of data points.  This is an alias until it is shuffled.
+  MatType data;
   //! Initial parameter vector.
-  arma::mat initialPoint;
+  MatType initialPoint;
   //! Size of the visible layer.
   size_t visibleSize;
   //! Size of the hidden layer.
@@ -160,9 +244,26 @@ class SparseAutoencoderFunction
   double beta;
   //! Sparsity parameter.
   double rho;
+
+  //! Activations of the hidden layer for the last minibatch.
+  mutable MatType hiddenLayer;
+  //! Activations of the output layer for the last minibatch.
+  mutable MatType outputLayer;
+  //! Average activations of the hidden layer for the last minibatch.
+  mutable arma::Col<ElemType> rhoCap;
+  //! Delta values of the output layer for the last minibatch.
+  mutable MatType delOut;
+  //! Delta values of the hidden layer for the last minibatch.
+  mutable MatType delHid;
 };
 
+//! The sparse autoencoder objective function on double-precision data.
+using SparseAutoencoderFunction = SparseAutoencoderFunctionType<arma::mat>;
+
 } // namespace nn
 } // namespace mlpack
 
+// Include implementation.
+#include "sparse_autoencoder_function_impl.hpp"
+
 #endif
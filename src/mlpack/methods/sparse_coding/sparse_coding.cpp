@@ -36,27 +36,39 @@ SparseCoding::SparseCoding(
 void SparseCoding::Encode(const arma::mat& data, arma::mat& codes)
 {
   // When using the Cholesky version of LARS, this is correct even if
-  // lambda2 > 0.
+  // lambda2 > 0.  It is shared by the solvers of all the points.
   arma::mat matGram = trans(dictionary) * dictionary;
 
   codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-  {
-    // Report progress.
-    if ((i % 100) == 0)
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
 
+  // The points are coded independently, so they are split across threads; each
+  // thread reuses one LARS object for all of its points.
+  #pragma omp parallel
+  {
     bool useCholesky = true;
     regression::LARS lars(useCholesky, matGram, lambda1, lambda2);
+    arma::rowvec responses(data.n_rows);
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    {
+      // Report progress.
+      if ((i % 100) == 0)
+      {
+        #pragma omp critical
+        Log::Debug << "Optimization at point " << i << "." << std::endl;
+      }
 
-    // Create an alias of the code (using the same memory), and then LARS will
-    // place the result directly into that; then we will not need to have an
-    // extra copy.
-    arma::vec code = codes.unsafe_col(i);
-    arma::rowvec responses = data.unsafe_col(i).t();
-    lars.Train(dictionary, responses, code, false);
+      // Create an alias of the code (using the same memory), and then LARS
+      // will place the result directly into that; then we will not need to
+      // have an extra copy.
+      arma::vec code = codes.unsafe_col((size_t) i);
+      responses = data.col((size_t) i).t();
+      lars.Train(dictionary, responses, code, false);
+    }
   }
 }
+}
 
 // Dictionary step for optimization.
 double SparseCoding::OptimizeDictionary(const arma::mat& data,
@@ -15,6 +15,7 @@
 
 #include "svdplusplus_function.hpp"
 #include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/methods/regularized_svd/rating_blocks.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -402,10 +403,6 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
   double overallObjective = DBL_MAX;
   double lastObjective;
 
-  // The order in which the functions will be visited.
-  arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
-      (function.NumFunctions() - 1), function.NumFunctions());
-
   const arma::mat data = function.Dataset();
   const arma::sp_mat implicitData = function.ImplicitDataset();
   const size_t numUsers = function.NumUsers();
@@ -415,6 +412,13 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
   // Rank of decomposition.
   const size_t rank = function.Rank();
 
+  // Threads update disjoint blocks of users and items, so the explicit factors
+  // and biases need no synchronization.  The implicit item vectors of a user
+  // may belong to the items of any block, so several threads may update the
+  // same implicit vector at once; those vectors are read and updated with
+  // atomic operations.
+  mlpack::svd::RatingBlocks blocks(data, numUsers, numItems);
+
   // Iterate till the objective is within tolerance or the maximum number of
   // allowed iterations is reached. If maxIterations is 0, this will iterate
   // till convergence.
@@ -453,100 +457,81 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
     double stepSize = decayPolicy.StepSize(i);
 
     if (shuffle) // Determine order of visitation.
-      std::shuffle(visitationOrder.begin(), visitationOrder.end(),
-          mlpack::math::randGen);
+      blocks.Shuffle();
 
-    #pragma omp parallel
+    blocks.Visit([&](const size_t j)
     {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize.
-      size_t threadId = 0;
-      #ifdef HAS_OPENMP
-        threadId = omp_get_thread_num();
-      #endif
-
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
+      // Indices for accessing the the correct parameter columns.
+      const size_t user = data(0, j);
+      const size_t item = data(1, j) + numUsers;
+      const size_t implicitStart = numUsers + numItems;
+
+      // Prediction error for the example.
+      const double rating = data(2, j);
+      const double userBias = iterate(rank, user);
+      const double itemBias = iterate(rank, item);
+      // Iterate through each item which the user interacted with to calculate
+      // user vector.
+      arma::vec userVec(rank, arma::fill::zeros);
+      arma::sp_mat::const_iterator it = implicitData.begin_col(user);
+      arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
+      size_t implicitCount = 0;
+      for (; it != it_end; ++it)
       {
-        // Indices for accessing the the correct parameter columns.
-        const size_t user = data(0, visitationOrder[j]);
-        const size_t item = data(1, visitationOrder[j]) + numUsers;
-        const size_t implicitStart = numUsers + numItems;
-
-        // Prediction error for the example.
-        const double rating = data(2, visitationOrder[j]);
-        const double userBias = iterate(rank, user);
-        const double itemBias = iterate(rank, item);
-        // Iterate through each item which the user interacted with to calculate
-        // user vector.
-        arma::vec userVec(rank, arma::fill::zeros);
-        arma::sp_mat::const_iterator it = implicitData.begin_col(user);
-        arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
-        size_t implicitCount = 0;
-        for (; it != it_end; ++it)
-        {
-          userVec += iterate.col(implicitStart + it.row()).subvec(0, rank - 1);
-          implicitCount += 1;
-        }
-        if (implicitCount != 0)
-          userVec /= std::sqrt(implicitCount);
-        userVec += iterate.col(user).subvec(0, rank - 1);
-
-        double ratingError = rating - userBias - itemBias -
-        arma::dot(userVec, iterate.col(item).subvec(0, rank - 1));
-
-        arma::mat userVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(user).subvec(0, rank - 1) -
-            ratingError * iterate.col(item).subvec(0, rank - 1));
-        arma::mat itemVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(item).subvec(0, rank - 1) -
-            ratingError * userVec);
-        double userBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, user) - ratingError);
-        double itemBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, item) - ratingError);
-
-        // Update of item implicit vectors.
-        arma::mat itemImplicitUpdate(rank, implicitCount);
-        arma::Col<size_t> implicitItems(implicitCount);
-        it = implicitData.begin_col(user);
-        it_end = implicitData.end_col(user);
-        size_t implicitIndex = 0;
-        for (; it != it_end; ++it, ++implicitIndex)
+        const size_t implicitCol = implicitStart + it.row();
+        for (size_t k = 0; k < rank; ++k)
         {
-          itemImplicitUpdate.col(implicitIndex) =
-              stepSize * 2.0 * (lambda / implicitCount *
-              iterate.col(implicitStart + it.row()).subvec(0, rank - 1) -
-              ratingError / std::sqrt(implicitCount) *
-              iterate.col(item).subvec(0, rank - 1));
-          implicitItems(implicitIndex) = it.row();
+          double value;
+          #pragma omp atomic read
+          value = iterate(k, implicitCol);
+          userVec[k] += value;
         }
-
-        // Gradient is non-zero only for the parameter columns corresponding to
-        // the example.
-        for (size_t i = 0; i < rank; ++i)
+        implicitCount += 1;
+      }
+      if (implicitCount != 0)
+        userVec /= std::sqrt(implicitCount);
+      userVec += iterate.col(user).subvec(0, rank - 1);
+
+      const double ratingError = rating - userBias - itemBias -
+          arma::dot(userVec, iterate.col(item).subvec(0, rank - 1));
+
+      const arma::vec userVecUpdate = stepSize * 2 * (
+          lambda * iterate.col(user).subvec(0, rank - 1) -
+          ratingError * iterate.col(item).subvec(0, rank - 1));
+      const arma::vec itemVecUpdate = stepSize * 2 * (
+          lambda * iterate.col(item).subvec(0, rank - 1) -
+          ratingError * userVec);
+      const double userBiasUpdate = stepSize * 2 * (
+          lambda * iterate(rank, user) - ratingError);
+      const double itemBiasUpdate = stepSize * 2 * (
+          lambda * iterate(rank, item) - ratingError);
+
+      // Update of item implicit vectors; this uses the item vector before its
+      // own update.
+      it = implicitData.begin_col(user);
+      for (; it != it_end; ++it)
+      {
+        const size_t implicitCol = implicitStart + it.row();
+        for (size_t k = 0; k < rank; ++k)
         {
+          double value;
+          #pragma omp atomic read
+          value = iterate(k, implicitCol);
+          const double update = stepSize * 2.0 * (lambda / implicitCount *
+              value - ratingError / std::sqrt(implicitCount) *
+              iterate(k, item));
           #pragma omp atomic
-          iterate(i, user) -= userVecUpdate(i);
-          #pragma omp atomic
-          iterate(i, item) -= itemVecUpdate(i);
-        }
-        #pragma omp atomic
-        iterate(rank, user) -= userBiasUpdate;
-        #pragma omp atomic
-        iterate(rank, item) -= itemBiasUpdate;
-        for (size_t k = 0; k < implicitCount; ++k)
-        {
-          for (size_t i = 0; i < rank; ++i)
-          {
-            #pragma omp atomic
-            iterate(i, implicitStart + implicitItems(k)) -=
-                itemImplicitUpdate(i, k);
-          }
+          iterate(k, implicitCol) -= update;
         }
       }
-    }
+
+      // Gradient is non-zero only for the parameter columns corresponding to
+      // the example.
+      iterate.col(user).subvec(0, rank - 1) -= userVecUpdate;
+      iterate.col(item).subvec(0, rank - 1) -= itemVecUpdate;
+      iterate(rank, user) -= userBiasUpdate;
+      iterate(rank, item) -= itemBiasUpdate;
+    });
   }
   mlpack::Log::Info << "\n Parallel SGD terminated with objective : "
       << overallObjective << std::endl;
@@ -0,0 +1,92 @@
+/**
+ * @file methods/xgboost/feature_binner.hpp
+ *
+ * Definition of the FeatureBinner class, which maps each dimension of a
+ * dataset to at most 256 bins, for the histogram-based gradient boosted trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_FEATURE_BINNER_HPP
+#define MLPACK_METHODS_XGBOOST_FEATURE_BINNER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ensemble {
+
+/**
+ * The FeatureBinner finds, for each dimension of a dataset, a sorted set of at
+ * most maximumBins - 1 thresholds (quantiles of the values of the dimension),
+ * and maps each value to the index of its bin: the number of thresholds that
+ * are smaller than the value.  A value x is then in a bin less than or equal
+ * to b if and only if x <= Thresholds(dimension)[b], so a split on bin indices
+ * is the same as a split on the original values.
+ *
+ * Since there are at most 256 bins, a binned dataset is stored with one byte
+ * per value, and the histograms of the gradients have at most 256 entries per
+ * dimension.
+ */
+class FeatureBinner
+{
+ public:
+  //! Create an empty binner; Train() must be called before Transform().
+  FeatureBinner() { }
+
+  /**
+   * Find the thresholds of each dimension of the given dataset.
+   *
+   * @param data Dataset to find the thresholds of (column-major).
+   * @param maximumBins Maximum number of bins of each dimension (at most 256).
+   */
+  template<typename MatType>
+  FeatureBinner(const MatType& data, const size_t maximumBins = 256);
+
+  /**
+   * Find the thresholds of each dimension of the given dataset.
+   *
+   * @param data Dataset to find the thresholds of (column-major).
+   * @param maximumBins Maximum number of bins of each dimension (at most 256).
+   */
+  template<typename MatType>
+  void Train(const MatType& data, const size_t maximumBins = 256);
+
+  /**
+   * Map each value of the given dataset to its bin.
+   *
+   * @param data Dataset to bin; it must have Dimensionality() rows.
+   * @param bins Matrix to store the bin of each value in.
+   */
+  template<typename MatType>
+  void Transform(const MatType& data, arma::Mat<unsigned char>& bins) const;
+
+  //! Get the number of dimensions the binner was trained on.
+  size_t Dimensionality() const { return thresholds.size(); }
+  //! Get the number of bins of the given dimension.
+  size_t NumBins(const size_t dimension) const
+  { return thresholds[dimension].n_elem + 1; }
+  //! Get the thresholds of the given dimension.
+  const arma::vec& Thresholds(const size_t dimension) const
+  { return thresholds[dimension]; }
+
+  //! Serialize the binner.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(thresholds));
+  }
+
+ private:
+  //! The sorted thresholds of each dimension.
+  std::vector<arma::vec> thresholds;
+};
+
+} // namespace ensemble
+} // namespace mlpack
+
+// Include implementation.
+#include "feature_binner_impl.hpp"
+
+#endif
@@ -0,0 +1,103 @@
+/**
+ * @file methods/xgboost/feature_binner_impl.hpp
+ *
+ * Implementation of the FeatureBinner class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_FEATURE_BINNER_IMPL_HPP
+#define MLPACK_METHODS_XGBOOST_FEATURE_BINNER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "feature_binner.hpp"
+
+namespace mlpack {
+namespace ensemble {
+
+template<typename MatType>
+FeatureBinner::FeatureBinner(const MatType& data, const size_t maximumBins)
+{
+  Train(data, maximumBins);
+}
+
+template<typename MatType>
+void FeatureBinner::Train(const MatType& data, const size_t maximumBins)
+{
+  if (maximumBins < 2 || maximumBins > 256)
+  {
+    throw std::invalid_argument("FeatureBinner::Train(): the maximum number "
+        "of bins must be between 2 and 256");
+  }
+
+  if (data.n_cols == 0)
+  {
+    throw std::invalid_argument("FeatureBinner::Train(): the dataset has no "
+        "points");
+  }
+
+  thresholds.clear();
+  thresholds.resize(data.n_rows);
+  for (size_t d = 0; d < data.n_rows; ++d)
+  {
+    const arma::vec values = arma::sort(
+        arma::conv_to<arma::vec>::from(data.row(d)));
+    const arma::vec uniqueValues = arma::unique(values);
+
+    // If there are few enough distinct values, each of them gets its own bin.
+    if (uniqueValues.n_elem <= maximumBins)
+    {
+      thresholds[d] = uniqueValues.head(uniqueValues.n_elem - 1);
+      continue;
+    }
+
+    // Otherwise the thresholds are the quantiles of the values.  Repeated
+    // quantiles (of values that occur many times) are only kept once, and
+    // the largest value is never a threshold, since that would leave the last
+    // bin empty.
+    std::vector<double> quantiles;
+    for (size_t k = 1; k < maximumBins; ++k)
+    {
+      const double value = values[(k * values.n_elem) / maximumBins];
+      if (value < values[values.n_elem - 1] &&
+          (quantiles.empty() || value > quantiles.back()))
+        quantiles.push_back(value);
+    }
+
+    thresholds[d] = arma::vec(quantiles);
+  }
+}
+
+template<typename MatType>
+void FeatureBinner::Transform(const MatType& data,
+                              arma::Mat<unsigned char>& bins) const
+{
+  if (data.n_rows != thresholds.size())
+  {
+    std::ostringstream oss;
+    oss << "FeatureBinner::Transform(): the dataset has " << data.n_rows
+        << " dimensions, but the binner was trained on " << thresholds.size()
+        << " dimensions";
+    throw std::invalid_argument(oss.str());
+  }
+
+  bins.set_size(data.n_rows, data.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    for (size_t d = 0; d < data.n_rows; ++d)
+    {
+      const arma::vec& t = thresholds[d];
+      bins(d, i) = (unsigned char) (std::lower_bound(t.begin(), t.end(),
+          (double) data(d, i)) - t.begin());
+    }
+  }
+}
+
+} // namespace ensemble
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,175 @@
+/**
+ * @file methods/xgboost/histogram_tree.hpp
+ *
+ * Definition of the HistogramTree class, a regression tree that is fit to the
+ * gradients and hessians of a loss function using histograms of binned data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_HISTOGRAM_TREE_HPP
+#define MLPACK_METHODS_XGBOOST_HISTOGRAM_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "feature_binner.hpp"
+
+namespace mlpack {
+namespace ensemble {
+
+/**
+ * The HistogramTree is one tree of a gradient boosted ensemble.  It is trained
+ * on a dataset that has been binned with a FeatureBinner, and on the gradients
+ * and hessians of the loss at each point.  For each node, the sums of the
+ * gradients and of the hessians of the points in each bin of each dimension
+ * are collected in a histogram; the best split of a dimension is then found
+ * by one pass over its (at most 256) bins instead of by sorting the points.
+ *
+ * The histogram of a node is the sum of the histograms of its children, so
+ * only the histogram of the child with fewer points is built from the data;
+ * that of the other child is the difference of the histogram of the parent
+ * and the one that was built (the subtraction trick).  The histograms are
+ * built and searched for splits in parallel over the dimensions, with OpenMP.
+ *
+ * The splits are stored as thresholds on the original values, so the tree
+ * predicts on unbinned points.  The nodes are stored in flat arrays, with the
+ * two children of a node next to each other.
+ */
+class HistogramTree
+{
+ public:
+  //! Create an empty tree.
+  HistogramTree() :
+      maximumDepth(0),
+      minimumChildWeight(0.0),
+      minimumGainSplit(0.0)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Fit the tree to the given gradients and hessians.
+   *
+   * @param bins The binned dataset.
+   * @param binner The binner that was used to bin the dataset.
+   * @param gradients The gradient of the loss at each point.
+   * @param hessians The hessian of the loss at each point.
+   * @param loss The loss function, used for the gain of the splits and the
+   *     values of the leaves.
+   * @param maximumDepth Maximum depth of the tree (0 means no limit).
+   * @param minimumChildWeight Minimum sum of the hessians of the points in
+   *     each leaf.
+   * @param minimumGainSplit Minimum gain for splitting a node.
+   * @param predictions Vector to store the value of the leaf of each point in.
+   */
+  template<typename LossFunction>
+  void Train(const arma::Mat<unsigned char>& bins,
+             const FeatureBinner& binner,
+             const arma::vec& gradients,
+             const arma::vec& hessians,
+             const LossFunction& loss,
+             const size_t maximumDepth,
+             const double minimumChildWeight,
+             const double minimumGainSplit,
+             arma::vec& predictions);
+
+  /**
+   * Predict the value of the given point.
+   *
+   * @param point Point to predict the value of.
+   */
+  template<typename VecType>
+  double Predict(const VecType& point) const
+  {
+    size_t node = 0;
+    while (children[node] != 0)
+    {
+      node = children[node] +
+          ((point[splitDimensions[node]] <= splitValues[node]) ? 0 : 1);
+    }
+
+    return values[node];
+  }
+
+  //! Get the number of nodes of the tree.
+  size_t NumNodes() const { return children.size(); }
+  //! Get the index of the left child of a node (0 for a leaf); the right child
+  //! follows it.
+  size_t Child(const size_t node) const { return children[node]; }
+  //! Get the dimension a node splits on.
+  size_t SplitDimension(const size_t node) const
+  { return splitDimensions[node]; }
+  //! Get the threshold of a node; smaller or equal values go to the left.
+  double SplitValue(const size_t node) const { return splitValues[node]; }
+  //! Get the value of a leaf.
+  double Value(const size_t node) const { return values[node]; }
+
+  //! Serialize the tree.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(children));
+    ar(CEREAL_NVP(splitDimensions));
+    ar(CEREAL_NVP(splitValues));
+    ar(CEREAL_NVP(values));
+  }
+
+ private:
+  //! Compute the histogram of the points order[begin, end).
+  void BuildHistogram(const arma::Mat<unsigned char>& bins,
+                      const arma::vec& gradients,
+                      const arma::vec& hessians,
+                      const size_t begin,
+                      const size_t end,
+                      arma::mat& histogram) const;
+
+  /**
+   * Split the given node (holding the points order[begin, end)) if a split
+   * with enough gain is found, and recurse into its children; otherwise make
+   * it a leaf.
+   */
+  template<typename LossFunction>
+  void Split(const size_t node,
+             const size_t begin,
+             const size_t end,
+             const size_t depth,
+             const double sumGradients,
+             const double sumHessians,
+             const arma::mat& histogram,
+             const arma::Mat<unsigned char>& bins,
+             const FeatureBinner& binner,
+             const arma::vec& gradients,
+             const arma::vec& hessians,
+             const LossFunction& loss,
+             arma::vec& predictions);
+
+  //! The index of the left child of each node, or 0 for leaves.
+  std::vector<size_t> children;
+  //! The dimension each node splits on.
+  std::vector<size_t> splitDimensions;
+  //! The threshold of each node.
+  std::vector<double> splitValues;
+  //! The value of each node (only used for leaves).
+  std::vector<double> values;
+
+  //! The maximum depth, while training.
+  size_t maximumDepth;
+  //! The minimum sum of the hessians in a leaf, while training.
+  double minimumChildWeight;
+  //! The minimum gain of a split, while training.
+  double minimumGainSplit;
+  //! The points, ordered so that those of each node are contiguous, while
+  //! training.
+  std::vector<size_t> order;
+  //! The offset of the histogram of each dimension, while training.
+  std::vector<size_t> offsets;
+};
+
+} // namespace ensemble
+} // namespace mlpack
+
+// Include implementation.
+#include "histogram_tree_impl.hpp"
+
+#endif
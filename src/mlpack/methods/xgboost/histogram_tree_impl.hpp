@@ -0,0 +1,233 @@
+/**
+ * @file methods/xgboost/histogram_tree_impl.hpp
+ *
+ * Implementation of the HistogramTree class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_HISTOGRAM_TREE_IMPL_HPP
+#define MLPACK_METHODS_XGBOOST_HISTOGRAM_TREE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "histogram_tree.hpp"
+
+namespace mlpack {
+namespace ensemble {
+
+template<typename LossFunction>
+void HistogramTree::Train(const arma::Mat<unsigned char>& bins,
+                          const FeatureBinner& binner,
+                          const arma::vec& gradients,
+                          const arma::vec& hessians,
+                          const LossFunction& loss,
+                          const size_t maximumDepth,
+                          const double minimumChildWeight,
+                          const double minimumGainSplit,
+                          arma::vec& predictions)
+{
+  if (bins.n_rows != binner.Dimensionality())
+  {
+    throw std::invalid_argument("HistogramTree::Train(): the binned dataset "
+        "does not have the dimensionality of the binner");
+  }
+
+  if (gradients.n_elem != bins.n_cols || hessians.n_elem != bins.n_cols)
+  {
+    throw std::invalid_argument("HistogramTree::Train(): there must be one "
+        "gradient and one hessian for each point");
+  }
+
+  this->maximumDepth = maximumDepth;
+  this->minimumChildWeight = minimumChildWeight;
+  this->minimumGainSplit = minimumGainSplit;
+
+  children.clear();
+  splitDimensions.clear();
+  splitValues.clear();
+  values.clear();
+
+  // The histogram of dimension d is held in the columns offsets[d] to
+  // offsets[d + 1] - 1 of a 2-row matrix (the gradients and the hessians).
+  offsets.resize(bins.n_rows + 1);
+  offsets[0] = 0;
+  for (size_t d = 0; d < bins.n_rows; ++d)
+    offsets[d + 1] = offsets[d] + binner.NumBins(d);
+
+  order.resize(bins.n_cols);
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+
+  predictions.set_size(bins.n_cols);
+
+  arma::mat histogram;
+  BuildHistogram(bins, gradients, hessians, 0, bins.n_cols, histogram);
+
+  children.push_back(0);
+  splitDimensions.push_back(0);
+  splitValues.push_back(0.0);
+  values.push_back(0.0);
+  Split(0, 0, bins.n_cols, 0, arma::accu(gradients), arma::accu(hessians),
+      histogram, bins, binner, gradients, hessians, loss, predictions);
+
+  // The training state is not needed anymore.
+  order.clear();
+  offsets.clear();
+}
+
+inline void HistogramTree::BuildHistogram(
+    const arma::Mat<unsigned char>& bins,
+    const arma::vec& gradients,
+    const arma::vec& hessians,
+    const size_t begin,
+    const size_t end,
+    arma::mat& histogram) const
+{
+  histogram.zeros(2, offsets.back());
+
+  // Each dimension has its own part of the histogram, so the dimensions are
+  // filled in parallel without any synchronization.
+  #pragma omp parallel for
+  for (omp_size_t d = 0; d < (omp_size_t) bins.n_rows; ++d)
+  {
+    double* h = histogram.colptr(offsets[d]);
+    for (size_t j = begin; j < end; ++j)
+    {
+      const size_t point = order[j];
+      const size_t bin = bins(d, point);
+      h[2 * bin] += gradients[point];
+      h[2 * bin + 1] += hessians[point];
+    }
+  }
+}
+
+template<typename LossFunction>
+void HistogramTree::Split(const size_t node,
+                          const size_t begin,
+                          const size_t end,
+                          const size_t depth,
+                          const double sumGradients,
+                          const double sumHessians,
+                          const arma::mat& histogram,
+                          const arma::Mat<unsigned char>& bins,
+                          const FeatureBinner& binner,
+                          const arma::vec& gradients,
+                          const arma::vec& hessians,
+                          const LossFunction& loss,
+                          arma::vec& predictions)
+{
+  values[node] = loss.LeafValue(sumGradients, sumHessians);
+
+  // Find the best split of each dimension in parallel; the best split of all
+  // dimensions is then chosen in order, so the result does not depend on the
+  // number of threads.
+  const size_t dimensions = bins.n_rows;
+  std::vector<double> bestGains(dimensions,
+      -std::numeric_limits<double>::infinity());
+  std::vector<size_t> bestBins(dimensions, 0);
+  std::vector<double> bestLeftGradients(dimensions, 0.0);
+  std::vector<double> bestLeftHessians(dimensions, 0.0);
+
+  const bool canSplit = (end - begin >= 2) &&
+      (maximumDepth == 0 || depth < maximumDepth);
+  if (canSplit)
+  {
+    const double parentGain = loss.Gain(sumGradients, sumHessians);
+
+    #pragma omp parallel for
+    for (omp_size_t d = 0; d < (omp_size_t) dimensions; ++d)
+    {
+      const double* h = histogram.colptr(offsets[d]);
+      double leftGradients = 0.0;
+      double leftHessians = 0.0;
+      for (size_t b = 0; b + 1 < binner.NumBins(d); ++b)
+      {
+        leftGradients += h[2 * b];
+        leftHessians += h[2 * b + 1];
+        const double rightHessians = sumHessians - leftHessians;
+        if (leftHessians < minimumChildWeight)
+          continue;
+        if (rightHessians < minimumChildWeight)
+          break;
+
+        const double gain = loss.Gain(leftGradients, leftHessians) +
+            loss.Gain(sumGradients - leftGradients, rightHessians) -
+            parentGain;
+        if (gain > bestGains[d])
+        {
+          bestGains[d] = gain;
+          bestBins[d] = b;
+          bestLeftGradients[d] = leftGradients;
+          bestLeftHessians[d] = leftHessians;
+        }
+      }
+    }
+  }
+
+  size_t bestDimension = dimensions;
+  double bestGain = minimumGainSplit;
+  for (size_t d = 0; d < dimensions; ++d)
+  {
+    if (bestGains[d] > bestGain)
+    {
+      bestGain = bestGains[d];
+      bestDimension = d;
+    }
+  }
+
+  if (bestDimension == dimensions)
+  {
+    // No split is good enough, so this is a leaf.
+    for (size_t j = begin; j < end; ++j)
+      predictions[order[j]] = values[node];
+    return;
+  }
+
+  const size_t bin = bestBins[bestDimension];
+  const size_t middle = std::partition(order.begin() + begin,
+      order.begin() + end, [&](const size_t point)
+      {
+        return bins(bestDimension, point) <= bin;
+      }) - order.begin();
+
+  const size_t left = children.size();
+  children[node] = left;
+  splitDimensions[node] = bestDimension;
+  splitValues[node] = binner.Thresholds(bestDimension)[bin];
+  for (size_t i = 0; i < 2; ++i)
+  {
+    children.push_back(0);
+    splitDimensions.push_back(0);
+    splitValues.push_back(0.0);
+    values.push_back(0.0);
+  }
+
+  // Build the histogram of the child with fewer points, and get the other one
+  // by subtraction.
+  const double leftGradients = bestLeftGradients[bestDimension];
+  const double leftHessians = bestLeftHessians[bestDimension];
+  arma::mat leftHistogram, rightHistogram;
+  if (middle - begin <= end - middle)
+  {
+    BuildHistogram(bins, gradients, hessians, begin, middle, leftHistogram);
+    rightHistogram = histogram - leftHistogram;
+  }
+  else
+  {
+    BuildHistogram(bins, gradients, hessians, middle, end, rightHistogram);
+    leftHistogram = histogram - rightHistogram;
+  }
+
+  Split(left, begin, middle, depth + 1, leftGradients, leftHessians,
+      leftHistogram, bins, binner, gradients, hessians, loss, predictions);
+  Split(left + 1, middle, end, depth + 1, sumGradients - leftGradients,
+      sumHessians - leftHessians, rightHistogram, bins, binner, gradients,
+      hessians, loss, predictions);
+}
+
+} // namespace ensemble
+} // namespace mlpack
+
+#endif
@@ -58,7 +58,16 @@ class SSELoss
   double OutputLeafValue(const MatType& /* input */,
                          const WeightVecType& /* weights */)
   {
-    return -ApplyL1(arma::accu(gradients)) / (arma::accu(hessians) + lambda);
+    return LeafValue(arma::accu(gradients), arma::accu(hessians));
+  }
+
+  /**
+   * Returns the output value of a leaf, given the sums of the gradients and
+   * of the hessians of the points in the leaf.
+   */
+  double LeafValue(const double sumGradients, const double sumHessians) const
+  {
+    return -ApplyL1(sumGradients) / (sumHessians + lambda);
   }
 
   /**
@@ -69,8 +78,36 @@ class SSELoss
    */
   double Evaluate(const size_t begin, const size_t end)
   {
-    return std::pow(ApplyL1(arma::accu(gradients.subvec(begin, end))), 2) /
-        (arma::accu(hessians.subvec(begin, end)) + lambda);
+    return Gain(arma::accu(gradients.subvec(begin, end)),
+        arma::accu(hessians.subvec(begin, end)));
+  }
+
+  /**
+   * Calculates the gain of a node, given the sums of the gradients and of the
+   * hessians of the points in the node.  This is used by the histogram-based
+   * trees, which only keep these sums.
+   */
+  double Gain(const double sumGradients, const double sumHessians) const
+  {
+    return std::pow(ApplyL1(sumGradients), 2) / (sumHessians + lambda);
+  }
+
+  /**
+   * Computes the gradient and the hessian of the loss for each point.
+   *
+   * @param observed The true observed values.
+   * @param predicted The predictions at the current step of boosting.
+   * @param gradients Vector to store the first order gradients in.
+   * @param hessians Vector to store the second order gradients in.
+   */
+  template<typename VecType>
+  void Gradients(const VecType& observed,
+                 const VecType& predicted,
+                 arma::vec& gradients,
+                 arma::vec& hessians) const
+  {
+    gradients = arma::vectorise(predicted - observed);
+    hessians.ones(observed.n_elem);
   }
 
   /**
@@ -90,9 +127,9 @@ class SSELoss
     gradients = (input.row(1) - input.row(0)).t();
     hessians = arma::vec(input.n_cols, arma::fill::ones);
 
-    return std::pow(ApplyL1(arma::accu(gradients)), 2) /
-        (arma::accu(hessians) + lambda);
+    return Gain(arma::accu(gradients), arma::accu(hessians));
   }
+
  private:
   //! The L1 regularization parameter.
   const double alpha;
@@ -104,7 +141,7 @@ class SSELoss
   arma::vec hessians;
 
   //! Applies the L1 regularization.
-  double ApplyL1(const double sumGradients)
+  double ApplyL1(const double sumGradients) const
   {
     if (sumGradients > alpha)
     {
@@ -114,7 +151,7 @@ class SSELoss
     {
       return sumGradients + alpha;
     }
-    
+
     return 0;
   }
 };
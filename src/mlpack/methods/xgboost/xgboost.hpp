@@ -0,0 +1,161 @@
+/**
+ * @file methods/xgboost/xgboost.hpp
+ *
+ * Definition of the XGBoost class, a gradient boosted ensemble of
+ * histogram-based regression trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_XGBOOST_HPP
+#define MLPACK_METHODS_XGBOOST_XGBOOST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "feature_binner.hpp"
+#include "histogram_tree.hpp"
+#include "loss_functions/sse_loss.hpp"
+
+namespace mlpack {
+namespace ensemble {
+
+/**
+ * The XGBoost class implements gradient tree boosting with second order
+ * (Newton) steps, as described in the paper below.  Starting from the initial
+ * prediction of the loss function, each tree is fit to the gradients and
+ * hessians of the loss at the current predictions, and its (shrunk) output is
+ * added to the predictions.
+ *
+ * The dimensions of the training set are first mapped to at most 256 bins
+ * each with a FeatureBinner, and the trees are HistogramTrees, which find
+ * their splits from histograms of the gradients and hessians (see
+ * HistogramTree for details).
+ *
+ * @code
+ * @inproceedings{chen2016xgboost,
+ *   title={XGBoost: A Scalable Tree Boosting System},
+ *   author={Chen, Tianqi and Guestrin, Carlos},
+ *   booktitle={Proceedings of the 22nd ACM SIGKDD International Conference on
+ *       Knowledge Discovery and Data Mining},
+ *   pages={785--794},
+ *   year={2016}
+ * }
+ * @endcode
+ *
+ * @tparam LossFunction The loss function to minimize (for instance SSELoss).
+ */
+template<typename LossFunction = SSELoss>
+class XGBoost
+{
+ public:
+  /**
+   * Construct the model without any training.  Predict() will throw an
+   * exception until Train() is called.
+   */
+  XGBoost();
+
+  /**
+   * Train the model on the given data and responses.
+   *
+   * @param data Dataset to train on.
+   * @param responses Responses for the dataset.
+   * @param numTrees Number of trees to train.
+   * @param learningRate Shrinkage applied to the output of each tree.
+   * @param maximumDepth Maximum depth of each tree (0 means no limit).
+   * @param minimumChildWeight Minimum sum of the hessians of the points in
+   *     each leaf.
+   * @param minimumGainSplit Minimum gain for splitting a node.
+   * @param maximumBins Maximum number of bins of each dimension (at most 256).
+   * @param loss Instantiated loss function.
+   */
+  template<typename MatType>
+  XGBoost(const MatType& data,
+          const arma::rowvec& responses,
+          const size_t numTrees = 100,
+          const double learningRate = 0.3,
+          const size_t maximumDepth = 6,
+          const double minimumChildWeight = 1.0,
+          const double minimumGainSplit = 0.0,
+          const size_t maximumBins = 256,
+          LossFunction loss = LossFunction());
+
+  /**
+   * Train the model on the given data and responses.  Any previous trees are
+   * discarded.
+   *
+   * @param data Dataset to train on.
+   * @param responses Responses for the dataset.
+   * @param numTrees Number of trees to train.
+   * @param learningRate Shrinkage applied to the output of each tree.
+   * @param maximumDepth Maximum depth of each tree (0 means no limit).
+   * @param minimumChildWeight Minimum sum of the hessians of the points in
+   *     each leaf.
+   * @param minimumGainSplit Minimum gain for splitting a node.
+   * @param maximumBins Maximum number of bins of each dimension (at most 256).
+   * @param loss Instantiated loss function.
+   * @return The mean squared error of the model on the training set.
+   */
+  template<typename MatType>
+  double Train(const MatType& data,
+               const arma::rowvec& responses,
+               const size_t numTrees = 100,
+               const double learningRate = 0.3,
+               const size_t maximumDepth = 6,
+               const double minimumChildWeight = 1.0,
+               const double minimumGainSplit = 0.0,
+               const size_t maximumBins = 256,
+               LossFunction loss = LossFunction());
+
+  /**
+   * Predict the response of the given point.  If the model has not been
+   * trained, this will throw an exception.
+   *
+   * @param point Point to predict the response of.
+   */
+  template<typename VecType>
+  double Predict(const VecType& point) const;
+
+  /**
+   * Predict the responses of each point in the given dataset.  If the model
+   * has not been trained, this will throw an exception.
+   *
+   * @param data Dataset to predict the responses of.
+   * @param predictions Output predictions for each point in the dataset.
+   */
+  template<typename MatType>
+  void Predict(const MatType& data, arma::rowvec& predictions) const;
+
+  //! Access a tree of the model.
+  const HistogramTree& Tree(const size_t i) const { return trees[i]; }
+  //! Get the number of trees of the model.
+  size_t NumTrees() const { return trees.size(); }
+  //! Get the initial prediction, to which the output of the trees is added.
+  double InitialPrediction() const { return initialPrediction; }
+  //! Get the shrinkage applied to the output of each tree.
+  double LearningRate() const { return learningRate; }
+
+  /**
+   * Serialize the model.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! The trees of the model.
+  std::vector<HistogramTree> trees;
+  //! The initial prediction.
+  double initialPrediction;
+  //! The shrinkage applied to the output of each tree.
+  double learningRate;
+  //! The dimensionality of the training set.
+  size_t dimensionality;
+};
+
+} // namespace ensemble
+} // namespace mlpack
+
+// Include implementation.
+#include "xgboost_impl.hpp"
+
+#endif
@@ -0,0 +1,164 @@
+/**
+ * @file methods/xgboost/xgboost_impl.hpp
+ *
+ * Implementation of the XGBoost class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_XGBOOST_IMPL_HPP
+#define MLPACK_METHODS_XGBOOST_XGBOOST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "xgboost.hpp"
+
+namespace mlpack {
+namespace ensemble {
+
+template<typename LossFunction>
+XGBoost<LossFunction>::XGBoost() :
+    initialPrediction(0.0),
+    learningRate(0.0),
+    dimensionality(0)
+{
+  // Nothing to do here.
+}
+
+template<typename LossFunction>
+template<typename MatType>
+XGBoost<LossFunction>::XGBoost(const MatType& data,
+                               const arma::rowvec& responses,
+                               const size_t numTrees,
+                               const double learningRate,
+                               const size_t maximumDepth,
+                               const double minimumChildWeight,
+                               const double minimumGainSplit,
+                               const size_t maximumBins,
+                               LossFunction loss) :
+    initialPrediction(0.0),
+    learningRate(0.0),
+    dimensionality(0)
+{
+  // Pass off work to the Train() method.
+  Train(data, responses, numTrees, learningRate, maximumDepth,
+      minimumChildWeight, minimumGainSplit, maximumBins, loss);
+}
+
+template<typename LossFunction>
+template<typename MatType>
+double XGBoost<LossFunction>::Train(const MatType& data,
+                                    const arma::rowvec& responses,
+                                    const size_t numTrees,
+                                    const double learningRate,
+                                    const size_t maximumDepth,
+                                    const double minimumChildWeight,
+                                    const double minimumGainSplit,
+                                    const size_t maximumBins,
+                                    LossFunction loss)
+{
+  if (data.n_cols != responses.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "XGBoost::Train(): number of points (" << data.n_cols << ") does "
+        << "not match number of responses (" << responses.n_elem << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (learningRate <= 0.0)
+  {
+    throw std::invalid_argument("XGBoost::Train(): the learning rate must be "
+        "positive!");
+  }
+
+  // The data is only binned once; all the trees are trained on the bins.
+  FeatureBinner binner(data, maximumBins);
+  arma::Mat<unsigned char> bins;
+  binner.Transform(data, bins);
+
+  this->learningRate = learningRate;
+  dimensionality = data.n_rows;
+  initialPrediction = loss.InitialPrediction(responses);
+
+  arma::rowvec predictions(responses.n_elem);
+  predictions.fill(initialPrediction);
+
+  trees.clear();
+  trees.resize(numTrees);
+  arma::vec gradients, hessians, treePredictions;
+  for (size_t i = 0; i < numTrees; ++i)
+  {
+    loss.Gradients(responses, predictions, gradients, hessians);
+    trees[i].Train(bins, binner, gradients, hessians, loss, maximumDepth,
+        minimumChildWeight, minimumGainSplit, treePredictions);
+
+    // The tree gives the value of the leaf of each training point, so the
+    // training points do not have to be passed through the tree again.
+    predictions += learningRate * treePredictions.t();
+  }
+
+  return arma::mean(arma::square(responses - predictions));
+}
+
+template<typename LossFunction>
+template<typename VecType>
+double XGBoost<LossFunction>::Predict(const VecType& point) const
+{
+  if (trees.size() == 0)
+  {
+    throw std::invalid_argument("XGBoost::Predict(): no model trained!");
+  }
+
+  double prediction = 0.0;
+  for (size_t i = 0; i < trees.size(); ++i)
+    prediction += trees[i].Predict(point);
+
+  return initialPrediction + learningRate * prediction;
+}
+
+template<typename LossFunction>
+template<typename MatType>
+void XGBoost<LossFunction>::Predict(const MatType& data,
+                                    arma::rowvec& predictions) const
+{
+  if (trees.size() == 0)
+  {
+    predictions.clear();
+    throw std::invalid_argument("XGBoost::Predict(): no model trained!");
+  }
+
+  if (data.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "XGBoost::Predict(): the dataset has " << data.n_rows
+        << " dimensions, but the model was trained on " << dimensionality
+        << " dimensions!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  predictions.set_size(data.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    predictions[i] = Predict(data.col(i));
+}
+
+template<typename LossFunction>
+template<typename Archive>
+void XGBoost<LossFunction>::serialize(Archive& ar,
+                                      const uint32_t /* version */)
+{
+  if (cereal::is_loading<Archive>())
+    trees.clear();
+
+  ar(CEREAL_NVP(trees));
+  ar(CEREAL_NVP(initialPrediction));
+  ar(CEREAL_NVP(learningRate));
+  ar(CEREAL_NVP(dimensionality));
+}
+
+} // namespace ensemble
+} // namespace mlpack
+
+#endif
@@ -35,6 +35,9 @@
 #include <mlpack/methods/ann/activation_functions/hard_swish_function.hpp>
 #include <mlpack/methods/ann/activation_functions/tanh_exponential_function.hpp>
 #include <mlpack/methods/ann/activation_functions/silu_function.hpp>
+#include <mlpack/methods/ann/activation_functions/fast_logistic_function.hpp>
+#include <mlpack/methods/ann/activation_functions/fast_tanh_function.hpp>
+#include <mlpack/methods/ann/activation_functions/fast_gelu_function.hpp>
 
 #include "catch.hpp"
 
@@ -1379,3 +1382,127 @@ TEST_CASE("FlattenTSwishFunctionTest", "[ActivationFunctionsTest]")
   CheckFlattenTSwishActivationCorrect(input, desiredActivation);
   CheckFlattenTSwishDerivateCorrect(desiredActivation, desiredDerivation);
 }
+
+/**
+ * Make sure that FastExp() and FastTanh() match std::exp() and std::tanh() on
+ * a wide range of inputs.
+ */
+TEST_CASE("FastMathAccuracyTest", "[ActivationFunctionsTest]")
+{
+  arma::vec input = arma::join_cols(arma::linspace(-700, 700, 10001),
+      arma::vec(1000, arma::fill::randn) * 1e-3);
+
+  arma::vec exp(input.n_elem), tanh(input.n_elem);
+  FastExp(input.memptr(), exp.memptr(), input.n_elem);
+  FastTanh(input.memptr(), tanh.memptr(), input.n_elem);
+
+  for (size_t i = 0; i < input.n_elem; ++i)
+  {
+    REQUIRE(exp[i] == Approx(std::exp(input[i])).epsilon(1e-14));
+    REQUIRE(FastExp(input[i]) == exp[i]);
+    REQUIRE(tanh[i] == Approx(std::tanh(input[i])).epsilon(1e-12).margin(
+        1e-15));
+    REQUIRE(FastTanh(input[i]) == tanh[i]);
+  }
+
+  // Arguments outside of the range are clamped.
+  REQUIRE(std::isfinite(FastExp(1000.0)));
+  REQUIRE(FastExp(-1000.0) > 0.0);
+  REQUIRE(FastTanh(1000.0) == 1.0);
+  REQUIRE(FastTanh(-1000.0) == -1.0);
+}
+
+/**
+ * Basic test of the fast logistic function, which should give the same results
+ * as the logistic function.
+ */
+TEST_CASE("FastLogisticFunctionTest", "[ActivationFunctionsTest]")
+{
+  const arma::colvec desiredActivations("1.19202922e-01 9.60834277e-01 \
+                                         9.89013057e-01 3.04574e-44 \
+                                         7.31058579e-01 2.68941421e-01 \
+                                         8.80797078e-01 0.5");
+
+  const arma::colvec desiredDerivatives("0.10499359 0.03763177 0.01086623 \
+                                         3.04574e-44 0.19661193 0.19661193 \
+                                         0.10499359 0.25");
+
+  CheckActivationCorrect<FastLogisticFunction>(activationData,
+                                               desiredActivations);
+  CheckDerivativeCorrect<FastLogisticFunction>(desiredActivations,
+                                               desiredDerivatives);
+  CheckInverseCorrect<FastLogisticFunction>(activationData);
+
+  arma::mat input = arma::randn(20, 30) * 10;
+  arma::mat output, desiredOutput;
+  FastLogisticFunction::Fn(input, output);
+  LogisticFunction::Fn(input, desiredOutput);
+  for (size_t i = 0; i < output.n_elem; ++i)
+    REQUIRE(output[i] == Approx(desiredOutput[i]).epsilon(1e-12));
+}
+
+/**
+ * Basic test of the fast tanh function, which should give the same results as
+ * the tanh function.
+ */
+TEST_CASE("FastTanhFunctionTest", "[ActivationFunctionsTest]")
+{
+  const arma::colvec desiredActivations("-0.96402758 0.9966824 0.99975321 -1 \
+                                         0.76159416 -0.76159416 0.96402758 0");
+
+  const arma::colvec desiredDerivatives("0.07065082 0.00662419 0.00049352 0 \
+                                         0.41997434 0.41997434 0.07065082 1");
+
+  CheckActivationCorrect<FastTanhFunction>(activationData, desiredActivations);
+  CheckDerivativeCorrect<FastTanhFunction>(desiredActivations,
+                                           desiredDerivatives);
+  CheckInverseCorrect<FastTanhFunction>(desiredActivations);
+
+  arma::mat input = arma::randn(20, 30) * 5;
+  arma::mat output, desiredOutput;
+  FastTanhFunction::Fn(input, output);
+  TanhFunction::Fn(input, desiredOutput);
+  for (size_t i = 0; i < output.n_elem; ++i)
+  {
+    REQUIRE(output[i] ==
+        Approx(desiredOutput[i]).epsilon(1e-12).margin(1e-15));
+  }
+}
+
+/**
+ * Basic test of the fast GELU function, which should give the same results as
+ * the GELU function.
+ */
+TEST_CASE("FastGELUFunctionTest", "[ActivationFunctionsTest]")
+{
+  // Calculated using torch.nn.gelu().
+  const arma::colvec desiredActivations("-0.0454023 3.1981304 \
+                                         4.5 -0.0 0.84119199 \
+                                         -0.158808 1.954597694 0.0");
+
+  const arma::colvec desiredDerivatives("0.4637992 1.0065302 \
+                                         1.0000293 0.5 1.03513446 \
+                                         0.37435387 1.090984 0.5");
+
+  CheckActivationCorrect<FastGELUFunction>(activationData,
+                                           desiredActivations);
+  CheckDerivativeCorrect<FastGELUFunction>(desiredActivations,
+                                           desiredDerivatives);
+
+  // The layer should give the same results as the GELU layer.
+  arma::mat input = arma::randn(20, 30) * 3;
+  arma::mat error = arma::randn(20, 30);
+  arma::mat output, desiredOutput, delta, desiredDelta;
+  FastGELUFunctionLayer<> layer;
+  GELUFunctionLayer<> desiredLayer;
+  layer.Forward(input, output);
+  desiredLayer.Forward(input, desiredOutput);
+  layer.Backward(output, error, delta);
+  desiredLayer.Backward(desiredOutput, error, desiredDelta);
+  for (size_t i = 0; i < output.n_elem; ++i)
+  {
+    REQUIRE(output[i] ==
+        Approx(desiredOutput[i]).epsilon(1e-10).margin(1e-14));
+    REQUIRE(delta[i] == Approx(desiredDelta[i]).epsilon(1e-10).margin(1e-14));
+  }
+}
@@ -22,6 +22,8 @@
 #include <mlpack/methods/ann/loss_functions/binary_cross_entropy_loss.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
 #include <mlpack/methods/ann/rnn.hpp>
+#include <mlpack/methods/ann/util/device_gemm.hpp>
+#include <mlpack/methods/ann/util/lazy_adam_update.hpp>
 
 #include "test_catch_tools.hpp"
 #include "catch.hpp"
@@ -495,6 +497,145 @@ TEST_CASE("GradientLinearLayerTest", "[ANNLayerTest]")
   REQUIRE(CheckGradient(function) <= 1e-4);
 }
 
+/**
+ * Make sure that DeviceGemm() computes the product for every transposition of
+ * its operands, both for small products and for products large enough to run
+ * on the GPU if Bandicoot is available.
+ */
+TEST_CASE("DeviceGemmTest", "[ANNLayerTest]")
+{
+  const size_t sizes[] = { 7, 256 };
+  for (size_t s = 0; s < 2; ++s)
+  {
+    const size_t n = sizes[s];
+    arma::mat a(n, n + 1, arma::fill::randn);
+    arma::mat b(n + 1, n, arma::fill::randn);
+    arma::mat bt(b.t());
+    arma::mat at(a.t());
+    const arma::mat ab = a * b;
+    DeviceMatrix<double> deviceA;
+
+    arma::mat c;
+    DeviceGemm(a, false, b, false, c, &deviceA);
+    REQUIRE(arma::approx_equal(c, ab, "absdiff", 1e-8));
+    DeviceGemm(at, true, b, false, c);
+    REQUIRE(arma::approx_equal(c, ab, "absdiff", 1e-8));
+    DeviceGemm(a, false, bt, true, c, &deviceA);
+    REQUIRE(arma::approx_equal(c, ab, "absdiff", 1e-8));
+    DeviceGemm(at, true, bt, true, c);
+    REQUIRE(arma::approx_equal(c, ab, "absdiff", 1e-8));
+
+    // The result can be stored in the memory of another matrix.
+    arma::mat memory(n * n, 1);
+    arma::mat alias(memory.memptr(), n, n, false, true);
+    DeviceGemm(a, false, b, false, alias);
+    REQUIRE(arma::approx_equal(arma::reshape(memory, n, n), ab, "absdiff",
+        1e-8));
+  }
+}
+
+/**
+ * FusedLinear must give the same results as Linear followed by the activation.
+ */
+TEST_CASE("SimpleFusedLinearLayerTest", "[ANNLayerTest]")
+{
+  arma::mat input = arma::randn(10, 7), output, fusedOutput, linearOutput;
+  arma::mat delta, fusedDelta;
+
+  Linear<> linear(10, 5);
+  ReLULayer<> relu;
+  FusedLinear<RectifierFunction> fused(10, 5);
+  linear.Parameters().randn();
+  fused.Parameters() = linear.Parameters();
+  linear.Reset();
+  fused.Reset();
+
+  linear.Forward(input, linearOutput);
+  relu.Forward(linearOutput, output);
+  fused.Forward(input, fusedOutput);
+  CheckMatrices(output, fusedOutput);
+
+  // Backward pass through the activation first, then the linear layer.
+  arma::mat error = arma::randn(5, 7), reluDelta;
+  relu.Backward(output, error, reluDelta);
+  linear.Backward(linearOutput, reluDelta, delta);
+  fused.Backward(fusedOutput, error, fusedDelta);
+  CheckMatrices(delta, fusedDelta);
+}
+
+/**
+ * FusedLinear layer numerical gradient test.
+ */
+TEST_CASE("GradientFusedLinearLayerTest", "[ANNLayerTest]")
+{
+  // FusedLinear function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction() :
+        input(arma::randu(10, 1)),
+        target(arma::mat("0"))
+    {
+      model = new FFN<NegativeLogLikelihood<>, NguyenWidrowInitialization>();
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<IdentityLayer<> >();
+      model->Add<FusedLinear<TanhFunction> >(10, 10);
+      model->Add<FusedLinear<LogisticFunction> >(10, 2);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 1);
+      model->Gradient(model->Parameters(), 0, gradient, 1);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<NegativeLogLikelihood<>, NguyenWidrowInitialization>* model;
+    arma::mat input, target;
+  } function;
+
+  REQUIRE(CheckGradient(function) <= 1e-4);
+}
+
+/**
+ * Simple QuantizedLinear layer test: compare with the Linear layer, and check
+ * the int8 product against the exact integer product.
+ */
+TEST_CASE("SimpleQuantizedLinearLayerTest", "[ANNLayerTest]")
+{
+  arma::mat input = arma::randu(10, 7) * 2 - 1, output, quantizedOutput;
+
+  Linear<> linear(10, 5);
+  linear.Parameters().randn();
+  linear.Reset();
+  linear.Forward(input, output);
+
+  QuantizedLinear<> quantized(linear.Weight(), linear.Bias(),
+      arma::abs(input).max() / 127.0);
+  REQUIRE(quantized.InputSize() == 10);
+  REQUIRE(quantized.OutputSize() == 5);
+  quantized.Forward(input, quantizedOutput);
+  REQUIRE(arma::abs(output - quantizedOutput).max() < 0.05);
+
+  // The blocked product must be exact.
+  arma::Mat<int8_t> a(12, 5), b(12, 9);
+  a.imbue([]() { return (int8_t) (std::rand() % 255 - 127); });
+  b.imbue([]() { return (int8_t) (std::rand() % 255 - 127); });
+  arma::Mat<int32_t> c;
+  Int8Gemm(a, b, c);
+  const arma::Mat<int32_t> expected = arma::conv_to<arma::Mat<int32_t>>::from(
+      a).t() * arma::conv_to<arma::Mat<int32_t>>::from(b);
+  REQUIRE(arma::accu(c != expected) == 0);
+}
+
 /**
  * Simple Linear3D layer test.
  */
@@ -1282,6 +1423,128 @@ TEST_CASE("FastLSTMLayerParametersTest", "[ANNLayerTest]")
   REQUIRE(layer1.Rho() == layer2.Rho());
 }
 
+/**
+ * FusedLSTM layer numerical gradient test.
+ */
+TEST_CASE("GradientFusedLSTMLayerTest", "[ANNLayerTest]")
+{
+  // Fused LSTM function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction() :
+        input(arma::randu(1, 2, 5)),
+        target(arma::zeros(1, 2, 5))
+    {
+      const size_t rho = 5;
+
+      model = new RNN<NegativeLogLikelihood<> >(rho);
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<IdentityLayer<> >();
+      model->Add<Linear<> >(1, 10);
+      model->Add<FusedLSTM<> >(10, 3, rho);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 2);
+      model->Gradient(model->Parameters(), 0, gradient, 2);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    RNN<NegativeLogLikelihood<> >* model;
+    arma::cube input, target;
+  } function;
+
+  REQUIRE(CheckGradient(function) <= 1e-4);
+}
+
+/**
+ * Test that the sequence functions of the FusedLSTM layer give the same
+ * outputs as the step-wise forward pass, and that the errors and gradients of
+ * BackwardSequence() match finite differences.
+ */
+TEST_CASE("FusedLSTMSequenceTest", "[ANNLayerTest]")
+{
+  const size_t inSize = 4, outSize = 3, batchSize = 2, steps = 6;
+  FusedLSTM<> layer(inSize, outSize, steps);
+  layer.Parameters().randn();
+  layer.Parameters() *= 0.5;
+  layer.Reset();
+
+  arma::cube input = arma::randn(inSize, batchSize, steps);
+  arma::cube output;
+  layer.ForwardSequence(input, output);
+  REQUIRE(output.n_rows == outSize);
+  REQUIRE(output.n_cols == batchSize);
+  REQUIRE(output.n_slices == steps);
+
+  // The step-wise forward pass gives the same outputs.
+  FusedLSTM<> stepLayer(inSize, outSize, steps);
+  stepLayer.Parameters() = layer.Parameters();
+  stepLayer.Reset();
+  stepLayer.ResetCell(steps);
+  for (size_t t = 0; t < steps; ++t)
+  {
+    arma::mat stepOutput;
+    stepLayer.Forward(input.slice(t), stepOutput);
+    CheckMatrices(stepOutput, output.slice(t), 1e-10);
+  }
+
+  // The loss is the weighted sum of the outputs, so its gradient with respect
+  // to the outputs is the weights.
+  const arma::cube gy = arma::randn(outSize, batchSize, steps);
+  arma::cube g;
+  arma::mat gradient;
+  layer.BackwardSequence(input, gy, g, gradient);
+  REQUIRE(g.n_rows == inSize);
+  REQUIRE(g.n_slices == steps);
+  REQUIRE(gradient.n_elem == layer.WeightSize());
+
+  const double eps = 1e-6;
+  for (size_t k = 0; k < 10; ++k)
+  {
+    const size_t i = math::RandInt(layer.Parameters().n_elem);
+    const double original = layer.Parameters()(i);
+    arma::cube perturbedOutput;
+
+    layer.Parameters()(i) = original + eps;
+    layer.ForwardSequence(input, perturbedOutput);
+    const double lossPlus = arma::accu(perturbedOutput % gy);
+    layer.Parameters()(i) = original - eps;
+    layer.ForwardSequence(input, perturbedOutput);
+    const double lossMinus = arma::accu(perturbedOutput % gy);
+    layer.Parameters()(i) = original;
+
+    REQUIRE(gradient(i) == Approx((lossPlus - lossMinus) / (2 * eps)).
+        margin(1e-6));
+  }
+
+  for (size_t k = 0; k < 10; ++k)
+  {
+    const size_t i = math::RandInt(input.n_elem);
+    arma::cube perturbedInput = input;
+    arma::cube perturbedOutput;
+
+    perturbedInput(i) += eps;
+    layer.ForwardSequence(perturbedInput, perturbedOutput);
+    const double lossPlus = arma::accu(perturbedOutput % gy);
+    perturbedInput(i) -= 2 * eps;
+    layer.ForwardSequence(perturbedInput, perturbedOutput);
+    const double lossMinus = arma::accu(perturbedOutput % gy);
+
+    REQUIRE(g(i) == Approx((lossPlus - lossMinus) / (2 * eps)).margin(1e-6));
+  }
+}
+
 /**
  * Check whether copying and moving network with FastLSTM is working or not.
  */
@@ -1689,6 +1952,37 @@ TEST_CASE("SimpleConcatLayerTest", "[ANNLayerTest]")
   REQUIRE(arma::accu(delta) == 0);
 }
 
+/**
+ * Check the Concat layer with several layers and a batch of points against the
+ * concatenated outputs of the layers.
+ */
+TEST_CASE("BatchConcatLayerTest", "[ANNLayerTest]")
+{
+  arma::mat input = arma::randu(10, 7);
+  arma::mat output, expectedOutput;
+
+  Concat<> module;
+  const size_t outSizes[3] = { 4, 1, 6 };
+  for (size_t i = 0; i < 3; ++i)
+  {
+    Linear<>* linear = new Linear<>(10, outSizes[i]);
+    linear->Parameters().randu();
+    linear->Reset();
+    module.Add(linear);
+
+    arma::mat linearOutput;
+    linear->Forward(input, linearOutput);
+    expectedOutput = arma::join_cols(expectedOutput, linearOutput);
+  }
+
+  module.Forward(input, output);
+  CheckMatrices(output, expectedOutput, 1e-12);
+
+  // Call it again, so that the output is reused.
+  module.Forward(input, output);
+  CheckMatrices(output, expectedOutput, 1e-12);
+}
+
 /**
  * Test to check Concat layer along different axes.
  */
@@ -2015,6 +2309,122 @@ TEST_CASE("LookupLayerParametersTest", "[ANNLayerTest]")
   REQUIRE(layer.EmbeddingSize() == 8);
 }
 
+/**
+ * Test that reusing the gradient of the Lookup layer, where only the columns
+ * used by the previous batch are cleared, gives the same gradient as a new
+ * matrix, and that the used columns are correct.
+ */
+TEST_CASE("LookupLayerReusedGradientTest", "[ANNLayerTest]")
+{
+  const size_t vocabSize = 50;
+  const size_t embeddingSize = 4;
+  const size_t seqLength = 3;
+  const size_t batchSize = 2;
+
+  Lookup<> module(vocabSize, embeddingSize);
+  module.Parameters().randu();
+  Lookup<> reference(vocabSize, embeddingSize);
+
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    arma::mat input(seqLength, batchSize);
+    for (size_t i = 0; i < input.n_elem; ++i)
+      input(i) = math::RandInt(1, vocabSize);
+
+    arma::mat output;
+    module.Forward(input, output);
+    arma::mat error = arma::randu(embeddingSize * seqLength, batchSize);
+
+    arma::mat freshGradient;
+    reference.Gradient(input, error, freshGradient);
+    module.Gradient(input, error, module.Gradient());
+
+    CheckMatrices(module.Gradient(), freshGradient);
+
+    const arma::uvec expected = arma::unique(
+        arma::conv_to<arma::uvec>::from(arma::vectorise(input)) - 1);
+    REQUIRE(module.UsedColumns().n_elem == expected.n_elem);
+    for (size_t i = 0; i < expected.n_elem; ++i)
+      REQUIRE(module.UsedColumns()[i] == expected[i]);
+  }
+}
+
+/**
+ * Test that the sparse gradient of a network with a Lookup layer is the same as
+ * its dense gradient, over several batches.
+ */
+TEST_CASE("LookupLayerSparseGradientTest", "[ANNLayerTest]")
+{
+  const size_t vocabSize = 100;
+  const size_t embeddingSize = 4;
+  const size_t seqLength = 3;
+  const size_t points = 8;
+  const size_t batchSize = 4;
+
+  arma::mat input(seqLength, points);
+  for (size_t i = 0; i < input.n_elem; ++i)
+    input(i) = math::RandInt(1, vocabSize);
+  arma::mat target = arma::randu(2, points);
+
+  FFN<MeanSquaredError<>, RandomInitialization> model;
+  model.Predictors() = input;
+  model.Responses() = target;
+  model.Add<Lookup<> >(vocabSize, embeddingSize);
+  model.Add<Linear<> >(embeddingSize * seqLength, 2);
+  model.ResetParameters();
+
+  arma::sp_mat sparseGradient;
+  for (size_t begin = 0; begin < points; begin += batchSize)
+  {
+    arma::mat denseGradient;
+    const double denseObjective = model.EvaluateWithGradient(
+        model.Parameters(), begin, denseGradient, batchSize);
+    const double sparseObjective = model.EvaluateWithGradient(
+        model.Parameters(), begin, sparseGradient, batchSize);
+
+    REQUIRE(sparseObjective == Approx(denseObjective).epsilon(1e-7));
+    CheckMatrices(arma::mat(sparseGradient), denseGradient);
+
+    // Only the used columns of the embedding table and the Linear layer may
+    // be nonzero.
+    REQUIRE(sparseGradient.n_nonzero <= embeddingSize * seqLength *
+        batchSize + (embeddingSize * seqLength + 1) * 2);
+  }
+}
+
+/**
+ * Test that LazyAdamUpdate only changes the parameters with a nonzero
+ * gradient, and is the Adam update for them.
+ */
+TEST_CASE("LazyAdamUpdateTest", "[ANNLayerTest]")
+{
+  LazyAdamUpdate update;
+  LazyAdamUpdate::Policy<arma::mat, arma::sp_mat> policy(update, 10, 1);
+
+  arma::mat iterate = arma::randu(10, 1);
+  const arma::mat original = iterate;
+
+  arma::sp_mat gradient(10, 1);
+  gradient(2, 0) = 0.5;
+  gradient(7, 0) = -1.0;
+  policy.Update(iterate, 0.01, gradient);
+
+  for (size_t i = 0; i < 10; ++i)
+  {
+    if (i == 2 || i == 7)
+    {
+      // After one step, the bias-corrected update is the step size times the
+      // sign of the gradient (up to epsilon).
+      const double sign = (gradient(i, 0) > 0) ? 1.0 : -1.0;
+      REQUIRE(iterate(i) == Approx(original(i) - 0.01 * sign).epsilon(1e-5));
+    }
+    else
+    {
+      REQUIRE(iterate(i) == original(i));
+    }
+  }
+}
+
 /**
  * Simple LogSoftMax module test.
  */
@@ -3213,6 +3623,55 @@ TEST_CASE("LayerNormLayerParametersTest", "[ANNLayerTest]")
   REQUIRE(layer.Epsilon() == 1e-3);
 }
 
+/**
+ * Make sure that the normalization layers are invariant to a large offset of
+ * the input, i.e. that the statistics are computed in a numerically stable
+ * way, and that the backward pass does not depend on the offset either.
+ */
+TEST_CASE("NormalizationLayersLargeOffsetTest", "[ANNLayerTest]")
+{
+  const arma::mat input = arma::randn(48, 17);
+  const arma::mat shiftedInput = input + 1e5;
+  const arma::mat error = arma::randn(48, 17);
+
+  BatchNorm<> batchNorm(3), shiftedBatchNorm(3);
+  LayerNorm<> layerNorm(48), shiftedLayerNorm(48);
+  GroupNorm<> groupNorm(4, 8), shiftedGroupNorm(4, 8);
+  batchNorm.Reset();
+  shiftedBatchNorm.Reset();
+  layerNorm.Reset();
+  shiftedLayerNorm.Reset();
+  groupNorm.Reset();
+  shiftedGroupNorm.Reset();
+
+  arma::mat output, shiftedOutput, delta, shiftedDelta;
+
+  batchNorm.Forward(input, output);
+  shiftedBatchNorm.Forward(shiftedInput, shiftedOutput);
+  CheckMatrices(output, shiftedOutput, 1e-3);
+  batchNorm.Backward(output, error, delta);
+  shiftedBatchNorm.Backward(shiftedOutput, error, shiftedDelta);
+  CheckMatrices(delta, shiftedDelta, 1e-3);
+
+  layerNorm.Forward(input, output);
+  shiftedLayerNorm.Forward(shiftedInput, shiftedOutput);
+  CheckMatrices(output, shiftedOutput, 1e-3);
+  layerNorm.Backward(output, error, delta);
+  shiftedLayerNorm.Backward(shiftedOutput, error, shiftedDelta);
+  CheckMatrices(delta, shiftedDelta, 1e-3);
+
+  // Each column of the output of LayerNorm has zero mean and unit variance.
+  CheckMatrices(arma::mean(shiftedOutput), arma::zeros(1, 17), 1e-3);
+  CheckMatrices(arma::var(shiftedOutput, 1), arma::ones(1, 17), 1e-3);
+
+  groupNorm.Forward(input, output);
+  shiftedGroupNorm.Forward(shiftedInput, shiftedOutput);
+  CheckMatrices(output, shiftedOutput, 1e-3);
+  groupNorm.Backward(output, error, delta);
+  shiftedGroupNorm.Backward(shiftedOutput, error, shiftedDelta);
+  CheckMatrices(delta, shiftedDelta, 1e-3);
+}
+
 /**
  * Test if the AddMerge layer is able to forward the
  * Forward/Backward/Gradient calls.
@@ -3775,6 +4234,118 @@ TEST_CASE("GradientSequentialLayerTest", "[ANNLayerTest]")
   REQUIRE(CheckGradient(function) <= 1e-4);
 }
 
+/**
+ * Check that a checkpointed Sequential block gives the same gradient as a
+ * regular Sequential block, and releases the outputs of its layers.
+ */
+TEST_CASE("CheckpointSequentialLayerTest", "[ANNLayerTest]")
+{
+  arma::mat input = arma::randu(10, 8);
+  arma::mat target = arma::randi<arma::mat>(1, 8, arma::distr_param(1, 2));
+
+  FFN<NegativeLogLikelihood<>, NguyenWidrowInitialization> models[2];
+  Sequential<>* blocks[2];
+  Residual<>* residuals[2];
+  for (size_t m = 0; m < 2; ++m)
+  {
+    models[m].Add<IdentityLayer<> >();
+    models[m].Add<Linear<> >(10, 10);
+
+    blocks[m] = new Sequential<>();
+    blocks[m]->Add<Linear<> >(10, 10);
+    blocks[m]->Add<SigmoidLayer<> >();
+    blocks[m]->Add<Linear<> >(10, 10);
+    blocks[m]->Add<TanHLayer<> >();
+    blocks[m]->Checkpoint() = (m == 1);
+    models[m].Add(blocks[m]);
+
+    residuals[m] = new Residual<>();
+    residuals[m]->Add<Linear<> >(10, 10);
+    residuals[m]->Add<ReLULayer<> >();
+    residuals[m]->Checkpoint() = (m == 1);
+    models[m].Add(residuals[m]);
+
+    models[m].Add<Linear<> >(10, 2);
+    models[m].Add<LogSoftMax<> >();
+  }
+
+  models[0].ResetParameters();
+  models[1].ResetParameters();
+  models[1].Parameters() = models[0].Parameters();
+
+  arma::mat gradient, checkpointGradient;
+  models[0].Predictors() = input;
+  models[0].Responses() = target;
+  models[1].Predictors() = input;
+  models[1].Responses() = target;
+  const double error = models[0].EvaluateWithGradient(models[0].Parameters(),
+      0, gradient, input.n_cols);
+  const double checkpointError = models[1].EvaluateWithGradient(
+      models[1].Parameters(), 0, checkpointGradient, input.n_cols);
+
+  REQUIRE(checkpointError == Approx(error).epsilon(1e-10));
+  CheckMatrices(gradient, checkpointGradient, 1e-8);
+
+  // Only the checkpointed blocks release the outputs of their layers.
+  arma::mat output;
+  models[0].Forward(input, output);
+  models[1].Forward(input, output);
+  REQUIRE(!boost::get<Linear<>*>(blocks[0]->Model()[0])->OutputParameter()
+      .is_empty());
+  REQUIRE(boost::get<Linear<>*>(blocks[1]->Model()[0])->OutputParameter()
+      .is_empty());
+  REQUIRE(boost::get<Linear<>*>(residuals[1]->Model()[0])->OutputParameter()
+      .is_empty());
+}
+
+/**
+ * Make sure that the output and the delta of a Sequential block are aliases of
+ * the output of its last layer and the delta of its first layer.
+ */
+TEST_CASE("SequentialLayerAliasTest", "[ANNLayerTest]")
+{
+  arma::mat input = arma::randu(10, 8);
+  arma::mat error = arma::randu(5, 8);
+
+  Linear<>* first = new Linear<>(10, 10);
+  SigmoidLayer<>* sigmoid = new SigmoidLayer<>();
+  Linear<>* last = new Linear<>(10, 5);
+  first->Parameters().randu();
+  first->Reset();
+  last->Parameters().randu();
+  last->Reset();
+
+  Sequential<> block;
+  block.Add(first);
+  block.Add(sigmoid);
+  block.Add(last);
+
+  arma::mat output, delta;
+  block.Forward(input, output);
+  REQUIRE(output.memptr() == last->OutputParameter().memptr());
+  CheckMatrices(output, last->OutputParameter());
+
+  block.Backward(input, error, delta);
+  REQUIRE(delta.memptr() == first->Delta().memptr());
+  CheckMatrices(delta, first->Delta());
+
+  // A residual block has to add the input, so it copies the output.
+  Linear<>* linear = new Linear<>(10, 10);
+  linear->Parameters().randu();
+  linear->Reset();
+
+  Residual<> residual;
+  residual.Add(linear);
+  residual.Forward(input, output);
+  REQUIRE(output.memptr() != linear->OutputParameter().memptr());
+  CheckMatrices(output, linear->OutputParameter() + input);
+
+  delete first;
+  delete sigmoid;
+  delete last;
+  delete linear;
+}
+
 /**
  * WeightNorm layer numerical gradient test.
  */
@@ -3996,6 +4567,167 @@ TEST_CASE("ConvolutionLayerPaddingTest", "[ANNLayerTest]")
   module2.Backward(input, output, delta);
 }
 
+/**
+ * Test that the Convolution layer gives the same results with the
+ * Im2ColConvolution rules as with the naive rules.
+ */
+TEST_CASE("Im2ColConvolutionLayerTest", "[ANNLayerTest]")
+{
+  typedef Convolution<Im2ColConvolution<ValidConvolution>,
+                      Im2ColConvolution<FullConvolution>,
+                      Im2ColConvolution<ValidConvolution>,
+                      arma::mat, arma::mat> Im2ColConvolutionLayer;
+
+  const size_t inSize = 2, outSize = 3, width = 7, height = 6;
+  arma::mat input = arma::randu(width * height * inSize, 4);
+
+  Convolution<> naive(inSize, outSize, 3, 3, 1, 1, 1, 2, width, height);
+  Im2ColConvolutionLayer im2col(inSize, outSize, 3, 3, 1, 1, 1, 2, width,
+      height);
+  naive.Parameters().randu();
+  naive.Reset();
+  im2col.Parameters() = naive.Parameters();
+  im2col.Reset();
+
+  arma::mat naiveOutput, im2colOutput;
+  naive.Forward(input, naiveOutput);
+  im2col.Forward(input, im2colOutput);
+  REQUIRE(im2colOutput.n_rows == naiveOutput.n_rows);
+  REQUIRE(im2colOutput.n_cols == naiveOutput.n_cols);
+  CheckMatrices(im2colOutput, naiveOutput, 1e-8);
+  REQUIRE(im2col.OutputWidth() == naive.OutputWidth());
+  REQUIRE(im2col.OutputHeight() == naive.OutputHeight());
+
+  const arma::mat error = arma::randu(naiveOutput.n_rows, naiveOutput.n_cols);
+  arma::mat naiveDelta, im2colDelta;
+  naive.Backward(input, error, naiveDelta);
+  im2col.Backward(input, error, im2colDelta);
+  CheckMatrices(im2colDelta, naiveDelta, 1e-8);
+
+  arma::mat naiveGradient, im2colGradient;
+  naive.Gradient(input, error, naiveGradient);
+  im2col.Gradient(input, error, im2colGradient);
+  CheckMatrices(im2colGradient, naiveGradient, 1e-8);
+
+  // With a stride of 2 the forward pass must still agree.
+  Convolution<> naiveStrided(inSize, outSize, 3, 3, 2, 2, 1, 1, width,
+      height);
+  Im2ColConvolutionLayer im2colStrided(inSize, outSize, 3, 3, 2, 2, 1, 1,
+      width, height);
+  naiveStrided.Parameters().randu();
+  naiveStrided.Reset();
+  im2colStrided.Parameters() = naiveStrided.Parameters();
+  im2colStrided.Reset();
+
+  naiveStrided.Forward(input, naiveOutput);
+  im2colStrided.Forward(input, im2colOutput);
+  CheckMatrices(im2colOutput, naiveOutput, 1e-8);
+}
+
+/**
+ * Test that the Winograd forward pass of the Convolution layer (used for 3x3
+ * kernels with stride 1) matches the im2col convolution, and that the
+ * transformed filters are only kept in deterministic mode.
+ */
+TEST_CASE("WinogradConvolutionLayerTest", "[ANNLayerTest]")
+{
+  const size_t inSize = 2, outSize = 3, width = 7, height = 6;
+  arma::mat input = arma::randu(width * height * inSize, 3);
+
+  Convolution<> winograd(inSize, outSize, 3, 3, 1, 1, 1, 0, width, height);
+  Convolution<Im2ColConvolution<ValidConvolution>,
+              Im2ColConvolution<FullConvolution>,
+              Im2ColConvolution<ValidConvolution>,
+              arma::mat, arma::mat> reference(inSize, outSize, 3, 3, 1, 1, 1,
+      0, width, height);
+  winograd.Parameters().randu();
+  winograd.Reset();
+  reference.Parameters() = winograd.Parameters();
+  reference.Reset();
+
+  arma::mat output, referenceOutput;
+  winograd.Forward(input, output);
+  reference.Forward(input, referenceOutput);
+  CheckMatrices(output, referenceOutput, 1e-8);
+
+  // In training mode, changed weights are used by the next forward pass.
+  winograd.Parameters() *= 2;
+  reference.Parameters() *= 2;
+  winograd.Forward(input, output);
+  reference.Forward(input, referenceOutput);
+  CheckMatrices(output, referenceOutput, 1e-8);
+
+  // In deterministic mode, the transformed filters are reused until Reset()
+  // is called.
+  winograd.Deterministic() = true;
+  winograd.Forward(input, output);
+  CheckMatrices(output, referenceOutput, 1e-8);
+
+  winograd.Parameters() *= 2;
+  reference.Parameters() *= 2;
+  arma::mat staleOutput;
+  winograd.Forward(input, staleOutput);
+  CheckMatrices(staleOutput, output, 1e-8);
+
+  winograd.Reset();
+  winograd.Forward(input, output);
+  reference.Forward(input, referenceOutput);
+  CheckMatrices(output, referenceOutput, 1e-8);
+
+  // The AtrousConvolution layer uses the same path without dilation.
+  AtrousConvolution<> atrous(inSize, outSize, 3, 3, 1, 1, 1, 0, width,
+      height);
+  atrous.Parameters() = winograd.Parameters();
+  atrous.Reset();
+  atrous.Forward(input, output);
+  CheckMatrices(output, referenceOutput, 1e-8);
+}
+
+/**
+ * Im2ColConvolution layer numerical gradient test.
+ */
+TEST_CASE("GradientIm2ColConvolutionLayerTest", "[ANNLayerTest]")
+{
+  // Convolution function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction() :
+        input(arma::randu(5 * 4 * 2, 1)),
+        target(arma::mat("1"))
+    {
+      model = new FFN<NegativeLogLikelihood<>, RandomInitialization>();
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<Convolution<Im2ColConvolution<ValidConvolution>,
+                             Im2ColConvolution<FullConvolution>,
+                             Im2ColConvolution<ValidConvolution>,
+                             arma::mat, arma::mat> >(2, 3, 3, 2, 1, 1, 1, 0,
+          5, 4);
+      model->Add<Linear<> >(5 * 3 * 3, 2);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 1);
+      model->Gradient(model->Parameters(), 0, gradient, 1);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<NegativeLogLikelihood<>, RandomInitialization>* model;
+    arma::mat input, target;
+  } function;
+
+  REQUIRE(CheckGradient(function) <= 1e-4);
+}
+
 /**
  * Test that the padding options in Transposed Convolution layer.
  */
@@ -5212,6 +5944,42 @@ TEST_CASE("JacobianPositionalEncodingTest", "[ANNLayerTest]")
   }
 }
 
+/**
+ * Check that the incremental Positional Encoding layer adds the encoding of
+ * the next positions.
+ */
+TEST_CASE("IncrementalPositionalEncodingTest", "[ANNLayerTest]")
+{
+  const size_t seqLength = 5;
+  const size_t embedDim = 4;
+  const size_t batchSize = 2;
+
+  arma::mat input = arma::randu(embedDim * seqLength, batchSize);
+  arma::mat output, stepOutput;
+
+  PositionalEncoding<> module(embedDim, seqLength);
+  module.Forward(input, output);
+
+  module.Incremental() = true;
+  REQUIRE(module.InputShape() == embedDim);
+
+  // Two steps at once, and then one step at a time.
+  module.Forward(arma::mat(input.rows(0, 2 * embedDim - 1)), stepOutput);
+  CheckMatrices(stepOutput, output.rows(0, 2 * embedDim - 1));
+  for (size_t i = 2; i < seqLength; ++i)
+  {
+    module.Forward(arma::mat(input.rows(i * embedDim, (i + 1) * embedDim - 1)),
+        stepOutput);
+    CheckMatrices(stepOutput,
+        output.rows(i * embedDim, (i + 1) * embedDim - 1));
+  }
+  REQUIRE(module.Offset() == seqLength);
+
+  module.ResetOffset();
+  module.Forward(arma::mat(input.rows(0, embedDim - 1)), stepOutput);
+  CheckMatrices(stepOutput, output.rows(0, embedDim - 1));
+}
+
 /**
  * Simple Multihead Attention test.
  */
@@ -5408,3 +6176,150 @@ TEST_CASE("GradientMultiheadAttentionTest", "[ANNLayerTest]")
 
   REQUIRE(CheckGradient(function) <= 3e-06);
 }
+
+/**
+ * Check that the blocked MultiheadAttention gives the same results as the
+ * MultiheadAttention that stores the attention weights.
+ */
+TEST_CASE("BlockedMultiheadAttentionTest", "[ANNLayerTest]")
+{
+  const size_t tgtSeqLen = 5;
+  const size_t srcSeqLen = 7;
+  const size_t embedDim = 4;
+  const size_t numHeads = 2;
+  const size_t batchSize = 3;
+
+  arma::mat attnMask = arma::zeros(tgtSeqLen, srcSeqLen);
+  for (size_t i = 0; i < tgtSeqLen; ++i)
+  {
+    for (size_t j = 0; j < srcSeqLen; ++j)
+    {
+      if (i < j)
+        attnMask(i, j) = std::numeric_limits<double>::lowest();
+    }
+  }
+
+  arma::mat keyPaddingMask = arma::zeros(1, srcSeqLen);
+  keyPaddingMask(srcSeqLen - 2) = std::numeric_limits<double>::lowest();
+
+  arma::mat input = arma::randu(embedDim * (tgtSeqLen + 2 * srcSeqLen),
+      batchSize);
+  arma::mat gy = arma::randu(embedDim * tgtSeqLen, batchSize);
+
+  // Blocks of a single element, blocks that divide neither sequence length,
+  // and blocks that hold the whole source sequence.
+  for (size_t blockSize = 1; blockSize <= 8; blockSize += 3)
+  {
+    MultiheadAttention<> module(tgtSeqLen, srcSeqLen, embedDim, numHeads);
+    MultiheadAttention<> blocked(tgtSeqLen, srcSeqLen, embedDim, numHeads,
+        blockSize);
+    REQUIRE(blocked.BlockSize() == blockSize);
+
+    module.Parameters().randu();
+    blocked.Parameters() = module.Parameters();
+    module.Reset();
+    blocked.Reset();
+
+    module.AttentionMask() = attnMask;
+    module.KeyPaddingMask() = keyPaddingMask;
+    blocked.AttentionMask() = attnMask;
+    blocked.KeyPaddingMask() = keyPaddingMask;
+
+    arma::mat output, blockedOutput;
+    module.Forward(input, output);
+    blocked.Forward(input, blockedOutput);
+    CheckMatrices(output, blockedOutput, 1e-6);
+
+    arma::mat g, blockedG;
+    module.Backward(input, gy, g);
+    blocked.Backward(input, gy, blockedG);
+    CheckMatrices(g, blockedG, 1e-6);
+
+    arma::mat gradient, blockedGradient;
+    module.Gradient(input, gy, gradient);
+    blocked.Gradient(input, gy, blockedGradient);
+    CheckMatrices(gradient, blockedGradient, 1e-6);
+  }
+
+  // The Jacobian of the blocked layer.
+  MultiheadAttention<> blocked(2, 3, embedDim, numHeads, 2);
+  blocked.Parameters().randu();
+  arma::mat jacobianInput(embedDim * (2 + 2 * 3), 1);
+  REQUIRE(JacobianTest(blocked, jacobianInput) <= 1e-5);
+}
+
+/**
+ * Check that each step of the MultiheadAttention decoding mode gives the same
+ * output as the Forward() pass over the whole prefix.
+ */
+TEST_CASE("DecodingMultiheadAttentionTest", "[ANNLayerTest]")
+{
+  const size_t seqLen = 6;
+  const size_t embedDim = 4;
+  const size_t numHeads = 2;
+  const size_t batchSize = 2;
+
+  arma::mat attnMask = arma::zeros(seqLen, seqLen);
+  for (size_t i = 0; i < seqLen; ++i)
+  {
+    for (size_t j = 0; j < seqLen; ++j)
+    {
+      if (i < j)
+        attnMask(i, j) = std::numeric_limits<double>::lowest();
+    }
+  }
+
+  arma::mat keyPaddingMask = arma::zeros(1, seqLen);
+  keyPaddingMask(1) = std::numeric_limits<double>::lowest();
+
+  const arma::cube query = arma::randu(embedDim, seqLen, batchSize);
+  const arma::cube key = arma::randu(embedDim, seqLen, batchSize);
+  const arma::cube value = arma::randu(embedDim, seqLen, batchSize);
+
+  MultiheadAttention<> decoder(seqLen, seqLen, embedDim, numHeads);
+  decoder.Parameters().randu();
+  decoder.Reset();
+  decoder.AttentionMask() = attnMask;
+  decoder.KeyPaddingMask() = keyPaddingMask;
+  decoder.Decoding() = true;
+  REQUIRE(decoder.InputShape() == 3 * embedDim);
+
+  arma::mat outputs(embedDim * seqLen, batchSize);
+  for (size_t p = 0; p < seqLen; ++p)
+  {
+    // The input of the step, laid out as the input of Forward().
+    arma::mat stepInput = arma::reshape(arma::join_cols(arma::join_cols(
+        arma::vectorise(query.cols(p, p)), arma::vectorise(key.cols(p, p))),
+        arma::vectorise(value.cols(p, p))), 3 * embedDim, batchSize);
+    arma::mat stepOutput;
+    decoder.Forward(stepInput, stepOutput);
+    REQUIRE(decoder.CacheLength() == p + 1);
+    outputs.rows(p * embedDim, (p + 1) * embedDim - 1) = stepOutput;
+
+    // The output of the last element of the Forward() pass over the prefix.
+    MultiheadAttention<> prefix(p + 1, p + 1, embedDim, numHeads);
+    prefix.Parameters() = decoder.Parameters();
+    prefix.Reset();
+    prefix.AttentionMask() = attnMask.submat(0, 0, p, p);
+    prefix.KeyPaddingMask() = keyPaddingMask.cols(0, p);
+
+    arma::mat prefixInput = arma::reshape(arma::join_cols(arma::join_cols(
+        arma::vectorise(query.cols(0, p)), arma::vectorise(key.cols(0, p))),
+        arma::vectorise(value.cols(0, p))), 3 * embedDim * (p + 1),
+        batchSize);
+    arma::mat prefixOutput;
+    prefix.Forward(prefixInput, prefixOutput);
+
+    CheckMatrices(stepOutput,
+        prefixOutput.rows(p * embedDim, (p + 1) * embedDim - 1), 1e-6);
+  }
+
+  // All the steps at once give the same outputs.
+  decoder.ResetCache();
+  arma::mat input = arma::reshape(arma::join_cols(arma::join_cols(
+      arma::vectorise(query), arma::vectorise(key)), arma::vectorise(value)),
+      3 * embedDim * seqLen, batchSize);
+  arma::mat output;
+  decoder.Forward(input, output);
+  CheckMatrices(output, outputs, 1e-6);
+}
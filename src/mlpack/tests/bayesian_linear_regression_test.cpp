@@ -193,3 +193,33 @@ TEST_CASE("EqualtoRidge", "[BayesianLinearRegressionTest]")
 
   REQUIRE(trial <= 3);
 }
+
+// Make sure that the hyperparameters found on a large dataset are a fixed point
+// of the evidence maximization, computed directly from the data.
+TEST_CASE("BayesianLinearRegressionFixedPointTest",
+          "[BayesianLinearRegressionTest]")
+{
+  arma::mat matX;
+  arma::rowvec y;
+  GenerateProblem(matX, y, 20000, 8, 0.5);
+
+  BayesianLinearRegression estimator(true, false, 100, 1e-8);
+  estimator.Train(matX, y);
+
+  // The solution is the ridge solution for the ratio of the hyperparameters.
+  const arma::mat centered = matX.each_col() - arma::mean(matX, 1);
+  const arma::rowvec t = y - arma::mean(y);
+  const arma::colvec omega = arma::solve(centered * centered.t() +
+      (estimator.Alpha() / estimator.Beta()) * arma::eye(8, 8),
+      centered * t.t());
+  for (size_t i = 0; i < omega.n_elem; ++i)
+    REQUIRE(estimator.Omega()[i] == Approx(omega[i]).epsilon(1e-6));
+
+  // The noise precision matches the residual of that solution.
+  const arma::rowvec residual = t - omega.t() * centered;
+  const arma::vec eigVal = arma::eig_sym(centered * centered.t());
+  const double gamma = arma::accu(eigVal / (eigVal + estimator.Alpha() /
+      estimator.Beta()));
+  const double beta = (matX.n_cols - gamma) / arma::dot(residual, residual);
+  REQUIRE(estimator.Beta() == Approx(beta).epsilon(1e-4));
+}
@@ -0,0 +1,83 @@
+/**
+ * @file tests/benchmarks/ann_benchmark.cpp
+ *
+ * Benchmarks of the forward pass, the backward pass and the computation of
+ * the gradient of the most used layers of neural networks, for a batch of
+ * points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+
+#include "../catch.hpp"
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::ann;
+
+/**
+ * Benchmark the given layer on the given batch: the forward pass, then the
+ * backward pass and the gradient with the output as the error.  The parameters
+ * of the layer must be initialized.
+ */
+template<typename LayerType>
+void BenchmarkLayer(LayerType& layer, const arma::mat& input)
+{
+  arma::mat output, delta;
+  BENCHMARK("forward")
+  {
+    layer.Forward(input, output);
+    return output[0];
+  };
+
+  BENCHMARK("backward")
+  {
+    layer.Backward(input, output, delta);
+    return delta[0];
+  };
+
+  arma::mat gradient(arma::size(layer.Parameters()));
+  BENCHMARK("gradient")
+  {
+    layer.Gradient(input, output, gradient);
+    return gradient[0];
+  };
+}
+
+TEST_CASE("LinearBenchmark", "[ANNBenchmark]")
+{
+  const size_t batchSize = GENERATE(1, 64);
+  const size_t size = GENERATE(100, 1000);
+
+  DYNAMIC_SECTION(batchSize << " points, " << size << " units")
+  {
+    Linear<> layer(size, size);
+    layer.Parameters().randu();
+    layer.Reset();
+
+    arma::mat input(size, batchSize, arma::fill::randu);
+    BenchmarkLayer(layer, input);
+  }
+}
+
+TEST_CASE("ConvolutionBenchmark", "[ANNBenchmark]")
+{
+  const size_t batchSize = GENERATE(1, 16);
+  const size_t maps = GENERATE(3, 16);
+  const size_t width = 32;
+  const size_t height = 32;
+
+  DYNAMIC_SECTION(batchSize << " points, " << maps << " maps")
+  {
+    Convolution<> layer(maps, maps, 3, 3, 1, 1, 1, 1, width, height);
+    layer.Parameters().randu();
+    layer.Reset();
+
+    arma::mat input(width * height * maps, batchSize, arma::fill::randu);
+    BenchmarkLayer(layer, input);
+  }
+}
@@ -0,0 +1,111 @@
+/**
+ * @file tests/benchmarks/benchmark_data.hpp
+ *
+ * Utilities for the benchmarks: synthetic datasets, and the serialized size
+ * and loading of models.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_TESTS_BENCHMARKS_BENCHMARK_DATA_HPP
+#define MLPACK_TESTS_BENCHMARKS_BENCHMARK_DATA_HPP
+
+#include <mlpack/core.hpp>
+#include "../catch.hpp"
+
+namespace mlpack {
+namespace benchmark {
+
+/**
+ * Generate a classification dataset: each class is a Gaussian around a random
+ * center, with the centers close enough that the classes overlap.
+ *
+ * @param numPoints Number of points to generate.
+ * @param dimensionality Number of dimensions of the points.
+ * @param numClasses Number of classes.
+ * @param data Matrix to store the points in.
+ * @param labels Row to store the labels in.
+ */
+inline void ClassificationData(const size_t numPoints,
+                               const size_t dimensionality,
+                               const size_t numClasses,
+                               arma::mat& data,
+                               arma::Row<size_t>& labels)
+{
+  const arma::mat centers = 2.0 * arma::randu<arma::mat>(dimensionality,
+      numClasses);
+
+  data.randn(dimensionality, numPoints);
+  labels.set_size(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    labels[i] = math::RandInt(numClasses);
+    data.col(i) += centers.col(labels[i]);
+  }
+}
+
+/**
+ * Generate a regression dataset, whose responses are a nonlinear function of
+ * the first dimensions plus noise.
+ *
+ * @param numPoints Number of points to generate.
+ * @param dimensionality Number of dimensions of the points.
+ * @param data Matrix to store the points in.
+ * @param responses Row to store the responses in.
+ */
+inline void RegressionData(const size_t numPoints,
+                           const size_t dimensionality,
+                           arma::mat& data,
+                           arma::rowvec& responses)
+{
+  data.randu(dimensionality, numPoints);
+  responses = arma::sin(4.0 * data.row(0)) +
+      arma::randn<arma::rowvec>(numPoints) * 0.1;
+  if (dimensionality > 1)
+    responses += 2.0 * arma::square(data.row(1));
+}
+
+/**
+ * Serialize the given model to a binary archive in the given string, and
+ * return the number of bytes of the archive.
+ */
+template<typename ModelType>
+size_t SerializeModel(const ModelType& model, std::string& buffer)
+{
+  std::ostringstream oss;
+  {
+    cereal::BinaryOutputArchive ar(oss);
+    ar(cereal::make_nvp("model", model));
+  }
+
+  buffer = oss.str();
+  return buffer.size();
+}
+
+/**
+ * Load a model from the binary archive in the given string.
+ */
+template<typename ModelType>
+void LoadModel(const std::string& buffer, ModelType& model)
+{
+  std::istringstream iss(buffer);
+  cereal::BinaryInputArchive ar(iss);
+  ar(cereal::make_nvp("model", model));
+}
+
+/**
+ * Report a size next to the benchmark results.  It is a warning, so that it is
+ * printed by every reporter (including the XML one, where it is a Warning
+ * element).
+ */
+inline void ReportSize(const std::string& name, const size_t bytes)
+{
+  WARN(name << " (bytes): " << bytes);
+}
+
+} // namespace benchmark
+} // namespace mlpack
+
+#endif
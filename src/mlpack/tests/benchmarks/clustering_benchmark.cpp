@@ -0,0 +1,108 @@
+/**
+ * @file tests/benchmarks/clustering_benchmark.cpp
+ *
+ * Benchmarks of the clustering methods: a fixed number of iterations of
+ * k-means with each Lloyd step type, and of EM for Gaussian mixture models.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+#include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include <mlpack/methods/kmeans/elkan_kmeans.hpp>
+#include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
+#include <mlpack/methods/kmeans/naive_kmeans.hpp>
+#include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
+#include <mlpack/methods/gmm/gmm.hpp>
+
+#include "../catch.hpp"
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+using namespace mlpack::gmm;
+using namespace mlpack::kmeans;
+using namespace mlpack::metric;
+
+//! The number of iterations of each run, so that every step type does the same
+//! amount of work.
+const size_t iterations = 10;
+
+/**
+ * Benchmark the given Lloyd step type: the same initial centroids are used for
+ * every run.
+ */
+template<template<class, class> class LloydStepType>
+void BenchmarkKMeans(const std::string& stepName,
+                     const arma::mat& data,
+                     const arma::mat& initialCentroids)
+{
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      LloydStepType> kmeans(iterations);
+
+  arma::mat centroids;
+  BENCHMARK(stepName)
+  {
+    centroids = initialCentroids;
+    kmeans.Cluster(data, initialCentroids.n_cols, centroids, true);
+    return centroids[0];
+  };
+}
+
+TEST_CASE("KMeansBenchmark", "[ClusteringBenchmark]")
+{
+  const size_t numPoints = GENERATE(10000, 100000);
+  const size_t dimensionality = GENERATE(5, 50);
+  const size_t clusters = GENERATE(10, 100);
+
+  arma::mat data;
+  arma::Row<size_t> labels;
+  ClassificationData(numPoints, dimensionality, clusters, data, labels);
+  const arma::mat initialCentroids = data.cols(0, clusters - 1);
+
+  DYNAMIC_SECTION(numPoints << " points, " << dimensionality << " dims, "
+      << clusters << " clusters")
+  {
+    BenchmarkKMeans<NaiveKMeans>("naive", data, initialCentroids);
+    BenchmarkKMeans<ElkanKMeans>("elkan", data, initialCentroids);
+    BenchmarkKMeans<HamerlyKMeans>("hamerly", data, initialCentroids);
+    BenchmarkKMeans<PellegMooreKMeans>("pelleg-moore", data,
+        initialCentroids);
+    BenchmarkKMeans<DefaultDualTreeKMeans>("dual-tree", data,
+        initialCentroids);
+  }
+}
+
+TEST_CASE("GMMBenchmark", "[ClusteringBenchmark]")
+{
+  const size_t numPoints = GENERATE(10000, 100000);
+  const size_t dimensionality = GENERATE(5, 20);
+  const size_t gaussians = 10;
+
+  arma::mat data;
+  arma::Row<size_t> labels;
+  ClassificationData(numPoints, dimensionality, gaussians, data, labels);
+
+  DYNAMIC_SECTION(numPoints << " points, " << dimensionality << " dims")
+  {
+    // The model is initialized with k-means once; then each run does the same
+    // number of EM iterations from it.
+    GMM initialModel(gaussians, dimensionality);
+    initialModel.Train(data, 1, false, EMFit<>(1));
+
+    EMFit<> fitter(iterations, 0.0);
+    BENCHMARK("EM iterations")
+    {
+      GMM model(initialModel);
+      return model.Train(data, 1, true, fitter);
+    };
+
+    BENCHMARK("log-likelihood")
+    {
+      return initialModel.LogLikelihood(data);
+    };
+  }
+}
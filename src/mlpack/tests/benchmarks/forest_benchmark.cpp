@@ -0,0 +1,224 @@
+/**
+ * @file tests/benchmarks/forest_benchmark.cpp
+ *
+ * Benchmarks of the tree-based models: training time, the latency of the
+ * prediction of a set of points and of a single point, the size of the
+ * serialized model and its loading time, for a few dataset shapes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/decision_tree/decision_tree.hpp>
+#include <mlpack/methods/decision_tree/flat_forest.hpp>
+#include <mlpack/methods/hoeffding_trees/hoeffding_tree.hpp>
+#include <mlpack/methods/random_forest/random_forest.hpp>
+#include <mlpack/methods/xgboost/xgboost.hpp>
+
+#include "../catch.hpp"
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+using namespace mlpack::ensemble;
+using namespace mlpack::tree;
+
+const size_t numClasses = 3;
+
+TEST_CASE("DecisionTreeBenchmark", "[ForestBenchmark]")
+{
+  const size_t numPoints = GENERATE(1000, 20000);
+  const size_t dimensionality = GENERATE(10, 50);
+
+  arma::mat data;
+  arma::Row<size_t> labels;
+  ClassificationData(numPoints, dimensionality, numClasses, data, labels);
+
+  DYNAMIC_SECTION(numPoints << " points, " << dimensionality << " dims")
+  {
+    BENCHMARK("train")
+    {
+      return DecisionTree<>(data, labels, numClasses).NumChildren();
+    };
+
+    DecisionTree<> tree(data, labels, numClasses);
+    arma::Row<size_t> predictions;
+    BENCHMARK("classify set")
+    {
+      tree.Classify(data, predictions);
+      return predictions[0];
+    };
+
+    size_t i = 0;
+    BENCHMARK("classify point")
+    {
+      return tree.Classify(data.col(i++ % numPoints));
+    };
+
+    std::string buffer;
+    ReportSize("serialized DecisionTree", SerializeModel(tree, buffer));
+    BENCHMARK("load")
+    {
+      DecisionTree<> loaded;
+      LoadModel(buffer, loaded);
+      return loaded.NumChildren();
+    };
+  }
+}
+
+TEST_CASE("RandomForestBenchmark", "[ForestBenchmark]")
+{
+  const size_t numPoints = GENERATE(1000, 20000);
+  const size_t dimensionality = GENERATE(10, 50);
+  const size_t numTrees = 20;
+
+  arma::mat data;
+  arma::Row<size_t> labels;
+  ClassificationData(numPoints, dimensionality, numClasses, data, labels);
+
+  DYNAMIC_SECTION(numPoints << " points, " << dimensionality << " dims")
+  {
+    BENCHMARK("train")
+    {
+      return RandomForest<>(data, labels, numClasses, numTrees).NumTrees();
+    };
+
+    RandomForest<> forest(data, labels, numClasses, numTrees);
+    arma::Row<size_t> predictions;
+    BENCHMARK("classify set")
+    {
+      forest.Classify(data, predictions);
+      return predictions[0];
+    };
+
+    size_t i = 0;
+    BENCHMARK("classify point")
+    {
+      return forest.Classify(data.col(i++ % numPoints));
+    };
+
+    std::string buffer;
+    ReportSize("serialized RandomForest", SerializeModel(forest, buffer));
+    BENCHMARK("load")
+    {
+      RandomForest<> loaded;
+      LoadModel(buffer, loaded);
+      return loaded.NumTrees();
+    };
+
+    // The flat form of the same forest.
+    FlatForest flatForest;
+    forest.Flatten(flatForest);
+    BENCHMARK("flat forest classify set")
+    {
+      flatForest.Classify(data, predictions);
+      return predictions[0];
+    };
+
+    BENCHMARK("flat forest classify point")
+    {
+      return flatForest.Classify(data.col(i++ % numPoints));
+    };
+
+    ReportSize("serialized FlatForest", SerializeModel(flatForest, buffer));
+    BENCHMARK("flat forest load")
+    {
+      FlatForest loaded;
+      LoadModel(buffer, loaded);
+      return loaded.NumTrees();
+    };
+  }
+}
+
+TEST_CASE("HoeffdingTreeBenchmark", "[ForestBenchmark]")
+{
+  const size_t numPoints = GENERATE(1000, 20000);
+  const size_t dimensionality = GENERATE(10, 50);
+
+  arma::mat data;
+  arma::Row<size_t> labels;
+  ClassificationData(numPoints, dimensionality, numClasses, data, labels);
+  data::DatasetInfo info(dimensionality);
+
+  DYNAMIC_SECTION(numPoints << " points, " << dimensionality << " dims")
+  {
+    BENCHMARK("train (streaming)")
+    {
+      return HoeffdingTree<>(data, info, labels, numClasses,
+          false).NumChildren();
+    };
+
+    BENCHMARK("train (batch)")
+    {
+      return HoeffdingTree<>(data, info, labels, numClasses,
+          true).NumChildren();
+    };
+
+    HoeffdingTree<> tree(data, info, labels, numClasses, false);
+    arma::Row<size_t> predictions;
+    BENCHMARK("classify set")
+    {
+      tree.Classify(data, predictions);
+      return predictions[0];
+    };
+
+    size_t i = 0;
+    BENCHMARK("classify point")
+    {
+      return tree.Classify(data.col(i++ % numPoints));
+    };
+
+    std::string buffer;
+    ReportSize("serialized HoeffdingTree", SerializeModel(tree, buffer));
+    BENCHMARK("load")
+    {
+      HoeffdingTree<> loaded;
+      LoadModel(buffer, loaded);
+      return loaded.NumChildren();
+    };
+  }
+}
+
+TEST_CASE("XGBoostBenchmark", "[ForestBenchmark]")
+{
+  const size_t numPoints = GENERATE(1000, 20000);
+  const size_t dimensionality = GENERATE(10, 50);
+  const size_t numTrees = 50;
+
+  arma::mat data;
+  arma::rowvec responses;
+  RegressionData(numPoints, dimensionality, data, responses);
+
+  DYNAMIC_SECTION(numPoints << " points, " << dimensionality << " dims")
+  {
+    BENCHMARK("train")
+    {
+      return XGBoost<>(data, responses, numTrees).NumTrees();
+    };
+
+    XGBoost<> model(data, responses, numTrees);
+    arma::rowvec predictions;
+    BENCHMARK("predict set")
+    {
+      model.Predict(data, predictions);
+      return predictions[0];
+    };
+
+    size_t i = 0;
+    BENCHMARK("predict point")
+    {
+      return model.Predict(data.col(i++ % numPoints));
+    };
+
+    std::string buffer;
+    ReportSize("serialized XGBoost", SerializeModel(model, buffer));
+    BENCHMARK("load")
+    {
+      XGBoost<> loaded;
+      LoadModel(buffer, loaded);
+      return loaded.NumTrees();
+    };
+  }
+}
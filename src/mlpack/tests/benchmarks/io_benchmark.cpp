@@ -0,0 +1,62 @@
+/**
+ * @file tests/benchmarks/io_benchmark.cpp
+ *
+ * Benchmarks of the loading and saving of datasets as CSV and in the binary
+ * format of Armadillo.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+
+#include "../catch.hpp"
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+
+/**
+ * Benchmark saving the given dataset to the given file and loading it back;
+ * the file is removed afterwards.
+ */
+void BenchmarkFormat(const std::string& filename,
+                     const arma::mat& data)
+{
+  BENCHMARK("save")
+  {
+    return data::Save(filename, data, true);
+  };
+
+  arma::mat loaded;
+  BENCHMARK("load")
+  {
+    data::Load(filename, loaded, true);
+    return loaded.n_cols;
+  };
+
+  remove(filename.c_str());
+}
+
+TEST_CASE("DatasetIOBenchmark", "[IOBenchmark]")
+{
+  const size_t numPoints = GENERATE(10000, 100000);
+  const size_t dimensionality = GENERATE(10, 100);
+
+  arma::mat data;
+  arma::Row<size_t> labels;
+  ClassificationData(numPoints, dimensionality, 3, data, labels);
+
+  DYNAMIC_SECTION("CSV / " << numPoints << " points, " << dimensionality
+      << " dims")
+  {
+    BenchmarkFormat("mlpack_benchmark_data.csv", data);
+  }
+
+  DYNAMIC_SECTION("binary / " << numPoints << " points, " << dimensionality
+      << " dims")
+  {
+    BenchmarkFormat("mlpack_benchmark_data.bin", data);
+  }
+}
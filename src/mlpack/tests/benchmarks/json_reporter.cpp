@@ -0,0 +1,160 @@
+/**
+ * @file tests/benchmarks/json_reporter.cpp
+ *
+ * A Catch reporter that writes the results of the benchmarks as JSON, so that
+ * the results of two commits can be compared by a script.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "../catch.hpp"
+
+namespace mlpack {
+namespace benchmark {
+
+/**
+ * The JSON reporter writes one object with a "results" array.  Each benchmark
+ * gives an element of type "benchmark" with its test case, its sections
+ * (joined with " / ") and its name, the number of samples and of iterations
+ * per sample, and the mean (with its confidence interval) and the standard
+ * deviation of the time of one iteration, in nanoseconds:
+ *
+ * @code
+ * { "type": "benchmark", "test": "KNNBenchmark",
+ *   "section": "KDTree / 10000 points, 3 dims", "name": "search",
+ *   "samples": 100, "iterations": 1, "mean": 3.1e6, "meanLow": 3.0e6,
+ *   "meanHigh": 3.2e6, "standardDeviation": 1.1e5 }
+ * @endcode
+ *
+ * The sizes reported by ReportSize() give elements of type "message", and
+ * failures give elements of type "failure", with the same test and section and
+ * a "message".  Select it with `--reporter json`.
+ */
+class JSONReporter : public Catch::StreamingReporterBase<JSONReporter>
+{
+ public:
+  //! Create the reporter.
+  JSONReporter(const Catch::ReporterConfig& config) :
+      StreamingReporterBase(config),
+      firstResult(true)
+  {
+    // Nothing to do.
+  }
+
+  //! Get the description given by --list-reporters.
+  static std::string getDescription()
+  {
+    return "Reports the results of the benchmarks as JSON";
+  }
+
+  void testRunStarting(const Catch::TestRunInfo& info) override
+  {
+    StreamingReporterBase::testRunStarting(info);
+    stream << "{\n  \"results\": [";
+  }
+
+  void benchmarkEnded(const Catch::BenchmarkStats<>& stats) override
+  {
+    StartResult("benchmark");
+    stream << ", \"name\": " << Quote(stats.info.name)
+        << ", \"samples\": " << stats.samples.size()
+        << ", \"iterations\": " << stats.info.iterations
+        << ", \"mean\": " << stats.mean.point.count()
+        << ", \"meanLow\": " << stats.mean.lower_bound.count()
+        << ", \"meanHigh\": " << stats.mean.upper_bound.count()
+        << ", \"standardDeviation\": "
+        << stats.standardDeviation.point.count() << " }";
+  }
+
+  void benchmarkFailed(const std::string& error) override
+  {
+    StartResult("failure");
+    stream << ", \"message\": " << Quote(error) << " }";
+  }
+
+  void assertionStarting(const Catch::AssertionInfo& /* info */) override { }
+
+  bool assertionEnded(const Catch::AssertionStats& stats) override
+  {
+    const Catch::AssertionResult& result = stats.assertionResult;
+    if (result.getResultType() == Catch::ResultWas::Warning)
+    {
+      StartResult("message");
+      stream << ", \"message\": " << Quote(result.getMessage()) << " }";
+    }
+    else if (!result.isOk())
+    {
+      StartResult("failure");
+      stream << ", \"message\": " << Quote(result.hasMessage() ?
+          result.getMessage() : result.getExpressionInMacro()) << " }";
+    }
+
+    return true;
+  }
+
+  void testRunEnded(const Catch::TestRunStats& stats) override
+  {
+    stream << "\n  ]\n}\n";
+    StreamingReporterBase::testRunEnded(stats);
+  }
+
+ private:
+  //! Start the element of a result of the given type, with the current test
+  //! case and sections.
+  void StartResult(const std::string& type)
+  {
+    stream << (firstResult ? "\n" : ",\n");
+    firstResult = false;
+
+    // The first section is the test case itself.
+    std::string section;
+    for (size_t i = 1; i < m_sectionStack.size(); ++i)
+      section += ((i > 1) ? " / " : "") + m_sectionStack[i].name;
+
+    stream << "    { \"type\": " << Quote(type) << ", \"test\": "
+        << Quote(currentTestCaseInfo->name) << ", \"section\": "
+        << Quote(section);
+  }
+
+  //! Quote and escape the given string for JSON.
+  static std::string Quote(const std::string& s)
+  {
+    std::string quoted = "\"";
+    for (const char c : s)
+    {
+      if (c == '"' || c == '\\')
+      {
+        quoted += '\\';
+        quoted += c;
+      }
+      else if (c == '\n')
+      {
+        quoted += "\\n";
+      }
+      else if ((unsigned char) c < 0x20)
+      {
+        char escaped[8];
+        snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned int) c);
+        quoted += escaped;
+      }
+      else
+      {
+        quoted += c;
+      }
+    }
+
+    return quoted + "\"";
+  }
+
+  //! Whether no result has been written yet.
+  bool firstResult;
+};
+
+} // namespace benchmark
+} // namespace mlpack
+
+// The registration macro pastes the class name into an identifier.
+using mlpack::benchmark::JSONReporter;
+CATCH_REGISTER_REPORTER("json", JSONReporter)
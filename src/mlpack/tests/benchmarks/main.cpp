@@ -0,0 +1,24 @@
+/**
+ * @file tests/benchmarks/main.cpp
+ *
+ * Main file for the Catch benchmarks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+
+// CATCH_CONFIG_ENABLE_BENCHMARKING is defined by the build for every file of
+// the benchmark executable.
+#define CATCH_CONFIG_RUNNER  // we will define main()
+#include "../catch.hpp"
+
+int main(int argc, char** argv)
+{
+  // Use the same data in every run, so that the results can be compared.
+  mlpack::math::RandomSeed(42);
+
+  return Catch::Session().run(argc, argv);
+}
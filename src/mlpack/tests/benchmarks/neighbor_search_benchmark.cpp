@@ -0,0 +1,141 @@
+/**
+ * @file tests/benchmarks/neighbor_search_benchmark.cpp
+ *
+ * Benchmarks of the trees through k-nearest-neighbor search: tree building,
+ * dual-tree and single-tree search for each tree type, and the serialization
+ * of a model, for low- and higher-dimensional data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include "../catch.hpp"
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+using namespace mlpack::metric;
+using namespace mlpack::neighbor;
+using namespace mlpack::tree;
+
+const size_t k = 5;
+
+/**
+ * Benchmark the given tree type on a dataset of each shape: building the tree,
+ * searching the neighbors of every point with a dual-tree and a single-tree
+ * traversal, and loading the serialized model.
+ */
+template<template<typename, typename, typename> class TreeType>
+void BenchmarkTree(const std::string& treeName)
+{
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      TreeType> KNNType;
+  typedef typename KNNType::Tree Tree;
+
+  const size_t numPoints = GENERATE(10000, 50000);
+  const size_t dimensionality = GENERATE(3, 20);
+
+  // Clustered data, like most real datasets.
+  arma::mat data;
+  arma::Row<size_t> labels;
+  ClassificationData(numPoints, dimensionality, 10, data, labels);
+
+  DYNAMIC_SECTION(treeName << " / " << numPoints << " points, "
+      << dimensionality << " dims")
+  {
+    BENCHMARK("build")
+    {
+      return Tree(data).NumDescendants();
+    };
+
+    KNNType knn(data);
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    BENCHMARK("dual-tree search")
+    {
+      knn.Search(k, neighbors, distances);
+      return neighbors[0];
+    };
+
+    knn.SearchMode() = SINGLE_TREE_MODE;
+    BENCHMARK("single-tree search")
+    {
+      knn.Search(k, neighbors, distances);
+      return neighbors[0];
+    };
+
+    std::string buffer;
+    ReportSize("serialized " + treeName + " model",
+        SerializeModel(knn, buffer));
+    BENCHMARK("load")
+    {
+      KNNType loaded;
+      LoadModel(buffer, loaded);
+      return loaded.ReferenceSet().n_cols;
+    };
+  }
+}
+
+TEST_CASE("KDTreeKNNBenchmark", "[NeighborSearchBenchmark]")
+{
+  BenchmarkTree<KDTree>("KDTree");
+}
+
+TEST_CASE("BallTreeKNNBenchmark", "[NeighborSearchBenchmark]")
+{
+  BenchmarkTree<BallTree>("BallTree");
+}
+
+TEST_CASE("VPTreeKNNBenchmark", "[NeighborSearchBenchmark]")
+{
+  BenchmarkTree<VPTree>("VPTree");
+}
+
+TEST_CASE("RPTreeKNNBenchmark", "[NeighborSearchBenchmark]")
+{
+  BenchmarkTree<RPTree>("RPTree");
+}
+
+TEST_CASE("UBTreeKNNBenchmark", "[NeighborSearchBenchmark]")
+{
+  BenchmarkTree<UBTree>("UBTree");
+}
+
+TEST_CASE("OctreeKNNBenchmark", "[NeighborSearchBenchmark]")
+{
+  BenchmarkTree<Octree>("Octree");
+}
+
+TEST_CASE("CoverTreeKNNBenchmark", "[NeighborSearchBenchmark]")
+{
+  BenchmarkTree<StandardCoverTree>("CoverTree");
+}
+
+TEST_CASE("RTreeKNNBenchmark", "[NeighborSearchBenchmark]")
+{
+  BenchmarkTree<RTree>("RTree");
+}
+
+TEST_CASE("RStarTreeKNNBenchmark", "[NeighborSearchBenchmark]")
+{
+  BenchmarkTree<RStarTree>("RStarTree");
+}
+
+TEST_CASE("XTreeKNNBenchmark", "[NeighborSearchBenchmark]")
+{
+  BenchmarkTree<XTree>("XTree");
+}
+
+TEST_CASE("HilbertRTreeKNNBenchmark", "[NeighborSearchBenchmark]")
+{
+  BenchmarkTree<HilbertRTree>("HilbertRTree");
+}
+
+TEST_CASE("RPlusTreeKNNBenchmark", "[NeighborSearchBenchmark]")
+{
+  BenchmarkTree<RPlusTree>("RPlusTree");
+}
@@ -65,3 +65,22 @@ TEST_CASE("BinerizeAll", "[BinarizeTest]")
   REQUIRE(output(2, 1) == Approx(1.0).epsilon(1e-7)); // 8
   REQUIRE(output(2, 2) == Approx(1.0).epsilon(1e-7)); // 9
 }
+
+TEST_CASE("BinarizeInPlace", "[BinarizeTest]")
+{
+  mat input = randu<mat>(5, 1000);
+  const double threshold = 0.5;
+
+  mat expected;
+  Binarize<double>(input, expected, threshold);
+  mat data = input;
+  Binarize(data, threshold);
+  CheckMatrices(data, expected);
+
+  Binarize<double>(input, expected, threshold, 2);
+  data = input;
+  Binarize(data, threshold, 2);
+  CheckMatrices(data, expected);
+
+  REQUIRE_THROWS_AS(Binarize(data, threshold, 5), std::invalid_argument);
+}
@@ -13,6 +13,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/cf/cf.hpp>
+#include <mlpack/methods/cf/decomposition_policies/als_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/batch_svd_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/bias_svd_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/randomized_svd_method.hpp>
@@ -505,6 +506,58 @@ void Serialization()
   }
 }
 
+/**
+ * Make sure that the recommendations found with a maximum inner product search
+ * have the same ratings as the recommendations of GetRecommendations().
+ */
+template<typename DecompositionPolicy,
+         typename NormalizationType = NoNormalization>
+void MIPSRecommendations()
+{
+  DecompositionPolicy decomposition;
+  const size_t numRecs = 10;
+
+  arma::mat dataset;
+  if (!data::Load("GroupLensSmall.csv", dataset))
+    FAIL("Cannot load test dataset GroupLensSmall.csv!");
+
+  CFType<DecompositionPolicy, NormalizationType> c(dataset, decomposition, 5,
+      5, 30);
+
+  arma::Mat<size_t> recommendations, mipsRecommendations;
+  c.GetRecommendations(numRecs, recommendations);
+  c.GetMIPSRecommendations(numRecs, mipsRecommendations);
+
+  REQUIRE(mipsRecommendations.n_rows == numRecs);
+  REQUIRE(mipsRecommendations.n_cols == recommendations.n_cols);
+
+  // Ties may be ordered differently, so compare the predicted ratings of the
+  // recommendations.
+  arma::Mat<size_t> combinations(2, recommendations.n_elem);
+  arma::Mat<size_t> mipsCombinations(2, recommendations.n_elem);
+  for (size_t i = 0; i < recommendations.n_cols; ++i)
+  {
+    for (size_t j = 0; j < numRecs; ++j)
+    {
+      const size_t index = i * numRecs + j;
+      combinations(0, index) = i;
+      combinations(1, index) = recommendations(j, i);
+      mipsCombinations(0, index) = i;
+      mipsCombinations(1, index) = mipsRecommendations(j, i);
+
+      // The user must not have rated the item already.
+      REQUIRE(c.CleanedData()(mipsRecommendations(j, i), i) == 0.0);
+    }
+  }
+
+  arma::vec predictions, mipsPredictions;
+  c.Predict(combinations, predictions);
+  c.Predict(mipsCombinations, mipsPredictions);
+
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    REQUIRE(mipsPredictions[i] == Approx(predictions[i]).epsilon(1e-5));
+}
+
 /**
  * Make sure that correct number of recommendations are generated when query
  * set for randomized SVD.
@@ -578,6 +631,43 @@ TEST_CASE("CFGetRecommendationsAllUsersSVDPPTest", "[CFTest]")
   GetRecommendationsAllUsers<SVDPlusPlusPolicy>();
 }
 
+/**
+ * Make sure that correct number of recommendations are generated when query
+ * set for ALS.
+ */
+TEST_CASE("CFGetRecommendationsAllUsersALSTest", "[CFTest]")
+{
+  GetRecommendationsAllUsers<ALSPolicy>();
+}
+
+/**
+ * Make sure that the maximum inner product search gives the best
+ * recommendations for NMF.
+ */
+TEST_CASE("CFMIPSRecommendationsNMFTest", "[CFTest]")
+{
+  MIPSRecommendations<NMFPolicy>();
+}
+
+/**
+ * Make sure that the maximum inner product search gives the best
+ * recommendations for Bias SVD and item mean normalization, which both add an
+ * offset for each item.
+ */
+TEST_CASE("CFMIPSRecommendationsBiasSVDItemMeanTest", "[CFTest]")
+{
+  MIPSRecommendations<BiasSVDPolicy, ItemMeanNormalization>();
+}
+
+/**
+ * Make sure that the maximum inner product search gives the best
+ * recommendations for SVDPlusPlus and z-score normalization.
+ */
+TEST_CASE("CFMIPSRecommendationsSVDPPZScoreTest", "[CFTest]")
+{
+  MIPSRecommendations<SVDPlusPlusPolicy, ZScoreNormalization>();
+}
+
 /**
  * Make sure that the recommendations are generated for queried users only
  * for randomized SVD.
@@ -786,6 +876,161 @@ TEST_CASE("CFPredictSVDPPTest", "[CFTest]")
   CFPredict<SVDPlusPlusPolicy>();
 }
 
+/**
+ * Make sure that Predict() is returning reasonable results for ALS.
+ */
+TEST_CASE("CFPredictALSTest", "[CFTest]")
+{
+  CFPredict<ALSPolicy>();
+}
+
+/**
+ * Make sure that ALS with implicit feedback gives higher scores to the
+ * observed entries than to the unobserved ones.
+ */
+TEST_CASE("ALSImplicitFeedbackTest", "[CFTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("GroupLensSmall.csv", dataset))
+    FAIL("Cannot load test dataset GroupLensSmall.csv!");
+
+  ALSPolicy decomposition(0.05, true, 10.0);
+  CFType<ALSPolicy> c(dataset, decomposition, 5, 5, 20);
+
+  const arma::sp_mat& cleanedData = c.CleanedData();
+  const arma::mat scores = c.Decomposition().W() * c.Decomposition().H();
+
+  double observed = 0.0;
+  arma::sp_mat::const_iterator it = cleanedData.begin();
+  for (; it != cleanedData.end(); ++it)
+    observed += scores(it.row(), it.col());
+  double unobserved = arma::accu(scores) - observed;
+  observed /= cleanedData.n_nonzero;
+  unobserved /= (scores.n_elem - cleanedData.n_nonzero);
+
+  // The preferences are fit to 1 for observed entries and 0 otherwise.
+  REQUIRE(observed > 0.3);
+  REQUIRE(unobserved < 0.1);
+  REQUIRE(observed > 3 * unobserved);
+}
+
+/**
+ * Hold out the ratings of the last user, train, and fold the user back in with
+ * AddRatings().  The folded-in factors should fit the ratings of the user
+ * better than the mean rating does.
+ */
+template<typename DecompositionPolicy,
+         typename NormalizationType = NoNormalization>
+void FoldInNewUser()
+{
+  DecompositionPolicy decomposition;
+
+  arma::mat dataset;
+  if (!data::Load("GroupLensSmall.csv", dataset))
+    FAIL("Cannot load test dataset GroupLensSmall.csv!");
+
+  const size_t user = (size_t) arma::max(dataset.row(0));
+  arma::mat heldOut = dataset.cols(arma::find(dataset.row(0) == (double) user));
+  arma::mat trainData = dataset.cols(arma::find(dataset.row(0) != (double) user));
+
+  CFType<DecompositionPolicy, NormalizationType> c(trainData, decomposition,
+      5, 5, 30);
+  REQUIRE(c.CleanedData().n_cols == user);
+
+  // Only items that the model knows can be folded in.
+  heldOut = heldOut.cols(arma::find(heldOut.row(1) <
+      (double) c.CleanedData().n_rows));
+  c.AddRatings(heldOut);
+
+  REQUIRE(c.CleanedData().n_cols == user + 1);
+  REQUIRE(c.CleanedData().col(user).n_nonzero == heldOut.n_cols);
+  REQUIRE(c.Decomposition().H().n_cols == user + 1);
+
+  const double mean = arma::mean(trainData.row(2));
+  double foldInError = 0.0, meanError = 0.0;
+  for (size_t i = 0; i < heldOut.n_cols; ++i)
+  {
+    const size_t item = (size_t) heldOut(1, i);
+    const double rating = c.Normalization().Denormalize(user, item,
+        c.Decomposition().GetRating(user, item));
+    foldInError += std::pow(rating - heldOut(2, i), 2.0);
+    meanError += std::pow(mean - heldOut(2, i), 2.0);
+  }
+
+  REQUIRE(foldInError < meanError);
+}
+
+/**
+ * Fold a new user into an ALS model.
+ */
+TEST_CASE("CFFoldInNewUserALSTest", "[CFTest]")
+{
+  FoldInNewUser<ALSPolicy>();
+}
+
+/**
+ * Fold a new user into a BiasSVD model with user mean normalization.
+ */
+TEST_CASE("CFFoldInNewUserBiasSVDUserMeanTest", "[CFTest]")
+{
+  FoldInNewUser<BiasSVDPolicy, UserMeanNormalization>();
+}
+
+/**
+ * Fold a new user into an SVD++ model.
+ */
+TEST_CASE("CFFoldInNewUserSVDPPTest", "[CFTest]")
+{
+  FoldInNewUser<SVDPlusPlusPolicy>();
+}
+
+/**
+ * Make sure that AddRatings() replaces existing ratings, computes the mean of
+ * new users, rejects unknown items, and that Refresh() factorizes all the
+ * ratings.
+ */
+TEST_CASE("CFAddRatingsTest", "[CFTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("GroupLensSmall.csv", dataset))
+    FAIL("Cannot load test dataset GroupLensSmall.csv!");
+
+  CFType<ALSPolicy, UserMeanNormalization> c(dataset, ALSPolicy(), 5, 5, 10);
+  const size_t numUsers = c.CleanedData().n_cols;
+  const size_t numRatings = c.CleanedData().n_nonzero;
+
+  // Change an existing rating, and add two ratings of a new user.
+  const size_t oldUser = (size_t) dataset(0, 0);
+  const size_t oldItem = (size_t) dataset(1, 0);
+  const double oldRating = dataset(2, 0) == 5.0 ? 1.0 : 5.0;
+  const size_t newUser = numUsers + 2;
+  arma::mat ratings = { { (double) oldUser, (double) newUser,
+                          (double) newUser },
+                        { (double) oldItem, 0.0, 1.0 },
+                        { oldRating, 2.0, 4.0 } };
+  c.AddRatings(ratings);
+
+  REQUIRE(c.CleanedData().n_cols == newUser + 1);
+  REQUIRE(c.CleanedData().n_nonzero == numRatings + 2);
+  REQUIRE(c.Normalization().Mean()(newUser) == Approx(3.0).epsilon(1e-7));
+  REQUIRE(c.Normalization().Denormalize(oldUser, oldItem,
+      c.CleanedData()(oldItem, oldUser)) ==
+      Approx(oldRating).epsilon(1e-7));
+  REQUIRE(c.Decomposition().H().n_cols == newUser + 1);
+  REQUIRE(arma::norm(c.Decomposition().H().col(newUser)) > 0.0);
+  REQUIRE(arma::norm(c.Decomposition().H().col(numUsers)) == 0.0);
+
+  // Items have to be known to the model.
+  arma::mat unknownItem = { { 0.0 },
+                            { (double) c.CleanedData().n_rows },
+                            { 3.0 } };
+  REQUIRE_THROWS_AS(c.AddRatings(unknownItem), std::invalid_argument);
+
+  c.Refresh(10);
+  REQUIRE(c.Decomposition().H().n_cols == newUser + 1);
+  REQUIRE(c.Decomposition().W().n_rows == c.CleanedData().n_rows);
+}
+
 // Compare batch Predict() and individual Predict() for randomized SVD.
 TEST_CASE("CFBatchPredictRandSVDTest", "[CFTest]")
 {
@@ -1225,3 +1470,59 @@ TEST_CASE("CFPredictRegressionInterpolation", "[CFTest]")
             EuclideanSearch,
             RegressionInterpolation>(2.0);
 }
+
+/**
+ * Make sure that predictions and recommendations computed from a precomputed
+ * neighborhood index are the same as those computed without it, and that the
+ * index is discarded when the model changes.
+ */
+TEST_CASE("CFNeighborhoodIndexTest", "[CFTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("GroupLensSmall.csv", dataset))
+    FAIL("Cannot load test dataset GroupLensSmall.csv!");
+
+  CFType<RegSVDPolicy, OverallMeanNormalization> c(dataset, RegSVDPolicy(),
+      5, 5, 10);
+
+  arma::Mat<size_t> combinations(2, 300);
+  for (size_t i = 0; i < combinations.n_cols; ++i)
+  {
+    combinations(0, i) = math::RandInt(c.CleanedData().n_cols);
+    combinations(1, i) = math::RandInt(c.CleanedData().n_rows);
+  }
+
+  arma::vec predictions, indexPredictions;
+  arma::Mat<size_t> recommendations, indexRecommendations;
+  c.Predict<CosineSearch, RegressionInterpolation>(combinations, predictions);
+  c.GetRecommendations<CosineSearch, RegressionInterpolation>(5,
+      recommendations);
+
+  c.BuildNeighborhoodIndex<CosineSearch, RegressionInterpolation>();
+  REQUIRE(c.HasNeighborhoodIndex<CosineSearch, RegressionInterpolation>());
+  REQUIRE(!c.HasNeighborhoodIndex<CosineSearch, AverageInterpolation>());
+
+  c.Predict<CosineSearch, RegressionInterpolation>(combinations,
+      indexPredictions);
+  c.GetRecommendations<CosineSearch, RegressionInterpolation>(5,
+      indexRecommendations);
+
+  REQUIRE(indexPredictions.n_elem == predictions.n_elem);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    REQUIRE(indexPredictions[i] == Approx(predictions[i]).epsilon(1e-7));
+  for (size_t i = 0; i < combinations.n_cols; ++i)
+  {
+    REQUIRE(c.Predict<CosineSearch, RegressionInterpolation>(
+        combinations(0, i), combinations(1, i)) ==
+        Approx(predictions[i]).epsilon(1e-7));
+  }
+
+  REQUIRE(indexRecommendations.n_cols == recommendations.n_cols);
+  for (size_t i = 0; i < recommendations.n_elem; ++i)
+    REQUIRE(indexRecommendations[i] == recommendations[i]);
+
+  // Changing the model discards the index.
+  arma::mat ratings = { { 0.0 }, { 0.0 }, { 3.0 } };
+  c.AddRatings(ratings);
+  REQUIRE(!c.HasNeighborhoodIndex<CosineSearch, RegressionInterpolation>());
+}
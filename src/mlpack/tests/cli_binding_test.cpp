@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/bindings/cli/cli_option.hpp>
+#include <mlpack/bindings/cli/serve.hpp>
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 
 #include "catch.hpp"
@@ -46,6 +47,7 @@ void AddCLIMapFunctions(util::Params& p)
   p.functionMap[TYPENAME(N)]["DeleteAllocatedMemory"] =
       &cli::DeleteAllocatedMemory<N>;
   p.functionMap[TYPENAME(N)]["InPlaceCopy"] = &cli::InPlaceCopy<N>;
+  p.functionMap[TYPENAME(N)]["GetInputSize"] = &cli::GetInputSize<N>;
 }
 
 /**
@@ -686,3 +688,62 @@ TEST_CASE("DeleteAllocatedMemoryModelTest", "[CLIOptionTest]")
   DeleteAllocatedMemory<GaussianKernel*>((util::ParamData&) d,
       (const void*) NULL, (void*) NULL);
 }
+
+// Make sure that request lines in server mode are split like a shell would.
+TEST_CASE("SplitArgumentsTest", "[CLIOptionTest]")
+{
+  vector<string> args = SplitArguments("  --k 3 --query_file "
+      "'my queries.csv'  --string \"a \\\"b\\\" c\" --empty '' a\\ b ");
+  REQUIRE(args.size() == 9);
+  REQUIRE(args[0] == "--k");
+  REQUIRE(args[1] == "3");
+  REQUIRE(args[2] == "--query_file");
+  REQUIRE(args[3] == "my queries.csv");
+  REQUIRE(args[4] == "--string");
+  REQUIRE(args[5] == "a \"b\" c");
+  REQUIRE(args[6] == "--empty");
+  REQUIRE(args[7] == "");
+  REQUIRE(args[8] == "a b");
+
+  REQUIRE(SplitArguments("   ").size() == 0);
+  REQUIRE_THROWS_AS(SplitArguments("--file 'unterminated"),
+      std::invalid_argument);
+}
+
+// Models loaded in server mode should be copies of a cached model, which is
+// loaded again when the file changes.
+TEST_CASE("ModelCacheTest", "[CLIOptionTest]")
+{
+  data::DatasetInfo info(3);
+  data::Save("model_cache_test.bin", "model", info, true);
+
+  ModelCache::Enabled() = true;
+  data::DatasetInfo* info1 = ModelCache::Load<data::DatasetInfo>(
+      "model_cache_test.bin");
+  data::DatasetInfo* info2 = ModelCache::Load<data::DatasetInfo>(
+      "model_cache_test.bin");
+  REQUIRE(info1 != info2);
+  REQUIRE(info1->Dimensionality() == 3);
+  REQUIRE(info2->Dimensionality() == 3);
+
+  // Changing a returned model must not change the cached model.
+  info1->Type(0) = data::Datatype::categorical;
+  data::DatasetInfo* info3 = ModelCache::Load<data::DatasetInfo>(
+      "model_cache_test.bin");
+  REQUIRE(info3->Type(0) == data::Datatype::numeric);
+
+  // A file that changed (here, its size) is loaded again.
+  data::DatasetInfo info4(5);
+  data::Save("model_cache_test.bin", "model", info4, true);
+  data::DatasetInfo* info5 = ModelCache::Load<data::DatasetInfo>(
+      "model_cache_test.bin");
+  REQUIRE(info5->Dimensionality() == 5);
+
+  ModelCache::Clear();
+  ModelCache::Enabled() = false;
+  delete info1;
+  delete info2;
+  delete info3;
+  delete info5;
+  remove("model_cache_test.bin");
+}
@@ -16,6 +16,8 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/winograd_convolution.hpp>
 
 #include "serialization.hpp"
 #include "catch.hpp"
@@ -148,6 +150,14 @@ TEST_CASE("ValidConvolution2DTest", "[ConvolutionTest]")
   // speed up the computation.
   Convolution2DMethodTest<SVDConvolution<ValidConvolution> >(input, filter,
       output);
+
+  // Perform the convolution through im2col and a matrix product.
+  Convolution2DMethodTest<Im2ColConvolution<ValidConvolution> >(input, filter,
+      output);
+
+  // Perform the convolution through the Winograd transform.
+  Convolution2DMethodTest<WinogradConvolution<ValidConvolution> >(input, filter,
+      output);
 }
 
 /**
@@ -185,6 +195,14 @@ TEST_CASE("FullConvolution2DTest", "[ConvolutionTest]")
   // speed up the computation.
   Convolution2DMethodTest<SVDConvolution<FullConvolution> >(input, filter,
       output);
+
+  // Perform the convolution through im2col and a matrix product.
+  Convolution2DMethodTest<Im2ColConvolution<FullConvolution> >(input, filter,
+      output);
+
+  // Perform the convolution through the Winograd transform.
+  Convolution2DMethodTest<WinogradConvolution<FullConvolution> >(input, filter,
+      output);
 }
 
 /**
@@ -230,6 +248,14 @@ TEST_CASE("ValidConvolution3DTest", "[ConvolutionTest]")
   // speed up the computation.
   Convolution3DMethodTest<SVDConvolution<ValidConvolution> >(inputCube,
       filterCube, outputCube);
+
+  // Perform the convolution through im2col and a matrix product.
+  Convolution3DMethodTest<Im2ColConvolution<ValidConvolution> >(inputCube,
+      filterCube, outputCube);
+
+  // Perform the convolution through the Winograd transform.
+  Convolution3DMethodTest<WinogradConvolution<ValidConvolution> >(inputCube,
+      filterCube, outputCube);
 }
 
 /**
@@ -279,6 +305,14 @@ TEST_CASE("FullConvolution3DTest", "[ConvolutionTest]")
   // speed up the computation.
   Convolution3DMethodTest<SVDConvolution<FullConvolution> >(inputCube,
       filterCube, outputCube);
+
+  // Perform the convolution through im2col and a matrix product.
+  Convolution3DMethodTest<Im2ColConvolution<FullConvolution> >(inputCube,
+      filterCube, outputCube);
+
+  // Perform the convolution through the Winograd transform.
+  Convolution3DMethodTest<WinogradConvolution<FullConvolution> >(inputCube,
+      filterCube, outputCube);
 }
 
 /**
@@ -321,6 +355,14 @@ TEST_CASE("ValidConvolutionBatchTest", "[ConvolutionTest]")
   // speed up the computation.
   ConvolutionMethodBatchTest<SVDConvolution<ValidConvolution> >(input,
       filterCube, outputCube);
+
+  // Perform the convolution through im2col and a matrix product.
+  ConvolutionMethodBatchTest<Im2ColConvolution<ValidConvolution> >(input,
+      filterCube, outputCube);
+
+  // Perform the convolution through the Winograd transform.
+  ConvolutionMethodBatchTest<WinogradConvolution<ValidConvolution> >(input,
+      filterCube, outputCube);
 }
 
 /**
@@ -367,4 +409,76 @@ TEST_CASE("FullConvolutionBatchTest", "[ConvolutionTest]")
   // speed up the computation.
   ConvolutionMethodBatchTest<SVDConvolution<FullConvolution> >(input,
       filterCube, outputCube);
+
+  // Perform the convolution through im2col and a matrix product.
+  ConvolutionMethodBatchTest<Im2ColConvolution<FullConvolution> >(input,
+      filterCube, outputCube);
+
+  // Perform the convolution through the Winograd transform.
+  ConvolutionMethodBatchTest<WinogradConvolution<FullConvolution> >(input,
+      filterCube, outputCube);
+}
+
+/**
+ * Test the Winograd convolution against the naive convolution on inputs with
+ * odd sizes, for which the last output tiles are partial, and test the batch
+ * convolution with the transformed filters.
+ */
+TEST_CASE("WinogradConvolutionTest", "[ConvolutionTest]")
+{
+  arma::mat input = arma::randu(9, 8);
+  arma::mat filter = arma::randu(3, 3);
+
+  arma::mat naiveOutput, winogradOutput;
+  NaiveConvolution<ValidConvolution>::Convolution(input, filter, naiveOutput);
+  WinogradConvolution<ValidConvolution>::Convolution(input, filter,
+      winogradOutput);
+  CheckMatrices(winogradOutput, naiveOutput, 1e-10);
+
+  NaiveConvolution<FullConvolution>::Convolution(input, filter, naiveOutput);
+  WinogradConvolution<FullConvolution>::Convolution(input, filter,
+      winogradOutput);
+  CheckMatrices(winogradOutput, naiveOutput, 1e-10);
+
+  // Unsupported shapes fall back to the naive convolution.
+  NaiveConvolution<ValidConvolution>::Convolution(input, filter, naiveOutput,
+      2, 2);
+  WinogradConvolution<ValidConvolution>::Convolution(input, filter,
+      winogradOutput, 2, 2);
+  CheckMatrices(winogradOutput, naiveOutput);
+
+  // Two points with three input maps each, and two output maps.
+  const size_t inSize = 3, outSize = 2, batchSize = 2;
+  arma::cube inputCube = arma::randu<arma::cube>(7, 6, inSize * batchSize);
+  arma::cube filters = arma::randu<arma::cube>(3, 3, outSize * inSize);
+
+  arma::mat transformedFilters;
+  WinogradConvolution<>::TransformFilters(filters, transformedFilters);
+  REQUIRE(transformedFilters.n_rows == 16);
+  REQUIRE(transformedFilters.n_cols == outSize * inSize);
+
+  arma::cube output;
+  WinogradConvolution<>::BatchConvolution(inputCube, transformedFilters,
+      inSize, output);
+  REQUIRE(output.n_rows == 5);
+  REQUIRE(output.n_cols == 4);
+  REQUIRE(output.n_slices == outSize * batchSize);
+
+  for (size_t b = 0; b < batchSize; ++b)
+  {
+    for (size_t o = 0; o < outSize; ++o)
+    {
+      arma::mat expected(5, 4, arma::fill::zeros);
+      for (size_t m = 0; m < inSize; ++m)
+      {
+        arma::mat convOutput;
+        NaiveConvolution<ValidConvolution>::Convolution(
+            inputCube.slice(b * inSize + m), filters.slice(o * inSize + m),
+            convOutput);
+        expected += convOutput;
+      }
+
+      CheckMatrices(output.slice(b * outSize + o), expected, 1e-10);
+    }
+  }
 }
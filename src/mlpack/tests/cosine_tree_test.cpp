@@ -218,6 +218,32 @@ TEST_CASE("CosineTreeModifiedGramSchmidt", "[CosineTreeTest]")
   }
 }
 
+/**
+ * Checks CosineTree::BlockGramSchmidt() by orthonormalizing blocks of random
+ * vectors against a growing basis, and checking that the result is
+ * orthonormal and spans the original vectors.
+ */
+TEST_CASE("CosineTreeBlockGramSchmidt", "[CosineTreeTest]")
+{
+  const size_t numRows = 100;
+  const size_t numCols = 40;
+
+  arma::mat data = arma::randu(numRows, numCols);
+  CosineTree dummyTree(data, 1, 0.1);
+
+  // Orthonormalize the columns two at a time.
+  arma::mat basis = data;
+  for (size_t i = 0; i < numCols; i += 2)
+    dummyTree.BlockGramSchmidt(basis, i, 2);
+
+  REQUIRE(arma::norm(basis.t() * basis - arma::eye(numCols, numCols), "inf")
+      == Approx(0.0).margin(1e-8));
+
+  // The basis must reproduce the original vectors.
+  REQUIRE(arma::norm(basis * (basis.t() * data) - data, "fro") ==
+      Approx(0.0).margin(1e-8));
+}
+
 /**
  * Test the copy constructor & copy assignment using Cosine trees.
  */
@@ -95,6 +95,89 @@ TEST_CASE("ConfusionMatrixTest", "[CVTest]")
   REQUIRE(output(1, 1) == 3);
 }
 
+/**
+ * Make sure the confusion matrix of many predictions, computed in parallel,
+ * matches the counts computed one prediction at a time.
+ */
+TEST_CASE("LargeConfusionMatrixTest", "[CVTest]")
+{
+  const size_t numClasses = 5;
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(100000,
+      arma::distr_param(0, numClasses - 1));
+  arma::Row<size_t> predictedLabels = arma::randi<arma::Row<size_t>>(100000,
+      arma::distr_param(0, numClasses - 1));
+
+  arma::Mat<size_t> output;
+  data::ConfusionMatrix(predictedLabels, labels, output, numClasses);
+
+  arma::Mat<size_t> expected(numClasses, numClasses, arma::fill::zeros);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    expected(predictedLabels[i], labels[i])++;
+
+  REQUIRE(arma::accu(output != expected) == 0);
+
+  // Confusion matrices of parts of the predictions add up.
+  arma::Mat<size_t> first, second;
+  data::ConfusionMatrix(predictedLabels.head(30000), labels.head(30000), first,
+      numClasses);
+  data::ConfusionMatrix(predictedLabels.tail(70000), labels.tail(70000),
+      second, numClasses);
+  REQUIRE(arma::accu((first + second) != expected) == 0);
+}
+
+/**
+ * Make sure the metrics give the same results when the test set is split into
+ * several chunks.
+ */
+TEST_CASE("ChunkedMetricsTest", "[CVTest]")
+{
+  // Use more points than fit in one chunk.
+  const size_t numPoints = 2 * metricsChunkSize + 1000;
+  arma::mat data(1, numPoints, arma::fill::randu);
+  arma::Row<size_t> trainLabels = arma::conv_to<arma::Row<size_t>>::from(
+      data.row(0) > 0.5);
+  LogisticRegression<> lr(data, trainLabels);
+
+  // Flip some of the labels so that the metrics are not all 1.
+  arma::Row<size_t> labels = trainLabels;
+  for (size_t i = 0; i < numPoints; i += 7)
+    labels[i] = 1 - labels[i];
+
+  arma::Row<size_t> predictedLabels;
+  lr.Classify(data, predictedLabels);
+
+  const double tp = arma::accu((labels == 1) % (predictedLabels == 1));
+  const double accuracy = (double) arma::accu(predictedLabels == labels) /
+      numPoints;
+  const double precision = tp / arma::accu(predictedLabels == 1);
+  const double recall = tp / arma::accu(labels == 1);
+
+  REQUIRE(Accuracy::Evaluate(lr, data, labels) ==
+      Approx(accuracy).epsilon(1e-10));
+  REQUIRE(Precision<Binary>::Evaluate(lr, data, labels) ==
+      Approx(precision).epsilon(1e-10));
+  REQUIRE(Recall<Binary>::Evaluate(lr, data, labels) ==
+      Approx(recall).epsilon(1e-10));
+  REQUIRE(F1<Binary>::Evaluate(lr, data, labels) ==
+      Approx(2 * precision * recall / (precision + recall)).epsilon(1e-10));
+
+  // Now the same for regression.
+  arma::rowvec responses = 2 * data.row(0) + 1 +
+      0.1 * arma::randn<arma::rowvec>(numPoints);
+  LinearRegression linReg(data, responses);
+  arma::rowvec predictedResponses;
+  linReg.Predict(data, predictedResponses);
+
+  const double residual = arma::accu(arma::square(responses -
+      predictedResponses));
+  const double total = arma::accu(arma::square(responses -
+      arma::mean(responses)));
+  REQUIRE(MSE::Evaluate(linReg, data, responses) ==
+      Approx(residual / numPoints).epsilon(1e-8));
+  REQUIRE(R2Score<false>::Evaluate(linReg, data, responses) ==
+      Approx(1 - residual / total).epsilon(1e-8));
+}
+
 /**
  * Test metrics for multiclass classification.
  */
@@ -362,6 +445,41 @@ TEST_CASE("SimpleCVAccuracyTest", "[CVTest]")
   REQUIRE(cv.Evaluate() == Approx(0.75).epsilon(1e-7));
 }
 
+/**
+ * Make sure that SimpleCV can validate on the given points instead of the last
+ * ones.
+ */
+TEST_CASE("SimpleCVValidationPointsTest", "[CVTest]")
+{
+  // The same data as in SimpleCVAccuracyTest; then, the two halves are
+  // swapped.
+  arma::mat data =
+    arma::mat("1 0; 2 0; 1 1; 2 1; 1 0; 2 0; 1 1; 2 1").t();
+  arma::Row<size_t> labels("0 0 1 1 0 1 1 1");
+  arma::mat swappedData = arma::join_rows(data.cols(4, 7), data.cols(0, 3));
+  arma::Row<size_t> swappedLabels = arma::join_rows(labels.cols(4, 7),
+      labels.cols(0, 3));
+
+  SimpleCV<LogisticRegression<>, Accuracy> cv(0.5, data, labels);
+  SimpleCV<LogisticRegression<>, Accuracy> swappedCV(0.5, swappedData,
+      swappedLabels);
+  swappedCV.ValidationPoints(arma::uvec("0 1 2 3"));
+
+  REQUIRE(swappedCV.Evaluate() == Approx(cv.Evaluate()).epsilon(1e-7));
+
+  // Indices refer to the original data, even after a previous call.
+  swappedCV.ValidationPoints(arma::uvec("4 5 6 7"));
+  SimpleCV<LogisticRegression<>, Accuracy> swappedDefaultCV(0.5, swappedData,
+      swappedLabels);
+  REQUIRE(swappedCV.Evaluate() ==
+      Approx(swappedDefaultCV.Evaluate()).epsilon(1e-7));
+
+  REQUIRE_THROWS_AS(swappedCV.ValidationPoints(arma::uvec("1 1")),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(swappedCV.ValidationPoints(arma::uvec()),
+      std::invalid_argument);
+}
+
 /**
  * Test the simple cross-validation strategy implementation with the MSE metric.
  */
@@ -665,6 +783,37 @@ TEST_CASE("KFoldCVWithDTTestUnevenBinsNoShuffle", "[CVTest]")
   REQUIRE(accuracy > 0.7);
 }
 
+/**
+ * Make sure that k-fold cross-validation gives the same result whether the
+ * folds are trained one after another or in parallel.
+ */
+TEST_CASE("KFoldCVParallelFoldsTest", "[CVTest]")
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  data::DatasetInfo datasetInfo;
+  MockCategoricalData(data, labels, datasetInfo);
+
+  size_t numClasses = 5;
+  size_t minimumLeafSize = 5;
+
+  KFoldCV<DecisionTree<InformationGain>, Accuracy> cv(5, data, datasetInfo,
+      labels, numClasses, false);
+
+  cv.NumThreads() = 1;
+  const double sequentialAccuracy = cv.Evaluate(minimumLeafSize);
+  arma::Row<size_t> sequentialPredictions;
+  cv.Model().Classify(data, sequentialPredictions);
+
+  cv.NumThreads() = 0;
+  const double parallelAccuracy = cv.Evaluate(minimumLeafSize);
+  arma::Row<size_t> parallelPredictions;
+  cv.Model().Classify(data, parallelPredictions);
+
+  REQUIRE(parallelAccuracy == Approx(sequentialAccuracy).epsilon(1e-12));
+  REQUIRE(arma::all(parallelPredictions == sequentialPredictions));
+}
+
 /**
  * Test k-fold cross-validation with decision trees constructed in multiple
  * ways, but with larger k.
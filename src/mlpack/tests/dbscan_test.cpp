@@ -306,3 +306,77 @@ TEST_CASE("RandomPointSelectionTest", "[DBSCANTest]")
   // The number of assignments returned should be the same as points.
   REQUIRE(assignments.n_elem == points.n_cols);
 }
+
+/**
+ * Make sure that batch mode and pointwise mode give exactly the same
+ * assignments, with every type of range search.
+ */
+TEST_CASE("BatchModeMatchesPointwiseModeTest", "[DBSCANTest]")
+{
+  arma::mat points(2, 1000, arma::fill::randu);
+
+  DBSCAN<> pointwise(0.03, 3, false);
+  arma::Row<size_t> pointwiseAssignments;
+  const size_t pointwiseClusters = pointwise.Cluster(points,
+      pointwiseAssignments);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    DBSCAN<> batch(0.03, 3, true, RangeSearch<>(mode == 0, mode == 1));
+    arma::Row<size_t> assignments;
+    const size_t clusters = batch.Cluster(points, assignments);
+
+    REQUIRE(clusters == pointwiseClusters);
+    REQUIRE(assignments.n_elem == pointwiseAssignments.n_elem);
+    for (size_t i = 0; i < assignments.n_elem; ++i)
+      REQUIRE(assignments[i] == pointwiseAssignments[i]);
+  }
+}
+
+/**
+ * Make sure that the point selection policy only changes the numbering of the
+ * clusters, and that the clusters are numbered in the order of selection.
+ */
+TEST_CASE("PointSelectionNumberingTest", "[DBSCANTest]")
+{
+  arma::mat points(2, 500, arma::fill::randu);
+
+  DBSCAN<> ordered(0.05, 3);
+  arma::Row<size_t> orderedAssignments;
+  const size_t orderedClusters = ordered.Cluster(points, orderedAssignments);
+
+  DBSCAN<RangeSearch<>, RandomPointSelection> random(0.05, 3);
+  arma::Row<size_t> randomAssignments;
+  const size_t randomClusters = random.Cluster(points, randomAssignments);
+
+  REQUIRE(orderedClusters == randomClusters);
+
+  // With ordered selection, each cluster is numbered after all the clusters
+  // of the points before its first point.
+  size_t nextCluster = 0;
+  for (size_t i = 0; i < orderedAssignments.n_elem; ++i)
+  {
+    if (orderedAssignments[i] == SIZE_MAX)
+      continue;
+
+    REQUIRE(orderedAssignments[i] <= nextCluster);
+    if (orderedAssignments[i] == nextCluster)
+      ++nextCluster;
+  }
+  REQUIRE(nextCluster == orderedClusters);
+
+  // Both policies find the same clusters, up to their numbering.
+  std::vector<size_t> mapping(orderedClusters, SIZE_MAX);
+  for (size_t i = 0; i < orderedAssignments.n_elem; ++i)
+  {
+    if (orderedAssignments[i] == SIZE_MAX)
+    {
+      REQUIRE(randomAssignments[i] == SIZE_MAX);
+      continue;
+    }
+
+    if (mapping[orderedAssignments[i]] == SIZE_MAX)
+      mapping[orderedAssignments[i]] = randomAssignments[i];
+    REQUIRE(mapping[orderedAssignments[i]] == randomAssignments[i]);
+  }
+}
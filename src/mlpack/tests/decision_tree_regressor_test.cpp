@@ -181,6 +181,46 @@ TEST_CASE("MADGainHandCalculation", "[DecisionTreeRegressorTest]")
           Approx(weightedGain).margin(1e-5));
 }
 
+/**
+ * Check that the gains computed incrementally while scanning the split points
+ * match the gains computed directly on each child.
+ */
+template<typename FitnessFunction, bool UseWeights>
+void CheckBinaryScanGains(const arma::rowvec& responses,
+                          const arma::rowvec& weights,
+                          const size_t minimum)
+{
+  FitnessFunction fitnessFunction;
+  fitnessFunction.template BinaryScanInitialize<UseWeights>(responses,
+      weights, minimum);
+  for (size_t index = minimum; index < responses.n_elem - minimum + 1; ++index)
+  {
+    fitnessFunction.template BinaryStep<UseWeights>(responses, weights,
+        index - 1);
+    std::tuple<double, double> gains = fitnessFunction.BinaryGains();
+
+    REQUIRE(std::get<0>(gains) == Approx(FitnessFunction::template
+        Evaluate<UseWeights>(responses, weights, 0, index)).margin(1e-8));
+    REQUIRE(std::get<1>(gains) == Approx(FitnessFunction::template
+        Evaluate<UseWeights>(responses, weights, index,
+        responses.n_elem)).margin(1e-8));
+  }
+}
+
+TEST_CASE("BinaryScanGainsTest", "[DecisionTreeRegressorTest]")
+{
+  arma::rowvec responses(200, arma::fill::randn);
+  // Add some ties.
+  for (size_t i = 0; i < 200; i += 7)
+    responses[i] = 1.0;
+  arma::rowvec weights(200, arma::fill::randu);
+
+  CheckBinaryScanGains<MSEGain, false>(responses, weights, 1);
+  CheckBinaryScanGains<MSEGain, true>(responses, weights, 5);
+  CheckBinaryScanGains<MADGain, false>(responses, weights, 1);
+  CheckBinaryScanGains<MADGain, true>(responses, weights, 5);
+}
+
 /**
  * Check that AllCategoricalSplit will split when the split is obviously
  * better.
@@ -1100,3 +1140,44 @@ TEST_CASE("WeightedDecisionTreeMADGainTest", "[DecisionTreeRegressorTest]")
   double rmse = RMSE(predictions, testResponses);
   REQUIRE(rmse < 6.5);
 }
+
+/**
+ * Test that a tree trained on numeric data, which sorts each dimension once at
+ * the root, gives the same predictions as a tree that sorts the points of each
+ * node (as is done when a DatasetInfo is given).
+ */
+TEST_CASE("DecisionTreeRegressorPresortedTrainTest",
+          "[DecisionTreeRegressorTest]")
+{
+  arma::mat dataset(4, 2000, arma::fill::randu);
+  arma::rowvec responses = arma::sin(4 * dataset.row(0)) +
+      dataset.row(1) % dataset.row(2) + 0.1 * arma::randn<arma::rowvec>(2000);
+  arma::rowvec weights(2000, arma::fill::randu);
+  data::DatasetInfo info(4);
+
+  arma::mat testData(4, 500, arma::fill::randu);
+
+  for (size_t w = 0; w < 2; ++w)
+  {
+    DecisionTreeRegressor<> presortedTree, tree;
+    double presortedGain, gain;
+    if (w == 0)
+    {
+      presortedGain = presortedTree.Train(dataset, responses, 5);
+      gain = tree.Train(dataset, info, responses, 5);
+    }
+    else
+    {
+      presortedGain = presortedTree.Train(dataset, responses, weights, 5);
+      gain = tree.Train(dataset, info, responses, weights, 5);
+    }
+
+    REQUIRE(presortedGain == Approx(gain).epsilon(1e-10));
+
+    arma::rowvec presortedPredictions, predictions;
+    presortedTree.Predict(testData, presortedPredictions);
+    tree.Predict(testData, predictions);
+    for (size_t i = 0; i < testData.n_cols; ++i)
+      REQUIRE(presortedPredictions[i] == Approx(predictions[i]).epsilon(1e-10));
+  }
+}
@@ -10,11 +10,13 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/core.hpp>
+#include <mlpack/core/data/compressed_dataset.hpp>
 #include <mlpack/methods/decision_tree/decision_tree.hpp>
 #include <mlpack/methods/decision_tree/information_gain.hpp>
 #include <mlpack/methods/decision_tree/gini_gain.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 #include <mlpack/methods/decision_tree/multiple_random_dimension_select.hpp>
+#include <mlpack/methods/decision_tree/flat_forest.hpp>
 
 #include "catch.hpp"
 #include "serialization.hpp"
@@ -1399,3 +1401,318 @@ TEST_CASE("DifferentMaximumDepthTest", "[DecisionTreeTest]")
   REQUIRE(d2.Child(0).NumChildren() == 2);
   REQUIRE(d2.Child(1).NumChildren() == 2);
 }
+
+/**
+ * Test that a tree trained on numeric data, which sorts each dimension once at
+ * the root, is the same as a tree that sorts the points of each node (as is
+ * done when a DatasetInfo is given).
+ */
+TEST_CASE("DecisionTreePresortedTrainTest", "[DecisionTreeTest]")
+{
+  arma::mat dataset(5, 2000, arma::fill::randu);
+  arma::Row<size_t> labels(2000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    labels[i] = (dataset(0, i) + dataset(1, i) * dataset(2, i) > 0.7) ? 1 : 0;
+    if (i % 10 == 0)
+      labels[i] = 2;
+  }
+  arma::rowvec weights(2000, arma::fill::randu);
+  data::DatasetInfo info(5);
+
+  arma::mat testData(5, 500, arma::fill::randu);
+
+  for (size_t w = 0; w < 2; ++w)
+  {
+    DecisionTree<> presortedTree, tree;
+    double presortedEntropy, entropy;
+    if (w == 0)
+    {
+      presortedEntropy = presortedTree.Train(dataset, labels, 3, 5);
+      entropy = tree.Train(dataset, info, labels, 3, 5);
+    }
+    else
+    {
+      presortedEntropy = presortedTree.Train(dataset, labels, 3, weights, 5);
+      entropy = tree.Train(dataset, info, labels, 3, weights, 5);
+    }
+
+    REQUIRE(presortedEntropy == Approx(entropy).epsilon(1e-10));
+    REQUIRE(presortedTree.NumChildren() == tree.NumChildren());
+
+    arma::Row<size_t> presortedPredictions, predictions;
+    arma::mat presortedProbabilities, probabilities;
+    presortedTree.Classify(testData, presortedPredictions,
+        presortedProbabilities);
+    tree.Classify(testData, predictions, probabilities);
+    for (size_t i = 0; i < testData.n_cols; ++i)
+      REQUIRE(presortedPredictions[i] == predictions[i]);
+    for (size_t i = 0; i < probabilities.n_elem; ++i)
+    {
+      REQUIRE(presortedProbabilities[i] ==
+          Approx(probabilities[i]).epsilon(1e-10));
+    }
+  }
+}
+
+/**
+ * Make sure that a tree large enough to be searched and split in parallel is
+ * the same as the one trained without presorting, also with a minimum gain.
+ */
+TEST_CASE("DecisionTreeParallelTrainTest", "[DecisionTreeTest]")
+{
+  arma::mat dataset(6, 20000, arma::fill::randu);
+  arma::Row<size_t> labels(20000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    labels[i] = (dataset(0, i) + dataset(3, i) * dataset(4, i) > 0.7) ? 1 : 0;
+    if (i % 7 == 0)
+      labels[i] = 2;
+  }
+  data::DatasetInfo info(6);
+
+  arma::mat testData(6, 1000, arma::fill::randu);
+
+  for (size_t g = 0; g < 2; ++g)
+  {
+    const double minimumGainSplit = (g == 0) ? 1e-7 : 1e-3;
+    DecisionTree<> parallelTree(dataset, labels, 3, 10, minimumGainSplit);
+    DecisionTree<> tree(dataset, info, labels, 3, 10, minimumGainSplit);
+
+    REQUIRE(parallelTree.NumChildren() == tree.NumChildren());
+    REQUIRE(parallelTree.SplitDimension() == tree.SplitDimension());
+
+    arma::Row<size_t> parallelPredictions, predictions;
+    arma::mat parallelProbabilities, probabilities;
+    parallelTree.Classify(testData, parallelPredictions,
+        parallelProbabilities);
+    tree.Classify(testData, predictions, probabilities);
+    for (size_t i = 0; i < testData.n_cols; ++i)
+      REQUIRE(parallelPredictions[i] == predictions[i]);
+    for (size_t i = 0; i < probabilities.n_elem; ++i)
+    {
+      REQUIRE(parallelProbabilities[i] ==
+          Approx(probabilities[i]).epsilon(1e-10));
+    }
+  }
+}
+
+/**
+ * Make sure that a FlatForest holding a numeric decision tree classifies like
+ * the tree, both with QuickScorer and by walking the tree.
+ */
+TEST_CASE("FlatForestNumericTreeTest", "[DecisionTreeTest]")
+{
+  arma::mat dataset(4, 1000, arma::fill::randu);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    labels[i] = (dataset(0, i) + dataset(1, i) > 1.0) ? 1 : 0;
+
+  arma::mat testData(4, 300, arma::fill::randu);
+
+  // A tree of depth 6 has at most 32 leaves.
+  DecisionTree<> tree(dataset, labels, 2, 1, 1e-7, 6);
+  FlatForest flat(tree);
+  REQUIRE(flat.NumTrees() == 1);
+  REQUIRE(flat.NumClasses() == 2);
+  REQUIRE(flat.QuickScorerAvailable());
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  tree.Classify(testData, predictions, probabilities);
+
+  for (size_t q = 0; q < 2; ++q)
+  {
+    flat.UseQuickScorer() = (q == 0);
+
+    arma::Row<size_t> flatPredictions;
+    arma::mat flatProbabilities;
+    flat.Classify(testData, flatPredictions, flatProbabilities);
+
+    REQUIRE(flatPredictions.n_elem == testData.n_cols);
+    for (size_t i = 0; i < testData.n_cols; ++i)
+    {
+      REQUIRE(flatPredictions[i] == predictions[i]);
+      REQUIRE(flat.Classify(testData.col(i)) == predictions[i]);
+    }
+    for (size_t i = 0; i < probabilities.n_elem; ++i)
+      REQUIRE(flatProbabilities[i] == Approx(probabilities[i]).epsilon(1e-10));
+  }
+
+  // A point exactly on a threshold goes left in both cases.
+  arma::vec point(4, arma::fill::zeros);
+  point[tree.SplitDimension()] = tree.ClassProbabilities()[0];
+  flat.UseQuickScorer() = true;
+  arma::Row<size_t> pointPrediction;
+  flat.Classify(arma::mat(point), pointPrediction);
+  REQUIRE(pointPrediction[0] == tree.Classify(point));
+}
+
+/**
+ * Make sure that a FlatForest holding a tree with categorical splits
+ * classifies like the tree.
+ */
+TEST_CASE("FlatForestCategoricalTreeTest", "[DecisionTreeTest]")
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  DecisionTree<> tree(d.cols(0, 1999), di, l.subvec(0, 1999), 5, 10);
+  FlatForest flat(tree);
+  REQUIRE(!flat.QuickScorerAvailable());
+
+  const arma::mat testData = d.cols(2000, 3999);
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+  tree.Classify(testData, predictions, probabilities);
+  flat.Classify(testData, flatPredictions, flatProbabilities);
+
+  for (size_t i = 0; i < testData.n_cols; ++i)
+    REQUIRE(flatPredictions[i] == predictions[i]);
+  for (size_t i = 0; i < probabilities.n_elem; ++i)
+    REQUIRE(flatProbabilities[i] == Approx(probabilities[i]).epsilon(1e-10));
+
+  // Serialize the flattened tree and make sure it still classifies the same.
+  FlatForest xmlFlat, jsonFlat, binaryFlat;
+  SerializeObjectAll(flat, xmlFlat, jsonFlat, binaryFlat);
+
+  arma::Row<size_t> xmlPredictions, jsonPredictions, binaryPredictions;
+  xmlFlat.Classify(testData, xmlPredictions);
+  jsonFlat.Classify(testData, jsonPredictions);
+  binaryFlat.Classify(testData, binaryPredictions);
+  for (size_t i = 0; i < testData.n_cols; ++i)
+  {
+    REQUIRE(xmlPredictions[i] == predictions[i]);
+    REQUIRE(jsonPredictions[i] == predictions[i]);
+    REQUIRE(binaryPredictions[i] == predictions[i]);
+  }
+}
+
+/**
+ * Make sure that training on the indices of some points (with repetitions)
+ * gives the same tree as training on a copy of these points.
+ */
+TEST_CASE("DecisionTreeTrainOnIndicesTest", "[DecisionTreeTest]")
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+  arma::rowvec weights(d.n_cols, arma::fill::randu);
+
+  arma::Row<size_t> indices = arma::sort(arma::randi<arma::Row<size_t>>(
+      2000, arma::distr_param(0, d.n_cols - 1)));
+  const arma::mat data = d.cols(indices);
+  const arma::Row<size_t> labels = l.cols(indices);
+  const arma::rowvec pointWeights = weights.cols(indices);
+
+  const arma::mat testData = d.cols(0, 999);
+  for (size_t t = 0; t < 4; ++t)
+  {
+    DecisionTree<> tree, indexTree;
+    double gain, indexGain;
+    if (t == 0)
+    {
+      gain = tree.Train(data, di, labels, 5, 10);
+      indexGain = indexTree.TrainOnIndices<false, true>(d, indices, di, l, 5,
+          weights, 10);
+    }
+    else if (t == 1)
+    {
+      gain = tree.Train(data, di, labels, 5, pointWeights, 10);
+      indexGain = indexTree.TrainOnIndices<true, true>(d, indices, di, l, 5,
+          weights, 10);
+    }
+    else if (t == 2)
+    {
+      gain = tree.Train(data, labels, 5, 10);
+      indexGain = indexTree.TrainOnIndices<false, false>(d, indices, di, l, 5,
+          weights, 10);
+    }
+    else
+    {
+      gain = tree.Train(data, labels, 5, pointWeights, 10);
+      indexGain = indexTree.TrainOnIndices<true, false>(d, indices, di, l, 5,
+          weights, 10);
+    }
+
+    REQUIRE(indexGain == Approx(gain).epsilon(1e-10));
+    REQUIRE(indexTree.NumChildren() == tree.NumChildren());
+
+    arma::Row<size_t> predictions, indexPredictions;
+    arma::mat probabilities, indexProbabilities;
+    tree.Classify(testData, predictions, probabilities);
+    indexTree.Classify(testData, indexPredictions, indexProbabilities);
+    for (size_t i = 0; i < testData.n_cols; ++i)
+      REQUIRE(indexPredictions[i] == predictions[i]);
+    for (size_t i = 0; i < probabilities.n_elem; ++i)
+    {
+      REQUIRE(indexProbabilities[i] ==
+          Approx(probabilities[i]).epsilon(1e-10));
+    }
+  }
+
+  // An index past the end of the dataset is an error.
+  indices[0] = d.n_cols;
+  DecisionTree<> tree;
+  REQUIRE_THROWS_AS((tree.TrainOnIndices<false, true>(d, indices, di, l, 5,
+      weights, 10)), std::invalid_argument);
+}
+
+/**
+ * Make sure that a CompressedDataset holds the same values as the dataset it
+ * was made from, in less memory, and that a decision tree trained on it is the
+ * same as one trained on the original dataset.
+ */
+TEST_CASE("CompressedDatasetDecisionTreeTest", "[DecisionTreeTest]")
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  // Numeric dimensions are stored as floats.
+  d = arma::conv_to<arma::mat>::from(arma::conv_to<arma::fmat>::from(d));
+  data::CompressedDataset compressed(d, di);
+
+  REQUIRE(compressed.n_rows == d.n_rows);
+  REQUIRE(compressed.n_cols == d.n_cols);
+  REQUIRE(compressed.BitWidth(0) == 32);
+  REQUIRE(compressed.BitWidth(2) == 2);
+  REQUIRE(compressed.BitWidth(3) == 1);
+  REQUIRE(compressed.MemoryUsage() < sizeof(double) * d.n_elem / 3);
+
+  arma::mat decompressed;
+  compressed.Decompress(decompressed);
+  REQUIRE(arma::approx_equal(decompressed, d, "absdiff", 0.0));
+  for (size_t i = 0; i < d.n_cols; i += 97)
+    REQUIRE(arma::approx_equal(compressed.col(i), d.col(i), "absdiff", 0.0));
+
+  const arma::uvec points = arma::regspace<arma::uvec>(2000, 3999);
+  const data::CompressedDataset testData = compressed.cols(points);
+  REQUIRE(testData.n_cols == 2000);
+  for (size_t i = 0; i < testData.n_cols; ++i)
+    REQUIRE(testData(2, i) == d(2, 2000 + i));
+
+  // A value that is not a category index cannot be compressed.
+  arma::mat invalid(d.cols(0, 9));
+  invalid(3, 5) = 2.0;
+  REQUIRE_THROWS_AS(data::CompressedDataset(invalid, di),
+      std::invalid_argument);
+
+  arma::mat trainingData = d.cols(0, 1999);
+  arma::mat testMat = d.cols(2000, 3999);
+  arma::Row<size_t> trainingLabels = l.subvec(0, 1999);
+  DecisionTree<> tree(trainingData, di, trainingLabels, 5, 10);
+  DecisionTree<> compressedTree(compressed.cols(arma::regspace<arma::uvec>(0,
+      1999)), di, trainingLabels, 5, 10);
+
+  arma::Row<size_t> predictions, compressedPredictions;
+  tree.Classify(testMat, predictions);
+  compressedTree.Classify(testData, compressedPredictions);
+  REQUIRE(compressedPredictions.n_elem == predictions.n_elem);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    REQUIRE(predictions[i] == compressedPredictions[i]);
+}
@@ -458,6 +458,48 @@ TEST_CASE("TestSparseComputeValue", "[DETTest]")
   REQUIRE(0.0 == Approx(testDTree.ComputeValue(q4)).epsilon(1e-12));
 }
 
+/**
+ * Grow a tree on enough points that the presorted dense implementation splits
+ * them in parallel, and make sure it gives the same tree as the sparse
+ * implementation (which sorts the points at each node), and keeps the mapping
+ * of the points right.
+ */
+TEST_CASE("TestPresortedGrow", "[DETTest]")
+{
+  arma::mat realData = arma::randu<arma::mat>(3, 20000) + 1.0;
+
+  arma::mat denseData(realData);
+  arma::Col<size_t> denseOldFromNew =
+      arma::regspace<arma::Col<size_t>>(0, realData.n_cols - 1);
+  DTree<arma::mat> denseTree(denseData);
+  const double denseAlpha = denseTree.Grow(denseData, denseOldFromNew, false,
+      10, 5);
+
+  arma::sp_mat sparseData(realData);
+  arma::Col<size_t> sparseOldFromNew =
+      arma::regspace<arma::Col<size_t>>(0, realData.n_cols - 1);
+  DTree<arma::sp_mat> sparseTree(sparseData);
+  const double sparseAlpha = sparseTree.Grow(sparseData, sparseOldFromNew,
+      false, 10, 5);
+
+  REQUIRE(denseTree.SubtreeLeaves() == sparseTree.SubtreeLeaves());
+  REQUIRE(denseAlpha == Approx(sparseAlpha).epsilon(1e-10));
+
+  for (size_t i = 0; i < realData.n_cols; ++i)
+  {
+    REQUIRE(arma::approx_equal(denseData.col(i),
+        realData.col(denseOldFromNew[i]), "absdiff", 0.0));
+  }
+
+  for (size_t i = 0; i < realData.n_cols; i += 100)
+  {
+    const arma::vec q = realData.col(i);
+    const arma::sp_vec sq(q);
+    REQUIRE(denseTree.ComputeValue(q) ==
+        Approx(sparseTree.ComputeValue(sq)).epsilon(1e-12));
+  }
+}
+
 /**
  * These are not yet implemented.
  *
@@ -453,6 +453,40 @@ TEST_CASE("GaussianMultipointMultivariateProbabilityTest", "[DistributionTest]")
   REQUIRE(phis(5) == Approx(-14.900192463287908).epsilon(1e-7));
 }
 
+/**
+ * Make sure the log probabilities of many observations, which are computed in
+ * blocks, match the log probabilities of each observation.
+ */
+TEST_CASE("GaussianBlockLogProbabilityTest", "[DistributionTest]")
+{
+  arma::mat factor(8, 8, arma::fill::randu);
+  const arma::mat cov = factor * factor.t() + arma::eye<arma::mat>(8, 8);
+  const arma::vec mean(8, arma::fill::randu);
+  GaussianDistribution g(mean, cov);
+
+  // This is several blocks, the last one partial.
+  arma::mat points(8, 1000, arma::fill::randn);
+  points.each_col() += mean;
+
+  arma::vec logProbs;
+  g.LogProbability(points, logProbs);
+  REQUIRE(logProbs.n_elem == 1000);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    REQUIRE(logProbs[i] ==
+        Approx(g.LogProbability(arma::vec(points.col(i)))).epsilon(1e-10));
+  }
+
+  DiagonalGaussianDistribution d(mean, cov.diag());
+  d.LogProbability(points, logProbs);
+  REQUIRE(logProbs.n_elem == 1000);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    REQUIRE(logProbs[i] ==
+        Approx(d.LogProbability(arma::vec(points.col(i)))).epsilon(1e-10));
+  }
+}
+
 /**
  * Make sure random observations follow the probability distribution correctly.
  */
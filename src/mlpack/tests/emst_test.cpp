@@ -274,3 +274,37 @@ TEST_CASE("EMSTBallTreeTest", "[EMSTTest]")
     REQUIRE(bstResults(2, i) == Approx(ballResults(2, i)).epsilon(1e-7));
   }
 }
+
+/**
+ * Make sure that the dual-tree MST is still correct when the tree is large
+ * enough to be split into several query subtrees (which happens when OpenMP is
+ * used).  The total length of the tree is compared with the naive computation,
+ * and every edge must connect two different components.
+ */
+TEST_CASE("EMSTSplitQueryTreeTest", "[EMSTTest]")
+{
+  arma::mat dataset(3, 2500, arma::fill::randu);
+  arma::mat naiveData = dataset;
+
+  DualTreeBoruvka<> dtb(dataset);
+  arma::mat dualResults;
+  dtb.ComputeMST(dualResults);
+
+  DualTreeBoruvka<> dtbNaive(naiveData, true);
+  arma::mat naiveResults;
+  dtbNaive.ComputeMST(naiveResults);
+
+  REQUIRE(dualResults.n_cols == 2499);
+  REQUIRE(naiveResults.n_cols == 2499);
+  REQUIRE(arma::accu(dualResults.row(2)) ==
+      Approx(arma::accu(naiveResults.row(2))).epsilon(1e-7));
+
+  UnionFind components(2500);
+  for (size_t i = 0; i < dualResults.n_cols; ++i)
+  {
+    const size_t a = (size_t) dualResults(0, i);
+    const size_t b = (size_t) dualResults(1, i);
+    REQUIRE(components.Find(a) != components.Find(b));
+    components.Union(a, b);
+  }
+}
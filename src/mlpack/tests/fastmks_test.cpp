@@ -1141,3 +1141,151 @@ TEST_CASE("CopyAssignmentTest", "[FastMKSTest]")
       REQUIRE(newKernels[i] == Approx(0.0).margin(1e-5));
   }
 }
+
+/**
+ * Make sure that batched search gives the same results as dual-tree search.
+ */
+TEST_CASE("FastMKSBatchSearchTest", "[FastMKSTest]")
+{
+  arma::mat referenceData = arma::randn<arma::mat>(5, 1000);
+  arma::mat queryData = arma::randn<arma::mat>(5, 700);
+  LinearKernel lk;
+
+  FastMKS<LinearKernel> f(referenceData, lk);
+
+  arma::Mat<size_t> indices, batchIndices;
+  arma::mat kernels, batchKernels;
+  f.Search(queryData, 5, indices, kernels);
+  f.BatchSearch(queryData, 5, batchIndices, batchKernels, 64);
+
+  REQUIRE(batchIndices.n_rows == 5);
+  REQUIRE(batchIndices.n_cols == 700);
+  REQUIRE(batchKernels.n_rows == 5);
+  REQUIRE(batchKernels.n_cols == 700);
+
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    REQUIRE(batchIndices[i] == indices[i]);
+    REQUIRE(batchKernels[i] == Approx(kernels[i]).epsilon(1e-7));
+  }
+
+  REQUIRE_THROWS_AS(f.BatchSearch(queryData, 5, batchIndices, batchKernels, 0),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that approximate search stays within the requested relative
+ * error, in single-tree, dual-tree and batched mode.
+ */
+TEST_CASE("FastMKSApproximateTest", "[FastMKSTest]")
+{
+  // All kernel values are positive with this data.
+  arma::mat referenceData = arma::randu<arma::mat>(5, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(5, 300);
+  LinearKernel lk;
+  const double epsilon = 0.1;
+
+  FastMKS<LinearKernel> naive(referenceData, lk, false, true);
+  arma::Mat<size_t> naiveIndices;
+  arma::mat naiveKernels;
+  naive.Search(queryData, 5, naiveIndices, naiveKernels);
+
+  FastMKS<LinearKernel> dual(referenceData, lk);
+  FastMKS<LinearKernel> single(referenceData, lk, true);
+  dual.Epsilon() = epsilon;
+  single.Epsilon() = epsilon;
+
+  arma::Mat<size_t> dualIndices, singleIndices, batchIndices;
+  arma::mat dualKernels, singleKernels, batchKernels;
+  dual.Search(queryData, 5, dualIndices, dualKernels);
+  single.Search(queryData, 5, singleIndices, singleKernels);
+  dual.BatchSearch(queryData, 5, batchIndices, batchKernels, 50);
+
+  for (size_t i = 0; i < naiveKernels.n_elem; ++i)
+  {
+    // Each returned value is a real kernel value, so it can't be better than
+    // the exact result, and it must be within the relative error.
+    REQUIRE(dualKernels[i] <= naiveKernels[i] + 1e-10);
+    REQUIRE(singleKernels[i] <= naiveKernels[i] + 1e-10);
+    REQUIRE(batchKernels[i] <= naiveKernels[i] + 1e-10);
+    REQUIRE(naiveKernels[i] <= (1 + epsilon) * dualKernels[i] + 1e-10);
+    REQUIRE(naiveKernels[i] <= (1 + epsilon) * singleKernels[i] + 1e-10);
+    REQUIRE(naiveKernels[i] <= (1 + epsilon) * batchKernels[i] + 1e-10);
+  }
+
+  // Invalid values of epsilon are rejected.
+  dual.Epsilon() = 1.0;
+  REQUIRE_THROWS_AS(dual.Search(queryData, 5, dualIndices, dualKernels),
+      std::invalid_argument);
+  dual.Epsilon() = -0.1;
+  REQUIRE_THROWS_AS(dual.Search(5, dualIndices, dualKernels),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure FastMKS works with single-precision data.
+ */
+TEST_CASE("FastMKSFloatTest", "[FastMKSTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(5, 500);
+  arma::mat queryData = arma::randu<arma::mat>(5, 200);
+  arma::fmat floatReferenceData = arma::conv_to<arma::fmat>::from(
+      referenceData);
+  arma::fmat floatQueryData = arma::conv_to<arma::fmat>::from(queryData);
+  LinearKernel lk;
+
+  FastMKS<LinearKernel> naive(referenceData, lk, false, true);
+  arma::Mat<size_t> naiveIndices;
+  arma::mat naiveKernels;
+  naive.Search(queryData, 3, naiveIndices, naiveKernels);
+
+  FastMKS<LinearKernel, arma::fmat> dual(floatReferenceData, lk);
+  FastMKS<LinearKernel, arma::fmat> single(floatReferenceData, lk, true);
+
+  arma::Mat<size_t> dualIndices, singleIndices, batchIndices;
+  arma::mat dualKernels, singleKernels, batchKernels;
+  dual.Search(floatQueryData, 3, dualIndices, dualKernels);
+  single.Search(floatQueryData, 3, singleIndices, singleKernels);
+  dual.BatchSearch(floatQueryData, 3, batchIndices, batchKernels, 32);
+
+  // Ties may be broken differently in single precision, so only the kernel
+  // values are compared.
+  for (size_t i = 0; i < naiveKernels.n_elem; ++i)
+  {
+    REQUIRE(dualKernels[i] == Approx(naiveKernels[i]).epsilon(1e-4));
+    REQUIRE(singleKernels[i] == Approx(naiveKernels[i]).epsilon(1e-4));
+    REQUIRE(batchKernels[i] == Approx(naiveKernels[i]).epsilon(1e-4));
+  }
+}
+
+/**
+ * Make sure that the approximation setting is saved with a FastMKSModel.
+ */
+TEST_CASE("FastMKSModelEpsilonSerializationTest", "[FastMKSTest]")
+{
+  LinearKernel lk;
+  arma::mat referenceData = arma::randu<arma::mat>(5, 200);
+  util::Timers timers;
+
+  FastMKSModel m(FastMKSModel::LINEAR_KERNEL);
+  m.BuildModel(timers, std::move(referenceData), lk, false, false, 2.0);
+  m.Epsilon() = 0.25;
+
+  FastMKSModel mXml, mText, mBinary;
+  SerializeObjectAll(m, mXml, mText, mBinary);
+
+  REQUIRE(mXml.Epsilon() == Approx(0.25));
+  REQUIRE(mText.Epsilon() == Approx(0.25));
+  REQUIRE(mBinary.Epsilon() == Approx(0.25));
+
+  arma::mat queryData = arma::randu<arma::mat>(5, 50);
+  arma::Mat<size_t> indices, xmlIndices, textIndices, binaryIndices;
+  arma::mat kernels, xmlKernels, textKernels, binaryKernels;
+  m.Search(timers, queryData, 3, indices, kernels, 2.0);
+  mXml.Search(timers, queryData, 3, xmlIndices, xmlKernels, 2.0);
+  mText.Search(timers, queryData, 3, textIndices, textKernels, 2.0);
+  mBinary.Search(timers, queryData, 3, binaryIndices, binaryKernels, 2.0);
+
+  CheckMatrices(indices, xmlIndices, textIndices, binaryIndices);
+  CheckMatrices(kernels, xmlKernels, textKernels, binaryKernels);
+}
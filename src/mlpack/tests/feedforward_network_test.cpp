@@ -15,6 +15,13 @@
 #include <mlpack/methods/ann/layer/layer.hpp>
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/data_parallel_ffn.hpp>
+#include <mlpack/methods/ann/static_ffn.hpp>
+#include <mlpack/methods/ann/inference_session.hpp>
+#include <mlpack/methods/ann/prefetch_pipeline.hpp>
+#include <mlpack/methods/ann/fuse_network.hpp>
+#include <mlpack/methods/ann/quantize_network.hpp>
+#include <mlpack/core/data/async_checkpoint.hpp>
 
 #include <ensmallen.hpp>
 
@@ -1010,3 +1017,546 @@ TEST_CASE("FFNCheckInputShapeTest", "[FeedForwardNetworkTest]")
 
   REQUIRE_THROWS_AS(model.Train(trainData, trainLabels, opt), std::logic_error);
 }
+
+/**
+ * Make sure that StaticFFN gives the same predictions, objective and gradient
+ * as FFN with the same layers and parameters.
+ */
+TEST_CASE("StaticFFNMatchesFFNTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(10, 50);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 50) * 3);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  StaticFFN<NegativeLogLikelihood<>, RandomInitialization, Linear<>,
+      SigmoidLayer<>, Linear<>, LogSoftMax<> > staticModel(Linear<>(10, 8),
+      SigmoidLayer<>(), Linear<>(8, 3), LogSoftMax<>());
+  staticModel.ResetParameters();
+
+  REQUIRE(staticModel.Parameters().n_elem == model.Parameters().n_elem);
+  staticModel.Parameters() = model.Parameters();
+
+  arma::mat predictions, staticPredictions;
+  model.Predict(data, predictions);
+  staticModel.Predict(data, staticPredictions, 7);
+  CheckMatrices(predictions, staticPredictions);
+
+  REQUIRE(staticModel.Evaluate(data, labels) ==
+      Approx(model.Evaluate(data, labels)).epsilon(1e-7));
+
+  // The gradient on a batch of the training data.
+  ens::StandardSGD opt(0.0, 50, 1);
+  model.Train(data, labels, opt);
+  staticModel.Train(data, labels, opt);
+  staticModel.Parameters() = model.Parameters();
+
+  arma::mat gradient, staticGradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 50);
+  const double staticObjective = staticModel.EvaluateWithGradient(
+      staticModel.Parameters(), 0, staticGradient, 50);
+  REQUIRE(staticObjective == Approx(objective).epsilon(1e-7));
+  CheckMatrices(gradient, staticGradient);
+}
+
+/**
+ * Train a StaticFFN on the thyroid dataset and make sure that copies and
+ * serialized models give the same predictions.
+ */
+TEST_CASE("StaticFFNTrainCopySerializeTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat trainData;
+  if (!data::Load("thyroid_train.csv", trainData))
+    FAIL("Cannot open thyroid_train.csv");
+
+  arma::mat trainLabels = trainData.row(trainData.n_rows - 1) - 1;
+  trainData.shed_row(trainData.n_rows - 1);
+
+  arma::mat testData;
+  if (!data::Load("thyroid_test.csv", testData))
+    FAIL("Cannot load dataset thyroid_test.csv");
+
+  arma::mat testLabels = testData.row(testData.n_rows - 1) - 1;
+  testData.shed_row(testData.n_rows - 1);
+
+  typedef StaticFFN<NegativeLogLikelihood<>, RandomInitialization, Linear<>,
+      SigmoidLayer<>, Linear<>, LogSoftMax<> > ModelType;
+  ModelType model(Linear<>(trainData.n_rows, 8), SigmoidLayer<>(),
+      Linear<>(8, 3), LogSoftMax<>());
+
+  TestNetwork<>(model, trainData, trainLabels, testData, testLabels, 10, 0.1);
+
+  arma::mat predictions;
+  model.Predict(testData, predictions);
+
+  // Copy and move the model.
+  ModelType* copied = new ModelType(model);
+  ModelType moved(std::move(*copied));
+  delete copied;
+
+  arma::mat movedPredictions;
+  moved.Predict(testData, movedPredictions);
+  CheckMatrices(predictions, movedPredictions);
+
+  ModelType xmlModel(Linear<>(trainData.n_rows, 8), SigmoidLayer<>(),
+      Linear<>(8, 3), LogSoftMax<>());
+  ModelType jsonModel(xmlModel), binaryModel(xmlModel);
+  SerializeObjectAll(model, xmlModel, jsonModel, binaryModel);
+
+  arma::mat xmlPredictions, jsonPredictions, binaryPredictions;
+  xmlModel.Predict(testData, xmlPredictions);
+  jsonModel.Predict(testData, jsonPredictions);
+  binaryModel.Predict(testData, binaryPredictions);
+  CheckMatrices(predictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+}
+
+/**
+ * Make sure that an InferenceSession gives the same predictions as the network
+ * it was created from, for batches that do and do not divide the data.
+ */
+TEST_CASE("InferenceSessionTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(10, 53);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 20);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Dropout<> >();
+  model.Add<Linear<> >(20, 5);
+  model.Add<LogSoftMax<> >();
+
+  // The network must have parameters.
+  REQUIRE_THROWS_AS(InferenceSession<FFN<NegativeLogLikelihood<> > >(model,
+      10), std::invalid_argument);
+
+  model.ResetParameters();
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  // The wrong input size.
+  REQUIRE_THROWS_AS(InferenceSession<FFN<NegativeLogLikelihood<> > >(model,
+      9), std::logic_error);
+
+  InferenceSession<FFN<NegativeLogLikelihood<> > > session(model, 10, 8);
+  REQUIRE(session.OutputSize() == 5);
+  REQUIRE(session.LayerSizes().size() == 5);
+  REQUIRE(session.ArenaSize() == 2 * 20 * 8);
+
+  // Predict twice, so that the buffers are reused.
+  arma::mat sessionPredictions;
+  session.Predict(data, sessionPredictions);
+  CheckMatrices(predictions, sessionPredictions);
+  session.Predict(data, sessionPredictions);
+  CheckMatrices(predictions, sessionPredictions);
+
+  REQUIRE_THROWS_AS(session.Predict(arma::mat(9, 10), sessionPredictions),
+      std::invalid_argument);
+
+  // The network itself still works.
+  arma::mat predictions2;
+  model.Predict(data, predictions2);
+  CheckMatrices(predictions, predictions2);
+}
+
+/**
+ * Fold BatchNorm and activation layers into the preceding Linear layer, and
+ * make sure that the fused network gives the same predictions.
+ */
+TEST_CASE("FuseNetworkLinearTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(10, 100);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 100) * 3);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<BatchNorm<> >(8);
+  model.Add<ReLULayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  FFN<NegativeLogLikelihood<> > unfused;
+  REQUIRE_THROWS_AS(FuseNetwork(model, unfused), std::invalid_argument);
+
+  // Train the network a little, so that BatchNorm has non-trivial statistics.
+  ens::StandardSGD opt(0.01, 10, 500);
+  model.Train(data, labels, opt);
+
+  FFN<NegativeLogLikelihood<> > fused;
+  REQUIRE(FuseNetwork(model, fused) == 2);
+  REQUIRE(fused.Model().size() == 3);
+  REQUIRE(boost::get<FusedLinear<RectifierFunction>*>(&fused.Model()[0]) !=
+      NULL);
+
+  arma::mat predictions, fusedPredictions;
+  model.Predict(data, predictions);
+  fused.Predict(data, fusedPredictions);
+  CheckMatrices(predictions, fusedPredictions, 1e-3);
+
+  // The fused layer must serialize.
+  FFN<NegativeLogLikelihood<> > xmlModel, jsonModel, binaryModel;
+  SerializeObjectAll(fused, xmlModel, jsonModel, binaryModel);
+
+  arma::mat xmlPredictions, jsonPredictions, binaryPredictions;
+  xmlModel.Predict(data, xmlPredictions);
+  jsonModel.Predict(data, jsonPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+  CheckMatrices(fusedPredictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+}
+
+/**
+ * Fold a BatchNorm layer into the preceding Convolution layer.
+ */
+TEST_CASE("FuseNetworkConvolutionTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(25, 50);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 50) * 3);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Convolution<> >(1, 2, 3, 3, 1, 1, 0, 0, 5, 5);
+  model.Add<BatchNorm<> >(2);
+  model.Add<Linear<> >(18, 3);
+  model.Add<LogSoftMax<> >();
+
+  ens::StandardSGD opt(0.01, 10, 200);
+  model.Train(data, labels, opt);
+
+  FFN<NegativeLogLikelihood<> > fused;
+  REQUIRE(FuseNetwork(model, fused) == 1);
+  REQUIRE(fused.Model().size() == 3);
+
+  arma::mat predictions, fusedPredictions;
+  model.Predict(data, predictions);
+  fused.Predict(data, fusedPredictions);
+  CheckMatrices(predictions, fusedPredictions, 1e-3);
+}
+
+/**
+ * Quantize a network with Convolution and Linear layers to int8, and make sure
+ * that the quantized network gives approximately the same predictions.
+ */
+TEST_CASE("QuantizeNetworkTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(25, 100);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 100) * 3);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Convolution<> >(1, 2, 3, 3, 1, 1, 1, 1, 5, 5);
+  model.Add<ReLULayer<> >();
+  model.Add<Linear<> >(50, 8);
+  model.Add<TanHLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  FFN<NegativeLogLikelihood<> > quantized;
+  REQUIRE_THROWS_AS(QuantizeNetwork(model, data, quantized),
+      std::invalid_argument);
+
+  ens::StandardSGD opt(0.01, 10, 200);
+  model.Train(data, labels, opt);
+
+  REQUIRE(QuantizeNetwork(model, data, quantized, 32) == 3);
+  REQUIRE(quantized.Model().size() == 6);
+  REQUIRE(boost::get<QuantizedConvolution<>*>(&quantized.Model()[0]) != NULL);
+  REQUIRE(boost::get<QuantizedLinear<>*>(&quantized.Model()[2]) != NULL);
+
+  // The error of int8 quantization is about 1% of the range of each layer.
+  arma::mat predictions, quantizedPredictions;
+  model.Predict(data, predictions);
+  quantized.Predict(data, quantizedPredictions);
+  REQUIRE(quantizedPredictions.n_rows == predictions.n_rows);
+  REQUIRE(quantizedPredictions.n_cols == predictions.n_cols);
+  REQUIRE(arma::abs(predictions - quantizedPredictions).max() < 0.1);
+
+  // The quantized layers must serialize.
+  FFN<NegativeLogLikelihood<> > xmlModel, jsonModel, binaryModel;
+  SerializeObjectAll(quantized, xmlModel, jsonModel, binaryModel);
+
+  arma::mat xmlPredictions, jsonPredictions, binaryPredictions;
+  xmlModel.Predict(data, xmlPredictions);
+  jsonModel.Predict(data, jsonPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+  CheckMatrices(quantizedPredictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+}
+
+/**
+ * Train the same network with FFN::Train() and with DataParallelFFN, and make
+ * sure that the parameters are the same, for an output layer that averages
+ * its loss and for one that sums it.
+ */
+TEST_CASE("DataParallelFFNTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(5, 64);
+  arma::mat targets = arma::randu<arma::mat>(2, 64);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 64) * 3);
+
+  // Training with FFN::Train() re-initializes the parameters unless the
+  // network has been used before, so predict once first.
+  arma::mat predictions;
+  FFN<MeanSquaredError<> > model, parallelModel;
+  model.Add<Linear<> >(5, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 2);
+  parallelModel.Add<Linear<> >(5, 8);
+  parallelModel.Add<SigmoidLayer<> >();
+  parallelModel.Add<Linear<> >(8, 2);
+  model.Predict(data, predictions);
+  parallelModel.Predict(data, predictions);
+  parallelModel.Parameters() = model.Parameters();
+
+  ens::StandardSGD opt(0.1, 16, 192, -1, false);
+  model.Train(data, targets, opt);
+
+  DataParallelFFN<FFN<MeanSquaredError<> > > parallel(parallelModel, 3);
+  REQUIRE(parallel.NumReplicas() == 3);
+  parallel.Train(data, targets, opt);
+  CheckMatrices(model.Parameters(), parallelModel.Parameters());
+
+  FFN<NegativeLogLikelihood<> > nllModel, parallelNLLModel;
+  nllModel.Add<Linear<> >(5, 3);
+  nllModel.Add<LogSoftMax<> >();
+  parallelNLLModel.Add<Linear<> >(5, 3);
+  parallelNLLModel.Add<LogSoftMax<> >();
+  nllModel.Predict(data, predictions);
+  parallelNLLModel.Predict(data, predictions);
+  parallelNLLModel.Parameters() = nllModel.Parameters();
+
+  ens::StandardSGD nllOpt(0.01, 16, 192, -1, false);
+  nllModel.Train(data, labels, nllOpt);
+
+  DataParallelFFN<FFN<NegativeLogLikelihood<> > > parallelNLL(
+      parallelNLLModel, 4);
+  parallelNLL.Train(data, labels, nllOpt);
+  CheckMatrices(nllModel.Parameters(), parallelNLLModel.Parameters());
+}
+
+/**
+ * Make sure that a PrefetchPipeline built from data in memory delivers each
+ * point once per epoch, and that errors of the loader reach the consumer.
+ */
+TEST_CASE("PrefetchPipelineTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::linspace<arma::rowvec>(0, 9, 10);
+  arma::mat responses = data + 100;
+
+  PrefetchPipeline<> pipeline(data, responses, 3, 2);
+  REQUIRE(pipeline.NumBatches() == 4);
+  REQUIRE(pipeline.NumPoints() == 10);
+
+  for (size_t epoch = 0; epoch < 3; ++epoch)
+  {
+    arma::mat x, y, seen;
+    for (size_t b = 0; b < pipeline.NumBatches(); ++b)
+    {
+      pipeline.Next(x, y);
+      REQUIRE(x.n_cols <= 3);
+      CheckMatrices(x + 100, y);
+      seen = arma::join_rows(seen, x);
+    }
+
+    CheckMatrices(arma::sort(seen, "ascend", 1), data);
+  }
+  pipeline.Stop();
+
+  PrefetchPipeline<> failing([](const size_t batch, arma::mat& x,
+      arma::mat& y)
+  {
+    if (batch == 1)
+      throw std::runtime_error("cannot load batch");
+    x.zeros(2, 4);
+    y.zeros(1, 4);
+  }, 2, 4, 2, false);
+
+  arma::mat x, y;
+  failing.Next(x, y);
+  REQUIRE(x.n_cols == 4);
+  REQUIRE_THROWS_AS(failing.Next(x, y), std::runtime_error);
+}
+
+/**
+ * Train a network with the batches of a PrefetchPipeline.
+ */
+TEST_CASE("PrefetchPipelineTrainTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(2, 200);
+  arma::mat labels = arma::conv_to<arma::mat>::from(
+      data.row(0) > data.row(1));
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(2, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 2);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+  const double initialLoss = model.Evaluate(data, labels);
+
+  PrefetchPipeline<> pipeline(data, labels, 20);
+  ens::StandardSGD opt(0.05, 20, 200 * 50);
+  pipeline.Train(model, opt);
+
+  REQUIRE(model.Evaluate(data, labels) < 0.5 * initialLoss);
+}
+
+/**
+ * Make sure that a StaticFFN over arma::fmat gives the same predictions as the
+ * same network over arma::mat (up to rounding), and that it can be trained,
+ * with and without a double precision master copy of the weights.
+ */
+TEST_CASE("StaticFFNSinglePrecisionTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(10, 100);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 100) * 3);
+  arma::fmat fdata = arma::conv_to<arma::fmat>::from(data);
+  arma::fmat flabels = arma::conv_to<arma::fmat>::from(labels);
+
+  StaticFFN<NegativeLogLikelihood<>, RandomInitialization, Linear<>,
+      SigmoidLayer<>, Linear<>, LogSoftMax<> > model(Linear<>(10, 8),
+      SigmoidLayer<>(), Linear<>(8, 3), LogSoftMax<>());
+  model.ResetParameters();
+
+  typedef StaticFFN<NegativeLogLikelihood<>, RandomInitialization,
+      Linear<arma::fmat, arma::fmat>,
+      SigmoidLayer<arma::fmat, arma::fmat>,
+      Linear<arma::fmat, arma::fmat>,
+      LogSoftMax<arma::fmat, arma::fmat> > FloatNetwork;
+  FloatNetwork floatModel(Linear<arma::fmat, arma::fmat>(10, 8),
+      SigmoidLayer<arma::fmat, arma::fmat>(),
+      Linear<arma::fmat, arma::fmat>(8, 3),
+      LogSoftMax<arma::fmat, arma::fmat>());
+  floatModel.ResetParameters();
+  REQUIRE(floatModel.Parameters().n_elem == model.Parameters().n_elem);
+  // Copy into the existing memory, which the layers alias.
+  const arma::fmat floatParameters = arma::conv_to<arma::fmat>::from(
+      model.Parameters());
+  floatModel.Parameters() = floatParameters;
+
+  arma::mat predictions;
+  arma::fmat floatPredictions;
+  model.Predict(data, predictions);
+  floatModel.Predict(fdata, floatPredictions);
+  CheckMatrices(predictions, arma::conv_to<arma::mat>::from(floatPredictions),
+      1e-3);
+
+  // Train in single precision, with and without master weights.
+  FloatNetwork masterModel(floatModel);
+  const double initialLoss = floatModel.Evaluate(fdata, flabels);
+
+  ens::StandardSGD opt(0.01, 10, 100 * 20);
+  floatModel.Train(fdata, flabels, opt);
+  REQUIRE(floatModel.Evaluate(fdata, flabels) < initialLoss);
+
+  masterModel.TrainMixedPrecision(fdata, flabels, opt);
+  REQUIRE(masterModel.Evaluate(fdata, flabels) < initialLoss);
+}
+
+/**
+ * Make sure that the layer profiler records every layer call of an FFN, and
+ * writes the table and the trace.
+ */
+TEST_CASE("FFNLayerProfilerTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(10, 64);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 64) * 3);
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  // Nothing is recorded unless the profiler is enabled.
+  ens::StandardSGD opt(0.01, 16, 64);
+  model.Train(data, labels, opt);
+  REQUIRE(model.Profiler().Statistics().empty());
+
+  model.Profiler().Enabled() = true;
+  model.Profiler().Trace() = true;
+  arma::mat gradient;
+  for (size_t b = 0; b < 4; ++b)
+    model.EvaluateWithGradient(model.Parameters(), 16 * b, gradient, 16);
+
+  // Four batches of 16 points: each layer is called four times in each pass,
+  // except for the backward pass of the first layer, which is not needed.
+  const std::vector<LayerProfiler::LayerStatistics>& statistics =
+      model.Profiler().Statistics();
+  REQUIRE(statistics.size() == 4);
+  size_t calls = 0;
+  for (size_t i = 0; i < statistics.size(); ++i)
+  {
+    REQUIRE(statistics[i].calls[LayerProfiler::FORWARD] == 4);
+    REQUIRE(statistics[i].calls[LayerProfiler::BACKWARD] == ((i == 0) ? 0 : 4));
+    REQUIRE(statistics[i].calls[LayerProfiler::GRADIENT] == 4);
+    calls += statistics[i].calls[LayerProfiler::FORWARD] +
+        statistics[i].calls[LayerProfiler::BACKWARD] +
+        statistics[i].calls[LayerProfiler::GRADIENT];
+  }
+  REQUIRE(statistics[0].name.find("Linear") == 0);
+  REQUIRE(statistics[1].name.find("BaseLayer<LogisticFunction") == 0);
+  REQUIRE(statistics[0].weights == 10 * 8 + 8);
+  REQUIRE(statistics[1].weights == 0);
+  REQUIRE(statistics[2].outputBytes == 3 * 16 * sizeof(double));
+  REQUIRE(model.Profiler().Events().size() == calls);
+
+  std::ostringstream table;
+  model.Profiler().Print(table);
+  REQUIRE(table.str().find("Linear") != std::string::npos);
+
+  std::ostringstream trace;
+  model.Profiler().WriteTrace(trace);
+  REQUIRE(trace.str().find("{\"traceEvents\":[") == 0);
+  REQUIRE(trace.str().find("\"cat\":\"Gradient\"") != std::string::npos);
+
+  model.Profiler().Reset();
+  REQUIRE(model.Profiler().Statistics().empty());
+  REQUIRE(model.Profiler().Events().empty());
+}
+
+/**
+ * Make sure that AsyncCheckpoint saves the model during training, and that the
+ * last checkpoint holds the trained parameters.
+ */
+TEST_CASE("AsyncCheckpointTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 64, arma::fill::randu);
+  arma::mat labels = arma::floor(3 * arma::randu<arma::mat>(1, 64));
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  // Four epochs, with a checkpoint every two epochs.
+  ens::StandardSGD opt(0.01, 16, 4 * 64);
+  {
+    data::AsyncCheckpoint<FFN<NegativeLogLikelihood<> > > checkpoint(model,
+        "ffn_checkpoint.bin", "model", 2);
+    model.Train(data, labels, opt, checkpoint);
+    checkpoint.Wait();
+
+    REQUIRE(checkpoint.Saver().Failed() == 0);
+    REQUIRE(checkpoint.Saver().Written() + checkpoint.Saver().Dropped() >= 1);
+  }
+
+  FFN<NegativeLogLikelihood<> > loadedModel;
+  REQUIRE(data::Load("ffn_checkpoint.bin", "model", loadedModel));
+
+  arma::mat predictions, loadedPredictions;
+  model.Predict(data, predictions);
+  loadedModel.Predict(data, loadedPredictions);
+  CheckMatrices(predictions, loadedPredictions);
+
+  REQUIRE_THROWS_AS(data::AsyncCheckpoint<FFN<NegativeLogLikelihood<> > >(
+      model, "ffn_checkpoint.bin", "model", 0), std::invalid_argument);
+
+  remove("ffn_checkpoint.bin");
+}
@@ -345,3 +345,54 @@ TEST_CASE("GANMemorySharingTest", "[GANNetworkTest]")
   CheckMatricesNotEqual(gan.Predictors().head_cols(trainData.n_cols),
       trainData);
 }
+
+/*
+ * Make sure that generating the fake points while the Discriminator is trained
+ * on the real points gives the same results as doing it afterwards.
+ */
+TEST_CASE("GANOverlapGeneratorTest", "[GANNetworkTest]")
+{
+  const size_t batchSize = 8;
+  const size_t noiseDim = 2;
+
+  arma::mat trainData(1, 200);
+  trainData.imbue( [&]() { return arma::as_scalar(RandNormal(4, 0.5));});
+
+  FFN<SigmoidCrossEntropyError<> > discriminator;
+  discriminator.Add<Linear<> >(1, 8);
+  discriminator.Add<ReLULayer<> >();
+  discriminator.Add<Linear<> >(8, 1);
+
+  FFN<SigmoidCrossEntropyError<> > generator;
+  generator.Add<Linear<> >(noiseDim, 8);
+  generator.Add<SoftPlusLayer<> >();
+  generator.Add<Linear<> >(8, 1);
+
+  // The noise function is called from another thread, so it has its own
+  // random number generator; each GAN gets a copy of it.
+  std::mt19937 rng(7);
+  std::normal_distribution<double> normal;
+  std::function<double ()> noiseFunction = [rng, normal]() mutable
+      { return normal(rng); };
+
+  GaussianInitialization gaussian(0, 0.1);
+  typedef GAN<FFN<SigmoidCrossEntropyError<> >, GaussianInitialization,
+      std::function<double()> > GANType;
+  GANType gan(generator, discriminator, gaussian, noiseFunction, noiseDim,
+      batchSize, 1, 0, 1);
+  GANType overlapGAN(generator, discriminator, gaussian, noiseFunction,
+      noiseDim, batchSize, 1, 0, 1);
+  overlapGAN.OverlapGenerator() = true;
+
+  ens::Adam optimizer(0.001, batchSize, 0.9, 0.999, 1e-8,
+      5 * trainData.n_cols, -1, false);
+
+  math::RandomSeed(42);
+  const double objective = gan.Train(trainData, optimizer);
+  math::RandomSeed(42);
+  const double overlapObjective = overlapGAN.Train(trainData, optimizer);
+
+  REQUIRE(overlapObjective == Approx(objective).epsilon(1e-7));
+  CheckMatrices(overlapGAN.Parameters(), gan.Parameters());
+  CheckMatrices(overlapGAN.Predictors(), gan.Predictors());
+}
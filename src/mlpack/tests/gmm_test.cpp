@@ -122,6 +122,29 @@ TEST_CASE("GMMTrainEMOneGaussian", "[GMMTest]")
   }
 }
 
+/**
+ * Make sure that the blocked EM steps give the exact mean and covariance of one
+ * Gaussian when the dataset spans many blocks and is far from the origin.
+ */
+TEST_CASE("GMMTrainEMOneGaussianManyBlocks", "[GMMTest]")
+{
+  arma::mat data;
+  data.randn(20, 20000);
+  data.each_row() %= arma::linspace<arma::rowvec>(0.5, 2.0, 20000);
+  data += 100.0;
+
+  GMM gmm(1, 20);
+  gmm.Train(data, 1);
+
+  arma::vec actualMean = arma::mean(data, 1);
+  arma::mat actualCovar = mlpack::math::ColumnCovariance(data,
+      1 /* biased estimator */);
+
+  REQUIRE(arma::norm(gmm.Component(0).Mean() - actualMean) < 1e-5);
+  REQUIRE(arma::norm(gmm.Component(0).Covariance() - actualCovar) < 1e-4);
+  REQUIRE(gmm.Weights()[0] == Approx(1.0).epsilon(1e-7));
+}
+
 /**
  * Test a training model on multiple Gaussians in higher dimensionality than
  * two.  We will hold the dataset size constant at 10k points.  The EM algorithm
@@ -914,6 +937,61 @@ TEST_CASE("DiagonalGMMTrainEMOneGaussian", "[GMMTest]")
   }
 }
 
+/**
+ * Train a GMM on two well-separated Gaussians with online EM.
+ */
+TEST_CASE("GMMTrainOnlineEMTwoGaussians", "[GMMTest]")
+{
+  arma::mat data(2, 10000, arma::fill::randn);
+  data.cols(5000, 9999) += 10.0;
+
+  GMM gmm(2, 2);
+  OnlineEMFit<> fitter(500, 3);
+  gmm.Train(data, 1, false, fitter);
+
+  // Find which component is which.
+  const size_t first = (gmm.Component(0).Mean()[0] < 5.0) ? 0 : 1;
+  const size_t second = 1 - first;
+
+  REQUIRE(arma::norm(gmm.Component(first).Mean()) < 0.2);
+  REQUIRE(arma::norm(gmm.Component(second).Mean() - 10.0) < 0.2);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    REQUIRE(arma::norm(gmm.Component(i).Covariance() -
+        arma::eye<arma::mat>(2, 2)) < 0.3);
+    REQUIRE(gmm.Weights()[i] == Approx(0.5).epsilon(0.1));
+  }
+}
+
+/**
+ * Fold new data into a trained DiagonalGMM with online EM.
+ */
+TEST_CASE("DiagonalGMMOnlineUpdateTest", "[GMMTest]")
+{
+  arma::mat data(3, 2000, arma::fill::randn);
+
+  DiagonalGMM gmm(1, 3);
+  gmm.Train(data);
+
+  // Data from the same distribution should not move the model much.
+  OnlineEMFit<kmeans::KMeans<>, DiagonalConstraint,
+      distribution::DiagonalGaussianDistribution> fitter;
+  for (size_t i = 0; i < 10; ++i)
+    gmm.Update(arma::randn<arma::mat>(3, 500), fitter);
+
+  REQUIRE(fitter.Steps() == 10);
+  REQUIRE(arma::norm(gmm.Component(0).Mean()) < 0.2);
+  REQUIRE(arma::norm(gmm.Component(0).Covariance() - 1.0) < 0.3);
+  REQUIRE(gmm.Weights()[0] == Approx(1.0).epsilon(1e-7));
+
+  // Shifted data should move the mean towards the new data.
+  for (size_t i = 0; i < 10; ++i)
+    gmm.Update(arma::randn<arma::mat>(3, 500) + 2.0, fitter);
+
+  REQUIRE(arma::min(gmm.Component(0).Mean()) > 0.5);
+  REQUIRE(arma::max(gmm.Component(0).Mean()) < 2.2);
+}
+
 /**
  * Make sure we can train a single Gaussian Mixture Model with diagonal
  * covariance reasonably using Train() where probabilities of the observation
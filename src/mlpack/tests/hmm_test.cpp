@@ -528,6 +528,100 @@ TEST_CASE("DiscreteHMMLogLikelihoodTest", "[HMMTest]")
       Approx(-24.51556128368).epsilon(1e-7));
 }
 
+/**
+ * Make sure that a left-to-right HMM, whose transition matrix is sparse, gives
+ * the same log-likelihoods and most probable paths as computing them directly,
+ * and that Baum-Welch training keeps impossible transitions impossible.
+ */
+TEST_CASE("LeftToRightHMMSparseTransitionTest", "[HMMTest]")
+{
+  const size_t states = 20;
+  arma::vec initial(states, arma::fill::zeros);
+  initial[0] = 1.0;
+  arma::mat transition(states, states, arma::fill::zeros);
+  for (size_t j = 0; j < states; ++j)
+  {
+    transition(j, j) = (j == states - 1) ? 1.0 : 0.7;
+    if (j < states - 1)
+      transition(j + 1, j) = 0.3;
+  }
+
+  std::vector<DiscreteDistribution> emission(states, DiscreteDistribution(4));
+  for (size_t j = 0; j < states; ++j)
+  {
+    arma::vec probabilities(4, arma::fill::randu);
+    emission[j].Probabilities() = probabilities / arma::accu(probabilities);
+  }
+
+  HMM<DiscreteDistribution> hmm(initial, transition, emission);
+
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    arma::mat dataSeq;
+    arma::Row<size_t> stateSeq;
+    hmm.Generate(60, dataSeq, stateSeq);
+
+    // Compute the log-likelihood with a scaled forward pass in linear space.
+    arma::vec emissionProbs(states);
+    for (size_t j = 0; j < states; ++j)
+      emissionProbs[j] = emission[j].Probability(dataSeq.col(0));
+    arma::vec alpha = initial % emissionProbs;
+    double logLikelihood = std::log(arma::accu(alpha));
+    alpha /= arma::accu(alpha);
+    for (size_t t = 1; t < dataSeq.n_cols; ++t)
+    {
+      for (size_t j = 0; j < states; ++j)
+        emissionProbs[j] = emission[j].Probability(dataSeq.col(t));
+      alpha = (transition * alpha) % emissionProbs;
+      logLikelihood += std::log(arma::accu(alpha));
+      alpha /= arma::accu(alpha);
+    }
+
+    REQUIRE(hmm.LogLikelihood(dataSeq) ==
+        Approx(logLikelihood).epsilon(1e-7));
+
+    // The most probable path must be possible, its log-probability must be
+    // the returned one, and it must be at least as probable as the true path.
+    arma::Row<size_t> predicted;
+    const double pathLogProb = hmm.Predict(dataSeq, predicted);
+    double predictedLogProb = std::log(initial[predicted[0]]) +
+        std::log(emission[predicted[0]].Probability(dataSeq.col(0)));
+    double trueLogProb = std::log(initial[stateSeq[0]]) +
+        std::log(emission[stateSeq[0]].Probability(dataSeq.col(0)));
+    for (size_t t = 1; t < dataSeq.n_cols; ++t)
+    {
+      predictedLogProb += std::log(transition(predicted[t],
+          predicted[t - 1])) + std::log(emission[predicted[t]].Probability(
+          dataSeq.col(t)));
+      trueLogProb += std::log(transition(stateSeq[t], stateSeq[t - 1])) +
+          std::log(emission[stateSeq[t]].Probability(dataSeq.col(t)));
+    }
+
+    REQUIRE(std::isfinite(pathLogProb));
+    REQUIRE(pathLogProb == Approx(predictedLogProb).epsilon(1e-7));
+    REQUIRE(pathLogProb >= trueLogProb - 1e-7);
+  }
+
+  // Train on generated sequences; the zero transitions must stay zero.
+  std::vector<arma::mat> dataSeqs(10);
+  for (size_t i = 0; i < dataSeqs.size(); ++i)
+  {
+    arma::Row<size_t> stateSeq;
+    hmm.Generate(100, dataSeqs[i], stateSeq);
+  }
+  hmm.Train(dataSeqs);
+
+  for (size_t j = 0; j < states; ++j)
+  {
+    for (size_t i = 0; i < states; ++i)
+    {
+      if (i != j && i != j + 1)
+        REQUIRE(hmm.Transition()(i, j) == 0.0);
+    }
+    REQUIRE(arma::accu(hmm.Transition().col(j)) == Approx(1.0).epsilon(1e-7));
+  }
+}
+
 /**
  * A simple test to make sure HMMs with Gaussian output distributions work.
  */
@@ -746,6 +840,49 @@ TEST_CASE("GaussianHMMGenerateTest", "[HMMTest]")
   }
 }
 
+/**
+ * Make sure that the batched Predict() and LogLikelihood() give the same
+ * results as calling them on each sequence.
+ */
+TEST_CASE("GaussianHMMBatchPredictTest", "[HMMTest]")
+{
+  HMM<GaussianDistribution> hmm(3, GaussianDistribution(2));
+  hmm.Transition() = arma::mat("0.4 0.6 0.8; 0.2 0.2 0.1; 0.4 0.2 0.1");
+  hmm.Emission()[0] = GaussianDistribution("0.0 0.0", "1.0 0.0; 0.0 1.0");
+  hmm.Emission()[1] = GaussianDistribution("2.0 2.0", "1.0 0.5; 0.5 1.2");
+  hmm.Emission()[2] = GaussianDistribution("-2.0 1.0", "2.0 0.1; 0.1 1.0");
+
+  std::vector<arma::mat> observations(50);
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    arma::Row<size_t> states;
+    hmm.Generate(20 + 10 * i, observations[i], states, i % 3);
+  }
+
+  std::vector<arma::Row<size_t>> predictions;
+  arma::vec predictionLogLikelihoods;
+  hmm.Predict(observations, predictions, predictionLogLikelihoods);
+
+  arma::vec logLikelihoods;
+  hmm.LogLikelihood(observations, logLikelihoods);
+
+  REQUIRE(predictions.size() == observations.size());
+  REQUIRE(predictionLogLikelihoods.n_elem == observations.size());
+  REQUIRE(logLikelihoods.n_elem == observations.size());
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    arma::Row<size_t> prediction;
+    const double predictionLogLikelihood = hmm.Predict(observations[i],
+        prediction);
+
+    REQUIRE(arma::all(prediction == predictions[i]));
+    REQUIRE(predictionLogLikelihoods[i] ==
+        Approx(predictionLogLikelihood).epsilon(1e-10));
+    REQUIRE(logLikelihoods[i] ==
+        Approx(hmm.LogLikelihood(observations[i])).epsilon(1e-10));
+  }
+}
+
 /**
  * Make sure that Predict() is numerically stable.
  */
@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/core.hpp>
+#include <mlpack/core/data/compressed_dataset.hpp>
 #include <mlpack/methods/hoeffding_trees/gini_impurity.hpp>
 #include <mlpack/methods/hoeffding_trees/information_gain.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree.hpp>
@@ -1526,3 +1527,203 @@ TEST_CASE("HoeffdingTreeEmptyConstructorTrainTest", "[HoeffdingTreeTest]")
   REQUIRE_NOTHROW(ht.Train(data, labels, false, true, 2));
   REQUIRE_NOTHROW(ht.Train(data2, info, labels2, false, 3));
 }
+
+/**
+ * Make sure that training in streaming mode on minibatches gives the same tree
+ * as training on each point separately.
+ */
+TEST_CASE("HoeffdingTreeMinibatchStreamingTest", "[HoeffdingTreeTest]")
+{
+  // Generate data.
+  arma::mat dataset(4, 9000);
+  arma::Row<size_t> labels(9000);
+  data::DatasetInfo info(4); // All features are numeric, except the fourth.
+  info.MapString<double>("0", 3);
+  info.MapString<double>("1", 3);
+  for (size_t i = 0; i < 9000; i += 3)
+  {
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::Random();
+    dataset(2, i) = mlpack::math::Random();
+    dataset(3, i) = 0.0;
+    labels[i] = 0;
+
+    dataset(0, i + 1) = mlpack::math::Random();
+    dataset(1, i + 1) = mlpack::math::Random() - 1.0;
+    dataset(2, i + 1) = mlpack::math::Random() + 0.5;
+    dataset(3, i + 1) = 1.0;
+    labels[i + 1] = 2;
+
+    dataset(0, i + 2) = mlpack::math::Random();
+    dataset(1, i + 2) = mlpack::math::Random() + 1.0;
+    dataset(2, i + 2) = mlpack::math::Random() + 0.8;
+    dataset(3, i + 2) = 0.0;
+    labels[i + 2] = 1;
+  }
+
+  // Check for splits often, so that leaves split in the middle of batches.
+  HoeffdingTree<> pointTree(info, 3, 0.95, 0, 50, 100);
+  HoeffdingTree<> batchTree(info, 3, 0.95, 0, 50, 100);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    pointTree.Train(dataset.col(i), labels[i]);
+
+  // Stream the points in batches.
+  for (size_t begin = 0; begin < dataset.n_cols; begin += 1500)
+  {
+    const arma::mat batch = dataset.cols(begin, begin + 1499);
+    const arma::Row<size_t> batchLabels = labels.cols(begin, begin + 1499);
+    batchTree.Train(batch, batchLabels, false);
+  }
+
+  REQUIRE(pointTree.NumChildren() > 0);
+  REQUIRE(batchTree.NumChildren() == pointTree.NumChildren());
+  REQUIRE(batchTree.SplitDimension() == pointTree.SplitDimension());
+
+  arma::Row<size_t> pointPredictions, batchPredictions;
+  arma::rowvec pointProbabilities, batchProbabilities;
+  pointTree.Classify(dataset, pointPredictions, pointProbabilities);
+  batchTree.Classify(dataset, batchPredictions, batchProbabilities);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    REQUIRE(batchPredictions[i] == pointPredictions[i]);
+    REQUIRE(batchProbabilities[i] ==
+        Approx(pointProbabilities[i]).epsilon(1e-7));
+  }
+}
+
+/**
+ * Make sure that the HoeffdingNumericSplit frees the points it holds before
+ * binning once the binning is done.
+ */
+TEST_CASE("HoeffdingNumericSplitMemoryUsageTest", "[HoeffdingTreeTest]")
+{
+  HoeffdingNumericSplit<GiniImpurity> split(3, 10, 100);
+  const size_t untrainedMemory = split.MemoryUsage();
+
+  for (size_t i = 0; i < 99; ++i)
+    split.Train(mlpack::math::Random(), i % 3);
+  const size_t beforeBinningMemory = split.MemoryUsage();
+  REQUIRE(beforeBinningMemory > untrainedMemory);
+
+  for (size_t i = 99; i < 1000; ++i)
+    split.Train(mlpack::math::Random(), i % 3);
+  REQUIRE(split.MemoryUsage() < beforeBinningMemory);
+}
+
+/**
+ * Train a tree whose numeric splits keep every point on a long stream with a
+ * memory limit, and make sure that the limit is respected, that leaves are
+ * deactivated, and that the tree is still accurate.
+ */
+TEST_CASE("HoeffdingTreeMemoryLimitTest", "[HoeffdingTreeTest]")
+{
+  // Generate data.
+  arma::mat dataset(4, 30000);
+  arma::Row<size_t> labels(30000);
+  data::DatasetInfo info(4); // All features are numeric, except the fourth.
+  info.MapString<double>("0", 3);
+  for (size_t i = 0; i < 30000; i += 3)
+  {
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::Random();
+    dataset(2, i) = mlpack::math::Random();
+    dataset(3, i) = 0.0;
+    labels[i] = 0;
+
+    dataset(0, i + 1) = mlpack::math::Random();
+    dataset(1, i + 1) = mlpack::math::Random() - 1.0;
+    dataset(2, i + 1) = mlpack::math::Random() + 0.5;
+    dataset(3, i + 1) = 0.0;
+    labels[i + 1] = 2;
+
+    dataset(0, i + 2) = mlpack::math::Random();
+    dataset(1, i + 2) = mlpack::math::Random() + 1.0;
+    dataset(2, i + 2) = mlpack::math::Random() + 0.8;
+    dataset(3, i + 2) = 0.0;
+    labels[i + 2] = 1;
+  }
+
+  typedef HoeffdingTree<GiniImpurity, BinaryDoubleNumericSplit> TreeType;
+  TreeType unlimitedTree(info, 3);
+  TreeType limitedTree(info, 3);
+  const size_t memoryLimit = 100000;
+  limitedTree.MemoryLimit(memoryLimit);
+
+  // Train both trees on the stream in batches of points.
+  for (size_t begin = 0; begin < dataset.n_cols; begin += 1000)
+  {
+    const arma::mat batch = dataset.cols(begin, begin + 999);
+    const arma::Row<size_t> batchLabels = labels.cols(begin, begin + 999);
+    unlimitedTree.Train(batch, batchLabels, false);
+    limitedTree.Train(batch, batchLabels, false);
+
+    REQUIRE(limitedTree.MemoryUsage() <= memoryLimit);
+  }
+
+  REQUIRE(unlimitedTree.MemoryUsage() > memoryLimit);
+  REQUIRE(limitedTree.MemoryLimit() == memoryLimit);
+
+  // Some leaves must have been deactivated.
+  size_t inactiveLeaves = 0;
+  std::stack<const TreeType*> stack;
+  stack.push(&limitedTree);
+  while (!stack.empty())
+  {
+    const TreeType* node = stack.top();
+    stack.pop();
+
+    if (node->NumChildren() == 0 && !node->Active())
+      ++inactiveLeaves;
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      stack.push(&node->Child(i));
+  }
+  REQUIRE(inactiveLeaves > 0);
+
+  // The tree should still be accurate.
+  arma::Row<size_t> predictions;
+  limitedTree.Classify(dataset, predictions);
+  const size_t correct = arma::accu(predictions == labels);
+  REQUIRE(double(correct) / double(dataset.n_cols) > 0.95);
+}
+
+/**
+ * Make sure that a Hoeffding tree trained in batch mode on a CompressedDataset
+ * is the same as one trained on the original dataset.
+ */
+TEST_CASE("HoeffdingTreeCompressedDatasetTest", "[HoeffdingTreeTest]")
+{
+  // A dataset with two categorical dimensions and one numeric dimension.
+  arma::mat dataset(3, 5000);
+  arma::Row<size_t> labels(5000);
+  DatasetInfo info(3);
+  info.Type(0) = Datatype::categorical;
+  info.Type(1) = Datatype::categorical;
+  for (size_t i = 0; i < 3; ++i)
+    info.MapString<double>(std::to_string(i), 0);
+  for (size_t i = 0; i < 10; ++i)
+    info.MapString<double>(std::to_string(i), 1);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    dataset(0, i) = math::RandInt(3);
+    dataset(1, i) = math::RandInt(10);
+    dataset(2, i) = (float) math::Random();
+    labels[i] = (dataset(0, i) == 1 || dataset(2, i) > 0.8) ? 1 : 0;
+  }
+
+  CompressedDataset compressed(dataset, info);
+
+  HoeffdingTree<> tree(dataset, info, labels, 2, true);
+  HoeffdingTree<> compressedTree(compressed, info, labels, 2, true);
+
+  REQUIRE(tree.NumChildren() == compressedTree.NumChildren());
+  REQUIRE(tree.SplitDimension() == compressedTree.SplitDimension());
+
+  arma::Row<size_t> predictions, compressedPredictions;
+  tree.Classify(dataset, predictions);
+  compressedTree.Classify(compressed, compressedPredictions);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    REQUIRE(predictions[i] == compressedPredictions[i]);
+}
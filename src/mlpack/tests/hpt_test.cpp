@@ -324,6 +324,135 @@ TEST_CASE("HPTTest", "[HPTTest]")
   REQUIRE(expectedObjective == Approx(objective).epsilon(1e-7));
 }
 
+/**
+ * Test that CVFunction runs cross-validation only once for each set of
+ * parameters and budget, and that evaluations with a budget use the given
+ * fraction of the training data.
+ */
+TEST_CASE("CVFunctionMemoizationTest", "[HPTTest]")
+{
+  arma::mat xs;
+  arma::rowvec ys;
+  double validationSize;
+  InitProneToOverfittingData(xs, ys, validationSize);
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  double lambda2 = 0.05;
+
+  IncrementPolicy policy(true);
+  DatasetMapper<IncrementPolicy, double> datasetInfo(policy, 1);
+
+  SimpleCV<LARS, MSE> cv(validationSize, xs, ys);
+  CVFunction<decltype(cv), LARS, 4, FixedArg<bool, 0>, FixedArg<bool, 1>,
+      FixedArg<double, 3>> cvFun(cv, datasetInfo, 0.0, 0.0, {transposeData},
+      {useCholesky}, {lambda2});
+
+  arma::mat parameters(1, 1);
+  parameters(0, 0) = 0.01;
+  const double objective = cvFun.Evaluate(parameters);
+  REQUIRE(cvFun.NumEvaluations() == 1);
+  REQUIRE(cvFun.Evaluate(parameters) == objective);
+  REQUIRE(cvFun.NumEvaluations() == 1);
+
+  const double partialObjective = cvFun.Evaluate(parameters, 0.5);
+  REQUIRE(cvFun.NumEvaluations() == 2);
+  REQUIRE(cv.TrainingFraction() == 1.0);
+
+  cv.TrainingFraction() = 0.5;
+  const double expected = cv.Evaluate(transposeData, useCholesky, 0.01,
+      lambda2);
+  cv.TrainingFraction() = 1.0;
+  REQUIRE(partialObjective == Approx(expected).epsilon(1e-7));
+
+  REQUIRE_THROWS_AS(cvFun.Evaluate(parameters, 0.0), std::invalid_argument);
+}
+
+/**
+ * Test HyperParameterTuner with RandomSearch.  With a budget that covers all
+ * the configurations, it should find the same hyper-parameters as GridSearch.
+ */
+TEST_CASE("HPTRandomSearchTest", "[HPTTest]")
+{
+  arma::mat xs;
+  arma::rowvec ys;
+  double validationSize;
+  InitProneToOverfittingData(xs, ys, validationSize);
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  arma::vec lambda1Set("0 0.001 0.01 0.1 1.0 10.0 100.0");
+  arma::vec lambda2Set("0.0 0.05 0.5 5.0");
+
+  double expectedLambda1, expectedLambda2, expectedObjective;
+  FindLARSBestLambdas(xs, ys, validationSize, transposeData, useCholesky,
+      lambda1Set, lambda2Set, expectedLambda1, expectedLambda2,
+      expectedObjective);
+
+  double actualLambda1, actualLambda2;
+  HyperParameterTuner<LARS, MSE, SimpleCV, RandomSearch>
+      hpt(validationSize, xs, ys);
+  std::tie(actualLambda1, actualLambda2) = hpt.Optimize(Fixed(transposeData),
+      Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  REQUIRE(expectedObjective == Approx(hpt.BestObjective()).epsilon(1e-7));
+  REQUIRE(expectedLambda1 == Approx(actualLambda1).epsilon(1e-7));
+  REQUIRE(expectedLambda2 == Approx(actualLambda2).epsilon(1e-7));
+
+  // With a smaller budget, the result can only be worse, but it has to be the
+  // objective of the returned hyper-parameters.
+  hpt.Optimizer().MaxEvaluations() = 10;
+  std::tie(actualLambda1, actualLambda2) = hpt.Optimize(Fixed(transposeData),
+      Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  SimpleCV<LARS, MSE> cv(validationSize, xs, ys);
+  REQUIRE(hpt.BestObjective() >= expectedObjective - 1e-10);
+  REQUIRE(hpt.BestObjective() == Approx(cv.Evaluate(transposeData,
+      useCholesky, actualLambda1, actualLambda2)).epsilon(1e-7));
+}
+
+/**
+ * Test HyperParameterTuner with SuccessiveHalving.  The best objective should
+ * be the objective of the returned hyper-parameters on all the data.
+ */
+TEST_CASE("HPTSuccessiveHalvingTest", "[HPTTest]")
+{
+  arma::mat xs;
+  arma::rowvec ys;
+  double validationSize;
+  InitProneToOverfittingData(xs, ys, validationSize);
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  arma::vec lambda1Set("0 0.001 0.01 0.1 1.0 10.0 100.0");
+  arma::vec lambda2Set("0.0 0.05 0.5 5.0");
+
+  double expectedLambda1, expectedLambda2, expectedObjective;
+  FindLARSBestLambdas(xs, ys, validationSize, transposeData, useCholesky,
+      lambda1Set, lambda2Set, expectedLambda1, expectedLambda2,
+      expectedObjective);
+
+  double actualLambda1, actualLambda2;
+  HyperParameterTuner<LARS, MSE, SimpleCV, SuccessiveHalving>
+      hpt(validationSize, xs, ys);
+  hpt.Optimizer().MinBudget() = 0.25;
+  std::tie(actualLambda1, actualLambda2) = hpt.Optimize(Fixed(transposeData),
+      Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  SimpleCV<LARS, MSE> cv(validationSize, xs, ys);
+  const double objective = cv.Evaluate(transposeData, useCholesky,
+      actualLambda1, actualLambda2);
+  REQUIRE(hpt.BestObjective() >= expectedObjective - 1e-10);
+  REQUIRE(hpt.BestObjective() == Approx(objective).epsilon(1e-7));
+
+  // The best model has been trained on all the training data.
+  size_t validationFirstColumn = round(xs.n_cols * (1.0 - validationSize));
+  arma::mat validationXs = xs.cols(validationFirstColumn, xs.n_cols - 1);
+  arma::rowvec validationYs = ys.cols(validationFirstColumn, ys.n_cols - 1);
+  REQUIRE(MSE::Evaluate(hpt.BestModel(), validationXs, validationYs) ==
+      Approx(objective).epsilon(1e-7));
+}
+
 /**
  * Test HyperParamterTuner maximizes Accuracy rather than minimizes it.
  */
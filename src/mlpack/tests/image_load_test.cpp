@@ -156,4 +156,58 @@ TEST_CASE("ImageInfoSerialization", "[ImageLoadTest]")
   REQUIRE(info.Quality() == binaryInfo.Quality());
 }
 
+/**
+ * Test that a batch of images is laid out planar, normalized and resized as
+ * given by ImageOptions.
+ */
+TEST_CASE("LoadImageBatchOptionsTest", "[ImageLoadTest]")
+{
+  std::vector<std::string> files = {"test_image.png", "test_image.png",
+      "test_image.png"};
+  arma::Mat<unsigned char> interleaved;
+  data::ImageInfo info;
+  REQUIRE(data::Load(files, interleaved, info, false) == true);
+
+  // Planar layout scaled to [0, 1], with the same size.
+  arma::mat planar;
+  data::ImageInfo planarInfo;
+  data::ImageOptions options(0, 0, true, 1.0 / 255.0);
+  REQUIRE(data::Load(files, planar, planarInfo, options, false) == true);
+  REQUIRE(planar.n_rows == 50 * 50 * 3);
+  REQUIRE(planar.n_cols == 3);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    for (size_t p = 0; p < 50 * 50; ++p)
+    {
+      for (size_t c = 0; c < 3; ++c)
+      {
+        REQUIRE(planar(c * 50 * 50 + p, i) ==
+            Approx(interleaved(p * 3 + c, i) / 255.0).epsilon(1e-12));
+      }
+    }
+  }
+
+  // Resizing to the same size changes nothing, and resizing to another size
+  // gives images of that size.
+  arma::Mat<unsigned char> same;
+  REQUIRE(data::Load(files, same, info, data::ImageOptions(50, 50)) == true);
+  REQUIRE(arma::all(arma::vectorise(same == interleaved)));
+
+  arma::fmat resized;
+  data::ImageInfo resizedInfo;
+  REQUIRE(data::Load(files, resized, resizedInfo,
+      data::ImageOptions(20, 30)) == true);
+  REQUIRE(resized.n_rows == 20 * 30 * 3);
+  REQUIRE(resized.n_cols == 3);
+  REQUIRE(resizedInfo.Width() == 20);
+  REQUIRE(resizedInfo.Height() == 30);
+  REQUIRE(resized.min() >= 0.0f);
+  REQUIRE(resized.max() <= 255.0f);
+
+  // Per-channel standardization needs one value per channel.
+  data::ImageOptions wrongMean;
+  wrongMean.Mean() = { 0.5, 0.5 };
+  REQUIRE(data::Load(files, planar, planarInfo, wrongMean, false) == false);
+}
+
 #endif // HAS_STB.
@@ -313,3 +313,66 @@ TEST_CASE("DatasetMapperPointerMapping", "[ImputationTest]")
   REQUIRE(dm.UnmapString(1, 0) == &b);
   REQUIRE(dm.UnmapString(2, 0) == &c);
 }
+
+/**
+ * Check that imputing several dimensions at once with the given strategy gives
+ * the same result as imputing them one at a time, for both layouts.
+ */
+template<typename StrategyType>
+void CheckMultipleDimensionImputation()
+{
+  arma::mat input = arma::round(10.0 * arma::randu<arma::mat>(6, 1000));
+  // Make sure that a few points are missing values in several dimensions.
+  input.submat(1, 0, 4, 9).zeros();
+  const std::vector<size_t> dimensions = { 0, 1, 4 };
+  const std::vector<double> mappedValues(dimensions.size(), 0.0);
+
+  for (const bool columnMajor : { true, false })
+  {
+    arma::mat oneByOne = columnMajor ? input : arma::mat(input.t());
+    arma::mat atOnce(oneByOne);
+
+    StrategyType imputer;
+    for (size_t i = 0; i < dimensions.size(); ++i)
+      imputer.Impute(oneByOne, 0.0, dimensions[i], columnMajor);
+    imputer.Impute(atOnce, mappedValues, dimensions, columnMajor);
+
+    REQUIRE(atOnce.n_rows == oneByOne.n_rows);
+    REQUIRE(atOnce.n_cols == oneByOne.n_cols);
+    REQUIRE(arma::approx_equal(atOnce, oneByOne, "absdiff", 1e-10));
+  }
+}
+
+/**
+ * Make sure that imputing several dimensions at once gives the same result as
+ * imputing them one at a time.
+ */
+TEST_CASE("MultipleDimensionImputationTest", "[ImputationTest]")
+{
+  CheckMultipleDimensionImputation<MeanImputation<double>>();
+  CheckMultipleDimensionImputation<MedianImputation<double>>();
+  CheckMultipleDimensionImputation<ListwiseDeletion<double>>();
+}
+
+/**
+ * Make sure the median found by selection is the same as arma::median(), for
+ * both odd and even numbers of valid values.
+ */
+TEST_CASE("MedianImputationSelectionTest", "[ImputationTest]")
+{
+  for (const size_t numPoints : { 101, 102 })
+  {
+    arma::mat input(2, numPoints, arma::fill::randu);
+    input.row(1).cols(0, numPoints / 3).fill(-1.0);
+
+    const arma::rowvec valid = input.row(1).cols(numPoints / 3 + 1,
+        numPoints - 1);
+    const double median = arma::median(valid);
+
+    MedianImputation<double> imputer;
+    imputer.Impute(input, -1.0, 1, true);
+
+    for (size_t i = 0; i <= numPoints / 3; ++i)
+      REQUIRE(input(1, i) == Approx(median).epsilon(1e-12));
+  }
+}
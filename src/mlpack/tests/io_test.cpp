@@ -1291,3 +1291,35 @@ TEST_CASE("CppNameTest", "[IOTest]")
   REQUIRE(p.Parameters().at("help").cppType == "bool");
   REQUIRE(p.Parameters().at("double").cppType == "double");
 }
+
+/**
+ * Make sure that Params objects can be created and used from several threads
+ * at once, and that each call gets its own copy of the parameters.
+ */
+TEST_CASE("ConcurrentParametersTest", "[IOTest]")
+{
+  AddRequiredCLIOptions("ConcurrentParametersTest");
+
+  #define BINDING_NAME ConcurrentParametersTest
+  PARAM_INT_IN("value", "Test int", "v", 0);
+  #undef BINDING_NAME
+
+  const int calls = 64;
+  std::vector<int> values(calls, -1);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) calls; ++i)
+  {
+    util::Params p = IO::Parameters("ConcurrentParametersTest");
+    p.Get<int>("value") = (int) i;
+    p.SetPassed("value");
+    values[i] = p.Has("value") ? p.Get<int>("value") : -1;
+  }
+
+  for (int i = 0; i < calls; ++i)
+    REQUIRE(values[i] == i);
+
+  // The registered parameter keeps its default.
+  util::Params p = IO::Parameters("ConcurrentParametersTest");
+  REQUIRE(p.Has("value") == false);
+  REQUIRE(p.Get<int>("value") == 0);
+}
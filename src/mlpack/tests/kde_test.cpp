@@ -1297,3 +1297,130 @@ TEST_CASE("GaussianBreadthDualKDTreeMonteCarloKDE", "[KDETest]")
 
   REQUIRE(correctResults > 70);
 }
+
+/**
+ * Make sure that the error tolerance holds for every point when the query tree
+ * is large enough to be split into subtrees that are traversed by different
+ * threads, in single-tree, dual-tree and monochromatic evaluations.
+ */
+TEST_CASE("KDEQuerySplitErrorToleranceTest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(2, 2000);
+  arma::mat query = arma::randu(2, 5000);
+  const double relError = 0.05;
+  GaussianKernel kernel(0.3);
+  metric::EuclideanDistance metric;
+
+  arma::vec bfEstimations(query.n_cols, arma::fill::zeros);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+  arma::vec bfMonoEstimations(reference.n_cols, arma::fill::zeros);
+  BruteForceKDE<GaussianKernel>(reference, reference, bfMonoEstimations,
+      kernel);
+  // The monochromatic evaluation skips each point with itself.
+  bfMonoEstimations -= kernel.Evaluate(0.0) / reference.n_cols;
+
+  for (size_t m = 0; m < 2; ++m)
+  {
+    const KDEMode mode = (m == 0) ? KDEMode::DUAL_TREE_MODE :
+        KDEMode::SINGLE_TREE_MODE;
+    KDE<GaussianKernel, metric::EuclideanDistance, arma::mat, tree::KDTree>
+        kde(relError, 0.0, kernel, mode, metric);
+    kde.Train(reference);
+
+    arma::vec estimations;
+    kde.Evaluate(query, estimations);
+    REQUIRE(estimations.n_elem == query.n_cols);
+    for (size_t i = 0; i < query.n_cols; ++i)
+      REQUIRE(estimations[i] == Approx(bfEstimations[i]).epsilon(relError));
+
+    arma::vec monoEstimations;
+    kde.Evaluate(monoEstimations);
+    REQUIRE(monoEstimations.n_elem == reference.n_cols);
+    for (size_t i = 0; i < reference.n_cols; ++i)
+    {
+      REQUIRE(monoEstimations[i] ==
+          Approx(bfMonoEstimations[i]).epsilon(relError));
+    }
+  }
+}
+
+/**
+ * Make sure that inserted and deleted points are taken into account, both
+ * before and after the reference tree is rebuilt, and that point indices are
+ * preserved by rebuilding.
+ */
+TEST_CASE("KDEInsertDeleteTest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(2, 1000);
+  arma::mat extra = arma::randu(2, 50);
+  arma::mat query = arma::randu(2, 200);
+  const arma::mat all = arma::join_rows(reference, extra);
+  const double relError = 0.05;
+  GaussianKernel kernel(0.2);
+  metric::EuclideanDistance metric;
+
+  for (size_t m = 0; m < 2; ++m)
+  {
+    const KDEMode mode = (m == 0) ? KDEMode::DUAL_TREE_MODE :
+        KDEMode::SINGLE_TREE_MODE;
+    KDE<GaussianKernel, metric::EuclideanDistance, arma::mat, tree::KDTree>
+        kde(relError, 0.0, kernel, mode, metric);
+    // Keep all changes pending.
+    kde.RebuildFraction() = 1.0;
+    kde.Train(reference);
+
+    REQUIRE(kde.Insert(extra) == 1000);
+    for (size_t i = 0; i < 60; i += 2)
+      kde.Delete(i);
+    kde.Delete(1010);
+    REQUIRE(kde.NumPending() == 49);
+    REQUIRE(kde.NumDeleted() == 30);
+    REQUIRE_THROWS_AS(kde.Delete(2), std::invalid_argument);
+    REQUIRE_THROWS_AS(kde.Delete(1050), std::invalid_argument);
+
+    // These are the indices of the remaining points.
+    std::vector<arma::uword> live;
+    for (size_t i = 0; i < all.n_cols; ++i)
+      if (!(i < 60 && i % 2 == 0) && i != 1010)
+        live.push_back(i);
+    arma::mat liveSet = all.cols(arma::uvec(live));
+
+    arma::vec bfEstimations(query.n_cols, arma::fill::zeros);
+    BruteForceKDE<GaussianKernel>(liveSet, query, bfEstimations, kernel);
+
+    arma::vec estimations;
+    kde.Evaluate(query, estimations);
+    for (size_t i = 0; i < query.n_cols; ++i)
+      REQUIRE(estimations[i] == Approx(bfEstimations[i]).epsilon(relError));
+
+    kde.Rebuild();
+    REQUIRE(kde.NumPending() == 0);
+    REQUIRE(kde.NumDeleted() == 0);
+    REQUIRE(kde.ReferenceTree()->Dataset().n_cols == liveSet.n_cols);
+
+    kde.Evaluate(query, estimations);
+    for (size_t i = 0; i < query.n_cols; ++i)
+      REQUIRE(estimations[i] == Approx(bfEstimations[i]).epsilon(relError));
+
+    // The indices of the points have not changed.
+    REQUIRE_THROWS_AS(kde.Delete(0), std::invalid_argument);
+    kde.Delete(1020);
+    live.erase(std::find(live.begin(), live.end(), 1020));
+    liveSet = all.cols(arma::uvec(live));
+
+    // Monochromatic estimations are returned in increasing order of index.
+    arma::vec bfMonoEstimations(liveSet.n_cols, arma::fill::zeros);
+    BruteForceKDE<GaussianKernel>(liveSet, liveSet, bfMonoEstimations, kernel);
+    bfMonoEstimations -= kernel.Evaluate(0.0) / liveSet.n_cols;
+
+    arma::vec monoEstimations;
+    kde.Evaluate(monoEstimations);
+    REQUIRE(kde.NumDeleted() == 0);
+    REQUIRE(monoEstimations.n_elem == liveSet.n_cols);
+    for (size_t i = 0; i < liveSet.n_cols; ++i)
+    {
+      REQUIRE(monoEstimations[i] ==
+          Approx(bfMonoEstimations[i]).epsilon(relError));
+    }
+  }
+}
@@ -18,8 +18,10 @@
 #include <mlpack/core/kernels/linear_kernel.hpp>
 #include <mlpack/core/kernels/polynomial_kernel.hpp>
 #include <mlpack/core/kernels/spherical_kernel.hpp>
+#include <mlpack/core/kernels/triangular_kernel.hpp>
 #include <mlpack/core/kernels/pspectrum_string_kernel.hpp>
 #include <mlpack/core/kernels/cauchy_kernel.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/metrics/mahalanobis_distance.hpp>
 
@@ -213,6 +215,48 @@ TEST_CASE("MDFullCovarianceTest", "[KernelTest]")
   REQUIRE(md.Evaluate(b, a) == Approx(15.7).epsilon(1e-7));
 }
 
+/**
+ * Make sure that the distance between transformed points is the Mahalanobis
+ * distance, for positive definite and singular covariance matrices.
+ */
+TEST_CASE("MDTransformTest", "[KernelTest]")
+{
+  arma::mat points(6, 20, arma::fill::randn);
+  arma::mat factor(6, 6, arma::fill::randn);
+  arma::mat singularFactor(3, 6, arma::fill::randn);
+
+  MahalanobisDistance<true> md(factor.t() * factor + 0.1 *
+      arma::eye<arma::mat>(6, 6));
+  MahalanobisDistance<false> singularMd(singularFactor.t() * singularFactor);
+
+  const arma::mat transformed = md.Transform(points);
+  const arma::mat singularTransformed = singularMd.Transform(points);
+  REQUIRE(transformed.n_rows == 6);
+  REQUIRE(transformed.n_cols == 20);
+
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    for (size_t j = i + 1; j < points.n_cols; ++j)
+    {
+      REQUIRE(MahalanobisDistance<true>::TransformedMetric::Evaluate(
+          transformed.col(i), transformed.col(j)) ==
+          Approx(md.Evaluate(points.col(i), points.col(j))).epsilon(1e-7));
+      REQUIRE(MahalanobisDistance<false>::TransformedMetric::Evaluate(
+          singularTransformed.col(i), singularTransformed.col(j)) ==
+          Approx(singularMd.Evaluate(points.col(i), points.col(j)))
+          .epsilon(1e-7).margin(1e-8));
+    }
+  }
+
+  // Modifying the covariance matrix discards the cached transformation.
+  md.Covariance() = arma::eye<arma::mat>(6, 6);
+  CheckMatrices(md.Transformation(), arma::eye<arma::mat>(6, 6));
+
+  // A matrix with a negative eigenvalue is not a valid covariance.
+  md.Covariance()(0, 0) = -1.0;
+  REQUIRE_THROWS_AS(md.Transformation(), std::invalid_argument);
+}
+
 /**
  * Simple test case for the cosine distance.
  */
@@ -632,3 +676,78 @@ TEST_CASE("CauchyKernelTest", "[KernelTest]")
   REQUIRE(ck.Evaluate(a, b) == Approx(0.92592588).epsilon(1e-7));
   REQUIRE(ck.Evaluate(b, a) == Approx(0.92592588).epsilon(1e-7));
 }
+
+/**
+ * Check that the kernel matrix of two sets of points, and of a set with
+ * itself, holds the kernel of each pair of points.
+ */
+template<typename KernelType>
+void CheckKernelMatrix(KernelType& kernel)
+{
+  arma::mat a(4, 30, arma::fill::randn);
+  arma::mat b(4, 20, arma::fill::randn);
+  a.col(3).zeros();
+
+  arma::mat output, symmetricOutput;
+  KernelMatrix(kernel, a, b, output);
+  KernelMatrix(kernel, a, symmetricOutput);
+
+  REQUIRE(output.n_rows == a.n_cols);
+  REQUIRE(output.n_cols == b.n_cols);
+  for (size_t j = 0; j < b.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      REQUIRE(output(i, j) ==
+          Approx(kernel.Evaluate(a.col(i), b.col(j))).margin(1e-10));
+    }
+  }
+
+  REQUIRE(symmetricOutput.n_rows == a.n_cols);
+  REQUIRE(symmetricOutput.n_cols == a.n_cols);
+  for (size_t j = 0; j < a.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      REQUIRE(symmetricOutput(i, j) ==
+          Approx(kernel.Evaluate(a.col(i), a.col(j))).margin(1e-10));
+    }
+  }
+}
+
+/**
+ * Make sure that KernelMatrix() gives the kernels of each pair of points, both
+ * for the kernels computed from inner products and for the others.
+ */
+TEST_CASE("KernelMatrixTest", "[KernelTest]")
+{
+  GaussianKernel gk(1.5);
+  CheckKernelMatrix(gk);
+
+  LaplacianKernel lk(2.0);
+  CheckKernelMatrix(lk);
+
+  PolynomialKernel pk(3.0, 1.0);
+  CheckKernelMatrix(pk);
+
+  LinearKernel linear;
+  CheckKernelMatrix(linear);
+
+  CosineDistance cd;
+  CheckKernelMatrix(cd);
+
+  HyperbolicTangentKernel tk(0.5, 1.0);
+  CheckKernelMatrix(tk);
+
+  EpanechnikovKernel ek(3.0);
+  CheckKernelMatrix(ek);
+
+  CauchyKernel ck(1.5);
+  CheckKernelMatrix(ck);
+
+  TriangularKernel trk(3.0);
+  CheckKernelMatrix(trk);
+
+  SphericalKernel sk(2.5);
+  CheckKernelMatrix(sk);
+}
@@ -13,17 +13,21 @@
 #include <mlpack/methods/kmeans/allow_empty_clusters.hpp>
 #include <mlpack/methods/kmeans/refined_start.hpp>
 #include <mlpack/methods/kmeans/kmeans_plus_plus_initialization.hpp>
+#include <mlpack/methods/kmeans/kmeans_parallel_initialization.hpp>
 #include <mlpack/methods/kmeans/elkan_kmeans.hpp>
 #include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
 #include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
 #include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include <mlpack/methods/kmeans/mini_batch_kmeans.hpp>
 #include <mlpack/methods/kmeans/sample_initialization.hpp>
 #include <mlpack/methods/kmeans/random_partition.hpp>
+#include <mlpack/methods/kmeans/distributed_kmeans.hpp>
 
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 
 #include "catch.hpp"
+#include "thread_communicator.hpp"
 #include <mlpack/methods/kmeans/kill_empty_clusters.hpp>
 
 using namespace mlpack;
@@ -553,6 +557,59 @@ TEST_CASE("KMeansPlusPlusTest", "[KMeansTest]")
   REQUIRE(distortion < 14500.0);
 }
 
+/**
+ * Make sure k-means|| gives good initial centroids on the same dataset as the
+ * k-means++ test.
+ */
+TEST_CASE("KMeansParallelTest", "[KMeansTest]")
+{
+  arma::mat data(3, 3000);
+  data.randn();
+
+  arma::mat centroids(" 0  5 -2 -6  1;"
+                      " 0  0 -2  8  6;"
+                      " 0 -2 -2  8  1");
+
+  for (size_t i = 1000; i < 1200; ++i)
+    data.col(i) += centroids.col(1);
+  for (size_t i = 1200; i < 1700; ++i)
+    data.col(i) += centroids.col(2);
+  for (size_t i = 1700; i < 1800; ++i)
+    data.col(i) += centroids.col(3);
+  for (size_t i = 1800; i < 3000; ++i)
+    data.col(i) += centroids.col(4);
+
+  KMeansParallelInitialization k;
+  arma::mat resultingCentroids;
+  k.Cluster(data, 5, resultingCentroids);
+
+  REQUIRE(resultingCentroids.n_rows == 3);
+  REQUIRE(resultingCentroids.n_cols == 5);
+
+  // Calculate sum of distances from the closest centroids.
+  double distortion = 0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    double bestDist = DBL_MAX;
+    for (size_t j = 0; j < 5; ++j)
+    {
+      bestDist = std::min(bestDist, metric::EuclideanDistance::Evaluate(
+          data.col(i), resultingCentroids.col(j)));
+    }
+    distortion += bestDist;
+  }
+
+  // This uses the same threshold as the k-means++ test.
+  REQUIRE(distortion < 14500.0);
+
+  // It should also work as the initial partition policy of KMeans.
+  KMeans<metric::EuclideanDistance, KMeansParallelInitialization> kmeans;
+  arma::Row<size_t> assignments;
+  kmeans.Cluster(data, 5, assignments);
+  REQUIRE(assignments.n_elem == data.n_cols);
+  REQUIRE(arma::max(assignments) < 5);
+}
+
 #ifdef ARMA_HAS_SPMAT
 /**
  * Make sure sparse k-means works okay.
@@ -669,6 +726,50 @@ TEST_CASE("HamerlyTest", "[KMeansTest]")
   }
 }
 
+/**
+ * Make sure that Elkan's and Hamerly's algorithms still match the naive
+ * algorithm when there are many clusters and the points span several blocks.
+ */
+TEST_CASE("ElkanHamerlyLargeKTest", "[KMeansTest]")
+{
+  arma::mat dataset(5, 3000);
+  dataset.randu();
+
+  const size_t k = 100;
+  arma::mat centroids(5, k);
+  centroids.randu();
+
+  arma::mat naiveCentroids(centroids);
+  KMeans<> km(30);
+  arma::Row<size_t> assignments;
+  km.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      ElkanKMeans> elkan(30);
+  arma::Row<size_t> elkanAssignments;
+  arma::mat elkanCentroids(centroids);
+  elkan.Cluster(dataset, k, elkanAssignments, elkanCentroids, false, true);
+
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      HamerlyKMeans> hamerly(30);
+  arma::Row<size_t> hamerlyAssignments;
+  arma::mat hamerlyCentroids(centroids);
+  hamerly.Cluster(dataset, k, hamerlyAssignments, hamerlyCentroids, false,
+      true);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    REQUIRE(assignments[i] == elkanAssignments[i]);
+    REQUIRE(assignments[i] == hamerlyAssignments[i]);
+  }
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+  {
+    REQUIRE(naiveCentroids[i] == Approx(elkanCentroids[i]).epsilon(1e-7));
+    REQUIRE(naiveCentroids[i] == Approx(hamerlyCentroids[i]).epsilon(1e-7));
+  }
+}
+
 TEST_CASE("PellegMooreTest", "[KMeansTest]")
 {
   const size_t trials = 5;
@@ -767,6 +868,82 @@ TEST_CASE("DTNNCoverTreeTest", "[KMeansTest]")
   }
 }
 
+/**
+ * Make sure the dual-tree algorithm gives the same clusters as the naive
+ * algorithm when there are many clusters, so that the centroid tree is refit
+ * between iterations.
+ */
+TEST_CASE("DTNNLargeKTest", "[KMeansTest]")
+{
+  arma::mat dataset(5, 3000);
+  dataset.randu();
+
+  const size_t k = 100;
+  arma::mat centroids(5, k);
+  centroids.randu();
+
+  arma::mat naiveCentroids(centroids);
+  KMeans<> km(30);
+  arma::Row<size_t> assignments;
+  km.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      DefaultDualTreeKMeans> dtnn(30);
+  arma::Row<size_t> dtnnAssignments;
+  arma::mat dtnnCentroids(centroids);
+  dtnn.Cluster(dataset, k, dtnnAssignments, dtnnCentroids, false, true);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    REQUIRE(assignments[i] == dtnnAssignments[i]);
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    REQUIRE(naiveCentroids[i] == Approx(dtnnCentroids[i]).epsilon(1e-7));
+}
+
+/**
+ * Make sure that the dual-tree algorithm on float data gives the same
+ * iterations as on double data.
+ */
+TEST_CASE("DTNNFloatTest", "[KMeansTest]")
+{
+  arma::fmat dataset(5, 2000);
+  dataset.randu();
+  const arma::mat doubleDataset = arma::conv_to<arma::mat>::from(dataset);
+
+  const size_t k = 20;
+  arma::mat centroids(5, k);
+  centroids.randu();
+
+  metric::EuclideanDistance metric;
+  DualTreeKMeans<metric::EuclideanDistance, arma::fmat, tree::KDTree>
+      floatStep(dataset, metric);
+  DualTreeKMeans<metric::EuclideanDistance, arma::mat, tree::KDTree>
+      doubleStep(doubleDataset, metric);
+
+  arma::mat floatCentroids(centroids), doubleCentroids(centroids);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    arma::mat newFloatCentroids, newDoubleCentroids;
+    arma::Col<size_t> floatCounts, doubleCounts;
+    floatStep.Iterate(floatCentroids, newFloatCentroids, floatCounts);
+    doubleStep.Iterate(doubleCentroids, newDoubleCentroids, doubleCounts);
+
+    // Empty clusters keep their centroids.
+    for (size_t c = 0; c < k; ++c)
+    {
+      REQUIRE(floatCounts[c] == doubleCounts[c]);
+      if (floatCounts[c] > 0)
+      {
+        floatCentroids.col(c) = newFloatCentroids.col(c);
+        doubleCentroids.col(c) = newDoubleCentroids.col(c);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    REQUIRE(floatCentroids[i] == Approx(doubleCentroids[i]).epsilon(1e-4));
+}
+
 /**
  * Make sure that the sample initialization strategy successfully samples points
  * from the dataset.
@@ -800,3 +977,139 @@ TEST_CASE("SampleInitializationTest", "[KMeansTest]")
     REQUIRE(j < dataset.n_cols);
   }
 }
+
+/**
+ * Make sure that a mini-batch step sets each centroid to the mean of the points
+ * it has been given, since the learning rate is one over their number.
+ */
+TEST_CASE("MiniBatchKMeansStepTest", "[KMeansTest]")
+{
+  arma::mat data = trans(kMeansData);
+  arma::mat centroids("0.0 10.0 -10.0; 0.0 10.0 5.0");
+
+  EuclideanDistance metric;
+  MiniBatchKMeans<EuclideanDistance, arma::mat> step(data, metric);
+  arma::mat newCentroids;
+  arma::Col<size_t> counts;
+
+  // Give the first half of the points, and then the second half.
+  step.Step(data.cols(0, 14), centroids, newCentroids, counts);
+  step.Step(data.cols(15, 29), arma::mat(newCentroids), newCentroids, counts);
+
+  REQUIRE(counts[0] == 13);
+  REQUIRE(counts[1] == 7);
+  REQUIRE(counts[2] == 10);
+
+  const arma::vec mean0 = arma::mean(data.cols(0, 12), 1);
+  const arma::vec mean1 = arma::mean(data.cols(13, 19), 1);
+  const arma::vec mean2 = arma::mean(data.cols(20, 29), 1);
+  for (size_t d = 0; d < 2; ++d)
+  {
+    REQUIRE(newCentroids(d, 0) == Approx(mean0[d]).epsilon(1e-7));
+    REQUIRE(newCentroids(d, 1) == Approx(mean1[d]).epsilon(1e-7));
+    REQUIRE(newCentroids(d, 2) == Approx(mean2[d]).epsilon(1e-7));
+  }
+}
+
+/**
+ * Make sure that mini-batch k-means, in memory and streamed, finds
+ * well-separated clusters.
+ */
+TEST_CASE("MiniBatchKMeansTest", "[KMeansTest]")
+{
+  arma::mat means("0.0 10.0 -10.0; 0.0 10.0 5.0");
+  arma::mat data(2, 3000);
+  arma::Row<size_t> labels(3000);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    labels[i] = i % 3;
+    data.col(i) = means.col(i % 3) + arma::randn<arma::vec>(2);
+  }
+
+  // Start from one point of each cluster, so that the result does not depend
+  // on the initial partition.
+  arma::mat initialCentroids = data.cols(0, 2);
+
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      MiniBatchKMeans> kmeans(50);
+  arma::Row<size_t> assignments;
+  arma::mat centroids(initialCentroids);
+  kmeans.Cluster(data, 3, assignments, centroids, false, true);
+
+  // The centroids are the means of all the points given to them, so they are
+  // in the order of the initial centroids.
+  for (size_t i = 0; i < data.n_cols; ++i)
+    REQUIRE(assignments[i] == labels[i]);
+  for (size_t c = 0; c < 3; ++c)
+    REQUIRE(arma::norm(centroids.col(c) - means.col(c)) < 0.2);
+
+  // Now give the data in chunks of 500 points.
+  size_t begin = 0;
+  auto source = [&](arma::mat& chunk)
+  {
+    if (begin == data.n_cols)
+      return false;
+
+    chunk = data.cols(begin, begin + 499);
+    begin += 500;
+    return true;
+  };
+
+  KMeans<> streamKMeans(0);
+  arma::mat streamCentroids(initialCentroids);
+  streamKMeans.ClusterStream(source, 3, streamCentroids, true, 250);
+
+  REQUIRE(begin == data.n_cols);
+  for (size_t c = 0; c < 3; ++c)
+    REQUIRE(arma::norm(streamCentroids.col(c) - means.col(c)) < 0.2);
+}
+
+/**
+ * Make sure that DistributedKMeans on several shards gives the centroids that
+ * KMeans gives on the whole dataset, from the same initial centroids.
+ */
+TEST_CASE("DistributedKMeansTest", "[KMeansTest]")
+{
+  arma::mat data(4, 3000, arma::fill::randu);
+  data.cols(1000, 1999) += 3.0;
+  data.cols(2000, 2999) -= 3.0;
+  const arma::mat initialCentroids = data.cols(arma::uvec({ 0, 1000, 2000 }));
+
+  arma::mat centroids(initialCentroids);
+  KMeans<> kmeans(50);
+  kmeans.Cluster(data, 3, centroids, true);
+
+  // The shards have different sizes, and the points of each cluster are spread
+  // over several shards.
+  std::vector<arma::mat> shards;
+  shards.push_back(data.cols(0, 1499));
+  shards.push_back(data.cols(1500, 2199));
+  shards.push_back(data.cols(2200, 2999));
+
+  std::vector<arma::mat> shardCentroids(shards.size());
+  RunSharded(shards, [&](ThreadCommunicator& communicator,
+                         const arma::mat& shard)
+  {
+    arma::mat localCentroids(initialCentroids);
+    DistributedKMeans<ThreadCommunicator> distributedKMeans(communicator, 50);
+    distributedKMeans.Cluster(shard, 3, localCentroids, true);
+    shardCentroids[communicator.Rank()] = localCentroids;
+  });
+
+  for (size_t i = 0; i < shards.size(); ++i)
+  {
+    REQUIRE(arma::approx_equal(shardCentroids[i], shardCentroids[0],
+        "absdiff", 0.0));
+    REQUIRE(arma::approx_equal(shardCentroids[i], centroids, "absdiff",
+        1e-8));
+  }
+
+  // With a single process, the initial centroids are sampled from the data.
+  distributed::LocalCommunicator local;
+  DistributedKMeans<distributed::LocalCommunicator> localKMeans(local);
+  arma::mat localCentroids;
+  localKMeans.Cluster(data, 3, localCentroids);
+  REQUIRE(localCentroids.n_rows == 4);
+  REQUIRE(localCentroids.n_cols == 3);
+  REQUIRE(localKMeans.Iterations() > 0);
+}
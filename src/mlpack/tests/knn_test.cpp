@@ -12,10 +12,18 @@
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/methods/neighbor_search/unmap.hpp>
 #include <mlpack/methods/neighbor_search/ns_model.hpp>
+#include <mlpack/methods/neighbor_search/nn_descent.hpp>
+#include <mlpack/methods/neighbor_search/hnsw.hpp>
+#include <mlpack/methods/neighbor_search/quantized_search.hpp>
+#include <mlpack/methods/neighbor_search/spill_calibration.hpp>
+#include <mlpack/methods/neighbor_search/distributed_neighbor_search.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/tree/example_tree.hpp>
+#include <mlpack/core/metrics/mahalanobis_distance.hpp>
+#include "serialization.hpp"
 #include "test_catch_tools.hpp"
 #include "catch.hpp"
+#include "thread_communicator.hpp"
 
 using namespace mlpack;
 using namespace mlpack::neighbor;
@@ -889,6 +897,38 @@ TEST_CASE("KNNDualBallTreeTest", "[KNNTest]")
   }
 }
 
+/**
+ * Test the Morton tree in single-tree and dual-tree mode against the naive
+ * method on two-dimensional data, with duplicated points.
+ */
+TEST_CASE("KNNMortonTreeTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(2, 2000);
+  dataset.cols(1000, 1099) = dataset.cols(0, 99);
+  arma::mat querySet = arma::randu<arma::mat>(2, 300);
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(querySet, 4, naiveNeighbors, naiveDistances);
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, MortonTree>
+      mortonSearch(dataset);
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    mortonSearch.SearchMode() = (mode == 0) ? DUAL_TREE_MODE :
+        SINGLE_TREE_MODE;
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    mortonSearch.Search(querySet, 4, neighbors, distances);
+
+    for (size_t i = 0; i < distances.n_elem; ++i)
+      REQUIRE(distances[i] == Approx(naiveDistances[i]).epsilon(1e-7));
+  }
+}
+
 /**
  * Test the spill tree hybrid sp-tree search (defeatist search on overlapping
  * nodes, and backtracking in non-overlapping nodes) against the naive method.
@@ -981,6 +1021,106 @@ TEST_CASE("KNNDuplicatedSpillSearchTest", "[KNNTest]")
   }
 }
 
+/**
+ * Make sure that a spill forest of one tree gives the same results as SpillKNN,
+ * and that searching more trees of the forest never gives worse neighbors.
+ */
+TEST_CASE("KNNSpillForestTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(10, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(10, 200);
+  const size_t k = 5;
+
+  SpillKNN::Tree referenceTree(dataset, 0.05);
+  SpillKNN spTreeSearch(std::move(referenceTree), SINGLE_TREE_MODE);
+  arma::Mat<size_t> neighborsSPTree;
+  arma::mat distancesSPTree;
+  spTreeSearch.Search(querySet, k, neighborsSPTree, distancesSPTree);
+
+  SpillForest<> forest(dataset, 4, 0.05);
+  REQUIRE(forest.NumTrees() == 4);
+
+  arma::Mat<size_t> neighbors1, neighbors4;
+  arma::mat distances1, distances4;
+  forest.Search(querySet, k, neighbors1, distances1, 1);
+  forest.Search(querySet, k, neighbors4, distances4);
+
+  CheckMatrices(neighbors1, neighborsSPTree);
+  CheckMatrices(distances1, distancesSPTree);
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> neighborsNaive;
+  arma::mat distancesNaive;
+  naive.Search(querySet, k, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    for (size_t j = 0; j < k; ++j)
+    {
+      // Each returned distance is at least the true distance, and no worse than
+      // the distance found with only one tree.
+      REQUIRE(distances4(j, i) >= distancesNaive(j, i) - 1e-10);
+      REQUIRE(distances4(j, i) <= distances1(j, i) + 1e-10);
+
+      // Neighbors are distinct.
+      for (size_t l = j + 1; l < k; ++l)
+        REQUIRE(neighbors4(j, i) != neighbors4(l, i));
+    }
+  }
+
+  REQUIRE(KNN::Recall(neighbors4, neighborsNaive) >=
+      KNN::Recall(neighbors1, neighborsNaive));
+
+  // Searching more trees than the forest has is an error.
+  REQUIRE_THROWS_AS(forest.Search(querySet, k, neighbors4, distances4, 5),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that the spill tree calibration measures every setting, that the
+ * Pareto front is not dominated, and that a setting that gives exact results is
+ * chosen when perfect recall is required.
+ */
+TEST_CASE("KNNSpillCalibrationTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(5, 100);
+  const size_t k = 3;
+
+  // A very large tau makes every node non-overlapping, so that search is exact.
+  SpillCalibration<> calibration(arma::vec("0.0 0.05 100.0"),
+      arma::vec("0.5 0.7"), 2, 20);
+  const SpillSetting& setting = calibration.Calibrate(dataset, querySet, k,
+      1.0);
+
+  REQUIRE(calibration.Settings().size() == 12);
+  REQUIRE(setting.recall == Approx(1.0));
+  REQUIRE(&setting == &calibration.Selected());
+
+  const std::vector<SpillSetting>& front = calibration.ParetoFront();
+  REQUIRE(front.size() > 0);
+  for (size_t i = 1; i < front.size(); ++i)
+  {
+    REQUIRE(front[i].queryTime >= front[i - 1].queryTime);
+    REQUIRE(front[i].recall > front[i - 1].recall);
+  }
+
+  // No measured setting dominates a setting on the front.
+  for (size_t i = 0; i < front.size(); ++i)
+  {
+    for (size_t j = 0; j < calibration.Settings().size(); ++j)
+    {
+      const SpillSetting& s = calibration.Settings()[j];
+      REQUIRE(!(s.queryTime < front[i].queryTime &&
+          s.recall > front[i].recall));
+    }
+  }
+
+  // With no possible target, the best recall within the budget is chosen.
+  const SpillSetting& best = calibration.Calibrate(dataset, querySet, k, 2.0);
+  REQUIRE(best.recall == Approx(1.0));
+}
+
 /**
  * Make sure sparse nearest neighbors works with kd trees.
  */
@@ -1072,7 +1212,7 @@ TEST_CASE("KNNModelTest", "[KNNTest]")
   arma::mat referenceData = arma::randu<arma::mat>(10, 200);
 
   // Build all the possible models.
-  KNNModel models[28];
+  KNNModel models[30];
   models[0] = KNNModel(KNNModel::TreeTypes::KD_TREE, true);
   models[1] = KNNModel(KNNModel::TreeTypes::KD_TREE, false);
   models[2] = KNNModel(KNNModel::TreeTypes::COVER_TREE, true);
@@ -1101,6 +1241,8 @@ TEST_CASE("KNNModelTest", "[KNNTest]")
   models[25] = KNNModel(KNNModel::TreeTypes::UB_TREE, false);
   models[26] = KNNModel(KNNModel::TreeTypes::OCTREE, true);
   models[27] = KNNModel(KNNModel::TreeTypes::OCTREE, false);
+  models[28] = KNNModel(KNNModel::TreeTypes::MORTON_TREE, true);
+  models[29] = KNNModel(KNNModel::TreeTypes::MORTON_TREE, false);
 
   for (size_t j = 0; j < 3; ++j)
   {
@@ -1110,7 +1252,7 @@ TEST_CASE("KNNModelTest", "[KNNTest]")
     arma::mat baselineDistances;
     knn.Search(queryData, 3, baselineNeighbors, baselineDistances);
 
-    for (size_t i = 0; i < 28; ++i)
+    for (size_t i = 0; i < 30; ++i)
     {
       // We only have std::move() constructors so make a copy of our data.
       arma::mat referenceCopy(referenceData);
@@ -1163,7 +1305,7 @@ TEST_CASE("KNNModelMonochromaticTest", "[KNNTest]")
   arma::mat referenceData = arma::randu<arma::mat>(10, 200);
 
   // Build all the possible models.
-  KNNModel models[28];
+  KNNModel models[30];
   models[0] = KNNModel(KNNModel::TreeTypes::KD_TREE, true);
   models[1] = KNNModel(KNNModel::TreeTypes::KD_TREE, false);
   models[2] = KNNModel(KNNModel::TreeTypes::COVER_TREE, true);
@@ -1192,6 +1334,8 @@ TEST_CASE("KNNModelMonochromaticTest", "[KNNTest]")
   models[25] = KNNModel(KNNModel::TreeTypes::UB_TREE, false);
   models[26] = KNNModel(KNNModel::TreeTypes::OCTREE, true);
   models[27] = KNNModel(KNNModel::TreeTypes::OCTREE, false);
+  models[28] = KNNModel(KNNModel::TreeTypes::MORTON_TREE, true);
+  models[29] = KNNModel(KNNModel::TreeTypes::MORTON_TREE, false);
 
   for (size_t j = 0; j < 3; ++j)
   {
@@ -1201,7 +1345,7 @@ TEST_CASE("KNNModelMonochromaticTest", "[KNNTest]")
     arma::mat baselineDistances;
     knn.Search(3, baselineNeighbors, baselineDistances);
 
-    for (size_t i = 0; i < 28; ++i)
+    for (size_t i = 0; i < 30; ++i)
     {
       // We only have a std::move() constructor... so copy the data.
       arma::mat referenceCopy(referenceData);
@@ -1832,3 +1976,909 @@ TEST_CASE("KNNSpillTreeSearchEnoughResults", "[KNNTest]")
   REQUIRE(arma::accu(distancesGreedy < 0.0 || distancesGreedy > std::sqrt(3.0))
       == 0);
 }
+
+/**
+ * Make sure that splitting the query set into blocks (which happens when
+ * several OpenMP threads are available) gives the same results as naive search,
+ * in both the monochromatic and bichromatic settings.
+ */
+TEST_CASE("KNNQueryBlockSearchTest", "[KNNTest]")
+{
+  #ifdef HAS_OPENMP
+  const int oldNumThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  #endif
+
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 311);
+
+  KNN naive(referenceSet, NAIVE_MODE);
+  KNN singleTree(referenceSet, SINGLE_TREE_MODE);
+
+  arma::Mat<size_t> naiveNeighbors, treeNeighbors;
+  arma::mat naiveDistances, treeDistances;
+
+  // Bichromatic search.
+  naive.Search(querySet, 7, naiveNeighbors, naiveDistances);
+  singleTree.Search(querySet, 7, treeNeighbors, treeDistances);
+
+  REQUIRE(treeNeighbors.n_rows == 7);
+  REQUIRE(treeNeighbors.n_cols == 311);
+  for (size_t i = 0; i < treeNeighbors.n_elem; ++i)
+  {
+    REQUIRE(treeNeighbors[i] == naiveNeighbors[i]);
+    REQUIRE(treeDistances[i] == Approx(naiveDistances[i]).epsilon(1e-7));
+  }
+
+  // Monochromatic search; no point should be returned as its own neighbor.
+  naive.Search(7, naiveNeighbors, naiveDistances);
+  singleTree.Search(7, treeNeighbors, treeDistances);
+
+  REQUIRE(treeNeighbors.n_cols == 1000);
+  for (size_t i = 0; i < treeNeighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < treeNeighbors.n_rows; ++j)
+    {
+      REQUIRE(naiveNeighbors(j, i) != i);
+      REQUIRE(treeNeighbors(j, i) == naiveNeighbors(j, i));
+      REQUIRE(treeDistances(j, i) ==
+          Approx(naiveDistances(j, i)).epsilon(1e-7));
+    }
+  }
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(oldNumThreads);
+  #endif
+}
+
+/**
+ * Make sure that the task-parallel dual-tree traverser gives the same results
+ * as naive search, in both the monochromatic and bichromatic settings.
+ */
+TEST_CASE("KNNParallelDualTreeTraverserTest", "[KNNTest]")
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 5000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 3000);
+
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      KDTree, KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat>::template ParallelDualTreeTraverser> ParallelKNN;
+
+  KNN naive(referenceSet, NAIVE_MODE);
+  ParallelKNN parallel(referenceSet);
+
+  arma::Mat<size_t> naiveNeighbors, parallelNeighbors;
+  arma::mat naiveDistances, parallelDistances;
+
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+  parallel.Search(querySet, 5, parallelNeighbors, parallelDistances);
+
+  REQUIRE(parallel.BaseCases() > 0);
+  for (size_t i = 0; i < parallelNeighbors.n_elem; ++i)
+  {
+    REQUIRE(parallelNeighbors[i] == naiveNeighbors[i]);
+    REQUIRE(parallelDistances[i] ==
+        Approx(naiveDistances[i]).epsilon(1e-7));
+  }
+
+  naive.Search(5, naiveNeighbors, naiveDistances);
+  parallel.Search(5, parallelNeighbors, parallelDistances);
+
+  for (size_t i = 0; i < parallelNeighbors.n_elem; ++i)
+  {
+    REQUIRE(parallelNeighbors[i] == naiveNeighbors[i]);
+    REQUIRE(parallelDistances[i] ==
+        Approx(naiveDistances[i]).epsilon(1e-7));
+  }
+}
+
+/**
+ * Test that BoundedSearch() is exact without a budget, that it falls back to
+ * greedy search once the budget is exhausted, and that it reuses the output
+ * matrices.
+ */
+TEST_CASE("KNNBoundedSearchTest", "[KNNTest]")
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 32);
+
+  KNN naive(referenceSet, NAIVE_MODE);
+  KNN knn(referenceSet);
+
+  arma::Mat<size_t> naiveNeighbors, neighbors;
+  arma::mat naiveDistances, distances;
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+
+  // Without a budget, the results should be exact.
+  REQUIRE(knn.BoundedSearch(querySet, 5, neighbors, distances, 0) == 0);
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    REQUIRE(neighbors[i] == naiveNeighbors[i]);
+    REQUIRE(distances[i] == Approx(naiveDistances[i]).epsilon(1e-7));
+  }
+
+  // With a budget of one base case, only the first query point is exact.
+  const size_t* neighborsMem = neighbors.memptr();
+  const double* distancesMem = distances.memptr();
+  REQUIRE(knn.BoundedSearch(querySet, 5, neighbors, distances, 1) == 31);
+  REQUIRE(neighbors.memptr() == neighborsMem);
+  REQUIRE(distances.memptr() == distancesMem);
+
+  for (size_t j = 0; j < 5; ++j)
+    REQUIRE(neighbors(j, 0) == naiveNeighbors(j, 0));
+  REQUIRE(arma::all(arma::vectorise(neighbors) < 2000));
+
+  // The greedy results can't be better than the exact results.
+  for (size_t i = 1; i < neighbors.n_cols; ++i)
+    REQUIRE(distances(0, i) >= naiveDistances(0, i) - 1e-10);
+}
+
+/**
+ * Test that small query sets give correct results when dual-tree search falls
+ * back to single-tree search.
+ */
+TEST_CASE("KNNDualTreeQueryThresholdTest", "[KNNTest]")
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 10);
+
+  KNN naive(referenceSet, NAIVE_MODE);
+  KNN knn(referenceSet);
+  knn.DualTreeQueryThreshold() = 16;
+
+  arma::Mat<size_t> naiveNeighbors, neighbors;
+  arma::mat naiveDistances, distances;
+  naive.Search(querySet, 3, naiveNeighbors, naiveDistances);
+  knn.Search(querySet, 3, neighbors, distances);
+
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    REQUIRE(neighbors[i] == naiveNeighbors[i]);
+    REQUIRE(distances[i] == Approx(naiveDistances[i]).epsilon(1e-7));
+  }
+}
+
+/**
+ * Make sure that a kd-tree model saved in the mapped format gives the same
+ * results after it is loaded.
+ */
+TEST_CASE("KNNModelMappedTest", "[KNNTest]")
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+  util::Timers timers;
+
+  arma::mat referenceSet = arma::randu<arma::mat>(5, 500);
+  arma::mat querySet = arma::randu<arma::mat>(5, 50);
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    KNNModel model(KNNModel::TreeTypes::KD_TREE, (i == 1));
+    model.LeafSize() = 10;
+    arma::mat referenceCopy(referenceSet);
+    model.BuildModel(timers, std::move(referenceCopy), DUAL_TREE_MODE);
+    model.SaveMapped("knn_model_mapped.bin");
+
+    KNNModel mappedModel;
+    mappedModel.LoadMapped("knn_model_mapped.bin");
+
+    REQUIRE(mappedModel.TreeType() == KNNModel::TreeTypes::KD_TREE);
+    REQUIRE(mappedModel.RandomBasis() == model.RandomBasis());
+    REQUIRE(mappedModel.LeafSize() == 10);
+    REQUIRE(mappedModel.SearchMode() == DUAL_TREE_MODE);
+
+    arma::Mat<size_t> neighbors, mappedNeighbors;
+    arma::mat distances, mappedDistances;
+    arma::mat queryCopy(querySet);
+    model.Search(timers, std::move(queryCopy), 3, neighbors, distances);
+    queryCopy = querySet;
+    mappedModel.Search(timers, std::move(queryCopy), 3, mappedNeighbors,
+        mappedDistances);
+
+    for (size_t j = 0; j < neighbors.n_elem; ++j)
+    {
+      REQUIRE(neighbors[j] == mappedNeighbors[j]);
+      REQUIRE(distances[j] == Approx(mappedDistances[j]).epsilon(1e-7));
+    }
+
+    // Monochromatic search uses the mapped reference set directly.
+    model.Search(timers, 3, neighbors, distances);
+    mappedModel.Search(timers, 3, mappedNeighbors, mappedDistances);
+    for (size_t j = 0; j < neighbors.n_elem; ++j)
+    {
+      REQUIRE(neighbors[j] == mappedNeighbors[j]);
+      REQUIRE(distances[j] == Approx(mappedDistances[j]).epsilon(1e-7));
+    }
+  }
+
+  // Other tree types are not supported.
+  KNNModel coverModel(KNNModel::TreeTypes::COVER_TREE);
+  arma::mat referenceCopy(referenceSet);
+  coverModel.BuildModel(timers, std::move(referenceCopy), DUAL_TREE_MODE);
+  REQUIRE_THROWS_AS(coverModel.SaveMapped("knn_model_mapped.bin"),
+      std::invalid_argument);
+
+  remove("knn_model_mapped.bin");
+}
+
+/**
+ * Make sure that inserting and deleting points gives the same results as
+ * searching the equivalent reference set, both before and after the tree is
+ * rebuilt.
+ */
+TEST_CASE("KNNIncrementalUpdateTest", "[KNNTest]")
+{
+  arma::mat referenceSet(3, 500, arma::fill::randu);
+  arma::mat newPoints(3, 60, arma::fill::randu);
+  arma::mat querySet(3, 40, arma::fill::randu);
+
+  KNN knn(referenceSet);
+  knn.RebuildFraction() = 1.0; // Do not rebuild automatically.
+
+  REQUIRE(knn.Insert(newPoints) == 500);
+  REQUIRE(knn.NumPending() == 60);
+
+  // Delete some points in the tree and some pending points.
+  std::vector<bool> deleted(560, false);
+  for (size_t i = 0; i < 560; i += 7)
+  {
+    knn.Delete(i);
+    deleted[i] = true;
+  }
+  REQUIRE_THROWS_AS(knn.Delete(7), std::invalid_argument);
+  REQUIRE_THROWS_AS(knn.Delete(560), std::invalid_argument);
+  REQUIRE(knn.NumDeleted() > 0);
+
+  // Build the equivalent reference set.
+  arma::mat liveSet(3, 560);
+  std::vector<size_t> liveIndices;
+  for (size_t i = 0; i < 560; ++i)
+  {
+    if (deleted[i])
+      continue;
+
+    liveSet.col(liveIndices.size()) = (i < 500) ? referenceSet.col(i) :
+        newPoints.col(i - 500);
+    liveIndices.push_back(i);
+  }
+  liveSet.resize(3, liveIndices.size());
+
+  KNN naive(liveSet, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    const NeighborSearchMode modes[] = { DUAL_TREE_MODE, SINGLE_TREE_MODE };
+    for (size_t m = 0; m < 2; ++m)
+    {
+      knn.SearchMode() = modes[m];
+
+      arma::Mat<size_t> neighbors;
+      arma::mat distances;
+      knn.Search(querySet, 5, neighbors, distances);
+
+      for (size_t i = 0; i < neighbors.n_elem; ++i)
+      {
+        REQUIRE(neighbors[i] == liveIndices[naiveNeighbors[i]]);
+        REQUIRE(distances[i] == Approx(naiveDistances[i]).epsilon(1e-7));
+      }
+    }
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    knn.BoundedSearch(querySet, 5, neighbors, distances, 0);
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+    {
+      REQUIRE(neighbors[i] == liveIndices[naiveNeighbors[i]]);
+      REQUIRE(distances[i] == Approx(naiveDistances[i]).epsilon(1e-7));
+    }
+
+    // Now check the same results with the updates merged into the tree.
+    knn.Rebuild();
+    REQUIRE(knn.NumPending() == 0);
+    REQUIRE(knn.NumDeleted() == 0);
+    REQUIRE(knn.ReferenceSet().n_cols == liveIndices.size());
+  }
+
+  // The indices are not contiguous anymore.
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  REQUIRE_THROWS_AS(knn.Search(1, neighbors, distances), std::invalid_argument);
+
+  // New points still get new indices.
+  REQUIRE(knn.Insert(newPoints.cols(0, 0)) == 560);
+
+  // Updates are not possible without a tree.
+  KNN naiveUpdate(referenceSet, NAIVE_MODE);
+  REQUIRE_THROWS_AS(naiveUpdate.Insert(newPoints), std::invalid_argument);
+}
+
+/**
+ * Make sure that single-precision trees give the same results as naive search
+ * with single-precision data, both with NeighborSearch and with NSModel.
+ */
+TEST_CASE("KNNFloatTest", "[KNNTest]")
+{
+  arma::fmat referenceSet(8, 1000, arma::fill::randu);
+  arma::fmat querySet(8, 200, arma::fill::randu);
+
+  typedef NeighborSearch<NearestNeighborSort, metric::EuclideanDistance,
+      arma::fmat> FloatKNN;
+
+  FloatKNN naive(referenceSet, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+
+  const NeighborSearchMode modes[] = { DUAL_TREE_MODE, SINGLE_TREE_MODE };
+  for (size_t m = 0; m < 2; ++m)
+  {
+    FloatKNN knn(referenceSet, modes[m]);
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    knn.Search(querySet, 5, neighbors, distances);
+
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+    {
+      REQUIRE(neighbors[i] == naiveNeighbors[i]);
+      REQUIRE(distances[i] == Approx(naiveDistances[i]).epsilon(1e-5));
+    }
+  }
+
+  const NSModel<NearestNeighborSort, arma::fmat>::TreeTypes treeTypes[] = {
+      NSModel<NearestNeighborSort, arma::fmat>::KD_TREE,
+      NSModel<NearestNeighborSort, arma::fmat>::BALL_TREE,
+      NSModel<NearestNeighborSort, arma::fmat>::COVER_TREE };
+  for (size_t t = 0; t < 3; ++t)
+  {
+    util::Timers timers;
+    NSModel<NearestNeighborSort, arma::fmat> model(treeTypes[t]);
+    arma::fmat referenceCopy(referenceSet);
+    model.BuildModel(timers, std::move(referenceCopy), DUAL_TREE_MODE);
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    arma::fmat queryCopy(querySet);
+    model.Search(timers, std::move(queryCopy), 5, neighbors, distances);
+
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+    {
+      REQUIRE(neighbors[i] == naiveNeighbors[i]);
+      REQUIRE(distances[i] == Approx(naiveDistances[i]).epsilon(1e-5));
+    }
+  }
+}
+
+/**
+ * Make sure that quantized search with re-ranking finds almost all of the true
+ * neighbors with exact distances, and that the quantized distances are close
+ * to the true distances.
+ */
+TEST_CASE("QuantizedSearchTest", "[KNNTest]")
+{
+  arma::fmat referenceSet(16, 2000, arma::fill::randu);
+  arma::fmat querySet(16, 100, arma::fill::randu);
+
+  NeighborSearch<NearestNeighborSort, metric::EuclideanDistance, arma::fmat>
+      naive(referenceSet, NAIVE_MODE);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  naive.Search(querySet, 10, trueNeighbors, trueDistances);
+
+  QuantizedSearch<> search(referenceSet, 4);
+  REQUIRE(search.Codes().n_rows == 16);
+  REQUIRE(search.Codes().n_cols == 2000);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  search.Search(querySet, 10, neighbors, distances);
+  REQUIRE(neighbors.n_rows == 10);
+  REQUIRE(neighbors.n_cols == 100);
+
+  const double recall = KNN::Recall(neighbors, trueNeighbors);
+  REQUIRE(recall >= 0.95);
+
+  // Re-ranked distances are exact.
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      const double distance = metric::EuclideanDistance::Evaluate(
+          querySet.col(i), referenceSet.col(neighbors(j, i)));
+      REQUIRE(distances(j, i) == Approx(distance).epsilon(1e-5));
+      if (j > 0)
+        REQUIRE(distances(j, i) >= distances(j - 1, i));
+    }
+  }
+
+  // By default there is no re-ranking, the full-precision points are not kept,
+  // and the distances are approximate.
+  QuantizedSearch<> approxSearch(referenceSet);
+  REQUIRE(approxSearch.RerankFactor() == 0);
+  REQUIRE(approxSearch.ReferenceSet().n_elem == 0);
+  approxSearch.Search(querySet, 10, neighbors, distances);
+  REQUIRE(KNN::Recall(neighbors, trueNeighbors) >= 0.7);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    const double distance = metric::EuclideanDistance::Evaluate(
+        querySet.col(i), referenceSet.col(neighbors(0, i)));
+    REQUIRE(std::abs(distances(0, i) - distance) <=
+        2 * std::sqrt(16.0) * approxSearch.Step());
+  }
+
+  REQUIRE_THROWS_AS(search.Search(querySet, 2001, neighbors, distances),
+      std::invalid_argument);
+}
+
+/**
+ * Compute the distances from each query point to its k nearest (or furthest)
+ * quantized reference points by brute force.
+ */
+static arma::mat QuantizedDistances(const arma::mat& referenceSet,
+                                    const arma::mat& querySet,
+                                    const size_t k,
+                                    const bool furthest)
+{
+  QuantizedDataset<> quantizedSet(referenceSet);
+  arma::mat distances(k, querySet.n_cols);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    arma::vec all(referenceSet.n_cols);
+    for (size_t j = 0; j < referenceSet.n_cols; ++j)
+      all[j] = quantizedSet.Evaluate(querySet.col(i), j);
+
+    all = arma::sort(all, furthest ? "descend" : "ascend");
+    distances.col(i) = all.subvec(0, k - 1);
+  }
+
+  return distances;
+}
+
+/**
+ * Make sure that quantized tree searches find the same neighbors as a brute
+ * force search of the quantized reference points.
+ */
+TEST_CASE("QuantizedNeighborSearchTest", "[KNNTest]")
+{
+  arma::mat referenceSet(8, 1500, arma::fill::randu);
+  arma::mat querySet(8, 200, arma::fill::randu);
+
+  const arma::mat nearest = QuantizedDistances(referenceSet, querySet, 5,
+      false);
+  const arma::mat furthest = QuantizedDistances(referenceSet, querySet, 5,
+      true);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  const NeighborSearchMode modes[] = { NAIVE_MODE, SINGLE_TREE_MODE,
+      DUAL_TREE_MODE };
+  for (size_t m = 0; m < 3; ++m)
+  {
+    KNN knn(referenceSet, modes[m]);
+    REQUIRE(!knn.Quantized());
+    knn.Quantize();
+    REQUIRE(knn.Quantized());
+
+    knn.Search(querySet, 5, neighbors, distances);
+    CheckMatrices(distances, nearest);
+
+    // The returned distances are the distances to the quantized points.
+    QuantizedDataset<> quantizedSet(referenceSet);
+    for (size_t i = 0; i < neighbors.n_cols; ++i)
+    {
+      REQUIRE(distances(0, i) == Approx(quantizedSet.Evaluate(
+          querySet.col(i), neighbors(0, i))).epsilon(1e-7));
+    }
+
+    // Cover trees use the first point of each node as its center.
+    NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+        StandardCoverTree> coverKNN(referenceSet, modes[m]);
+    coverKNN.Quantize();
+    coverKNN.Search(querySet, 5, neighbors, distances);
+    CheckMatrices(distances, nearest);
+
+    KFN kfn(referenceSet, modes[m]);
+    kfn.Quantize();
+    kfn.Search(querySet, 5, neighbors, distances);
+    CheckMatrices(distances, furthest);
+  }
+
+  // The codes are recomputed when the reference set changes, and dropped when
+  // quantization is turned off.
+  KNN knn(querySet);
+  knn.Quantize();
+  knn.Train(referenceSet);
+  knn.Search(querySet, 5, neighbors, distances);
+  CheckMatrices(distances, nearest);
+
+  KNN copy(knn);
+  REQUIRE(copy.Quantized());
+  copy.Search(querySet, 5, neighbors, distances);
+  CheckMatrices(distances, nearest);
+
+  knn.Quantize(false);
+  knn.Search(querySet, 5, neighbors, distances);
+  KNN exact(referenceSet);
+  arma::Mat<size_t> exactNeighbors;
+  arma::mat exactDistances;
+  exact.Search(querySet, 5, exactNeighbors, exactDistances);
+  CheckMatrices(neighbors, exactNeighbors);
+  CheckMatrices(distances, exactDistances);
+}
+
+/**
+ * Make sure that NSModel can search the quantized reference set.
+ */
+TEST_CASE("QuantizedNSModelTest", "[KNNTest]")
+{
+  arma::mat referenceSet(8, 1000, arma::fill::randu);
+  arma::mat querySet(8, 100, arma::fill::randu);
+
+  const arma::mat nearest = QuantizedDistances(referenceSet, querySet, 3,
+      false);
+
+  util::Timers timers;
+  NSModel<NearestNeighborSort> model;
+  model.TreeType() = NSModel<NearestNeighborSort>::BALL_TREE;
+  model.BuildModel(timers, arma::mat(referenceSet), DUAL_TREE_MODE);
+  model.Quantize();
+  REQUIRE(model.Quantized());
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  model.Search(timers, arma::mat(querySet), 3, neighbors, distances);
+  CheckMatrices(distances, nearest);
+
+  // HNSW graphs cannot be quantized.
+  NSModel<NearestNeighborSort> hnswModel;
+  hnswModel.TreeType() = NSModel<NearestNeighborSort>::HNSW_GRAPH;
+  hnswModel.BuildModel(timers, arma::mat(referenceSet), DUAL_TREE_MODE);
+  REQUIRE_THROWS_AS(hnswModel.Quantize(), std::invalid_argument);
+  REQUIRE(!hnswModel.Quantized());
+}
+
+/**
+ * Make sure that the traversal statistics add up to the total number of base
+ * cases and scores, and that collecting them does not change the results.
+ */
+TEST_CASE("KNNTraversalStatisticsTest", "[KNNTest]")
+{
+  arma::mat referenceSet(4, 1000, arma::fill::randu);
+  arma::mat querySet(4, 300, arma::fill::randu);
+
+  KNN naive(referenceSet, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(querySet, 3, naiveNeighbors, naiveDistances);
+
+  const NeighborSearchMode modes[] = { NAIVE_MODE, SINGLE_TREE_MODE,
+      DUAL_TREE_MODE };
+  for (size_t m = 0; m < 3; ++m)
+  {
+    KNN knn(referenceSet, modes[m]);
+    knn.CollectStatistics() = true;
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    knn.Search(querySet, 3, neighbors, distances);
+
+    CheckMatrices(neighbors, naiveNeighbors);
+    CheckMatrices(distances, naiveDistances);
+
+    const tree::TraversalStatistics& stats = knn.Statistics();
+    REQUIRE(stats.QueryBaseCases().n_elem == querySet.n_cols);
+    REQUIRE(arma::accu(stats.QueryBaseCases()) == knn.BaseCases());
+    REQUIRE(arma::accu(stats.LevelScores()) == knn.Scores());
+    REQUIRE(arma::accu(stats.LevelPrunes()) <= knn.Scores());
+    REQUIRE(stats.BaseCaseTime() >= 0.0);
+    REQUIRE(stats.ScoreTime() >= 0.0);
+
+    if (modes[m] == NAIVE_MODE)
+    {
+      // Every query point is compared with every reference point.
+      for (size_t i = 0; i < querySet.n_cols; ++i)
+        REQUIRE(stats.QueryBaseCases()[i] == referenceSet.n_cols);
+    }
+    else
+    {
+      // The root is scored at least once, and something must be pruned.
+      REQUIRE(stats.LevelScores().n_elem > 1);
+      REQUIRE(stats.LevelScores()[0] > 0);
+      REQUIRE(arma::accu(stats.LevelPrunes()) > 0);
+    }
+
+    if (modes[m] == SINGLE_TREE_MODE)
+    {
+      // Each query point is scored individually.
+      REQUIRE(arma::accu(stats.QueryScores()) == knn.Scores());
+      REQUIRE(arma::all(stats.QueryPrunes() <= stats.QueryScores()));
+    }
+  }
+
+  // Without collection, nothing is recorded.
+  KNN knn(referenceSet);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(querySet, 3, neighbors, distances);
+  REQUIRE(knn.Statistics().QueryBaseCases().n_elem == 0);
+}
+
+/**
+ * Make sure that NNDescent finds nearly all the true neighbors of a dataset,
+ * with exact and sorted distances, and with fewer distance evaluations than
+ * brute force.
+ */
+TEST_CASE("NNDescentTest", "[KNNTest]")
+{
+  arma::mat dataset(16, 2000, arma::fill::randu);
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  naive.Search(10, trueNeighbors, trueDistances);
+
+  NNDescent<> nnd;
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  nnd.Search(dataset, 10, neighbors, distances);
+  REQUIRE(neighbors.n_rows == 10);
+  REQUIRE(neighbors.n_cols == 2000);
+  REQUIRE(nnd.Iterations() > 0);
+  REQUIRE(nnd.DistanceEvaluations() < 2000 * 1999 / 2);
+
+  REQUIRE(KNN::Recall(neighbors, trueNeighbors) >= 0.9);
+
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      REQUIRE(neighbors(j, i) != i);
+      const double distance = metric::EuclideanDistance::Evaluate(
+          dataset.col(i), dataset.col(neighbors(j, i)));
+      REQUIRE(distances(j, i) == Approx(distance).epsilon(1e-10));
+      if (j > 0)
+        REQUIRE(distances(j, i) >= distances(j - 1, i));
+    }
+  }
+
+  REQUIRE_THROWS_AS(nnd.Search(dataset, 2000, neighbors, distances),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that the HNSW graph finds most of the true nearest neighbors, with
+ * exact and sorted distances, both with a query set and without one, and after
+ * more points are inserted.
+ */
+TEST_CASE("HNSWTest", "[KNNTest]")
+{
+  arma::mat dataset(16, 2000, arma::fill::randu);
+  arma::mat querySet(16, 200, arma::fill::randu);
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  naive.Search(querySet, 10, trueNeighbors, trueDistances);
+
+  HNSW<> hnsw(dataset.cols(0, 999), 8, 100, 50);
+  hnsw.Insert(dataset.cols(1000, 1999));
+  REQUIRE(hnsw.ReferenceSet().n_cols == 2000);
+  for (size_t i = 0; i < 2000; ++i)
+    REQUIRE(hnsw.Links(i, 0).size() <= 16);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(querySet, 10, neighbors, distances);
+  REQUIRE(neighbors.n_rows == 10);
+  REQUIRE(neighbors.n_cols == 200);
+  REQUIRE(hnsw.BaseCases() < 200 * 2000);
+  REQUIRE(KNN::Recall(neighbors, trueNeighbors) >= 0.9);
+
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      const double distance = metric::EuclideanDistance::Evaluate(
+          querySet.col(i), dataset.col(neighbors(j, i)));
+      REQUIRE(distances(j, i) == Approx(distance).epsilon(1e-10));
+      if (j > 0)
+        REQUIRE(distances(j, i) >= distances(j - 1, i));
+    }
+  }
+
+  // Without a query set, no point is its own neighbor.
+  naive.Search(10, trueNeighbors, trueDistances);
+  hnsw.Search(10, neighbors, distances);
+  REQUIRE(KNN::Recall(neighbors, trueNeighbors) >= 0.9);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+      REQUIRE(neighbors(j, i) != i);
+
+  REQUIRE_THROWS_AS(hnsw.Search(2000, neighbors, distances),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(hnsw.Search(querySet, 2001, neighbors, distances),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that an NSModel with an HNSW graph gives the same results after
+ * serialization, and that it finds most of the true nearest neighbors.
+ */
+TEST_CASE("KNNModelHNSWTest", "[KNNTest]")
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat dataset(10, 1000, arma::fill::randu);
+  arma::mat querySet(10, 100, arma::fill::randu);
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  naive.Search(querySet, 5, trueNeighbors, trueDistances);
+
+  KNNModel model(KNNModel::TreeTypes::HNSW_GRAPH);
+  model.HNSWM() = 8;
+  util::Timers timers;
+  model.BuildModel(timers, arma::mat(dataset), DUAL_TREE_MODE);
+  REQUIRE(model.Dataset().n_cols == 1000);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  model.Search(timers, arma::mat(querySet), 5, neighbors, distances);
+  REQUIRE(KNN::Recall(neighbors, trueNeighbors) >= 0.9);
+
+  KNNModel xmlModel, jsonModel, binaryModel;
+  SerializeObjectAll(model, xmlModel, jsonModel, binaryModel);
+
+  KNNModel* models[3] = { &xmlModel, &jsonModel, &binaryModel };
+  for (size_t m = 0; m < 3; ++m)
+  {
+    REQUIRE(models[m]->TreeType() == KNNModel::TreeTypes::HNSW_GRAPH);
+    REQUIRE(models[m]->HNSWM() == 8);
+
+    arma::Mat<size_t> modelNeighbors;
+    arma::mat modelDistances;
+    models[m]->Search(timers, arma::mat(querySet), 5, modelNeighbors,
+        modelDistances);
+    CheckMatrices(neighbors, modelNeighbors);
+    CheckMatrices(distances, modelDistances);
+  }
+}
+
+/**
+ * Make sure that NSModel::Tune() chooses one of the candidate configurations,
+ * and that the model built with it gives the same results as naive search.
+ */
+TEST_CASE("KNNModelTuneTest", "[KNNTest]")
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat dataset(3, 2000, arma::fill::randu);
+  arma::mat querySet(3, 300, arma::fill::randu);
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  naive.Search(querySet, 3, trueNeighbors, trueDistances);
+
+  // Sample less than the full dataset, so that the costs are extrapolated.
+  KNNModel model;
+  model.LeafSize() = 7;
+  util::Timers timers;
+  model.Tune(timers, dataset, querySet, 3, DUAL_TREE_MODE, 0.0,
+      TreeTuner(500, 50));
+
+  const KNNModel::TreeTypes treeType = model.TreeType();
+  const bool hasLeafSize = (treeType != KNNModel::COVER_TREE &&
+      treeType != KNNModel::R_STAR_TREE);
+  REQUIRE((treeType == KNNModel::KD_TREE ||
+           treeType == KNNModel::BALL_TREE ||
+           treeType == KNNModel::VP_TREE ||
+           treeType == KNNModel::MAX_RP_TREE || !hasLeafSize));
+  if (hasLeafSize)
+  {
+    REQUIRE((model.LeafSize() == 10 || model.LeafSize() == 20 ||
+             model.LeafSize() == 40));
+  }
+  else
+  {
+    REQUIRE(model.LeafSize() == 7);
+  }
+
+  model.BuildModel(timers, arma::mat(dataset), DUAL_TREE_MODE);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  model.Search(timers, arma::mat(querySet), 3, neighbors, distances);
+  CheckMatrices(neighbors, trueNeighbors);
+  CheckMatrices(distances, trueDistances);
+}
+
+/**
+ * Make sure that tree-based KNN on a dataset transformed by
+ * MahalanobisDistance::Transform() finds the Mahalanobis nearest neighbors.
+ */
+TEST_CASE("KNNMahalanobisTransformTest", "[KNNTest]")
+{
+  arma::mat dataset(4, 200, arma::fill::randu);
+  arma::mat factor(4, 4, arma::fill::randn);
+  MahalanobisDistance<> md(factor.t() * factor + 0.1 *
+      arma::eye<arma::mat>(4, 4));
+
+  NeighborSearch<NearestNeighborSort, MahalanobisDistance<>::TransformedMetric>
+      knn(md.Transform(dataset));
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(3, neighbors, distances);
+
+  // Compare with a brute-force search with the Mahalanobis distance.
+  std::vector<std::pair<double, size_t>> candidates;
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    candidates.clear();
+    for (size_t j = 0; j < dataset.n_cols; ++j)
+    {
+      if (j != i)
+      {
+        candidates.push_back(std::make_pair(md.Evaluate(dataset.col(i),
+            dataset.col(j)), j));
+      }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    for (size_t j = 0; j < 3; ++j)
+    {
+      REQUIRE(distances(j, i) ==
+          Approx(candidates[j].first).epsilon(1e-7));
+      REQUIRE(neighbors(j, i) == candidates[j].second);
+    }
+  }
+}
+
+/**
+ * Make sure that DistributedNeighborSearch on several shards, one of which is
+ * empty, gives the results of NeighborSearch on the whole reference set.
+ */
+TEST_CASE("DistributedKNNTest", "[KNNTest]")
+{
+  arma::mat referenceSet(3, 2000, arma::fill::randu);
+  arma::mat querySet(3, 100, arma::fill::randu);
+  const size_t k = 10;
+
+  KNN knn(referenceSet);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(querySet, k, neighbors, distances);
+
+  // The second shard has fewer than k points, and the third has none.
+  std::vector<arma::mat> shards;
+  shards.push_back(referenceSet.cols(0, 994));
+  shards.push_back(referenceSet.cols(995, 999));
+  shards.push_back(arma::mat(3, 0));
+  shards.push_back(referenceSet.cols(1000, 1999));
+
+  std::vector<arma::Mat<size_t>> shardNeighbors(shards.size());
+  std::vector<arma::mat> shardDistances(shards.size());
+  std::vector<size_t> offsets(shards.size());
+  RunSharded(shards, [&](ThreadCommunicator& communicator,
+                         const arma::mat& shard)
+  {
+    DistributedNeighborSearch<ThreadCommunicator> distributedKNN(communicator,
+        shard);
+    const size_t rank = communicator.Rank();
+    offsets[rank] = distributedKNN.Offset();
+    distributedKNN.Search(querySet, k, shardNeighbors[rank],
+        shardDistances[rank]);
+  });
+
+  REQUIRE(offsets[0] == 0);
+  REQUIRE(offsets[1] == 995);
+  REQUIRE(offsets[2] == 1000);
+  REQUIRE(offsets[3] == 1000);
+  for (size_t i = 0; i < shards.size(); ++i)
+  {
+    CheckMatrices(shardNeighbors[i], neighbors);
+    CheckMatrices(shardDistances[i], distances);
+  }
+}
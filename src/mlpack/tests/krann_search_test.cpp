@@ -15,6 +15,7 @@
 #include <mlpack/core/tree/cover_tree.hpp>
 
 #include "catch.hpp"
+#include "test_catch_tools.hpp"
 
 #include <mlpack/methods/rann/ra_search.hpp>
 #include <mlpack/methods/rann/ra_model.hpp>
@@ -545,6 +546,61 @@ TEST_CASE("DualBallTreeTest", "[KRANNTest]")
 }
 */
 
+/**
+ * Make sure that, for a fixed random seed, the results of single-tree and
+ * dual-tree search do not depend on the number of threads, and that they are
+ * the same every time.
+ */
+TEST_CASE("KRANNReproducibleParallelTest", "[KRANNTest]")
+{
+  arma::mat refData = arma::randu<arma::mat>(3, 3000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 2500);
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    const bool singleMode = (mode == 0);
+    RASearch<> rs(refData, false, singleMode, 5.0, 0.95);
+
+    arma::Mat<size_t> neighbors1, neighbors2;
+    arma::mat distances1, distances2;
+
+    #ifdef HAS_OPENMP
+    const int numThreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    #endif
+
+    math::RandomSeed(42);
+    rs.Search(queryData, 3, neighbors1, distances1);
+
+    #ifdef HAS_OPENMP
+    omp_set_num_threads(std::max(numThreads, 4));
+    #endif
+
+    math::RandomSeed(42);
+    rs.Search(queryData, 3, neighbors2, distances2);
+
+    #ifdef HAS_OPENMP
+    omp_set_num_threads(numThreads);
+    #endif
+
+    CheckMatrices(neighbors1, neighbors2);
+    CheckMatrices(distances1, distances2);
+
+    // The results must still be valid neighbors, sorted by distance.
+    for (size_t i = 0; i < queryData.n_cols; ++i)
+    {
+      for (size_t j = 0; j < 3; ++j)
+      {
+        REQUIRE(neighbors1(j, i) < refData.n_cols);
+        REQUIRE(distances1(j, i) == Approx(metric::EuclideanDistance::Evaluate(
+            queryData.col(i), refData.col(neighbors1(j, i)))).epsilon(1e-7));
+        if (j > 0)
+          REQUIRE(distances1(j - 1, i) <= distances1(j, i));
+      }
+    }
+  }
+}
+
 /**
  * Make sure that the neighborPtr matrix isn't accidentally deleted.
  * See issue #478.
@@ -469,3 +469,47 @@ TEST_CASE("LARSCopyConstructorTest", "[LARSTest]")
   // The output of both models should be the same.
   CheckMatrices(predictions, predictionsFromCopiedModel);
 }
+
+/**
+ * Make sure that the solutions of a regularization path sweep match the
+ * solutions of LARS run separately for each value of lambda1.
+ */
+TEST_CASE("LARSTrainPathTest", "[LARSTest]")
+{
+  arma::mat X;
+  arma::rowvec y;
+  GenerateProblem(X, y, 100, 10);
+
+  const arma::vec sortedAbsCorr = arma::sort(arma::abs(X * y.t()));
+  const arma::vec lambda1Values = { sortedAbsCorr(2), sortedAbsCorr(5),
+      sortedAbsCorr(8), 2 * sortedAbsCorr(9) };
+
+  for (size_t c = 0; c < 2; ++c)
+  {
+    const bool useCholesky = (c == 0);
+    LARS pathLars(useCholesky, 0.0, 0.1);
+    arma::mat betas;
+    pathLars.TrainPath(X, y, lambda1Values, betas);
+
+    REQUIRE(betas.n_rows == 10);
+    REQUIRE(betas.n_cols == lambda1Values.n_elem);
+    REQUIRE(pathLars.Lambda1() == Approx(sortedAbsCorr(2)));
+
+    for (size_t j = 0; j < lambda1Values.n_elem; ++j)
+    {
+      LARS lars(useCholesky, lambda1Values[j], 0.1);
+      arma::vec beta;
+      lars.Train(X, y, beta);
+      REQUIRE(arma::approx_equal(betas.col(j), beta, "absdiff", 1e-8));
+
+      arma::vec errCorr = (X * trans(X) + 0.1 * arma::eye(10, 10)) *
+          betas.col(j) - X * y.t();
+      LARSVerifyCorrectness(betas.col(j), errCorr, lambda1Values[j]);
+    }
+  }
+
+  LARS lars;
+  arma::mat betas;
+  REQUIRE_THROWS_AS(lars.TrainPath(X, y, arma::vec({ 0.0 }), betas),
+      std::invalid_argument);
+}
@@ -86,6 +86,26 @@ TEST_CASE("TestCenterB", "[LinAlgTest]")
   }
 }
 
+/**
+ * Make sure that Center() gives the same result in place and into another
+ * matrix, for a matrix large enough to be centered in parallel.
+ */
+TEST_CASE("TestCenterInPlace", "[LinAlgTest]")
+{
+  mat x(50, 3000, fill::randu);
+  x.each_col() += linspace<vec>(0, 49, 50);
+
+  mat centered;
+  Center(x, centered);
+  mat inPlace(x);
+  Center(inPlace);
+
+  const mat expected = x.each_col() - mean(x, 1);
+  REQUIRE(approx_equal(centered, expected, "absdiff", 1e-10));
+  REQUIRE(approx_equal(inPlace, centered, "absdiff", 1e-12));
+  REQUIRE(abs(mean(centered, 1)).max() < 1e-10);
+}
+
 TEST_CASE("TestOrthogonalize", "[LinAlgTest]")
 {
   // Generate a random matrix; then, orthogonalize it and test if it's
@@ -266,3 +286,63 @@ TEST_CASE("TestSymKronId", "[LinAlgTest]")
       REQUIRE(lhs(j) == Approx(rhs(j)).epsilon(1e-7));
   }
 }
+
+/**
+ * Make sure that PairwiseSquaredDistances() gives the squared distance of each
+ * pair of points.
+ */
+TEST_CASE("PairwiseSquaredDistancesTest", "[LinAlgTest]")
+{
+  mat a(5, 40, fill::randn), b(5, 30, fill::randn);
+  b.col(3) = a.col(7);
+
+  mat distances;
+  PairwiseSquaredDistances(a, b, distances);
+  REQUIRE(distances.n_rows == 40);
+  REQUIRE(distances.n_cols == 30);
+  for (size_t j = 0; j < b.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      REQUIRE(distances(i, j) ==
+          Approx(accu(square(a.col(i) - b.col(j)))).margin(1e-10));
+    }
+  }
+
+  // Identical points may not give exactly 0, but never a negative distance.
+  REQUIRE(distances(7, 3) >= 0.0);
+  REQUIRE(distances(7, 3) < 1e-10);
+
+  mat c(4, 10, fill::randn);
+  REQUIRE_THROWS_AS(PairwiseSquaredDistances(a, c, distances),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that ColumnCovariance() and CovarianceAccumulator match Armadillo's
+ * covariance, whether the points are added at once, in chunks, or merged from
+ * two accumulators.
+ */
+TEST_CASE("CovarianceAccumulatorTest", "[LinAlgTest]")
+{
+  mat x(6, 20000, fill::randn);
+  x.each_col() += linspace<vec>(100, 105, 6);
+  const mat expected = cov(x.t());
+
+  REQUIRE(approx_equal(ColumnCovariance(x), expected, "absdiff", 1e-10));
+  REQUIRE(approx_equal(ColumnCovariance(x, 1), expected * (19999.0 / 20000.0),
+      "absdiff", 1e-10));
+
+  CovarianceAccumulator<double> chunked, first, second;
+  for (size_t i = 0; i < x.n_cols; i += 3000)
+    chunked.Update(x.cols(i, std::min(i + 3000, (size_t) x.n_cols) - 1));
+  first.Update(x.cols(0, 12344));
+  second.Update(x.cols(12345, x.n_cols - 1));
+  first.Merge(second);
+
+  REQUIRE(chunked.Count() == x.n_cols);
+  REQUIRE(first.Count() == x.n_cols);
+  REQUIRE(approx_equal(chunked.Mean(), vec(mean(x, 1)), "absdiff", 1e-10));
+  REQUIRE(approx_equal(chunked.Covariance(), expected, "absdiff", 1e-10));
+  REQUIRE(approx_equal(first.Covariance(), expected, "absdiff", 1e-10));
+}
@@ -266,3 +266,47 @@ TEST_CASE("LinearRegressionTrainReturnObjective", "[LinearRegressionTest]")
 
   REQUIRE(std::isfinite(error) == true);
 }
+
+/**
+ * Make sure that training on chunks of a dataset with Update() gives the same
+ * model as training on the whole dataset, with and without weights.
+ */
+TEST_CASE("LinearRegressionUpdateTest", "[LinearRegressionTest]")
+{
+  // Use enough points that the statistics are accumulated in blocks.
+  arma::mat predictors(4, 20000, arma::fill::randu);
+  arma::rowvec responses = arma::randn<arma::rowvec>(4) * predictors + 0.5 +
+      0.1 * arma::randn<arma::rowvec>(20000);
+  arma::rowvec weights = arma::randu<arma::rowvec>(20000);
+
+  LinearRegression lr(predictors, responses, 0.1);
+  LinearRegression weightedLr(predictors, responses, weights, 0.1);
+
+  // Compute the ridge solution directly.
+  arma::mat design = arma::join_cols(arma::ones<arma::rowvec>(20000),
+      predictors);
+  arma::vec parameters = arma::solve(design * design.t() +
+      0.1 * arma::eye<arma::mat>(5, 5), design * responses.t());
+  REQUIRE(arma::approx_equal(lr.Parameters(), parameters, "reldiff", 1e-6));
+
+  LinearRegression chunkedLr, weightedChunkedLr;
+  chunkedLr.Lambda() = 0.1;
+  weightedChunkedLr.Lambda() = 0.1;
+  for (size_t begin = 0; begin < 20000; begin += 5000)
+  {
+    const size_t end = begin + 4999;
+    chunkedLr.Update(predictors.cols(begin, end),
+        responses.cols(begin, end));
+    weightedChunkedLr.Update(predictors.cols(begin, end),
+        responses.cols(begin, end), weights.cols(begin, end));
+  }
+
+  REQUIRE(arma::approx_equal(chunkedLr.Parameters(), lr.Parameters(),
+      "reldiff", 1e-8));
+  REQUIRE(arma::approx_equal(weightedChunkedLr.Parameters(),
+      weightedLr.Parameters(), "reldiff", 1e-8));
+
+  // The new data must have the dimensionality of the model.
+  REQUIRE_THROWS_AS(chunkedLr.Update(arma::mat(3, 10, arma::fill::randu),
+      arma::rowvec(10, arma::fill::randu)), std::invalid_argument);
+}
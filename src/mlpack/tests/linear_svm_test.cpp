@@ -404,6 +404,44 @@ TEST_CASE("LinearSVMFunctionGradient", "[LinearSVMTest]")
   }
 }
 
+/**
+ * Make sure that shuffling only changes the order in which the batches visit
+ * the points, also when fitting an intercept.
+ */
+TEST_CASE("LinearSVMFunctionShuffledBatches", "[LinearSVMTest]")
+{
+  const size_t points = 20000;
+  const size_t numClasses = 3;
+
+  arma::mat data(4, points, arma::fill::randu);
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; ++i)
+    labels(i) = math::RandInt(0, numClasses);
+
+  // Without regularization, the batch objectives are plain averages.
+  LinearSVMFunction<arma::mat> svmf(data, labels, numClasses, 0.0, 1.0, true);
+  arma::mat parameters(5, numClasses, arma::fill::randn);
+
+  arma::mat gradient;
+  const double objective = svmf.EvaluateWithGradient(parameters, gradient);
+
+  svmf.Shuffle();
+
+  double batchObjectives = 0.0;
+  arma::mat batchGradient, batchGradients(arma::size(parameters),
+      arma::fill::zeros);
+  for (size_t begin = 0; begin < points; begin += 4000)
+  {
+    batchObjectives += svmf.EvaluateWithGradient(parameters, begin,
+        batchGradient, 4000) * 4000;
+    batchGradients += batchGradient * 4000;
+  }
+
+  REQUIRE(batchObjectives == Approx(objective * points).epsilon(1e-7));
+  REQUIRE(arma::approx_equal(batchGradients, gradient * points, "reldiff",
+      1e-7));
+}
+
 /**
  * Test separable Gradient() of the LinearSVMFunction when regularization
  * is used.
@@ -97,6 +97,56 @@ TEST_CASE("LMNNImpostorsTest", "[LMNNTest]")
   REQUIRE(impostors(0, 5) == 2);
 }
 
+/**
+ * Impostors found from the cached candidates, after the points have moved,
+ * should be the same as those found by a new search.
+ */
+TEST_CASE("LMNNCachedImpostorsTest", "[LMNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 300);
+  arma::Row<size_t> labels =
+      arma::randi<arma::Row<size_t>>(300, arma::distr_param(0, 2));
+
+  arma::vec norm(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    norm(i) = arma::norm(dataset.col(i));
+
+  Constraints<> constraint(dataset, labels, 2);
+  arma::Mat<size_t> impostors(2, dataset.n_cols);
+  arma::mat distances(2, dataset.n_cols);
+  constraint.Impostors(impostors, distances, dataset, labels, norm);
+
+  // Move the points a little, and then a lot (which refreshes the cache).
+  const double scales[] = { 0.01, 0.5 };
+  for (size_t s = 0; s < 2; ++s)
+  {
+    const arma::mat transformation = arma::eye<arma::mat>(3, 3) +
+        scales[s] * arma::randn<arma::mat>(3, 3);
+    const arma::mat transformed = transformation * dataset;
+
+    const arma::uvec points = arma::randperm(dataset.n_cols);
+    const size_t numPoints = 100;
+    constraint.Impostors(impostors, distances, transformed, labels, norm,
+        points, numPoints);
+
+    Constraints<> newConstraint(transformed, labels, 2);
+    arma::Mat<size_t> trueImpostors(2, dataset.n_cols);
+    arma::mat trueDistances(2, dataset.n_cols);
+    newConstraint.Impostors(trueImpostors, trueDistances, transformed, labels,
+        norm);
+
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+      for (size_t j = 0; j < 2; ++j)
+      {
+        REQUIRE(impostors(j, points[i]) == trueImpostors(j, points[i]));
+        REQUIRE(distances(j, points[i]) ==
+            Approx(trueDistances(j, points[i])).epsilon(1e-7));
+      }
+    }
+  }
+}
+
 //
 // Tests for the LMNNFunction
 //
@@ -12,9 +12,13 @@
 #include <sstream>
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/data/async_saver.hpp>
+#include <mlpack/core/data/chunked_reader.hpp>
 #include <mlpack/core/data/load_arff.hpp>
 #include <mlpack/core/data/map_policies/missing_policy.hpp>
+#include <mlpack/core/data/string_map.hpp>
 #include "catch.hpp"
+#include "serialization.hpp"
 #include "test_catch_tools.hpp"
 
 using namespace mlpack;
@@ -1243,6 +1247,45 @@ TEST_CASE("NormalizeLabelTest", "[LoadSaveTest]")
     REQUIRE(randLabels[i] == revertedLabels[i]);
 }
 
+/**
+ * Normalize many labels with many classes, in place and not, and make sure the
+ * labels are numbered in the order of their first appearance.
+ */
+TEST_CASE("NormalizeLabelLargeDatasetTest", "[LoadSaveTest]")
+{
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(100000,
+      arma::distr_param(0, 20000));
+
+  arma::Row<size_t> newLabels;
+  arma::Col<size_t> mappings;
+  data::NormalizeLabels(labels, newLabels, mappings);
+
+  // Compute the expected labels one at a time.
+  std::unordered_map<size_t, size_t> expectedMap;
+  for (size_t i = 0; i < labels.n_elem; ++i)
+  {
+    if (expectedMap.count(labels[i]) == 0)
+    {
+      const size_t label = expectedMap.size();
+      expectedMap[labels[i]] = label;
+    }
+
+    REQUIRE(newLabels[i] == expectedMap[labels[i]]);
+  }
+  REQUIRE(mappings.n_elem == expectedMap.size());
+
+  arma::Row<size_t> revertedLabels;
+  data::RevertLabels(newLabels, mappings, revertedLabels);
+  REQUIRE(arma::all(revertedLabels == labels));
+
+  // The in-place version gives the same result.
+  arma::Row<size_t> inPlaceLabels = labels;
+  arma::Col<size_t> inPlaceMappings;
+  data::NormalizeLabels(inPlaceLabels, inPlaceMappings);
+  REQUIRE(arma::all(inPlaceLabels == newLabels));
+  REQUIRE(arma::all(inPlaceMappings == mappings));
+}
+
 // Test structures.
 class TestInner
 {
@@ -1304,6 +1347,48 @@ TEST_CASE("LoadBinaryTest", "[LoadSaveTest]")
   REQUIRE(y.inb.s == x.inb.s);
 }
 
+/**
+ * Make sure that AsyncSaver writes the latest snapshot of an object, and that
+ * the object can be changed while it is written.
+ */
+TEST_CASE("AsyncSaverTest", "[LoadSaveTest]")
+{
+  Test x(10, 12);
+  {
+    data::AsyncSaver<Test> saver;
+    for (int i = 0; i < 10; ++i)
+    {
+      x.x = i;
+      saver.Save("test_async.bin", "x", x);
+    }
+
+    // Changing the object does not change the snapshots.
+    x.x = 100;
+    saver.Wait();
+
+    REQUIRE(saver.Written() >= 1);
+    REQUIRE(saver.Written() + saver.Dropped() == 10);
+    REQUIRE(saver.Failed() == 0);
+
+    x.y = 13;
+    saver.Save("test_async.xml", "x", x);
+  }
+
+  // The destructor writes the last snapshot.
+  Test y(11, 14);
+  REQUIRE(data::Load("test_async.bin", "x", y, false) == true);
+  REQUIRE(y.x == 9);
+  REQUIRE(y.y == 12);
+  REQUIRE(y.ina.s == x.ina.s);
+
+  REQUIRE(data::Load("test_async.xml", "x", y, false) == true);
+  REQUIRE(y.x == 100);
+  REQUIRE(y.y == 13);
+
+  remove("test_async.bin");
+  remove("test_async.xml");
+}
+
 /**
  * Make sure we can load and save.
  */
@@ -2311,6 +2396,94 @@ TEST_CASE("CategoryCaseTest", "[LoadSaveTest]")
   remove("test.arff");
 }
 
+/**
+ * Make sure sparse ARFF instances are loaded densely.
+ */
+TEST_CASE("SparseARFFTest", "[LoadSaveTest]")
+{
+  fstream f;
+  f.open("test.arff", fstream::out);
+  f << "@relation test" << endl;
+  f << "@attribute one numeric" << endl;
+  f << "@attribute two {no, yes}" << endl;
+  f << "@attribute three numeric" << endl;
+  f << "@attribute four numeric" << endl;
+  f << "@data" << endl;
+  f << "{0 1.5, 3 -2}" << endl;
+  f << "% comment" << endl;
+  f << "{}" << endl;
+  f << "{1 yes, 2 3} % comment" << endl;
+  f << "4, no, 5, 6" << endl;
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo info;
+  REQUIRE(data::Load("test.arff", dataset, info));
+
+  REQUIRE(dataset.n_rows == 4);
+  REQUIRE(dataset.n_cols == 4);
+
+  arma::mat expected = { { 1.5, 0.0, 0.0, 4.0 },
+                         { 0.0, 0.0, 1.0, 0.0 },
+                         { 0.0, 0.0, 3.0, 5.0 },
+                         { -2.0, 0.0, 0.0, 6.0 } };
+  CheckMatrices(dataset, expected);
+
+  // An index past the last attribute is an error.
+  f.open("test.arff", fstream::out);
+  f << "@relation test" << endl;
+  f << "@attribute one numeric" << endl;
+  f << "@data" << endl;
+  f << "{1 1.5}" << endl;
+  f.close();
+  REQUIRE(!data::Load("test.arff", dataset, info));
+
+  remove("test.arff");
+}
+
+/**
+ * Make sure an ARFF file large enough to be parsed in several chunks is loaded
+ * with the same mappings as if it were read in order.
+ */
+TEST_CASE("LargeARFFTest", "[LoadSaveTest]")
+{
+  const size_t points = 100000;
+  fstream f;
+  f.open("test.arff", fstream::out);
+  f << "@relation test" << endl;
+  f << "@attribute one numeric" << endl;
+  f << "@attribute two string" << endl;
+  f << "@attribute three real" << endl;
+  f << "@data" << endl;
+  for (size_t i = 0; i < points; ++i)
+  {
+    f << i << ", 'category " << ((i * 7919) % 1000) << "', " << (i * 0.25)
+        << endl;
+  }
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo info;
+  REQUIRE(data::Load("test.arff", dataset, info));
+
+  REQUIRE(dataset.n_rows == 3);
+  REQUIRE(dataset.n_cols == points);
+  REQUIRE(info.NumMappings(1) == 1000);
+  for (size_t i = 0; i < points; ++i)
+  {
+    REQUIRE(dataset(0, i) == double(i));
+    REQUIRE(dataset(2, i) == Approx(i * 0.25).epsilon(1e-12));
+    // Categories are numbered in order of first appearance.
+    const size_t category = (i * 7919) % 1000;
+    REQUIRE(info.UnmapString(dataset(1, i), 1) == "category " +
+        std::to_string(category));
+    if (i < 1000)
+      REQUIRE(dataset(1, i) == double(i));
+  }
+
+  remove("test.arff");
+}
+
 /**
  * Test that a CSV with the wrong number of columns fails.
  */
@@ -2504,3 +2677,381 @@ TEST_CASE("LoadCSVHeaderTest", "[LoadSaveTest]")
   REQUIRE(dataset.n_rows == 4);
   REQUIRE(dataset.n_cols == 2);
 }
+
+/**
+ * Make sure that a CSV large enough to be parsed in several chunks loads with
+ * the same values and mappings as it would serially, including quoted fields
+ * that contain the delimiter.
+ */
+TEST_CASE("LoadCSVLargeCategoricalTest", "[LoadSaveTest]")
+{
+  const size_t points = 60000;
+  fstream f;
+  f.open("test.csv", fstream::out);
+  for (size_t i = 0; i < points; ++i)
+  {
+    f << i << ", cat" << (i % 3) << ", " << (0.5 * i) << ", \"q,"
+        << (i % 2) << "\"" << endl;
+  }
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo di;
+  REQUIRE(data::Load("test.csv", dataset, di, true));
+
+  REQUIRE(dataset.n_rows == 4);
+  REQUIRE(dataset.n_cols == points);
+  REQUIRE(di.Type(0) == Datatype::numeric);
+  REQUIRE(di.Type(1) == Datatype::categorical);
+  REQUIRE(di.Type(2) == Datatype::numeric);
+  REQUIRE(di.Type(3) == Datatype::categorical);
+  REQUIRE(di.NumMappings(1) == 3);
+  REQUIRE(di.NumMappings(3) == 2);
+  REQUIRE(di.UnmapString(0, 1) == "cat0");
+  REQUIRE(di.UnmapString(2, 1) == "cat2");
+  REQUIRE(di.UnmapString(1, 3) == "\"q,1\"");
+
+  for (size_t i = 0; i < points; ++i)
+  {
+    REQUIRE(dataset(0, i) == (double) i);
+    REQUIRE(dataset(1, i) == (double) (i % 3));
+    REQUIRE(dataset(2, i) == 0.5 * i);
+    REQUIRE(dataset(3, i) == (double) (i % 2));
+  }
+
+  remove("test.csv");
+}
+
+/**
+ * Test the number parser of LoadCSV against strtod().
+ */
+TEST_CASE("LoadCSVParseDoubleTest", "[LoadSaveTest]")
+{
+  const std::vector<std::string> numbers = { "0", "-0", "+3", "1.", ".25",
+      "1e5", "-2.5E-3", "123456789012345678901234", "0.1",
+      "2.2250738585072014e-308", "1.7976931348623157e308", "3.14159265358979323846" };
+  for (const std::string& s : numbers)
+  {
+    double value;
+    REQUIRE(LoadCSV::ParseDouble(s.data(), s.data() + s.size(), value));
+    REQUIRE(value == std::strtod(s.c_str(), NULL));
+  }
+
+  const std::vector<std::string> others = { "", "-", ".", "e5", "1e", "1e+",
+      "1.2.3", "abc", "1,5", "nan", "inf", "1e400", " 1" };
+  for (const std::string& s : others)
+  {
+    double value;
+    REQUIRE(!LoadCSV::ParseDouble(s.data(), s.data() + s.size(), value));
+  }
+}
+
+/**
+ * Make sure a matrix saved in the mlpack binary format can be mapped without
+ * copying, and loaded into an ordinary matrix, without being transposed.
+ */
+TEST_CASE("SaveLoadMappedMatrixTest", "[LoadSaveTest]")
+{
+  arma::mat test(5, 20, arma::fill::randu);
+  REQUIRE(data::Save("test.mlmat", test));
+
+  {
+    data::MappedMatrix<double> mapped;
+    REQUIRE(data::Load("test.mlmat", mapped));
+    REQUIRE(mapped.Rows() == 5);
+    REQUIRE(mapped.Cols() == 20);
+    CheckMatrices(mapped.Matrix(), test);
+
+    // Copies share the mapping.
+    data::MappedMatrix<double> copy(mapped);
+    REQUIRE(copy.Matrix().memptr() == mapped.Matrix().memptr());
+
+    // The data is aligned for vectorized access.
+    REQUIRE((size_t) mapped.Matrix().memptr() % 64 == 0);
+  }
+
+  arma::mat loaded;
+  REQUIRE(data::Load("test.mlmat", loaded));
+  CheckMatrices(loaded, test);
+
+  // The element type must match.
+  data::MappedMatrix<float> wrongType;
+  REQUIRE(!data::Load("test.mlmat", wrongType));
+
+  remove("test.mlmat");
+}
+
+/**
+ * Make sure a matrix written a block of columns at a time maps as the whole
+ * matrix.
+ */
+TEST_CASE("MatrixFileWriterChunkedTest", "[LoadSaveTest]")
+{
+  arma::Mat<size_t> test = arma::randi<arma::Mat<size_t>>(3, 100,
+      arma::distr_param(0, 1000));
+
+  {
+    data::MatrixFileWriter<size_t> writer("test.mlmat", 3);
+    for (size_t i = 0; i < 100; i += 30)
+      writer.Write(test.cols(i, std::min(i + 29, (size_t) 99)));
+
+    arma::Mat<size_t> wrongRows(4, 2);
+    REQUIRE_THROWS_AS(writer.Write(wrongRows), std::invalid_argument);
+
+    REQUIRE(writer.Cols() == 100);
+    writer.Close();
+  }
+
+  data::MappedMatrix<size_t> mapped("test.mlmat");
+  REQUIRE(mapped.Rows() == 3);
+  REQUIRE(mapped.Cols() == 100);
+  REQUIRE(arma::all(arma::vectorise(mapped.Matrix() == test)));
+
+  remove("test.mlmat");
+}
+
+/**
+ * Make sure that reading a CSV in chunks gives the same points and mappings as
+ * loading it at once, in every pass.
+ */
+TEST_CASE("ChunkedReaderCSVTest", "[LoadSaveTest]")
+{
+  fstream f;
+  f.open("test.csv", fstream::out);
+  for (size_t i = 0; i < 100; ++i)
+    f << i << ", " << (0.25 * i) << ", c" << (i % 7) << endl;
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo datasetInfo;
+  REQUIRE(data::Load("test.csv", dataset, datasetInfo, true));
+
+  DatasetInfo info;
+  data::ChunkedReader<> reader("test.csv", info, 30);
+  REQUIRE(reader.Dimensionality() == 3);
+  REQUIRE(info.Type(2) == Datatype::categorical);
+
+  for (size_t pass = 0; pass < 2; ++pass)
+  {
+    arma::mat chunk;
+    arma::mat all;
+    size_t chunks = 0;
+    while (reader.Next(chunk))
+    {
+      REQUIRE(chunk.n_cols == std::min((size_t) 30, 100 - all.n_cols));
+      all = arma::join_rows(all, chunk);
+      ++chunks;
+    }
+
+    REQUIRE(chunks == 4);
+    REQUIRE(reader.Position() == 100);
+    CheckMatrices(all, dataset);
+    reader.Reset();
+  }
+
+  REQUIRE(info.NumMappings(2) == datasetInfo.NumMappings(2));
+  for (size_t i = 0; i < 7; ++i)
+    REQUIRE(info.UnmapString(i, 2) == datasetInfo.UnmapString(i, 2));
+
+  remove("test.csv");
+}
+
+/**
+ * Make sure that reading an mlpack binary matrix file in chunks gives the
+ * matrix, with and without prefetching.
+ */
+TEST_CASE("ChunkedReaderMappedMatrixTest", "[LoadSaveTest]")
+{
+  arma::mat test(4, 50, arma::fill::randu);
+  REQUIRE(data::Save("test.mlmat", test));
+
+  for (const bool prefetch : { true, false })
+  {
+    DatasetInfo info;
+    data::ChunkedReader<> reader("test.mlmat", info, 16, prefetch);
+    REQUIRE(info.Dimensionality() == 4);
+
+    arma::mat chunk;
+    arma::mat all;
+    while (reader.Next(chunk))
+      all = arma::join_rows(all, chunk);
+
+    CheckMatrices(all, test);
+  }
+
+  remove("test.mlmat");
+}
+
+/**
+ * Make sure StringMap gives consecutive ids in order of insertion, keeps equal
+ * strings with different tags apart, and survives serialization.
+ */
+TEST_CASE("StringMapTest", "[LoadSaveTest]")
+{
+  data::StringMap map;
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    const std::string s = "id" + std::to_string(i);
+    REQUIRE(map.Insert(s.data(), s.size(), i % 2) == i);
+  }
+
+  // Inserting again gives the same ids.
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    const std::string s = "id" + std::to_string(i);
+    REQUIRE(map.Insert(s.data(), s.size(), i % 2) == i);
+  }
+
+  REQUIRE(map.Size() == 1000);
+  REQUIRE(map.String(123) == "id123");
+  REQUIRE(map.Tag(123) == 1);
+  REQUIRE(map.Find("id123", 5, 0) == data::StringMap::notFound);
+  REQUIRE(map.Insert("id123", 5, 0) == 1000);
+
+  data::StringMap xmlMap, jsonMap, binaryMap;
+  SerializeObjectAll(map, xmlMap, jsonMap, binaryMap);
+  for (data::StringMap* m : { &xmlMap, &jsonMap, &binaryMap })
+  {
+    REQUIRE(m->Size() == 1001);
+    REQUIRE(m->Find("id999", 5, 1) == 999);
+    REQUIRE(m->Find("id123", 5, 0) == 1000);
+    REQUIRE(m->String(0) == "id0");
+  }
+}
+
+/**
+ * Make sure a CSV with a high-cardinality categorical column, large enough to
+ * be split into several chunks, gets the mappings of a serial load (in order
+ * of first appearance).
+ */
+TEST_CASE("LoadCSVHighCardinalityTest", "[LoadSaveTest]")
+{
+  const size_t points = 150000;
+  fstream f;
+  f.open("test.csv", fstream::out);
+  for (size_t i = 0; i < points; ++i)
+  {
+    // Categories are repeated, out of order, across the whole file.
+    const size_t category = (i * 7919) % 20000;
+    f << "user" << category << ", " << i << ", " << (category % 2 ? "?" : "1")
+        << endl;
+  }
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo info;
+  REQUIRE(data::Load("test.csv", dataset, info, true));
+
+  REQUIRE(info.Type(0) == Datatype::categorical);
+  REQUIRE(info.Type(1) == Datatype::numeric);
+  REQUIRE(info.Type(2) == Datatype::categorical);
+  REQUIRE(info.NumMappings(0) == 20000);
+  REQUIRE(info.NumMappings(2) == 2);
+  for (size_t i = 0; i < points; ++i)
+  {
+    const size_t category = (i * 7919) % 20000;
+    // The first 20000 points have distinct categories.
+    REQUIRE(info.UnmapString((size_t) dataset(0, i), 0) ==
+        "user" + std::to_string(category));
+    if (i < 20000)
+      REQUIRE(dataset(0, i) == (double) i);
+    REQUIRE(dataset(1, i) == (double) i);
+  }
+  // "1" appears first, so it is mapped to 0.
+  REQUIRE(info.UnmapString(0, 2) == "1");
+  REQUIRE(info.UnmapString(1, 2) == "?");
+
+  remove("test.csv");
+}
+
+/**
+ * Make sure a libsvm file is loaded correctly, including unsorted features,
+ * zeros, comments and qid fields, and that it survives a save and a load.
+ */
+TEST_CASE("LoadSaveLibSVMTest", "[LoadSaveTest]")
+{
+  fstream f;
+  f.open("test_sparse.libsvm", fstream::out);
+  f << "1 1:0.5 3:-2" << endl;
+  f << "-1 qid:3 4:1.5 2:0.25 # A comment." << endl;
+  f << "1" << endl;
+  f << "2 1:0 5:1e-3" << endl;
+  f.close();
+
+  arma::sp_mat matrix;
+  arma::rowvec labels;
+  REQUIRE(data::LoadLibSVM("test_sparse.libsvm", matrix, labels));
+
+  arma::mat expected = { { 0.5, 0.0,  0.0, 0.0 },
+                         { 0.0, 0.25, 0.0, 0.0 },
+                         { -2,  0.0,  0.0, 0.0 },
+                         { 0.0, 1.5,  0.0, 0.0 },
+                         { 0.0, 0.0,  0.0, 1e-3 } };
+  REQUIRE(matrix.n_nonzero == 5);
+  CheckMatrices(arma::mat(matrix), expected);
+  CheckMatrices(labels, arma::rowvec({ 1, -1, 1, 2 }));
+
+  REQUIRE(data::SaveLibSVM("test_sparse.libsvm", matrix, labels));
+  arma::sp_mat matrix2;
+  arma::rowvec labels2;
+  REQUIRE(data::LoadLibSVM("test_sparse.libsvm", matrix2, labels2));
+  CheckMatrices(arma::mat(matrix2), expected);
+  CheckMatrices(labels2, labels);
+
+  // A feature given twice is an error.
+  f.open("test_sparse.libsvm", fstream::out);
+  f << "1 3:1 1:2 3:4" << endl;
+  f.close();
+  REQUIRE(!data::LoadLibSVM("test_sparse.libsvm", matrix, labels));
+
+  remove("test_sparse.libsvm");
+}
+
+/**
+ * Make sure a coordinate file loads the same as the matrix that was saved, with
+ * and without transposing.
+ */
+TEST_CASE("LoadSparseCoordinatesLargeTest", "[LoadSaveTest]")
+{
+  arma::sp_mat test;
+  test.sprandu(300, 2000, 0.05);
+  REQUIRE(data::Save("test_sparse_large.txt", test, true, false));
+
+  arma::sp_mat loaded;
+  REQUIRE(data::Load("test_sparse_large.txt", loaded, true, false));
+  REQUIRE(loaded.n_nonzero == test.n_nonzero);
+  REQUIRE(arma::approx_equal(arma::mat(loaded), arma::mat(test), "absdiff",
+      1e-10));
+
+  arma::sp_mat transposed;
+  REQUIRE(data::Load("test_sparse_large.txt", transposed, true, true));
+  REQUIRE(arma::approx_equal(arma::mat(transposed), arma::mat(test.t()),
+      "absdiff", 1e-10));
+
+  remove("test_sparse_large.txt");
+}
+
+/**
+ * Make sure a sparse matrix survives a save and a load in the mlpack binary
+ * sparse format.
+ */
+TEST_CASE("SaveLoadSparseBinaryTest", "[LoadSaveTest]")
+{
+  arma::sp_fmat test;
+  test.sprandu(50, 80, 0.1);
+  REQUIRE(data::Save("test.mlsp", test));
+
+  arma::sp_fmat loaded;
+  REQUIRE(data::Load("test.mlsp", loaded));
+  REQUIRE(loaded.n_rows == 50);
+  REQUIRE(loaded.n_cols == 80);
+  REQUIRE(loaded.n_nonzero == test.n_nonzero);
+  REQUIRE(arma::approx_equal(arma::fmat(loaded), arma::fmat(test), "absdiff",
+      0.0f));
+
+  // The element type must match.
+  arma::sp_mat wrongType;
+  REQUIRE(!data::Load("test.mlsp", wrongType));
+
+  remove("test.mlsp");
+}
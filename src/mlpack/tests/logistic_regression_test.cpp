@@ -835,6 +835,98 @@ TEST_CASE("LogisticRegressionSparseSGDTest", "[LogisticRegressionTest]")
         Approx(lrSparse.Parameters()[i]).epsilon(1e-5));
 }
 
+/**
+ * Make sure the batch objective and gradient of the sparse logistic regression
+ * function match those of the dense one, and that sparse classification
+ * matches dense classification.
+ */
+TEST_CASE("LogisticRegressionSparseBatchGradientTest",
+          "[LogisticRegressionTest]")
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(50, 200, 0.1);
+  arma::mat denseDataset(dataset);
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < 200; ++i)
+    labels[i] = math::RandInt(0, 2);
+
+  LogisticRegressionFunction<> lrf(denseDataset, labels, 0.5);
+  LogisticRegressionFunction<arma::sp_mat> lrfSparse(dataset, labels, 0.5);
+
+  const arma::mat parameters = arma::randn<arma::rowvec>(51);
+  arma::mat gradient, sparseGradient;
+  for (size_t begin = 0; begin < 200; begin += 40)
+  {
+    const double objective = lrf.EvaluateWithGradient(parameters, begin,
+        gradient, 40);
+    const double sparseObjective = lrfSparse.EvaluateWithGradient(parameters,
+        begin, sparseGradient, 40);
+    REQUIRE(sparseObjective == Approx(objective).epsilon(1e-7));
+    REQUIRE(arma::approx_equal(sparseGradient, gradient, "absdiff", 1e-8));
+  }
+
+  lrf.Gradient(parameters, gradient);
+  lrfSparse.Gradient(parameters, sparseGradient);
+  REQUIRE(arma::approx_equal(sparseGradient, gradient, "absdiff", 1e-8));
+
+  LogisticRegression<> lr(denseDataset, labels, 0.5);
+  LogisticRegression<arma::sp_mat> lrSparse(dataset.n_rows, 0.5);
+  lrSparse.Parameters() = lr.Parameters();
+
+  arma::Row<size_t> predictions, sparsePredictions;
+  lr.Classify(denseDataset, predictions);
+  lrSparse.Classify(dataset, sparsePredictions);
+  REQUIRE(arma::all(predictions == sparsePredictions));
+  REQUIRE(lrSparse.ComputeError(dataset, labels) ==
+      Approx(lr.ComputeError(denseDataset, labels)).epsilon(1e-7));
+}
+
+/**
+ * Make sure that shuffling only changes the order in which the batches visit
+ * the points, and that large batches (which are split across threads) give the
+ * same results as the plain formulas.
+ */
+TEST_CASE("LogisticRegressionShuffledBatchesTest", "[LogisticRegressionTest]")
+{
+  const size_t points = 20000;
+  arma::mat dataset(5, points, arma::fill::randn);
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; ++i)
+    labels[i] = math::RandInt(0, 2);
+
+  LogisticRegressionFunction<> lrf(dataset, labels, 0.5);
+  const arma::mat parameters = arma::randn<arma::rowvec>(6);
+
+  arma::mat gradient;
+  const double objective = lrf.EvaluateWithGradient(parameters, gradient);
+
+  // Compute the gradient by hand.
+  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
+      parameters.tail_cols(5) * dataset)));
+  const arma::rowvec errors = sigmoids - arma::conv_to<arma::rowvec>::from(
+      labels);
+  REQUIRE(gradient(0, 0) == Approx(arma::accu(errors)).epsilon(1e-7));
+  REQUIRE(arma::approx_equal(gradient.tail_cols(5), errors * dataset.t() +
+      0.5 * parameters.tail_cols(5), "reldiff", 1e-7));
+
+  // The batches of a shuffled function cover every point once.
+  lrf.Shuffle();
+  REQUIRE(lrf.Predictors().memptr() == dataset.memptr());
+
+  double batchObjectives = 0.0;
+  arma::mat batchGradient, batchGradients(arma::size(parameters),
+      arma::fill::zeros);
+  for (size_t begin = 0; begin < points; begin += 5000)
+  {
+    batchObjectives += lrf.EvaluateWithGradient(parameters, begin,
+        batchGradient, 5000);
+    batchGradients += batchGradient;
+  }
+
+  REQUIRE(batchObjectives == Approx(objective).epsilon(1e-7));
+  REQUIRE(arma::approx_equal(batchGradients, gradient, "reldiff", 1e-7));
+}
+
 /**
  * Test multi-point classification (Classify()).
  */
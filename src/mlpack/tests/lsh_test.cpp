@@ -991,3 +991,77 @@ TEST_CASE("SparseLSHTest", "[LSHTest]")
     REQUIRE(!std::isnan(sparseDistances[i]));
   }
 }
+
+/**
+ * Make sure that inserting points into a trained model gives the same results
+ * as training on all the points at once.
+ */
+TEST_CASE("LSHInsertTest", "[LSHTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 300);
+  arma::mat newData = arma::randu<arma::mat>(4, 200);
+  arma::mat queryData = arma::randu<arma::mat>(4, 50);
+  arma::cube projections = arma::randn<arma::cube>(4, 3, 5);
+
+  // Use the same random offsets and second hash weights for both models, and
+  // no limit on the bucket size, so that both have the same buckets.
+  math::RandomSeed(42);
+  LSHSearch<> lsh(arma::join_rows(referenceData, newData), projections, 0.5,
+      99901, 0);
+
+  math::RandomSeed(42);
+  LSHSearch<> insertedLsh(referenceData, projections, 0.5, 99901, 0);
+  insertedLsh.Insert(newData);
+
+  REQUIRE(insertedLsh.ReferenceSet().n_cols == 500);
+  REQUIRE(insertedLsh.BucketContents().n_elem == lsh.BucketContents().n_elem);
+  REQUIRE(insertedLsh.BucketOffsets().n_elem == lsh.BucketOffsets().n_elem);
+
+  arma::Mat<size_t> neighbors, insertedNeighbors;
+  arma::mat distances, insertedDistances;
+  lsh.Search(queryData, 5, neighbors, distances);
+  insertedLsh.Search(queryData, 5, insertedNeighbors, insertedDistances);
+
+  CheckMatrices(neighbors, insertedNeighbors);
+  CheckMatrices(distances, insertedDistances);
+
+  // Points cannot be inserted into an untrained model, or with the wrong
+  // dimensionality.
+  LSHSearch<> emptyLsh;
+  REQUIRE_THROWS_AS(emptyLsh.Insert(newData), std::invalid_argument);
+  REQUIRE_THROWS_AS(insertedLsh.Insert(arma::mat(3, 10, arma::fill::randu)),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that LSH works with single-precision data and projections.
+ */
+TEST_CASE("FloatLSHTest", "[LSHTest]")
+{
+  arma::fmat referenceData = arma::randu<arma::fmat>(4, 300);
+  arma::fmat queryData = arma::randu<arma::fmat>(4, 50);
+
+  LSHSearch<NearestNeighborSort, arma::fmat> lsh(referenceData, 3, 10, 0.5);
+  REQUIRE(lsh.Projections().n_rows == 4);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  lsh.Search(queryData, 3, neighbors, distances);
+
+  REQUIRE(neighbors.n_rows == 3);
+  REQUIRE(neighbors.n_cols == 50);
+
+  // Every neighbor that was found must have the right distance.
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      if (neighbors(j, i) == referenceData.n_cols)
+        continue;
+
+      const double distance = metric::EuclideanDistance::Evaluate(
+          queryData.col(i), referenceData.col(neighbors(j, i)));
+      REQUIRE(distances(j, i) == Approx(distance).epsilon(1e-5));
+    }
+  }
+}
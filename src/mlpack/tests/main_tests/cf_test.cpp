@@ -141,7 +141,7 @@ TEST_CASE_METHOD(CFTestFixture, "CFNeighborhoodBoundTest",
 /**
  * Ensure algorithm is one of { "NMF", "BatchSVD",
  * "SVDIncompleteIncremental", "SVDCompleteIncremental", "RegSVD",
- * "BiasSVD", "SVDPP" }.
+ * "BiasSVD", "SVDPP", "ALS" }.
  */
 TEST_CASE_METHOD(CFTestFixture, "CFAlgorithmBoundTest",
                 "[CFMainTest][BindingTests]")
@@ -166,7 +166,7 @@ TEST_CASE_METHOD(CFTestFixture, "CFModelReuseTest",
 {
   std::string algorithms[] = { "NMF", "BatchSVD",
       "SVDIncompleteIncremental", "SVDCompleteIncremental", "RegSVD",
-      "BiasSVD", "SVDPP" };
+      "BiasSVD", "SVDPP", "ALS" };
 
   mat dataset;
   data::Load("GroupLensSmall.csv", dataset);
@@ -715,3 +715,47 @@ TEST_CASE_METHOD(CFTestFixture, "CFNormalizationTest",
   REQUIRE(arma::any(arma::vectorise(output1 != output2)));
   REQUIRE(arma::any(arma::vectorise(output1 != output3)));
 }
+
+/**
+ * Replay a query log as a benchmark of every policy, and make sure the JSON
+ * report holds the statistics of each of them.
+ */
+TEST_CASE_METHOD(CFTestFixture, "CFBenchmarkReportTest",
+                "[CFMainTest][BindingTests]")
+{
+  mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  // Query users, and items to predict ratings of.
+  arma::Mat<size_t> queries(2, 20);
+  for (size_t i = 0; i < queries.n_cols; ++i)
+  {
+    queries(0, i) = (size_t) dataset(0, i);
+    queries(1, i) = (size_t) dataset(1, i);
+  }
+
+  SetInputParam("training", std::move(dataset));
+  SetInputParam("max_iterations", int(10));
+  SetInputParam("algorithm", std::string("NMF"));
+  SetInputParam("benchmark_queries", std::move(queries));
+  SetInputParam("benchmark_all_policies", true);
+  SetInputParam("benchmark_report", std::string("cf_benchmark_report.json"));
+
+  RUN_BINDING();
+
+  std::ifstream stream("cf_benchmark_report.json");
+  REQUIRE(stream.is_open());
+  const std::string report((std::istreambuf_iterator<char>(stream)),
+      std::istreambuf_iterator<char>());
+  stream.close();
+  remove("cf_benchmark_report.json");
+
+  // Each of the 9 policies reports both kinds of queries.
+  size_t count = 0;
+  for (size_t pos = report.find("\"p999_us\""); pos != std::string::npos;
+       pos = report.find("\"p999_us\"", pos + 1))
+    ++count;
+  REQUIRE(count == 18);
+  REQUIRE(report.find("\"algorithm\": \"NMF\"") != std::string::npos);
+  REQUIRE(report.find("\"queries\": 20") != std::string::npos);
+}
@@ -655,3 +655,33 @@ TEST_CASE_METHOD(FastMKSTestFixture, "FastMKSBandwidthTest",
 
   CheckMatricesNotEqual(triKernel, params.Get<arma::mat>("kernels"));
 }
+
+/**
+ * Make sure that epsilon is checked, and that it is kept in the output model.
+ */
+TEST_CASE_METHOD(FastMKSTestFixture, "FastMKSEpsilonTest",
+                 "[FastMKSMainTest][BindingTests]")
+{
+  arma::mat referenceData(3, 100, arma::fill::randu);
+
+  SetInputParam("reference", referenceData);
+  SetInputParam("k", (int) 5);
+  SetInputParam("epsilon", 1.5); // Invalid.
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  CleanMemory();
+  ResetSettings();
+
+  SetInputParam("reference", referenceData);
+  SetInputParam("k", (int) 5);
+  SetInputParam("epsilon", 0.2);
+
+  RUN_BINDING();
+
+  FastMKSModel* m = params.Get<FastMKSModel*>("output_model");
+  REQUIRE(m->Epsilon() == Approx(0.2));
+  REQUIRE(params.Get<arma::mat>("kernels").n_cols == 100);
+}
@@ -66,6 +66,47 @@ TEST_CASE_METHOD(KDETestFixture, "KDEGaussianRTreeResultsMain",
     REQUIRE(kdeEstimations[i] == Approx(mainEstimations[i]).epsilon(relError));
 }
 
+/**
+ * Ensure that the estimations of KDEMain are still within the error tolerance
+ * when the tree is chosen automatically.
+ */
+TEST_CASE_METHOD(KDETestFixture, "KDEAutoTreeResultsMain",
+                "[KDEMainTest][BindingTests]")
+{
+  // Datasets.
+  arma::mat reference = arma::randu(3, 3000);
+  arma::mat query = arma::randu(3, 100);
+  arma::vec kdeEstimations, mainEstimations;
+  double kernelBandwidth = 0.5;
+  double relError = 0.05;
+
+  // Exact estimations.
+  kernel::GaussianKernel kernel(kernelBandwidth);
+  metric::EuclideanDistance metric;
+  KDE<kernel::GaussianKernel, metric::EuclideanDistance, arma::mat>
+      kde(0.0, 0.0, kernel, KDEMode::DUAL_TREE_MODE, metric);
+  kde.Train(reference);
+  kde.Evaluate(query, kdeEstimations);
+  // Normalize estimations.
+  kdeEstimations /= kernel.Normalizer(reference.n_rows);
+
+  // Main estimations.
+  SetInputParam("reference", reference);
+  SetInputParam("query", query);
+  SetInputParam("kernel", std::string("gaussian"));
+  SetInputParam("tree", std::string("auto"));
+  SetInputParam("rel_error", relError);
+  SetInputParam("bandwidth", kernelBandwidth);
+
+  RUN_BINDING();
+
+  mainEstimations = std::move(params.Get<arma::vec>("predictions"));
+
+  // Check whether results are equal.
+  for (size_t i = 0; i < query.n_cols; ++i)
+    REQUIRE(kdeEstimations[i] == Approx(mainEstimations[i]).epsilon(relError));
+}
+
 /**
  * Ensure that the estimations we get for KDEMain, are the same as the ones we
  * get from the KDE class without any wrappers. Doesn't require normalization.
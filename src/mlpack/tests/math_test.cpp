@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/core/math/clamp.hpp>
+#include <mlpack/core/math/log_add.hpp>
 #include <mlpack/core/math/random.hpp>
 #include <mlpack/core/math/range.hpp>
 #include "catch.hpp"
@@ -1006,3 +1007,58 @@ TEST_CASE("InplaceSparseShuffleWeightsTest", "[MathTest]")
     REQUIRE(weightCounts[i] == 1);
   }
 }
+
+/**
+ * Make sure that LogSumExp() and LogSumExpT() match a direct computation, also
+ * when y is added to the sums, for matrices large enough to be split into
+ * blocks, and for rows and columns that are entirely -inf.
+ */
+TEST_CASE("LogSumExpTest", "[MathTest]")
+{
+  arma::mat x(600, 150, arma::fill::randn);
+  x *= 10;
+  x.row(5).fill(-arma::datum::inf);
+  x.col(7).fill(-arma::datum::inf);
+
+  arma::vec y, yT;
+  LogSumExp(x, y);
+  LogSumExpT(x, yT);
+  REQUIRE(y.n_elem == x.n_rows);
+  REQUIRE(yT.n_elem == x.n_cols);
+
+  for (size_t i = 0; i < x.n_rows; ++i)
+  {
+    if (i == 5)
+    {
+      REQUIRE(y[i] == -arma::datum::inf);
+      continue;
+    }
+
+    const double m = x.row(i).max();
+    REQUIRE(y[i] == Approx(m + std::log(arma::accu(arma::exp(x.row(i) -
+        m)))).epsilon(1e-10));
+    REQUIRE(y[i] == Approx(AccuLog(x.row(i))).epsilon(1e-10));
+  }
+
+  for (size_t j = 0; j < x.n_cols; ++j)
+  {
+    if (j == 7)
+    {
+      REQUIRE(yT[j] == -arma::datum::inf);
+      continue;
+    }
+
+    REQUIRE(yT[j] == Approx(AccuLog(x.col(j))).epsilon(1e-10));
+  }
+
+  // Add y to the sums.
+  arma::vec z(x.n_rows, arma::fill::randn);
+  arma::vec zT(x.n_cols, arma::fill::randn);
+  arma::vec z0 = z, zT0 = zT;
+  LogSumExp<arma::mat, true>(x, z);
+  LogSumExpT<arma::mat, true>(x, zT);
+  for (size_t i = 0; i < x.n_rows; ++i)
+    REQUIRE(z[i] == Approx(LogAdd(y[i], z0[i])).epsilon(1e-10));
+  for (size_t j = 0; j < x.n_cols; ++j)
+    REQUIRE(zT[j] == Approx(LogAdd(yT[j], zT0[j])).epsilon(1e-10));
+}
@@ -60,3 +60,37 @@ TEST_CASE("UniformMatrixCompletionSDP", "[MatrixCompletionTest]")
        Approx(Xorig(indices(0, i), indices(1, i))).epsilon(1e-7));
   }
 }
+
+/**
+ * Recover the matrix of the previous test from half of the known entries, then
+ * add the other half and check that the warm started recovery is exact.
+ */
+TEST_CASE("MatrixCompletionWarmStart", "[MatrixCompletionTest]")
+{
+  arma::mat Xorig;
+  arma::umat indices;
+
+  if (!data::Load("completion_X.csv", Xorig, false, false))
+    FAIL("Cannot load dataset completion_X.csv");
+  if (!data::Load("completion_indices.csv", indices, false, false))
+    FAIL("Cannot load dataset completion_indices.csv");
+
+  arma::vec values(indices.n_cols);
+  for (size_t i = 0; i < indices.n_cols; ++i)
+    values(i) = Xorig(indices(0, i), indices(1, i));
+
+  const size_t half = indices.n_cols / 2;
+  arma::mat recovered;
+  MatrixCompletion mc(Xorig.n_rows, Xorig.n_cols,
+      indices.cols(0, half - 1), values.subvec(0, half - 1));
+  mc.Recover(recovered);
+
+  mc.Observations(indices, values);
+  REQUIRE(mc.Function().NumConstraints() == indices.n_cols);
+  mc.Recover(recovered);
+
+  const double err =
+    arma::norm(Xorig - recovered, "fro") /
+    arma::norm(Xorig, "fro");
+  REQUIRE(err == Approx(0.0).margin(1e-5));
+}
@@ -88,6 +88,33 @@ TEST_CASE("MeanShiftSimpleTest", "[MeanShiftTest]")
     REQUIRE(assignments(i) == thirdClass);
 }
 
+/**
+ * Use every point as a seed, with the Gaussian kernel, and make sure the seeds
+ * that converge at different iterations still give the three classes.
+ */
+TEST_CASE("MeanShiftKernelAllPointsTest", "[MeanShiftTest]")
+{
+  MeanShift<true> meanShift(2.0);
+
+  arma::Row<size_t> assignments;
+  arma::mat centroids;
+  meanShift.Cluster((arma::mat) trans(meanShiftData), assignments, centroids,
+      true, false);
+
+  REQUIRE(centroids.n_cols == 3);
+
+  for (size_t i = 1; i < 13; ++i)
+    REQUIRE(assignments(i) == assignments(0));
+  for (size_t i = 14; i < 20; ++i)
+    REQUIRE(assignments(i) == assignments(13));
+  for (size_t i = 21; i < 30; ++i)
+    REQUIRE(assignments(i) == assignments(20));
+
+  REQUIRE(assignments(0) != assignments(13));
+  REQUIRE(assignments(0) != assignments(20));
+  REQUIRE(assignments(13) != assignments(20));
+}
+
 // Generate samples from four Gaussians, and make sure mean shift nearly
 // recovers those four centers.
 TEST_CASE("GaussianClustering", "[MeanShiftTest]")
@@ -97,6 +97,44 @@ TEST_CASE("LINFMetricTest", "[MetricTest]")
       Approx(lMetric.Evaluate(a2, b2)).epsilon(1e-7));
 }
 
+/**
+ * Make sure that EvaluateBlock() gives the same results as Evaluate() for a
+ * block of columns, both with dense columns and with other vector types.
+ */
+template<typename MetricType>
+void CheckEvaluateBlock()
+{
+  arma::mat points = arma::randu<arma::mat>(7, 50);
+  arma::vec point = arma::randu<arma::vec>(7);
+  arma::mat pointMat(point);
+
+  arma::vec distances(20);
+  MetricType::EvaluateBlock(pointMat.col(0), points, 10, 20,
+      distances.memptr());
+  for (size_t i = 0; i < 20; ++i)
+  {
+    REQUIRE(distances[i] ==
+        Approx(MetricType::Evaluate(point, points.col(10 + i))).epsilon(1e-7));
+  }
+
+  // This uses the general implementation.
+  distances.zeros();
+  MetricType::EvaluateBlock(point, points, 10, 20, distances.memptr());
+  for (size_t i = 0; i < 20; ++i)
+  {
+    REQUIRE(distances[i] ==
+        Approx(MetricType::Evaluate(point, points.col(10 + i))).epsilon(1e-7));
+  }
+}
+
+TEST_CASE("LMetricEvaluateBlockTest", "[MetricTest]")
+{
+  CheckEvaluateBlock<ManhattanDistance>();
+  CheckEvaluateBlock<SquaredEuclideanDistance>();
+  CheckEvaluateBlock<EuclideanDistance>();
+  CheckEvaluateBlock<ChebyshevDistance>();
+}
+
 /**
  * Simple test for IoU metric.
  */
@@ -301,6 +339,114 @@ TEST_CASE("NMSMetricTest", "[MetricTest]")
   CheckMatrices(desiredBoundingBox, selectedBoundingBox);
 }
 
+/**
+ * Make sure that the IoU of sets of bounding boxes matches the IoU of each
+ * pair.
+ */
+TEST_CASE("BatchIoUMetricTest", "[MetricTest]")
+{
+  arma::mat a(4, 30, arma::fill::randu), b(4, 20, arma::fill::randu);
+  a *= 100;
+  b *= 100;
+  a.rows(2, 3) += 1;
+  b.rows(2, 3) += 1;
+
+  arma::mat ious;
+  IoU<>::Evaluate(a, b, ious);
+  REQUIRE(ious.n_rows == 30);
+  REQUIRE(ious.n_cols == 20);
+
+  for (size_t i = 0; i < a.n_cols; ++i)
+  {
+    for (size_t j = 0; j < b.n_cols; ++j)
+    {
+      REQUIRE(ious(i, j) == Approx(IoU<>::Evaluate(a.col(i),
+          b.col(j))).epsilon(1e-10));
+    }
+  }
+
+  // Now use coordinates.
+  a.rows(2, 3) += a.rows(0, 1);
+  b.rows(2, 3) += b.rows(0, 1);
+  IoU<true>::Evaluate(a, b, ious);
+  for (size_t i = 0; i < a.n_cols; ++i)
+  {
+    for (size_t j = 0; j < b.n_cols; ++j)
+    {
+      REQUIRE(ious(i, j) == Approx(IoU<true>::Evaluate(a.col(i),
+          b.col(j))).epsilon(1e-10));
+    }
+  }
+}
+
+/**
+ * Make sure that NMS on many boxes selects the same boxes as a simple greedy
+ * suppression, and that batched NMS only suppresses boxes of the same class.
+ */
+TEST_CASE("BatchedNMSMetricTest", "[MetricTest]")
+{
+  const size_t n = 1000;
+  arma::mat bbox(4, n, arma::fill::randu);
+  bbox.rows(0, 1) *= 200;
+  bbox.rows(2, 3) = 10 + 20 * bbox.rows(2, 3);
+  arma::vec confidenceScores(n, arma::fill::randu);
+  arma::uvec labels = arma::randi<arma::uvec>(n, arma::distr_param(0, 2));
+
+  // Simple greedy suppression with the IoU of each pair of boxes.
+  arma::mat bboxCoordinates = bbox;
+  bboxCoordinates.rows(2, 3) += bbox.rows(0, 1);
+  arma::mat area = (bboxCoordinates.row(2) - bboxCoordinates.row(0)) %
+      (bboxCoordinates.row(3) - bboxCoordinates.row(1));
+  arma::uvec order = arma::sort_index(confidenceScores, "descend");
+  std::vector<size_t> desired, desiredBatched;
+  for (size_t batched = 0; batched < 2; ++batched)
+  {
+    std::vector<size_t>& result = batched ? desiredBatched : desired;
+    std::vector<bool> removed(n, false);
+    for (size_t a = 0; a < n; ++a)
+    {
+      const size_t i = order[a];
+      if (removed[i])
+        continue;
+      result.push_back(i);
+
+      for (size_t b = a + 1; b < n; ++b)
+      {
+        const size_t j = order[b];
+        if (batched && labels[i] != labels[j])
+          continue;
+
+        const double width = std::max(0.0, std::min(bboxCoordinates(2, i),
+            bboxCoordinates(2, j)) - std::max(bboxCoordinates(0, i),
+            bboxCoordinates(0, j)));
+        const double height = std::max(0.0, std::min(bboxCoordinates(3, i),
+            bboxCoordinates(3, j)) - std::max(bboxCoordinates(1, i),
+            bboxCoordinates(1, j)));
+        const double intersection = width * height;
+        if (intersection / (area[i] + area[j] - intersection) > 0.3)
+          removed[j] = true;
+      }
+    }
+  }
+
+  arma::uvec selectedIndices;
+  NMS<>::Evaluate(bbox, confidenceScores, selectedIndices, 0.3);
+  REQUIRE(selectedIndices.n_elem == desired.size());
+  for (size_t i = 0; i < desired.size(); ++i)
+    REQUIRE(selectedIndices[i] == desired[i]);
+
+  NMS<true>::Evaluate(bboxCoordinates, confidenceScores, selectedIndices, 0.3);
+  REQUIRE(selectedIndices.n_elem == desired.size());
+  for (size_t i = 0; i < desired.size(); ++i)
+    REQUIRE(selectedIndices[i] == desired[i]);
+
+  NMS<>::BatchedEvaluate(bbox, confidenceScores, labels, selectedIndices,
+      0.3);
+  REQUIRE(selectedIndices.n_elem == desiredBatched.size());
+  for (size_t i = 0; i < desiredBatched.size(); ++i)
+    REQUIRE(selectedIndices[i] == desiredBatched[i]);
+}
+
 /**
  *
  */
@@ -358,3 +504,73 @@ TEST_CASE("BLEUScoreTest", "[MetricTest]")
         Approx(expectedPrecision[i]).epsilon(1e-4));
   }
 }
+
+/**
+ * Make sure that the BLEU score of a corpus given in parts with Update() and
+ * Merge() is the same as the score of the whole corpus, and that a corpus
+ * large enough to be split into blocks gives the same counts as its sentences
+ * taken one at a time.
+ */
+TEST_CASE("BLEUUpdateMergeTest", "[MetricTest]")
+{
+  typedef typename std::vector<std::string> WordVector;
+  const std::vector<std::string> words = { "a", "b", "c", "d", "e" };
+  std::vector<std::vector<WordVector>> referenceCorpus(2000);
+  std::vector<WordVector> translationCorpus(2000);
+  for (size_t i = 0; i < referenceCorpus.size(); ++i)
+  {
+    referenceCorpus[i].resize(1 + math::RandInt(3));
+    for (WordVector& reference : referenceCorpus[i])
+    {
+      reference.resize(math::RandInt(10));
+      for (std::string& word : reference)
+        word = words[math::RandInt(words.size())];
+    }
+
+    translationCorpus[i].resize(math::RandInt(10));
+    for (std::string& word : translationCorpus[i])
+      word = words[math::RandInt(words.size())];
+  }
+
+  BLEU<double> bleu(4);
+  const double score = bleu.Evaluate(referenceCorpus, translationCorpus, true);
+
+  // Give the corpus in two parts to two objects, and merge them.
+  const std::vector<std::vector<WordVector>> firstReferences(
+      referenceCorpus.begin(), referenceCorpus.begin() + 700);
+  const std::vector<std::vector<WordVector>> secondReferences(
+      referenceCorpus.begin() + 700, referenceCorpus.end());
+  const std::vector<WordVector> firstTranslations(translationCorpus.begin(),
+      translationCorpus.begin() + 700);
+  const std::vector<WordVector> secondTranslations(
+      translationCorpus.begin() + 700, translationCorpus.end());
+
+  BLEU<double> first(4), second(4);
+  first.Update(firstReferences, firstTranslations);
+  second.Update(secondReferences, secondTranslations);
+  first.Merge(second);
+  REQUIRE(first.Score(true) == Approx(score).epsilon(1e-10));
+  REQUIRE(first.TranslationLength() == bleu.TranslationLength());
+  REQUIRE(first.ReferenceLength() == bleu.ReferenceLength());
+
+  // Give the corpus one sentence at a time.
+  BLEU<double> streaming(4);
+  for (size_t i = 0; i < referenceCorpus.size(); ++i)
+  {
+    streaming.Update(std::vector<std::vector<WordVector>>(1,
+        referenceCorpus[i]), std::vector<WordVector>(1, translationCorpus[i]));
+  }
+
+  REQUIRE(streaming.Score(true) == Approx(score).epsilon(1e-10));
+  for (size_t i = 0; i < 4; ++i)
+  {
+    REQUIRE(streaming.MatchesByOrder()[i] == bleu.MatchesByOrder()[i]);
+    REQUIRE(streaming.PossibleMatchesByOrder()[i] ==
+        bleu.PossibleMatchesByOrder()[i]);
+  }
+
+  // After Reset(), nothing is left.
+  streaming.Reset();
+  REQUIRE(streaming.TranslationLength() == 0);
+  REQUIRE(streaming.Score() == Approx(0.0).margin(1e-10));
+}
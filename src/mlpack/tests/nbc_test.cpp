@@ -9,6 +9,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/core.hpp>
+#include <mlpack/core/data/compressed_dataset.hpp>
 #include <mlpack/methods/naive_bayes/naive_bayes_classifier.hpp>
 
 #include "catch.hpp"
@@ -354,6 +355,39 @@ TEST_CASE("SeparateTrainIndividualIncrementalTest", "[NBCTest]")
   }
 }
 
+/**
+ * Make sure that training incrementally on two halves of a dataset large
+ * enough to be split into blocks gives the same model as training on all of
+ * it at once.
+ */
+TEST_CASE("NaiveBayesClassifierMergeTest", "[NBCTest]")
+{
+  arma::mat dataset(5, 20000);
+  arma::Row<size_t> labels(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    labels[i] = math::RandInt(3);
+    dataset.col(i) = 10.0 * labels[i] + arma::randn<arma::vec>(5);
+  }
+
+  NaiveBayesClassifier<> nbc(dataset, labels, 3, false);
+  NaiveBayesClassifier<> nbcMerged(dataset.n_rows, 3);
+  nbcMerged.Train(dataset.cols(0, 12999), labels.subvec(0, 12999), 3);
+  nbcMerged.Train(dataset.cols(13000, 19999), labels.subvec(13000, 19999), 3);
+
+  for (size_t i = 0; i < nbc.Means().n_elem; ++i)
+  {
+    REQUIRE(nbcMerged.Means()[i] == Approx(nbc.Means()[i]).epsilon(1e-7));
+    REQUIRE(nbcMerged.Variances()[i] ==
+        Approx(nbc.Variances()[i]).epsilon(1e-7));
+  }
+  for (size_t i = 0; i < nbc.Probabilities().n_elem; ++i)
+  {
+    REQUIRE(nbcMerged.Probabilities()[i] ==
+        Approx(nbc.Probabilities()[i]).epsilon(1e-7));
+  }
+}
+
 /**
  * Check if NaiveBayesClassifier::Classify() works properly for a high
  * dimension datasets.
@@ -398,3 +432,41 @@ TEST_CASE("NaiveBayesClassifierHighDimensionsTest", "[NBCTest]")
   for (size_t i = 0; i < calcVec.n_cols; ++i)
     REQUIRE(calcVec(i) == testLabels(i));
 }
+
+/**
+ * Make sure that a naive Bayes classifier trained on a CompressedDataset is
+ * the same as one trained on the original dataset.
+ */
+TEST_CASE("NaiveBayesCompressedDatasetTest", "[NBCTest]")
+{
+  arma::mat dataset(4, 1000);
+  arma::Row<size_t> labels(1000);
+  data::DatasetInfo info(4);
+  info.Type(1) = data::Datatype::categorical;
+  for (size_t i = 0; i < 5; ++i)
+    info.MapString<double>(std::to_string(i), 1);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    labels[i] = math::RandInt(3);
+    dataset(0, i) = (float) (labels[i] + math::Random());
+    dataset(1, i) = math::RandInt(5);
+    dataset(2, i) = (float) math::RandNormal();
+    dataset(3, i) = (float) (2.0 * labels[i] + math::RandNormal());
+  }
+
+  data::CompressedDataset compressed(dataset, info);
+
+  NaiveBayesClassifier<> nbc(dataset, labels, 3);
+  NaiveBayesClassifier<> compressedNbc(compressed, labels, 3);
+
+  for (size_t i = 0; i < nbc.Means().n_elem; ++i)
+  {
+    REQUIRE(compressedNbc.Means()[i] ==
+        Approx(nbc.Means()[i]).epsilon(1e-10));
+    REQUIRE(compressedNbc.Variances()[i] ==
+        Approx(nbc.Variances()[i]).epsilon(1e-10));
+  }
+  for (size_t i = 0; i < nbc.Probabilities().n_elem; ++i)
+    REQUIRE(compressedNbc.Probabilities()[i] == nbc.Probabilities()[i]);
+}
@@ -16,6 +16,7 @@
 #include <ensmallen.hpp>
 
 #include "catch.hpp"
+#include "test_catch_tools.hpp"
 
 using namespace mlpack;
 using namespace mlpack::metric;
@@ -188,6 +189,40 @@ TEST_CASE("OptimalSoftmaxSeparableObjective", "[NCATesT]")
   REQUIRE(sef.Evaluate(coordinates, 3, 1) == Approx(-1.0).epsilon(1e-12));
 }
 
+/**
+ * The separable objective and gradient, summed over all points, should equal
+ * the full objective and gradient, on a dataset large enough to take several
+ * blocks.
+ */
+TEST_CASE("SoftmaxSeparableSumTest", "[NCATesT]")
+{
+  arma::mat data = arma::randu<arma::mat>(3, 700);
+  arma::Row<size_t> labels =
+      arma::randi<arma::Row<size_t>>(700, arma::distr_param(0, 2));
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+
+  arma::mat coordinates = 2.0 * arma::randu<arma::mat>(3, 3);
+
+  const double objective = sef.Evaluate(coordinates);
+  arma::mat gradient;
+  sef.Gradient(coordinates, gradient);
+
+  double separableObjective = 0.0;
+  arma::mat separableGradient(3, 3, arma::fill::zeros);
+  for (size_t begin = 0; begin < 700; begin += 100)
+  {
+    separableObjective += sef.Evaluate(coordinates, begin, 100);
+
+    arma::mat batchGradient;
+    sef.Gradient(coordinates, begin, batchGradient, 100);
+    separableGradient += batchGradient;
+  }
+
+  REQUIRE(separableObjective == Approx(objective).epsilon(1e-7));
+  CheckMatrices(separableGradient, gradient, 1e-5);
+}
+
 /**
  * Ensure the separable gradient is right.
  */
@@ -240,6 +240,41 @@ TEST_CASE("SparseNMFALSTest", "[NMFTest]")
   REQUIRE(success == true);
 }
 
+/**
+ * Check that the multiplicative divergence update rules give the same result
+ * for a sparse matrix, where W H is only evaluated at the nonzero elements, as
+ * for its dense copy.
+ */
+TEST_CASE("SparseNMFMultDivUpdateTest", "[NMFTest]")
+{
+  sp_mat v;
+  v.sprandu(30, 20, 0.2);
+  // Ensure there is at least one nonzero element in every row and column.
+  for (size_t i = 0; i < 20; ++i)
+    v(i, i) += 0.1;
+  v(29, 0) += 0.1;
+  mat dv(v); // Make a dense copy.
+
+  mat w = randu<mat>(30, 4) + 0.1;
+  mat h = randu<mat>(4, 20) + 0.1;
+  mat dw(w), dh(h);
+
+  for (size_t i = 0; i < 5; ++i)
+  {
+    NMFMultiplicativeDivergenceUpdate::WUpdate(v, w, h);
+    NMFMultiplicativeDivergenceUpdate::HUpdate(v, w, h);
+    NMFMultiplicativeDivergenceUpdate::WUpdate(dv, dw, dh);
+    NMFMultiplicativeDivergenceUpdate::HUpdate(dv, dw, dh);
+  }
+
+  REQUIRE(w.is_finite());
+  REQUIRE(h.is_finite());
+  REQUIRE(arma::norm(w - dw, "fro") / arma::norm(dw, "fro") ==
+      Approx(0.0).margin(1e-10));
+  REQUIRE(arma::norm(h - dh, "fro") / arma::norm(dh, "fro") ==
+      Approx(0.0).margin(1e-10));
+}
+
 /**
  * Check if all elements in W and H are non-negative.
  * Default Case.
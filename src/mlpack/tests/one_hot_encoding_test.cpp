@@ -230,3 +230,75 @@ TEST_CASE("OneHotEncodingDatasetinfoTest", "[OneHotEncodingTest]")
 
   remove("test.csv");
 }
+
+/**
+ * Make sure that the sparse one-hot encoding of a matrix is the same as the
+ * dense one.
+ */
+TEST_CASE("OneHotEncodingSparseOutputTest", "[OneHotEncodingTest]")
+{
+  arma::mat input = arma::floor(20.0 * arma::randu<arma::mat>(5, 300));
+  // Make some of the values of the dimensions that are not encoded zero.
+  input.row(0).cols(0, 99).zeros();
+  arma::Col<size_t> indices("1 3 4");
+
+  arma::mat dense;
+  arma::sp_mat sparse;
+  data::OneHotEncoding(input, indices, dense);
+  data::OneHotEncoding(input, indices, sparse);
+
+  REQUIRE(sparse.n_rows == dense.n_rows);
+  REQUIRE(sparse.n_cols == dense.n_cols);
+  // Each encoded dimension gives one nonzero value per point.
+  REQUIRE(sparse.n_nonzero == (size_t) arma::accu(dense != 0.0));
+  REQUIRE(arma::approx_equal(arma::mat(sparse), dense, "absdiff", 0.0));
+}
+
+/**
+ * Test the hashing encoding: the width is fixed, the dimensions that are not
+ * encoded are kept, and separately encoded chunks give the same encoding.
+ */
+TEST_CASE("HashEncodingTest", "[OneHotEncodingTest]")
+{
+  arma::mat input = arma::floor(1000.0 * arma::randu<arma::mat>(4, 500));
+  arma::Col<size_t> indices("0 2");
+  const size_t numBuckets = 64;
+
+  arma::sp_mat output;
+  data::HashEncoding(input, indices, numBuckets, output);
+
+  REQUIRE(output.n_rows == 2 + numBuckets);
+  REQUIRE(output.n_cols == input.n_cols);
+
+  const arma::mat encoded(output);
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    REQUIRE(encoded(0, i) == input(1, i));
+    REQUIRE(encoded(1, i) == input(3, i));
+    // Each encoded dimension adds one to a bucket.
+    REQUIRE(arma::accu(encoded.submat(2, i, 1 + numBuckets, i)) == 2.0);
+  }
+
+  arma::sp_mat firstChunk, secondChunk;
+  data::HashEncoding(arma::mat(input.cols(0, 249)), indices, numBuckets,
+      firstChunk);
+  data::HashEncoding(arma::mat(input.cols(250, 499)), indices, numBuckets,
+      secondChunk);
+  REQUIRE(arma::approx_equal(arma::mat(arma::join_rows(firstChunk,
+      secondChunk)), encoded, "absdiff", 0.0));
+
+  // The same value in two different dimensions should not always go to the
+  // same bucket.
+  arma::mat same(2, 100);
+  same.row(0) = arma::regspace<arma::rowvec>(0, 99);
+  same.row(1) = same.row(0);
+  arma::sp_mat sameOutput;
+  data::HashEncoding(same, arma::Col<size_t>("0 1"), 1000, sameOutput);
+  size_t collisions = 0;
+  for (size_t i = 0; i < same.n_cols; ++i)
+  {
+    if (arma::max(arma::mat(sameOutput.col(i))) == 2.0)
+      ++collisions;
+  }
+  REQUIRE(collisions < 10);
+}
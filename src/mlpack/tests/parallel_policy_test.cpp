@@ -0,0 +1,130 @@
+/**
+ * @file tests/parallel_policy_test.cpp
+ *
+ * Tests for ParallelPolicy and ParallelScope.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+
+#include <thread>
+
+#include "catch.hpp"
+
+using namespace mlpack;
+
+/**
+ * Make sure that the number of blocks respects the grain size and the number
+ * of threads, and does not depend on the number of threads for deterministic
+ * policies.
+ */
+TEST_CASE("ParallelPolicyNumBlocksTest", "[ParallelPolicyTest]")
+{
+  const ParallelPolicy policy(4);
+  REQUIRE(policy.NumBlocks(0, 1000) == 1);
+  REQUIRE(policy.NumBlocks(1999, 1000) == 1);
+  REQUIRE(policy.NumBlocks(100000, 1000) == policy.NumThreads());
+
+  // The grain size of the policy takes precedence over the default.
+  const ParallelPolicy grainPolicy(4, 50000);
+  REQUIRE(grainPolicy.NumBlocks(100000, 1000) ==
+      std::min(grainPolicy.NumThreads(), (size_t) 2));
+
+  const ParallelPolicy deterministic1(1, 0, true);
+  const ParallelPolicy deterministic8(8, 0, true);
+  REQUIRE(deterministic1.NumBlocks(30000, 1000) == 30);
+  REQUIRE(deterministic8.NumBlocks(30000, 1000) == 30);
+  REQUIRE(deterministic1.NumBlocks(1000000, 1000) ==
+      deterministic8.NumBlocks(1000000, 1000));
+}
+
+/**
+ * Make sure that scopes apply their policy to the current thread only, and
+ * restore the previous policy.
+ */
+TEST_CASE("ParallelScopeTest", "[ParallelPolicyTest]")
+{
+  const size_t defaultThreads = ParallelPolicy::Current().NumThreads();
+  REQUIRE(ParallelPolicy::Current().Threads() == 0);
+
+  {
+    ParallelScope scope(ParallelPolicy(3, 100));
+    REQUIRE(ParallelPolicy::Current().Threads() == 3);
+    REQUIRE(ParallelPolicy::Current().GrainSize() == 100);
+    #ifdef HAS_OPENMP
+      REQUIRE(omp_get_max_threads() == 3);
+    #endif
+
+    {
+      ParallelScope innerScope(ParallelPolicy(2, 0, true));
+      REQUIRE(ParallelPolicy::Current().Threads() == 2);
+      REQUIRE(ParallelPolicy::Current().Deterministic());
+    }
+
+    REQUIRE(ParallelPolicy::Current().Threads() == 3);
+    REQUIRE(!ParallelPolicy::Current().Deterministic());
+
+    // Other threads keep their own policy.
+    size_t otherThreads = 0;
+    std::thread other([&otherThreads]()
+    {
+      otherThreads = ParallelPolicy::Current().Threads();
+    });
+    other.join();
+    REQUIRE(otherThreads == 0);
+  }
+
+  REQUIRE(ParallelPolicy::Current().Threads() == 0);
+  REQUIRE(ParallelPolicy::Current().NumThreads() == defaultThreads);
+}
+
+/**
+ * Make sure that a reduction gives exactly the same result with any number of
+ * threads under a deterministic policy.
+ */
+TEST_CASE("DeterministicCovarianceTest", "[ParallelPolicyTest]")
+{
+  arma::mat data(5, 50000, arma::fill::randn);
+
+  arma::mat cov1, cov4;
+  {
+    ParallelScope scope(ParallelPolicy(1, 0, true));
+    cov1 = math::ColumnCovariance(data);
+  }
+  {
+    ParallelScope scope(ParallelPolicy(4, 0, true));
+    cov4 = math::ColumnCovariance(data);
+  }
+
+  REQUIRE(arma::approx_equal(cov1, cov4, "absdiff", 0.0));
+  REQUIRE(arma::approx_equal(cov1, arma::cov(data.t()), "reldiff", 1e-8));
+}
+
+/**
+ * Make sure that FirstTouch() keeps the values of the matrix, and that loading
+ * under a NUMA-aware policy gives the same matrix.
+ */
+TEST_CASE("FirstTouchTest", "[ParallelPolicyTest]")
+{
+  arma::mat data(7, 10000, arma::fill::randu);
+  arma::mat placed(data);
+  data::FirstTouch(placed);
+  REQUIRE(arma::approx_equal(placed, data, "absdiff", 0.0));
+
+  arma::mat empty;
+  data::FirstTouch(empty);
+  REQUIRE(empty.n_elem == 0);
+
+  data::Save("first_touch_test.bin", data, true);
+  arma::mat loaded;
+  {
+    ParallelScope scope(ParallelPolicy(0, 0, false, true));
+    REQUIRE(data::Load("first_touch_test.bin", loaded, true));
+  }
+  remove("first_touch_test.bin");
+
+  REQUIRE(arma::approx_equal(loaded, data, "absdiff", 0.0));
+}
@@ -336,3 +336,80 @@ TEST_CASE("PCAScalingTest", "[PCATest]")
   // The eigenvalues should sum to three.
   REQUIRE(accu(eigval) == Approx(3.0).epsilon(0.001));
 }
+
+/**
+ * Make sure that applying PCA in place gives the same result as applying it to
+ * a copy of the data.
+ */
+TEST_CASE("PCAInPlaceTest", "[PCATest]")
+{
+  arma::mat data = arma::randu<arma::mat>(4, 500);
+  arma::mat transData, eigvec, inPlaceEigvec;
+  arma::vec eigval, inPlaceEigval;
+
+  PCA<> p;
+  p.Apply(data, transData, eigval, eigvec);
+  p.Apply(data, data, inPlaceEigval, inPlaceEigvec);
+
+  REQUIRE(approx_equal(eigval, inPlaceEigval, "both", 1e-10, 1e-10));
+  REQUIRE(approx_equal(eigvec, inPlaceEigvec, "both", 1e-10, 1e-10));
+  REQUIRE(approx_equal(transData, data, "both", 1e-10, 1e-10));
+}
+
+/**
+ * Make sure that IncrementalPCA on minibatches finds the same components as
+ * exact PCA on all the data, and that it keeps only the requested number of
+ * them.
+ */
+TEST_CASE("IncrementalPCATest", "[PCATest]")
+{
+  arma::mat data = arma::randn<arma::mat>(5, 1000);
+  data.row(1) += 2.0 * data.row(0);
+  data.row(3) *= 3.0;
+  data.each_col() += arma::vec("1.0 -2.0 3.0 0.0 5.0");
+
+  arma::mat transData, eigvec;
+  arma::vec eigval;
+  PCA<> p;
+  p.Apply(data, transData, eigval, eigvec);
+
+  // Without truncation, the incremental updates are exact.
+  IncrementalPCA ipca;
+  ipca.Train(svd::MatColumnBlocks(data, 128));
+
+  REQUIRE(ipca.NumPoints() == data.n_cols);
+  REQUIRE(approx_equal(ipca.Mean(), arma::vec(arma::mean(data, 1)), "both",
+      1e-10, 1e-10));
+  const arma::vec ipcaEigval = ipca.EigenValues();
+  REQUIRE(ipcaEigval.n_elem == eigval.n_elem);
+  for (size_t i = 0; i < eigval.n_elem; ++i)
+  {
+    REQUIRE(ipcaEigval[i] == Approx(eigval[i]).epsilon(1e-8));
+    // The components are only defined up to their sign.
+    const double sign = arma::dot(ipca.EigenVectors().col(i), eigvec.col(i));
+    REQUIRE(std::abs(sign) == Approx(1.0).epsilon(1e-6));
+  }
+
+  // The projections match up to the sign of the components too.
+  arma::mat ipcaTransData;
+  ipca.Transform(data, ipcaTransData);
+  for (size_t i = 0; i < eigval.n_elem; ++i)
+  {
+    const double sign = (arma::dot(ipca.EigenVectors().col(i),
+        eigvec.col(i)) > 0) ? 1.0 : -1.0;
+    REQUIRE(approx_equal(sign * ipcaTransData.row(i), transData.row(i),
+        "absdiff", 1e-6));
+  }
+
+  // With truncation, only the leading components are kept.
+  IncrementalPCA truncated(2);
+  for (size_t i = 0; i < data.n_cols; i += 250)
+    truncated.Update(data.cols(i, i + 249));
+
+  REQUIRE(truncated.EigenVectors().n_cols == 2);
+  REQUIRE(truncated.EigenValues()[0] == Approx(eigval[0]).epsilon(0.05));
+
+  // A minibatch of the wrong dimensionality is rejected.
+  REQUIRE_THROWS_AS(truncated.Update(arma::randu<arma::mat>(3, 10)),
+      std::invalid_argument);
+}
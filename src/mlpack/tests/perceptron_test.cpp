@@ -245,3 +245,64 @@ TEST_CASE("SecondaryConstructor", "[PerceptronTest]")
 
   Perceptron<> p2(p1);
 }
+
+/**
+ * Make sure that classifying a set of points at once gives the same labels as
+ * classifying each point separately.
+ */
+TEST_CASE("BatchClassificationTest", "[PerceptronTest]")
+{
+  mat trainData(5, 300, fill::randu);
+  Row<size_t> labels(300);
+  for (size_t i = 0; i < 300; ++i)
+  {
+    labels[i] = i % 3;
+    trainData(labels[i], i) += 1.0;
+  }
+
+  Perceptron<> p(trainData, labels, 3, 1000);
+
+  mat testData(5, 100, fill::randu);
+  Row<size_t> predictedLabels;
+  p.Classify(testData, predictedLabels);
+  REQUIRE(predictedLabels.n_elem == 100);
+
+  for (size_t i = 0; i < testData.n_cols; ++i)
+  {
+    const mat point = testData.col(i);
+    Row<size_t> pointLabel;
+    p.Classify(point, pointLabel);
+    REQUIRE(pointLabel.n_elem == 1);
+    REQUIRE(pointLabel[0] == predictedLabels[i]);
+  }
+}
+
+/**
+ * Make sure that the averaged perceptron and the perceptron trained with
+ * parameter mixing both separate a linearly separable dataset.
+ */
+TEST_CASE("AveragedAndParameterMixingTest", "[PerceptronTest]")
+{
+  mat trainData(4, 8000, fill::randu);
+  Row<size_t> labels(8000);
+  for (size_t i = 0; i < 8000; ++i)
+  {
+    labels[i] = i % 2;
+    trainData(0, i) += 2.0 * labels[i];
+  }
+
+  Perceptron<> averaged(2, 4, 100);
+  averaged.Averaged() = true;
+  averaged.Train(trainData, labels, 2);
+
+  Perceptron<> mixed(2, 4, 100);
+  mixed.ParameterMixing() = true;
+  mixed.Train(trainData, labels, 2);
+
+  Row<size_t> averagedLabels, mixedLabels;
+  averaged.Classify(trainData, averagedLabels);
+  mixed.Classify(trainData, mixedLabels);
+
+  REQUIRE(accu(averagedLabels == labels) == 8000);
+  REQUIRE(accu(mixedLabels == labels) == 8000);
+}
@@ -235,3 +235,53 @@ TEST_CASE("TestArmaCustomPrecision", "[PrefixedOutStreamTest]")
       BASH_GREEN "[INFO ] " BASH_CLEAR "   2.5000   3.0000   3.5000\n"
       BASH_GREEN "[INFO ] " BASH_CLEAR "   4.0000   4.5000   5.0000\n");
 }
+
+//! Counts how many times it is formatted.
+struct FormatCounter
+{
+  mutable size_t count = 0;
+};
+
+std::ostream& operator<<(std::ostream& stream, const FormatCounter& counter)
+{
+  ++counter.count;
+  return stream << "counter";
+}
+
+/**
+ * A muted stream should not format what is written to it, and MLPACK_LOG()
+ * should not even evaluate it.
+ */
+TEST_CASE("TestMutedOutput", "[PrefixedOutStreamTest]")
+{
+  std::stringstream ss;
+  PrefixedOutStream pss(ss, BASH_GREEN "[INFO ] " BASH_CLEAR, true);
+  REQUIRE(pss.Muted());
+
+  FormatCounter counter;
+  pss << counter << std::endl;
+  REQUIRE(counter.count == 0);
+  REQUIRE(ss.str() == "");
+
+  size_t evaluated = 0;
+  MLPACK_LOG(pss) << ++evaluated << std::endl;
+  REQUIRE(evaluated == 0);
+
+  // Once unmuted, everything is written again.
+  pss.ignoreInput = false;
+  REQUIRE(!pss.Muted());
+  MLPACK_LOG(pss) << counter << " " << ++evaluated << std::endl;
+  REQUIRE(counter.count == 1);
+  REQUIRE(evaluated == 1);
+  REQUIRE(ss.str() == BASH_GREEN "[INFO ] " BASH_CLEAR "counter 1\n");
+
+  // A fatal stream is never muted, since it must still throw.
+  PrefixedOutStream fatal(ss, BASH_RED "[FATAL] " BASH_CLEAR, true, true);
+  REQUIRE(!fatal.Muted());
+  REQUIRE_THROWS_AS(fatal << "error" << std::endl, std::runtime_error);
+
+  NullOutStream nss;
+  REQUIRE(nss.Muted());
+  MLPACK_LOG(nss) << ++evaluated << std::endl;
+  REQUIRE(evaluated == 1);
+}
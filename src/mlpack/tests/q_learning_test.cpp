@@ -19,6 +19,7 @@
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/loss_functions/empty_loss.hpp>
 #include <mlpack/methods/reinforcement_learning/q_learning.hpp>
+#include <mlpack/methods/reinforcement_learning/apex.hpp>
 #include <mlpack/methods/reinforcement_learning/sac.hpp>
 #include <mlpack/methods/reinforcement_learning/q_networks/simple_dqn.hpp>
 #include <mlpack/methods/reinforcement_learning/q_networks/dueling_dqn.hpp>
@@ -123,6 +124,143 @@ TEST_CASE("CartPoleWithDQN", "[QLearningTest]")
   REQUIRE(converged);
 }
 
+//! Train DQN on several Cart Pole environments stepped in lockstep.
+TEST_CASE("CartPoleWithVectorEnvironmentDQN", "[QLearningTest]")
+{
+  SimpleDQN<> network(4, 32, 32, 2);
+  GreedyPolicy<CartPole> policy(1.0, 1000, 0.1, 0.99);
+  RandomReplay<CartPole> replayMethod(10, 10000);
+
+  TrainingConfig config;
+  config.StepSize() = 0.01;
+  config.Discount() = 0.9;
+  config.TargetNetworkSyncInterval() = 100;
+  config.ExplorationSteps() = 100;
+
+  QLearning<CartPole, decltype(network), AdamUpdate, decltype(policy)>
+      agent(config, network, policy, replayMethod);
+
+  VectorEnvironment<CartPole> environments(8);
+  agent.Steps(environments, 100);
+
+  // Every environment took every step.
+  REQUIRE(agent.TotalSteps() == 800);
+  REQUIRE(!environments.FinishedReturns().empty());
+  for (size_t i = 0; i < environments.FinishedReturns().size(); ++i)
+    REQUIRE(environments.FinishedReturns()[i] >= 1.0);
+
+  // n-step replay cannot interleave several environments.
+  RandomReplay<CartPole> nStepReplay(10, 10000, 3);
+  QLearning<CartPole, decltype(network), AdamUpdate, decltype(policy)>
+      nStepAgent(config, network, policy, nStepReplay);
+  REQUIRE_THROWS_AS(nStepAgent.Steps(environments, 1), std::invalid_argument);
+}
+
+//! Check the training metrics of DQN.
+TEST_CASE("DQNTrainingMetrics", "[QLearningTest]")
+{
+  SimpleDQN<> network(4, 32, 32, 2);
+  GreedyPolicy<CartPole> policy(1.0, 1000, 0.1, 0.99);
+  RandomReplay<CartPole> replayMethod(10, 10000);
+
+  TrainingConfig config;
+  config.StepSize() = 0.01;
+  config.Discount() = 0.9;
+  config.TargetNetworkSyncInterval() = 100;
+  config.ExplorationSteps() = 100;
+
+  QLearning<CartPole, decltype(network), AdamUpdate, decltype(policy)>
+      agent(config, network, policy, replayMethod);
+  agent.Metrics().TimePhases() = true;
+
+  std::vector<double> returns;
+  agent.Metrics().Callback() = [&](const TrainingMetrics& metrics)
+  {
+    returns.push_back(metrics.LastReturn());
+  };
+
+  double totalReturn = 0.0;
+  for (size_t i = 0; i < 20; ++i)
+    totalReturn += agent.Episode();
+
+  const TrainingMetrics& metrics = agent.Metrics();
+  REQUIRE(metrics.Episodes() == 20);
+  REQUIRE(returns.size() == 20);
+  REQUIRE(arma::accu(arma::vec(returns)) == Approx(totalReturn));
+  REQUIRE(metrics.Steps() == agent.TotalSteps());
+  REQUIRE(metrics.ReplayOccupancy() == replayMethod.Size());
+
+  // Each step after the exploration steps trains the agent once, and every
+  // training step samples the replay and updates the network.
+  REQUIRE(metrics.Updates() == agent.TotalSteps() - 99);
+  REQUIRE(metrics.Count(TrainingMetrics::Phase::replaySample) ==
+      metrics.Updates());
+  REQUIRE(metrics.Count(TrainingMetrics::Phase::update) == metrics.Updates());
+  REQUIRE(metrics.Count(TrainingMetrics::Phase::environment) ==
+      metrics.Steps());
+  REQUIRE(metrics.StepsPerSecond() > 0.0);
+  REQUIRE(metrics.UpdatesPerSecond() > 0.0);
+  REQUIRE(metrics.MeanReplaySampleTime() >= 0.0);
+
+  agent.Metrics().Reset();
+  REQUIRE(agent.Metrics().Steps() == 0);
+  REQUIRE(agent.Metrics().Updates() == 0);
+  REQUIRE(agent.Metrics().Time(TrainingMetrics::Phase::forward) == 0.0);
+}
+
+//! Test Ape-X in Cart Pole task.
+TEST_CASE("CartPoleWithApeX", "[QLearningTest]")
+{
+  SimpleDQN<> network(4, 64, 64, 2);
+  GreedyPolicy<CartPole> policy(1.0, 1000, 0.1, 0.99);
+  PrioritizedReplay<CartPole> replayMethod(32, 10000, 0.6);
+
+  TrainingConfig config;
+  config.NumWorkers() = 4;
+  config.UpdateInterval() = 20;
+  config.StepSize() = 0.01;
+  config.Discount() = 0.9;
+  config.TargetNetworkSyncInterval() = 100;
+  config.ExplorationSteps() = 100;
+  config.StepLimit() = 200;
+
+  ApeX<CartPole, decltype(network), AdamUpdate, decltype(policy)>
+      agent(config, network, policy, replayMethod);
+  agent.LearnerSteps() = 4;
+
+  // Stop when the last 50 episodes of the actors have an average return above
+  // the threshold, or after too many episodes.
+  std::vector<double> returnList;
+  size_t episodes = 0;
+  bool converged = false;
+  auto measure = [&](double episodeReturn)
+  {
+    ++episodes;
+    returnList.push_back(episodeReturn);
+    if (returnList.size() > 50)
+      returnList.erase(returnList.begin());
+
+    const double averageReturn = std::accumulate(returnList.begin(),
+        returnList.end(), 0.0) / returnList.size();
+    if (returnList.size() >= 50 && averageReturn > 40)
+      converged = true;
+
+    return converged || episodes > 2000;
+  };
+
+  agent.Train(measure);
+
+  REQUIRE(agent.TotalSteps() % (4 * 20) == 0);
+  REQUIRE(agent.Learner().TotalSteps() > 0);
+  REQUIRE(converged);
+
+  // n-step transitions cannot be prioritized by the actors.
+  PrioritizedReplay<CartPole> nStepReplay(32, 10000, 0.6, 3);
+  ApeX<CartPole, decltype(network), AdamUpdate, decltype(policy)>
+      nStepAgent(config, network, policy, nStepReplay);
+  REQUIRE_THROWS_AS(nStepAgent.Train(measure), std::invalid_argument);
+}
+
 //! Test DQN in Cart Pole task with Prioritized Replay.
 TEST_CASE("CartPoleWithDQNPrioritizedReplay", "[QLearningTest]")
 {
@@ -141,6 +141,39 @@ TEST_CASE("QDAFNMultipleNeighbors", "[QDAFNTest]")
   }
 }
 
+/**
+ * Make sure that the neighbors of each query are distinct, sorted from the
+ * furthest to the nearest, and have the right distances.
+ */
+TEST_CASE("QDAFNSortedDistinctNeighbors", "[QDAFNTest]")
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(5, 300);
+  arma::mat querySet = arma::randu<arma::mat>(5, 100);
+
+  QDAFN<> qdafn(referenceSet, 5, 40);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  qdafn.Search(querySet, 5, neighbors, distances);
+
+  for (size_t q = 0; q < querySet.n_cols; ++q)
+  {
+    for (size_t i = 0; i < 5; ++i)
+    {
+      REQUIRE(neighbors(i, q) < referenceSet.n_cols);
+      const double dist = metric::EuclideanDistance::Evaluate(querySet.col(q),
+          referenceSet.col(neighbors(i, q)));
+      REQUIRE(distances(i, q) == Approx(dist).epsilon(1e-7));
+
+      for (size_t j = 0; j < i; ++j)
+      {
+        REQUIRE(neighbors(j, q) != neighbors(i, q));
+        REQUIRE(distances(j, q) >= distances(i, q));
+      }
+    }
+  }
+}
+
 /**
  * Test re-training method.
  */
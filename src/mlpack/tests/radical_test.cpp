@@ -56,3 +56,28 @@ TEST_CASE("Radical_Test_Radical3D", "[RadicalTest]")
   // Larger tolerance is sometimes needed.
   REQUIRE(valBest == Approx(valEst).epsilon(0.02));
 }
+
+/**
+ * Make sure that the entropy estimate sorts its sample, including negative
+ * values and duplicates, and matches the m-spacing sum computed directly.
+ */
+TEST_CASE("RadicalVasicekSortTest", "[RadicalTest]")
+{
+  Radical rad(0.175, 5, 100, 1, 3);
+
+  vec x = 100.0 * randn<vec>(1000);
+  x.subvec(0, 9).fill(-2.5);
+  x(10) = 0.0;
+  x(11) = -0.0;
+  vec sorted = sort(x);
+
+  double expected = 0.0;
+  for (uword i = 0; i + 3 < sorted.n_elem; ++i)
+    expected += log(std::max(sorted(i + 3) - sorted(i), DBL_MIN));
+
+  const double estimate = rad.Vasicek(x);
+
+  REQUIRE(estimate == Approx(expected).epsilon(1e-10));
+  for (uword i = 0; i < x.n_elem; ++i)
+    REQUIRE(x(i) == sorted(i));
+}
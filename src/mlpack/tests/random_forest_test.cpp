@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/core.hpp>
+#include <mlpack/core/data/compressed_dataset.hpp>
 #include <mlpack/methods/random_forest/random_forest.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 
@@ -609,3 +610,114 @@ TEST_CASE("ExtraTreesAccuracyTest", "[RandomForestTest]")
 
   REQUIRE(accuracy >= 0.91);
 }
+
+/**
+ * Make sure that a flattened random forest classifies like the forest, with
+ * and without QuickScorer.
+ */
+TEST_CASE("RandomForestFlattenTest", "[RandomForestTest]")
+{
+  arma::mat dataset(5, 2000, arma::fill::randu);
+  arma::Row<size_t> labels(2000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    labels[i] = (dataset(0, i) + dataset(2, i) > 1.0) ? 1 : 0;
+    if (dataset(4, i) > 0.8)
+      labels[i] = 2;
+  }
+
+  arma::mat testData(5, 500, arma::fill::randu);
+
+  // Shallow trees can be evaluated with QuickScorer; deep ones can not.
+  for (size_t depth = 0; depth < 2; ++depth)
+  {
+    RandomForest<> rf(dataset, labels, 3, 10, 1, 1e-7, (depth == 0) ? 5 : 0);
+    FlatForest flat;
+    rf.Flatten(flat);
+    REQUIRE(flat.NumTrees() == rf.NumTrees());
+    REQUIRE(flat.QuickScorerAvailable() == (depth == 0));
+
+    arma::Row<size_t> predictions;
+    arma::mat probabilities;
+    rf.Classify(testData, predictions, probabilities);
+
+    for (size_t q = 0; q < 2; ++q)
+    {
+      flat.UseQuickScorer() = (q == 0);
+
+      arma::Row<size_t> flatPredictions;
+      arma::mat flatProbabilities;
+      flat.Classify(testData, flatPredictions, flatProbabilities);
+      for (size_t i = 0; i < testData.n_cols; ++i)
+        REQUIRE(flatPredictions[i] == predictions[i]);
+      for (size_t i = 0; i < probabilities.n_elem; ++i)
+      {
+        REQUIRE(flatProbabilities[i] ==
+            Approx(probabilities[i]).epsilon(1e-10));
+      }
+    }
+  }
+
+  // An untrained forest can not be flattened.
+  RandomForest<> untrained;
+  FlatForest flat;
+  REQUIRE_THROWS_AS(untrained.Flatten(flat), std::invalid_argument);
+}
+
+/**
+ * Make sure that a random forest without bootstrap, whose trees are trained
+ * on the indices of the points, is the same as a decision tree trained on the
+ * dataset.
+ */
+TEST_CASE("RandomForestNoBootstrapTreeTest", "[RandomForestTest]")
+{
+  arma::mat dataset(4, 1000, arma::fill::randu);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    labels[i] = (dataset(1, i) * dataset(3, i) > 0.25) ? 1 : 0;
+
+  RandomForest<GiniGain, AllDimensionSelect, BestBinaryNumericSplit,
+      AllCategoricalSplit, false> rf(dataset, labels, 2, 2, 5);
+  DecisionTree<GiniGain, BestBinaryNumericSplit, AllCategoricalSplit,
+      AllDimensionSelect> tree(dataset, labels, 2, 5);
+
+  arma::mat testData(4, 500, arma::fill::randu);
+  arma::Row<size_t> forestPredictions, treePredictions;
+  arma::mat forestProbabilities, treeProbabilities;
+  rf.Classify(testData, forestPredictions, forestProbabilities);
+  tree.Classify(testData, treePredictions, treeProbabilities);
+
+  for (size_t i = 0; i < testData.n_cols; ++i)
+    REQUIRE(forestPredictions[i] == treePredictions[i]);
+  for (size_t i = 0; i < treeProbabilities.n_elem; ++i)
+  {
+    REQUIRE(forestProbabilities[i] ==
+        Approx(treeProbabilities[i]).epsilon(1e-10));
+  }
+}
+
+/**
+ * Test that a random forest can be trained on a CompressedDataset.
+ */
+TEST_CASE("CompressedDatasetRandomForestTest", "[RandomForestTest]")
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  data::CompressedDataset trainingData(d.cols(0, 1999), di);
+  data::CompressedDataset testData(d.cols(2000, 3999), di);
+  arma::Row<size_t> trainingLabels = l.subvec(0, 1999);
+  arma::Row<size_t> testLabels = l.subvec(2000, 3999);
+
+  RandomForest<> rf(trainingData, di, trainingLabels, 5, 25 /* 25 trees */, 1,
+      1e-7, 0, MultipleRandomDimensionSelect(4));
+
+  arma::Row<size_t> predictions;
+  rf.Classify(testData, predictions);
+  REQUIRE(predictions.n_elem == testData.n_cols);
+
+  const size_t correct = arma::accu(predictions == testLabels);
+  REQUIRE(correct >= size_t(0.7 * testData.n_cols));
+}
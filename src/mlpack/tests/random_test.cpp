@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/core/math/random.hpp>
+#include <mlpack/core/math/random_stream.hpp>
 #include <mlpack/core/dists/discrete_distribution.hpp>
 
 #include "catch.hpp"
@@ -94,3 +95,97 @@ TEST_CASE("WeightedRandomTest", "[RandomTest]")
     }
   }
 }
+
+// Check the Philox4x32-10 function against the known-answer vectors of its
+// reference implementation.
+TEST_CASE("RandomStreamPhiloxTest", "[RandomTest]")
+{
+  const uint32_t counters[3][4] = {
+      { 0x00000000, 0x00000000, 0x00000000, 0x00000000 },
+      { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF },
+      { 0x243F6A88, 0x85A308D3, 0x13198A2E, 0x03707344 } };
+  const uint32_t keys[3][2] = {
+      { 0x00000000, 0x00000000 },
+      { 0xFFFFFFFF, 0xFFFFFFFF },
+      { 0xA4093822, 0x299F31D0 } };
+  const uint32_t outputs[3][4] = {
+      { 0x6627E8D5, 0xE169C58D, 0xBC57AC4C, 0x9B00DBD8 },
+      { 0x408F276D, 0x41C83B0E, 0xA20BC7C6, 0x6D5451FD },
+      { 0xD16CFE09, 0x94FDCCEB, 0x5001E420, 0x24126EA1 } };
+
+  for (size_t t = 0; t < 3; ++t)
+  {
+    uint32_t out[4];
+    RandomStream::Philox(counters[t], keys[t], out);
+    for (size_t i = 0; i < 4; ++i)
+      REQUIRE(out[i] == outputs[t][i]);
+  }
+}
+
+// Make sure that split streams only depend on the seed and the task, and that
+// they differ between tasks.
+TEST_CASE("RandomStreamSplitTest", "[RandomTest]")
+{
+  RandomStream stream(12345);
+  stream.Random();
+
+  // The split streams do not depend on the position of the stream, nor on the
+  // order they are used in.
+  arma::mat values(100, 8);
+  #pragma omp parallel for
+  for (omp_size_t t = 0; t < 8; ++t)
+  {
+    RandomStream taskStream = stream.Split(t);
+    for (size_t i = 0; i < 100; ++i)
+      values(i, t) = taskStream.Random();
+  }
+
+  RandomStream other(12345);
+  for (size_t t = 8; t > 0; --t)
+  {
+    RandomStream taskStream = other.Split(t - 1);
+    for (size_t i = 0; i < 100; ++i)
+      REQUIRE(values(i, t - 1) == taskStream.Random());
+  }
+
+  for (size_t t = 1; t < 8; ++t)
+    REQUIRE(arma::accu(values.col(t) == values.col(0)) == 0);
+
+  // A stream split twice differs from the stream split once.
+  RandomStream nested = stream.Split(0).Split(0);
+  REQUIRE(nested.Random() != values(0, 0));
+}
+
+// Make sure that the bulk fills give the same numbers as the scalar functions,
+// and that the numbers have the right distributions.
+TEST_CASE("RandomStreamFillTest", "[RandomTest]")
+{
+  RandomStream stream(42, 7);
+  stream();
+  RandomStream scalarStream(stream);
+
+  // This is large enough to be filled in parallel.
+  arma::mat uniform(100, 200);
+  stream.Randu(uniform);
+  for (size_t i = 0; i < uniform.n_elem; ++i)
+    REQUIRE(uniform[i] == scalarStream.Random());
+  REQUIRE(stream.Position() == scalarStream.Position());
+  REQUIRE(uniform.min() >= 0.0);
+  REQUIRE(uniform.max() < 1.0);
+  REQUIRE(arma::mean(arma::vectorise(uniform)) == Approx(0.5).epsilon(0.01));
+
+  arma::fmat normal(101, 99);
+  stream.Randn(normal);
+  for (size_t i = 0; i < normal.n_elem; i += 2)
+    REQUIRE(normal[i] == Approx(scalarStream.RandNormal()).epsilon(1e-6));
+  REQUIRE(stream.Position() == scalarStream.Position());
+  REQUIRE(arma::mean(arma::vectorise(normal)) == Approx(0.0).margin(0.03));
+  REQUIRE(arma::var(arma::vectorise(normal)) == Approx(1.0).epsilon(0.03));
+
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    const int value = stream.RandInt(-3, 4);
+    REQUIRE(value >= -3);
+    REQUIRE(value < 4);
+  }
+}
@@ -60,3 +60,61 @@ TEST_CASE("RandomizedSVDReconstructionError", "[RandomizedSVDTest]")
       arma::norm(centeredData, "frob");
   REQUIRE(error == Approx(0.0).margin(1e-5));
 }
+
+/**
+ * The out-of-core randomized SVD should find the same singular values as the
+ * exact SVD of the centered data, whether the blocks come from memory or from
+ * a file.
+ */
+TEST_CASE("RandomizedSVDStreamingReconstructionError", "[RandomizedSVDTest]")
+{
+  arma::mat U = arma::randn<arma::mat>(50, 3);
+  arma::mat V = arma::randn<arma::mat>(12, 3);
+
+  arma::mat R;
+  arma::qr_econ(U, R, U);
+  arma::qr_econ(V, R, V);
+
+  arma::mat data = arma::trans(U * arma::diagmat(arma::vec("1 0.1 0.01")) *
+      V.t());
+
+  // Center the data into a temporary matrix.
+  arma::mat centeredData;
+  math::Center(data, centeredData);
+
+  arma::mat U1, U2, V1, V2;
+  arma::vec s1, s2;
+  arma::svd_econ(U1, s1, V1, centeredData);
+
+  // Use blocks that do not divide the number of columns.
+  svd::RandomizedSVD rSVD(0, 10);
+  rSVD.ApplyStreaming(svd::MatColumnBlocks(data, 7), U2, s2, V2, 3);
+
+  REQUIRE(V2.n_rows == data.n_cols);
+  double error = arma::norm(s2 - s1.subvec(0, s2.n_elem - 1), "frob") /
+      arma::norm(s2, "frob");
+  REQUIRE(error == Approx(0.0).margin(1e-5));
+
+  arma::mat reconstruct = U2 * arma::diagmat(s2) * V2.t();
+  error = arma::norm(centeredData - reconstruct, "frob") /
+      arma::norm(centeredData, "frob");
+  REQUIRE(error == Approx(0.0).margin(1e-5));
+
+  // Read the same matrix from a file.
+  REQUIRE(data.save("randomized_svd_blocks.bin", arma::raw_binary));
+  arma::mat U3, V3;
+  arma::vec s3;
+  svd::RandomizedSVD fileSVD(0, 10);
+  fileSVD.ApplyStreaming(svd::BinaryFileColumnBlocks(
+      "randomized_svd_blocks.bin", data.n_rows, data.n_cols, 16), U3, s3, V3,
+      3);
+  remove("randomized_svd_blocks.bin");
+
+  error = arma::norm(s3 - s1.subvec(0, s3.n_elem - 1), "frob") /
+      arma::norm(s3, "frob");
+  REQUIRE(error == Approx(0.0).margin(1e-5));
+
+  // A missing file is an error.
+  REQUIRE_THROWS_AS(fileSVD.ApplyStreaming(svd::BinaryFileColumnBlocks(
+      "randomized_svd_missing.bin", 3, 3), U3, s3, V3, 3), std::runtime_error);
+}
@@ -1355,6 +1355,65 @@ TEST_CASE("RSModelTest", "[RangeSearchTest]")
   }
 }
 
+/**
+ * Make sure that RSModel::Tune() chooses one of the candidate configurations,
+ * and that the model built with it gives the same results as naive search.
+ */
+TEST_CASE("RSModelTuneTest", "[RangeSearchTest]")
+{
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1500);
+
+  RangeSearch<> rs(referenceData, true);
+  vector<vector<size_t>> baselineNeighbors;
+  vector<vector<double>> baselineDistances;
+  rs.Search(queryData, math::Range(0.05, 0.15), baselineNeighbors,
+      baselineDistances);
+
+  vector<vector<pair<double, size_t>>> baselineSorted;
+  SortResults(baselineNeighbors, baselineDistances, baselineSorted);
+
+  // Sample less than the full dataset, so that the costs are extrapolated.
+  RSModel model;
+  model.LeafSize() = 7;
+  util::Timers timers;
+  model.Tune(timers, referenceData, queryData, math::Range(0.05, 0.15), false,
+      false, tree::TreeTuner(500, 50));
+  if (model.TreeType() == RSModel::COVER_TREE ||
+      model.TreeType() == RSModel::R_STAR_TREE)
+  {
+    REQUIRE(model.LeafSize() == 7);
+  }
+  else
+  {
+    REQUIRE((model.LeafSize() == 10 || model.LeafSize() == 20 ||
+             model.LeafSize() == 40));
+  }
+
+  model.BuildModel(timers, arma::mat(referenceData), model.LeafSize(), false,
+      false);
+
+  vector<vector<size_t>> neighbors;
+  vector<vector<double>> distances;
+  model.Search(timers, arma::mat(queryData), math::Range(0.05, 0.15),
+      neighbors, distances);
+
+  vector<vector<pair<double, size_t>>> sorted;
+  SortResults(neighbors, distances, sorted);
+
+  REQUIRE(sorted.size() == baselineSorted.size());
+  for (size_t k = 0; k < sorted.size(); ++k)
+  {
+    REQUIRE(sorted[k].size() == baselineSorted[k].size());
+    for (size_t l = 0; l < sorted[k].size(); ++l)
+    {
+      REQUIRE(sorted[k][l].second == baselineSorted[k][l].second);
+      REQUIRE(sorted[k][l].first ==
+          Approx(baselineSorted[k][l].first).epsilon(1e-7));
+    }
+  }
+}
+
 TEST_CASE("RSModelMonochromaticTest", "[RangeSearchTest]")
 {
   // Ensure that we can build an RSModel and get correct results.
@@ -1718,3 +1777,109 @@ TEST_CASE("MoveOperatorNaiveTest", "[RangeSearchTest]")
     }
   }
 }
+
+/**
+ * Make sure that Count() and Stream() give the same results as Search(), in
+ * every search mode, with and without a separate query set.
+ */
+TEST_CASE("RangeSearchCountAndStreamTest", "[RangeSearchTest]")
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 500);
+  arma::mat querySet = arma::randu<arma::mat>(3, 200);
+  const math::Range range(0.05, 0.2);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RangeSearch<> rs(referenceSet, mode == 0, mode == 1);
+
+    for (size_t mono = 0; mono < 2; ++mono)
+    {
+      vector<vector<size_t>> neighbors;
+      vector<vector<double>> distances;
+      arma::Row<size_t> counts;
+      vector<vector<pair<size_t, double>>> streamed(mono ? 500 : 200);
+      auto callback = [&streamed](const size_t queryIndex,
+                                  const size_t referenceIndex,
+                                  const double distance)
+      {
+        streamed[queryIndex].push_back(make_pair(referenceIndex, distance));
+      };
+
+      if (mono)
+      {
+        rs.Search(range, neighbors, distances);
+        rs.Count(range, counts);
+        rs.Stream(range, callback);
+      }
+      else
+      {
+        rs.Search(querySet, range, neighbors, distances);
+        rs.Count(querySet, range, counts);
+        rs.Stream(querySet, range, callback);
+      }
+
+      REQUIRE(counts.n_elem == neighbors.size());
+      for (size_t i = 0; i < neighbors.size(); ++i)
+      {
+        REQUIRE(counts[i] == neighbors[i].size());
+        REQUIRE(streamed[i].size() == neighbors[i].size());
+
+        vector<pair<size_t, double>> expected;
+        for (size_t j = 0; j < neighbors[i].size(); ++j)
+          expected.push_back(make_pair(neighbors[i][j], distances[i][j]));
+
+        sort(expected.begin(), expected.end());
+        sort(streamed[i].begin(), streamed[i].end());
+        for (size_t j = 0; j < expected.size(); ++j)
+        {
+          REQUIRE(streamed[i][j].first == expected[j].first);
+          REQUIRE(streamed[i][j].second ==
+              Approx(expected[j].second).epsilon(1e-7));
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that MaxResults() limits the number of results for each query
+ * point, and that the results that are returned are correct.
+ */
+TEST_CASE("RangeSearchMaxResultsTest", "[RangeSearchTest]")
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 500);
+  arma::mat querySet = arma::randu<arma::mat>(3, 200);
+  const math::Range range(0.0, 0.3);
+
+  RangeSearch<> naive(referenceSet, true);
+  arma::Row<size_t> trueCounts;
+  naive.Count(querySet, range, trueCounts);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RangeSearch<> rs(referenceSet, mode == 0, mode == 1);
+    rs.MaxResults() = 5;
+
+    vector<vector<size_t>> neighbors;
+    vector<vector<double>> distances;
+    rs.Search(querySet, range, neighbors, distances);
+
+    arma::Row<size_t> counts;
+    rs.Count(querySet, range, counts);
+
+    for (size_t i = 0; i < neighbors.size(); ++i)
+    {
+      const size_t expected = std::min(trueCounts[i], (size_t) 5);
+      REQUIRE(neighbors[i].size() == expected);
+      REQUIRE(counts[i] == expected);
+
+      for (size_t j = 0; j < neighbors[i].size(); ++j)
+      {
+        const double distance = EuclideanDistance::Evaluate(querySet.col(i),
+            referenceSet.col(neighbors[i][j]));
+        REQUIRE(range.Contains(distance));
+        REQUIRE(distances[i][j] == Approx(distance).epsilon(1e-7));
+      }
+    }
+  }
+}
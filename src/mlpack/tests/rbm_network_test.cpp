@@ -211,6 +211,84 @@ TEST_CASE("ssRBMClassificationTest", "[RBMNetworkTest]")
   REQUIRE(ssRbmClassificationAccuracy >= 76.18 - 3.0);
 }
 
+/*
+ * Check the free energy and the conditional means of the SpikeSlabRBM, which
+ * are computed for all hidden units at once, against the formulas evaluated
+ * separately for each hidden unit.
+ */
+TEST_CASE("ssRBMBlockedComputationTest", "[RBMNetworkTest]")
+{
+  const size_t visibleSize = 6;
+  const size_t hiddenSize = 4;
+  const size_t poolSize = 3;
+  const double slabPenalty = 8;
+
+  arma::mat data(visibleSize, 5, arma::fill::randu);
+  GaussianInitialization gaussian(0, 0.5);
+  RBM<GaussianInitialization, arma::mat, SpikeSlabRBM> model(data, gaussian,
+      visibleSize, hiddenSize, 5, 1, 1, poolSize, slabPenalty, 2);
+  model.Reset();
+  model.VisiblePenalty().fill(5);
+  model.SpikeBias().randu();
+
+  const arma::cube& weight = model.Weight();
+
+  // Free energy of a batch of points.
+  double freeEnergy = 0.5 * 5 * arma::dot(data, data) - 0.5 * hiddenSize *
+      poolSize * std::log((2.0 * M_PI) / slabPenalty);
+  for (size_t i = 0; i < hiddenSize; ++i)
+  {
+    const double sum = arma::accu(arma::square(data.t() * weight.slice(i))) /
+        (2.0 * slabPenalty);
+    freeEnergy -= std::log(1 + std::exp(model.SpikeBias()(i) - sum));
+  }
+  REQUIRE(model.FreeEnergy(data) == Approx(freeEnergy).epsilon(1e-7));
+
+  // Spike means, for one point and for the mean of a batch.
+  arma::mat spikeMean;
+  for (size_t cols = 1; cols <= data.n_cols; cols += data.n_cols - 1)
+  {
+    const arma::mat visible = data.cols(0, cols - 1);
+    model.SpikeMean(visible, spikeMean);
+    REQUIRE(spikeMean.n_elem == hiddenSize);
+    for (size_t i = 0; i < hiddenSize; ++i)
+    {
+      const double expected = 1.0 / (1.0 + std::exp(-(0.5 *
+          (1.0 / slabPenalty) * arma::accu(visible.t() * (weight.slice(i) *
+          weight.slice(i).t()) * visible) / std::pow(cols, 2) +
+          model.SpikeBias()(i))));
+      REQUIRE(spikeMean(i) == Approx(expected).epsilon(1e-7));
+    }
+  }
+
+  // Slab means.
+  arma::mat spike("1; 0; 1; 1"), slabMean(poolSize, hiddenSize);
+  model.SlabMean(data, spike, slabMean);
+  for (size_t i = 0; i < hiddenSize; ++i)
+  {
+    const arma::vec expected = arma::mean((1.0 / slabPenalty) * spike(i) *
+        weight.slice(i).t() * data, 1);
+    for (size_t k = 0; k < poolSize; ++k)
+      REQUIRE(slabMean(k, i) == Approx(expected(k)).margin(1e-10));
+  }
+
+  // Visible means.
+  arma::mat hidden(hiddenSize + poolSize * hiddenSize, 1, arma::fill::randn);
+  hidden.rows(0, hiddenSize - 1) = spike;
+  arma::mat visibleMean;
+  model.VisibleMean(hidden, visibleMean);
+  arma::vec expected(visibleSize, arma::fill::zeros);
+  for (size_t i = 0; i < hiddenSize; ++i)
+  {
+    expected += weight.slice(i) * hidden.submat(hiddenSize + i * poolSize, 0,
+        hiddenSize + (i + 1) * poolSize - 1, 0) * spike(i);
+  }
+  expected /= 5.0;
+  REQUIRE(visibleMean.n_elem == visibleSize);
+  for (size_t j = 0; j < visibleSize; ++j)
+    REQUIRE(visibleMean(j) == Approx(expected(j)).margin(1e-10));
+}
+
 template<typename MatType = arma::mat>
 void BuildVanillaNetwork(MatType& trainData,
                          const size_t hiddenLayerSize)
@@ -931,3 +931,279 @@ TEST_CASE("RNNCheckInputShapeTest", "[RecurrentNetworkTest]")
 
   REQUIRE_THROWS_AS(model.Train(input, labels, opt), std::logic_error);
 }
+
+/**
+ * Predict the outputs of a sequence in one pass, and in two parts with the
+ * recurrent state carried over, and make sure the results are the same.
+ */
+template<typename RecurrentLayerType>
+void CarryStatePredictTest()
+{
+  const size_t steps = 10;
+  arma::cube input(3, 6, steps, arma::fill::randn);
+
+  RNN<MeanSquaredError<> > model(steps);
+  model.Add<IdentityLayer<> >();
+  model.Add<RecurrentLayerType>(3, 4, steps);
+  model.Add<Linear<> >(4, 2);
+  model.ResetParameters();
+
+  // The same network, given half of the sequence at a time.
+  RNN<MeanSquaredError<> > streamModel(steps / 2);
+  streamModel.Add<IdentityLayer<> >();
+  streamModel.Add<RecurrentLayerType>(3, 4, steps / 2);
+  streamModel.Add<Linear<> >(4, 2);
+  streamModel.ResetParameters();
+  streamModel.Parameters() = model.Parameters();
+
+  arma::cube results;
+  model.Predict(input, results);
+
+  streamModel.CarryState() = true;
+  streamModel.ResetState();
+  arma::cube firstResults, secondResults;
+  streamModel.Predict(input.slices(0, steps / 2 - 1), firstResults);
+  streamModel.Predict(input.slices(steps / 2, steps - 1), secondResults);
+
+  CheckMatrices(firstResults, arma::cube(results.slices(0, steps / 2 - 1)));
+  CheckMatrices(secondResults, arma::cube(results.slices(steps / 2,
+      steps - 1)));
+
+  // Without the carried state, the second part starts from zero.
+  streamModel.ResetState();
+  streamModel.Predict(input.slices(steps / 2, steps - 1), secondResults);
+  const arma::cube secondFullResults = results.slices(steps / 2, steps - 1);
+  REQUIRE(arma::abs(secondResults - secondFullResults).max() > 1e-5);
+
+  // The state is held for each sequence, so all of them must be given at
+  // once.
+  REQUIRE_THROWS_AS(streamModel.Predict(input.slices(0, steps / 2 - 1),
+      firstResults, 2), std::logic_error);
+}
+
+/**
+ * Test that the state of LSTM is carried over between the parts of a
+ * sequence.
+ */
+TEST_CASE("LSTMCarryStatePredictTest", "[RecurrentNetworkTest]")
+{
+  CarryStatePredictTest<LSTM<> >();
+}
+
+/**
+ * Test that the state of FusedLSTM is carried over between the parts of a
+ * sequence.
+ */
+TEST_CASE("FusedLSTMCarryStatePredictTest", "[RecurrentNetworkTest]")
+{
+  CarryStatePredictTest<FusedLSTM<> >();
+}
+
+/**
+ * Train an LSTM to predict the next value of long sine waves that are given to
+ * RNN::TrainChunk() in parts, with truncated BPTT.
+ */
+TEST_CASE("RNNTrainChunkTest", "[RecurrentNetworkTest]")
+{
+  const size_t rho = 10;
+  const size_t sequences = 4;
+  const size_t length = 200;
+  const size_t chunkSize = 50;
+
+  arma::cube predictors(1, sequences, length);
+  arma::cube responses(1, sequences, length);
+  for (size_t i = 0; i < sequences; ++i)
+  {
+    for (size_t t = 0; t < length; ++t)
+    {
+      predictors(0, i, t) = std::sin(0.2 * t + i);
+      responses(0, i, t) = std::sin(0.2 * (t + 1) + i);
+    }
+  }
+
+  RNN<MeanSquaredError<> > model(rho);
+  model.Add<IdentityLayer<> >();
+  model.Add<LSTM<> >(1, 8, rho);
+  model.Add<Linear<> >(8, 1);
+
+  // One step for each window of rho steps, keeping the state of the optimizer.
+  ens::Adam opt(0.01, sequences, 0.9, 0.999, 1e-8, sequences, -1, false,
+      false);
+
+  double firstObjective = 0.0, lastObjective = 0.0;
+  for (size_t epoch = 0; epoch < 20; ++epoch)
+  {
+    model.ResetState();
+    double objective = 0.0;
+    for (size_t t = 0; t < length; t += chunkSize)
+    {
+      objective += model.TrainChunk(
+          predictors.slices(t, t + chunkSize - 1),
+          responses.slices(t, t + chunkSize - 1), opt);
+    }
+
+    REQUIRE(std::isfinite(objective));
+    if (epoch == 0)
+      firstObjective = objective;
+    lastObjective = objective;
+  }
+
+  REQUIRE(model.CarryState() == true);
+  REQUIRE(lastObjective < 0.5 * firstObjective);
+}
+
+/**
+ * Predict sequences of different lengths in batches, and make sure that the
+ * results are the same as when each sequence is predicted alone, and zero
+ * after the end of each sequence.
+ */
+template<typename RecurrentLayerType>
+void VariableLengthPredictTest()
+{
+  const size_t maxLength = 12;
+  const size_t sequences = 7;
+
+  // The padding after the end of each sequence is noise, which must not
+  // change the results.
+  arma::cube input(3, sequences, maxLength, arma::fill::randn);
+  arma::Row<size_t> lengths(sequences);
+  for (size_t i = 0; i < sequences; ++i)
+    lengths[i] = math::RandInt(1, maxLength + 1);
+  lengths[2] = maxLength;
+
+  RNN<MeanSquaredError<> > model(maxLength);
+  model.Add<IdentityLayer<> >();
+  model.Add<RecurrentLayerType>(3, 4, maxLength);
+  model.Add<Linear<> >(4, 2);
+  model.ResetParameters();
+
+  arma::cube results;
+  model.Predict(input, results, lengths, 3);
+  REQUIRE(results.n_rows == 2);
+  REQUIRE(results.n_cols == sequences);
+  REQUIRE(results.n_slices == maxLength);
+
+  for (size_t i = 0; i < sequences; ++i)
+  {
+    model.Rho() = lengths[i];
+    arma::cube sequenceResults;
+    model.Predict(arma::cube(input.subcube(0, i, 0, 2, i, lengths[i] - 1)),
+        sequenceResults);
+
+    for (size_t t = 0; t < maxLength; ++t)
+    {
+      if (t < lengths[i])
+      {
+        CheckMatrices(arma::mat(results.slice(t).col(i)),
+            arma::mat(sequenceResults.slice(t).col(0)));
+      }
+      else
+      {
+        REQUIRE(arma::accu(arma::abs(results.slice(t).col(i))) == 0.0);
+      }
+    }
+  }
+
+  // Only the response to the last step of each sequence is kept by a network
+  // that predicts only the last element.
+  RNN<MeanSquaredError<> > singleModel(maxLength, true);
+  singleModel.Add<IdentityLayer<> >();
+  singleModel.Add<RecurrentLayerType>(3, 4, maxLength);
+  singleModel.Add<Linear<> >(4, 2);
+  singleModel.ResetParameters();
+  singleModel.Parameters() = model.Parameters();
+
+  arma::cube lastResults;
+  singleModel.Predict(input, lastResults, lengths, 3);
+  REQUIRE(lastResults.n_slices == 1);
+  for (size_t i = 0; i < sequences; ++i)
+  {
+    CheckMatrices(arma::mat(lastResults.slice(0).col(i)),
+        arma::mat(results.slice(lengths[i] - 1).col(i)));
+  }
+
+  // The lengths must match the predictors.
+  lengths[0] = maxLength + 1;
+  REQUIRE_THROWS_AS(model.Predict(input, results, lengths),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(model.Predict(input, results, lengths.head(3)),
+      std::invalid_argument);
+}
+
+/**
+ * Test the prediction of sequences of different lengths with LSTM.
+ */
+TEST_CASE("LSTMVariableLengthPredictTest", "[RecurrentNetworkTest]")
+{
+  VariableLengthPredictTest<LSTM<> >();
+}
+
+/**
+ * Test the prediction of sequences of different lengths with GRU.
+ */
+TEST_CASE("GRUVariableLengthPredictTest", "[RecurrentNetworkTest]")
+{
+  VariableLengthPredictTest<GRU<> >();
+}
+
+/**
+ * Predict sequences of different lengths with a BRNN, and make sure that the
+ * results are the same as when each sequence is predicted alone (so that the
+ * padding does not change the state of the backward network), and the same as
+ * the results of Predict() for sequences of the same length.
+ */
+TEST_CASE("BRNNVariableLengthPredictTest", "[RecurrentNetworkTest]")
+{
+  const size_t maxLength = 8;
+  const size_t sequences = 5;
+
+  arma::cube input(3, sequences, maxLength, arma::fill::randn);
+  // The outputs of both directions are concatenated.
+  arma::cube responses(4, sequences, maxLength, arma::fill::randu);
+  arma::Row<size_t> lengths(sequences);
+  for (size_t i = 0; i < sequences; ++i)
+    lengths[i] = math::RandInt(1, maxLength + 1);
+
+  BRNN<MeanSquaredError<>, Concat<>, IdentityLayer<> > model(maxLength);
+  model.Add<IdentityLayer<> >();
+  model.Add<LSTM<> >(3, 4, maxLength);
+  model.Add<Linear<> >(4, 2);
+
+  // A short training sets up the output size used by the other Predict().
+  StandardSGD opt(0.01, 1, sequences, -100);
+  model.Train(input, responses, opt);
+
+  arma::cube results;
+  model.Predict(input, results, lengths, 2);
+  REQUIRE(results.n_rows == 4);
+  REQUIRE(results.n_slices == maxLength);
+
+  for (size_t i = 0; i < sequences; ++i)
+  {
+    arma::cube sequenceResults;
+    arma::Row<size_t> length(1);
+    length[0] = lengths[i];
+    model.Predict(arma::cube(input.subcube(0, i, 0, 2, i, lengths[i] - 1)),
+        sequenceResults, length);
+
+    for (size_t t = 0; t < maxLength; ++t)
+    {
+      if (t < lengths[i])
+      {
+        CheckMatrices(arma::mat(results.slice(t).col(i)),
+            arma::mat(sequenceResults.slice(t).col(0)));
+      }
+      else
+      {
+        REQUIRE(arma::accu(arma::abs(results.slice(t).col(i))) == 0.0);
+      }
+    }
+  }
+
+  // With sequences of the same length, the results are those of Predict().
+  arma::cube fullResults, fixedResults;
+  lengths.fill(maxLength);
+  model.Predict(input, fullResults, lengths);
+  model.Predict(input, fixedResults);
+  CheckMatrices(fullResults, fixedResults);
+}
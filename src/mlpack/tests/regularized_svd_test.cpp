@@ -249,6 +249,89 @@ TEST_CASE("RegularizedSVDFunctionOptimize", "[RegularizedSVDTest]")
   REQUIRE(relativeError == Approx(0.0).margin(1e-2));
 }
 
+/**
+ * Make sure that RatingBlocks visits every rating once, and that the blocks of
+ * each stratum share no users and no items.
+ */
+TEST_CASE("RatingBlocksVisitTest", "[RegularizedSVDTest]")
+{
+  const size_t numUsers = 37;
+  const size_t numItems = 23;
+  const size_t numRatings = 2000;
+
+  arma::mat data = arma::randu(3, numRatings);
+  data.row(0) = floor(data.row(0) * numUsers);
+  data.row(1) = floor(data.row(1) * numItems);
+
+  RatingBlocks blocks(data, numUsers, numItems, 4);
+  REQUIRE(blocks.NumBlocks() == 4);
+  blocks.Shuffle();
+
+  // The ratings of a stratum are visited by several threads at once, but each
+  // rating is visited by one thread only.
+  arma::Col<size_t> visits(numRatings, arma::fill::zeros);
+  blocks.Visit([&](const size_t i) { ++visits[i]; });
+
+  for (size_t i = 0; i < numRatings; ++i)
+    REQUIRE(visits[i] == 1);
+}
+
+/**
+ * Make sure the block-parallel SGD specialization for Regularized SVD (with an
+ * exponential backoff step size) converges like serial SGD.
+ */
+TEST_CASE("RegularizedSVDFunctionOptimizeBlockParallel", "[RegularizedSVDTest]")
+{
+  // Define useful constants.
+  const size_t numUsers = 50;
+  const size_t numItems = 50;
+  const size_t numRatings = 100;
+  const size_t rank = 10;
+  const double alpha = 0.01;
+  const double lambda = 0.01;
+
+  // Initiate random parameters.
+  arma::mat parameters = arma::randu(rank, numUsers + numItems);
+
+  // Make a random rating dataset.
+  arma::mat data = arma::randu(3, numRatings);
+  data.row(0) = floor(data.row(0) * numUsers);
+  data.row(1) = floor(data.row(1) * numItems);
+
+  // Manually set last row to maximum user and maximum item.
+  data(0, numRatings - 1) = numUsers - 1;
+  data(1, numRatings - 1) = numItems - 1;
+
+  // Make rating entries based on the parameters.
+  for (size_t i = 0; i < numRatings; ++i)
+  {
+    data(2, i) = arma::dot(parameters.col(data(0, i)),
+                           parameters.col(numUsers + data(1, i)));
+  }
+
+  RegularizedSVDFunction<arma::mat> rSVDFunc(data, rank, lambda);
+
+  // The step size stays constant for the first 10000 epochs.
+  ExponentialBackoff decayPolicy(10000, alpha, 0.5);
+  ParallelSGD<ExponentialBackoff> optimizer(0, numRatings, 1e-5, true,
+      decayPolicy);
+
+  arma::mat optParameters = arma::randu(rank, numUsers + numItems);
+  optimizer.Optimize(rSVDFunc, optParameters);
+
+  arma::mat predictedData(1, numRatings);
+  for (size_t i = 0; i < numRatings; ++i)
+  {
+    predictedData(0, i) = arma::dot(optParameters.col(data(0, i)),
+                                    optParameters.col(numUsers + data(1, i)));
+  }
+
+  const double relativeError = arma::norm(data.row(2) - predictedData, "frob") /
+                               arma::norm(data, "frob");
+
+  REQUIRE(relativeError == Approx(0.0).margin(1e-2));
+}
+
 // The test is only compiled if the user has specified OpenMP to be
 // used.
 #ifdef HAS_OPENMP
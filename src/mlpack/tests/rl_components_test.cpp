@@ -20,8 +20,10 @@
 #include <mlpack/methods/reinforcement_learning/environment/continuous_double_pole_cart.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/acrobot.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/pendulum.hpp>
+#include <mlpack/methods/reinforcement_learning/environment/vector_environment.hpp>
 #include <mlpack/methods/reinforcement_learning/replay/random_replay.hpp>
 #include <mlpack/methods/reinforcement_learning/policy/greedy_policy.hpp>
+#include <mlpack/methods/reinforcement_learning/policy/aggregated_policy.hpp>
 
 #include "catch.hpp"
 #include "test_catch_tools.hpp"
@@ -170,6 +172,58 @@ TEST_CASE("SimpleCartPoleTest", "[RLComponentsTest]")
   REQUIRE(2 == static_cast<size_t>(CartPole::Action::size));
 }
 
+/**
+ * Step several CartPole instances in lockstep and make sure their episodes
+ * are restarted when they end.
+ */
+TEST_CASE("VectorEnvironmentTest", "[RLComponentsTest]")
+{
+  CartPole task;
+  task.MaxSteps() = 5;
+  VectorEnvironment<CartPole> environments(4, task);
+  REQUIRE(environments.NumEnvironments() == 4);
+  REQUIRE(environments.EncodedStates().n_rows == CartPole::State::dimension);
+  REQUIRE(environments.EncodedStates().n_cols == 4);
+
+  std::vector<CartPole::Action> actions(4);
+  for (size_t i = 0; i < 4; ++i)
+    actions[i].action = CartPole::Action::actions::backward;
+
+  std::vector<CartPole::State> previousStates, nextStates;
+  arma::rowvec rewards;
+  std::vector<bool> terminal;
+  for (size_t step = 0; step < 12; ++step)
+  {
+    const std::vector<CartPole::State> states = environments.States();
+    environments.Step(actions, previousStates, rewards, nextStates, terminal);
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+      CheckMatrices(previousStates[i].Encode(), states[i].Encode());
+      REQUIRE(rewards[i] == 1.0);
+      // Each episode ends after 5 steps.
+      REQUIRE(terminal[i] == (step % 5 == 4));
+      CheckMatrices(environments.EncodedStates().col(i),
+          environments.States()[i].Encode());
+    }
+  }
+
+  // Each environment finished two episodes of 5 steps.
+  REQUIRE(environments.FinishedReturns().size() == 8);
+  for (size_t i = 0; i < 8; ++i)
+    REQUIRE(environments.FinishedReturns()[i] == 5.0);
+
+  // Episodes can also be cut after a given number of steps.
+  environments.Reset();
+  environments.Step(actions, previousStates, rewards, nextStates, terminal, 1);
+  REQUIRE(environments.FinishedReturns().size() == 4);
+  REQUIRE(!terminal[0]);
+
+  actions.pop_back();
+  REQUIRE_THROWS_AS(environments.Step(actions, previousStates, rewards,
+      nextStates, terminal), std::invalid_argument);
+}
+
 /**
  * Constructs a DoublePoleCart instance and check if the main routine works as
  * it should be.
@@ -271,6 +325,54 @@ TEST_CASE("RandomReplayTest", "[RLComponentsTest]")
   }
 }
 
+/**
+ * Store transitions from several threads in a RandomReplay with float storage,
+ * and make sure that every sampled transition is one that was stored.
+ */
+TEST_CASE("RandomReplayConcurrentInsertTest", "[RLComponentsTest]")
+{
+  const size_t numTransitions = 2000;
+  RandomReplay<MountainCar, float> replay(32, 500);
+
+  MountainCar::Action action;
+  action.action = MountainCar::Action::actions::forward;
+
+  // The velocity of each state identifies its transition.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numTransitions; ++i)
+  {
+    MountainCar::State state(arma::colvec({ -0.5, (double) i }));
+    MountainCar::State nextState(arma::colvec({ -0.4, (double) i }));
+    replay.Insert(state, action, (double) i, nextState, (i % 2 == 0));
+  }
+
+  REQUIRE(replay.Size() == 500);
+
+  arma::mat sampledState;
+  std::vector<MountainCar::Action> sampledAction;
+  arma::rowvec sampledReward;
+  arma::mat sampledNextState;
+  arma::irowvec sampledTerminal;
+  for (size_t trial = 0; trial < 10; ++trial)
+  {
+    replay.Sample(sampledState, sampledAction, sampledReward,
+        sampledNextState, sampledTerminal);
+
+    REQUIRE(sampledState.n_cols == 32);
+    REQUIRE(sampledAction.size() == 32);
+    for (size_t i = 0; i < 32; ++i)
+    {
+      const size_t id = (size_t) sampledReward[i];
+      REQUIRE(id < numTransitions);
+      REQUIRE(sampledState(0, i) == Approx(-0.5).epsilon(1e-5));
+      REQUIRE(sampledState(1, i) == Approx((double) id).epsilon(1e-5));
+      REQUIRE(sampledNextState(0, i) == Approx(-0.4).epsilon(1e-5));
+      REQUIRE(sampledNextState(1, i) == Approx((double) id).epsilon(1e-5));
+      REQUIRE(sampledTerminal[i] == (id % 2 == 0 ? 1 : 0));
+    }
+  }
+}
+
 /**
  * Construct a greedy policy instance and check if it works as
  * it should be.
@@ -286,3 +388,44 @@ TEST_CASE("GreedyPolicyTest", "[RLComponentsTest]")
   REQUIRE(actionValue[action.action] ==
       Approx(actionValue.max()).epsilon(1e-7));
 }
+
+/**
+ * Sample a batch of actions with greedy and aggregated policies, and check
+ * that greedy policies select the best actions and exploring ones do not.
+ */
+TEST_CASE("GreedyPolicyBatchTest", "[RLComponentsTest]")
+{
+  const size_t numActions = MountainCar::Action::size;
+  arma::mat actionValues = arma::randn<arma::mat>(numActions, 1000);
+  const arma::urowvec bestActions = arma::index_max(actionValues, 0);
+
+  // With epsilon equal to 0, the batch is sampled greedily.
+  GreedyPolicy<MountainCar> greedy(0.0, 10, 0.0);
+  std::vector<MountainCar::Action> actions;
+  greedy.Sample(actionValues, actions);
+  REQUIRE(actions.size() == 1000);
+  for (size_t i = 0; i < actions.size(); ++i)
+    REQUIRE((size_t) actions[i].action == bestActions[i]);
+
+  // With epsilon equal to 1, about 1 / numActions of the actions are the best
+  // ones, unless the sampling is deterministic.
+  GreedyPolicy<MountainCar> explorer(1.0, 10, 1.0);
+  explorer.Sample(actionValues, actions);
+  size_t numBest = 0;
+  for (size_t i = 0; i < actions.size(); ++i)
+    numBest += ((size_t) actions[i].action == bestActions[i]);
+  REQUIRE(numBest > 200);
+  REQUIRE(numBest < 470);
+
+  explorer.Sample(actionValues, actions, true);
+  for (size_t i = 0; i < actions.size(); ++i)
+    REQUIRE((size_t) actions[i].action == bestActions[i]);
+
+  // An aggregated policy that always picks the greedy child is greedy too.
+  AggregatedPolicy<GreedyPolicy<MountainCar>> aggregated({explorer, greedy},
+      arma::colvec({0.0, 1.0}));
+  aggregated.Sample(actionValues, actions);
+  REQUIRE(actions.size() == 1000);
+  for (size_t i = 0; i < actions.size(); ++i)
+    REQUIRE((size_t) actions[i].action == bestActions[i]);
+}
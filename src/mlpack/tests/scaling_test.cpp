@@ -15,7 +15,10 @@
 #include <mlpack/core/data/scaler_methods/max_abs_scaler.hpp>
 #include <mlpack/core/data/scaler_methods/standard_scaler.hpp>
 #include <mlpack/core/data/scaler_methods/mean_normalization.hpp>
+#include <mlpack/core/data/feature_statistics.hpp>
+#include <mlpack/core/data/pipeline.hpp>
 
+#include "serialization.hpp"
 #include "test_catch_tools.hpp"
 #include "catch.hpp"
 
@@ -172,3 +175,253 @@ TEST_CASE("ZCAWhiteningTest", "[ScalingTest]")
   scale.InverseTransform(output, temp);
   CheckMatrices(dataset, temp);
 }
+
+/**
+ * Make sure that FeatureStatistics computes the same statistics as Armadillo,
+ * whether the points are given at once or in chunks.
+ */
+TEST_CASE("FeatureStatisticsTest", "[ScalingTest]")
+{
+  arma::mat points = arma::randn<arma::mat>(3, 20000);
+  points.row(1) = arma::exp(points.row(1));
+  points.row(2).fill(4.0);
+
+  data::FeatureStatistics statistics;
+  statistics.Update(points);
+
+  data::FeatureStatistics chunked;
+  for (size_t i = 0; i < points.n_cols; i += 777)
+  {
+    const size_t last = std::min(i + 776, (size_t) points.n_cols - 1);
+    chunked.Update(points.cols(i, last));
+  }
+
+  REQUIRE(statistics.Count() == points.n_cols);
+  REQUIRE(chunked.Count() == points.n_cols);
+  for (size_t d = 0; d < points.n_rows; ++d)
+  {
+    const arma::rowvec row = points.row(d);
+    REQUIRE(statistics.Mean()[d] == Approx(arma::mean(row)).epsilon(1e-10));
+    REQUIRE(chunked.Mean()[d] == Approx(arma::mean(row)).epsilon(1e-10));
+    REQUIRE(statistics.Variance()[d] ==
+        Approx(arma::var(row)).epsilon(1e-10).margin(1e-12));
+    REQUIRE(chunked.Variance(true)[d] ==
+        Approx(arma::var(row, 1)).epsilon(1e-10).margin(1e-12));
+    REQUIRE(statistics.Min()[d] == arma::min(row));
+    REQUIRE(chunked.Max()[d] == arma::max(row));
+  }
+
+  // Compare the higher moments with a direct computation.
+  const arma::rowvec row = points.row(1);
+  const double mean = arma::mean(row);
+  const double m2 = arma::accu(arma::pow(row - mean, 2));
+  const double m3 = arma::accu(arma::pow(row - mean, 3));
+  const double m4 = arma::accu(arma::pow(row - mean, 4));
+  const double n = row.n_elem;
+  REQUIRE(chunked.Skewness(true)[1] ==
+      Approx(m3 / (n * std::pow(m2 / n, 1.5))).epsilon(1e-8));
+  REQUIRE(chunked.Kurtosis(true)[1] ==
+      Approx(n * m4 / (m2 * m2) - 3).epsilon(1e-8));
+
+  // A constant dimension has no variance at all.
+  REQUIRE(chunked.Variance()[2] == 0.0);
+}
+
+/**
+ * Make sure that QuantileSketch is exact for small streams, and accurate for
+ * large and merged streams.
+ */
+TEST_CASE("QuantileSketchTest", "[ScalingTest]")
+{
+  arma::rowvec small = arma::randu<arma::rowvec>(151);
+  data::QuantileSketch exact(200);
+  for (size_t i = 0; i < small.n_elem; ++i)
+    exact.Insert(small[i]);
+  REQUIRE(exact.Quantile(0.5) == Approx(arma::median(small)).epsilon(1e-12));
+  REQUIRE(exact.Quantile(0.0) == arma::min(small));
+  REQUIRE(exact.Quantile(1.0) == arma::max(small));
+
+  arma::rowvec large = arma::randu<arma::rowvec>(100000);
+  data::FeatureStatistics statistics(200);
+  statistics.Update(large.cols(0, 49999));
+  data::FeatureStatistics other(200);
+  other.Update(large.cols(50000, 99999));
+  statistics.Merge(other);
+
+  // The rank error should be small.
+  const arma::rowvec sorted = arma::sort(large);
+  for (const double q : { 0.1, 0.5, 0.9 })
+  {
+    const double value = statistics.Quantile(0, q);
+    const double rank = (double) arma::accu(sorted <= value) / large.n_elem;
+    REQUIRE(rank == Approx(q).margin(0.02));
+  }
+
+  REQUIRE_THROWS_AS(data::FeatureStatistics().Quantile(0, 0.5),
+      std::logic_error);
+}
+
+/**
+ * Make sure that scalers fit from chunked statistics are the same as scalers
+ * fit on the whole dataset.
+ */
+TEST_CASE("ScalerFitFromStatisticsTest", "[ScalingTest]")
+{
+  arma::mat points = arma::randu<arma::mat>(4, 1000);
+
+  data::FeatureStatistics statistics;
+  statistics.Update(points.cols(0, 299));
+  statistics.Update(points.cols(300, 999));
+
+  data::StandardScaler standard, standardChunked;
+  standard.Fit(points);
+  standardChunked.Fit(statistics);
+  CheckMatrices(standard.ItemMean(), standardChunked.ItemMean());
+  CheckMatrices(standard.ItemStdDev(), standardChunked.ItemStdDev());
+
+  data::MinMaxScaler minMax, minMaxChunked;
+  minMax.Fit(points);
+  minMaxChunked.Fit(statistics);
+  CheckMatrices(minMax.ItemMin(), minMaxChunked.ItemMin());
+  CheckMatrices(minMax.ItemMax(), minMaxChunked.ItemMax());
+
+  // The original definitions.
+  CheckMatrices(standard.ItemStdDev(), arma::vec(arma::stddev(points, 1, 1)));
+  CheckMatrices(minMax.ItemMin(), arma::vec(arma::min(points, 1)));
+}
+
+/**
+ * Check that transforming the given dataset in place with the given (fitted)
+ * scaler gives the same result as transforming it into another matrix, and
+ * that the in-place inverse transform recovers the dataset.
+ */
+template<typename ScalerType>
+void CheckInPlaceTransform(ScalerType& scaler, const arma::mat& points)
+{
+  arma::mat scaled, recovered;
+  scaler.Transform(points, scaled);
+  scaler.InverseTransform(scaled, recovered);
+
+  arma::mat inPlace(points);
+  scaler.Transform(inPlace);
+  CheckMatrices(inPlace, scaled);
+
+  scaler.InverseTransform(inPlace);
+  CheckMatrices(inPlace, recovered);
+  CheckMatrices(inPlace, points, 1e-5);
+}
+
+/**
+ * Make sure that the in-place transforms of all the scalers match the
+ * out-of-place ones, including the whitening transforms, which work on more
+ * than one block of points here.
+ */
+TEST_CASE("InPlaceTransformTest", "[ScalingTest]")
+{
+  arma::mat points(5, 10000, arma::fill::randn);
+  points.row(1) *= 10.0;
+  points.row(3) += 4.0;
+  points.row(4) = 0.5 * points.row(0) + 0.1 * points.row(4);
+
+  data::MinMaxScaler minMax;
+  minMax.Fit(points);
+  CheckInPlaceTransform(minMax, points);
+
+  data::MaxAbsScaler maxAbs;
+  maxAbs.Fit(points);
+  CheckInPlaceTransform(maxAbs, points);
+
+  data::StandardScaler standard;
+  standard.Fit(points);
+  CheckInPlaceTransform(standard, points);
+
+  data::MeanNormalization meanNormalization;
+  meanNormalization.Fit(points);
+  CheckInPlaceTransform(meanNormalization, points);
+
+  data::PCAWhitening pca;
+  pca.Fit(points);
+  CheckInPlaceTransform(pca, points);
+
+  data::ZCAWhitening zca;
+  zca.Fit(points);
+  CheckInPlaceTransform(zca, points);
+
+  // The whitened points should have an identity covariance (up to the
+  // regularization of the eigenvalues).
+  arma::mat whitened(points);
+  zca.Transform(whitened);
+  const arma::mat covariance = arma::cov(whitened.t());
+  REQUIRE(arma::approx_equal(covariance, arma::eye<arma::mat>(5, 5), "absdiff",
+      1e-2));
+}
+
+/**
+ * Make sure that Pipeline gives the same result as imputing, scaling and
+ * one-hot encoding the dataset one step at a time.
+ */
+TEST_CASE("PipelineTest", "[ScalingTest]")
+{
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  arma::mat input(4, 1000, arma::fill::randu);
+  // Dimension 1 is categorical, with categories 3, 5 and 7.
+  for (size_t i = 0; i < input.n_cols; ++i)
+    input(1, i) = 3 + 2 * (i % 3);
+  for (size_t i = 0; i < input.n_cols; i += 11)
+    input(i % 2 == 0 ? 0 : 3, i) = nan;
+
+  Pipeline<MinMaxScaler> pipeline(std::vector<size_t>({ 1 }));
+  pipeline.Fit(input);
+  arma::mat output;
+  pipeline.Transform(input, output, 100);
+  REQUIRE(pipeline.OutputDimensionality() == 6);
+  REQUIRE(output.n_rows == 6);
+  REQUIRE(output.n_cols == 1000);
+
+  // Impute, scale and encode separately.
+  arma::mat numeric = input.rows(arma::uvec({ 0, 2, 3 }));
+  for (size_t d = 0; d < numeric.n_rows; ++d)
+  {
+    arma::rowvec row = numeric.row(d);
+    const double mean = arma::mean(row.elem(arma::find_finite(row)));
+    row.replace(nan, mean);
+    numeric.row(d) = row;
+    REQUIRE(pipeline.ImputedValues()[d] == Approx(mean).epsilon(1e-10));
+  }
+  MinMaxScaler scaler;
+  scaler.Fit(numeric);
+  scaler.Transform(numeric);
+
+  arma::mat expected(6, 1000, arma::fill::zeros);
+  expected.row(0) = numeric.row(0);
+  expected.rows(4, 5) = numeric.rows(1, 2);
+  for (size_t i = 0; i < input.n_cols; ++i)
+    expected(1 + i % 3, i) = 1.0;
+
+  CheckMatrices(output, expected);
+
+  // An unseen category is encoded as all zeros.
+  arma::mat test = input.cols(0, 9);
+  test(1, 0) = 4;
+  arma::mat testOutput;
+  pipeline.Transform(test, testOutput);
+  REQUIRE(arma::accu(testOutput.submat(1, 0, 3, 0)) == 0.0);
+
+  // Transforming in place gives the same result.
+  arma::mat inPlace = input;
+  pipeline.Transform(inPlace, inPlace, 100);
+  CheckMatrices(inPlace, expected);
+
+  // The pipeline can be serialized.
+  Pipeline<MinMaxScaler> xmlPipeline, jsonPipeline, binaryPipeline;
+  SerializeObjectAll(pipeline, xmlPipeline, jsonPipeline, binaryPipeline);
+  arma::mat xmlOutput, jsonOutput, binaryOutput;
+  xmlPipeline.Transform(input, xmlOutput);
+  jsonPipeline.Transform(input, jsonOutput);
+  binaryPipeline.Transform(input, binaryOutput);
+  CheckMatrices(output, xmlOutput, jsonOutput, binaryOutput);
+
+  // The categorical dimensions must exist.
+  Pipeline<> badPipeline(std::vector<size_t>({ 4 }));
+  REQUIRE_THROWS_AS(badPipeline.Fit(input), std::invalid_argument);
+}
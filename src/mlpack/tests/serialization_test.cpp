@@ -31,6 +31,7 @@
 #include <mlpack/methods/perceptron/perceptron.hpp>
 #include <mlpack/methods/logistic_regression/logistic_regression.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/neighbor_search/ns_model.hpp>
 #include <mlpack/methods/softmax_regression/softmax_regression.hpp>
 #include <mlpack/methods/det/dtree.hpp>
 #include <mlpack/methods/naive_bayes/naive_bayes_classifier.hpp>
@@ -654,6 +655,41 @@ TEST_CASE("KNNTest", "[SerializationTest]")
   CheckMatrices(neighbors, xmlNeighbors, jsonNeighbors, binaryNeighbors);
 }
 
+TEST_CASE("KNNFloatModelTest", "[SerializationTest]")
+{
+  using neighbor::NSModel;
+  using neighbor::NearestNeighborSort;
+  arma::fmat dataset = arma::randu<arma::fmat>(5, 2000);
+
+  util::Timers timers;
+  NSModel<NearestNeighborSort, arma::fmat> knn;
+  knn.BuildModel(timers, std::move(dataset), DUAL_TREE_MODE);
+
+  NSModel<NearestNeighborSort, arma::fmat> knnXml, knnText, knnBinary;
+
+  SerializeObjectAll(knn, knnXml, knnText, knnBinary);
+
+  // Now run nearest neighbor and make sure the results are the same.
+  arma::fmat querySet = arma::randu<arma::fmat>(5, 1000);
+
+  arma::mat distances, xmlDistances, jsonDistances, binaryDistances;
+  arma::Mat<size_t> neighbors, xmlNeighbors, jsonNeighbors, binaryNeighbors;
+
+  arma::fmat queryCopy(querySet);
+  knn.Search(timers, std::move(queryCopy), 5, neighbors, distances);
+  queryCopy = querySet;
+  knnXml.Search(timers, std::move(queryCopy), 5, xmlNeighbors, xmlDistances);
+  queryCopy = querySet;
+  knnText.Search(timers, std::move(queryCopy), 5, jsonNeighbors,
+      jsonDistances);
+  queryCopy = querySet;
+  knnBinary.Search(timers, std::move(queryCopy), 5, binaryNeighbors,
+      binaryDistances);
+
+  CheckMatrices(distances, xmlDistances, jsonDistances, binaryDistances);
+  CheckMatrices(neighbors, xmlNeighbors, jsonNeighbors, binaryNeighbors);
+}
+
 TEST_CASE("SoftmaxRegressionTest", "[SerializationTest]")
 {
   using regression::SoftmaxRegression;
@@ -1073,16 +1109,10 @@ TEST_CASE("LSHTest", "[SerializationTest]")
   REQUIRE(lsh.BucketSize() == jsonLsh.BucketSize());
   REQUIRE(lsh.BucketSize() == binaryLsh.BucketSize());
 
-  REQUIRE(lsh.SecondHashTable().size() ==
-      xmlLsh.SecondHashTable().size());
-  REQUIRE(lsh.SecondHashTable().size() ==
-      jsonLsh.SecondHashTable().size());
-  REQUIRE(lsh.SecondHashTable().size() ==
-      binaryLsh.SecondHashTable().size());
-
-  for (size_t i = 0; i < lsh.SecondHashTable().size(); ++i)
-  CheckMatrices(lsh.SecondHashTable()[i], xmlLsh.SecondHashTable()[i],
-      jsonLsh.SecondHashTable()[i], binaryLsh.SecondHashTable()[i]);
+  CheckMatrices(lsh.BucketContents(), xmlLsh.BucketContents(),
+      jsonLsh.BucketContents(), binaryLsh.BucketContents());
+  CheckMatrices(lsh.BucketOffsets(), xmlLsh.BucketOffsets(),
+      jsonLsh.BucketOffsets(), binaryLsh.BucketOffsets());
 }
 
 // Make sure serialization works for LARS.
@@ -1654,3 +1684,83 @@ TEST_CASE("CerealEmptyArrayWrapperTest", "[SerializationTest]")
   REQUIRE(jsonT.mem == (int*) NULL);
   REQUIRE(jsonT.len == 0);
 }
+
+/**
+ * Save a model with matrices in the mapped format, and make sure that it is
+ * the same after loading it both by copying and by mapping.
+ */
+TEST_CASE("MappedModelSerializeTest", "[SerializationTest]")
+{
+  arma::mat data;
+  data.randu(3, 100);
+  arma::Row<size_t> responses;
+  responses.randu(100);
+  responses.transform([](size_t val) { return val % 2; });
+
+  LogisticRegression<> lr(data, responses, 0.5);
+  REQUIRE(data::Save("lr.mlmodel", "lr", lr, true));
+
+  LogisticRegression<> lrCopy(3, 0.0);
+  REQUIRE(data::Load("lr.mlmodel", "lr", lrCopy, true));
+  REQUIRE(lrCopy.Parameters().n_elem == lr.Parameters().n_elem);
+  for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+    REQUIRE(lrCopy.Parameters()[i] == lr.Parameters()[i]);
+  REQUIRE(lrCopy.Lambda() == lr.Lambda());
+
+  {
+    data::MappedModel<LogisticRegression<>> mapped("lr.mlmodel", "lr");
+    const arma::rowvec& parameters = mapped.Model().Parameters();
+    REQUIRE(parameters.n_rows == 1);
+    REQUIRE(parameters.n_elem == lr.Parameters().n_elem);
+    for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+      REQUIRE(parameters[i] == lr.Parameters()[i]);
+    // The parameters live in the mapped file.
+    REQUIRE(parameters.mem_state == 2);
+
+    arma::Row<size_t> predictions, mappedPredictions;
+    lr.Classify(data, predictions);
+    mapped.Model().Classify(data, mappedPredictions);
+    for (size_t i = 0; i < predictions.n_elem; ++i)
+      REQUIRE(predictions[i] == mappedPredictions[i]);
+  }
+
+  // A model with a tree and its dataset goes through the same archive.
+  using neighbor::KNN;
+  arma::mat dataset = arma::randu<arma::mat>(5, 2000);
+  KNN knn(dataset, DUAL_TREE_MODE);
+  REQUIRE(data::Save("knn.mlmodel", "knn", knn, true));
+  KNN knnMapped;
+  REQUIRE(data::Load("knn.mlmodel", "knn", knnMapped, true));
+
+  arma::mat querySet = arma::randu<arma::mat>(5, 100);
+  arma::mat distances, mappedDistances;
+  arma::Mat<size_t> neighbors, mappedNeighbors;
+  knn.Search(querySet, 5, neighbors, distances);
+  knnMapped.Search(querySet, 5, mappedNeighbors, mappedDistances);
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    REQUIRE(neighbors[i] == mappedNeighbors[i]);
+    REQUIRE(distances[i] == Approx(mappedDistances[i]).epsilon(1e-10));
+  }
+
+  // The same format can be written to and read from memory.
+  std::ostringstream oss(std::ios::binary);
+  data::SaveMappedModel(oss, "lr", lr);
+  const std::string buffer = oss.str();
+  LogisticRegression<> lrMemory(3, 0.0);
+  data::LoadMappedModel(buffer.data(), buffer.size(), "lr", lrMemory, false);
+  REQUIRE(lrMemory.Parameters().n_elem == lr.Parameters().n_elem);
+  for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+    REQUIRE(lrMemory.Parameters()[i] == lr.Parameters()[i]);
+  REQUIRE_THROWS_AS(data::LoadMappedModel(buffer.data(), 32, "lr", lrMemory,
+      false), std::runtime_error);
+
+  // A file in another format is rejected.
+  REQUIRE(data::Save("lr.bin", "lr", lr, true));
+  REQUIRE(data::Load("lr.bin", "lr", lrCopy, false, data::format::mapped) ==
+      false);
+
+  remove("lr.mlmodel");
+  remove("knn.mlmodel");
+  remove("lr.bin");
+}
@@ -674,3 +674,53 @@ TEST_CASE("SoftmaxRegressionComputeProbabilitiesAndLabelsTest",
     REQUIRE(testLabels(i) == labels(i));
   }
 }
+
+/**
+ * Train softmax regression on sparse data, with and without an intercept, and
+ * make sure the results match those on the same dense data.
+ */
+TEST_CASE("SoftmaxRegressionSparseTest", "[SoftmaxRegressionTest]")
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(20, 300, 0.2);
+  arma::mat denseDataset(dataset);
+  arma::Row<size_t> labels(300);
+  for (size_t i = 0; i < 300; ++i)
+    labels[i] = math::RandInt(0, 3);
+
+  for (const bool fitIntercept : { false, true })
+  {
+    // The batch gradients of the objective functions match.
+    SoftmaxRegressionFunction srf(denseDataset, labels, 3, 0.01,
+        fitIntercept);
+    SoftmaxRegressionFunctionType<arma::sp_mat> srfSparse(dataset, labels, 3,
+        0.01, fitIntercept);
+    const arma::mat parameters = srf.GetInitialPoint();
+    arma::mat gradient, sparseGradient;
+    for (size_t begin = 0; begin < 300; begin += 50)
+    {
+      srf.Gradient(parameters, begin, gradient, 50);
+      srfSparse.Gradient(parameters, begin, sparseGradient, 50);
+      REQUIRE(arma::approx_equal(sparseGradient, gradient, "absdiff", 1e-8));
+      REQUIRE(srfSparse.Evaluate(parameters, begin, 50) ==
+          Approx(srf.Evaluate(parameters, begin, 50)).epsilon(1e-7));
+    }
+
+    // Training from the same starting point gives the same model.
+    SoftmaxRegression sr(dataset.n_rows, 3, fitIntercept);
+    SoftmaxRegression srSparse(sr);
+    sr.Train(denseDataset, labels, 3, ens::L_BFGS(10, 20));
+    srSparse.Train(dataset, labels, 3, ens::L_BFGS(10, 20));
+    REQUIRE(arma::approx_equal(srSparse.Parameters(), sr.Parameters(),
+        "absdiff", 1e-5));
+
+    arma::mat probabilities, sparseProbabilities;
+    arma::Row<size_t> predictions, sparsePredictions;
+    sr.Classify(denseDataset, predictions, probabilities);
+    srSparse.Classify(dataset, sparsePredictions, sparseProbabilities);
+    REQUIRE(arma::approx_equal(sparseProbabilities, probabilities, "absdiff",
+        1e-5));
+    REQUIRE(srSparse.ComputeAccuracy(dataset, labels) ==
+        Approx(sr.ComputeAccuracy(denseDataset, labels)));
+  }
+}
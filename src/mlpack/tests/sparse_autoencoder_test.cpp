@@ -274,3 +274,57 @@ TEST_CASE("SparseAutoencoderFunctionGradient", "[SparseAutoencoderTest]")
     }
   }
 }
+
+/**
+ * Make sure that EvaluateWithGradient() matches Evaluate() and Gradient(), and
+ * that without the KL divergence term the minibatch objectives and gradients
+ * sum to the full ones.
+ */
+TEST_CASE("SparseAutoencoderFunctionSeparableTest", "[SparseAutoencoderTest]")
+{
+  const size_t points = 100;
+  const size_t vSize = 10;
+  const size_t hSize = 5;
+
+  arma::mat data;
+  data.randu(vSize, points);
+
+  SparseAutoencoderFunction saf(data, vSize, hSize, 0.5, 0);
+  arma::mat parameters = saf.GetInitialPoint();
+
+  arma::mat gradient, fusedGradient;
+  const double objective = saf.Evaluate(parameters);
+  saf.Gradient(parameters, gradient);
+  const double fusedObjective = saf.EvaluateWithGradient(parameters,
+      fusedGradient);
+
+  REQUIRE(fusedObjective == Approx(objective).epsilon(1e-10));
+  CheckMatrices(gradient, fusedGradient);
+
+  // Sum the minibatches, of uneven sizes.
+  double batchObjective = 0.0;
+  arma::mat batchGradient(arma::size(gradient), arma::fill::zeros);
+  arma::mat g;
+  for (size_t begin = 0; begin < points; begin += 30)
+  {
+    const size_t batchSize = std::min((size_t) 30, points - begin);
+    batchObjective += saf.EvaluateWithGradient(parameters, begin, g,
+        batchSize);
+    batchGradient += g;
+    REQUIRE(saf.Evaluate(parameters, begin, batchSize) ==
+        Approx(saf.EvaluateWithGradient(parameters, begin, g, batchSize)));
+  }
+
+  REQUIRE(batchObjective == Approx(objective).epsilon(1e-10));
+  CheckMatrices(gradient, batchGradient);
+
+  // Single precision gives nearly the same objective.
+  arma::fmat fdata = arma::conv_to<arma::fmat>::from(data);
+  SparseAutoencoderFunctionType<arma::fmat> fsaf(fdata, vSize, hSize, 0.5, 0);
+  arma::fmat fgradient;
+  const double fobjective = fsaf.EvaluateWithGradient(
+      arma::conv_to<arma::fmat>::from(parameters), fgradient);
+
+  REQUIRE(fobjective == Approx(objective).epsilon(1e-4));
+  CheckMatrices(gradient, arma::conv_to<arma::mat>::from(fgradient), 1e-2);
+}
@@ -434,3 +434,96 @@ TEST_CASE("SplitLabeledDataResultField", "[SplitDataTest]")
   CheckFields(input, inputConcat);
   CheckFields(label, labelConcat);
 }
+
+/**
+ * Make sure that the index-based splits give the same split as Split() and
+ * StratifiedSplit() for the same random seed.
+ */
+TEST_CASE("SplitIndicesTest", "[SplitDataTest]")
+{
+  mat input(3, 101, fill::randu);
+  Row<size_t> labels(101);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = i % 3;
+
+  for (const bool stratify : { false, true })
+  {
+    mat trainData, testData;
+    Row<size_t> trainLabels, testLabels;
+    math::RandomSeed(7);
+    if (stratify)
+    {
+      StratifiedSplit(input, labels, trainData, testData, trainLabels,
+          testLabels, 0.3);
+    }
+    else
+    {
+      data::Split(input, labels, trainData, testData, trainLabels, testLabels,
+          0.3);
+    }
+
+    uvec trainIndices, testIndices;
+    math::RandomSeed(7);
+    if (stratify)
+      StratifiedSplitIndices(labels, trainIndices, testIndices, 0.3);
+    else
+      SplitIndices(input.n_cols, trainIndices, testIndices, 0.3);
+
+    CheckMatrices(trainData, input.cols(trainIndices));
+    CheckMatrices(testData, input.cols(testIndices));
+    REQUIRE(accu(trainLabels != labels.cols(trainIndices)) == 0);
+    REQUIRE(accu(testLabels != labels.cols(testIndices)) == 0);
+  }
+}
+
+/**
+ * Make sure that SplitInPlace() reorders the points in place and returns
+ * aliases of the two parts of the data.
+ */
+TEST_CASE("SplitInPlaceTest", "[SplitDataTest]")
+{
+  mat original(4, 200, fill::randu);
+  Row<size_t> originalLabels(200);
+  for (size_t i = 0; i < originalLabels.n_elem; ++i)
+    originalLabels[i] = i % 4;
+  // Store the index of each point, so that it can be found after the split.
+  original.row(0) = conv_to<rowvec>::from(regspace<uvec>(0, 199));
+
+  for (const bool stratify : { false, true })
+  {
+    mat input(original);
+    Row<size_t> labels(originalLabels);
+    const double* memory = input.memptr();
+
+    mat trainData, testData;
+    Row<size_t> trainLabels, testLabels;
+    SplitInPlace(input, labels, trainData, testData, trainLabels, testLabels,
+        0.25, true, stratify);
+
+    // Stratification takes floor(50 * 0.25) = 12 test points of each class.
+    const size_t trainSize = stratify ? 152 : 150;
+    REQUIRE(trainData.n_cols == trainSize);
+    REQUIRE(testData.n_cols == 200 - trainSize);
+    REQUIRE(trainData.memptr() == memory);
+    REQUIRE(testData.memptr() == memory + trainSize * input.n_rows);
+    REQUIRE(input.memptr() == memory);
+
+    // Each point should still be with its label, and be one of the original
+    // points.
+    for (size_t i = 0; i < input.n_cols; ++i)
+    {
+      const size_t index = (size_t) input(0, i);
+      CheckMatrices(input.col(i), original.col(index));
+      REQUIRE(labels[i] == originalLabels[index]);
+    }
+
+    uvec sortedIndices = sort(conv_to<uvec>::from(input.row(0)));
+    REQUIRE(accu(sortedIndices != regspace<uvec>(0, 199)) == 0);
+
+    if (stratify)
+    {
+      for (size_t c = 0; c < 4; ++c)
+        REQUIRE(accu(testLabels == c) == 12);
+    }
+  }
+}
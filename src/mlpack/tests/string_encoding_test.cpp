@@ -615,6 +615,99 @@ TEST_CASE("BagOfWordsEncodingTest", "[StringEncodingTest]")
   CheckMatrices(output, expected.t());
 }
 
+/**
+ * Test that the streaming bag of words encoder gives the same result as the
+ * dense encoder, whichever way the corpus is split into shards.
+ */
+TEST_CASE("StreamingBagOfWordsEncodingTest", "[StringEncodingTest]")
+{
+  arma::mat expected;
+  BagOfWordsEncoding<SplitByAnyOf::TokenType> denseEncoder;
+  SplitByAnyOf tokenizer(" ,.");
+  denseEncoder.Encode(stringEncodingInput, expected, tokenizer);
+
+  for (size_t shardSize = 1; shardSize <= stringEncodingInput.size();
+      ++shardSize)
+  {
+    std::vector<std::vector<std::string>> shards;
+    for (size_t i = 0; i < stringEncodingInput.size(); i += shardSize)
+    {
+      shards.emplace_back(stringEncodingInput.begin() + i,
+          stringEncodingInput.begin() + std::min(i + shardSize,
+          stringEncodingInput.size()));
+    }
+
+    BagOfWordsEncoding<SplitByAnyOf::TokenType> encoder;
+    for (size_t i = 0; i < shards.size(); ++i)
+      encoder.CountTokens(shards[i], tokenizer);
+    REQUIRE(encoder.NumDocuments() == stringEncodingInput.size());
+    REQUIRE(encoder.Dictionary().Size() == denseEncoder.Dictionary().Size());
+
+    size_t column = 0;
+    for (size_t i = 0; i < shards.size(); ++i)
+    {
+      arma::sp_mat output;
+      encoder.EncodeShard(shards[i], output, tokenizer);
+      REQUIRE(output.n_rows == expected.n_rows);
+      REQUIRE(output.n_cols == shards[i].size());
+      CheckMatrices(arma::mat(output), arma::mat(expected.cols(column,
+          column + output.n_cols - 1)));
+      column += output.n_cols;
+    }
+  }
+}
+
+/**
+ * Test that the streaming tf-idf encoder gives the same result as the dense
+ * encoder, and that pruning removes exactly the rare tokens.
+ */
+TEST_CASE("StreamingTfIdfEncodingPruneTest", "[StringEncodingTest]")
+{
+  arma::mat expected;
+  TfIdfEncoding<SplitByAnyOf::TokenType> denseEncoder(
+      TfIdfEncodingPolicy(TfIdfEncodingPolicy::TfTypes::TERM_FREQUENCY, true));
+  SplitByAnyOf tokenizer(" ,.");
+  denseEncoder.Encode(stringEncodingInput, expected, tokenizer);
+
+  TfIdfEncoding<SplitByAnyOf::TokenType> encoder(
+      TfIdfEncodingPolicy(TfIdfEncodingPolicy::TfTypes::TERM_FREQUENCY, true));
+  const std::vector<std::string> first(stringEncodingInput.begin(),
+      stringEncodingInput.begin() + 2);
+  const std::vector<std::string> second(stringEncodingInput.begin() + 2,
+      stringEncodingInput.end());
+  encoder.CountTokens(first, tokenizer);
+  encoder.CountTokens(second, tokenizer);
+
+  arma::sp_mat output;
+  encoder.EncodeShard(stringEncodingInput, output, tokenizer);
+  CheckMatrices(arma::mat(output), expected);
+
+  // Keep the tokens that occur in at least two documents: "mlpack", "is",
+  // "and", "C++", "machine", "learning", "bindings" and "to".
+  encoder.PruneMap(2);
+  REQUIRE(encoder.Dictionary().Size() == 8);
+  REQUIRE(encoder.Dictionary().HasToken("learning"));
+  REQUIRE(!encoder.Dictionary().HasToken("LAPACK"));
+  REQUIRE(encoder.Dictionary().Value("mlpack") == 1);
+  for (size_t i = 0; i < encoder.DocumentFrequencies().size(); ++i)
+    REQUIRE(encoder.DocumentFrequencies()[i] >= 2);
+
+  encoder.EncodeShard(stringEncodingInput, output, tokenizer);
+  REQUIRE(output.n_rows == 8);
+  REQUIRE(output.n_cols == stringEncodingInput.size());
+  const StringEncodingDictionary<boost::string_view>& dense =
+      denseEncoder.Dictionary();
+  for (const auto& keyValue : encoder.Dictionary().Mapping())
+  {
+    const size_t denseRow = dense.Value(keyValue.first) - 1;
+    for (size_t j = 0; j < output.n_cols; ++j)
+    {
+      REQUIRE(output(keyValue.second - 1, j) ==
+          Approx(expected(denseRow, j)).epsilon(1e-7));
+    }
+  }
+}
+
 /**
  * Test the Bag of Words encoding algorithm. The output is saved into a vector.
  */
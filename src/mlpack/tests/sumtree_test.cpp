@@ -88,3 +88,86 @@ TEST_CASE("BatchUpdate", "[SumTreeTest]")
   CHECK(sumtree.FindPrefixSum(2.8) <= 3);
   CHECK(sumtree.FindPrefixSum(3.0) <= 3);
 }
+
+/**
+ * Make sure that the sums of a large tree, whose capacity is not a power of
+ * the fanout, are right after single and batched updates.
+ */
+TEST_CASE("LargeTreeSums", "[SumTreeTest]")
+{
+  const size_t capacity = 10000;
+  SumTree<double> sumtree(capacity);
+  arma::vec values(capacity, arma::fill::zeros);
+
+  // Set half of the elements one at a time.
+  for (size_t i = 0; i < capacity; i += 2)
+  {
+    values[i] = arma::randu();
+    sumtree.Set(i, values[i]);
+  }
+
+  // Update many elements (some of them several times) at once.
+  arma::ucolvec indices = arma::randi<arma::ucolvec>(6000,
+      arma::distr_param(0, (int) capacity - 1));
+  indices = arma::unique(indices);
+  arma::vec data(indices.n_elem, arma::fill::randu);
+  sumtree.BatchUpdate(indices, data);
+  values.elem(indices) = data;
+
+  REQUIRE(sumtree.Sum() == Approx(arma::accu(values)).epsilon(1e-10));
+  for (size_t trial = 0; trial < 100; ++trial)
+  {
+    const size_t start = math::RandInt(0, capacity);
+    const size_t end = math::RandInt(start + 1, capacity + 1);
+    REQUIRE(sumtree.Sum(start, end) ==
+        Approx(arma::accu(values.subvec(start, end - 1))).epsilon(1e-10));
+  }
+
+  // Batched queries must give the same indices as single ones, and each index
+  // must hold the given mass.
+  const arma::vec cumulative = arma::cumsum(values);
+  arma::vec masses = arma::randu<arma::vec>(5000) * arma::accu(values);
+  arma::ucolvec found;
+  sumtree.FindPrefixSums(masses, found);
+  REQUIRE(found.n_elem == masses.n_elem);
+  for (size_t i = 0; i < masses.n_elem; ++i)
+  {
+    REQUIRE(found[i] == sumtree.FindPrefixSum(masses[i]));
+    REQUIRE(found[i] < capacity);
+    REQUIRE(values[found[i]] > 0.0);
+    REQUIRE(cumulative[found[i]] >= masses[i] - 1e-8);
+    REQUIRE(cumulative[found[i]] - values[found[i]] <= masses[i] + 1e-8);
+  }
+}
+
+/**
+ * Make sure that stratified sampling picks each element about as often as its
+ * share of the sum, and never picks an empty element.
+ */
+TEST_CASE("StratifiedSample", "[SumTreeTest]")
+{
+  SumTree<double, 4> sumtree(10);
+  const arma::vec values = { 1.0, 0.0, 2.0, 3.0, 0.0, 4.0, 0.0, 0.0, 0.0,
+      0.0 };
+  for (size_t i = 0; i < values.n_elem; ++i)
+    sumtree.Set(i, values[i]);
+
+  arma::vec counts(values.n_elem, arma::fill::zeros);
+  arma::ucolvec indices;
+  for (size_t trial = 0; trial < 1000; ++trial)
+  {
+    sumtree.StratifiedSample(10, indices);
+    REQUIRE(indices.n_elem == 10);
+    for (size_t i = 0; i < indices.n_elem; ++i)
+    {
+      REQUIRE(values[indices[i]] > 0.0);
+      if (i > 0)
+        REQUIRE(indices[i] >= indices[i - 1]);
+      counts[indices[i]] += 1.0;
+    }
+  }
+
+  counts /= arma::accu(counts);
+  for (size_t i = 0; i < values.n_elem; ++i)
+    REQUIRE(counts[i] == Approx(values[i] / 10.0).margin(0.02));
+}
@@ -0,0 +1,138 @@
+/**
+ * @file tests/thread_communicator.hpp
+ *
+ * A communicator between the threads of a test, to test the distributed
+ * methods with several shards without MPI.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_TESTS_THREAD_COMMUNICATOR_HPP
+#define MLPACK_TESTS_THREAD_COMMUNICATOR_HPP
+
+#include <mlpack/core.hpp>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/**
+ * The state shared by the threads of a group.
+ */
+struct ThreadGroup
+{
+  explicit ThreadGroup(const size_t size) :
+      size(size), arrived(0), generation(0), buffers(size) { }
+
+  //! Wait until every thread of the group has called Barrier().
+  void Barrier()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    const size_t currentGeneration = generation;
+    if (++arrived == size)
+    {
+      arrived = 0;
+      ++generation;
+      condition.notify_all();
+    }
+    else
+    {
+      condition.wait(lock, [this, currentGeneration]()
+          { return generation != currentGeneration; });
+    }
+  }
+
+  size_t size;
+  size_t arrived;
+  size_t generation;
+  std::mutex mutex;
+  std::condition_variable condition;
+  //! The serialized object of each thread for the current collective call.
+  std::vector<std::string> buffers;
+};
+
+/**
+ * A communicator between the threads of a ThreadGroup, with the interface of
+ * distributed::LocalCommunicator.  Objects are exchanged serialized, as with
+ * distributed::MPICommunicator.
+ */
+class ThreadCommunicator
+{
+ public:
+  ThreadCommunicator(ThreadGroup& group, const size_t rank) :
+      group(group), rank(rank) { }
+
+  size_t Rank() const { return rank; }
+  size_t Size() const { return group.size; }
+
+  template<typename eT>
+  void AllReduceSum(arma::Mat<eT>& matrix)
+  {
+    std::vector<arma::Mat<eT>> matrices;
+    AllGather(matrix, matrices);
+    matrix.zeros();
+    for (size_t i = 0; i < matrices.size(); ++i)
+      matrix += matrices[i];
+  }
+
+  template<typename T>
+  void Broadcast(T& object, const size_t root)
+  {
+    std::vector<T> objects;
+    AllGather(object, objects);
+    object = objects[root];
+  }
+
+  template<typename T>
+  void AllGather(const T& object, std::vector<T>& objects)
+  {
+    std::ostringstream oss;
+    {
+      cereal::BinaryOutputArchive ar(oss);
+      ar(cereal::make_nvp("object", object));
+    }
+    group.buffers[rank] = oss.str();
+    group.Barrier();
+
+    objects.resize(group.size);
+    for (size_t i = 0; i < group.size; ++i)
+    {
+      std::istringstream iss(group.buffers[i]);
+      cereal::BinaryInputArchive ar(iss);
+      ar(cereal::make_nvp("object", objects[i]));
+    }
+
+    // Nobody may overwrite its buffer before everyone has read it.
+    group.Barrier();
+  }
+
+ private:
+  ThreadGroup& group;
+  size_t rank;
+};
+
+/**
+ * Run the given function in one thread per shard, as function(communicator,
+ * shard), and wait for all the threads.
+ */
+template<typename FunctionType>
+void RunSharded(const std::vector<arma::mat>& shards, FunctionType function)
+{
+  ThreadGroup group(shards.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < shards.size(); ++i)
+  {
+    threads.push_back(std::thread([&group, &shards, &function, i]()
+    {
+      ThreadCommunicator communicator(group, i);
+      function(communicator, shards[i]);
+    }));
+  }
+
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i].join();
+}
+
+#endif
@@ -143,3 +143,101 @@ TEST_CASE("DisabledTimingTest", "[TimerTest]")
 
   REQUIRE(Timer::Get("test_timer") == std::chrono::microseconds(0));
 }
+
+/**
+ * Scopes recorded by several threads, nested or not, should all appear in the
+ * trace, each on the track of its thread.
+ */
+TEST_CASE("TracerTest", "[TimerTest]")
+{
+  util::Tracer::Enable(16);
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 3; ++i)
+  {
+    threads.push_back(std::thread([]()
+        {
+          for (size_t j = 0; j < 4; ++j)
+          {
+            MLPACK_TRACE_SCOPE("outer \"scope\"");
+            MLPACK_TRACE_SCOPE("inner");
+          }
+        }));
+  }
+
+  for (size_t i = 0; i < 3; ++i)
+    threads[i].join();
+
+  util::Tracer::Disable();
+
+  // Scopes are not recorded while the tracer is disabled.
+  {
+    MLPACK_TRACE_SCOPE("disabled");
+  }
+
+  std::ostringstream oss;
+  util::Tracer::Write(oss);
+  const std::string trace = oss.str();
+
+  REQUIRE(trace.find("{\"traceEvents\":[") == 0);
+  REQUIRE(trace.find("\"disabled\"") == std::string::npos);
+
+  size_t outer = 0, inner = 0;
+  for (size_t pos = trace.find("\"outer \\\"scope\\\"\""); pos !=
+      std::string::npos; pos = trace.find("\"outer \\\"scope\\\"\"", pos + 1))
+    ++outer;
+  for (size_t pos = trace.find("\"inner\""); pos != std::string::npos;
+      pos = trace.find("\"inner\"", pos + 1))
+    ++inner;
+  REQUIRE(outer == 12);
+  REQUIRE(inner == 12);
+  for (size_t t = 0; t < 3; ++t)
+  {
+    REQUIRE(trace.find("\"tid\":" + std::to_string(t) + ",") !=
+        std::string::npos);
+  }
+
+  // The ring buffer of each thread keeps only the most recent events.
+  util::Tracer::Enable(4);
+  for (size_t j = 0; j < 10; ++j)
+  {
+    MLPACK_TRACE_SCOPE("inner");
+  }
+  util::Tracer::Disable();
+
+  oss.str("");
+  util::Tracer::Write(oss);
+  const std::string wrapped = oss.str();
+  size_t count = 0;
+  for (size_t pos = wrapped.find("\"inner\""); pos != std::string::npos;
+      pos = wrapped.find("\"inner\"", pos + 1))
+    ++count;
+  REQUIRE(count == 4);
+
+  util::Tracer::Clear();
+}
+
+/**
+ * Counters should add up, but only while timing is enabled, and be removed by
+ * Reset().
+ */
+TEST_CASE("TimersCounterTest", "[TimerTest]")
+{
+  util::Timers timers;
+  timers.Count("base_cases", 5);
+  REQUIRE(timers.GetAllCounters().size() == 0);
+
+  timers.Enabled() = true;
+  timers.Count("base_cases", 5);
+  timers.Count("base_cases", 7);
+  timers.Count("iterations");
+  timers.Count("iterations");
+
+  std::map<std::string, size_t> counters = timers.GetAllCounters();
+  REQUIRE(counters.size() == 2);
+  REQUIRE(counters["base_cases"] == 12);
+  REQUIRE(counters["iterations"] == 2);
+
+  timers.Reset();
+  REQUIRE(timers.GetAllCounters().size() == 0);
+}
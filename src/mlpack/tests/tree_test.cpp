@@ -15,8 +15,10 @@
 #include <mlpack/core/metrics/mahalanobis_distance.hpp>
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
+#include <mlpack/core/tree/tree_tuner.hpp>
 
 #include <queue>
+#include <set>
 #include <stack>
 
 #include "catch.hpp"
@@ -145,6 +147,42 @@ TEST_CASE("HRectBoundMoveConstructor", "[TreeTest]")
   REQUIRE(b2[1].Hi() == Approx(4.0).epsilon(1e-7));
 }
 
+/**
+ * Make sure that copies and moves of low-dimensional bounds, whose ranges are
+ * stored in the bound itself, and of higher-dimensional bounds are independent
+ * of the original bound.
+ */
+TEST_CASE("HRectBoundInlineCopyMove", "[TreeTest]")
+{
+  HRectBound<EuclideanDistance> b(2);
+  b[0] = Range(0.0, 2.0);
+  b[1] = Range(2.0, 4.0);
+
+  HRectBound<EuclideanDistance> c(b);
+  b[0] = Range(-1.0, 1.0);
+  REQUIRE(c[0].Lo() == Approx(0.0).margin(1e-5));
+  REQUIRE(c[0].Hi() == Approx(2.0).epsilon(1e-7));
+
+  HRectBound<EuclideanDistance> d(std::move(c));
+  c = HRectBound<EuclideanDistance>(5);
+  REQUIRE(c.Dim() == 5);
+  REQUIRE(d.Dim() == 2);
+  REQUIRE(d[0].Hi() == Approx(2.0).epsilon(1e-7));
+  REQUIRE(d[1].Lo() == Approx(2.0).epsilon(1e-7));
+
+  // Switch between inline and allocated ranges.
+  c[4] = Range(3.0, 5.0);
+  d = c;
+  REQUIRE(d.Dim() == 5);
+  REQUIRE(d[4].Hi() == Approx(5.0).epsilon(1e-7));
+  d = b;
+  REQUIRE(d.Dim() == 2);
+  REQUIRE(d[0].Lo() == Approx(-1.0).epsilon(1e-7));
+  d = std::move(c);
+  REQUIRE(d.Dim() == 5);
+  REQUIRE(d[4].Lo() == Approx(3.0).epsilon(1e-7));
+}
+
 /**
  * Ensure that we get the correct center for our bound.
  */
@@ -1040,6 +1078,57 @@ TEST_CASE("HRectBoundDiameter", "[TreeTest]")
   REQUIRE(d.Diameter() == Approx(0.0).margin(1e-5));
 }
 
+/**
+ * Ensure that the distances of HRectBound with the L1 and L3 metrics, which
+ * use the integer powers of the metric, are the same as the brute-force
+ * distances between the point and the corners of the bound.
+ */
+template<int Power>
+void CheckHRectBoundLMetric()
+{
+  for (size_t trial = 0; trial < 20; ++trial)
+  {
+    const size_t dim = 3;
+    HRectBound<LMetric<Power, true>> b(dim);
+    arma::vec lo(dim, arma::fill::randn);
+    arma::vec width(dim, arma::fill::randu);
+    for (size_t j = 0; j < dim; ++j)
+      b[j] = Range(lo[j], lo[j] + width[j]);
+
+    const arma::vec point(dim, arma::fill::randn);
+
+    // The maximum distance is reached at a corner, and the minimum distance is
+    // reached at the point clamped to the bound.
+    double maxDistance = 0.0;
+    for (size_t corner = 0; corner < (size_t(1) << dim); ++corner)
+    {
+      arma::vec c(dim);
+      for (size_t j = 0; j < dim; ++j)
+        c[j] = ((corner >> j) & 1) ? b[j].Hi() : b[j].Lo();
+      maxDistance = std::max(maxDistance,
+          LMetric<Power, true>::Evaluate(point, c));
+    }
+
+    arma::vec clamped = point;
+    for (size_t j = 0; j < dim; ++j)
+      clamped[j] = std::min(std::max(point[j], b[j].Lo()), b[j].Hi());
+    const double minDistance = LMetric<Power, true>::Evaluate(point, clamped);
+
+    REQUIRE(b.MinDistance(point) == Approx(minDistance).margin(1e-7));
+    REQUIRE(b.MaxDistance(point) == Approx(maxDistance).epsilon(1e-7));
+
+    const Range r = b.RangeDistance(point);
+    REQUIRE(r.Lo() == Approx(minDistance).margin(1e-7));
+    REQUIRE(r.Hi() == Approx(maxDistance).epsilon(1e-7));
+  }
+}
+
+TEST_CASE("HRectBoundLMetricDistances", "[TreeTest]")
+{
+  CheckHRectBoundLMetric<1>();
+  CheckHRectBoundLMetric<3>();
+}
+
 /**
  * It seems as though Bill has stumbled across a bug where
  * BinarySpaceTree<>::count() returns something different than
@@ -1593,6 +1682,71 @@ TEST_CASE("RPTreeSplitTest", "[TreeTest]")
   CheckRPTreeSplit<TreeType, EuclideanDistance>(root);
 }
 
+// Recursively checks that the children of each Morton tree node hold
+// consecutive ranges of the Z-order curve, and that their bounds do not
+// overlap.
+template<typename TreeType>
+void CheckMortonTreeNode(const TreeType& node,
+                         const std::vector<uint64_t>& codes)
+{
+  for (size_t i = node.Begin(); i < node.Begin() + node.Count(); ++i)
+    REQUIRE(node.Bound().Contains(node.Dataset().col(i)));
+
+  if (node.IsLeaf())
+    return;
+
+  const TreeType& left = *node.Left();
+  const TreeType& right = *node.Right();
+  REQUIRE(left.Begin() == node.Begin());
+  REQUIRE(left.Count() > 0);
+  REQUIRE(right.Count() > 0);
+  REQUIRE(right.Begin() == left.Begin() + left.Count());
+
+  // Unless all codes are the same (so the node was split at the median), the
+  // children are in different Z-order cells.
+  if (codes[node.Begin()] != codes[node.Begin() + node.Count() - 1])
+  {
+    REQUIRE(codes[left.Begin() + left.Count() - 1] < codes[right.Begin()]);
+    REQUIRE(!left.Bound().Contains(right.Bound()));
+  }
+
+  CheckMortonTreeNode(left, codes);
+  CheckMortonTreeNode(right, codes);
+}
+
+/**
+ * Make sure that the Morton tree sorts the dataset along the Z-order curve,
+ * maps the points back correctly, and builds a valid tree.
+ */
+TEST_CASE("MortonTreeTest", "[TreeTest]")
+{
+  typedef MortonTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  for (size_t dims = 2; dims <= 3; ++dims)
+  {
+    arma::mat dataset = arma::randu<arma::mat>(dims, 3000);
+    // Add some duplicates, which all have the same code.
+    dataset.cols(2000, 2099).each_col() = dataset.col(0);
+
+    std::vector<size_t> oldFromNew;
+    TreeType root(dataset, oldFromNew, 10);
+
+    REQUIRE(root.NumDescendants() == dataset.n_cols);
+    for (size_t i = 0; i < oldFromNew.size(); ++i)
+      CheckMatrices(arma::mat(root.Dataset().col(i)),
+          arma::mat(dataset.col(oldFromNew[i])));
+
+    // The rearranged dataset is sorted by code.
+    std::vector<uint64_t> codes;
+    MortonSplit<HRectBound<EuclideanDistance>, arma::mat>::ComputeCodes(
+        root.Dataset(), arma::min(dataset, 1), arma::max(dataset, 1), codes);
+    for (size_t i = 1; i < codes.size(); ++i)
+      REQUIRE(codes[i - 1] <= codes[i]);
+
+    CheckMortonTreeNode(root, codes);
+  }
+}
+
 // Recursively checks that each node contains all points that it claims to have.
 template<typename TreeType>
 bool CheckPointBounds(TreeType& node)
@@ -1665,6 +1819,43 @@ TEST_CASE("BallTreeTest", "[TreeTest]")
   }
 }
 
+//! A ball bound whose center is a fixed-size vector, for 3-dimensional data.
+template<typename MetricType>
+using Ball3Bound = BallBound<MetricType, arma::vec::fixed<3>>;
+
+//! Check that two ball trees have the same nodes and bounds.
+template<typename TreeType, typename OtherTreeType>
+void CheckSameBallTrees(const TreeType& a, const OtherTreeType& b)
+{
+  REQUIRE(a.Begin() == b.Begin());
+  REQUIRE(a.Count() == b.Count());
+  REQUIRE(a.NumChildren() == b.NumChildren());
+  REQUIRE(a.Bound().Radius() == Approx(b.Bound().Radius()).epsilon(1e-10));
+  for (size_t d = 0; d < 3; ++d)
+  {
+    REQUIRE(a.Bound().Center()[d] ==
+        Approx(b.Bound().Center()[d]).epsilon(1e-10));
+  }
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameBallTrees(a.Child(i), b.Child(i));
+}
+
+/**
+ * Make sure that a ball tree with fixed-size centers is the same as a ball
+ * tree with the default bound.
+ */
+TEST_CASE("FixedSizeBallTreeTest", "[TreeTest]")
+{
+  arma::mat dataset(3, 2000, arma::fill::randu);
+
+  BallTree<EuclideanDistance, EmptyStatistic, arma::mat> tree(dataset);
+  BinarySpaceTree<EuclideanDistance, EmptyStatistic, arma::mat, Ball3Bound>
+      fixedTree(dataset);
+
+  CheckSameBallTrees(tree, fixedTree);
+}
+
 /**
  * Ensure that we can build a ball tree with a custom instantiated metric type.
  */
@@ -1954,6 +2145,35 @@ TEST_CASE("CoverTreeConstructionTest", "[TreeTest]")
   // implementation.
 }
 
+/**
+ * Create a cover tree on high-dimensional data with duplicate points, which
+ * causes large used sets to be moved between point sets during construction,
+ * and make sure it's accurate.
+ */
+TEST_CASE("CoverTreeHighDimensionalConstructionTest", "[TreeTest]")
+{
+  arma::mat dataset;
+  dataset.randu(120, 3000);
+  // Make some of the points duplicates of others.
+  for (size_t i = 0; i < 3000; i += 7)
+    dataset.col(i) = dataset.col((i * 13) % 3000);
+
+  typedef StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      TreeType;
+  TreeType tree(dataset);
+
+  arma::vec counts;
+  counts.zeros(3000);
+  RecurseTreeCountLeaves(tree, counts);
+
+  for (size_t i = 0; i < 3000; ++i)
+    REQUIRE(counts[i] == 1);
+
+  REQUIRE(tree.NumDescendants() == 3000);
+  CheckSelfChild<TreeType>(tree);
+  CheckCovering<TreeType, LMetric<2, true> >(tree);
+}
+
 /**
  * Create a cover tree on sparse data and make sure it's accurate.
  */
@@ -2287,3 +2507,244 @@ TEST_CASE("CoverTreeDescendantTest", "[TreeTest]")
   // using the recursive function above.
   CheckDescendants(&tree);
 }
+
+// Recursively check that two binary space trees have the same structure and
+// bounds, and that the parent pointers of the second tree are consistent.
+template<typename TreeType>
+void CheckSameTree(const TreeType& a, const TreeType& b)
+{
+  REQUIRE(a.Begin() == b.Begin());
+  REQUIRE(a.Count() == b.Count());
+  REQUIRE(a.NumChildren() == b.NumChildren());
+  REQUIRE(a.Bound().Dim() == b.Bound().Dim());
+  for (size_t d = 0; d < a.Bound().Dim(); ++d)
+  {
+    REQUIRE(a.Bound()[d].Lo() == b.Bound()[d].Lo());
+    REQUIRE(a.Bound()[d].Hi() == b.Bound()[d].Hi());
+  }
+  REQUIRE(a.ParentDistance() == Approx(b.ParentDistance()).epsilon(1e-7));
+  REQUIRE(a.FurthestDescendantDistance() ==
+      Approx(b.FurthestDescendantDistance()).epsilon(1e-7));
+
+  for (size_t i = 0; i < b.NumChildren(); ++i)
+  {
+    REQUIRE(b.Child(i).Parent() == &b);
+    REQUIRE(&b.Child(i).Dataset() == &b.Dataset());
+    CheckSameTree(a.Child(i), b.Child(i));
+  }
+}
+
+/**
+ * Make sure that compacting a kd-tree, in both layouts, does not change the
+ * tree, and that compacted trees can be copied and moved.
+ */
+TEST_CASE("BinarySpaceTreeCompactTest", "[TreeTest]")
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  TreeType tree(dataset, 5);
+
+  for (size_t layout = 0; layout < 2; ++layout)
+  {
+    TreeType compactTree(tree);
+    REQUIRE(!compactTree.IsCompact());
+    compactTree.Compact(layout == 0);
+    REQUIRE(compactTree.IsCompact());
+    CheckSameTree(tree, compactTree);
+
+    // In breadth-first order, the children of the root are stored next to
+    // each other.
+    if (layout == 1)
+      REQUIRE(compactTree.Right() == compactTree.Left() + 1);
+
+    // Compacting again should also work.
+    compactTree.Compact(layout == 1);
+    CheckSameTree(tree, compactTree);
+
+    TreeType copiedTree(compactTree);
+    REQUIRE(!copiedTree.IsCompact());
+    CheckSameTree(tree, copiedTree);
+
+    TreeType movedTree(std::move(compactTree));
+    REQUIRE(movedTree.IsCompact());
+    REQUIRE(!compactTree.IsCompact());
+    CheckSameTree(tree, movedTree);
+
+    copiedTree = std::move(movedTree);
+    REQUIRE(copiedTree.IsCompact());
+    CheckSameTree(tree, copiedTree);
+  }
+
+  // Only the root can be compacted.
+  TreeType compactTree(tree);
+  REQUIRE_THROWS_AS(compactTree.Left()->Compact(), std::invalid_argument);
+}
+
+/**
+ * Make sure that kd-trees built with several threads are the same as those
+ * built with one thread.
+ */
+template<typename TreeType>
+void CheckParallelBuild()
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 30000);
+
+  #ifdef HAS_OPENMP
+    const int numThreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+  #endif
+
+  std::vector<size_t> serialOldFromNew;
+  TreeType serialTree(dataset, serialOldFromNew, 10);
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(std::max(numThreads, 4));
+  #endif
+
+  std::vector<size_t> parallelOldFromNew;
+  TreeType parallelTree(dataset, parallelOldFromNew, 10);
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(numThreads);
+  #endif
+
+  REQUIRE(serialOldFromNew == parallelOldFromNew);
+  REQUIRE(arma::approx_equal(serialTree.Dataset(), parallelTree.Dataset(),
+      "absdiff", 0.0));
+  CheckSameTree(serialTree, parallelTree);
+}
+
+TEST_CASE("BinarySpaceTreeParallelBuildTest", "[TreeTest]")
+{
+  CheckParallelBuild<KDTree<EuclideanDistance, EmptyStatistic, arma::mat>>();
+  CheckParallelBuild<MeanSplitKDTree<EuclideanDistance, EmptyStatistic,
+      arma::mat>>();
+}
+
+/**
+ * Make sure that a NodeArena returns distinct memory for each node, and that
+ * reserved nodes are contiguous.
+ */
+TEST_CASE("NodeArenaTest", "[TreeTest]")
+{
+  NodeArena<arma::uword> arena(4, 16);
+  std::set<arma::uword*> nodes;
+  for (size_t i = 0; i < 100; ++i)
+  {
+    arma::uword* node = new (arena.Allocate()) arma::uword(i);
+    nodes.insert(node);
+  }
+
+  REQUIRE(nodes.size() == 100);
+  REQUIRE(arena.Size() == 100);
+
+  arena.Reserve(50);
+  arma::uword* first = static_cast<arma::uword*>(arena.Allocate());
+  for (size_t i = 1; i < 50; ++i)
+    REQUIRE(arena.Allocate() == first + i);
+  REQUIRE(arena.Size() == 150);
+}
+
+/**
+ * Make sure that trees built in an arena can be replaced by copied, moved and
+ * rebuilt trees.
+ */
+TEST_CASE("BinarySpaceTreeArenaAssignTest", "[TreeTest]")
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  TreeType tree(dataset, 5);
+
+  TreeType copiedTree(arma::randu<arma::mat>(3, 500), 5);
+  copiedTree = tree;
+  CheckSameTree(tree, copiedTree);
+
+  TreeType movedTree(arma::randu<arma::mat>(3, 500), 5);
+  movedTree = TreeType(dataset, 5);
+  CheckSameTree(tree, movedTree);
+
+  // Replace the arena of the tree.
+  movedTree.Compact();
+  CheckSameTree(tree, movedTree);
+}
+
+/**
+ * Make sure that TreeTuner tries every candidate on samples of the requested
+ * sizes, and chooses the candidate with the lowest estimated cost.
+ */
+TEST_CASE("TreeTunerTest", "[TreeTest]")
+{
+  arma::mat referenceSet(3, 1000, arma::fill::randu);
+  arma::mat querySet(3, 300, arma::fill::randu);
+
+  TreeTuner tuner(100, 10, { 5, 15 });
+  std::vector<TreeCandidate> candidates;
+  tuner.AddCandidates(candidates, 0, "first tree", true);
+  tuner.AddCandidates(candidates, 1, "second tree", false);
+  REQUIRE(candidates.size() == 3);
+  REQUIRE(candidates[0].leafSize == 5);
+  REQUIRE(candidates[1].leafSize == 15);
+  REQUIRE(candidates[2].leafSize == 0);
+
+  // Each search counts more base cases than the previous one.
+  size_t built = 0;
+  auto build = [&](const TreeCandidate& /* candidate */,
+                   arma::mat&& references)
+  {
+    REQUIRE(references.n_cols == 100);
+    ++built;
+  };
+  auto search = [&](arma::mat&& queries, util::Timers& timers)
+  {
+    REQUIRE(queries.n_cols == 10);
+    timers.Count("base_cases", 10 * built);
+    timers.Count("scores", 2);
+  };
+
+  const size_t best = tuner.Tune(referenceSet, querySet, candidates, build,
+      search);
+  REQUIRE(built == 3);
+  REQUIRE(best < 3);
+  for (size_t i = 0; i < candidates.size(); ++i)
+  {
+    REQUIRE(candidates[i].baseCases == 10 * (i + 1));
+    REQUIRE(candidates[i].scores == 2);
+    REQUIRE(candidates[i].cost >= candidates[best].cost);
+  }
+
+  // For monochromatic search, the queries are taken from the reference sample.
+  REQUIRE(tuner.Tune(referenceSet, arma::mat(), candidates, build,
+      search) < 3);
+
+  candidates.clear();
+  REQUIRE_THROWS_AS(tuner.Tune(referenceSet, querySet, candidates, build,
+      search), std::invalid_argument);
+  REQUIRE_THROWS_AS(TreeTuner(1, 10), std::invalid_argument);
+}
+
+/**
+ * Check the extrapolation of the cost model of TreeTuner.
+ */
+TEST_CASE("TreeTunerEstimateCostTest", "[TreeTest]")
+{
+  TreeCandidate candidate;
+  candidate.buildTime = 1.0;
+  candidate.searchTime = 1.0;
+
+  // Without extrapolation, the cost is the measured time.
+  REQUIRE(TreeTuner::EstimateCost(candidate, 100, 10, 100, 10) ==
+      Approx(2.0));
+
+  // Building grows as N log N, and each query as log N if everything was
+  // pruned: here 100 times more points make building 200 times slower, and
+  // each of the 100 times more queries twice slower.
+  REQUIRE(TreeTuner::EstimateCost(candidate, 100, 10, 10000, 1000) ==
+      Approx(400.0));
+
+  // If each query was compared to the whole sample, the search grows as N.
+  candidate.baseCases = 1000;
+  REQUIRE(TreeTuner::EstimateCost(candidate, 100, 10, 10000, 1000) ==
+      Approx(10200.0));
+}
@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 
 #include <mlpack/core.hpp>
 #include "catch.hpp"
@@ -47,3 +48,35 @@ TEST_CASE("TestUnion", "[UnionFindTest]")
   REQUIRE(testUnionFind.Find(1) == testUnionFind.Find(5));
   REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
 }
+
+/**
+ * Make sure that ConcurrentUnionFind gives the same components as UnionFind
+ * when the unions are performed in parallel, and that the root of each
+ * component is its smallest element.
+ */
+TEST_CASE("TestConcurrentUnionFind", "[UnionFindTest]")
+{
+  static const size_t testSize = 5000;
+  arma::Mat<size_t> edges = arma::randi<arma::Mat<size_t>>(2, 3000,
+      arma::distr_param(0, (int) testSize - 1));
+
+  UnionFind serial(testSize);
+  for (size_t i = 0; i < edges.n_cols; ++i)
+    serial.Union(edges(0, i), edges(1, i));
+
+  ConcurrentUnionFind concurrent(testSize);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) edges.n_cols; ++i)
+    concurrent.Union(edges(0, i), edges(1, i));
+
+  arma::Col<size_t> smallest(testSize);
+  smallest.fill(SIZE_MAX);
+  for (size_t i = 0; i < testSize; ++i)
+  {
+    const size_t root = serial.Find(i);
+    smallest[root] = std::min(smallest[root], i);
+  }
+
+  for (size_t i = 0; i < testSize; ++i)
+    REQUIRE(concurrent.Find(i) == smallest[serial.Find(i)]);
+}
@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/xgboost/loss_functions/sse_loss.hpp>
+#include <mlpack/methods/xgboost/xgboost.hpp>
 
 #include "catch.hpp"
 #include "serialization.hpp"
@@ -64,3 +65,144 @@ TEST_CASE("SSEGainTest", "[XGBTest]")
   SSELoss Loss;
   REQUIRE(Loss.Evaluate<false>(input, weights) == gain);
 }
+
+/**
+ * Test that the bins of the FeatureBinner agree with its thresholds, and that
+ * each distinct value gets its own bin when there are few of them.
+ */
+TEST_CASE("FeatureBinnerTest", "[XGBTest]")
+{
+  arma::mat data(2, 1000, arma::fill::randu);
+  // The second dimension only takes 5 different values.
+  data.row(1) = arma::floor(5 * data.row(1));
+
+  FeatureBinner binner(data, 32);
+  REQUIRE(binner.Dimensionality() == 2);
+  REQUIRE(binner.NumBins(0) <= 32);
+  REQUIRE(binner.NumBins(0) > 16);
+  REQUIRE(binner.NumBins(1) == 5);
+
+  arma::Mat<unsigned char> bins;
+  binner.Transform(data, bins);
+  REQUIRE(bins.n_rows == 2);
+  REQUIRE(bins.n_cols == 1000);
+
+  for (size_t d = 0; d < 2; ++d)
+  {
+    const arma::vec& thresholds = binner.Thresholds(d);
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      REQUIRE(bins(d, i) < binner.NumBins(d));
+      if (bins(d, i) < thresholds.n_elem)
+        REQUIRE(data(d, i) <= thresholds[bins(d, i)]);
+      if (bins(d, i) > 0)
+        REQUIRE(data(d, i) > thresholds[bins(d, i) - 1]);
+    }
+  }
+
+  // Each value of the second dimension is in its own bin.
+  for (size_t i = 0; i < data.n_cols; ++i)
+    REQUIRE(bins(1, i) == (size_t) data(1, i));
+}
+
+/**
+ * Test that a HistogramTree finds the split of a step function, and that the
+ * values it gives for the training points are the same as its predictions.
+ */
+TEST_CASE("HistogramTreeStepTest", "[XGBTest]")
+{
+  // There are few enough points that each value gets its own bin.
+  arma::mat data(3, 200, arma::fill::randu);
+  arma::rowvec responses(200);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    responses[i] = (data(1, i) > 0.5) ? 2.0 : -1.0;
+
+  FeatureBinner binner(data);
+  arma::Mat<unsigned char> bins;
+  binner.Transform(data, bins);
+
+  SSELoss loss;
+  arma::rowvec zeros(200, arma::fill::zeros);
+  arma::vec gradients, hessians, predictions;
+  loss.Gradients(responses, zeros, gradients, hessians);
+
+  HistogramTree tree;
+  tree.Train(bins, binner, gradients, hessians, loss, 1, 1.0, 0.0,
+      predictions);
+
+  REQUIRE(tree.NumNodes() == 3);
+  REQUIRE(tree.Child(0) == 1);
+  REQUIRE(tree.SplitDimension(0) == 1);
+  REQUIRE(tree.SplitValue(0) == Approx(0.5).margin(0.01));
+
+  // Without regularization the leaves predict the responses exactly.
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    REQUIRE(predictions[i] == Approx(responses[i]).epsilon(1e-10));
+    REQUIRE(tree.Predict(data.col(i)) == predictions[i]);
+  }
+}
+
+/**
+ * Test that XGBoost fits a smooth nonlinear function.
+ */
+TEST_CASE("XGBoostRegressionTest", "[XGBTest]")
+{
+  arma::mat data(4, 2000, arma::fill::randu);
+  arma::rowvec responses = 3 * arma::sin(4 * data.row(0)) +
+      arma::square(data.row(1)) + 0.05 * arma::randn<arma::rowvec>(2000);
+
+  arma::mat trainData = data.cols(0, 1499);
+  arma::rowvec trainResponses = responses.subvec(0, 1499);
+  arma::mat testData = data.cols(1500, 1999);
+  arma::rowvec testResponses = responses.subvec(1500, 1999);
+
+  XGBoost<> model(trainData, trainResponses, 100, 0.3, 4);
+  REQUIRE(model.NumTrees() == 100);
+
+  arma::rowvec predictions;
+  model.Predict(testData, predictions);
+  REQUIRE(predictions.n_elem == 500);
+
+  const double mse = arma::mean(arma::square(predictions - testResponses));
+  const double variance = arma::var(testResponses);
+  REQUIRE(mse < 0.05 * variance);
+
+  // Batch and single-point predictions agree.
+  for (size_t i = 0; i < testData.n_cols; ++i)
+    REQUIRE(model.Predict(testData.col(i)) == Approx(predictions[i]));
+}
+
+/**
+ * Test that an untrained model cannot predict.
+ */
+TEST_CASE("XGBoostUntrainedPredictTest", "[XGBTest]")
+{
+  XGBoost<> model;
+  arma::mat data(3, 10, arma::fill::randu);
+  arma::rowvec predictions;
+  REQUIRE_THROWS_AS(model.Predict(data, predictions), std::invalid_argument);
+}
+
+/**
+ * Test that a serialized model gives the same predictions.
+ */
+TEST_CASE("XGBoostSerializationTest", "[XGBTest]")
+{
+  arma::mat data(3, 300, arma::fill::randu);
+  arma::rowvec responses = data.row(0) + 2 * data.row(2);
+
+  XGBoost<> model(data, responses, 20);
+  XGBoost<> xmlModel, jsonModel, binaryModel;
+  SerializeObjectAll(model, xmlModel, jsonModel, binaryModel);
+
+  arma::rowvec predictions, xmlPredictions, jsonPredictions, binaryPredictions;
+  model.Predict(data, predictions);
+  xmlModel.Predict(data, xmlPredictions);
+  jsonModel.Predict(data, jsonPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+
+  REQUIRE(xmlModel.NumTrees() == 20);
+  CheckMatrices(predictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+}